@@ -0,0 +1,592 @@
+// OpenSTA, Static Timing Analyzer
+// Copyright (c) 2019, Parallax Software, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+// Micro-benchmarks for the timing kernels.
+//
+//  sta_bench [-threads "1 2 4 8"] [-reps count] design_dir
+//
+// design_dir holds bench.lib, bench.v, bench.sdc and bench.spef written
+// by etc/GenBenchDesign.tcl. Each kernel is reported in nanoseconds per
+// operation for each thread count with the speedup over the first.
+
+#include <tcl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <chrono>
+#include <functional>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "Machine.hh"
+#include "StringUtil.hh"
+#include "MinMax.hh"
+#include "Transition.hh"
+#include "TimingRole.hh"
+#include "TimingArc.hh"
+#include "TableModel.hh"
+#include "Liberty.hh"
+#include "Network.hh"
+#include "Graph.hh"
+#include "Corner.hh"
+#include "DcalcAnalysisPt.hh"
+#include "Parasitics.hh"
+#include "ArcDelayCalc.hh"
+#include "DmpDelayCalc.hh"
+#include "GraphDelayCalc.hh"
+#include "ThreadForEach.hh"
+#include "VertexVisitor.hh"
+#include "SearchPred.hh"
+#include "Levelize.hh"
+#include "Bfs.hh"
+#include "Tag.hh"
+#include "Search.hh"
+#include "PathEnd.hh"
+#include "PathEnum.hh"
+#include "Sta.hh"
+#include "StaMain.hh"
+
+// Swig uses C linkage for init functions.
+extern "C" {
+extern int Sta_Init(Tcl_Interp *interp);
+}
+
+namespace sta {
+
+extern const char *tcl_inits[];
+
+using std::string;
+
+// Kernels return the number of operations in one repetition.
+typedef std::function<size_t ()> BenchKernel;
+typedef std::map<string, double> BenchBaselineMap;
+
+// Fixed lookup points so runs are comparable.
+static const size_t bench_table_points = 4096;
+static const size_t bench_tag_lookups = 1000;
+static const int bench_path_enum_ends = 100;
+static const int bench_path_enum_count = 10;
+
+struct BenchGateDelay
+{
+  const LibertyCell *cell;
+  TimingArc *arc;
+  Slew in_slew;
+  float load_cap;
+  Parasitic *parasitic;
+};
+
+class BenchVisitor : public VertexVisitor
+{
+public:
+  explicit BenchVisitor(BfsIterator *iter) : iter_(iter) {}
+  virtual VertexVisitor *copy() { return new BenchVisitor(iter_); }
+  virtual void visit(Vertex *vertex) { iter_->enqueueAdjacentVertices(vertex); }
+
+private:
+  BfsIterator *iter_;
+};
+
+class StaBench
+{
+public:
+  StaBench(Sta *sta,
+	   int reps);
+  ~StaBench();
+  void setup();
+  void run(int thread_count);
+
+private:
+  void makeTables();
+  void findGateDelays();
+  void findReduceDrvrs();
+  void findTags();
+  void findPathEnds();
+  void kernel(const char *name,
+	      int thread_count,
+	      BenchKernel func);
+  size_t tableLookups(const Table *table);
+  size_t gateDelays();
+  size_t reduceParasitics();
+  size_t bfsVisits();
+  size_t tagLookups();
+  size_t pathEnums();
+
+  Sta *sta_;
+  int reps_;
+  const DcalcAnalysisPt *dcalc_ap_;
+  Table *table2_;
+  Table *table3_;
+  std::vector<float> table_values_;
+  ArcDelayCalc *arc_delay_calc_;
+  std::vector<BenchGateDelay> gate_delays_;
+  std::vector<const Pin*> reduce_drvrs_;
+  std::vector<Tag*> tags_;
+  std::vector<PathEnd*> path_ends_;
+  BenchBaselineMap baselines_;
+  // Results are accumulated so the kernels cannot be optimized away.
+  double checksum_;
+};
+
+StaBench::StaBench(Sta *sta,
+		   int reps) :
+  sta_(sta),
+  reps_(reps),
+  dcalc_ap_(sta->cmdCorner()->findDcalcAnalysisPt(MinMax::max())),
+  table2_(nullptr),
+  table3_(nullptr),
+  arc_delay_calc_(makeDmpCeffElmoreDelayCalc(sta)),
+  checksum_(0.0)
+{
+}
+
+StaBench::~StaBench()
+{
+  arc_delay_calc_->finishDrvrPin();
+  delete arc_delay_calc_;
+  delete table2_;
+  delete table3_;
+}
+
+void
+StaBench::setup()
+{
+  sta_->updateTiming(true);
+  makeTables();
+  findGateDelays();
+  findReduceDrvrs();
+  findTags();
+  findPathEnds();
+  printf("%zu gate arcs %zu parasitic drivers %zu tags %zu path ends\n",
+	 gate_delays_.size(), reduce_drvrs_.size(), tags_.size(),
+	 path_ends_.size());
+}
+
+void
+StaBench::run(int thread_count)
+{
+  sta_->setThreadCount(thread_count);
+  kernel("table2_lookup", thread_count,
+	 [this] () { return tableLookups(table2_); });
+  kernel("table3_lookup", thread_count,
+	 [this] () { return tableLookups(table3_); });
+  kernel("dmp_gate_delay", thread_count,
+	 [this] () { return gateDelays(); });
+  kernel("reduce_pi_elmore", thread_count,
+	 [this] () { return reduceParasitics(); });
+  kernel("bfs_visit", thread_count,
+	 [this] () { return bfsVisits(); });
+  kernel("find_tag", thread_count,
+	 [this] () { return tagLookups(); });
+  kernel("path_enum", thread_count,
+	 [this] () { return pathEnums(); });
+}
+
+void
+StaBench::kernel(const char *name,
+		 int thread_count,
+		 BenchKernel func)
+{
+  // Warm up caches and pools before timing.
+  size_t op_count = func();
+  auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < reps_; i++)
+    func();
+  auto end = std::chrono::steady_clock::now();
+  double ns = std::chrono::duration<double, std::nano>(end - start).count();
+  double ns_per_op = (op_count > 0) ? ns / (op_count * reps_) : 0.0;
+  auto baseline_itr = baselines_.find(name);
+  if (baseline_itr == baselines_.end())
+    baseline_itr = baselines_.insert({name, ns_per_op}).first;
+  double speedup = (ns_per_op > 0.0) ? baseline_itr->second / ns_per_op : 0.0;
+  printf("%-18s %3d threads %10.1f ns/op %6.2fx\n",
+	 name, thread_count, ns_per_op, speedup);
+}
+
+////////////////////////////////////////////////////////////////
+
+static TableAxis *
+makeBenchAxis(TableAxisVariable variable,
+	      size_t size,
+	      float step)
+{
+  FloatSeq *values = new FloatSeq;
+  for (size_t i = 0; i < size; i++)
+    values->push_back(i * i * step);
+  return new TableAxis(variable, values);
+}
+
+void
+StaBench::makeTables()
+{
+  const size_t axis_size = 7;
+  FloatTable *values2 = new FloatTable;
+  for (size_t i = 0; i < axis_size; i++) {
+    FloatSeq *row = new FloatSeq;
+    for (size_t j = 0; j < axis_size; j++)
+      row->push_back(i * 0.1F + j * 0.01F);
+    values2->push_back(row);
+  }
+  table2_ = new Table2(values2,
+		       makeBenchAxis(TableAxisVariable::input_net_transition,
+				     axis_size, 0.02F), true,
+		       makeBenchAxis(TableAxisVariable::total_output_net_capacitance,
+				     axis_size, 0.005F), true);
+
+  // Table3 rows are indexed by axis1 and axis2.
+  FloatTable *values3 = new FloatTable;
+  for (size_t i = 0; i < axis_size * axis_size; i++) {
+    FloatSeq *row = new FloatSeq;
+    for (size_t k = 0; k < axis_size; k++)
+      row->push_back(i * 0.01F + k * 0.001F);
+    values3->push_back(row);
+  }
+  table3_ = new Table3(values3,
+		       makeBenchAxis(TableAxisVariable::input_net_transition,
+				     axis_size, 0.02F), true,
+		       makeBenchAxis(TableAxisVariable::total_output_net_capacitance,
+				     axis_size, 0.005F), true,
+		       makeBenchAxis(TableAxisVariable::related_out_total_output_net_capacitance,
+				     axis_size, 0.005F), true);
+
+  // Points cover the table and extrapolate past both ends.
+  unsigned seed = 1;
+  for (size_t i = 0; i < bench_table_points * 3; i++) {
+    seed = seed * 1103515245 + 12345;
+    table_values_.push_back(((seed >> 8) % 10000) * 0.00012F - 0.1F);
+  }
+}
+
+size_t
+StaBench::tableLookups(const Table *table)
+{
+  ThreadPool *pool = sta_->threadPool();
+  int thread_count = pool ? pool->threadCount() : 1;
+  std::vector<double> sums(thread_count, 0.0);
+  forEachChunk(bench_table_points, pool,
+	       [&] (size_t begin, size_t end, int thread_index) {
+		 double sum = 0.0;
+		 for (size_t i = begin; i < end; i++) {
+		   const float *point = &table_values_[i * 3];
+		   sum += table->findValue(point[0], point[1], point[2]);
+		 }
+		 sums[thread_index] += sum;
+	       });
+  for (double sum : sums)
+    checksum_ += sum;
+  return bench_table_points;
+}
+
+////////////////////////////////////////////////////////////////
+
+// Driver arcs with the slews and parasitics from the last timing update.
+void
+StaBench::findGateDelays()
+{
+  Network *network = sta_->network();
+  Graph *graph = sta_->graph();
+  GraphDelayCalc *graph_delay_calc = sta_->graphDelayCalc();
+  DcalcAPIndex ap_index = dcalc_ap_->index();
+  VertexIterator vertex_iter(graph);
+  while (vertex_iter.hasNext()) {
+    Vertex *vertex = vertex_iter.next();
+    const Pin *drvr_pin = vertex->pin();
+    if (network->isDriver(drvr_pin)) {
+      const LibertyCell *cell =
+	network->libertyCell(network->instance(drvr_pin));
+      if (cell) {
+	VertexInEdgeIterator edge_iter(vertex, graph);
+	while (edge_iter.hasNext()) {
+	  Edge *edge = edge_iter.next();
+	  const TimingRole *role = edge->role();
+	  if (!role->isWire() && !role->isTimingCheck()) {
+	    Vertex *from_vertex = edge->from(graph);
+	    TimingArcSetArcIterator arc_iter(edge->timingArcSet());
+	    while (arc_iter.hasNext()) {
+	      TimingArc *arc = arc_iter.next();
+	      TransRiseFall *from_tr = arc->fromTrans()->asRiseFall();
+	      TransRiseFall *drvr_tr = arc->toTrans()->asRiseFall();
+	      if (from_tr && drvr_tr) {
+		// The reduced parasitics are deleted by finishDrvrPin
+		// in the destructor.
+		Parasitic *parasitic =
+		  arc_delay_calc_->findParasitic(drvr_pin, drvr_tr, dcalc_ap_);
+		float load_cap = graph_delay_calc->loadCap(drvr_pin, parasitic,
+							   drvr_tr, dcalc_ap_);
+		gate_delays_.push_back({cell, arc,
+					graph->slew(from_vertex, from_tr,
+						    ap_index),
+					load_cap, parasitic});
+	      }
+	    }
+	  }
+	}
+      }
+    }
+  }
+}
+
+size_t
+StaBench::gateDelays()
+{
+  ThreadPool *pool = sta_->threadPool();
+  int thread_count = pool ? pool->threadCount() : 1;
+  // The arc delay calculators need separate state for each thread.
+  std::vector<ArcDelayCalc*> arc_delay_calcs;
+  for (int i = 0; i < thread_count; i++)
+    arc_delay_calcs.push_back(arc_delay_calc_->copy());
+  std::vector<double> sums(thread_count, 0.0);
+  const Pvt *pvt = dcalc_ap_->operatingConditions();
+  forEachChunk(gate_delays_.size(), pool,
+	       [&] (size_t begin, size_t end, int thread_index) {
+		 ArcDelayCalc *arc_delay_calc = arc_delay_calcs[thread_index];
+		 double sum = 0.0;
+		 for (size_t i = begin; i < end; i++) {
+		   BenchGateDelay &gate = gate_delays_[i];
+		   ArcDelay gate_delay;
+		   Slew drvr_slew;
+		   arc_delay_calc->gateDelay(gate.cell, gate.arc, gate.in_slew,
+					     gate.load_cap, gate.parasitic,
+					     0.0, pvt, dcalc_ap_,
+					     gate_delay, drvr_slew);
+		   sum += delayAsFloat(gate_delay);
+		 }
+		 sums[thread_index] += sum;
+	       });
+  for (ArcDelayCalc *arc_delay_calc : arc_delay_calcs)
+    delete arc_delay_calc;
+  for (double sum : sums)
+    checksum_ += sum;
+  return gate_delays_.size();
+}
+
+////////////////////////////////////////////////////////////////
+
+void
+StaBench::findReduceDrvrs()
+{
+  Network *network = sta_->network();
+  Parasitics *parasitics = sta_->parasitics();
+  const ParasiticAnalysisPt *parasitic_ap = dcalc_ap_->parasiticAnalysisPt();
+  VertexIterator vertex_iter(sta_->graph());
+  while (vertex_iter.hasNext()) {
+    Vertex *vertex = vertex_iter.next();
+    const Pin *drvr_pin = vertex->pin();
+    if (network->isDriver(drvr_pin)
+	&& parasitics->findParasiticNetwork(drvr_pin, parasitic_ap))
+      reduce_drvrs_.push_back(drvr_pin);
+  }
+}
+
+size_t
+StaBench::reduceParasitics()
+{
+  Parasitics *parasitics = sta_->parasitics();
+  const ParasiticAnalysisPt *parasitic_ap = dcalc_ap_->parasiticAnalysisPt();
+  forEachChunk(reduce_drvrs_.size(), sta_->threadPool(),
+	       [&] (size_t begin, size_t end, int) {
+		 for (size_t i = begin; i < end; i++) {
+		   const Pin *drvr_pin = reduce_drvrs_[i];
+		   Parasitic *parasitic_network =
+		     parasitics->findParasiticNetwork(drvr_pin, parasitic_ap);
+		   parasitics->reduceToPiElmore(parasitic_network, drvr_pin,
+						dcalc_ap_->operatingConditions(),
+						dcalc_ap_->corner(),
+						dcalc_ap_->constraintMinMax(),
+						parasitic_ap);
+		 }
+	       });
+  return reduce_drvrs_.size();
+}
+
+////////////////////////////////////////////////////////////////
+
+// Forward search of the whole graph from the level 0 vertices.
+size_t
+StaBench::bfsVisits()
+{
+  Graph *graph = sta_->graph();
+  SearchPred1 search_pred(sta_);
+  BfsFwdIterator iter(BfsIndex::other, &search_pred, sta_);
+  VertexIterator vertex_iter(graph);
+  while (vertex_iter.hasNext()) {
+    Vertex *vertex = vertex_iter.next();
+    if (vertex->level() == 0)
+      iter.enqueue(vertex);
+  }
+  BenchVisitor visitor(&iter);
+  return iter.visitParallel(sta_->levelize()->maxLevel(), &visitor);
+}
+
+////////////////////////////////////////////////////////////////
+
+void
+StaBench::findTags()
+{
+  Search *search = sta_->search();
+  for (TagIndex i = 0; i < search->tagCount(); i++) {
+    Tag *tag = search->tag(i);
+    if (tag)
+      tags_.push_back(tag);
+  }
+}
+
+// Lookups of existing tags, the common case during arrival search.
+size_t
+StaBench::tagLookups()
+{
+  if (tags_.empty())
+    return 0;
+  Search *search = sta_->search();
+  size_t lookup_count = tags_.size() * bench_tag_lookups;
+  forEachChunk(lookup_count, sta_->threadPool(),
+	       [&] (size_t begin, size_t end, int) {
+		 for (size_t i = begin; i < end; i++) {
+		   Tag *tag = tags_[i % tags_.size()];
+		   search->findTag(tag->transition(),
+				   tag->pathAnalysisPt(sta_),
+				   tag->clkInfo(),
+				   tag->isClock(),
+				   tag->inputDelay(),
+				   tag->isSegmentStart(),
+				   tag->states(),
+				   false);
+		 }
+	       });
+  return lookup_count;
+}
+
+////////////////////////////////////////////////////////////////
+
+void
+StaBench::findPathEnds()
+{
+  PathEndSeq *ends = sta_->findPathEnds(nullptr, nullptr, nullptr, false,
+					nullptr, MinMaxAll::max(),
+					bench_path_enum_ends, 1, false,
+					-INF, INF, true, nullptr,
+					true, false, false, false,
+					false, false);
+  if (ends) {
+    PathEndSeq::Iterator end_iter(ends);
+    while (end_iter.hasNext())
+      path_ends_.push_back(end_iter.next());
+  }
+}
+
+// Enumerate the worst paths to each endpoint.
+size_t
+StaBench::pathEnums()
+{
+  std::vector<size_t> counts(sta_->threadPool()
+			     ? sta_->threadPool()->threadCount() : 1, 0);
+  forEachChunk(path_ends_.size(), sta_->threadPool(),
+	       [&] (size_t begin, size_t end, int thread_index) {
+		 for (size_t i = begin; i < end; i++) {
+		   PathEnum path_enum(bench_path_enum_count,
+				      bench_path_enum_count,
+				      false, true, sta_);
+		   path_enum.insert(path_ends_[i]->copy());
+		   for (int n = 0;
+			path_enum.hasNext() && n < bench_path_enum_count;
+			n++) {
+		     delete path_enum.next();
+		     counts[thread_index]++;
+		   }
+		 }
+	       });
+  size_t path_count = 0;
+  for (size_t count : counts)
+    path_count += count;
+  return path_count;
+}
+
+////////////////////////////////////////////////////////////////
+
+static bool
+benchEval(Tcl_Interp *interp,
+	  const string &cmd)
+{
+  if (Tcl_Eval(interp, cmd.c_str()) != TCL_OK) {
+    fprintf(stderr, "Error: %s\n", Tcl_GetStringResult(interp));
+    return false;
+  }
+  return true;
+}
+
+static bool
+readBenchDesign(Tcl_Interp *interp,
+		const char *dir)
+{
+  string cmd;
+  stringPrint(cmd, "read_liberty %s/bench.lib;"
+	      "read_verilog %s/bench.v;"
+	      "link_design bench;"
+	      "read_sdc %s/bench.sdc;"
+	      "read_spef %s/bench.spef",
+	      dir, dir, dir, dir);
+  return benchEval(interp, cmd);
+}
+
+} // namespace
+
+using sta::Sta;
+using sta::StaBench;
+using sta::findCmdLineKey;
+
+int
+main(int argc,
+     char **argv)
+{
+  if (argc < 2 || argv[argc - 1][0] == '-') {
+    printf("Usage: %s [-threads \"count...\"] [-reps count] design_dir\n",
+	   argv[0]);
+    return 1;
+  }
+  const char *design_dir = argv[argc - 1];
+  std::vector<int> thread_counts;
+  const char *threads_arg = findCmdLineKey(argc, argv, "-threads");
+  std::istringstream threads_stream(threads_arg ? threads_arg : "1");
+  int thread_count;
+  while (threads_stream >> thread_count)
+    thread_counts.push_back(thread_count);
+  const char *reps_arg = findCmdLineKey(argc, argv, "-reps");
+  int reps = reps_arg ? atoi(reps_arg) : 10;
+  if (reps < 1)
+    reps = 1;
+
+  sta::initSta();
+  Sta *sta = new Sta;
+  Sta::setSta(sta);
+  sta->makeComponents();
+
+  Tcl_FindExecutable(argv[0]);
+  Tcl_Interp *interp = Tcl_CreateInterp();
+  Tcl_Init(interp);
+  Sta_Init(interp);
+  sta->setTclInterp(interp);
+  sta::evalTclInit(interp, sta::tcl_inits);
+  Tcl_Eval(interp, "sta::define_sta_cmds");
+  Tcl_Eval(interp, "namespace import sta::*");
+  if (!sta::readBenchDesign(interp, design_dir))
+    return 1;
+
+  StaBench bench(sta, reps);
+  bench.setup();
+  for (int thread_count : thread_counts)
+    bench.run(thread_count);
+  return 0;
+}
@@ -16,11 +16,18 @@
 
 #include <tcl.h>
 #include <stdlib.h>
+#include <string.h>
 #include "Machine.hh"
+#include "StaConfig.hh"  // STA_VERSION
 #include "StringUtil.hh"
 #include "Vector.hh"
+#include "Map.hh"
+#include "Error.hh"
+#include "Report.hh"
+#include "Search.hh"
 #include "Sta.hh"
 #include "StaMain.hh"
+#include "StaServer.hh"
 
 namespace sta {
 
@@ -34,6 +41,17 @@ static SwigInitFunc sta_swig_init;
 
 static const char *init_filename = "[file join $env(HOME) .sta]";
 
+static bool
+staBench(Sta *sta,
+	 const char *script,
+	 const char *output_filename,
+	 Tcl_Interp *interp);
+static void
+reportBenchSummary(Sta *sta,
+		   const char *script,
+		   double elapsed,
+		   double cpu);
+
 void
 staMain(Sta *sta,
 	int argc,
@@ -131,9 +149,122 @@ staTclAppInit(Tcl_Interp *interp)
   if (file)
     sourceTclFile(file, true, true, interp);
 
+  // "-bench script" sources script after cmd_file and reports a json
+  // performance summary.
+  char *bench_script = findCmdLineKey(argc, argv, "-bench");
+  if (bench_script) {
+    char *bench_output = findCmdLineKey(argc, argv, "-bench_output");
+    exit(staBench(sta, bench_script, bench_output, interp) ? 0 : 1);
+  }
+
+  // "-server port" serves timing queries after cmd_file is sourced.
+  // Only local clients can connect unless -server_address is given.
+  char *server_port = findCmdLineKey(argc, argv, "-server");
+  if (server_port) {
+    if (isDigits(server_port)) {
+      char *server_address = findCmdLineKey(argc, argv, "-server_address");
+      bool server_eval = findCmdLineFlag(argc, argv, "-server_eval");
+      if (!staServer(sta, atoi(server_port), server_address, server_eval,
+		     interp)) {
+	fprintf(stderr, "Error: cannot open server port %s.\n", server_port);
+	exit(1);
+      }
+      exit(0);
+    }
+    else
+      fprintf(stderr,"Warning: -server must be a port number.\n");
+  }
+
   return TCL_OK;
 }
 
+// Source script with the phase stats cleared and the thread profile
+// enabled and report the summary to output_filename (or stdout).
+static bool
+staBench(Sta *sta,
+	 const char *script,
+	 const char *output_filename,
+	 Tcl_Interp *interp)
+{
+  sta->clearPhaseStats();
+  sta->clearThreadProfile();
+  sta->setThreadProfileEnabled(true);
+  double elapsed_begin = elapsedRunTime();
+  double cpu_begin = userRunTime() + systemRunTime();
+  if (sourceTclFile(script, false, false, interp) != TCL_OK) {
+    fprintf(stderr, "Error: -bench %s: %s\n",
+	    script, Tcl_GetStringResult(interp));
+    return false;
+  }
+  double elapsed = elapsedRunTime() - elapsed_begin;
+  double cpu = userRunTime() + systemRunTime() - cpu_begin;
+  Report *report = sta->report();
+  if (output_filename) {
+    try {
+      report->redirectFileBegin(output_filename);
+    }
+    catch (FileNotWritable &) {
+      fprintf(stderr, "Error: -bench_output %s is not writable.\n",
+	      output_filename);
+      return false;
+    }
+  }
+  reportBenchSummary(sta, script, elapsed, cpu);
+  if (output_filename)
+    report->redirectFileEnd();
+  return true;
+}
+
+// The summary is one json object so release qualification runs can be
+// compared across versions.
+static void
+reportBenchSummary(Sta *sta,
+		   const char *script,
+		   double elapsed,
+		   double cpu)
+{
+  Report *report = sta->report();
+  report->print("{\"version\": \"%s\",\n", STA_VERSION);
+  string script_json;
+  jsonString(script, script_json);
+  report->print("\"script\": %s,\n", script_json.c_str());
+  report->print("\"threads\": %u,\n", sta->threadCount());
+  report->print("\"wall\": %.3f, \"cpu\": %.3f, \"peak_memory\": %lu,\n",
+		elapsed, cpu,
+		static_cast<unsigned long>(peakMemoryUsage()));
+  report->print("\"tags\": %lu, \"tag_groups\": %lu, \"clk_infos\": %lu,\n",
+		static_cast<unsigned long>(sta->tagCount()),
+		static_cast<unsigned long>(sta->tagGroupCount()),
+		static_cast<unsigned long>(sta->clkInfoCount()));
+  // Pairs of arrival count and the number of vertices with that count.
+  report->print("\"arrival_count_histogram\": [");
+  if (sta->graph()) {
+    Vector<int> vertex_counts;
+    sta->search()->arrivalCountHistogram(vertex_counts);
+    bool first = true;
+    for (size_t arrival_count = 0;
+	 arrival_count < vertex_counts.size();
+	 arrival_count++) {
+      int vertex_count = vertex_counts[arrival_count];
+      if (vertex_count > 0) {
+	report->print("%s[%lu, %d]",
+		      first ? "" : ", ",
+		      static_cast<unsigned long>(arrival_count),
+		      vertex_count);
+	first = false;
+      }
+    }
+  }
+  report->print("],\n");
+  report->print("\"phase_stats\": ");
+  sta->reportPhaseStats(true);
+  report->print(",\n\"memory\": ");
+  sta->reportMemory(true);
+  report->print(",\n\"thread_profile\": ");
+  sta->reportThreadProfileJson();
+  report->print("}\n");
+}
+
 bool
 findCmdLineFlag(int argc,
 		char **argv,
@@ -161,7 +292,8 @@ findCmdLineKey(int argc,
 }
 
 // Use overridden version of source to echo cmds and results.
-void
+// Returns the Tcl result code.
+int
 sourceTclFile(const char *filename,
 	      bool echo,
 	      bool verbose,
@@ -172,7 +304,40 @@ sourceTclFile(const char *filename,
 	      echo ? "-echo " : "",
 	      verbose ? "-verbose " : "",
 	      filename);
-  Tcl_Eval(interp, cmd.c_str());
+  return Tcl_Eval(interp, cmd.c_str());
+}
+
+// Proc definitions of lazily loaded groups indexed by group name.
+typedef Map<string, string> TclInitGroupMap;
+
+// sta::tcl_init_group_procs group
+// Return the proc definitions of group for sta::load_tcl_group.
+static int
+tclInitGroupProcsCmd(ClientData client_data,
+		     Tcl_Interp *interp,
+		     int objc,
+		     Tcl_Obj *const objv[])
+{
+  if (objc != 2) {
+    Tcl_WrongNumArgs(interp, 1, objv, "group");
+    return TCL_ERROR;
+  }
+  TclInitGroupMap *groups = static_cast<TclInitGroupMap*>(client_data);
+  auto group_iter = groups->find(Tcl_GetString(objv[1]));
+  if (group_iter == groups->end()) {
+    Tcl_AppendResult(interp, "unknown tcl init group ",
+		     Tcl_GetString(objv[1]), nullptr);
+    return TCL_ERROR;
+  }
+  const string &procs = group_iter->second;
+  Tcl_SetObjResult(interp, Tcl_NewStringObj(procs.c_str(), procs.size()));
+  return TCL_OK;
+}
+
+static void
+deleteTclInitGroups(ClientData client_data)
+{
+  delete static_cast<TclInitGroupMap*>(client_data);
 }
 
 void
@@ -189,13 +354,33 @@ evalTclInit(Tcl_Interp *interp,
   for (const char **e = inits; *e; e++) {
     const char *init = *e;
     size_t init_length = strlen(init);
-    for (const char *s = init; s < &init[init_length]; s += 3) {
-      char code[4] = {s[0], s[1], s[2], '\0'};
-      char ch = atoi(code);
-      *u++ = ch;
-    }
+    for (const char *s = init; s < &init[init_length]; s += 3)
+      *u++ = (s[0] - '0') * 100 + (s[1] - '0') * 10 + (s[2] - '0');
   }
   *u = '\0';
+
+  // The startup script is followed by the lazily loaded proc groups
+  // encoded by TclEncode.tcl as "\001group\n" followed by the group procs.
+  char *group_begin = strchr(unencoded, '\001');
+  if (group_begin) {
+    TclInitGroupMap *groups = new TclInitGroupMap;
+    *group_begin = '\0';
+    while (group_begin) {
+      char *name = group_begin + 1;
+      char *procs = strchr(name, '\n');
+      group_begin = strchr(name, '\001');
+      if (procs && (group_begin == nullptr || procs < group_begin)) {
+	string &group_procs = (*groups)[string(name, procs - name)];
+	if (group_begin)
+	  group_procs.assign(procs + 1, group_begin - procs - 1);
+	else
+	  group_procs.assign(procs + 1);
+      }
+    }
+    Tcl_CreateObjCommand(interp, "sta::tcl_init_group_procs",
+			 tclInitGroupProcsCmd, groups, deleteTclInitGroups);
+  }
+
   if (Tcl_Eval(interp, unencoded) != TCL_OK) {
     // Get a backtrace for the error.
     Tcl_Eval(interp, "$errorInfo");
@@ -210,7 +395,7 @@ evalTclInit(Tcl_Interp *interp,
 void
 showUseage(char *prog)
 {
-  printf("Usage: %s [-help] [-version] [-no_init] [-f cmd_file]\n", prog);
+  printf("Usage: %s [-help] [-version] [-no_init] [-f cmd_file] [-bench script] [-server port]\n", prog);
   printf("  -help              show help and exit\n");
   printf("  -version           show version and exit\n");
   printf("  -no_init           do not read .sta init file\n");
@@ -218,6 +403,12 @@ showUseage(char *prog)
   printf("  -f cmd_file        source cmd_file\n");
   printf("  -threads count|max use count threads\n");
   printf("  -no_splash         do not show the license splash at startup\n");
+  printf("  -bench script      source script after cmd_file, report a json\n");
+  printf("                     performance summary and exit\n");
+  printf("  -bench_output file write the -bench summary to file\n");
+  printf("  -server port       serve timing queries on port after cmd_file\n");
+  printf("  -server_address ip listen on ip instead of the loopback address\n");
+  printf("  -server_eval       allow server clients to evaluate tcl commands\n");
 }
 
 } // namespace
@@ -48,6 +48,8 @@ staTclAppInit(Tcl_Interp *interp);
 // unencodes the string and evals it.  This packages the TCL init
 // files as part of the executable so they don't have to be shipped as
 // separate files that have to be located and loaded at run time.
+// Proc definitions that TclEncode.tcl defers until first use are
+// kept unparsed for sta::load_tcl_group.
 void
 evalTclInit(Tcl_Interp *interp,
 	    const char *inits[]);
@@ -74,7 +76,7 @@ parseCmdsArg(int argc,
 	     bool &native_cmds,
 	     bool &compatibility_cmds);
 
-void
+int
 sourceTclFile(const char *filename,
 	      bool echo,
 	      bool verbose,
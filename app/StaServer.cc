@@ -0,0 +1,352 @@
+// OpenSTA, Static Timing Analyzer
+// Copyright (c) 2019, Parallax Software, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#include <tcl.h>
+#include <stdint.h>
+#include <string.h>
+#include <errno.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <string>
+#include <vector>
+#include "Machine.hh"
+#include "DisallowCopyAssign.hh"
+#include "Report.hh"
+#include "Error.hh"
+#include "StringUtil.hh"
+#include "MinMax.hh"
+#include "Network.hh"
+#include "Sta.hh"
+#include "StaServer.hh"
+
+// Writes to a client that has disconnected fail with EPIPE instead of
+// raising SIGPIPE. Without MSG_NOSIGNAL (macOS) client sockets are
+// marked SO_NOSIGPIPE.
+#ifndef MSG_NOSIGNAL
+#define MSG_NOSIGNAL 0
+#endif
+
+namespace sta {
+
+using std::string;
+
+class StaServer
+{
+public:
+  StaServer(Sta *sta,
+	    bool allow_eval,
+	    Tcl_Interp *interp);
+  bool serve(int port,
+	     const char *address);
+
+private:
+  DISALLOW_COPY_AND_ASSIGN(StaServer);
+  // Return false when the client closes the connection or
+  // sends a shutdown request.
+  bool request(int client);
+  void pinQuery(ServerOp op);
+  void updateTiming();
+  void eval();
+  void error(const char *msg);
+  void setStatus(uint32_t status);
+  bool readBytes(int client,
+		 void *bytes,
+		 size_t length);
+  bool writeBytes(int client,
+		  const void *bytes,
+		  size_t length);
+  bool writeResponse(int client);
+  bool payloadUint(uint32_t &value);
+
+  Sta *sta_;
+  bool allow_eval_;
+  Tcl_Interp *interp_;
+  std::vector<char> request_;
+  size_t request_pos_;
+  // Response length and status are reserved at the front of the
+  // buffer so query results are written in place and sent once.
+  std::vector<char> response_;
+  bool shutdown_;
+
+  // Length and status words keep the results float aligned.
+  static const size_t response_header_length_ = sizeof(uint32_t) * 2;
+};
+
+StaServer::StaServer(Sta *sta,
+		     bool allow_eval,
+		     Tcl_Interp *interp) :
+  sta_(sta),
+  allow_eval_(allow_eval),
+  interp_(interp),
+  request_pos_(0),
+  shutdown_(false)
+{
+}
+
+bool
+StaServer::serve(int port,
+		 const char *address)
+{
+  struct sockaddr_in addr;
+  memset(&addr, 0, sizeof(addr));
+  addr.sin_family = AF_INET;
+  addr.sin_port = htons(port);
+  if (address) {
+    if (inet_pton(AF_INET, address, &addr.sin_addr) != 1)
+      return false;
+  }
+  else
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  int listener = socket(AF_INET, SOCK_STREAM, 0);
+  if (listener < 0)
+    return false;
+  int reuse = 1;
+  setsockopt(listener, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+  if (bind(listener, reinterpret_cast<struct sockaddr*>(&addr),
+	   sizeof(addr)) < 0
+      || listen(listener, 1) < 0) {
+    close(listener);
+    return false;
+  }
+  sta_->report()->print("Serving timing queries on %s port %d.\n",
+			address ? address : "127.0.0.1", port);
+  while (!shutdown_) {
+    int client = accept(listener, nullptr, nullptr);
+    if (client >= 0) {
+#ifdef SO_NOSIGPIPE
+      int no_sigpipe = 1;
+      setsockopt(client, SOL_SOCKET, SO_NOSIGPIPE,
+		 &no_sigpipe, sizeof(no_sigpipe));
+#endif
+      while (request(client)) {}
+      close(client);
+    }
+  }
+  close(listener);
+  return true;
+}
+
+bool
+StaServer::request(int client)
+{
+  uint32_t length;
+  if (!readBytes(client, &length, sizeof(length))
+      || length == 0)
+    return false;
+  response_.resize(response_header_length_);
+  setStatus(server_ok);
+  if (length > server_max_request_length) {
+    // The rest of the request is not read, so close the connection.
+    error("request too long.");
+    writeResponse(client);
+    return false;
+  }
+  request_.resize(length);
+  if (!readBytes(client, &request_[0], length))
+    return false;
+  request_pos_ = 1;
+  ServerOp op = static_cast<ServerOp>(request_[0]);
+  try {
+    switch (op) {
+    case ServerOp::pin_slacks:
+    case ServerOp::pin_arrivals:
+    case ServerOp::pin_slews:
+      pinQuery(op);
+      break;
+    case ServerOp::update_timing:
+      updateTiming();
+      break;
+    case ServerOp::eval:
+      if (allow_eval_)
+	eval();
+      else
+	error("eval requests are disabled (see -server_eval).");
+      break;
+    case ServerOp::shutdown:
+      shutdown_ = true;
+      break;
+    default:
+      error("unknown request.");
+      break;
+    }
+  }
+  catch (StaException &excp) {
+    error(excp.what());
+  }
+  return writeResponse(client)
+    && !shutdown_;
+}
+
+bool
+StaServer::writeResponse(int client)
+{
+  uint32_t response_length = response_.size() - sizeof(uint32_t);
+  memcpy(&response_[0], &response_length, sizeof(response_length));
+  return writeBytes(client, &response_[0], response_.size());
+}
+
+void
+StaServer::pinQuery(ServerOp op)
+{
+  uint32_t pin_count;
+  // Skip the min_max byte.
+  request_pos_ = 2;
+  if (!payloadUint(pin_count)) {
+    error("pin query payload too short.");
+    return;
+  }
+  const MinMax *min_max = request_[1] ? MinMax::max() : MinMax::min();
+  Network *network = sta_->sdcNetwork();
+  PinSeq pins;
+  for (uint32_t i = 0; i < pin_count; i++) {
+    const char *name = &request_[0] + request_pos_;
+    const void *end = memchr(name, '\0', request_.size() - request_pos_);
+    if (end == nullptr) {
+      error("pin name not terminated.");
+      return;
+    }
+    Pin *pin = network->findPin(name);
+    if (pin == nullptr) {
+      string msg;
+      stringPrint(msg, "pin %s not found.", name);
+      error(msg.c_str());
+      return;
+    }
+    pins.push_back(pin);
+    request_pos_ = static_cast<const char*>(end) - &request_[0] + 1;
+  }
+  response_.resize(response_header_length_ + pin_count * sizeof(float));
+  if (pin_count > 0) {
+    float *values =
+      reinterpret_cast<float*>(&response_[response_header_length_]);
+    switch (op) {
+    case ServerOp::pin_slacks:
+      sta_->pinSlacks(&pins, min_max, values);
+      break;
+    case ServerOp::pin_arrivals:
+      sta_->pinArrivals(&pins, min_max, values);
+      break;
+    case ServerOp::pin_slews:
+      sta_->pinSlews(&pins, min_max, values);
+      break;
+    default:
+      break;
+    }
+  }
+}
+
+void
+StaServer::updateTiming()
+{
+  bool full = request_.size() > 1 && request_[1];
+  bool requireds = request_.size() > 2 && request_[2];
+  sta_->updateTiming(full);
+  if (requireds)
+    sta_->findRequireds();
+}
+
+void
+StaServer::eval()
+{
+  string script(request_.begin() + 1, request_.end());
+  Report *report = sta_->report();
+  report->redirectStringBegin();
+  int result = Tcl_Eval(interp_, script.c_str());
+  const char *output = report->redirectStringEnd();
+  if (output)
+    response_.insert(response_.end(), output, output + strlen(output));
+  const char *tcl_result = Tcl_GetStringResult(interp_);
+  response_.insert(response_.end(), tcl_result,
+		   tcl_result + strlen(tcl_result));
+  if (result != TCL_OK)
+    setStatus(server_error);
+}
+
+void
+StaServer::error(const char *msg)
+{
+  response_.resize(response_header_length_);
+  setStatus(server_error);
+  response_.insert(response_.end(), msg, msg + strlen(msg));
+}
+
+void
+StaServer::setStatus(uint32_t status)
+{
+  memcpy(&response_[sizeof(uint32_t)], &status, sizeof(status));
+}
+
+bool
+StaServer::payloadUint(uint32_t &value)
+{
+  if (request_pos_ + sizeof(value) > request_.size())
+    return false;
+  memcpy(&value, &request_[request_pos_], sizeof(value));
+  request_pos_ += sizeof(value);
+  return true;
+}
+
+bool
+StaServer::readBytes(int client,
+		     void *bytes,
+		     size_t length)
+{
+  char *ptr = static_cast<char*>(bytes);
+  while (length > 0) {
+    ssize_t count = read(client, ptr, length);
+    if (count <= 0)
+      return false;
+    ptr += count;
+    length -= count;
+  }
+  return true;
+}
+
+bool
+StaServer::writeBytes(int client,
+		      const void *bytes,
+		      size_t length)
+{
+  const char *ptr = static_cast<const char*>(bytes);
+  while (length > 0) {
+    ssize_t count = send(client, ptr, length, MSG_NOSIGNAL);
+    if (count < 0 && errno == EINTR)
+      continue;
+    // EPIPE when the client has disconnected.
+    if (count <= 0)
+      return false;
+    ptr += count;
+    length -= count;
+  }
+  return true;
+}
+
+////////////////////////////////////////////////////////////////
+
+bool
+staServer(Sta *sta,
+	  int port,
+	  const char *address,
+	  bool allow_eval,
+	  Tcl_Interp *interp)
+{
+  StaServer server(sta, allow_eval, interp);
+  return server.serve(port, address);
+}
+
+} // namespace
@@ -0,0 +1,72 @@
+// OpenSTA, Static Timing Analyzer
+// Copyright (c) 2019, Parallax Software, Inc.
+// 
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+// 
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+// 
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#ifndef STA_SERVER_H
+#define STA_SERVER_H
+
+struct Tcl_Interp;
+
+namespace sta {
+
+class Sta;
+
+// Binary timing query protocol served on a TCP port.
+// Integers and floats are in host byte order.
+//
+// Request:  uint32 length, uint8 op, payload (length - 1 bytes)
+// Response: uint32 length, uint32 status, payload (length - 4 bytes)
+//  status is server_ok or server_error; error payloads are messages.
+//
+// Pin queries (pin_slacks, pin_arrivals, pin_slews)
+//  payload:  uint8 min_max (0 min, 1 max), uint32 pin_count,
+//            pin_count NUL terminated hierarchical pin names
+//  response: float[pin_count] in seconds
+// update_timing
+//  payload:  uint8 full, uint8 requireds (optional)
+//  With requireds also find all required times.
+// eval
+//  payload:  Tcl script (for example an ECO batch or a report)
+//  response: report output followed by the Tcl result
+//  Only served when eval is enabled because clients can run any
+//  command as the sta user.
+// shutdown
+//  Stop serving and return.
+enum class ServerOp : unsigned char { pin_slacks = 1,
+				      pin_arrivals,
+				      pin_slews,
+				      update_timing,
+				      eval,
+				      shutdown };
+
+static const unsigned server_ok = 0;
+static const unsigned server_error = 1;
+// Longer requests are rejected and the connection is closed.
+static const unsigned server_max_request_length = 64 * 1024 * 1024;
+
+// Serve clients one at a time on port until a shutdown request.
+// address is an IPv4 address to listen on; nullptr listens on the
+// loopback address so only local clients can connect.
+// Eval requests are rejected unless allow_eval is true.
+// Return false if the port could not be opened.
+bool
+staServer(Sta *sta,
+	  int port,
+	  const char *address,
+	  bool allow_eval,
+	  Tcl_Interp *interp);
+
+} // namespace
+#endif
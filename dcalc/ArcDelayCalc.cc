@@ -44,6 +44,26 @@ ArcDelayCalc::gateModel(TimingArc *arc,
   return dynamic_cast<GateTimingModel*>(model(arc, dcalc_ap));
 }
 
+void
+ArcDelayCalc::gateDelays(const ArcDcalcArgSeq &args,
+			 ArcDcalcResultSeq &results)
+{
+  results.resize(args.size());
+  for (size_t i = 0; i < args.size(); i++) {
+    const ArcDcalcArg &arg = args[i];
+    ArcDcalcResult &result = results[i];
+    gateDelay(arg.drvr_cell_, arg.arc_, arg.in_slew_, arg.load_cap_,
+	      arg.drvr_parasitic_, arg.related_out_cap_, arg.pvt_,
+	      arg.dcalc_ap_, result.gate_delay_, result.drvr_slew_);
+    size_t load_count = arg.load_pins_.size();
+    result.wire_delays_.resize(load_count);
+    result.load_slews_.resize(load_count);
+    for (size_t j = 0; j < load_count; j++)
+      loadDelay(arg.load_pins_[j], result.wire_delays_[j],
+		result.load_slews_[j]);
+  }
+}
+
 CheckTimingModel *
 ArcDelayCalc::checkModel(TimingArc *arc,
 			 const DcalcAnalysisPt *dcalc_ap) const
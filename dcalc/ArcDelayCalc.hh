@@ -19,6 +19,7 @@
 
 #include <string>
 #include "DisallowCopyAssign.hh"
+#include "Vector.hh"
 #include "MinMax.hh"
 #include "Delay.hh"
 #include "StaState.hh"
@@ -31,6 +32,11 @@ using std::string;
 
 class Parasitic;
 class DcalcAnalysisPt;
+class ArcDcalcArg;
+class ArcDcalcResult;
+
+typedef Vector<ArcDcalcArg> ArcDcalcArgSeq;
+typedef Vector<ArcDcalcResult> ArcDcalcResultSeq;
 
 // Delay calculator class hierarchy.
 //  ArcDelayCalc
@@ -55,6 +61,10 @@ public:
   virtual Parasitic *findParasitic(const Pin *drvr_pin,
 				   const TransRiseFall *tr,
 				   const DcalcAnalysisPt *dcalc_ap) = 0;
+  // True if the parasitics reduced by findParasitic are saved in
+  // parasitics_, so they can be reduced for all drivers in parallel
+  // before delay calculation.
+  virtual bool savesReducedParasitics() const { return false; }
 
   // Find the wire delays and slews for an input port without a driving cell.
   // This call primarily initializes the load delay/slew iterator.
@@ -77,6 +87,19 @@ public:
 			 // Return values.
 			 ArcDelay &gate_delay,
 			 Slew &drvr_slew) = 0;
+  // True if the calculator finds the delays of many independent gate
+  // arcs faster with one call to gateDelays, for example by offloading
+  // them to an accelerator. GraphDelayCalc1 then collects the driver
+  // arcs of each level and passes them to gateDelays before the level
+  // is visited.
+  virtual bool batchesGateDelays() const { return false; }
+  // Find the gate delays, driver slews and load wire delays/slews for
+  // args. finishDrvrPin is called after the batch, so parasitics found
+  // for the args are valid during the call.
+  // The default calls gateDelay and loadDelay for each arg.
+  virtual void gateDelays(const ArcDcalcArgSeq &args,
+			  // Return value.
+			  ArcDcalcResultSeq &results);
   // Find the wire delay and load slew of a load pin.
   // Called after inputPortDelay or gateDelay.
   virtual void loadDelay(const Pin *load_pin,
@@ -142,5 +165,32 @@ private:
   DISALLOW_COPY_AND_ASSIGN(ArcDelayCalc);
 };
 
+// Inputs for one gate timing arc in ArcDelayCalc::gateDelays.
+class ArcDcalcArg
+{
+public:
+  const LibertyCell *drvr_cell_;
+  TimingArc *arc_;
+  Slew in_slew_;
+  // Pass in load_cap or drvr_parasitic.
+  float load_cap_;
+  Parasitic *drvr_parasitic_;
+  float related_out_cap_;
+  const Pvt *pvt_;
+  const DcalcAnalysisPt *dcalc_ap_;
+  PinSeq load_pins_;
+};
+
+// Results for one ArcDcalcArg.
+class ArcDcalcResult
+{
+public:
+  ArcDelay gate_delay_;
+  Slew drvr_slew_;
+  // Indexed like ArcDcalcArg::load_pins_.
+  Vector<ArcDelay> wire_delays_;
+  Vector<Slew> load_slews_;
+};
+
 } // namespace
 #endif
@@ -44,7 +44,6 @@
 namespace sta {
 
 // wireload8 is n^2
-// do not delete arnoldi parasitics
 // handle rspf parasitics?
 
 // mv static functions to ArnoldiDelayCalc
@@ -116,6 +115,7 @@ public:
   virtual Parasitic *findParasitic(const Pin *drvr_pin,
 				   const TransRiseFall *tr,
 				   const DcalcAnalysisPt *dcalc_ap);
+  virtual bool savesReducedParasitics() const { return true; }
   virtual void gateDelay(const LibertyCell *drvr_cell,
 			 TimingArc *arc,
 			 const Slew &in_slew,
@@ -288,6 +288,16 @@ ArnoldiDelayCalc::findParasitic(const Pin *drvr_pin,
     }
     
     if (parasitic_network) {
+      // Models reduced from annotated networks are saved in the
+      // parasitics until the network changes.
+      if (!delete_parasitic_network) {
+	Parasitic *parasitic =
+	  parasitics_->findReducedModel(parasitic_network, drvr_pin, drvr_tr,
+					op_cond, corner, cnst_min_max,
+					parasitic_ap);
+	if (parasitic)
+	  return parasitic;
+      }
       Parasitic *parasitic =
 	reduce_->reduceToArnoldi(parasitic_network,
 				 drvr_pin,
@@ -297,8 +307,13 @@ ArnoldiDelayCalc::findParasitic(const Pin *drvr_pin,
       if (delete_parasitic_network) {
 	Net *net = network_->net(drvr_pin);
 	parasitics_->deleteParasiticNetwork(net, parasitic_ap);
+	// Wireload models are deleted after the drvr pin delay calc.
+	unsaved_parasitics_.push_back(parasitic);
       }
-      reduced_parasitic_drvrs_.push_back(drvr_pin);
+      else
+	parasitics_->saveReducedModel(parasitic_network, drvr_pin, drvr_tr,
+				      op_cond, corner, cnst_min_max,
+				      parasitic_ap, parasitic);
       return parasitic;
     }
   }
@@ -1359,13 +1374,13 @@ ArnoldiDelayCalc::ra_rdelay_1(timing_table *tab,
   float c2 = 0.5*c1;
   if (c1==c2)
     return 0.0;
-  ArcDelay d1, d2;
-  Slew s1, s2;
-  tab->table->gateDelay(tab->cell, tab->pvt, tab->in_slew,
-                        c1, tab->relcap, pocv_enabled_, d1, s1);
-  tab->table->gateDelay(tab->cell, tab->pvt, tab->in_slew,
-                        c2, tab->relcap, pocv_enabled_, d2, s2);
-  double dt50 = delayAsFloat(d1)-delayAsFloat(d2);
+  float in_slews[2] = {tab->in_slew, tab->in_slew};
+  float caps[2] = {c1, c2};
+  ArcDelay delays[2];
+  Slew slews[2];
+  tab->table->gateDelays(tab->cell, tab->pvt, in_slews, caps, tab->relcap,
+                         2, pocv_enabled_, delays, slews);
+  double dt50 = delayAsFloat(delays[0])-delayAsFloat(delays[1]);
   if (dt50 <= 0.0)
     return 0.0;
   double rdelay = dt50/(c1-c2);
@@ -163,9 +163,8 @@ ArnoldiReduce::loadWork()
   pt_map_.clear();
 
   int resistor_count = 0;
-  ConcreteParasiticDeviceSet devices;
-  parasitic_network_->devices(&devices);
-  ConcreteParasiticDeviceSet::Iterator device_iter(devices);
+  ConcreteParasiticDeviceSeq *devices = parasitic_network_->devices();
+  ConcreteParasiticDeviceSeq::Iterator device_iter(devices);
   while (device_iter.hasNext()) {
     ParasiticDevice *device = device_iter.next();
     if (parasitics_->isResistor(device))
@@ -223,7 +222,7 @@ ArnoldiReduce::loadWork()
   }
   
   ts_edge **eV = ts_eV;
-  ConcreteParasiticDeviceSet::Iterator device_iter2(devices);
+  ConcreteParasiticDeviceSeq::Iterator device_iter2(devices);
   while (device_iter2.hasNext()) {
     ParasiticDevice *device = device_iter2.next();
     if (parasitics_->isResistor(device)) {
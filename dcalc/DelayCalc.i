@@ -48,4 +48,34 @@ set_delay_calc_incremental_tolerance(float tol)
   sta::Sta::sta()->setIncrementalDelayTolerance(tol);
 }
 
+bool
+gate_delay_cache()
+{
+  return sta::Sta::sta()->gateDelayCache();
+}
+
+void
+set_gate_delay_cache(bool enable)
+{
+  sta::Sta::sta()->setGateDelayCache(enable);
+}
+
+bool
+dcalc_level_batch()
+{
+  return sta::Sta::sta()->dcalcLevelBatch();
+}
+
+void
+set_dcalc_level_batch(bool enable)
+{
+  sta::Sta::sta()->setDcalcLevelBatch(enable);
+}
+
+void
+report_gate_delay_cache_cmd()
+{
+  sta::Sta::sta()->reportGateDelayCache();
+}
+
 %} // inline
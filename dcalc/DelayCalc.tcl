@@ -121,5 +121,16 @@ proc set_delay_calculator { alg } {
   }
 }
 
+################################################################
+
+define_cmd_args "report_gate_delay_cache" {}
+
+# Report hits and misses of the gate delay cache enabled by
+# the sta_gate_delay_cache variable.
+proc report_gate_delay_cache { args } {
+  check_argc_eq0 "report_gate_delay_cache" $args
+  report_gate_delay_cache_cmd
+}
+
 # sta namespace end
 }
@@ -827,6 +827,7 @@ public:
 
 private:
   bool findDriverParamsPi();
+  bool warmStartMatches() const;
   virtual double v0(double t);
   virtual double dv0dt(double t);
   double ipiIceff(double t0,
@@ -854,6 +855,17 @@ private:
   double A_;
   double B_;
   double D_;
+  const TransRiseFall *tr_;
+  // The arcs of a driver pin are calculated one after another with
+  // the same pi model, so the Ceff found for the last arc is used as
+  // the starting point for the next one.
+  bool warm_start_valid_;
+  const LibertyCell *warm_start_cell_;
+  const TransRiseFall *warm_start_tr_;
+  double warm_start_c2_;
+  double warm_start_rpi_;
+  double warm_start_c1_;
+  double warm_start_ceff_;
 };
 
 DmpPi::DmpPi(StaState *sta) :
@@ -871,7 +883,15 @@ DmpPi::DmpPi(StaState *sta) :
   k4_(0.0),
   A_(0.0),
   B_(0.0),
-  D_(0.0)
+  D_(0.0),
+  tr_(nullptr),
+  warm_start_valid_(false),
+  warm_start_cell_(nullptr),
+  warm_start_tr_(nullptr),
+  warm_start_c2_(0.0),
+  warm_start_rpi_(0.0),
+  warm_start_c1_(0.0),
+  warm_start_ceff_(0.0)
 {
 }
 
@@ -894,6 +914,7 @@ DmpPi::init(const LibertyLibrary *drvr_library,
   c1_ = c1;
   c2_ = c2;
   rpi_ = rpi;
+  tr_ = tr;
 
   // Find poles/zeros.
   z1_ = 1.0 / (rpi_ * c1_);
@@ -946,9 +967,36 @@ DmpPi::gateDelaySlew(double &delay,
 bool
 DmpPi::findDriverParamsPi()
 {
+  if (warmStartMatches()) {
+    x_[DmpParam::ceff] = warm_start_ceff_;
+    if (findDriverParams(x_[DmpParam::ceff])) {
+      warm_start_ceff_ = x_[DmpParam::ceff];
+      return true;
+    }
+  }
   double ceff = c1_ + c2_;
   x_[DmpParam::ceff] = ceff;
-  return findDriverParams(x_[DmpParam::ceff]);
+  warm_start_valid_ = findDriverParams(x_[DmpParam::ceff]);
+  if (warm_start_valid_) {
+    warm_start_cell_ = drvr_cell_;
+    warm_start_tr_ = tr_;
+    warm_start_c2_ = c2_;
+    warm_start_rpi_ = rpi_;
+    warm_start_c1_ = c1_;
+    warm_start_ceff_ = x_[DmpParam::ceff];
+  }
+  return warm_start_valid_;
+}
+
+bool
+DmpPi::warmStartMatches() const
+{
+  return warm_start_valid_
+    && warm_start_cell_ == drvr_cell_
+    && warm_start_tr_ == tr_
+    && warm_start_c2_ == c2_
+    && warm_start_rpi_ == rpi_
+    && warm_start_c1_ == c1_;
 }
 
 // Given x_ as a vector of input parameters, fill fvec_ with the
@@ -1741,13 +1789,14 @@ gateModelRd(const LibertyCell *cell,
   float cap1 = static_cast<float>((c1 + c2) * .75);
   float cap2 = cap1 * 1.1F;
   float in_slew1 = static_cast<float>(in_slew);
-  ArcDelay d1, d2;
-  Slew s1, s2;
-  gate_model->gateDelay(cell, pvt, in_slew1, cap1, related_out_cap, pocv_enabled,
-			d1, s1);
-  gate_model->gateDelay(cell, pvt, in_slew1, cap2, related_out_cap, pocv_enabled,
-			d2, s2);
-  return abs(delayAsFloat(d1) - delayAsFloat(d2)) / (cap2 - cap1);
+  float in_slews[2] = {in_slew1, in_slew1};
+  float caps[2] = {cap1, cap2};
+  ArcDelay delays[2];
+  Slew slews[2];
+  gate_model->gateDelays(cell, pvt, in_slews, caps, related_out_cap, 2,
+			 pocv_enabled, delays, slews);
+  return abs(delayAsFloat(delays[0]) - delayAsFloat(delays[1]))
+    / (cap2 - cap1);
 }
 
 void
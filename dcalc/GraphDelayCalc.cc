@@ -42,6 +42,16 @@ GraphDelayCalc::setObserver(DelayCalcObserver *observer)
   delete observer;
 }
 
+void
+GraphDelayCalc::gateDelayCacheStats(size_t &hits,
+				    size_t &misses,
+				    size_t &entries) const
+{
+  hits = 0;
+  misses = 0;
+  entries = 0;
+}
+
 string *
 GraphDelayCalc::reportDelayCalc(Edge *,
 				TimingArc *,
@@ -51,6 +51,10 @@ public:
   virtual void findDelays(Level /* level */) {};
   // Invalidate all delays/slews.
   virtual void delaysInvalid() {};
+  // Delays/slews were restored into the graph without delay calculation.
+  virtual void delaysRestored() {};
+  // All delays/slews are found and none are invalid.
+  virtual bool delaysValid() const { return true; }
   // Invalidate vertex and downstream delays/slews.
   virtual void delayInvalid(Vertex * /* vertex */) {}
 ;
@@ -70,6 +74,19 @@ public:
   virtual void setIncrementalDelayTolerance(float /* tol */) {}
   // Set the observer for edge delay changes.
   virtual void setObserver(DelayCalcObserver *observer);
+  // Reuse gate delays when the input slew, load and parasitic of a
+  // driver timing arc have not changed since the last calculation.
+  virtual bool gateDelayCache() const { return false; }
+  virtual void setGateDelayCache(bool /* enable */) {}
+  virtual void gateDelayCacheStats(// Return values.
+				   size_t &hits,
+				   size_t &misses,
+				   size_t &entries) const;
+  // Find the gate delays of each level in phases: gather the arc
+  // inputs of all of the level's drivers, evaluate them, and then
+  // annotate the results as the level is visited.
+  virtual bool levelBatch() const { return false; }
+  virtual void setLevelBatch(bool /* enable */) {}
   // pin_cap  = net pin capacitances + port external pin capacitance,
   // wire_cap = annotated net capacitance + port external wire capacitance.
   virtual void loadCap(const Pin *drvr_pin,
@@ -102,6 +119,15 @@ public:
   virtual float ceff(Edge *edge,
 		     TimingArc *arc,
 		     const DcalcAnalysisPt *dcalc_ap);
+  // Wireload parasitic of drvr_pin estimated before delay calculation,
+  // or nullptr. The parasitic is owned by the graph delay calculator.
+  virtual Parasitic *estimatedParasitic(const Pin * /* drvr_pin */,
+					const TransRiseFall * /* tr */,
+					const DcalcAnalysisPt * /* dcalc_ap */) const
+  { return nullptr; }
+  // True if the driver shares its net with other drivers.
+  virtual bool isMultiDrvr(const Vertex * /* drvr_vertex */) const
+  { return false; }
   // Precedence:
   //  SDF annotation
   //  Liberty library
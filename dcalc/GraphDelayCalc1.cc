@@ -14,10 +14,13 @@
 // You should have received a copy of the GNU General Public License
 // along with this program.  If not, see <https://www.gnu.org/licenses/>.
 
+#include <algorithm>
 #include "Machine.hh"
 #include "Debug.hh"
 #include "Stats.hh"
 #include "Mutex.hh"
+#include "ThreadPool.hh"
+#include "ThreadForEach.hh"
 #include "MinMax.hh"
 #include "PortDirection.hh"
 #include "TimingRole.hh"
@@ -28,6 +31,7 @@
 #include "Sdc.hh"
 #include "Corner.hh"
 #include "Graph.hh"
+#include "VertexVisitedBits.hh"
 #include "Levelize.hh"
 #include "SearchPred.hh"
 #include "Bfs.hh"
@@ -39,6 +43,77 @@
 
 namespace sta {
 
+// Relative input slew change that still reuses a cached gate delay.
+static const float gate_delay_cache_slew_tolerance = 1e-4;
+
+class GateDelayCacheLoad
+{
+public:
+  Vertex *load_vertex_;
+  ArcDelay wire_delay_;
+  Slew load_slew_;
+};
+
+// Gate delay calculation inputs and results for one driver timing arc
+// and delay calculation analysis point.
+class GateDelayCacheEntry
+{
+public:
+  GateDelayCacheEntry(const TimingArc *arc,
+		      DcalcAPIndex ap_index);
+  bool matches(float from_slew,
+	       float load_cap,
+	       float related_out_cap,
+	       const Parasitic *parasitic,
+	       float pi_c2,
+	       float pi_rpi,
+	       float pi_c1) const;
+
+  const TimingArc *arc_;
+  DcalcAPIndex ap_index_;
+  bool valid_;
+  float from_slew_;
+  float load_cap_;
+  float related_out_cap_;
+  // Pi models are matched by value because parasitics reduced
+  // during delay calculation are deleted after each driver.
+  const Parasitic *parasitic_;
+  float pi_c2_;
+  float pi_rpi_;
+  float pi_c1_;
+  ArcDelay gate_delay_;
+  Slew gate_slew_;
+  Vector<GateDelayCacheLoad> loads_;
+};
+
+GateDelayCacheEntry::GateDelayCacheEntry(const TimingArc *arc,
+					 DcalcAPIndex ap_index) :
+  arc_(arc),
+  ap_index_(ap_index),
+  valid_(false)
+{
+}
+
+bool
+GateDelayCacheEntry::matches(float from_slew,
+			     float load_cap,
+			     float related_out_cap,
+			     const Parasitic *parasitic,
+			     float pi_c2,
+			     float pi_rpi,
+			     float pi_c1) const
+{
+  return valid_
+    && abs(from_slew - from_slew_)
+       <= abs(from_slew_) * gate_delay_cache_slew_tolerance
+    && load_cap == load_cap_
+    && related_out_cap == related_out_cap_
+    && parasitic == parasitic_
+    && pi_c2 == pi_c2_
+    && pi_rpi == pi_rpi_
+    && pi_c1 == pi_c1_;
+}
+
 using std::abs;
 
 static const Slew default_slew = 0.0;
@@ -222,11 +297,18 @@ GraphDelayCalc1::GraphDelayCalc1(StaState *sta) :
   delays_seeded_(false),
   incremental_(false),
   search_pred_(new SearchPred1(sta)),
-  search_non_latch_pred_(new SearchPredNonLatch2(sta)),
+  // Delays outside of the search timing scope are not found.
+  search_non_latch_pred_(new SearchPredScope2(sta)),
   clk_pred_(new ClkTreeSearchPred(sta)),
   iter_(new BfsFwdIterator(BfsIndex::dcalc, search_non_latch_pred_, sta)),
   multi_drvr_nets_found_(false),
-  incremental_delay_tolerance_(0.0)
+  incremental_delay_tolerance_(0.0),
+  gate_delay_cache_enabled_(false),
+  level_batch_enabled_(false),
+  batch_gate_delays_(false),
+  gate_delay_cache_hits_(0),
+  gate_delay_cache_misses_(0),
+  debug_delay_calc_(sta->debug()->handle("delay_calc"))
 {
 }
 
@@ -238,6 +320,7 @@ GraphDelayCalc1::~GraphDelayCalc1()
   delete iter_;
   deleteMultiDrvrNets();
   clearIdealClkMap();
+  clearGateDelayCache();
   delete observer_;
 }
 
@@ -292,20 +375,122 @@ GraphDelayCalc1::setObserver(DelayCalcObserver *observer)
   observer_ = observer;
 }
 
+bool
+GraphDelayCalc1::gateDelayCache() const
+{
+  return gate_delay_cache_enabled_;
+}
+
+void
+GraphDelayCalc1::setGateDelayCache(bool enable)
+{
+  gate_delay_cache_enabled_ = enable;
+  clearGateDelayCache();
+  gate_delay_cache_hits_ = 0;
+  gate_delay_cache_misses_ = 0;
+}
+
+bool
+GraphDelayCalc1::levelBatch() const
+{
+  return level_batch_enabled_;
+}
+
+void
+GraphDelayCalc1::setLevelBatch(bool enable)
+{
+  level_batch_enabled_ = enable;
+}
+
+void
+GraphDelayCalc1::gateDelayCacheStats(size_t &hits,
+				     size_t &misses,
+				     size_t &entries) const
+{
+  hits = gate_delay_cache_hits_;
+  misses = gate_delay_cache_misses_;
+  entries = 0;
+  GateDelayCacheMap::ConstIterator cache_iter(gate_delay_cache_);
+  while (cache_iter.hasNext()) {
+    GateDelayCacheEntrySeq *entries1 = cache_iter.next();
+    entries += entries1->size();
+  }
+}
+
+void
+GraphDelayCalc1::clearGateDelayCache()
+{
+  GateDelayCacheMap::Iterator cache_iter(gate_delay_cache_);
+  while (cache_iter.hasNext()) {
+    GateDelayCacheEntrySeq *entries = cache_iter.next();
+    entries->deleteContents();
+    delete entries;
+  }
+  gate_delay_cache_.clear();
+}
+
+void
+GraphDelayCalc1::deleteGateDelayCache(const Vertex *drvr_vertex)
+{
+  GateDelayCacheEntrySeq *entries = gate_delay_cache_.findKey(drvr_vertex);
+  if (entries) {
+    entries->deleteContents();
+    delete entries;
+    gate_delay_cache_.erase(drvr_vertex);
+  }
+}
+
 void
 GraphDelayCalc1::delaysInvalid()
 {
-  debugPrint0(debug_, "delay_calc", 1, "delays invalid\n");
+  debugPrint0(debug_, debug_delay_calc_, 1, "delays invalid\n");
   delays_exist_ = false;
   delays_seeded_ = false;
   incremental_ = false;
   iter_->clear();
   clearIdealClkMap();
+  clearGateDelayCache();
+  deleteEstimatedParasitics();
   // No need to keep track of incremental updates any more.
   invalid_delays_.clear();
   invalid_checks_.clear();
 }
 
+bool
+GraphDelayCalc1::delaysValid() const
+{
+  return delays_exist_
+    && invalid_delays_.empty()
+    && invalid_checks_.empty()
+    && iter_->empty();
+}
+
+// Mark the restored delays as found so only incremental changes are
+// recalculated. The ideal clocks found during the delay calculation
+// traversal are rebuilt in level order.
+void
+GraphDelayCalc1::delaysRestored()
+{
+  delaysInvalid();
+  graph_->ensureCsr();
+  ensureMultiDrvrNetsFound();
+  VertexSeq vertices;
+  VertexIterator vertex_iter(graph_);
+  while (vertex_iter.hasNext())
+    vertices.push_back(vertex_iter.next());
+  std::stable_sort(vertices.begin(), vertices.end(),
+		   [] (const Vertex *vertex1,
+		       const Vertex *vertex2) {
+		     return vertex1->level() < vertex2->level();
+		   });
+  for (auto vertex : vertices)
+    findIdealClks(vertex);
+  iter_->ensureSize();
+  delays_seeded_ = true;
+  delays_exist_ = true;
+  incremental_ = true;
+}
+
 void
 GraphDelayCalc1::delayInvalid(const Pin *pin)
 {
@@ -332,14 +517,16 @@ GraphDelayCalc1::delayInvalid(const Pin *pin)
 void
 GraphDelayCalc1::delayInvalid(Vertex *vertex)
 {
-  debugPrint1(debug_, "delay_calc", 2, "delays invalid %s\n",
+  debugPrint1(debug_, debug_delay_calc_, 2, "delays invalid %s\n",
 	      vertex->name(sdc_network_));
+  // Pvt, load and netlist edits invalidate the driver.
+  deleteGateDelayCache(vertex);
   if (graph_ && incremental_) {
-    invalid_delays_.insert(vertex);
+    invalid_delays_.insert(vertex, graph_);
     // Invalidate driver that triggers dcalc for multi-driver nets.
     MultiDrvrNet *multi_drvr = multiDrvrNet(vertex);
     if (multi_drvr)
-      invalid_delays_.insert(multi_drvr->dcalcDrvr());
+      invalid_delays_.insert(multi_drvr->dcalcDrvr(), graph_);
   }
 }
 
@@ -348,7 +535,8 @@ GraphDelayCalc1::deleteVertexBefore(Vertex *vertex)
 {
   iter_->deleteVertexBefore(vertex);
   if (incremental_)
-    invalid_delays_.erase(vertex);
+    invalid_delays_.erase(vertex, graph_);
+  deleteGateDelayCache(vertex);
   MultiDrvrNet *multi_drvr = multiDrvrNet(vertex);
   if (multi_drvr) {
     multi_drvr->drvrs()->erase(vertex);
@@ -367,6 +555,10 @@ public:
   virtual ~FindVertexDelays();
   virtual void visit(Vertex *vertex);
   virtual VertexVisitor *copy();
+  virtual void dataflowPreds(Vertex *vertex,
+			     VertexSeq &preds);
+  virtual void levelBegin(const VertexSeq &vertices);
+  virtual bool heavy(Vertex *vertex);
 
 protected:
   GraphDelayCalc1 *graph_delay_calc1_;
@@ -398,6 +590,41 @@ FindVertexDelays::copy()
   return new FindVertexDelays(graph_delay_calc1_,arc_delay_calc_->copy(),true);
 }
 
+// The driver that finds the delays for a multi-driver net uses the
+// slews of the other drivers' fanin.
+void
+FindVertexDelays::dataflowPreds(Vertex *vertex,
+				VertexSeq &preds)
+{
+  MultiDrvrNet *multi_drvr = graph_delay_calc1_->multiDrvrNet(vertex);
+  if (multi_drvr
+      && multi_drvr->dcalcDrvr() == vertex) {
+    VertexSet::Iterator drvr_iter(multi_drvr->drvrs());
+    while (drvr_iter.hasNext()) {
+      Vertex *drvr = drvr_iter.next();
+      if (drvr != vertex)
+	preds.push_back(drvr);
+    }
+  }
+}
+
+void
+FindVertexDelays::levelBegin(const VertexSeq &vertices)
+{
+  if (graph_delay_calc1_->batch_gate_delays_)
+    graph_delay_calc1_->findLevelGateDelays(vertices);
+}
+
+// The driver that finds the delays of a multi-driver net finds them
+// for all of the net's drivers.
+bool
+FindVertexDelays::heavy(Vertex *vertex)
+{
+  MultiDrvrNet *multi_drvr = graph_delay_calc1_->multiDrvrNet(vertex);
+  return multi_drvr
+    && multi_drvr->dcalcDrvr() == vertex;
+}
+
 void
 FindVertexDelays::visit(Vertex *vertex)
 {
@@ -411,12 +638,17 @@ void
 GraphDelayCalc1::findDelays(Level level)
 {
   if (arc_delay_calc_) {
-    Stats stats(debug_);
+    Stats stats(debug_, phase_stats_);
     int dcalc_count = 0;
-    debugPrint1(debug_, "delay_calc", 1, "find delays to level %d\n", level);
+    debugPrint1(debug_, debug_delay_calc_, 1, "find delays to level %d\n", level);
+    graph_->ensureCsr();
     if (!delays_seeded_) {
       iter_->clear();
       ensureMultiDrvrNetsFound();
+      if (arc_delay_calc_->savesReducedParasitics())
+	reduceParasitics();
+      if (!parasitics_->haveParasitics())
+	estimateParasitics();
       seedRootSlews();
       delays_seeded_ = true;
     }
@@ -425,31 +657,196 @@ GraphDelayCalc1::findDelays(Level level)
     if (incremental_)
       seedInvalidDelays();
 
+    // Cached gate delays are matched with float slews.
+    batch_gate_delays_ = (arc_delay_calc_->batchesGateDelays()
+			  || level_batch_enabled_)
+      && !pocv_enabled_;
+    if (batch_gate_delays_) {
+      int thread_count = thread_pool_ ? thread_pool_->threadCount() : 1;
+      for (int i = 0; i < thread_count; i++)
+	batch_arc_delay_calcs_.push_back(arc_delay_calc_->copy());
+    }
     FindVertexDelays visitor(this, arc_delay_calc_, false);
     dcalc_count += iter_->visitParallel(level, &visitor);
+    batch_arc_delay_calcs_.deleteContents();
+    batch_arc_delay_calcs_.clear();
+    batch_gate_delays_ = false;
+    // Incremental updates estimate the parasitics they need.
+    deleteEstimatedParasitics();
 
     // Timing checks require slews at both ends of the arc,
     // so find their delays after all slews are known.
-    VertexSet::Iterator check_iter(invalid_checks_);
-    while (check_iter.hasNext()) {
-      Vertex *check_vertex = check_iter.next();
+    VertexSeq check_vertices;
+    invalid_checks_.vertices(graph_, check_vertices);
+    for (Vertex *check_vertex : check_vertices)
       findCheckDelays(check_vertex, arc_delay_calc_);
-    }
     invalid_checks_.clear();
 
     delays_exist_ = true;
     incremental_ = true;
-    debugPrint1(debug_, "delay_calc", 1, "found %d delays\n", dcalc_count);
+    debugPrint1(debug_, debug_delay_calc_, 1, "found %d delays\n", dcalc_count);
+    stats.setVisitCount(dcalc_count);
     stats.report("Delay calc");
   }
 }
 
+// Reduce the parasitic networks of all drivers in parallel so the
+// delay calculation visitor finds the saved reduced models.
 void
-GraphDelayCalc1::seedInvalidDelays()
+GraphDelayCalc1::reduceParasitics()
+{
+  Stats stats(debug_, phase_stats_);
+  VertexSeq drvrs;
+  VertexIterator vertex_iter(graph_);
+  while (vertex_iter.hasNext()) {
+    Vertex *vertex = vertex_iter.next();
+    if (isDriver(vertex))
+      drvrs.push_back(vertex);
+  }
+  // The arc delay calculators need separate state for each thread.
+  Vector<ArcDelayCalc*> arc_delay_calcs;
+  int thread_count = thread_pool_ ? thread_pool_->threadCount() : 1;
+  for (int i = 0; i < thread_count; i++)
+    arc_delay_calcs.push_back(arc_delay_calc_->copy());
+  forEachChunk(drvrs.size(), thread_pool_,
+	       [&] (size_t begin, size_t end, int thread_index) {
+		 ArcDelayCalc *arc_delay_calc = arc_delay_calcs[thread_index];
+		 for (size_t i = begin; i < end; i++) {
+		   const Pin *drvr_pin = drvrs[i]->pin();
+		   DcalcAnalysisPtIterator ap_iter(this);
+		   while (ap_iter.hasNext()) {
+		     DcalcAnalysisPt *dcalc_ap = ap_iter.next();
+		     const ParasiticAnalysisPt *parasitic_ap =
+		       dcalc_ap->parasiticAnalysisPt();
+		     if (parasitics_->findParasiticNetwork(drvr_pin,
+							   parasitic_ap)) {
+		       TransRiseFallIterator tr_iter;
+		       while (tr_iter.hasNext()) {
+			 TransRiseFall *tr = tr_iter.next();
+			 arc_delay_calc->findParasitic(drvr_pin, tr, dcalc_ap);
+		       }
+		     }
+		   }
+		   arc_delay_calc->finishDrvrPin();
+		 }
+	       });
+  arc_delay_calcs.deleteContents();
+  stats.setVisitCount(drvrs.size());
+  stats.report("Reduce parasitics");
+}
+
+// Without annotated parasitics every driver is estimated from the
+// wireload, so estimate them all in parallel before the levelized
+// visit instead of one driver at a time by the arc delay calculator.
+void
+GraphDelayCalc1::estimateParasitics()
 {
-  VertexSet::Iterator vertex_iter(invalid_delays_);
+  deleteEstimatedParasitics();
+  bool have_wireload = false;
+  DcalcAnalysisPtIterator ap_iter(this);
+  while (ap_iter.hasNext()) {
+    DcalcAnalysisPt *dcalc_ap = ap_iter.next();
+    if (sdc_->wireloadDefaulted(dcalc_ap->constraintMinMax()))
+      have_wireload = true;
+  }
+  if (!have_wireload)
+    return;
+
+  Stats stats(debug_, phase_stats_);
+  VertexSeq drvrs;
+  VertexIndex max_index = 0;
+  VertexIterator vertex_iter(graph_);
   while (vertex_iter.hasNext()) {
     Vertex *vertex = vertex_iter.next();
+    if (isDriver(vertex)) {
+      drvrs.push_back(vertex);
+      max_index = std::max(max_index, graph_->index(vertex));
+    }
+  }
+  estimated_drvr_slots_.assign(max_index + 1, drvrs.size());
+  for (size_t i = 0; i < drvrs.size(); i++)
+    estimated_drvr_slots_[graph_->index(drvrs[i])] = i;
+  size_t ap_count = corners_->dcalcAnalysisPtCount();
+  estimated_parasitics_.assign(drvrs.size() * ap_count
+			       * TransRiseFall::index_count, nullptr);
+  forEachChunk(drvrs.size(), thread_pool_,
+	       [&] (size_t begin, size_t end, int) {
+		 for (size_t i = begin; i < end; i++) {
+		   const Pin *drvr_pin = drvrs[i]->pin();
+		   // set_load has precidence over parasitics.
+		   if (sdc_->drvrPinHasWireCap(drvr_pin))
+		     continue;
+		   DcalcAnalysisPtIterator ap_iter(this);
+		   while (ap_iter.hasNext()) {
+		     DcalcAnalysisPt *dcalc_ap = ap_iter.next();
+		     const MinMax *cnst_min_max = dcalc_ap->constraintMinMax();
+		     Wireload *wireload = sdc_->wireloadDefaulted(cnst_min_max);
+		     if (wireload) {
+		       TransRiseFallIterator tr_iter;
+		       while (tr_iter.hasNext()) {
+			 TransRiseFall *tr = tr_iter.next();
+			 float pin_cap, wire_cap, fanout;
+			 bool has_wire_cap;
+			 netCaps(drvr_pin, tr, dcalc_ap,
+				 pin_cap, wire_cap, fanout, has_wire_cap);
+			 size_t index = (i * ap_count + dcalc_ap->index())
+			   * TransRiseFall::index_count + tr->index();
+			 estimated_parasitics_[index] =
+			   parasitics_->estimatePiElmore(drvr_pin, tr, wireload,
+							 fanout, pin_cap,
+							 dcalc_ap->operatingConditions(),
+							 dcalc_ap->corner(),
+							 cnst_min_max,
+							 dcalc_ap->parasiticAnalysisPt());
+		       }
+		     }
+		   }
+		 }
+	       });
+  stats.setVisitCount(drvrs.size());
+  stats.report("Estimate parasitics");
+}
+
+Parasitic *
+GraphDelayCalc1::estimatedParasitic(const Pin *drvr_pin,
+				    const TransRiseFall *tr,
+				    const DcalcAnalysisPt *dcalc_ap) const
+{
+  if (!estimated_parasitics_.empty()) {
+    Vertex *drvr_vertex = graph_->pinDrvrVertex(drvr_pin);
+    if (drvr_vertex) {
+      VertexIndex vertex_index = graph_->index(drvr_vertex);
+      if (vertex_index < estimated_drvr_slots_.size()) {
+	size_t slot = estimated_drvr_slots_[vertex_index];
+	size_t ap_count = corners_->dcalcAnalysisPtCount();
+	size_t index = (slot * ap_count + dcalc_ap->index())
+	  * TransRiseFall::index_count + tr->index();
+	if (index < estimated_parasitics_.size())
+	  return estimated_parasitics_[index];
+      }
+    }
+  }
+  return nullptr;
+}
+
+void
+GraphDelayCalc1::deleteEstimatedParasitics()
+{
+  for (auto parasitic : estimated_parasitics_) {
+    if (parasitic)
+      parasitics_->deleteUnsavedParasitic(parasitic);
+  }
+  // Release the memory as well.
+  std::vector<Parasitic*>().swap(estimated_parasitics_);
+  std::vector<size_t>().swap(estimated_drvr_slots_);
+}
+
+void
+GraphDelayCalc1::seedInvalidDelays()
+{
+  VertexSeq vertices;
+  invalid_delays_.vertices(graph_, vertices);
+  for (Vertex *vertex : vertices) {
     if (vertex->isRoot())
       seedRootSlew(vertex, arc_delay_calc_);
     else {
@@ -492,37 +889,81 @@ FindNetDrvrs::operator()(Pin *pin)
     drvr_pins_.insert(pin);
 }
 
+// The driver pins of leaf instances are searched for multi-driver nets
+// in parallel. The thread that claims the first driver of a net
+// records it and marks the net's other drivers so other threads can
+// skip them. The nets are made after the search.
 void
 GraphDelayCalc1::ensureMultiDrvrNetsFound()
 {
   if (!multi_drvr_nets_found_) {
+    InstanceSeq insts;
     LeafInstanceIterator *inst_iter = network_->leafInstanceIterator();
-    while (inst_iter->hasNext()) {
-      Instance *inst = inst_iter->next();
-      InstancePinIterator *pin_iter = network_->pinIterator(inst);
-      while (pin_iter->hasNext()) {
-	Pin *pin = pin_iter->next();
-	Vertex *drvr_vertex = graph_->pinDrvrVertex(pin);
-	if (network_->isDriver(pin)
-	    && !multi_drvr_net_map_.hasKey(drvr_vertex)) {
-	  PinSet drvr_pins;
-	  FindNetDrvrs visitor(drvr_pins, network_, graph_);
-	  network_->visitConnectedPins(pin, visitor);
-	  if (drvr_pins.size() > 1)
-	    makeMultiDrvrNet(drvr_pins);
-	}
+    while (inst_iter->hasNext())
+      insts.push_back(inst_iter->next());
+    delete inst_iter;
+
+    VertexVisitedBits found(graph_->vertexIndexBound());
+    int thread_count = thread_pool_ ? thread_pool_->threadCount() : 1;
+    Vector<Vector<PinSet*>> thread_nets(thread_count);
+    forEachChunk(insts.size(), thread_pool_,
+		 [&] (size_t begin, size_t end, int thread_index) {
+		   for (size_t i = begin; i < end; i++)
+		     findMultiDrvrNets(insts[i], found,
+				       thread_nets[thread_index]);
+		 });
+    for (auto &nets : thread_nets) {
+      for (auto drvr_pins : nets) {
+	makeMultiDrvrNet(*drvr_pins);
+	delete drvr_pins;
       }
-      delete pin_iter;
     }
-    delete inst_iter;
     multi_drvr_nets_found_ = true;
   }
 }
 
+void
+GraphDelayCalc1::findMultiDrvrNets(const Instance *inst,
+				   VertexVisitedBits &found,
+				   // Return value.
+				   Vector<PinSet*> &nets)
+{
+  InstancePinIterator *pin_iter = network_->pinIterator(inst);
+  while (pin_iter->hasNext()) {
+    Pin *pin = pin_iter->next();
+    if (network_->isDriver(pin)) {
+      Vertex *drvr_vertex = graph_->pinDrvrVertex(pin);
+      if (drvr_vertex
+	  && !found.visited(graph_->index(drvr_vertex))) {
+	PinSet *drvr_pins = new PinSet;
+	FindNetDrvrs visitor(*drvr_pins, network_, graph_);
+	network_->visitConnectedPins(pin, visitor);
+	PinSet::Iterator drvr_iter(drvr_pins);
+	// Only the thread that claims the first driver records the net.
+	if (drvr_pins->size() > 1
+	    && found.visit(drvrVertexIndex(drvr_iter.next()))) {
+	  while (drvr_iter.hasNext())
+	    found.visit(drvrVertexIndex(drvr_iter.next()));
+	  nets.push_back(drvr_pins);
+	}
+	else
+	  delete drvr_pins;
+      }
+    }
+  }
+  delete pin_iter;
+}
+
+VertexIndex
+GraphDelayCalc1::drvrVertexIndex(const Pin *pin) const
+{
+  return graph_->index(graph_->pinDrvrVertex(pin));
+}
+
 void
 GraphDelayCalc1::makeMultiDrvrNet(PinSet &drvr_pins)
 {
-  debugPrint0(debug_, "delay_calc", 3, "multi-driver net\n");
+  debugPrint0(debug_, debug_delay_calc_, 3, "multi-driver net\n");
   VertexSet *drvr_vertices = new VertexSet;
   MultiDrvrNet *multi_drvr = new MultiDrvrNet(drvr_vertices);
   Level max_drvr_level = 0;
@@ -531,14 +972,16 @@ GraphDelayCalc1::makeMultiDrvrNet(PinSet &drvr_pins)
   while (pin_iter.hasNext()) {
     Pin *pin = pin_iter.next();
     Vertex *drvr_vertex = graph_->pinDrvrVertex(pin);
-    debugPrint1(debug_, "delay_calc", 3, " %s\n",
+    debugPrint1(debug_, debug_delay_calc_, 3, " %s\n",
 		network_->pathName(pin));
     multi_drvr_net_map_[drvr_vertex] = multi_drvr;
     drvr_vertices->insert(drvr_vertex);
     Level drvr_level = drvr_vertex->level();
     if (max_drvr == nullptr
-	|| drvr_level > max_drvr_level)
+	|| drvr_level > max_drvr_level) {
       max_drvr = drvr_vertex;
+      max_drvr_level = drvr_level;
+    }
   }
   multi_drvr->setDcalcDrvr(max_drvr);
   multi_drvr->findCaps(this, sdc_);
@@ -559,6 +1002,12 @@ GraphDelayCalc1::multiDrvrNet(const Vertex *drvr_vertex) const
   return multi_drvr_net_map_.findKey(drvr_vertex);
 }
 
+bool
+GraphDelayCalc1::isMultiDrvr(const Vertex *drvr_vertex) const
+{
+  return multiDrvrNet(drvr_vertex) != nullptr;
+}
+
 void
 GraphDelayCalc1::seedRootSlews()
 {
@@ -586,7 +1035,7 @@ GraphDelayCalc1::seedDrvrSlew(Vertex *drvr_vertex,
 			      ArcDelayCalc *arc_delay_calc)
 {
   const Pin *drvr_pin = drvr_vertex->pin();
-  debugPrint1(debug_, "delay_calc", 2, "seed driver slew %s\n",
+  debugPrint1(debug_, debug_delay_calc_, 2, "seed driver slew %s\n",
 	      drvr_vertex->name(sdc_network_));
   InputDrive *drive = 0;
   if (network_->isTopLevelPort(drvr_pin)) {
@@ -693,7 +1142,7 @@ void
 GraphDelayCalc1::seedLoadSlew(Vertex *vertex)
 {
   const Pin *pin = vertex->pin();
-  debugPrint1(debug_, "delay_calc", 2, "seed load slew %s\n",
+  debugPrint1(debug_, debug_delay_calc_, 2, "seed load slew %s\n",
 	      vertex->name(sdc_network_));
   ClockSet *clks = sdc_->findVertexPinClocks(pin);
   initSlew(vertex);
@@ -775,7 +1224,7 @@ GraphDelayCalc1::findInputDriverDelay(LibertyCell *drvr_cell,
 				      LibertyPort *to_port,
 				      DcalcAnalysisPt *dcalc_ap)
 {
-  debugPrint2(debug_, "delay_calc", 2, "  driver cell %s %s\n",
+  debugPrint2(debug_, debug_delay_calc_, 2, "  driver cell %s %s\n",
 	      drvr_cell->name(),
 	      tr->asString());
   LibertyCellTimingArcSetIterator set_iter(drvr_cell);
@@ -807,7 +1256,7 @@ GraphDelayCalc1::findInputArcDelay(LibertyCell *drvr_cell,
 				   float from_slew,
 				   DcalcAnalysisPt *dcalc_ap)
 {
-  debugPrint5(debug_, "delay_calc", 3, "  %s %s -> %s %s (%s)\n",
+  debugPrint5(debug_, debug_delay_calc_, 3, "  %s %s -> %s %s (%s)\n",
 	      arc->from()->name(),
 	      arc->fromTrans()->asString(),
 	      arc->to()->name(),
@@ -835,7 +1284,7 @@ GraphDelayCalc1::findInputArcDelay(LibertyCell *drvr_cell,
 			       drvr_parasitic, 0.0, pvt, dcalc_ap,
 			       gate_delay, gate_slew);
     ArcDelay load_delay = gate_delay - intrinsic_delay;
-    debugPrint3(debug_, "delay_calc", 3,
+    debugPrint3(debug_, debug_delay_calc_, 3,
 		"    gate delay = %s intrinsic = %s slew = %s\n",
 		delayAsString(gate_delay, this),
 		delayAsString(intrinsic_delay, this),
@@ -855,7 +1304,7 @@ GraphDelayCalc1::findVertexDelay(Vertex *vertex,
   bool ideal_clks_changed = findIdealClks(vertex);
   // Don't clobber root slews.
   if (!vertex->isRoot()) {
-    debugPrint2(debug_, "delay_calc", 2, "find delays %s (%s)\n",
+    debugPrint2(debug_, debug_delay_calc_, 2, "find delays %s (%s)\n",
 		vertex->name(sdc_network_),
 		network_->cellName(network_->instance(pin)));
     if (network_->isLeaf(pin)) {
@@ -891,8 +1340,7 @@ GraphDelayCalc1::enqueueTimingChecksEdges(Vertex *vertex)
 {
   if (vertex->hasChecks()
       || vertex->isCheckClk()) {
-    UniqueLock lock(check_vertices_lock_);
-    invalid_checks_.insert(vertex);
+    invalid_checks_.insert(vertex, graph_);
   }
 }
 
@@ -923,6 +1371,15 @@ GraphDelayCalc1::findDriverDelays(Vertex *drvr_vertex,
   if (multi_drvr) {
     Vertex *dcalc_drvr = multi_drvr->dcalcDrvr();
     if (drvr_vertex == dcalc_drvr) {
+      // The load slews are merged from all of the drivers, so they
+      // are compared after all of the drivers are found.
+      Vector<std::vector<Delay>> prev_delays;
+      VertexSet::Iterator prev_iter(multi_drvr->drvrs());
+      while (prev_iter.hasNext()) {
+	Vertex *drvr_vertex = prev_iter.next();
+	prev_delays.push_back(std::vector<Delay>());
+	findDrvrLoadDelays(drvr_vertex, prev_delays.back());
+      }
       bool init_load_slews = true;
       VertexSet::Iterator drvr_iter(multi_drvr->drvrs());
       while (drvr_iter.hasNext()) {
@@ -933,14 +1390,132 @@ GraphDelayCalc1::findDriverDelays(Vertex *drvr_vertex,
 					   multi_drvr, arc_delay_calc);
 	init_load_slews = false;
       }
+      size_t drvr_index = 0;
+      VertexSet::Iterator changed_iter(multi_drvr->drvrs());
+      while (changed_iter.hasNext()) {
+	Vertex *drvr_vertex = changed_iter.next();
+	delay_changed |= loadDelaysChanged(drvr_vertex,
+					   prev_delays[drvr_index++]);
+      }
     }
   }
-  else
-    delay_changed = findDriverDelays1(drvr_vertex, true, nullptr, arc_delay_calc);
+  else {
+    std::vector<Delay> prev_delays;
+    findDrvrLoadDelays(drvr_vertex, prev_delays);
+    delay_changed = findDriverDelays1(drvr_vertex, true, nullptr,
+				      arc_delay_calc);
+    delay_changed |= loadDelaysChanged(drvr_vertex, prev_delays);
+  }
   arc_delay_calc->finishDrvrPin();
   return delay_changed;
 }
 
+// Driver slews, wire delays and load slews in the order compared by
+// loadDelaysChanged.
+void
+GraphDelayCalc1::findDrvrLoadDelays(Vertex *drvr_vertex,
+				    // Return value.
+				    std::vector<Delay> &delays)
+{
+  DcalcAnalysisPtIterator ap_iter(this);
+  while (ap_iter.hasNext()) {
+    DcalcAnalysisPt *dcalc_ap = ap_iter.next();
+    DcalcAPIndex ap_index = dcalc_ap->index();
+    TransRiseFallIterator tr_iter;
+    while (tr_iter.hasNext()) {
+      TransRiseFall *tr = tr_iter.next();
+      delays.push_back(graph_->slew(drvr_vertex, tr, ap_index));
+    }
+  }
+  VertexOutEdgeIterator edge_iter(drvr_vertex, graph_);
+  while (edge_iter.hasNext()) {
+    Edge *wire_edge = edge_iter.next();
+    if (wire_edge->isWire()) {
+      Vertex *load_vertex = wire_edge->to(graph_);
+      DcalcAnalysisPtIterator ap_iter(this);
+      while (ap_iter.hasNext()) {
+	DcalcAnalysisPt *dcalc_ap = ap_iter.next();
+	DcalcAPIndex ap_index = dcalc_ap->index();
+	TransRiseFallIterator tr_iter;
+	while (tr_iter.hasNext()) {
+	  TransRiseFall *tr = tr_iter.next();
+	  delays.push_back(graph_->wireArcDelay(wire_edge, tr, ap_index));
+	  delays.push_back(graph_->slew(load_vertex, tr, ap_index));
+	}
+      }
+    }
+  }
+}
+
+// Compare the driver slews, wire delays and load slews with their
+// values before the driver delays were found. Slew changes only
+// propagate to the downstream delay calculation. Search arrivals are
+// only invalidated at loads with changed wire delays.
+// Return true if a slew or wire delay changed.
+bool
+GraphDelayCalc1::loadDelaysChanged(Vertex *drvr_vertex,
+				   const std::vector<Delay> &prev_delays)
+{
+  bool changed = false;
+  size_t index = 0;
+  DcalcAnalysisPtIterator ap_iter(this);
+  while (ap_iter.hasNext()) {
+    DcalcAnalysisPt *dcalc_ap = ap_iter.next();
+    DcalcAPIndex ap_index = dcalc_ap->index();
+    TransRiseFallIterator tr_iter;
+    while (tr_iter.hasNext()) {
+      TransRiseFall *tr = tr_iter.next();
+      changed |= delayChanged(prev_delays[index++],
+			      graph_->slew(drvr_vertex, tr, ap_index));
+    }
+  }
+  bool wire_delay_changed = false;
+  VertexOutEdgeIterator edge_iter(drvr_vertex, graph_);
+  while (edge_iter.hasNext()) {
+    Edge *wire_edge = edge_iter.next();
+    if (wire_edge->isWire()) {
+      Vertex *load_vertex = wire_edge->to(graph_);
+      bool load_delay_changed = false;
+      DcalcAnalysisPtIterator ap_iter(this);
+      while (ap_iter.hasNext()) {
+	DcalcAnalysisPt *dcalc_ap = ap_iter.next();
+	DcalcAPIndex ap_index = dcalc_ap->index();
+	TransRiseFallIterator tr_iter;
+	while (tr_iter.hasNext()) {
+	  TransRiseFall *tr = tr_iter.next();
+	  load_delay_changed |=
+	    delayChanged(prev_delays[index++],
+			 graph_->wireArcDelay(wire_edge, tr, ap_index));
+	  changed |= delayChanged(prev_delays[index++],
+				  graph_->slew(load_vertex, tr, ap_index));
+	}
+      }
+      if (load_delay_changed) {
+	wire_delay_changed = true;
+	if (observer_)
+	  observer_->delayChangedTo(load_vertex);
+      }
+    }
+  }
+  if (wire_delay_changed && observer_)
+    observer_->delayChangedFrom(drvr_vertex);
+  return changed || wire_delay_changed;
+}
+
+// True if delay differs from prev_delay by more than the incremental
+// delay tolerance.
+bool
+GraphDelayCalc1::delayChanged(const Delay &prev_delay,
+			      const Delay &delay) const
+{
+  float delay1 = delayAsFloat(delay);
+  float prev_delay1 = delayAsFloat(prev_delay);
+  return delay1 != prev_delay1
+    && (prev_delay1 == 0.0
+	|| abs(delay1 - prev_delay1) / abs(prev_delay1)
+	> incremental_delay_tolerance_);
+}
+
 bool
 GraphDelayCalc1::findDriverDelays1(Vertex *drvr_vertex,
 				   bool init_load_slews,
@@ -953,6 +1528,17 @@ GraphDelayCalc1::findDriverDelays1(Vertex *drvr_vertex,
   initSlew(drvr_vertex);
   initWireDelays(drvr_vertex, init_load_slews);
   bool delay_changed = false;
+  // The pvt, parasitic and load cap are found once for each analysis
+  // point and shared by all of the driver timing arcs.
+  DrvrApInputsSeq ap_inputs(corners_->dcalcAnalysisPtCount());
+  DcalcAnalysisPtIterator ap_iter(this);
+  while (ap_iter.hasNext()) {
+    DcalcAnalysisPt *dcalc_ap = ap_iter.next();
+    const Pvt *pvt = sdc_->pvt(drvr_inst, dcalc_ap->constraintMinMax());
+    if (pvt == nullptr)
+      pvt = dcalc_ap->operatingConditions();
+    ap_inputs[dcalc_ap->index()].pvt_ = pvt;
+  }
   VertexInEdgeIterator edge_iter(drvr_vertex, graph_);
   while (edge_iter.hasNext()) {
     Edge *edge = edge_iter.next();
@@ -962,7 +1548,7 @@ GraphDelayCalc1::findDriverDelays1(Vertex *drvr_vertex,
 	&& search_pred_->searchThru(edge))
       delay_changed |= findDriverEdgeDelays(drvr_cell, drvr_inst, drvr_pin,
 					    drvr_vertex, multi_drvr, edge,
-					    arc_delay_calc);
+					    ap_inputs, arc_delay_calc);
   }
   if (delay_changed && observer_)
     observer_->delayChangedTo(drvr_vertex);
@@ -995,6 +1581,7 @@ GraphDelayCalc1::findDriverEdgeDelays(LibertyCell *drvr_cell,
 				      Vertex *drvr_vertex,
 				      MultiDrvrNet *multi_drvr,
 				      Edge *edge,
+				      DrvrApInputsSeq &ap_inputs,
 				      ArcDelayCalc *arc_delay_calc)
 {
   Vertex *in_vertex = edge->from(graph_);
@@ -1007,15 +1594,18 @@ GraphDelayCalc1::findDriverEdgeDelays(LibertyCell *drvr_cell,
   DcalcAnalysisPtIterator ap_iter(this);
   while (ap_iter.hasNext()) {
     DcalcAnalysisPt *dcalc_ap = ap_iter.next();
-    const Pvt *pvt = sdc_->pvt(drvr_inst, dcalc_ap->constraintMinMax());
-    if (pvt == nullptr)
-      pvt = dcalc_ap->operatingConditions();
+    DrvrApInputs &inputs = ap_inputs[dcalc_ap->index()];
+    const Pvt *pvt = inputs.pvt_;
     TimingArcSetArcIterator arc_iter(arc_set);
     while (arc_iter.hasNext()) {
       TimingArc *arc = arc_iter.next();
       const TransRiseFall *tr = arc->toTrans()->asRiseFall();
-      Parasitic *parasitic = arc_delay_calc->findParasitic(drvr_pin, tr,
-							   dcalc_ap);
+      int tr_index = tr->index();
+      if (!inputs.load_valid_[tr_index])
+	findDrvrApLoad(drvr_pin, multi_drvr, tr, dcalc_ap, arc_delay_calc,
+		       inputs);
+      Parasitic *parasitic = inputs.parasitic_[tr_index];
+      float load_cap = inputs.load_cap_[tr_index];
       float related_out_cap = 0.0;
       if (related_out_pin) {
 	Parasitic *related_out_parasitic = 
@@ -1025,7 +1615,7 @@ GraphDelayCalc1::findDriverEdgeDelays(LibertyCell *drvr_cell,
 				  tr, dcalc_ap);
       }
       delay_changed |= findArcDelay(drvr_cell, drvr_pin, drvr_vertex,
-				    multi_drvr, arc, parasitic,
+				    multi_drvr, arc, parasitic, load_cap,
 				    related_out_cap,
 				    in_vertex, edge, pvt, dcalc_ap,
 				    arc_delay_calc);
@@ -1039,6 +1629,33 @@ GraphDelayCalc1::findDriverEdgeDelays(LibertyCell *drvr_cell,
   return delay_changed;
 }
 
+void
+GraphDelayCalc1::findDrvrApLoad(const Pin *drvr_pin,
+				MultiDrvrNet *multi_drvr,
+				const TransRiseFall *tr,
+				const DcalcAnalysisPt *dcalc_ap,
+				ArcDelayCalc *arc_delay_calc,
+				DrvrApInputs &inputs)
+{
+  int tr_index = tr->index();
+  Parasitic *parasitic = arc_delay_calc->findParasitic(drvr_pin, tr,
+						       dcalc_ap);
+  inputs.parasitic_[tr_index] = parasitic;
+  inputs.load_cap_[tr_index] = loadCap(drvr_pin, multi_drvr, parasitic,
+				       tr, dcalc_ap);
+  inputs.load_valid_[tr_index] = true;
+}
+
+DrvrApInputs::DrvrApInputs() :
+  pvt_(nullptr)
+{
+  for (int tr_index = 0; tr_index < TransRiseFall::index_count; tr_index++) {
+    load_valid_[tr_index] = false;
+    parasitic_[tr_index] = nullptr;
+    load_cap_[tr_index] = 0.0;
+  }
+}
+
 float
 GraphDelayCalc1::loadCap(const Pin *drvr_pin,
 			 const DcalcAnalysisPt *dcalc_ap) const
@@ -1228,6 +1845,7 @@ GraphDelayCalc1::findArcDelay(LibertyCell *drvr_cell,
 			      MultiDrvrNet *multi_drvr,
 			      TimingArc *arc,
 			      Parasitic *drvr_parasitic,
+			      float load_cap,
 			      float related_out_cap,
 			      Vertex *from_vertex,
 			      Edge *edge,
@@ -1240,7 +1858,7 @@ GraphDelayCalc1::findArcDelay(LibertyCell *drvr_cell,
   TransRiseFall *drvr_tr = arc->toTrans()->asRiseFall();
   if (from_tr && drvr_tr) {
     DcalcAPIndex ap_index = dcalc_ap->index();
-    debugPrint6(debug_, "delay_calc", 3,
+    debugPrint6(debug_, debug_delay_calc_, 3,
 		"  %s %s -> %s %s (%s) %s\n",
 		arc->from()->name(),
 		arc->fromTrans()->asString(),
@@ -1253,6 +1871,8 @@ GraphDelayCalc1::findArcDelay(LibertyCell *drvr_cell,
     const Slew from_slew = edgeFromSlew(from_vertex, from_tr, edge, dcalc_ap);
     ArcDelay gate_delay;
     Slew gate_slew;
+    GateDelayCacheEntry *cache_entry = nullptr;
+    bool cache_hit = false;
     if (multi_drvr
 	&& network_->direction(drvr_pin)->isOutput())
       multiDrvrGateDelay(multi_drvr, drvr_cell, drvr_pin, arc,
@@ -1261,14 +1881,20 @@ GraphDelayCalc1::findArcDelay(LibertyCell *drvr_cell,
 			 arc_delay_calc,
 			 gate_delay, gate_slew);
     else {
-      float load_cap = loadCap(drvr_pin, multi_drvr, drvr_parasitic,
-			       drvr_tr, dcalc_ap);
-      arc_delay_calc->gateDelay(drvr_cell, arc,
-				from_slew, load_cap, drvr_parasitic,
-				related_out_cap, pvt, dcalc_ap,
-				gate_delay, gate_slew);
+      if ((gate_delay_cache_enabled_
+	   || batch_gate_delays_)
+	  && !pocv_enabled_)
+	cachedGateDelay(drvr_cell, drvr_vertex, arc,
+			from_slew, load_cap, drvr_parasitic,
+			related_out_cap, pvt, dcalc_ap, arc_delay_calc,
+			gate_delay, gate_slew, cache_entry, cache_hit);
+      else
+	arc_delay_calc->gateDelay(drvr_cell, arc,
+				  from_slew, load_cap, drvr_parasitic,
+				  related_out_cap, pvt, dcalc_ap,
+				  gate_delay, gate_slew);
     }
-    debugPrint2(debug_, "delay_calc", 3,
+    debugPrint2(debug_, debug_delay_calc_, 3,
 		"    gate delay = %s slew = %s\n",
 		delayAsString(gate_delay, this),
 		delayAsString(gate_slew, this));
@@ -1280,20 +1906,321 @@ GraphDelayCalc1::findArcDelay(LibertyCell *drvr_cell,
       graph_->setSlew(drvr_vertex, drvr_tr, ap_index, gate_slew);
     if (!graph_->arcDelayAnnotated(edge, arc, ap_index)) {
       const ArcDelay &prev_gate_delay = graph_->arcDelay(edge,arc,ap_index);
-      float gate_delay1 = delayAsFloat(gate_delay);
-      float prev_gate_delay1 = delayAsFloat(prev_gate_delay);
-      if (prev_gate_delay1 == 0.0
-	  || (abs(gate_delay1 - prev_gate_delay1) / prev_gate_delay1
-	      > incremental_delay_tolerance_))
+      if (delayChanged(prev_gate_delay, gate_delay))
 	delay_changed = true;
       graph_->setArcDelay(edge, arc, ap_index, gate_delay);
     }
-    annotateLoadDelays(drvr_vertex, drvr_tr, delay_zero, true, dcalc_ap,
-		       arc_delay_calc);
+    if (cache_hit)
+      annotateCachedLoadDelays(drvr_vertex, drvr_tr, dcalc_ap, cache_entry);
+    else
+      annotateLoadDelays(drvr_vertex, drvr_tr, delay_zero, true, dcalc_ap,
+			 arc_delay_calc, cache_entry);
   }
   return delay_changed;
 }
 
+// Find the gate delay with the cached result from the last
+// calculation of the arc if its inputs have not changed.
+// The arc delay calculator is only initialized for loadDelay
+// on a miss, so the load delays are cached with the gate delay.
+void
+GraphDelayCalc1::cachedGateDelay(LibertyCell *drvr_cell,
+				 Vertex *drvr_vertex,
+				 TimingArc *arc,
+				 const Slew &from_slew,
+				 float load_cap,
+				 Parasitic *drvr_parasitic,
+				 float related_out_cap,
+				 const Pvt *pvt,
+				 const DcalcAnalysisPt *dcalc_ap,
+				 ArcDelayCalc *arc_delay_calc,
+				 // Return values.
+				 ArcDelay &gate_delay,
+				 Slew &gate_slew,
+				 GateDelayCacheEntry *&cache_entry,
+				 bool &cache_hit)
+{
+  const Parasitic *parasitic = drvr_parasitic;
+  float pi_c2 = 0.0;
+  float pi_rpi = 0.0;
+  float pi_c1 = 0.0;
+  if (drvr_parasitic
+      && parasitics_->isPiModel(drvr_parasitic)) {
+    parasitics_->piModel(drvr_parasitic, pi_c2, pi_rpi, pi_c1);
+    parasitic = nullptr;
+  }
+  float from_slew1 = delayAsFloat(from_slew);
+  cache_entry = findGateDelayCacheEntry(drvr_vertex, arc, dcalc_ap->index());
+  cache_hit = cache_entry->matches(from_slew1, load_cap, related_out_cap,
+				   parasitic, pi_c2, pi_rpi, pi_c1)
+    && loadsMatch(cache_entry, drvr_vertex);
+  if (cache_hit) {
+    gate_delay = cache_entry->gate_delay_;
+    gate_slew = cache_entry->gate_slew_;
+    gate_delay_cache_hits_++;
+  }
+  else {
+    arc_delay_calc->gateDelay(drvr_cell, arc,
+			      from_slew, load_cap, drvr_parasitic,
+			      related_out_cap, pvt, dcalc_ap,
+			      gate_delay, gate_slew);
+    cache_entry->valid_ = true;
+    cache_entry->from_slew_ = from_slew1;
+    cache_entry->load_cap_ = load_cap;
+    cache_entry->related_out_cap_ = related_out_cap;
+    cache_entry->parasitic_ = parasitic;
+    cache_entry->pi_c2_ = pi_c2;
+    cache_entry->pi_rpi_ = pi_rpi;
+    cache_entry->pi_c1_ = pi_c1;
+    cache_entry->gate_delay_ = gate_delay;
+    cache_entry->gate_slew_ = gate_slew;
+    cache_entry->loads_.clear();
+    gate_delay_cache_misses_++;
+  }
+}
+
+// Find the gate delays of the driver arcs of a level in phases and save
+// them in the gate delay cache where findArcDelay finds them when the
+// level is visited.
+//  gather:   find the arc inputs of the level's drivers in parallel
+//  evaluate: find the delays of each thread's args in one gateDelays
+//            call, or all of them in one call if the arc delay
+//            calculator batches gate delays
+//  scatter:  save the results in the gate delay cache in parallel
+// Multi-driver nets are left to the visit.
+void
+GraphDelayCalc1::findLevelGateDelays(const VertexSeq &vertices)
+{
+  size_t thread_count = batch_arc_delay_calcs_.size();
+  Vector<ArcDcalcArgSeq> thread_args(thread_count);
+  Vector<VertexSeq> thread_drvrs(thread_count);
+  forEachChunk(vertices.size(), thread_pool_,
+	       [&] (size_t begin, size_t end, int thread_index) {
+		 ArcDelayCalc *arc_delay_calc =
+		   batch_arc_delay_calcs_[thread_index];
+		 for (size_t i = begin; i < end; i++) {
+		   Vertex *vertex = vertices[i];
+		   if (vertex
+		       && !vertex->isRoot()
+		       && network_->isLeaf(vertex->pin())
+		       && isDriver(vertex)
+		       && multiDrvrNet(vertex) == nullptr)
+		     levelGateDelayArgs(vertex, arc_delay_calc,
+					thread_args[thread_index],
+					thread_drvrs[thread_index]);
+		 }
+	       });
+  Vector<ArcDcalcResultSeq> thread_results(thread_count);
+  if (arc_delay_calc_->batchesGateDelays()) {
+    ArcDcalcArgSeq args;
+    VertexSeq arg_drvrs;
+    for (size_t i = 0; i < thread_count; i++) {
+      args.insert(args.end(), thread_args[i].begin(), thread_args[i].end());
+      arg_drvrs.insert(arg_drvrs.end(), thread_drvrs[i].begin(),
+		       thread_drvrs[i].end());
+    }
+    if (!args.empty()) {
+      debugPrint1(debug_, debug_delay_calc_, 2, "batch gate delays %lu\n",
+		  static_cast<unsigned long>(args.size()));
+      arc_delay_calc_->gateDelays(args, thread_results[0]);
+      thread_args[0].swap(args);
+      thread_drvrs[0].swap(arg_drvrs);
+      for (size_t i = 1; i < thread_count; i++) {
+	thread_args[i].clear();
+	thread_drvrs[i].clear();
+      }
+    }
+  }
+  else
+    forEachChunk(thread_count, thread_pool_,
+		 [&] (size_t begin, size_t end, int thread_index) {
+		   ArcDelayCalc *arc_delay_calc =
+		     batch_arc_delay_calcs_[thread_index];
+		   for (size_t i = begin; i < end; i++)
+		     arc_delay_calc->gateDelays(thread_args[i],
+						thread_results[i]);
+		 });
+  // Each driver's args are in one thread's sequence so the drivers'
+  // cache entries are only written by one thread.
+  forEachChunk(thread_count, thread_pool_,
+	       [&] (size_t begin, size_t end, int) {
+		 for (size_t i = begin; i < end; i++) {
+		   ArcDcalcArgSeq &args = thread_args[i];
+		   for (size_t j = 0; j < args.size(); j++)
+		     saveLevelGateDelay(thread_drvrs[i][j], args[j],
+					thread_results[i][j]);
+		 }
+	       });
+  for (auto arc_delay_calc : batch_arc_delay_calcs_)
+    arc_delay_calc->finishDrvrPin();
+}
+
+// Same inputs as findDriverEdgeDelays/findArcDelay.
+void
+GraphDelayCalc1::levelGateDelayArgs(Vertex *drvr_vertex,
+				    ArcDelayCalc *arc_delay_calc,
+				    ArcDcalcArgSeq &args,
+				    VertexSeq &arg_drvrs)
+{
+  const Pin *drvr_pin = drvr_vertex->pin();
+  Instance *drvr_inst = network_->instance(drvr_pin);
+  LibertyCell *drvr_cell = network_->libertyCell(drvr_inst);
+  PinSeq load_pins;
+  VertexOutEdgeIterator wire_iter(drvr_vertex, graph_);
+  while (wire_iter.hasNext()) {
+    Edge *wire_edge = wire_iter.next();
+    if (wire_edge->isWire())
+      load_pins.push_back(wire_edge->to(graph_)->pin());
+  }
+  DrvrApInputsSeq ap_inputs(corners_->dcalcAnalysisPtCount());
+  DcalcAnalysisPtIterator ap_iter(this);
+  while (ap_iter.hasNext()) {
+    DcalcAnalysisPt *dcalc_ap = ap_iter.next();
+    const Pvt *pvt = sdc_->pvt(drvr_inst, dcalc_ap->constraintMinMax());
+    if (pvt == nullptr)
+      pvt = dcalc_ap->operatingConditions();
+    ap_inputs[dcalc_ap->index()].pvt_ = pvt;
+  }
+  VertexInEdgeIterator edge_iter(drvr_vertex, graph_);
+  while (edge_iter.hasNext()) {
+    Edge *edge = edge_iter.next();
+    Vertex *from_vertex = edge->from(graph_);
+    if (search_pred_->searchFrom(from_vertex)
+	&& search_pred_->searchThru(edge)) {
+      TimingArcSet *arc_set = edge->timingArcSet();
+      const LibertyPort *related_out_port = arc_set->relatedOut();
+      const Pin *related_out_pin = related_out_port
+	? network_->findPin(drvr_inst, related_out_port)
+	: nullptr;
+      DcalcAnalysisPtIterator ap_iter(this);
+      while (ap_iter.hasNext()) {
+	DcalcAnalysisPt *dcalc_ap = ap_iter.next();
+	DrvrApInputs &inputs = ap_inputs[dcalc_ap->index()];
+	TimingArcSetArcIterator arc_iter(arc_set);
+	while (arc_iter.hasNext()) {
+	  TimingArc *arc = arc_iter.next();
+	  TransRiseFall *from_tr = arc->fromTrans()->asRiseFall();
+	  TransRiseFall *drvr_tr = arc->toTrans()->asRiseFall();
+	  if (from_tr && drvr_tr) {
+	    int tr_index = drvr_tr->index();
+	    if (!inputs.load_valid_[tr_index])
+	      findDrvrApLoad(drvr_pin, nullptr, drvr_tr, dcalc_ap,
+			     arc_delay_calc, inputs);
+	    float related_out_cap = 0.0;
+	    if (related_out_pin) {
+	      Parasitic *related_out_parasitic =
+		arc_delay_calc->findParasitic(related_out_pin, drvr_tr,
+					      dcalc_ap);
+	      related_out_cap = loadCap(related_out_pin,
+					related_out_parasitic,
+					drvr_tr, dcalc_ap);
+	    }
+	    ArcDcalcArg arg;
+	    arg.drvr_cell_ = drvr_cell;
+	    arg.arc_ = arc;
+	    arg.in_slew_ = edgeFromSlew(from_vertex, from_tr, edge, dcalc_ap);
+	    arg.load_cap_ = inputs.load_cap_[tr_index];
+	    arg.drvr_parasitic_ = inputs.parasitic_[tr_index];
+	    arg.related_out_cap_ = related_out_cap;
+	    arg.pvt_ = inputs.pvt_;
+	    arg.dcalc_ap_ = dcalc_ap;
+	    arg.load_pins_ = load_pins;
+	    args.push_back(arg);
+	    arg_drvrs.push_back(drvr_vertex);
+	  }
+	}
+      }
+    }
+  }
+}
+
+void
+GraphDelayCalc1::saveLevelGateDelay(Vertex *drvr_vertex,
+				    const ArcDcalcArg &arg,
+				    const ArcDcalcResult &result)
+{
+  const Parasitic *parasitic = arg.drvr_parasitic_;
+  float pi_c2 = 0.0;
+  float pi_rpi = 0.0;
+  float pi_c1 = 0.0;
+  if (arg.drvr_parasitic_
+      && parasitics_->isPiModel(arg.drvr_parasitic_)) {
+    parasitics_->piModel(arg.drvr_parasitic_, pi_c2, pi_rpi, pi_c1);
+    parasitic = nullptr;
+  }
+  GateDelayCacheEntry *cache_entry =
+    findGateDelayCacheEntry(drvr_vertex, arg.arc_, arg.dcalc_ap_->index());
+  cache_entry->valid_ = true;
+  cache_entry->from_slew_ = delayAsFloat(arg.in_slew_);
+  cache_entry->load_cap_ = arg.load_cap_;
+  cache_entry->related_out_cap_ = arg.related_out_cap_;
+  cache_entry->parasitic_ = parasitic;
+  cache_entry->pi_c2_ = pi_c2;
+  cache_entry->pi_rpi_ = pi_rpi;
+  cache_entry->pi_c1_ = pi_c1;
+  cache_entry->gate_delay_ = result.gate_delay_;
+  cache_entry->gate_slew_ = result.drvr_slew_;
+  cache_entry->loads_.clear();
+  size_t load_index = 0;
+  VertexOutEdgeIterator edge_iter(drvr_vertex, graph_);
+  while (edge_iter.hasNext()) {
+    Edge *wire_edge = edge_iter.next();
+    if (wire_edge->isWire()) {
+      GateDelayCacheLoad load;
+      load.load_vertex_ = wire_edge->to(graph_);
+      load.wire_delay_ = result.wire_delays_[load_index];
+      load.load_slew_ = result.load_slews_[load_index];
+      cache_entry->loads_.push_back(load);
+      load_index++;
+    }
+  }
+}
+
+GateDelayCacheEntry *
+GraphDelayCalc1::findGateDelayCacheEntry(const Vertex *drvr_vertex,
+					 const TimingArc *arc,
+					 DcalcAPIndex ap_index)
+{
+  GateDelayCacheEntrySeq *entries;
+  {
+    UniqueLock lock(gate_delay_cache_lock_);
+    entries = gate_delay_cache_.findKey(drvr_vertex);
+    if (entries == nullptr) {
+      entries = new GateDelayCacheEntrySeq;
+      gate_delay_cache_[drvr_vertex] = entries;
+    }
+  }
+  // Driver vertices are only visited by one thread at a time,
+  // so the entries do not need the lock.
+  for (GateDelayCacheEntry *entry : *entries) {
+    if (entry->arc_ == arc
+	&& entry->ap_index_ == ap_index)
+      return entry;
+  }
+  GateDelayCacheEntry *entry = new GateDelayCacheEntry(arc, ap_index);
+  entries->push_back(entry);
+  return entry;
+}
+
+bool
+GraphDelayCalc1::loadsMatch(const GateDelayCacheEntry *cache_entry,
+			    Vertex *drvr_vertex)
+{
+  size_t load_index = 0;
+  VertexOutEdgeIterator edge_iter(drvr_vertex, graph_);
+  while (edge_iter.hasNext()) {
+    Edge *wire_edge = edge_iter.next();
+    if (wire_edge->isWire()) {
+      if (load_index >= cache_entry->loads_.size()
+	  || cache_entry->loads_[load_index].load_vertex_
+	     != wire_edge->to(graph_))
+	return false;
+      load_index++;
+    }
+  }
+  return load_index == cache_entry->loads_.size();
+}
+
 void
 GraphDelayCalc1::multiDrvrGateDelay(MultiDrvrNet *multi_drvr,
 				    LibertyCell *drvr_cell,
@@ -1450,8 +2377,20 @@ GraphDelayCalc1::annotateLoadDelays(Vertex *drvr_vertex,
 				    const DcalcAnalysisPt *dcalc_ap,
 				    ArcDelayCalc *arc_delay_calc)
 {
-  DcalcAPIndex ap_index = dcalc_ap->index();
-  const MinMax *slew_min_max = dcalc_ap->slewMinMax();
+  annotateLoadDelays(drvr_vertex, drvr_tr, extra_delay, merge, dcalc_ap,
+		     arc_delay_calc, nullptr);
+}
+
+// Record the load delays in cache_entry if it is not null.
+void
+GraphDelayCalc1::annotateLoadDelays(Vertex *drvr_vertex,
+				    const TransRiseFall *drvr_tr,
+				    const ArcDelay &extra_delay,
+				    bool merge,
+				    const DcalcAnalysisPt *dcalc_ap,
+				    ArcDelayCalc *arc_delay_calc,
+				    GateDelayCacheEntry *cache_entry)
+{
   VertexOutEdgeIterator edge_iter(drvr_vertex, graph_);
   while (edge_iter.hasNext()) {
     Edge *wire_edge = edge_iter.next();
@@ -1461,52 +2400,98 @@ GraphDelayCalc1::annotateLoadDelays(Vertex *drvr_vertex,
       ArcDelay wire_delay;
       Slew load_slew;
       arc_delay_calc->loadDelay(load_pin, wire_delay, load_slew);
-      debugPrint3(debug_, "delay_calc", 3,
-		  "    %s load delay = %s slew = %s\n",
-		  load_vertex->name(sdc_network_),
-		  delayAsString(wire_delay, this),
-		  delayAsString(load_slew, this));
-      if (!load_vertex->slewAnnotated(drvr_tr, slew_min_max)) {
-	if (drvr_vertex->slewAnnotated(drvr_tr, slew_min_max)) {
-	  // Copy the driver slew to the load if it is annotated.
-	  const Slew &drvr_slew = graph_->slew(drvr_vertex,drvr_tr,ap_index);
-	  graph_->setSlew(load_vertex, drvr_tr, ap_index, drvr_slew);
-	}
-	else {
-	  const Slew &slew = graph_->slew(load_vertex, drvr_tr, ap_index);
-	  if (!merge
-	      || fuzzyGreater(load_slew, slew, slew_min_max))
-	    graph_->setSlew(load_vertex, drvr_tr, ap_index, load_slew);
-	}
-      }
-      if (!graph_->wireDelayAnnotated(wire_edge, drvr_tr, ap_index)) {
-	// Multiple timing arcs with the same output transition
-	// annotate the same wire edges so they must be combined
-	// rather than set.
-	const ArcDelay &delay = graph_->wireArcDelay(wire_edge, drvr_tr,
-						     ap_index);
-	Delay wire_delay_extra = extra_delay + wire_delay;
-	const MinMax *delay_min_max = dcalc_ap->delayMinMax();
-	if (!merge
-	    || fuzzyGreater(wire_delay_extra, delay, delay_min_max)) {
-	  graph_->setWireArcDelay(wire_edge, drvr_tr, ap_index,
-				  wire_delay_extra);
-	  if (observer_)
-	    observer_->delayChangedTo(load_vertex);
-	}
+      if (cache_entry) {
+	GateDelayCacheLoad load;
+	load.load_vertex_ = load_vertex;
+	load.wire_delay_ = wire_delay;
+	load.load_slew_ = load_slew;
+	cache_entry->loads_.push_back(load);
       }
-      // Enqueue bidirect driver from load vertex.
-      if (sdc_->bidirectDrvrSlewFromLoad(load_pin))
-	iter_->enqueue(graph_->pinDrvrVertex(load_pin));
+      annotateLoadDelay(drvr_vertex, drvr_tr, wire_edge,
+			wire_delay, load_slew, extra_delay, merge, dcalc_ap);
+    }
+  }
+}
+
+void
+GraphDelayCalc1::annotateCachedLoadDelays(Vertex *drvr_vertex,
+					  const TransRiseFall *drvr_tr,
+					  const DcalcAnalysisPt *dcalc_ap,
+					  const GateDelayCacheEntry *cache_entry)
+{
+  size_t load_index = 0;
+  VertexOutEdgeIterator edge_iter(drvr_vertex, graph_);
+  while (edge_iter.hasNext()) {
+    Edge *wire_edge = edge_iter.next();
+    if (wire_edge->isWire()) {
+      const GateDelayCacheLoad &load = cache_entry->loads_[load_index++];
+      annotateLoadDelay(drvr_vertex, drvr_tr, wire_edge,
+			load.wire_delay_, load.load_slew_,
+			delay_zero, true, dcalc_ap);
+    }
+  }
+}
+
+void
+GraphDelayCalc1::annotateLoadDelay(Vertex *drvr_vertex,
+				   const TransRiseFall *drvr_tr,
+				   Edge *wire_edge,
+				   const ArcDelay &wire_delay,
+				   const Slew &load_slew,
+				   const ArcDelay &extra_delay,
+				   bool merge,
+				   const DcalcAnalysisPt *dcalc_ap)
+{
+  DcalcAPIndex ap_index = dcalc_ap->index();
+  const MinMax *slew_min_max = dcalc_ap->slewMinMax();
+  Vertex *load_vertex = wire_edge->to(graph_);
+  Pin *load_pin = load_vertex->pin();
+  debugPrint3(debug_, debug_delay_calc_, 3,
+	      "    %s load delay = %s slew = %s\n",
+	      load_vertex->name(sdc_network_),
+	      delayAsString(wire_delay, this),
+	      delayAsString(load_slew, this));
+  if (!load_vertex->slewAnnotated(drvr_tr, slew_min_max)) {
+    if (drvr_vertex->slewAnnotated(drvr_tr, slew_min_max)) {
+      // Copy the driver slew to the load if it is annotated.
+      const Slew &drvr_slew = graph_->slew(drvr_vertex,drvr_tr,ap_index);
+      graph_->setSlew(load_vertex, drvr_tr, ap_index, drvr_slew);
+    }
+    else {
+      const Slew &slew = graph_->slew(load_vertex, drvr_tr, ap_index);
+      if (!merge
+	  || fuzzyGreater(load_slew, slew, slew_min_max))
+	graph_->setSlew(load_vertex, drvr_tr, ap_index, load_slew);
     }
   }
+  if (!graph_->wireDelayAnnotated(wire_edge, drvr_tr, ap_index)) {
+    // Multiple timing arcs with the same output transition
+    // annotate the same wire edges so they must be combined
+    // rather than set.
+    const ArcDelay &delay = graph_->wireArcDelay(wire_edge, drvr_tr,
+						 ap_index);
+    Delay wire_delay_extra = extra_delay + wire_delay;
+    const MinMax *delay_min_max = dcalc_ap->delayMinMax();
+    if (!merge
+	|| fuzzyGreater(wire_delay_extra, delay, delay_min_max)) {
+      graph_->setWireArcDelay(wire_edge, drvr_tr, ap_index,
+			      wire_delay_extra);
+      // Merged wire delays are compared with their previous values
+      // by loadDelaysChanged after all of the driver arcs are found.
+      if (observer_ && !merge)
+	observer_->delayChangedTo(load_vertex);
+    }
+  }
+  // Enqueue bidirect driver from load vertex.
+  if (sdc_->bidirectDrvrSlewFromLoad(load_pin))
+    iter_->enqueue(graph_->pinDrvrVertex(load_pin));
 }
 
 void
 GraphDelayCalc1::findCheckDelays(Vertex *vertex,
 				 ArcDelayCalc *arc_delay_calc)
 {
-  debugPrint2(debug_, "delay_calc", 2, "find checks %s (%s)\n",
+  debugPrint2(debug_, debug_delay_calc_, 2, "find checks %s (%s)\n",
 	      vertex->name(sdc_network_),
 	      network_->cellName(network_->instance(vertex->pin())));
   if (vertex->hasChecks()) {
@@ -1542,6 +2527,9 @@ void
 GraphDelayCalc1::findCheckEdgeDelays(Edge *edge,
 				     ArcDelayCalc *arc_delay_calc)
 {
+  // Fully SDF annotated checks have nothing to calculate.
+  if (graph_->allDelaysAnnotated(edge))
+    return;
   Vertex *from_vertex = edge->from(graph_);
   Vertex *to_vertex = edge->to(graph_);
   TimingArcSet *arc_set = edge->timingArcSet();
@@ -1571,14 +2559,14 @@ GraphDelayCalc1::findCheckEdgeDelays(Edge *edge,
 						   dcalc_ap);
 	  int slew_index = dcalc_ap->checkDataSlewIndex();
 	  const Slew &to_slew = graph_->slew(to_vertex, to_tr, slew_index);
-	  debugPrint5(debug_, "delay_calc", 3,
+	  debugPrint5(debug_, debug_delay_calc_, 3,
 		      "  %s %s -> %s %s (%s)\n",
 		      arc_set->from()->name(),
 		      arc->fromTrans()->asString(),
 		      arc_set->to()->name(),
 		      arc->toTrans()->asString(),
 		      arc_set->role()->asString());
-	  debugPrint2(debug_, "delay_calc", 3,
+	  debugPrint2(debug_, debug_delay_calc_, 3,
 		      "    from_slew = %s to_slew = %s\n",
 		      delayAsString(from_slew, this),
 		      delayAsString(to_slew, this));
@@ -1596,7 +2584,7 @@ GraphDelayCalc1::findCheckEdgeDelays(Edge *edge,
 				     related_out_cap,
 				     pvt, dcalc_ap,
 				     check_delay);
-	  debugPrint1(debug_, "delay_calc", 3,
+	  debugPrint1(debug_, debug_delay_calc_, 3,
 		      "    check_delay = %s\n",
 		      delayAsString(check_delay, this));
 	  graph_->setArcDelay(edge, arc, ap_index, check_delay);
@@ -1680,6 +2668,7 @@ void
 GraphDelayCalc1::clearIdealClkMap()
 {
   ideal_clks_map_.deleteContentsClear();
+  ideal_clk_vertices_.clear();
 }
 
 bool
@@ -1694,6 +2683,10 @@ GraphDelayCalc1::setIdealClks(const Vertex *vertex,
   else {
     delete clks1;
     ideal_clks_map_[vertex] = clks;
+    if (clks && !clks->empty())
+      ideal_clk_vertices_.insert(vertex, graph_);
+    else
+      ideal_clk_vertices_.erase(vertex, graph_);
     changed = true;
   }
   return changed;
@@ -1702,6 +2695,8 @@ GraphDelayCalc1::setIdealClks(const Vertex *vertex,
 ClockSet *
 GraphDelayCalc1::idealClks(const Vertex *vertex)
 {
+  if (!ideal_clk_vertices_.hasKey(vertex, graph_))
+    return nullptr;
   UniqueLock lock(ideal_clks_map_lock_);
   ClockSet *clks = ideal_clks_map_.findKey(vertex);
   return clks;
@@ -18,6 +18,14 @@
 #define STA_GRAPH_DELAY_CALC1_H
 
 #include <mutex>
+#include <atomic>
+#include <vector>
+#include "Vector.hh"
+#include "Debug.hh"
+#include "Delay.hh"
+#include "Transition.hh"
+#include "VertexBitSet.hh"
+#include "ArcDelayCalc.hh"
 #include "GraphDelayCalc.hh"
 
 namespace sta {
@@ -25,9 +33,28 @@ namespace sta {
 class MultiDrvrNet;
 class FindVertexDelays;
 class Corner;
+class GateDelayCacheEntry;
+class VertexVisitedBits;
 
 typedef Map<const Vertex*, MultiDrvrNet*> MultiDrvrNetMap;
 typedef Map<const Vertex*, ClockSet*> VertexIdealClksMap;
+typedef Vector<GateDelayCacheEntry*> GateDelayCacheEntrySeq;
+typedef Map<const Vertex*, GateDelayCacheEntrySeq*> GateDelayCacheMap;
+
+// Arc delay calculator inputs of a driver pin that are shared by all
+// of its timing arcs for one analysis point.
+class DrvrApInputs
+{
+public:
+  DrvrApInputs();
+
+  const Pvt *pvt_;
+  bool load_valid_[TransRiseFall::index_count];
+  Parasitic *parasitic_[TransRiseFall::index_count];
+  float load_cap_[TransRiseFall::index_count];
+};
+
+typedef Vector<DrvrApInputs> DrvrApInputsSeq;
 
 // This class traverses the graph calling the arc delay calculator and
 // annotating delays on graph edges.
@@ -38,6 +65,8 @@ public:
   virtual ~GraphDelayCalc1();
   virtual void copyState(const StaState *sta);
   virtual void delaysInvalid();
+  virtual void delaysRestored();
+  virtual bool delaysValid() const;
   virtual void delayInvalid(Vertex *vertex);
   virtual void delayInvalid(const Pin *pin);
   virtual void deleteVertexBefore(Vertex *vertex);
@@ -51,6 +80,14 @@ public:
   virtual float incrementalDelayTolerance();
   virtual void setIncrementalDelayTolerance(float tol);
   virtual void setObserver(DelayCalcObserver *observer);
+  virtual bool gateDelayCache() const;
+  virtual void setGateDelayCache(bool enable);
+  virtual bool levelBatch() const;
+  virtual void setLevelBatch(bool enable);
+  virtual void gateDelayCacheStats(// Return values.
+				   size_t &hits,
+				   size_t &misses,
+				   size_t &entries) const;
   // Load pin_cap + wire_cap.
   virtual float loadCap(const Pin *drvr_pin,
 			const TransRiseFall *drvr_tr,
@@ -79,10 +116,22 @@ public:
   float ceff(Edge *edge,
 	     TimingArc *arc,
 	     const DcalcAnalysisPt *dcalc_ap);
+  virtual Parasitic *estimatedParasitic(const Pin *drvr_pin,
+					const TransRiseFall *tr,
+					const DcalcAnalysisPt *dcalc_ap) const;
+  virtual bool isMultiDrvr(const Vertex *drvr_vertex) const;
 
 protected:
   void seedInvalidDelays();
+  void reduceParasitics();
+  void estimateParasitics();
+  void deleteEstimatedParasitics();
   void ensureMultiDrvrNetsFound();
+  void findMultiDrvrNets(const Instance *inst,
+			 VertexVisitedBits &found,
+			 // Return value.
+			 Vector<PinSet*> &nets);
+  VertexIndex drvrVertexIndex(const Pin *pin) const;
   void makeMultiDrvrNet(PinSet &drvr_pins);
   void initSlew(Vertex *vertex);
   void seedRootSlew(Vertex *vertex,
@@ -133,9 +182,23 @@ protected:
 			    Vertex *drvr_vertex,
 			    MultiDrvrNet *multi_drvr,
 			    Edge *edge,
+			    DrvrApInputsSeq &ap_inputs,
 			    ArcDelayCalc *arc_delay_calc);
+  void findDrvrApLoad(const Pin *drvr_pin,
+		      MultiDrvrNet *multi_drvr,
+		      const TransRiseFall *tr,
+		      const DcalcAnalysisPt *dcalc_ap,
+		      ArcDelayCalc *arc_delay_calc,
+		      DrvrApInputs &inputs);
   void initWireDelays(Vertex *drvr_vertex,
 		      bool init_load_slews);
+  void findDrvrLoadDelays(Vertex *drvr_vertex,
+			  // Return value.
+			  std::vector<Delay> &delays);
+  bool loadDelaysChanged(Vertex *drvr_vertex,
+			 const std::vector<Delay> &prev_delays);
+  bool delayChanged(const Delay &prev_delay,
+		    const Delay &delay) const;
   void initRootSlews(Vertex *vertex);
   void findVertexDelay(Vertex *vertex,
 		       ArcDelayCalc *arc_delay_calc,
@@ -148,6 +211,7 @@ protected:
 		    MultiDrvrNet *multi_drvr,
 		    TimingArc *arc,
 		    Parasitic *drvr_parasitic,
+		    float load_cap,
 		    float related_out_cap,
 		    Vertex *from_vertex,
 		    Edge *edge,
@@ -160,6 +224,56 @@ protected:
 			  bool merge,
 			  const DcalcAnalysisPt *dcalc_ap,
 			  ArcDelayCalc *arc_delay_calc);
+  void annotateLoadDelays(Vertex *drvr_vertex,
+			  const TransRiseFall *drvr_tr,
+			  const ArcDelay &extra_delay,
+			  bool merge,
+			  const DcalcAnalysisPt *dcalc_ap,
+			  ArcDelayCalc *arc_delay_calc,
+			  GateDelayCacheEntry *cache_entry);
+  void annotateCachedLoadDelays(Vertex *drvr_vertex,
+				const TransRiseFall *drvr_tr,
+				const DcalcAnalysisPt *dcalc_ap,
+				const GateDelayCacheEntry *cache_entry);
+  void annotateLoadDelay(Vertex *drvr_vertex,
+			 const TransRiseFall *drvr_tr,
+			 Edge *wire_edge,
+			 const ArcDelay &wire_delay,
+			 const Slew &load_slew,
+			 const ArcDelay &extra_delay,
+			 bool merge,
+			 const DcalcAnalysisPt *dcalc_ap);
+  void cachedGateDelay(LibertyCell *drvr_cell,
+		       Vertex *drvr_vertex,
+		       TimingArc *arc,
+		       const Slew &from_slew,
+		       float load_cap,
+		       Parasitic *drvr_parasitic,
+		       float related_out_cap,
+		       const Pvt *pvt,
+		       const DcalcAnalysisPt *dcalc_ap,
+		       ArcDelayCalc *arc_delay_calc,
+		       // Return values.
+		       ArcDelay &gate_delay,
+		       Slew &gate_slew,
+		       GateDelayCacheEntry *&cache_entry,
+		       bool &cache_hit);
+  void findLevelGateDelays(const VertexSeq &vertices);
+  void levelGateDelayArgs(Vertex *drvr_vertex,
+			  ArcDelayCalc *arc_delay_calc,
+			  // Return values.
+			  ArcDcalcArgSeq &args,
+			  VertexSeq &arg_drvrs);
+  void saveLevelGateDelay(Vertex *drvr_vertex,
+			  const ArcDcalcArg &arg,
+			  const ArcDcalcResult &result);
+  GateDelayCacheEntry *findGateDelayCacheEntry(const Vertex *drvr_vertex,
+					       const TimingArc *arc,
+					       DcalcAPIndex ap_index);
+  bool loadsMatch(const GateDelayCacheEntry *cache_entry,
+		  Vertex *drvr_vertex);
+  void deleteGateDelayCache(const Vertex *drvr_vertex);
+  void clearGateDelayCache();
   void findCheckDelays(Vertex *vertex,
 		       ArcDelayCalc *arc_delay_calc);
   void findCheckEdgeDelays(Edge *edge,
@@ -221,10 +335,9 @@ protected:
   bool incremental_;
   bool delays_exist_;
   // Vertices with invalid -to delays.
-  VertexSet invalid_delays_;
+  VertexBitSet invalid_delays_;
   // Vertices with invalid -from/-to timing checks.
-  VertexSet invalid_checks_;
-  std::mutex check_vertices_lock_;
+  VertexBitSet invalid_checks_;
   SearchPred *search_pred_;
   SearchPred *search_non_latch_pred_;
   SearchPred *clk_pred_;
@@ -236,6 +349,31 @@ protected:
   float incremental_delay_tolerance_;
   VertexIdealClksMap ideal_clks_map_;
   std::mutex ideal_clks_map_lock_;
+  // Vertices with ideal clocks in ideal_clks_map_, so vertices outside
+  // of the ideal clock network are checked without locking the map.
+  VertexBitSet ideal_clk_vertices_;
+  // Gate and load delays of the last calculation of each driver
+  // timing arc, reused while the arc inputs do not change.
+  bool gate_delay_cache_enabled_;
+  // TCL variable sta_dcalc_level_batch.
+  bool level_batch_enabled_;
+  // The gate delays of each level are found in one batch that is passed
+  // to the visit thru the gate delay cache, either because the arc delay
+  // calculator batches gate delays or level_batch_enabled_.
+  bool batch_gate_delays_;
+  // Arc delay calculator for each thread used to find level batches.
+  Vector<ArcDelayCalc*> batch_arc_delay_calcs_;
+  GateDelayCacheMap gate_delay_cache_;
+  std::mutex gate_delay_cache_lock_;
+  std::atomic<size_t> gate_delay_cache_hits_;
+  std::atomic<size_t> gate_delay_cache_misses_;
+  // Wireload parasitics estimated for all drivers before the first
+  // delay calculation pass when there are no annotated parasitics,
+  // indexed by [drvr_slot][dcalc_ap][tr].
+  std::vector<Parasitic*> estimated_parasitics_;
+  // estimated_parasitics_ driver slot indexed by vertex index.
+  std::vector<size_t> estimated_drvr_slots_;
+  DebugHandle debug_delay_calc_;
 
   friend class FindVertexDelays;
   friend class MultiDrvrNet;
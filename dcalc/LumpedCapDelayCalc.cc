@@ -78,6 +78,10 @@ LumpedCapDelayCalc::findParasitic(const Pin *drvr_pin,
     const MinMax *cnst_min_max = dcalc_ap->constraintMinMax();
     Wireload *wireload = sdc_->wireloadDefaulted(cnst_min_max);
     if (wireload) {
+      // Estimated for all drivers before delay calculation.
+      parasitic = graph_delay_calc_->estimatedParasitic(drvr_pin, tr, dcalc_ap);
+      if (parasitic)
+	return parasitic;
       float pin_cap, wire_cap, fanout;
       bool has_wire_cap;
       graph_delay_calc_->netCaps(drvr_pin, tr, dcalc_ap,
@@ -0,0 +1,91 @@
+# OpenSTA, Static Timing Analyzer
+# Copyright (c) 2019, Parallax Software, Inc.
+#
+# This program is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+# Benchmark driver for designs written by GenBenchDesign.tcl.
+#
+# sta -no_splash -no_init -x "source etc/GenBenchDesign.tcl;\
+#   source etc/Bench.tcl; sta::bench_run bench_dir {1 2 4 8}; exit"
+#
+# Each step is reported as one line with the wall clock time in
+# seconds so runs can be compared with diff or a spreadsheet.
+#  bench <step> <threads> <seconds>
+
+namespace eval sta {
+
+proc bench_run { dir thread_counts { eco_count 100 } } {
+  if { ![file exists [file join $dir "bench.v"]] } {
+    gen_bench_design $dir
+  }
+  bench_step "read_liberty" 1 \
+    [list read_liberty [file join $dir "bench.lib"]]
+  bench_step "read_verilog" 1 \
+    [list read_verilog [file join $dir "bench.v"]]
+  bench_step "link_design" 1 [list link_design "bench"]
+  bench_step "read_sdc" 1 [list read_sdc [file join $dir "bench.sdc"]]
+  bench_step "read_spef" 1 [list read_spef [file join $dir "bench.spef"]]
+  set insts [bench_eco_insts $eco_count]
+  foreach thread_count $thread_counts {
+    set_thread_count $thread_count
+    bench_step "update_timing" $thread_count "find_timing -full_update"
+    bench_step "eco" $thread_count [list sta::bench_ecos $insts]
+    bench_step "report_checks" $thread_count \
+      "report_checks -group_count 100 > /dev/null"
+  }
+  puts "bench memory [format %.0f [expr [mem] / 1e6]]MB"
+}
+
+proc bench_step { step thread_count cmd } {
+  set start [clock microseconds]
+  uplevel #0 $cmd
+  set seconds [expr ([clock microseconds] - $start) * 1e-6]
+  puts [format "bench %-14s %2d %8.3f" $step $thread_count $seconds]
+}
+
+# Combinational gates spread evenly through the design.
+proc bench_eco_insts { eco_count } {
+  set insts {}
+  set gates [get_cells -quiet "g*"]
+  set gate_count [llength $gates]
+  if { $gate_count > 0 } {
+    set stride [expr max(1, $gate_count / $eco_count)]
+    for {set i 0} {$i < $gate_count && [llength $insts] < $eco_count} \
+      {incr i $stride} {
+      lappend insts [get_full_name [lindex $gates $i]]
+    }
+  }
+  return $insts
+}
+
+# Swap each instance between its X1 and X2 sizes and retime, then
+# restore the original cells so every thread count sees the same design.
+proc bench_ecos { insts } {
+  foreach inst $insts {
+    set cell [[[get_cells $inst] liberty_cell] name]
+    set cells($inst) $cell
+    if { ![regsub "_X1\$" $cell "_X2" swap_cell] } {
+      regsub "_X2\$" $cell "_X1" swap_cell
+    }
+    replace_cell $inst $swap_cell
+    find_timing
+  }
+  foreach inst $insts {
+    replace_cell $inst $cells($inst)
+    find_timing
+  }
+}
+
+# sta namespace end.
+}
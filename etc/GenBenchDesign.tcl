@@ -0,0 +1,460 @@
+# OpenSTA, Static Timing Analyzer
+# Copyright (c) 2019, Parallax Software, Inc.
+#
+# This program is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+# Synthetic benchmark design generator.
+#
+# Writes bench.lib, bench.v, bench.spef and bench.sdc to a directory.
+# The design is a register bank followed by depth levels of gates that
+# feed back to the registers. Gate inputs come from nearby gates in the
+# previous level except for a fraction that come from a few high
+# fanout nets. The same options and seed always make the same design.
+#
+# tclsh GenBenchDesign.tcl dir [-instances count] [-depth levels]
+#   [-clocks count] [-latch_ratio ratio] [-high_fanout fanout]
+#   [-high_fanout_ratio ratio] [-seed seed]
+
+namespace eval sta {
+
+proc gen_bench_design { dir args } {
+  variable bench_seed
+
+  array set opts {
+    -instances 10000
+    -depth 20
+    -clocks 1
+    -latch_ratio 0.0
+    -high_fanout 32
+    -high_fanout_ratio 0.02
+    -seed 1
+  }
+  foreach {key value} $args {
+    if { ![info exists opts($key)] } {
+      error "gen_bench_design unknown option $key."
+    }
+    set opts($key) $value
+  }
+  set depth [expr max(1, $opts(-depth))]
+  set width [expr max(1, $opts(-instances) / ($depth + 1))]
+  set clk_count [expr max(1, $opts(-clocks))]
+  set input_count [expr max(1, $width / 16)]
+  set output_count [expr max(1, $width / 16)]
+  set bench_seed $opts(-seed)
+
+  file mkdir $dir
+  gen_bench_liberty [file join $dir "bench.lib"]
+
+  # Net connections for the spef.
+  # drvr(net) driver pin, loads(net) load pins
+  array set drvr {}
+  array set loads {}
+  set stream [open [file join $dir "bench.v"] w]
+  puts $stream "module bench ("
+  set ports {}
+  for {set c 0} {$c < $clk_count} {incr c} {
+    lappend ports "clk$c"
+  }
+  for {set i 0} {$i < $input_count} {incr i} {
+    lappend ports "in$i"
+  }
+  for {set i 0} {$i < $output_count} {incr i} {
+    lappend ports "out$i"
+  }
+  puts $stream "  [join $ports ",\n  "]);"
+  for {set c 0} {$c < $clk_count} {incr c} {
+    puts $stream "  input clk$c;"
+    set drvr(clk$c) "*P clk$c"
+  }
+  for {set i 0} {$i < $input_count} {incr i} {
+    puts $stream "  input in$i;"
+    set drvr(in$i) "*P in$i"
+  }
+  for {set i 0} {$i < $output_count} {incr i} {
+    puts $stream "  output out$i;"
+  }
+  for {set l 0} {$l <= $depth} {incr l} {
+    for {set i 0} {$i < $width} {incr i} {
+      puts $stream "  wire n${l}_$i;"
+    }
+  }
+
+  # Register bank.
+  for {set i 0} {$i < $width} {incr i} {
+    set clk "clk[expr $i % $clk_count]"
+    set d "n${depth}_$i"
+    set q "n0_$i"
+    if { [bench_rand] < $opts(-latch_ratio) } {
+      puts $stream "  DLAT_X1 r$i (.D($d), .G($clk), .Q($q));"
+      set clk_pin "r$i:G"
+    } else {
+      puts $stream "  DFF_X1 r$i (.D($d), .CK($clk), .Q($q));"
+      set clk_pin "r$i:CK"
+    }
+    lappend loads($clk) $clk_pin
+    lappend loads($d) "r$i:D"
+    set drvr($q) "r$i:Q"
+  }
+
+  # Gate levels.
+  set high_fanout_count [expr max(1, int($width * $opts(-high_fanout_ratio) \
+					      * 1.7 / $opts(-high_fanout)))]
+  for {set l 1} {$l <= $depth} {incr l} {
+    set prev [expr $l - 1]
+    for {set i 0} {$i < $width} {incr i} {
+      set r [bench_rand]
+      if { $r < 0.15 } {
+	set cell "INV"
+	set in_pins {A}
+      } elseif { $r < 0.3 } {
+	set cell "BUF"
+	set in_pins {A}
+      } elseif { $r < 0.65 } {
+	set cell "NAND2"
+	set in_pins {A B}
+      } else {
+	set cell "NOR2"
+	set in_pins {A B}
+      }
+      if { [bench_rand] < 0.2 } {
+	append cell "_X2"
+      } else {
+	append cell "_X1"
+      }
+      set inst "g${l}_$i"
+      set conns {}
+      foreach pin $in_pins {
+	if { $l == 1 && $pin == "B" && [bench_rand] < 0.25 } {
+	  set net "in[expr $i % $input_count]"
+	} elseif { [bench_rand] < $opts(-high_fanout_ratio) } {
+	  set net "n${prev}_[bench_rand_int $high_fanout_count]"
+	} else {
+	  # Nearby gates in the previous level.
+	  set offset [expr [bench_rand_int 9] - 4]
+	  set net "n${prev}_[expr ($i + $offset + $width) % $width]"
+	}
+	lappend conns ".$pin\($net\)"
+	lappend loads($net) "$inst:$pin"
+      }
+      set net "n${l}_$i"
+      lappend conns ".Y\($net\)"
+      set drvr($net) "$inst:Y"
+      puts $stream "  $cell $inst ([join $conns ", "]);"
+    }
+  }
+
+  # Output buffers.
+  for {set i 0} {$i < $output_count} {incr i} {
+    set net "n${depth}_[expr $i % $width]"
+    puts $stream "  BUF_X1 ob$i (.A($net), .Y(out$i));"
+    lappend loads($net) "ob$i:A"
+    set drvr(out$i) "ob$i:Y"
+    lappend loads(out$i) "*P out$i"
+  }
+  puts $stream "endmodule"
+  close $stream
+
+  gen_bench_spef [file join $dir "bench.spef"] drvr loads
+  gen_bench_sdc [file join $dir "bench.sdc"] $clk_count $depth \
+    $input_count $output_count
+}
+
+# Park-Miller generator so designs do not depend on the Tcl version.
+proc bench_rand {} {
+  variable bench_seed
+
+  set bench_seed [expr ($bench_seed * 48271) % 2147483647]
+  return [expr double($bench_seed) / 2147483647.0]
+}
+
+proc bench_rand_int { count } {
+  return [expr int([bench_rand] * $count) % $count]
+}
+
+################################################################
+
+proc gen_bench_liberty { filename } {
+  set stream [open $filename w]
+  puts $stream "library (bench) {
+  delay_model : table_lookup;
+  time_unit : \"1ns\";
+  voltage_unit : \"1V\";
+  current_unit : \"1mA\";
+  pulling_resistance_unit : \"1kohm\";
+  leakage_power_unit : \"1nW\";
+  capacitive_load_unit (1,pf);
+  nom_process : 1;
+  nom_voltage : 1;
+  nom_temperature : 25;
+  input_threshold_pct_rise : 50;
+  input_threshold_pct_fall : 50;
+  output_threshold_pct_rise : 50;
+  output_threshold_pct_fall : 50;
+  slew_lower_threshold_pct_rise : 20;
+  slew_lower_threshold_pct_fall : 20;
+  slew_upper_threshold_pct_rise : 80;
+  slew_upper_threshold_pct_fall : 80;
+  default_max_transition : 1.0;
+  lu_table_template (delay_2x2) {
+    variable_1 : input_net_transition;
+    variable_2 : total_output_net_capacitance;
+    index_1 (\"0.01, 0.5\");
+    index_2 (\"0.001, 0.1\");
+  }
+  lu_table_template (check_2x2) {
+    variable_1 : constrained_pin_transition;
+    variable_2 : related_pin_transition;
+    index_1 (\"0.01, 0.5\");
+    index_2 (\"0.01, 0.5\");
+  }"
+  foreach {size scale cap} {X1 1.0 0.002 X2 0.6 0.004} {
+    gen_bench_comb_cell $stream "INV_$size" {A} "!A" negative_unate \
+      $scale $cap
+    gen_bench_comb_cell $stream "BUF_$size" {A} "A" positive_unate \
+      $scale $cap
+    gen_bench_comb_cell $stream "NAND2_$size" {A B} "!(A & B)" \
+      negative_unate $scale $cap
+    gen_bench_comb_cell $stream "NOR2_$size" {A B} "!(A | B)" \
+      negative_unate $scale $cap
+  }
+  puts $stream "  cell (DFF_X1) {
+    area : 4;
+    ff (IQ,IQN) {
+      next_state : \"D\";
+      clocked_on : \"CK\";
+    }
+    pin (D) {
+      direction : input;
+      capacitance : 0.002;
+      timing () {
+        related_pin : \"CK\";
+        timing_type : setup_rising;
+[bench_check_tables 0.05]
+      }
+      timing () {
+        related_pin : \"CK\";
+        timing_type : hold_rising;
+[bench_check_tables 0.02]
+      }
+    }
+    pin (CK) {
+      direction : input;
+      capacitance : 0.002;
+      clock : true;
+    }
+    pin (Q) {
+      direction : output;
+      function : \"IQ\";
+      timing () {
+        related_pin : \"CK\";
+        timing_type : rising_edge;
+[bench_delay_tables 1.5]
+      }
+    }
+  }
+  cell (DLAT_X1) {
+    area : 3;
+    latch (IQ,IQN) {
+      data_in : \"D\";
+      enable : \"G\";
+    }
+    pin (D) {
+      direction : input;
+      capacitance : 0.002;
+      timing () {
+        related_pin : \"G\";
+        timing_type : setup_falling;
+[bench_check_tables 0.05]
+      }
+      timing () {
+        related_pin : \"G\";
+        timing_type : hold_falling;
+[bench_check_tables 0.02]
+      }
+    }
+    pin (G) {
+      direction : input;
+      capacitance : 0.002;
+      clock : true;
+    }
+    pin (Q) {
+      direction : output;
+      function : \"IQ\";
+      timing () {
+        related_pin : \"D\";
+        timing_sense : positive_unate;
+[bench_delay_tables 1.2]
+      }
+      timing () {
+        related_pin : \"G\";
+        timing_type : rising_edge;
+[bench_delay_tables 1.2]
+      }
+    }
+  }
+}"
+  close $stream
+}
+
+proc gen_bench_comb_cell { stream cell in_pins function sense scale cap } {
+  puts $stream "  cell ($cell) {"
+  puts $stream "    area : [expr [llength $in_pins] * $cap * 500];"
+  foreach pin $in_pins {
+    puts $stream "    pin ($pin) {
+      direction : input;
+      capacitance : $cap;
+    }"
+  }
+  puts $stream "    pin (Y) {
+      direction : output;
+      function : \"$function\";"
+  foreach pin $in_pins {
+    puts $stream "      timing () {
+        related_pin : \"$pin\";
+        timing_sense : $sense;
+[bench_delay_tables $scale]
+      }"
+  }
+  puts $stream "    }
+  }"
+}
+
+proc bench_delay_tables { scale } {
+  set tables {}
+  foreach {group d0 d1} {cell_rise 0.02 0.30 cell_fall 0.015 0.25 \
+			   rise_transition 0.01 0.40 fall_transition 0.01 0.35} {
+    set v00 [format "%.4f" [expr $d0 * $scale]]
+    set v01 [format "%.4f" [expr $d1 * $scale]]
+    set v10 [format "%.4f" [expr ($d0 + 0.03) * $scale]]
+    set v11 [format "%.4f" [expr ($d1 + 0.05) * $scale]]
+    lappend tables "        $group (delay_2x2) {
+          values (\"$v00, $v01\", \"$v10, $v11\");
+        }"
+  }
+  return [join $tables "\n"]
+}
+
+proc bench_check_tables { check } {
+  set v0 [format "%.4f" $check]
+  set v1 [format "%.4f" [expr $check * 2]]
+  set tables {}
+  foreach group {rise_constraint fall_constraint} {
+    lappend tables "        $group (check_2x2) {
+          values (\"$v0, $v0\", \"$v1, $v1\");
+        }"
+  }
+  return [join $tables "\n"]
+}
+
+################################################################
+
+proc gen_bench_spef { filename drvr_var loads_var } {
+  upvar 1 $drvr_var drvr
+  upvar 1 $loads_var loads
+
+  set stream [open $filename w]
+  puts $stream "*SPEF \"IEEE 1481-1998\""
+  puts $stream "*DESIGN \"bench\""
+  puts $stream "*DATE \"\""
+  puts $stream "*VENDOR \"OpenSTA\""
+  puts $stream "*PROGRAM \"GenBenchDesign\""
+  puts $stream "*VERSION \"1.0\""
+  puts $stream "*DESIGN_FLOW \"\""
+  puts $stream "*DIVIDER /"
+  puts $stream "*DELIMITER :"
+  puts $stream "*BUS_DELIMITER \[ \]"
+  puts $stream "*T_UNIT 1 NS"
+  puts $stream "*C_UNIT 1 PF"
+  puts $stream "*R_UNIT 1 KOHM"
+  puts $stream "*L_UNIT 1 HENRY"
+  puts $stream ""
+  foreach net [lsort -dictionary [array names drvr]] {
+    if { ![info exists loads($net)] } {
+      continue
+    }
+    set drvr_pin $drvr($net)
+    set net_loads $loads($net)
+    set node_cap 0.0005
+    set total_cap [expr $node_cap * (1 + [llength $net_loads])]
+    puts $stream "*D_NET $net [format %.6f $total_cap]"
+    puts $stream "*CONN"
+    puts $stream "[bench_spef_conn $drvr_pin O]"
+    foreach load $net_loads {
+      puts $stream "[bench_spef_conn $load I]"
+    }
+    puts $stream "*CAP"
+    set drvr_node [bench_spef_node $drvr_pin]
+    set i 1
+    puts $stream "$i $drvr_node $node_cap"
+    foreach load $net_loads {
+      incr i
+      puts $stream "$i [bench_spef_node $load] $node_cap"
+    }
+    puts $stream "*RES"
+    set i 0
+    foreach load $net_loads {
+      incr i
+      puts $stream "$i $drvr_node [bench_spef_node $load] 0.05"
+    }
+    puts $stream "*END"
+    puts $stream ""
+  }
+  close $stream
+}
+
+# Pins are "inst:pin" or "*P port".
+proc bench_spef_conn { pin dir } {
+  if { [string match "\\*P *" $pin] } {
+    # Top level ports have the opposite direction.
+    set port_dir [expr { $dir == "O" ? "I" : "O" }]
+    return "*P [lindex $pin 1] $port_dir"
+  } else {
+    return "*I $pin $dir"
+  }
+}
+
+proc bench_spef_node { pin } {
+  if { [string match "\\*P *" $pin] } {
+    return [lindex $pin 1]
+  } else {
+    return $pin
+  }
+}
+
+################################################################
+
+proc gen_bench_sdc { filename clk_count depth input_count output_count } {
+  set stream [open $filename w]
+  set period [format "%.2f" [expr $depth * 0.15 + 0.5]]
+  for {set c 0} {$c < $clk_count} {incr c} {
+    puts $stream "create_clock -name clk$c -period $period \[get_ports clk$c\]"
+  }
+  puts $stream "set_input_delay -clock clk0 0.1 \[get_ports in*\]"
+  puts $stream "set_output_delay -clock clk0 0.1 \[get_ports out*\]"
+  puts $stream "set_load 0.01 \[get_ports out*\]"
+  close $stream
+}
+
+# sta namespace end.
+}
+
+if { [info exists argv0] && [file tail $argv0] == "GenBenchDesign.tcl" } {
+  if { [llength $argv] < 1 } {
+    puts "GenBenchDesign.tcl dir \[-instances count\] \[-depth levels\]\
+ \[-clocks count\] \[-latch_ratio ratio\] \[-high_fanout fanout\]\
+ \[-high_fanout_ratio ratio\] \[-seed seed\]"
+    exit 1
+  }
+  eval sta::gen_bench_design $argv
+}
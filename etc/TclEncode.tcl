@@ -24,6 +24,14 @@ exec tclsh $0 ${1+"$@"}
 # Each TCL file is encoded as a separate string of three digit decimal numbers
 # that is unencoded and evaled on startup of the application.  
 # The init variable character array is terminated with a NULL pointer.
+#
+# Procs are loaded lazily to reduce startup time. Top level proc and
+# proc_redirect definitions are replaced by stubs that load all of the
+# procs in the same file (group) on first use and call the real proc.
+# Everything else in the files is evaluated at startup.
+# The proc definitions of each group follow the startup script as
+# "\001group\n" and a list of {namespace proc_name definition}.
+# They are not parsed until the group is loaded (see evalTclInit).
 
 set encoded_filename [lindex $argv 0]
 set init_var [lindex $argv 1]
@@ -68,17 +76,132 @@ proc encode_line { line } {
   incr encoded_length 3
 }
 
-proc encode_file { filename } {
-  set in_stream [open $filename r]
-  while {![eof $in_stream]} {
-    gets $in_stream line
+proc encode_string { str } {
+  foreach line [split $str "\n"] {
     encode_line $line
   }
-  close $in_stream
 }
 
+# Split script into top level commands.
+# Top level comments are dropped.
+proc split_commands { script } {
+  set cmds {}
+  set cmd ""
+  set in_comment 0
+  foreach line [split $script "\n"] {
+    if { $cmd == "" } {
+      set trimmed [string trimleft $line]
+      if { $in_comment || [string index $trimmed 0] == "#" } {
+	# Comments continue with a trailing backslash.
+	set in_comment [string match {*\\} $line]
+	continue
+      }
+      if { $trimmed == "" } {
+	continue
+      }
+    }
+    append cmd $line "\n"
+    if { [info complete $cmd] } {
+      lappend cmds $cmd
+      set cmd ""
+    }
+  }
+  if { $cmd != "" } {
+    lappend cmds $cmd
+  }
+  return $cmds
+}
+
+proc lazy_proc_stub { group } {
+  return "::sta::load_tcl_group $group; uplevel 1 \[info level 0\]"
+}
+
+# Return script with the proc definitions in namespace ns replaced by
+# stubs that load group. The definitions are appended to lazy_procs(group).
+proc lazy_script { script group ns } {
+  global lazy_procs
+
+  set eager ""
+  foreach cmd [split_commands $script] {
+    if { [catch {llength $cmd} length] == 0 && $length > 0 } {
+      set cmd_name [lindex $cmd 0]
+      if { $cmd_name == "namespace" && $length == 4 \
+	     && [lindex $cmd 1] == "eval" \
+	     && [string is wordchar [lindex $cmd 2]] } {
+	set child [lindex $cmd 2]
+	if { $ns == "::" } {
+	  set child_ns "::$child"
+	} else {
+	  set child_ns "${ns}::$child"
+	}
+	append eager "namespace eval $child \{\n" \
+	  [lazy_script [lindex $cmd 3] $group $child_ns] "\}\n"
+	continue
+      }
+      set proc_name [lindex $cmd 1]
+      if { (($cmd_name == "proc" && $length == 4) \
+	      || ($cmd_name == "proc_redirect" && $length == 3)) \
+	     && [string is wordchar $proc_name] } {
+	lappend lazy_procs($group) $ns $proc_name $cmd
+	append eager [list proc $proc_name args [lazy_proc_stub $group]] "\n"
+	continue
+      }
+    }
+    append eager $cmd
+  }
+  return $eager
+}
+
+# Defined before the stubs are evaluated.
+# Only procs that are still stubs for group are defined, so procs
+# redefined by later groups or users are not replaced. Stubs evaluated
+# after the group is loaded are defined when they are called.
+# The last definition of a proc in the group is used.
+set lazy_loader {
+namespace eval sta {
+variable tcl_groups
+
+proc load_tcl_group { group } {
+  variable tcl_groups
+
+  if { ![info exists tcl_groups($group)] } {
+    set tcl_groups($group) [tcl_init_group_procs $group]
+  }
+  set stub "::sta::load_tcl_group $group; uplevel 1 \[info level 0\]"
+  set procs $tcl_groups($group)
+  for {set i [expr [llength $procs] - 3]} {$i >= 0} {incr i -3} {
+    set ns [lindex $procs $i]
+    set name [lindex $procs [expr $i + 1]]
+    if { $ns == "::" } {
+      set proc_name "::$name"
+    } else {
+      set proc_name "${ns}::$name"
+    }
+    if { [info procs $proc_name] != {} \
+	   && [info body $proc_name] == $stub } {
+      namespace eval $ns [lindex $procs [expr $i + 2]]
+    }
+  }
+}
+
+# sta namespace end
+}
+}
+
+set eager_scripts {}
+set groups {}
 foreach filename $init_filenames {
-  encode_file $filename
+  set in_stream [open $filename r]
+  set script [read $in_stream]
+  close $in_stream
+  set group [file rootname [file tail $filename]]
+  lappend groups $group
+  lappend eager_scripts [lazy_script $script $group "::"]
+}
+
+encode_string $lazy_loader
+foreach eager $eager_scripts {
+  encode_string $eager
 }
 
 # See stax/src/Notify.tcl
@@ -88,6 +211,13 @@ if { $mail_log } {
   puts -nonewline $out_stream "035032117110099111109109101110116032101120105115105116105110103032110111116105102121010035032126047115116097047116114117110107047101116099047084099108069110099111100101046116099108032126047116109112047110111116105102121046099032110111116105102121032126047115116097120047115114099047110111116105102121050046116099108010105102032123032033091105110102111032101120105115116115032101110118040085083069082041093032125032123010032032101114114111114032034069114114111114058032085083069082032101110118105114111110109101110116032118097114105097098108101032110111116032115101116046034010032032101120105116032049010125010105102032123032091099097116099104032091101120101099032109097105108032045115032034115116097032091115116097058058118101114115105111110093032115116097114116101100034032092010009032032032032032032032115116097108111103064112097114097108108097120115119046099111109032060060032034032034093093032125032123010032032101114114111114032034069114114111114058032110111116105102105099097116105111110032109097105108032116111032080097114097108108097120032102097105108101100046034010032032101120105116032049010125010010"
 }
 
+foreach group $groups {
+  if [info exists lazy_procs($group)] {
+    encode_line "\001$group"
+    encode_line $lazy_procs($group)
+  }
+}
+
 puts $out_stream "\","
 # NULL string to terminate char* array.
 puts $out_stream "0"
@@ -14,6 +14,8 @@
 // You should have received a copy of the GNU General Public License
 // along with this program.  If not, see <https://www.gnu.org/licenses/>.
 
+#include <algorithm>
+#include <cmath>
 #include "Machine.hh"
 #include "StringUtil.hh"
 #include "Units.hh"
@@ -29,4 +31,49 @@ delayAsString(const Delay &delay,
   return delayAsString(delay, sta, sta->units()->timeUnit()->digits());
 }
 
+// Distributions more than this many sigmas apart are not blended;
+// the max is the larger distribution to float precision.
+static const float clark_dominance_sigmas = 5.0;
+
+void
+clarkMax(float mean1,
+	 float sigma2_1,
+	 float mean2,
+	 float sigma2_2,
+	 // Return values.
+	 float &mean,
+	 float &sigma2)
+{
+  // Negative sigma^2 offsets common clock path sigmas (crpr).
+  double var1 = std::max(sigma2_1, 0.0F);
+  double var2 = std::max(sigma2_2, 0.0F);
+  double theta = sqrt(var1 + var2);
+  double diff = static_cast<double>(mean1) - mean2;
+  if (theta == 0.0
+      || std::abs(diff) >= clark_dominance_sigmas * theta) {
+    if (mean1 >= mean2) {
+      mean = mean1;
+      sigma2 = sigma2_1;
+    }
+    else {
+      mean = mean2;
+      sigma2 = sigma2_2;
+    }
+  }
+  else {
+    double alpha = diff / theta;
+    // Standard normal cdf and pdf at alpha.
+    double cdf = 0.5 * erfc(-alpha * M_SQRT1_2);
+    double pdf = exp(-0.5 * alpha * alpha) / sqrt(2.0 * M_PI);
+    double m1 = mean1;
+    double m2 = mean2;
+    double mean_max = m1 * cdf + m2 * (1.0 - cdf) + theta * pdf;
+    double moment2 = (m1 * m1 + var1) * cdf
+      + (m2 * m2 + var2) * (1.0 - cdf)
+      + (m1 + m2) * theta * pdf;
+    mean = mean_max;
+    sigma2 = std::max(moment2 - mean_max * mean_max, 0.0);
+  }
+}
+
 } // namespace
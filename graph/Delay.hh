@@ -38,5 +38,16 @@ typedef Delay Arrival;
 typedef Delay Required;
 typedef Delay Slack;
 
+// Clark's moments of the max of two independent normal distributions.
+// Sigmas are passed and returned as sigma^2.
+void
+clarkMax(float mean1,
+	 float sigma2_1,
+	 float mean2,
+	 float sigma2_2,
+	 // Return values.
+	 float &mean,
+	 float &sigma2);
+
 } // namespace
 #endif
@@ -99,6 +99,14 @@ delayRatio(const Delay &delay1,
   return delay1 / delay2;
 }
 
+Delay
+delayStatisticalMax(const Delay &delay1,
+		    const Delay &delay2,
+		    const MinMax *min_max)
+{
+  return min_max->compare(delay1, delay2) ? delay1 : delay2;
+}
+
 const char *
 delayAsString(const Delay &delay,
 	      const StaState *sta)
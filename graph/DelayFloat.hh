@@ -99,6 +99,12 @@ fuzzyLessEqual(const Delay &delay1,
 float
 delayRatio(const Delay &delay1,
 	   const Delay &delay2);
+// Statistical max (min for MinMax::min()) of two independent
+// arrivals using Clark's approximation.
+Delay
+delayStatisticalMax(const Delay &delay1,
+		    const Delay &delay2,
+		    const MinMax *min_max);
 
 } // namespace
 #endif
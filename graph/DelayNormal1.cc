@@ -361,6 +361,26 @@ delayRatio(const Delay &delay1,
   return delay1.mean() / delay2.mean();
 }
 
+Delay
+delayStatisticalMax(const Delay &delay1,
+		    const Delay &delay2,
+		    const MinMax *min_max)
+{
+  float mean, sigma2;
+  if (min_max == MinMax::max())
+    clarkMax(delay1.mean(), delay1.sigma2(),
+	     delay2.mean(), delay2.sigma2(),
+	     mean, sigma2);
+  else {
+    // min(x, y) = -max(-x, -y)
+    clarkMax(-delay1.mean(), delay1.sigma2(),
+	     -delay2.mean(), delay2.sigma2(),
+	     mean, sigma2);
+    mean = -mean;
+  }
+  return Delay(mean, sigma2);
+}
+
 float
 delayAsFloat(const Delay &delay,
 	     const EarlyLate *early_late,
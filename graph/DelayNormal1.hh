@@ -152,6 +152,12 @@ fuzzyGreater(const Delay &delay1,
 float
 delayRatio(const Delay &delay1,
 	   const Delay &delay2);
+// Statistical max (min for MinMax::min()) of two independent
+// arrivals using Clark's approximation.
+Delay
+delayStatisticalMax(const Delay &delay1,
+		    const Delay &delay2,
+		    const MinMax *min_max);
 
 } // namespace
 #endif
@@ -50,26 +50,6 @@ delayInitValue(const MinMax *min_max)
   return delay_init_values[min_max->index()];
 }
 
-Delay::Delay() :
-  mean_(0.0),
-  sigma2_{0.0, 0.0}
-{
-}
-
-Delay::Delay(float mean) :
-  mean_(mean),
-  sigma2_{0.0, 0.0}
-{
-}
-
-Delay::Delay(float mean,
-	     float sigma2_early,
-	     float sigma2_late) :
-  mean_(mean),
-  sigma2_{sigma2_early, sigma2_late}
-{
-}
-
 float
 Delay::sigma(const EarlyLate *early_late) const
 {
@@ -82,134 +62,6 @@ Delay::sigma(const EarlyLate *early_late) const
     return sqrt(sigma);
 }
 
-float
-Delay::sigma2(const EarlyLate *early_late) const
-{
-  return sigma2_[early_late->index()];
-}
-
-float
-Delay::sigma2Early() const
-{
-  return sigma2_[early_index];
-}
-
-float
-Delay::sigma2Late() const
-{
-  return sigma2_[late_index];
-}
-
-void
-Delay::operator=(const Delay &delay)
-{
-  mean_ = delay.mean_;
-  sigma2_[early_index] = delay.sigma2_[early_index];
-  sigma2_[late_index] = delay.sigma2_[late_index];
-}
-
-void
-Delay::operator=(float delay)
-{
-  mean_ = delay;
-  sigma2_[early_index] = 0.0;
-  sigma2_[late_index] = 0.0;
-}
-
-void
-Delay::operator+=(const Delay &delay)
-{
-  mean_ += delay.mean_;
-  sigma2_[early_index] += delay.sigma2_[early_index];
-  sigma2_[late_index] += delay.sigma2_[late_index];
-}
-
-void
-Delay::operator+=(float delay)
-{
-  mean_ += delay;
-}
-
-Delay
-Delay::operator+(const Delay &delay) const
-{
-  return Delay(mean_ + delay.mean_,
-	       sigma2_[early_index] + delay.sigma2_[early_index],
-	       sigma2_[late_index] + delay.sigma2_[late_index]);
-}
-
-Delay
-Delay::operator+(float delay) const
-{
-  return Delay(mean_ + delay, sigma2_[early_index], sigma2_[late_index]);
-}
-
-Delay
-Delay::operator-(const Delay &delay) const
-{
-  return Delay(mean_ - delay.mean_,
-	       sigma2_[early_index] + delay.sigma2_[early_index],
-	       sigma2_[late_index] + delay.sigma2_[late_index]);
-}
-
-Delay
-Delay::operator-(float delay) const
-{
-  return Delay(mean_ - delay, sigma2_[early_index], sigma2_[late_index]);
-}
-
-Delay
-Delay::operator-() const
-{
-  return Delay(-mean_, sigma2_[early_index], sigma2_[late_index]);
-}
-
-void
-Delay::operator-=(float delay)
-{
-  mean_ -= delay;
-}
-
-void
-Delay::operator-=(const Delay &delay)
-{
-  mean_ -= delay.mean_;
-  sigma2_[early_index] += delay.sigma2_[early_index];
-  sigma2_[late_index] += delay.sigma2_[late_index];
-}
-
-bool
-Delay::operator==(const Delay &delay) const
-{
-  return mean_ == delay.mean_
-    && sigma2_[early_index] == delay.sigma2_[early_index]
-    && sigma2_[late_index]  == delay.sigma2_[late_index];
-}
-
-bool
-Delay::operator>(const Delay &delay) const
-{
-  return mean_ > delay.mean_;
-}
-
-bool
-Delay::operator>=(const Delay &delay) const
-{
-  return mean_ >= delay.mean_;
-}
-
-bool
-Delay::operator<(const Delay &delay) const
-{
-  return mean_ < delay.mean_;
-}
-
-bool
-Delay::operator<=(const Delay &delay) const
-{
-  return mean_ <= delay.mean_;
-}
-
 ////////////////////////////////////////////////////////////////
 
 Delay
@@ -282,17 +134,6 @@ fuzzyLessEqual(const Delay &delay1,
   return fuzzyLessEqual(delay1.mean(), delay2);
 }
 
-bool
-fuzzyLessEqual(const Delay &delay1,
-	       const Delay &delay2,
-	       const MinMax *min_max)
-{
-  if (min_max == MinMax::max())
-    return fuzzyLessEqual(delay1.mean(), delay2.mean());
-  else
-    return fuzzyGreaterEqual(delay1.mean(), delay2.mean());
-}
-
 bool
 fuzzyGreater(const Delay &delay1,
 	     const Delay &delay2)
@@ -321,48 +162,6 @@ fuzzyGreaterEqual(const Delay &delay1,
   return fuzzyGreaterEqual(delay1.mean(), delay2);
 }
 
-bool
-fuzzyGreater(const Delay &delay1,
-	     const Delay &delay2,
-	     const MinMax *min_max)
-{
-  if (min_max == MinMax::max())
-    return fuzzyGreater(delay1.mean(), delay2.mean());
-  else
-    return fuzzyLess(delay1.mean(), delay2.mean());
-}
-
-bool
-fuzzyGreaterEqual(const Delay &delay1,
-		  const Delay &delay2,
-		  const MinMax *min_max)
-{
-  if (min_max == MinMax::max())
-    return fuzzyGreaterEqual(delay1.mean(), delay2.mean());
-  else
-    return fuzzyLessEqual(delay1.mean(), delay2.mean());
-}
-
-bool
-fuzzyLess(const Delay &delay1,
-	  const Delay &delay2,
-	  const MinMax *min_max)
-{
-  if (min_max == MinMax::max())
-    return fuzzyLess(delay1.mean(), delay2.mean());
-  else
-    return fuzzyGreater(delay1.mean(), delay2.mean());
-}
-
-Delay
-operator+(float delay1,
-	  const Delay &delay2)
-{
-  return Delay(delay1 + delay2.mean(),
-	       delay2.sigma2Early(),
-	       delay2.sigma2Late());
-}
-
 Delay
 operator/(float delay1,
 	  const Delay &delay2)
@@ -372,15 +171,6 @@ operator/(float delay1,
 	       delay2.sigma2Late());
 }
 
-Delay
-operator*(const Delay &delay1,
-	  float delay2)
-{
-  return Delay(delay1.mean() * delay2,
-	       delay1.sigma2Early() * delay2,
-	       delay1.sigma2Late() * delay2);
-}
-
 float
 delayRatio(const Delay &delay1,
 	   const Delay &delay2)
@@ -388,6 +178,36 @@ delayRatio(const Delay &delay1,
   return delay1.mean() / delay2.mean();
 }
 
+// The sigma on the side of min_max (late for max, early for min) is
+// combined. The other sigma is taken from the arrival with the worst
+// mean.
+Delay
+delayStatisticalMax(const Delay &delay1,
+		    const Delay &delay2,
+		    const MinMax *min_max)
+{
+  float mean, sigma2;
+  if (min_max == MinMax::max()) {
+    clarkMax(delay1.mean(), delay1.sigma2Late(),
+	     delay2.mean(), delay2.sigma2Late(),
+	     mean, sigma2);
+    float sigma2_early = (delay1.mean() >= delay2.mean())
+      ? delay1.sigma2Early()
+      : delay2.sigma2Early();
+    return Delay(mean, sigma2_early, sigma2);
+  }
+  else {
+    // min(x, y) = -max(-x, -y)
+    clarkMax(-delay1.mean(), delay1.sigma2Early(),
+	     -delay2.mean(), delay2.sigma2Early(),
+	     mean, sigma2);
+    float sigma2_late = (delay1.mean() <= delay2.mean())
+      ? delay1.sigma2Late()
+      : delay2.sigma2Late();
+    return Delay(-mean, sigma2, sigma2_late);
+  }
+}
+
 float
 delayAsFloat(const Delay &delay,
 	     const EarlyLate *early_late,
@@ -18,6 +18,7 @@
 #define STA_DELAY_NORMAL2_H
 
 #include "MinMax.hh"
+#include "Fuzzy.hh"
 
 namespace sta {
 
@@ -25,6 +26,8 @@ class Delay;
 class StaState;
 
 // Normal distribution with early(left)/late(right) std deviations.
+// Arithmetic and comparisons are inline because arrival search and
+// delay calculation apply them to every edge.
 class Delay
 {
 public:
@@ -66,6 +69,158 @@ private:
   float sigma2_[EarlyLate::index_count];
 };
 
+inline
+Delay::Delay() :
+  mean_(0.0),
+  sigma2_{0.0, 0.0}
+{
+}
+
+inline
+Delay::Delay(float mean) :
+  mean_(mean),
+  sigma2_{0.0, 0.0}
+{
+}
+
+inline
+Delay::Delay(float mean,
+	     float sigma2_early,
+	     float sigma2_late) :
+  mean_(mean),
+  sigma2_{sigma2_early, sigma2_late}
+{
+}
+
+inline float
+Delay::sigma2(const EarlyLate *early_late) const
+{
+  return sigma2_[early_late->index()];
+}
+
+inline float
+Delay::sigma2Early() const
+{
+  return sigma2_[early_index];
+}
+
+inline float
+Delay::sigma2Late() const
+{
+  return sigma2_[late_index];
+}
+
+inline void
+Delay::operator=(const Delay &delay)
+{
+  mean_ = delay.mean_;
+  sigma2_[early_index] = delay.sigma2_[early_index];
+  sigma2_[late_index] = delay.sigma2_[late_index];
+}
+
+inline void
+Delay::operator=(float delay)
+{
+  mean_ = delay;
+  sigma2_[early_index] = 0.0;
+  sigma2_[late_index] = 0.0;
+}
+
+inline void
+Delay::operator+=(const Delay &delay)
+{
+  mean_ += delay.mean_;
+  sigma2_[early_index] += delay.sigma2_[early_index];
+  sigma2_[late_index] += delay.sigma2_[late_index];
+}
+
+inline void
+Delay::operator+=(float delay)
+{
+  mean_ += delay;
+}
+
+inline Delay
+Delay::operator+(const Delay &delay) const
+{
+  return Delay(mean_ + delay.mean_,
+	       sigma2_[early_index] + delay.sigma2_[early_index],
+	       sigma2_[late_index] + delay.sigma2_[late_index]);
+}
+
+inline Delay
+Delay::operator+(float delay) const
+{
+  return Delay(mean_ + delay, sigma2_[early_index], sigma2_[late_index]);
+}
+
+// Variances add for a difference of independent delays.
+inline Delay
+Delay::operator-(const Delay &delay) const
+{
+  return Delay(mean_ - delay.mean_,
+	       sigma2_[early_index] + delay.sigma2_[early_index],
+	       sigma2_[late_index] + delay.sigma2_[late_index]);
+}
+
+inline Delay
+Delay::operator-(float delay) const
+{
+  return Delay(mean_ - delay, sigma2_[early_index], sigma2_[late_index]);
+}
+
+inline Delay
+Delay::operator-() const
+{
+  return Delay(-mean_, sigma2_[early_index], sigma2_[late_index]);
+}
+
+inline void
+Delay::operator-=(float delay)
+{
+  mean_ -= delay;
+}
+
+inline void
+Delay::operator-=(const Delay &delay)
+{
+  mean_ -= delay.mean_;
+  sigma2_[early_index] += delay.sigma2_[early_index];
+  sigma2_[late_index] += delay.sigma2_[late_index];
+}
+
+inline bool
+Delay::operator==(const Delay &delay) const
+{
+  return mean_ == delay.mean_
+    && sigma2_[early_index] == delay.sigma2_[early_index]
+    && sigma2_[late_index]  == delay.sigma2_[late_index];
+}
+
+inline bool
+Delay::operator>(const Delay &delay) const
+{
+  return mean_ > delay.mean_;
+}
+
+inline bool
+Delay::operator>=(const Delay &delay) const
+{
+  return mean_ >= delay.mean_;
+}
+
+inline bool
+Delay::operator<(const Delay &delay) const
+{
+  return mean_ < delay.mean_;
+}
+
+inline bool
+Delay::operator<=(const Delay &delay) const
+{
+  return mean_ <= delay.mean_;
+}
+
 const Delay delay_zero(0.0);
 
 void
@@ -89,14 +244,27 @@ delayAsFloat(const Delay &delay) { return delay.mean(); }
 // functions so they can be defined on floats, where there is no class
 // to define them.
 
-Delay operator+(float delay1,
-		const Delay &delay2);
+inline Delay
+operator+(float delay1,
+	  const Delay &delay2)
+{
+  return Delay(delay1 + delay2.mean(),
+	       delay2.sigma2Early(),
+	       delay2.sigma2Late());
+}
+
 // Used for parallel gate delay calc.
 Delay operator/(float delay1,
 		const Delay &delay2);
 // Used for parallel gate delay calc.
-Delay operator*(const Delay &delay1,
-		float delay2);
+inline Delay
+operator*(const Delay &delay1,
+	  float delay2)
+{
+  return Delay(delay1.mean() * delay2,
+	       delay1.sigma2Early() * delay2,
+	       delay1.sigma2Late() * delay2);
+}
 
 // mean late+/early- sigma
 float
@@ -131,34 +299,68 @@ fuzzyEqual(const Delay &delay1,
 bool
 fuzzyLess(const Delay &delay1,
 	  const Delay &delay2);
-bool
+inline bool
 fuzzyLess(const Delay &delay1,
 	  const Delay &delay2,
-	  const MinMax *min_max);
+	  const MinMax *min_max)
+{
+  if (min_max == MinMax::max())
+    return fuzzyLess(delay1.mean(), delay2.mean());
+  else
+    return fuzzyGreater(delay1.mean(), delay2.mean());
+}
+
 bool
 fuzzyLessEqual(const Delay &delay1,
 	       const Delay &delay2);
-bool
+inline bool
 fuzzyLessEqual(const Delay &delay1,
 	       const Delay &delay2,
-	       const MinMax *min_max);
+	       const MinMax *min_max)
+{
+  if (min_max == MinMax::max())
+    return fuzzyLessEqual(delay1.mean(), delay2.mean());
+  else
+    return fuzzyGreaterEqual(delay1.mean(), delay2.mean());
+}
+
 bool
 fuzzyGreater(const Delay &delay1,
 	     const Delay &delay2);
 bool
 fuzzyGreaterEqual(const Delay &delay1,
 		  const Delay &delay2);
-bool
+inline bool
 fuzzyGreaterEqual(const Delay &delay1,
 		  const Delay &delay2,
-		  const MinMax *min_max);
-bool
+		  const MinMax *min_max)
+{
+  if (min_max == MinMax::max())
+    return fuzzyGreaterEqual(delay1.mean(), delay2.mean());
+  else
+    return fuzzyLessEqual(delay1.mean(), delay2.mean());
+}
+
+inline bool
 fuzzyGreater(const Delay &delay1,
 	     const Delay &delay2,
-	     const MinMax *min_max);
+	     const MinMax *min_max)
+{
+  if (min_max == MinMax::max())
+    return fuzzyGreater(delay1.mean(), delay2.mean());
+  else
+    return fuzzyLess(delay1.mean(), delay2.mean());
+}
+
 float
 delayRatio(const Delay &delay1,
 	   const Delay &delay2);
+// Statistical max (min for MinMax::min()) of two independent
+// arrivals using Clark's approximation.
+Delay
+delayStatisticalMax(const Delay &delay1,
+		    const Delay &delay2,
+		    const MinMax *min_max);
 
 } // namespace
 #endif
@@ -14,9 +14,13 @@
 // You should have received a copy of the GNU General Public License
 // along with this program.  If not, see <https://www.gnu.org/licenses/>.
 
+#include <string.h>  // memcpy
+#include <algorithm>
 #include "Machine.hh"
 #include "DisallowCopyAssign.hh"
+#include "ThreadForEach.hh"
 #include "Stats.hh"
+#include "MemoryReport.hh"
 #include "Error.hh"
 #include "Debug.hh"
 #include "Pool.hh"
@@ -28,6 +32,8 @@
 #include "Liberty.hh"
 #include "Network.hh"
 #include "DcalcAnalysisPt.hh"
+#include "SearchClass.hh"
+#include "PathVertexRep.hh"
 #include "Graph.hh"
 
 namespace sta {
@@ -45,15 +51,23 @@ Graph::Graph(StaState *sta,
   StaState(sta),
   vertices_(nullptr),
   edges_(nullptr),
+  private_pin_vertex_indices_(false),
   vertex_count_(0),
   edge_count_(0),
   arc_count_(0),
   slew_tr_count_(slew_tr_count),
   have_arc_delays_(have_arc_delays),
   ap_count_(ap_count),
+  float_delays_(!pocv_enabled_ || sizeof(Delay) == sizeof(float)),
+  quantized_slews_(false),
+  slew_stride_(0),
   float_pool_(nullptr),
+  arrival_pool_(new ArrivalPool),
+  prev_path_pool_(new PrevPathPool),
   width_check_annotations_(nullptr),
-  period_check_annotations_(nullptr)
+  period_check_annotations_(nullptr),
+  csr_valid_(false),
+  delay_journal_active_(false)
 {
 }
 
@@ -61,22 +75,190 @@ Graph::~Graph()
 {
   delete vertices_;
   delete edges_;
-  deleteSlewPools();
+  deleteSlews();
   deleteArcDelayPools();
   delete width_check_annotations_;
   delete period_check_annotations_;
   delete float_pool_;
+  delete arrival_pool_;
+  delete prev_path_pool_;
 }
 
 void
 Graph::makeGraph()
 {
-  Stats stats(debug_);
-  makeVerticesAndEdges();
-  makeWireEdges();
+  Stats stats(debug_, phase_stats_);
+  if (thread_pool_ && thread_pool_->threadCount() > 1)
+    makeGraphParallel();
+  else {
+    makeVerticesAndEdges();
+    makeWireEdges();
+  }
+  makeCsr();
   stats.report("Make graph");
 }
 
+void
+Graph::ensureCsr()
+{
+  if (!csr_valid_)
+    makeCsr();
+}
+
+void
+Graph::csrInvalid()
+{
+  csr_valid_ = false;
+}
+
+void
+Graph::makeCsr()
+{
+  // Deleted vertices are not distinguishable in the pool, so use
+  // the vertex iterator to find live vertices.
+  std::vector<std::pair<VertexIndex, Vertex*>> vertices;
+  vertices.reserve(vertex_count_);
+  VertexIterator vertex_iter(this);
+  while (vertex_iter.hasNext()) {
+    Vertex *vertex = vertex_iter.next();
+    vertices.push_back(std::pair<VertexIndex, Vertex*>(index(vertex), vertex));
+  }
+  // Index 0 is reserved, so indices are [1, size].
+  size_t begin_size = vertices_->size() + 2;
+  csr_in_begin_.assign(begin_size, 0);
+  csr_out_begin_.assign(begin_size, 0);
+  for (auto &index_vertex : vertices) {
+    VertexIndex vertex_index = index_vertex.first;
+    Vertex *vertex = index_vertex.second;
+    for (EdgeIndex i = vertex->in_edges_; i; i = edge(i)->vertex_in_link_)
+      csr_in_begin_[vertex_index + 1]++;
+    for (EdgeIndex i = vertex->out_edges_; i; i = edge(i)->vertex_out_next_)
+      csr_out_begin_[vertex_index + 1]++;
+  }
+  for (size_t i = 1; i < begin_size; i++) {
+    csr_in_begin_[i] += csr_in_begin_[i - 1];
+    csr_out_begin_[i] += csr_out_begin_[i - 1];
+  }
+  csr_in_edges_.resize(csr_in_begin_[begin_size - 1]);
+  csr_in_edges_.shrink_to_fit();
+  csr_out_edges_.resize(csr_out_begin_[begin_size - 1]);
+  csr_out_edges_.shrink_to_fit();
+  // Keep the linked list order so results do not depend on the view.
+  for (auto &index_vertex : vertices) {
+    VertexIndex vertex_index = index_vertex.first;
+    Vertex *vertex = index_vertex.second;
+    EdgeIndex in_index = csr_in_begin_[vertex_index];
+    for (EdgeIndex i = vertex->in_edges_; i; i = edge(i)->vertex_in_link_)
+      csr_in_edges_[in_index++] = edge(i);
+    EdgeIndex out_index = csr_out_begin_[vertex_index];
+    for (EdgeIndex i = vertex->out_edges_; i; i = edge(i)->vertex_out_next_)
+      csr_out_edges_[out_index++] = edge(i);
+  }
+  csr_valid_ = true;
+}
+
+void
+Graph::reportMemory(MemoryReport &memory) const
+{
+  memory.reportUsage("Graph", "vertices", vertex_count_,
+		     vertices_->size() * sizeof(Vertex));
+  memory.reportUsage("Graph", "edges", edge_count_,
+		     edges_->size() * sizeof(Edge));
+  size_t delay_size = float_delays_ ? sizeof(float) : sizeof(Delay);
+  size_t slew_count = slews_.size() + float_slews_.size()
+    + quantized_slews16_.size();
+  size_t slew_size = !float_delays_
+    ? sizeof(Delay)
+    : (quantized_slews_ ? sizeof(uint16_t) : sizeof(float));
+  memory.reportUsage("Graph", "slews", slew_count,
+		     slew_count * slew_size);
+  size_t arc_delay_count = 0;
+  for (auto arc_delays : arc_delays_)
+    arc_delay_count += arc_delays->size();
+  for (auto arc_delays : float_arc_delays_)
+    arc_delay_count += arc_delays->size();
+  memory.reportUsage("Graph", "arc delays", arc_delay_count,
+		     arc_delay_count * delay_size
+		     + arc_delay_annotated_.size() / 8);
+  size_t csr_count = csr_in_begin_.size() + csr_out_begin_.size();
+  size_t csr_edge_count = csr_in_edges_.size() + csr_out_edges_.size();
+  memory.reportUsage("Graph", "csr edges", csr_edge_count,
+		     csr_count * sizeof(EdgeIndex)
+		     + csr_edge_count * sizeof(Edge*));
+  size_t annotation_count = reg_clk_vertices_.size()
+    + pin_bidirect_drvr_vertex_map_.size()
+    + pin_vertex_indices_.size();
+  if (width_check_annotations_)
+    annotation_count += width_check_annotations_->size();
+  if (period_check_annotations_)
+    annotation_count += period_check_annotations_->size();
+  size_t float_count = float_pool_ ? float_pool_->size() : 0;
+  memory.reportUsage("Graph", "maps", annotation_count,
+		     annotation_count * (MemoryReport::map_node_bytes
+					 + 2 * sizeof(void*))
+		     + float_count * sizeof(float));
+  // Arrays in use are reported by Search; report the slab overhead.
+  size_t arrival_used = arrival_pool_->usedBytes()
+    + prev_path_pool_->usedBytes();
+  size_t arrival_slots = arrival_pool_->slotBytes()
+    + prev_path_pool_->slotBytes();
+  size_t arrival_free = arrival_pool_->freeBytes()
+    + prev_path_pool_->freeBytes();
+  size_t arrival_reserved = arrival_pool_->reservedBytes()
+    + prev_path_pool_->reservedBytes();
+  size_t arrival_array_count = arrival_pool_->arrayCount()
+    + prev_path_pool_->arrayCount();
+  memory.reportUsage("Graph", "path slab rounding", arrival_array_count,
+		     arrival_slots - arrival_used);
+  memory.reportUsage("Graph", "path slab free", 0,
+		     arrival_reserved - arrival_slots);
+  debugPrint4(debug_, "memory", 1,
+	      "path slabs reserved %zu free %zu unused %zu reused %zu\n",
+	      arrival_reserved,
+	      arrival_free,
+	      arrival_reserved - arrival_slots - arrival_free,
+	      arrival_pool_->reuseCount() + prev_path_pool_->reuseCount());
+  memory.reportSubsystemTotal("Graph");
+}
+
+Arrival *
+Graph::makeArrivals(int count)
+{
+  return arrival_pool_->makeObjects(count);
+}
+
+Arrival *
+Graph::resizeArrivals(Arrival *arrivals,
+		      int count)
+{
+  return arrival_pool_->resizeObjects(arrivals, count);
+}
+
+void
+Graph::deleteArrivals(Arrival *arrivals)
+{
+  arrival_pool_->deleteObjects(arrivals);
+}
+
+PathVertexRep *
+Graph::makePrevPaths(int count)
+{
+  return prev_path_pool_->makeObjects(count);
+}
+
+PathVertexRep *
+Graph::resizePrevPaths(PathVertexRep *prev_paths,
+		       int count)
+{
+  return prev_path_pool_->resizeObjects(prev_paths, count);
+}
+
+void
+Graph::deletePrevPaths(PathVertexRep *prev_paths)
+{
+  prev_path_pool_->deleteObjects(prev_paths);
+}
+
 // Make vertices for each pin.
 // Iterate over instances and top level port pins rather than nets
 // because network may not connect floating pins to a net
@@ -90,7 +272,7 @@ Graph::makeVerticesAndEdges()
   vertexAndEdgeCounts(vertex_count, edge_count, arc_count);
   vertices_ = new VertexPool(vertex_count);
   edges_ = new EdgePool(edge_count);
-  makeSlewPools(vertex_count, ap_count_);
+  makeSlews(vertex_count, ap_count_);
   makeArcDelayPools(arc_count, ap_count_);
 
   LeafInstanceIterator *leaf_iter = network_->leafInstanceIterator();
@@ -292,38 +474,45 @@ Graph::makePortInstanceEdges(const Instance *inst,
 	&& filterEdge(arc_set)) {
       Pin *from_pin = network_->findPin(inst, from_port);
       Pin *to_pin = network_->findPin(inst, to_port);
-      if (from_pin && to_pin) {
-	Vertex *from_vertex, *from_bidirect_drvr_vertex;
-	Vertex *to_vertex, *to_bidirect_drvr_vertex;
-	pinVertices(from_pin, from_vertex, from_bidirect_drvr_vertex);
-	pinVertices(to_pin, to_vertex, to_bidirect_drvr_vertex);
-	// From pin and/or to pin can be bidirect.
-	//  For combinational arcs edge is to driver.
-	//  For timing checks edge is to load.
-	// Vertices can be missing from the graph if the pins
-	// are power or ground.
-	if (from_vertex) {
-  	  bool is_check = arc_set->role()->isTimingCheck();
-	  if (to_bidirect_drvr_vertex &&
-	      !is_check)
-	    makeEdge(from_vertex, to_bidirect_drvr_vertex, arc_set);
-	  else if (to_vertex) {
-	    makeEdge(from_vertex, to_vertex, arc_set);
-	    if (is_check) {
-	      to_vertex->setHasChecks(true);
-	      from_vertex->setIsCheckClk(true);
-	    }
-	  }
-	  if (from_bidirect_drvr_vertex && to_vertex) {
-	    // Internal path from bidirect output back into the
-	    // instance.
-	    Edge *edge = makeEdge(from_bidirect_drvr_vertex, to_vertex,
-				  arc_set);
-	    edge->setIsBidirectInstPath(true);
-	  }
-	}
+      if (from_pin && to_pin)
+	makeInstArcEdge(from_pin, to_pin, arc_set);
+    }
+  }
+}
+
+void
+Graph::makeInstArcEdge(Pin *from_pin,
+		       Pin *to_pin,
+		       TimingArcSet *arc_set)
+{
+  Vertex *from_vertex, *from_bidirect_drvr_vertex;
+  Vertex *to_vertex, *to_bidirect_drvr_vertex;
+  pinVertices(from_pin, from_vertex, from_bidirect_drvr_vertex);
+  pinVertices(to_pin, to_vertex, to_bidirect_drvr_vertex);
+  // From pin and/or to pin can be bidirect.
+  //  For combinational arcs edge is to driver.
+  //  For timing checks edge is to load.
+  // Vertices can be missing from the graph if the pins
+  // are power or ground.
+  if (from_vertex) {
+    bool is_check = arc_set->role()->isTimingCheck();
+    if (to_bidirect_drvr_vertex &&
+	!is_check)
+      makeEdge(from_vertex, to_bidirect_drvr_vertex, arc_set);
+    else if (to_vertex) {
+      makeEdge(from_vertex, to_vertex, arc_set);
+      if (is_check) {
+	to_vertex->setHasChecks(true);
+	from_vertex->setIsCheckClk(true);
       }
     }
+    if (from_bidirect_drvr_vertex && to_vertex) {
+      // Internal path from bidirect output back into the
+      // instance.
+      Edge *edge = makeEdge(from_bidirect_drvr_vertex, to_vertex,
+			    arc_set);
+      edge->setIsBidirectInstPath(true);
+    }
   }
 }
 
@@ -398,6 +587,196 @@ Graph::makeWireEdgesToPin(Pin *to_pin)
   }
 }
 
+////////////////////////////////////////////////////////////////
+
+// Leaf instances looked up by the thread pool at a time while
+// building the graph in parallel.
+static const size_t graph_batch_size = 16 * 1024;
+
+class GraphInstArc
+{
+public:
+  Pin *from_pin_;
+  Pin *to_pin_;
+  TimingArcSet *arc_set_;
+};
+
+class GraphDrvrLoads
+{
+public:
+  Pin *drvr_pin_;
+  PinSeq drvrs_;
+  PinSeq loads_;
+};
+
+// The network and liberty lookups that find the instance timing arc
+// pins and the wire loads of each driver are done by the thread pool.
+// The vertices and edges are made serially in the same order as
+// makeVerticesAndEdges/makeWireEdges so the vertex and edge indices
+// do not depend on the thread count.
+void
+Graph::makeGraphParallel()
+{
+  InstanceSeq insts;
+  LeafInstanceIterator *leaf_iter = network_->leafInstanceIterator();
+  while (leaf_iter->hasNext())
+    insts.push_back(leaf_iter->next());
+  delete leaf_iter;
+
+  VertexIndex vertex_count;
+  EdgeIndex edge_count;
+  ArcIndex arc_count;
+  vertexAndEdgeCountsParallel(insts, vertex_count, edge_count, arc_count);
+  vertices_ = new VertexPool(vertex_count);
+  edges_ = new EdgePool(edge_count);
+  makeSlews(vertex_count, ap_count_);
+  makeArcDelayPools(arc_count, ap_count_);
+
+  makeVerticesAndEdgesParallel(insts);
+  makeWireEdgesParallel(insts);
+}
+
+void
+Graph::vertexAndEdgeCountsParallel(const InstanceSeq &insts,
+				   // Return values.
+				   VertexIndex &vertex_count,
+				   EdgeIndex &edge_count,
+				   ArcIndex &arc_count)
+{
+  int thread_count = thread_pool_->threadCount();
+  std::vector<VertexIndex> vertex_counts(thread_count, 0);
+  std::vector<EdgeIndex> edge_counts(thread_count, 0);
+  std::vector<ArcIndex> arc_counts(thread_count, 0);
+  // Threads do not share visited drivers, so wire edges on nets with
+  // multiple drivers can be counted more than once.  The counts only
+  // size the pools.
+  std::vector<PinSet> visited_drvrs(thread_count);
+  forEachChunk(insts.size(), thread_pool_,
+	       [&] (size_t begin, size_t end, int thread_index) {
+		 for (size_t i = begin; i < end; i++)
+		   vertexAndEdgeCounts(insts[i], visited_drvrs[thread_index],
+				       vertex_counts[thread_index],
+				       edge_counts[thread_index],
+				       arc_counts[thread_index]);
+	       });
+  vertex_count = edge_count = arc_count = 0;
+  for (int i = 0; i < thread_count; i++) {
+    vertex_count += vertex_counts[i];
+    edge_count += edge_counts[i];
+    arc_count += arc_counts[i];
+  }
+  vertexAndEdgeCounts(network_->topInstance(), visited_drvrs[0],
+		      vertex_count, edge_count, arc_count);
+}
+
+void
+Graph::makeVerticesAndEdgesParallel(const InstanceSeq &insts)
+{
+  size_t inst_count = insts.size();
+  std::vector<GraphInstArcSeq> inst_arcs(std::min(inst_count,
+						  graph_batch_size));
+  for (size_t batch_begin = 0;
+       batch_begin < inst_count;
+       batch_begin += graph_batch_size) {
+    size_t batch_end = std::min(batch_begin + graph_batch_size, inst_count);
+    forEachChunk(batch_end - batch_begin, thread_pool_,
+		 [&] (size_t begin, size_t end, int) {
+		   for (size_t i = begin; i < end; i++)
+		     findInstArcs(insts[batch_begin + i], inst_arcs[i]);
+		 });
+    for (size_t i = batch_begin; i < batch_end; i++) {
+      makePinVertices(insts[i]);
+      for (GraphInstArc &arc : inst_arcs[i - batch_begin])
+	makeInstArcEdge(arc.from_pin_, arc.to_pin_, arc.arc_set_);
+    }
+  }
+  makePinVertices(network_->topInstance());
+}
+
+// Find the pins of the instance timing arcs made by makeInstanceEdges.
+void
+Graph::findInstArcs(const Instance *inst,
+		    // Return value.
+		    GraphInstArcSeq &arcs) const
+{
+  arcs.clear();
+  LibertyCell *cell = network_->libertyCell(inst);
+  if (cell) {
+    LibertyCellTimingArcSetIterator timing_iter(cell);
+    while (timing_iter.hasNext()) {
+      TimingArcSet *arc_set = timing_iter.next();
+      if (filterEdge(arc_set)) {
+	Pin *from_pin = network_->findPin(inst, arc_set->from());
+	Pin *to_pin = network_->findPin(inst, arc_set->to());
+	if (from_pin && to_pin)
+	  arcs.push_back({from_pin, to_pin, arc_set});
+      }
+    }
+  }
+}
+
+void
+Graph::makeWireEdgesParallel(const InstanceSeq &insts)
+{
+  PinSet visited_drvrs;
+  size_t inst_count = insts.size();
+  std::vector<GraphDrvrLoadsSeq> inst_drvr_loads(std::min(inst_count,
+							  graph_batch_size));
+  for (size_t batch_begin = 0;
+       batch_begin < inst_count;
+       batch_begin += graph_batch_size) {
+    size_t batch_end = std::min(batch_begin + graph_batch_size, inst_count);
+    forEachChunk(batch_end - batch_begin, thread_pool_,
+		 [&] (size_t begin, size_t end, int) {
+		   for (size_t i = begin; i < end; i++)
+		     findInstDrvrLoads(insts[batch_begin + i],
+				       inst_drvr_loads[i]);
+		 });
+    for (size_t i = batch_begin; i < batch_end; i++) {
+      for (GraphDrvrLoads &drvr_loads : inst_drvr_loads[i - batch_begin]) {
+	Pin *drvr_pin = drvr_loads.drvr_pin_;
+	// Same as makeWireEdgesFromPin with visited_drvrs.
+	if (!visited_drvrs.hasKey(drvr_pin)) {
+	  for (auto drvr : drvr_loads.drvrs_) {
+	    if (drvr != drvr_pin)
+	      visited_drvrs.insert(drvr);
+	  }
+	  for (auto drvr : drvr_loads.drvrs_) {
+	    for (auto load_pin : drvr_loads.loads_) {
+	      if (drvr != load_pin)
+		makeWireEdge(drvr, load_pin);
+	    }
+	  }
+	}
+      }
+    }
+  }
+  makeInstDrvrWireEdges(network_->topInstance(), visited_drvrs);
+}
+
+void
+Graph::findInstDrvrLoads(const Instance *inst,
+			 // Return value.
+			 GraphDrvrLoadsSeq &drvr_loads) const
+{
+  drvr_loads.clear();
+  InstancePinIterator *pin_iter = network_->pinIterator(inst);
+  while (pin_iter->hasNext()) {
+    Pin *pin = pin_iter->next();
+    if (network_->isDriver(pin)) {
+      drvr_loads.push_back(GraphDrvrLoads());
+      GraphDrvrLoads &loads = drvr_loads.back();
+      loads.drvr_pin_ = pin;
+      // The serial pass skips the other drivers on the net.
+      PinSet visited_drvrs;
+      FindNetDrvrLoads visitor(pin, visited_drvrs, loads.loads_,
+			       loads.drvrs_, network_);
+      network_->visitConnectedPins(pin, visitor);
+    }
+  }
+  delete pin_iter;
+}
+
 class MakeEdgesThruHierPin : public HierPinThruVisitor
 {
 public:
@@ -460,6 +839,40 @@ Graph::index(const Vertex *vertex) const
   return vertices_->index(vertex);
 }
 
+void
+Graph::setPrivatePinVertexIndices(bool private_indices)
+{
+  private_pin_vertex_indices_ = private_indices;
+}
+
+VertexIndex
+Graph::pinVertexIndex(const Pin *pin) const
+{
+  if (private_pin_vertex_indices_) {
+    auto index_iter = pin_vertex_indices_.find(pin);
+    if (index_iter == pin_vertex_indices_.end())
+      return 0;
+    else
+      return index_iter->second;
+  }
+  else
+    return network_->vertexIndex(pin);
+}
+
+void
+Graph::setPinVertexIndex(Pin *pin,
+			 VertexIndex vertex_index)
+{
+  if (private_pin_vertex_indices_) {
+    if (vertex_index == 0)
+      pin_vertex_indices_.erase(pin);
+    else
+      pin_vertex_indices_[pin] = vertex_index;
+  }
+  else
+    network_->setVertexIndex(pin, vertex_index);
+}
+
 void
 Graph::makePinVertices(Pin *pin)
 {
@@ -476,7 +889,7 @@ Graph::makePinVertices(Pin *pin,
   if (!dir->isPowerGround()) {
     bool is_reg_clk = network_->isRegClkPin(pin);
     vertex = makeVertex(pin, false, is_reg_clk);
-    network_->setVertexIndex(pin, index(vertex));
+    setPinVertexIndex(pin, index(vertex));
     if (dir->isBidirect()) {
       bidir_drvr_vertex = makeVertex(pin, true, is_reg_clk);
       pin_bidirect_drvr_vertex_map_[pin] = bidir_drvr_vertex;
@@ -493,8 +906,9 @@ Graph::makeVertex(Pin *pin,
 {
   Vertex *vertex = vertices_->makeObject();
   vertex->init(pin, is_bidirect_drvr, is_reg_clk);
+  csrInvalid();
   vertex_count_++;
-  makeVertexSlews();
+  makeVertexSlews(vertex);
   if (is_reg_clk)
     reg_clk_vertices_.insert(vertex);
   return vertex;
@@ -506,7 +920,7 @@ Graph::pinVertices(const Pin *pin,
 		   Vertex *&vertex,
 		   Vertex *&bidirect_drvr_vertex)  const
 {
-  vertex = Graph::vertex(network_->vertexIndex(pin));
+  vertex = Graph::vertex(pinVertexIndex(pin));
   if (network_->direction(pin)->isBidirect())
     bidirect_drvr_vertex = pin_bidirect_drvr_vertex_map_.findKey(pin);
   else
@@ -519,18 +933,19 @@ Graph::pinDrvrVertex(const Pin *pin) const
   if (network_->direction(pin)->isBidirect())
     return pin_bidirect_drvr_vertex_map_.findKey(pin);
   else
-    return Graph::vertex(network_->vertexIndex(pin));
+    return Graph::vertex(pinVertexIndex(pin));
 }
 
 Vertex *
 Graph::pinLoadVertex(const Pin *pin) const
 {
-  return vertex(network_->vertexIndex(pin));
+  return vertex(pinVertexIndex(pin));
 }
 
 void
 Graph::deleteVertex(Vertex *vertex)
 {
+  csrInvalid();
   if (vertex->isRegClk())
     reg_clk_vertices_.erase(vertex);
   Pin *pin = vertex->pin_;
@@ -538,7 +953,7 @@ Graph::deleteVertex(Vertex *vertex)
     pin_bidirect_drvr_vertex_map_.erase(pin_bidirect_drvr_vertex_map_
 					.find(pin));
   else
-    network_->setVertexIndex(pin, 0);
+    setPinVertexIndex(pin, 0);
   // Delete edges to vertex.
   EdgeIndex edge_index, next_index;
   for (edge_index = vertex->in_edges_; edge_index; edge_index = next_index) {
@@ -560,7 +975,6 @@ Graph::deleteVertex(Vertex *vertex)
     arc_count_ -= edge->timingArcSet()->arcCount();
     edges_->deleteObject(edge);
   }
-  deleteVertexSlews(vertex);
   vertices_->deleteObject(vertex);
   vertex_count_--;
 }
@@ -602,22 +1016,15 @@ Graph::deleteOutEdge(Vertex *vertex,
     Graph::edge(next)->vertex_out_prev_ = prev;
 }
 
-const Slew &
+Slew
 Graph::slew(const Vertex *vertex,
 	    const TransRiseFall *tr,
 	    DcalcAPIndex ap_index)
 {
-  if (slew_tr_count_) {
-    int pool_index =
-      (slew_tr_count_ == 1) ? ap_index : ap_index*slew_tr_count_+tr->index();
-    DelayPool *pool = slew_pools_[pool_index];
-    VertexIndex vertex_index = index(vertex);
-    return *pool->find(vertex_index);
-  }
-  else {
-    static Slew slew(0.0);
-    return slew;
-  }
+  if (slew_tr_count_)
+    return slewValue(slewIndex(vertex, tr, ap_index));
+  else
+    return delay_zero;
 }
 
 void
@@ -627,12 +1034,85 @@ Graph::setSlew(Vertex *vertex,
 	       const Slew &slew)
 {
   if (slew_tr_count_) {
-    int pool_index =
-      (slew_tr_count_ == 1) ? ap_index : ap_index*slew_tr_count_+tr->index();
-    DelayPool *pool = slew_pools_[pool_index];
-    VertexIndex vertex_index = index(vertex);
-    Slew &vertex_slew = *pool->find(vertex_index);
-    vertex_slew = slew;
+    size_t slew_index = slewIndex(vertex, tr, ap_index);
+    if (delay_journal_active_)
+      journalSlew(slew_index);
+    setSlewValue(slew_index, slew);
+  }
+}
+
+size_t
+Graph::slewIndex(const Vertex *vertex,
+		 const TransRiseFall *tr,
+		 DcalcAPIndex ap_index) const
+{
+  int ap_tr_index =
+    (slew_tr_count_ == 1) ? ap_index : ap_index*slew_tr_count_+tr->index();
+  return index(vertex) * slew_stride_ + ap_tr_index;
+}
+
+// Round to the nearest bfloat16.
+static uint16_t
+quantizeSlew(float slew)
+{
+  uint32_t bits;
+  memcpy(&bits, &slew, sizeof(bits));
+  bits += 0x7fff + ((bits >> 16) & 1);
+  return static_cast<uint16_t>(bits >> 16);
+}
+
+static float
+unquantizeSlew(uint16_t slew16)
+{
+  uint32_t bits = static_cast<uint32_t>(slew16) << 16;
+  float slew;
+  memcpy(&slew, &bits, sizeof(slew));
+  return slew;
+}
+
+Slew
+Graph::slewValue(size_t slew_index) const
+{
+  if (!float_delays_)
+    return slews_[slew_index];
+  else if (quantized_slews_)
+    return Slew(unquantizeSlew(quantized_slews16_[slew_index]));
+  else
+    return Slew(float_slews_[slew_index]);
+}
+
+void
+Graph::setSlewValue(size_t slew_index,
+		    const Slew &slew)
+{
+  if (!float_delays_)
+    slews_[slew_index] = slew;
+  else if (quantized_slews_)
+    quantized_slews16_[slew_index] = quantizeSlew(delayAsFloat(slew));
+  else
+    float_slews_[slew_index] = delayAsFloat(slew);
+}
+
+void
+Graph::setQuantizedSlews(bool quantized)
+{
+  if (quantized != quantized_slews_) {
+    if (float_delays_) {
+      // Convert the existing slews.
+      if (quantized) {
+	quantized_slews16_.resize(float_slews_.size());
+	for (size_t i = 0; i < float_slews_.size(); i++)
+	  quantized_slews16_[i] = quantizeSlew(float_slews_[i]);
+	std::vector<float>().swap(float_slews_);
+      }
+      else {
+	float_slews_.resize(quantized_slews16_.size());
+	for (size_t i = 0; i < quantized_slews16_.size(); i++)
+	  float_slews_[i] = unquantizeSlew(quantized_slews16_[i]);
+	std::vector<uint16_t>().swap(quantized_slews16_);
+      }
+    }
+    quantized_slews_ = quantized;
   }
 }
 
@@ -657,6 +1137,7 @@ Graph::makeEdge(Vertex *from,
 {
   Edge *edge = edges_->makeObject();
   EdgeIndex edge_index = edges_->index(edge);
+  csrInvalid();
   edge->init(vertices_->index(from), vertices_->index(to), arc_set);
   makeEdgeArcDelays(edge);
   edge_count_++;
@@ -679,6 +1160,7 @@ Graph::makeEdge(Vertex *from,
 void
 Graph::deleteEdge(Edge *edge)
 {
+  csrInvalid();
   Vertex *from = edge->from(this);
   Vertex *to = edge->to(this);
   deleteOutEdge(from, edge);
@@ -689,16 +1171,76 @@ Graph::deleteEdge(Edge *edge)
   edges_->deleteObject(edge);
 }
 
+// Slew and arc delay pools for one delay storage type.
+template <class DELAY>
+static void
+makeDelayPools(Vector<Pool<DELAY>*> &pools,
+	       size_t pool_count,
+	       ObjectIndex size)
+{
+  pools.resize(pool_count);
+  for (size_t i = 0; i < pool_count; i++)
+    pools[i] = new Pool<DELAY>(size);
+}
+
+template <class DELAY>
+static void
+deleteDelayPools(Vector<Pool<DELAY>*> &pools)
+{
+  pools.deleteContentsClear();
+}
+
+// Make count zero delays in each pool and return their index.
+template <class DELAY>
+static ObjectIndex
+makePoolDelays(Vector<Pool<DELAY>*> &pools,
+	       ObjectIndex count)
+{
+  ObjectIndex index = 0;
+  for (auto pool : pools) {
+    DELAY *delays = pool->makeObjects(count);
+    index = pool->index(delays);
+    for (ObjectIndex i = 0; i < count; i++)
+      delays[i] = 0.0;
+  }
+  return index;
+}
+
+template <class DELAY>
+static void
+deletePoolDelays(Vector<Pool<DELAY>*> &pools,
+		 ObjectIndex index,
+		 ObjectIndex count)
+{
+  for (auto pool : pools)
+    pool->deleteObjects(index, count);
+}
+
+void
+Graph::updateDelayStorage()
+{
+  bool float_delays = !pocv_enabled_ || sizeof(Delay) == sizeof(float);
+  if (float_delays != float_delays_) {
+    deleteSlews();
+    deleteArcDelayPools();
+    float_delays_ = float_delays;
+    if (vertices_) {
+      makeSlews(vertex_count_, ap_count_);
+      makeArcDelayPools(arc_count_, ap_count_);
+      removeDelays();
+    }
+  }
+}
+
 void
 Graph::makeArcDelayPools(ArcIndex arc_count,
 			 DcalcAPIndex ap_count)
 {
   if (have_arc_delays_) {
-    arc_delays_.resize(ap_count);
-    for (DcalcAPIndex i = 0; i < ap_count; i++) {
-      DelayPool *pool = new DelayPool(arc_count);
-      arc_delays_[i] = pool;
-    }
+    if (float_delays_)
+      makeDelayPools(float_arc_delays_, ap_count, arc_count);
+    else
+      makeDelayPools(arc_delays_, ap_count, arc_count);
 
     // Leave some room for edits.
     unsigned annot_size = arc_count * 1.2;
@@ -710,11 +1252,8 @@ void
 Graph::deleteArcDelayPools()
 {
   if (have_arc_delays_) {
-    for (DcalcAPIndex i = 0; i < ap_count_; i++) {
-      DelayPool *pool = arc_delays_[i];
-      delete pool;
-    }
-    arc_delays_.clear();
+    deleteDelayPools(arc_delays_);
+    deleteDelayPools(float_arc_delays_);
   }
 }
 
@@ -723,14 +1262,9 @@ Graph::makeEdgeArcDelays(Edge *edge)
 {
   if (have_arc_delays_) {
     int arc_count = edge->timingArcSet()->arcCount();
-    ArcIndex arc_index = 0;
-    for (DcalcAPIndex i = 0; i < ap_count_; i++) {
-      DelayPool *pool = arc_delays_[i];
-      ArcDelay *arc_delays = pool->makeObjects(arc_count);
-      arc_index = pool->index(arc_delays);
-      for (int j = 0; j < arc_count; j++)
-	*arc_delays++ = 0.0;
-    }
+    ArcIndex arc_index = float_delays_
+      ? makePoolDelays(float_arc_delays_, arc_count)
+      : makePoolDelays(arc_delays_, arc_count);
     edge->setArcDelays(arc_index);
     // Make sure there is room for delay_annotated flags.
     unsigned max_annot_index = (arc_index + arc_count) * ap_count_;
@@ -748,10 +1282,10 @@ Graph::deleteEdgeArcDelays(Edge *edge)
   if (have_arc_delays_) {
     ArcIndex arc_count = edge->timingArcSet()->arcCount();
     ArcIndex arc_index = edge->arcDelays();
-    for (DcalcAPIndex i = 0; i < ap_count_; i++) {
-      DelayPool *pool = arc_delays_[i];
-      pool->deleteObjects(arc_index, arc_count);
-    }
+    if (float_delays_)
+      deletePoolDelays(float_arc_delays_, arc_index, arc_count);
+    else
+      deletePoolDelays(arc_delays_, arc_index, arc_count);
   }
 }
 
@@ -761,10 +1295,11 @@ Graph::arcDelay(const Edge *edge,
 		DcalcAPIndex ap_index) const
 {
   if (have_arc_delays_) {
-    DelayPool *pool = arc_delays_[ap_index];
     ArcIndex arc_index = edge->arcDelays() + arc->index();
-    ArcDelay &arc_delay = *pool->find(arc_index);
-    return arc_delay;
+    if (float_delays_)
+      return ArcDelay(*float_arc_delays_[ap_index]->find(arc_index));
+    else
+      return *arc_delays_[ap_index]->find(arc_index);
   }
   else
     return delay_zero;
@@ -777,23 +1312,27 @@ Graph::setArcDelay(Edge *edge,
 		   ArcDelay delay)
 {
   if (have_arc_delays_) {
-    DelayPool *pool = arc_delays_[ap_index];
     ArcIndex arc_index = edge->arcDelays() + arc->index();
-    ArcDelay &arc_delay = *pool->find(arc_index);
-    arc_delay = delay;
+    if (delay_journal_active_)
+      journalArcDelay(ap_index, arc_index);
+    if (float_delays_)
+      *float_arc_delays_[ap_index]->find(arc_index) = delayAsFloat(delay);
+    else
+      *arc_delays_[ap_index]->find(arc_index) = delay;
   }
 }
 
-const ArcDelay &
+ArcDelay
 Graph::wireArcDelay(const Edge *edge,
 		    const TransRiseFall *tr,
 		    DcalcAPIndex ap_index)
 {
   if (have_arc_delays_) {
-    DelayPool *pool = arc_delays_[ap_index];
     ArcIndex arc_index = edge->arcDelays() + tr->index();
-    const ArcDelay &arc_delay = *pool->find(arc_index);
-    return arc_delay;
+    if (float_delays_)
+      return ArcDelay(*float_arc_delays_[ap_index]->find(arc_index));
+    else
+      return *arc_delays_[ap_index]->find(arc_index);
   }
   else
     return delay_zero;
@@ -806,13 +1345,78 @@ Graph::setWireArcDelay(Edge *edge,
 		       const ArcDelay &delay)
 {
   if (have_arc_delays_) {
-    DelayPool *pool = arc_delays_[ap_index];
     ArcIndex arc_index = edge->arcDelays() + tr->index();
-    ArcDelay &arc_delay = *pool->find(arc_index);
-    arc_delay = delay;
+    if (delay_journal_active_)
+      journalArcDelay(ap_index, arc_index);
+    if (float_delays_)
+      *float_arc_delays_[ap_index]->find(arc_index) = delayAsFloat(delay);
+    else
+      *arc_delays_[ap_index]->find(arc_index) = delay;
   }
 }
 
+void
+Graph::beginDelayJournal()
+{
+  slew_journal_.clear();
+  arc_delay_journal_.clear();
+  delay_journal_active_ = true;
+}
+
+// Called by the delay calculation threads.
+void
+Graph::journalSlew(size_t slew_index)
+{
+  std::lock_guard<std::mutex> lock(delay_journal_lock_);
+  if (slew_journal_.find(slew_index) == slew_journal_.end())
+    slew_journal_[slew_index] = slewValue(slew_index);
+}
+
+// Called by the delay calculation threads.
+void
+Graph::journalArcDelay(DcalcAPIndex ap_index,
+		       ArcIndex arc_index)
+{
+  uint64_t key = (static_cast<uint64_t>(ap_index) << 32) | arc_index;
+  std::lock_guard<std::mutex> lock(delay_journal_lock_);
+  if (arc_delay_journal_.find(key) == arc_delay_journal_.end()) {
+    Delay delay = float_delays_
+      ? Delay(*float_arc_delays_[ap_index]->find(arc_index))
+      : *arc_delays_[ap_index]->find(arc_index);
+    arc_delay_journal_[key] = delay;
+  }
+}
+
+void
+Graph::restoreDelayJournal()
+{
+  delay_journal_active_ = false;
+  debugPrint2(debug_, "delay_journal", 1, "restore %zu slews %zu arc delays\n",
+	      slew_journal_.size(),
+	      arc_delay_journal_.size());
+  for (auto &key_slew : slew_journal_)
+    setSlewValue(key_slew.first, key_slew.second);
+  for (auto &key_delay : arc_delay_journal_) {
+    DcalcAPIndex ap_index = key_delay.first >> 32;
+    ArcIndex arc_index = key_delay.first & 0xffffffff;
+    if (float_delays_)
+      *float_arc_delays_[ap_index]->find(arc_index) =
+	delayAsFloat(key_delay.second);
+    else
+      *arc_delays_[ap_index]->find(arc_index) = key_delay.second;
+  }
+  slew_journal_.clear();
+  arc_delay_journal_.clear();
+}
+
+void
+Graph::endDelayJournal()
+{
+  delay_journal_active_ = false;
+  slew_journal_.clear();
+  arc_delay_journal_.clear();
+}
+
 bool
 Graph::arcDelayAnnotated(Edge *edge,
 			 TimingArc *arc,
@@ -872,11 +1476,11 @@ Graph::setDelayCount(DcalcAPIndex ap_count)
 {
   if (ap_count != ap_count_) {
     // Discard any existing delays.
-    deleteSlewPools();
+    deleteSlews();
     deleteArcDelayPools();
     removeWidthCheckAnnotations();
     removePeriodCheckAnnotations();
-    makeSlewPools(vertex_count_, ap_count);
+    makeSlews(vertex_count_, ap_count);
     makeArcDelayPools(arc_count_, ap_count);
     ap_count_ = ap_count;
     removeDelays();
@@ -889,7 +1493,7 @@ Graph::removeDelays()
   VertexIterator vertex_iter(this);
   while (vertex_iter.hasNext()) {
     Vertex *vertex = vertex_iter.next();
-    makeVertexSlews();
+    makeVertexSlews(vertex);
     VertexOutEdgeIterator edge_iter(vertex, this);
     while (edge_iter.hasNext()) {
       Edge *edge = edge_iter.next();
@@ -899,81 +1503,98 @@ Graph::removeDelays()
   }
 }
 
+void
+Graph::delayAnnotatedRange(Edge *edge,
+			   // Return values.
+			   Vector<bool>::iterator &begin,
+			   Vector<bool>::iterator &end)
+{
+  size_t begin_index = edge->arcDelays() * ap_count_;
+  size_t end_index = begin_index + edge->timingArcSet()->arcCount() * ap_count_;
+  if (end_index > arc_delay_annotated_.size())
+    internalError("arc_delay_annotated array bounds exceeded");
+  begin = arc_delay_annotated_.begin() + begin_index;
+  end = arc_delay_annotated_.begin() + end_index;
+}
+
+// std::fill and std::find on bit ranges work a word at a time.
 void
 Graph::removeDelayAnnotated(Edge *edge)
 {
   edge->setDelayAnnotationIsIncremental(false);
-  TimingArcSet *arc_set = edge->timingArcSet();
-  TimingArcSetArcIterator arc_iter(arc_set);
-  while (arc_iter.hasNext()) {
-    TimingArc *arc = arc_iter.next();
-    for (DcalcAPIndex ap_index = 0; ap_index < ap_count_; ap_index++) {
-      setArcDelayAnnotated(edge, arc, ap_index, false);
-    }
-  }
+  Vector<bool>::iterator begin, end;
+  delayAnnotatedRange(edge, begin, end);
+  std::fill(begin, end, false);
 }
 
 bool
 Graph::delayAnnotated(Edge *edge)
 {
-  TimingArcSet *arc_set = edge->timingArcSet();
-  TimingArcSetArcIterator arc_iter(arc_set);
-  while (arc_iter.hasNext()) {
-    TimingArc *arc = arc_iter.next();
-    for (DcalcAPIndex ap_index = 0; ap_index < ap_count_; ap_index++) {
-      if (arcDelayAnnotated(edge, arc, ap_index))
-	return true;
-    }
-  }
-  return false;
+  if (arc_delay_annotated_.empty())
+    return false;
+  Vector<bool>::iterator begin, end;
+  delayAnnotatedRange(edge, begin, end);
+  return std::find(begin, end, true) != end;
 }
 
-void
-Graph::makeSlewPools(VertexIndex vertex_count,
-		     DcalcAPIndex ap_count)
+bool
+Graph::allDelaysAnnotated(Edge *edge)
 {
-  DcalcAPIndex tr_ap_count = slew_tr_count_ * ap_count;
-  slew_pools_.resize(tr_ap_count);
-  for (DcalcAPIndex i = 0; i < tr_ap_count; i++) {
-    DelayPool *pool = new DelayPool(vertex_count);
-    slew_pools_[i] = pool;
-  }
+  if (arc_delay_annotated_.empty())
+    return false;
+  Vector<bool>::iterator begin, end;
+  delayAnnotatedRange(edge, begin, end);
+  return begin != end
+    && std::find(begin, end, false) == end;
 }
 
 void
-Graph::deleteSlewPools()
+Graph::makeSlews(VertexIndex vertex_count,
+		 DcalcAPIndex ap_count)
 {
-  if (slew_tr_count_) {
-    DcalcAPIndex tr_ap_count = slew_tr_count_ * ap_count_;
-    for (DcalcAPIndex i = 0; i < tr_ap_count; i++) {
-      DelayPool *pool = slew_pools_[i];
-      delete pool;
-    }
-    slew_pools_.clear();
-  }
+  slew_stride_ = slew_tr_count_ * ap_count;
+  // Vertex indices start at 1.
+  size_t slew_count = (vertex_count + 1) * slew_stride_;
+  if (!float_delays_)
+    slews_.reserve(slew_count);
+  else if (quantized_slews_)
+    quantized_slews16_.reserve(slew_count);
+  else
+    float_slews_.reserve(slew_count);
 }
 
 void
-Graph::makeVertexSlews()
+Graph::deleteSlews()
 {
-  DcalcAPIndex tr_ap_count = slew_tr_count_ * ap_count_;
-  slew_pools_.resize(tr_ap_count);
-  for (DcalcAPIndex i = 0; i < tr_ap_count; i++) {
-    DelayPool *pool = slew_pools_[i];
-    Slew *slew = pool->makeObject();
-    *slew = 0.0;
-  }
+  std::vector<Delay>().swap(slews_);
+  std::vector<float>().swap(float_slews_);
+  std::vector<uint16_t>().swap(quantized_slews16_);
 }
 
+// Vertex indices of deleted vertices are reused, so the slews of a
+// new vertex are zeroed.
 void
-Graph::deleteVertexSlews(Vertex *vertex)
+Graph::makeVertexSlews(Vertex *vertex)
 {
-  VertexIndex vertex_index = index(vertex);
-  DcalcAPIndex tr_ap_count = slew_tr_count_ * ap_count_;
-  slew_pools_.resize(tr_ap_count);
-  for (DcalcAPIndex i = 0; i < tr_ap_count; i++) {
-    DelayPool *pool = slew_pools_[i];
-    pool->deleteObject(vertex_index);
+  size_t slew_begin = index(vertex) * slew_stride_;
+  size_t slew_end = slew_begin + slew_stride_;
+  if (!float_delays_) {
+    if (slews_.size() < slew_end)
+      slews_.resize(slew_end);
+    std::fill(slews_.begin() + slew_begin, slews_.begin() + slew_end,
+	      delay_zero);
+  }
+  else if (quantized_slews_) {
+    if (quantized_slews16_.size() < slew_end)
+      quantized_slews16_.resize(slew_end);
+    std::fill(quantized_slews16_.begin() + slew_begin,
+	      quantized_slews16_.begin() + slew_end, 0);
+  }
+  else {
+    if (float_slews_.size() < slew_end)
+      float_slews_.resize(slew_end);
+    std::fill(float_slews_.begin() + slew_begin,
+	      float_slews_.begin() + slew_end, 0.0F);
   }
 }
 
@@ -1504,7 +2125,7 @@ VertexIterator::findNextPin()
 {
   while (pin_iter_->hasNext()) {
     Pin *pin = pin_iter_->next();
-    vertex_ = graph_->vertex(network_->vertexIndex(pin));
+    vertex_ = graph_->vertex(graph_->pinVertexIndex(pin));
     bidir_vertex_ = network_->direction(pin)->isBidirect() 
       ? graph_->pin_bidirect_drvr_vertex_map_.findKey(pin)
       : nullptr;
@@ -1542,39 +2163,74 @@ VertexIterator::findNext()
 
 VertexInEdgeIterator::VertexInEdgeIterator(Vertex *vertex,
 					   const Graph *graph) :
-  next_(graph->edge(vertex->in_edges_)),
   graph_(graph)
 {
+  if (graph->csr_valid_)
+    init(graph->index(vertex), vertex);
+  else
+    init(0, vertex);
 }
 
 VertexInEdgeIterator::VertexInEdgeIterator(VertexIndex vertex_index,
 					   const Graph *graph) :
-  next_(graph->edge(graph->vertex(vertex_index)->in_edges_)),
   graph_(graph)
 {
+  init(vertex_index, graph->vertex(vertex_index));
+}
+
+void
+VertexInEdgeIterator::init(VertexIndex vertex_index,
+			   const Vertex *vertex)
+{
+  csr_ = graph_->csr_valid_;
+  if (csr_) {
+    Edge *const *edges = graph_->csr_in_edges_.data();
+    csr_next_ = edges + graph_->csr_in_begin_[vertex_index];
+    csr_end_ = edges + graph_->csr_in_begin_[vertex_index + 1];
+    next_ = (csr_next_ < csr_end_) ? *csr_next_++ : nullptr;
+  }
+  else {
+    csr_next_ = csr_end_ = nullptr;
+    next_ = graph_->edge(vertex->in_edges_);
+  }
 }
 
 Edge *
 VertexInEdgeIterator::next()
 {
   Edge *next = next_;
-  if (next_)
+  if (csr_)
+    next_ = (csr_next_ < csr_end_) ? *csr_next_++ : nullptr;
+  else if (next_)
     next_ = graph_->edge(next_->vertex_in_link_);
   return next;
 }
 
 VertexOutEdgeIterator::VertexOutEdgeIterator(Vertex *vertex,
 					     const Graph *graph) :
-  next_(graph->edge(vertex->out_edges_)),
+  csr_(graph->csr_valid_),
   graph_(graph)
 {
+  if (csr_) {
+    VertexIndex vertex_index = graph->index(vertex);
+    Edge *const *edges = graph->csr_out_edges_.data();
+    csr_next_ = edges + graph->csr_out_begin_[vertex_index];
+    csr_end_ = edges + graph->csr_out_begin_[vertex_index + 1];
+    next_ = (csr_next_ < csr_end_) ? *csr_next_++ : nullptr;
+  }
+  else {
+    csr_next_ = csr_end_ = nullptr;
+    next_ = graph->edge(vertex->out_edges_);
+  }
 }
 
 Edge *
 VertexOutEdgeIterator::next()
 {
   Edge *next = next_;
-  if (next_)
+  if (csr_)
+    next_ = (csr_next_ < csr_end_) ? *csr_next_++ : nullptr;
+  else if (next_)
     next_ = graph_->edge(next_->vertex_out_next_);
   return next;
 }
@@ -17,11 +17,16 @@
 #ifndef STA_GRAPH_H
 #define STA_GRAPH_H
 
+#include <stdint.h>
+#include <vector>
+#include <mutex>
+#include <unordered_map>
 #include "DisallowCopyAssign.hh"
 #include "Iterator.hh"
 #include "Map.hh"
 #include "Vector.hh"
 #include "Pool.hh"
+#include "ConcurrentArrayPool.hh"
 #include "StaState.hh"
 #include "LibertyClass.hh"
 #include "NetworkClass.hh"
@@ -33,6 +38,9 @@ namespace sta {
 class MinMax;
 class Sdc;
 class PathVertexRep;
+class MemoryReport;
+class GraphInstArc;
+class GraphDrvrLoads;
 
 enum class LevelColor { white, gray, black };
 
@@ -40,10 +48,17 @@ typedef Pool<Delay> DelayPool;
 typedef Pool<Vertex> VertexPool;
 typedef Pool<Edge> EdgePool;
 typedef Map<const Pin*, Vertex*> PinVertexMap;
+typedef std::unordered_map<const Pin*, VertexIndex> PinVertexIndexMap;
 typedef Iterator<Edge*> VertexEdgeIterator;
 typedef Map<const Pin*, float*> WidthCheckAnnotations;
 typedef Map<const Pin*, float*> PeriodCheckAnnotations;
 typedef Vector<DelayPool*> DelayPoolSeq;
+typedef Pool<float> FloatPool;
+typedef Vector<FloatPool*> FloatPoolSeq;
+typedef ConcurrentArrayPool<Arrival> ArrivalPool;
+typedef ConcurrentArrayPool<PathVertexRep> PrevPathPool;
+typedef std::vector<GraphInstArc> GraphInstArcSeq;
+typedef std::vector<GraphDrvrLoads> GraphDrvrLoadsSeq;
 
 // The graph acts as a BUILDER for the graph vertices and edges.
 class Graph : public StaState
@@ -63,11 +78,28 @@ public:
 
   // Number of arc delays and slews from sdf or delay calculation.
   virtual void setDelayCount(DcalcAPIndex ap_count);
+  // Slews and arc delays are stored as floats unless the delays are
+  // distributions (SSTA builds) and pocv is enabled.
+  // Call after pocv_enabled_ changes; existing delays are discarded
+  // if the storage changes.
+  void updateDelayStorage();
+  bool floatDelays() const { return float_delays_; }
+  // Store float slews in 16 bits (bfloat16, the upper half of the
+  // float) to save memory. Slews keep 3 significant digits.
+  bool quantizedSlews() const { return quantized_slews_; }
+  void setQuantizedSlews(bool quantized);
+
+  // Graphs that share the network with another graph (StaMode) keep
+  // the pin vertex indices in the graph instead of the network pins.
+  // Call before makeGraph.
+  void setPrivatePinVertexIndices(bool private_indices);
 
   // Vertex functions.
   // Bidirect pins have two vertices.
   virtual Vertex *vertex(VertexIndex vertex_index) const;
   VertexIndex index(const Vertex *vertex) const;
+  // Index of the pin (load) vertex, 0 if the pin has no vertex.
+  VertexIndex pinVertexIndex(const Pin *pin) const;
   void makePinVertices(Pin *pin);
   void makePinVertices(Pin *pin,
 		       Vertex *&vertex,
@@ -84,13 +116,16 @@ public:
   virtual void deleteVertex(Vertex *vertex);
   bool hasFaninOne(Vertex *vertex) const;
   VertexIndex vertexCount() { return vertex_count_; }
+  // One more than the largest vertex index, for tables indexed by
+  // VertexIndex.
+  VertexIndex vertexIndexBound() const { return vertices_->size() + 1; }
   // Slews are reported slews in seconds.
   // Reported slew are the same as those in the liberty tables.
   //  reported_slews = measured_slews / slew_derate_from_library
   // Measured slews are between slew_lower_threshold and slew_upper_threshold.
-  virtual const Slew &slew(const Vertex *vertex,
-			   const TransRiseFall *tr,
-			   DcalcAPIndex ap_index);
+  virtual Slew slew(const Vertex *vertex,
+		    const TransRiseFall *tr,
+		    DcalcAPIndex ap_index);
   virtual void setSlew(Vertex *vertex,
 		       const TransRiseFall *tr,
 		       DcalcAPIndex ap_index,
@@ -118,9 +153,9 @@ public:
 			   DcalcAPIndex ap_index,
 			   ArcDelay delay);
   // Alias for arcDelays using library wire arcs.
-  virtual const ArcDelay &wireArcDelay(const Edge *edge,
-				       const TransRiseFall *tr,
-				       DcalcAPIndex ap_index);
+  virtual ArcDelay wireArcDelay(const Edge *edge,
+				const TransRiseFall *tr,
+				DcalcAPIndex ap_index);
   virtual void setWireArcDelay(Edge *edge,
 			       const TransRiseFall *tr,
 			       DcalcAPIndex ap_index,
@@ -142,6 +177,8 @@ public:
 			     bool annotated);
   // True if any edge arc is annotated.
   bool delayAnnotated(Edge *edge);
+  // True if every edge arc is annotated for every analysis point.
+  bool allDelaysAnnotated(Edge *edge);
   EdgeIndex edgeCount() { return edge_count_; }
   virtual ArcIndex arcCount() { return arc_count_; }
 
@@ -169,9 +206,54 @@ public:
   // Remove all delay and slew annotations.
   void removeDelaySlewAnnotations();
   VertexSet *regClkVertices() { return &reg_clk_vertices_; }
+  // The vertex in/out edge iterators use contiguous (compressed sparse
+  // row) copies of the vertex edge lists when they are valid.
+  // Graph edits invalidate the copies; ensureCsr rebuilds them.
+  // ensureCsr is not thread safe.
+  void ensureCsr();
+  bool csrValid() const { return csr_valid_; }
+  void reportMemory(MemoryReport &memory) const;
+  // Vertex arrival/required and prev path arrays come from size
+  // class slabs. The resize functions reuse the array in place when
+  // the new count is in the same size class.
+  // Safe to call from the search threads.
+  Arrival *makeArrivals(int count);
+  Arrival *resizeArrivals(Arrival *arrivals,
+			  int count);
+  void deleteArrivals(Arrival *arrivals);
+  PathVertexRep *makePrevPaths(int count);
+  PathVertexRep *resizePrevPaths(PathVertexRep *prev_paths,
+				 int count);
+  void deletePrevPaths(PathVertexRep *prev_paths);
+  // The delay journal saves each slew and arc delay before it is
+  // first changed so restoreDelayJournal can put back the delay
+  // calculation results from before the journal began.
+  // Graph edits are not journaled.
+  void beginDelayJournal();
+  // Restore the saved slews and arc delays and end the journal.
+  void restoreDelayJournal();
+  // Keep the current slews and arc delays and end the journal.
+  void endDelayJournal();
 
 protected:
   void makeVerticesAndEdges();
+  void makeGraphParallel();
+  void vertexAndEdgeCountsParallel(const InstanceSeq &insts,
+				   // Return values.
+				   VertexIndex &vertex_count,
+				   EdgeIndex &edge_count,
+				   ArcIndex &arc_count);
+  void makeVerticesAndEdgesParallel(const InstanceSeq &insts);
+  void findInstArcs(const Instance *inst,
+		    // Return value.
+		    GraphInstArcSeq &arcs) const;
+  void makeWireEdgesParallel(const InstanceSeq &insts);
+  void findInstDrvrLoads(const Instance *inst,
+			 // Return value.
+			 GraphDrvrLoadsSeq &drvr_loads) const;
+  void makeInstArcEdge(Pin *from_pin,
+		       Pin *to_pin,
+		       TimingArcSet *arc_set);
   void vertexAndEdgeCounts(// Return values.
 			   VertexIndex &vertex_count,
 			   EdgeIndex &edge_count,
@@ -202,11 +284,16 @@ protected:
                                      LibertyPort *from_to_port);
   void removeWidthCheckAnnotations();
   void removePeriodCheckAnnotations();
-  void makeSlewPools(VertexIndex vertex_count,
-		     DcalcAPIndex count);
-  void deleteSlewPools();
-  void makeVertexSlews();
-  void deleteVertexSlews(Vertex *vertex);
+  void makeSlews(VertexIndex vertex_count,
+		 DcalcAPIndex ap_count);
+  void deleteSlews();
+  void makeVertexSlews(Vertex *vertex);
+  size_t slewIndex(const Vertex *vertex,
+		   const TransRiseFall *tr,
+		   DcalcAPIndex ap_index) const;
+  Slew slewValue(size_t slew_index) const;
+  void setSlewValue(size_t slew_index,
+		    const Slew &slew);
   void makeArcDelayPools(ArcIndex arc_count,
 			 DcalcAPIndex ap_count);
   void deleteArcDelayPools();
@@ -220,6 +307,18 @@ protected:
   void deleteFloats(float *floats,
 		    ObjectIndex count);
   void removeDelayAnnotated(Edge *edge);
+  // Range of edge annotation flags in arc_delay_annotated_.
+  void delayAnnotatedRange(Edge *edge,
+			   // Return values.
+			   Vector<bool>::iterator &begin,
+			   Vector<bool>::iterator &end);
+  void setPinVertexIndex(Pin *pin,
+			 VertexIndex vertex_index);
+  void makeCsr();
+  void csrInvalid();
+  void journalSlew(size_t slew_index);
+  void journalArcDelay(DcalcAPIndex ap_index,
+		       ArcIndex arc_index);
   // User defined predicate to filter graph edges for liberty timing arcs.
   virtual bool filterEdge(TimingArcSet *) const { return true; }
 
@@ -230,23 +329,55 @@ protected:
   //  driver/source (top level input, instance pin output) vertex
   //  in pin_bidirect_drvr_vertex_map
   PinVertexMap pin_bidirect_drvr_vertex_map_;
+  bool private_pin_vertex_indices_;
+  PinVertexIndexMap pin_vertex_indices_;
   VertexIndex vertex_count_;
   EdgeIndex edge_count_;
   ArcIndex arc_count_;
+  // Annotation flags indexed by (arc delay index + arc index) * ap_count_
+  // + ap index so the flags for an edge are one contiguous bit range.
   Vector<bool> arc_delay_annotated_;
   int slew_tr_count_;
   bool have_arc_delays_;
   DcalcAPIndex ap_count_;
-  DelayPoolSeq slew_pools_;	      // [ap_index][tr_index][vertex_index]
-  VertexIndex slew_count_;
+  // Either the Delay or float pools are used, depending on float_delays_.
+  bool float_delays_;
+  bool quantized_slews_;
+  // The slews of a vertex are adjacent so delay calculation of a
+  // vertex touches one cache line.
+  //  slews[vertex_index * slew_stride_ + ap_index * slew_tr_count_ + tr_index]
+  // Only one of the slew arrays is used, depending on float_delays_
+  // and quantized_slews_.
+  size_t slew_stride_;
+  std::vector<Delay> slews_;
+  std::vector<float> float_slews_;
+  std::vector<uint16_t> quantized_slews16_;
   DelayPoolSeq arc_delays_;	      // [ap_index][edge_arc_index]
+  FloatPoolSeq float_arc_delays_;
   Pool<float> *float_pool_;
+  ArrivalPool *arrival_pool_;
+  PrevPathPool *prev_path_pool_;
   // Sdf width check annotations.
   WidthCheckAnnotations *width_check_annotations_;
   // Sdf period check annotations.
   PeriodCheckAnnotations *period_check_annotations_;
   // Register/latch clock vertices to search from.
   VertexSet reg_clk_vertices_;
+  // Compressed sparse row edge lists.
+  // The edges of vertex index i are
+  //  csr_in_edges_[csr_in_begin_[i]..csr_in_begin_[i+1]) and
+  //  csr_out_edges_[csr_out_begin_[i]..csr_out_begin_[i+1]).
+  bool csr_valid_;
+  std::vector<EdgeIndex> csr_in_begin_;
+  std::vector<Edge*> csr_in_edges_;
+  std::vector<EdgeIndex> csr_out_begin_;
+  std::vector<Edge*> csr_out_edges_;
+  bool delay_journal_active_;
+  std::mutex delay_journal_lock_;
+  // Values saved by the delay journal indexed by slew index and
+  // ap index << 32 | arc index.
+  std::unordered_map<uint64_t, Delay> slew_journal_;
+  std::unordered_map<uint64_t, Delay> arc_delay_journal_;
   friend class Vertex;
   friend class VertexIterator;
   friend class VertexInEdgeIterator;
@@ -300,6 +431,7 @@ public:
   void setHasChecks(bool has_checks);
   bool isCheckClk() const { return is_check_clk_; }
   void setIsCheckClk(bool is_check_clk);
+  // Gated clock enable endpoint (set when search finds the endpoints).
   bool isGatedClkEnable() const { return is_gated_clk_enable_; }
   void setIsGatedClkEnable(bool enable);
   bool hasDownstreamClkPin() const { return has_downstream_clk_pin_; }
@@ -473,8 +605,14 @@ public:
 
 private:
   DISALLOW_COPY_AND_ASSIGN(VertexInEdgeIterator);
+  void init(VertexIndex vertex_index,
+	    const Vertex *vertex);
 
   Edge *next_;
+  // Edges after next_ from the graph csr vectors.
+  Edge *const *csr_next_;
+  Edge *const *csr_end_;
+  bool csr_;
   const Graph *graph_;
 };
 
@@ -490,6 +628,10 @@ private:
   DISALLOW_COPY_AND_ASSIGN(VertexOutEdgeIterator);
 
   Edge *next_;
+  // Edges after next_ from the graph csr vectors.
+  Edge *const *csr_next_;
+  Edge *const *csr_end_;
+  bool csr_;
   const Graph *graph_;
 };
 
@@ -0,0 +1,209 @@
+// OpenSTA, Static Timing Analyzer
+// Copyright (c) 2019, Parallax Software, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#include "Machine.hh"
+#include "Graph.hh"
+#include "VertexBitSet.hh"
+
+namespace sta {
+
+static const int page_bits_log2 = 18;
+static const size_t page_bits = size_t(1) << page_bits_log2;
+static const size_t page_words = page_bits / 64;
+// Enough pages for any VertexIndex.
+static const size_t page_count =
+  (size_t(1) << (sizeof(VertexIndex) * 8)) / page_bits;
+// Sets with more vertices than this are visited by scanning the bits.
+static const size_t change_count_max = 1 << 16;
+
+VertexBitSet::VertexBitSet() :
+  pages_(new std::atomic<std::atomic<uint64_t>*>[page_count]),
+  size_(0),
+  changes_(nullptr),
+  change_count_(0),
+  erased_(false)
+{
+  for (size_t i = 0; i < page_count; i++)
+    pages_[i].store(nullptr, std::memory_order_relaxed);
+}
+
+VertexBitSet::~VertexBitSet()
+{
+  for (size_t i = 0; i < page_count; i++)
+    delete [] pages_[i].load(std::memory_order_relaxed);
+  delete [] pages_;
+  delete [] changes_.load(std::memory_order_relaxed);
+}
+
+// Threads that find the page missing race to install theirs and the
+// losers delete their copy.
+std::atomic<uint64_t> *
+VertexBitSet::ensurePage(size_t page_index)
+{
+  std::atomic<uint64_t> *page =
+    pages_[page_index].load(std::memory_order_acquire);
+  if (page == nullptr) {
+    std::atomic<uint64_t> *new_page = new std::atomic<uint64_t>[page_words];
+    for (size_t i = 0; i < page_words; i++)
+      new_page[i].store(0, std::memory_order_relaxed);
+    if (pages_[page_index].compare_exchange_strong(page, new_page,
+						   std::memory_order_acq_rel))
+      page = new_page;
+    else
+      delete [] new_page;
+  }
+  return page;
+}
+
+VertexIndex *
+VertexBitSet::ensureChanges()
+{
+  VertexIndex *changes = changes_.load(std::memory_order_acquire);
+  if (changes == nullptr) {
+    VertexIndex *new_changes = new VertexIndex[change_count_max];
+    if (changes_.compare_exchange_strong(changes, new_changes,
+					 std::memory_order_acq_rel))
+      changes = new_changes;
+    else
+      delete [] new_changes;
+  }
+  return changes;
+}
+
+bool
+VertexBitSet::insert(const Vertex *vertex,
+		     const Graph *graph)
+{
+  VertexIndex index = graph->index(vertex);
+  std::atomic<uint64_t> *page = ensurePage(index >> page_bits_log2);
+  uint64_t bit = uint64_t(1) << (index & 63);
+  std::atomic<uint64_t> &word = page[(index & (page_bits - 1)) >> 6];
+  if ((word.fetch_or(bit, std::memory_order_relaxed) & bit) == 0) {
+    size_.fetch_add(1, std::memory_order_relaxed);
+    size_t change_index = change_count_.fetch_add(1, std::memory_order_relaxed);
+    if (change_index < change_count_max)
+      ensureChanges()[change_index] = index;
+    return true;
+  }
+  else
+    return false;
+}
+
+bool
+VertexBitSet::hasKey(const Vertex *vertex,
+		     const Graph *graph) const
+{
+  VertexIndex index = graph->index(vertex);
+  std::atomic<uint64_t> *page =
+    pages_[index >> page_bits_log2].load(std::memory_order_acquire);
+  if (page) {
+    uint64_t bit = uint64_t(1) << (index & 63);
+    const std::atomic<uint64_t> &word = page[(index & (page_bits - 1)) >> 6];
+    return (word.load(std::memory_order_relaxed) & bit) != 0;
+  }
+  else
+    return false;
+}
+
+void
+VertexBitSet::erase(const Vertex *vertex,
+		    const Graph *graph)
+{
+  VertexIndex index = graph->index(vertex);
+  std::atomic<uint64_t> *page =
+    pages_[index >> page_bits_log2].load(std::memory_order_acquire);
+  if (page) {
+    uint64_t bit = uint64_t(1) << (index & 63);
+    std::atomic<uint64_t> &word = page[(index & (page_bits - 1)) >> 6];
+    if (word.fetch_and(~bit, std::memory_order_relaxed) & bit) {
+      size_.fetch_sub(1, std::memory_order_relaxed);
+      // The change list may now have the index more than once.
+      erased_ = true;
+    }
+  }
+}
+
+bool
+VertexBitSet::useChanges() const
+{
+  return !erased_
+    && change_count_.load(std::memory_order_relaxed) <= change_count_max;
+}
+
+void
+VertexBitSet::clear()
+{
+  if (size_ > 0) {
+    if (useChanges()) {
+      // Every set bit is in the change list, so the words with changes
+      // are the only ones to clear.
+      VertexIndex *changes = changes_.load(std::memory_order_relaxed);
+      size_t change_count = change_count_.load(std::memory_order_relaxed);
+      for (size_t i = 0; i < change_count; i++) {
+	VertexIndex index = changes[i];
+	std::atomic<uint64_t> *page =
+	  pages_[index >> page_bits_log2].load(std::memory_order_relaxed);
+	page[(index & (page_bits - 1)) >> 6].store(0, std::memory_order_relaxed);
+      }
+    }
+    else {
+      for (size_t i = 0; i < page_count; i++) {
+	std::atomic<uint64_t> *page =
+	  pages_[i].load(std::memory_order_relaxed);
+	if (page) {
+	  for (size_t j = 0; j < page_words; j++)
+	    page[j].store(0, std::memory_order_relaxed);
+	}
+      }
+    }
+  }
+  size_ = 0;
+  change_count_ = 0;
+  erased_ = false;
+}
+
+void
+VertexBitSet::vertices(const Graph *graph,
+		       VertexSeq &vertices) const
+{
+  if (size_ > 0) {
+    vertices.reserve(vertices.size() + size_);
+    if (useChanges()) {
+      VertexIndex *changes = changes_.load(std::memory_order_relaxed);
+      size_t change_count = change_count_.load(std::memory_order_relaxed);
+      for (size_t i = 0; i < change_count; i++)
+	vertices.push_back(graph->vertex(changes[i]));
+    }
+    else {
+      for (size_t i = 0; i < page_count; i++) {
+	std::atomic<uint64_t> *page =
+	  pages_[i].load(std::memory_order_relaxed);
+	if (page) {
+	  for (size_t j = 0; j < page_words; j++) {
+	    uint64_t bits = page[j].load(std::memory_order_relaxed);
+	    VertexIndex index = i * page_bits + j * 64;
+	    for (; bits; bits >>= 1, index++) {
+	      if (bits & 1)
+		vertices.push_back(graph->vertex(index));
+	    }
+	  }
+	}
+      }
+    }
+  }
+}
+
+} // namespace
@@ -0,0 +1,71 @@
+// OpenSTA, Static Timing Analyzer
+// Copyright (c) 2019, Parallax Software, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#ifndef STA_VERTEX_BIT_SET_H
+#define STA_VERTEX_BIT_SET_H
+
+#include <stddef.h>  // size_t
+#include <stdint.h>
+#include <atomic>
+#include "DisallowCopyAssign.hh"
+#include "GraphClass.hh"
+
+namespace sta {
+
+// Set of vertices that threads insert into without locks.
+// Membership is a bit per VertexIndex in pages that are allocated when
+// they are first used. Indices are also appended to a change list the
+// first time their bit is set so small sets are visited without
+// scanning the bits. Sets that outgrow the change list or that vertices
+// were erased from are visited with a linear scan of the bits.
+class VertexBitSet
+{
+public:
+  VertexBitSet();
+  ~VertexBitSet();
+  // Return true if the vertex was not in the set.
+  // Thread safe with other inserts.
+  bool insert(const Vertex *vertex,
+	      const Graph *graph);
+  bool hasKey(const Vertex *vertex,
+	      const Graph *graph) const;
+  void erase(const Vertex *vertex,
+	     const Graph *graph);
+  bool empty() const { return size_ == 0; }
+  size_t size() const { return size_; }
+  void clear();
+  // Append the vertices in the set to vertices.
+  void vertices(const Graph *graph,
+		// Return value.
+		VertexSeq &vertices) const;
+
+private:
+  DISALLOW_COPY_AND_ASSIGN(VertexBitSet);
+  std::atomic<uint64_t> *ensurePage(size_t page_index);
+  VertexIndex *ensureChanges();
+  bool useChanges() const;
+
+  // Pages of page_bits bits indexed by VertexIndex / page_bits.
+  std::atomic<std::atomic<uint64_t>*> *pages_;
+  std::atomic<size_t> size_;
+  // Indices inserted since the last clear, in insertion order.
+  std::atomic<VertexIndex*> changes_;
+  std::atomic<size_t> change_count_;
+  bool erased_;
+};
+
+} // namespace
+#endif
@@ -0,0 +1,61 @@
+// OpenSTA, Static Timing Analyzer
+// Copyright (c) 2019, Parallax Software, Inc.
+// 
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+// 
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+// 
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#ifndef STA_VERTEX_VISITED_BITS_H
+#define STA_VERTEX_VISITED_BITS_H
+
+#include <stddef.h>  // size_t
+#include <stdint.h>
+#include <atomic>
+#include "DisallowCopyAssign.hh"
+#include "GraphClass.hh"
+
+namespace sta {
+
+// Visited flags indexed by VertexIndex that threads set concurrently.
+class VertexVisitedBits
+{
+public:
+  explicit VertexVisitedBits(VertexIndex index_bound) :
+    word_count_((index_bound + 63) / 64),
+    words_(new std::atomic<uint64_t>[word_count_])
+  {
+    for (size_t i = 0; i < word_count_; i++)
+      words_[i].store(0, std::memory_order_relaxed);
+  }
+  ~VertexVisitedBits() { delete [] words_; }
+  // Return true if index was not visited before.
+  bool visit(VertexIndex index)
+  {
+    uint64_t bit = uint64_t(1) << (index & 63);
+    return (words_[index >> 6].fetch_or(bit, std::memory_order_relaxed)
+	    & bit) == 0;
+  }
+  bool visited(VertexIndex index) const
+  {
+    uint64_t bit = uint64_t(1) << (index & 63);
+    return (words_[index >> 6].load(std::memory_order_relaxed) & bit) != 0;
+  }
+
+private:
+  DISALLOW_COPY_AND_ASSIGN(VertexVisitedBits);
+
+  size_t word_count_;
+  std::atomic<uint64_t> *words_;
+};
+
+} // namespace
+#endif
@@ -14,8 +14,10 @@
 // You should have received a copy of the GNU General Public License
 // along with this program.  If not, see <https://www.gnu.org/licenses/>.
 
+#include <vector>
 #include "Machine.hh"
 #include "UnorderedMap.hh"
+#include "ThreadForEach.hh"
 #include "PortDirection.hh"
 #include "Transition.hh"
 #include "MinMax.hh"
@@ -29,14 +31,15 @@
 
 namespace sta {
 
-typedef UnorderedMap<unsigned, LibertyCellSeq*> LibertyCellHashMap;
-typedef Set<LibertyCell*> LibertyCellSet;
+typedef UnorderedMap<unsigned, size_t> LibertyCellHashMap;
+typedef std::vector<LibertyCellSeq> LibertyCellBuckets;
 
 static void
-findEquivCells1(const LibertyLibrary *library,
-		LibertyCellSet &cell_equivs);
+findBucketEquivs(LibertyCellSeq &bucket,
+		 // Return value.
+		 LibertyCellSeq &equiv_cells);
 static void
-sortCellEquivs(LibertyCellSet &cell_equivs);
+sortCellEquivs(LibertyCell *equiv_cell);
 static float
 cellDriveResistance(const LibertyCell *cell);
 
@@ -47,6 +50,8 @@ hashCellPorts(const LibertyCell *cell);
 static unsigned
 hashCellSequentials(const LibertyCell *cell);
 static unsigned
+hashCellTimingArcSets(const LibertyCell *cell);
+static unsigned
 hashFuncExpr(const FuncExpr *expr);
 static unsigned
 hashPort(const LibertyPort *port);
@@ -58,53 +63,81 @@ equivCellSequentials(const LibertyCell *cell1,
 		     const LibertyCell *cell2);
 
 void
-findEquivCells(const LibertyLibrary *library)
+findEquivCells(const LibertyLibrary *library,
+	       ThreadPool *thread_pool)
 {
-  LibertyCellSet cell_equivs;
-  findEquivCells1(library, cell_equivs);
-  // Sort by drive strength.
-  sortCellEquivs(cell_equivs);
+  LibertyCellSeq cells;
+  LibertyCellIterator cell_iter(library);
+  while (cell_iter.hasNext()) {
+    LibertyCell *cell = cell_iter.next();
+    if (!cell->dontUse())
+      cells.push_back(cell);
+  }
+
+  // Use a comprehensive hash on cell properties to segregate
+  // cells into groups of potential matches.
+  std::vector<unsigned> hashes(cells.size());
+  forEachChunk(cells.size(), thread_pool,
+	       [&](size_t begin, size_t end, int) {
+		 for (size_t i = begin; i < end; i++)
+		   hashes[i] = hashCell(cells[i]);
+	       });
+
+  LibertyCellHashMap bucket_index;
+  LibertyCellBuckets buckets;
+  for (size_t i = 0; i < cells.size(); i++) {
+    unsigned hash = hashes[i];
+    auto index_iter = bucket_index.find(hash);
+    if (index_iter == bucket_index.end()) {
+      bucket_index[hash] = buckets.size();
+      buckets.push_back(LibertyCellSeq());
+      buckets.back().push_back(cells[i]);
+    }
+    else
+      buckets[index_iter->second].push_back(cells[i]);
+  }
+
+  // Only cells in the same bucket are compared, so buckets are
+  // independent.
+  std::vector<LibertyCellSeq> bucket_equivs(buckets.size());
+  forEachChunk(buckets.size(), thread_pool,
+	       [&](size_t begin, size_t end, int) {
+		 for (size_t i = begin; i < end; i++) {
+		   findBucketEquivs(buckets[i], bucket_equivs[i]);
+		   // Sort by drive strength.
+		   for (auto equiv_cell : bucket_equivs[i])
+		     sortCellEquivs(equiv_cell);
+		 }
+	       });
 }
 
+// Group the cells in bucket into equivalence classes.
+// Return the first cell of each class with more than one cell.
 static void
-findEquivCells1(const LibertyLibrary *library,
-		LibertyCellSet &cell_equivs)
+findBucketEquivs(LibertyCellSeq &bucket,
+		 // Return value.
+		 LibertyCellSeq &equiv_cells)
 {
-  LibertyCellHashMap cell_hash;
-  LibertyCellIterator cell_iter(library);
-  while (cell_iter.hasNext()) {
-    LibertyCell *cell = cell_iter.next();
-    if (!cell->dontUse()) {
-      unsigned hash = hashCell(cell);
-      // Use a comprehensive hash on cell properties to segregate
-      // cells into groups of potential matches.
-      LibertyCellSeq *matches = cell_hash[hash];
-      if (matches) {
-	LibertyCellSeq::Iterator match_iter(matches);
-	while (match_iter.hasNext()) {
-	  LibertyCell *match = match_iter.next();
-	  if (equivCells(match, cell)) {
-	    LibertyCellSeq *equivs = match->equivCellsRaw();
-	    if (equivs == nullptr) {
-	      equivs = new LibertyCellSeq;
-	      equivs->push_back(match);
-	      match->setEquivCells(equivs);
-	      cell_equivs.insert(match);
-	    }
-	    equivs->push_back(cell);
-	    cell->setEquivCells(equivs);
-	    break;
-	  }
+  LibertyCellSeq matches;
+  for (auto cell : bucket) {
+    LibertyCellSeq::Iterator match_iter(matches);
+    while (match_iter.hasNext()) {
+      LibertyCell *match = match_iter.next();
+      if (equivCells(match, cell)) {
+	LibertyCellSeq *equivs = match->equivCellsRaw();
+	if (equivs == nullptr) {
+	  equivs = new LibertyCellSeq;
+	  equivs->push_back(match);
+	  match->setEquivCells(equivs);
+	  equiv_cells.push_back(match);
 	}
+	equivs->push_back(cell);
+	cell->setEquivCells(equivs);
+	break;
       }
-      else {
-	matches = new LibertyCellSeq;
-	cell_hash[hash] = matches;
-      }
-      matches->push_back(cell);
     }
+    matches.push_back(cell);
   }
-  cell_hash.deleteContents();
 }
 
 struct CellDriveResistanceLess
@@ -117,21 +150,19 @@ struct CellDriveResistanceLess
 };
 
 static void
-sortCellEquivs(LibertyCellSet &cell_equivs)
+sortCellEquivs(LibertyCell *equiv_cell)
 {
-  for (auto equiv : cell_equivs) {
-    LibertyCellSeq *equivs = equiv->equivCells();
-    sort(equivs, CellDriveResistanceLess());
-    LibertyCell *lower = nullptr;
-    LibertyCellSeq::Iterator cell_iter(equivs);
-    while (cell_iter.hasNext()) {
-      LibertyCell *cell = cell_iter.next();
-      if (lower) {
-	lower->setHigherDrive(cell);
-	cell->setLowerDrive(lower);
-      }
-      lower = cell;
+  LibertyCellSeq *equivs = equiv_cell->equivCellsRaw();
+  sort(equivs, CellDriveResistanceLess());
+  LibertyCell *lower = nullptr;
+  LibertyCellSeq::Iterator cell_iter(equivs);
+  while (cell_iter.hasNext()) {
+    LibertyCell *cell = cell_iter.next();
+    if (lower) {
+      lower->setHigherDrive(cell);
+      cell->setLowerDrive(lower);
     }
+    lower = cell;
   }
 }
 
@@ -162,7 +193,9 @@ cellDriveResistance(const LibertyCell *cell)
 static unsigned
 hashCell(const LibertyCell *cell)
 {
-  return hashCellPorts(cell) + hashCellSequentials(cell);
+  return hashCellPorts(cell)
+    + hashCellSequentials(cell)
+    + hashCellTimingArcSets(cell);
 }
 
 static unsigned
@@ -205,6 +238,25 @@ hashCellSequentials(const LibertyCell *cell)
   return hash;
 }
 
+// Arc sets are compared by ports and role, so the hash is the
+// same for cells that only differ in arc set order.
+static unsigned
+hashCellTimingArcSets(const LibertyCell *cell)
+{
+  unsigned hash = cell->timingArcSetCount() * 3;
+  LibertyCellTimingArcSetIterator set_iter(cell);
+  while (set_iter.hasNext()) {
+    TimingArcSet *set = set_iter.next();
+    LibertyPort *from = set->from();
+    LibertyPort *to = set->to();
+    hash += (from ? hashPort(from) : 0) * 5
+      + (to ? hashPort(to) : 0) * 7
+      + (set->role()->index() + 1) * 11
+      + set->arcCount() * 13;
+  }
+  return hash;
+}
+
 static unsigned
 hashFuncExpr(const FuncExpr *expr)
 {
@@ -22,10 +22,15 @@
 
 namespace sta {
 
+class ThreadPool;
+
 // Find equivalent cells, sort by drive strength and
 // and set cell->equivCells/higherDrive/lowerDrive.
+// Cell hashes and the comparisons within each hash bucket are
+// done in parallel when thread_pool is non-null.
 void
-findEquivCells(const LibertyLibrary *library);
+findEquivCells(const LibertyLibrary *library,
+	       ThreadPool *thread_pool);
 
 // Predicate that is true when the ports, functions, sequentials and
 // timing arcs match.
@@ -345,6 +345,169 @@ funcExprNot(FuncExpr *expr)
 
 ////////////////////////////////////////////////////////////////
 
+// Truth table bits for each input variable.
+static const unsigned long long truth_table_input_bits[FuncTruthTable::max_inputs] = {
+  0xaaaaaaaaaaaaaaaaULL,
+  0xccccccccccccccccULL,
+  0xf0f0f0f0f0f0f0f0ULL,
+  0xff00ff00ff00ff00ULL,
+  0xffff0000ffff0000ULL,
+  0xffffffff00000000ULL
+};
+
+FuncTruthTable::FuncTruthTable() :
+  input_count_(0),
+  bits_(0)
+{
+}
+
+FuncTruthTable *
+FuncTruthTable::make(const FuncExpr *expr)
+{
+  FuncTruthTable *table = new FuncTruthTable;
+  if (table->findInputs(expr)) {
+    table->bits_ = table->findBits(expr);
+    return table;
+  }
+  else {
+    delete table;
+    return nullptr;
+  }
+}
+
+bool
+FuncTruthTable::findInputs(const FuncExpr *expr)
+{
+  switch (expr->op()) {
+  case FuncExpr::op_port: {
+    LibertyPort *port = expr->port();
+    for (int i = 0; i < input_count_; i++) {
+      if (inputs_[i] == port)
+	return true;
+    }
+    if (input_count_ == max_inputs)
+      return false;
+    inputs_[input_count_++] = port;
+    return true;
+  }
+  case FuncExpr::op_not:
+    return findInputs(expr->left());
+  case FuncExpr::op_or:
+  case FuncExpr::op_and:
+  case FuncExpr::op_xor:
+    return findInputs(expr->left())
+      && findInputs(expr->right());
+  case FuncExpr::op_one:
+  case FuncExpr::op_zero:
+    return true;
+  }
+  return false;
+}
+
+unsigned long long
+FuncTruthTable::findBits(const FuncExpr *expr) const
+{
+  switch (expr->op()) {
+  case FuncExpr::op_port: {
+    LibertyPort *port = expr->port();
+    for (int i = 0; i < input_count_; i++) {
+      if (inputs_[i] == port)
+	return truth_table_input_bits[i];
+    }
+    return 0;
+  }
+  case FuncExpr::op_not:
+    return ~findBits(expr->left());
+  case FuncExpr::op_or:
+    return findBits(expr->left()) | findBits(expr->right());
+  case FuncExpr::op_and:
+    return findBits(expr->left()) & findBits(expr->right());
+  case FuncExpr::op_xor:
+    return findBits(expr->left()) ^ findBits(expr->right());
+  case FuncExpr::op_one:
+    return ~0ULL;
+  case FuncExpr::op_zero:
+    return 0;
+  }
+  return 0;
+}
+
+LogicValue
+FuncTruthTable::eval(const LogicValue *input_values) const
+{
+  unsigned long long mask = this->mask();
+  unsigned long long bits = restrictBits(input_values, -1) & mask;
+  if (bits == 0)
+    return LogicValue::zero;
+  else if (bits == mask)
+    return LogicValue::one;
+  else
+    return LogicValue::unknown;
+}
+
+TimingSense
+FuncTruthTable::sense(int input_index,
+		      const LogicValue *input_values) const
+{
+  unsigned long long bits = restrictBits(input_values, input_index) & mask();
+  // Compare the function with the input one (ones) to the function
+  // with the input zero (zeros) shifted to the same minterms.
+  unsigned long long input_bits = truth_table_input_bits[input_index];
+  unsigned long long ones = bits & input_bits;
+  unsigned long long zeros = (bits << (1 << input_index)) & input_bits;
+  bool increasing = (zeros & ~ones) == 0;
+  bool decreasing = (ones & ~zeros) == 0;
+  if (increasing && decreasing)
+    return TimingSense::none;
+  else if (increasing)
+    return TimingSense::positive_unate;
+  else if (decreasing)
+    return TimingSense::negative_unate;
+  else
+    return TimingSense::non_unate;
+}
+
+// Restrict the table to the constant inputs other than skip_index by
+// copying the half of the table for each constant value over the
+// other half.
+unsigned long long
+FuncTruthTable::restrictBits(const LogicValue *input_values,
+			     int skip_index) const
+{
+  unsigned long long bits = bits_;
+  for (int i = 0; i < input_count_; i++) {
+    if (i != skip_index) {
+      unsigned long long input_bits = truth_table_input_bits[i];
+      int shift = 1 << i;
+      switch (input_values[i]) {
+      case LogicValue::one: {
+	unsigned long long half = bits & input_bits;
+	bits = half | (half >> shift);
+	break;
+      }
+      case LogicValue::zero: {
+	unsigned long long half = bits & ~input_bits;
+	bits = half | (half << shift);
+	break;
+      }
+      default:
+	break;
+      }
+    }
+  }
+  return bits;
+}
+
+unsigned long long
+FuncTruthTable::mask() const
+{
+  return (input_count_ == max_inputs)
+    ? ~0ULL
+    : (1ULL << (1 << input_count_)) - 1;
+}
+
+////////////////////////////////////////////////////////////////
+
 FuncExprPortIterator::FuncExprPortIterator(FuncExpr *expr)
 {
   findPorts(expr);
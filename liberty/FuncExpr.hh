@@ -93,6 +93,45 @@ private:
 FuncExpr *
 funcExprNot(FuncExpr *expr);
 
+// Truth table for a function with at most max_inputs ports so it can
+// be evaluated with constant input values without walking the
+// expression.
+class FuncTruthTable
+{
+public:
+  static const int max_inputs = 6;
+  // Returns nullptr if expr has more than max_inputs ports.
+  static FuncTruthTable *make(const FuncExpr *expr);
+  int inputCount() const { return input_count_; }
+  LibertyPort *input(int index) const { return inputs_[index]; }
+  // Input values are indexed by input index.
+  // Inputs that are not zero or one are don't cares, so the result is
+  // unknown only if the function depends on them.
+  LogicValue eval(const LogicValue *input_values) const;
+  // Timing sense from input input_index to the function with the
+  // zero/one input_values of the other inputs.  The table holds the
+  // function of every constant pattern, so this is a lookup instead
+  // of walking the expression.
+  TimingSense sense(int input_index,
+		    const LogicValue *input_values) const;
+  // Function value when input j has the value of bit j of minterm.
+  bool value(unsigned minterm) const { return (bits_ >> minterm) & 1; }
+
+private:
+  DISALLOW_COPY_AND_ASSIGN(FuncTruthTable);
+  FuncTruthTable();
+  bool findInputs(const FuncExpr *expr);
+  unsigned long long findBits(const FuncExpr *expr) const;
+  unsigned long long restrictBits(const LogicValue *input_values,
+				  int skip_index) const;
+  unsigned long long mask() const;
+
+  int input_count_;
+  LibertyPort *inputs_[max_inputs];
+  // Bit i is the function value when input j has the value of bit j of i.
+  unsigned long long bits_;
+};
+
 class FuncExprPortIterator : public Iterator<LibertyPort*>
 {
 public:
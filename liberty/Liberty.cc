@@ -19,6 +19,7 @@
 #include "EnumNameMap.hh"
 #include "Report.hh"
 #include "Debug.hh"
+#include "MemoryReport.hh"
 #include "Error.hh"
 #include "StringUtil.hh"
 #include "StringSet.hh"
@@ -44,7 +45,13 @@ typedef Set<TimingModel*> TimingModelSet;
 typedef Set<FuncExpr*> FuncExprSet;
 typedef Set<LatchEnable*> LatchEnableSet;
 
+static void
+functionClkOperands(FuncExpr *root_expr,
+		    FuncExpr *expr,
+		    FuncExprSet &funcs);
+
 bool LibertyLibrary::found_rise_fall_caps_ = false;
+bool LibertyLibrary::found_pll_feedback_pins_ = false;
 
 void
 initLiberty()
@@ -85,7 +92,8 @@ LibertyLibrary::LibertyLibrary(const char *name,
   ocv_arc_depth_(0.0),
   default_ocv_derate_(nullptr),
   found_equiv_cells_(false),
-  buffers_(nullptr)
+  buffers_(nullptr),
+  cell_loader_(nullptr)
 {
   // Scalar templates are builtin.
   for (int i = 0; i != int(TableTemplateType::count); i++) {
@@ -133,6 +141,7 @@ LibertyLibrary::~LibertyLibrary()
     stringDelete(supply_name);
   }
   delete buffers_;
+  delete cell_loader_;
 }
 
 LibertyCell *
@@ -141,10 +150,53 @@ LibertyLibrary::findLibertyCell(const char *name) const
   return dynamic_cast<LibertyCell*>(findCell(name));
 }
 
+// The cells of a library with a loader are added while it is used, so
+// they are found with the loader lock held.
+ConcreteCell *
+LibertyLibrary::findCell(const char *name) const
+{
+  if (cell_loader_) {
+    std::lock_guard<std::recursive_mutex> lock(cell_loader_->lock());
+    ConcreteCell *cell = ConcreteLibrary::findCell(name);
+    if (cell == nullptr) {
+      cell_loader_->loadCell(name);
+      cell = ConcreteLibrary::findCell(name);
+    }
+    return cell;
+  }
+  else
+    return ConcreteLibrary::findCell(name);
+}
+
+void
+LibertyLibrary::findCellsMatching(const PatternMatch *pattern,
+				  CellSeq *cells) const
+{
+  if (cell_loader_) {
+    std::lock_guard<std::recursive_mutex> lock(cell_loader_->lock());
+    cell_loader_->loadCellsMatching(pattern);
+    ConcreteLibrary::findCellsMatching(pattern, cells);
+  }
+  else
+    ConcreteLibrary::findCellsMatching(pattern, cells);
+}
+
+void
+LibertyLibrary::setCellLoader(LibertyCellLoader *loader)
+{
+  delete cell_loader_;
+  cell_loader_ = loader;
+}
+
 void
 LibertyLibrary::findLibertyCellsMatching(PatternMatch *pattern,
 					 LibertyCellSeq *cells)
 {
+  std::unique_lock<std::recursive_mutex> lock;
+  if (cell_loader_) {
+    lock = std::unique_lock<std::recursive_mutex>(cell_loader_->lock());
+    cell_loader_->loadCellsMatching(pattern);
+  }
   LibertyCellIterator cell_iter(this);
   while (cell_iter.hasNext()) {
     LibertyCell *cell = cell_iter.next();
@@ -153,11 +205,78 @@ LibertyLibrary::findLibertyCellsMatching(PatternMatch *pattern,
   }
 }
 
+// Table values are shared between libraries so they are reported
+// separately (see internFloats).
+static size_t
+tableModelBytes(const TableModel *model)
+{
+  if (model)
+    return sizeof(TableModel) + sizeof(Table3);
+  else
+    return 0;
+}
+
+void
+LibertyLibrary::reportMemory(MemoryReport &memory) const
+{
+  size_t cell_count = 0;
+  size_t arc_set_count = 0;
+  size_t arc_count = 0;
+  size_t table_count = 0;
+  size_t table_bytes = 0;
+  LibertyCellIterator cell_iter(this);
+  while (cell_iter.hasNext()) {
+    LibertyCell *cell = cell_iter.next();
+    cell_count++;
+    LibertyCellTimingArcSetIterator set_iter(cell);
+    while (set_iter.hasNext()) {
+      TimingArcSet *arc_set = set_iter.next();
+      arc_set_count++;
+      TimingArcSetArcIterator arc_iter(arc_set);
+      while (arc_iter.hasNext()) {
+	TimingArc *arc = arc_iter.next();
+	arc_count++;
+	TimingModel *model = arc->model();
+	GateTableModel *gate_model = dynamic_cast<GateTableModel*>(model);
+	if (gate_model) {
+	  const TableModel *delay_model = gate_model->delayModel();
+	  const TableModel *slew_model = gate_model->slewModel();
+	  table_count += (delay_model != nullptr) + (slew_model != nullptr);
+	  table_bytes += sizeof(GateTableModel)
+	    + tableModelBytes(delay_model)
+	    + tableModelBytes(slew_model);
+	}
+	else {
+	  CheckTableModel *check_model = dynamic_cast<CheckTableModel*>(model);
+	  if (check_model) {
+	    const TableModel *table_model = check_model->model();
+	    table_count += (table_model != nullptr);
+	    table_bytes += sizeof(CheckTableModel)
+	      + tableModelBytes(table_model);
+	  }
+	}
+      }
+    }
+  }
+  memory.reportUsage("Liberty", "cells", cell_count,
+		     cell_count * sizeof(LibertyCell));
+  memory.reportUsage("Liberty", "timing arcs", arc_count,
+		     arc_set_count * sizeof(TimingArcSet)
+		     + arc_count * sizeof(TimingArc));
+  memory.reportUsage("Liberty", "timing tables", table_count, table_bytes);
+}
+
 void
 LibertyLibrary::ensureEquivCells()
+{
+  findEquivCells(nullptr);
+}
+
+void
+LibertyLibrary::findEquivCells(ThreadPool *thread_pool)
 {
   if (!found_equiv_cells_) {
-    findEquivCells(this);
+    sta::findEquivCells(this, thread_pool);
     found_equiv_cells_ = true;
   }
 }
@@ -690,6 +809,8 @@ LibertyLibrary::makeCornerMap(LibertyLibrary *lib,
 			      Network *network,
 			      Report *report)
 {
+  if (lib->cell_loader_)
+    lib->cell_loader_->addCornerIndex(ap_index);
   LibertyCellIterator cell_iter(lib);
   while (cell_iter.hasNext()) {
     LibertyCell *cell = cell_iter.next();
@@ -859,6 +980,7 @@ LibertyCell::LibertyCell(LibertyLibrary *library,
   has_internal_ports_(false),
   interface_timing_(false),
   clock_gate_type_(ClockGateType::none),
+  table_port_count_(0),
   has_infered_reg_timing_arcs_(false),
   scale_factors_(nullptr),
   test_cell_(nullptr),
@@ -1098,6 +1220,126 @@ LibertyCell::bufferPorts(// Return values.
     }
 }
 
+// Find the output functions that can gate a clock so the search does
+// not have to pick apart the function of every gate in the clock network.
+void
+LibertyCell::makeClkGatingFuncs()
+{
+  LibertyCellPortBitIterator port_iter(this);
+  while (port_iter.hasNext()) {
+    LibertyPort *gclk_port = port_iter.next();
+    FuncExpr *func = gclk_port->function();
+    if (func) {
+      FuncExpr *root = func;
+      while (root->op() == FuncExpr::op_not)
+	root = root->left();
+      if (root->op() == FuncExpr::op_and
+	  || root->op() == FuncExpr::op_or) {
+	// Function ports in order without duplicates.
+	LibertyPortSeq func_ports;
+	LibertyPortSet visited;
+	FuncExprPortIterator func_port_iter(func);
+	while (func_port_iter.hasNext()) {
+	  LibertyPort *port = func_port_iter.next();
+	  if (!visited.hasKey(port)) {
+	    visited.insert(port);
+	    func_ports.push_back(port);
+	  }
+	}
+	for (auto enable_port : func_ports) {
+	  for (auto clk_port : func_ports) {
+	    if (clk_port != enable_port) {
+	      bool is_clk_gate;
+	      LogicValue active_value;
+	      isClkGatingFunc(func, enable_port, clk_port,
+			      is_clk_gate, active_value);
+	      if (is_clk_gate)
+		clk_gating_funcs_.push_back(ClkGatingFunc(gclk_port,
+							  enable_port,
+							  clk_port,
+							  active_value));
+	    }
+	  }
+	}
+      }
+    }
+  }
+}
+
+void
+LibertyCell::isClkGatingFunc(FuncExpr *func,
+			     LibertyPort *enable_port,
+			     LibertyPort *clk_port,
+			     bool &is_clk_gate,
+			     LogicValue &logic_value) const
+{
+  // The function should be in two-level SOP or POS form depending on "cost".
+  // We need to apply literal cofactor if any input port is constant and
+  // do "simple" logic minimization based on SOP and POS.
+  while (func->op() == FuncExpr::op_not)
+    func = func->left();
+  if (func->op() == FuncExpr::op_and)
+    logic_value = LogicValue::one;
+  else if (func->op() == FuncExpr::op_or)
+    logic_value = LogicValue::zero;
+  else {
+    is_clk_gate = false;
+    return;
+  }
+
+  FuncExprSet funcs;
+  functionClkOperands(func, func->left(), funcs);
+  functionClkOperands(func, func->right(), funcs);
+
+  bool need_gating_check = false;
+  FuncExprSet::Iterator expr_iter(funcs);
+  while (expr_iter.hasNext()) {
+    FuncExpr *expr = expr_iter.next();
+    if (expr->op() == FuncExpr::op_not) {
+      if (expr->left()->op() == FuncExpr::op_port
+	  && expr->left()->port() == clk_port) {
+	need_gating_check = true;
+	logic_value = (logic_value == LogicValue::one) ? LogicValue::zero : LogicValue::one;
+      }
+    }
+    else {
+      if (expr->op() == FuncExpr::op_port
+	  && expr->port() == clk_port) {
+	need_gating_check = true;
+      }
+    }
+  }
+
+  if (need_gating_check) {
+    FuncExprSet::Iterator expr_iter2(funcs);
+    while (expr_iter2.hasNext()) {
+      FuncExpr *expr = expr_iter2.next();
+      FuncExprPortIterator en_port_iter(expr);
+      while (en_port_iter.hasNext()) {
+	LibertyPort *port = en_port_iter.next();
+	if (port == enable_port) {
+	  is_clk_gate = true;
+	  return;
+	}
+      }
+    }
+  }
+  is_clk_gate = false;
+}
+
+static void
+functionClkOperands(FuncExpr *root_expr,
+		    FuncExpr *expr,
+		    FuncExprSet &funcs)
+{
+  if (expr->op() != root_expr->op())
+    funcs.insert(expr);
+  else {
+    functionClkOperands(root_expr, expr->left(), funcs);
+    functionClkOperands(root_expr, expr->right(), funcs);
+  }
+}
+
 unsigned
 LibertyCell::addTimingArcSet(TimingArcSet *arc_set)
 {
@@ -1174,12 +1416,25 @@ LibertyCell::finish(bool infer_latches,
   makeTimingArcMap(report);
   makeTimingArcPortMaps();
   findDefaultCondArcs();
+  makeFuncTruthTables();
+  makeClkGatingFuncs();
   makeLatchEnables(report, debug);
   if (infer_latches
       && !interface_timing_)
     inferLatchRoles(debug);
 }
 
+// The reader sets port functions with LibertyPort::functionRef.
+void
+LibertyCell::makeFuncTruthTables()
+{
+  LibertyCellPortBitIterator port_iter(this);
+  while (port_iter.hasNext()) {
+    LibertyPort *port = port_iter.next();
+    port->makeFuncTruthTables();
+  }
+}
+
 void
 LibertyCell::findDefaultCondArcs()
 {
@@ -1288,6 +1543,44 @@ LibertyCell::makeTimingArcPortMaps()
     }
     sets->push_back(arc_set);
   }
+  makeTimingArcPortTables();
+}
+
+// Cells with more ports use the port pair map to bound the table size.
+static const int port_pair_table_max_ports = 32;
+
+// Graph construction and delay calculation look up arc sets by port
+// for every instance, so index them by port pinIndex.
+void
+LibertyCell::makeTimingArcPortTables()
+{
+  int port_count = portBitCount();
+  table_port_count_ = port_count;
+  from_port_arc_sets_.assign(port_count, nullptr);
+  to_port_arc_sets_.assign(port_count, nullptr);
+  port_pair_arc_sets_.clear();
+  for (auto port_sets : timing_arc_set_from_map_) {
+    int index = port_sets.first->pinIndex();
+    if (index >= 0 && index < port_count)
+      from_port_arc_sets_[index] = port_sets.second;
+  }
+  for (auto port_sets : timing_arc_set_to_map_) {
+    int index = port_sets.first->pinIndex();
+    if (index >= 0 && index < port_count)
+      to_port_arc_sets_[index] = port_sets.second;
+  }
+  if (port_count <= port_pair_table_max_ports) {
+    port_pair_arc_sets_.assign(port_count * port_count, nullptr);
+    for (auto port_pair_sets : port_timing_arc_set_map_) {
+      const LibertyPortPair &port_pair = port_pair_sets.first;
+      int from_index = port_pair.first->pinIndex();
+      int to_index = port_pair.second->pinIndex();
+      if (from_index >= 0 && from_index < port_count
+	  && to_index >= 0 && to_index < port_count)
+	port_pair_arc_sets_[from_index * port_count + to_index] =
+	  port_pair_sets.second;
+    }
+  }
 }
 
 TimingArcSetSeq *
@@ -1295,17 +1588,54 @@ LibertyCell::timingArcSets(const LibertyPort *from,
 			   const LibertyPort *to) const
 {
   if (from && to) {
+    int from_index = from->pinIndex();
+    int to_index = to->pinIndex();
+    if (!port_pair_arc_sets_.empty()
+	&& from_index >= 0 && from_index < table_port_count_
+	&& to_index >= 0 && to_index < table_port_count_) {
+      TimingArcSetSeq *sets =
+	port_pair_arc_sets_[from_index * table_port_count_ + to_index];
+      // Ports of another cell with the same index do not match.
+      if (sets
+	  && (*sets)[0]->from() == from
+	  && (*sets)[0]->to() == to)
+	return sets;
+      else
+	return nullptr;
+    }
     LibertyPortPair port_pair(from, to);
     return port_timing_arc_set_map_.findKey(port_pair);
   }
   else if (from)
-    return timing_arc_set_from_map_.findKey(from);
+    return portTimingArcSets(from, from_port_arc_sets_,
+			     timing_arc_set_from_map_);
   else if (to)
-    return timing_arc_set_to_map_.findKey(to);
+    return portTimingArcSets(to, to_port_arc_sets_,
+			     timing_arc_set_to_map_);
   else
     return nullptr;
 }
 
+TimingArcSetSeq *
+LibertyCell::portTimingArcSets(const LibertyPort *port,
+			       const Vector<TimingArcSetSeq*> &table,
+			       const LibertyPortTimingArcMap &map) const
+{
+  int index = port->pinIndex();
+  if (index >= 0 && index < static_cast<int>(table.size())) {
+    TimingArcSetSeq *sets = table[index];
+    if (sets) {
+      TimingArcSet *arc_set = (*sets)[0];
+      // Ports of another cell with the same index do not match.
+      if (arc_set->from() == port || arc_set->to() == port)
+	return sets;
+    }
+    return nullptr;
+  }
+  else
+    return map.findKey(port);
+}
+
 TimingArcSet *
 LibertyCell::findTimingArcSet(TimingArcSet *key) const
 {
@@ -1327,8 +1657,8 @@ LibertyCell::timingArcSetCount() const
 bool
 LibertyCell::hasTimingArcs(LibertyPort *port) const
 {
-  return timing_arc_set_from_map_.findKey(port)
-    || timing_arc_set_to_map_.findKey(port);
+  return timingArcSets(port, nullptr)
+    || timingArcSets(nullptr, port);
 }
 
 void
@@ -1559,6 +1889,19 @@ LibertyCellTimingArcSetIterator::LibertyCellTimingArcSetIterator(const LibertyCe
   
 ////////////////////////////////////////////////////////////////
 
+ClkGatingFunc::ClkGatingFunc(LibertyPort *gclk_port,
+			     LibertyPort *enable_port,
+			     LibertyPort *clk_port,
+			     LogicValue active_value) :
+  gclk_port_(gclk_port),
+  enable_port_(enable_port),
+  clk_port_(clk_port),
+  active_value_(active_value)
+{
+}
+
+////////////////////////////////////////////////////////////////
+
 // Latch enable port/function for a latch D->Q timing arc set.
 class LatchEnable
 {
@@ -1855,6 +2198,8 @@ LibertyPort::LibertyPort(LibertyCell *cell,
   liberty_cell_(cell),
   function_(nullptr),
   tristate_enable_(nullptr),
+  function_table_(nullptr),
+  tristate_enable_table_(nullptr),
   scaled_ports_(nullptr),
   // capacitance_ intentionally not initialized so
   // liberty reader can apply default capacitance.
@@ -1884,6 +2229,8 @@ LibertyPort::~LibertyPort()
     function_->deleteSubexprs();
   if (tristate_enable_)
     tristate_enable_->deleteSubexprs();
+  delete function_table_;
+  delete tristate_enable_table_;
   delete scaled_ports_;
   stringDelete(related_ground_pin_);
   stringDelete(related_power_pin_);
@@ -1984,6 +2331,7 @@ void
 LibertyPort::setFunction(FuncExpr *func)
 {
   function_ = func;
+  makeFuncTruthTables();
   if (is_bus_ || is_bundle_) {
     LibertyPortMemberIterator member_iter(this);
     int bit_offset = 0;
@@ -2000,6 +2348,7 @@ void
 LibertyPort::setTristateEnable(FuncExpr *enable)
 {
   tristate_enable_ = enable;
+  makeFuncTruthTables();
   if (hasMembers()) {
     LibertyPortMemberIterator member_iter(this);
     while (member_iter.hasNext()) {
@@ -2011,6 +2360,17 @@ LibertyPort::setTristateEnable(FuncExpr *enable)
   }
 }
 
+void
+LibertyPort::makeFuncTruthTables()
+{
+  delete function_table_;
+  function_table_ = function_ ? FuncTruthTable::make(function_) : nullptr;
+  delete tristate_enable_table_;
+  tristate_enable_table_ = tristate_enable_
+    ? FuncTruthTable::make(tristate_enable_)
+    : nullptr;
+}
+
 void
 LibertyPort::slewLimit(const MinMax *min_max,
 		       // Return values.
@@ -2215,6 +2575,8 @@ void
 LibertyPort::setIsPllFeedbackPin(bool is_pll_feedback_pin)
 {
   is_pll_feedback_pin_ = is_pll_feedback_pin;
+  if (is_pll_feedback_pin)
+    LibertyLibrary::found_pll_feedback_pins_ = true;
 }
 
 void
@@ -17,6 +17,7 @@
 #ifndef STA_LIBERTY_H
 #define STA_LIBERTY_H
 
+#include <mutex>
 #include "DisallowCopyAssign.hh"
 #include "Transition.hh"
 #include "MinMax.hh"
@@ -36,6 +37,7 @@ class ModeValueDef;
 class TestCell;
 class PatternMatch;
 class LatchEnable;
+class ClkGatingFunc;
 class Report;
 class Debug;
 class LibertyBuilder;
@@ -44,6 +46,8 @@ class OcvDerate;
 class TimingArcAttrs;
 class InternalPowerAttrs;
 class LibertyPgPort;
+class MemoryReport;
+class ThreadPool;
 
 typedef Set<Library*> LibrarySet;
 typedef Map<const char*, TableTemplate*, CharPtrLess> TableTemplateMap;
@@ -71,9 +75,31 @@ typedef Vector<TimingArcAttrs*> TimingArcAttrsSeq;
 typedef Vector<InternalPowerAttrs*> InternalPowerAttrsSeq;
 typedef Map<const char *, float, CharPtrLess> SupplyVoltageMap;
 typedef Map<const char *, LibertyPgPort*, CharPtrLess> LibertyPgPortMap;
+typedef Vector<ClkGatingFunc> ClkGatingFuncSeq;
 
 enum class ClockGateType { none, latch_posedge, latch_negedge, other };
 
+// Output gclk_port function that gates clk_port with enable_port.
+// The clock passes when the enable is active_value.
+class ClkGatingFunc
+{
+public:
+  ClkGatingFunc(LibertyPort *gclk_port,
+		LibertyPort *enable_port,
+		LibertyPort *clk_port,
+		LogicValue active_value);
+  LibertyPort *gclkPort() const { return gclk_port_; }
+  LibertyPort *enablePort() const { return enable_port_; }
+  LibertyPort *clkPort() const { return clk_port_; }
+  LogicValue activeValue() const { return active_value_; }
+
+protected:
+  LibertyPort *gclk_port_;
+  LibertyPort *enable_port_;
+  LibertyPort *clk_port_;
+  LogicValue active_value_;
+};
+
 enum class DelayModelType { cmos_linear, cmos_pwl, cmos2, table, polynomial, dcm };
 
 enum class ScaleFactorPvt { process, volt, temp, count, unknown };
@@ -109,6 +135,29 @@ timingSenseString(TimingSense sense);
 TimingSense
 timingSenseOpposite(TimingSense sense);
 
+// Makes the cells of a library the first time they are referenced
+// by name instead of when the library is read.
+class LibertyCellLoader
+{
+public:
+  LibertyCellLoader() {}
+  virtual ~LibertyCellLoader() {}
+  // Make the cell named name if it has not been made already.
+  virtual void loadCell(const char *name) = 0;
+  // Make the cells with names matching pattern.
+  virtual void loadCellsMatching(const PatternMatch *pattern) = 0;
+  // The library is used for corner analysis point ap_index so
+  // cells that are loaded later are added to the corner map.
+  virtual void addCornerIndex(int ap_index) = 0;
+  // Held while cells are loaded and while the library cells are
+  // found, so the cells of the library can be found from multiple
+  // threads. Loads and finds nest, so the lock is recursive.
+  virtual std::recursive_mutex &lock() = 0;
+
+private:
+  DISALLOW_COPY_AND_ASSIGN(LibertyCellLoader);
+};
+
 class LibertyLibrary : public ConcreteLibrary
 {
 public:
@@ -118,8 +167,19 @@ public:
   LibertyCell *findLibertyCell(const char *name) const;
   void findLibertyCellsMatching(PatternMatch *pattern,
 				LibertyCellSeq *cells);
+  // Load cells on demand when they are found by name.
+  virtual ConcreteCell *findCell(const char *name) const;
+  virtual void findCellsMatching(const PatternMatch *pattern,
+				 CellSeq *cells) const;
+  // Cells that have not been referenced are not made until they are
+  // found by name. Iterators only see the cells that have been made.
+  // The library owns the loader.
+  void setCellLoader(LibertyCellLoader *loader);
+  LibertyCellLoader *cellLoader() const { return cell_loader_; }
   // Liberty cells that are buffers.
   LibertyCellSeq *buffers();
+  // Report estimated cell and timing table memory usage.
+  void reportMemory(MemoryReport &memory) const;
 
   DelayModelType delayModelType() const { return delay_model_type_; }
   void setDelayModelType(DelayModelType type);
@@ -262,6 +322,12 @@ public:
 		     float &voltage,
 		     bool &exists) const;
 
+  // Find the equivalent cells of the library if they have not been
+  // found. Otherwise they are found serially on first use.
+  void findEquivCells(ThreadPool *thread_pool);
+  // True if any library has is_pll_feedback_pin ports.
+  static bool foundPllFeedbackPins() { return found_pll_feedback_pins_; }
+
   // Make scaled cell.  Call LibertyCell::addScaledCell after it is complete.
   LibertyCell *makeScaledCell(const char *name,
 			      const char *filename);
@@ -332,9 +398,12 @@ protected:
   SupplyVoltageMap supply_voltage_map_;
   bool found_equiv_cells_;
   LibertyCellSeq *buffers_;
+  LibertyCellLoader *cell_loader_;
 
   // Set if any library has rise/fall capacitances.
   static bool found_rise_fall_caps_;
+  // Set if any library has PLL feedback pins.
+  static bool found_pll_feedback_pins_;
   static constexpr float input_threshold_default_ = .5;
   static constexpr float output_threshold_default_ = .5;
   static constexpr float slew_lower_threshold_default_ = .2;
@@ -345,6 +414,7 @@ private:
 
   friend class LibertyCell;
   friend class LibertyCellIterator;
+  friend class LibertyPort;
   friend class TableTemplateIterator;
   friend class OperatingConditionsIterator;
 };
@@ -503,6 +573,9 @@ public:
   void bufferPorts(// Return values.
 		   LibertyPort *&input,
 		   LibertyPort *&output);
+  // AND/OR type output functions that gate a clock input with an
+  // enable input (inferred clock gating checks).
+  const ClkGatingFuncSeq &clkGatingFuncs() const { return clk_gating_funcs_; }
 
 protected:
   virtual void addPort(ConcretePort *port);
@@ -521,11 +594,23 @@ protected:
 			       TimingArcSet *setup_check,
 			       Debug *debug);
   void findDefaultCondArcs();
+  void makeFuncTruthTables();
+  void makeClkGatingFuncs();
+  void isClkGatingFunc(FuncExpr *func,
+		       LibertyPort *enable_port,
+		       LibertyPort *clk_port,
+		       // Return values.
+		       bool &is_clk_gate,
+		       LogicValue &logic_value) const;
   virtual void translatePresetClrCheckRoles();
   virtual void inferLatchRoles(Debug *debug);
   void deleteInternalPowerAttrs();
   void makeTimingArcMap(Report *report);
   void makeTimingArcPortMaps();
+  void makeTimingArcPortTables();
+  TimingArcSetSeq *portTimingArcSets(const LibertyPort *port,
+				     const Vector<TimingArcSetSeq*> &table,
+				     const LibertyPortTimingArcMap &map) const;
   bool hasBufferFunc(const LibertyPort *input,
 		     const LibertyPort *output) const;
 
@@ -542,6 +627,13 @@ protected:
   LibertyPortPairTimingArcMap port_timing_arc_set_map_;
   LibertyPortTimingArcMap timing_arc_set_from_map_;
   LibertyPortTimingArcMap timing_arc_set_to_map_;
+  // Dense versions of the port timing arc maps indexed by port pinIndex.
+  // The from/to pair table is from_index * table_port_count_ + to_index
+  // and is empty for cells with more than port_pair_table_max_ports ports.
+  int table_port_count_;
+  Vector<TimingArcSetSeq*> port_pair_arc_sets_;
+  Vector<TimingArcSetSeq*> from_port_arc_sets_;
+  Vector<TimingArcSetSeq*> to_port_arc_sets_;
   TimingArcAttrsSeq timing_arc_attrs_;
   bool has_infered_reg_timing_arcs_;
   InternalPowerSeq internal_powers_;
@@ -560,6 +652,7 @@ protected:
   LatchEnableMap latch_check_map_;
   // Ports that have latch D->Q timing arc sets from them.
   LibertyPortSet latch_data_ports_;
+  ClkGatingFuncSeq clk_gating_funcs_;
   float ocv_arc_depth_;
   OcvDerate *ocv_derate_;
   OcvDerateMap ocv_derate_map_;
@@ -674,6 +767,14 @@ public:
   FuncExpr *tristateEnable() const { return tristate_enable_; }
   void setTristateEnable(FuncExpr *enable);
   FuncExpr *&tristateEnableRef() { return tristate_enable_; }
+  // Truth tables for function and tristateEnable for constant
+  // propagation (nullptr if the function has too many inputs).
+  const FuncTruthTable *functionTruthTable() const { return function_table_; }
+  const FuncTruthTable *tristateEnableTruthTable() const
+  { return tristate_enable_table_; }
+  // Call after function or tristateEnable are changed through
+  // functionRef or tristateEnableRef.
+  void makeFuncTruthTables();
   void slewLimit(const MinMax *min_max,
 		 // Return values.
 		 float &limit,
@@ -766,6 +867,8 @@ protected:
   LibertyCell *liberty_cell_;
   FuncExpr *function_;
   FuncExpr *tristate_enable_;
+  FuncTruthTable *function_table_;
+  FuncTruthTable *tristate_enable_table_;
   ScaledPortMap *scaled_ports_;
   RiseFallMinMax capacitance_;
   MinMaxFloatValues slew_limit_; // inputs and outputs
@@ -0,0 +1,588 @@
+// OpenSTA, Static Timing Analyzer
+// Copyright (c) 2019, Parallax Software, Inc.
+// 
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+// 
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+// 
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+
+#include <stdio.h>
+#include <string.h>
+#include <stdint.h>
+#include "Machine.hh"
+#include "Report.hh"
+#include "Error.hh"
+#include "StringUtil.hh"
+#include "UnorderedMap.hh"
+#include "LibertyCache.hh"
+
+namespace sta {
+
+// Bump the version when the record encoding changes.
+static const uint32_t liberty_cache_version = 1;
+static const char liberty_cache_magic[] = "OpenSTA liberty cache";
+// Written in native byte order to reject caches from other machines.
+static const uint32_t liberty_cache_byte_order = 0x01020304;
+
+enum class LibertyCacheOp { end,
+			    group_begin,
+			    group_end,
+			    simple_attr,
+			    complex_attr,
+			    variable };
+
+enum class LibertyCacheValue { null, float_value, string_value };
+
+// Record the parser statement stream.
+// Strings are written inline the first time they are seen and
+// referenced by index after that.
+class LibertyCacheWriter : public LibertyGroupVisitor
+{
+public:
+  explicit LibertyCacheWriter(const char *cache_filename);
+  virtual ~LibertyCacheWriter();
+  void writeHeader(const char *liberty_filename);
+  void writeEnd();
+  virtual void begin(LibertyGroup *group);
+  virtual void end(LibertyGroup *group);
+  virtual void visitAttr(LibertyAttr *attr);
+  virtual void visitVariable(LibertyVariable *variable);
+  virtual bool save(LibertyGroup *) { return false; }
+  virtual bool save(LibertyAttr *) { return false; }
+  virtual bool save(LibertyVariable *) { return false; }
+
+private:
+  DISALLOW_COPY_AND_ASSIGN(LibertyCacheWriter);
+
+  void writeOp(LibertyCacheOp op);
+  void writeVarint(size_t value);
+  void writeFloat(float value);
+  void writeString(const char *str);
+  void writeValue(LibertyAttrValue *value);
+  void writeValues(LibertyAttrValueSeq *values);
+
+  FILE *stream_;
+  UnorderedMap<std::string, size_t> string_ids_;
+};
+
+void
+writeLibertyCache(const char *filename,
+		  const char *cache_filename,
+		  Report *report)
+{
+  LibertyCacheWriter writer(cache_filename);
+  writer.writeHeader(filename);
+  parseLibertyFile(filename, &writer, nullptr, false, report);
+  writer.writeEnd();
+}
+
+bool
+isLibertyCache(const char *filename)
+{
+  FILE *stream = fopen(filename, "rb");
+  if (stream) {
+    char magic[sizeof(liberty_cache_magic)];
+    size_t length = fread(magic, 1, sizeof(magic), stream);
+    fclose(stream);
+    return length == sizeof(magic)
+      && memcmp(magic, liberty_cache_magic, sizeof(magic)) == 0;
+  }
+  else
+    return false;
+}
+
+LibertyCacheWriter::LibertyCacheWriter(const char *cache_filename) :
+  LibertyGroupVisitor()
+{
+  stream_ = fopen(cache_filename, "wb");
+  if (stream_ == nullptr)
+    throw FileNotWritable(cache_filename);
+}
+
+LibertyCacheWriter::~LibertyCacheWriter()
+{
+  fclose(stream_);
+}
+
+void
+LibertyCacheWriter::writeHeader(const char *liberty_filename)
+{
+  fwrite(liberty_cache_magic, sizeof(liberty_cache_magic), 1, stream_);
+  fwrite(&liberty_cache_version, sizeof(liberty_cache_version), 1, stream_);
+  fwrite(&liberty_cache_byte_order, sizeof(liberty_cache_byte_order), 1,
+	 stream_);
+  writeString(liberty_filename);
+}
+
+void
+LibertyCacheWriter::writeEnd()
+{
+  writeOp(LibertyCacheOp::end);
+}
+
+void
+LibertyCacheWriter::begin(LibertyGroup *group)
+{
+  writeOp(LibertyCacheOp::group_begin);
+  writeString(group->type());
+  writeVarint(group->line());
+  writeValues(group->params());
+}
+
+void
+LibertyCacheWriter::end(LibertyGroup *)
+{
+  writeOp(LibertyCacheOp::group_end);
+}
+
+void
+LibertyCacheWriter::visitAttr(LibertyAttr *attr)
+{
+  if (attr->isSimple()) {
+    writeOp(LibertyCacheOp::simple_attr);
+    writeString(attr->name());
+    writeVarint(attr->line());
+    writeValue(attr->firstValue());
+  }
+  else {
+    writeOp(LibertyCacheOp::complex_attr);
+    writeString(attr->name());
+    writeVarint(attr->line());
+    writeValues(attr->values());
+  }
+}
+
+void
+LibertyCacheWriter::visitVariable(LibertyVariable *variable)
+{
+  writeOp(LibertyCacheOp::variable);
+  writeString(variable->variable());
+  writeVarint(variable->line());
+  writeFloat(variable->value());
+}
+
+void
+LibertyCacheWriter::writeOp(LibertyCacheOp op)
+{
+  putc(static_cast<int>(op), stream_);
+}
+
+void
+LibertyCacheWriter::writeVarint(size_t value)
+{
+  while (value >= 0x80) {
+    putc((value & 0x7f) | 0x80, stream_);
+    value >>= 7;
+  }
+  putc(value, stream_);
+}
+
+void
+LibertyCacheWriter::writeFloat(float value)
+{
+  fwrite(&value, sizeof(value), 1, stream_);
+}
+
+void
+LibertyCacheWriter::writeString(const char *str)
+{
+  auto id_iter = string_ids_.find(str);
+  if (id_iter == string_ids_.end()) {
+    // Index 0 marks an inline string definition.
+    size_t id = string_ids_.size();
+    string_ids_[str] = id;
+    size_t length = strlen(str);
+    writeVarint(0);
+    writeVarint(length);
+    // Include the terminator so the reader can use the mapped string.
+    fwrite(str, length + 1, 1, stream_);
+  }
+  else
+    writeVarint(id_iter->second + 1);
+}
+
+void
+LibertyCacheWriter::writeValue(LibertyAttrValue *value)
+{
+  if (value == nullptr)
+    putc(static_cast<int>(LibertyCacheValue::null), stream_);
+  else if (value->isFloat()) {
+    putc(static_cast<int>(LibertyCacheValue::float_value), stream_);
+    writeFloat(value->floatValue());
+  }
+  else {
+    putc(static_cast<int>(LibertyCacheValue::string_value), stream_);
+    writeString(value->stringValue());
+  }
+}
+
+void
+LibertyCacheWriter::writeValues(LibertyAttrValueSeq *values)
+{
+  // Count + 1 so that 0 is a null sequence.
+  if (values) {
+    writeVarint(values->size() + 1);
+    for (auto value : *values)
+      writeValue(value);
+  }
+  else
+    writeVarint(0);
+}
+
+////////////////////////////////////////////////////////////////
+
+LibertyCacheReader::LibertyCacheReader(const char *cache_filename) :
+  filename_(cache_filename),
+  file_(cache_filename),
+  data_(file_.data()),
+  size_(file_.size()),
+  next_(nullptr),
+  end_(nullptr),
+  valid_(false),
+  error_(false),
+  liberty_filename_(nullptr),
+  string_next_(0)
+{
+  next_ = data_;
+  end_ = data_ + size_;
+  readHeader();
+}
+
+LibertyCacheReader::~LibertyCacheReader()
+{
+}
+
+void
+LibertyCacheReader::readHeader()
+{
+  size_t header_size = sizeof(liberty_cache_magic)
+    + sizeof(liberty_cache_version)
+    + sizeof(liberty_cache_byte_order);
+  if (size_ >= header_size
+      && memcmp(next_, liberty_cache_magic, sizeof(liberty_cache_magic)) == 0) {
+    next_ += sizeof(liberty_cache_magic);
+    uint32_t version, byte_order;
+    memcpy(&version, next_, sizeof(version));
+    next_ += sizeof(version);
+    memcpy(&byte_order, next_, sizeof(byte_order));
+    next_ += sizeof(byte_order);
+    if (version == liberty_cache_version
+	&& byte_order == liberty_cache_byte_order) {
+      liberty_filename_ = readString();
+      valid_ = !error_;
+    }
+  }
+}
+
+bool
+LibertyCacheReader::visit(LibertyGroupVisitor *visitor)
+{
+  return visitRecords(visitor, nullptr, false);
+}
+
+bool
+LibertyCacheReader::visitDeferCells(LibertyGroupVisitor *visitor,
+				    // Return value.
+				    LibertyCacheGroupSeq &deferred)
+{
+  return visitRecords(visitor, &deferred, false);
+}
+
+bool
+LibertyCacheReader::visitGroup(LibertyGroupVisitor *visitor,
+			       const LibertyCacheGroup &group)
+{
+  const char *next = next_;
+  size_t string_next = string_next_;
+  next_ = data_ + group.offset;
+  string_next_ = group.string_index;
+  bool success = visitRecords(visitor, nullptr, true);
+  next_ = next;
+  string_next_ = string_next;
+  return success;
+}
+
+bool
+LibertyCacheReader::visitRecords(LibertyGroupVisitor *visitor,
+				 LibertyCacheGroupSeq *deferred,
+				 bool one_group)
+{
+  LibertyGroupSeq group_stack;
+  bool done = false;
+  while (!error_ && !done) {
+    size_t offset = next_ - data_;
+    size_t string_index = string_next_;
+    LibertyCacheOp op = static_cast<LibertyCacheOp>(readByte());
+    if (error_ || op == LibertyCacheOp::end)
+      break;
+    switch (op) {
+    case LibertyCacheOp::group_begin: {
+      const char *type = readString();
+      int line = readVarint();
+      if (deferred
+	  && group_stack.size() == 1
+	  && (stringEq(type, "cell") || stringEq(type, "scaled_cell"))) {
+	const char *name = skipValues();
+	skipGroup();
+	if (name && !error_)
+	  deferred->push_back({type, name, offset, string_index});
+	break;
+      }
+      LibertyAttrValueSeq *params = readValues();
+      if (!error_) {
+	LibertyGroup *group = new LibertyGroup(stringCopy(type), params, line);
+	visitor->begin(group);
+	group_stack.push_back(group);
+      }
+      break;
+    }
+    case LibertyCacheOp::group_end: {
+      if (group_stack.empty())
+	error_ = true;
+      else {
+	LibertyGroup *group = group_stack.back();
+	visitor->end(group);
+	group_stack.pop_back();
+	LibertyGroup *parent =
+	  group_stack.empty() ? nullptr : group_stack.back();
+	if (parent && visitor->save(group))
+	  parent->addSubgroup(group);
+	else
+	  delete group;
+	done = one_group && group_stack.empty();
+      }
+      break;
+    }
+    case LibertyCacheOp::simple_attr:
+    case LibertyCacheOp::complex_attr: {
+      const char *name = readString();
+      int line = readVarint();
+      LibertyAttr *attr = nullptr;
+      if (op == LibertyCacheOp::simple_attr) {
+	LibertyAttrValue *value = readValue();
+	if (!error_)
+	  attr = new LibertySimpleAttr(stringCopy(name), value, line);
+      }
+      else {
+	LibertyAttrValueSeq *values = readValues();
+	if (!error_)
+	  attr = new LibertyComplexAttr(stringCopy(name), values, line);
+      }
+      if (attr) {
+	visitor->visitAttr(attr);
+	if (!group_stack.empty() && visitor->save(attr))
+	  group_stack.back()->addAttribute(attr);
+	else
+	  delete attr;
+      }
+      break;
+    }
+    case LibertyCacheOp::variable: {
+      const char *var = readString();
+      int line = readVarint();
+      float value = readFloat();
+      if (!error_) {
+	LibertyVariable *variable = new LibertyVariable(stringCopy(var),
+							value, line);
+	visitor->visitVariable(variable);
+	if (!visitor->save(variable))
+	  delete variable;
+      }
+      break;
+    }
+    default:
+      error_ = true;
+      break;
+    }
+  }
+  // Groups left open by a truncated cache.
+  group_stack.deleteContents();
+  return !error_ && group_stack.empty();
+}
+
+int
+LibertyCacheReader::readByte()
+{
+  if (next_ < end_)
+    return static_cast<unsigned char>(*next_++);
+  else {
+    error_ = true;
+    return 0;
+  }
+}
+
+size_t
+LibertyCacheReader::readVarint()
+{
+  size_t value = 0;
+  int shift = 0;
+  int byte;
+  do {
+    byte = readByte();
+    value |= static_cast<size_t>(byte & 0x7f) << shift;
+    shift += 7;
+  } while ((byte & 0x80) && !error_);
+  return value;
+}
+
+float
+LibertyCacheReader::readFloat()
+{
+  float value = 0.0;
+  if (next_ + sizeof(value) <= end_) {
+    memcpy(&value, next_, sizeof(value));
+    next_ += sizeof(value);
+  }
+  else
+    error_ = true;
+  return value;
+}
+
+const char *
+LibertyCacheReader::readString()
+{
+  size_t id = readVarint();
+  if (error_)
+    return "";
+  else if (id == 0) {
+    size_t length = readVarint();
+    if (!error_
+	&& length < static_cast<size_t>(end_ - next_)
+	&& next_[length] == '\0') {
+      const char *str = next_;
+      next_ += length + 1;
+      if (string_next_ == strings_.size())
+	strings_.push_back(str);
+      string_next_++;
+      return str;
+    }
+  }
+  else if (id <= strings_.size())
+    return strings_[id - 1];
+  error_ = true;
+  return "";
+}
+
+LibertyAttrValue *
+LibertyCacheReader::readValue()
+{
+  LibertyCacheValue type = static_cast<LibertyCacheValue>(readByte());
+  switch (type) {
+  case LibertyCacheValue::null:
+    return nullptr;
+  case LibertyCacheValue::float_value:
+    return new LibertyFloatAttrValue(readFloat());
+  case LibertyCacheValue::string_value:
+    return new LibertyStringAttrValue(stringCopy(readString()));
+  default:
+    error_ = true;
+    return nullptr;
+  }
+}
+
+// Skip the records of a group after the group_begin record.
+void
+LibertyCacheReader::skipGroup()
+{
+  int depth = 1;
+  while (depth > 0 && !error_) {
+    LibertyCacheOp op = static_cast<LibertyCacheOp>(readByte());
+    switch (op) {
+    case LibertyCacheOp::group_begin:
+      readString();
+      readVarint();
+      skipValues();
+      depth++;
+      break;
+    case LibertyCacheOp::group_end:
+      depth--;
+      break;
+    case LibertyCacheOp::simple_attr:
+      readString();
+      readVarint();
+      skipValue();
+      break;
+    case LibertyCacheOp::complex_attr:
+      readString();
+      readVarint();
+      skipValues();
+      break;
+    case LibertyCacheOp::variable:
+      readString();
+      readVarint();
+      readFloat();
+      break;
+    default:
+      error_ = true;
+      break;
+    }
+  }
+}
+
+// Return the value if it is a string.
+const char *
+LibertyCacheReader::skipValue()
+{
+  LibertyCacheValue type = static_cast<LibertyCacheValue>(readByte());
+  switch (type) {
+  case LibertyCacheValue::null:
+    return nullptr;
+  case LibertyCacheValue::float_value:
+    readFloat();
+    return nullptr;
+  case LibertyCacheValue::string_value:
+    return readString();
+  default:
+    error_ = true;
+    return nullptr;
+  }
+}
+
+// Return the first value if it is a string.
+const char *
+LibertyCacheReader::skipValues()
+{
+  const char *first = nullptr;
+  size_t count1 = readVarint();
+  for (size_t i = 0; i + 1 < count1 && !error_; i++) {
+    const char *str = skipValue();
+    if (i == 0)
+      first = str;
+  }
+  return first;
+}
+
+LibertyAttrValueSeq *
+LibertyCacheReader::readValues()
+{
+  size_t count1 = readVarint();
+  if (count1 == 0 || error_)
+    return nullptr;
+  else {
+    LibertyAttrValueSeq *values = new LibertyAttrValueSeq;
+    for (size_t i = 0; i < count1 - 1 && !error_; i++) {
+      LibertyAttrValue *value = readValue();
+      if (value)
+	values->push_back(value);
+      else
+	error_ = true;
+    }
+    if (error_) {
+      values->deleteContents();
+      delete values;
+      return nullptr;
+    }
+    return values;
+  }
+}
+
+} // namespace
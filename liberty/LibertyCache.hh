@@ -0,0 +1,123 @@
+// OpenSTA, Static Timing Analyzer
+// Copyright (c) 2019, Parallax Software, Inc.
+// 
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+// 
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+// 
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+
+#ifndef STA_LIBERTY_CACHE_H
+#define STA_LIBERTY_CACHE_H
+
+#include <stddef.h>  // size_t
+#include <string>
+#include "DisallowCopyAssign.hh"
+#include "Vector.hh"
+#include "MappedFile.hh"
+#include "LibertyParser.hh"
+
+namespace sta {
+
+class Report;
+
+// A liberty cache is a binary recording of the liberty parser
+// statement stream (groups, attributes and variables) with
+// interned strings and binary floats. Replaying the cache into a
+// LibertyGroupVisitor builds the same library as parsing the liberty
+// file without the lexer/parser overhead.
+// The cache format is machine dependent and versioned.
+
+// Parse liberty filename and write the cache to cache_filename.
+void
+writeLibertyCache(const char *filename,
+		  const char *cache_filename,
+		  Report *report);
+
+// True if filename starts with the liberty cache magic string.
+bool
+isLibertyCache(const char *filename);
+
+// Position of a group in a liberty cache that was skipped by
+// LibertyCacheReader::visitDeferCells.
+class LibertyCacheGroup
+{
+public:
+  // Group type and first name.
+  const char *type;
+  const char *name;
+  // Offset of the group record.
+  size_t offset;
+  // Index of the next string defined in the cache at the group.
+  size_t string_index;
+};
+
+typedef Vector<LibertyCacheGroup> LibertyCacheGroupSeq;
+
+// Memory maps a liberty cache file for replay.
+class LibertyCacheReader
+{
+public:
+  // Throws FileNotReadable if cache_filename cannot be read.
+  explicit LibertyCacheReader(const char *cache_filename);
+  ~LibertyCacheReader();
+  // True if the file is a cache with a compatible version.
+  bool isValid() const { return valid_; }
+  // Filename of the liberty file the cache was written from.
+  const char *libertyFilename() const { return liberty_filename_; }
+  // Replay the statements into visitor.
+  // Returns false if the cache is truncated or corrupt.
+  bool visit(LibertyGroupVisitor *visitor);
+  // visit without the cell and scaled_cell groups in the library.
+  // The skipped groups are appended to deferred so they can be
+  // replayed later with visitGroup. The reader must outlive deferred.
+  bool visitDeferCells(LibertyGroupVisitor *visitor,
+		       // Return value.
+		       LibertyCacheGroupSeq &deferred);
+  // Replay one group skipped by visitDeferCells.
+  bool visitGroup(LibertyGroupVisitor *visitor,
+		  const LibertyCacheGroup &group);
+
+private:
+  DISALLOW_COPY_AND_ASSIGN(LibertyCacheReader);
+
+  void readHeader();
+  bool visitRecords(LibertyGroupVisitor *visitor,
+		    LibertyCacheGroupSeq *deferred,
+		    bool one_group);
+  void skipGroup();
+  const char *skipValue();
+  const char *skipValues();
+  int readByte();
+  size_t readVarint();
+  float readFloat();
+  const char *readString();
+  LibertyAttrValue *readValue();
+  LibertyAttrValueSeq *readValues();
+
+  const char *filename_;
+  MappedFile file_;
+  const char *data_;
+  size_t size_;
+  const char *next_;
+  const char *end_;
+  bool valid_;
+  bool error_;
+  const char *liberty_filename_;
+  // Interned strings (pointers into data_).
+  Vector<const char*> strings_;
+  // Index of the next string defined in the cache. This is behind
+  // strings_.size() when a deferred group is replayed.
+  size_t string_next_;
+};
+
+} // namespace
+#endif
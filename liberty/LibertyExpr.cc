@@ -21,12 +21,17 @@
 #include "Liberty.hh"
 #include "LibertyExprPvt.hh"
 
-extern int
-LibertyExprParse_parse();
+// Global namespace
 
-namespace sta {
+int
+LibertyExprParse_parse(sta::LibExprParser *parser);
+int
+LibertyExprLex_lex_init_extra(sta::LibExprParser *parser,
+			      void **scanner);
+int
+LibertyExprLex_lex_destroy(void *scanner);
 
-LibExprParser *libexpr_parser;
+namespace sta {
 
 FuncExpr *
 parseFuncExpr(const char *func,
@@ -36,8 +41,7 @@ parseFuncExpr(const char *func,
 {
   if (func != nullptr && func[0] != '\0') {
     LibExprParser parser(func, cell, error_msg, report);
-    libexpr_parser = &parser;
-    LibertyExprParse_parse();
+    LibertyExprParse_parse(&parser);
     return parser.result();
   }
   else
@@ -55,12 +59,15 @@ LibExprParser::LibExprParser(const char *func,
   result_(nullptr),
   token_length_(100),
   token_(new char[token_length_]),
-  token_next_(token_)
+  token_next_(token_),
+  scanner_(nullptr)
 {
+  LibertyExprLex_lex_init_extra(this, &scanner_);
 }
 
 LibExprParser::~LibExprParser()
 {
+  LibertyExprLex_lex_destroy(scanner_);
   stringDelete(token_);
 }
 
@@ -184,9 +191,9 @@ LibExprParser::parseError(const char *msg)
 // Global namespace
 
 int
-LibertyExprParse_error(const char *msg)
+LibertyExprParse_error(sta::LibExprParser *parser,
+		       const char *msg)
 {
-  sta::libexpr_parser->parseError(msg);
-  libertyExprFlushBuffer();
+  parser->parseError(msg);
   return 0;
 }
@@ -23,7 +23,6 @@
 #include "StringUtil.hh"
 #include "LibertyExprPvt.hh"
 
-using sta::libexpr_parser;
 using sta::stringCopy;
 using sta::FuncExpr;
 
@@ -32,13 +31,7 @@ using sta::FuncExpr;
 #define YY_NO_INPUT
 
 #define YY_INPUT(buf,result,max_size) \
-  result = libexpr_parser->copyInput(buf, max_size)
-
-void
-libertyExprFlushBuffer()
-{
-  YY_FLUSH_BUFFER;
-}
+  result = yyextra->copyInput(buf, max_size)
 
 %}
 
@@ -46,6 +39,8 @@ libertyExprFlushBuffer()
 %option noyywrap
 %option nounput
 %option never-interactive
+%option reentrant bison-bridge
+%option extra-type="sta::LibExprParser *"
 
 %x ESCAPED_STRING
 
@@ -59,28 +54,28 @@ EOL	\r?\n
 
 %%
 
-{OP}|{PAREN} { return ((int) LibertyExprLex_text[0]); }
+{OP}|{PAREN} { return ((int) yytext[0]); }
 
 {ESCAPE}{EOL} { /* I doubt that escaped returns get thru the parser */ }
 
-{ESCAPE}{QUOTE}	{ BEGIN(ESCAPED_STRING); libexpr_parser->tokenErase(); }
+{ESCAPE}{QUOTE}	{ BEGIN(ESCAPED_STRING); yyextra->tokenErase(); }
 
-<ESCAPED_STRING>. { libexpr_parser->tokenAppend(LibertyExprLex_text[0]); }
+<ESCAPED_STRING>. { yyextra->tokenAppend(yytext[0]); }
 
 <ESCAPED_STRING>{ESCAPE}{QUOTE} {
 	BEGIN(INITIAL);
-	LibertyExprParse_lval.string = libexpr_parser->tokenCopy();
+	yylval->string = yyextra->tokenCopy();
 	return PORT;
 	}
 
 {PORT}	{
-	LibertyExprParse_lval.string = stringCopy(LibertyExprLex_text);
+	yylval->string = stringCopy(yytext);
 	return PORT;
 	}
 
 {BLANK}	{}
 
 	/* Send out of bound characters to parser. */
-.	{ return (int) LibertyExprLex_text[0]; }
+.	{ return (int) yytext[0]; }
 
 %%
@@ -23,11 +23,12 @@
 #include "LibertyExpr.hh"
 #include "LibertyExprPvt.hh"
 
-int LibertyExprLex_lex();
-#define LibertyExprParse_lex LibertyExprLex_lex
-
 %}
 
+%define api.pure full
+%parse-param {sta::LibExprParser *parser}
+%lex-param {sta::LibExprParser *parser}
+
 %union {
   int int_val;
   const char *string;
@@ -43,18 +44,23 @@ int LibertyExprLex_lex();
 %type <string> PORT
 %type <expr> expr terminal terminal_expr implicit_and
 
-%{
-%}
+%code {
+int
+LibertyExprLex_lex(YYSTYPE *lvalp,
+		   void *scanner);
+#define LibertyExprParse_lex(lvalp, parser) \
+  LibertyExprLex_lex(lvalp, (parser)->scanner())
+}
 
 %%
 
 result_expr:
-	expr	{ sta::libexpr_parser->setResult($1); }
-|	expr ';'{ sta::libexpr_parser->setResult($1); }
+	expr	{ parser->setResult($1); }
+|	expr ';'{ parser->setResult($1); }
 ;
 
 terminal:
-	PORT		{ $$ = sta::libexpr_parser->makeFuncExprPort($1); }
+	PORT		{ $$ = parser->makeFuncExprPort($1); }
 |	'0'		{ $$ = sta::FuncExpr::makeZero(); }
 |	'1'		{ $$ = sta::FuncExpr::makeOne(); }
 |	'(' expr ')'	{ $$ = $2; }
@@ -62,25 +68,25 @@ terminal:
 
 terminal_expr:
 	terminal
-|	'!' terminal	{ $$ = sta::libexpr_parser->makeFuncExprNot($2); }
-|	terminal '\''	{ $$ = sta::libexpr_parser->makeFuncExprNot($1); }
+|	'!' terminal	{ $$ = parser->makeFuncExprNot($2); }
+|	terminal '\''	{ $$ = parser->makeFuncExprNot($1); }
 ;
 
 implicit_and:
 	terminal_expr terminal_expr
-	{ $$ = sta::libexpr_parser->makeFuncExprAnd($1, $2); }
+	{ $$ = parser->makeFuncExprAnd($1, $2); }
 |	implicit_and terminal_expr
-	{ $$ = sta::libexpr_parser->makeFuncExprAnd($1, $2); }
+	{ $$ = parser->makeFuncExprAnd($1, $2); }
 ;
 
 expr:
 	terminal_expr
 |	implicit_and
-|	expr '+' expr	{ $$ = sta::libexpr_parser->makeFuncExprOr($1, $3); }
-|	expr '|' expr	{ $$ = sta::libexpr_parser->makeFuncExprOr($1, $3); }
-|	expr '*' expr   { $$ = sta::libexpr_parser->makeFuncExprAnd($1, $3); }
-|	expr '&' expr   { $$ = sta::libexpr_parser->makeFuncExprAnd($1, $3); }
-|	expr '^' expr	{ $$ = sta::libexpr_parser->makeFuncExprXor($1, $3); }
+|	expr '+' expr	{ $$ = parser->makeFuncExprOr($1, $3); }
+|	expr '|' expr	{ $$ = parser->makeFuncExprOr($1, $3); }
+|	expr '*' expr   { $$ = parser->makeFuncExprAnd($1, $3); }
+|	expr '&' expr   { $$ = parser->makeFuncExprAnd($1, $3); }
+|	expr '^' expr	{ $$ = parser->makeFuncExprXor($1, $3); }
 ;
 
 %%
@@ -33,6 +33,8 @@ public:
 		const char *error_msg,
 		Report *report);
   ~LibExprParser();
+  // Reentrant flex scanner state.
+  void *scanner() { return scanner_; }
   FuncExpr *makeFuncExprPort(const char *port_name);
   FuncExpr *makeFuncExprOr(FuncExpr *arg1,
 			   FuncExpr *arg2);
@@ -63,17 +65,15 @@ private:
   size_t token_length_;
   char *token_;
   char *token_next_;
+  void *scanner_;
 };
 
-extern LibExprParser *libexpr_parser;
-
 } // namespace
 
 // Global namespace
 
-void
-libertyExprFlushBuffer();
 int
-LibertyExprParse_error(const char *msg);
+LibertyExprParse_error(sta::LibExprParser *parser,
+		       const char *msg);
 
 #endif
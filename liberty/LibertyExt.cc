@@ -45,6 +45,7 @@ using sta::LibertyBuilder;
 using sta::TimingRole;
 using sta::TimingArcAttrs;
 using sta::Sta;
+using sta::StringSet;
 using sta::stringCopy;
 
 // LibertyCell with Bigco thingy variable.
@@ -248,6 +249,7 @@ public:
 protected:
   virtual LibertyLibrary *readLibertyFile(const char *filename, 
 					  bool infer_latches,
+					  const StringSet *skip_groups,
 					  Report *report,
 					  Debug *debug,
 					  Network *network);
@@ -262,12 +264,14 @@ BigcoSta::BigcoSta() :
 LibertyLibrary *
 Sta::readLibertyFile(const char *filename,
 		bool infer_latches,
+		     const StringSet *skip_groups,
 		     Report *report,
 		     Debug *debug,
 		     Network *network)
 {
   BigcoLibertyBuilder builder;
   BigcoLibertyReader reader(&builder);
+  reader.setSkipGroups(skip_groups);
   return reader.readLibertyFile(filename, infer_latches, 
 				report, debug, network);
 }
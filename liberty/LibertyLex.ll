@@ -23,6 +23,9 @@
 
 #define YY_NO_INPUT
 
+#define YY_INPUT(buf,result,max_size) \
+  result = yyextra->getChars(buf, max_size)
+
 #if defined(YY_FLEX_MAJOR_VERSION) \
     && defined(YY_FLEX_MINOR_VERSION) \
     && YY_FLEX_MAJOR_VERSION >=2 \
@@ -33,23 +36,20 @@
  #define INCLUDE_SUPPORTED
 #endif
 
-static std::string string_buf;
-
-void
-libertyParseFlushBuffer()
-{
-  YY_FLUSH_BUFFER;
-}
-
 %}
 
 /* %option debug */
 %option noyywrap
 %option nounput
 %option never-interactive
+%option reentrant bison-bridge
+%option extra-type="sta::LibertyParser *"
 
 %x comment
 %x qstring
+%x skip_group
+%x skip_comment
+%x skip_qstring
 
 DIGIT [0-9]
 ALPHA [a-zA-Z]
@@ -77,20 +77,19 @@ TOKEN_END {PUNCTUATION}|[ \t\r\n]
 EOL \r?\n
 %%
 
-{PUNCTUATION} { return ((int) LibertyLex_text[0]); }
+{PUNCTUATION} { return ((int) yytext[0]); }
 
 {FLOAT}{TOKEN_END} {
 	/* Push back the TOKEN_END character. */
-	yyless(LibertyLex_leng - 1);
-	LibertyParse_lval.number = static_cast<float>(strtod(LibertyLex_text,
-	                                                     NULL));
+	yyless(yyleng - 1);
+	yylval->number = static_cast<float>(strtod(yytext, NULL));
 	return FLOAT;
 	}
 
 {ALPHA}({ALPHA}|_|{DIGIT})*{TOKEN_END} {
 	/* Push back the TOKEN_END character. */
-	yyless(LibertyLex_leng - 1);
-	LibertyParse_lval.string = sta::stringCopy(LibertyLex_text);
+	yyless(yyleng - 1);
+	yylval->string = sta::stringCopy(yytext);
 	return KEYWORD;
 	}
 
@@ -102,17 +101,17 @@ EOL \r?\n
 {BUS_STYLE}{TOKEN_END} |
 {TOKEN}{TOKEN_END} {
 	/* Push back the TOKEN_END character. */
-	yyless(LibertyLex_leng - 1);
-	LibertyParse_lval.string = sta::stringCopy(LibertyLex_text);
+	yyless(yyleng - 1);
+	yylval->string = sta::stringCopy(yytext);
 	return STRING;
 	}
 
-\\?{EOL} { sta::libertyIncrLine(); }
+\\?{EOL} { yyextra->incrLine(); }
 
 "include_file"[ \t]*"(".+")"[ \t]*";"? {
 #ifdef INCLUDE_SUPPORTED
-	if (sta::libertyInInclude())
-	  sta::libertyParseError("nested include_file's are not supported\n");
+	if (yyextra->inInclude())
+	  yyextra->parseError("nested include_file's are not supported\n");
 	else {
 	  char *filename = &yytext[strlen("include_file")];
 	  /* Skip blanks between include_file and '('. */
@@ -125,21 +124,22 @@ EOL \r?\n
 	    filename++;
 	  char *filename_end = strpbrk(filename, ")");
 	  if (filename_end == NULL)
-	    sta::libertyParseError("include_file missing ')'\n");
+	    yyextra->parseError("include_file missing ')'\n");
 	  else {
 	    /* Trim trailing blanks. */
 	    while (isspace(filename_end[-1]) && filename_end > filename)
 	      filename_end--;
 	    *filename_end = '\0';
-	    FILE *stream = sta::libertyIncludeBegin(filename);
-	    if (stream) {
-	      yypush_buffer_state(yy_create_buffer(stream, YY_BUF_SIZE));
+	    if (yyextra->includeBegin(filename)) {
+	      /* Input comes from LibertyParser::getChars, not a FILE. */
+	      yypush_buffer_state(yy_create_buffer(NULL, YY_BUF_SIZE, yyscanner),
+				  yyscanner);
 	      BEGIN(INITIAL);
 	    }
 	  }
 	}
 #else
-	sta::libertyParseError("include_file is not supported.\n");
+	yyextra->parseError("include_file is not supported.\n");
 #endif
 }
 
@@ -148,58 +148,89 @@ EOL \r?\n
 	/* Straight out of the flex man page. */
 <comment>[^*\r\n]*		/* eat anything that's not a '*' */
 <comment>"*"+[^*/\r\n]*		/* eat up '*'s not followed by '/'s */
-<comment>{EOL}	sta::libertyIncrLine();
+<comment>{EOL}	yyextra->incrLine();
 <comment>"*"+"/" BEGIN(INITIAL);
 
 \"	{
-	string_buf.erase();
+	yyextra->stringBuf().erase();
 	BEGIN(qstring);
 	}
 
 <qstring>\" {
 	BEGIN(INITIAL);
-	LibertyParse_lval.string = sta::stringCopy(string_buf.c_str());
+	yylval->string = sta::stringCopy(yyextra->stringBuf().c_str());
 	return STRING;
 	}
 
 <qstring>{EOL} {
-	LibertyParse_error("unterminated string constant");
+	yyextra->parseError("unterminated string constant.\n");
 	BEGIN(INITIAL);
-	LibertyParse_lval.string = sta::stringCopy(string_buf.c_str());
+	yylval->string = sta::stringCopy(yyextra->stringBuf().c_str());
 	return STRING;
 	}
 
 <qstring>\\{EOL} {
 	/* Line continuation. */
-	sta::libertyIncrLine();
+	yyextra->incrLine();
 	}
 
 <qstring>\\. {
 	/* Escaped character. */
-	string_buf += '\\';
-	string_buf += LibertyLex_text[1];
+	yyextra->stringBuf() += '\\';
+	yyextra->stringBuf() += yytext[1];
 	}
 
 <qstring>[^\\\r\n\"]+ {
 	/* Anything but escape, return or double quote */
-	string_buf += LibertyLex_text;
+	yyextra->stringBuf() += yytext;
 	}
 
 <qstring><<EOF>> {
-	LibertyParse_error("unterminated string constant");
+	yyextra->parseError("unterminated string constant.\n");
 	BEGIN(INITIAL);
 	yyterminate();
 	}
 
+	/* Skipped group bodies are scanned for the matching '}' without
+	   making any tokens. */
+<skip_group>"{"	{ yyextra->incrSkipDepth(); }
+
+<skip_group>"}"	{
+	if (yyextra->decrSkipDepth() == 0) {
+	  BEGIN(INITIAL);
+	  return '}';
+	}
+	}
+
+<skip_group>"/*"	BEGIN(skip_comment);
+<skip_group>\"	BEGIN(skip_qstring);
+<skip_group>\\?{EOL}	{ yyextra->incrLine(); }
+<skip_group>[^{}\"/\\\r\n]+	{}
+<skip_group>.	{}
+
+<skip_comment>[^*\r\n]*	{}
+<skip_comment>"*"+[^*/\r\n]*	{}
+<skip_comment>{EOL}	{ yyextra->incrLine(); }
+<skip_comment>"*"+"/"	BEGIN(skip_group);
+
+<skip_qstring>\"	BEGIN(skip_group);
+<skip_qstring>\\{EOL}	{ yyextra->incrLine(); }
+<skip_qstring>{EOL} {
+	yyextra->incrLine();
+	BEGIN(skip_group);
+	}
+<skip_qstring>\\.	{}
+<skip_qstring>[^\\\r\n\"]+	{}
+
 {BLANK}* {}
 	/* Send out of bound characters to parser. */
-.	{ return (int) LibertyLex_text[0]; }
+.	{ return (int) yytext[0]; }
 
 <<EOF>> {
 #ifdef INCLUDE_SUPPORTED
-	if (sta::libertyInInclude()) {
-	  sta::libertyIncludeEnd();
-	  yypop_buffer_state();
+	if (yyextra->inInclude()) {
+	  yyextra->includeEnd();
+	  yypop_buffer_state(yyscanner);
 	}
 	else
 #endif
@@ -207,3 +238,14 @@ EOL \r?\n
 }
 
 %%
+
+namespace sta {
+
+void
+libertyLexSkipGroup(void *scanner)
+{
+  yyguts_t *yyg = static_cast<yyguts_t*>(scanner);
+  BEGIN(skip_group);
+}
+
+} // namespace
@@ -21,13 +21,15 @@
 #include "StringUtil.hh"
 #include "LibertyParser.hh"
 
-int LibertyLex_lex();
-#define LibertyParse_lex LibertyLex_lex
 // Use yacc generated parser errors.
 #define YYERROR_VERBOSE
 
 %}
 
+%define api.pure full
+%parse-param {sta::LibertyParser *parser}
+%lex-param {sta::LibertyParser *parser}
+
 %union {
   char *string;
   float number;
@@ -50,8 +52,13 @@ int LibertyLex_lex();
 
 %start file
 
-%{
-%}
+%code {
+int
+LibertyLex_lex(YYSTYPE *lvalp,
+	       void *scanner);
+#define LibertyParse_lex(lvalp, parser) \
+  LibertyLex_lex(lvalp, (parser)->scanner())
+}
 
 %%
 
@@ -60,26 +67,23 @@ file:
 	;
 
 group:
-	KEYWORD '(' ')' line '{'
-	{ sta::libertyGroupBegin($1, NULL, $4); }
-	'}' semi_opt
-	{ $$ = sta::libertyGroupEnd(); }
-|	KEYWORD '(' ')' line '{'
-	{ sta::libertyGroupBegin($1, NULL, $4); }
-	statements '}' semi_opt
-	{ $$ = sta::libertyGroupEnd(); }
-|	KEYWORD '(' attr_values ')' line '{'
-	{ sta::libertyGroupBegin($1, $3, $5); }
-	'}' semi_opt
-	{ $$ = sta::libertyGroupEnd(); }
-|	KEYWORD '(' attr_values ')' line '{'
-	{ sta::libertyGroupBegin($1, $3, $5); }
-	statements '}' semi_opt
-	{ $$ = sta::libertyGroupEnd(); }
+	group_begin '{' '}' semi_opt
+	{ $$ = parser->groupEnd(); }
+|	group_begin '{' statements '}' semi_opt
+	{ $$ = parser->groupEnd(); }
+	;
+
+/* Nested groups are begun with the '{' as the lookahead token (to tell
+   them from complex attributes) so the lexer can skip the group body. */
+group_begin:
+	KEYWORD '(' ')' line
+	{ parser->groupBegin($1, NULL, $4); }
+|	KEYWORD '(' attr_values ')' line
+	{ parser->groupBegin($1, $3, $5); }
 	;
 
 line: /* empty */
-	{ $$ = sta::libertyLine(); }
+	{ $$ = parser->line(); }
 	;
 
 statements:
@@ -96,7 +100,7 @@ statement:
 
 simple_attr:
 	KEYWORD ':' simple_attr_value line semi_opt
-	{ $$ = sta::makeLibertySimpleAttr($1, $3, $4); }
+	{ $$ = parser->makeSimpleAttr($1, $3, $4); }
 	;
 
 simple_attr_value:
@@ -111,9 +115,9 @@ simple_attr_value:
 
 complex_attr:
 	KEYWORD '(' ')' line semi_opt
-	{ $$ = sta::makeLibertyComplexAttr($1, NULL, $4); }
+	{ $$ = parser->makeComplexAttr($1, NULL, $4); }
 |	KEYWORD '(' attr_values ')' line semi_opt
-	{ $$ = sta::makeLibertyComplexAttr($1, $3, $5); }
+	{ $$ = parser->makeComplexAttr($1, $3, $5); }
 	;
 
 attr_values:
@@ -133,7 +137,7 @@ attr_values:
 
 variable:
 	string '=' FLOAT line semi_opt
-	{ $$ = sta::makeLibertyVariable($1, $3, $4); }
+	{ $$ = parser->makeVariable($1, $3, $4); }
 	;
 
 string:
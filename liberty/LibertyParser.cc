@@ -20,32 +20,21 @@
 #include "Report.hh"
 #include "Error.hh"
 #include "StringUtil.hh"
+#include "ScanInput.hh"
 #include "LibertyParser.hh"
 
 // Global namespace
 
 int
-LibertyParse_parse();
-extern FILE *LibertyLex_in;
+LibertyParse_parse(sta::LibertyParser *parser);
+int
+LibertyLex_lex_init_extra(sta::LibertyParser *parser,
+			  void **scanner);
+int
+LibertyLex_lex_destroy(void *scanner);
 
 namespace sta {
 
-typedef Vector<LibertyGroup*> LibertyGroupSeq;
-
-static const char *liberty_filename;
-static int liberty_line;
-// Previous lex reader state for include files.
-static const char *liberty_filename_prev;
-static int liberty_line_prev;
-static FILE *liberty_stream_prev;
-
-static LibertyGroupVisitor *liberty_group_visitor;
-static LibertyGroupSeq liberty_group_stack;
-static Report *liberty_report;
-
-static LibertyStmt *
-makeLibertyDefine(LibertyAttrValueSeq *values,
-		  int line);
 static LibertyAttrType
 attrValueType(const char *value_type_name);
 static LibertyGroupType
@@ -56,43 +45,88 @@ groupType(const char *group_type_name);
 void
 parseLibertyFile(const char *filename,
 		 LibertyGroupVisitor *library_visitor,
+		 const StringSet *skip_groups,
+		 bool read_ahead,
 		 Report *report)
 {
-  LibertyLex_in = fopen(filename, "r");
-  if (LibertyLex_in) {
-    liberty_group_visitor = library_visitor;
-    liberty_group_stack.clear();
-    liberty_filename = filename;
-    liberty_filename_prev = nullptr;
-    liberty_stream_prev = nullptr;
-    liberty_line = 1;
-    liberty_report = report;
-    LibertyParse_parse();
-    fclose(LibertyLex_in);
-  }
-  else
-    throw FileNotReadable(filename);
+  ScanInput input(filename, read_ahead);
+  LibertyParser parser(filename, &input, library_visitor, skip_groups, report);
+  parser.parse();
+}
+
+LibertyParser::LibertyParser(const char *filename,
+			     ScanInput *input,
+			     LibertyGroupVisitor *group_visitor,
+			     const StringSet *skip_groups,
+			     Report *report) :
+  filename_(filename),
+  line_(1),
+  input_(input),
+  filename_prev_(nullptr),
+  line_prev_(0),
+  input_prev_(nullptr),
+  group_visitor_(group_visitor),
+  skip_groups_(skip_groups),
+  report_(report),
+  skip_depth_(0),
+  scanner_(nullptr)
+{
+  LibertyLex_lex_init_extra(this, &scanner_);
+}
+
+LibertyParser::~LibertyParser()
+{
+  LibertyLex_lex_destroy(scanner_);
+  // Close an include file left open by a parse error.
+  if (input_prev_)
+    delete input_;
 }
 
 void
-libertyGroupBegin(const char *type,
-		  LibertyAttrValueSeq *params,
-		  int line)
+LibertyParser::parse()
 {
-  LibertyGroup *group = new LibertyGroup(type, params, line);
-  liberty_group_visitor->begin(group);
-  liberty_group_stack.push_back(group);
+  LibertyParse_parse(this);
+}
+
+void
+LibertyParser::groupBegin(const char *type,
+			  LibertyAttrValueSeq *params,
+			  int line)
+{
+  // Only nested groups are skipped because the top level group is
+  // begun before its '{' is read.
+  if (skip_groups_
+      && !group_stack_.empty()
+      && skip_groups_->hasKey(type)) {
+    stringDelete(type);
+    if (params) {
+      params->deleteContents();
+      delete params;
+    }
+    group_stack_.push_back(nullptr);
+    // The parser has already read the group's '{'.
+    skip_depth_ = 1;
+    libertyLexSkipGroup(scanner_);
+  }
+  else {
+    LibertyGroup *group = new LibertyGroup(type, params, line);
+    group_visitor_->begin(group);
+    group_stack_.push_back(group);
+  }
 }
 
 LibertyGroup *
-libertyGroupEnd()
-{
-  LibertyGroup *group = libertyGroup();
-  liberty_group_visitor->end(group);
-  liberty_group_stack.pop_back();
-  LibertyGroup *parent =
-    liberty_group_stack.empty() ? nullptr : liberty_group_stack.back();
-  if (parent && liberty_group_visitor->save(group)) {
+LibertyParser::groupEnd()
+{
+  LibertyGroup *group = this->group();
+  if (group == nullptr) {
+    group_stack_.pop_back();
+    return nullptr;
+  }
+  group_visitor_->end(group);
+  group_stack_.pop_back();
+  LibertyGroup *parent = group_stack_.empty() ? nullptr : group_stack_.back();
+  if (parent && group_visitor_->save(group)) {
     parent->addSubgroup(group);
     return group;
   }
@@ -242,15 +276,15 @@ LibertyAttr::~LibertyAttr()
 }
 
 LibertyStmt *
-makeLibertySimpleAttr(const char *name,
-		      LibertyAttrValue *value,
-		      int line)
+LibertyParser::makeSimpleAttr(const char *name,
+			      LibertyAttrValue *value,
+			      int line)
 {
   LibertyAttr *attr = new LibertySimpleAttr(name, value, line);
-  if (liberty_group_visitor)
-    liberty_group_visitor->visitAttr(attr);
-  LibertyGroup *group = libertyGroup();
-  if (group && liberty_group_visitor->save(attr)) {
+  if (group_visitor_)
+    group_visitor_->visitAttr(attr);
+  LibertyGroup *group = this->group();
+  if (group && group_visitor_->save(attr)) {
     group->addAttribute(attr);
     return attr;
   }
@@ -261,9 +295,9 @@ makeLibertySimpleAttr(const char *name,
 }
 
 LibertyGroup *
-libertyGroup()
+LibertyParser::group()
 {
-  return liberty_group_stack.back();
+  return group_stack_.back();
 }
 
 LibertySimpleAttr::LibertySimpleAttr(const char *name,
@@ -287,14 +321,14 @@ LibertySimpleAttr::values() const
 }
 
 LibertyStmt *
-makeLibertyComplexAttr(const char *name,
-		       LibertyAttrValueSeq *values,
-		       int line)
+LibertyParser::makeComplexAttr(const char *name,
+			       LibertyAttrValueSeq *values,
+			       int line)
 {
   // Defines have the same syntax as complex attributes.
   // Detect and convert them.
   if (stringEq(name, "define")) {
-    LibertyStmt *define = makeLibertyDefine(values, line);
+    LibertyStmt *define = makeDefine(values, line);
     stringDelete(name);
     LibertyAttrValueSeq::Iterator attr_iter(values);
     while (attr_iter.hasNext())
@@ -304,10 +338,10 @@ makeLibertyComplexAttr(const char *name,
   }
   else {
     LibertyAttr *attr = new LibertyComplexAttr(name, values, line);
-    if (liberty_group_visitor)
-      liberty_group_visitor->visitAttr(attr);
-    if (liberty_group_visitor->save(attr)) {
-      LibertyGroup *group = libertyGroup();
+    if (group_visitor_)
+      group_visitor_->visitAttr(attr);
+    if (group_visitor_->save(attr)) {
+      LibertyGroup *group = this->group();
       group->addAttribute(attr);
       return attr;
     }
@@ -399,9 +433,9 @@ LibertyFloatAttrValue::stringValue()
 
 ////////////////////////////////////////////////////////////////
 
-static LibertyStmt *
-makeLibertyDefine(LibertyAttrValueSeq *values,
-		  int line)
+LibertyStmt *
+LibertyParser::makeDefine(LibertyAttrValueSeq *values,
+			  int line)
 {
   LibertyDefine *define = nullptr;
   if (values->size() == 3) {
@@ -412,12 +446,12 @@ makeLibertyDefine(LibertyAttrValueSeq *values,
     LibertyGroupType group_type = groupType(group_type_name);
     define = new LibertyDefine(stringCopy(define_name), group_type,
 			       value_type, line);
-    LibertyGroup *group = libertyGroup();
+    LibertyGroup *group = this->group();
     group->addDefine(define);
   }
   else
-    liberty_report->fileWarn(liberty_filename, line,
-			     "define does not have three arguments.\n");
+    report_->fileWarn(filename_, line,
+		      "define does not have three arguments.\n");
   return define;
 }
 
@@ -473,13 +507,13 @@ LibertyDefine::~LibertyDefine()
 ////////////////////////////////////////////////////////////////
 
 LibertyStmt *
-makeLibertyVariable(char *var,
-		    float value,
-		    int line)
+LibertyParser::makeVariable(char *var,
+			    float value,
+			    int line)
 {
   LibertyVariable *variable = new LibertyVariable(var, value, line);
-  liberty_group_visitor->visitVariable(variable);
-  if (liberty_group_visitor->save(variable))
+  group_visitor_->visitVariable(variable);
+  if (group_visitor_->save(variable))
     return variable;
   else {
     delete variable;
@@ -504,58 +538,50 @@ LibertyVariable::~LibertyVariable()
 ////////////////////////////////////////////////////////////////
 
 bool
-libertyInInclude()
-{
-  return liberty_filename_prev != nullptr;
-}
-
-FILE *
-libertyIncludeBegin(const char *filename)
+LibertyParser::includeBegin(const char *filename)
 {
-  FILE *stream = fopen(filename, "r" );
-  if (stream == nullptr)
-    libertyParseError("cannot open include file %s.\n", filename);
-  else {
-    liberty_filename_prev = liberty_filename;
-    liberty_line_prev = liberty_line;
-    liberty_stream_prev = LibertyLex_in;
-
-    liberty_filename = filename;
-    liberty_line = 1;
+  ScanInput *input;
+  try {
+    input = new ScanInput(filename, false);
   }
-  return stream;
-}
+  catch (FileNotReadable &) {
+    parseError("cannot open include file %s.\n", filename);
+    return false;
+  }
+  filename_prev_ = filename_;
+  line_prev_ = line_;
+  input_prev_ = input_;
 
-void
-libertyIncludeEnd()
-{
-  fclose(LibertyLex_in);
-  liberty_filename = liberty_filename_prev;
-  liberty_line = liberty_line_prev;
-  LibertyLex_in = liberty_stream_prev;
-  liberty_filename_prev = nullptr;
-  liberty_stream_prev = nullptr;
+  filename_ = filename;
+  line_ = 1;
+  input_ = input;
+  return true;
 }
 
 void
-libertyIncrLine()
+LibertyParser::includeEnd()
 {
-  sta::liberty_line++;
+  delete input_;
+  filename_ = filename_prev_;
+  line_ = line_prev_;
+  input_ = input_prev_;
+  filename_prev_ = nullptr;
+  input_prev_ = nullptr;
 }
 
-int
-libertyLine()
+size_t
+LibertyParser::getChars(char *buf,
+			size_t max_size)
 {
-  return liberty_line;
+  return input_->read(buf, max_size);
 }
 
 void
-libertyParseError(const char *fmt, ...)
+LibertyParser::parseError(const char *fmt, ...)
 {
   va_list args;
   va_start(args, fmt);
-  sta::liberty_report->vfileError(sta::liberty_filename, sta::liberty_line,
-				  fmt, args);
+  report_->vfileError(filename_, line_, fmt, args);
   va_end(args);
 }
 
@@ -564,13 +590,10 @@ libertyParseError(const char *fmt, ...)
 ////////////////////////////////////////////////////////////////
 // Global namespace
 
-void libertyParseFlushBuffer();
-
 int
-LibertyParse_error(const char *msg)
+LibertyParse_error(sta::LibertyParser *parser,
+		   const char *msg)
 {
-  sta::liberty_report->fileError(sta::liberty_filename, sta::liberty_line,
-				 "%s.\n", msg);
-  libertyParseFlushBuffer();
+  parser->parseError("%s.\n", msg);
   return 0;
 }
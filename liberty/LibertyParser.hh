@@ -17,15 +17,18 @@
 #ifndef STA_LIBERTY_PARSER_H
 #define STA_LIBERTY_PARSER_H
 
+#include <string>
 #include "DisallowCopyAssign.hh"
 #include "Vector.hh"
 #include "Map.hh"
 #include "Set.hh"
 #include "StringUtil.hh"
+#include "StringSet.hh"
 
 namespace sta {
 
 class Report;
+class ScanInput;
 class LibertyGroupVisitor;
 class LibertyAttrVisitor;
 class LibertyStmt;
@@ -293,6 +296,10 @@ public:
   virtual void visitAttr(LibertyAttr *attr) = 0;
   virtual void visitVariable(LibertyVariable *variable) = 0;
   // Predicates to save parse structure after visits.
+  // Groups, attributes and variables that are not saved are deleted
+  // as soon as they are visited (groups when they close), so a
+  // visitor that saves nothing streams the file and never holds more
+  // than the groups enclosing the current statement.
   virtual bool save(LibertyGroup *group) = 0;
   virtual bool save(LibertyAttr *attr) = 0;
   virtual bool save(LibertyVariable *variable) = 0;
@@ -301,53 +308,102 @@ private:
   DISALLOW_COPY_AND_ASSIGN(LibertyGroupVisitor);
 };
 
-FILE *
-libertyIncludeBegin(const char *filename);
-void
-libertyIncludeEnd();
-bool
-libertyInInclude();
-void
-libertyIncrLine();
-void
-libertyParseError(const char *fmt,
-		  ...);
-int
-libertyLine();
-
+// Groups with a type in skip_groups are skipped by the lexer without
+// making any parse structure or calling the visitor.
+// gzip'd files are uncompressed in a separate thread with read_ahead.
+// Throws FileNotReadable.
 void
 parseLibertyFile(const char *filename,
 		 LibertyGroupVisitor *library_visitor,
+		 const StringSet *skip_groups,
+		 bool read_ahead,
 		 Report *report);
-void
-libertyGroupBegin(const char *type,
-		  LibertyAttrValueSeq *params,
-		  int line);
-LibertyGroup *
-libertyGroupEnd();
-LibertyGroup *
-libertyGroup();
-LibertyStmt *
-makeLibertyComplexAttr(const char *name,
-		       LibertyAttrValueSeq *values,
-		       int line);
-LibertyStmt *
-makeLibertySimpleAttr(const char *name,
-		      LibertyAttrValue *value,
-		      int line);
 LibertyAttrValue *
 makeLibertyFloatAttrValue(float value);
 LibertyAttrValue *
 makeLibertyStringAttrValue(char *value);
-LibertyStmt *
-makeLibertyVariable(char *var,
-		    float value,
-		    int line);
+
+// Parser and lexer state for one liberty file.
+// The flex scanner and bison parser are reentrant so separate files
+// can be parsed by separate threads.
+class LibertyParser
+{
+public:
+  LibertyParser(const char *filename,
+		ScanInput *input,
+		LibertyGroupVisitor *group_visitor,
+		const StringSet *skip_groups,
+		Report *report);
+  ~LibertyParser();
+  void parse();
+  // Reentrant flex scanner state.
+  void *scanner() { return scanner_; }
+
+  // Parser actions.
+  void groupBegin(const char *type,
+		  LibertyAttrValueSeq *params,
+		  int line);
+  LibertyGroup *groupEnd();
+  LibertyGroup *group();
+  LibertyStmt *makeComplexAttr(const char *name,
+			       LibertyAttrValueSeq *values,
+			       int line);
+  LibertyStmt *makeSimpleAttr(const char *name,
+			      LibertyAttrValue *value,
+			      int line);
+  LibertyStmt *makeVariable(char *var,
+			    float value,
+			    int line);
+  int line() const { return line_; }
+  void parseError(const char *fmt,
+		  ...);
+
+  // Lexer interface.
+  size_t getChars(char *buf,
+		  size_t max_size);
+  void incrLine() { line_++; }
+  // Return true if the include file is open.
+  bool includeBegin(const char *filename);
+  void includeEnd();
+  bool inInclude() const { return filename_prev_ != nullptr; }
+  std::string &stringBuf() { return string_buf_; }
+  void incrSkipDepth() { skip_depth_++; }
+  // Return the remaining depth.
+  int decrSkipDepth() { return --skip_depth_; }
+
+private:
+  DISALLOW_COPY_AND_ASSIGN(LibertyParser);
+  LibertyStmt *makeDefine(LibertyAttrValueSeq *values,
+			  int line);
+
+  const char *filename_;
+  int line_;
+  ScanInput *input_;
+  // Previous lex reader state for include files.
+  const char *filename_prev_;
+  int line_prev_;
+  ScanInput *input_prev_;
+  LibertyGroupVisitor *group_visitor_;
+  // Skipped groups are pushed as nullptr.
+  LibertyGroupSeq group_stack_;
+  const StringSet *skip_groups_;
+  Report *report_;
+  // Quoted string being scanned.
+  std::string string_buf_;
+  // Brace depth of a group body being skipped.
+  int skip_depth_;
+  void *scanner_;
+};
+
+// Skip the body of the group whose '{' has just been read (LibertyLex.ll).
+void
+libertyLexSkipGroup(void *scanner);
 
 } // namespace
 
 // Global namespace.
 int
-LibertyParse_error(const char *msg);
+LibertyParse_error(sta::LibertyParser *parser,
+		   const char *msg);
 
 #endif
@@ -19,6 +19,8 @@
 #include "Machine.hh"
 #include "Report.hh"
 #include "Debug.hh"
+#include "Progress.hh"
+#include "ThreadPool.hh"
 #include "TokenParser.hh"
 #include "Network.hh"
 #include "Units.hh"
@@ -34,8 +36,10 @@
 #include "EquivCells.hh"
 #include "LibertyExpr.hh"
 #include "ParseBus.hh"
+#include "PatternMatch.hh"
 #include "Liberty.hh"
 #include "LibertyBuilder.hh"
+#include "LibertyCache.hh"
 #include "LibertyReader.hh"
 #include "LibertyReaderPvt.hh"
 
@@ -48,19 +52,278 @@ scaleFloats(FloatSeq *floats,
 LibertyLibrary *
 readLibertyFile(const char *filename,
 		bool infer_latches,
+		const StringSet *skip_groups,
 		Report *report,
 		Debug *debug,
 		Network *network)
 {
   LibertyBuilder builder;
   LibertyReader reader(&builder);
+  reader.setSkipGroups(skip_groups);
   return reader.readLibertyFile(filename, infer_latches,
 				report, debug, network);
 }
 
+LibertyLibrary *
+readLibertyDetached(const char *filename,
+		    bool infer_latches,
+		    const StringSet *skip_groups,
+		    Report *report,
+		    Debug *debug,
+		    Network *network)
+{
+  LibertyBuilder builder;
+  LibertyReader reader(&builder);
+  reader.setAddLibrary(false);
+  reader.setSkipGroups(skip_groups);
+  if (isLibertyCache(filename))
+    return reader.readLibertyCache(filename, infer_latches,
+				   report, debug, network);
+  else
+    return reader.readLibertyFile(filename, infer_latches,
+				  report, debug, network);
+}
+
+// Power groups and their CCS power data.
+static const char *liberty_power_groups[] = {
+  "internal_power",
+  "leakage_power",
+  "dynamic_current",
+  "leakage_current",
+  "intrinsic_parasitic",
+  nullptr
+};
+
+// CCS timing, receiver capacitance and CCS noise groups.
+static const char *liberty_ccs_groups[] = {
+  "output_current_rise",
+  "output_current_fall",
+  "receiver_capacitance",
+  "receiver_capacitance1_rise",
+  "receiver_capacitance1_fall",
+  "receiver_capacitance2_rise",
+  "receiver_capacitance2_fall",
+  "compact_ccs_rise",
+  "compact_ccs_fall",
+  "ccsn_first_stage",
+  "ccsn_last_stage",
+  "input_ccb",
+  "output_ccb",
+  "noise_immunity_high",
+  "noise_immunity_low",
+  "noise_immunity_above_high",
+  "noise_immunity_below_low",
+  "propagated_noise_high",
+  "propagated_noise_low",
+  "steady_state_current_high",
+  "steady_state_current_low",
+  "steady_state_current_tristate",
+  nullptr
+};
+
+StringSet *
+makeLibertySkipGroups(bool skip_power,
+		      bool skip_ccs)
+{
+  if (skip_power || skip_ccs) {
+    StringSet *skip_groups = new StringSet;
+    if (skip_power) {
+      for (const char **group = liberty_power_groups; *group; group++)
+	skip_groups->insert(*group);
+    }
+    if (skip_ccs) {
+      for (const char **group = liberty_ccs_groups; *group; group++)
+	skip_groups->insert(*group);
+    }
+    return skip_groups;
+  }
+  else
+    return nullptr;
+}
+
+////////////////////////////////////////////////////////////////
+
+typedef Map<const char*, LibertyCacheGroupSeq*, CharPtrLess> CellCacheGroupMap;
+
+// Replay the cell groups in a liberty cache when the cells are
+// first referenced.
+class LibertyCacheCellLoader : public LibertyCellLoader
+{
+public:
+  explicit LibertyCacheCellLoader(const char *cache_filename);
+  virtual ~LibertyCacheCellLoader();
+  bool isValid() const { return cache_.isValid(); }
+  LibertyLibrary *read(bool infer_latches,
+		       Report *report,
+		       Debug *debug,
+		       Network *network);
+  virtual void loadCell(const char *name);
+  virtual void loadCellsMatching(const PatternMatch *pattern);
+  virtual void addCornerIndex(int ap_index);
+  virtual std::recursive_mutex &lock();
+
+private:
+  DISALLOW_COPY_AND_ASSIGN(LibertyCacheCellLoader);
+  void makeCornerMaps(LibertyCell *cell);
+
+  LibertyCacheReader cache_;
+  LibertyBuilder builder_;
+  LibertyReader reader_;
+  LibertyLibrary *library_;
+  Report *report_;
+  Network *network_;
+  // Cell and scaled_cell groups that have not been loaded by cell name.
+  CellCacheGroupMap cell_groups_;
+  Vector<int> corner_indices_;
+};
+
+// Loading a cell finds and loads the cells with the same name in the
+// other libraries (makeCornerMaps), so every cache loader shares one
+// lock to keep loads in different libraries from deadlocking.
+static std::recursive_mutex cache_cell_loader_lock;
+
+LibertyLibrary *
+readLibertyCacheLazy(const char *cache_filename,
+		     bool infer_latches,
+		     Report *report,
+		     Debug *debug,
+		     Network *network)
+{
+  LibertyCacheCellLoader *loader = new LibertyCacheCellLoader(cache_filename);
+  if (loader->isValid()) {
+    LibertyLibrary *library = loader->read(infer_latches, report,
+					   debug, network);
+    if (library)
+      library->setCellLoader(loader);
+    else
+      delete loader;
+    return library;
+  }
+  else {
+    report->error("%s is not a liberty cache for this version.\n",
+		  cache_filename);
+    delete loader;
+    return nullptr;
+  }
+}
+
+LibertyCacheCellLoader::LibertyCacheCellLoader(const char *cache_filename) :
+  LibertyCellLoader(),
+  cache_(cache_filename),
+  reader_(&builder_),
+  library_(nullptr),
+  report_(nullptr),
+  network_(nullptr)
+{
+}
+
+LibertyCacheCellLoader::~LibertyCacheCellLoader()
+{
+  cell_groups_.deleteContents();
+}
+
+LibertyLibrary *
+LibertyCacheCellLoader::read(bool infer_latches,
+			     Report *report,
+			     Debug *debug,
+			     Network *network)
+{
+  report_ = report;
+  network_ = network;
+  LibertyCacheGroupSeq deferred;
+  library_ = reader_.readLibertyCacheDeferCells(&cache_, infer_latches,
+						report, debug, network,
+						deferred);
+  for (LibertyCacheGroup &group : deferred) {
+    LibertyCacheGroupSeq *groups = cell_groups_.findKey(group.name);
+    if (groups == nullptr) {
+      groups = new LibertyCacheGroupSeq;
+      cell_groups_[group.name] = groups;
+    }
+    groups->push_back(group);
+  }
+  return library_;
+}
+
+void
+LibertyCacheCellLoader::loadCell(const char *name)
+{
+  std::lock_guard<std::recursive_mutex> lock(cache_cell_loader_lock);
+  LibertyCacheGroupSeq *groups = cell_groups_.findKey(name);
+  if (groups) {
+    // Remove the groups first so finding the cell while it is
+    // loaded does not load it again.
+    cell_groups_.erase(name);
+    for (LibertyCacheGroup &group : *groups) {
+      if (!cache_.visitGroup(&reader_, group))
+	report_->error("liberty cache for %s is corrupt.\n",
+		       library_->filename());
+    }
+    delete groups;
+    LibertyCell *cell = library_->findLibertyCell(name);
+    if (cell)
+      makeCornerMaps(cell);
+  }
+}
+
+// Do the LibertyLibrary::makeCornerMap work for a cell that is
+// loaded after the library is added to the corners.
+void
+LibertyCacheCellLoader::makeCornerMaps(LibertyCell *cell)
+{
+  const char *name = cell->name();
+  LibertyCell *link_cell = network_->findLibertyCell(name);
+  if (link_cell) {
+    for (int ap_index : corner_indices_)
+      LibertyLibrary::makeCornerMap(link_cell, cell, ap_index, report_);
+    if (link_cell == cell) {
+      // Load the corner cells for the link cell in the other libraries.
+      LibertyLibraryIterator *lib_iter = network_->libertyLibraryIterator();
+      while (lib_iter->hasNext()) {
+	LibertyLibrary *lib = lib_iter->next();
+	if (lib != library_ && lib->cellLoader())
+	  lib->findLibertyCell(name);
+      }
+      delete lib_iter;
+    }
+  }
+}
+
+void
+LibertyCacheCellLoader::loadCellsMatching(const PatternMatch *pattern)
+{
+  std::lock_guard<std::recursive_mutex> lock(cache_cell_loader_lock);
+  StringSeq names;
+  for (auto name_groups : cell_groups_) {
+    const char *name = name_groups.first;
+    if (pattern->match(name))
+      names.push_back(name);
+  }
+  for (const char *name : names)
+    loadCell(name);
+}
+
+void
+LibertyCacheCellLoader::addCornerIndex(int ap_index)
+{
+  std::lock_guard<std::recursive_mutex> lock(cache_cell_loader_lock);
+  corner_indices_.push_back(ap_index);
+}
+
+std::recursive_mutex &
+LibertyCacheCellLoader::lock()
+{
+  return cache_cell_loader_lock;
+}
+
+////////////////////////////////////////////////////////////////
+
 LibertyReader::LibertyReader(LibertyBuilder *builder) :
   LibertyGroupVisitor(),
-  builder_(builder)
+  add_library_(true),
+  skip_groups_(nullptr),
+  builder_(builder),
+  progress_(nullptr)
 {
   defineVisitors();
 }
@@ -88,18 +351,100 @@ LibertyReader::~LibertyReader()
   }
 }
 
+LibertyLibrary *
+readLibertyCache(const char *cache_filename,
+		 bool infer_latches,
+		 Report *report,
+		 Debug *debug,
+		 Network *network)
+{
+  LibertyBuilder builder;
+  LibertyReader reader(&builder);
+  return reader.readLibertyCache(cache_filename, infer_latches,
+				 report, debug, network);
+}
+
+void
+LibertyReader::setAddLibrary(bool add_library)
+{
+  add_library_ = add_library;
+}
+
+void
+LibertyReader::setSkipGroups(const StringSet *skip_groups)
+{
+  skip_groups_ = skip_groups;
+}
+
 LibertyLibrary *
 LibertyReader::readLibertyFile(const char *filename,
 			       bool infer_latches,
 			       Report *report,
 			       Debug *debug,
 			       Network *network)
+{
+  init(filename, infer_latches, report, debug, network);
+  Progress progress("read_liberty", "cells", report);
+  progress_ = &progress;
+  // Only read ahead when there is a spare thread to parse while the
+  // file is uncompressed.
+  ThreadPool *thread_pool = network->threadPool();
+  parseLibertyFile(filename, this, skip_groups_,
+		   thread_pool && thread_pool->threadCount() > 1, report);
+  progress_ = nullptr;
+  return library_;
+}
+
+LibertyLibrary *
+LibertyReader::readLibertyCache(const char *cache_filename,
+				bool infer_latches,
+				Report *report,
+				Debug *debug,
+				Network *network)
+{
+  LibertyCacheReader cache(cache_filename);
+  if (cache.isValid()) {
+    // Messages and the library refer to the cached liberty file.
+    init(cache.libertyFilename(), infer_latches, report, debug, network);
+    if (!cache.visit(this))
+      report->error("liberty cache %s is corrupt.\n", cache_filename);
+    return library_;
+  }
+  else {
+    report->error("%s is not a liberty cache for this version.\n",
+		  cache_filename);
+    return nullptr;
+  }
+}
+
+LibertyLibrary *
+LibertyReader::readLibertyCacheDeferCells(LibertyCacheReader *cache,
+					  bool infer_latches,
+					  Report *report,
+					  Debug *debug,
+					  Network *network,
+					  // Return value.
+					  LibertyCacheGroupSeq &deferred)
+{
+  init(cache->libertyFilename(), infer_latches, report, debug, network);
+  if (!cache->visitDeferCells(this, deferred))
+    report->error("liberty cache for %s is corrupt.\n", filename_);
+  return library_;
+}
+
+void
+LibertyReader::init(const char *filename,
+		    bool infer_latches,
+		    Report *report,
+		    Debug *debug,
+		    Network *network)
 {
   filename_ = filename;
   infer_latches_ = infer_latches;
   report_ = report;
   debug_ = debug;
   network_ = network;
+  group_stack_.clear();
   var_map_ = nullptr;
   library_ = nullptr;
   wireload_ = nullptr;
@@ -142,9 +487,6 @@ LibertyReader::readLibertyFile(const char *filename,
     have_slew_lower_threshold_[tr_index] = false;
     have_slew_upper_threshold_[tr_index] = false;
   }
-
-  parseLibertyFile(filename, this, report);
-  return library_;
 }
 
 void
@@ -519,6 +861,7 @@ LibertyReader::visitAttr(LibertyAttr *attr)
 void
 LibertyReader::begin(LibertyGroup *group)
 {
+  group_stack_.push_back(group);
   LibraryGroupVisitor visitor = group_begin_map_.findKey(group->type());
   if (visitor)
     (this->*visitor)(group);
@@ -530,6 +873,7 @@ LibertyReader::end(LibertyGroup *group)
   LibraryGroupVisitor visitor = group_end_map_.findKey(group->type());
   if (visitor)
     (this->*visitor)(group);
+  group_stack_.pop_back();
 }
 
 void
@@ -542,7 +886,10 @@ LibertyReader::beginLibrary(LibertyGroup *group)
       libWarn(group, "library %s already exists.\n", name);
     // Make a new library even if a library with the same name exists.
     // Both libraries may be accessed by min/max analysis points.
-    library_ = network_->makeLibertyLibrary(name, filename_);
+    if (add_library_)
+      library_ = network_->makeLibertyLibrary(name, filename_);
+    else
+      library_ = new LibertyLibrary(name, filename_);
     // 1ns default
     time_scale_ = 1E-9F;
     // 1ohm default
@@ -1366,7 +1713,7 @@ LibertyReader::visitIndex(int index,
 {
   if (tbl_template_
       // Ignore index_xx in ecsm_waveform groups.
-      && !stringEq(libertyGroup()->type(), "ecsm_waveform")) {
+      && !stringEq(group_stack_.back()->type(), "ecsm_waveform")) {
     FloatSeq *axis_values = readFloatSeq(attr, 1.0F);
     if (axis_values)
       axis_values_[index] = axis_values;
@@ -1812,6 +2159,8 @@ LibertyReader::beginCell(LibertyGroup *group)
 void
 LibertyReader::endCell(LibertyGroup *group)
 {
+  if (progress_)
+    progress_->incr();
   if (cell_) {
     // Sequentials and leakage powers reference expressions outside of port definitions
     // so they do not require LibertyFunc's.
@@ -1887,6 +2236,7 @@ LibertyReader::makeTimingArcs(PortGroup *port_group)
       LibertyPort *port = port_iter.next();
       makeTimingArcs(port, timing);
     }
+    timing->deleteRelatedPortNames();
     cell_->addTimingArcAttrs(timing);
   }
 }
@@ -1902,6 +2252,7 @@ LibertyReader::makeInternalPowers(PortGroup *port_group)
       LibertyPort *port = port_iter.next();
       makeInternalPowers(port, power_group);
     }
+    power_group->deleteRelatedPortNames();
     cell_->addInternalPowerAttrs(power_group);
   }
 }
@@ -3871,7 +4222,7 @@ LibertyReader::visitValues(LibertyAttr *attr)
 {
   if (tbl_template_
       // Ignore values in ecsm_waveform groups.
-      && !stringEq(libertyGroup()->type(), "ecsm_waveform"))
+      && !stringEq(group_stack_.back()->type(), "ecsm_waveform"))
     makeTable(attr, table_model_scale_);
 }
 
@@ -4979,10 +5330,17 @@ RelatedPortGroup::RelatedPortGroup(int line) :
 }
 
 RelatedPortGroup::~RelatedPortGroup()
+{
+  deleteRelatedPortNames();
+}
+
+void
+RelatedPortGroup::deleteRelatedPortNames()
 {
   if (related_port_names_) {
     deleteContents(related_port_names_);
     delete related_port_names_;
+    related_port_names_ = nullptr;
   }
 }
 
@@ -5036,6 +5394,16 @@ TimingGroup::~TimingGroup()
     stringDelete(related_output_port_name_);
 }
 
+void
+TimingGroup::deleteRelatedPortNames()
+{
+  RelatedPortGroup::deleteRelatedPortNames();
+  if (related_output_port_name_) {
+    stringDelete(related_output_port_name_);
+    related_output_port_name_ = nullptr;
+  }
+}
+
 void
 TimingGroup::setRelatedOutputPortName(const char *name)
 {
@@ -17,6 +17,8 @@
 #ifndef STA_LIBERTY_READER_H
 #define STA_LIBERTY_READER_H
 
+#include "StringSet.hh"
+
 namespace sta {
 
 class Report;
@@ -24,12 +26,50 @@ class Debug;
 class Network;
 class LibertyLibrary;
 
+// Groups with a type in skip_groups are not read (nullptr reads all).
 LibertyLibrary *
 readLibertyFile(const char *filename,
 		bool infer_latches,
+		const StringSet *skip_groups,
 		Report *report,
 		Debug *debug,
 		Network *network);
 
+// Read a library from a cache written by writeLibertyCache.
+LibertyLibrary *
+readLibertyCache(const char *cache_filename,
+		 bool infer_latches,
+		 Report *report,
+		 Debug *debug,
+		 Network *network);
+
+// Read a library from a cache without making the cells until they
+// are found by name (see LibertyCellLoader).
+LibertyLibrary *
+readLibertyCacheLazy(const char *cache_filename,
+		     bool infer_latches,
+		     Report *report,
+		     Debug *debug,
+		     Network *network);
+
+// Read a liberty file or a liberty cache without adding the library
+// to network (see Network::addLibertyLibrary).
+// Multiple liberty files and caches can be read by separate threads
+// at once.
+LibertyLibrary *
+readLibertyDetached(const char *filename,
+		    bool infer_latches,
+		    const StringSet *skip_groups,
+		    Report *report,
+		    Debug *debug,
+		    Network *network);
+
+// Make the set of groups to skip for readLibertyFile when power
+// and/or CCS data is not needed. Returns nullptr if both are false.
+// The caller owns the set but not its strings.
+StringSet *
+makeLibertySkipGroups(bool skip_power,
+		      bool skip_ccs);
+
 } // namespace
 #endif
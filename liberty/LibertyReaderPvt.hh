@@ -28,6 +28,7 @@
 #include "LeakagePower.hh"
 #include "Liberty.hh"
 #include "LibertyParser.hh"
+#include "LibertyCache.hh"
 #include "LibertyReader.hh"
 #include "NetworkClass.hh"
 
@@ -35,6 +36,7 @@ namespace sta {
 
 class LibertyBuilder;
 class LibertyReader;
+class Progress;
 class LibertyFunc;
 class PortGroup;
 class SequentialGroup;
@@ -67,7 +69,27 @@ public:
 					  Report *report,
 					  Debug *debug,
 					  Network *network);
+  LibertyLibrary *readLibertyCache(const char *cache_filename,
+				   bool infer_latches,
+				   Report *report,
+				   Debug *debug,
+				   Network *network);
+  // Read the library from cache without the cells (see
+  // LibertyCacheReader::visitDeferCells). The reader builds the
+  // deferred cells when they are replayed with visitGroup.
+  LibertyLibrary *readLibertyCacheDeferCells(LibertyCacheReader *cache,
+					     bool infer_latches,
+					     Report *report,
+					     Debug *debug,
+					     Network *network,
+					     // Return value.
+					     LibertyCacheGroupSeq &deferred);
   LibertyLibrary *library() const { return library_; }
+  // When false the library is not added to the network so it can be
+  // read in parallel with other libraries and added later.
+  void setAddLibrary(bool add_library);
+  // Groups the parser skips (see makeLibertySkipGroups).
+  void setSkipGroups(const StringSet *skip_groups);
   virtual bool save(LibertyGroup *) { return false; }
   virtual bool save(LibertyAttr *) { return false; }
   virtual bool save(LibertyVariable *) { return false; }
@@ -428,6 +450,11 @@ public:
   virtual void visitAttr9(LibertyAttr *) {}
 
 protected:
+  void init(const char *filename,
+	    bool infer_latches,
+	    Report *report,
+	    Debug *debug,
+	    Network *network);
   void setEnergyScale();
   void defineVisitors();
   virtual void begin(LibertyGroup *group);
@@ -501,7 +528,13 @@ protected:
   Report *report_;
   Debug *debug_;
   Network *network_;
+  bool add_library_;
+  const StringSet *skip_groups_;
+  // Groups being visited.
+  LibertyGroupSeq group_stack_;
   LibertyBuilder *builder_;
+  // Cell progress while a file is read.
+  Progress *progress_;
   LibertyVariableMap *var_map_;
   LibertyLibrary *library_;
   LibraryGroupMap group_begin_map_;
@@ -685,6 +718,9 @@ public:
   int line() const { return line_; }
   StringSeq *relatedPortNames() const { return related_port_names_; }
   void setRelatedPortNames(StringSeq *names);
+  // Delete the port names once the arcs referencing them are made
+  // so they are not kept for the life of the library.
+  virtual void deleteRelatedPortNames();
   bool isOneToOne() const { return is_one_to_one_; }
   void setIsOneToOne(bool one);
 
@@ -704,6 +740,7 @@ public:
   virtual ~TimingGroup();
   const char *relatedOutputPortName()const {return related_output_port_name_;}
   void setRelatedOutputPortName(const char *name);
+  virtual void deleteRelatedPortNames();
   void intrinsic(TransRiseFall *tr,
 		 // Return values.
 		 float &value,
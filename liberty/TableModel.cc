@@ -14,9 +14,19 @@
 // You should have received a copy of the GNU General Public License
 // along with this program.  If not, see <https://www.gnu.org/licenses/>.
 
+#include <algorithm>
+#include <mutex>
+#include <vector>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
 #include "Machine.hh"
+#include "Mutex.hh"
+#include "Hash.hh"
+#include "UnorderedMap.hh"
 #include "Report.hh"
 #include "Error.hh"
+#include "MappedFile.hh"
 #include "EnumNameMap.hh"
 #include "Units.hh"
 #include "Liberty.hh"
@@ -123,6 +133,59 @@ GateTableModel::gateDelay(const LibertyCell *cell,
   drvr_slew = makeDelay(slew, sigma_early, sigma_late);
 }
 
+void
+GateTableModel::gateDelays(const LibertyCell *cell,
+			   const Pvt *pvt,
+			   const float *in_slews,
+			   const float *load_caps,
+			   float related_out_cap,
+			   size_t count,
+			   bool pocv_enabled,
+			   // return values
+			   ArcDelay *gate_delays,
+			   Slew *drvr_slews) const
+{
+  const LibertyLibrary *library = cell->libertyLibrary();
+  std::vector<float> related_out_caps(count, related_out_cap);
+  std::vector<float> values(count);
+  std::vector<float> sigmas_early(count, 0.0);
+  std::vector<float> sigmas_late(count, 0.0);
+  findValues(library, cell, pvt, delay_model_, in_slews, load_caps,
+	     related_out_caps.data(), count, values.data());
+  if (pocv_enabled && delay_sigma_models_[EarlyLate::earlyIndex()])
+    findValues(library, cell, pvt,
+	       delay_sigma_models_[EarlyLate::earlyIndex()],
+	       in_slews, load_caps, related_out_caps.data(), count,
+	       sigmas_early.data());
+  if (pocv_enabled && delay_sigma_models_[EarlyLate::lateIndex()])
+    findValues(library, cell, pvt,
+	       delay_sigma_models_[EarlyLate::earlyIndex()],
+	       in_slews, load_caps, related_out_caps.data(), count,
+	       sigmas_late.data());
+  for (size_t i = 0; i < count; i++)
+    gate_delays[i] = makeDelay(values[i], sigmas_early[i], sigmas_late[i]);
+
+  findValues(library, cell, pvt, slew_model_, in_slews, load_caps,
+	     related_out_caps.data(), count, values.data());
+  if (pocv_enabled && slew_sigma_models_[EarlyLate::earlyIndex()])
+    findValues(library, cell, pvt,
+	       slew_sigma_models_[EarlyLate::earlyIndex()],
+	       in_slews, load_caps, related_out_caps.data(), count,
+	       sigmas_early.data());
+  if (pocv_enabled && slew_sigma_models_[EarlyLate::lateIndex()])
+    findValues(library, cell, pvt,
+	       slew_sigma_models_[EarlyLate::earlyIndex()],
+	       in_slews, load_caps, related_out_caps.data(), count,
+	       sigmas_late.data());
+  for (size_t i = 0; i < count; i++) {
+    float slew = values[i];
+    // Clip negative slews to zero.
+    if (slew < 0.0)
+      slew = 0.0;
+    drvr_slews[i] = makeDelay(slew, sigmas_early[i], sigmas_late[i]);
+  }
+}
+
 void
 GateTableModel::reportGateDelay(const LibertyCell *cell,
 				const Pvt *pvt,
@@ -204,6 +267,59 @@ GateTableModel::findValue(const LibertyLibrary *library,
     return 0.0;
 }
 
+void
+GateTableModel::findValues(const LibertyLibrary *library,
+			   const LibertyCell *cell,
+			   const Pvt *pvt,
+			   const TableModel *model,
+			   const float *in_slews,
+			   const float *load_caps,
+			   const float *related_out_caps,
+			   size_t count,
+			   // Return values.
+			   float *values) const
+{
+  if (model) {
+    int order = model->order();
+    const float *axis_values1 = (order >= 1)
+      ? axisValues(model->axis1(), in_slews, load_caps, related_out_caps)
+      : nullptr;
+    const float *axis_values2 = (order >= 2)
+      ? axisValues(model->axis2(), in_slews, load_caps, related_out_caps)
+      : nullptr;
+    const float *axis_values3 = (order >= 3)
+      ? axisValues(model->axis3(), in_slews, load_caps, related_out_caps)
+      : nullptr;
+    model->findValues(library, cell, pvt,
+		      axis_values1, axis_values2, axis_values3,
+		      count, values);
+  }
+  else {
+    for (size_t i = 0; i < count; i++)
+      values[i] = 0.0;
+  }
+}
+
+const float *
+GateTableModel::axisValues(TableAxis *axis,
+			   const float *in_slews,
+			   const float *load_caps,
+			   const float *related_out_caps) const
+{
+  TableAxisVariable var = axis->variable();
+  if (var == TableAxisVariable::input_transition_time
+      || var == TableAxisVariable::input_net_transition)
+    return in_slews;
+  else if (var == TableAxisVariable::total_output_net_capacitance)
+    return load_caps;
+  else if (var == TableAxisVariable::related_out_total_output_net_capacitance)
+    return related_out_caps;
+  else {
+    internalError("unsupported table axes");
+    return nullptr;
+  }
+}
+
 void
 GateTableModel::findAxisValues(const TableModel *model,
 			       float in_slew,
@@ -607,6 +723,18 @@ TableModel::axis3() const
   return table_->axis3();
 }
 
+size_t
+TableModel::valueCount() const
+{
+  size_t count = 1;
+  TableAxis *axes[3] = {table_->axis1(), table_->axis2(), table_->axis3()};
+  for (auto axis : axes) {
+    if (axis)
+      count *= axis->size();
+  }
+  return count;
+}
+
 float
 TableModel::findValue(const LibertyLibrary *library,
 		      const LibertyCell *cell,
@@ -619,6 +747,23 @@ TableModel::findValue(const LibertyLibrary *library,
     * scaleFactor(library, cell, pvt);
 }
 
+void
+TableModel::findValues(const LibertyLibrary *library,
+		       const LibertyCell *cell,
+		       const Pvt *pvt,
+		       const float *values1,
+		       const float *values2,
+		       const float *values3,
+		       size_t count,
+		       // Return values.
+		       float *results) const
+{
+  table_->findValues(values1, values2, values3, count, results);
+  float scale = scaleFactor(library, cell, pvt);
+  for (size_t i = 0; i < count; i++)
+    results[i] *= scale;
+}
+
 float
 TableModel::scaleFactor(const LibertyLibrary *library,
 			const LibertyCell *cell,
@@ -697,6 +842,22 @@ TableModel::reportPvtScaleFactor(const LibertyLibrary *library,
 
 ////////////////////////////////////////////////////////////////
 
+void
+Table::findValues(const float *values1,
+		  const float *values2,
+		  const float *values3,
+		  size_t count,
+		  // Return values.
+		  float *results) const
+{
+  for (size_t i = 0; i < count; i++)
+    results[i] = findValue(values1 ? values1[i] : 0.0F,
+			   values2 ? values2[i] : 0.0F,
+			   values3 ? values3[i] : 0.0F);
+}
+
+////////////////////////////////////////////////////////////////
+
 Table0::Table0(float value) :
   Table(),
   value_(value)
@@ -748,7 +909,7 @@ Table1::Table1(FloatSeq *values,
 	       TableAxis *axis1,
 	       bool own_axis1) :
   Table(),
-  values_(values),
+  values_(internFloats(values)),
   axis1_(axis1),
   own_axis1_(own_axis1)
 {
@@ -756,7 +917,7 @@ Table1::Table1(FloatSeq *values,
 
 Table1::~Table1()
 {
-  delete values_;
+  releaseFloats(values_);
   if (own_axis1_)
     delete axis1_;
 }
@@ -860,19 +1021,39 @@ Table2::Table2(FloatTable *values,
 	       bool own_axis1,
 	       TableAxis *axis2,
 	       bool own_axis2) :
+  Table2(values, axis1, own_axis1, axis2, own_axis2, axis2->size())
+{
+}
+
+Table2::Table2(FloatTable *values,
+	       TableAxis *axis1,
+	       bool own_axis1,
+	       TableAxis *axis2,
+	       bool own_axis2,
+	       size_t row_size) :
   Table(),
-  values_(values),
   axis1_(axis1),
   own_axis1_(own_axis1),
   axis2_(axis2),
   own_axis2_(own_axis2)
 {
+  // Copy the rows into one contiguous vector.
+  FloatSeq *flat_values = new FloatSeq(values->size() * row_size, 0.0);
+  size_t row_index = 0;
+  for (FloatSeq *row : *values) {
+    size_t size = std::min(row->size(), row_size);
+    std::copy(row->begin(), row->begin() + size,
+	      flat_values->begin() + row_index * row_size);
+    row_index++;
+  }
+  values->deleteContents();
+  delete values;
+  values_ = internFloats(flat_values);
 }
 
 Table2::~Table2()
 {
-  values_->deleteContents();
-  delete values_;
+  releaseFloats(values_);
   if (own_axis1_)
     delete axis1_;
   if (own_axis2_)
@@ -883,8 +1064,7 @@ float
 Table2::tableValue(size_t index1,
 		   size_t index2) const
 {
-  FloatSeq *row = (*values_)[index1];
-  return (*row)[index2];
+  return (*values_)[index1 * axis2_->size() + index2];
 }
 
 // Bilinear Interpolation.
@@ -949,6 +1129,49 @@ Table2::findValue(float value1,
   }
 }
 
+// Bilinear Interpolation of count points.
+// Same arithmetic as findValue so the results are identical.
+void
+Table2::findValues(const float *values1,
+		   const float *values2,
+		   const float *values3,
+		   size_t count,
+		   // Return values.
+		   float *results) const
+{
+  size_t size1 = axis1_->size();
+  size_t size2 = axis2_->size();
+  if (size1 == 1 || size2 == 1)
+    Table::findValues(values1, values2, values3, count, results);
+  else {
+    size_t index1 = 0;
+    size_t index2 = 0;
+    for (size_t i = 0; i < count; i++) {
+      float x1 = values1[i];
+      float x2 = values2[i];
+      index1 = axis1_->findAxisIndex(x1, index1);
+      index2 = axis2_->findAxisIndex(x2, index2);
+      const float *row0 = values_->data() + index1 * size2;
+      const float *row1 = row0 + size2;
+      float y00 = row0[index2];
+      float x1l = axis1_->axisValue(index1);
+      float x1u = axis1_->axisValue(index1 + 1);
+      float dx1 = (x1 - x1l) / (x1u - x1l);
+      float y10 = row1[index2];
+      float y11 = row1[index2 + 1];
+      float x2l = axis2_->axisValue(index2);
+      float x2u = axis2_->axisValue(index2 + 1);
+      float dx2 = (x2 - x2l) / (x2u - x2l);
+      float y01 = row0[index2 + 1];
+      results[i]
+	= (1 - dx1) * (1 - dx2) * y00
+	+      dx1  * (1 - dx2) * y10
+	+      dx1  *      dx2  * y11
+	+ (1 - dx1) *      dx2  * y01;
+    }
+  }
+}
+
 void
 Table2::reportValue(const char *result_name,
 		    const LibertyLibrary *library,
@@ -1052,7 +1275,7 @@ Table3::Table3(FloatTable *values,
 	       bool own_axis2,
 	       TableAxis *axis3,
 	       bool own_axis3) :
-  Table2(values, axis1, own_axis1, axis2, own_axis2),
+  Table2(values, axis1, own_axis1, axis2, own_axis2, axis3->size()),
   axis3_(axis3),
   own_axis3_(own_axis3)
 {
@@ -1070,7 +1293,19 @@ Table3::tableValue(size_t index1,
 		   size_t index3) const
 {
   size_t row = index1 * axis2_->size() + index2;
-  return values_->operator[](row)->operator[](index3);
+  return (*values_)[row * axis3_->size() + index3];
+}
+
+// Override the Table2 bilinear version.
+void
+Table3::findValues(const float *values1,
+		   const float *values2,
+		   const float *values3,
+		   size_t count,
+		   // Return values.
+		   float *results) const
+{
+  Table::findValues(values1, values2, values3, count, results);
 }
 
 // Bilinear Interpolation.
@@ -1310,13 +1545,13 @@ Table3::report(const Units *units,
 TableAxis::TableAxis(TableAxisVariable variable,
 		     FloatSeq *values) :
   variable_(variable),
-  values_(values)
+  values_(internFloats(values))
 {
 }
 
 TableAxis::~TableAxis()
 {
-  delete values_;
+  releaseFloats(values_);
 }
 
 // Bisection search.
@@ -1344,6 +1579,321 @@ TableAxis::findAxisIndex(float value) const
   }
 }
 
+size_t
+TableAxis::findAxisIndex(float value,
+			 size_t hint) const
+{
+  if (hint + 1 < values_->size()
+      && value >= (*values_)[hint]
+      && value < (*values_)[hint + 1])
+    return hint;
+  else
+    return findAxisIndex(value);
+}
+
+////////////////////////////////////////////////////////////////
+
+TableValues::TableValues(FloatSeq *values) :
+  values_(values),
+  data_(values->data()),
+  size_(values->size())
+{
+}
+
+TableValues::TableValues(const float *data,
+			 size_t size) :
+  values_(nullptr),
+  data_(data),
+  size_(size)
+{
+}
+
+TableValues::~TableValues()
+{
+  delete values_;
+}
+
+static Hash
+hashFloats(const float *data,
+	   size_t size)
+{
+  Hash hash = hash_init_value;
+  for (size_t i = 0; i < size; i++) {
+    uint32_t bits;
+    memcpy(&bits, &data[i], sizeof(bits));
+    hashIncr(hash, bits);
+  }
+  return hash;
+}
+
+static bool
+floatsEqual(const float *data1,
+	    size_t size1,
+	    const float *data2,
+	    size_t size2)
+{
+  return size1 == size2
+    && memcmp(data1, data2, size1 * sizeof(float)) == 0;
+}
+
+class TableValuesHash
+{
+public:
+  size_t operator()(const TableValues *values) const
+  {
+    return hashFloats(values->data(), values->size());
+  }
+};
+
+class TableValuesEqual
+{
+public:
+  bool operator()(const TableValues *values1,
+		  const TableValues *values2) const
+  {
+    return floatsEqual(values1->data(), values1->size(),
+		       values2->data(), values2->size());
+  }
+};
+
+// Interned float vectors and their reference counts.
+typedef UnorderedMap<const TableValues*, int,
+		     TableValuesHash, TableValuesEqual> TableValuesRefCountMap;
+
+// Libraries can be read by multiple threads.
+static std::mutex interned_floats_lock;
+
+// Constructed on first use so tables can be made during static
+// initialization.
+static TableValuesRefCountMap &
+internedFloats()
+{
+  static TableValuesRefCountMap interned_floats;
+  return interned_floats;
+}
+
+////////////////////////////////////////////////////////////////
+
+// Shared table values file layout, in native byte order:
+//  header     magic, version, byte order, entry count
+//  entries    {hash, offset, size} sorted by hash
+//  floats     vectors at entry offsets from the start of the file
+// There are no pointers so the file can be mapped at any address.
+static const uint32_t table_values_version = 1;
+static const char table_values_magic[] = "OpenSTA table values";
+static const uint32_t table_values_byte_order = 0x01020304;
+
+class TableValuesHeader
+{
+public:
+  char magic_[sizeof(table_values_magic)];
+  uint32_t version_;
+  uint32_t byte_order_;
+  uint64_t entry_count_;
+};
+
+class TableValuesEntry
+{
+public:
+  uint64_t hash_;
+  // Bytes from the start of the file.
+  uint64_t offset_;
+  // Float count.
+  uint64_t size_;
+};
+
+// Mapped files are never unmapped because tables reference them.
+static std::vector<MappedFile*> &
+sharedTableValuesFiles()
+{
+  static std::vector<MappedFile*> files;
+  return files;
+}
+
+// Find values in the mapped shared table values files.
+static const float *
+findSharedFloats(const float *data,
+		 size_t size)
+{
+  std::vector<MappedFile*> &files = sharedTableValuesFiles();
+  if (!files.empty()) {
+    uint64_t hash = hashFloats(data, size);
+    for (MappedFile *file : files) {
+      const char *base = file->data();
+      const TableValuesHeader *header =
+	reinterpret_cast<const TableValuesHeader*>(base);
+      const TableValuesEntry *entries =
+	reinterpret_cast<const TableValuesEntry*>(base + sizeof(TableValuesHeader));
+      const TableValuesEntry *entries_end = entries + header->entry_count_;
+      const TableValuesEntry *entry =
+	std::lower_bound(entries, entries_end, hash,
+			 [] (const TableValuesEntry &entry, uint64_t hash) {
+			   return entry.hash_ < hash;
+			 });
+      for (; entry != entries_end && entry->hash_ == hash; entry++) {
+	const float *shared =
+	  reinterpret_cast<const float*>(base + entry->offset_);
+	if (floatsEqual(shared, entry->size_, data, size))
+	  return shared;
+      }
+    }
+  }
+  return nullptr;
+}
+
+////////////////////////////////////////////////////////////////
+
+const TableValues *
+internFloats(FloatSeq *values)
+{
+  UniqueLock lock(interned_floats_lock);
+  TableValuesRefCountMap &interned_floats = internedFloats();
+  TableValues key(values->data(), values->size());
+  auto iter = interned_floats.find(&key);
+  if (iter == interned_floats.end()) {
+    TableValues *interned;
+    const float *shared = findSharedFloats(values->data(), values->size());
+    if (shared) {
+      interned = new TableValues(shared, values->size());
+      delete values;
+    }
+    else {
+      values->shrink_to_fit();
+      interned = new TableValues(values);
+    }
+    interned_floats[interned] = 1;
+    return interned;
+  }
+  else {
+    const TableValues *interned = iter->first;
+    iter->second++;
+    delete values;
+    return interned;
+  }
+}
+
+void
+releaseFloats(const TableValues *values)
+{
+  UniqueLock lock(interned_floats_lock);
+  TableValuesRefCountMap &interned_floats = internedFloats();
+  auto iter = interned_floats.find(values);
+  if (iter != interned_floats.end()
+      && --iter->second == 0) {
+    interned_floats.erase(iter);
+    delete values;
+  }
+}
+
+size_t
+internedFloatsCount(// Return values.
+		    size_t &float_count,
+		    size_t &mapped_float_count)
+{
+  UniqueLock lock(interned_floats_lock);
+  TableValuesRefCountMap &interned_floats = internedFloats();
+  float_count = 0;
+  mapped_float_count = 0;
+  for (auto value_count : interned_floats) {
+    const TableValues *values = value_count.first;
+    if (values->isMapped())
+      mapped_float_count += values->size();
+    else
+      float_count += values->size();
+  }
+  return interned_floats.size();
+}
+
+void
+writeSharedTableValues(const char *filename)
+{
+  FILE *stream = fopen(filename, "wb");
+  if (stream == nullptr)
+    throw FileNotWritable(filename);
+  // Hold the lock while writing so the vectors cannot be released.
+  UniqueLock lock(interned_floats_lock);
+  TableValuesRefCountMap &interned_floats = internedFloats();
+  std::vector<const TableValues*> values_seq;
+  for (auto value_count : interned_floats)
+    values_seq.push_back(value_count.first);
+  // Sort by hash for binary search.
+  std::vector<TableValuesEntry> entries;
+  for (const TableValues *values : values_seq)
+    entries.push_back({hashFloats(values->data(), values->size()),
+		       0, values->size()});
+  std::vector<size_t> order(values_seq.size());
+  for (size_t i = 0; i < order.size(); i++)
+    order[i] = i;
+  std::sort(order.begin(), order.end(),
+	    [&] (size_t i1, size_t i2) {
+	      return entries[i1].hash_ < entries[i2].hash_;
+	    });
+  std::vector<TableValuesEntry> sorted_entries;
+  uint64_t offset = sizeof(TableValuesHeader)
+    + entries.size() * sizeof(TableValuesEntry);
+  for (size_t i : order) {
+    TableValuesEntry entry = entries[i];
+    entry.offset_ = offset;
+    offset += entry.size_ * sizeof(float);
+    sorted_entries.push_back(entry);
+  }
+
+  TableValuesHeader header;
+  memset(&header, 0, sizeof(header));
+  memcpy(header.magic_, table_values_magic, sizeof(table_values_magic));
+  header.version_ = table_values_version;
+  header.byte_order_ = table_values_byte_order;
+  header.entry_count_ = sorted_entries.size();
+  bool written = fwrite(&header, sizeof(header), 1, stream) == 1;
+  if (!sorted_entries.empty())
+    written &= fwrite(sorted_entries.data(), sizeof(TableValuesEntry),
+		      sorted_entries.size(), stream) == sorted_entries.size();
+  for (size_t i : order) {
+    const TableValues *values = values_seq[i];
+    written &= fwrite(values->data(), sizeof(float), values->size(), stream)
+      == values->size();
+  }
+  written &= fclose(stream) == 0;
+  if (!written)
+    throw FileNotWritable(filename);
+}
+
+bool
+readSharedTableValues(const char *filename)
+{
+  MappedFile *file = new MappedFile(filename);
+  const char *base = file->data();
+  size_t size = file->size();
+  bool valid = false;
+  if (size >= sizeof(TableValuesHeader)) {
+    const TableValuesHeader *header =
+      reinterpret_cast<const TableValuesHeader*>(base);
+    if (memcmp(header->magic_, table_values_magic,
+	       sizeof(table_values_magic)) == 0
+	&& header->version_ == table_values_version
+	&& header->byte_order_ == table_values_byte_order
+	&& header->entry_count_
+	<= (size - sizeof(TableValuesHeader)) / sizeof(TableValuesEntry)) {
+      const TableValuesEntry *entries =
+	reinterpret_cast<const TableValuesEntry*>(base + sizeof(TableValuesHeader));
+      valid = true;
+      for (uint64_t i = 0; valid && i < header->entry_count_; i++) {
+	const TableValuesEntry &entry = entries[i];
+	valid = entry.offset_ % sizeof(float) == 0
+	  && entry.offset_ <= size
+	  && entry.size_ <= (size - entry.offset_) / sizeof(float);
+      }
+    }
+  }
+  if (valid) {
+    UniqueLock lock(interned_floats_lock);
+    sharedTableValuesFiles().push_back(file);
+  }
+  else
+    delete file;
+  return valid;
+}
+
 ////////////////////////////////////////////////////////////////
 
 static EnumNameMap<TableAxisVariable> table_axis_variable_map =
@@ -42,6 +42,59 @@ const Unit *
 tableVariableUnit(TableAxisVariable variable,
 		  const Units *units);
 
+// Read only table axis or value vector. The floats are owned by the
+// vector or mapped from a shared table values file.
+class TableValues
+{
+public:
+  // Takes ownership of values.
+  explicit TableValues(FloatSeq *values);
+  // Reference floats owned by the caller (mapped file).
+  TableValues(const float *data,
+	      size_t size);
+  ~TableValues();
+  size_t size() const { return size_; }
+  const float *data() const { return data_; }
+  float operator[](size_t index) const { return data_[index]; }
+  bool isMapped() const { return values_ == nullptr; }
+
+private:
+  DISALLOW_COPY_AND_ASSIGN(TableValues);
+
+  FloatSeq *values_;
+  const float *data_;
+  size_t size_;
+};
+
+// Tables repeat the same axis and value vectors across cells, drive
+// strengths and libraries, so they are shared through a content hashed
+// store. internFloats returns the shared vector equal to values and
+// deletes values if it is a duplicate or found in a mapped shared table
+// values file. Each internFloats must be matched by a releaseFloats of
+// the returned vector.
+const TableValues *
+internFloats(FloatSeq *values);
+void
+releaseFloats(const TableValues *values);
+// Number of interned vectors and the total floats they hold in
+// private memory and in mapped shared table values files.
+size_t
+internedFloatsCount(// Return values.
+		    size_t &float_count,
+		    size_t &mapped_float_count);
+// Write the interned vectors to filename with a position independent
+// layout (offsets instead of pointers) that is mapped read only by
+// readSharedTableValues. Throws FileNotWritable.
+void
+writeSharedTableValues(const char *filename);
+// Map a file written by writeSharedTableValues for the rest of the
+// process. Vectors interned after this that are in the file reference
+// the mapped pages, which the OS shares between processes mapping the
+// same file. Throws FileNotReadable.
+// Return false if filename is not a shared table values file.
+bool
+readSharedTableValues(const char *filename);
+
 class GateTableModel : public GateTimingModel
 {
 public:
@@ -59,6 +112,20 @@ public:
 			 // Return values.
 			 ArcDelay &gate_delay,
 			 Slew &drvr_slew) const;
+  // gateDelay for count (in_slews[i], load_caps[i]) points.
+  // The scale factors are found once and the table axis searches
+  // start from the interval found for the previous point, so points
+  // that are close together (ceff iterations) are cheap.
+  void gateDelays(const LibertyCell *cell,
+		  const Pvt *pvt,
+		  const float *in_slews,
+		  const float *load_caps,
+		  float related_out_cap,
+		  size_t count,
+		  bool pocv_enabled,
+		  // Return values.
+		  ArcDelay *gate_delays,
+		  Slew *drvr_slews) const;
   virtual void reportGateDelay(const LibertyCell *cell,
 			       const Pvt *pvt,
 			       float in_slew,
@@ -94,6 +161,20 @@ protected:
 		  float in_slew,
 		  float load_cap,
 		  float related_out_cap) const;
+  void findValues(const LibertyLibrary *library,
+		  const LibertyCell *cell,
+		  const Pvt *pvt,
+		  const TableModel *model,
+		  const float *in_slews,
+		  const float *load_caps,
+		  const float *related_out_caps,
+		  size_t count,
+		  // Return values.
+		  float *values) const;
+  const float *axisValues(TableAxis *axis,
+			  const float *in_slews,
+			  const float *load_caps,
+			  const float *related_out_caps) const;
   void reportTableLookup(const char *result_name,
 			 const LibertyLibrary *library,
 			 const LibertyCell *cell,
@@ -129,6 +210,7 @@ public:
   explicit CheckTableModel(TableModel *model,
 			   TableModel *sigma_models[EarlyLate::index_count]);
   virtual ~CheckTableModel();
+  const TableModel *model() const { return model_; }
   virtual void checkDelay(const LibertyCell *cell,
 			  const Pvt *pvt,
 			  float from_slew,
@@ -204,6 +286,8 @@ public:
   TableAxis *axis1() const;
   TableAxis *axis2() const;
   TableAxis *axis3() const;
+  // Number of table values.
+  size_t valueCount() const;
   void setIsScaled(bool is_scaled);
   // Table interpolated lookup.
   float findValue(float value1,
@@ -216,6 +300,17 @@ public:
 		  float value1,
 		  float value2,
 		  float value3) const;
+  // Table interpolated lookup of count points with scale factor.
+  // Axis values arrays beyond the table order are not referenced.
+  void findValues(const LibertyLibrary *library,
+		  const LibertyCell *cell,
+		  const Pvt *pvt,
+		  const float *values1,
+		  const float *values2,
+		  const float *values3,
+		  size_t count,
+		  // Return values.
+		  float *results) const;
   void reportValue(const char *result_name,
 		   const LibertyLibrary *library,
 		   const LibertyCell *cell,
@@ -265,6 +360,13 @@ public:
   virtual float findValue(float value1,
 			  float value2,
 			  float value3) const = 0;
+  // Table interpolated lookup of count points.
+  virtual void findValues(const float *values1,
+			  const float *values2,
+			  const float *values3,
+			  size_t count,
+			  // Return values.
+			  float *results) const;
   // Table interpolated lookup with scale factor.
   float findValue(const LibertyLibrary *library,
 		  const LibertyCell *cell,
@@ -348,7 +450,7 @@ public:
 private:
   DISALLOW_COPY_AND_ASSIGN(Table1);
 
-  FloatSeq *values_;
+  const TableValues *values_;
   TableAxis *axis1_;
   bool own_axis1_;
 };
@@ -371,6 +473,12 @@ public:
   virtual float findValue(float value1,
 			  float value2,
 			  float value3) const;
+  virtual void findValues(const float *values1,
+			  const float *values2,
+			  const float *values3,
+			  size_t count,
+			  // Return values.
+			  float *results) const;
   virtual void reportValue(const char *result_name,
 			   const LibertyLibrary *library,
 			   const LibertyCell *cell,
@@ -387,8 +495,16 @@ public:
 
 protected:
   DISALLOW_COPY_AND_ASSIGN(Table2);
+  // Rows of values are row_size long.
+  Table2(FloatTable *values,
+	 TableAxis *axis1,
+	 bool own_axis1,
+	 TableAxis *axis2,
+	 bool own_axis2,
+	 size_t row_size);
 
-  FloatTable *values_;
+  // Row major values so rows are adjacent in memory.
+  const TableValues *values_;
   // Row.
   TableAxis *axis1_;
   bool own_axis1_;
@@ -417,6 +533,12 @@ public:
   virtual float findValue(float value1,
 			  float value2,
 			  float value3) const;
+  virtual void findValues(const float *values1,
+			  const float *values2,
+			  const float *values3,
+			  size_t count,
+			  // Return values.
+			  float *results) const;
   virtual void reportValue(const char *result_name,
 			   const LibertyLibrary *library,
 			   const LibertyCell *cell,
@@ -449,12 +571,15 @@ public:
   float axisValue(size_t index) const { return (*values_)[index]; }
   // Find the index for value such that axis[index] <= value < axis[index+1].
   size_t findAxisIndex(float value) const;
+  // findAxisIndex that checks the interval at hint before searching.
+  size_t findAxisIndex(float value,
+		       size_t hint) const;
 
 private:
   DISALLOW_COPY_AND_ASSIGN(TableAxis);
 
   TableAxisVariable variable_;
-  FloatSeq *values_;
+  const TableValues *values_;
 };
 
 } // namespace
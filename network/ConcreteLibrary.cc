@@ -19,6 +19,7 @@
 #include "DisallowCopyAssign.hh"
 #include "PatternMatch.hh"
 #include "PortDirection.hh"
+#include "StringIntern.hh"
 #include "ParseBus.hh"
 #include "ConcreteLibrary.hh"
 
@@ -110,8 +111,8 @@ ConcreteCell::ConcreteCell(ConcreteLibrary *library,
 			   bool is_leaf,
 			   const char *filename):
   library_(library),
-  name_(stringCopy(name)),
-  filename_(stringCopy(filename)),
+  name_(internString(name)),
+  filename_(internString(filename)),
   port_bit_count_(0),
   is_leaf_(is_leaf)
 {
@@ -119,18 +120,14 @@ ConcreteCell::ConcreteCell(ConcreteLibrary *library,
 
 ConcreteCell::~ConcreteCell()
 {
-  stringDelete(name_);
-  if (filename_)
-    stringDelete(filename_);
   ports_.deleteContents();
 }
 
 void
 ConcreteCell::setName(const char *name)
 {
-  const char *name_cpy = stringCopy(name);
+  const char *name_cpy = internString(name);
   library_->renameCell(this, name_cpy);
-  stringDelete(name_);
   name_ = name_cpy;
 }
 
@@ -419,7 +416,7 @@ ConcretePort::ConcretePort(ConcreteCell *cell,
 			   int to_index,
 			   bool is_bundle,
 			   ConcretePortSeq *member_ports) :
-  name_(stringCopy(name)),
+  name_(internString(name)),
   cell_(cell),
   direction_(PortDirection::unknown()),
   pin_index_(-1),
@@ -438,7 +435,6 @@ ConcretePort::~ConcretePort()
   if (is_bus_)
     member_ports_->deleteContents();
   delete member_ports_;
-  stringDelete(name_);
 }
 
 Cell *
@@ -14,10 +14,15 @@
 // You should have received a copy of the GNU General Public License
 // along with this program.  If not, see <https://www.gnu.org/licenses/>.
 
+#include <algorithm>
 #include "Machine.hh"
 #include "DisallowCopyAssign.hh"
+#include "Mutex.hh"
+#include "ThreadForEach.hh"
 #include "PatternMatch.hh"
 #include "Report.hh"
+#include "MemoryReport.hh"
+#include "StringIntern.hh"
 #include "PortDirection.hh"
 #include "ConcreteLibrary.hh"
 #include "Liberty.hh"
@@ -46,6 +51,76 @@ makeConcreteNetwork()
   return new ConcreteNetwork;
 }
 
+// Instances with fewer children/nets than this are matched linearly.
+static const size_t name_index_min_size = 64;
+// Wildcard matches over more names than this are split across threads.
+static const size_t parallel_match_min_size = 10000;
+
+template <class OBJ>
+class NameLess
+{
+public:
+  bool operator()(const OBJ *obj1,
+		  const OBJ *obj2) const
+  {
+    return strcmp(obj1->name(), obj2->name()) < 0;
+  }
+};
+
+// Append the objects in the name sorted sequence that match pattern
+// in name order.  The literal prefix of the pattern bounds the range
+// of names that are matched.
+template <class OBJ, class RESULT>
+static void
+findSortedMatching(const Vector<OBJ*> &sorted,
+		   const PatternMatch *pattern,
+		   ThreadPool *thread_pool,
+		   // Return value.
+		   Vector<RESULT*> *matches)
+{
+  auto begin = sorted.begin();
+  auto end = sorted.end();
+  size_t prefix_length = pattern->literalPrefixLength();
+  if (prefix_length > 0) {
+    const char *prefix = pattern->pattern();
+    begin = std::lower_bound(begin, end, prefix,
+			     [] (const OBJ *obj,
+				 const char *prefix) {
+			       return strcmp(obj->name(), prefix) < 0;
+			     });
+    end = std::upper_bound(begin, end, prefix,
+			   [=] (const char *prefix,
+				const OBJ *obj) {
+			     return strncmp(prefix, obj->name(),
+					    prefix_length) < 0;
+			   });
+  }
+  size_t count = end - begin;
+  // Tcl regexps cannot be matched from multiple threads.
+  if (count >= parallel_match_min_size
+      && !pattern->isRegexp()
+      && thread_pool
+      && thread_pool->threadCount() > 1) {
+    std::vector<char> matched(count);
+    forEachChunk(count, thread_pool,
+		 [&] (size_t chunk_begin, size_t chunk_end, int) {
+		   for (size_t i = chunk_begin; i < chunk_end; i++)
+		     matched[i] = pattern->match(begin[i]->name());
+		 });
+    for (size_t i = 0; i < count; i++) {
+      if (matched[i])
+	matches->push_back(reinterpret_cast<RESULT*>(begin[i]));
+    }
+  }
+  else {
+    for (auto iter = begin; iter != end; iter++) {
+      OBJ *obj = *iter;
+      if (pattern->match(obj->name()))
+	matches->push_back(reinterpret_cast<RESULT*>(obj));
+    }
+  }
+}
+
 class ConcreteInstanceChildIterator : public InstanceChildIterator
 {
 public:
@@ -253,7 +328,9 @@ ConcreteNetTermIterator::next()
 ConcreteNetwork::ConcreteNetwork() :
   NetworkReader(),
   top_instance_(nullptr),
-  link_func_(nullptr)
+  link_func_(nullptr),
+  instance_pool_(1000),
+  pin_pool_(4000)
 {
 }
 
@@ -267,11 +344,70 @@ ConcreteNetwork::clear()
 {
   deleteTopInstance();
   deleteCellNetworkViews();
+  deleteNameIndices();
   library_seq_.deleteContentsClear();
   library_map_.clear();
   Network::clear();
 }
 
+void
+ConcreteNetwork::reportMemory(MemoryReport &memory) const
+{
+  size_t inst_count = 0;
+  size_t inst_bytes = 0;
+  size_t pin_count = 0;
+  size_t net_count = 0;
+  size_t term_count = 0;
+  size_t map_count = 0;
+  size_t map_bytes = 0;
+  Vector<ConcreteInstance*> insts;
+  if (top_instance_)
+    insts.push_back(reinterpret_cast<ConcreteInstance*>(top_instance_));
+  while (!insts.empty()) {
+    ConcreteInstance *inst = insts.back();
+    insts.pop_back();
+    inst_count++;
+    int pin_slots = reinterpret_cast<ConcreteCell*>(inst->cell_)->portBitCount();
+    inst_bytes += sizeof(ConcreteInstance) + pin_slots * sizeof(ConcretePin*);
+    if (inst->pins_) {
+      for (int i = 0; i < pin_slots; i++) {
+	if (inst->pins_[i])
+	  pin_count++;
+      }
+    }
+    // The names themselves are in the string intern table.
+    if (inst->children_) {
+      map_count++;
+      map_bytes += sizeof(ConcreteInstanceChildMap)
+	+ inst->children_->size() * (MemoryReport::hash_node_bytes
+				     + 2 * sizeof(void*));
+      for (auto name_child : *inst->children_)
+	insts.push_back(name_child.second);
+    }
+    if (inst->nets_) {
+      map_count++;
+      map_bytes += sizeof(ConcreteInstanceNetMap)
+	+ inst->nets_->size() * (MemoryReport::hash_node_bytes
+				 + 2 * sizeof(void*));
+      for (auto name_net : *inst->nets_) {
+	ConcreteNet *net = name_net.second;
+	net_count++;
+	for (ConcreteTerm *term = net->terms_; term; term = term->net_next_)
+	  term_count++;
+      }
+    }
+  }
+  memory.reportUsage("Network", "instances", inst_count, inst_bytes);
+  memory.reportUsage("Network", "pins", pin_count,
+		     pin_count * sizeof(ConcretePin));
+  memory.reportUsage("Network", "nets", net_count,
+		     net_count * sizeof(ConcreteNet));
+  memory.reportUsage("Network", "terms", term_count,
+		     term_count * sizeof(ConcreteTerm));
+  memory.reportUsage("Network", "name maps", map_count, map_bytes);
+  memory.reportSubsystemTotal("Network");
+}
+
 void
 ConcreteNetwork::deleteTopInstance()
 {
@@ -421,6 +557,12 @@ ConcreteNetwork::makeLibertyLibrary(const char *name,
   return library;
 }
 
+void
+ConcreteNetwork::addLibertyLibrary(LibertyLibrary *library)
+{
+  addLibrary(library);
+}
+
 void
 ConcreteNetwork::addLibrary(ConcreteLibrary *library)
 {
@@ -862,6 +1004,64 @@ ConcreteNetwork::name(const Instance *instance) const
   return inst->name();
 }
 
+const char *
+ConcreteNetwork::pathName(const Instance *instance) const
+{
+  if (isTopInstance(instance))
+    return "";
+  else {
+    const ConcreteInstance *inst =
+      reinterpret_cast<const ConcreteInstance*>(instance);
+    const ConcreteInstance *parent = inst->parent();
+    if (parent == nullptr
+	|| isTopInstance(reinterpret_cast<const Instance*>(parent)))
+      return inst->name();
+    else {
+      const char *parent_name = parentPathName(parent);
+      size_t parent_name_length = strlen(parent_name);
+      const char *inst_name = inst->name();
+      size_t path_name_length = parent_name_length + strlen(inst_name) + 2;
+      char *path_name = makeTmpString(path_name_length);
+      strcpy(path_name, parent_name);
+      path_name[parent_name_length] = pathDivider();
+      strcpy(path_name + parent_name_length + 1, inst_name);
+      return path_name;
+    }
+  }
+}
+
+// Path names of the instances above leaves are cached so finding the
+// path name of a pin or leaf instance does not walk the hierarchy.
+const char *
+ConcreteNetwork::parentPathName(const ConcreteInstance *inst) const
+{
+  const char *path_name = inst->path_name_.load();
+  if (path_name == nullptr) {
+    const ConcreteInstance *parent = inst->parent();
+    const char *inst_name = inst->name();
+    if (parent == nullptr
+	|| isTopInstance(reinterpret_cast<const Instance*>(parent)))
+      path_name = inst_name;
+    else {
+      const char *parent_name = parentPathName(parent);
+      size_t parent_name_length = strlen(parent_name);
+      char *name = new char[parent_name_length + strlen(inst_name) + 2];
+      strcpy(name, parent_name);
+      name[parent_name_length] = pathDivider();
+      strcpy(name + parent_name_length + 1, inst_name);
+      path_name = name;
+    }
+    // Another thread may have cached the name first.
+    const char *cached = nullptr;
+    if (!inst->path_name_.compare_exchange_strong(cached, path_name)) {
+      if (path_name != inst_name)
+	delete [] path_name;
+      path_name = cached;
+    }
+  }
+  return path_name;
+}
+
 Cell *
 ConcreteNetwork::cell(const Instance *instance) const
 {
@@ -930,7 +1130,94 @@ ConcreteNetwork::findInstNetsMatching(const Instance *instance,
 {
   const ConcreteInstance *inst =
     reinterpret_cast<const ConcreteInstance*>(instance);
-  inst->findNetsMatching(pattern, nets);
+  if (pattern->hasWildcards()
+      && inst->nets_
+      && inst->nets_->size() >= name_index_min_size)
+    findSortedMatching(*netNameIndex(inst), pattern, threadPool(), nets);
+  else
+    inst->findNetsMatching(pattern, nets);
+}
+
+void
+ConcreteNetwork::findChildrenMatching(const Instance *parent,
+				      const PatternMatch *pattern,
+				      InstanceSeq *insts) const
+{
+  const ConcreteInstance *cparent =
+    reinterpret_cast<const ConcreteInstance*>(parent);
+  if (pattern->hasWildcards()
+      && cparent->children_
+      && cparent->children_->size() >= name_index_min_size)
+    findSortedMatching(*childNameIndex(cparent), pattern, threadPool(), insts);
+  else
+    Network::findChildrenMatching(parent, pattern, insts);
+}
+
+const ConcreteInstanceSeq *
+ConcreteNetwork::childNameIndex(const ConcreteInstance *inst) const
+{
+  UniqueLock lock(name_index_lock_);
+  ConcreteInstanceSeq *index = child_name_index_.findKey(inst);
+  if (index == nullptr) {
+    index = new ConcreteInstanceSeq;
+    index->reserve(inst->children_->size());
+    for (auto name_child : *inst->children_)
+      index->push_back(name_child.second);
+    sort(index, NameLess<ConcreteInstance>());
+    child_name_index_[inst] = index;
+  }
+  return index;
+}
+
+const ConcreteNetSeq *
+ConcreteNetwork::netNameIndex(const ConcreteInstance *inst) const
+{
+  UniqueLock lock(name_index_lock_);
+  ConcreteNetSeq *index = net_name_index_.findKey(inst);
+  if (index == nullptr) {
+    index = new ConcreteNetSeq;
+    index->reserve(inst->nets_->size());
+    for (auto name_net : *inst->nets_)
+      index->push_back(name_net.second);
+    sort(index, NameLess<ConcreteNet>());
+    net_name_index_[inst] = index;
+  }
+  return index;
+}
+
+// The empty checks keep edits that do not have indices (like the
+// parallel verilog link) from serializing on the lock.
+void
+ConcreteNetwork::deleteChildNameIndex(const ConcreteInstance *inst)
+{
+  if (!child_name_index_.empty()) {
+    UniqueLock lock(name_index_lock_);
+    ConcreteInstanceSeq *index = child_name_index_.findKey(inst);
+    if (index) {
+      delete index;
+      child_name_index_.erase(inst);
+    }
+  }
+}
+
+void
+ConcreteNetwork::deleteNetNameIndex(const ConcreteInstance *inst)
+{
+  if (!net_name_index_.empty()) {
+    UniqueLock lock(name_index_lock_);
+    ConcreteNetSeq *index = net_name_index_.findKey(inst);
+    if (index) {
+      delete index;
+      net_name_index_.erase(inst);
+    }
+  }
+}
+
+void
+ConcreteNetwork::deleteNameIndices()
+{
+  child_name_index_.deleteContentsClear();
+  net_name_index_.deleteContentsClear();
 }
 
 ////////////////////////////////////////////////////////////////
@@ -1121,9 +1408,16 @@ ConcreteNetwork::makeConcreteInstance(ConcreteCell *cell,
 {
   ConcreteInstance *cparent =
     reinterpret_cast<ConcreteInstance*>(parent);
-  ConcreteInstance *inst = new ConcreteInstance(cell, name, cparent);
-  if (parent)
+  ConcreteInstance *inst;
+  {
+    UniqueLock lock(pool_lock_);
+    inst = instance_pool_.makeObject();
+  }
+  inst->init(cell, name, cparent);
+  if (parent) {
     cparent->addChild(inst);
+    deleteChildNameIndex(cparent);
+  }
   return reinterpret_cast<Instance*>(inst);
 }
 
@@ -1206,8 +1500,13 @@ ConcreteNetwork::deleteInstance(Instance *inst)
     ConcreteInstance *cparent =
       reinterpret_cast<ConcreteInstance*>(parent_inst);
     cparent->deleteChild(cinst);
+    deleteChildNameIndex(cparent);
   }
-  delete cinst;
+  deleteChildNameIndex(cinst);
+  deleteNetNameIndex(cinst);
+  cinst->deleteContents();
+  UniqueLock lock(pool_lock_);
+  instance_pool_.deleteObject(cinst);
 }
 
 Pin *
@@ -1218,13 +1517,21 @@ ConcreteNetwork::makePin(Instance *inst,
   ConcreteInstance *cinst = reinterpret_cast<ConcreteInstance*>(inst);
   ConcretePort *cport = reinterpret_cast<ConcretePort*>(port);
   ConcreteNet *cnet = reinterpret_cast<ConcreteNet*>(net);
-  ConcretePin *cpin = new ConcretePin(cinst, cport, cnet);
+  ConcretePin *cpin = makeConcretePin(cinst, cport, cnet);
   cinst->addPin(cpin);
   if (cnet)
     connectNetPin(cnet, cpin);
   return reinterpret_cast<Pin*>(cpin);
 }
 
+void
+ConcreteNetwork::initPins(Instance *inst)
+{
+  ConcreteInstance *cinst = reinterpret_cast<ConcreteInstance*>(inst);
+  delete [] cinst->pins_;
+  cinst->initPins();
+}
+
 Term *
 ConcreteNetwork::makeTerm(Pin *pin,
 			  Net *net)
@@ -1261,7 +1568,7 @@ ConcreteNetwork::connect(Instance *inst,
       disconnectNetPin(prev_net, cpin);
   }
   else {
-    cpin = new ConcretePin(cinst, cport, cnet);
+    cpin = makeConcretePin(cinst, cport, cnet);
     cinst->addPin(cpin);
   }
   if (inst == top_instance_) {
@@ -1356,7 +1663,22 @@ ConcreteNetwork::deletePin(Pin *pin)
     reinterpret_cast<ConcreteInstance*>(cpin->instance());
   if (cinst)
     cinst->deletePin(cpin);
-  delete cpin;
+  UniqueLock lock(pool_lock_);
+  pin_pool_.deleteObject(cpin);
+}
+
+ConcretePin *
+ConcreteNetwork::makeConcretePin(ConcreteInstance *inst,
+				 ConcretePort *port,
+				 ConcreteNet *net)
+{
+  ConcretePin *pin;
+  {
+    UniqueLock lock(pool_lock_);
+    pin = pin_pool_.makeObject();
+  }
+  pin->init(inst, port, net);
+  return pin;
 }
 
 Net *
@@ -1366,6 +1688,7 @@ ConcreteNetwork::makeNet(const char *name,
   ConcreteInstance *cparent = reinterpret_cast<ConcreteInstance*>(parent);
   ConcreteNet *net = new ConcreteNet(name, cparent);
   cparent->addNet(net);
+  deleteNetNameIndex(cparent);
   return reinterpret_cast<Net*>(net);
 }
 
@@ -1392,6 +1715,7 @@ ConcreteNetwork::deleteNet(Net *net)
   ConcreteInstance *cinst =
     reinterpret_cast<ConcreteInstance*>(cnet->instance());
   cinst->deleteNet(cnet);
+  deleteNetNameIndex(cinst);
   delete cnet;
 }
 
@@ -1457,15 +1781,28 @@ ConcreteNetwork::visitConnectedPins(const Net *net,
 
 ////////////////////////////////////////////////////////////////
 
-ConcreteInstance::ConcreteInstance(ConcreteCell *cell,
-				   const char *name,
-				   ConcreteInstance *parent) :
-  cell_(cell),
-  name_(stringCopy(name)),
-  parent_(parent),
+ConcreteInstance::ConcreteInstance() :
+  cell_(nullptr),
+  name_(nullptr),
+  parent_(nullptr),
+  pins_(nullptr),
   children_(nullptr),
-  nets_(nullptr)
+  nets_(nullptr),
+  path_name_(nullptr)
 {
+}
+
+void
+ConcreteInstance::init(ConcreteCell *cell,
+		       const char *name,
+		       ConcreteInstance *parent)
+{
+  cell_ = cell;
+  name_ = internString(name);
+  parent_ = parent;
+  children_ = nullptr;
+  nets_ = nullptr;
+  path_name_ = nullptr;
   initPins();
 }
 
@@ -1481,10 +1818,21 @@ ConcreteInstance::initPins()
 
 ConcreteInstance::~ConcreteInstance()
 {
-  stringDelete(name_);
+  deleteContents();
+}
+
+void
+ConcreteInstance::deleteContents()
+{
   delete [] pins_;
+  pins_ = nullptr;
   delete children_;
+  children_ = nullptr;
   delete nets_;
+  nets_ = nullptr;
+  const char *path_name = path_name_.exchange(nullptr);
+  if (path_name != name_)
+    delete [] path_name;
 }
 
 Instance *
@@ -1565,6 +1913,21 @@ ConcreteInstance::childIterator() const
   return new ConcreteInstanceChildIterator(children_);
 }
 
+void
+ConcreteInstance::clearPathNames()
+{
+  const char *path_name = path_name_.exchange(nullptr);
+  if (path_name != name_)
+    delete [] path_name;
+  if (children_) {
+    ConcreteInstanceChildMap::Iterator child_iter(children_);
+    while (child_iter.hasNext()) {
+      ConcreteInstance *child = child_iter.next();
+      child->clearPathNames();
+    }
+  }
+}
+
 void
 ConcreteInstance::addChild(ConcreteInstance *child)
 {
@@ -1624,12 +1987,10 @@ ConcreteInstance::setCell(ConcreteCell *cell)
 
 ////////////////////////////////////////////////////////////////
 
-ConcretePin::ConcretePin(ConcreteInstance *instance,
-			 ConcretePort *port,
-			 ConcreteNet *net) :
-  instance_(instance),
-  port_(port),
-  net_(net),
+ConcretePin::ConcretePin() :
+  instance_(nullptr),
+  port_(nullptr),
+  net_(nullptr),
   term_(nullptr),
   net_next_(nullptr),
   net_prev_(nullptr),
@@ -1637,6 +1998,20 @@ ConcretePin::ConcretePin(ConcreteInstance *instance,
 {
 }
 
+void
+ConcretePin::init(ConcreteInstance *instance,
+		  ConcretePort *port,
+		  ConcreteNet *net)
+{
+  instance_ = instance;
+  port_ = port;
+  net_ = net;
+  term_ = nullptr;
+  net_next_ = nullptr;
+  net_prev_ = nullptr;
+  vertex_index_ = 0;
+}
+
 const char *
 ConcretePin::name() const
 {
@@ -1672,7 +2047,7 @@ ConcreteTerm::ConcreteTerm(ConcretePin *pin,
 
 ConcreteNet::ConcreteNet(const char *name,
 			 ConcreteInstance *instance) :
-  name_(stringCopy(name)),
+  name_(internString(name)),
   instance_(instance),
   pins_(nullptr),
   terms_(nullptr),
@@ -1682,7 +2057,6 @@ ConcreteNet::ConcreteNet(const char *name,
 
 ConcreteNet::~ConcreteNet()
 {
-  stringDelete(name_);
 }
 
 // Merged nets are kept around to serve as name aliases.
@@ -1813,6 +2187,16 @@ ConcreteNetwork::setTopInstance(Instance *top_inst)
   top_instance_ = top_inst;
 }
 
+void
+ConcreteNetwork::setPathDivider(char divider)
+{
+  if (divider != pathDivider()) {
+    NetworkReader::setPathDivider(divider);
+    if (top_instance_)
+      reinterpret_cast<ConcreteInstance*>(top_instance_)->clearPathNames();
+  }
+}
+
 void
 ConcreteNetwork::setLinkFunc(LinkNetworkFunc *link)
 {
@@ -17,9 +17,13 @@
 #ifndef STA_CONCRETE_NETWORK_H
 #define STA_CONCRETE_NETWORK_H
 
+#include <atomic>
+#include <mutex>
 #include "DisallowCopyAssign.hh"
 #include "Map.hh"
+#include "UnorderedMap.hh"
 #include "Set.hh"
+#include "Pool.hh"
 #include "StringUtil.hh"
 #include "Network.hh"
 #include "LibertyClass.hh"
@@ -40,12 +44,22 @@ class ConcreteLibertyLibraryIterator;
 typedef Vector<ConcreteLibrary*> ConcreteLibrarySeq;
 typedef Map<const char*, ConcreteLibrary*, CharPtrLess> ConcreteLibraryMap;
 typedef ConcreteLibrarySeq::ConstIterator ConcreteLibraryIterator;
-typedef Map<const char *, ConcreteInstance*,
-	    CharPtrLess> ConcreteInstanceChildMap;
-typedef Map<const char *, ConcreteNet*, CharPtrLess> ConcreteInstanceNetMap;
+// Child and net names are interned so the keys outlive the map entries.
+typedef UnorderedMap<const char*, ConcreteInstance*,
+		     CharPtrHash, CharPtrEqual> ConcreteInstanceChildMap;
+typedef UnorderedMap<const char*, ConcreteNet*,
+		     CharPtrHash, CharPtrEqual> ConcreteInstanceNetMap;
 typedef Vector<ConcreteNet*> ConcreteNetSeq;
+typedef Vector<ConcreteInstance*> ConcreteInstanceSeq;
+// Children/nets of an instance sorted by name for pattern matching.
+typedef UnorderedMap<const ConcreteInstance*,
+		     ConcreteInstanceSeq*> ConcreteChildNameIndex;
+typedef UnorderedMap<const ConcreteInstance*,
+		     ConcreteNetSeq*> ConcreteNetNameIndex;
 typedef Map<Cell*, Instance*> CellNetworkViewMap;
 typedef Set<const ConcreteNet*> ConcreteNetSet;
+typedef Pool<ConcreteInstance> ConcreteInstancePool;
+typedef Pool<ConcretePin> ConcretePinPool;
 
 // This adapter implements the network api for the concrete network.
 // A superset of the Network api methods are implemented in the interface.
@@ -59,6 +73,7 @@ public:
 			   bool make_black_boxes,
 			   Report *report);
   virtual Instance *topInstance() const;
+  virtual void reportMemory(MemoryReport &memory) const;
 
   virtual LibraryIterator *libraryIterator() const;
   virtual LibertyLibraryIterator *libertyLibraryIterator() const ;
@@ -106,11 +121,15 @@ public:
   virtual PortMemberIterator *memberIterator(const Port *port) const;
 
   virtual const char *name(const Instance *instance) const;
+  virtual const char *pathName(const Instance *instance) const;
   virtual Cell *cell(const Instance *instance) const;
   virtual Instance *parent(const Instance *instance) const;
   virtual bool isLeaf(const Instance *instance) const;
   virtual Instance *findChild(const Instance *parent,
 			      const char *name) const;
+  virtual void findChildrenMatching(const Instance *parent,
+				    const PatternMatch *pattern,
+				    InstanceSeq *insts) const;
   virtual Pin *findPin(const Instance *instance,
 		       const char *port_name) const;
   virtual Pin *findPin(const Instance *instance,
@@ -159,6 +178,7 @@ public:
 			       const char *filename);
   virtual LibertyLibrary *makeLibertyLibrary(const char *name,
 					     const char *filename);
+  virtual void addLibertyLibrary(LibertyLibrary *library);
   virtual Cell *makeCell(Library *library,
 			 const char *name,
 			 bool is_leaf,
@@ -212,6 +232,7 @@ public:
   virtual Pin *makePin(Instance *inst,
 		       Port *port,
 		       Net *net);
+  virtual void initPins(Instance *inst);
 
   // Instance is the network view for cell.
   virtual void setCellNetworkView(Cell *cell,
@@ -222,7 +243,8 @@ public:
 
   virtual void readNetlistBefore();
   virtual void setLinkFunc(LinkNetworkFunc *link);
-  void setTopInstance(Instance *top_inst);
+  virtual void setTopInstance(Instance *top_inst);
+  virtual void setPathDivider(char divider);
 
   using Network::netIterator;
   using Network::findPin;
@@ -243,12 +265,21 @@ protected:
   Instance *makeConcreteInstance(ConcreteCell *cell,
 				 const char *name,
 				 Instance *parent);
+  ConcretePin *makeConcretePin(ConcreteInstance *inst,
+			       ConcretePort *port,
+			       ConcreteNet *net);
   void disconnectNetPin(ConcreteNet *cnet,
 			ConcretePin *cpin);
   void connectNetPin(ConcreteNet *cnet,
 		     ConcretePin *cpin);
   void replaceCellIntenal(Instance *inst,
 			  ConcreteCell *cell);
+  const char *parentPathName(const ConcreteInstance *inst) const;
+  const ConcreteInstanceSeq *childNameIndex(const ConcreteInstance *inst) const;
+  const ConcreteNetSeq *netNameIndex(const ConcreteInstance *inst) const;
+  void deleteChildNameIndex(const ConcreteInstance *inst);
+  void deleteNetNameIndex(const ConcreteInstance *inst);
+  void deleteNameIndices();
 
   // Cell lookup search order sequence.
   ConcreteLibrarySeq library_seq_;
@@ -257,6 +288,16 @@ protected:
   NetSet constant_nets_[2];  // LogicValue::zero/one
   LinkNetworkFunc *link_func_;
   CellNetworkViewMap cell_network_view_map_;
+  // Name indices are built by the first wildcard match on an instance
+  // with many children/nets and deleted when they are edited.
+  mutable ConcreteChildNameIndex child_name_index_;
+  mutable ConcreteNetNameIndex net_name_index_;
+  mutable std::mutex name_index_lock_;
+  // Instances and pins are allocated from pools so they are contiguous
+  // in creation order for the graph and delay calc traversals.
+  ConcreteInstancePool instance_pool_;
+  ConcretePinPool pin_pool_;
+  std::mutex pool_lock_;
 
 private:
   DISALLOW_COPY_AND_ASSIGN(ConcreteNetwork);
@@ -288,13 +329,20 @@ public:
   void deleteNet(ConcreteNet *net);
   void setCell(ConcreteCell *cell);
   void initPins();
+  // Delete the cached path names of the instance and its children.
+  void clearPathNames();
 
-protected:
-  ConcreteInstance(ConcreteCell *cell,
-		   const char *name,
-		   ConcreteInstance *parent);
+  // Pool objects are default constructed and initialized by init.
+  ConcreteInstance();
   ~ConcreteInstance();
 
+protected:
+  void init(ConcreteCell *cell,
+	    const char *name,
+	    ConcreteInstance *parent);
+  // Delete the pins, child and net maps before returning to the pool.
+  void deleteContents();
+
   ConcreteCell *cell_;
   const char *name_;
   ConcreteInstance *parent_;
@@ -302,6 +350,11 @@ protected:
   ConcretePin **pins_;
   ConcreteInstanceChildMap *children_;
   ConcreteInstanceNetMap *nets_;
+  // Path name cached the first time the instance is used as a parent
+  // in ConcreteNetwork::pathName.  Instance names and parents do not
+  // change, so it is only cleared when the path divider changes
+  // (clearPathNames, called by ConcreteNetwork::setPathDivider).
+  mutable std::atomic<const char*> path_name_;
 
 private:
   DISALLOW_COPY_AND_ASSIGN(ConcreteInstance);
@@ -321,12 +374,15 @@ public:
   VertexIndex vertexIndex() const { return vertex_index_; }
   void setVertexIndex(VertexIndex index);
 
+  // Pool objects are default constructed and initialized by init.
+  ConcretePin();
+  ~ConcretePin() {}
+
 private:
   DISALLOW_COPY_AND_ASSIGN(ConcretePin);
-  ConcretePin(ConcreteInstance *instance,
-	      ConcretePort *port,
-	      ConcreteNet *net);
-  ~ConcretePin() {}
+  void init(ConcreteInstance *instance,
+	    ConcretePort *port,
+	    ConcreteNet *net);
 
   ConcreteInstance *instance_;
   ConcretePort *port_;
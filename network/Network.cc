@@ -177,6 +177,9 @@ Network::pathNameLess(const Instance *inst1,
   return pathNameCmp(inst1, inst2) < 0;
 }
 
+// Compare the instance paths top down without building the path
+// names.  Distinct siblings have distinct names, so the first names
+// that differ are those of the children of the lowest common ancestor.
 int
 Network::pathNameCmp(const Instance *inst1,
 		     const Instance *inst2) const
@@ -188,26 +191,34 @@ Network::pathNameCmp(const Instance *inst1,
   else if (inst1 == inst2)
     return 0;
   else {
-    ConstInstanceSeq path1;
-    ConstInstanceSeq path2;
-    path(inst1, path1);
-    path(inst2, path2);
-    while (!path1.empty() && !path2.empty()) {
-      const Instance *inst1 = path1.back();
-      const Instance *inst2 = path2.back();
-      int cmp = strcmp(name(inst1), name(inst2));
-      if (cmp != 0)
-	return cmp;
-      path1.pop_back();
-      path2.pop_back();
+    int depth1 = pathDepth(inst1);
+    int depth2 = pathDepth(inst2);
+    const Instance *above1 = inst1;
+    const Instance *above2 = inst2;
+    for (int i = depth1; i > depth2; i--)
+      above1 = parent(above1);
+    for (int i = depth2; i > depth1; i--)
+      above2 = parent(above2);
+    if (above1 == above2)
+      // One path is a prefix of the other.
+      return (depth1 < depth2) ? -1 : 1;
+    while (parent(above1) != parent(above2)) {
+      above1 = parent(above1);
+      above2 = parent(above2);
     }
-    if (path1.empty() && !path2.empty())
-      return -1;
-    else if (path1.empty() && path2.empty())
-      return 0;
-    else
-      return 1;
+    return strcmp(name(above1), name(above2));
+  }
+}
+
+int
+Network::pathDepth(const Instance *inst) const
+{
+  int depth = 0;
+  while (inst && !isTopInstance(inst)) {
+    depth++;
+    inst = parent(inst);
   }
+  return depth;
 }
 
 void
@@ -1451,7 +1462,9 @@ Network::drivers(const Pin *pin)
 void
 Network::clearNetDrvPinrMap()
 {
-  net_drvr_pin_map_.deleteContentsClear();
+  // Linking merges nets from multiple threads while the map is empty.
+  if (!net_drvr_pin_map_.empty())
+    net_drvr_pin_map_.deleteContentsClear();
 }
 
 PinSet *
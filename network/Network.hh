@@ -29,6 +29,7 @@ namespace sta {
 
 class Report;
 class PatternMatch;
+class MemoryReport;
 class PinVisitor;
 
 typedef Set<const Net*> ConstNetSet;
@@ -100,6 +101,8 @@ public:
 			   Report *report) = 0;
   virtual bool isLinked() const;
   virtual bool isEditable() const { return false; }
+  // Report estimated memory usage.
+  virtual void reportMemory(MemoryReport &) const {}
 
   ////////////////////////////////////////////////////////////////
   // Library functions.
@@ -121,6 +124,8 @@ public:
   virtual LibertyCell *findLibertyCell(const char *name) const;
   virtual LibertyLibrary *makeLibertyLibrary(const char *name,
 					     const char *filename) = 0;
+  // Add a library made outside of the network (see makeLibertyLibrary).
+  virtual void addLibertyLibrary(LibertyLibrary *library) = 0;
   // Hook for network after reading liberty library.
   virtual void readLibertyAfter(LibertyLibrary *library);
   // First liberty library read is used to look up defaults.
@@ -213,6 +218,8 @@ public:
   void path(const Instance *inst,
 	    // Return value.
 	    ConstInstanceSeq &path) const;
+  // Number of instances in the path below the top instance.
+  int pathDepth(const Instance *inst) const;
   virtual Cell *cell(const Instance *instance) const = 0;
   virtual const char *cellName(const Instance *instance) const;
   virtual LibertyLibrary *libertyLibrary(const Instance *instance) const;
@@ -520,6 +527,8 @@ public:
   // Called before reading a netlist to delete any previously linked network.
   virtual void readNetlistBefore() = 0;
   virtual void setLinkFunc(LinkNetworkFunc *link) = 0;
+  // Use an instance made without linking as the top instance.
+  virtual void setTopInstance(Instance *top_inst) = 0;
   virtual Library *makeLibrary(const char *name,
 			       const char *filename) = 0;
   // Search the libraries in read order for a cell by name.
@@ -555,6 +564,9 @@ public:
 			 Net *net) = 0;
   virtual void setDirection(Port *port,
 			    PortDirection *dir) = 0;
+  // Make room for the pins of an instance that was made before the
+  // ports of its cell. The instance must not have any pins.
+  virtual void initPins(Instance *inst) = 0;
   // Instance is the network view for cell.
   virtual void setCellNetworkView(Cell *cell,
 				  Instance *inst) = 0;
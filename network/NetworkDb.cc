@@ -0,0 +1,772 @@
+// OpenSTA, Static Timing Analyzer
+// Copyright (c) 2019, Parallax Software, Inc.
+// 
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+// 
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+// 
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#include <stdio.h>
+#include <string.h>
+#include <stdint.h>
+#include <string>
+#include "Machine.hh"
+#include "Report.hh"
+#include "Error.hh"
+#include "StringUtil.hh"
+#include "UnorderedMap.hh"
+#include "MappedFile.hh"
+#include "PortDirection.hh"
+#include "Network.hh"
+#include "NetworkDb.hh"
+
+namespace sta {
+
+// Bump the version when the record encoding changes.
+static const uint32_t network_db_version = 1;
+static const char network_db_magic[] = "OpenSTA network db";
+// Written in native byte order to reject databases from other machines.
+static const uint32_t network_db_byte_order = 0x01020304;
+
+enum class NetworkDbPort { scalar, bus, bundle };
+
+enum class NetworkDbConstant { none, zero, one };
+
+// String and cell ids.
+static const size_t db_id_define = 0;
+static const size_t db_id_null = 1;
+static const size_t db_id_first = 2;
+
+typedef UnorderedMap<const Port*, size_t> PortBitIndexMap;
+
+class NetworkDbWriter
+{
+public:
+  NetworkDbWriter(const char *filename,
+		  Network *network);
+  ~NetworkDbWriter();
+  void write();
+
+private:
+  DISALLOW_COPY_AND_ASSIGN(NetworkDbWriter);
+
+  void writeHeader();
+  void writeInstance(const Instance *inst);
+  void writeNets(const Instance *inst);
+  void writeCell(const Cell *cell,
+		 // Return value.
+		 PortBitIndexMap *&port_bits);
+  void writeCellPorts(const Cell *cell);
+  void writePortBits(const Cell *cell,
+		     PortBitIndexMap *port_bits);
+  void writeNetId(const Net *net);
+  void writeByte(int value);
+  void writeVarint(size_t value);
+  void writeInt(int value);
+  void writeName(const char *name);
+  void writeString(const char *str);
+
+  Network *network_;
+  FILE *stream_;
+  UnorderedMap<std::string, size_t> string_ids_;
+  UnorderedMap<const Cell*, size_t> cell_ids_;
+  // Port bit indices by cell id.
+  Vector<PortBitIndexMap*> cell_port_bits_;
+  UnorderedMap<const Net*, size_t> net_ids_;
+};
+
+class NetworkDbCell
+{
+public:
+  NetworkDbCell(Cell *cell,
+		Network *network);
+
+  Cell *cell_;
+  PortSeq port_bits_;
+};
+
+class NetworkDbReader
+{
+public:
+  NetworkDbReader(const char *filename,
+		  NetworkReader *network);
+  ~NetworkDbReader();
+  bool read();
+
+private:
+  DISALLOW_COPY_AND_ASSIGN(NetworkDbReader);
+
+  bool readHeader();
+  Instance *readInstance(Instance *parent);
+  void readNets(Instance *inst);
+  void readPins(Instance *inst,
+		NetworkDbCell *cell);
+  NetworkDbCell *readCell();
+  Cell *readCellDefinition(Library *library,
+			   const char *cell_name);
+  void readCellPorts(Cell *cell);
+  bool readPortBits(NetworkDbCell *cell);
+  Net *readNetId();
+  PortDirection *readDirection();
+  int readByte();
+  size_t readVarint();
+  int readInt();
+  const char *readName();
+  // Returns the string id or db_id_null.
+  size_t readStringId();
+  const char *readString();
+
+  const char *filename_;
+  NetworkReader *network_;
+  MappedFile file_;
+  const char *next_;
+  const char *end_;
+  bool error_;
+  // Interned strings (pointers into file_).
+  Vector<const char*> strings_;
+  Vector<NetworkDbCell*> cells_;
+  Vector<Net*> nets_;
+};
+
+void
+writeNetworkDb(const char *filename,
+	       Network *network)
+{
+  NetworkDbWriter writer(filename, network);
+  writer.write();
+}
+
+bool
+readNetworkDb(const char *filename,
+	      NetworkReader *network)
+{
+  NetworkDbReader reader(filename, network);
+  return reader.read();
+}
+
+NetworkDbWriter::NetworkDbWriter(const char *filename,
+				 Network *network) :
+  network_(network)
+{
+  stream_ = fopen(filename, "wb");
+  if (stream_ == nullptr)
+    throw FileNotWritable(filename);
+}
+
+NetworkDbWriter::~NetworkDbWriter()
+{
+  fclose(stream_);
+  cell_port_bits_.deleteContents();
+}
+
+void
+NetworkDbWriter::write()
+{
+  writeHeader();
+  writeInstance(network_->topInstance());
+}
+
+void
+NetworkDbWriter::writeHeader()
+{
+  fwrite(network_db_magic, sizeof(network_db_magic), 1, stream_);
+  fwrite(&network_db_version, sizeof(network_db_version), 1, stream_);
+  fwrite(&network_db_byte_order, sizeof(network_db_byte_order), 1, stream_);
+}
+
+// Instances are written top down so the nets a pin connects to
+// are written before the pin.
+void
+NetworkDbWriter::writeInstance(const Instance *inst)
+{
+  PortBitIndexMap *port_bits;
+  writeCell(network_->cell(inst), port_bits);
+  writeName(network_->name(inst));
+  writeNets(inst);
+
+  InstancePinIterator *pin_iter = network_->pinIterator(inst);
+  PinSeq pins;
+  while (pin_iter->hasNext())
+    pins.push_back(pin_iter->next());
+  delete pin_iter;
+  writeVarint(pins.size());
+  for (Pin *pin : pins) {
+    writeVarint((*port_bits)[network_->port(pin)]);
+    writeNetId(network_->net(pin));
+    Term *term = network_->term(pin);
+    writeNetId(term ? network_->net(term) : nullptr);
+  }
+
+  InstanceSeq children;
+  InstanceChildIterator *child_iter = network_->childIterator(inst);
+  while (child_iter->hasNext())
+    children.push_back(child_iter->next());
+  delete child_iter;
+  writeVarint(children.size());
+  for (Instance *child : children)
+    writeInstance(child);
+}
+
+void
+NetworkDbWriter::writeNets(const Instance *inst)
+{
+  NetSeq nets;
+  InstanceNetIterator *net_iter = network_->netIterator(inst);
+  while (net_iter->hasNext())
+    nets.push_back(net_iter->next());
+  delete net_iter;
+  writeVarint(nets.size());
+  for (Net *net : nets) {
+    size_t id = net_ids_.size();
+    net_ids_[net] = id;
+    writeName(network_->name(net));
+    NetworkDbConstant constant = NetworkDbConstant::none;
+    if (network_->isGround(net))
+      constant = NetworkDbConstant::zero;
+    else if (network_->isPower(net))
+      constant = NetworkDbConstant::one;
+    writeByte(static_cast<int>(constant));
+  }
+}
+
+void
+NetworkDbWriter::writeNetId(const Net *net)
+{
+  if (net) {
+    auto id_iter = net_ids_.find(net);
+    // Nets outside the hierarchy (merged away) are not connected.
+    if (id_iter == net_ids_.end())
+      writeVarint(db_id_null);
+    else
+      writeVarint(id_iter->second + db_id_first);
+  }
+  else
+    writeVarint(db_id_null);
+}
+
+void
+NetworkDbWriter::writeCell(const Cell *cell,
+			   // Return value.
+			   PortBitIndexMap *&port_bits)
+{
+  auto id_iter = cell_ids_.find(cell);
+  if (id_iter == cell_ids_.end()) {
+    size_t id = cell_ids_.size();
+    cell_ids_[cell] = id;
+    port_bits = new PortBitIndexMap;
+    cell_port_bits_.push_back(port_bits);
+    writeVarint(db_id_define);
+    writeString(network_->name(network_->library(cell)));
+    writeString(network_->name(cell));
+    // Liberty cells are references to the libraries already read.
+    bool is_liberty = network_->libertyCell(const_cast<Cell*>(cell));
+    writeByte(!is_liberty);
+    if (!is_liberty) {
+      writeByte(network_->isLeaf(cell));
+      writeString(network_->filename(const_cast<Cell*>(cell)));
+      writeCellPorts(cell);
+    }
+    writePortBits(cell, port_bits);
+  }
+  else {
+    size_t id = id_iter->second;
+    port_bits = cell_port_bits_[id];
+    writeVarint(id + db_id_first);
+  }
+}
+
+void
+NetworkDbWriter::writeCellPorts(const Cell *cell)
+{
+  PortSeq ports;
+  CellPortIterator *port_iter = network_->portIterator(cell);
+  while (port_iter->hasNext())
+    ports.push_back(port_iter->next());
+  delete port_iter;
+  writeVarint(ports.size());
+  for (Port *port : ports) {
+    writeString(network_->name(port));
+    if (network_->isBundle(port)) {
+      writeByte(static_cast<int>(NetworkDbPort::bundle));
+      PortSeq members;
+      PortMemberIterator *member_iter = network_->memberIterator(port);
+      while (member_iter->hasNext())
+	members.push_back(member_iter->next());
+      delete member_iter;
+      writeVarint(members.size());
+      for (Port *member : members)
+	writeString(network_->name(member));
+    }
+    else {
+      if (network_->isBus(port)) {
+	writeByte(static_cast<int>(NetworkDbPort::bus));
+	writeInt(network_->fromIndex(port));
+	writeInt(network_->toIndex(port));
+      }
+      else
+	writeByte(static_cast<int>(NetworkDbPort::scalar));
+      writeVarint(network_->direction(port)->index());
+    }
+  }
+}
+
+// Port bit names are written for every cell so the reader can check
+// that the cell has not changed since the database was written.
+void
+NetworkDbWriter::writePortBits(const Cell *cell,
+			       PortBitIndexMap *port_bits)
+{
+  writeVarint(network_->portBitCount(cell));
+  CellPortBitIterator *port_iter = network_->portBitIterator(cell);
+  while (port_iter->hasNext()) {
+    Port *port = port_iter->next();
+    size_t index = port_bits->size();
+    (*port_bits)[port] = index;
+    writeString(network_->name(port));
+  }
+  delete port_iter;
+}
+
+void
+NetworkDbWriter::writeByte(int value)
+{
+  putc(value, stream_);
+}
+
+void
+NetworkDbWriter::writeVarint(size_t value)
+{
+  while (value >= 0x80) {
+    putc((value & 0x7f) | 0x80, stream_);
+    value >>= 7;
+  }
+  putc(value, stream_);
+}
+
+void
+NetworkDbWriter::writeInt(int value)
+{
+  fwrite(&value, sizeof(value), 1, stream_);
+}
+
+// Instance and net names are mostly unique so they are not interned.
+void
+NetworkDbWriter::writeName(const char *name)
+{
+  size_t length = strlen(name);
+  writeVarint(length);
+  // Include the terminator so the reader can use the mapped string.
+  fwrite(name, length + 1, 1, stream_);
+}
+
+void
+NetworkDbWriter::writeString(const char *str)
+{
+  if (str == nullptr)
+    writeVarint(db_id_null);
+  else {
+    auto id_iter = string_ids_.find(str);
+    if (id_iter == string_ids_.end()) {
+      size_t id = string_ids_.size();
+      string_ids_[str] = id;
+      writeVarint(db_id_define);
+      writeName(str);
+    }
+    else
+      writeVarint(id_iter->second + db_id_first);
+  }
+}
+
+////////////////////////////////////////////////////////////////
+
+NetworkDbCell::NetworkDbCell(Cell *cell,
+			     Network *network) :
+  cell_(cell)
+{
+  CellPortBitIterator *port_iter = network->portBitIterator(cell);
+  while (port_iter->hasNext())
+    port_bits_.push_back(port_iter->next());
+  delete port_iter;
+}
+
+NetworkDbReader::NetworkDbReader(const char *filename,
+				 NetworkReader *network) :
+  filename_(filename),
+  network_(network),
+  file_(filename),
+  next_(file_.data()),
+  end_(file_.data() + file_.size()),
+  error_(false)
+{
+}
+
+NetworkDbReader::~NetworkDbReader()
+{
+  cells_.deleteContents();
+}
+
+bool
+NetworkDbReader::read()
+{
+  Report *report = network_->report();
+  if (!readHeader()) {
+    report->error("%s is not a network db for this version.\n", filename_);
+    return false;
+  }
+  Instance *top_inst = readInstance(nullptr);
+  if (error_) {
+    if (top_inst)
+      network_->deleteInstance(top_inst);
+    report->error("network db %s is corrupt or does not match the libraries.\n",
+		  filename_);
+    return false;
+  }
+  network_->setTopInstance(top_inst);
+  return true;
+}
+
+bool
+NetworkDbReader::readHeader()
+{
+  size_t header_size = sizeof(network_db_magic)
+    + sizeof(network_db_version)
+    + sizeof(network_db_byte_order);
+  if (file_.size() >= header_size
+      && memcmp(next_, network_db_magic, sizeof(network_db_magic)) == 0) {
+    next_ += sizeof(network_db_magic);
+    uint32_t version, byte_order;
+    memcpy(&version, next_, sizeof(version));
+    next_ += sizeof(version);
+    memcpy(&byte_order, next_, sizeof(byte_order));
+    next_ += sizeof(byte_order);
+    return version == network_db_version
+      && byte_order == network_db_byte_order;
+  }
+  return false;
+}
+
+Instance *
+NetworkDbReader::readInstance(Instance *parent)
+{
+  NetworkDbCell *cell = readCell();
+  const char *name = readName();
+  if (cell == nullptr || name == nullptr) {
+    error_ = true;
+    return nullptr;
+  }
+  Instance *inst = network_->makeInstance(cell->cell_, name, parent);
+  readNets(inst);
+  readPins(inst, cell);
+  size_t child_count = readVarint();
+  for (size_t i = 0; i < child_count && !error_; i++)
+    readInstance(inst);
+  return inst;
+}
+
+void
+NetworkDbReader::readNets(Instance *inst)
+{
+  size_t net_count = readVarint();
+  for (size_t i = 0; i < net_count && !error_; i++) {
+    const char *name = readName();
+    NetworkDbConstant constant = static_cast<NetworkDbConstant>(readByte());
+    if (name) {
+      Net *net = network_->makeNet(name, inst);
+      nets_.push_back(net);
+      if (constant == NetworkDbConstant::zero)
+	network_->addConstantNet(net, LogicValue::zero);
+      else if (constant == NetworkDbConstant::one)
+	network_->addConstantNet(net, LogicValue::one);
+    }
+  }
+}
+
+void
+NetworkDbReader::readPins(Instance *inst,
+			  NetworkDbCell *cell)
+{
+  size_t pin_count = readVarint();
+  for (size_t i = 0; i < pin_count && !error_; i++) {
+    size_t port_index = readVarint();
+    Net *net = readNetId();
+    Net *term_net = readNetId();
+    if (port_index < cell->port_bits_.size()) {
+      Port *port = cell->port_bits_[port_index];
+      Pin *pin = network_->makePin(inst, port, net);
+      if (term_net)
+	network_->makeTerm(pin, term_net);
+    }
+    else
+      error_ = true;
+  }
+}
+
+Net *
+NetworkDbReader::readNetId()
+{
+  size_t id = readVarint();
+  if (id == db_id_null)
+    return nullptr;
+  else if (id >= db_id_first && id - db_id_first < nets_.size())
+    return nets_[id - db_id_first];
+  else {
+    error_ = true;
+    return nullptr;
+  }
+}
+
+NetworkDbCell *
+NetworkDbReader::readCell()
+{
+  size_t id = readVarint();
+  if (id == db_id_define) {
+    const char *lib_name = readString();
+    const char *cell_name = readString();
+    bool is_defined = readByte();
+    if (lib_name == nullptr || cell_name == nullptr) {
+      error_ = true;
+      return nullptr;
+    }
+    Library *library = network_->findLibrary(lib_name);
+    Cell *cell = nullptr;
+    if (is_defined) {
+      if (library == nullptr)
+	library = network_->makeLibrary(lib_name, nullptr);
+      cell = readCellDefinition(library, cell_name);
+    }
+    else if (library) {
+      cell = network_->findCell(library, cell_name);
+      if (cell == nullptr)
+	network_->report()->error("cell %s not found in library %s.\n",
+				  cell_name, lib_name);
+    }
+    else
+      network_->report()->error("library %s not found.\n", lib_name);
+    if (cell == nullptr) {
+      error_ = true;
+      return nullptr;
+    }
+    NetworkDbCell *db_cell = new NetworkDbCell(cell, network_);
+    cells_.push_back(db_cell);
+    if (!readPortBits(db_cell)) {
+      network_->report()->error("cell %s ports do not match the network db.\n",
+				cell_name);
+      error_ = true;
+      return nullptr;
+    }
+    return db_cell;
+  }
+  else if (id >= db_id_first && id - db_id_first < cells_.size())
+    return cells_[id - db_id_first];
+  else {
+    error_ = true;
+    return nullptr;
+  }
+}
+
+// Cells that already exist (from reading verilog) are used as long
+// as their ports match.
+Cell *
+NetworkDbReader::readCellDefinition(Library *library,
+				    const char *cell_name)
+{
+  bool is_leaf = readByte();
+  const char *filename = readString();
+  Cell *cell = network_->findCell(library, cell_name);
+  if (cell)
+    // Skip the port definitions.
+    readCellPorts(nullptr);
+  else {
+    cell = network_->makeCell(library, cell_name, is_leaf, filename);
+    readCellPorts(cell);
+  }
+  return cell;
+}
+
+// Ports are only made if cell is non-null.
+void
+NetworkDbReader::readCellPorts(Cell *cell)
+{
+  size_t port_count = readVarint();
+  for (size_t i = 0; i < port_count && !error_; i++) {
+    const char *port_name = readString();
+    NetworkDbPort port_type = static_cast<NetworkDbPort>(readByte());
+    if (port_name == nullptr) {
+      error_ = true;
+      break;
+    }
+    switch (port_type) {
+    case NetworkDbPort::scalar: {
+      PortDirection *dir = readDirection();
+      if (cell) {
+	Port *port = network_->makePort(cell, port_name);
+	network_->setDirection(port, dir);
+      }
+      break;
+    }
+    case NetworkDbPort::bus: {
+      int from_index = readInt();
+      int to_index = readInt();
+      PortDirection *dir = readDirection();
+      if (cell) {
+	Port *port = network_->makeBusPort(cell, port_name,
+					   from_index, to_index);
+	network_->setDirection(port, dir);
+      }
+      break;
+    }
+    case NetworkDbPort::bundle: {
+      size_t member_count = readVarint();
+      PortSeq *members = cell ? new PortSeq : nullptr;
+      for (size_t j = 0; j < member_count && !error_; j++) {
+	const char *member_name = readString();
+	if (cell) {
+	  Port *member = member_name
+	    ? network_->findPort(cell, member_name)
+	    : nullptr;
+	  if (member)
+	    members->push_back(member);
+	  else
+	    error_ = true;
+	}
+      }
+      if (cell)
+	network_->makeBundlePort(cell, port_name, members);
+      break;
+    }
+    default:
+      error_ = true;
+      break;
+    }
+  }
+}
+
+bool
+NetworkDbReader::readPortBits(NetworkDbCell *cell)
+{
+  size_t port_bit_count = readVarint();
+  bool match = (port_bit_count == cell->port_bits_.size());
+  for (size_t i = 0; i < port_bit_count && !error_; i++) {
+    const char *port_name = readString();
+    if (match
+	&& !(port_name
+	     && stringEq(port_name, network_->name(cell->port_bits_[i]))))
+      match = false;
+  }
+  return match && !error_;
+}
+
+PortDirection *
+NetworkDbReader::readDirection()
+{
+  static PortDirection *directions[] = {PortDirection::input(),
+					PortDirection::output(),
+					PortDirection::tristate(),
+					PortDirection::bidirect(),
+					PortDirection::internal(),
+					PortDirection::ground(),
+					PortDirection::power(),
+					PortDirection::unknown()};
+  int index = readVarint();
+  for (PortDirection *dir : directions) {
+    if (dir->index() == index)
+      return dir;
+  }
+  error_ = true;
+  return PortDirection::unknown();
+}
+
+int
+NetworkDbReader::readByte()
+{
+  if (next_ < end_)
+    return static_cast<unsigned char>(*next_++);
+  else {
+    error_ = true;
+    return 0;
+  }
+}
+
+size_t
+NetworkDbReader::readVarint()
+{
+  size_t value = 0;
+  int shift = 0;
+  int byte;
+  do {
+    byte = readByte();
+    value |= static_cast<size_t>(byte & 0x7f) << shift;
+    shift += 7;
+  } while ((byte & 0x80) && !error_);
+  return value;
+}
+
+int
+NetworkDbReader::readInt()
+{
+  int value = 0;
+  if (next_ + sizeof(value) <= end_) {
+    memcpy(&value, next_, sizeof(value));
+    next_ += sizeof(value);
+  }
+  else
+    error_ = true;
+  return value;
+}
+
+const char *
+NetworkDbReader::readName()
+{
+  size_t length = readVarint();
+  if (!error_ && next_ + length < end_ && next_[length] == '\0') {
+    const char *name = next_;
+    next_ += length + 1;
+    return name;
+  }
+  else {
+    error_ = true;
+    return nullptr;
+  }
+}
+
+size_t
+NetworkDbReader::readStringId()
+{
+  size_t id = readVarint();
+  if (id == db_id_define) {
+    const char *str = readName();
+    if (str) {
+      strings_.push_back(str);
+      return strings_.size() - 1 + db_id_first;
+    }
+    else
+      return db_id_null;
+  }
+  else if (id == db_id_null
+	   || (id >= db_id_first && id - db_id_first < strings_.size()))
+    return id;
+  else {
+    error_ = true;
+    return db_id_null;
+  }
+}
+
+const char *
+NetworkDbReader::readString()
+{
+  size_t id = readStringId();
+  if (id == db_id_null)
+    return nullptr;
+  else
+    return strings_[id - db_id_first];
+}
+
+} // namespace
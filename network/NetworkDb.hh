@@ -0,0 +1,45 @@
+// OpenSTA, Static Timing Analyzer
+// Copyright (c) 2019, Parallax Software, Inc.
+// 
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+// 
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+// 
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#ifndef STA_NETWORK_DB_H
+#define STA_NETWORK_DB_H
+
+namespace sta {
+
+class Network;
+class NetworkReader;
+
+// A network database is a binary snapshot of the linked network:
+// the instance hierarchy with its pins, nets and terms. Liberty
+// cells are recorded by library and cell name and must be read
+// before the database. Verilog module and black box cells are
+// recorded with their ports. Reading the database makes the top
+// instance without reading or linking verilog again.
+// The format is machine dependent and versioned.
+
+// Throws FileNotWritable.
+void
+writeNetworkDb(const char *filename,
+	       Network *network);
+
+// Throws FileNotReadable.
+// Return true if successful.
+bool
+readNetworkDb(const char *filename,
+	      NetworkReader *network);
+
+} // namespace
+#endif
@@ -894,6 +894,12 @@ NetworkNameAdapter::makeLibertyLibrary(const char *name,
   return network_edit_->makeLibertyLibrary(name, filename);
 }
 
+void
+NetworkNameAdapter::addLibertyLibrary(LibertyLibrary *library)
+{
+  network_edit_->addLibertyLibrary(library);
+}
+
 Instance *
 NetworkNameAdapter::makeInstance(LibertyCell *cell,
 				 const char *name,
@@ -119,6 +119,7 @@ public:
   virtual bool isEditable() const;
   virtual LibertyLibrary *makeLibertyLibrary(const char *name,
 					     const char *filename);
+  virtual void addLibertyLibrary(LibertyLibrary *library);
   virtual Instance *makeInstance(LibertyCell *cell,
 				 const char *name,
 				 Instance *parent);
@@ -61,21 +61,43 @@ vstringAppend(char *&str,
   *insert++ = ch;
 }
 
+// True if sta_name has to be escaped in verilog.
+static bool
+staToVerilogEscaped(const char *sta_name,
+		    bool escape_brkts,
+		    const char escape)
+{
+  const char bus_brkt_left = '[';
+  const char bus_brkt_right = ']';
+  for (const char *s = sta_name; *s ; s++) {
+    char ch = s[0];
+    if (ch == escape) {
+      if (s[1] != escape)
+	return true;
+      s++;
+    }
+    else if (!(isalnum(ch) || ch == '_')) {
+      bool is_brkt = (ch == bus_brkt_left || ch == bus_brkt_right);
+      if (!is_brkt || escape_brkts)
+	return true;
+    }
+  }
+  return false;
+}
+
 const char *
 staToVerilog(const char *sta_name,
 	     bool escape_brkts,
 	     const char escape)
 {
-  const char bus_brkt_left = '[';
-  const char bus_brkt_right = ']';
-  // Leave room for leading escape and trailing space if the name
-  // needs to be escaped.
+  // Most names do not need to be escaped, so look before copying.
+  if (!staToVerilogEscaped(sta_name, escape_brkts, escape))
+    return sta_name;
+  // Leave room for leading escape and trailing space.
   size_t verilog_name_length = strlen(sta_name) + 3;
   char *verilog_name = makeTmpString(verilog_name_length);
   char *verilog_name_end = &verilog_name[verilog_name_length];
   char *v = verilog_name;
-  // Assume the name has to be escaped and start copying while scanning.
-  bool escaped = false;
   *v++ = '\\';
   for (const char *s = sta_name; *s ; s++) {
     char ch = s[0];
@@ -86,26 +108,15 @@ staToVerilog(const char *sta_name,
 	vstringAppend(verilog_name, verilog_name_end, v, next_ch);
 	s++;
       }
-      else
-	// Skip escape.
-	escaped = true;
+      // Skip escape.
     }
-    else {
-      bool is_brkt = (ch == bus_brkt_left || ch == bus_brkt_right);
-      if ((!(isalnum(ch) || ch == '_') && !is_brkt)
-	  || (is_brkt && escape_brkts))
-	escaped = true;
+    else
       vstringAppend(verilog_name, verilog_name_end, v, ch);
-    }
-  }
-  if (escaped) {
-    // Add a terminating space.
-    vstringAppend(verilog_name, verilog_name_end, v, ' ');
-    vstringAppend(verilog_name, verilog_name_end, v, '\0');
-    return verilog_name;
   }
-  else
-    return sta_name;
+  // Add a terminating space.
+  vstringAppend(verilog_name, verilog_name_end, v, ' ');
+  vstringAppend(verilog_name, verilog_name_end, v, '\0');
+  return verilog_name;
 }
 
 const char *
@@ -21,6 +21,7 @@
 #include "Debug.hh"
 #include "Error.hh"
 #include "Mutex.hh"
+#include "MemoryReport.hh"
 #include "Set.hh"
 #include "MinMax.hh"
 #include "Network.hh"
@@ -469,7 +470,8 @@ ConcretePiPoleResidue::deleteLoad(const Pin *load_pin)
 
 ////////////////////////////////////////////////////////////////
 
-ConcreteParasiticNode::ConcreteParasiticNode() :
+ConcreteParasiticNode::ConcreteParasiticNode(ConcreteParasiticNetwork *network) :
+  network_(network),
   cap_(0.0)
 {
 }
@@ -494,9 +496,10 @@ ConcreteParasiticNode::addDevice(ConcreteParasiticDevice *device)
 
 ////////////////////////////////////////////////////////////////
 
-ConcreteParasiticSubNode::ConcreteParasiticSubNode(const Net *net,
+ConcreteParasiticSubNode::ConcreteParasiticSubNode(ConcreteParasiticNetwork *network,
+						   const Net *net,
 						   int id) :
-  ConcreteParasiticNode(),
+  ConcreteParasiticNode(network),
   net_(net),
   id_(id)
 {
@@ -511,8 +514,9 @@ ConcreteParasiticSubNode::name(const Network *network) const
 
 ////////////////////////////////////////////////////////////////
 
-ConcreteParasiticPinNode::ConcreteParasiticPinNode(const Pin *pin) :
-  ConcreteParasiticNode(),
+ConcreteParasiticPinNode::ConcreteParasiticPinNode(ConcreteParasiticNetwork *network,
+						   const Pin *pin) :
+  ConcreteParasiticNode(network),
   pin_(pin)
 {
 }
@@ -674,6 +678,47 @@ ConcreteCouplingCapExtPin::replaceNode(ConcreteParasiticNode *from_node,
 
 ////////////////////////////////////////////////////////////////
 
+ConcreteParasiticArena::ConcreteParasiticArena() :
+  next_(nullptr),
+  free_(0),
+  size_(0)
+{
+}
+
+ConcreteParasiticArena::~ConcreteParasiticArena()
+{
+  for (char *block : blocks_)
+    delete [] block;
+}
+
+void *
+ConcreteParasiticArena::alloc(size_t size)
+{
+  // Keep objects pointer aligned.
+  size = (size + alignof(void*) - 1) & ~(alignof(void*) - 1);
+  if (size > free_) {
+    // Double the block size as the network grows so small networks
+    // stay small and big ones only need a few blocks.
+    size_t block_size = size_;
+    if (block_size < block_size_min_)
+      block_size = block_size_min_;
+    else if (block_size > block_size_max_)
+      block_size = block_size_max_;
+    if (block_size < size)
+      block_size = size;
+    next_ = new char[block_size];
+    free_ = block_size;
+    size_ += block_size;
+    blocks_.push_back(next_);
+  }
+  void *object = next_;
+  next_ += size;
+  free_ -= size;
+  return object;
+}
+
+////////////////////////////////////////////////////////////////
+
 ConcreteParasiticNetwork::ConcreteParasiticNetwork(bool includes_pin_caps) :
   max_node_id_(0),
   includes_pin_caps_(includes_pin_caps)
@@ -686,26 +731,28 @@ ConcreteParasiticNetwork::~ConcreteParasiticNetwork()
   deleteNodes();
 }
 
+// Nodes and devices are allocated in the arena, so only their
+// destructors are called here.  The arena frees the memory.
 void
 ConcreteParasiticNetwork::deleteNodes()
 {
   ConcreteParasiticSubNodeMap::Iterator node_iter1(sub_nodes_);
   while (node_iter1.hasNext()) {
-    NetId *net_id;
-    ConcreteParasiticSubNode *node;
-    node_iter1.next(net_id, node);
-    delete net_id;
-    delete node;
+    ConcreteParasiticSubNode *node = node_iter1.next();
+    node->~ConcreteParasiticSubNode();
+  }
+  ConcreteParasiticPinNodeMap::Iterator node_iter2(pin_nodes_);
+  while (node_iter2.hasNext()) {
+    ConcreteParasiticPinNode *node = node_iter2.next();
+    node->~ConcreteParasiticPinNode();
   }
-  pin_nodes_.deleteContents();
 }
 
 void
 ConcreteParasiticNetwork::deleteDevices()
 {
-  ConcreteParasiticDeviceSet devices1;
-  devices(&devices1);
-  devices1.deleteContents();
+  for (ConcreteParasiticDevice *device : devices_)
+    device->~ConcreteParasiticDevice();
 }
 
 ParasiticNodeIterator *
@@ -728,35 +775,62 @@ ConcreteParasiticNetwork::nodeIterator()
 ParasiticDeviceIterator *
 ConcreteParasiticNetwork::deviceIterator()
 {
-  ConcreteParasiticDeviceSet *devices1 = new ConcreteParasiticDeviceSet();
-  devices(devices1);
-  return new ConcreteParasiticDeviceSetIterator(devices1);
+  return new ConcreteParasiticDeviceSeqIterator(&devices_);
 }
 
 void
-ConcreteParasiticNetwork::devices(ConcreteParasiticDeviceSet *devices)
+ConcreteParasiticNetwork::makeResistor(const char *name,
+				       ConcreteParasiticNode *node1,
+				       ConcreteParasiticNode *node2,
+				       float res)
 {
-  // Collect devices into a set so they are only deleted once
-  // because multiple sub-nodes or pin nodes can refer to them.
-  ConcreteParasiticSubNodeMap::Iterator node_iter1(sub_nodes_);
-  while (node_iter1.hasNext()) {
-    ConcreteParasiticSubNode *node = node_iter1.next();
-    ConcreteParasiticDeviceSeq::Iterator device_iter(node->devices());
-    while (device_iter.hasNext()) {
-      ConcreteParasiticDevice *device = device_iter.next();
-      devices->insert(device);
-    }
-  }
+  ConcreteParasiticDevice *resistor =
+    new (arena_.alloc(sizeof(ConcreteParasiticResistor)))
+    ConcreteParasiticResistor(name, node1, node2, res);
+  devices_.push_back(resistor);
+  node1->addDevice(resistor);
+  node2->addDevice(resistor);
+}
 
-  ConcreteParasiticPinNodeMap::Iterator node_iter2(pin_nodes_);
-  while (node_iter2.hasNext()) {
-    ConcreteParasiticPinNode *node = node_iter2.next();
-    ConcreteParasiticDeviceSeq::Iterator device_iter(node->devices());
-    while (device_iter.hasNext()) {
-      ConcreteParasiticDevice *device = device_iter.next();
-      devices->insert(device);
-    }
-  }
+void
+ConcreteParasiticNetwork::makeCouplingCap(const char *name,
+					  ConcreteParasiticNode *node,
+					  ConcreteParasiticNode *other_node,
+					  float cap)
+{
+  ConcreteCouplingCap *coupling_cap =
+    new (arena_.alloc(sizeof(ConcreteCouplingCapInt)))
+    ConcreteCouplingCapInt(name, node, other_node, cap);
+  devices_.push_back(coupling_cap);
+  node->addDevice(coupling_cap);
+  other_node->addDevice(coupling_cap);
+}
+
+void
+ConcreteParasiticNetwork::makeCouplingCap(const char *name,
+					  ConcreteParasiticNode *node,
+					  Net *other_node_net,
+					  int other_node_id,
+					  float cap)
+{
+  ConcreteCouplingCap *coupling_cap =
+    new (arena_.alloc(sizeof(ConcreteCouplingCapExtNode)))
+    ConcreteCouplingCapExtNode(name, node, other_node_net, other_node_id, cap);
+  devices_.push_back(coupling_cap);
+  node->addDevice(coupling_cap);
+}
+
+void
+ConcreteParasiticNetwork::makeCouplingCap(const char *name,
+					  ConcreteParasiticNode *node,
+					  Pin *other_node_pin,
+					  float cap)
+{
+  ConcreteCouplingCap *coupling_cap =
+    new (arena_.alloc(sizeof(ConcreteCouplingCapExtPin)))
+    ConcreteCouplingCapExtPin(name, node, other_node_pin, cap);
+  devices_.push_back(coupling_cap);
+  node->addDevice(coupling_cap);
 }
 
 float
@@ -782,10 +856,11 @@ ConcreteParasiticNetwork::ensureParasiticNode(const Net *net,
 					      int id)
 {
   NetId net_id(net, id);
-  ConcreteParasiticSubNode *node = sub_nodes_.findKey(&net_id);
+  ConcreteParasiticSubNode *node = sub_nodes_.findKey(net_id);
   if (node == nullptr) {
-    node = new ConcreteParasiticSubNode(net, id);
-    sub_nodes_[new NetId(net, id)] = node;
+    node = new (arena_.alloc(sizeof(ConcreteParasiticSubNode)))
+      ConcreteParasiticSubNode(this, net, id);
+    sub_nodes_[net_id] = node;
     max_node_id_ = max((int) max_node_id_, id);
   }
   return node;
@@ -814,7 +889,7 @@ ConcreteParasiticNetwork::disconnectPin(const Pin *pin,
     }
 
     pin_nodes_.erase(pin);
-    delete node;
+    node->~ConcreteParasiticNode();
   }
 }
 
@@ -823,20 +898,21 @@ ConcreteParasiticNetwork::ensureParasiticNode(const Pin *pin)
 {
   ConcreteParasiticPinNode *node = pin_nodes_.findKey(pin);
   if (node == nullptr) {
-    node = new ConcreteParasiticPinNode(pin);
+    node = new (arena_.alloc(sizeof(ConcreteParasiticPinNode)))
+      ConcreteParasiticPinNode(this, pin);
     pin_nodes_[pin] = node;
   }
   return node;
 }
 
 bool
-NetIdLess::operator()(const NetId *net_id1,
-		      const NetId *net_id2) const
+NetIdLess::operator()(const NetId &net_id1,
+		      const NetId &net_id2) const
 {
-  const Net *net1 = net_id1->first;
-  const Net *net2 = net_id2->first;
-  int id1 = net_id1->second;
-  int id2 = net_id2->second;
+  const Net *net1 = net_id1.first;
+  const Net *net2 = net_id2.first;
+  int id1 = net_id1.second;
+  int id2 = net_id2.second;
   return net1 < net2
     || (net1 == net2
 	&& id1 < id2);
@@ -850,6 +926,38 @@ makeConcreteParasitics(StaState *sta)
   return new ConcreteParasitics(sta);
 }
 
+ConcreteReducedModel::ConcreteReducedModel(const Parasitic *parasitic_network,
+					   const OperatingConditions *op_cond,
+					   const Corner *corner,
+					   const MinMax *cnst_min_max,
+					   ConcreteParasitic *model) :
+  parasitic_network_(parasitic_network),
+  op_cond_(op_cond),
+  corner_(corner),
+  cnst_min_max_(cnst_min_max),
+  model_(model)
+{
+}
+
+ConcreteReducedModel::~ConcreteReducedModel()
+{
+  delete model_;
+}
+
+bool
+ConcreteReducedModel::matches(const Parasitic *parasitic_network,
+			      const OperatingConditions *op_cond,
+			      const Corner *corner,
+			      const MinMax *cnst_min_max) const
+{
+  return parasitic_network == parasitic_network_
+    && op_cond == op_cond_
+    && corner == corner_
+    && cnst_min_max == cnst_min_max_;
+}
+
+////////////////////////////////////////////////////////////////
+
 ConcreteParasitics::ConcreteParasitics(StaState *sta) :
   Parasitics(sta)
 {
@@ -864,7 +972,8 @@ bool
 ConcreteParasitics::haveParasitics()
 {
   return !drvr_parasitic_map_.empty()
-    || !parasitic_network_map_.empty();
+    || !parasitic_network_map_.empty()
+    || !loaders_.empty();
 }
 
 void
@@ -880,13 +989,91 @@ ConcreteParasitics::parasiticAnalysisPtIndex(const ParasiticAnalysisPt *ap,
   return ap->index() * TransRiseFall::index_count + tr->index();
 }
 
+void
+ConcreteParasitics::reportMemory(MemoryReport &memory) const
+{
+  int ap_count = corners_->parasiticAnalysisPtCount();
+  int ap_tr_count = ap_count * TransRiseFall::index_count;
+  size_t reduced_count = 0;
+  size_t reduced_bytes = drvr_parasitic_map_.size()
+    * (MemoryReport::hash_node_bytes
+       + 2 * sizeof(void*)
+       + ap_tr_count * sizeof(ConcreteParasitic*));
+  ConcreteParasiticMap::Iterator drvr_iter(&drvr_parasitic_map_);
+  while (drvr_iter.hasNext()) {
+    const Pin *drvr_pin;
+    ConcreteParasitic **parasitics;
+    drvr_iter.next(drvr_pin, parasitics);
+    if (parasitics) {
+      for (int i = 0; i < ap_tr_count; i++) {
+	ConcreteParasitic *parasitic = parasitics[i];
+	if (parasitic) {
+	  reduced_count++;
+	  if (parasitic->isPiElmore())
+	    reduced_bytes += sizeof(ConcretePiElmore);
+	  else if (parasitic->isPiPoleResidue())
+	    reduced_bytes += sizeof(ConcretePiPoleResidue);
+	  else
+	    reduced_bytes += sizeof(ConcretePoleResidue);
+	}
+      }
+    }
+  }
+  memory.reportUsage("Parasitics", "reduced models", reduced_count,
+		     reduced_bytes);
+
+  size_t network_count = 0;
+  size_t node_count = 0;
+  size_t device_count = 0;
+  size_t network_bytes = parasitic_network_map_.size()
+    * (MemoryReport::hash_node_bytes
+       + 2 * sizeof(void*)
+       + ap_count * sizeof(ConcreteParasiticNetwork*));
+  ConcreteParasiticNetworkMap::Iterator net_iter(&parasitic_network_map_);
+  while (net_iter.hasNext()) {
+    const Net *net;
+    ConcreteParasiticNetwork **parasitics;
+    net_iter.next(net, parasitics);
+    if (parasitics) {
+      for (int i = 0; i < ap_count; i++) {
+	ConcreteParasiticNetwork *parasitic = parasitics[i];
+	if (parasitic) {
+	  network_count++;
+	  // Nodes and devices are allocated in the network arena.
+	  network_bytes += sizeof(ConcreteParasiticNetwork)
+	    + parasitic->arenaSize();
+	  size_t pin_node_count = parasitic->pinNodes()->size();
+	  size_t sub_node_count = parasitic->subNodes()->size();
+	  node_count += pin_node_count + sub_node_count;
+	  network_bytes += pin_node_count
+	    * (MemoryReport::map_node_bytes + 2 * sizeof(void*));
+	  network_bytes += sub_node_count
+	    * (MemoryReport::map_node_bytes + sizeof(NetId) + sizeof(void*));
+	  size_t devices_count = parasitic->devices()->size();
+	  device_count += devices_count;
+	  // Devices are referenced by the network and each node they connect.
+	  network_bytes += devices_count * 3 * sizeof(ConcreteParasiticDevice*);
+	}
+      }
+    }
+  }
+  memory.reportUsage("Parasitics", "networks", network_count,
+		     network_bytes);
+  memory.reportUsage("Parasitics", "network nodes", node_count, 0);
+  memory.reportUsage("Parasitics", "network devices", device_count, 0);
+  memory.reportSubsystemTotal("Parasitics");
+}
+
 void
 ConcreteParasitics::deleteParasitics()
 {
   int ap_count = corners_->parasiticAnalysisPtCount();
   int ap_tr_count = ap_count * TransRiseFall::index_count;
-  for (auto drvr_parasitics : drvr_parasitic_map_) {
-    ConcreteParasitic **parasitics = drvr_parasitics.second;
+  ConcreteParasiticMap::Iterator drvr_iter(&drvr_parasitic_map_);
+  while (drvr_iter.hasNext()) {
+    const Pin *drvr_pin;
+    ConcreteParasitic **parasitics;
+    drvr_iter.next(drvr_pin, parasitics);
     if (parasitics) {
       for (int i = 0; i < ap_tr_count; i++)
 	delete parasitics[i];
@@ -894,9 +1081,13 @@ ConcreteParasitics::deleteParasitics()
     }
   }
   drvr_parasitic_map_.clear();
+  deleteReducedModels();
 
-  for (auto net_parasitics : parasitic_network_map_) {
-    ConcreteParasiticNetwork **parasitics = net_parasitics.second;
+  ConcreteParasiticNetworkMap::Iterator net_iter(&parasitic_network_map_);
+  while (net_iter.hasNext()) {
+    const Net *net;
+    ConcreteParasiticNetwork **parasitics;
+    net_iter.next(net, parasitics);
     if (parasitics) {
       for (int i = 0; i < ap_count; i++)
 	delete parasitics[i];
@@ -904,13 +1095,15 @@ ConcreteParasitics::deleteParasitics()
     }
   }
   parasitic_network_map_.clear();
+  loaders_.deleteContentsClear();
 }
 
 void
 ConcreteParasitics::deleteParasitics(const Pin *drvr_pin,
 				     const ParasiticAnalysisPt *ap)
 {
-  ConcreteParasitic **parasitics = drvr_parasitic_map_[drvr_pin];
+  UniqueLock lock(drvr_parasitic_map_.lock(drvr_pin));
+  ConcreteParasitic **parasitics = drvr_parasitic_map_.findKey(drvr_pin);
   if (parasitics) {
     TransRiseFallIterator tr_iter;
     while (tr_iter.hasNext()) {
@@ -920,6 +1113,8 @@ ConcreteParasitics::deleteParasitics(const Pin *drvr_pin,
       parasitics[ap_tr_index] = nullptr;
     }
   }
+  lock.unlock();
+  deleteDrvrReducedModels(drvr_pin, ap);
 }
 
 void
@@ -930,7 +1125,8 @@ ConcreteParasitics::deleteParasitics(const Net *net,
   for (auto drvr_pin : *drivers)
     deleteParasitics(drvr_pin, ap);
 
-  ConcreteParasiticNetwork **parasitics = parasitic_network_map_[net];
+  UniqueLock lock(parasitic_network_map_.lock(net));
+  ConcreteParasiticNetwork **parasitics = parasitic_network_map_.findKey(net);
   if (parasitics) {
     delete parasitics[ap->index()];
     parasitics[ap->index()] = nullptr;
@@ -944,6 +1140,31 @@ ConcreteParasitics::deleteUnsavedParasitic(Parasitic *parasitic)
   delete cparasitic;
 }
 
+void
+ConcreteParasitics::addLoader(ParasiticsLoader *loader)
+{
+  loaders_.push_back(loader);
+}
+
+// Read the parasitics of the net connected to pin if they have not
+// been read.
+void
+ConcreteParasitics::loadParasitics(const Pin *pin) const
+{
+  if (!loaders_.empty()) {
+    Net *net = findParasiticNet(pin);
+    if (net)
+      loadParasitics(net);
+  }
+}
+
+void
+ConcreteParasitics::loadParasitics(const Net *net) const
+{
+  for (ParasiticsLoader *loader : loaders_)
+    loader->loadNet(net);
+}
+
 void
 ConcreteParasitics::save()
 {
@@ -980,7 +1201,9 @@ ConcreteParasitics::disconnectPinBefore(const Pin *pin)
 
     Net *net = findParasiticNet(pin);
     if (net) {
-      ConcreteParasiticNetwork **parasitics = parasitic_network_map_[net];
+      UniqueLock lock(parasitic_network_map_.lock(net));
+      ConcreteParasiticNetwork **parasitics =
+	parasitic_network_map_.findKey(net);
       if (parasitics) {
         int ap_count = corners_->parasiticAnalysisPtCount();
 	for (int i = 0; i < ap_count; i++) {
@@ -1014,15 +1237,130 @@ ConcreteParasitics::deleteReducedParasitics(const Pin *pin)
 void
 ConcreteParasitics::deleteDrvrReducedParasitics(const Pin *drvr_pin)
 {
-  ConcreteParasitic **parasitics = drvr_parasitic_map_[drvr_pin];
+  UniqueLock lock(drvr_parasitic_map_.lock(drvr_pin));
+  ConcreteParasitic **parasitics = drvr_parasitic_map_.findKey(drvr_pin);
   if (parasitics) {
     int ap_count = corners_->parasiticAnalysisPtCount();
     int ap_tr_count = ap_count * TransRiseFall::index_count;
     for (int i = 0; i < ap_tr_count; i++)
       delete parasitics[i];
     delete [] parasitics;
+    drvr_parasitic_map_.erase(drvr_pin);
+  }
+  lock.unlock();
+  deleteDrvrReducedModels(drvr_pin);
+}
+
+Parasitic *
+ConcreteParasitics::findReducedModel(const Parasitic *parasitic_network,
+				     const Pin *drvr_pin,
+				     const TransRiseFall *tr,
+				     const OperatingConditions *op_cond,
+				     const Corner *corner,
+				     const MinMax *cnst_min_max,
+				     const ParasiticAnalysisPt *ap) const
+{
+  if (!reduced_model_map_.empty()) {
+    UniqueLock lock(reduced_model_map_.lock(drvr_pin));
+    ConcreteReducedModel **models = reduced_model_map_.findKey(drvr_pin);
+    if (models) {
+      ConcreteReducedModel *model = models[parasiticAnalysisPtIndex(ap, tr)];
+      if (model
+	  && model->matches(parasitic_network, op_cond, corner, cnst_min_max))
+	return model->model();
+    }
+  }
+  return nullptr;
+}
+
+void
+ConcreteParasitics::saveReducedModel(const Parasitic *parasitic_network,
+				     const Pin *drvr_pin,
+				     const TransRiseFall *tr,
+				     const OperatingConditions *op_cond,
+				     const Corner *corner,
+				     const MinMax *cnst_min_max,
+				     const ParasiticAnalysisPt *ap,
+				     Parasitic *model)
+{
+  UniqueLock lock(reduced_model_map_.lock(drvr_pin));
+  ConcreteReducedModel **models = reduced_model_map_.findKey(drvr_pin);
+  if (models == nullptr) {
+    int ap_count = corners_->parasiticAnalysisPtCount();
+    int ap_tr_count = ap_count * TransRiseFall::index_count;
+    models = new ConcreteReducedModel*[ap_tr_count]{nullptr};
+    reduced_model_map_.insert(drvr_pin, models);
+  }
+  int ap_tr_index = parasiticAnalysisPtIndex(ap, tr);
+  delete models[ap_tr_index];
+  models[ap_tr_index] =
+    new ConcreteReducedModel(parasitic_network, op_cond, corner, cnst_min_max,
+			     static_cast<ConcreteParasitic*>(model));
+}
+
+void
+ConcreteParasitics::deleteReducedModels()
+{
+  int ap_count = corners_->parasiticAnalysisPtCount();
+  int ap_tr_count = ap_count * TransRiseFall::index_count;
+  ConcreteReducedModelMap::Iterator model_iter(&reduced_model_map_);
+  while (model_iter.hasNext()) {
+    const Pin *drvr_pin;
+    ConcreteReducedModel **models;
+    model_iter.next(drvr_pin, models);
+    for (int i = 0; i < ap_tr_count; i++)
+      delete models[i];
+    delete [] models;
+  }
+  reduced_model_map_.clear();
+}
+
+void
+ConcreteParasitics::deleteDrvrReducedModels(const Pin *drvr_pin)
+{
+  if (!reduced_model_map_.empty()) {
+    UniqueLock lock(reduced_model_map_.lock(drvr_pin));
+    ConcreteReducedModel **models = reduced_model_map_.findKey(drvr_pin);
+    if (models) {
+      int ap_count = corners_->parasiticAnalysisPtCount();
+      int ap_tr_count = ap_count * TransRiseFall::index_count;
+      for (int i = 0; i < ap_tr_count; i++)
+	delete models[i];
+      delete [] models;
+      reduced_model_map_.erase(drvr_pin);
+    }
+  }
+}
+
+void
+ConcreteParasitics::deleteDrvrReducedModels(const Pin *drvr_pin,
+					    const ParasiticAnalysisPt *ap)
+{
+  if (!reduced_model_map_.empty()) {
+    UniqueLock lock(reduced_model_map_.lock(drvr_pin));
+    ConcreteReducedModel **models = reduced_model_map_.findKey(drvr_pin);
+    if (models) {
+      TransRiseFallIterator tr_iter;
+      while (tr_iter.hasNext()) {
+	TransRiseFall *tr = tr_iter.next();
+	int ap_tr_index = parasiticAnalysisPtIndex(ap, tr);
+	delete models[ap_tr_index];
+	models[ap_tr_index] = nullptr;
+      }
+    }
+  }
+}
+
+// Delete the models reduced from the net parasitic network.
+void
+ConcreteParasitics::deleteNetReducedModels(const Net *net,
+					   const ParasiticAnalysisPt *ap)
+{
+  if (!reduced_model_map_.empty()) {
+    PinSet *drivers = network_->drivers(net);
+    for (auto drvr_pin : *drivers)
+      deleteDrvrReducedModels(drvr_pin, ap);
   }
-  drvr_parasitic_map_[drvr_pin] = nullptr;
 }
 
 ////////////////////////////////////////////////////////////////
@@ -1039,9 +1377,10 @@ ConcreteParasitics::findPiElmore(const Pin *drvr_pin,
 				 const TransRiseFall *tr,
 				 const ParasiticAnalysisPt *ap) const
 {
+  loadParasitics(drvr_pin);
   if (!drvr_parasitic_map_.empty()) {
     int ap_tr_index = parasiticAnalysisPtIndex(ap, tr);
-    UniqueLock lock(lock_);
+    UniqueLock lock(drvr_parasitic_map_.lock(drvr_pin));
     ConcreteParasitic **parasitics = drvr_parasitic_map_.findKey(drvr_pin);
     if (parasitics) {
       ConcreteParasitic *parasitic = parasitics[ap_tr_index];
@@ -1064,13 +1403,13 @@ ConcreteParasitics::makePiElmore(const Pin *drvr_pin,
 				 float rpi,
 				 float c1)
 {
-  UniqueLock lock(lock_);
+  UniqueLock lock(drvr_parasitic_map_.lock(drvr_pin));
   ConcreteParasitic **parasitics = drvr_parasitic_map_.findKey(drvr_pin);
   if (parasitics == nullptr) {
     int ap_count = corners_->parasiticAnalysisPtCount();
     int ap_tr_count = ap_count * TransRiseFall::index_count;
     parasitics = new ConcreteParasitic*[ap_tr_count]{nullptr};
-    drvr_parasitic_map_[drvr_pin] = parasitics;
+    drvr_parasitic_map_.insert(drvr_pin, parasitics);
   }
   int ap_tr_index = parasiticAnalysisPtIndex(ap, tr);
   ConcreteParasitic *parasitic = parasitics[ap_tr_index];
@@ -1157,9 +1496,10 @@ ConcreteParasitics::findPiPoleResidue(const Pin *drvr_pin,
 				      const TransRiseFall *tr,
 				      const ParasiticAnalysisPt *ap) const
 {
+  loadParasitics(drvr_pin);
   if (!drvr_parasitic_map_.empty()) {
     int ap_tr_index = parasiticAnalysisPtIndex(ap, tr);
-    UniqueLock lock(lock_);
+    UniqueLock lock(drvr_parasitic_map_.lock(drvr_pin));
     ConcreteParasitic **parasitics = drvr_parasitic_map_.findKey(drvr_pin);
     if (parasitics) {
       ConcreteParasitic *parasitic = parasitics[ap_tr_index];
@@ -1167,7 +1507,7 @@ ConcreteParasitics::findPiPoleResidue(const Pin *drvr_pin,
 	ap_tr_index = parasiticAnalysisPtIndex(ap, TransRiseFall::rise());
 	parasitic = parasitics[ap_tr_index];
       }
-      if (parasitic->isPiPoleResidue())
+      if (parasitic && parasitic->isPiPoleResidue())
 	return parasitic;
     }
   }
@@ -1182,19 +1522,19 @@ ConcreteParasitics::makePiPoleResidue(const Pin *drvr_pin,
 				      float rpi,
 				      float c1)
 {
-  UniqueLock lock(lock_);
+  UniqueLock lock(drvr_parasitic_map_.lock(drvr_pin));
   ConcreteParasitic **parasitics = drvr_parasitic_map_.findKey(drvr_pin);
   if (parasitics == nullptr) {
     int ap_count = corners_->parasiticAnalysisPtCount();
     int ap_tr_count = ap_count * TransRiseFall::index_count;
     parasitics = new ConcreteParasitic*[ap_tr_count]{nullptr};
-    drvr_parasitic_map_[drvr_pin] = parasitics;
+    drvr_parasitic_map_.insert(drvr_pin, parasitics);
   }
   int ap_tr_index = parasiticAnalysisPtIndex(ap, tr);
   ConcreteParasitic *parasitic = parasitics[ap_tr_index];
   ConcretePiPoleResidue *pi_pole_residue = nullptr;
   if (parasitic) {
-    if (parasitic->isPiElmore()) {
+    if (parasitic->isPiPoleResidue()) {
       pi_pole_residue = dynamic_cast<ConcretePiPoleResidue*>(parasitic);
       pi_pole_residue->setPiModel(c2, rpi, c1);
     }
@@ -1273,13 +1613,12 @@ Parasitic *
 ConcreteParasitics::findParasiticNetwork(const Net *net,
 					 const ParasiticAnalysisPt *ap) const
 {
+  loadParasitics(net);
   if (!parasitic_network_map_.empty()) {
-    UniqueLock lock(lock_);
-    if (!parasitic_network_map_.empty()) {
-      ConcreteParasiticNetwork **parasitics=parasitic_network_map_.findKey(net);
-      if (parasitics)
-	return parasitics[ap->index()];
-    }
+    UniqueLock lock(parasitic_network_map_.lock(net));
+    ConcreteParasiticNetwork **parasitics=parasitic_network_map_.findKey(net);
+    if (parasitics)
+      return parasitics[ap->index()];
   }
   return nullptr;
 }
@@ -1288,15 +1627,14 @@ Parasitic *
 ConcreteParasitics::findParasiticNetwork(const Pin *pin,
 					 const ParasiticAnalysisPt *ap) const
 {
+  loadParasitics(pin);
   if (!parasitic_network_map_.empty()) {
-    UniqueLock lock(lock_);
-    if (!parasitic_network_map_.empty()) {
-      // Only call findParasiticNet if parasitics exist.
-      Net *net = findParasiticNet(pin);
-      ConcreteParasiticNetwork **parasitics=parasitic_network_map_.findKey(net);
-      if (parasitics)
-	return parasitics[ap->index()];
-    }
+    // Only call findParasiticNet if parasitics exist.
+    Net *net = findParasiticNet(pin);
+    UniqueLock lock(parasitic_network_map_.lock(net));
+    ConcreteParasiticNetwork **parasitics=parasitic_network_map_.findKey(net);
+    if (parasitics)
+      return parasitics[ap->index()];
   }
   return nullptr;
 }
@@ -1306,17 +1644,19 @@ ConcreteParasitics::makeParasiticNetwork(const Net *net,
 					 bool includes_pin_caps,
 					 const ParasiticAnalysisPt *ap)
 {
-  UniqueLock lock(lock_);
+  UniqueLock lock(parasitic_network_map_.lock(net));
   ConcreteParasiticNetwork **parasitics = parasitic_network_map_.findKey(net);
   if (parasitics == nullptr) {
     int ap_count = corners_->parasiticAnalysisPtCount();
     parasitics = new ConcreteParasiticNetwork*[ap_count]{nullptr};
-    parasitic_network_map_[net] = parasitics;
+    parasitic_network_map_.insert(net, parasitics);
   }
   int ap_index = ap->index();
   ConcreteParasiticNetwork *parasitic = parasitics[ap_index];
-  if (parasitic)
+  if (parasitic) {
+    deleteNetReducedModels(net, ap);
     delete parasitic;
+  }
   parasitic = new ConcreteParasiticNetwork(includes_pin_caps);
   parasitics[ap_index] = parasitic;
   return parasitic;
@@ -1327,10 +1667,12 @@ ConcreteParasitics::deleteParasiticNetwork(const Net *net,
 					   const ParasiticAnalysisPt *ap)
 {
   if (!parasitic_network_map_.empty()) {
-    UniqueLock lock(lock_);
+    UniqueLock lock(parasitic_network_map_.lock(net));
     ConcreteParasiticNetwork **parasitics = parasitic_network_map_.findKey(net);
     if (parasitics) {
       int ap_index = ap->index();
+      if (parasitics[ap_index])
+	deleteNetReducedModels(net, ap);
       delete parasitics[ap_index];
       parasitics[ap_index] = nullptr;
     }
@@ -1383,10 +1725,7 @@ ConcreteParasitics::makeCouplingCap(const char *name,
   ConcreteParasiticNode *cnode = static_cast<ConcreteParasiticNode*>(node);
   ConcreteParasiticNode *other_cnode =
     static_cast<ConcreteParasiticNode*>(other_node);
-  ConcreteCouplingCap *coupling_cap =
-    new ConcreteCouplingCapInt(name, cnode, other_cnode, cap);
-  cnode->addDevice(coupling_cap);
-  other_cnode->addDevice(coupling_cap);
+  cnode->network()->makeCouplingCap(name, cnode, other_cnode, cap);
 }
 
 void
@@ -1398,10 +1737,8 @@ ConcreteParasitics::makeCouplingCap(const char *name,
 				    const ParasiticAnalysisPt *)
 {
   ConcreteParasiticNode *cnode = static_cast<ConcreteParasiticNode*>(node);
-  ConcreteCouplingCap *coupling_cap =
-    new ConcreteCouplingCapExtNode(name, cnode, other_node_net,
-				   other_node_id, cap);
-  cnode->addDevice(coupling_cap);
+  cnode->network()->makeCouplingCap(name, cnode, other_node_net,
+				    other_node_id, cap);
 }
 
 void
@@ -1412,9 +1749,7 @@ ConcreteParasitics::makeCouplingCap(const char *name,
 				    const ParasiticAnalysisPt *)
 {
   ConcreteParasiticNode *cnode = static_cast<ConcreteParasiticNode*>(node);
-  ConcreteCouplingCap *coupling_cap =
-    new ConcreteCouplingCapExtPin(name, cnode, other_node_pin, cap);
-  cnode->addDevice(coupling_cap);
+  cnode->network()->makeCouplingCap(name, cnode, other_node_pin, cap);
 }
 
 void
@@ -1426,10 +1761,7 @@ ConcreteParasitics::makeResistor(const char *name,
 {
   ConcreteParasiticNode *cnode1 = static_cast<ConcreteParasiticNode*>(node1);
   ConcreteParasiticNode *cnode2 = static_cast<ConcreteParasiticNode*>(node2);
-  ConcreteParasiticDevice *resistor =
-    new ConcreteParasiticResistor(name, cnode1, cnode2, res);
-  cnode1->addDevice(resistor);
-  cnode2->addDevice(resistor);
+  cnode1->network()->makeResistor(name, cnode1, cnode2, res);
 }
 
 ParasiticDeviceIterator *
@@ -1676,17 +2008,6 @@ ConcreteParasiticDeviceSeqIterator(ConcreteParasiticDeviceSeq *devices) :
 {
 }
 
-ConcreteParasiticDeviceSetIterator::
-ConcreteParasiticDeviceSetIterator(ConcreteParasiticDeviceSet *devices) :
-  iter_(devices)
-{
-}
-
-ConcreteParasiticDeviceSetIterator::~ConcreteParasiticDeviceSetIterator()
-{
-  delete iter_.container();
-}
-
 ConcreteParasiticNodeSeqIterator::
 ConcreteParasiticNodeSeqIterator(ConcreteParasiticNodeSeq *nodes) :
   iter_(nodes)
@@ -17,9 +17,8 @@
 #ifndef STA_CONCRETE_PARASITICS_H
 #define STA_CONCRETE_PARASITICS_H
 
-#include <mutex>
-#include "Map.hh"
 #include "Set.hh"
+#include "StripedMap.hh"
 #include "MinMax.hh"
 #include "EstimateParasitics.hh"
 #include "Parasitics.hh"
@@ -32,9 +31,14 @@ class ConcretePiPoleResidue;
 class ConcreteParasiticNetwork;
 class ConcreteParasiticNode;
 class ConcreteParasiticDevice;
+class ConcreteReducedModel;
 
-typedef Map<const Pin*, ConcreteParasitic**> ConcreteParasiticMap;
-typedef Map<const Net*, ConcreteParasiticNetwork**> ConcreteParasiticNetworkMap;
+// Lock striped so dcalc threads finding and making parasitics for
+// different drivers do not serialize on one lock.
+typedef StripedMap<const Pin*, ConcreteParasitic**> ConcreteParasiticMap;
+typedef StripedMap<const Pin*, ConcreteReducedModel**> ConcreteReducedModelMap;
+typedef StripedMap<const Net*, ConcreteParasiticNetwork**> ConcreteParasiticNetworkMap;
+typedef Vector<ParasiticsLoader*> ParasiticsLoaderSeq;
 
 // This class acts as a BUILDER for all parasitics.
 class ConcreteParasitics : public Parasitics, public EstimateParasitics
@@ -46,12 +50,14 @@ public:
   virtual void clear();
 
   virtual void save();
+  virtual void reportMemory(MemoryReport &memory) const;
   virtual void deleteParasitics();
   virtual void deleteParasitics(const Net *net,
 				const ParasiticAnalysisPt *ap);
   virtual void deleteParasitics(const Pin *drvr_pin,
 				const ParasiticAnalysisPt *ap);
   virtual void deleteUnsavedParasitic(Parasitic *parasitic);
+  virtual void addLoader(ParasiticsLoader *loader);
 
   virtual bool isReducedParasiticNetwork(Parasitic *parasitic) const;
   virtual void setIsReducedParasiticNetwork(Parasitic *parasitic,
@@ -193,6 +199,21 @@ public:
 				      const MinMax *cnst_min_max,
 				      const ParasiticAnalysisPt *ap);
   virtual void deleteDrvrReducedParasitics(const Pin *drvr_pin);
+  virtual Parasitic *findReducedModel(const Parasitic *parasitic_network,
+				      const Pin *drvr_pin,
+				      const TransRiseFall *tr,
+				      const OperatingConditions *op_cond,
+				      const Corner *corner,
+				      const MinMax *cnst_min_max,
+				      const ParasiticAnalysisPt *ap) const;
+  virtual void saveReducedModel(const Parasitic *parasitic_network,
+				const Pin *drvr_pin,
+				const TransRiseFall *tr,
+				const OperatingConditions *op_cond,
+				const Corner *corner,
+				const MinMax *cnst_min_max,
+				const ParasiticAnalysisPt *ap,
+				Parasitic *model);
 
 protected:
   int parasiticAnalysisPtIndex(const ParasiticAnalysisPt *ap,
@@ -200,12 +221,24 @@ protected:
   Parasitic *ensureRspf(const Pin *drvr_pin);
   void makeAnalysisPtAfter();
   void deleteReducedParasitics(const Pin *pin);
+  void deleteReducedModels();
+  void deleteDrvrReducedModels(const Pin *drvr_pin);
+  void deleteDrvrReducedModels(const Pin *drvr_pin,
+			       const ParasiticAnalysisPt *ap);
+  void deleteNetReducedModels(const Net *net,
+			      const ParasiticAnalysisPt *ap);
+  void loadParasitics(const Pin *pin) const;
+  void loadParasitics(const Net *net) const;
 
   // Driver pin to array of parasitics indexed by analysis pt index
   // and transition.
   ConcreteParasiticMap drvr_parasitic_map_;
   ConcreteParasiticNetworkMap parasitic_network_map_;
-  mutable std::mutex lock_;
+  // Driver pin to array of saved reduced models indexed by analysis pt
+  // index and transition.
+  ConcreteReducedModelMap reduced_model_map_;
+  // Parasitics that have not been read yet.
+  ParasiticsLoaderSeq loaders_;
 
   using EstimateParasitics::estimatePiElmore;
   friend class ConcretePiElmore;
@@ -26,6 +26,7 @@ class ConcreteParasiticDevice;
 class ConcreteParasiticPinNode;
 class ConcreteParasiticSubNode;
 class ConcreteParasiticNode;
+class ConcreteParasiticNetwork;
 
 typedef Map<const Pin*, float> ConcreteElmoreLoadMap;
 typedef ConcreteElmoreLoadMap::Iterator ConcretePiElmoreLoadIterator;
@@ -33,15 +34,14 @@ typedef Map<const Pin*, ConcretePoleResidue*> ConcretePoleResidueMap;
 typedef std::pair<const Net*, int> NetId;
 struct NetIdLess
 {
-  bool operator()(const NetId *net_id1,
-		  const NetId *net_id2) const;
+  bool operator()(const NetId &net_id1,
+		  const NetId &net_id2) const;
 };
-typedef Map<NetId*, ConcreteParasiticSubNode*,
+typedef Map<NetId, ConcreteParasiticSubNode*,
 	    NetIdLess > ConcreteParasiticSubNodeMap;
 typedef Map<const Pin*,
 	    ConcreteParasiticPinNode*> ConcreteParasiticPinNodeMap;
 typedef Vector<ConcreteParasiticDevice*> ConcreteParasiticDeviceSeq;
-typedef Set<ConcreteParasiticDevice*> ConcreteParasiticDeviceSet;
 typedef Vector<ConcreteParasiticNode*> ConcreteParasiticNodeSeq;
 
 // Empty base class definitions so casts are not required on returned
@@ -237,13 +237,15 @@ public:
   float capacitance() const;
   virtual const char *name(const Network *network) const = 0;
   virtual bool isPinNode() const { return false; }
+  ConcreteParasiticNetwork *network() const { return network_; }
   ConcreteParasiticDeviceSeq *devices() { return &devices_; }
   void incrCapacitance(float cap);
   void addDevice(ConcreteParasiticDevice *device);
 
 protected:
-  ConcreteParasiticNode();
+  explicit ConcreteParasiticNode(ConcreteParasiticNetwork *network);
 
+  ConcreteParasiticNetwork *network_;
   float cap_;
   ConcreteParasiticDeviceSeq devices_;
 
@@ -253,7 +255,8 @@ protected:
 class ConcreteParasiticSubNode : public ConcreteParasiticNode
 {
 public:
-  ConcreteParasiticSubNode(const Net *net,
+  ConcreteParasiticSubNode(ConcreteParasiticNetwork *network,
+			   const Net *net,
 			   int id);
   virtual const char *name(const Network *network) const;
 
@@ -265,7 +268,8 @@ private:
 class ConcreteParasiticPinNode : public ConcreteParasiticNode
 {
 public:
-  ConcreteParasiticPinNode(const Pin *pin);
+  ConcreteParasiticPinNode(ConcreteParasiticNetwork *network,
+			   const Pin *pin);
   const Pin *pin() const { return pin_; }
   virtual bool isPinNode() const { return true; }
   virtual const char *name(const Network *network) const;
@@ -377,18 +381,6 @@ public:
 private:
 };
 
-class ConcreteParasiticDeviceSetIterator : public ParasiticDeviceIterator
-{
-public:
-  ConcreteParasiticDeviceSetIterator(ConcreteParasiticDeviceSet *devices);
-  virtual ~ConcreteParasiticDeviceSetIterator();
-  bool hasNext() { return iter_.hasNext(); }
-  ParasiticDevice *next() { return iter_.next(); }
-
-private:
-  ConcreteParasiticDeviceSet::ConstIterator iter_;
-};
-
 class ConcreteParasiticDeviceSeqIterator : public ParasiticDeviceIterator
 {
 public:
@@ -412,6 +404,29 @@ private:
   ConcreteParasiticNodeSeq::ConstIterator iter_;
 };
 
+// Memory for the nodes and devices of a parasitic network.
+// Objects are carved out of a few large blocks that are freed with the
+// arena instead of allocating and deleting each object separately.
+class ConcreteParasiticArena
+{
+public:
+  ConcreteParasiticArena();
+  ~ConcreteParasiticArena();
+  void *alloc(size_t size);
+  size_t size() const { return size_; }
+
+private:
+  DISALLOW_COPY_AND_ASSIGN(ConcreteParasiticArena);
+
+  Vector<char*> blocks_;
+  char *next_;
+  size_t free_;
+  // Bytes in blocks_.
+  size_t size_;
+  static const size_t block_size_min_ = 256;
+  static const size_t block_size_max_ = 64 * 1024;
+};
+
 class ConcreteParasiticNetwork : public ParasiticNetwork,
 				 public ConcreteParasitic
 {
@@ -431,18 +446,65 @@ public:
 		     Net *net);
   virtual ParasiticDeviceIterator *deviceIterator();
   virtual ParasiticNodeIterator *nodeIterator();
-  virtual void devices(// Return value.
-		       ConcreteParasiticDeviceSet *devices);
+  ConcreteParasiticDeviceSeq *devices() { return &devices_; }
+  // Devices are allocated from the network arena.
+  void makeResistor(const char *name,
+		    ConcreteParasiticNode *node1,
+		    ConcreteParasiticNode *node2,
+		    float res);
+  void makeCouplingCap(const char *name,
+		       ConcreteParasiticNode *node,
+		       ConcreteParasiticNode *other_node,
+		       float cap);
+  void makeCouplingCap(const char *name,
+		       ConcreteParasiticNode *node,
+		       Net *other_node_net,
+		       int other_node_id,
+		       float cap);
+  void makeCouplingCap(const char *name,
+		       ConcreteParasiticNode *node,
+		       Pin *other_node_pin,
+		       float cap);
+  size_t arenaSize() const { return arena_.size(); }
 
 private:
   void deleteNodes();
   void deleteDevices();
 
+  ConcreteParasiticArena arena_;
   ConcreteParasiticSubNodeMap sub_nodes_;
   ConcreteParasiticPinNodeMap pin_nodes_;
+  ConcreteParasiticDeviceSeq devices_;
   unsigned max_node_id_:31;
   bool includes_pin_caps_:1;
 };
 
+// Model reduced from a parasitic network by a delay calculator and the
+// reduction inputs it is valid for.
+class ConcreteReducedModel
+{
+public:
+  ConcreteReducedModel(const Parasitic *parasitic_network,
+		       const OperatingConditions *op_cond,
+		       const Corner *corner,
+		       const MinMax *cnst_min_max,
+		       ConcreteParasitic *model);
+  ~ConcreteReducedModel();
+  bool matches(const Parasitic *parasitic_network,
+	       const OperatingConditions *op_cond,
+	       const Corner *corner,
+	       const MinMax *cnst_min_max) const;
+  ConcreteParasitic *model() const { return model_; }
+
+private:
+  DISALLOW_COPY_AND_ASSIGN(ConcreteReducedModel);
+
+  const Parasitic *parasitic_network_;
+  const OperatingConditions *op_cond_;
+  const Corner *corner_;
+  const MinMax *cnst_min_max_;
+  ConcreteParasitic *model_;
+};
+
 } // namespace
 #endif
@@ -40,6 +40,11 @@ NullParasitics::save()
 {
 }
 
+void
+NullParasitics::reportMemory(MemoryReport &) const
+{
+}
+
 void
 NullParasitics::deleteParasitics()
 {
@@ -66,6 +71,36 @@ NullParasitics::deleteDrvrReducedParasitics(const Pin *)
 {
 }
 
+void
+NullParasitics::addLoader(ParasiticsLoader *loader)
+{
+  delete loader;
+}
+
+Parasitic *
+NullParasitics::findReducedModel(const Parasitic *,
+				 const Pin *,
+				 const TransRiseFall *,
+				 const OperatingConditions *,
+				 const Corner *,
+				 const MinMax *,
+				 const ParasiticAnalysisPt *) const
+{
+  return nullptr;
+}
+
+void
+NullParasitics::saveReducedModel(const Parasitic *,
+				 const Pin *,
+				 const TransRiseFall *,
+				 const OperatingConditions *,
+				 const Corner *,
+				 const MinMax *,
+				 const ParasiticAnalysisPt *,
+				 Parasitic *)
+{
+}
+
 float
 NullParasitics::capacitance(Parasitic *) const
 {
@@ -30,6 +30,7 @@ public:
   virtual bool haveParasitics();
   virtual void clear();
   virtual void save();
+  virtual void reportMemory(MemoryReport &memory) const;
   virtual void deleteParasitics();
   virtual void deleteParasitics(const Net *net,
 				const ParasiticAnalysisPt *ap);
@@ -37,6 +38,22 @@ public:
 				const ParasiticAnalysisPt *ap);
   virtual void deleteUnsavedParasitic(Parasitic *parasitic);
   virtual void deleteDrvrReducedParasitics(const Pin *drvr_pin);
+  virtual void addLoader(ParasiticsLoader *loader);
+  virtual Parasitic *findReducedModel(const Parasitic *parasitic_network,
+				      const Pin *drvr_pin,
+				      const TransRiseFall *tr,
+				      const OperatingConditions *op_cond,
+				      const Corner *corner,
+				      const MinMax *cnst_min_max,
+				      const ParasiticAnalysisPt *ap) const;
+  virtual void saveReducedModel(const Parasitic *parasitic_network,
+				const Pin *drvr_pin,
+				const TransRiseFall *tr,
+				const OperatingConditions *op_cond,
+				const Corner *corner,
+				const MinMax *cnst_min_max,
+				const ParasiticAnalysisPt *ap,
+				Parasitic *model);
 
   virtual float capacitance(Parasitic *parasitic) const;
 
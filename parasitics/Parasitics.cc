@@ -201,6 +201,7 @@ ParasiticAnalysisPt::ParasiticAnalysisPt(const char *name,
 ParasiticAnalysisPt::~ParasiticAnalysisPt()
 {
   stringDelete(name_);
+  discarded_spef_files_.deleteContents();
 }
 
 void
@@ -209,4 +210,38 @@ ParasiticAnalysisPt::setCouplingCapFactor(float factor)
   coupling_cap_factor_ = factor;
 }
 
+void
+ParasiticAnalysisPt::addDiscardedSpefFile(const char *filename,
+					  Instance *instance,
+					  bool pin_cap_included,
+					  bool keep_coupling_caps)
+{
+  for (ParasiticSpefFile *spef_file : discarded_spef_files_) {
+    if (stringEq(spef_file->filename(), filename)
+	&& spef_file->instance() == instance)
+      return;
+  }
+  discarded_spef_files_.push_back(new ParasiticSpefFile(filename, instance,
+							pin_cap_included,
+							keep_coupling_caps));
+}
+
+////////////////////////////////////////////////////////////////
+
+ParasiticSpefFile::ParasiticSpefFile(const char *filename,
+				     Instance *instance,
+				     bool pin_cap_included,
+				     bool keep_coupling_caps) :
+  filename_(stringCopy(filename)),
+  instance_(instance),
+  pin_cap_included_(pin_cap_included),
+  keep_coupling_caps_(keep_coupling_caps)
+{
+}
+
+ParasiticSpefFile::~ParasiticSpefFile()
+{
+  stringDelete(filename_);
+}
+
 } // namespace
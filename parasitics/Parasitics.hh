@@ -29,6 +29,7 @@ namespace sta {
 
 class Wireload;
 class Corner;
+class MemoryReport;
 
 typedef std::complex<float> ComplexFloat;
 typedef Vector<ComplexFloat> ComplexFloatSeq;
@@ -52,6 +53,8 @@ public:
 
   // Save parasitics to database file.
   virtual void save() = 0;
+  // Report estimated memory usage.
+  virtual void reportMemory(MemoryReport &memory) const = 0;
   // Delete all parasitics.
   virtual void deleteParasitics() = 0;
   // Delete all parasitics on net at analysis point.
@@ -62,6 +65,28 @@ public:
 				const ParasiticAnalysisPt *ap) = 0;
   virtual void deleteUnsavedParasitic(Parasitic *parasitic) = 0;
   virtual void deleteDrvrReducedParasitics(const Pin *drvr_pin) = 0;
+  // Add a loader for parasitics that are read when they are first
+  // found. The parasitics own the loader until they are deleted.
+  virtual void addLoader(ParasiticsLoader *loader) = 0;
+
+  // Models reduced from parasitic_network by a delay calculator that
+  // are saved until the network or driver reduced parasitics are
+  // deleted.  The parasitics own saved models.
+  virtual Parasitic *findReducedModel(const Parasitic *parasitic_network,
+				      const Pin *drvr_pin,
+				      const TransRiseFall *tr,
+				      const OperatingConditions *op_cond,
+				      const Corner *corner,
+				      const MinMax *cnst_min_max,
+				      const ParasiticAnalysisPt *ap) const = 0;
+  virtual void saveReducedModel(const Parasitic *parasitic_network,
+				const Pin *drvr_pin,
+				const TransRiseFall *tr,
+				const OperatingConditions *op_cond,
+				const Corner *corner,
+				const MinMax *cnst_min_max,
+				const ParasiticAnalysisPt *ap,
+				Parasitic *model) = 0;
 
   virtual bool isReducedParasiticNetwork(Parasitic *parasitic) const = 0;
   // Flag this parasitic as reduced from a parasitic network.
@@ -151,6 +176,8 @@ public:
   virtual Parasitic *makeParasiticNetwork(const Net *net,
 					  bool includes_pin_caps,
 					  const ParasiticAnalysisPt *ap) = 0;
+  // Net that the parasitic network connected to pin is stored under.
+  Net *findParasiticNet(const Pin *pin) const;
   virtual ParasiticDeviceIterator *deviceIterator(Parasitic *parasitic) = 0;
   virtual ParasiticNodeIterator *nodeIterator(Parasitic *parasitic) = 0;
   // Delete parasitic network if it exists.
@@ -300,12 +327,49 @@ protected:
 				   const ParasiticAnalysisPt *ap);
 
   Parasitics(StaState *sta);
-  Net *findParasiticNet(const Pin *pin) const;
 
 private:
   DISALLOW_COPY_AND_ASSIGN(Parasitics);
 };
 
+// Parasitics that are read when a net's parasitics are first found
+// instead of when the file is read.
+class ParasiticsLoader
+{
+public:
+  virtual ~ParasiticsLoader() {}
+  // Read the parasitics of net if they have not been read.
+  // Called by dcalc threads.
+  virtual void loadNet(const Net *net) = 0;
+};
+
+// Spef file read with parasitic networks that were deleted after
+// they were reduced, so the networks can be read again when a command
+// needs them.
+class ParasiticSpefFile
+{
+public:
+  ParasiticSpefFile(const char *filename,
+		    Instance *instance,
+		    bool pin_cap_included,
+		    bool keep_coupling_caps);
+  ~ParasiticSpefFile();
+  const char *filename() const { return filename_; }
+  Instance *instance() const { return instance_; }
+  bool pinCapIncluded() const { return pin_cap_included_; }
+  bool keepCouplingCaps() const { return keep_coupling_caps_; }
+
+private:
+  DISALLOW_COPY_AND_ASSIGN(ParasiticSpefFile);
+
+  const char *filename_;
+  Instance *instance_;
+  bool pin_cap_included_;
+  bool keep_coupling_caps_;
+};
+
+typedef Vector<ParasiticSpefFile*> ParasiticSpefFileSeq;
+
 // Managed by the Corner class.
 class ParasiticAnalysisPt
 {
@@ -320,12 +384,20 @@ public:
   // Coupling capacitor factor used by all reduction functions.
   float couplingCapFactor() const { return coupling_cap_factor_; }
   void setCouplingCapFactor(float factor);
+  // Spef files with parasitic networks deleted after reduction.
+  const ParasiticSpefFileSeq &discardedSpefFiles() const
+  { return discarded_spef_files_; }
+  void addDiscardedSpefFile(const char *filename,
+			    Instance *instance,
+			    bool pin_cap_included,
+			    bool keep_coupling_caps);
 
 private:
   const char *name_;
   int index_;
   const MinMax *min_max_;
   float coupling_cap_factor_;
+  ParasiticSpefFileSeq discarded_spef_files_;
 };
 
 } // namespace
@@ -18,6 +18,8 @@
 // You should have received a copy of the GNU General Public License
 // along with this program.  If not, see <https://www.gnu.org/licenses/>.
 
+#include <algorithm>
+#include <vector>
 #include "Sta.hh"
 
 using sta::Sta;
@@ -28,6 +30,8 @@ using sta::ReduceParasiticsTo;
 using sta::TransRiseFall;
 using sta::Pin;
 using sta::TmpFloatSeq;
+using sta::FloatSeq;
+using sta::PinSeq;
 
 %}
 
@@ -38,20 +42,37 @@ read_spef_cmd(const char *filename,
 	      Instance *instance,
 	      MinMaxAll *min_max,
 	      bool increment,
+	      bool incremental,
 	      bool pin_cap_included,
 	      bool keep_coupling_caps,
 	      float coupling_cap_factor,
 	      ReduceParasiticsTo reduce_to,
 	      bool delete_after_reduce,
 	      bool quiet,
-	      bool save)
+	      bool save,
+	      bool lazy)
 {
   cmdLinkedNetwork();
   return Sta::sta()->readSpef(filename, instance, min_max,
-			      increment, pin_cap_included,
+			      increment, incremental, pin_cap_included,
 			      keep_coupling_caps, coupling_cap_factor,
 			      reduce_to, delete_after_reduce,
-			      save, quiet);
+			      save, quiet, lazy);
+}
+
+void
+write_parasitics_db_cmd(const char *filename,
+			bool networks)
+{
+  cmdLinkedNetwork();
+  Sta::sta()->writeParasiticsDb(filename, networks);
+}
+
+bool
+read_parasitics_db_cmd(const char *filename)
+{
+  cmdLinkedNetwork();
+  return Sta::sta()->readParasiticsDb(filename);
 }
 
 TmpFloatSeq *
@@ -104,4 +125,42 @@ set_elmore_cmd(Pin *drvr_pin,
   Sta::sta()->setElmore(drvr_pin, load_pin, tr, min_max, elmore);
 }
 
+void
+set_placement_wire_rc_cmd(float res_per_length,
+			  float cap_per_length)
+{
+  Sta::sta()->setPlacementWireRC(res_per_length, cap_per_length);
+}
+
+// Locations are in microns.
+void
+set_pin_locations_cmd(PinSeq *pins,
+		      FloatSeq *xs,
+		      FloatSeq *ys)
+{
+  cmdLinkedNetwork();
+  size_t count = 0;
+  if (pins && xs && ys)
+    count = std::min(pins->size(), std::min(xs->size(), ys->size()));
+  std::vector<const Pin*> pins1(count);
+  std::vector<double> xs1(count);
+  std::vector<double> ys1(count);
+  for (size_t i = 0; i < count; i++) {
+    pins1[i] = (*pins)[i];
+    xs1[i] = (*xs)[i] * 1e-6;
+    ys1[i] = (*ys)[i] * 1e-6;
+  }
+  Sta::sta()->setPinLocations(pins1.data(), xs1.data(), ys1.data(), count);
+  delete pins;
+  delete xs;
+  delete ys;
+}
+
+void
+estimate_placement_parasitics_cmd()
+{
+  cmdLinkedNetwork();
+  Sta::sta()->estimatePlacementParasitics();
+}
+
 %} // inline
@@ -22,21 +22,24 @@ define_cmd_args "read_spef" \
      [-elmore]\
      [-path path]\
      [-increment]\
+     [-incremental]\
      [-pin_cap_included]\
      [-keep_capacitive_coupling]\
      [-coupling_reduction_factor factor]\
      [-reduce_to pi_elmore|pi_pole_residue2]\
      [-delete_after_reduce]\
+     [-reduce_and_discard]\
      [-quiet]\
      [-save]\
+     [-lazy]\
      filename}
 
 proc_redirect read_spef {
   parse_key_args "read_spef" args \
     keys {-path -coupling_reduction_factor -reduce_to} \
-    flags {-min -max -elmore -increment -pin_cap_included \
+    flags {-min -max -elmore -increment -incremental -pin_cap_included \
 	     -keep_capacitive_coupling \
-	     -delete_after_reduce -quiet -save}
+	     -delete_after_reduce -reduce_and_discard -quiet -save -lazy}
   check_argc_eq1 "report_spef" $args
 
   set instance [top_instance]
@@ -49,11 +52,19 @@ proc_redirect read_spef {
   }
   set min_max [parse_min_max_all_flags flags]
   set increment [info exists flags(-increment)]
+  # -incremental replaces the parasitics of the nets in an eco spef.
+  set incremental [info exists flags(-incremental)]
+  if { $increment && $incremental } {
+    sta_error "-increment and -incremental are mutually exclusive."
+  }
   set coupling_reduction_factor 1.0
   if [info exists keys(-coupling_reduction_factor)] {
     set coupling_reduction_factor $keys(-coupling_reduction_factor)
     check_positive_float "-coupling_reduction_factor" $coupling_reduction_factor
   }
+  # Without -keep_capacitive_coupling coupling caps are grounded at
+  # each end on the net as they are read, multiplied by the coupling
+  # reduction (Miller) factor, so no coupling devices are made.
   set keep_coupling_caps [info exists flags(-keep_capacitive_coupling)]
   set pin_cap_included [info exists flags(-pin_cap_included)]
 
@@ -65,13 +76,38 @@ proc_redirect read_spef {
     }
   }
   set delete_after_reduce [info exists flags(-delete_after_reduce)]
+  # -reduce_and_discard is -delete_after_reduce with a default reduction.
+  if [info exists flags(-reduce_and_discard)] {
+    set delete_after_reduce 1
+    if { $reduce_to == "none" } {
+      set reduce_to "pi_elmore"
+    }
+  }
   set quiet [info exists flags(-quiet)]
   set save [info exists flags(-save)]
+  # -lazy reads the parasitics of each net when they are first used.
+  set lazy [info exists flags(-lazy)]
   set filename $args
-  return [read_spef_cmd $filename $instance $min_max $increment \
+  return [read_spef_cmd $filename $instance $min_max $increment $incremental \
 	    $pin_cap_included $keep_coupling_caps $coupling_reduction_factor \
 	    $reduce_to $delete_after_reduce \
-	    $save $quiet]
+	    $save $quiet $lazy]
+}
+
+define_cmd_args "write_parasitics_db" {[-networks] filename}
+
+proc write_parasitics_db { args } {
+  parse_key_args "write_parasitics_db" args keys {} flags {-networks}
+  check_argc_eq1 "write_parasitics_db" $args
+  set networks [info exists flags(-networks)]
+  write_parasitics_db_cmd [file nativename $args] $networks
+}
+
+define_cmd_args "read_parasitics_db" {filename}
+
+proc read_parasitics_db { args } {
+  check_argc_eq1 "read_parasitics_db" $args
+  return [read_parasitics_db_cmd [file nativename $args]]
 }
 
 # set_pi_model [-min] [-max] drvr_pin c2 rpi c1
@@ -118,5 +154,55 @@ proc set_elmore { args } {
   set_elmore_cmd $drvr_pin $load_pin "fall" $min_max $elmore
 }
 
+define_cmd_args "set_placement_wire_rc" {-resistance res -capacitance cap}
+
+# Wire resistance and capacitance per micron used to estimate
+# parasitics from pin locations.
+proc set_placement_wire_rc { args } {
+  parse_key_args "set_placement_wire_rc" args \
+    keys {-resistance -capacitance} flags {}
+  check_argc_eq0 "set_placement_wire_rc" $args
+  if { ![info exists keys(-resistance)] \
+	 || ![info exists keys(-capacitance)] } {
+    sta_error "set_placement_wire_rc requires -resistance and -capacitance."
+  }
+  set res $keys(-resistance)
+  check_positive_float "-resistance" $res
+  set cap $keys(-capacitance)
+  check_positive_float "-capacitance" $cap
+  # Per micron to per meter.
+  set_placement_wire_rc_cmd [expr [resistance_ui_sta $res] * 1e+6] \
+    [expr [capacitance_ui_sta $cap] * 1e+6]
+}
+
+define_cmd_args "set_pin_locations" {pin_locations}
+
+# pin_locations is a list of {pin x y} with x/y in microns.
+proc set_pin_locations { args } {
+  check_argc_eq1 "set_pin_locations" $args
+  set pins {}
+  set xs {}
+  set ys {}
+  foreach pin_location [lindex $args 0] {
+    if { [llength $pin_location] != 3 } {
+      sta_error "set_pin_locations $pin_location is not a list of {pin x y}."
+    }
+    lassign $pin_location pin_arg x y
+    lappend pins [get_port_pin_error "pin" $pin_arg]
+    check_float "x" $x
+    check_float "y" $y
+    lappend xs $x
+    lappend ys $y
+  }
+  set_pin_locations_cmd $pins $xs $ys
+}
+
+define_cmd_args "estimate_placement_parasitics" {}
+
+proc estimate_placement_parasitics { args } {
+  check_argc_eq0 "estimate_placement_parasitics" $args
+  estimate_placement_parasitics_cmd
+}
+
 # sta namespace end
 }
@@ -24,6 +24,7 @@ class Parasitic;
 class ParasiticDevice;
 class ParasiticNode;
 class ParasiticAnalysisPt;
+class ParasiticsLoader;
 
 enum class ReduceParasiticsTo { pi_elmore, pi_pole_residue2, none };
 
@@ -0,0 +1,835 @@
+// OpenSTA, Static Timing Analyzer
+// Copyright (c) 2019, Parallax Software, Inc.
+// 
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+// 
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+// 
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <string>
+#include "Machine.hh"
+#include "Report.hh"
+#include "Error.hh"
+#include "StringUtil.hh"
+#include "UnorderedMap.hh"
+#include "MappedFile.hh"
+#include "MinMax.hh"
+#include "Transition.hh"
+#include "Network.hh"
+#include "Corner.hh"
+#include "StaState.hh"
+#include "Parasitics.hh"
+#include "ParasiticsDb.hh"
+
+namespace sta {
+
+// Bump the version when the record encoding changes.
+static const uint32_t parasitics_db_version = 1;
+static const char parasitics_db_magic[] = "OpenSTA parasitics db";
+// Written in native byte order to reject databases from other machines.
+static const uint32_t parasitics_db_byte_order = 0x01020304;
+
+enum class ParasiticsDbOp { end,
+			    pi_elmore,
+			    pi_pole_residue,
+			    network };
+
+enum class ParasiticsDbNode { pin, sub_node };
+
+enum class ParasiticsDbDevice { resistor,
+				coupling_cap,
+				coupling_cap_ext };
+
+// String ids.
+static const size_t db_string_define = 0;
+static const size_t db_string_null = 1;
+static const size_t db_string_first_id = 2;
+
+typedef Vector<ParasiticNode*> ParasiticNodeSeq;
+typedef Vector<ParasiticDevice*> ParasiticDeviceSeq;
+typedef UnorderedMap<const ParasiticNode*, size_t> ParasiticNodeIndexMap;
+
+class ParasiticsDbWriter : public StaState
+{
+public:
+  ParasiticsDbWriter(const char *filename,
+		     const StaState *sta);
+  ~ParasiticsDbWriter();
+  void write(bool networks);
+
+private:
+  DISALLOW_COPY_AND_ASSIGN(ParasiticsDbWriter);
+
+  void writeHeader();
+  void findDrvrPins(const Instance *inst,
+		    // Return value.
+		    PinSeq &drvrs);
+  void writeDrvr(const Pin *drvr_pin,
+		 const ParasiticAnalysisPt *ap);
+  void writePiElmore(const Pin *drvr_pin,
+		     const TransRiseFall *tr,
+		     const ParasiticAnalysisPt *ap,
+		     Parasitic *pi_elmore);
+  void writePiPoleResidue(const Pin *drvr_pin,
+			  const TransRiseFall *tr,
+			  const ParasiticAnalysisPt *ap,
+			  Parasitic *pi_pole_residue);
+  void writePiModel(Parasitic *parasitic);
+  void writeNetwork(const Net *net,
+		    const ParasiticAnalysisPt *ap,
+		    Parasitic *parasitic);
+  void writeNode(ParasiticNode *node,
+		 const ParasiticAnalysisPt *ap);
+  void writeOp(ParasiticsDbOp op);
+  void writeByte(int value);
+  void writeVarint(size_t value);
+  void writeFloat(float value);
+  void writeString(const char *str);
+
+  FILE *stream_;
+  UnorderedMap<std::string, size_t> string_ids_;
+};
+
+class ParasiticsDbReader : public StaState
+{
+public:
+  ParasiticsDbReader(const char *filename,
+		     StaState *sta);
+  bool read();
+
+private:
+  DISALLOW_COPY_AND_ASSIGN(ParasiticsDbReader);
+
+  bool readHeader();
+  void readPiElmore();
+  void readPiPoleResidue();
+  void readNetwork();
+  bool readPiModel(const Pin *&drvr_pin,
+		   const TransRiseFall *&tr,
+		   const ParasiticAnalysisPt *&ap,
+		   float &c2,
+		   float &rpi,
+		   float &c1,
+		   bool &is_reduced);
+  const ParasiticAnalysisPt *readAnalysisPt();
+  int readByte();
+  size_t readVarint();
+  float readFloat();
+  // Returns the string id or db_string_null.
+  size_t readStringId();
+  const char *readString();
+  const Pin *readPin();
+  const Net *readNet();
+
+  const char *filename_;
+  MappedFile file_;
+  const char *next_;
+  const char *end_;
+  bool error_;
+  // Interned strings (pointers into file_).
+  Vector<const char*> strings_;
+  // Pins and nets found by string id.
+  UnorderedMap<size_t, const Pin*> pins_;
+  UnorderedMap<size_t, const Net*> nets_;
+  int missing_count_;
+};
+
+void
+writeParasiticsDb(const char *filename,
+		  bool networks,
+		  StaState *sta)
+{
+  ParasiticsDbWriter writer(filename, sta);
+  writer.write(networks);
+}
+
+bool
+readParasiticsDb(const char *filename,
+		 StaState *sta)
+{
+  ParasiticsDbReader reader(filename, sta);
+  return reader.read();
+}
+
+ParasiticsDbWriter::ParasiticsDbWriter(const char *filename,
+				       const StaState *sta) :
+  StaState(sta)
+{
+  stream_ = fopen(filename, "wb");
+  if (stream_ == nullptr)
+    throw FileNotWritable(filename);
+}
+
+ParasiticsDbWriter::~ParasiticsDbWriter()
+{
+  fclose(stream_);
+}
+
+void
+ParasiticsDbWriter::write(bool networks)
+{
+  writeHeader();
+  PinSeq drvrs;
+  findDrvrPins(network_->topInstance(), drvrs);
+  LeafInstanceIterator *leaf_iter = network_->leafInstanceIterator();
+  while (leaf_iter->hasNext())
+    findDrvrPins(leaf_iter->next(), drvrs);
+  delete leaf_iter;
+
+  ParasiticAnalysisPtSeq &aps = corners_->parasiticAnalysisPts();
+  for (ParasiticAnalysisPt *ap : aps) {
+    for (Pin *drvr_pin : drvrs)
+      writeDrvr(drvr_pin, ap);
+  }
+  if (networks) {
+    ConstNetSet nets;
+    for (Pin *drvr_pin : drvrs) {
+      const Net *net = parasitics_->findParasiticNet(drvr_pin);
+      if (net && !nets.hasKey(net)) {
+	nets.insert(net);
+	for (ParasiticAnalysisPt *ap : aps) {
+	  Parasitic *parasitic = parasitics_->findParasiticNetwork(net, ap);
+	  if (parasitic)
+	    writeNetwork(net, ap, parasitic);
+	}
+      }
+    }
+  }
+  writeOp(ParasiticsDbOp::end);
+}
+
+void
+ParasiticsDbWriter::findDrvrPins(const Instance *inst,
+				 // Return value.
+				 PinSeq &drvrs)
+{
+  InstancePinIterator *pin_iter = network_->pinIterator(inst);
+  while (pin_iter->hasNext()) {
+    Pin *pin = pin_iter->next();
+    if (network_->isDriver(pin))
+      drvrs.push_back(pin);
+  }
+  delete pin_iter;
+}
+
+void
+ParasiticsDbWriter::writeHeader()
+{
+  fwrite(parasitics_db_magic, sizeof(parasitics_db_magic), 1, stream_);
+  fwrite(&parasitics_db_version, sizeof(parasitics_db_version), 1, stream_);
+  fwrite(&parasitics_db_byte_order, sizeof(parasitics_db_byte_order), 1,
+	 stream_);
+  ParasiticAnalysisPtSeq &aps = corners_->parasiticAnalysisPts();
+  writeVarint(aps.size());
+  for (ParasiticAnalysisPt *ap : aps)
+    writeFloat(ap->couplingCapFactor());
+}
+
+void
+ParasiticsDbWriter::writeDrvr(const Pin *drvr_pin,
+			      const ParasiticAnalysisPt *ap)
+{
+  Parasitic *rise_parasitic = nullptr;
+  TransRiseFallIterator tr_iter;
+  while (tr_iter.hasNext()) {
+    TransRiseFall *tr = tr_iter.next();
+    // Fall lookups find the rise parasitic when there is no fall.
+    Parasitic *parasitic = parasitics_->findPiElmore(drvr_pin, tr, ap);
+    if (parasitic) {
+      if (parasitic != rise_parasitic)
+	writePiElmore(drvr_pin, tr, ap, parasitic);
+    }
+    else {
+      parasitic = parasitics_->findPiPoleResidue(drvr_pin, tr, ap);
+      if (parasitic && parasitic != rise_parasitic)
+	writePiPoleResidue(drvr_pin, tr, ap, parasitic);
+    }
+    rise_parasitic = parasitic;
+  }
+}
+
+void
+ParasiticsDbWriter::writePiElmore(const Pin *drvr_pin,
+				  const TransRiseFall *tr,
+				  const ParasiticAnalysisPt *ap,
+				  Parasitic *pi_elmore)
+{
+  writeOp(ParasiticsDbOp::pi_elmore);
+  writeVarint(ap->index());
+  writeVarint(tr->index());
+  writeString(network_->pathName(drvr_pin));
+  writePiModel(pi_elmore);
+  PinSeq loads;
+  FloatSeq elmores;
+  PinConnectedPinIterator *pin_iter = network_->connectedPinIterator(drvr_pin);
+  while (pin_iter->hasNext()) {
+    Pin *load_pin = pin_iter->next();
+    if (network_->isLoad(load_pin)) {
+      float elmore;
+      bool exists;
+      parasitics_->findElmore(pi_elmore, load_pin, elmore, exists);
+      if (exists) {
+	loads.push_back(load_pin);
+	elmores.push_back(elmore);
+      }
+    }
+  }
+  delete pin_iter;
+  writeVarint(loads.size());
+  for (size_t i = 0; i < loads.size(); i++) {
+    writeString(network_->pathName(loads[i]));
+    writeFloat(elmores[i]);
+  }
+}
+
+void
+ParasiticsDbWriter::writePiPoleResidue(const Pin *drvr_pin,
+				       const TransRiseFall *tr,
+				       const ParasiticAnalysisPt *ap,
+				       Parasitic *pi_pole_residue)
+{
+  writeOp(ParasiticsDbOp::pi_pole_residue);
+  writeVarint(ap->index());
+  writeVarint(tr->index());
+  writeString(network_->pathName(drvr_pin));
+  writePiModel(pi_pole_residue);
+  PinSeq loads;
+  Vector<Parasitic*> pole_residues;
+  PinConnectedPinIterator *pin_iter = network_->connectedPinIterator(drvr_pin);
+  while (pin_iter->hasNext()) {
+    Pin *load_pin = pin_iter->next();
+    if (network_->isLoad(load_pin)) {
+      Parasitic *pole_residue =
+	parasitics_->findPoleResidue(pi_pole_residue, load_pin);
+      if (pole_residue) {
+	loads.push_back(load_pin);
+	pole_residues.push_back(pole_residue);
+      }
+    }
+  }
+  delete pin_iter;
+  writeVarint(loads.size());
+  for (size_t i = 0; i < loads.size(); i++) {
+    writeString(network_->pathName(loads[i]));
+    Parasitic *pole_residue = pole_residues[i];
+    size_t pole_count = parasitics_->poleResidueCount(pole_residue);
+    writeVarint(pole_count);
+    for (size_t j = 0; j < pole_count; j++) {
+      ComplexFloat pole, residue;
+      parasitics_->poleResidue(pole_residue, j, pole, residue);
+      writeFloat(pole.real());
+      writeFloat(pole.imag());
+      writeFloat(residue.real());
+      writeFloat(residue.imag());
+    }
+  }
+}
+
+void
+ParasiticsDbWriter::writePiModel(Parasitic *parasitic)
+{
+  float c2, rpi, c1;
+  parasitics_->piModel(parasitic, c2, rpi, c1);
+  writeFloat(c2);
+  writeFloat(rpi);
+  writeFloat(c1);
+  writeByte(parasitics_->isReducedParasiticNetwork(parasitic));
+}
+
+void
+ParasiticsDbWriter::writeNetwork(const Net *net,
+				 const ParasiticAnalysisPt *ap,
+				 Parasitic *parasitic)
+{
+  writeOp(ParasiticsDbOp::network);
+  writeVarint(ap->index());
+  writeString(network_->pathName(net));
+  writeByte(parasitics_->includesPinCaps(parasitic));
+
+  ParasiticNodeSeq nodes;
+  ParasiticNodeIterator *node_iter = parasitics_->nodeIterator(parasitic);
+  while (node_iter->hasNext())
+    nodes.push_back(node_iter->next());
+  delete node_iter;
+  ParasiticNodeIndexMap node_index;
+  writeVarint(nodes.size());
+  for (size_t i = 0; i < nodes.size(); i++) {
+    ParasiticNode *node = nodes[i];
+    node_index[node] = i;
+    writeNode(node, ap);
+  }
+
+  ParasiticDeviceSeq devices;
+  ParasiticDeviceIterator *device_iter = parasitics_->deviceIterator(parasitic);
+  while (device_iter->hasNext())
+    devices.push_back(device_iter->next());
+  delete device_iter;
+  writeVarint(devices.size());
+  for (ParasiticDevice *device : devices) {
+    ParasiticNode *node1 = parasitics_->node1(device);
+    ParasiticNode *node2 = parasitics_->node2(device);
+    if (parasitics_->isResistor(device))
+      writeByte(static_cast<int>(ParasiticsDbDevice::resistor));
+    else if (node2)
+      writeByte(static_cast<int>(ParasiticsDbDevice::coupling_cap));
+    else
+      writeByte(static_cast<int>(ParasiticsDbDevice::coupling_cap_ext));
+    writeString(parasitics_->name(device));
+    writeVarint(node_index[node1]);
+    if (node2)
+      writeVarint(node_index[node2]);
+    writeFloat(parasitics_->value(device, ap));
+  }
+}
+
+void
+ParasiticsDbWriter::writeNode(ParasiticNode *node,
+			      const ParasiticAnalysisPt *ap)
+{
+  const Pin *pin = parasitics_->connectionPin(node);
+  if (pin) {
+    writeByte(static_cast<int>(ParasiticsDbNode::pin));
+    writeString(network_->pathName(pin));
+  }
+  else {
+    // Sub node names are net_path:id.
+    const char *name = parasitics_->name(node);
+    const char *id_sep = strrchr(name, ':');
+    std::string net_name(name, id_sep - name);
+    writeByte(static_cast<int>(ParasiticsDbNode::sub_node));
+    writeString(net_name.c_str());
+    writeVarint(atoi(id_sep + 1));
+  }
+  writeFloat(parasitics_->nodeGndCap(node, ap));
+}
+
+void
+ParasiticsDbWriter::writeOp(ParasiticsDbOp op)
+{
+  putc(static_cast<int>(op), stream_);
+}
+
+void
+ParasiticsDbWriter::writeByte(int value)
+{
+  putc(value, stream_);
+}
+
+void
+ParasiticsDbWriter::writeVarint(size_t value)
+{
+  while (value >= 0x80) {
+    putc((value & 0x7f) | 0x80, stream_);
+    value >>= 7;
+  }
+  putc(value, stream_);
+}
+
+void
+ParasiticsDbWriter::writeFloat(float value)
+{
+  fwrite(&value, sizeof(value), 1, stream_);
+}
+
+void
+ParasiticsDbWriter::writeString(const char *str)
+{
+  if (str == nullptr)
+    writeVarint(db_string_null);
+  else {
+    auto id_iter = string_ids_.find(str);
+    if (id_iter == string_ids_.end()) {
+      size_t id = string_ids_.size();
+      string_ids_[str] = id;
+      size_t length = strlen(str);
+      writeVarint(db_string_define);
+      writeVarint(length);
+      // Include the terminator so the reader can use the mapped string.
+      fwrite(str, length + 1, 1, stream_);
+    }
+    else
+      writeVarint(id_iter->second + db_string_first_id);
+  }
+}
+
+////////////////////////////////////////////////////////////////
+
+ParasiticsDbReader::ParasiticsDbReader(const char *filename,
+				       StaState *sta) :
+  StaState(sta),
+  filename_(filename),
+  file_(filename),
+  next_(file_.data()),
+  end_(file_.data() + file_.size()),
+  error_(false),
+  missing_count_(0)
+{
+}
+
+bool
+ParasiticsDbReader::read()
+{
+  if (!readHeader()) {
+    report_->error("%s is not a parasitics db for this version.\n",
+		   filename_);
+    return false;
+  }
+  bool done = false;
+  while (!error_ && !done) {
+    ParasiticsDbOp op = static_cast<ParasiticsDbOp>(readByte());
+    switch (op) {
+    case ParasiticsDbOp::end:
+      done = true;
+      break;
+    case ParasiticsDbOp::pi_elmore:
+      readPiElmore();
+      break;
+    case ParasiticsDbOp::pi_pole_residue:
+      readPiPoleResidue();
+      break;
+    case ParasiticsDbOp::network:
+      readNetwork();
+      break;
+    default:
+      error_ = true;
+      break;
+    }
+  }
+  if (error_) {
+    report_->error("parasitics db %s is corrupt.\n", filename_);
+    return false;
+  }
+  if (missing_count_ > 0)
+    report_->warn("%d pins/nets in parasitics db %s not found.\n",
+		  missing_count_, filename_);
+  return true;
+}
+
+bool
+ParasiticsDbReader::readHeader()
+{
+  size_t header_size = sizeof(parasitics_db_magic)
+    + sizeof(parasitics_db_version)
+    + sizeof(parasitics_db_byte_order);
+  if (file_.size() >= header_size
+      && memcmp(next_, parasitics_db_magic, sizeof(parasitics_db_magic)) == 0) {
+    next_ += sizeof(parasitics_db_magic);
+    uint32_t version, byte_order;
+    memcpy(&version, next_, sizeof(version));
+    next_ += sizeof(version);
+    memcpy(&byte_order, next_, sizeof(byte_order));
+    next_ += sizeof(byte_order);
+    if (version == parasitics_db_version
+	&& byte_order == parasitics_db_byte_order) {
+      size_t ap_count = readVarint();
+      if (ap_count == 1)
+	corners_->makeParasiticAnalysisPtsSingle();
+      else if (ap_count == MinMax::index_count)
+	corners_->makeParasiticAnalysisPtsMinMax();
+      else
+	return false;
+      for (ParasiticAnalysisPt *ap : corners_->parasiticAnalysisPts())
+	ap->setCouplingCapFactor(readFloat());
+      return !error_;
+    }
+  }
+  return false;
+}
+
+void
+ParasiticsDbReader::readPiElmore()
+{
+  const Pin *drvr_pin;
+  const TransRiseFall *tr;
+  const ParasiticAnalysisPt *ap;
+  float c2, rpi, c1;
+  bool is_reduced;
+  bool exists = readPiModel(drvr_pin, tr, ap, c2, rpi, c1, is_reduced);
+  Parasitic *pi_elmore = nullptr;
+  if (exists) {
+    pi_elmore = parasitics_->makePiElmore(drvr_pin, tr, ap, c2, rpi, c1);
+    parasitics_->setIsReducedParasiticNetwork(pi_elmore, is_reduced);
+  }
+  size_t load_count = readVarint();
+  for (size_t i = 0; i < load_count && !error_; i++) {
+    const Pin *load_pin = readPin();
+    float elmore = readFloat();
+    if (pi_elmore && load_pin)
+      parasitics_->setElmore(pi_elmore, load_pin, elmore);
+  }
+}
+
+void
+ParasiticsDbReader::readPiPoleResidue()
+{
+  const Pin *drvr_pin;
+  const TransRiseFall *tr;
+  const ParasiticAnalysisPt *ap;
+  float c2, rpi, c1;
+  bool is_reduced;
+  bool exists = readPiModel(drvr_pin, tr, ap, c2, rpi, c1, is_reduced);
+  Parasitic *pi_pole_residue = nullptr;
+  if (exists) {
+    pi_pole_residue = parasitics_->makePiPoleResidue(drvr_pin, tr, ap,
+						     c2, rpi, c1);
+    parasitics_->setIsReducedParasiticNetwork(pi_pole_residue, is_reduced);
+  }
+  size_t load_count = readVarint();
+  for (size_t i = 0; i < load_count && !error_; i++) {
+    const Pin *load_pin = readPin();
+    size_t pole_count = readVarint();
+    ComplexFloatSeq *poles = new ComplexFloatSeq;
+    ComplexFloatSeq *residues = new ComplexFloatSeq;
+    for (size_t j = 0; j < pole_count && !error_; j++) {
+      float pole_real = readFloat();
+      float pole_imag = readFloat();
+      float residue_real = readFloat();
+      float residue_imag = readFloat();
+      poles->push_back(ComplexFloat(pole_real, pole_imag));
+      residues->push_back(ComplexFloat(residue_real, residue_imag));
+    }
+    if (pi_pole_residue && load_pin && !error_)
+      parasitics_->setPoleResidue(pi_pole_residue, load_pin, poles, residues);
+    else {
+      delete poles;
+      delete residues;
+    }
+  }
+}
+
+bool
+ParasiticsDbReader::readPiModel(const Pin *&drvr_pin,
+				const TransRiseFall *&tr,
+				const ParasiticAnalysisPt *&ap,
+				float &c2,
+				float &rpi,
+				float &c1,
+				bool &is_reduced)
+{
+  ap = readAnalysisPt();
+  size_t tr_index = readVarint();
+  tr = (tr_index < TransRiseFall::index_count)
+    ? TransRiseFall::find(tr_index)
+    : nullptr;
+  if (tr == nullptr)
+    error_ = true;
+  drvr_pin = readPin();
+  c2 = readFloat();
+  rpi = readFloat();
+  c1 = readFloat();
+  is_reduced = readByte();
+  return drvr_pin && !error_;
+}
+
+void
+ParasiticsDbReader::readNetwork()
+{
+  const ParasiticAnalysisPt *ap = readAnalysisPt();
+  const Net *net = readNet();
+  bool includes_pin_caps = readByte();
+  Parasitic *parasitic = nullptr;
+  if (net && !error_)
+    parasitic = parasitics_->makeParasiticNetwork(net, includes_pin_caps, ap);
+
+  size_t node_count = readVarint();
+  ParasiticNodeSeq nodes;
+  for (size_t i = 0; i < node_count && !error_; i++) {
+    ParasiticsDbNode node_type = static_cast<ParasiticsDbNode>(readByte());
+    ParasiticNode *node = nullptr;
+    if (node_type == ParasiticsDbNode::pin) {
+      const Pin *pin = readPin();
+      if (parasitic && pin)
+	node = parasitics_->ensureParasiticNode(parasitic, pin);
+    }
+    else if (node_type == ParasiticsDbNode::sub_node) {
+      const Net *node_net = readNet();
+      int id = readVarint();
+      if (parasitic && node_net)
+	node = parasitics_->ensureParasiticNode(parasitic, node_net, id);
+    }
+    else
+      error_ = true;
+    float cap = readFloat();
+    if (node && cap != 0.0)
+      parasitics_->incrCap(node, cap, ap);
+    nodes.push_back(node);
+  }
+
+  size_t device_count = readVarint();
+  for (size_t i = 0; i < device_count && !error_; i++) {
+    ParasiticsDbDevice device_type =
+      static_cast<ParasiticsDbDevice>(readByte());
+    const char *name = readString();
+    size_t node1_index = readVarint();
+    size_t node2_index = 0;
+    if (device_type != ParasiticsDbDevice::coupling_cap_ext)
+      node2_index = readVarint();
+    float value = readFloat();
+    if (node1_index >= nodes.size() || node2_index >= nodes.size()) {
+      error_ = true;
+      break;
+    }
+    ParasiticNode *node1 = nodes[node1_index];
+    ParasiticNode *node2 = nodes[node2_index];
+    if (node1 && node2) {
+      // Devices own their names.
+      char *device_name = name ? stringCopy(name) : nullptr;
+      switch (device_type) {
+      case ParasiticsDbDevice::resistor:
+	parasitics_->makeResistor(device_name, node1, node2, value, ap);
+	break;
+      case ParasiticsDbDevice::coupling_cap:
+	parasitics_->makeCouplingCap(device_name, node1, node2, value, ap);
+	break;
+      case ParasiticsDbDevice::coupling_cap_ext:
+	parasitics_->makeCouplingCap(device_name, node1,
+				     static_cast<Net*>(nullptr), 0,
+				     value, ap);
+	break;
+      default:
+	stringDelete(device_name);
+	error_ = true;
+	break;
+      }
+    }
+  }
+}
+
+const ParasiticAnalysisPt *
+ParasiticsDbReader::readAnalysisPt()
+{
+  size_t ap_index = readVarint();
+  ParasiticAnalysisPtSeq &aps = corners_->parasiticAnalysisPts();
+  if (ap_index < aps.size())
+    return aps[ap_index];
+  else {
+    error_ = true;
+    return aps[0];
+  }
+}
+
+int
+ParasiticsDbReader::readByte()
+{
+  if (next_ < end_)
+    return static_cast<unsigned char>(*next_++);
+  else {
+    error_ = true;
+    return 0;
+  }
+}
+
+size_t
+ParasiticsDbReader::readVarint()
+{
+  size_t value = 0;
+  int shift = 0;
+  int byte;
+  do {
+    byte = readByte();
+    value |= static_cast<size_t>(byte & 0x7f) << shift;
+    shift += 7;
+  } while ((byte & 0x80) && !error_);
+  return value;
+}
+
+float
+ParasiticsDbReader::readFloat()
+{
+  float value = 0.0;
+  if (next_ + sizeof(value) <= end_) {
+    memcpy(&value, next_, sizeof(value));
+    next_ += sizeof(value);
+  }
+  else
+    error_ = true;
+  return value;
+}
+
+size_t
+ParasiticsDbReader::readStringId()
+{
+  size_t id = readVarint();
+  if (error_)
+    return db_string_null;
+  else if (id == db_string_define) {
+    size_t length = readVarint();
+    if (!error_
+	&& length < static_cast<size_t>(end_ - next_)
+	&& next_[length] == '\0') {
+      strings_.push_back(next_);
+      next_ += length + 1;
+      return strings_.size() - 1 + db_string_first_id;
+    }
+  }
+  else if (id == db_string_null)
+    return db_string_null;
+  else if (id - db_string_first_id < strings_.size())
+    return id;
+  error_ = true;
+  return db_string_null;
+}
+
+const char *
+ParasiticsDbReader::readString()
+{
+  size_t id = readStringId();
+  if (id == db_string_null)
+    return nullptr;
+  else
+    return strings_[id - db_string_first_id];
+}
+
+const Pin *
+ParasiticsDbReader::readPin()
+{
+  size_t id = readStringId();
+  if (id == db_string_null) {
+    error_ = true;
+    return nullptr;
+  }
+  auto pin_iter = pins_.find(id);
+  if (pin_iter == pins_.end()) {
+    const Pin *pin = network_->findPin(strings_[id - db_string_first_id]);
+    if (pin == nullptr)
+      missing_count_++;
+    pins_[id] = pin;
+    return pin;
+  }
+  else
+    return pin_iter->second;
+}
+
+const Net *
+ParasiticsDbReader::readNet()
+{
+  size_t id = readStringId();
+  if (id == db_string_null) {
+    error_ = true;
+    return nullptr;
+  }
+  auto net_iter = nets_.find(id);
+  if (net_iter == nets_.end()) {
+    const Net *net = network_->findNet(strings_[id - db_string_first_id]);
+    if (net == nullptr)
+      missing_count_++;
+    nets_[id] = net;
+    return net;
+  }
+  else
+    return net_iter->second;
+}
+
+} // namespace
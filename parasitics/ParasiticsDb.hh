@@ -0,0 +1,45 @@
+// OpenSTA, Static Timing Analyzer
+// Copyright (c) 2019, Parallax Software, Inc.
+// 
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+// 
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+// 
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+
+#ifndef STA_PARASITICS_DB_H
+#define STA_PARASITICS_DB_H
+
+namespace sta {
+
+class StaState;
+
+// A parasitics database is a binary snapshot of the parasitics of
+// every parasitic analysis point: pi/elmore and pi/pole/residue
+// models, and optionally the parasitic networks. Pins and nets are
+// recorded by path name. Reading the database restores the
+// parasitics without parsing or reducing spef again.
+// The format is machine dependent and versioned.
+
+// Throws FileNotWritable.
+void
+writeParasiticsDb(const char *filename,
+		  bool networks,
+		  StaState *sta);
+
+// Throws FileNotReadable.
+// Return true if successful.
+bool
+readParasiticsDb(const char *filename,
+		 StaState *sta);
+
+} // namespace
+#endif
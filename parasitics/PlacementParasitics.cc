@@ -0,0 +1,252 @@
+// OpenSTA, Static Timing Analyzer
+// Copyright (c) 2019, Parallax Software, Inc.
+// 
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+// 
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+// 
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+#include "Machine.hh"
+#include "ThreadForEach.hh"
+#include "Transition.hh"
+#include "Network.hh"
+#include "Sdc.hh"
+#include "Corner.hh"
+#include "DcalcAnalysisPt.hh"
+#include "Parasitics.hh"
+#include "PlacementParasitics.hh"
+
+namespace sta {
+
+PlacementParasitics::PlacementParasitics(StaState *sta) :
+  StaState(sta),
+  res_per_length_(0.0),
+  cap_per_length_(0.0)
+{
+}
+
+void
+PlacementParasitics::setWireRC(float res_per_length,
+			       float cap_per_length)
+{
+  if (res_per_length != res_per_length_
+      || cap_per_length != cap_per_length_) {
+    res_per_length_ = res_per_length;
+    cap_per_length_ = cap_per_length;
+    // Every located net changes.
+    for (auto &pin_location : locations_)
+      netChanged(const_cast<Pin*>(pin_location.first));
+  }
+}
+
+void
+PlacementParasitics::setPinLocations(const Pin * const *pins,
+				     const double *xs,
+				     const double *ys,
+				     size_t count)
+{
+  for (size_t i = 0; i < count; i++) {
+    const Pin *pin = pins[i];
+    if (pin) {
+      auto location_iter = locations_.find(pin);
+      if (location_iter == locations_.end()
+	  || location_iter->second.x_ != xs[i]
+	  || location_iter->second.y_ != ys[i]) {
+	PinLocation &location = locations_[pin];
+	location.x_ = xs[i];
+	location.y_ = ys[i];
+	netChanged(const_cast<Pin*>(pin));
+      }
+    }
+  }
+}
+
+void
+PlacementParasitics::clear()
+{
+  locations_.clear();
+  moved_drvrs_.clear();
+}
+
+void
+PlacementParasitics::netChanged(Pin *pin)
+{
+  if (network_->isDriver(pin))
+    moved_drvrs_.insert(pin);
+  PinSet *drvrs = network_->drivers(pin);
+  if (drvrs) {
+    for (auto drvr : *drvrs)
+      moved_drvrs_.insert(drvr);
+  }
+}
+
+void
+PlacementParasitics::deletePinBefore(Pin *pin)
+{
+  locations_.erase(pin);
+  moved_drvrs_.erase(pin);
+}
+
+const PinLocation *
+PlacementParasitics::findLocation(const Pin *pin) const
+{
+  auto location_iter = locations_.find(pin);
+  if (location_iter == locations_.end())
+    return nullptr;
+  else
+    return &location_iter->second;
+}
+
+void
+PlacementParasitics::estimate(// Return value.
+			      PinSeq &drvrs)
+{
+  drvrs.clear();
+  for (auto drvr : moved_drvrs_)
+    drvrs.push_back(drvr);
+  moved_drvrs_.clear();
+  forEachChunk(drvrs.size(), thread_pool_,
+	       [&] (size_t begin, size_t end, int) {
+		 for (size_t i = begin; i < end; i++) {
+		   DcalcAnalysisPtIterator ap_iter(this);
+		   while (ap_iter.hasNext()) {
+		     DcalcAnalysisPt *dcalc_ap = ap_iter.next();
+		     estimate(drvrs[i], dcalc_ap);
+		   }
+		 }
+	       });
+}
+
+// Ratio of rectilinear Steiner tree length to half perimeter wire
+// length for nets with pin_count pins.
+float
+PlacementParasitics::steinerFactor(size_t pin_count)
+{
+  static const float factors[] = {1.0, 1.0, 1.0, 1.0, 1.08, 1.15, 1.22,
+				  1.28, 1.34, 1.40, 1.45};
+  static const size_t factor_count = sizeof(factors) / sizeof(factors[0]);
+  if (pin_count < factor_count)
+    return factors[pin_count];
+  else
+    return factors[factor_count - 1]
+      + 0.05 * std::sqrt(static_cast<float>(pin_count - factor_count + 1));
+}
+
+// Driver to load wires in a star with lengths scaled so the total
+// is the Steiner length of the net.
+// Use O'Brien/Savarino reduction to rspf (pi elmore) model like
+// EstimateParasitics::estimatePiElmoreBalanced.
+void
+PlacementParasitics::estimate(const Pin *drvr_pin,
+			      const DcalcAnalysisPt *dcalc_ap)
+{
+  std::vector<const Pin*> loads;
+  std::vector<const PinLocation*> load_locations;
+  double x_min = INF, x_max = -INF;
+  double y_min = INF, y_max = -INF;
+  size_t located_count = 0;
+  auto bound = [&] (const PinLocation *location) {
+    x_min = std::min(x_min, location->x_);
+    x_max = std::max(x_max, location->x_);
+    y_min = std::min(y_min, location->y_);
+    y_max = std::max(y_max, location->y_);
+    located_count++;
+  };
+  const PinLocation *drvr_location = findLocation(drvr_pin);
+  if (drvr_location)
+    bound(drvr_location);
+  PinConnectedPinIterator *load_iter = network_->connectedPinIterator(drvr_pin);
+  while (load_iter->hasNext()) {
+    const Pin *load_pin = load_iter->next();
+    // Bidirects don't count themselves as loads.
+    if (load_pin != drvr_pin
+	&& network_->isLoad(load_pin)
+	&& (network_->isLeaf(load_pin)
+	    || network_->isTopLevelPort(load_pin))) {
+      const PinLocation *location = findLocation(load_pin);
+      if (location)
+	bound(location);
+      loads.push_back(load_pin);
+      load_locations.push_back(location);
+    }
+  }
+  delete load_iter;
+  if (located_count == 0)
+    return;
+
+  // Wires start at the center of the net if the driver is not placed.
+  double x0 = drvr_location ? drvr_location->x_ : (x_min + x_max) / 2.0;
+  double y0 = drvr_location ? drvr_location->y_ : (y_min + y_max) / 2.0;
+  std::vector<double> lengths(loads.size(), 0.0);
+  double star_length = 0.0;
+  for (size_t i = 0; i < loads.size(); i++) {
+    const PinLocation *location = load_locations[i];
+    if (location) {
+      lengths[i] = std::abs(location->x_ - x0) + std::abs(location->y_ - y0);
+      star_length += lengths[i];
+    }
+  }
+  double hpwl = (x_max - x_min) + (y_max - y_min);
+  double steiner_length = hpwl * steinerFactor(located_count);
+  // Loads share wire so the star overestimates the wire length.
+  double length_scale = (star_length > steiner_length && star_length > 0.0)
+    ? steiner_length / star_length
+    : 1.0;
+
+  const OperatingConditions *op_cond = dcalc_ap->operatingConditions();
+  const Corner *corner = dcalc_ap->corner();
+  const MinMax *min_max = dcalc_ap->constraintMinMax();
+  const ParasiticAnalysisPt *parasitic_ap = dcalc_ap->parasiticAnalysisPt();
+  std::vector<float> elmores(loads.size());
+  TransRiseFallIterator tr_iter;
+  while (tr_iter.hasNext()) {
+    TransRiseFall *tr = tr_iter.next();
+    // Find admittance moments.
+    double y1 = sdc_->pinCapacitance(drvr_pin, tr, op_cond, corner, min_max);
+    double y2 = 0.0;
+    double y3 = 0.0;
+    for (size_t i = 0; i < loads.size(); i++) {
+      const Pin *load_pin = loads[i];
+      double load_cap = network_->isLeaf(load_pin)
+	? sdc_->pinCapacitance(load_pin, tr, op_cond, corner, min_max)
+	: sdc_->portExtCap(network_->port(load_pin), tr, min_max);
+      double length = lengths[i] * length_scale;
+      double res = res_per_length_ * length;
+      double wire_cap = cap_per_length_ * length;
+      double cap = load_cap + wire_cap;
+      y1 += cap;
+      y2 -= res * cap * cap;
+      y3 += res * res * cap * cap * cap;
+      elmores[i] = static_cast<float>(res * (wire_cap / 2.0 + load_cap));
+    }
+    float c2, rpi, c1;
+    if (y3 == 0.0) {
+      // No resistance, so load is capacitance only.
+      c2 = static_cast<float>(y1);
+      rpi = 0.0;
+      c1 = 0.0;
+    }
+    else {
+      c1 = static_cast<float>(y2 * y2 / y3);
+      c2 = static_cast<float>(y1 - y2 * y2 / y3);
+      rpi = static_cast<float>(-y3 * y3 / (y2 * y2 * y2));
+    }
+    Parasitic *parasitic = parasitics_->makePiElmore(drvr_pin, tr, parasitic_ap,
+						     c2, rpi, c1);
+    for (size_t i = 0; i < loads.size(); i++)
+      parasitics_->setElmore(parasitic, loads[i], elmores[i]);
+  }
+}
+
+} // namespace
@@ -0,0 +1,85 @@
+// OpenSTA, Static Timing Analyzer
+// Copyright (c) 2019, Parallax Software, Inc.
+// 
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+// 
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+// 
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#ifndef STA_PLACEMENT_PARASITICS_H
+#define STA_PLACEMENT_PARASITICS_H
+
+#include <stddef.h>  // size_t
+#include "DisallowCopyAssign.hh"
+#include "UnorderedMap.hh"
+#include "NetworkClass.hh"
+#include "StaState.hh"
+
+namespace sta {
+
+class DcalcAnalysisPt;
+
+class PinLocation
+{
+public:
+  double x_;
+  double y_;
+};
+
+typedef UnorderedMap<const Pin*, PinLocation> PinLocationMap;
+
+// Parasitics estimated from placed pin locations for timing before
+// routing. Each driver gets a pi model with elmore delays to its loads
+// (RSPF) built from a star of driver to load wires. The total wire
+// length is scaled to a Steiner tree estimate of the net
+// (half perimeter wire length times a fanout correction).
+// Only nets with pins that moved since the last estimate are
+// estimated again.
+class PlacementParasitics : public StaState
+{
+public:
+  explicit PlacementParasitics(StaState *sta);
+  // Wire resistance and capacitance per unit length (meters).
+  void setWireRC(float res_per_length,
+		 float cap_per_length);
+  // Set pin locations (meters). The drivers of nets with pins that
+  // moved are estimated by the next call to estimate().
+  void setPinLocations(const Pin * const *pins,
+		       const double *xs,
+		       const double *ys,
+		       size_t count);
+  void clear();
+  // Estimate the drivers of moved nets in parallel.
+  // Return the estimated drivers.
+  void estimate(// Return value.
+		PinSeq &drvrs);
+  // Network edits change the loads of the pin's net.
+  void netChanged(Pin *pin);
+  void deletePinBefore(Pin *pin);
+
+protected:
+  void estimate(const Pin *drvr_pin,
+		const DcalcAnalysisPt *dcalc_ap);
+  const PinLocation *findLocation(const Pin *pin) const;
+  static float steinerFactor(size_t pin_count);
+
+  float res_per_length_;
+  float cap_per_length_;
+  PinLocationMap locations_;
+  // Drivers of nets with moved pins.
+  PinSet moved_drvrs_;
+
+private:
+  DISALLOW_COPY_AND_ASSIGN(PlacementParasitics);
+};
+
+} // namespace
+#endif
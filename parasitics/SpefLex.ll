@@ -25,20 +25,8 @@
 
 #define YY_NO_INPUT
 
-static std::string spef_token;
-
-void
-spefFlushBuffer()
-{
-  YY_FLUSH_BUFFER;
-}
-
-// Reset the start condition to INITIAL.
-void
-spefResetScanner()
-{
-  BEGIN(0);
-}
+#define YY_INPUT(buf,result,max_size) \
+  yyextra->getChars(buf, result, max_size)
 
 %}
 
@@ -46,6 +34,8 @@ spefResetScanner()
 %option noyywrap
 %option nounput
 %option never-interactive
+%option reentrant bison-bridge
+%option extra-type="sta::SpefReader *"
 
 %x COMMENT
 %x QUOTE
@@ -84,6 +74,11 @@ INDEX   "*"{POS_INTEGER}
 
 %%
 
+%{
+	if (yyextra->netSectionsBegin())
+	  return NET_SECTIONS;
+%}
+
 "*BUS_DELIMITER" { return BUS_DELIMITER; }
 "*C2_R1_C1" { return C2_R1_C1; }
 "*C" { return KW_C; }
@@ -131,7 +126,7 @@ INDEX   "*"{POS_INTEGER}
 "*V" { return KW_V; }
 
 "//".*\n { /* Single line comment */
-	sta::spef_reader->incrLine();
+	yyextra->incrLine();
 	}
 
 "/*"	{ BEGIN COMMENT; }
@@ -139,67 +134,67 @@ INDEX   "*"{POS_INTEGER}
 
 .
 
-\n	{ sta::spef_reader->incrLine(); }
+\n	{ yyextra->incrLine(); }
 
 "*/"	{ BEGIN INITIAL; }
 
 <<EOF>> {
-	SpefParse_error("unterminated comment");
+	SpefParse_error(yyextra, "unterminated comment");
 	BEGIN(INITIAL);
 	yyterminate();
 	}
 }
 
-"\""	{ BEGIN QUOTE; spef_token.erase(); }
+"\""	{ BEGIN QUOTE; yyextra->stringBuf().erase(); }
 <QUOTE>{
 
 \r?\n	{
-	sta::spef_reader->incrLine();
+	yyextra->incrLine();
 	}
 
-"\\".	{ spef_token += yytext[1]; }
+"\\".	{ yyextra->stringBuf() += yytext[1]; }
 
 "\"" 	{
 	BEGIN INITIAL;
-	SpefParse_lval.string = sta::stringCopy(spef_token.c_str());
+	yylval->string = sta::stringCopy(yyextra->stringBuf().c_str());
 	return QSTRING;
 	}
 
-.	{ spef_token += yytext[0]; }
+.	{ yyextra->stringBuf() += yytext[0]; }
 
 <<EOF>> {
-	SpefParse_error("unterminated quoted string");
+	SpefParse_error(yyextra, "unterminated quoted string");
 	BEGIN(INITIAL);
 	yyterminate();
 	}
 }
 
 {BLANK}*\n {
-	sta::spef_reader->incrLine();
+	yyextra->incrLine();
 	}
 
 {INTEGER} {
-	SpefParse_lval.integer = atoi(yytext);
+	yylval->integer = atoi(yytext);
 	return INTEGER;
 	}
 
 {FLOAT} {
-	SpefParse_lval.number = static_cast<float>(atof(yytext));
+	yylval->number = static_cast<float>(atof(yytext));
 	return FLOAT;
 	}
 
 {IDENT} {
-	SpefParse_lval.string = sta::spef_reader->translated(yytext);
+	yylval->string = yyextra->translated(yytext);
 	return IDENT;
 	}
 
 {PATH}|{NAME_PAIR} {
-	SpefParse_lval.string = sta::spef_reader->translated(yytext);
+	yylval->string = yyextra->translated(yytext);
 	return NAME;
 	}
 
 {INDEX} {
-	SpefParse_lval.string = sta::stringCopy(yytext);
+	yylval->string = sta::stringCopy(yytext);
 	return INDEX;
 	}
 
@@ -214,3 +209,18 @@ INDEX   "*"{POS_INTEGER}
 .	{ return ((int) yytext[0]); }
 
 %%
+
+namespace sta {
+
+// Discard the buffered input and reset the start condition so the
+// scanner can read new input.
+void
+spefLexReset(void *scanner)
+{
+  yyguts_t *yyg = static_cast<yyguts_t*>(scanner);
+  if (YY_CURRENT_BUFFER)
+    yy_flush_buffer(YY_CURRENT_BUFFER, scanner);
+  BEGIN(INITIAL);
+}
+
+} // namespace
@@ -17,22 +17,44 @@
 #include <ctype.h>
 #include <string.h>
 #include "Machine.hh"
+#include "SpefNamespace.hh"
 
 namespace sta {
 
+static const char spef_escape = '\\';
+
 char *
 spefToSta(const char *token, char spef_divider,
 	  char path_divider, char path_escape)
 {
-  const char spef_escape = '\\';
   char *trans_token = new char[strlen(token) + 1];
-  char *t = trans_token;
+  spefToSta(token, spef_divider, path_divider, path_escape, trans_token);
+  return trans_token;
+}
 
-  for (const char *s = token; *s ; s++) {
+size_t
+spefToSta(const char *token, char spef_divider,
+	  char path_divider, char path_escape,
+	  char *trans_token)
+{
+  const char specials[] = {spef_escape, spef_divider, '\0'};
+  char *t = trans_token;
+  const char *s = token;
+  while (true) {
+    // Copy the characters up to the next escape or divider in one
+    // piece. Most names have none.
+    size_t length = strcspn(s, specials);
+    memcpy(t, s, length);
+    t += length;
+    s += length;
     char ch = *s;
-    if (ch == spef_escape) {
+    if (ch == '\0')
+      break;
+    else if (ch == spef_escape) {
       char next_ch = s[1];
-      if (next_ch == spef_divider) {
+      if (next_ch == '\0')
+	break;
+      else if (next_ch == spef_divider) {
 	// Translate spef escape to network escape.
 	*t++ = path_escape;
 	// Translate spef divider to network divider.
@@ -48,32 +70,44 @@ spefToSta(const char *token, char spef_divider,
       else
 	// No need to escape other characters.
 	*t++ = next_ch;
-      s++;
+      s += 2;
     }
-    else if (ch == spef_divider)
+    else {
       // Translate spef divider to network divider.
       *t++ = path_divider;
-    else
-      // Just the normal noises.
-      *t++ = ch;
+      s++;
+    }
   }
-  *t++ = '\0';
-  return trans_token;
+  *t = '\0';
+  return t - trans_token;
 }
 
 char *
 staToSpef(const char *token, char spef_divider,
 	  char path_divider, char path_escape)
 {
-  const char spef_escape = '\\';
-  char *trans_token = new char[strlen(token) + 1];
-  char *t = trans_token;
+  // Every character may need an escape.
+  char *trans_token = new char[strlen(token) * 2 + 1];
+  staToSpef(token, spef_divider, path_divider, path_escape, trans_token);
+  return trans_token;
+}
 
+size_t
+staToSpef(const char *token, char spef_divider,
+	  char path_divider, char path_escape,
+	  char *trans_token)
+{
+  char *t = trans_token;
   for (const char *s = token; *s ; s++) {
     char ch = *s;
-    if (ch == path_escape) {
+    if (isalnum(ch) || ch == '_')
+      // Just the normal noises.
+      *t++ = ch;
+    else if (ch == path_escape) {
       char next_ch = s[1];
-      if (next_ch == path_divider) {
+      if (next_ch == '\0')
+	break;
+      else if (next_ch == path_divider) {
 	// Translate network escape to spef escape.
 	*t++ = spef_escape;
 	// Translate network divider to spef divider.
@@ -93,17 +127,14 @@ staToSpef(const char *token, char spef_divider,
     else if (ch == path_divider)
       // Translate network divider to spef divider.
       *t++ = spef_divider;
-    else if (!(isdigit(ch) || isalpha(ch) || ch == '_')) {
+    else {
       // Escape non-alphanum characters.
       *t++ = spef_escape;
       *t++ = ch;
     }
-    else
-      // Just the normal noises.
-      *t++ = ch;
   }
-  *t++ = '\0';
-  return trans_token;
+  *t = '\0';
+  return t - trans_token;
 }
 
 } // namespace
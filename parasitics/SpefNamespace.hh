@@ -17,19 +17,32 @@
 #ifndef STA_SPEF_NAMESPACE_H
 #define STA_SPEF_NAMESPACE_H
 
+#include <stddef.h>  // size_t
+
 namespace sta {
 
 // Translate from spf/spef namespace to sta namespace.
 // Caller owns the result string.
 char *
 spefToSta(const char *token, char spef_divider,
-	  char path_escape, char path_divider);
+	  char path_divider, char path_escape);
+// Translate into trans_token, which must hold strlen(token) + 1 chars.
+// Returns the length of the translated token.
+size_t
+spefToSta(const char *token, char spef_divider,
+	  char path_divider, char path_escape,
+	  char *trans_token);
 // Translate from sta namespace to spf/spef namespace.
 // Caller owns the result string.
 char *
 staToSpef(const char *token, char spef_divider,
 	  char path_divider, char path_escape);
-
+// Translate into trans_token, which must hold strlen(token) * 2 + 1 chars.
+// Returns the length of the translated token.
+size_t
+staToSpef(const char *token, char spef_divider,
+	  char path_divider, char path_escape,
+	  char *trans_token);
 
 } // namespace
 #endif
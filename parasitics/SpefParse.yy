@@ -22,13 +22,15 @@
 #include "StringSeq.hh"
 #include "SpefReaderPvt.hh"
 
-int SpefLex_lex();
-#define SpefParse_lex SpefLex_lex
 // use yacc generated parser errors
 #define YYERROR_VERBOSE
 
 %}
 
+%define api.pure full
+%parse-param {sta::SpefReader *reader}
+%lex-param {sta::SpefReader *reader}
+
 %union {
   char ch;
   char *string;
@@ -50,6 +52,8 @@ int SpefLex_lex();
 %token D_NET D_PNET R_NET R_PNET END
 %token CONN CAP RES INDUC KW_P KW_I KW_N DRIVER CELL C2_R1_C1 LOADS
 %token RC KW_Q KW_K
+/* Start of net sections read without the file header. */
+%token NET_SECTIONS
 
 %token INTEGER FLOAT QSTRING INDEX IDENT NAME
 
@@ -90,8 +94,13 @@ int SpefLex_lex();
 
 %start file
 
-%{
-%}
+%code {
+int
+SpefLex_lex(YYSTYPE *lvalp,
+	    void *scanner);
+#define SpefParse_lex(lvalp, reader) \
+  SpefLex_lex(lvalp, (reader)->scanner())
+}
 
 %%
 
@@ -102,6 +111,8 @@ file:
 	external_def
 	define_def
 	internal_def
+|	NET_SECTIONS
+	internal_def
 ;
 
 /****************************************************************/
@@ -187,7 +198,7 @@ vendor:
 
 design_flow:
 	DESIGN_FLOW qstrings
-	{ sta::spef_reader->setDesignFlow($2); }
+	{ reader->setDesignFlow($2); }
 ;
 
 qstrings:
@@ -201,19 +212,19 @@ qstrings:
 
 hierarchy_div_def:
 	DIVIDER hchar
-	{ sta::spef_reader->setDivider($2); }
+	{ reader->setDivider($2); }
 ;
 
 pin_delim_def:
 	DELIMITER hchar
-	{ sta::spef_reader->setDelimiter($2); }
+	{ reader->setDelimiter($2); }
 ;
 
 bus_delim_def:
 	BUS_DELIMITER prefix_bus_delim
-	{ sta::spef_reader->setBusBrackets($2, '\0'); }
+	{ reader->setBusBrackets($2, '\0'); }
 |	BUS_DELIMITER prefix_bus_delim suffix_bus_delim
-	{ sta::spef_reader->setBusBrackets($2, $3); }
+	{ reader->setBusBrackets($2, $3); }
 ;
 
 /****************************************************************/
@@ -227,22 +238,22 @@ unit_def:
 
 time_scale:
 	T_UNIT pos_number IDENT
-	{ sta::spef_reader->setTimeScale($2, $3); }
+	{ reader->setTimeScale($2, $3); }
 ;
 
 cap_scale:
 	C_UNIT pos_number IDENT
-	{ sta::spef_reader->setCapScale($2, $3); }
+	{ reader->setCapScale($2, $3); }
 ;
 
 res_scale:
 	R_UNIT pos_number IDENT
-	{ sta::spef_reader->setResScale($2, $3); }
+	{ reader->setResScale($2, $3); }
 ;
 
 induc_scale:
 	L_UNIT pos_number IDENT
-	{ sta::spef_reader->setInductScale($2, $3); }
+	{ reader->setInductScale($2, $3); }
 ;
 
 /****************************************************************/
@@ -250,6 +261,7 @@ induc_scale:
 name_map:
 	/* empty */
 |	NAME_MAP name_map_entries
+	{ reader->resolveNameMap(); }
 ;
 
 name_map_entries:
@@ -259,7 +271,7 @@ name_map_entries:
 
 name_map_entry:
 	INDEX mapped_item
-	{ sta::spef_reader->makeNameMapEntry($1, $2);
+	{ reader->makeNameMapEntry($1, $2);
 	  sta::stringDelete($1);
 	}
 ;
@@ -322,7 +334,7 @@ port_entry:
 
 direction:
 	IDENT
-	{ $$ = sta::spef_reader->portDirection($1);
+	{ $$ = reader->portDirection($1);
           sta::stringDelete($1);
 	}
 ;
@@ -450,8 +462,9 @@ entity:
 
 /****************************************************************/
 
+/* Empty when the header is read without the net sections. */
 internal_def:
-	nets
+	/* empty */
 |	internal_def nets
 ;
 
@@ -466,14 +479,14 @@ nets:
 
 d_net:
 	D_NET net total_cap
-	{ sta::spef_reader->dspfBegin($2, $3); }
+	{ reader->dspfBegin($2, $3); }
 	routing_conf conn_sec cap_sec res_sec induc_sec END
-	{ sta::spef_reader->dspfFinish(); }
+	{ reader->dspfFinish(); }
 ;
 
 net:
 	name_or_index
-	{ $$ = sta::spef_reader->findNet($1);
+	{ $$ = reader->findNet($1);
 	  sta::stringDelete($1);
 	}
 ;
@@ -523,7 +536,7 @@ internal_connection:
 
 pin_name:
 	name_or_index
-	{ $$ = sta::spef_reader->findPin($1);
+	{ $$ = reader->findPin($1);
 	  sta::stringDelete($1);
 	}
 ;
@@ -557,9 +570,9 @@ cap_elems:
 
 cap_elem:
 	cap_id parasitic_node par_value
-	{ sta::spef_reader->makeCapacitor($1, $2, $3); }
+	{ reader->makeCapacitor($1, $2, $3); }
 |	cap_id parasitic_node parasitic_node par_value
-	{ sta::spef_reader->makeCapacitor($1, $2, $3, $4); }
+	{ reader->makeCapacitor($1, $2, $3, $4); }
 ;
 
 cap_id:
@@ -585,7 +598,7 @@ res_elems:
 
 res_elem:
 	res_id parasitic_node parasitic_node par_value
-	{ sta::spef_reader->makeResistor($1, $2, $3, $4); }
+	{ reader->makeResistor($1, $2, $3, $4); }
 ;
 
 res_id:
@@ -618,9 +631,9 @@ induc_id:
 
 r_net:
 	R_NET net total_cap
-	{ sta::spef_reader->rspfBegin($2, $3); }
+	{ reader->rspfBegin($2, $3); }
 	routing_conf driver_reducs END
-	{ sta::spef_reader->rspfFinish(); }
+	{ reader->rspfFinish(); }
 ;
 
 driver_reducs:
@@ -630,11 +643,11 @@ driver_reducs:
 
 driver_reduc:
 	driver_pair driver_cell pi_model
-	{ sta::spef_reader->rspfDrvrBegin($1, $3);
+	{ reader->rspfDrvrBegin($1, $3);
 	  sta::stringDelete($2);
 	}
 	load_desc
-	{ sta::spef_reader->rspfDrvrFinish(); }
+	{ reader->rspfDrvrFinish(); }
 ;
 
 driver_pair:
@@ -665,9 +678,9 @@ rc_descs:
 
 rc_desc:
 	RC pin_name par_value
-	{ sta::spef_reader->rspfLoad($2, $3); }
+	{ reader->rspfLoad($2, $3); }
 |	RC pin_name par_value pole_residue_desc
-	{ sta::spef_reader->rspfLoad($2, $3); }
+	{ reader->rspfLoad($2, $3); }
 ;
 
 pole_residue_desc:
@@ -802,7 +815,7 @@ pos_integer:
 	INTEGER
 	{ int value = $1;
 	  if (value < 0)
-	    sta::spef_reader->warn("%d is not positive.\n", value);
+	    reader->warn("%d is not positive.\n", value);
 	  $$ = value;
 	}
 ;
@@ -811,13 +824,13 @@ pos_number:
 	INTEGER
 	{ float value = static_cast<float>($1);
 	  if (value < 0)
-	    sta::spef_reader->warn("%.4f is not positive.\n", value);
+	    reader->warn("%.4f is not positive.\n", value);
 	  $$ = value;
 	}
 |	FLOAT
 	{ float value = static_cast<float>($1);
 	  if (value < 0)
-	    sta::spef_reader->warn("%.4f is not positive.\n", value);
+	    reader->warn("%.4f is not positive.\n", value);
 	  $$ = value;
 	}
 ;
@@ -14,9 +14,16 @@
 // You should have received a copy of the GNU General Public License
 // along with this program.  If not, see <https://www.gnu.org/licenses/>.
 
+#include <ctype.h>
+#include <stdio.h>
+#include <string.h>
+#include <algorithm>
+#include <atomic>
 #include <limits>
+#include <mutex>
+#include <string>
+#include <vector>
 #include "Machine.hh"
-#include "Zlib.hh"
 #include "Report.hh"
 #include "Debug.hh"
 #include "StringUtil.hh"
@@ -27,18 +34,126 @@
 #include "Liberty.hh"
 #include "Sdc.hh"
 #include "Parasitics.hh"
+#include "ThreadForEach.hh"
+#include "Mutex.hh"
+#include "StripedMap.hh"
+#include "MappedFile.hh"
+#include "ScanInput.hh"
 #include "SpefReaderPvt.hh"
 #include "SpefNamespace.hh"
 #include "SpefReader.hh"
 
+// Global namespace
+
 int
-SpefParse_parse();
-void
-spefResetScanner();
+SpefParse_parse(sta::SpefReader *reader);
+int
+SpefLex_lex_init_extra(sta::SpefReader *reader,
+		       void **scanner);
+int
+SpefLex_lex_destroy(void *scanner);
 
 namespace sta {
 
-SpefReader *spef_reader;
+// Parasitic networks are reduced in parallel in batches of nets to
+// bound the memory used by networks that are deleted after reduction.
+static const size_t reduce_batch_net_count = 8192;
+// Name map indices below this (or twice the map size) are kept in a
+// dense vector.
+static const size_t name_map_dense_min = 1 << 16;
+
+// Net sections read by read_spef -lazy are found with an index of the
+// *D_NET/*R_NET section offsets that is saved in <spef>.idx.
+static const char spef_index_magic[8] = {'S','T','A','S','P','X','1','\0'};
+
+// Net sections are not loaded while a Spef file is read (its networks
+// are reduced as they are read) or from inside a load on the same
+// thread, so loads do not nest.
+static std::atomic<bool> spef_file_parsing(false);
+static thread_local bool spef_net_loading = false;
+// Serializes loads from dcalc threads.
+static std::mutex spef_load_lock;
+
+class SpefFileParsing
+{
+public:
+  SpefFileParsing() { spef_file_parsing = true; }
+  ~SpefFileParsing() { spef_file_parsing = false; }
+};
+
+class SpefNetLoading
+{
+public:
+  SpefNetLoading() { spef_net_loading = true; }
+  ~SpefNetLoading() { spef_net_loading = false; }
+};
+
+static bool
+isGzipped(const char *filename);
+
+// Read the parasitics of a net from its Spef net sections when they
+// are first requested.
+class SpefNetLoader : public ParasiticsLoader
+{
+public:
+  SpefNetLoader(const char *filename,
+		Instance *instance,
+		ParasiticAnalysisPt *ap,
+		bool increment,
+		bool pin_cap_included,
+		bool keep_coupling_caps,
+		float coupling_cap_factor,
+		ReduceParasiticsTo reduce_to,
+		bool delete_after_reduce,
+		const OperatingConditions *op_cond,
+		const Corner *corner,
+		const MinMax *cnst_min_max,
+		bool quiet,
+		Report *report,
+		Network *network,
+		Parasitics *parasitics,
+		ThreadPool *thread_pool);
+  // Read the file header and find the nets of the net sections.
+  // The net section index is saved in <filename>.idx if write_index.
+  // Return true if successful.
+  bool init(NetSet *updated_nets,
+	    bool write_index);
+  virtual void loadNet(const Net *net);
+  // Read the net sections of every net on the thread pool.
+  void loadAllNets();
+
+private:
+  DISALLOW_COPY_AND_ASSIGN(SpefNetLoader);
+  bool readIndex(const char *index_filename);
+  void writeIndex(const char *index_filename);
+  void findSections();
+  bool isSectionStart(size_t offset) const;
+  size_t sectionEnd(size_t section) const;
+  void sectionName(size_t section,
+		   // Return value.
+		   std::string &name) const;
+  void findSectionNets(NetSet *updated_nets);
+
+  std::string filename_;
+  MappedFile file_;
+  bool increment_;
+  Report *report_;
+  Network *network_;
+  Parasitics *parasitics_;
+  ThreadPool *thread_pool_;
+  const ParasiticAnalysisPt *ap_;
+  SpefReader reader_;
+  size_t header_end_;
+  // Net section offsets and lines in file order.
+  std::vector<uint64_t> offsets_;
+  std::vector<uint32_t> lines_;
+  // Net section indices sorted by net.
+  std::vector<size_t> net_sections_;
+  // Net to its first position in net_sections_.
+  // Nets are erased once they are loaded.
+  StripedMap<const Net*, size_t> net_section_map_;
+  std::vector<const Net*> section_nets_;
+};
 
 bool
 readSpefFile(const char *filename,
@@ -55,33 +170,435 @@ readSpefFile(const char *filename,
 	     const MinMax *cnst_min_max,
 	     bool save,
 	     bool quiet,
+	     bool lazy,
+	     NetSet *updated_nets,
 	     Report *report,
 	     Network *network,
-	     Parasitics *parasitics)
+	     Parasitics *parasitics,
+	     ThreadPool *thread_pool)
 {
-  bool success = false;
-  // Use zlib to uncompress gzip'd files automagically.
-  gzFile stream = gzopen(filename, "rb");
-  if (stream) {
-    SpefReader reader(filename, stream, instance, ap, increment,
-		      pin_cap_included, keep_coupling_caps, coupling_cap_factor,
-		      reduce_to, delete_after_reduce, op_cond, corner, 
-		      cnst_min_max, quiet, report, network, parasitics);
-    spef_reader = &reader;
-    ::spefResetScanner();
-    // yyparse returns 0 on success.
-    success = (::SpefParse_parse() == 0);
-    gzclose(stream);
+  SpefFileParsing parsing;
+  if (lazy) {
+    if (isGzipped(filename))
+      report->warn("%s is compressed so it is read without -lazy.\n",
+		   filename);
+    else {
+      SpefNetLoader *loader = new SpefNetLoader(filename, instance, ap,
+						increment, pin_cap_included,
+						keep_coupling_caps,
+						coupling_cap_factor,
+						reduce_to, delete_after_reduce,
+						op_cond, corner, cnst_min_max,
+						quiet, report, network,
+						parasitics, thread_pool);
+      bool success = loader->init(updated_nets, true);
+      if (success)
+	parasitics->addLoader(loader);
+      else
+	delete loader;
+      return success;
+    }
   }
-  else
-    throw FileNotReadable(filename);
+  bool parallel = thread_pool && thread_pool->threadCount() > 1;
+  if (parallel && !isGzipped(filename)) {
+    // Index the net sections of the mapped file and parse them on
+    // the thread pool.
+    SpefNetLoader loader(filename, instance, ap,
+			 increment, pin_cap_included,
+			 keep_coupling_caps, coupling_cap_factor,
+			 reduce_to, delete_after_reduce,
+			 op_cond, corner, cnst_min_max,
+			 quiet, report, network,
+			 parasitics, thread_pool);
+    bool success = loader.init(updated_nets, false);
+    if (success) {
+      loader.loadAllNets();
+      if (save)
+	parasitics->save();
+    }
+    return success;
+  }
+  // Only read ahead when there is a spare thread to parse while the
+  // file is uncompressed.
+  ScanInput input(filename, parallel);
+  SpefReader reader(filename, &input, instance, ap, increment,
+		    pin_cap_included, keep_coupling_caps,
+		    coupling_cap_factor, reduce_to, delete_after_reduce,
+		    op_cond, corner, cnst_min_max, quiet, report,
+		    network, parasitics, thread_pool);
+  reader.setUpdatedNets(updated_nets);
+  bool success = reader.parse();
+  reader.reduceNets();
   if (success && save)
     parasitics->save();
   return success;
 }
 
+bool
+readSpefNets(const ParasiticSpefFile *spef_file,
+	     const NetSet *nets,
+	     ParasiticAnalysisPt *ap,
+	     Report *report,
+	     Network *network,
+	     Parasitics *parasitics)
+{
+  const char *filename = spef_file->filename();
+  SpefFileParsing parsing;
+  ScanInput input(filename, false);
+  // Incremental so existing parasitics are left alone.
+  SpefReader reader(filename, &input, spef_file->instance(), ap, true,
+		    spef_file->pinCapIncluded(),
+		    spef_file->keepCouplingCaps(),
+		    ap->couplingCapFactor(), ReduceParasiticsTo::none,
+		    false, nullptr, nullptr, nullptr, true, report,
+		    network, parasitics, nullptr);
+  reader.setNets(nets);
+  return reader.parse();
+}
+
+////////////////////////////////////////////////////////////////
+
+SpefNetLoader::SpefNetLoader(const char *filename,
+			     Instance *instance,
+			     ParasiticAnalysisPt *ap,
+			     bool increment,
+			     bool pin_cap_included,
+			     bool keep_coupling_caps,
+			     float coupling_cap_factor,
+			     ReduceParasiticsTo reduce_to,
+			     bool delete_after_reduce,
+			     const OperatingConditions *op_cond,
+			     const Corner *corner,
+			     const MinMax *cnst_min_max,
+			     bool quiet,
+			     Report *report,
+			     Network *network,
+			     Parasitics *parasitics,
+			     ThreadPool *thread_pool) :
+  filename_(filename),
+  file_(filename),
+  increment_(increment),
+  report_(report),
+  network_(network),
+  parasitics_(parasitics),
+  thread_pool_(thread_pool),
+  ap_(ap),
+  // Loads are incremental so parasitics made after read_spef are not
+  // overwritten. Existing parasitics are deleted by init instead.
+  reader_(filename_.c_str(), nullptr, instance, ap, true,
+	  pin_cap_included, keep_coupling_caps,
+	  coupling_cap_factor, reduce_to, delete_after_reduce,
+	  op_cond, corner, cnst_min_max, quiet, report,
+	  network, parasitics, thread_pool),
+  header_end_(0)
+{
+}
+
+bool
+SpefNetLoader::init(NetSet *updated_nets,
+		    bool write_index)
+{
+  std::string index_filename = filename_ + ".idx";
+  if (!readIndex(index_filename.c_str())) {
+    findSections();
+    if (write_index)
+      writeIndex(index_filename.c_str());
+  }
+
+  ScanInput input(file_.data(), header_end_);
+  reader_.setInput(&input, 1);
+  bool success = reader_.parse();
+  if (success)
+    findSectionNets(updated_nets);
+  // Loads are serial.
+  reader_.setThreadPool(nullptr);
+  return success;
+}
+
+// Scan the lines of the file for the net section keywords.
+void
+SpefNetLoader::findSections()
+{
+  const char *data = file_.data();
+  size_t size = file_.size();
+  offsets_.clear();
+  lines_.clear();
+  uint32_t line = 1;
+  size_t offset = 0;
+  while (offset < size) {
+    if (isSectionStart(offset)) {
+      offsets_.push_back(offset);
+      lines_.push_back(line);
+    }
+    const char *eol = static_cast<const char*>(memchr(data + offset, '\n',
+						      size - offset));
+    if (eol == nullptr)
+      break;
+    offset = eol - data + 1;
+    line++;
+  }
+  header_end_ = offsets_.empty() ? size : offsets_[0];
+}
+
+// True if the line at offset starts a *D_NET or *R_NET section.
+bool
+SpefNetLoader::isSectionStart(size_t offset) const
+{
+  const char *data = file_.data();
+  size_t size = file_.size();
+  while (offset < size && (data[offset] == ' ' || data[offset] == '\t'))
+    offset++;
+  return offset + 7 <= size
+    && (strncmp(data + offset, "*D_NET", 6) == 0
+	|| strncmp(data + offset, "*R_NET", 6) == 0)
+    && (data[offset + 6] == ' ' || data[offset + 6] == '\t');
+}
+
+size_t
+SpefNetLoader::sectionEnd(size_t section) const
+{
+  if (section + 1 < offsets_.size())
+    return offsets_[section + 1];
+  else
+    return file_.size();
+}
+
+// The net name or name map index after the section keyword.
+void
+SpefNetLoader::sectionName(size_t section,
+			   std::string &name) const
+{
+  const char *s = file_.data() + offsets_[section];
+  const char *end = file_.data() + sectionEnd(section);
+  // Skip blanks and the *D_NET/*R_NET keyword.
+  while (*s == ' ' || *s == '\t')
+    s++;
+  s += 6;
+  while (s < end && (*s == ' ' || *s == '\t'))
+    s++;
+  name.clear();
+  while (s < end && !isspace(*s)) {
+    // Keep escaped characters.
+    if (*s == '\\' && s + 1 < end)
+      name += *s++;
+    name += *s++;
+  }
+}
+
+// The index is only used if it was made for a file of the same size
+// and every offset in it starts a net section.
+bool
+SpefNetLoader::readIndex(const char *index_filename)
+{
+  FILE *stream = fopen(index_filename, "rb");
+  if (stream == nullptr)
+    return false;
+  char magic[sizeof(spef_index_magic)];
+  uint64_t header[3];
+  bool valid = false;
+  if (fread(magic, sizeof(magic), 1, stream) == 1
+      && memcmp(magic, spef_index_magic, sizeof(magic)) == 0
+      && fread(header, sizeof(header), 1, stream) == 1
+      && header[0] == file_.size()
+      && header[1] <= file_.size()
+      // Bound the count by the file size before allocating.
+      && header[2] <= file_.size()) {
+    size_t count = header[2];
+    offsets_.resize(count);
+    lines_.resize(count);
+    valid = (count == 0
+	     || (fread(&offsets_[0], sizeof(uint64_t), count, stream) == count
+		 && fread(&lines_[0], sizeof(uint32_t), count, stream) == count));
+    if (valid) {
+      header_end_ = header[1];
+      for (size_t i = 0; valid && i < count; i++)
+	valid = offsets_[i] < file_.size()
+	  && (i == 0 || offsets_[i] > offsets_[i - 1])
+	  && isSectionStart(offsets_[i]);
+      valid = valid && header_end_ == (count ? offsets_[0] : file_.size());
+    }
+  }
+  fclose(stream);
+  if (!valid) {
+    offsets_.clear();
+    lines_.clear();
+  }
+  return valid;
+}
+
+// The index is only an optimization, so failures to write it are
+// ignored.
+void
+SpefNetLoader::writeIndex(const char *index_filename)
+{
+  FILE *stream = fopen(index_filename, "wb");
+  if (stream) {
+    uint64_t header[3] = {file_.size(), header_end_, offsets_.size()};
+    bool ok = fwrite(spef_index_magic, sizeof(spef_index_magic), 1, stream) == 1
+      && fwrite(header, sizeof(header), 1, stream) == 1
+      && (offsets_.empty()
+	  || (fwrite(&offsets_[0], sizeof(uint64_t), offsets_.size(), stream)
+	      == offsets_.size()
+	      && fwrite(&lines_[0], sizeof(uint32_t), lines_.size(), stream)
+	      == lines_.size()));
+    if (fclose(stream) != 0 || !ok)
+      remove(index_filename);
+  }
+}
+
+// Find the net of each section in parallel.
+void
+SpefNetLoader::findSectionNets(NetSet *updated_nets)
+{
+  size_t section_count = offsets_.size();
+  section_nets_.resize(section_count);
+  forEachChunk(section_count, thread_pool_,
+	       [&] (size_t begin, size_t end, int) {
+		 std::string name;
+		 for (size_t i = begin; i < end; i++) {
+		   sectionName(i, name);
+		   Net *net = reader_.findSectionNet(name.c_str());
+		   section_nets_[i] = net
+		     ? network_->highestConnectedNet(net)
+		     : nullptr;
+		 }
+	       });
+
+  for (size_t i = 0; i < section_count; i++) {
+    const Net *net = section_nets_[i];
+    if (net) {
+      net_sections_.push_back(i);
+      if (updated_nets)
+	updated_nets->insert(const_cast<Net*>(net));
+    }
+    else {
+      std::string name;
+      sectionName(i, name);
+      report_->fileWarn(filename_.c_str(), lines_[i],
+			"net %s not found.\n", name.c_str());
+    }
+  }
+  std::stable_sort(net_sections_.begin(), net_sections_.end(),
+		   [&] (size_t section1, size_t section2) {
+		     return section_nets_[section1] < section_nets_[section2];
+		   });
+  const Net *prev_net = nullptr;
+  for (size_t i = 0; i < net_sections_.size(); i++) {
+    const Net *net = section_nets_[net_sections_[i]];
+    if (net != prev_net) {
+      // Like read_spef, the file replaces the parasitics of its nets.
+      if (!increment_)
+	parasitics_->deleteParasitics(const_cast<Net*>(net), ap_);
+      UniqueLock lock(net_section_map_.lock(net));
+      net_section_map_.insert(net, i);
+      prev_net = net;
+    }
+  }
+}
+
+void
+SpefNetLoader::loadNet(const Net *net)
+{
+  if (!spef_net_loading
+      && !spef_file_parsing
+      && !net_section_map_.empty()) {
+    UniqueLock lock(net_section_map_.lock(net));
+    bool exists;
+    size_t first;
+    net_section_map_.findKey(net, first, exists);
+    if (exists) {
+      // Other threads looking for the net wait on its lock until it
+      // is loaded.
+      UniqueLock load_lock(spef_load_lock);
+      net_section_map_.erase(net);
+      SpefNetLoading loading;
+      for (size_t i = first;
+	   i < net_sections_.size()
+	     && section_nets_[net_sections_[i]] == net;
+	   i++) {
+	size_t section = net_sections_[i];
+	size_t offset = offsets_[section];
+	ScanInput input(file_.data() + offset, sectionEnd(section) - offset);
+	reader_.setInput(&input, lines_[section]);
+	reader_.parseNetSections();
+      }
+      reader_.reduceNets();
+    }
+  }
+}
+
+// net_sections_ is sorted by net so the sections of a net are parsed
+// in file order by one thread, and the nets of different threads
+// share no parasitic networks. Each chunk of nets is parsed by its own
+// reader that shares the header and name map of reader_. Warnings are
+// reported after the parse in line order. Like net loads, the first
+// section of a net with more than one section is kept.
+void
+SpefNetLoader::loadAllNets()
+{
+  // Positions in net_sections_ where a net begins.
+  std::vector<size_t> net_begins;
+  const Net *prev_net = nullptr;
+  for (size_t i = 0; i < net_sections_.size(); i++) {
+    const Net *net = section_nets_[net_sections_[i]];
+    if (net != prev_net) {
+      net_begins.push_back(i);
+      prev_net = net;
+    }
+  }
+  net_begins.push_back(net_sections_.size());
+  size_t net_count = net_begins.size() - 1;
+  std::vector<SpefWarningSeq> thread_warnings(thread_pool_
+					      ? thread_pool_->threadCount()
+					      : 1);
+  forEachChunk(net_count, thread_pool_,
+	       [&] (size_t begin, size_t end, int thread_index) {
+		 SpefReader reader(&reader_);
+		 for (size_t i = net_begins[begin]; i < net_begins[end]; i++) {
+		   size_t section = net_sections_[i];
+		   size_t offset = offsets_[section];
+		   ScanInput input(file_.data() + offset,
+				   sectionEnd(section) - offset);
+		   reader.setInput(&input, lines_[section]);
+		   reader.parseNetSections();
+		 }
+		 reader.reduceNets();
+		 SpefWarningSeq &warnings = thread_warnings[thread_index];
+		 for (auto &line_warning : reader.warnings())
+		   warnings.push_back(std::move(line_warning));
+	       });
+  SpefWarningSeq warnings;
+  for (SpefWarningSeq &thread_warns : thread_warnings) {
+    for (auto &line_warning : thread_warns)
+      warnings.push_back(std::move(line_warning));
+  }
+  std::stable_sort(warnings.begin(), warnings.end(),
+		   [] (const std::pair<int, std::string> &warning1,
+		       const std::pair<int, std::string> &warning2) {
+		     return warning1.first < warning2.first;
+		   });
+  for (auto &line_warning : warnings)
+    report_->fileWarn(filename_.c_str(), line_warning.first, "%s",
+		      line_warning.second.c_str());
+}
+
+static bool
+isGzipped(const char *filename)
+{
+  bool gzipped = false;
+  FILE *stream = fopen(filename, "rb");
+  if (stream) {
+    unsigned char magic[2];
+    gzipped = fread(magic, 1, 2, stream) == 2
+      && magic[0] == 0x1f
+      && magic[1] == 0x8b;
+    fclose(stream);
+  }
+  return gzipped;
+}
+
 SpefReader::SpefReader(const char *filename,
-		       gzFile stream,
+		       ScanInput *input,
 		       Instance *instance,
 		       ParasiticAnalysisPt *ap,
 		       bool increment,
@@ -96,7 +613,8 @@ SpefReader::SpefReader(const char *filename,
 		       bool quiet,
 		       Report *report,
 		       Network *network,
-		       Parasitics *parasitics) :
+		       Parasitics *parasitics,
+		       ThreadPool *thread_pool) :
   filename_(filename),
   instance_(instance),
   ap_(ap),
@@ -108,10 +626,15 @@ SpefReader::SpefReader(const char *filename,
   op_cond_(op_cond),
   corner_(corner),
   cnst_min_max_(cnst_min_max),
+  nets_(nullptr),
+  updated_nets_(nullptr),
   keep_device_names_(false),
   quiet_(quiet),
-  stream_(stream),
+  input_(input),
   line_(1),
+  scanner_(nullptr),
+  net_sections_(false),
+  collect_warnings_(false),
   // defaults
   divider_('\0'),
   delimiter_('\0'),
@@ -121,30 +644,133 @@ SpefReader::SpefReader(const char *filename,
   report_(report),
   network_(network),
   parasitics_(parasitics),
+  thread_pool_(thread_pool),
   triple_index_(0),
+  name_map_(new SpefNameMap),
+  name_map_sparse_(new SpefSparseNameMap),
+  own_name_map_(true),
   design_flow_(nullptr),
-  parasitic_(nullptr)
+  parasitic_(nullptr),
+  progress_("read_spef", "nets", report)
 {
   ap->setCouplingCapFactor(coupling_cap_factor);
+  SpefLex_lex_init_extra(this, &scanner_);
+}
+
+SpefReader::SpefReader(const SpefReader *header) :
+  filename_(header->filename_),
+  instance_(header->instance_),
+  ap_(header->ap_),
+  increment_(header->increment_),
+  pin_cap_included_(header->pin_cap_included_),
+  keep_coupling_caps_(header->keep_coupling_caps_),
+  reduce_to_(header->reduce_to_),
+  delete_after_reduce_(header->delete_after_reduce_),
+  op_cond_(header->op_cond_),
+  corner_(header->corner_),
+  cnst_min_max_(header->cnst_min_max_),
+  nets_(header->nets_),
+  updated_nets_(nullptr),
+  keep_device_names_(header->keep_device_names_),
+  quiet_(header->quiet_),
+  input_(nullptr),
+  line_(1),
+  scanner_(nullptr),
+  net_sections_(false),
+  collect_warnings_(true),
+  divider_(header->divider_),
+  delimiter_(header->delimiter_),
+  bus_brkt_left_(header->bus_brkt_left_),
+  bus_brkt_right_(header->bus_brkt_right_),
+  net_(nullptr),
+  report_(header->report_),
+  network_(header->network_),
+  parasitics_(header->parasitics_),
+  thread_pool_(nullptr),
+  triple_index_(header->triple_index_),
+  time_scale_(header->time_scale_),
+  cap_scale_(header->cap_scale_),
+  res_scale_(header->res_scale_),
+  induct_scale_(header->induct_scale_),
+  name_map_(header->name_map_),
+  name_map_sparse_(header->name_map_sparse_),
+  own_name_map_(false),
+  design_flow_(nullptr),
+  parasitic_(nullptr),
+  // Progress is not thread safe.
+  progress_("read_spef", "nets", nullptr)
+{
+  SpefLex_lex_init_extra(this, &scanner_);
 }
 
 SpefReader::~SpefReader()
 {
+  SpefLex_lex_destroy(scanner_);
   if (design_flow_) {
     deleteContents(design_flow_);
     delete design_flow_;
     design_flow_ = nullptr;
   }
 
-  SpefNameMap::Iterator map_iter(name_map_);
-  while (map_iter.hasNext()) {
-    int index;
-    char *name;
-    map_iter.next(index, name);
-    stringDelete(name);
+  if (own_name_map_) {
+    for (SpefNameMapEntry &entry : *name_map_)
+      stringDelete(entry.name_);
+    for (auto &index_entry : *name_map_sparse_)
+      stringDelete(index_entry.second.name_);
+    delete name_map_;
+    delete name_map_sparse_;
   }
 }
 
+bool
+SpefReader::parse()
+{
+  spefLexReset(scanner_);
+  // yyparse returns 0 on success.
+  return SpefParse_parse(this) == 0;
+}
+
+bool
+SpefReader::parseNetSections()
+{
+  net_sections_ = true;
+  return parse();
+}
+
+bool
+SpefReader::netSectionsBegin()
+{
+  bool net_sections = net_sections_;
+  net_sections_ = false;
+  return net_sections;
+}
+
+void
+SpefReader::setNets(const NetSet *nets)
+{
+  nets_ = nets;
+}
+
+void
+SpefReader::setUpdatedNets(NetSet *nets)
+{
+  updated_nets_ = nets;
+}
+
+void
+SpefReader::setInput(ScanInput *input,
+		     int line)
+{
+  input_ = input;
+  line_ = line;
+}
+
+void
+SpefReader::setThreadPool(ThreadPool *thread_pool)
+{
+  thread_pool_ = thread_pool;
+}
+
 void
 SpefReader::setDivider(char divider)
 {
@@ -183,6 +809,36 @@ SpefReader::findNetRelative(const char *name)
   return network_->findNetRelative(instance_, name);
 }
 
+Instance *
+SpefReader::findMappedInstance(const char *name,
+			       SpefNameMapEntry *entry)
+{
+  if (entry) {
+    if (!entry->inst_found_) {
+      entry->inst_ = findInstanceRelative(name);
+      entry->inst_found_ = true;
+    }
+    return entry->inst_;
+  }
+  else
+    return findInstanceRelative(name);
+}
+
+Net *
+SpefReader::findMappedNet(const char *name,
+			  SpefNameMapEntry *entry)
+{
+  if (entry) {
+    if (!entry->net_found_) {
+      entry->net_ = findNetRelative(name);
+      entry->net_found_ = true;
+    }
+    return entry->net_;
+  }
+  else
+    return findNetRelative(name);
+}
+
 Pin *
 SpefReader::findPinRelative(const char *name)
 {
@@ -200,11 +856,7 @@ SpefReader::getChars(char *buf,
 		     int &result,
 		     size_t max_size)
 {
-  char *status = gzgets(stream_, buf, max_size);
-  if (status == Z_NULL)
-    result = 0;  // YY_nullptr
-  else
-    result = static_cast<int>(strlen(buf));
+  result = static_cast<int>(input_->read(buf, max_size));
 }
 
 void
@@ -212,11 +864,7 @@ SpefReader::getChars(char *buf,
 		     size_t &result,
 		     size_t max_size)
 {
-  char *status = gzgets(stream_, buf, max_size);
-  if (status == Z_NULL)
-    result = 0;  // YY_nullptr
-  else
-    result = strlen(buf);
+  result = input_->read(buf, max_size);
 }
 
 char *
@@ -237,7 +885,13 @@ SpefReader::warn(const char *fmt, ...)
 {
   va_list args;
   va_start(args, fmt);
-  report_->vfileWarn(filename_, line_, fmt, args);
+  if (collect_warnings_) {
+    char *msg = stringPrintArgs(fmt, args);
+    warnings_.push_back(std::make_pair(line_, std::string(msg)));
+    stringDelete(msg);
+  }
+  else
+    report_->vfileWarn(filename_, line_, fmt, args);
   va_end(args);
 }
 
@@ -300,19 +954,77 @@ SpefReader::makeNameMapEntry(char *index,
 			     char *name)
 {
   int i = atoi(index + 1);
-  name_map_[i] = name;
+  SpefNameMapEntry *entry;
+  // Name maps are normally numbered densely from 1.
+  if (i >= 0
+      && static_cast<size_t>(i) < name_map_->size() * 2 + name_map_dense_min) {
+    if (static_cast<size_t>(i) >= name_map_->size())
+      name_map_->resize(i + 1);
+    entry = &(*name_map_)[i];
+  }
+  else
+    entry = &(*name_map_sparse_)[i];
+  stringDelete(entry->name_);
+  *entry = SpefNameMapEntry();
+  entry->name_ = name;
+}
+
+void
+SpefReader::resolveNameMap()
+{
+  // Entries that are never referenced are also resolved, so only
+  // resolve them ahead of use when the lookups are spread over threads.
+  if (thread_pool_ && thread_pool_->threadCount() > 1) {
+    auto resolve = [this] (SpefNameMapEntry &entry) {
+      if (entry.name_) {
+	entry.inst_ = findInstanceRelative(entry.name_);
+	entry.inst_found_ = true;
+	entry.net_ = findNetRelative(entry.name_);
+	entry.net_found_ = true;
+      }
+    };
+    forEachChunk(name_map_->size(), thread_pool_,
+		 [&] (size_t begin, size_t end, int) {
+		   for (size_t i = begin; i < end; i++)
+		     resolve((*name_map_)[i]);
+		 });
+    for (auto &index_entry : *name_map_sparse_)
+      resolve(index_entry.second);
+  }
+}
+
+SpefNameMapEntry *
+SpefReader::findNameMapEntry(int index)
+{
+  if (index >= 0 && static_cast<size_t>(index) < name_map_->size()) {
+    SpefNameMapEntry *entry = &(*name_map_)[index];
+    if (entry->name_)
+      return entry;
+  }
+  auto find_iter = name_map_sparse_->find(index);
+  if (find_iter != name_map_sparse_->end())
+    return &find_iter->second;
+  else
+    return nullptr;
 }
 
 char *
 SpefReader::nameMapLookup(char *name)
 {
+  SpefNameMapEntry *entry;
+  return nameMapLookup(name, entry);
+}
+
+char *
+SpefReader::nameMapLookup(char *name,
+			  SpefNameMapEntry *&entry)
+{
+  entry = nullptr;
   if (name && name[0] == '*') {
-    char *mapped_name;
-    bool exists;
     int index = atoi(name + 1);
-    name_map_.findKey(index, mapped_name, exists);
-    if (exists)
-      return mapped_name;
+    entry = findNameMapEntry(index);
+    if (entry)
+      return entry->name_;
     else {
       warn("no name map entry for %d.\n", index);
       return 0;
@@ -351,8 +1063,9 @@ SpefReader::findPin(char *name)
     char *delim = strrchr(name, delimiter_);
     if (delim) {
       *delim = '\0';
-      name = nameMapLookup(name);
-      Instance *inst = findInstanceRelative(name);
+      SpefNameMapEntry *entry;
+      name = nameMapLookup(name, entry);
+      Instance *inst = findMappedInstance(name, entry);
       // Replace delimiter for error messages.
       *delim = delimiter_;
       const char *port_name = delim + 1;
@@ -377,21 +1090,42 @@ Net *
 SpefReader::findNet(char *name)
 {
   Net *net = nullptr;
-  name = nameMapLookup(name);
+  SpefNameMapEntry *entry;
+  name = nameMapLookup(name, entry);
   if (name) {
-    net = findNetRelative(name);
+    net = findMappedNet(name, entry);
     if (net == nullptr)
       warn("net %s not found.\n", name);
   }
   return net;
 }
 
+Net *
+SpefReader::findSectionNet(const char *name)
+{
+  if (name[0] == '*') {
+    SpefNameMapEntry *entry = findNameMapEntry(atoi(name + 1));
+    if (entry)
+      return findMappedNet(entry->name_, entry);
+    else
+      return nullptr;
+  }
+  else {
+    char *sta_name = translated(name);
+    Net *net = findNetRelative(sta_name);
+    stringDelete(sta_name);
+    return net;
+  }
+}
+
 void
 SpefReader::rspfBegin(Net *net,
 		      SpefTriple *total_cap)
 {
   if (net && !increment_)
     parasitics_->deleteParasitics(net, ap_);
+  if (net && updated_nets_)
+    updated_nets_->insert(net);
   // Net total capacitance is ignored.
   delete total_cap;
 }
@@ -405,7 +1139,8 @@ void
 SpefReader::rspfDrvrBegin(Pin *drvr_pin,
 			  SpefRspfPi *pi)
 {
-  if (drvr_pin) {
+  // Reduced *R_NET models are not filtered by nets_.
+  if (drvr_pin && nets_ == nullptr) {
     // Incremental parasitics do not overwrite existing parasitics.
     if (!(increment_ &&
 	  parasitics_->findPiElmore(drvr_pin, TransRiseFall::rise(), ap_))) {
@@ -445,7 +1180,8 @@ void
 SpefReader::dspfBegin(Net *net,
 		      SpefTriple *total_cap)
 {
-  if (net) {
+  if (net && (nets_ == nullptr
+	      || nets_->hasKey(network_->highestConnectedNet(net)))) {
     // Incremental parasitics do not overwrite existing parasitics.
     if (increment_
 	&& parasitics_->findParasiticNetwork(net, ap_))
@@ -453,7 +1189,14 @@ SpefReader::dspfBegin(Net *net,
     else
       parasitic_ = parasitics_->makeParasiticNetwork(net, pin_cap_included_,
 						     ap_);
+    if (updated_nets_)
+      updated_nets_->insert(net);
     net_ = net;
+    // Every coupling cap node is checked for a connection to net_, so
+    // find the connected nets once instead of searching the hierarchy
+    // for each node.
+    if (parasitic_)
+      network_->connectedNets(net, &connected_nets_);
   }
   else {
     parasitic_ = nullptr;
@@ -470,14 +1213,38 @@ SpefReader::dspfFinish()
     if (!quiet_)
       parasitics_->check(parasitic_);
     if (reduce_to_ != ReduceParasiticsTo::none) {
-      parasitics_->reduceTo(parasitic_, net_, reduce_to_, op_cond_,
-			    corner_, cnst_min_max_, ap_);
-      if (delete_after_reduce_)
-	parasitics_->deleteParasiticNetwork(net_, ap_);
+      reduce_nets_.push_back(net_);
+      if (reduce_nets_.size() >= reduce_batch_net_count)
+	reduceNets();
     }
   }
   parasitic_ = nullptr;
   net_ = nullptr;
+  connected_nets_.clear();
+  progress_.incr();
+}
+
+// The nets are independent, so their networks are reduced in parallel.
+void
+SpefReader::reduceNets()
+{
+  forEachChunk(reduce_nets_.size(), thread_pool_,
+	       [&] (size_t begin, size_t end, int) {
+		 for (size_t i = begin; i < end; i++) {
+		   Net *net = reduce_nets_[i];
+		   Parasitic *parasitic =
+		     parasitics_->findParasiticNetwork(net, ap_);
+		   if (parasitic)
+		     parasitics_->reduceTo(parasitic, net, reduce_to_,
+					   op_cond_, corner_, cnst_min_max_,
+					   ap_);
+		 }
+	       });
+  if (delete_after_reduce_) {
+    for (Net *net : reduce_nets_)
+      parasitics_->deleteParasiticNetwork(net, ap_);
+  }
+  reduce_nets_.clear();
 }
 
 // Caller is only interested in nodes on net_.
@@ -495,6 +1262,18 @@ SpefReader::findParasiticNode(char *name)
   return node;
 }
 
+// True if pin is connected to net_.
+bool
+SpefReader::isConnected(const Pin *pin)
+{
+  Net *net = network_->net(pin);
+  if (net)
+    return connected_nets_.hasKey(net);
+  else
+    // Top level port pins do not have nets.
+    return network_->isConnected(net_, pin);
+}
+
 void
 SpefReader::findParasiticNode(char *name,
 			      ParasiticNode *&node,
@@ -512,13 +1291,16 @@ SpefReader::findParasiticNode(char *name,
       if (delim) {
 	*delim = '\0';
 	char *name2 = delim + 1;
-	name = nameMapLookup(name);
-	Instance *inst = findInstanceRelative(name);
+	SpefNameMapEntry *entry;
+	name = nameMapLookup(name, entry);
+	if (name == nullptr)
+	  return;
+	Instance *inst = findMappedInstance(name, entry);
 	if (inst) {
 	  // <instance>:<port>
 	  Pin *pin = network_->findPin(inst, name2);
 	  if (pin) {
-	    if (network_->isConnected(net_, pin))
+	    if (isConnected(pin))
 	      node = parasitics_->ensureParasiticNode(parasitic_, pin);
 	    else
 	      ext_pin = pin;
@@ -530,7 +1312,9 @@ SpefReader::findParasiticNode(char *name,
 	  }
 	}
 	else {
-	  Net *net = findNet(name);
+	  Net *net = findMappedNet(name, entry);
+	  if (net == nullptr)
+	    warn("net %s not found.\n", name);
 	  // Replace delimiter for error messages.
 	  *delim = delimiter_;
 	  if (net) {
@@ -538,7 +1322,7 @@ SpefReader::findParasiticNode(char *name,
 	    const char *id_str = delim + 1;
 	    if (isDigits(id_str)) {
 	      int id = atoi(id_str);
-	      if (network_->isConnected(net, net_))
+	      if (connected_nets_.hasKey(net))
 		node = parasitics_->ensureParasiticNode(parasitic_, net, id);
 	      else {
 		ext_net = net;
@@ -555,7 +1339,7 @@ SpefReader::findParasiticNode(char *name,
 	name = nameMapLookup(name);
 	Pin *pin = findPortPinRelative(name);
 	if (pin) {
-	  if (network_->isConnected(net_, pin))
+	  if (isConnected(pin))
 	    node = parasitics_->ensureParasiticNode(parasitic_, pin);
 	  else
 	    ext_pin = pin;
@@ -669,6 +1453,17 @@ SpefReader::makeResistor(int id,
 
 ////////////////////////////////////////////////////////////////
 
+SpefNameMapEntry::SpefNameMapEntry() :
+  name_(nullptr),
+  inst_found_(false),
+  inst_(nullptr),
+  net_found_(false),
+  net_(nullptr)
+{
+}
+
+////////////////////////////////////////////////////////////////
+
 SpefRspfPi::SpefRspfPi(SpefTriple *c2,
 		       SpefTriple *r1,
 		       SpefTriple *c1) :
@@ -717,12 +1512,10 @@ SpefTriple::value(int index) const
 ////////////////////////////////////////////////////////////////
 // Global namespace
 
-void spefFlushBuffer();
-
 int
-SpefParse_error(const char *msg)
+SpefParse_error(sta::SpefReader *reader,
+		const char *msg)
 {
-  sta::spef_reader->warn("%s.\n", msg);
-  spefFlushBuffer();
+  reader->warn("%s.\n", msg);
   return 0;
 }
@@ -18,6 +18,7 @@
 #define STA_SPEF_READER_H
 
 #include "Zlib.hh"
+#include "NetworkClass.hh"
 
 namespace sta {
 
@@ -25,11 +26,21 @@ class Network;
 class Parasitics;
 class ParasiticAnalysisPt;
 class Instance;
+class ThreadPool;
+class ParasiticSpefFile;
 
 // Read a file single value parasitics into analysis point ap.
 // In a Spef file with triplet values the first value is used.
 // Constraint min/max cnst_min_max and operating condition op_cond
 // are used for parasitic network reduction.
+// Parasitic networks are reduced in batches of nets on thread_pool.
+// With more than one thread the net sections of uncompressed files
+// are parsed in parallel after the header and name map are read.
+// Nets with parasitics in the file are added to updated_nets if it
+// is not null.
+// With lazy only the file header is read and the net sections are
+// indexed (in <filename>.idx). The parasitics of a net are read the
+// first time they are requested.
 // Return true if successful.
 bool
 readSpefFile(const char *filename,
@@ -46,6 +57,21 @@ readSpefFile(const char *filename,
 	     const MinMax *cnst_min_max,
 	     bool save,
 	     bool quiet,
+	     bool lazy,
+	     NetSet *updated_nets,
+	     Report *report,
+	     Network *network,
+	     Parasitics *parasitics,
+	     ThreadPool *thread_pool);
+
+// Read the parasitic networks of nets from a Spef file into ap
+// without reducing them.  Used to recover networks that read_spef
+// deleted after reduction.  Existing parasitics are not changed.
+// Return true if successful.
+bool
+readSpefNets(const ParasiticSpefFile *spef_file,
+	     const NetSet *nets,
+	     ParasiticAnalysisPt *ap,
 	     Report *report,
 	     Network *network,
 	     Parasitics *parasitics);
@@ -17,21 +17,16 @@
 #ifndef STA_SPEF_READER_PVT_H
 #define STA_SPEF_READER_PVT_H
 
-#include "Zlib.hh"
-#include "Map.hh"
+#include <string>
+#include <utility>
+#include <vector>
+#include "DisallowCopyAssign.hh"
+#include "UnorderedMap.hh"
 #include "StringSeq.hh"
+#include "Progress.hh"
 #include "NetworkClass.hh"
 #include "ParasiticsClass.hh"
 
-// Global namespace.
-#define YY_INPUT(buf,result,max_size) \
-  sta::spef_reader->getChars(buf, result, max_size)
-
-int
-SpefParse_error(const char *msg);
-
-////////////////////////////////////////////////////////////////
-
 namespace sta {
 
 class Report;
@@ -40,14 +35,37 @@ class MinMax;
 class SpefRspfPi;
 class SpefTriple;
 class Corner;
+class ThreadPool;
+class ScanInput;
 
-typedef Map<int,char*,std::less<int> > SpefNameMap;
+// Name map entry and the instance and net that the name refers to.
+// They are found in parallel after the name map is read, or on first
+// use without a thread pool. RC sections refer to the same names over
+// and over so the hierarchical name lookups are only done once per entry.
+class SpefNameMapEntry
+{
+public:
+  SpefNameMapEntry();
+
+  char *name_;
+  bool inst_found_;
+  Instance *inst_;
+  bool net_found_;
+  Net *net_;
+};
+
+// Indexed by name map index. Entries without a name are not in the map.
+typedef std::vector<SpefNameMapEntry> SpefNameMap;
+// Indices that are too large to keep in a dense vector.
+typedef UnorderedMap<int, SpefNameMapEntry> SpefSparseNameMap;
+// Warnings collected by a net section reader and their lines.
+typedef std::vector<std::pair<int, std::string>> SpefWarningSeq;
 
 class SpefReader
 {
 public:
   SpefReader(const char *filename,
-	     gzFile stream,
+	     ScanInput *input,
 	     Instance *instance,
 	     ParasiticAnalysisPt *ap,
 	     bool increment,
@@ -62,9 +80,34 @@ public:
 	     bool quiet,
 	     Report *report,
 	     Network *network,
-	     Parasitics *parasitics);
+	     Parasitics *parasitics,
+	     ThreadPool *thread_pool);
+  // Reader for net sections that are parsed concurrently with other
+  // net sections of the file read by header. The header units,
+  // delimiters and name map are shared with header, the net networks
+  // are reduced without a thread pool and warnings are collected
+  // (see warnings) instead of reported.
+  explicit SpefReader(const SpefReader *header);
   virtual ~SpefReader();
+  // Parse the input. Return true if successful.
+  bool parse();
+  // Parse net sections without the file header from the input.
+  bool parseNetSections();
+  void *scanner() { return scanner_; }
+  // Called by the scanner before the first token; true if the input is
+  // net sections.
+  bool netSectionsBegin();
+  std::string &stringBuf() { return string_buf_; }
+  SpefWarningSeq &warnings() { return warnings_; }
   char divider() const { return divider_; }
+  // Only read the *D_NET networks of nets.
+  void setNets(const NetSet *nets);
+  // Add the nets with parasitics in the file to nets.
+  void setUpdatedNets(NetSet *nets);
+  // Read net sections from input starting at line.
+  void setInput(ScanInput *input,
+		int line);
+  void setThreadPool(ThreadPool *thread_pool);
   void setDivider(char divider);
   char delimiter() const { return delimiter_; }
   void setDelimiter(char delimiter);
@@ -95,10 +138,21 @@ public:
 		      const char *units);
   void makeNameMapEntry(char *index,
 			char *name);
+  // Find the instances and nets of the name map entries.
+  // With a thread pool every entry is resolved so name map lookups
+  // are read only and net sections can be parsed concurrently.
+  void resolveNameMap();
   char *nameMapLookup(char *index);
+  // Return the mapped name and its entry, or name and null entry
+  // if it is not a name map index.
+  char *nameMapLookup(char *name,
+		      SpefNameMapEntry *&entry);
   void setDesignFlow(StringSeq *flow_keys);
   Pin *findPin(char *name);
   Net *findNet(char *name);
+  // Net of a net section name or name map index without warnings.
+  // Thread safe once the name map is resolved.
+  Net *findSectionNet(const char *name);
   void rspfBegin(Net *net,
 		 SpefTriple *total_cap);
   void rspfFinish();
@@ -110,6 +164,9 @@ public:
   void dspfBegin(Net *net,
 		 SpefTriple *total_cap);
   void dspfFinish();
+  // Reduce the parasitic networks of the nets finished since the
+  // last call.
+  void reduceNets();
   void makeCapacitor(int id,
 		     char *node_name,
 		     SpefTriple *cap);
@@ -128,6 +185,12 @@ private:
   Pin *findPortPinRelative(const char *name);
   Net *findNetRelative(const char *name);
   Instance *findInstanceRelative(const char *name);
+  SpefNameMapEntry *findNameMapEntry(int index);
+  // Find instances and nets using the name map entry cache.
+  Instance *findMappedInstance(const char *name,
+			       SpefNameMapEntry *entry);
+  Net *findMappedNet(const char *name,
+		     SpefNameMapEntry *entry);
   void makeCouplingCap(int id,
 		       char *node_name1,
 		       char *node_name2,
@@ -138,6 +201,7 @@ private:
 			 Net *&ext_net,
 			 int &ext_node_id,
 			 Pin *&ext_pin);
+  bool isConnected(const Pin *pin);
 
   const char *filename_;
   Instance *instance_;
@@ -150,28 +214,49 @@ private:
   const OperatingConditions *op_cond_;
   const Corner *corner_;
   const MinMax *cnst_min_max_;
+  // Nets to read networks for, or null to read all nets.
+  const NetSet *nets_;
+  // Nets read from the file, or null.
+  NetSet *updated_nets_;
   // Normally no need to keep device names.
   bool keep_device_names_;
   bool quiet_;
-  gzFile stream_;
+  ScanInput *input_;
   int line_;
+  void *scanner_;
+  // The next parse reads net sections without the file header.
+  bool net_sections_;
+  // Quoted string token.
+  std::string string_buf_;
+  // Collect warnings instead of reporting them.
+  bool collect_warnings_;
+  SpefWarningSeq warnings_;
   char divider_;
   char delimiter_;
   char bus_brkt_left_;
   char bus_brkt_right_;
   Net *net_;
+  // Nets connected to net_ through the hierarchy.
+  NetSet connected_nets_;
   Report *report_;
   Network *network_;
   Parasitics *parasitics_;
+  ThreadPool *thread_pool_;
+  // Nets with parasitic networks waiting to be reduced.
+  NetSeq reduce_nets_;
 
   int triple_index_;
   float time_scale_;
   float cap_scale_;
   float res_scale_;
   float induct_scale_;
-  SpefNameMap name_map_;
+  // Owned by the header reader and shared by net section readers.
+  SpefNameMap *name_map_;
+  SpefSparseNameMap *name_map_sparse_;
+  bool own_name_map_;
   StringSeq *design_flow_;
   Parasitic *parasitic_;
+  Progress progress_;
 };
 
 class SpefTriple
@@ -204,7 +289,15 @@ private:
   SpefTriple *c1_;
 };
 
-extern SpefReader *spef_reader;
+// Reset the scanner to read new input (SpefLex.ll).
+void
+spefLexReset(void *scanner);
 
 } // namespace
+
+// Global namespace.
+int
+SpefParse_error(sta::SpefReader *reader,
+		const char *msg);
+
 #endif
@@ -14,6 +14,7 @@
 // You should have received a copy of the GNU General Public License
 // along with this program.  If not, see <https://www.gnu.org/licenses/>.
 
+#include <algorithm>
 #include "Machine.hh"
 #include "DeratingFactors.hh"
 
@@ -196,4 +197,139 @@ DeratingFactorsNet::DeratingFactorsNet()
 {
 }
 
+////////////////////////////////////////////////////////////////
+
+DerateTable::DerateTable()
+{
+  for (int type = 0; type < timing_derate_type_count; type++) {
+    for (int clk_data = 0; clk_data < path_clk_or_data_count; clk_data++) {
+      for (int tr = 0; tr < TransRiseFall::index_count; tr++) {
+	for (int el = 0; el < EarlyLate::index_count; el++)
+	  factors_[type][clk_data][tr][el] = 1.0;
+      }
+    }
+  }
+}
+
+void
+DerateTable::setFactors(const DeratingFactorsGlobal *factors)
+{
+  for (int type = 0; type < timing_derate_type_count; type++) {
+    for (int clk_data = 0; clk_data < path_clk_or_data_count; clk_data++) {
+      for (int tr = 0; tr < TransRiseFall::index_count; tr++) {
+	for (int el = 0; el < EarlyLate::index_count; el++) {
+	  float factor;
+	  bool exists;
+	  factors->factor(TimingDerateType(type), PathClkOrData(clk_data),
+			  TransRiseFall::find(tr), EarlyLate::find(el),
+			  factor, exists);
+	  if (exists)
+	    factors_[type][clk_data][tr][el] = factor;
+	}
+      }
+    }
+  }
+}
+
+void
+DerateTable::setFactors(const DeratingFactorsCell *factors)
+{
+  for (int type = 0; type < timing_derate_cell_type_count; type++) {
+    for (int clk_data = 0; clk_data < path_clk_or_data_count; clk_data++) {
+      for (int tr = 0; tr < TransRiseFall::index_count; tr++) {
+	for (int el = 0; el < EarlyLate::index_count; el++) {
+	  float factor;
+	  bool exists;
+	  factors->factor(TimingDerateType(type), PathClkOrData(clk_data),
+			  TransRiseFall::find(tr), EarlyLate::find(el),
+			  factor, exists);
+	  if (exists)
+	    factors_[type][clk_data][tr][el] = factor;
+	}
+      }
+    }
+  }
+}
+
+void
+DerateTable::setFactors(const DeratingFactorsNet *factors)
+{
+  int type = int(TimingDerateType::net_delay);
+  for (int clk_data = 0; clk_data < path_clk_or_data_count; clk_data++) {
+    for (int tr = 0; tr < TransRiseFall::index_count; tr++) {
+      for (int el = 0; el < EarlyLate::index_count; el++) {
+	float factor;
+	bool exists;
+	factors->factor(PathClkOrData(clk_data),
+			TransRiseFall::find(tr), EarlyLate::find(el),
+			factor, exists);
+	if (exists)
+	  factors_[type][clk_data][tr][el] = factor;
+      }
+    }
+  }
+}
+
+////////////////////////////////////////////////////////////////
+
+AocvTable::AocvTable()
+{
+}
+
+void
+AocvTable::setTable(const FloatSeq *depths,
+		    const FloatSeq *derates)
+{
+  depths_.assign(depths->begin(), depths->end());
+  derates_.assign(derates->begin(), derates->end());
+}
+
+float
+AocvTable::derate(float depth) const
+{
+  size_t count = depths_.size();
+  if (depth <= depths_[0])
+    return derates_[0];
+  if (depth >= depths_[count - 1])
+    return derates_[count - 1];
+  size_t upper = std::upper_bound(depths_.begin(), depths_.end(), depth)
+    - depths_.begin();
+  size_t lower = upper - 1;
+  float depth_lower = depths_[lower];
+  float ratio = (depth - depth_lower) / (depths_[upper] - depth_lower);
+  return derates_[lower] + ratio * (derates_[upper] - derates_[lower]);
+}
+
+AocvDerates::AocvDerates()
+{
+}
+
+void
+AocvDerates::setTable(PathClkOrData clk_data,
+		      const TransRiseFallBoth *tr,
+		      const EarlyLate *early_late,
+		      const FloatSeq *depths,
+		      const FloatSeq *derates)
+{
+  TransRiseFallIterator tr_iter(tr);
+  while (tr_iter.hasNext()) {
+    TransRiseFall *tr1 = tr_iter.next();
+    tables_[int(clk_data)][tr1->index()][early_late->index()]
+      .setTable(depths, derates);
+  }
+}
+
+const AocvTable *
+AocvDerates::table(PathClkOrData clk_data,
+		   const TransRiseFall *tr,
+		   const EarlyLate *early_late) const
+{
+  const AocvTable &table =
+    tables_[int(clk_data)][tr->index()][early_late->index()];
+  if (table.exists())
+    return &table;
+  else
+    return nullptr;
+}
+
 } // namespace
@@ -17,10 +17,12 @@
 #ifndef STA_DERATING_FACTORS_H
 #define STA_DERATING_FACTORS_H
 
+#include <vector>
 #include "DisallowCopyAssign.hh"
 #include "LibertyClass.hh"
 #include "SdcClass.hh"
 #include "MinMax.hh"
+#include "Transition.hh"
 #include "RiseFallMinMax.hh"
 
 namespace sta {
@@ -114,5 +116,67 @@ private:
   DISALLOW_COPY_AND_ASSIGN(DeratingFactorsNet);
 };
 
+// Derating factors with the factors inherited from less specific
+// derates (cell and global) filled in so a derate is an array lookup.
+// Factors that are not set anywhere are 1.0.
+class DerateTable
+{
+public:
+  DerateTable();
+  // Copy the factors that exist over the inherited ones.
+  void setFactors(const DeratingFactorsGlobal *factors);
+  void setFactors(const DeratingFactorsCell *factors);
+  void setFactors(const DeratingFactorsNet *factors);
+  float factor(TimingDerateType type,
+	       PathClkOrData clk_data,
+	       const TransRiseFall *tr,
+	       const EarlyLate *early_late) const
+  { return factors_[int(type)][int(clk_data)][tr->index()][early_late->index()]; }
+
+protected:
+  float factors_[timing_derate_type_count][path_clk_or_data_count]
+  [TransRiseFall::index_count][EarlyLate::index_count];
+};
+
+// Advanced on-chip variation derates indexed by the logic depth
+// (number of cell stages) of the path segment thru a cell.
+class AocvTable
+{
+public:
+  AocvTable();
+  // depths must be increasing.
+  void setTable(const FloatSeq *depths,
+		const FloatSeq *derates);
+  bool exists() const { return !depths_.empty(); }
+  // Derate interpolated between the table depths and clipped to the
+  // first/last derate outside of them.
+  float derate(float depth) const;
+
+protected:
+  std::vector<float> depths_;
+  std::vector<float> derates_;
+};
+
+class AocvDerates
+{
+public:
+  AocvDerates();
+  void setTable(PathClkOrData clk_data,
+		const TransRiseFallBoth *tr,
+		const EarlyLate *early_late,
+		const FloatSeq *depths,
+		const FloatSeq *derates);
+  // Return nullptr if there is no table.
+  const AocvTable *table(PathClkOrData clk_data,
+			 const TransRiseFall *tr,
+			 const EarlyLate *early_late) const;
+
+private:
+  DISALLOW_COPY_AND_ASSIGN(AocvDerates);
+
+  AocvTable tables_[path_clk_or_data_count]
+  [TransRiseFall::index_count][EarlyLate::index_count];
+};
+
 } // namespace
 #endif
@@ -39,8 +39,6 @@ class ExceptionThru;
 class ExceptionTo;
 class ExceptionState;
 
-typedef Vector<ExceptionPath*> ExceptionPathSeq;
-
 class ExceptionPath : public SdcCmdComment
 {
 public:
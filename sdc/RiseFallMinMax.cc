@@ -14,11 +14,15 @@
 // You should have received a copy of the GNU General Public License
 // along with this program.  If not, see <https://www.gnu.org/licenses/>.
 
+#include <limits>
 #include "Machine.hh"
 #include "RiseFallMinMax.hh"
 
 namespace sta {
 
+const float RiseFallMinMax::missing_value_ =
+  std::numeric_limits<float>::quiet_NaN();
+
 RiseFallMinMax::RiseFallMinMax()
 {
   clear();
@@ -29,7 +33,7 @@ RiseFallMinMax::clear()
 {
   for (int tr_index=0; tr_index<TransRiseFall::index_count; tr_index++) {
     for (int mm_index = 0; mm_index < MinMax::index_count; mm_index++) {
-      exists_[tr_index][mm_index] = false;
+      values_[tr_index][mm_index] = missing_value_;
     }
   }
 }
@@ -39,7 +43,6 @@ RiseFallMinMax::RiseFallMinMax(float init_value)
   for (int tr_index=0;tr_index<TransRiseFall::index_count;tr_index++) {
     for (int mm_index = 0; mm_index < MinMax::index_count; mm_index++) {
       values_[tr_index][mm_index] = init_value;
-      exists_[tr_index][mm_index] = true;
     }
   }
 }
@@ -49,7 +52,6 @@ RiseFallMinMax::RiseFallMinMax(const RiseFallMinMax *rfmm)
   for (int tr_index=0;tr_index<TransRiseFall::index_count;tr_index++) {
     for (int mm_index = 0; mm_index < MinMax::index_count; mm_index++) {
       values_[tr_index][mm_index] = rfmm->values_[tr_index][mm_index];
-      exists_[tr_index][mm_index] = rfmm->exists_[tr_index][mm_index];
     }
   }
 }
@@ -74,7 +76,6 @@ RiseFallMinMax::setValue(const TransRiseFallBoth *tr,
       MinMax *mm = mm_iter.next();
       int mm_index = mm->index();
       values_[tr_index][mm_index] = value;
-      exists_[tr_index][mm_index] = true;
     }
   }
 }
@@ -88,7 +89,7 @@ RiseFallMinMax::removeValue(const TransRiseFallBoth *tr,
   while (tr_iter.hasNext()) {
     TransRiseFall *tr = tr_iter.next();
     int tr_index = tr->index();
-    exists_[tr_index][mm_index] = false;
+    values_[tr_index][mm_index] = missing_value_;
   }
 }
 
@@ -116,11 +117,9 @@ RiseFallMinMax::mergeValue(const TransRiseFallBoth *tr,
     while (mm_iter.hasNext()) {
       MinMax *mm = mm_iter.next();
       int mm_index = mm->index();
-      if (!exists_[tr_index][mm_index]
-	  || mm->compare(value, values_[tr_index][mm_index])) {
+      if (!isValue(values_[tr_index][mm_index])
+	  || mm->compare(value, values_[tr_index][mm_index]))
 	values_[tr_index][mm_index] = value;
-	exists_[tr_index][mm_index] = true;
-      }
     }
   }
 }
@@ -136,7 +135,6 @@ RiseFallMinMax::setValue(const TransRiseFallBoth *tr,
     TransRiseFall *tr = tr_iter.next();
     int tr_index = tr->index();
     values_[tr_index][mm_index] = value;
-    exists_[tr_index][mm_index] = true;
   }
 }
 
@@ -148,7 +146,6 @@ RiseFallMinMax::setValue(const TransRiseFall *tr,
   int tr_index = tr->index();
   int mm_index = min_max->index();
   values_[tr_index][mm_index] = value;
-  exists_[tr_index][mm_index] = true;
 }
 
 void
@@ -157,7 +154,6 @@ RiseFallMinMax::setValues(RiseFallMinMax *values)
   for (int tr_index=0;tr_index<TransRiseFall::index_count;tr_index++) {
     for (int mm_index = 0; mm_index < MinMax::index_count; mm_index++) {
       values_[tr_index][mm_index] = values->values_[tr_index][mm_index];
-      exists_[tr_index][mm_index] = values->exists_[tr_index][mm_index];
     }
   }
 }
@@ -167,9 +163,10 @@ RiseFallMinMax::value(const TransRiseFall *tr,
 		      const MinMax *min_max,
 		      float &value, bool &exists) const
 {
-  exists = exists_[tr->index()][min_max->index()];
+  float value1 = values_[tr->index()][min_max->index()];
+  exists = isValue(value1);
   if (exists)
-    value = values_[tr->index()][min_max->index()];
+    value = value1;
 }
 
 float
@@ -190,7 +187,7 @@ RiseFallMinMax::empty() const
 {
   for (int tr_index=0;tr_index<TransRiseFall::index_count;tr_index++) {
     for (int mm_index = 0; mm_index < MinMax::index_count; mm_index++) {
-      if (exists_[tr_index][mm_index])
+      if (isValue(values_[tr_index][mm_index]))
 	return false;
     }
   }
@@ -200,7 +197,7 @@ RiseFallMinMax::empty() const
 bool
 RiseFallMinMax::hasValue(const TransRiseFall *tr, const MinMax *min_max) const
 {
-  return exists_[tr->index()][min_max->index()];
+  return isValue(values_[tr->index()][min_max->index()]);
 }
 
 void
@@ -211,17 +208,15 @@ RiseFallMinMax::mergeWith(RiseFallMinMax *rfmm)
     MinMax *min_max = mm_iter.next();
     int mm_index = min_max->index();
     for (int tr_index=0;tr_index<TransRiseFall::index_count;tr_index++) {
-      bool exists1 = exists_[tr_index][mm_index];
-      bool exists2 = rfmm->exists_[tr_index][mm_index];
+      bool exists1 = isValue(values_[tr_index][mm_index]);
+      bool exists2 = isValue(rfmm->values_[tr_index][mm_index]);
       if (exists1 && exists2) {
 	float rfmm_value = rfmm->values_[tr_index][mm_index];
 	if (min_max->compare(rfmm_value, values_[tr_index][mm_index]))
 	  values_[tr_index][mm_index] = rfmm_value;
       }
-      else if (!exists1 && exists2) {
+      else if (!exists1 && exists2)
 	values_[tr_index][mm_index] = rfmm->values_[tr_index][mm_index];
-	exists_[tr_index][mm_index] = true;
-      }
     }
   }
 }
@@ -231,8 +226,8 @@ RiseFallMinMax::equal(const RiseFallMinMax *values) const
 {
   for (int tr_index=0;tr_index<TransRiseFall::index_count;tr_index++) {
     for (int mm_index = 0; mm_index < MinMax::index_count; mm_index++) {
-      bool exists1 = exists_[tr_index][mm_index];
-      bool exists2 = values->exists_[tr_index][mm_index];
+      bool exists1 = isValue(values_[tr_index][mm_index]);
+      bool exists2 = isValue(values->values_[tr_index][mm_index]);
       if (exists1 != exists2)
 	return false;
       if (exists1 && exists2
@@ -253,11 +248,11 @@ RiseFallMinMax::isOneValue() const
 bool
 RiseFallMinMax::isOneValue(float &value) const
 {
-  if (exists_[0][0]) {
+  if (isValue(values_[0][0])) {
     value = values_[0][0];
     for (int tr_index=0;tr_index<TransRiseFall::index_count;tr_index++) {
       for (int mm_index=0; mm_index<MinMax::index_count;mm_index++) {
-	if (!exists_[tr_index][mm_index]
+	if (!isValue(values_[tr_index][mm_index])
 	    || values_[tr_index][mm_index] != value)
 	  return false;
       }
@@ -274,10 +269,10 @@ RiseFallMinMax::isOneValue(const MinMax *min_max,
 			   float &value) const
 {
   int mm_index = min_max->index();
-  if (exists_[0][mm_index]) {
+  if (isValue(values_[0][mm_index])) {
     value = values_[0][mm_index];
     for (int tr_index=0;tr_index<TransRiseFall::index_count;tr_index++) {
-      if (!exists_[tr_index][mm_index]
+      if (!isValue(values_[tr_index][mm_index])
 	  || values_[tr_index][mm_index] != value)
 	return false;
     }
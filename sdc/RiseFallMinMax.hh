@@ -24,6 +24,8 @@
 namespace sta {
 
 // Rise/Fall/Min/Max group of four values common to many constraints.
+// Missing values are stored as NaN so there is no separate existence
+// flag for each value; there are lots of these in the sdc.
 class RiseFallMinMax
 {
 public:
@@ -68,8 +70,11 @@ public:
 		  float &value) const;
 
 private:
+  // NaN is the only value that is not equal to itself.
+  static bool isValue(float value) { return value == value; }
+
   float values_[TransRiseFall::index_count][MinMax::index_count];
-  bool exists_[TransRiseFall::index_count][MinMax::index_count];
+  static const float missing_value_;
 };
 
 } // namespace
@@ -14,11 +14,15 @@
 // You should have received a copy of the GNU General Public License
 // along with this program.  If not, see <https://www.gnu.org/licenses/>.
 
+#include <limits>
 #include "Machine.hh"
 #include "RiseFallValues.hh"
 
 namespace sta {
 
+const float RiseFallValues::missing_value_ =
+  std::numeric_limits<float>::quiet_NaN();
+
 RiseFallValues::RiseFallValues()
 {
   clear();
@@ -31,7 +35,7 @@ RiseFallValues::clear()
   while (tr_iter.hasNext()) {
     TransRiseFall *tr = tr_iter.next();
     int tr_index = tr->index();
-    exists_[tr_index] = false;
+    values_[tr_index] = missing_value_;
   }
 }
 
@@ -42,7 +46,6 @@ RiseFallValues::RiseFallValues(float init_value)
     TransRiseFall *tr = tr_iter.next();
     int tr_index = tr->index();
     values_[tr_index] = init_value;
-    exists_[tr_index] = true;
   }
 }
 
@@ -60,7 +63,6 @@ RiseFallValues::setValue(const TransRiseFallBoth *tr, float value)
     TransRiseFall *tr = tr_iter.next();
     int tr_index = tr->index();
     values_[tr_index] = value;
-    exists_[tr_index] = true;
   }
 }
 
@@ -69,7 +71,6 @@ RiseFallValues::setValue(const TransRiseFall *tr, float value)
 {
   int tr_index = tr->index();
   values_[tr_index] = value;
-  exists_[tr_index] = true;
 }
 
 void
@@ -80,7 +81,6 @@ RiseFallValues::setValues(RiseFallValues *values)
     TransRiseFall *tr = tr_iter.next();
     int tr_index = tr->index();
     values_[tr_index] = values->values_[tr_index];
-    exists_[tr_index] = values->exists_[tr_index];
   }
 }
 
@@ -89,9 +89,10 @@ RiseFallValues::value(const TransRiseFall *tr,
 		      float &value, bool &exists) const
 {
   int tr_index = tr->index();
-  exists = exists_[tr_index];
+  float value1 = values_[tr_index];
+  exists = isValue(value1);
   if (exists)
-    value = values_[tr_index];
+    value = value1;
 }
 
 float
@@ -103,7 +104,7 @@ RiseFallValues::value(const TransRiseFall *tr) const
 bool
 RiseFallValues::hasValue(const TransRiseFall *tr) const
 {
-  return exists_[tr->index()];
+  return isValue(values_[tr->index()]);
 }
 
 } // namespace
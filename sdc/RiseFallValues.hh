@@ -23,6 +23,7 @@
 namespace sta {
 
 // Rise/fall group of two values.
+// Missing values are stored as NaN (see RiseFallMinMax).
 class RiseFallValues
 {
 public:
@@ -41,8 +42,10 @@ public:
 private:
   DISALLOW_COPY_AND_ASSIGN(RiseFallValues);
 
+  static bool isValue(float value) { return value == value; }
+
   float values_[TransRiseFall::index_count];
-  bool exists_[TransRiseFall::index_count];
+  static const float missing_value_;
 };
 
 } // namespace
@@ -47,6 +47,7 @@
 #include "Levelize.hh"
 #include "HpinDrvrLoad.hh"
 #include "Corner.hh"
+#include "ThreadForEach.hh"
 #include "Sdc.hh"
 
 namespace sta {
@@ -90,10 +91,13 @@ Sdc::Sdc(StaState *sta) :
   net_derating_factors_(nullptr),
   inst_derating_factors_(nullptr),
   cell_derating_factors_(nullptr),
+  derate_tables_valid_(false),
+  global_derate_table_(nullptr),
+  aocv_derates_(nullptr),
   clk_index_(0),
   clk_insertions_(nullptr),
-  clk_group_exclusions_(nullptr),
-  clk_group_same_(nullptr),
+  clk_group_clk_count_(0),
+  clk_group_relations_valid_(false),
   clk_sense_map_(network_),
   clk_gating_check_(nullptr),
   input_delay_index_(0),
@@ -110,6 +114,9 @@ Sdc::Sdc(StaState *sta) :
   first_to_clk_exceptions_(nullptr),
   first_to_inst_exceptions_(nullptr),
   first_thru_edge_exceptions_(nullptr),
+  thru_index_valid_(false),
+  exception_merge_deferred_(false),
+  searched_exceptions_changed_(false),
   path_delay_internal_startpoints_(nullptr),
   path_delay_internal_endpoints_(nullptr)
 {
@@ -318,6 +325,7 @@ Sdc::deleteConstraints()
   clearGroupPathMap();
   deleteInstancePvts();
   deleteDeratingFactors();
+  deleteAocvDerates();
   removeLoadCaps();
   clk_sense_map_.clear();
 }
@@ -428,8 +436,21 @@ Sdc::initInstancePvtMaps()
 void
 Sdc::searchPreamble()
 {
+  mergePendingExceptions();
+  unsearched_exceptions_.clear();
   ensureClkHpinDisables();
   ensureClkGroupExclusions();
+  ensureDerateTables();
+}
+
+bool
+Sdc::searchPreambleDue() const
+{
+  return !exception_merge_pending_.empty()
+    || !unsearched_exceptions_.empty()
+    || !clk_hpin_disables_valid_
+    || !clk_group_relations_valid_
+    || !derate_tables_valid_;
 }
 
 ////////////////////////////////////////////////////////////////
@@ -440,7 +461,7 @@ Sdc::isConstrained(const Pin *pin) const
   Pin *pin1 = const_cast<Pin*>(pin);
   Port *port = network_->isTopLevelPort(pin) ? network_->port(pin) : nullptr;
   return clock_pin_map_.hasKey(pin)
-    || propagated_clk_pins_.hasKey(pin1)
+    || propagated_clk_pins_.hasKey(pin)
     || hasClockLatency(pin)
     || hasClockInsertion(pin)
     || pin_clk_uncertainty_map_.hasKey(pin)
@@ -579,6 +600,7 @@ Sdc::setTimingDerate(TimingDerateType type,
   if (derating_factors_ == nullptr)
     derating_factors_ = new DeratingFactorsGlobal;
   derating_factors_->setFactor(type, clk_data, tr, early_late, derate);
+  derate_tables_valid_ = false;
 }
 
 void
@@ -596,6 +618,7 @@ Sdc::setTimingDerate(const Net *net,
     (*net_derating_factors_)[net] = factors;
   }
   factors->setFactor(clk_data, tr, early_late, derate);
+  derate_tables_valid_ = false;
 }
 
 void
@@ -614,6 +637,7 @@ Sdc::setTimingDerate(const Instance *inst,
     (*inst_derating_factors_)[inst] = factors;
   }
   factors->setFactor(type, clk_data, tr, early_late, derate);
+  derate_tables_valid_ = false;
 }
 
 void
@@ -632,6 +656,7 @@ Sdc::setTimingDerate(const LibertyCell *cell,
     (*cell_derating_factors_)[cell] = factors;
   }
   factors->setFactor(type, clk_data, tr, early_late, derate);
+  derate_tables_valid_ = false;
 }
 
 float
@@ -641,6 +666,25 @@ Sdc::timingDerateInstance(const Pin *pin,
 			  const TransRiseFall *tr,
 			  const EarlyLate *early_late) const
 {
+  if (derate_tables_valid_) {
+    if (!inst_derate_tables_.empty()) {
+      const Instance *inst = network_->instance(pin);
+      DerateTable *table = inst_derate_tables_.findKey(inst);
+      if (table)
+	return table->factor(type, clk_data, tr, early_late);
+    }
+    if (!cell_derate_tables_.empty()) {
+      const Instance *inst = network_->instance(pin);
+      const LibertyCell *cell = network_->libertyCell(inst);
+      DerateTable *table = cell_derate_tables_.findKey(cell);
+      if (table)
+	return table->factor(type, clk_data, tr, early_late);
+    }
+    if (global_derate_table_)
+      return global_derate_table_->factor(type, clk_data, tr, early_late);
+    return 1.0;
+  }
+
   if (inst_derating_factors_) {
     const Instance *inst = network_->instance(pin);
     DeratingFactorsCell *factors = inst_derating_factors_->findKey(inst);
@@ -683,6 +727,20 @@ Sdc::timingDerateNet(const Pin *pin,
 		     const TransRiseFall *tr,
 		     const EarlyLate *early_late) const
 {
+  if (derate_tables_valid_) {
+    if (!net_derate_tables_.empty()) {
+      const Net *net = network_->net(pin);
+      DerateTable *table = net_derate_tables_.findKey(net);
+      if (table)
+	return table->factor(TimingDerateType::net_delay, clk_data, tr,
+			     early_late);
+    }
+    if (global_derate_table_)
+      return global_derate_table_->factor(TimingDerateType::net_delay,
+					  clk_data, tr, early_late);
+    return 1.0;
+  }
+
   if (net_derating_factors_) {
     const Net *net = network_->net(pin);
     DeratingFactorsNet *factors = net_derating_factors_->findKey(net);
@@ -746,6 +804,151 @@ Sdc::deleteDeratingFactors()
 
   delete derating_factors_;
   derating_factors_ = nullptr;
+  deleteDerateTables();
+}
+
+void
+Sdc::ensureDerateTables()
+{
+  if (!derate_tables_valid_) {
+    deleteDerateTables();
+    if (derating_factors_) {
+      global_derate_table_ = new DerateTable;
+      global_derate_table_->setFactors(derating_factors_);
+    }
+    // Tables with no factors are all 1.0.
+    DerateTable no_derates;
+    const DerateTable *global = global_derate_table_
+      ? global_derate_table_
+      : &no_derates;
+    if (cell_derating_factors_) {
+      CellDeratingFactorsMap::Iterator cell_iter(cell_derating_factors_);
+      while (cell_iter.hasNext()) {
+	const LibertyCell *cell;
+	DeratingFactorsCell *factors;
+	cell_iter.next(cell, factors);
+	DerateTable *table = new DerateTable(*global);
+	table->setFactors(factors);
+	cell_derate_tables_[cell] = table;
+      }
+    }
+    if (inst_derating_factors_) {
+      InstDeratingFactorsMap::Iterator inst_iter(inst_derating_factors_);
+      while (inst_iter.hasNext()) {
+	const Instance *inst;
+	DeratingFactorsCell *factors;
+	inst_iter.next(inst, factors);
+	const LibertyCell *cell = network_->libertyCell(inst);
+	const DerateTable *cell_table = cell_derate_tables_.findKey(cell);
+	DerateTable *table = new DerateTable(cell_table ? *cell_table : *global);
+	table->setFactors(factors);
+	inst_derate_tables_[inst] = table;
+      }
+    }
+    if (net_derating_factors_) {
+      NetDeratingFactorsMap::Iterator net_iter(net_derating_factors_);
+      while (net_iter.hasNext()) {
+	const Net *net;
+	DeratingFactorsNet *factors;
+	net_iter.next(net, factors);
+	DerateTable *table = new DerateTable(*global);
+	table->setFactors(factors);
+	net_derate_tables_[net] = table;
+      }
+    }
+    derate_tables_valid_ = true;
+  }
+}
+
+void
+Sdc::deleteDerateTables()
+{
+  inst_derate_tables_.deleteContentsClear();
+  cell_derate_tables_.deleteContentsClear();
+  net_derate_tables_.deleteContentsClear();
+  delete global_derate_table_;
+  global_derate_table_ = nullptr;
+  derate_tables_valid_ = false;
+}
+
+void
+Sdc::timingDerateCellChanged(const Instance *inst)
+{
+  // The instance table inherits the cell derates.
+  if (inst_derate_tables_.hasKey(inst))
+    derate_tables_valid_ = false;
+}
+
+////////////////////////////////////////////////////////////////
+
+void
+Sdc::setAocvDerate(PathClkOrData clk_data,
+		   const TransRiseFallBoth *tr,
+		   const EarlyLate *early_late,
+		   const FloatSeq *depths,
+		   const FloatSeq *derates)
+{
+  if (aocv_derates_ == nullptr)
+    aocv_derates_ = new AocvDerates;
+  aocv_derates_->setTable(clk_data, tr, early_late, depths, derates);
+}
+
+void
+Sdc::setAocvDerate(const LibertyCell *cell,
+		   PathClkOrData clk_data,
+		   const TransRiseFallBoth *tr,
+		   const EarlyLate *early_late,
+		   const FloatSeq *depths,
+		   const FloatSeq *derates)
+{
+  AocvDerates *cell_derates = cell_aocv_derates_.findKey(cell);
+  if (cell_derates == nullptr) {
+    cell_derates = new AocvDerates;
+    cell_aocv_derates_[cell] = cell_derates;
+  }
+  cell_derates->setTable(clk_data, tr, early_late, depths, derates);
+}
+
+bool
+Sdc::hasAocvDerates() const
+{
+  return aocv_derates_
+    || !cell_aocv_derates_.empty();
+}
+
+float
+Sdc::aocvDerate(const LibertyCell *cell,
+		PathClkOrData clk_data,
+		const TransRiseFall *tr,
+		const EarlyLate *early_late,
+		float depth) const
+{
+  const AocvTable *table = nullptr;
+  if (cell && !cell_aocv_derates_.empty()) {
+    AocvDerates *cell_derates = cell_aocv_derates_.findKey(cell);
+    if (cell_derates)
+      table = cell_derates->table(clk_data, tr, early_late);
+  }
+  if (table == nullptr && aocv_derates_)
+    table = aocv_derates_->table(clk_data, tr, early_late);
+  if (table)
+    return table->derate(depth);
+  else
+    return 1.0;
+}
+
+void
+Sdc::unsetAocvDerates()
+{
+  deleteAocvDerates();
+}
+
+void
+Sdc::deleteAocvDerates()
+{
+  cell_aocv_derates_.deleteContentsClear();
+  delete aocv_derates_;
+  aocv_derates_ = nullptr;
 }
 
 ////////////////////////////////////////////////////////////////
@@ -1578,7 +1781,7 @@ Sdc::removePropagatedClock(Pin *pin)
 bool
 Sdc::isPropagatedClock(const Pin *pin)
 {
-  return propagated_clk_pins_.hasKey(const_cast<Pin*>(pin));
+  return propagated_clk_pins_.hasKey(pin);
 }
 
 void
@@ -1964,39 +2167,34 @@ Sdc::clockInsertion(const Clock *clk,
 
 ////////////////////////////////////////////////////////////////
 
+size_t
+ClockLatencyPinClkHash::operator()(const ClockLatency *latency) const
+{
+  return hashSum(hashPtr(latency->clock()), hashPtr(latency->pin()));
+}
+
 bool
-ClockLatencyPinClkLess::operator()(const ClockLatency *latency1,
-				   const ClockLatency *latency2) const
+ClockLatencyPinClkEqual::operator()(const ClockLatency *latency1,
+				    const ClockLatency *latency2) const
 {
-  const Clock *clk1 = latency1->clock();
-  const Clock *clk2 = latency2->clock();
-  const Pin *pin1 = latency1->pin();
-  const Pin *pin2 = latency2->pin();
-  return clk1 < clk2
-    || (clk1 == clk2
-	&& pin1 < pin2);
+  return latency1->clock() == latency2->clock()
+    && latency1->pin() == latency2->pin();
 }
 
 ////////////////////////////////////////////////////////////////
 
+size_t
+ClockInsertionPinClkHash::operator()(const ClockInsertion *insert) const
+{
+  return hashSum(hashPtr(insert->clock()), hashPtr(insert->pin()));
+}
+
 bool
-ClockInsertionPinClkLess::operator()(const ClockInsertion *insert1,
-				     const ClockInsertion *insert2)const
-{
-  const Clock *clk1 = insert1->clock();
-  const Clock *clk2 = insert2->clock();
-  const Pin *pin1 = insert1->pin();
-  const Pin *pin2 = insert2->pin();
-  return (clk1 && clk2
-	  && (clk1 < clk2
-	      || (clk1 == clk2
-		  && pin1 && pin2
-		  && pin1 < pin2)))
-    || (clk1 == nullptr && clk2)
-    || (clk1 == nullptr && clk2 == nullptr
-	&& ((pin1 && pin2
-	     && pin1 < pin2)
-	    || (pin1 == nullptr && pin2)));
+ClockInsertionPinClkEqual::operator()(const ClockInsertion *insert1,
+				      const ClockInsertion *insert2) const
+{
+  return insert1->clock() == insert2->clock()
+    && insert1->pin() == insert2->pin();
 }
 
 ////////////////////////////////////////////////////////////////
@@ -2056,11 +2254,13 @@ Sdc::clockGroupIterator()
 void
 Sdc::ensureClkGroupExclusions()
 {
-  if (clk_group_exclusions_ == nullptr) {
-    clk_group_exclusions_ = new ClockPairSet;
-    clk_group_same_ = new ClockPairSet;
+  if (!clk_group_relations_valid_) {
+    clk_group_clk_count_ = clk_index_;
+    clk_group_relations_.assign(clk_group_clk_count_ * clk_group_clk_count_,
+				0);
     for (auto name_clk_groups : clk_groups_name_map_)
       makeClkGroupExclusions(name_clk_groups.second);
+    clk_group_relations_valid_ = true;
   }
 }
    
@@ -2089,7 +2289,7 @@ Sdc::makeClkGroupExclusions1(ClockGroupSet *groups)
     for (Clock *clk2 : clocks_) {
       if (clk2 != clk1
 	  && !group1->isMember(clk2))
-	clk_group_exclusions_->insert(ClockPair(clk1, clk2));
+	setClkGroupRelation(clk1, clk2, clk_group_excluded_);
     }
   }
   makeClkGroupSame(group1);
@@ -2105,10 +2305,9 @@ Sdc::makeClkGroupExclusions(ClockGroupSet *groups)
 	ClockSet *clks2 = group2->clks();
 	for (auto clk1 : *clks1) {
 	  for (auto clk2 : *clks2) {
-	    // ClockPair is symmetric so only add one clk1/clk2 pair.
-	    if (clk1->index() < clk2->index()) {
-	      clk_group_exclusions_->insert(ClockPair(clk1, clk2));
-	    }
+	    // Relations are symmetric so only add one clk1/clk2 pair.
+	    if (clk1->index() < clk2->index())
+	      setClkGroupRelation(clk1, clk2, clk_group_excluded_);
 	  }
 	}
       }
@@ -2123,11 +2322,8 @@ Sdc::makeClkGroupSame(ClockGroup *group)
   ClockSet *clks = group->clks();
   for (auto clk1 : *clks) {
     for (auto clk2 : *clks) {
-      if (clk1->index() <= clk2->index()) {
-	ClockPair clk_pair(clk1, clk2);
-	if (!clk_group_same_->hasKey(clk_pair))
-	  clk_group_same_->insert(clk_pair);
-      }
+      if (clk1->index() <= clk2->index())
+	setClkGroupRelation(clk1, clk2, clk_group_same_);
     }
   }
 }
@@ -2135,23 +2331,42 @@ Sdc::makeClkGroupSame(ClockGroup *group)
 void
 Sdc::clearClkGroupExclusions()
 {
-  if (clk_group_exclusions_) {
-    delete clk_group_exclusions_;
-    delete clk_group_same_;
-    clk_group_exclusions_ = nullptr;
-    clk_group_same_ = nullptr;
-  }
+  clk_group_relations_.clear();
+  clk_group_clk_count_ = 0;
+  clk_group_relations_valid_ = false;
+}
+
+void
+Sdc::setClkGroupRelation(const Clock *clk1,
+			 const Clock *clk2,
+			 unsigned char relation)
+{
+  int index1 = clk1->index();
+  int index2 = clk2->index();
+  clk_group_relations_[index1 * clk_group_clk_count_ + index2] |= relation;
+  clk_group_relations_[index2 * clk_group_clk_count_ + index1] |= relation;
+}
+
+// Clocks defined after the matrix was built have no relations.
+unsigned char
+Sdc::clkGroupRelation(const Clock *clk1,
+		      const Clock *clk2) const
+{
+  int index1 = clk1->index();
+  int index2 = clk2->index();
+  if (index1 < clk_group_clk_count_
+      && index2 < clk_group_clk_count_)
+    return clk_group_relations_[index1 * clk_group_clk_count_ + index2];
+  else
+    return 0;
 }
 
 bool
 Sdc::sameClockGroup(const Clock *clk1,
 		    const Clock *clk2)
 {
-  if (clk1 && clk2) {
-    ClockPair clk_pair(clk1, clk2);
-    bool excluded = clk_group_exclusions_->hasKey(clk_pair);
-    return !excluded;
-  }
+  if (clk1 && clk2)
+    return !(clkGroupRelation(clk1, clk2) & clk_group_excluded_);
   else
     return true;
 }
@@ -2160,8 +2375,8 @@ bool
 Sdc::sameClockGroupExplicit(const Clock *clk1,
 			    const Clock *clk2)
 {
-  ClockPair clk_pair(clk1, clk2);
-  return clk_group_same_->hasKey(clk_pair);
+  ensureClkGroupExclusions();
+  return clkGroupRelation(clk1, clk2) & clk_group_same_;
 }
 
 void
@@ -3355,6 +3570,25 @@ Sdc::hasNetWireCap(Net *net) const
   return false;
 }
 
+bool
+Sdc::netWireCapsEqual(const Corner *corner1,
+		      const Corner *corner2) const
+{
+  if (net_wire_cap_map_) {
+    NetWireCapMap &caps1 = net_wire_cap_map_[corner1->index()];
+    NetWireCapMap &caps2 = net_wire_cap_map_[corner2->index()];
+    if (caps1.size() != caps2.size())
+      return false;
+    for (auto &net_caps1 : caps1) {
+      auto caps2_iter = caps2.find(net_caps1.first);
+      if (caps2_iter == caps2.end()
+	  || !MinMaxFloatValues::equal(&net_caps1.second, &caps2_iter->second))
+	return false;
+    }
+  }
+  return true;
+}
+
 ////////////////////////////////////////////////////////////////
 
 void
@@ -4063,6 +4297,12 @@ Sdc::removeCaseAnalysis(Pin *pin)
   case_value_map_.erase(pin);
 }
 
+void
+Sdc::setCaseAnalysis(const LogicValueMap *case_values)
+{
+  case_value_map_ = *case_values;
+}
+
 void
 Sdc::caseLogicValue(const Pin *pin,
 		    LogicValue &value,
@@ -4593,8 +4833,109 @@ Sdc::addException2(ExceptionPath *exception)
 {
   if (exception->isMultiCycle() || exception->isPathDelay())
     deleteMatchingExceptions(exception);
-  recordException(exception);
-  mergeException(exception);
+  unsearched_exceptions_.insert(exception);
+  if (exception_merge_deferred_) {
+    // Merge hashes are recorded by mergePendingExceptions.
+    exceptions_.insert(exception);
+    recordExceptionFirstPts(exception);
+    exception_merge_order_.push_back(exception);
+    exception_merge_pending_.insert(exception);
+  }
+  else {
+    mergePendingExceptions();
+    recordException(exception);
+    mergeException(exception);
+  }
+}
+
+ExceptionPathSet *
+Sdc::exceptions()
+{
+  mergePendingExceptions();
+  return &exceptions_;
+}
+
+void
+Sdc::setExceptionMergeDeferred(bool deferred)
+{
+  exception_merge_deferred_ = deferred;
+}
+
+// Hashing the missing points of an exception only reads the exception,
+// so the hashes of the pending exceptions are found in parallel and sorted
+// into buckets that are recorded one bucket at a time.  The merges
+// themselves edit the shared first point maps and are done serially
+// in the order the exceptions were added.
+void
+Sdc::mergePendingExceptions()
+{
+  if (!exception_merge_pending_.empty()) {
+    ExceptionPathSeq pending;
+    pending.reserve(exception_merge_pending_.size());
+    for (ExceptionPath *exception : exception_merge_order_) {
+      // Deleted exceptions are no longer pending, and an exception
+      // allocated at the address of a deleted one is only listed once.
+      if (exception_merge_pending_.hasKey(exception)) {
+	pending.push_back(exception);
+	exception_merge_pending_.erase(exception);
+      }
+    }
+    exception_merge_order_.clear();
+    debugPrint1(debug_, "exception_merge", 1, "merge %lu pending exceptions\n",
+		static_cast<unsigned long>(pending.size()));
+
+    size_t count = pending.size();
+    std::vector<size_t> offsets(count + 1);
+    size_t pt_count = 0;
+    for (size_t i = 0; i < count; i++) {
+      offsets[i] = pt_count;
+      ExceptionPtIterator pt_iter(pending[i]);
+      while (pt_iter.hasNext()) {
+	pt_iter.next();
+	pt_count++;
+      }
+    }
+    offsets[count] = pt_count;
+
+    // (hash, pending index) for each missing point.
+    std::vector<std::pair<Hash, size_t> > hashes(pt_count);
+    forEachChunk(count, thread_pool_, [&] (size_t begin, size_t end, int) {
+	for (size_t i = begin; i < end; i++) {
+	  ExceptionPath *exception = pending[i];
+	  size_t h = offsets[i];
+	  ExceptionPtIterator pt_iter(exception);
+	  while (pt_iter.hasNext()) {
+	    ExceptionPt *missing_pt = pt_iter.next();
+	    hashes[h++] = std::make_pair(exception->hash(missing_pt), i);
+	  }
+	}
+      });
+    std::sort(hashes.begin(), hashes.end());
+
+    size_t h = 0;
+    while (h < pt_count) {
+      Hash hash = hashes[h].first;
+      ExceptionPathSet *set = exception_merge_hash_.findKey(hash);
+      if (set == nullptr) {
+	set = new ExceptionPathSet;
+	exception_merge_hash_[hash] = set;
+      }
+      for (; h < pt_count && hashes[h].first == hash; h++)
+	set->insert(pending[hashes[h].second]);
+    }
+
+    // Exceptions that are merged away are removed from
+    // exception_merge_pending_ by unrecordException.
+    for (ExceptionPath *exception : pending)
+      exception_merge_pending_.insert(exception);
+    for (ExceptionPath *exception : pending) {
+      if (exception_merge_pending_.hasKey(exception)) {
+	exception_merge_pending_.erase(exception);
+	mergeException(exception);
+      }
+    }
+    exception_merge_pending_.clear();
+  }
 }
 
 // If a path delay/multicycle exception is redefined with a different
@@ -4949,6 +5290,7 @@ Sdc::recordMergeHash(ExceptionPath *exception,
 void
 Sdc::recordExceptionFirstPts(ExceptionPath *exception)
 {
+  exceptionThruIndexInvalid();
   if (exception->from())
     recordExceptionFirstFrom(exception);
   else if (exception->thrus())
@@ -5160,8 +5502,11 @@ Sdc::findMergeMatch(ExceptionPath *exception)
 		      exception->asString(network_));
 	  debugPrint1(debug_, "exception_merge", 1, " with %s\n",
 		      match->asString(network_));
+	  searchedExceptionChanged(exception);
+	  searchedExceptionChanged(match);
 	  // Unrecord the exception that is being merged away.
 	  unrecordException(exception);
+	  unsearched_exceptions_.erase(exception);
 	  unrecordMergeHashes(match);
 	  missing_pt->mergeInto(match_missing_pt);
 	  recordMergeHashes(match);
@@ -5202,6 +5547,7 @@ Sdc::deleteExceptions()
   deleteExceptionMap(first_thru_inst_exceptions_);
   deleteExceptionMap(first_thru_net_exceptions_);
   deleteExceptionMap(first_thru_edge_exceptions_);
+  exceptionThruIndexInvalid();
 
   delete path_delay_internal_startpoints_;
   path_delay_internal_startpoints_ = nullptr;
@@ -5211,6 +5557,22 @@ Sdc::deleteExceptions()
 
   deleteExceptionPtHashMapSets(exception_merge_hash_);
   exception_merge_hash_.clear();
+  exception_merge_order_.clear();
+  exception_merge_pending_.clear();
+  unsearched_exceptions_.clear();
+}
+
+void
+Sdc::searchedExceptionChanged(ExceptionPath *exception)
+{
+  if (!unsearched_exceptions_.hasKey(exception))
+    searched_exceptions_changed_ = true;
+}
+
+void
+Sdc::clearSearchedExceptionsChanged()
+{
+  searched_exceptions_changed_ = false;
 }
 
 void
@@ -5338,7 +5700,9 @@ Sdc::deleteException(ExceptionPath *exception)
 {
   debugPrint1(debug_, "exception_merge", 2, "delete %s\n",
 	      exception->asString(network_));
+  searchedExceptionChanged(exception);
   unrecordException(exception);
+  unsearched_exceptions_.erase(exception);
   delete exception;
 }
 
@@ -5348,6 +5712,7 @@ Sdc::unrecordException(ExceptionPath *exception)
   unrecordMergeHashes(exception);
   unrecordExceptionFirstPts(exception);
   exceptions_.erase(exception);
+  exception_merge_pending_.erase(exception);
 }
 
 void
@@ -5378,6 +5743,7 @@ Sdc::unrecordMergeHash(ExceptionPath *exception,
 void
 Sdc::unrecordExceptionFirstPts(ExceptionPath *exception)
 {
+  exceptionThruIndexInvalid();
   ExceptionFrom *from = exception->from();
   ExceptionThruSeq *thrus = exception->thrus();
   ExceptionTo *to = exception->to();
@@ -5752,6 +6118,66 @@ Sdc::exceptionThruStates(const Pin *from_pin,
   }
 }
 
+bool
+Sdc::isExceptionThruPin(const Pin *to_pin) const
+{
+  ensureExceptionThruIndex();
+  return thru_index_pins_.hasKey(to_pin)
+    || (!thru_index_insts_.empty()
+	&& thru_index_insts_.hasKey(network_->instance(to_pin)))
+    || (!thru_index_nets_.empty()
+	&& thru_index_nets_.hasKey(network_->net(to_pin)));
+}
+
+// Tag propagation calls isExceptionThruPin from multiple threads so
+// the index is built under a lock the first time it is needed.
+void
+Sdc::ensureExceptionThruIndex() const
+{
+  if (!thru_index_valid_) {
+    UniqueLock lock(thru_index_lock_);
+    if (!thru_index_valid_) {
+      thru_index_pins_.clear();
+      thru_index_insts_.clear();
+      thru_index_nets_.clear();
+      for (auto exception : exceptions_) {
+	ExceptionThruSeq *thrus = exception->thrus();
+	if (thrus) {
+	  for (auto thru : *thrus) {
+	    PinSet *pins = thru->pins();
+	    if (pins) {
+	      for (auto pin : *pins)
+		thru_index_pins_.insert(pin);
+	    }
+	    EdgePinsSet *edges = thru->edges();
+	    if (edges) {
+	      for (auto edge_pins : *edges)
+		thru_index_pins_.insert(edge_pins->second);
+	    }
+	    InstanceSet *insts = thru->instances();
+	    if (insts) {
+	      for (auto inst : *insts)
+		thru_index_insts_.insert(inst);
+	    }
+	    NetSet *nets = thru->nets();
+	    if (nets) {
+	      for (auto net : *nets)
+		thru_index_nets_.insert(net);
+	    }
+	  }
+	}
+      }
+      thru_index_valid_ = true;
+    }
+  }
+}
+
+void
+Sdc::exceptionThruIndexInvalid()
+{
+  thru_index_valid_ = false;
+}
+
 void
 Sdc::exceptionThruStates(const ExceptionPathSet *exceptions,
 			 const TransRiseFall *to_tr,
@@ -6155,6 +6581,7 @@ Sdc::setUseDefaultArrivalClock(bool enable)
 void
 Sdc::connectPinAfter(Pin *pin)
 {
+  exceptionThruIndexInvalid();
   PinSet *drvrs = network_->drivers(pin);
   ExceptionPathSet::Iterator except_iter(exceptions_);
   while (except_iter.hasNext()) {
@@ -6176,6 +6603,7 @@ Sdc::connectPinAfter(Pin *pin)
 void
 Sdc::disconnectPinBefore(Pin *pin)
 {
+  exceptionThruIndexInvalid();
   ExceptionPathSet::Iterator except_iter(exceptions_);
   while (except_iter.hasNext()) {
     ExceptionPath *exception = except_iter.next();
@@ -6206,7 +6634,7 @@ Sdc::clkHpinDisablesChanged(Pin *pin)
 void
 Sdc::annotateGraph(bool annotate)
 {
-  Stats stats(debug_);
+  Stats stats(debug_, phase_stats_);
   // All output pins are considered constrained because
   // they may be downstream from a set_min/max_delay -from that
   // does not have a set_output_delay.
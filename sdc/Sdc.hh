@@ -17,7 +17,9 @@
 #ifndef STA_SDC_H
 #define STA_SDC_H
 
+#include <atomic>
 #include <mutex>
+#include <vector>
 #include "DisallowCopyAssign.hh"
 #include "StringUtil.hh"
 #include "StringSet.hh"
@@ -52,6 +54,8 @@ class DeratingFactors;
 class DeratingFactorsGlobal;
 class DeratingFactorsNet;
 class DeratingFactorsCell;
+class DerateTable;
+class AocvDerates;
 class PatternMatch;
 class FindNetCaps;
 class ClkHpinDisable;
@@ -65,14 +69,26 @@ class ClockIterator;
 
 typedef std::pair<const Pin*, const Clock*> PinClockPair;
 
-class ClockInsertionPinClkLess
+class ClockInsertionPinClkHash
+{
+public:
+  size_t operator()(const ClockInsertion *insert) const;
+};
+
+class ClockInsertionPinClkEqual
 {
 public:
   bool operator()(const ClockInsertion *insert1,
 		  const ClockInsertion *insert2) const;
 };
 
-class ClockLatencyPinClkLess
+class ClockLatencyPinClkHash
+{
+public:
+  size_t operator()(const ClockLatency *latency) const;
+};
+
+class ClockLatencyPinClkEqual
 {
 public:
   bool operator()(const ClockLatency *latency1,
@@ -109,11 +125,11 @@ public:
 
 typedef Map<const char*,Clock*, CharPtrLess> ClockNameMap;
 typedef UnorderedMap<const Pin*, ClockSet*> ClockPinMap;
-typedef Map<const Pin*,InputDelay*> InputDelayMap;
+typedef UnorderedMap<const Pin*,InputDelay*> InputDelayMap;
 typedef Set<InputDelay*> InputDelaySet;
-typedef Map<const Pin*,InputDelaySet*> InputDelayRefPinMap;
-typedef Map<const Pin*,InputDelaySet*> InputDelayInternalPinMap;
-typedef Map<const Pin*,OutputDelay*> OutputDelayMap;
+typedef UnorderedMap<const Pin*,InputDelaySet*> InputDelayRefPinMap;
+typedef UnorderedMap<const Pin*,InputDelaySet*> InputDelayInternalPinMap;
+typedef UnorderedMap<const Pin*,OutputDelay*> OutputDelayMap;
 typedef UnorderedSet<CycleAccting*, CycleAcctingHash, CycleAcctingEqual> CycleAcctingSet;
 typedef Set<Instance*> InstanceSet;
 typedef UnorderedMap<const Pin*,ExceptionPathSet*> PinExceptionsMap;
@@ -123,22 +139,24 @@ typedef Map<const Net*,ExceptionPathSet*> NetExceptionsMap;
 typedef UnorderedMap<const EdgePins*,ExceptionPathSet*,
 		     PinPairHash, PinPairEqual> EdgeExceptionsMap;
 typedef Vector<ExceptionThru*> ExceptionThruSeq;
-typedef Map<const Port*,InputDrive*> InputDriveMap;
+typedef UnorderedMap<const Port*,InputDrive*> InputDriveMap;
 typedef Map<int, ExceptionPathSet*, std::less<int> > ExceptionPathPtHash;
-typedef Set<ClockLatency*, ClockLatencyPinClkLess> ClockLatencies;
-typedef Map<const Pin*, ClockUncertainties*> PinClockUncertaintyMap;
+typedef UnorderedSet<ClockLatency*, ClockLatencyPinClkHash,
+		     ClockLatencyPinClkEqual> ClockLatencies;
+typedef UnorderedMap<const Pin*, ClockUncertainties*> PinClockUncertaintyMap;
 typedef Set<InterClockUncertainty*,
 	    InterClockUncertaintyLess> InterClockUncertaintySet;
 typedef Map<const Clock*, ClockGatingCheck*> ClockGatingCheckMap;
 typedef Map<const Instance*, ClockGatingCheck*> InstanceClockGatingCheckMap;
 typedef Map<const Pin*, ClockGatingCheck*> PinClockGatingCheckMap;
-typedef Set<ClockInsertion*, ClockInsertionPinClkLess> ClockInsertions;
-typedef Map<const Pin*, float> PinLatchBorrowLimitMap;
+typedef UnorderedSet<ClockInsertion*, ClockInsertionPinClkHash,
+		     ClockInsertionPinClkEqual> ClockInsertions;
+typedef UnorderedMap<const Pin*, float> PinLatchBorrowLimitMap;
 typedef Map<const Instance*, float> InstLatchBorrowLimitMap;
 typedef Map<const Clock*, float> ClockLatchBorrowLimitMap;
 typedef Set<DataCheck*, DataCheckLess> DataCheckSet;
-typedef Map<const Pin*, DataCheckSet*> DataChecksMap;
-typedef Map<Port*, PortExtCap*> PortExtCapMap;
+typedef UnorderedMap<const Pin*, DataCheckSet*> DataChecksMap;
+typedef UnorderedMap<Port*, PortExtCap*> PortExtCapMap;
 typedef Map<Net*, MinMaxFloatValues> NetResistanceMap;
 typedef Map<Port*, MinMaxFloatValues> PortSlewLimitMap;
 typedef Map<const Pin*, MinMaxFloatValues> PinSlewLimitMap;
@@ -151,13 +169,17 @@ typedef Map<Cell*, MinMaxFloatValues> CellFanoutLimitMap;
 typedef Map<Net*, MinMaxFloatValues> NetWireCapMap;
 typedef Map<Pin*, MinMaxFloatValues*> PinWireCapMap;
 typedef Map<Instance*, Pvt*> InstancePvtMap;
-typedef Map<Edge*, ClockLatency*> EdgeClockLatencyMap;
+typedef UnorderedMap<Edge*, ClockLatency*> EdgeClockLatencyMap;
 typedef Map<const Pin*, RiseFallValues*> PinMinPulseWidthMap;
 typedef Map<const Clock*, RiseFallValues*> ClockMinPulseWidthMap;
 typedef Map<const Instance*, RiseFallValues*> InstMinPulseWidthMap;
-typedef Map<const Net*, DeratingFactorsNet*> NetDeratingFactorsMap;
-typedef Map<const Instance*, DeratingFactorsCell*> InstDeratingFactorsMap;
-typedef Map<const LibertyCell*, DeratingFactorsCell*> CellDeratingFactorsMap;
+typedef UnorderedMap<const Net*, DeratingFactorsNet*> NetDeratingFactorsMap;
+typedef UnorderedMap<const Instance*, DeratingFactorsCell*> InstDeratingFactorsMap;
+typedef UnorderedMap<const LibertyCell*, DeratingFactorsCell*> CellDeratingFactorsMap;
+typedef UnorderedMap<const Net*, DerateTable*> NetDerateTableMap;
+typedef UnorderedMap<const Instance*, DerateTable*> InstDerateTableMap;
+typedef UnorderedMap<const LibertyCell*, DerateTable*> CellDerateTableMap;
+typedef UnorderedMap<const LibertyCell*, AocvDerates*> CellAocvDeratesMap;
 typedef Set<ClockGroups*> ClockGroupsSet;
 typedef Map<const Clock*, ClockGroupsSet*> ClockGroupsClkMap;
 typedef Map<const char*, ClockGroups*, CharPtrLess> ClockGroupsNameMap;
@@ -234,6 +256,33 @@ public:
 			const TransRiseFall *tr,
 			const EarlyLate *early_late) const;
   void unsetTimingDerate();
+  // Resolve the derates of each instance, cell and net with the
+  // derates they inherit so timingDerateInstance/Net are one table
+  // lookup.  Called by searchPreamble.
+  void ensureDerateTables();
+  // The cell of an instance changed (replace_cell).
+  void timingDerateCellChanged(const Instance *inst);
+  // Advanced on-chip variation cell delay derates by logic depth.
+  void setAocvDerate(PathClkOrData clk_data,
+		     const TransRiseFallBoth *tr,
+		     const EarlyLate *early_late,
+		     const FloatSeq *depths,
+		     const FloatSeq *derates);
+  void setAocvDerate(const LibertyCell *cell,
+		     PathClkOrData clk_data,
+		     const TransRiseFallBoth *tr,
+		     const EarlyLate *early_late,
+		     const FloatSeq *depths,
+		     const FloatSeq *derates);
+  bool hasAocvDerates() const;
+  // AOCV derate of a cell arc at depth. Cell tables take precedence
+  // over the global table. Return 1.0 if there is no table.
+  float aocvDerate(const LibertyCell *cell,
+		   PathClkOrData clk_data,
+		   const TransRiseFall *tr,
+		   const EarlyLate *early_late,
+		   float depth) const;
+  void unsetAocvDerates();
   void setInputSlew(Port *port, const TransRiseFallBoth *tr,
 		    const MinMaxAll *min_max, float slew);
   // Set the rise/fall drive resistance on design port.
@@ -589,6 +638,9 @@ public:
 		     const MinMax *min_max,
 		     float cap);
   bool hasNetWireCap(Net *net) const;
+  // True if the corners have the same net wire capacitances.
+  bool netWireCapsEqual(const Corner *corner1,
+			const Corner *corner2) const;
   // True if driver pin net has wire capacitance.
   bool drvrPinHasWireCap(const Pin *pin);
   // Net wire capacitance (set_load -wire net).
@@ -684,6 +736,8 @@ public:
   void setCaseAnalysis(Pin *pin,
 		       LogicValue value);
   void removeCaseAnalysis(Pin *pin);
+  // Replace all set_case_analysis values with case_values.
+  void setCaseAnalysis(const LogicValueMap *case_values);
   void logicValue(const Pin *pin,
 		  LogicValue &value,
 		  bool &exists);
@@ -983,6 +1037,10 @@ public:
 			   const TransRiseFall *to_tr,
 			   const MinMax *min_max,
 			   ExceptionStateSet *&states) const;
+  // True if to_pin is on some exception -thru (pin, edge, instance or net)
+  // so an exception state can advance at it.  Tag propagation skips
+  // checking each state's next -thru at other pins.
+  bool isExceptionThruPin(const Pin *to_pin) const;
   // Find the highest priority exception with first exception pt at
   // pin/clk end.
   void exceptionTo(ExceptionPathType type,
@@ -1011,7 +1069,20 @@ public:
   bool isPathDelayInternalStartpoint(const Pin *pin) const;
   PinSet *pathDelayInternalStartpoints() const;
   bool isPathDelayInternalEndpoint(const Pin *pin) const;
-  ExceptionPathSet *exceptions() { return &exceptions_; }
+  ExceptionPathSet *exceptions();
+  // When merging is deferred new exceptions are recorded without
+  // trying to merge them with existing exceptions.  The pending
+  // exceptions are merged in one pass by mergePendingExceptions,
+  // which is called before the first search that follows.
+  bool exceptionMergeDeferred() const { return exception_merge_deferred_; }
+  void setExceptionMergeDeferred(bool deferred);
+  void mergePendingExceptions();
+  // True when an exception that tags may reference was deleted or
+  // merged into since the last clearSearchedExceptionsChanged.
+  bool searchedExceptionsChanged() const { return searched_exceptions_changed_; }
+  // searchPreamble has work to do.
+  bool searchPreambleDue() const;
+  void clearSearchedExceptionsChanged();
   void deleteExceptions();
   void deleteException(ExceptionPath *exception);
   void recordException(ExceptionPath *exception);
@@ -1088,6 +1159,8 @@ protected:
 				ExceptionPath *excluding,
 				ExceptionPathSet &expanded_matches);
   void recordException1(ExceptionPath *exception);
+  void ensureExceptionThruIndex() const;
+  void exceptionThruIndexInvalid();
   void recordExceptionFirstPts(ExceptionPath *exception);
   void recordExceptionFirstFrom(ExceptionPath *exception);
   void recordExceptionFirstThru(ExceptionPath *exception);
@@ -1135,6 +1208,7 @@ protected:
   void unrecordMergeHash(ExceptionPath *exception,
 			 ExceptionPt *missing_pt);
   void mergeException(ExceptionPath *exception);
+  void searchedExceptionChanged(ExceptionPath *exception);
   void expandException(ExceptionPath *exception,
 		       ExceptionPathSet &expansions);
   bool exceptionFromStates(const ExceptionPathSet *exceptions,
@@ -1214,6 +1288,8 @@ protected:
   void deleteClockLatenciesReferencing(Clock *clk);
   void deleteClockLatency(ClockLatency *latency);
   void deleteDeratingFactors();
+  void deleteDerateTables();
+  void deleteAocvDerates();
   void annotateGraphOutputDelays(bool annotate);
   void annotateGraphDataChecks(bool annotate);
   void annotateGraphConstrained(const PinSet *pins,
@@ -1260,11 +1336,16 @@ protected:
 			const Corner *corner,
 			const MinMax *min_max) const;
   void removeClockGroups(ClockGroups *groups);
-  void ensureClkGroupExclusions();;
+  void ensureClkGroupExclusions();
   void makeClkGroupExclusions(ClockGroups *clk_groups);
   void makeClkGroupExclusions1(ClockGroupSet *groups);
   void makeClkGroupExclusions(ClockGroupSet *groups);
   void makeClkGroupSame(ClockGroup *group);
+  void setClkGroupRelation(const Clock *clk1,
+			   const Clock *clk2,
+			   unsigned char relation);
+  unsigned char clkGroupRelation(const Clock *clk1,
+				 const Clock *clk2) const;
   void clearClkGroupExclusions();
   char *makeClockGroupsName();
   void setClockSense(const Pin *pin,
@@ -1289,6 +1370,16 @@ protected:
   NetDeratingFactorsMap *net_derating_factors_;
   InstDeratingFactorsMap *inst_derating_factors_;
   CellDeratingFactorsMap *cell_derating_factors_;
+  // Derating factors resolved by ensureDerateTables.
+  bool derate_tables_valid_;
+  // nullptr when there are no global derates.
+  DerateTable *global_derate_table_;
+  InstDerateTableMap inst_derate_tables_;
+  CellDerateTableMap cell_derate_tables_;
+  NetDerateTableMap net_derate_tables_;
+  // nullptr when there are no global AOCV derates.
+  AocvDerates *aocv_derates_;
+  CellAocvDeratesMap cell_aocv_derates_;
   // Clock sequence retains clock definition order.
   // This is important for getting consistent regression results,
   // which iterating over the name map can't provide.
@@ -1304,17 +1395,23 @@ protected:
   ClockPinMap clock_vertex_pin_map_;
   ClkHpinDisables clk_hpin_disables_;
   bool clk_hpin_disables_valid_;
-  PinSet propagated_clk_pins_;
+  UnorderedSet<const Pin*> propagated_clk_pins_;
   ClockLatencies clk_latencies_;
   ClockInsertions *clk_insertions_;
   PinClockUncertaintyMap pin_clk_uncertainty_map_;
   InterClockUncertaintySet inter_clk_uncertainties_;
   // clk_groups name -> clk_groups
   ClockGroupsNameMap clk_groups_name_map_;
+  // Dense clock pair matrix of clk_group_excluded_/clk_group_same_
+  // bits indexed by clk1->index() * clk_group_clk_count_ + clk2->index()
+  // so path end clock group checks do not search a pair set.
+  std::vector<unsigned char> clk_group_relations_;
+  int clk_group_clk_count_;
+  bool clk_group_relations_valid_;
   // clk to clk paths excluded by clock groups.
-  ClockPairSet *clk_group_exclusions_;
+  static const unsigned char clk_group_excluded_ = 1;
   // clks in the same set_clock_group set.
-  ClockPairSet *clk_group_same_;
+  static const unsigned char clk_group_same_ = 2;
   ClockSenseMap clk_sense_map_;
   ClockGatingCheck *clk_gating_check_;
   ClockGatingCheckMap clk_gating_check_map_;
@@ -1377,9 +1474,24 @@ protected:
   InstanceExceptionsMap *first_to_inst_exceptions_;
   // Edges that traverse hierarchical exception pins.
   EdgeExceptionsMap *first_thru_edge_exceptions_;
+  // Objects on any exception -thru, built on demand by isExceptionThruPin.
+  mutable UnorderedSet<const Pin*> thru_index_pins_;
+  mutable UnorderedSet<const Instance*> thru_index_insts_;
+  mutable UnorderedSet<const Net*> thru_index_nets_;
+  mutable std::atomic<bool> thru_index_valid_;
+  mutable std::mutex thru_index_lock_;
 
   // Exception hash with one missing from/thru/to point, used for merging.
   ExceptionPathPtHash exception_merge_hash_;
+  bool exception_merge_deferred_;
+  // Exceptions waiting to be merged, in the order they were added.
+  ExceptionPathSeq exception_merge_order_;
+  // Pending exceptions that have not been merged away or deleted.
+  ExceptionPathSet exception_merge_pending_;
+  // Exceptions added since the last search preamble.
+  // Tags cannot reference them yet.
+  ExceptionPathSet unsearched_exceptions_;
+  bool searched_exceptions_changed_;
   // Path delay -from pin internal startpoints.
   PinSet *path_delay_internal_startpoints_;
   // Path delay -to pin internal endpoints.
@@ -20,6 +20,8 @@
 #include "Machine.hh"
 #include "DisallowCopyAssign.hh"
 #include "Report.hh"
+#include "ThreadPool.hh"
+#include "ThreadForEach.hh"
 #include "Error.hh"
 #include "Units.hh"
 #include "StaState.hh"
@@ -51,6 +53,8 @@ namespace sta {
 typedef Set<ClockSense*> ClockSenseSet;
 typedef Vector<ClockSense*> ClockSenseSeq;
 
+static const size_t stream_buffer_size = 1 << 16;
+
 static const char *
 transRiseFallFlag(const TransRiseFall *tr);
 static const char *
@@ -281,11 +285,12 @@ writeSdc(Instance *instance,
 	 const char *filename,
 	 const char *creator,
 	 bool compatible,
+	 bool gzip,
 	 bool no_timestamp,
 	 int digits,
 	 Sdc *sdc)
 {
-  WriteSdc writer(instance, filename, creator, compatible, digits,
+  WriteSdc writer(instance, filename, creator, compatible, gzip, digits,
 		  no_timestamp, sdc);
   writer.write();
 }
@@ -294,6 +299,7 @@ WriteSdc::WriteSdc(Instance *instance,
 		   const char *filename,
 		   const char *creator,
 		   bool compatible,
+		   bool gzip,
 		   int digits,
 		   bool no_timestamp,
 		   Sdc *sdc) :
@@ -302,11 +308,32 @@ WriteSdc::WriteSdc(Instance *instance,
   filename_(filename),
   creator_(creator),
   compatible_(compatible),
+  gzip_(gzip),
   digits_(digits),
   no_timestamp_(no_timestamp),
   top_instance_(instance == sdc_network_->topInstance()),
   instance_name_length_(strlen(sdc_network_->pathName(instance))),
-  cell_(sdc_network_->cell(instance))
+  cell_(sdc_network_->cell(instance)),
+  stream_(nullptr),
+  gz_stream_(nullptr)
+{
+}
+
+WriteSdc::WriteSdc(const WriteSdc *writer,
+		   FILE *stream) :
+  StaState(writer),
+  instance_(writer->instance_),
+  filename_(writer->filename_),
+  creator_(writer->creator_),
+  compatible_(writer->compatible_),
+  gzip_(false),
+  digits_(writer->digits_),
+  no_timestamp_(writer->no_timestamp_),
+  top_instance_(writer->top_instance_),
+  instance_name_length_(writer->instance_name_length_),
+  cell_(writer->cell_),
+  stream_(stream),
+  gz_stream_(nullptr)
 {
 }
 
@@ -317,6 +344,8 @@ WriteSdc::~WriteSdc()
 void
 WriteSdc::write()
 {
+  // Sections read the exceptions concurrently.
+  sdc_->mergePendingExceptions();
   openFile(filename_);
   writeHeader();
   writeTiming();
@@ -329,14 +358,35 @@ WriteSdc::write()
 void
 WriteSdc::openFile(const char *filename)
 {
-  stream_ = fopen(filename, "w");
-  if (stream_ == nullptr)
-    throw FileNotWritable(filename);
+  if (gzip_) {
+    gz_stream_ = gzopen(filename, "wb");
+    if (gz_stream_ == Z_NULL)
+      throw FileNotWritable(filename);
+    stream_ = tmpfile();
+    if (stream_ == nullptr) {
+      gzclose(gz_stream_);
+      throw FileNotWritable(filename);
+    }
+  }
+  else {
+    stream_ = fopen(filename, "w");
+    if (stream_ == nullptr)
+      throw FileNotWritable(filename);
+  }
+  setvbuf(stream_, nullptr, _IOFBF, stream_buffer_size);
 }
 
 void
 WriteSdc::closeFile()
 {
+  if (gzip_) {
+    rewind(stream_);
+    char buffer[stream_buffer_size];
+    size_t length;
+    while ((length = fread(buffer, 1, stream_buffer_size, stream_)) > 0)
+      gzwrite(gz_stream_, buffer, length);
+    gzclose(gz_stream_);
+  }
   fclose(stream_);
 }
 
@@ -366,6 +416,56 @@ WriteSdc::writeHeader() const
 
 ////////////////////////////////////////////////////////////////
 
+// Each section is written to a temporary file by a writer that
+// shares this writer's settings.  Sections only read the constraints
+// and network.
+void
+WriteSdc::writeSections(const WriteSdcSection *sections,
+			size_t count) const
+{
+  if (thread_pool_ == nullptr
+      || thread_pool_->threadCount() <= 1) {
+    for (size_t i = 0; i < count; i++)
+      (this->*sections[i])();
+  }
+  else {
+    std::vector<FILE*> streams(count, nullptr);
+    forEachChunk(count, thread_pool_, [&] (size_t begin, size_t end, int) {
+	for (size_t i = begin; i < end; i++) {
+	  FILE *stream = tmpfile();
+	  if (stream) {
+	    setvbuf(stream, nullptr, _IOFBF, stream_buffer_size);
+	    WriteSdc writer(this, stream);
+	    (writer.*sections[i])();
+	  }
+	  streams[i] = stream;
+	}
+      });
+    for (size_t i = 0; i < count; i++) {
+      FILE *stream = streams[i];
+      if (stream) {
+	copyStream(stream);
+	fclose(stream);
+      }
+      else
+	// No temporary file so write the section directly.
+	(this->*sections[i])();
+    }
+  }
+}
+
+void
+WriteSdc::copyStream(FILE *from) const
+{
+  rewind(from);
+  char buffer[stream_buffer_size];
+  size_t length;
+  while ((length = fread(buffer, 1, stream_buffer_size, from)) > 0)
+    fwrite(buffer, 1, length, stream_);
+}
+
+////////////////////////////////////////////////////////////////
+
 void
 WriteSdc::writeTiming() const
 {
@@ -378,11 +478,14 @@ WriteSdc::writeTiming() const
   writeInterClockUncertainties();
   writeClockSenses();
   writeClockGroups();
-  writeInputDelays();
-  writeOutputDelays();
-  writeDisables();
-  writeExceptions();
-  writeDataChecks();
+  static const WriteSdcSection sections[] = {
+    &WriteSdc::writeInputDelays,
+    &WriteSdc::writeOutputDelays,
+    &WriteSdc::writeDisables,
+    &WriteSdc::writeExceptions,
+    &WriteSdc::writeDataChecks
+  };
+  writeSections(sections, sizeof(sections) / sizeof(sections[0]));
 }
 
 void
@@ -645,9 +748,7 @@ WriteSdc::writeClockInsertion(ClockInsertion *insert,
 void
 WriteSdc::writePropagatedClkPins() const
 {
-  PinSet::Iterator pin_iter(sdc_->propagated_clk_pins_);
-  while (pin_iter.hasNext()) {
-    const Pin *pin = pin_iter.next();
+  for (const Pin *pin : sdc_->propagated_clk_pins_) {
     fprintf(stream_, "set_propagated_clock ");
     writeGetPin(pin);
     fprintf(stream_, "\n");
@@ -1564,14 +1665,17 @@ WriteSdc::writeEnvironment() const
   writeCommentSection("Environment");
   writeOperatingConditions();
   writeWireload();
-  writePinLoads();
-  writeDriveResistances();
-  writeDrivingCells();
-  writeInputTransitions();
-  writeNetResistances();
-  writeConstants();
-  writeCaseAnalysis();
-  writeDeratings();
+  static const WriteSdcSection sections[] = {
+    &WriteSdc::writePinLoads,
+    &WriteSdc::writeDriveResistances,
+    &WriteSdc::writeDrivingCells,
+    &WriteSdc::writeInputTransitions,
+    &WriteSdc::writeNetResistances,
+    &WriteSdc::writeConstants,
+    &WriteSdc::writeCaseAnalysis,
+    &WriteSdc::writeDeratings
+  };
+  writeSections(sections, sizeof(sections) / sizeof(sections[0]));
 }
 
 void
@@ -29,6 +29,7 @@ writeSdc(Instance *instance,
 	 const char *filename,
 	 const char *creator,
 	 bool compatible,
+	 bool gzip,
 	 bool no_timestamp,
 	 int digits,
 	 Sdc *sdc);
@@ -17,11 +17,16 @@
 #ifndef STA_WRITE_SDC_PVT_H
 #define STA_WRITE_SDC_PVT_H
 
+#include <stdio.h>
 #include "DisallowCopyAssign.hh"
+#include "Zlib.hh"
 
 namespace sta {
 
 class WriteSdcObject;
+class WriteSdc;
+
+typedef void (WriteSdc::*WriteSdcSection)() const;
 
 class WriteSdc : public StaState
 {
@@ -30,6 +35,7 @@ public:
 	   const char *filename,
 	   const char *creator,
 	   bool compatible,
+	   bool gzip,
 	   int digits,
 	   bool no_timestamp,
 	   Sdc *sdc);
@@ -40,6 +46,11 @@ public:
   void closeFile();
   void flush();
   virtual void writeHeader() const;
+  // Write independent sections in parallel and copy them to
+  // stream_ in order.
+  void writeSections(const WriteSdcSection *sections,
+		     size_t count) const;
+  void copyStream(FILE *from) const;
   void writeTiming() const;
   void writeDisables() const;
   void writeDisabledCells() const;
@@ -236,16 +247,24 @@ public:
   FILE *stream() const { return stream_; }
 
 protected:
+  // Section writer that shares the settings of writer.
+  WriteSdc(const WriteSdc *writer,
+	   FILE *stream);
+
   Instance *instance_;
   const char *filename_;
   const char *creator_;
   bool compatible_;
+  bool gzip_;
   int digits_;
   bool no_timestamp_;
   bool top_instance_;
   size_t instance_name_length_;
   Cell *cell_;
   FILE *stream_;
+  // gzip output is written to stream_ (a temporary file) and
+  // compressed into gz_stream_ when the file is closed.
+  gzFile gz_stream_;
 
 private:
   DISALLOW_COPY_AND_ASSIGN(WriteSdc);
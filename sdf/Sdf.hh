@@ -17,8 +17,10 @@
 #ifndef STA_SDF_H
 #define STA_SDF_H
 
+#include <functional>
+#include <mutex>
+#include <vector>
 #include "DisallowCopyAssign.hh"
-#include "Zlib.hh"
 #include "Vector.hh"
 #include "TimingRole.hh"
 #include "Transition.hh"
@@ -45,6 +47,34 @@ class SdfPortSpec;
 
 typedef Vector<SdfTriple*> SdfTripleSeq;
 
+class SdfReader;
+class ScanInput;
+
+typedef std::function<void (SdfReader *reader)> SdfAnnotation;
+
+// Annotation command with the parser state when it was read.
+class SdfDeferredAnnotation
+{
+public:
+  SdfDeferredAnnotation(int line,
+			Instance *instance,
+			bool in_incremental,
+			const SdfAnnotation &annotation) :
+    line_(line),
+    instance_(instance),
+    in_incremental_(in_incremental),
+    annotation_(annotation)
+  {
+  }
+
+  int line_;
+  Instance *instance_;
+  bool in_incremental_;
+  SdfAnnotation annotation_;
+};
+
+typedef std::vector<SdfDeferredAnnotation> SdfDeferredAnnotationSeq;
+
 class SdfReader : public StaState
 {
 public:
@@ -159,6 +189,39 @@ public:
 
 private:
   DISALLOW_COPY_AND_ASSIGN(SdfReader);
+  // Worker that annotates deferred commands with the settings of reader.
+  explicit SdfReader(const SdfReader *reader);
+  void annotate(const SdfAnnotation &annotation);
+  void annotateDeferred();
+  void annotateInterconnect(const char *from_pin_name,
+			    const char *to_pin_name,
+			    SdfTripleSeq *triples);
+  void annotateIopath(SdfPortSpec *from_edge,
+		      const char *to_port_name,
+		      SdfTripleSeq *triples,
+		      const char *cond,
+		      bool condelse);
+  void annotateTimingCheck(TimingRole *role,
+			   SdfPortSpec *data_edge,
+			   SdfPortSpec *clk_edge,
+			   SdfTriple *triple);
+  void annotateTimingCheckWidth(SdfPortSpec *edge,
+				SdfTriple *triple);
+  void annotateTimingCheckPeriod(SdfPortSpec *edge,
+				 SdfTriple *triple);
+  void annotateTimingCheckSetupHold(SdfPortSpec *data_edge,
+				    SdfPortSpec *clk_edge,
+				    SdfTriple *setup_triple,
+				    SdfTriple *hold_triple);
+  void annotateTimingCheckRecRem(SdfPortSpec *data_edge,
+				 SdfPortSpec *clk_edge,
+				 SdfTriple *rec_triple,
+				 SdfTriple *rem_triple);
+  void annotatePort(const char *to_pin_name,
+		    SdfTripleSeq *triples);
+  void annotateDevice(SdfTripleSeq *triples);
+  void annotateDevice(const char *to_pin_name,
+		      SdfTripleSeq *triples);
   int readSdfFile1(Network *network,
 		   Graph *graph,
 		   const char *filename);
@@ -207,7 +270,7 @@ private:
   MinMaxAll *cond_use_;
 
   int line_;
-  gzFile stream_;
+  ScanInput *input_;
   char divider_;
   char escape_;
   Instance *instance_;
@@ -215,8 +278,17 @@ private:
   bool in_timing_check_;
   bool in_incremental_;
   float timescale_;
+  // With multiple threads annotation commands are deferred until a
+  // batch of them is read and then annotated in parallel by workers.
+  // The commands only look up pins and edges concurrently; graph
+  // annotation writes and errors are serialized by annotate_lock_.
+  bool parallel_;
+  SdfDeferredAnnotationSeq deferred_;
+  std::mutex own_annotate_lock_;
+  std::mutex &annotate_lock_;
 
   static const int null_index_ = -1;
+  static const size_t deferred_batch_size_ = 1 << 16;
 };
 
 extern SdfReader *sdf_reader;
@@ -64,6 +64,7 @@ read_sdf_file_single(const char *filename,
   cmdLinkedNetwork();
   Sta *sta = Sta::sta();
   sta->ensureGraph();
+  sta->unshareDcalcAnalysisPts();
   if (stringEq(path, ""))
     path = NULL;
   bool success = readSdfSingle(filename, path, corner, sdf_index,
@@ -89,6 +90,7 @@ read_sdf_file_min_max(const char *filename,
   cmdLinkedNetwork();
   Sta *sta = Sta::sta();
   sta->ensureGraph();
+  sta->unshareDcalcAnalysisPts();
   if (stringEq(path, ""))
     path = NULL;
   bool success = readSdfMinMax(filename, path, corner, sdf_min_index,
@@ -27,6 +27,9 @@
 #include "Graph.hh"
 #include "Corner.hh"
 #include "DcalcAnalysisPt.hh"
+#include "ThreadPool.hh"
+#include "ThreadForEach.hh"
+#include "ScanInput.hh"
 #include "Sdf.hh"
 #include "SdfReader.hh"
 
@@ -143,17 +146,48 @@ SdfReader::SdfReader(const char *filename,
   is_incremental_only_(is_incremental_only),
   cond_use_(cond_use),
   line_(1),
+  input_(nullptr),
   escape_('\\'),
   instance_(nullptr),
   cell_name_(nullptr),
   in_timing_check_(false),
   in_incremental_(false),
-  timescale_(1.0E-9F)		// default units of ns
+  timescale_(1.0E-9F),		// default units of ns
+  parallel_(thread_pool_ && thread_pool_->threadCount() > 1),
+  annotate_lock_(own_annotate_lock_)
 {
   if (unescaped_dividers)
     network_ = makeSdcNetwork(network_);
 }
 
+// The worker shares the reader's network, so it does not own an
+// unescaped divider network.
+SdfReader::SdfReader(const SdfReader *reader) :
+  StaState(reader),
+  filename_(reader->filename_),
+  path_(reader->path_),
+  triple_min_index_(reader->triple_min_index_),
+  triple_max_index_(reader->triple_max_index_),
+  arc_delay_min_index_(reader->arc_delay_min_index_),
+  arc_delay_max_index_(reader->arc_delay_max_index_),
+  analysis_type_(reader->analysis_type_),
+  unescaped_dividers_(false),
+  is_incremental_only_(reader->is_incremental_only_),
+  cond_use_(reader->cond_use_),
+  line_(reader->line_),
+  input_(nullptr),
+  divider_(reader->divider_),
+  escape_(reader->escape_),
+  instance_(nullptr),
+  cell_name_(nullptr),
+  in_timing_check_(false),
+  in_incremental_(false),
+  timescale_(reader->timescale_),
+  parallel_(false),
+  annotate_lock_(reader->annotate_lock_)
+{
+}
+
 SdfReader::~SdfReader()
 {
   if (unescaped_dividers_)
@@ -163,16 +197,15 @@ SdfReader::~SdfReader()
 bool
 SdfReader::read()
 {
-  // Use zlib to uncompress gzip'd files automagically.
-  stream_ = gzopen(filename_, "rb");
-  if (stream_) {
-    // yyparse returns 0 on success.
-    bool success = (::SdfParse_parse() == 0);
-    gzclose(stream_);
-    return success;
-  }
-  else
-    throw FileNotReadable(filename_);
+  // Only read ahead when there is a spare thread to parse while the
+  // file is uncompressed.
+  ScanInput input(filename_, parallel_);
+  input_ = &input;
+  // yyparse returns 0 on success.
+  bool success = (::SdfParse_parse() == 0);
+  input_ = nullptr;
+  annotateDeferred();
+  return success;
 }
 
 void
@@ -203,9 +236,9 @@ SdfReader::setTimescale(float multiplier,
 }
 
 void
-SdfReader::interconnect(const char *from_pin_name,
-			const char *to_pin_name,
-			SdfTripleSeq *triples)
+SdfReader::annotateInterconnect(const char *from_pin_name,
+				const char *to_pin_name,
+				SdfTripleSeq *triples)
 {
   // Ignore non-incremental annotations in incremental only mode.
   if (!(is_incremental_only_ && !in_incremental_)) {
@@ -243,8 +276,8 @@ SdfReader::interconnect(const char *from_pin_name,
 }
 
 void
-SdfReader::port(const char *to_pin_name,
-		SdfTripleSeq *triples)
+SdfReader::annotatePort(const char *to_pin_name,
+			SdfTripleSeq *triples)
 {
   // Ignore non-incremental annotations in incremental only mode.
   if (!(is_incremental_only_ && !in_incremental_)) {
@@ -358,6 +391,65 @@ SdfReader::cellFinish()
   stringDelete(cell_name_);
   cell_name_ = nullptr;
   instance_ = nullptr;
+  if (deferred_.size() >= deferred_batch_size_)
+    annotateDeferred();
+}
+
+////////////////////////////////////////////////////////////////
+
+void
+SdfReader::annotate(const SdfAnnotation &annotation)
+{
+  if (parallel_)
+    deferred_.push_back(SdfDeferredAnnotation(line_, instance_,
+					      in_incremental_, annotation));
+  else
+    annotation(this);
+}
+
+// Annotations for different pins touch disjoint edges, so the pin and
+// edge searches for a batch of commands run on multiple threads.
+void
+SdfReader::annotateDeferred()
+{
+  if (!deferred_.empty()) {
+    std::vector<SdfReader*> workers;
+    for (int i = 0; i < thread_pool_->threadCount(); i++)
+      workers.push_back(new SdfReader(this));
+    forEachChunk(deferred_.size(), thread_pool_,
+		 [&] (size_t begin, size_t end, int thread_index) {
+		   SdfReader *worker = workers[thread_index];
+		   for (size_t i = begin; i < end; i++) {
+		     SdfDeferredAnnotation &deferred = deferred_[i];
+		     worker->line_ = deferred.line_;
+		     worker->instance_ = deferred.instance_;
+		     worker->in_incremental_ = deferred.in_incremental_;
+		     deferred.annotation_(worker);
+		   }
+		 });
+    for (SdfReader *worker : workers)
+      delete worker;
+    deferred_.clear();
+  }
+}
+
+void
+SdfReader::interconnect(const char *from_pin_name,
+			const char *to_pin_name,
+			SdfTripleSeq *triples)
+{
+  annotate([=] (SdfReader *reader) {
+      reader->annotateInterconnect(from_pin_name, to_pin_name, triples);
+    });
+}
+
+void
+SdfReader::port(const char *to_pin_name,
+		SdfTripleSeq *triples)
+{
+  annotate([=] (SdfReader *reader) {
+      reader->annotatePort(to_pin_name, triples);
+    });
 }
 
 void
@@ -366,6 +458,90 @@ SdfReader::iopath(SdfPortSpec *from_edge,
 		  SdfTripleSeq *triples,
 		  const char *cond,
 		  bool condelse)
+{
+  annotate([=] (SdfReader *reader) {
+      reader->annotateIopath(from_edge, to_port_name, triples, cond, condelse);
+    });
+}
+
+void
+SdfReader::timingCheck(TimingRole *role,
+		       SdfPortSpec *data_edge,
+		       SdfPortSpec *clk_edge,
+		       SdfTriple *triple)
+{
+  annotate([=] (SdfReader *reader) {
+      reader->annotateTimingCheck(role, data_edge, clk_edge, triple);
+    });
+}
+
+void
+SdfReader::timingCheckWidth(SdfPortSpec *edge,
+			    SdfTriple *triple)
+{
+  annotate([=] (SdfReader *reader) {
+      reader->annotateTimingCheckWidth(edge, triple);
+    });
+}
+
+void
+SdfReader::timingCheckPeriod(SdfPortSpec *edge,
+			     SdfTriple *triple)
+{
+  annotate([=] (SdfReader *reader) {
+      reader->annotateTimingCheckPeriod(edge, triple);
+    });
+}
+
+void
+SdfReader::timingCheckSetupHold(SdfPortSpec *data_edge,
+				SdfPortSpec *clk_edge,
+				SdfTriple *setup_triple,
+				SdfTriple *hold_triple)
+{
+  annotate([=] (SdfReader *reader) {
+      reader->annotateTimingCheckSetupHold(data_edge, clk_edge,
+					   setup_triple, hold_triple);
+    });
+}
+
+void
+SdfReader::timingCheckRecRem(SdfPortSpec *data_edge,
+			     SdfPortSpec *clk_edge,
+			     SdfTriple *rec_triple,
+			     SdfTriple *rem_triple)
+{
+  annotate([=] (SdfReader *reader) {
+      reader->annotateTimingCheckRecRem(data_edge, clk_edge,
+					rec_triple, rem_triple);
+    });
+}
+
+void
+SdfReader::device(SdfTripleSeq *triples)
+{
+  annotate([=] (SdfReader *reader) {
+      reader->annotateDevice(triples);
+    });
+}
+
+void
+SdfReader::device(const char *to_port_name,
+		  SdfTripleSeq *triples)
+{
+  annotate([=] (SdfReader *reader) {
+      reader->annotateDevice(to_port_name, triples);
+    });
+}
+
+////////////////////////////////////////////////////////////////
+
+void
+SdfReader::annotateIopath(SdfPortSpec *from_edge,
+			  const char *to_port_name,
+			  SdfTripleSeq *triples,
+			  const char *cond,
+			  bool condelse)
 {
   if (instance_) {
     const char *from_port_name = from_edge->port();
@@ -442,8 +618,8 @@ SdfReader::iopath(SdfPortSpec *from_edge,
 }
 
 void
-SdfReader::timingCheck(TimingRole *role, SdfPortSpec *data_edge,
-		       SdfPortSpec *clk_edge, SdfTriple *triple)
+SdfReader::annotateTimingCheck(TimingRole *role, SdfPortSpec *data_edge,
+			       SdfPortSpec *clk_edge, SdfTriple *triple)
 {
   timingCheck1(role, data_edge, clk_edge, triple, true);
   deletePortSpec(data_edge);
@@ -567,8 +743,8 @@ SdfReader::annotateCheckEdges(Pin *data_pin,
 }
 
 void
-SdfReader::timingCheckWidth(SdfPortSpec *edge,
-			    SdfTriple *triple)
+SdfReader::annotateTimingCheckWidth(SdfPortSpec *edge,
+				    SdfTriple *triple)
 {
   // Ignore non-incremental annotations in incremental only mode.
   if (!(is_incremental_only_ && !in_incremental_)
@@ -584,6 +760,7 @@ SdfReader::timingCheckWidth(SdfPortSpec *edge,
 	const TransRiseFall *tr = edge->transition()->asRiseFall();
 	float **values = triple->values();
 	float *value_ptr = values[triple_min_index_];
+	std::lock_guard<std::mutex> lock(annotate_lock_);
 	if (value_ptr) {
 	  float value = *value_ptr;
 	  graph_->setWidthCheckAnnotation(pin, tr, arc_delay_min_index_,
@@ -605,8 +782,8 @@ SdfReader::timingCheckWidth(SdfPortSpec *edge,
 }
 
 void
-SdfReader::timingCheckPeriod(SdfPortSpec *edge,
-			     SdfTriple *triple)
+SdfReader::annotateTimingCheckPeriod(SdfPortSpec *edge,
+				     SdfTriple *triple)
 {
   // Ignore non-incremental annotations in incremental only mode.
   if (!(is_incremental_only_ && !in_incremental_)
@@ -622,6 +799,7 @@ SdfReader::timingCheckPeriod(SdfPortSpec *edge,
       if (pin) {
 	float **values = triple->values();
 	float *value_ptr = values[triple_min_index_];
+	std::lock_guard<std::mutex> lock(annotate_lock_);
 	if (value_ptr) {
 	  float value = *value_ptr;
 	  graph_->setPeriodCheckAnnotation(pin, arc_delay_min_index_, value);
@@ -641,10 +819,10 @@ SdfReader::timingCheckPeriod(SdfPortSpec *edge,
 }
 
 void
-SdfReader::timingCheckSetupHold(SdfPortSpec *data_edge,
-				SdfPortSpec *clk_edge,
-				SdfTriple *setup_triple,
-				SdfTriple *hold_triple)
+SdfReader::annotateTimingCheckSetupHold(SdfPortSpec *data_edge,
+					SdfPortSpec *clk_edge,
+					SdfTriple *setup_triple,
+					SdfTriple *hold_triple)
 {
   timingCheck1(TimingRole::setup(), data_edge, clk_edge, setup_triple, true);
   timingCheck1(TimingRole::hold(), data_edge, clk_edge, hold_triple, false);
@@ -655,10 +833,10 @@ SdfReader::timingCheckSetupHold(SdfPortSpec *data_edge,
 }
 
 void
-SdfReader::timingCheckRecRem(SdfPortSpec *data_edge,
-			     SdfPortSpec *clk_edge,
-			     SdfTriple *rec_triple,
-			     SdfTriple *rem_triple)
+SdfReader::annotateTimingCheckRecRem(SdfPortSpec *data_edge,
+				     SdfPortSpec *clk_edge,
+				     SdfTriple *rec_triple,
+				     SdfTriple *rem_triple)
 {
   timingCheck1(TimingRole::recovery(), data_edge, clk_edge, rec_triple, true);
   timingCheck1(TimingRole::removal(), data_edge, clk_edge, rem_triple, false);
@@ -682,7 +860,7 @@ SdfReader::timingCheckNochange(SdfPortSpec *data_edge,
 }
 
 void
-SdfReader::device(SdfTripleSeq *triples)
+SdfReader::annotateDevice(SdfTripleSeq *triples)
 {
   // Ignore non-incremental annotations in incremental only mode.
   if (!(is_incremental_only_ && !in_incremental_)
@@ -698,8 +876,8 @@ SdfReader::device(SdfTripleSeq *triples)
 }
 
 void
-SdfReader::device(const char *to_port_name,
-		  SdfTripleSeq *triples)
+SdfReader::annotateDevice(const char *to_port_name,
+			  SdfTripleSeq *triples)
 {
   // Ignore non-incremental annotations in incremental only mode.
   if (!(is_incremental_only_ && !in_incremental_)
@@ -750,6 +928,7 @@ SdfReader::setEdgeArcDelays(Edge *edge,
     float **values = triple->values();
     float *value_ptr = values[triple_index];
     if (value_ptr) {
+      std::lock_guard<std::mutex> lock(annotate_lock_);
       ArcDelay delay;
       if (in_incremental_)
 	delay = *value_ptr + graph_->arcDelay(edge, arc, arc_delay_index);
@@ -803,6 +982,7 @@ SdfReader::setEdgeArcDelaysCondUse(Edge *edge,
 {
   if (value
       && triple_index != null_index_) {
+    std::lock_guard<std::mutex> lock(annotate_lock_);
     ArcDelay delay(*value);
     if (!is_incremental_only_ && in_incremental_)
       delay = graph_->arcDelay(edge, arc, arc_delay_index) + *value;
@@ -998,11 +1178,7 @@ SdfReader::getChars(char *buf,
 		    size_t &result,
 		    size_t max_size)
 {
-  char *status = gzgets(stream_, buf, max_size);
-  if (status == Z_NULL)
-    result = 0;  // YY_nullptr
-  else
-    result = strlen(buf);
+  result = input_->read(buf, max_size);
 }
 
 void
@@ -1010,11 +1186,7 @@ SdfReader::getChars(char *buf,
 		    int &result,
 		    size_t max_size)
 {
-  char *status = gzgets(stream_, buf, max_size);
-  if (status == Z_NULL)
-    result = 0;  // YY_nullptr
-  else
-    result = strlen(buf);
+  result = static_cast<int>(input_->read(buf, max_size));
 }
 
 void
@@ -1034,6 +1206,7 @@ SdfReader::portNotFound(const char *port_name)
 void
 SdfReader::sdfError(const char *fmt, ...)
 {
+  std::lock_guard<std::mutex> lock(annotate_lock_);
   va_list args;
   va_start(args, fmt);
   report_->vfileError(filename_, line_, fmt, args);
@@ -16,8 +16,15 @@
 
 #include <stdio.h>
 #include <time.h>
+#include <unistd.h>  // dup
+#include <algorithm>
+#include <vector>
 #include "Machine.hh"
 #include "Zlib.hh"
+#include "Error.hh"
+#include "Report.hh"
+#include "ThreadPool.hh"
+#include "ThreadForEach.hh"
 #include "StaConfig.hh"  // STA_VERSION
 #include "Fuzzy.hh"
 #include "StringUtil.hh"
@@ -52,15 +59,32 @@ public:
 	     bool no_version);
 
 protected:
+  // Section writer with the settings of writer.
+  SdfWriter(const SdfWriter *writer,
+	    gzFile stream);
+  void writeParallel(FILE *stream,
+		     bool gzip,
+		     LibertyLibrary *default_lib,
+		     bool no_timestamp,
+		     bool no_version);
+  void writeSection(size_t section,
+		    const InstanceSeq &insts,
+		    size_t block_count,
+		    LibertyLibrary *default_lib,
+		    bool no_timestamp,
+		    bool no_version);
   void writeHeader(LibertyLibrary *default_lib,
 		   bool no_timestamp,
 		   bool no_version);
   void writeTrailer();
   void writeInterconnects();
+  void writeInterconnectHeader();
+  void writeInterconnectTrailer();
   void writeInstInterconnects(Instance *inst);
   void writeInterconnectFromPin(Pin *drvr_pin);
 
   void writeInstances();
+  void writeInstance(const Instance *inst);
   void writeInstHeader(const Instance *inst);
   void writeInstTrailer();
   void writeIopaths(const Instance *inst,
@@ -142,6 +166,21 @@ SdfWriter::SdfWriter(StaState *sta) :
 {
 }
 
+SdfWriter::SdfWriter(const SdfWriter *writer,
+		     gzFile stream) :
+  StaState(writer),
+  sdf_divider_(writer->sdf_divider_),
+  timescale_(writer->timescale_),
+  sdf_escape_(writer->sdf_escape_),
+  network_escape_(writer->network_escape_),
+  delay_format_(stringCopy(writer->delay_format_)),
+  stream_(stream),
+  corner_(writer->corner_),
+  arc_delay_min_index_(writer->arc_delay_min_index_),
+  arc_delay_max_index_(writer->arc_delay_max_index_)
+{
+}
+
 SdfWriter::~SdfWriter()
 {
   stringDelete(delay_format_);
@@ -174,15 +213,125 @@ SdfWriter::write(const char *filename,
   dcalc_ap = corner_->findDcalcAnalysisPt(min_max);
   arc_delay_max_index_ = dcalc_ap->index();
 
-  stream_ = gzopen(filename, gzip ? "wb" : "wT");
+  if (thread_pool_ && thread_pool_->threadCount() > 1) {
+    FILE *stream = fopen(filename, "wb");
+    if (stream == nullptr)
+      throw FileNotWritable(filename);
+    writeParallel(stream, gzip, default_lib, no_timestamp, no_version);
+    fclose(stream);
+  }
+  else {
+    stream_ = gzopen(filename, gzip ? "wb" : "wT");
+    if (stream_ == Z_NULL)
+      throw FileNotWritable(filename);
+
+    writeHeader(default_lib, no_timestamp, no_version);
+    writeInterconnects();
+    writeInstances();
+    writeTrailer();
+
+    gzclose(stream_);
+    stream_ = nullptr;
+  }
+}
+
+// The file is split into sections that are formatted (and compressed)
+// on multiple threads by section writers into temporary files that are
+// then copied to the sdf file in order.  The instance interconnects and
+// cells are split into blocks of leaf instances.  A gzip file can be
+// a sequence of compressed members, so the compressed sections are
+// simply concatenated.
+void
+SdfWriter::writeParallel(FILE *stream,
+			 bool gzip,
+			 LibertyLibrary *default_lib,
+			 bool no_timestamp,
+			 bool no_version)
+{
+  InstanceSeq insts;
+  LeafInstanceIterator *leaf_iter = network_->leafInstanceIterator();
+  while (leaf_iter->hasNext())
+    insts.push_back(leaf_iter->next());
+  delete leaf_iter;
 
-  writeHeader(default_lib, no_timestamp, no_version);
-  writeInterconnects();
-  writeInstances();
-  writeTrailer();
+  size_t block_count = thread_pool_->threadCount() * 4;
+  if (block_count > insts.size())
+    block_count = insts.size();
+  // header, interconnect blocks, interconnect trailer,
+  // instance blocks, trailer
+  size_t section_count = block_count * 2 + 3;
+  std::vector<FILE*> streams(section_count, nullptr);
+  const char *mode = gzip ? "wb" : "wT";
+  forEachChunk(section_count, thread_pool_,
+	       [&] (size_t begin, size_t end, int) {
+		 for (size_t i = begin; i < end; i++) {
+		   FILE *tmp = tmpfile();
+		   if (tmp) {
+		     gzFile gz_stream = gzdopen(dup(fileno(tmp)), mode);
+		     if (gz_stream == Z_NULL)
+		       fclose(tmp);
+		     else {
+		       SdfWriter writer(this, gz_stream);
+		       writer.writeSection(i, insts, block_count, default_lib,
+					   no_timestamp, no_version);
+		       gzclose(gz_stream);
+		       streams[i] = tmp;
+		     }
+		   }
+		 }
+	       });
+
+  bool streams_missing = false;
+  const size_t buffer_size = 1 << 16;
+  std::vector<char> buffer(buffer_size);
+  for (FILE *tmp : streams) {
+    if (tmp) {
+      rewind(tmp);
+      size_t length;
+      while ((length = fread(buffer.data(), 1, buffer_size, tmp)) > 0)
+	fwrite(buffer.data(), 1, length, stream);
+      fclose(tmp);
+    }
+    else
+      streams_missing = true;
+  }
+  if (streams_missing)
+    report_->error("could not make temporary files to write sdf.\n");
+}
 
-  gzclose(stream_);
-  stream_ = nullptr;
+void
+SdfWriter::writeSection(size_t section,
+			const InstanceSeq &insts,
+			size_t block_count,
+			LibertyLibrary *default_lib,
+			bool no_timestamp,
+			bool no_version)
+{
+  size_t inst_count = insts.size();
+  size_t block_size = block_count
+    ? (inst_count + block_count - 1) / block_count
+    : 0;
+  if (section == 0) {
+    writeHeader(default_lib, no_timestamp, no_version);
+    writeInterconnectHeader();
+    writeInstInterconnects(network_->topInstance());
+  }
+  else if (section <= block_count) {
+    size_t begin = (section - 1) * block_size;
+    size_t end = std::min(begin + block_size, inst_count);
+    for (size_t i = begin; i < end; i++)
+      writeInstInterconnects(insts[i]);
+  }
+  else if (section == block_count + 1)
+    writeInterconnectTrailer();
+  else if (section <= block_count * 2 + 1) {
+    size_t begin = (section - block_count - 2) * block_size;
+    size_t end = std::min(begin + block_size, inst_count);
+    for (size_t i = begin; i < end; i++)
+      writeInstance(insts[i]);
+  }
+  else
+    writeTrailer();
 }
 
 void
@@ -262,13 +411,7 @@ SdfWriter::writeTrailer()
 void
 SdfWriter::writeInterconnects()
 {
-  gzprintf(stream_, " (CELL\n");
-  gzprintf(stream_, "  (CELLTYPE \"%s\")\n",
-	   network_->cellName(network_->topInstance()));
-  gzprintf(stream_, "  (INSTANCE)\n");
-  gzprintf(stream_, "  (DELAY\n");
-  gzprintf(stream_, "   (ABSOLUTE\n");
-
+  writeInterconnectHeader();
   writeInstInterconnects(network_->topInstance());
 
   LeafInstanceIterator *inst_iter = network_->leafInstanceIterator();
@@ -278,6 +421,23 @@ SdfWriter::writeInterconnects()
   }
   delete inst_iter;
 
+  writeInterconnectTrailer();
+}
+
+void
+SdfWriter::writeInterconnectHeader()
+{
+  gzprintf(stream_, " (CELL\n");
+  gzprintf(stream_, "  (CELLTYPE \"%s\")\n",
+	   network_->cellName(network_->topInstance()));
+  gzprintf(stream_, "  (INSTANCE)\n");
+  gzprintf(stream_, "  (DELAY\n");
+  gzprintf(stream_, "   (ABSOLUTE\n");
+}
+
+void
+SdfWriter::writeInterconnectTrailer()
+{
   gzprintf(stream_, "   )\n");
   gzprintf(stream_, "  )\n");
   gzprintf(stream_, " )\n");
@@ -319,15 +479,21 @@ SdfWriter::writeInstances()
   LeafInstanceIterator *leaf_iter = network_->leafInstanceIterator();
   while (leaf_iter->hasNext()) {
     const Instance *inst = leaf_iter->next();
-    bool inst_header = false;
-    writeIopaths(inst, inst_header);
-    writeTimingChecks(inst, inst_header);
-    if (inst_header)
-      writeInstTrailer();
+    writeInstance(inst);
   }
   delete leaf_iter;
 }
 
+void
+SdfWriter::writeInstance(const Instance *inst)
+{
+  bool inst_header = false;
+  writeIopaths(inst, inst_header);
+  writeTimingChecks(inst, inst_header);
+  if (inst_header)
+    writeInstTrailer();
+}
+
 void
 SdfWriter::writeInstHeader(const Instance *inst)
 {
@@ -0,0 +1,947 @@
+// OpenSTA, Static Timing Analyzer
+// Copyright (c) 2019, Parallax Software, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#include <ctype.h>
+#include <stdarg.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include "Machine.hh"
+#include "DisallowCopyAssign.hh"
+#include "Zlib.hh"
+#include "Report.hh"
+#include "Error.hh"
+#include "StringUtil.hh"
+#include "Network.hh"
+#include "Clock.hh"
+#include "Sdc.hh"
+#include "Power.hh"
+#include "ActivityReader.hh"
+
+namespace sta {
+
+using std::string;
+
+// Tokens separated by white space read from a file a block at a time.
+// If paren_tokens is true parens are tokens and double quoted strings
+// are read as one token without the quotes (SAIF).
+class ActivityTokenizer
+{
+public:
+  ActivityTokenizer(const char *filename,
+		    bool paren_tokens);
+  ~ActivityTokenizer();
+  // Return false at the end of the file.
+  bool next(string &token);
+  int line() const { return line_; }
+
+private:
+  DISALLOW_COPY_AND_ASSIGN(ActivityTokenizer);
+  int getChar();
+
+  gzFile stream_;
+  std::vector<char> buffer_;
+  size_t buffer_length_;
+  size_t buffer_pos_;
+  // Character read past the end of a token.
+  int peek_;
+  bool paren_tokens_;
+  int line_;
+
+  static const size_t block_size_ = 1 << 16;
+};
+
+ActivityTokenizer::ActivityTokenizer(const char *filename,
+				     bool paren_tokens) :
+  buffer_(block_size_),
+  buffer_length_(0),
+  buffer_pos_(0),
+  peek_(EOF),
+  paren_tokens_(paren_tokens),
+  line_(1)
+{
+  stream_ = gzopen(filename, "rb");
+  if (stream_ == Z_NULL)
+    throw FileNotReadable(filename);
+}
+
+ActivityTokenizer::~ActivityTokenizer()
+{
+  gzclose(stream_);
+}
+
+int
+ActivityTokenizer::getChar()
+{
+  if (peek_ != EOF) {
+    int ch = peek_;
+    peek_ = EOF;
+    return ch;
+  }
+  if (buffer_pos_ == buffer_length_) {
+    int length = gzread(stream_, &buffer_[0], block_size_);
+    if (length <= 0)
+      return EOF;
+    buffer_length_ = length;
+    buffer_pos_ = 0;
+  }
+  return static_cast<unsigned char>(buffer_[buffer_pos_++]);
+}
+
+bool
+ActivityTokenizer::next(string &token)
+{
+  token.clear();
+  int ch = getChar();
+  while (ch != EOF && isspace(ch)) {
+    if (ch == '\n')
+      line_++;
+    ch = getChar();
+  }
+  if (ch == EOF)
+    return false;
+  if (paren_tokens_) {
+    if (ch == '(' || ch == ')') {
+      token.push_back(ch);
+      return true;
+    }
+    if (ch == '"') {
+      ch = getChar();
+      while (ch != EOF && ch != '"') {
+	if (ch == '\n')
+	  line_++;
+	token.push_back(ch);
+	ch = getChar();
+      }
+      return true;
+    }
+  }
+  while (ch != EOF && !isspace(ch)) {
+    if (paren_tokens_ && (ch == '(' || ch == ')')) {
+      peek_ = ch;
+      break;
+    }
+    token.push_back(ch);
+    // Escaped characters (SAIF) are part of the token.
+    if (paren_tokens_ && ch == '\\') {
+      ch = getChar();
+      if (ch == EOF)
+	break;
+      token.push_back(ch);
+    }
+    ch = getChar();
+  }
+  if (ch == '\n')
+    line_++;
+  return true;
+}
+
+////////////////////////////////////////////////////////////////
+
+// Scope tracking and pin annotation shared by the VCD and SAIF readers.
+class ActivityReader : public StaState
+{
+protected:
+  ActivityReader(const char *filename,
+		 const char *scope,
+		 bool paren_tokens,
+		 Power *power);
+  bool findClkPeriod();
+  // Return the design instance for the scope, or nullptr if the
+  // scope is outside the design.
+  Instance *pushScope(const string &name);
+  void popScope();
+  Instance *scopeInstance() const;
+  void findPins(const Instance *inst,
+		const char *name,
+		// Return value.
+		PinSeq &pins);
+  void annotate(PinSeq &pins,
+		double toggles,
+		double high_time,
+		double duration);
+  bool parseTimeScale(const string &timescale,
+		      // Return value.
+		      double &scale);
+  void reportNotFound(const char *kind);
+  void error(const char *fmt, ...)
+    __attribute__((format (printf, 2, 3)));
+
+  const char *filename_;
+  ActivityTokenizer tokenizer_;
+  Power *power_;
+  // Scope names down to and including the design top.
+  std::vector<string> scope_;
+  std::vector<string> scope_stack_;
+  // True if scope_stack_ matches scope_ so far.
+  std::vector<bool> scope_match_stack_;
+  std::vector<Instance*> inst_stack_;
+  float clk_period_;
+  int not_found_count_;
+};
+
+ActivityReader::ActivityReader(const char *filename,
+			       const char *scope,
+			       bool paren_tokens,
+			       Power *power) :
+  StaState(power),
+  filename_(filename),
+  tokenizer_(filename, paren_tokens),
+  power_(power),
+  clk_period_(0.0),
+  not_found_count_(0)
+{
+  if (scope) {
+    string name;
+    for (const char *s = scope; *s; s++) {
+      if (*s == '/') {
+	if (!name.empty())
+	  scope_.push_back(name);
+	name.clear();
+      }
+      else
+	name.push_back(*s);
+    }
+    if (!name.empty())
+      scope_.push_back(name);
+  }
+}
+
+// Activities are toggles per clock cycle so the toggle rates are
+// scaled by the fastest clock period.
+bool
+ActivityReader::findClkPeriod()
+{
+  clk_period_ = 0.0;
+  for (Clock *clk : sdc_->clks()) {
+    float period = clk->period();
+    if (period > 0.0
+	&& (clk_period_ == 0.0 || period < clk_period_))
+      clk_period_ = period;
+  }
+  if (clk_period_ == 0.0) {
+    report_->warn("no clocks defined to find activities in %s.\n",
+		  filename_);
+    return false;
+  }
+  return true;
+}
+
+Instance *
+ActivityReader::pushScope(const string &name)
+{
+  size_t depth = scope_stack_.size();
+  size_t top_depth = scope_.empty() ? 0 : scope_.size() - 1;
+  Instance *inst = nullptr;
+  bool match = false;
+  if (depth <= top_depth) {
+    match = (depth == 0 || scope_match_stack_.back())
+      && (scope_.empty() || name == scope_[depth]);
+    if (match && depth == top_depth)
+      inst = network_->topInstance();
+  }
+  else {
+    Instance *parent = inst_stack_.back();
+    if (parent)
+      inst = network_->findChild(parent, name.c_str());
+  }
+  scope_stack_.push_back(name);
+  scope_match_stack_.push_back(match);
+  inst_stack_.push_back(inst);
+  return inst;
+}
+
+void
+ActivityReader::popScope()
+{
+  if (!scope_stack_.empty()) {
+    scope_stack_.pop_back();
+    scope_match_stack_.pop_back();
+    inst_stack_.pop_back();
+  }
+}
+
+Instance *
+ActivityReader::scopeInstance() const
+{
+  return inst_stack_.empty() ? nullptr : inst_stack_.back();
+}
+
+// Nets are annotated on their drivers because load activities are
+// propagated from the drivers. Names that are not nets are instance
+// pins.
+void
+ActivityReader::findPins(const Instance *inst,
+			 const char *name,
+			 // Return value.
+			 PinSeq &pins)
+{
+  pins.clear();
+  Net *net = network_->findNet(inst, name);
+  if (net) {
+    PinSet *drvrs = network_->drivers(net);
+    if (drvrs) {
+      PinSet::Iterator drvr_iter(drvrs);
+      while (drvr_iter.hasNext())
+	pins.push_back(drvr_iter.next());
+    }
+  }
+  else {
+    Pin *pin = network_->findPin(inst, name);
+    if (pin)
+      pins.push_back(pin);
+  }
+  if (pins.empty())
+    not_found_count_++;
+}
+
+void
+ActivityReader::annotate(PinSeq &pins,
+			 double toggles,
+			 double high_time,
+			 double duration)
+{
+  if (duration > 0.0) {
+    // duration is in seconds.
+    float activity = toggles * clk_period_ / duration;
+    float duty = high_time / duration;
+    for (Pin *pin : pins)
+      power_->setPinActivity(pin, activity, duty, PwrActivityOrigin::user);
+  }
+}
+
+// Time scales are a number followed by a unit, as in "1ps" or "10 ns".
+bool
+ActivityReader::parseTimeScale(const string &timescale,
+			       // Return value.
+			       double &scale)
+{
+  const char *str = timescale.c_str();
+  char *unit;
+  double value = strtod(str, &unit);
+  if (unit == str)
+    value = 1.0;
+  while (isspace(*unit))
+    unit++;
+  double unit_scale;
+  if (stringEq(unit, "s"))
+    unit_scale = 1.0;
+  else if (stringEq(unit, "ms"))
+    unit_scale = 1e-3;
+  else if (stringEq(unit, "us"))
+    unit_scale = 1e-6;
+  else if (stringEq(unit, "ns"))
+    unit_scale = 1e-9;
+  else if (stringEq(unit, "ps"))
+    unit_scale = 1e-12;
+  else if (stringEq(unit, "fs"))
+    unit_scale = 1e-15;
+  else {
+    error("unknown time scale %s.\n", str);
+    return false;
+  }
+  scale = value * unit_scale;
+  return true;
+}
+
+void
+ActivityReader::reportNotFound(const char *kind)
+{
+  if (not_found_count_ > 0)
+    report_->warn("%d %s in %s not found.\n",
+		  not_found_count_, kind, filename_);
+}
+
+void
+ActivityReader::error(const char *fmt, ...)
+{
+  va_list args;
+  va_start(args, fmt);
+  report_->vfileError(filename_, tokenizer_.line(), fmt, args);
+  va_end(args);
+}
+
+////////////////////////////////////////////////////////////////
+
+// Value change dump reader.
+// Only signals in the design are recorded, one VcdBit per bit.
+class VcdReader : public ActivityReader
+{
+public:
+  VcdReader(const char *filename,
+	    const char *scope,
+	    Power *power);
+  bool read();
+
+private:
+  DISALLOW_COPY_AND_ASSIGN(VcdReader);
+  bool readHeader();
+  bool readTimeScale();
+  bool readVar();
+  bool skipSection();
+  bool readValueChanges();
+  void setVarValue(const string &id,
+		   const char *value);
+  void setBitValue(size_t bit_index,
+		   char value);
+  void annotateBits();
+
+  struct VcdBit
+  {
+    char value;
+    uint64_t last_time;
+    uint64_t high_time;
+    uint64_t toggles;
+    PinSeq pins;
+  };
+
+  // Bit indices of a var from msb (leftmost value character) to lsb.
+  typedef std::vector<size_t> VcdVarBits;
+
+  double time_scale_;
+  uint64_t time_;
+  uint64_t time_min_;
+  bool have_time_;
+  std::vector<VcdBit> bits_;
+  // Vars with the same id code share bits.
+  std::unordered_map<string, VcdVarBits> id_bits_;
+};
+
+bool
+readVcdActivities(const char *filename,
+		  const char *scope,
+		  Power *power)
+{
+  VcdReader reader(filename, scope, power);
+  return reader.read();
+}
+
+VcdReader::VcdReader(const char *filename,
+		     const char *scope,
+		     Power *power) :
+  ActivityReader(filename, scope, false, power),
+  time_scale_(1.0),
+  time_(0),
+  time_min_(0),
+  have_time_(false)
+{
+}
+
+bool
+VcdReader::read()
+{
+  if (!findClkPeriod())
+    return false;
+  if (readHeader()
+      && readValueChanges()) {
+    annotateBits();
+    reportNotFound("vcd signals");
+    return true;
+  }
+  return false;
+}
+
+bool
+VcdReader::readHeader()
+{
+  string token;
+  while (tokenizer_.next(token)) {
+    if (token == "$enddefinitions")
+      return skipSection();
+    else if (token == "$timescale") {
+      if (!readTimeScale())
+	return false;
+    }
+    else if (token == "$scope") {
+      string type, name;
+      if (!(tokenizer_.next(type)
+	    && tokenizer_.next(name)))
+	break;
+      pushScope(name);
+      if (!skipSection())
+	return false;
+    }
+    else if (token == "$upscope") {
+      popScope();
+      if (!skipSection())
+	return false;
+    }
+    else if (token == "$var") {
+      if (!readVar())
+	return false;
+    }
+    else if (token[0] == '$') {
+      // $date, $version, $comment.
+      if (!skipSection())
+	return false;
+    }
+  }
+  error("unexpected end of file.\n");
+  return false;
+}
+
+// Read tokens through $end.
+bool
+VcdReader::skipSection()
+{
+  string token;
+  while (tokenizer_.next(token)) {
+    if (token == "$end")
+      return true;
+  }
+  error("unexpected end of file.\n");
+  return false;
+}
+
+bool
+VcdReader::readTimeScale()
+{
+  string timescale, token;
+  while (tokenizer_.next(token)) {
+    if (token == "$end")
+      return parseTimeScale(timescale, time_scale_);
+    timescale += token;
+  }
+  error("unexpected end of file.\n");
+  return false;
+}
+
+// $var type size id_code reference [range] $end
+bool
+VcdReader::readVar()
+{
+  string type, size_str, id, name, range, token;
+  if (!(tokenizer_.next(type)
+	&& tokenizer_.next(size_str)
+	&& tokenizer_.next(id)
+	&& tokenizer_.next(name)))
+    return skipSection();
+  while (tokenizer_.next(token)) {
+    if (token == "$end")
+      break;
+    range += token;
+  }
+  Instance *inst = scopeInstance();
+  if (inst == nullptr
+      || type == "real"
+      || type == "event"
+      || type == "parameter")
+    return true;
+
+  int width = atoi(size_str.c_str());
+  int msb = 0, lsb = 0;
+  bool is_bus = false;
+  if (!range.empty() && range[0] == '[') {
+    const char *colon = strchr(range.c_str(), ':');
+    if (colon) {
+      msb = atoi(range.c_str() + 1);
+      lsb = atoi(colon + 1);
+      is_bus = true;
+    }
+    else
+      // Bit select of a bus.
+      name += range;
+  }
+  if (!is_bus)
+    width = 1;
+  else if (width != abs(msb - lsb) + 1) {
+    error("$var %s range does not match size %d.\n",
+	  name.c_str(), width);
+    width = abs(msb - lsb) + 1;
+  }
+
+  VcdVarBits &var_bits = id_bits_[id];
+  bool alias = !var_bits.empty();
+  PinSeq pins;
+  for (int i = 0; i < width; i++) {
+    string bit_name = name;
+    if (is_bus) {
+      int index = (msb >= lsb) ? msb - i : msb + i;
+      stringPrint(bit_name, "%s[%d]", name.c_str(), index);
+    }
+    findPins(inst, bit_name.c_str(), pins);
+    if (!alias) {
+      var_bits.push_back(bits_.size());
+      bits_.push_back({'x', 0, 0, 0, PinSeq()});
+    }
+    if (static_cast<size_t>(i) < var_bits.size()) {
+      PinSeq &bit_pins = bits_[var_bits[i]].pins;
+      bit_pins.insert(bit_pins.end(), pins.begin(), pins.end());
+    }
+  }
+  return true;
+}
+
+bool
+VcdReader::readValueChanges()
+{
+  string token, id, value;
+  while (tokenizer_.next(token)) {
+    char ch = token[0];
+    switch (ch) {
+    case '#': {
+      uint64_t time = strtoull(token.c_str() + 1, nullptr, 10);
+      if (!have_time_) {
+	time_min_ = time;
+	for (VcdBit &bit : bits_)
+	  bit.last_time = time;
+	have_time_ = true;
+      }
+      time_ = time;
+      break;
+    }
+    case '0':
+    case '1':
+    case 'x':
+    case 'X':
+    case 'z':
+    case 'Z':
+      id = token.substr(1);
+      value = ch;
+      setVarValue(id, value.c_str());
+      break;
+    case 'b':
+    case 'B':
+      if (!tokenizer_.next(id)) {
+	error("unexpected end of file.\n");
+	return false;
+      }
+      setVarValue(id, token.c_str() + 1);
+      break;
+    case 'r':
+    case 'R':
+      // Real values are not activities.
+      if (!tokenizer_.next(id)) {
+	error("unexpected end of file.\n");
+	return false;
+      }
+      break;
+    case '$':
+      if (token == "$comment") {
+	if (!skipSection())
+	  return false;
+      }
+      // $dumpvars, $dumpall, $dumpon, $dumpoff and $end are
+      // transparent.
+      break;
+    default:
+      break;
+    }
+  }
+  return true;
+}
+
+// Values shorter than the var are extended on the left with 0, or x/z
+// if the leftmost value is x/z.
+void
+VcdReader::setVarValue(const string &id,
+		       const char *value)
+{
+  auto bits_iter = id_bits_.find(id);
+  if (bits_iter != id_bits_.end()) {
+    VcdVarBits &var_bits = bits_iter->second;
+    size_t width = var_bits.size();
+    size_t value_length = strlen(value);
+    char extend = tolower(value[0]);
+    if (extend == '1')
+      extend = '0';
+    for (size_t i = 0; i < width; i++) {
+      // Bits are numbered from the right (lsb) end of the value.
+      size_t from_right = width - 1 - i;
+      char bit_value = (from_right < value_length)
+	? value[value_length - 1 - from_right]
+	: extend;
+      setBitValue(var_bits[i], tolower(bit_value));
+    }
+  }
+}
+
+void
+VcdReader::setBitValue(size_t bit_index,
+		       char value)
+{
+  VcdBit &bit = bits_[bit_index];
+  if (bit.value == '1')
+    bit.high_time += time_ - bit.last_time;
+  if ((bit.value == '0' && value == '1')
+      || (bit.value == '1' && value == '0'))
+    bit.toggles++;
+  bit.value = value;
+  bit.last_time = time_;
+}
+
+void
+VcdReader::annotateBits()
+{
+  double duration = (time_ - time_min_) * time_scale_;
+  for (VcdBit &bit : bits_) {
+    if (bit.value == '1')
+      bit.high_time += time_ - bit.last_time;
+    if (!bit.pins.empty())
+      annotate(bit.pins, bit.toggles, bit.high_time * time_scale_, duration);
+  }
+}
+
+////////////////////////////////////////////////////////////////
+
+// Switching activity interchange format reader.
+class SaifReader : public ActivityReader
+{
+public:
+  SaifReader(const char *filename,
+	     const char *scope,
+	     Power *power);
+  bool read();
+
+private:
+  DISALLOW_COPY_AND_ASSIGN(SaifReader);
+  bool readGroup();
+  bool readGroups();
+  bool readTimeScale();
+  bool readDuration();
+  bool readInstance();
+  bool readSignals();
+  bool readSignal(const string &name);
+  bool skipGroup();
+  bool nextToken(string &token);
+  string unescape(const string &name);
+
+  double time_scale_;
+  double duration_;
+};
+
+bool
+readSaifActivities(const char *filename,
+		   const char *scope,
+		   Power *power)
+{
+  SaifReader reader(filename, scope, power);
+  return reader.read();
+}
+
+SaifReader::SaifReader(const char *filename,
+		       const char *scope,
+		       Power *power) :
+  ActivityReader(filename, scope, true, power),
+  time_scale_(1e-9),
+  duration_(0.0)
+{
+}
+
+bool
+SaifReader::read()
+{
+  if (!findClkPeriod())
+    return false;
+  string token;
+  while (tokenizer_.next(token)) {
+    if (token == "(") {
+      if (!readGroup())
+	return false;
+    }
+    else {
+      error("syntax error at %s.\n", token.c_str());
+      return false;
+    }
+  }
+  reportNotFound("saif signals");
+  return true;
+}
+
+bool
+SaifReader::nextToken(string &token)
+{
+  if (tokenizer_.next(token))
+    return true;
+  error("unexpected end of file.\n");
+  return false;
+}
+
+// Read a group after its open paren through the close paren.
+bool
+SaifReader::readGroup()
+{
+  string keyword;
+  if (!nextToken(keyword))
+    return false;
+  if (keyword == "SAIFILE")
+    return readGroups();
+  else if (keyword == "TIMESCALE")
+    return readTimeScale();
+  else if (keyword == "DURATION")
+    return readDuration();
+  else if (keyword == "INSTANCE")
+    return readInstance();
+  else if (keyword == "NET"
+	   || keyword == "PORT")
+    return readSignals();
+  else
+    return skipGroup();
+}
+
+// Read groups through the close paren.
+bool
+SaifReader::readGroups()
+{
+  string token;
+  while (nextToken(token)) {
+    if (token == ")")
+      return true;
+    else if (token == "(") {
+      if (!readGroup())
+	return false;
+    }
+  }
+  return false;
+}
+
+bool
+SaifReader::skipGroup()
+{
+  int depth = 1;
+  string token;
+  while (nextToken(token)) {
+    if (token == "(")
+      depth++;
+    else if (token == ")") {
+      depth--;
+      if (depth == 0)
+	return true;
+    }
+  }
+  return false;
+}
+
+bool
+SaifReader::readTimeScale()
+{
+  string timescale, token;
+  while (nextToken(token)) {
+    if (token == ")")
+      return parseTimeScale(timescale, time_scale_);
+    timescale += token;
+  }
+  return false;
+}
+
+bool
+SaifReader::readDuration()
+{
+  string token;
+  if (!nextToken(token))
+    return false;
+  duration_ = strtod(token.c_str(), nullptr);
+  return skipGroup();
+}
+
+// (INSTANCE [cell_name] instance_name groups...)
+bool
+SaifReader::readInstance()
+{
+  string name, token;
+  if (!(nextToken(name)
+	&& nextToken(token)))
+    return false;
+  if (token != "(" && token != ")") {
+    name = token;
+    if (!nextToken(token))
+      return false;
+  }
+  pushScope(unescape(name));
+  bool success = true;
+  while (token != ")") {
+    if (token == "(") {
+      if (!readGroup()) {
+	success = false;
+	break;
+      }
+    }
+    if (!nextToken(token)) {
+      success = false;
+      break;
+    }
+  }
+  popScope();
+  return success;
+}
+
+// (NET (name (T0 t) (T1 t) (TX t) (TC n) (IG n)) ...)
+bool
+SaifReader::readSignals()
+{
+  string token, name;
+  while (nextToken(token)) {
+    if (token == ")")
+      return true;
+    else if (token == "(") {
+      if (!(nextToken(name)
+	    && readSignal(name)))
+	return false;
+    }
+  }
+  return false;
+}
+
+bool
+SaifReader::readSignal(const string &name)
+{
+  double high_time = 0.0;
+  double toggles = 0.0;
+  string token, keyword, value;
+  while (nextToken(token)) {
+    if (token == ")") {
+      Instance *inst = scopeInstance();
+      if (inst) {
+	PinSeq pins;
+	findPins(inst, unescape(name).c_str(), pins);
+	annotate(pins, toggles, high_time * time_scale_,
+		 duration_ * time_scale_);
+      }
+      return true;
+    }
+    else if (token == "(") {
+      if (!(nextToken(keyword)
+	    && nextToken(value)))
+	return false;
+      if (keyword == "T1")
+	high_time = strtod(value.c_str(), nullptr);
+      else if (keyword == "TC")
+	toggles = strtod(value.c_str(), nullptr);
+      if (value != ")"
+	  && !skipGroup())
+	return false;
+    }
+  }
+  return false;
+}
+
+// Remove the escapes in names like "data\[3\]".
+string
+SaifReader::unescape(const string &name)
+{
+  string unescaped;
+  for (size_t i = 0; i < name.size(); i++) {
+    if (name[i] == '\\' && i + 1 < name.size())
+      i++;
+    unescaped.push_back(name[i]);
+  }
+  return unescaped;
+}
+
+} // namespace
@@ -0,0 +1,52 @@
+// OpenSTA, Static Timing Analyzer
+// Copyright (c) 2019, Parallax Software, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#ifndef STA_ACTIVITY_READER_H
+#define STA_ACTIVITY_READER_H
+
+namespace sta {
+
+class Power;
+
+// Annotate user pin activities from simulation switching activity
+// files. The files are read a block at a time (gzipped files are
+// supported) so memory use depends on the number of signals rather
+// than the file size.
+//
+// scope is the hierarchical path of the design top instance in the
+// file, using '/' between scope names, for example "testbench/dut".
+// Pass nullptr if the top level scope is the design top.
+//
+// Net activities are annotated on the net driver pins. Toggle counts
+// are converted to toggles per cycle of the fastest clock and high
+// times to duty cycles.
+
+// Throws FileNotReadable.
+// Return true if successful.
+bool
+readVcdActivities(const char *filename,
+		  const char *scope,
+		  Power *power);
+
+// Throws FileNotReadable.
+// Return true if successful.
+bool
+readSaifActivities(const char *filename,
+		   const char *scope,
+		   Power *power);
+
+} // namespace
+#endif
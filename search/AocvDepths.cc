@@ -0,0 +1,294 @@
+// OpenSTA, Static Timing Analyzer
+// Copyright (c) 2019, Parallax Software, Inc.
+// 
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+// 
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+// 
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#include "Machine.hh"
+#include "Debug.hh"
+#include "Stats.hh"
+#include "TimingRole.hh"
+#include "Graph.hh"
+#include "Levelize.hh"
+#include "SearchPred.hh"
+#include "VertexVisitor.hh"
+#include "Bfs.hh"
+#include "AocvDepths.hh"
+
+namespace sta {
+
+// Find a vertex depth from the depths of its fanin (or fanout) and
+// enqueue the vertices adjacent to it when the depth changes.
+class AocvDepthVisitor : public VertexVisitor
+{
+public:
+  AocvDepthVisitor(bool fanin,
+		   std::vector<int> &depths,
+		   BfsIterator *iter,
+		   SearchPred *pred,
+		   const StaState *sta);
+  virtual VertexVisitor *copy();
+  virtual void visit(Vertex *vertex);
+
+protected:
+  int findDepth(Vertex *vertex);
+  void edgeDepth(Edge *edge,
+		 Vertex *adj_vertex,
+		 bool &found,
+		 int &depth);
+
+  bool fanin_;
+  std::vector<int> &depths_;
+  BfsIterator *iter_;
+  SearchPred *pred_;
+  const StaState *sta_;
+
+private:
+  DISALLOW_COPY_AND_ASSIGN(AocvDepthVisitor);
+};
+
+AocvDepthVisitor::AocvDepthVisitor(bool fanin,
+				   std::vector<int> &depths,
+				   BfsIterator *iter,
+				   SearchPred *pred,
+				   const StaState *sta) :
+  VertexVisitor(),
+  fanin_(fanin),
+  depths_(depths),
+  iter_(iter),
+  pred_(pred),
+  sta_(sta)
+{
+}
+
+VertexVisitor *
+AocvDepthVisitor::copy()
+{
+  return new AocvDepthVisitor(fanin_, depths_, iter_, pred_, sta_);
+}
+
+void
+AocvDepthVisitor::visit(Vertex *vertex)
+{
+  const Graph *graph = sta_->graph();
+  int depth = findDepth(vertex);
+  // Adjacent vertices are at other levels so no other thread
+  // references this depth.
+  int &vertex_depth = depths_[graph->index(vertex)];
+  if (depth != vertex_depth) {
+    vertex_depth = depth;
+    iter_->enqueueAdjacentVertices(vertex, pred_);
+  }
+}
+
+int
+AocvDepthVisitor::findDepth(Vertex *vertex)
+{
+  int depth = 0;
+  // Register clock pins end clock path segments and start data path
+  // segments.
+  if (!vertex->isRegClk()) {
+    const Graph *graph = sta_->graph();
+    bool found = false;
+    if (fanin_) {
+      VertexInEdgeIterator edge_iter(vertex, graph);
+      while (edge_iter.hasNext()) {
+	Edge *edge = edge_iter.next();
+	Vertex *from_vertex = edge->from(graph);
+	if (pred_->searchFrom(from_vertex))
+	  edgeDepth(edge, from_vertex, found, depth);
+      }
+    }
+    else if (pred_->searchFrom(vertex)) {
+      VertexOutEdgeIterator edge_iter(vertex, graph);
+      while (edge_iter.hasNext()) {
+	Edge *edge = edge_iter.next();
+	Vertex *to_vertex = edge->to(graph);
+	if (pred_->searchTo(to_vertex))
+	  edgeDepth(edge, to_vertex, found, depth);
+      }
+    }
+  }
+  return depth;
+}
+
+void
+AocvDepthVisitor::edgeDepth(Edge *edge,
+			    Vertex *adj_vertex,
+			    bool &found,
+			    int &depth)
+{
+  if (pred_->searchThru(edge)) {
+    const Graph *graph = sta_->graph();
+    int edge_depth = depths_[graph->index(adj_vertex)];
+    if (!edge->role()->isWire())
+      edge_depth++;
+    if (!found || edge_depth < depth) {
+      depth = edge_depth;
+      found = true;
+    }
+  }
+}
+
+////////////////////////////////////////////////////////////////
+
+AocvDepths::AocvDepths(StaState *sta) :
+  StaState(sta),
+  depths_exist_(false),
+  search_pred_(new SearchPred2(sta)),
+  fanin_iter_(new BfsFwdIterator(BfsIndex::other, search_pred_, sta)),
+  fanout_iter_(new BfsBkwdIterator(BfsIndex::other, search_pred_, sta))
+{
+}
+
+AocvDepths::~AocvDepths()
+{
+  delete fanin_iter_;
+  delete fanout_iter_;
+  delete search_pred_;
+}
+
+void
+AocvDepths::copyState(const StaState *sta)
+{
+  StaState::copyState(sta);
+  fanin_iter_->copyState(sta);
+  fanout_iter_->copyState(sta);
+}
+
+void
+AocvDepths::clear()
+{
+  fanin_depths_.clear();
+  fanout_depths_.clear();
+  invalid_fanin_.clear();
+  invalid_fanout_.clear();
+  fanin_iter_->clear();
+  fanout_iter_->clear();
+  depths_exist_ = false;
+}
+
+void
+AocvDepths::depthsInvalid()
+{
+  depths_exist_ = false;
+  invalid_fanin_.clear();
+  invalid_fanout_.clear();
+}
+
+void
+AocvDepths::faninInvalid(Vertex *vertex)
+{
+  if (depths_exist_)
+    invalid_fanin_.insert(vertex, graph_);
+}
+
+void
+AocvDepths::fanoutInvalid(Vertex *vertex)
+{
+  if (depths_exist_)
+    invalid_fanout_.insert(vertex, graph_);
+}
+
+void
+AocvDepths::deleteVertexBefore(Vertex *vertex)
+{
+  invalid_fanin_.erase(vertex, graph_);
+  invalid_fanout_.erase(vertex, graph_);
+}
+
+int
+AocvDepths::cellDepth(Edge *edge) const
+{
+  VertexIndex from_index = graph_->index(edge->from(graph_));
+  VertexIndex to_index = graph_->index(edge->to(graph_));
+  int depth = 1;
+  if (from_index < fanin_depths_.size())
+    depth += fanin_depths_[from_index];
+  if (to_index < fanout_depths_.size())
+    depth += fanout_depths_[to_index];
+  return depth;
+}
+
+void
+AocvDepths::ensureDepths()
+{
+  if (!depths_exist_) {
+    findDepths(true);
+    depths_exist_ = true;
+  }
+  else if (!invalid_fanin_.empty()
+	   || !invalid_fanout_.empty())
+    findDepths(false);
+}
+
+void
+AocvDepths::ensureSize()
+{
+  size_t index_bound = graph_->vertexIndexBound();
+  // New vertices are seeded by faninInvalid/fanoutInvalid.
+  if (fanin_depths_.size() < index_bound) {
+    fanin_depths_.resize(index_bound, 0);
+    fanout_depths_.resize(index_bound, 0);
+  }
+  fanin_iter_->ensureSize();
+  fanout_iter_->ensureSize();
+}
+
+void
+AocvDepths::findDepths(bool all)
+{
+  Stats stats(debug_, phase_stats_);
+  debugPrint3(debug_, "aocv", 1, "find depths %s%zu/%zu\n",
+	      all ? "all " : "",
+	      invalid_fanin_.size(),
+	      invalid_fanout_.size());
+  ensureSize();
+  VertexSeq fanin_vertices;
+  VertexSeq fanout_vertices;
+  if (all) {
+    fanin_depths_.assign(fanin_depths_.size(), 0);
+    fanout_depths_.assign(fanout_depths_.size(), 0);
+    VertexIterator vertex_iter(graph_);
+    while (vertex_iter.hasNext()) {
+      Vertex *vertex = vertex_iter.next();
+      fanin_vertices.push_back(vertex);
+    }
+    fanout_vertices = fanin_vertices;
+  }
+  else {
+    invalid_fanin_.vertices(graph_, fanin_vertices);
+    invalid_fanout_.vertices(graph_, fanout_vertices);
+  }
+  invalid_fanin_.clear();
+  invalid_fanout_.clear();
+
+  // The iterators share the BfsIndex::other queue flag so the passes
+  // cannot overlap.
+  for (auto vertex : fanin_vertices)
+    fanin_iter_->enqueue(vertex);
+  AocvDepthVisitor fanin_visitor(true, fanin_depths_, fanin_iter_,
+				 search_pred_, this);
+  int visit_count = fanin_iter_->visitParallel(levelize_->maxLevel(),
+					       &fanin_visitor);
+
+  for (auto vertex : fanout_vertices)
+    fanout_iter_->enqueue(vertex);
+  AocvDepthVisitor fanout_visitor(false, fanout_depths_, fanout_iter_,
+				  search_pred_, this);
+  visit_count += fanout_iter_->visitParallel(0, &fanout_visitor);
+  stats.setVisitCount(visit_count);
+  stats.report("Find AOCV depths");
+}
+
+} // namespace
@@ -0,0 +1,78 @@
+// OpenSTA, Static Timing Analyzer
+// Copyright (c) 2019, Parallax Software, Inc.
+// 
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+// 
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+// 
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#ifndef STA_AOCV_DEPTHS_H
+#define STA_AOCV_DEPTHS_H
+
+#include <vector>
+#include "DisallowCopyAssign.hh"
+#include "GraphClass.hh"
+#include "VertexBitSet.hh"
+#include "StaState.hh"
+
+namespace sta {
+
+class SearchPred;
+class BfsFwdIterator;
+class BfsBkwdIterator;
+
+// Logic depths for advanced on-chip variation (AOCV) derates.
+// The depth of a cell arc is the number of cell stages on the
+// shortest path segment thru it. Path segments start at inputs,
+// clock sources and register clock pins and end at register clock
+// pins, timing checks and outputs, so clock and data paths are
+// counted separately. Using the shortest segment thru each cell
+// instead of enumerating paths is the graph based (pessimistic)
+// approximation of path depth.
+// Depths are found in parallel level order passes and updated
+// incrementally from the vertices with fanin or fanout edge changes.
+class AocvDepths : public StaState
+{
+public:
+  explicit AocvDepths(StaState *sta);
+  virtual ~AocvDepths();
+  virtual void copyState(const StaState *sta);
+  void ensureDepths();
+  // Cell stages on the shortest path segment thru a cell edge.
+  int cellDepth(Edge *edge) const;
+  // Thread safe so delay calc observers can call them.
+  void faninInvalid(Vertex *vertex);
+  void fanoutInvalid(Vertex *vertex);
+  // Find all depths again.
+  void depthsInvalid();
+  void deleteVertexBefore(Vertex *vertex);
+  void clear();
+
+protected:
+  // Find the depths of all vertices or the invalid ones.
+  void findDepths(bool all);
+  void ensureSize();
+
+  std::vector<int> fanin_depths_;
+  std::vector<int> fanout_depths_;
+  bool depths_exist_;
+  VertexBitSet invalid_fanin_;
+  VertexBitSet invalid_fanout_;
+  SearchPred *search_pred_;
+  BfsFwdIterator *fanin_iter_;
+  BfsBkwdIterator *fanout_iter_;
+
+private:
+  DISALLOW_COPY_AND_ASSIGN(AocvDepths);
+};
+
+} // namespace
+#endif
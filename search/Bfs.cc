@@ -15,16 +15,24 @@
 // along with this program.  If not, see <https://www.gnu.org/licenses/>.
 
 #include <limits.h>
+#include <atomic>
+#include <chrono>
+#include <deque>
+#include <memory>
 #include "Machine.hh"
 #include "Report.hh"
 #include "Debug.hh"
 #include "Mutex.hh"
 #include "ThreadForEach.hh"
+#include "Progress.hh"
+#include "UnorderedMap.hh"
 #include "Network.hh"
 #include "Graph.hh"
 #include "Levelize.hh"
 #include "Sdc.hh"
 #include "SearchPred.hh"
+#include "ThreadProfile.hh"
+#include "HotVertices.hh"
 #include "Bfs.hh"
 
 namespace sta {
@@ -38,7 +46,8 @@ BfsIterator::BfsIterator(BfsIndex bfs_index,
   bfs_index_(bfs_index),
   level_min_(level_min),
   level_max_(level_max),
-  search_pred_(search_pred)
+  search_pred_(search_pred),
+  staging_(false)
 {
   init();
 }
@@ -135,116 +144,278 @@ BfsIterator::enqueueAdjacentVertices(Vertex *vertex,
   enqueueAdjacentVertices(vertex, search_pred_, to_level);
 }
 
+static const char *bfs_progress_steps[] = {
+  "delay calc", "arrival search", "required search", "search"
+};
+
+const char *
+BfsIterator::progressStep() const
+{
+  return bfs_progress_steps[static_cast<int>(bfs_index_)];
+}
+
+// Backward iterators visit levels from the max level down.
+size_t
+BfsIterator::levelsDone(Level level) const
+{
+  if (levelLess(0, 1))
+    return level + 1;
+  else
+    return levelize_->maxLevel() - level + 1;
+}
+
 int
 BfsIterator::visit(Level to_level,
 		   VertexVisitor *visitor)
 {
+  Progress progress(progressStep(), "vertices", report_);
+  size_t graph_level_count = levelize_->maxLevel() + 1;
+  HotVertices *hot = hotVerticesEnabled() ? hot_vertices_ : nullptr;
+  if (hot)
+    hot_work_.resize(1);
   int visit_count = 0;
   while (levelLessOrEqual(first_level_, last_level_)
 	 && levelLessOrEqual(first_level_, to_level)) {
-    VertexSeq &level_vertices = queue_[first_level_];
+    Level level = first_level_;
+    VertexSeq &level_vertices = queue_[level];
     incrLevel(first_level_);
     if (!level_vertices.empty()) {
+      visitor->levelBegin(level_vertices);
       for (auto vertex : level_vertices) {
 	if (vertex) {
 	  vertex->setBfsInQueue(bfs_index_, false);
-	  visitor->visit(vertex);
+	  if (hot)
+	    visitProfiled(vertex, visitor, nullptr, &hot_work_[0]);
+	  else
+	    visitor->visit(vertex);
 	  visit_count++;
+	  progress.incr();
 	}
       }
       level_vertices.clear();
+      progress.setLevel(levelsDone(level), graph_level_count);
     }
   }
+  if (hot)
+    hot->record(bfs_index_, hot_work_, this);
   return visit_count;
 }
 
-// VertexSeq::Iterator that filters null objects,
-// and pops objects so the vector does not need to be cleared.
-class QueueIterator : Iterator<Vertex*>
+int
+BfsIterator::visitParallel(Level to_level,
+			   VertexVisitor *visitor)
 {
-public:
-  QueueIterator(VertexSeq &vertices,
-		BfsIndex bfs_index);
-  virtual bool hasNext();
-  virtual Vertex *next();
-  unsigned count() { return count_; }
+  int visit_count = 0;
+  if (!empty()) {
+    if (thread_pool_ == nullptr || thread_pool_->threadCount() <= 1)
+      visit_count = visit(to_level, visitor);
+    else {
+      // Visitors are copied once per call rather than once per level.
+      int thread_count = thread_pool_->threadCount();
+      VertexVisitorSeq visitors(thread_count);
+      for (int i = 0; i < thread_count; i++)
+	visitors[i] = visitor->copy();
+      HotVertices *hot = hotVerticesEnabled() ? hot_vertices_ : nullptr;
+      if (hot)
+	hot_work_.resize(thread_count);
+      if (dataflow_scheduling_)
+	visit_count += visitDataflow(to_level, visitors);
+      visit_count += visitLevels(to_level, visitors);
+      visitors.deleteContents();
+      if (hot)
+	hot->record(bfs_index_, hot_work_, this);
+    }
+  }
+  return visit_count;
+}
 
-private:
-  VertexSeq &vertices_;
-  BfsIndex bfs_index_;
-  unsigned count_;
-};
+int
+BfsIterator::visitLevels(Level to_level,
+			 VertexVisitorSeq &visitors)
+{
+  Progress progress(progressStep(), "vertices", report_);
+  size_t graph_level_count = levelize_->maxLevel() + 1;
+  int visit_count = 0;
+  staged_.resize(visitors.size());
+  ThreadProfile *profile = profileEnabled() ? thread_profile_ : nullptr;
+  ThreadLevelWorkSeq work(profile ? visitors.size() : 0);
+  HotVertexWork *hot_work = hotVerticesEnabled() ? hot_work_.data() : nullptr;
+  Level level = first_level_;
+  while (levelLessOrEqual(level, last_level_)
+	 && levelLessOrEqual(level, to_level)) {
+    VertexSeq &level_vertices = queue_[level];
+    incrLevel(first_level_);
+    if (!level_vertices.empty()) {
+      std::atomic<int> level_count(0);
+      // The thread visitors are copies so any of them can see the level.
+      visitors[0]->levelBegin(level_vertices);
+      VertexSeq heavy_vertices;
+      removeHeavy(level_vertices, visitors[0], heavy_vertices);
+      std::atomic<size_t> next_heavy(0);
+      auto visit_vertex = [&] (Vertex *vertex,
+			       int thread_index) {
+	vertex->setBfsInQueue(bfs_index_, false);
+	if (profile || hot_work)
+	  visitProfiled(vertex, visitors[thread_index],
+			profile ? &work[thread_index] : nullptr,
+			hot_work ? &hot_work[thread_index] : nullptr);
+	else
+	  visitors[thread_index]->visit(vertex);
+      };
+      // Threads claim blocks of the level's vertices without locking.
+      // Heavy vertices are claimed one at a time before a thread's
+      // first block so they start first and do not hold up the other
+      // vertices in their block.
+      // The pool waits for all threads working on this level
+      // before returning.
+      staging_ = true;
+      auto level_start = std::chrono::steady_clock::now();
+      if (level_vertices.empty())
+	forEachChunk(heavy_vertices.size(), thread_pool_,
+		     [&] (size_t begin, size_t end, int thread_index) {
+		       for (size_t i = begin; i < end; i++)
+			 visit_vertex(heavy_vertices[i], thread_index);
+		       level_count += end - begin;
+		     });
+      else
+	forEachChunk(level_vertices.size(), thread_pool_,
+		     [&] (size_t begin, size_t end, int thread_index) {
+		       int count = 0;
+		       size_t heavy_index;
+		       while ((heavy_index = next_heavy++)
+			      < heavy_vertices.size()) {
+			 visit_vertex(heavy_vertices[heavy_index],
+				      thread_index);
+			 count++;
+		       }
+		       for (size_t i = begin; i < end; i++) {
+			 Vertex *vertex = level_vertices[i];
+			 // Removed vertices are null.
+			 if (vertex) {
+			   visit_vertex(vertex, thread_index);
+			   count++;
+			 }
+		       }
+		       level_count += count;
+		     });
+      staging_ = false;
+      if (profile) {
+	profile->levelVisited(bfs_index_, level, secondsSince(level_start),
+			      work, network_);
+	for (auto &thread_work : work)
+	  thread_work.clear();
+      }
+      level_vertices.clear();
+      mergeStaged();
+      visit_count += level_count;
+      progress.incr(level_count);
+      progress.setLevel(levelsDone(level), graph_level_count);
+    }
+    level = first_level_;
+  }
+  return visit_count;
+}
 
-QueueIterator::QueueIterator(VertexSeq &vertices,
-			     BfsIndex bfs_index) :
-  vertices_(vertices),
-  bfs_index_(bfs_index),
-  count_(0)
+// Move the vertices that visitor says are heavy from level_vertices
+// to heavy_vertices.
+void
+BfsIterator::removeHeavy(VertexSeq &level_vertices,
+			 VertexVisitor *visitor,
+			 // Return value.
+			 VertexSeq &heavy_vertices)
 {
+  size_t j = 0;
+  for (auto vertex : level_vertices) {
+    if (vertex && visitor->heavy(vertex))
+      heavy_vertices.push_back(vertex);
+    else
+      level_vertices[j++] = vertex;
+  }
+  level_vertices.resize(j);
 }
-  
+
 bool
-QueueIterator::hasNext()
+BfsIterator::profileEnabled() const
 {
-  Vertex *next = nullptr;
-  while (!vertices_.empty()
-	 && (next = vertices_.back()) == nullptr)
-    vertices_.pop_back();
-  return next != nullptr;
+  return thread_profile_ && thread_profile_->enabled();
 }
 
-Vertex *
-QueueIterator::next()
+bool
+BfsIterator::hotVerticesEnabled() const
 {
-  Vertex *next = vertices_.back();
-  next->setBfsInQueue(bfs_index_, false);
-  vertices_.pop_back();
-  count_++;
-  return next;
+  return hot_vertices_ && hot_vertices_->enabled();
 }
 
-int
-BfsIterator::visitParallel(Level to_level,
-			   VertexVisitor *visitor)
+void
+BfsIterator::visitProfiled(Vertex *vertex,
+			   VertexVisitor *visitor,
+			   ThreadLevelWork *work,
+			   HotVertexWork *hot_work)
 {
-  int visit_count = 0;
-  if (!empty()) {
-    if (thread_count_ <= 1)
-      visit_count = visit(to_level, visitor);
-    else {
-      std::mutex lock;
-      Level level = first_level_;
-      while (levelLessOrEqual(level, last_level_)
-	     && levelLessOrEqual(level, to_level)) {
-	VertexSeq &level_vertices = queue_[level];
-	if (!level_vertices.empty()) {
-	  incrLevel(first_level_);
-	  QueueIterator iter(level_vertices, bfs_index_);
-	  std::vector<std::thread> threads;
-
-	  for (int i = 0; i < thread_count_; i++) {
-	    ForEachArg<QueueIterator, VertexVisitor> arg(&iter, lock,
-							 visitor->copy());
-	    // Missing check for null vertex.
-	    threads.push_back(std::thread(forEachBegin<QueueIterator,
-					  VertexVisitor, Vertex*>, arg));
-	  }
+  auto start = std::chrono::steady_clock::now();
+  visitor->visit(vertex);
+  double seconds = secondsSince(start);
+  if (work)
+    work->visited(vertex, seconds);
+  if (hot_work)
+    hot_work->visited(vertex, seconds);
+}
 
-	  // Wait for all threads working on this level before moving on.
-	  for (auto &thread : threads)
-	    thread.join();
+double
+BfsIterator::secondsSince(std::chrono::steady_clock::time_point start)
+{
+  std::chrono::duration<double> seconds =
+    std::chrono::steady_clock::now() - start;
+  return seconds.count();
+}
 
-	  visit_count += iter.count();
-	  level = first_level_;
-	}
-	else {
-	  incrLevel(first_level_);
-	  level = first_level_;
-	}
+void
+BfsIterator::mergeStaged()
+{
+  for (auto &staged : staged_) {
+    for (auto vertex : staged) {
+      if (!vertex->bfsInQueue(bfs_index_)) {
+	Level level = vertex->level();
+	vertex->setBfsInQueue(bfs_index_, true);
+	queue_[level].push_back(vertex);
+	if (levelLess(last_level_, level))
+	  last_level_ = level;
+	if (levelLess(level, first_level_))
+	  first_level_ = level;
       }
     }
+    staged.clear();
   }
-  return visit_count;
+}
+
+int
+BfsIterator::visitDataflow(Level,
+			   VertexVisitorSeq &)
+{
+  return 0;
+}
+
+void
+BfsIterator::removeVisited(Level to_level)
+{
+  VertexSet queued;
+  Level level = first_level_;
+  while (levelLessOrEqual(level, last_level_)
+	 && levelLessOrEqual(level, to_level)) {
+    VertexSeq &level_vertices = queue_[level];
+    size_t j = 0;
+    for (auto vertex : level_vertices) {
+      if (vertex
+	  && vertex->bfsInQueue(bfs_index_)
+	  && !queued.hasKey(vertex)) {
+	queued.insert(vertex);
+	level_vertices[j++] = vertex;
+      }
+    }
+    level_vertices.resize(j);
+    incrLevel(level);
+  }
+  findNext(to_level);
 }
 
 bool
@@ -284,7 +455,11 @@ void
 BfsIterator::enqueue(Vertex *vertex)
 {
   debugPrint1(debug_, "bfs", 2, "enqueue %s\n", vertex->name(sdc_network_));
-  if (!vertex->bfsInQueue(bfs_index_)) {
+  int thread_index = ThreadPool::threadIndex();
+  if (staging_ && thread_index >= 0)
+    // The in queue flag is checked when the staged vertices are merged.
+    staged_[thread_index].push_back(vertex);
+  else if (!vertex->bfsInQueue(bfs_index_)) {
     Level level = vertex->level();
     UniqueLock lock(queue_lock_);
     if (!vertex->bfsInQueue(bfs_index_)) {
@@ -402,6 +577,199 @@ BfsFwdIterator::enqueueAdjacentVertices(Vertex *vertex,
   }
 }
 
+// Work queue for one thread that other threads can steal from.
+class BfsWorkDeque
+{
+public:
+  void push(int index);
+  // Pop the most recently pushed entry (owner thread).
+  bool pop(int &index);
+  // Remove the oldest entry (other threads).
+  bool steal(int &index);
+
+private:
+  std::mutex lock_;
+  std::deque<int> indices_;
+};
+
+void
+BfsWorkDeque::push(int index)
+{
+  UniqueLock lock(lock_);
+  indices_.push_back(index);
+}
+
+bool
+BfsWorkDeque::pop(int &index)
+{
+  UniqueLock lock(lock_);
+  if (indices_.empty())
+    return false;
+  else {
+    index = indices_.back();
+    indices_.pop_back();
+    return true;
+  }
+}
+
+bool
+BfsWorkDeque::steal(int &index)
+{
+  UniqueLock lock(lock_);
+  if (indices_.empty())
+    return false;
+  else {
+    index = indices_.front();
+    indices_.pop_front();
+    return true;
+  }
+}
+
+// Visit the queued vertices and the fanout cone reachable from them
+// (up to to_level) in dataflow order.  Each vertex in the cone has a
+// count of pending fanin in the cone; when the count reaches zero the
+// vertex is visited (if a fanin enqueued it) and its fanout counts are
+// decremented.  Only edges that increase the level are dependencies so
+// loop breaking edges cannot deadlock the schedule.
+int
+BfsFwdIterator::visitDataflow(Level to_level,
+			      VertexVisitorSeq &visitors)
+{
+  // Vertices in the cone, indexed by schedule index.
+  VertexSeq cone;
+  UnorderedMap<Vertex*, int> cone_index;
+  Level level = first_level_;
+  while (levelLessOrEqual(level, last_level_)
+	 && levelLessOrEqual(level, to_level)) {
+    for (auto vertex : queue_[level]) {
+      if (vertex
+	  && vertex->bfsInQueue(bfs_index_)
+	  && !cone_index.hasKey(vertex)) {
+	cone_index[vertex] = cone.size();
+	cone.push_back(vertex);
+      }
+    }
+    incrLevel(level);
+  }
+
+  // Dependency (from, to) pairs.
+  std::vector<std::pair<int, int>> deps;
+  for (size_t i = 0; i < cone.size(); i++) {
+    Vertex *vertex = cone[i];
+    if (search_pred_ == nullptr || search_pred_->searchFrom(vertex)) {
+      VertexOutEdgeIterator edge_iter(vertex, graph_);
+      while (edge_iter.hasNext()) {
+	Edge *edge = edge_iter.next();
+	Vertex *to_vertex = edge->to(graph_);
+	Level to_vertex_level = to_vertex->level();
+	if (to_vertex_level > vertex->level()
+	    && to_vertex_level <= to_level
+	    && (search_pred_ == nullptr
+		|| (search_pred_->searchThru(edge)
+		    && search_pred_->searchTo(to_vertex)))) {
+	  int to_index;
+	  auto index_iter = cone_index.find(to_vertex);
+	  if (index_iter == cone_index.end()) {
+	    to_index = cone.size();
+	    cone_index[to_vertex] = to_index;
+	    cone.push_back(to_vertex);
+	  }
+	  else
+	    to_index = index_iter->second;
+	  deps.push_back(std::pair<int, int>(i, to_index));
+	}
+      }
+    }
+  }
+  // Dependencies known to the visitor that are not edges.
+  VertexSeq preds;
+  for (size_t i = 0; i < cone.size(); i++) {
+    preds.clear();
+    visitors[0]->dataflowPreds(cone[i], preds);
+    for (auto pred : preds) {
+      auto index_iter = cone_index.find(pred);
+      if (index_iter != cone_index.end()
+	  && index_iter->second != static_cast<int>(i))
+	deps.push_back(std::pair<int, int>(index_iter->second, i));
+    }
+  }
+
+  // Compressed fanout lists and pending fanin counts.
+  int cone_count = cone.size();
+  std::vector<int> fanout_begin(cone_count + 1, 0);
+  std::unique_ptr<std::atomic<int>[]> pending(new std::atomic<int>[cone_count]);
+  for (int i = 0; i < cone_count; i++)
+    pending[i] = 0;
+  for (auto &dep : deps) {
+    fanout_begin[dep.first + 1]++;
+    pending[dep.second]++;
+  }
+  for (int i = 0; i < cone_count; i++)
+    fanout_begin[i + 1] += fanout_begin[i];
+  std::vector<int> fanouts(deps.size());
+  std::vector<int> fanout_next(fanout_begin.begin(), fanout_begin.end() - 1);
+  for (auto &dep : deps)
+    fanouts[fanout_next[dep.first]++] = dep.second;
+  deps.clear();
+
+  int thread_count = thread_pool_->threadCount();
+  std::vector<BfsWorkDeque> work(thread_count);
+  int ready_count = 0;
+  for (int i = 0; i < cone_count; i++) {
+    if (pending[i] == 0)
+      work[ready_count++ % thread_count].push(i);
+  }
+
+  ThreadProfile *profile = profileEnabled() ? thread_profile_ : nullptr;
+  ThreadLevelWorkSeq profile_work(profile ? thread_count : 0);
+  HotVertexWork *hot_work = hotVerticesEnabled() ? hot_work_.data() : nullptr;
+  auto dataflow_start = std::chrono::steady_clock::now();
+  std::atomic<int> remaining(cone_count);
+  std::atomic<int> visit_count(0);
+  thread_pool_->run([&] (int thread_index) {
+      VertexVisitor *visitor = visitors[thread_index];
+      BfsWorkDeque &own_work = work[thread_index];
+      int count = 0;
+      while (remaining > 0) {
+	int index;
+	bool found = own_work.pop(index);
+	for (int i = 1; !found && i < thread_count; i++)
+	  found = work[(thread_index + i) % thread_count].steal(index);
+	if (found) {
+	  Vertex *vertex = cone[index];
+	  // Cone vertices that were not enqueued by their fanin
+	  // only release their fanout.
+	  if (vertex->bfsInQueue(bfs_index_)) {
+	    vertex->setBfsInQueue(bfs_index_, false);
+	    if (profile || hot_work)
+	      visitProfiled(vertex, visitor,
+			    profile ? &profile_work[thread_index] : nullptr,
+			    hot_work ? &hot_work[thread_index] : nullptr);
+	    else
+	      visitor->visit(vertex);
+	    count++;
+	  }
+	  for (int i = fanout_begin[index]; i < fanout_begin[index + 1]; i++) {
+	    int fanout = fanouts[i];
+	    if (--pending[fanout] == 0)
+	      own_work.push(fanout);
+	  }
+	  remaining--;
+	}
+	else
+	  std::this_thread::yield();
+      }
+      visit_count += count;
+    });
+  if (profile)
+    profile->dataflowVisited(bfs_index_, secondsSince(dataflow_start),
+			     profile_work);
+  // Vertices enqueued from outside the cone (or by edges that do not
+  // increase the level) are still in the queue.
+  removeVisited(to_level);
+  return visit_count;
+}
+
 ////////////////////////////////////////////////////////////////
 
 BfsBkwdIterator::BfsBkwdIterator(BfsIndex bfs_index,
@@ -17,6 +17,7 @@
 #ifndef STA_BFS_H
 #define STA_BFS_H
 
+#include <chrono>
 #include <mutex>
 #include "DisallowCopyAssign.hh"
 #include "Iterator.hh"
@@ -24,15 +25,18 @@
 #include "StaState.hh"
 #include "GraphClass.hh"
 #include "VertexVisitor.hh"
+#include "HotVertices.hh"
 
 namespace sta {
 
 class SearchPred;
+class ThreadLevelWork;
 class BfsFwdIterator;
 class BfsBkwdIterator;
 
 // LevelQueue is a vector of vertex vectors indexed by logic level.
 typedef Vector<VertexSeq> LevelQueue;
+typedef Vector<VertexVisitor*> VertexVisitorSeq;
 
 // Abstract base class for forward and backward breadth first search iterators.
 // Visit all of the vertices at a level before moving to the next.
@@ -80,6 +84,9 @@ public:
 		    VertexVisitor *visitor);
   // Apply visitor to all vertices in the queue in level order,
   // using threads to parallelize the visits. visitor must be thread safe.
+  // With dataflow scheduling (TCL variable sta_dataflow_scheduling)
+  // vertices are visited as soon as their fanin has been visited
+  // instead of waiting for all of the vertices in the previous level.
   // Returns the number of vertices that are visited.
   int visitParallel(Level to_level,
 		    VertexVisitor *visitor);
@@ -99,6 +106,34 @@ protected:
   virtual void incrLevel(Level &level) = 0;
   void findNext(Level to_level);
   void deleteEntries();
+  // Level synchronous parallel visit with one visitor per thread.
+  int visitLevels(Level to_level,
+		  VertexVisitorSeq &visitors);
+  // Visit queued vertices and their fanout cone in dataflow order.
+  // Vertices left in the queue are visited by visitLevels.
+  virtual int visitDataflow(Level to_level,
+			    VertexVisitorSeq &visitors);
+  // Remove visited and duplicate entries from the queue up to to_level.
+  void removeVisited(Level to_level);
+  void mergeStaged();
+  void removeHeavy(VertexSeq &level_vertices,
+		   VertexVisitor *visitor,
+		   // Return value.
+		   VertexSeq &heavy_vertices);
+  // Thread profiling (TCL variable sta_thread_profile).
+  bool profileEnabled() const;
+  // Hot vertex profiling (TCL variable sta_hot_vertex_profile).
+  bool hotVerticesEnabled() const;
+  // Visit vertex and record the visit time in work and hot_work
+  // if they are non-null.
+  static void visitProfiled(Vertex *vertex,
+			    VertexVisitor *visitor,
+			    ThreadLevelWork *work,
+			    HotVertexWork *hot_work);
+  static double secondsSince(std::chrono::steady_clock::time_point start);
+  // Progress message step name for the iterator.
+  const char *progressStep() const;
+  size_t levelsDone(Level level) const;
 
   BfsIndex bfs_index_;
   Level level_min_;
@@ -106,6 +141,13 @@ protected:
   SearchPred *search_pred_;
   LevelQueue queue_;
   std::mutex queue_lock_;
+  // While visitLevels is visiting a level in parallel, enqueued
+  // vertices are appended to per-thread staging vectors without locking
+  // and merged into queue_ when the level is finished.
+  bool staging_;
+  Vector<VertexSeq> staged_;
+  // Per thread slowest visits while hot vertex profiling.
+  HotVertexWorkSeq hot_work_;
   // Min (max) level of queued vertices.
   Level first_level_;
   // Max (min) level of queued vertices.
@@ -136,6 +178,8 @@ protected:
   virtual bool levelLess(Level level1,
 			 Level level2) const;
   virtual void incrLevel(Level &level);
+  virtual int visitDataflow(Level to_level,
+			    VertexVisitorSeq &visitors);
 
 private:
   DISALLOW_COPY_AND_ASSIGN(BfsFwdIterator);
@@ -0,0 +1,264 @@
+// OpenSTA, Static Timing Analyzer
+// Copyright (c) 2019, Parallax Software, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#include <stdio.h>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include "Machine.hh"
+#include "Report.hh"
+#include "Error.hh"
+#include "Fuzzy.hh"
+#include "MinMax.hh"
+#include "Transition.hh"
+#include "PortDirection.hh"
+#include "Network.hh"
+#include "Graph.hh"
+#include "Clock.hh"
+#include "Sdc.hh"
+#include "Corner.hh"
+#include "PathAnalysisPt.hh"
+#include "Sta.hh"
+#include "BoundaryTiming.hh"
+
+namespace sta {
+
+using std::string;
+using std::ifstream;
+using std::istringstream;
+
+// File format, one record per line with times in seconds.
+//  instance inst_path
+//  slew port rise|fall min|max slew
+//  input port rise|fall min|max clock rise|fall delay
+//  output port rise|fall min|max clock rise|fall delay
+
+static void
+writeInputTiming(FILE *stream,
+		 const char *port_name,
+		 Vertex *vertex,
+		 const Corner *corner,
+		 Sta *sta);
+static void
+writeOutputTiming(FILE *stream,
+		  const char *port_name,
+		  Vertex *vertex,
+		  const Corner *corner,
+		  Sta *sta);
+static Vertex *
+boundaryDrvrVertex(const Pin *pin,
+		   Sta *sta);
+
+void
+writeBoundaryTiming(Instance *inst,
+		    const char *filename,
+		    Sta *sta)
+{
+  FILE *stream = fopen(filename, "w");
+  if (stream == nullptr)
+    throw FileNotWritable(filename);
+  Network *network = sta->network();
+  const Corner *corner = sta->cmdCorner();
+  fprintf(stream, "instance %s\n", network->pathName(inst));
+  InstancePinIterator *pin_iter = network->pinIterator(inst);
+  while (pin_iter->hasNext()) {
+    Pin *pin = pin_iter->next();
+    Vertex *vertex = boundaryDrvrVertex(pin, sta);
+    if (vertex) {
+      const char *port_name = network->portName(pin);
+      PortDirection *dir = network->direction(pin);
+      if (dir->isAnyInput())
+	writeInputTiming(stream, port_name, vertex, corner, sta);
+      if (dir->isAnyOutput())
+	writeOutputTiming(stream, port_name, vertex, corner, sta);
+    }
+  }
+  delete pin_iter;
+  fclose(stream);
+}
+
+// Input pins are timed at the driver outside the block and output
+// pins at the driver inside the block.
+static Vertex *
+boundaryDrvrVertex(const Pin *pin,
+		   Sta *sta)
+{
+  Network *network = sta->network();
+  Graph *graph = sta->ensureGraph();
+  PinSet *drvrs = network->drivers(pin);
+  if (drvrs && !drvrs->empty())
+    return graph->pinDrvrVertex(*drvrs->begin());
+  else
+    return nullptr;
+}
+
+static void
+writeInputTiming(FILE *stream,
+		 const char *port_name,
+		 Vertex *vertex,
+		 const Corner *corner,
+		 Sta *sta)
+{
+  Sdc *sdc = sta->sdc();
+  MinMaxIterator mm_iter;
+  while (mm_iter.hasNext()) {
+    MinMax *min_max = mm_iter.next();
+    const PathAnalysisPt *path_ap = corner->findPathAnalysisPt(min_max);
+    const DcalcAnalysisPt *dcalc_ap = corner->findDcalcAnalysisPt(min_max);
+    TransRiseFallIterator tr_iter;
+    while (tr_iter.hasNext()) {
+      TransRiseFall *tr = tr_iter.next();
+      Slew slew = sta->vertexSlew(vertex, tr, dcalc_ap);
+      fprintf(stream, "slew %s %s %s %.6e\n",
+	      port_name, tr->name(), min_max->asString(),
+	      delayAsFloat(slew));
+      for (auto clk : sdc->clks()) {
+	TransRiseFallIterator clk_tr_iter;
+	while (clk_tr_iter.hasNext()) {
+	  TransRiseFall *clk_tr = clk_tr_iter.next();
+	  ClockEdge *clk_edge = clk->edge(clk_tr);
+	  Arrival arrival = sta->vertexArrival(vertex, tr, clk_edge, path_ap);
+	  if (!fuzzyInf(delayAsFloat(arrival)))
+	    fprintf(stream, "input %s %s %s %s %s %.6e\n",
+		    port_name, tr->name(), min_max->asString(),
+		    clk->name(), clk_tr->name(),
+		    delayAsFloat(arrival) - clk_edge->time());
+	}
+      }
+    }
+  }
+}
+
+static void
+writeOutputTiming(FILE *stream,
+		  const char *port_name,
+		  Vertex *vertex,
+		  const Corner *corner,
+		  Sta *sta)
+{
+  Sdc *sdc = sta->sdc();
+  MinMaxIterator mm_iter;
+  while (mm_iter.hasNext()) {
+    MinMax *min_max = mm_iter.next();
+    const PathAnalysisPt *path_ap = corner->findPathAnalysisPt(min_max);
+    TransRiseFallIterator tr_iter;
+    while (tr_iter.hasNext()) {
+      TransRiseFall *tr = tr_iter.next();
+      for (auto clk : sdc->clks()) {
+	TransRiseFallIterator clk_tr_iter;
+	while (clk_tr_iter.hasNext()) {
+	  TransRiseFall *clk_tr = clk_tr_iter.next();
+	  ClockEdge *clk_edge = clk->edge(clk_tr);
+	  Required required = sta->vertexRequired(vertex, tr, clk_edge,
+						  path_ap);
+	  if (!fuzzyInf(delayAsFloat(required))) {
+	    float capture_time = clk_edge->time();
+	    if (min_max == MinMax::max())
+	      capture_time += clk->period();
+	    fprintf(stream, "output %s %s %s %s %s %.6e\n",
+		    port_name, tr->name(), min_max->asString(),
+		    clk->name(), clk_tr->name(),
+		    capture_time - delayAsFloat(required));
+	  }
+	}
+      }
+    }
+  }
+}
+
+////////////////////////////////////////////////////////////////
+
+bool
+readBoundaryTiming(const char *filename,
+		   Sta *sta)
+{
+  ifstream stream(filename);
+  if (!stream.is_open())
+    throw FileNotReadable(filename);
+  Network *network = sta->network();
+  Report *report = sta->report();
+  Sdc *sdc = sta->sdc();
+  Instance *top_inst = network->topInstance();
+  string line;
+  int line_number = 0;
+  bool success = true;
+  while (getline(stream, line)) {
+    line_number++;
+    istringstream tokens(line);
+    string record, port_name, tr_name, min_max_name;
+    tokens >> record;
+    if (record.empty() || record == "instance")
+      continue;
+    tokens >> port_name >> tr_name >> min_max_name;
+    Pin *pin = network->findPin(top_inst, port_name.c_str());
+    TransRiseFall *tr = TransRiseFall::find(tr_name.c_str());
+    MinMax *min_max = MinMax::find(min_max_name.c_str());
+    if (pin == nullptr) {
+      report->fileWarn(filename, line_number, "port %s not found.\n",
+		       port_name.c_str());
+      continue;
+    }
+    if (tr == nullptr || min_max == nullptr) {
+      report->fileError(filename, line_number, "syntax error.\n");
+      success = false;
+      continue;
+    }
+    if (record == "slew") {
+      float slew;
+      if (tokens >> slew)
+	sta->setInputSlew(network->port(pin), tr->asRiseFallBoth(),
+			  min_max->asMinMaxAll(), slew);
+      else {
+	report->fileError(filename, line_number, "syntax error.\n");
+	success = false;
+      }
+    }
+    else if (record == "input" || record == "output") {
+      string clk_name, clk_tr_name;
+      float delay;
+      if (tokens >> clk_name >> clk_tr_name >> delay) {
+	Clock *clk = sdc->findClock(clk_name.c_str());
+	TransRiseFall *clk_tr = TransRiseFall::find(clk_tr_name.c_str());
+	if (clk == nullptr)
+	  report->fileWarn(filename, line_number, "clock %s not found.\n",
+			   clk_name.c_str());
+	else if (clk_tr == nullptr) {
+	  report->fileError(filename, line_number, "syntax error.\n");
+	  success = false;
+	}
+	// Boundary times include the clock latencies.
+	else if (record == "input")
+	  sta->setInputDelay(pin, tr->asRiseFallBoth(), clk, clk_tr, nullptr,
+			     true, true, min_max->asMinMaxAll(), true, delay);
+	else
+	  sta->setOutputDelay(pin, tr->asRiseFallBoth(), clk, clk_tr, nullptr,
+			      true, true, min_max->asMinMaxAll(), true, delay);
+      }
+      else {
+	report->fileError(filename, line_number, "syntax error.\n");
+	success = false;
+      }
+    }
+    else {
+      report->fileError(filename, line_number, "unknown record %s.\n",
+			record.c_str());
+      success = false;
+    }
+  }
+  return success;
+}
+
+} // namespace
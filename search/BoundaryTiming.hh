@@ -0,0 +1,50 @@
+// OpenSTA, Static Timing Analyzer
+// Copyright (c) 2019, Parallax Software, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#ifndef STA_BOUNDARY_TIMING_H
+#define STA_BOUNDARY_TIMING_H
+
+#include "NetworkClass.hh"
+
+namespace sta {
+
+class Sta;
+
+// Boundary timing models let a hierarchical block be timed in its own
+// process. The top level session writes the arrivals and slews at the
+// block inputs and the requireds at the block outputs with respect to
+// each clock edge. The block level session reads them as input delays,
+// input transitions and output delays on its top level ports. Running
+// the two sessions in turn refines the boundary models.
+//
+// Output delays assume the block output is captured one clock period
+// after the launching edge for max paths and at the launching edge for
+// min paths.
+
+// Throws FileNotWritable.
+void
+writeBoundaryTiming(Instance *inst,
+		    const char *filename,
+		    Sta *sta);
+
+// Throws FileNotReadable.
+// Return true if successful.
+bool
+readBoundaryTiming(const char *filename,
+		   Sta *sta);
+
+} // namespace
+#endif
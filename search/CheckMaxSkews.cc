@@ -15,6 +15,7 @@
 // along with this program.  If not, see <https://www.gnu.org/licenses/>.
 
 #include "Machine.hh"
+#include "ThreadForEach.hh"
 #include "DisallowCopyAssign.hh"
 #include "TimingRole.hh"
 #include "TimingArc.hh"
@@ -58,6 +59,13 @@ CheckMaxSkews::clear()
   checks_.deleteContentsClear();
 }
 
+int
+CheckMaxSkews::threadCount() const
+{
+  ThreadPool *thread_pool = sta_->threadPool();
+  return thread_pool ? thread_pool->threadCount() : 1;
+}
+
 class MaxSkewChecksVisitor : public MaxSkewCheckVisitor
 {
 public:
@@ -84,21 +92,28 @@ MaxSkewChecksVisitor::visit(MaxSkewCheck &check,
   checks_.push_back(check.copy());
 }
 
+// Only violating checks are copied. With max_count each thread keeps
+// the max_count worst violators.
 class MaxSkewViolatorsVisititor : public MaxSkewCheckVisitor
 {
 public:
-  explicit MaxSkewViolatorsVisititor(MaxSkewCheckSeq &checks);
+  MaxSkewViolatorsVisititor(size_t max_count,
+			    MaxSkewCheckSeq &checks);
   virtual void visit(MaxSkewCheck &check,
 		     const StaState *sta);
 
 private:
   DISALLOW_COPY_AND_ASSIGN(MaxSkewViolatorsVisititor);
+
+  size_t max_count_;
   MaxSkewCheckSeq &checks_;
 };
 
 MaxSkewViolatorsVisititor::
-MaxSkewViolatorsVisititor(MaxSkewCheckSeq &checks) :
+MaxSkewViolatorsVisititor(size_t max_count,
+			  MaxSkewCheckSeq &checks) :
   MaxSkewCheckVisitor(),
+  max_count_(max_count),
   checks_(checks)
 {
 }
@@ -107,17 +122,30 @@ void
 MaxSkewViolatorsVisititor::visit(MaxSkewCheck &check,
 				 const StaState *sta)
 {
-  if (fuzzyLess(check.slack(sta), 0.0))
+  if (fuzzyLess(check.slack(sta), 0.0)) {
     checks_.push_back(check.copy());
+    if (max_count_ > 0
+	&& checks_.size() >= max_count_ * 2)
+      sortDeleteTail(checks_, max_count_, MaxSkewSlackLess(sta));
+  }
 }
 
 MaxSkewCheckSeq &
-CheckMaxSkews::violations()
+CheckMaxSkews::violations(size_t max_count)
 {
   clear();
-  MaxSkewViolatorsVisititor visitor(checks_);
-  visitMaxSkewChecks(&visitor);
-  sort(checks_, MaxSkewSlackLess(sta_));
+  int thread_count = threadCount();
+  std::vector<MaxSkewCheckSeq> thread_checks(thread_count);
+  std::vector<MaxSkewCheckVisitor*> visitors(thread_count);
+  for (int i = 0; i < thread_count; i++)
+    visitors[i] = new MaxSkewViolatorsVisititor(max_count, thread_checks[i]);
+  visitMaxSkewChecks(visitors);
+  for (int i = 0; i < thread_count; i++) {
+    MaxSkewCheckSeq &checks = thread_checks[i];
+    checks_.insert(checks_.end(), checks.begin(), checks.end());
+    delete visitors[i];
+  }
+  sortDeleteTail(checks_, max_count, MaxSkewSlackLess(sta_));
   return checks_;
 }
 
@@ -164,25 +192,62 @@ MaxSkewCheck *
 CheckMaxSkews::minSlackCheck()
 {
   clear();
-  MaxSkewSlackVisitor visitor;
-  visitMaxSkewChecks(&visitor);
-  MaxSkewCheck *check = visitor.minSlackCheck();
+  int thread_count = threadCount();
+  std::vector<MaxSkewSlackVisitor*> slack_visitors(thread_count);
+  std::vector<MaxSkewCheckVisitor*> visitors(thread_count);
+  for (int i = 0; i < thread_count; i++) {
+    slack_visitors[i] = new MaxSkewSlackVisitor;
+    visitors[i] = slack_visitors[i];
+  }
+  visitMaxSkewChecks(visitors);
+  MaxSkewSlackLess slack_less(sta_);
+  MaxSkewCheck *min_check = nullptr;
+  for (MaxSkewSlackVisitor *visitor : slack_visitors) {
+    MaxSkewCheck *check = visitor->minSlackCheck();
+    if (check) {
+      if (min_check == nullptr)
+	min_check = check;
+      else if (slack_less(check, min_check)) {
+	delete min_check;
+	min_check = check;
+      }
+      else
+	delete check;
+    }
+    delete visitor;
+  }
   // Save check for cleanup.
-  checks_.push_back(check);
-  return check;
+  checks_.push_back(min_check);
+  return min_check;
 }
 
 void
-CheckMaxSkews::visitMaxSkewChecks(MaxSkewCheckVisitor *visitor)
+CheckMaxSkews::checkVertices(// Return value.
+			     VertexSeq &vertices)
 {
   Graph *graph = sta_->graph();
   VertexIterator vertex_iter(graph);
   while (vertex_iter.hasNext()) {
     Vertex *vertex = vertex_iter.next();
-    visitMaxSkewChecks(vertex, visitor);
+    // Skew checks are timing check edges.
+    if (vertex->hasChecks())
+      vertices.push_back(vertex);
   }
 }
 
+void
+CheckMaxSkews::visitMaxSkewChecks(std::vector<MaxSkewCheckVisitor*> &visitors)
+{
+  VertexSeq vertices;
+  checkVertices(vertices);
+  forEachChunk(vertices.size(), sta_->threadPool(),
+	       [&] (size_t begin, size_t end, int thread_index) {
+		 MaxSkewCheckVisitor *visitor = visitors[thread_index];
+		 for (size_t i = begin; i < end; i++)
+		   visitMaxSkewChecks(vertices[i], visitor);
+	       });
+}
+
 void
 CheckMaxSkews:: visitMaxSkewChecks(Vertex *vertex,
 				   MaxSkewCheckVisitor *visitor)
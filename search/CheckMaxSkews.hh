@@ -17,6 +17,7 @@
 #ifndef STA_MAX_SKEW_H
 #define STA_MAX_SKEW_H
 
+#include <vector>
 #include "DisallowCopyAssign.hh"
 #include "StaState.hh"
 #include "GraphClass.hh"
@@ -35,12 +36,17 @@ public:
   ~CheckMaxSkews();
   void clear();
   // All violating max skew checks.
-  MaxSkewCheckSeq &violations();
+  // max_count > 0 returns the max_count checks with the least slack.
+  MaxSkewCheckSeq &violations(size_t max_count);
   // Max skew check with the least slack.
   MaxSkewCheck *minSlackCheck();
 
 protected:
-  void visitMaxSkewChecks(MaxSkewCheckVisitor *visitor);
+  int threadCount() const;
+  void checkVertices(// Return value.
+		     VertexSeq &vertices);
+  // Visit the checks in parallel with one visitor per thread.
+  void visitMaxSkewChecks(std::vector<MaxSkewCheckVisitor*> &visitors);
   void visitMaxSkewChecks(Vertex *vertex,
 			  MaxSkewCheckVisitor *visitor);
 
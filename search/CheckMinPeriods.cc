@@ -15,6 +15,7 @@
 // along with this program.  If not, see <https://www.gnu.org/licenses/>.
 
 #include "Machine.hh"
+#include "ThreadForEach.hh"
 #include "DisallowCopyAssign.hh"
 #include "Liberty.hh"
 #include "Network.hh"
@@ -57,20 +58,33 @@ CheckMinPeriods::clear()
   checks_.deleteContentsClear();
 }
 
+int
+CheckMinPeriods::threadCount() const
+{
+  ThreadPool *thread_pool = sta_->threadPool();
+  return thread_pool ? thread_pool->threadCount() : 1;
+}
+
+// Only violating checks are copied. With max_count each thread keeps
+// the max_count worst violators.
 class MinPeriodViolatorsVisitor : public MinPeriodCheckVisitor
 {
 public:
-  MinPeriodViolatorsVisitor(MinPeriodCheckSeq &checks);
+  MinPeriodViolatorsVisitor(size_t max_count,
+			    MinPeriodCheckSeq &checks);
   virtual void visit(MinPeriodCheck &check,
 		     StaState *sta);
 
 private:
   DISALLOW_COPY_AND_ASSIGN(MinPeriodViolatorsVisitor);
 
+  size_t max_count_;
   MinPeriodCheckSeq &checks_;
 };
 
-MinPeriodViolatorsVisitor::MinPeriodViolatorsVisitor(MinPeriodCheckSeq &checks):
+MinPeriodViolatorsVisitor::MinPeriodViolatorsVisitor(size_t max_count,
+						     MinPeriodCheckSeq &checks):
+  max_count_(max_count),
   checks_(checks)
 {
 }
@@ -79,32 +93,59 @@ void
 MinPeriodViolatorsVisitor::visit(MinPeriodCheck &check,
 				 StaState *sta)
 {
-  if (fuzzyLess(check.slack(sta), 0.0))
+  if (fuzzyLess(check.slack(sta), 0.0)) {
     checks_.push_back(check.copy());
+    if (max_count_ > 0
+	&& checks_.size() >= max_count_ * 2)
+      sortDeleteTail(checks_, max_count_, MinPeriodSlackLess(sta));
+  }
 }
 
 MinPeriodCheckSeq &
-CheckMinPeriods::violations()
+CheckMinPeriods::violations(size_t max_count)
 {
   clear();
-  MinPeriodViolatorsVisitor visitor(checks_);
-  visitMinPeriodChecks(&visitor);
-  sort(checks_, MinPeriodSlackLess(sta_));
+  int thread_count = threadCount();
+  std::vector<MinPeriodCheckSeq> thread_checks(thread_count);
+  std::vector<MinPeriodCheckVisitor*> visitors(thread_count);
+  for (int i = 0; i < thread_count; i++)
+    visitors[i] = new MinPeriodViolatorsVisitor(max_count, thread_checks[i]);
+  visitMinPeriodChecks(visitors);
+  for (int i = 0; i < thread_count; i++) {
+    MinPeriodCheckSeq &checks = thread_checks[i];
+    checks_.insert(checks_.end(), checks.begin(), checks.end());
+    delete visitors[i];
+  }
+  sortDeleteTail(checks_, max_count, MinPeriodSlackLess(sta_));
   return checks_;
 }
 
 void
-CheckMinPeriods::visitMinPeriodChecks(MinPeriodCheckVisitor *visitor)
+CheckMinPeriods::checkVertices(// Return value.
+			       VertexSeq &vertices)
 {
   Graph *graph = sta_->graph();
   VertexIterator vertex_iter(graph);
   while (vertex_iter.hasNext()) {
     Vertex *vertex = vertex_iter.next();
     if (isClkEnd(vertex, graph))
-      visitMinPeriodChecks(vertex, visitor);
+      vertices.push_back(vertex);
   }
 }
 
+void
+CheckMinPeriods::visitMinPeriodChecks(std::vector<MinPeriodCheckVisitor*> &visitors)
+{
+  VertexSeq vertices;
+  checkVertices(vertices);
+  forEachChunk(vertices.size(), sta_->threadPool(),
+	       [&] (size_t begin, size_t end, int thread_index) {
+		 MinPeriodCheckVisitor *visitor = visitors[thread_index];
+		 for (size_t i = begin; i < end; i++)
+		   visitMinPeriodChecks(vertices[i], visitor);
+	       });
+}
+
 void
 CheckMinPeriods::visitMinPeriodChecks(Vertex *vertex,
 				      MinPeriodCheckVisitor *visitor)
@@ -171,12 +212,35 @@ MinPeriodCheck *
 CheckMinPeriods::minSlackCheck()
 {
   clear();
-  MinPeriodSlackVisitor visitor;
-  visitMinPeriodChecks(&visitor);
-  MinPeriodCheck *check = visitor.minSlackCheck();
+  int thread_count = threadCount();
+  std::vector<MinPeriodSlackVisitor*> slack_visitors(thread_count);
+  std::vector<MinPeriodCheckVisitor*> visitors(thread_count);
+  for (int i = 0; i < thread_count; i++) {
+    slack_visitors[i] = new MinPeriodSlackVisitor;
+    visitors[i] = slack_visitors[i];
+  }
+  visitMinPeriodChecks(visitors);
+  // Ties are broken by pin and clock names so the result does not
+  // depend on how vertices were divided between threads.
+  MinPeriodSlackLess slack_less(sta_);
+  MinPeriodCheck *min_check = nullptr;
+  for (MinPeriodSlackVisitor *visitor : slack_visitors) {
+    MinPeriodCheck *check = visitor->minSlackCheck();
+    if (check) {
+      if (min_check == nullptr)
+	min_check = check;
+      else if (slack_less(check, min_check)) {
+	delete min_check;
+	min_check = check;
+      }
+      else
+	delete check;
+    }
+    delete visitor;
+  }
   // Save check for cleanup.
-  checks_.push_back(check);
-  return check;
+  checks_.push_back(min_check);
+  return min_check;
 }
 
 ////////////////////////////////////////////////////////////////
@@ -17,6 +17,7 @@
 #ifndef STA_MIN_PERIOD_H
 #define STA_MIN_PERIOD_H
 
+#include <vector>
 #include "DisallowCopyAssign.hh"
 #include "StaState.hh"
 #include "NetworkClass.hh"
@@ -35,12 +36,18 @@ public:
   explicit CheckMinPeriods(StaState *sta);
   ~CheckMinPeriods();
   void clear();
-  MinPeriodCheckSeq &violations();
+  // All violating min period checks.
+  // max_count > 0 returns the max_count checks with the least slack.
+  MinPeriodCheckSeq &violations(size_t max_count);
   // Min period check with the least slack.
   MinPeriodCheck *minSlackCheck();
 
 protected:
-  void visitMinPeriodChecks(MinPeriodCheckVisitor *visitor);
+  int threadCount() const;
+  void checkVertices(// Return value.
+		     VertexSeq &vertices);
+  // Visit the checks in parallel with one visitor per thread.
+  void visitMinPeriodChecks(std::vector<MinPeriodCheckVisitor*> &visitors);
   void visitMinPeriodChecks(Vertex *vertex,
 			    MinPeriodCheckVisitor *visitor);
 
@@ -15,6 +15,7 @@
 // along with this program.  If not, see <https://www.gnu.org/licenses/>.
 
 #include "Machine.hh"
+#include "ThreadForEach.hh"
 #include "Debug.hh"
 #include "DisallowCopyAssign.hh"
 #include "TimingRole.hh"
@@ -74,6 +75,13 @@ CheckMinPulseWidths::clear()
   checks_.deleteContentsClear();
 }
 
+int
+CheckMinPulseWidths::threadCount() const
+{
+  ThreadPool *thread_pool = sta_->threadPool();
+  return thread_pool ? thread_pool->threadCount() : 1;
+}
+
 ////////////////////////////////////////////////////////////////
 
 class MinPulseWidthChecksVisitor : public MinPulseWidthCheckVisitor
@@ -114,8 +122,17 @@ MinPulseWidthCheckSeq &
 CheckMinPulseWidths::check(const Corner *corner)
 {
   clear();
-  MinPulseWidthChecksVisitor visitor(corner, checks_);
-  visitMinPulseWidthChecks(&visitor);
+  int thread_count = threadCount();
+  std::vector<MinPulseWidthCheckSeq> thread_checks(thread_count);
+  std::vector<MinPulseWidthCheckVisitor*> visitors(thread_count);
+  for (int i = 0; i < thread_count; i++)
+    visitors[i] = new MinPulseWidthChecksVisitor(corner, thread_checks[i]);
+  visitMinPulseWidthChecks(visitors);
+  for (int i = 0; i < thread_count; i++) {
+    MinPulseWidthCheckSeq &checks = thread_checks[i];
+    checks_.insert(checks_.end(), checks.begin(), checks.end());
+    delete visitors[i];
+  }
   sort(checks_, MinPulseWidthSlackLess(sta_));
   return checks_;
 }
@@ -139,10 +156,14 @@ CheckMinPulseWidths::check(PinSeq *pins,
 
 ////////////////////////////////////////////////////////////////
 
+// Only violating checks are copied. With max_count each thread keeps
+// the max_count worst violators so a design with lots of violations
+// does not collect all of them.
 class MinPulseWidthViolatorsVisitor : public MinPulseWidthCheckVisitor
 {
 public:
   explicit MinPulseWidthViolatorsVisitor(const Corner *corner,
+					 size_t max_count,
 					 MinPulseWidthCheckSeq &checks);
   virtual void visit(MinPulseWidthCheck &check,
 		     const StaState *sta);
@@ -151,13 +172,16 @@ private:
   DISALLOW_COPY_AND_ASSIGN(MinPulseWidthViolatorsVisitor);
 
   const Corner *corner_;
+  size_t max_count_;
   MinPulseWidthCheckSeq &checks_;
 };
 
 MinPulseWidthViolatorsVisitor::
 MinPulseWidthViolatorsVisitor(const Corner *corner,
+			      size_t max_count,
 			      MinPulseWidthCheckSeq &checks) :
   corner_(corner),
+  max_count_(max_count),
   checks_(checks)
 {
 }
@@ -166,21 +190,35 @@ void
 MinPulseWidthViolatorsVisitor::visit(MinPulseWidthCheck &check,
 				     const StaState *sta)
 {
-  if (fuzzyLess(check.slack(sta), 0.0)
-      && (corner_ == nullptr
-	  || check.corner(sta) == corner_)) {
+  if ((corner_ == nullptr
+       || check.corner(sta) == corner_)
+      && fuzzyLess(check.slack(sta), 0.0)) {
     MinPulseWidthCheck *copy = new MinPulseWidthCheck(check.openPath());
     checks_.push_back(copy);
+    if (max_count_ > 0
+	&& checks_.size() >= max_count_ * 2)
+      sortDeleteTail(checks_, max_count_, MinPulseWidthSlackLess(sta));
   }
 }
 
 MinPulseWidthCheckSeq &
-CheckMinPulseWidths::violations(const Corner *corner)
+CheckMinPulseWidths::violations(const Corner *corner,
+				size_t max_count)
 {
   clear();
-  MinPulseWidthViolatorsVisitor visitor(corner, checks_);
-  visitMinPulseWidthChecks(&visitor);
-  sort(checks_, MinPulseWidthSlackLess(sta_));
+  int thread_count = threadCount();
+  std::vector<MinPulseWidthCheckSeq> thread_checks(thread_count);
+  std::vector<MinPulseWidthCheckVisitor*> visitors(thread_count);
+  for (int i = 0; i < thread_count; i++)
+    visitors[i] = new MinPulseWidthViolatorsVisitor(corner, max_count,
+						    thread_checks[i]);
+  visitMinPulseWidthChecks(visitors);
+  for (int i = 0; i < thread_count; i++) {
+    MinPulseWidthCheckSeq &checks = thread_checks[i];
+    checks_.insert(checks_.end(), checks.begin(), checks.end());
+    delete visitors[i];
+  }
+  sortDeleteTail(checks_, max_count, MinPulseWidthSlackLess(sta_));
   return checks_;
 }
 
@@ -233,31 +271,70 @@ MinPulseWidthCheck *
 CheckMinPulseWidths::minSlackCheck(const Corner *corner)
 {
   clear();
-  MinPulseWidthSlackVisitor visitor(corner);
-  visitMinPulseWidthChecks(&visitor);
-  MinPulseWidthCheck *check = visitor.minSlackCheck();
+  int thread_count = threadCount();
+  std::vector<MinPulseWidthSlackVisitor*> slack_visitors(thread_count);
+  std::vector<MinPulseWidthCheckVisitor*> visitors(thread_count);
+  for (int i = 0; i < thread_count; i++) {
+    slack_visitors[i] = new MinPulseWidthSlackVisitor(corner);
+    visitors[i] = slack_visitors[i];
+  }
+  visitMinPulseWidthChecks(visitors);
+  // The slack comparison breaks ties by name so the merged result
+  // does not depend on how vertices were divided between threads.
+  MinPulseWidthSlackLess slack_less(sta_);
+  MinPulseWidthCheck *min_check = nullptr;
+  for (MinPulseWidthSlackVisitor *visitor : slack_visitors) {
+    MinPulseWidthCheck *check = visitor->minSlackCheck();
+    if (check) {
+      if (min_check == nullptr)
+	min_check = check;
+      else if (slack_less(check, min_check)) {
+	delete min_check;
+	min_check = check;
+      }
+      else
+	delete check;
+    }
+    delete visitor;
+  }
   // Save check for cleanup.
-  checks_.push_back(check);
-  return check;
+  checks_.push_back(min_check);
+  return min_check;
 }
 
 void
-CheckMinPulseWidths::
-visitMinPulseWidthChecks(MinPulseWidthCheckVisitor *visitor)
+CheckMinPulseWidths::checkVertices(// Return value.
+				   VertexSeq &vertices)
 {
   Graph *graph = sta_->graph();
-  Debug *debug = sta_->debug();
-  Network *sdc_network = sta_->network();
   VertexIterator vertex_iter(graph);
   while (vertex_iter.hasNext()) {
     Vertex *vertex = vertex_iter.next();
-    if (isClkEnd(vertex, graph)) {
-      debugPrint1(debug, "mpw", 1, "check mpw %s\n", vertex->name(sdc_network));
-      visitMinPulseWidthChecks(vertex, visitor);
-    }
+    if (isClkEnd(vertex, graph))
+      vertices.push_back(vertex);
   }
 }
 
+void
+CheckMinPulseWidths::
+visitMinPulseWidthChecks(std::vector<MinPulseWidthCheckVisitor*> &visitors)
+{
+  Debug *debug = sta_->debug();
+  Network *sdc_network = sta_->network();
+  VertexSeq vertices;
+  checkVertices(vertices);
+  forEachChunk(vertices.size(), sta_->threadPool(),
+	       [&] (size_t begin, size_t end, int thread_index) {
+		 MinPulseWidthCheckVisitor *visitor = visitors[thread_index];
+		 for (size_t i = begin; i < end; i++) {
+		   Vertex *vertex = vertices[i];
+		   debugPrint1(debug, "mpw", 1, "check mpw %s\n",
+			       vertex->name(sdc_network));
+		   visitMinPulseWidthChecks(vertex, visitor);
+		 }
+	       });
+}
+
 void
 CheckMinPulseWidths::
 visitMinPulseWidthChecks(Vertex *vertex,
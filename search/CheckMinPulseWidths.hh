@@ -17,7 +17,9 @@
 #ifndef STA_MIN_PULSE_WIDTH_H
 #define STA_MIN_PULSE_WIDTH_H
 
+#include <vector>
 #include "DisallowCopyAssign.hh"
+#include "GraphClass.hh"
 #include "SdcClass.hh"
 #include "SearchClass.hh"
 #include "StaState.hh"
@@ -44,13 +46,19 @@ public:
   MinPulseWidthCheckSeq &check(const Corner *corner);
   // All violating min pulse width checks.
   // corner=nullptr checks all corners.
-  MinPulseWidthCheckSeq &violations(const Corner *corner);
+  // max_count > 0 returns the max_count checks with the least slack.
+  MinPulseWidthCheckSeq &violations(const Corner *corner,
+				    size_t max_count);
   // Min pulse width check with the least slack.
   // corner=nullptr checks all corners.
   MinPulseWidthCheck *minSlackCheck(const Corner *corner);
 
 protected:
-  void visitMinPulseWidthChecks(MinPulseWidthCheckVisitor *visitor);
+  int threadCount() const;
+  void checkVertices(// Return value.
+		     VertexSeq &vertices);
+  // Visit the checks in parallel with one visitor per thread.
+  void visitMinPulseWidthChecks(std::vector<MinPulseWidthCheckVisitor*> &visitors);
   void visitMinPulseWidthChecks(Vertex *vertex,
 				MinPulseWidthCheckVisitor *visitor);
 
@@ -14,6 +14,7 @@
 // You should have received a copy of the GNU General Public License
 // along with this program.  If not, see <https://www.gnu.org/licenses/>.
 
+#include <algorithm>
 #include "Machine.hh"
 #include "Fuzzy.hh"
 #include "Liberty.hh"
@@ -25,55 +26,38 @@
 #include "Corner.hh"
 #include "PathVertex.hh"
 #include "Search.hh"
+#include "ThreadForEach.hh"
 #include "CheckSlewLimits.hh"
 
 namespace sta {
 
-class PinSlewLimitSlackLess
+// Smaller slacks first.
+class PinSlewSlackLess
 {
 public:
-  PinSlewLimitSlackLess(const Corner *corner,
-			const MinMax *min_max,
-			CheckSlewLimits *check_slew_limit,
-			const StaState *sta);
-  bool operator()(Pin *pin1,
-		  Pin *pin2) const;
+  explicit PinSlewSlackLess(const Network *network);
+  bool operator()(const PinSlewSlack &pin_slack1,
+		  const PinSlewSlack &pin_slack2) const;
 
 private:
-  const Corner *corner_;
-  const MinMax *min_max_;
-  CheckSlewLimits *check_slew_limit_;
-  const StaState *sta_;
-
+  const Network *network_;
 };
 
-PinSlewLimitSlackLess::PinSlewLimitSlackLess(const Corner *corner,
-					     const MinMax *min_max,
-					     CheckSlewLimits *check_slew_limit,
-					     const StaState *sta) :
-  corner_(corner),
-  min_max_(min_max),
-  check_slew_limit_(check_slew_limit),
-  sta_(sta)
+PinSlewSlackLess::PinSlewSlackLess(const Network *network) :
+  network_(network)
 {
 }
 
 bool
-PinSlewLimitSlackLess::operator()(Pin *pin1,
-				  Pin *pin2) const
+PinSlewSlackLess::operator()(const PinSlewSlack &pin_slack1,
+			     const PinSlewSlack &pin_slack2) const
 {
-  const Corner *corner1, *corner2;
-  const TransRiseFall *tr1, *tr2;
-  Slew slew1, slew2;
-  float limit1, limit2, slack1, slack2;
-  check_slew_limit_->checkSlews(pin1, corner_, min_max_,
-				corner1, tr1, slew1, limit1, slack1);
-  check_slew_limit_->checkSlews(pin2, corner_, min_max_,
-				corner2, tr2, slew2, limit2, slack2);
+  float slack1 = pin_slack1.second;
+  float slack2 = pin_slack2.second;
   return slack1 < slack2
     || (fuzzyEqual(slack1, slack2)
 	// Break ties for the sake of regression stability.
-	&& sta_->network()->pinLess(pin1, pin2));
+	&& network_->pinLess(pin_slack1.first, pin_slack2.first));
 }
 
 ////////////////////////////////////////////////////////////////
@@ -156,12 +140,18 @@ CheckSlewLimits::checkSlews1(Vertex *vertex,
 			     float &limit,
 			     float &slack) const
 {
+  // The clock domains are only needed for clock slew limits and are
+  // found once for both transitions.
+  ClockSet clks;
+  if (sta_->sdc()->haveClkSlewLimits())
+    clockDomains(vertex, clks);
   TransRiseFallIterator tr_iter;
   while (tr_iter.hasNext()) {
     TransRiseFall *tr1 = tr_iter.next();
     float limit1;
     bool limit1_exists;
-    findLimit(vertex->pin(), vertex, tr1, min_max, limit1, limit1_exists);
+    findLimit(vertex->pin(), vertex, clks, tr1, min_max,
+	      limit1, limit1_exists);
     if (limit1_exists) {
       checkSlew(vertex, corner1, min_max, tr1, limit1,
 		corner, tr, slew, slack, limit);
@@ -172,6 +162,7 @@ CheckSlewLimits::checkSlews1(Vertex *vertex,
 void
 CheckSlewLimits::findLimit(const Pin *pin,
 			   const Vertex *vertex,
+			   const ClockSet &clks,
 			   const TransRiseFall *tr,
 			   const MinMax *min_max,
 			   // Return values.
@@ -180,37 +171,75 @@ CheckSlewLimits::findLimit(const Pin *pin,
 			
 {
   limit1_exists = false;
-  const Network *network = sta_->network();
   Sdc *sdc = sta_->sdc();
-  bool is_clk = sta_->search()->isClock(vertex);
   // Look for clock slew limits.
-  ClockSet clks;
-  clockDomains(vertex, clks);
-  ClockSet::Iterator clk_iter(clks);
-  while (clk_iter.hasNext()) {
-    Clock *clk = clk_iter.next();
-    PathClkOrData clk_data = is_clk ? PathClkOrData::clk : PathClkOrData::data;
-    float clk_limit;
-    bool clk_limit_exists;
-    sdc->slewLimit(clk, tr, clk_data, min_max,
-			   clk_limit, clk_limit_exists);
-    if (clk_limit_exists
+  if (!clks.empty()) {
+    bool is_clk = sta_->search()->isClock(vertex);
+    ClockSet::ConstIterator clk_iter(clks);
+    while (clk_iter.hasNext()) {
+      Clock *clk = clk_iter.next();
+      PathClkOrData clk_data = is_clk ? PathClkOrData::clk : PathClkOrData::data;
+      float clk_limit;
+      bool clk_limit_exists;
+      sdc->slewLimit(clk, tr, clk_data, min_max,
+		     clk_limit, clk_limit_exists);
+      if (clk_limit_exists
+	  && (!limit1_exists
+	      || min_max->compare(limit1, clk_limit))) {
+	// Use the tightest clock limit.
+	limit1 = clk_limit;
+	limit1_exists = true;
+      }
+    }
+  }
+  if (!limit1_exists)
+    findLimit(pin, min_max, limit1, limit1_exists);
+}
+
+// Limit without clock slew limits.
+void
+CheckSlewLimits::findLimit(const Pin *pin,
+			   const MinMax *min_max,
+			   // Return values.
+			   float &limit1,
+			   bool &limit1_exists) const
+{
+  const Network *network = sta_->network();
+  Sdc *sdc = sta_->sdc();
+  // Default to top ("design") limit.
+  limit1_exists = top_limit_exists_;
+  limit1 = top_limit_;
+  if (network->isTopLevelPort(pin)) {
+    Port *port = network->port(pin);
+    float port_limit;
+    bool port_limit_exists;
+    sdc->slewLimit(port, min_max, port_limit, port_limit_exists);
+    // Use the tightest limit.
+    if (port_limit_exists
 	&& (!limit1_exists
-	    || min_max->compare(limit1, clk_limit))) {
-      // Use the tightest clock limit.
-      limit1 = clk_limit;
+	    || min_max->compare(limit1, port_limit))) {
+      limit1 = port_limit;
       limit1_exists = true;
     }
   }
-  if (!limit1_exists) {
-    // Default to top ("design") limit.
-    limit1_exists = top_limit_exists_;
-    limit1 = top_limit_;
-    if (network->isTopLevelPort(pin)) {
-      Port *port = network->port(pin);
-      float port_limit;
-      bool port_limit_exists;
-      sdc->slewLimit(port, min_max, port_limit, port_limit_exists);
+  else {
+    float pin_limit;
+    bool pin_limit_exists;
+    sdc->slewLimit(pin, min_max,
+		   pin_limit, pin_limit_exists);
+    // Use the tightest limit.
+    if (pin_limit_exists
+	&& (!limit1_exists
+	    || min_max->compare(limit1, pin_limit))) {
+      limit1 = pin_limit;
+      limit1_exists = true;
+    }
+
+    float port_limit;
+    bool port_limit_exists;
+    LibertyPort *port = network->libertyPort(pin);
+    if (port) {
+      port->slewLimit(min_max, port_limit, port_limit_exists);
       // Use the tightest limit.
       if (port_limit_exists
 	  && (!limit1_exists
@@ -219,33 +248,6 @@ CheckSlewLimits::findLimit(const Pin *pin,
 	limit1_exists = true;
       }
     }
-    else {
-      float pin_limit;
-      bool pin_limit_exists;
-      sdc->slewLimit(pin, min_max,
-			     pin_limit, pin_limit_exists);
-      // Use the tightest limit.
-      if (pin_limit_exists
-	  && (!limit1_exists
-	      || min_max->compare(limit1, pin_limit))) {
-	limit1 = pin_limit;
-	limit1_exists = true;
-      }
-
-      float port_limit;
-      bool port_limit_exists;
-      LibertyPort *port = network->libertyPort(pin);
-      if (port) {
-	port->slewLimit(min_max, port_limit, port_limit_exists);
-	// Use the tightest limit.
-	if (port_limit_exists
-	    && (!limit1_exists
-		|| min_max->compare(limit1, port_limit))) {
-	  limit1 = port_limit;
-	  limit1_exists = true;
-	}
-      }
-    }
   }
 }
 
@@ -294,30 +296,64 @@ CheckSlewLimits::checkSlew(Vertex *vertex,
   }
 }
 
-PinSeq *
-CheckSlewLimits::pinSlewLimitViolations(const Corner *corner,
-					const MinMax *min_max)
+void
+CheckSlewLimits::checkInstances(// Return value.
+				InstanceSeq &insts) const
 {
-  init(min_max);
   const Network *network = sta_->network();
-  PinSeq *violators = new PinSeq;
   LeafInstanceIterator *inst_iter = network->leafInstanceIterator();
-  while (inst_iter->hasNext()) {
-    Instance *inst = inst_iter->next();
-    pinSlewLimitViolations(inst, corner, min_max, violators);
-  }
+  while (inst_iter->hasNext())
+    insts.push_back(inst_iter->next());
   delete inst_iter;
   // Check top level ports.
-  pinSlewLimitViolations(network->topInstance(), corner, min_max, violators);
-  sort(violators, PinSlewLimitSlackLess(corner, min_max, this, sta_));
-  return violators;
+  insts.push_back(network->topInstance());
+}
+
+// Instances are checked in parallel with a violator list per thread.
+// The slacks are kept with the pins so sorting does not check the
+// slews again.
+PinSeq *
+CheckSlewLimits::pinSlewLimitViolations(const Corner *corner,
+					const MinMax *min_max,
+					size_t max_count)
+{
+  init(min_max);
+  InstanceSeq insts;
+  checkInstances(insts);
+  ThreadPool *thread_pool = sta_->threadPool();
+  int thread_count = thread_pool ? thread_pool->threadCount() : 1;
+  std::vector<PinSlewSlackSeq> thread_violators(thread_count);
+  forEachChunk(insts.size(), thread_pool,
+	       [&] (size_t begin, size_t end, int thread_index) {
+		 for (size_t i = begin; i < end; i++)
+		   pinSlewLimitViolations(insts[i], corner, min_max,
+					  thread_violators[thread_index]);
+	       });
+  PinSlewSlackSeq violators;
+  for (PinSlewSlackSeq &violators1 : thread_violators)
+    violators.insert(violators.end(), violators1.begin(), violators1.end());
+
+  PinSlewSlackLess slack_less(sta_->network());
+  if (max_count > 0 && max_count < violators.size()) {
+    std::partial_sort(violators.begin(), violators.begin() + max_count,
+		      violators.end(), slack_less);
+    violators.resize(max_count);
+  }
+  else
+    std::sort(violators.begin(), violators.end(), slack_less);
+  PinSeq *violator_pins = new PinSeq;
+  violator_pins->reserve(violators.size());
+  for (PinSlewSlack &violator : violators)
+    violator_pins->push_back(violator.first);
+  return violator_pins;
 }
 
 void
 CheckSlewLimits::pinSlewLimitViolations(Instance *inst,
 					const Corner *corner,
 					const MinMax *min_max,
-					PinSeq *violators)
+					// Return value.
+					PinSlewSlackSeq &violators)
 {
   const Network *network = sta_->network();
   InstancePinIterator *pin_iter = network->pinIterator(inst);
@@ -329,31 +365,57 @@ CheckSlewLimits::pinSlewLimitViolations(Instance *inst,
     float limit, slack;
     checkSlews(pin, corner, min_max, corner1, tr, slew, limit, slack );
     if (tr && slack < 0.0)
-      violators->push_back(pin);
+      violators.push_back(PinSlewSlack(pin, slack));
   }
   delete pin_iter;
 }
 
+// Each thread finds its min slack pin. Ties go to the pin found first
+// in instance order like a serial scan.
 Pin *
 CheckSlewLimits::pinMinSlewLimitSlack(const Corner *corner,
 				      const MinMax *min_max)
 {
   init(min_max);
-  const Network *network = sta_->network();
-  Pin *min_slack_pin = 0;
+  InstanceSeq insts;
+  checkInstances(insts);
+  ThreadPool *thread_pool = sta_->threadPool();
+  int thread_count = thread_pool ? thread_pool->threadCount() : 1;
+  std::vector<Pin*> thread_pins(thread_count, nullptr);
+  std::vector<float> thread_slacks(thread_count, MinMax::min()->initValue());
+  std::vector<size_t> thread_inst_indices(thread_count, 0);
+  forEachChunk(insts.size(), thread_pool,
+	       [&] (size_t begin, size_t end, int thread_index) {
+		 Pin *&min_slack_pin = thread_pins[thread_index];
+		 float &min_slack = thread_slacks[thread_index];
+		 for (size_t i = begin; i < end; i++) {
+		   Pin *prev_pin = min_slack_pin;
+		   pinMinSlewLimitSlack(insts[i], corner, min_max,
+					min_slack_pin, min_slack);
+		   if (min_slack_pin != prev_pin)
+		     thread_inst_indices[thread_index] = i;
+		 }
+	       });
+  Pin *min_slack_pin = nullptr;
   float min_slack = MinMax::min()->initValue();
-  LeafInstanceIterator *inst_iter = network->leafInstanceIterator();
-  while (inst_iter->hasNext()) {
-    Instance *inst = inst_iter->next();
-    pinMinSlewLimitSlack(inst, corner, min_max, min_slack_pin, min_slack);
+  size_t min_inst_index = 0;
+  for (int i = 0; i < thread_count; i++) {
+    Pin *pin = thread_pins[i];
+    if (pin) {
+      float slack = thread_slacks[i];
+      size_t inst_index = thread_inst_indices[i];
+      if (min_slack_pin == nullptr
+	  || slack < min_slack
+	  || (slack == min_slack
+	      && inst_index < min_inst_index)) {
+	min_slack_pin = pin;
+	min_slack = slack;
+	min_inst_index = inst_index;
+      }
+    }
   }
-  delete inst_iter;
-  // Check top level ports.
-  pinMinSlewLimitSlack(network->topInstance(), corner, min_max,
-		       min_slack_pin, min_slack);
   return min_slack_pin;
 }
-
 void
 CheckSlewLimits::pinMinSlewLimitSlack(Instance *inst,
 				      const Corner *corner,
@@ -17,9 +17,12 @@
 #ifndef STA_CHECK_SLEW_LIMIT_H
 #define STA_CHECK_SLEW_LIMIT_H
 
+#include <utility>
+#include <vector>
 #include "MinMax.hh"
 #include "Transition.hh"
 #include "NetworkClass.hh"
+#include "SdcClass.hh"
 #include "GraphClass.hh"
 #include "Delay.hh"
 
@@ -28,6 +31,9 @@ namespace sta {
 class StaState;
 class DcalcAnalysisPt;
 
+typedef std::pair<Pin*, float> PinSlewSlack;
+typedef std::vector<PinSlewSlack> PinSlewSlackSeq;
+
 class CheckSlewLimits
 {
 public:
@@ -46,8 +52,11 @@ public:
 		  float &limit,
 		  float &slack) const;
   // corner=nullptr checks all corners.
+  // max_count=0 returns all violators, otherwise the max_count
+  // violators with the smallest slacks.
   PinSeq *pinSlewLimitViolations(const Corner *corner,
-				 const MinMax *min_max);
+				 const MinMax *min_max,
+				 size_t max_count);
   // corner=nullptr checks all corners.
   Pin *pinMinSlewLimitSlack(const Corner *corner,
 			    const MinMax *min_max);
@@ -82,17 +91,28 @@ protected:
 		 Slew &slew,
 		 float &slack,
 		 float &limit) const;
+  // clks are the vertex clock domains.
   void findLimit(const Pin *pin,
 		 const Vertex *vertex,
+		 const ClockSet &clks,
 		 const TransRiseFall *tr,
 		 const MinMax *min_max,
 		 // Return values.
 		 float &limit1,
 		 bool &limit1_exists) const;
+  void findLimit(const Pin *pin,
+		 const MinMax *min_max,
+		 // Return values.
+		 float &limit1,
+		 bool &limit1_exists) const;
+  // Leaf instances followed by the top instance (ports).
+  void checkInstances(// Return value.
+		      InstanceSeq &insts) const;
   void pinSlewLimitViolations(Instance *inst,
 			      const Corner *corner,
 			      const MinMax *min_max,
-			      PinSeq *violators);
+			      // Return value.
+			      PinSlewSlackSeq &violators);
   void pinMinSlewLimitSlack(Instance *inst,
 			    const Corner *corner,
 			    const MinMax *min_max,
@@ -16,6 +16,7 @@
 
 #include "Machine.hh"
 #include "Error.hh"
+#include "ThreadForEach.hh"
 #include "PortDirection.hh"
 #include "TimingRole.hh"
 #include "Network.hh"
@@ -37,7 +38,8 @@ namespace sta {
 using std::string;
 
 CheckTiming::CheckTiming(StaState *sta) :
-  StaState(sta)
+  StaState(sta),
+  verbose_(true)
 {
 }
 
@@ -71,9 +73,11 @@ CheckTiming::check(bool no_input_delay,
 		   bool reg_no_clks,
 		   bool unconstrained_endpoints,
 		   bool loops,
-		   bool generated_clks)
+		   bool generated_clks,
+		   bool verbose)
 {
   clear();
+  verbose_ = verbose;
   if (no_input_delay)
     checkNoInputDelay();
   if (no_output_delay)
@@ -152,18 +156,31 @@ void
 CheckTiming::checkRegClks(bool reg_multiple_clks,
 			  bool reg_no_clks)
 {
-  PinSet no_clk_pins, multiple_clk_pins;
+  VertexSeq reg_clk_vertices;
   VertexSet::ConstIterator reg_clk_iter(graph_->regClkVertices());
-  while (reg_clk_iter.hasNext()) {
-    Vertex *vertex = reg_clk_iter.next();
-    Pin *pin = vertex->pin();
-    ClockSet clks;
-    search_->clocks(vertex, clks);
-    if (reg_no_clks && clks.empty())
-      no_clk_pins.insert(pin);
-    if (reg_multiple_clks && clks.size() > 1)
-      multiple_clk_pins.insert(pin);
-  }
+  while (reg_clk_iter.hasNext())
+    reg_clk_vertices.push_back(reg_clk_iter.next());
+
+  int thread_count = checkThreadCount();
+  std::vector<PinSeq> thread_no_clk_pins(thread_count);
+  std::vector<PinSeq> thread_multiple_clk_pins(thread_count);
+  forEachChunk(reg_clk_vertices.size(), thread_pool_,
+	       [&] (size_t begin, size_t end, int thread_index) {
+		 ClockSet clks;
+		 for (size_t i = begin; i < end; i++) {
+		   Vertex *vertex = reg_clk_vertices[i];
+		   Pin *pin = vertex->pin();
+		   clks.clear();
+		   search_->clocks(vertex, clks);
+		   if (reg_no_clks && clks.empty())
+		     thread_no_clk_pins[thread_index].push_back(pin);
+		   if (reg_multiple_clks && clks.size() > 1)
+		     thread_multiple_clk_pins[thread_index].push_back(pin);
+		 }
+	       });
+  PinSet no_clk_pins, multiple_clk_pins;
+  insertThreadPins(thread_no_clk_pins, no_clk_pins);
+  insertThreadPins(thread_multiple_clk_pins, multiple_clk_pins);
   pushPinErrors("Warning: There %is %d unclocked register/latch pin%s.",
 		no_clk_pins);
   pushPinErrors("Warning: There %is %d register/latch pin%s with multiple clocks.",
@@ -192,7 +209,7 @@ CheckTiming::checkLoops()
     error->push_back(stringCopy(error_msg.c_str()));
 
     GraphLoopSeq::Iterator loop_iter2(loops);
-    while (loop_iter2.hasNext()) {
+    while (verbose_ && loop_iter2.hasNext()) {
       GraphLoop *loop = loop_iter2.next();
       if (loop->isCombinational()) {
 	EdgeSeq::Iterator edge_iter(loop->edges());
@@ -230,6 +247,8 @@ CheckTiming::checkUnconstrainedEndpoints()
 void
 CheckTiming::checkUnconstraintedOutputs(PinSet &unconstrained_ends)
 {
+  PinSet max_delay_pins;
+  findMaxDelayToPins(max_delay_pins);
   Instance *top_inst = network_->topInstance();
   InstancePinIterator *pin_iter = network_->pinIterator(top_inst);
   while (pin_iter->hasNext()) {
@@ -238,7 +257,7 @@ CheckTiming::checkUnconstraintedOutputs(PinSet &unconstrained_ends)
     if (dir->isAnyOutput()
 	&& !((hasClkedDepature(pin)
 	      && hasClkedArrival(graph_->pinLoadVertex(pin)))
-	     || hasMaxDelay(pin)))
+	     || max_delay_pins.hasKey(pin)))
       unconstrained_ends.insert(pin);
   }
   delete pin_iter;
@@ -256,9 +275,10 @@ CheckTiming::hasClkedDepature(Pin *pin)
   return false;
 }
 
-// Check for max delay exception that ends at pin.
-bool
-CheckTiming::hasMaxDelay(Pin *pin)
+// Pins that max delay exceptions end at.
+// Find them once instead of searching the exceptions for each output.
+void
+CheckTiming::findMaxDelayToPins(PinSet &pins)
 {
   ExceptionPathSet *exceptions = sdc_->exceptions();
   ExceptionPathSet::Iterator exception_iter(exceptions);
@@ -268,32 +288,57 @@ CheckTiming::hasMaxDelay(Pin *pin)
     if (exception->isPathDelay()
 	&& exception->minMax() == MinMaxAll::max()
 	&& to
-	&& to->hasPins()
-	&& to->pins()->hasKey(pin))
-      return true;
+	&& to->hasPins())
+      pins.insertSet(to->pins());
   }
-  return false;
 }
 
+// Vertices are checked in parallel with a list of unconstrained pins
+// for each thread.
 void
 CheckTiming::checkUnconstrainedSetups(PinSet &unconstrained_ends)
 {
+  VertexSeq vertices;
   VertexIterator vertex_iter(graph_);
-  while (vertex_iter.hasNext()) {
-    Vertex *vertex = vertex_iter.next();
-    VertexInEdgeIterator edge_iter(vertex, graph_);
-    while (edge_iter.hasNext()) {
-      Edge *edge = edge_iter.next();
-      if (edge->role() == TimingRole::setup()
-	  && (!search_->isClock(edge->from(graph_))
-	       || !hasClkedArrival(edge->to(graph_)))) {
-	unconstrained_ends.insert(vertex->pin());
-	break;
-      }
-    }
+  while (vertex_iter.hasNext())
+    vertices.push_back(vertex_iter.next());
+
+  std::vector<PinSeq> thread_ends(checkThreadCount());
+  forEachChunk(vertices.size(), thread_pool_,
+	       [&] (size_t begin, size_t end, int thread_index) {
+		 for (size_t i = begin; i < end; i++) {
+		   Vertex *vertex = vertices[i];
+		   VertexInEdgeIterator edge_iter(vertex, graph_);
+		   while (edge_iter.hasNext()) {
+		     Edge *edge = edge_iter.next();
+		     if (edge->role() == TimingRole::setup()
+			 && (!search_->isClock(edge->from(graph_))
+			     || !hasClkedArrival(edge->to(graph_)))) {
+		       thread_ends[thread_index].push_back(vertex->pin());
+		       break;
+		     }
+		   }
+		 }
+	       });
+  insertThreadPins(thread_ends, unconstrained_ends);
+}
+
+void
+CheckTiming::insertThreadPins(std::vector<PinSeq> &thread_pins,
+			      PinSet &pins)
+{
+  for (PinSeq &pins1 : thread_pins) {
+    for (Pin *pin : pins1)
+      pins.insert(pin);
   }
 }
 
+int
+CheckTiming::checkThreadCount() const
+{
+  return thread_pool_ ? thread_pool_->threadCount() : 1;
+}
+
 bool
 CheckTiming::hasClkedArrival(Vertex *vertex)
 {
@@ -351,15 +396,17 @@ CheckTiming::pushPinErrors(const char *msg,
     // Copy the error strings because the error deletes them when it
     // is deleted.
     error->push_back(stringCopy(error_msg.c_str()));
-    // Sort the error pins so the output is independent of the order
-    // the the errors are discovered.
-    PinSeq pin_seq;
-    sortPinSet(&pins, network_, pin_seq);
-    PinSeq::Iterator pin_iter(pin_seq);
-    while (pin_iter.hasNext()) {
-      const Pin *pin = pin_iter.next();
-      const char *pin_name = stringCopy(sdc_network_->pathName(pin));
-      error->push_back(pin_name);
+    if (verbose_) {
+      // Sort the error pins so the output is independent of the order
+      // the the errors are discovered.
+      PinSeq pin_seq;
+      sortPinSet(&pins, network_, pin_seq);
+      PinSeq::Iterator pin_iter(pin_seq);
+      while (pin_iter.hasNext()) {
+	const Pin *pin = pin_iter.next();
+	const char *pin_name = stringCopy(sdc_network_->pathName(pin));
+	error->push_back(pin_name);
+      }
     }
     errors_.push_back(error);
   }
@@ -376,15 +423,17 @@ CheckTiming::pushClkErrors(const char *msg,
     // Copy the error strings because the error deletes them when it
     // is deleted.
     error->push_back(stringCopy(error_msg.c_str()));
-    // Sort the error clks so the output is independent of the order
-    // the the errors are discovered.
-    ClockSeq clk_seq;
-    sortClockSet(&clks, clk_seq);
-    ClockSeq::Iterator clk_iter(clk_seq);
-    while (clk_iter.hasNext()) {
-      const Clock *clk = clk_iter.next();
-      const char *clk_name = stringCopy(clk->name());
-      error->push_back(clk_name);
+    if (verbose_) {
+      // Sort the error clks so the output is independent of the order
+      // the the errors are discovered.
+      ClockSeq clk_seq;
+      sortClockSet(&clks, clk_seq);
+      ClockSeq::Iterator clk_iter(clk_seq);
+      while (clk_iter.hasNext()) {
+	const Clock *clk = clk_iter.next();
+	const char *clk_name = stringCopy(clk->name());
+	error->push_back(clk_name);
+      }
     }
     errors_.push_back(error);
   }
@@ -17,10 +17,12 @@
 #ifndef STA_CHECK_TIMING_H
 #define STA_CHECK_TIMING_H
 
+#include <vector>
 #include "DisallowCopyAssign.hh"
 #include "Vector.hh"
 #include "StringSeq.hh"
 #include "NetworkClass.hh"
+#include "GraphClass.hh"
 #include "StaState.hh"
 
 namespace sta {
@@ -39,7 +41,10 @@ public:
 		       bool reg_no_clks,
 		       bool unconstrained_endpoints,
 		       bool loops,
-		       bool generated_clks);
+		       bool generated_clks,
+		       // Errors only have the message with the count
+		       // when verbose is false.
+		       bool verbose);
 
 protected:
   void clear();
@@ -56,7 +61,10 @@ protected:
   void checkLoops();
   bool hasClkedDepature(Pin *pin);
   bool hasClkedCheck(Vertex *vertex);
-  bool hasMaxDelay(Pin *pin);
+  void findMaxDelayToPins(PinSet &pins);
+  void insertThreadPins(std::vector<PinSeq> &thread_pins,
+			PinSet &pins);
+  int checkThreadCount() const;
   void checkGeneratedClocks();
   void pushPinErrors(const char *msg,
 		     PinSet &pins);
@@ -67,6 +75,7 @@ protected:
 		     string &error_msg);
 
   CheckErrorSeq errors_;
+  bool verbose_;
 
 private:
   DISALLOW_COPY_AND_ASSIGN(CheckTiming);
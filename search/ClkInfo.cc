@@ -28,8 +28,7 @@ namespace sta {
 
 static bool
 clkInfoEqual(const ClkInfo *clk_info1,
-	     const ClkInfo *clk_info2,
-	     const StaState *sta);
+	     const ClkInfo *clk_info2);
 static int
 clkInfoCmp(const ClkInfo *clk_info1,
 	   const ClkInfo *clk_info2,
@@ -74,11 +73,11 @@ ClkInfo::findHash(const StaState *sta)
   if (clk_edge_)
     hashIncr(hash_, clk_edge_->index());
 
-  const Network *network = sta->network();
+  const Graph *graph = sta->graph();
   if (clk_src_)
-    hashIncr(hash_, network->vertexIndex(clk_src_));
+    hashIncr(hash_, graph->pinVertexIndex(clk_src_));
   if (gen_clk_src_)
-    hashIncr(hash_, network->vertexIndex(gen_clk_src_));
+    hashIncr(hash_, graph->pinVertexIndex(gen_clk_src_));
   hashIncr(hash_, crprClkVertexIndex());
   if (uncertainties_) {
     float uncertainty;
@@ -187,33 +186,25 @@ ClkInfoHash::operator()(const ClkInfo *clk_info)
 
 ////////////////////////////////////////////////////////////////
 
-ClkInfoEqual::ClkInfoEqual(const StaState *sta) :
-  sta_(sta)
-{
-}
-
 bool
 ClkInfoEqual::operator()(const ClkInfo *clk_info1,
 			 const ClkInfo *clk_info2)
 {
-  return clkInfoEqual(clk_info1, clk_info2, sta_);
+  return clkInfoEqual(clk_info1, clk_info2);
 }
 
 static bool
 clkInfoEqual(const ClkInfo *clk_info1,
-	     const ClkInfo *clk_info2,
-	     const StaState *sta)
+	     const ClkInfo *clk_info2)
 {
-  bool crpr_on = sta->sdc()->crprActive();
   ClockUncertainties *uncertainties1 = clk_info1->uncertainties();
   ClockUncertainties *uncertainties2 = clk_info2->uncertainties();
   return clk_info1->clkEdge() == clk_info2->clkEdge()
     && clk_info1->pathAPIndex() == clk_info2->pathAPIndex()
     && clk_info1->clkSrc() == clk_info2->clkSrc()
     && clk_info1->genClkSrc() == clk_info2->genClkSrc()
-    && (!crpr_on
-	|| (PathVertexRep::equal(clk_info1->crprClkPath(),
-				 clk_info2->crprClkPath())))
+    && PathVertexRep::equal(clk_info1->crprClkPath(),
+			    clk_info2->crprClkPath())
     && ((uncertainties1 == nullptr
 	 && uncertainties2 == nullptr)
 	|| (uncertainties1 && uncertainties2
@@ -109,15 +109,13 @@ public:
   Hash operator()(const ClkInfo *clk_info);
 };
 
+// Clock infos only have crpr clock paths when crpr is active, so the
+// paths are always compared.
 class ClkInfoEqual
 {
 public:
-  ClkInfoEqual(const StaState *sta);
   bool operator()(const ClkInfo *clk_info1,
 		  const ClkInfo *clk_info2);
-
-protected:
-  const StaState *sta_;
 };
 
 } // namespace
@@ -16,6 +16,7 @@
 
 #include <cmath> // abs
 #include "Machine.hh"
+#include "ThreadForEach.hh"
 #include "DisallowCopyAssign.hh"
 #include "Report.hh"
 #include "Debug.hh"
@@ -25,7 +26,6 @@
 #include "Network.hh"
 #include "Graph.hh"
 #include "Sdc.hh"
-#include "Bfs.hh"
 #include "PathVertex.hh"
 #include "StaState.hh"
 #include "PathAnalysisPt.hh"
@@ -44,6 +44,7 @@ public:
   ClkSkew();
   ClkSkew(PathVertex *src_path,
 	  PathVertex *tgt_path,
+	  size_t src_index,
 	  StaState *sta);
   ClkSkew(ClkSkew &clk_skew);
   void copy(ClkSkew &clk_skew);
@@ -53,23 +54,30 @@ public:
   float tgtLatency(StaState *sta);
   Crpr crpr(StaState *sta);
   float skew() const { return skew_; }
+  // Index of the source register in the search order.
+  size_t srcIndex() const { return src_index_; }
+  bool skewGreater(const ClkSkew *clk_skew) const;
 
 private:
   PathVertex src_path_;
   PathVertex tgt_path_;
+  size_t src_index_;
   float skew_;
 
   DISALLOW_COPY_AND_ASSIGN(ClkSkew);
 };
 
 ClkSkew::ClkSkew() :
+  src_index_(0),
   skew_(0.0)
 {
 }
 
 ClkSkew::ClkSkew(PathVertex *src_path,
 		 PathVertex *tgt_path,
-		 StaState *sta)
+		 size_t src_index,
+		 StaState *sta) :
+  src_index_(src_index)
 {
   src_path_.copy(src_path);
   tgt_path_.copy(tgt_path);
@@ -86,9 +94,20 @@ ClkSkew::copy(ClkSkew &clk_skew)
 {
   src_path_.copy(clk_skew.src_path_);
   tgt_path_.copy(clk_skew.tgt_path_);
+  src_index_ = clk_skew.src_index_;
   skew_ = clk_skew.skew_;
 }
 
+// Equal skews go to the first source register in search order so the
+// result does not depend on how the registers are split between threads.
+bool
+ClkSkew::skewGreater(const ClkSkew *clk_skew) const
+{
+  return fuzzyGreater(skew_, clk_skew->skew_)
+    || (fuzzyEqual(skew_, clk_skew->skew_)
+	&& src_index_ < clk_skew->src_index_);
+}
+
 float
 ClkSkew::srcLatency(StaState *sta)
 {
@@ -166,29 +185,69 @@ ClkSkews::reportClkSkew(ClockSet *clks,
   skews.deleteContents();
 }
 
+// Source registers are searched in parallel with a skew map per thread.
+// The CRPR common clock pessimism cache is shared by the threads.
 void
 ClkSkews::findClkSkew(ClockSet *clks,
 		      const Corner *corner,
 		      const SetupHold *setup_hold,
 		      ClkSkewMap &skews)
-{	      
+{
+  VertexSeq src_vertices;
   VertexSet::ConstIterator reg_clk_iter(graph_->regClkVertices());
-  while (reg_clk_iter.hasNext()) {
-    Vertex *src_vertex = reg_clk_iter.next();
-    if (hasClkPaths(src_vertex, clks)) {
-      VertexOutEdgeIterator edge_iter(src_vertex, graph_);
-      while (edge_iter.hasNext()) {
-	Edge *edge = edge_iter.next();
-	if (edge->role()->genericRole() == TimingRole::regClkToQ()) {
-	  Vertex *q_vertex = edge->to(graph_);
-	  TransRiseFall *tr = edge->timingArcSet()->isRisingFallingEdge();
-	  TransRiseFallBoth *src_tr = tr
-	    ? tr->asRiseFallBoth()
-	    : TransRiseFallBoth::riseFall();
-	  findClkSkewFrom(src_vertex, q_vertex, src_tr, clks,
-			  corner, setup_hold, skews);
-	}
+  while (reg_clk_iter.hasNext())
+    src_vertices.push_back(reg_clk_iter.next());
+
+  int thread_count = thread_pool_ ? thread_pool_->threadCount() : 1;
+  std::vector<ClkSkewMap> thread_skews(thread_count);
+  forEachChunk(src_vertices.size(), thread_pool_,
+	       [&] (size_t begin, size_t end, int thread_index) {
+		 for (size_t i = begin; i < end; i++) {
+		   Vertex *src_vertex = src_vertices[i];
+		   if (hasClkPaths(src_vertex, clks))
+		     findClkSkewFrom(src_vertex, i, clks, corner, setup_hold,
+				     thread_skews[thread_index]);
+		 }
+	       });
+
+  for (ClkSkewMap &skews1 : thread_skews) {
+    ClkSkewMap::Iterator skew_iter(skews1);
+    while (skew_iter.hasNext()) {
+      Clock *clk;
+      ClkSkew *clk_skew1;
+      skew_iter.next(clk, clk_skew1);
+      ClkSkew *clk_skew = skews.findKey(clk);
+      if (clk_skew == nullptr)
+	skews[clk] = clk_skew1;
+      else if (clk_skew1->skewGreater(clk_skew)) {
+	delete clk_skew;
+	skews[clk] = clk_skew1;
       }
+      else
+	delete clk_skew1;
+    }
+  }
+}
+
+void
+ClkSkews::findClkSkewFrom(Vertex *src_vertex,
+			  size_t src_index,
+			  ClockSet *clks,
+			  const Corner *corner,
+			  const SetupHold *setup_hold,
+			  ClkSkewMap &skews)
+{
+  VertexOutEdgeIterator edge_iter(src_vertex, graph_);
+  while (edge_iter.hasNext()) {
+    Edge *edge = edge_iter.next();
+    if (edge->role()->genericRole() == TimingRole::regClkToQ()) {
+      Vertex *q_vertex = edge->to(graph_);
+      TransRiseFall *tr = edge->timingArcSet()->isRisingFallingEdge();
+      TransRiseFallBoth *src_tr = tr
+	? tr->asRiseFallBoth()
+	: TransRiseFallBoth::riseFall();
+      findClkSkewFrom(src_vertex, src_index, q_vertex, src_tr, clks,
+		      corner, setup_hold, skews);
     }
   }
 }
@@ -209,6 +268,7 @@ ClkSkews::hasClkPaths(Vertex *vertex,
 
 void
 ClkSkews::findClkSkewFrom(Vertex *src_vertex,
+			  size_t src_index,
 			  Vertex *q_vertex,
 			  TransRiseFallBoth *src_tr,
 			  ClockSet *clks,
@@ -235,7 +295,7 @@ ClkSkews::findClkSkewFrom(Vertex *src_vertex,
 	TransRiseFallBoth *tgt_tr = tgt_tr1
 	  ? tgt_tr1->asRiseFallBoth()
 	  : TransRiseFallBoth::riseFall();
-	findClkSkew(src_vertex, src_tr, tgt_vertex, tgt_tr,
+	findClkSkew(src_vertex, src_index, src_tr, tgt_vertex, tgt_tr,
 		    clks, corner, setup_hold, skews);
       }
     }
@@ -244,6 +304,7 @@ ClkSkews::findClkSkewFrom(Vertex *src_vertex,
 
 void
 ClkSkews::findClkSkew(Vertex *src_vertex,
+		      size_t src_index,
 		      TransRiseFallBoth *src_tr,
 		      Vertex *tgt_vertex,
 		      TransRiseFallBoth *tgt_tr,
@@ -272,7 +333,7 @@ ClkSkews::findClkSkew(Vertex *src_vertex,
 	      && tgt_tr->matches(tgt_path->transition(this))
 	      && tgt_path->minMax(this) == tgt_min_max
 	      && tgt_path->pathAnalysisPt(this)->corner() == src_corner) {
-	    ClkSkew probe(src_path, tgt_path, this);
+	    ClkSkew probe(src_path, tgt_path, src_index, this);
 	    ClkSkew *clk_skew = skews.findKey(src_clk);
 	    debugPrint8(debug_, "clk_skew", 2, "%s %s %s -> %s %s %s crpr = %s skew = %s\n",
 			network_->pathName(src_path->pin(this)),
@@ -287,7 +348,7 @@ ClkSkews::findClkSkew(Vertex *src_vertex,
 	      clk_skew = new ClkSkew(probe);
 	      skews[src_clk] = clk_skew;
 	    }
-	    else if (fuzzyGreater(probe.skew(), clk_skew->skew()))
+	    else if (probe.skewGreater(clk_skew))
 	      clk_skew->copy(probe);
 	  }
 	}
@@ -318,6 +379,8 @@ FanOutSrchPred::searchThru(Edge *edge)
     || role == TimingRole::tristateDisable();
 }
 
+// Depth first search with a local visited set instead of a
+// BfsIterator so threads can search at the same time.
 void
 ClkSkews::findFanout(Vertex *from,
 		     // Return value.
@@ -326,16 +389,31 @@ ClkSkews::findFanout(Vertex *from,
   debugPrint1(debug_, "fanout", 1, "%s\n",
 	      from->name(sdc_network_));
   FanOutSrchPred pred(this);
-  BfsFwdIterator fanout_iter(BfsIndex::other, &pred, this);
-  fanout_iter.enqueue(from);
-  while (fanout_iter.hasNext()) {
-    Vertex *fanout = fanout_iter.next();
+  VertexSet visited;
+  VertexSeq stack;
+  visited.insert(from);
+  stack.push_back(from);
+  while (!stack.empty()) {
+    Vertex *fanout = stack.back();
+    stack.pop_back();
     if (fanout->hasChecks()) {
       debugPrint1(debug_, "fanout", 1, " endpoint %s\n",
 		  fanout->name(sdc_network_));
       endpoints.insert(fanout);
     }
-    fanout_iter.enqueueAdjacentVertices(fanout);
+    if (pred.searchFrom(fanout)) {
+      VertexOutEdgeIterator edge_iter(fanout, graph_);
+      while (edge_iter.hasNext()) {
+	Edge *edge = edge_iter.next();
+	Vertex *to_vertex = edge->to(graph_);
+	if (pred.searchThru(edge)
+	    && pred.searchTo(to_vertex)
+	    && !visited.hasKey(to_vertex)) {
+	  visited.insert(to_vertex);
+	  stack.push_back(to_vertex);
+	}
+      }
+    }
   }
 }
 
@@ -45,6 +45,13 @@ protected:
   bool hasClkPaths(Vertex *vertex,
 		   ClockSet *clks);
   void findClkSkewFrom(Vertex *src_vertex,
+		       size_t src_index,
+		       ClockSet *clks,
+		       const Corner *corner,
+		       const SetupHold *setup_hold,
+		       ClkSkewMap &skews);
+  void findClkSkewFrom(Vertex *src_vertex,
+		       size_t src_index,
 		       Vertex *q_vertex,
 		       TransRiseFallBoth *src_tr,
 		       ClockSet *clks,
@@ -52,6 +59,7 @@ protected:
 		       const SetupHold *setup_hold,
 		       ClkSkewMap &skews);
   void findClkSkew(Vertex *src_vertex,
+		   size_t src_index,
 		   TransRiseFallBoth *src_tr,
 		   Vertex *tgt_vertex,
 		   TransRiseFallBoth *tgt_tr,
@@ -24,7 +24,9 @@
 namespace sta {
 
 Corners::Corners(StaState *sta) :
-  StaState(sta)
+  StaState(sta),
+  share_dcalc_(true),
+  dcalc_inputs_changed_(false)
 {
 }
 
@@ -137,6 +139,22 @@ Corners::makeParasiticAnalysisPtsMinMax()
   }
 }
 
+void
+Corners::copyParasiticAnalysisPts(Corners *corners)
+{
+  parasitic_analysis_pts_.deleteContentsClear();
+  ParasiticAnalysisPtSeq::Iterator ap_iter(corners->parasiticAnalysisPts());
+  while (ap_iter.hasNext()) {
+    ParasiticAnalysisPt *ap = ap_iter.next();
+    ParasiticAnalysisPt *ap_copy = new ParasiticAnalysisPt(ap->name(),
+							   ap->index(),
+							   ap->minMax());
+    ap_copy->setCouplingCapFactor(ap->couplingCapFactor());
+    parasitic_analysis_pts_.push_back(ap_copy);
+  }
+  updateCornerParasiticAnalysisPts();
+}
+
 void
 Corners::updateCornerParasiticAnalysisPts()
 {
@@ -157,15 +175,102 @@ Corners::makeAnalysisPts()
 {
   dcalc_analysis_pts_.deleteContentsClear();
   path_analysis_pts_.deleteContentsClear();
+  dcalc_inputs_changed_ = false;
 
+  CornerSeq dcalc_corners;
   CornerSeq::Iterator corner_iter(corners_);
   while (corner_iter.hasNext()) {
     Corner *corner = corner_iter.next();
-    makeDcalcAnalysisPts(corner);
+    Corner *dcalc_corner = findDcalcCorner(corner, dcalc_corners);
+    corner->dcalc_corner_ = dcalc_corner;
+    if (dcalc_corner == corner) {
+      makeDcalcAnalysisPts(corner);
+      dcalc_corners.push_back(corner);
+    }
+    else
+      corner->dcalc_analysis_pts_ = dcalc_corner->dcalc_analysis_pts_;
     makePathAnalysisPts(corner);
   }
 }
 
+void
+Corners::dcalcInputsChanged()
+{
+  dcalc_inputs_changed_ = true;
+}
+
+bool
+Corners::dcalcSharingChanged()
+{
+  if (dcalc_inputs_changed_) {
+    dcalc_inputs_changed_ = false;
+    CornerSeq dcalc_corners;
+    bool changed = false;
+    CornerSeq::Iterator corner_iter(corners_);
+    while (corner_iter.hasNext()) {
+      Corner *corner = corner_iter.next();
+      Corner *dcalc_corner = findDcalcCorner(corner, dcalc_corners);
+      if (dcalc_corner == corner)
+	dcalc_corners.push_back(corner);
+      if (dcalc_corner != corner->dcalc_corner_)
+	changed = true;
+    }
+    return changed;
+  }
+  else
+    return false;
+}
+
+void
+Corners::updateDcalcSharing()
+{
+  makeAnalysisPts();
+}
+
+bool
+Corners::unshareDcalcAnalysisPts()
+{
+  if (share_dcalc_) {
+    share_dcalc_ = false;
+    CornerSeq::Iterator corner_iter(corners_);
+    while (corner_iter.hasNext()) {
+      Corner *corner = corner_iter.next();
+      if (corner->dcalc_corner_ != corner)
+	return true;
+    }
+  }
+  return false;
+}
+
+// Find an earlier corner with the same dcalc inputs.
+Corner *
+Corners::findDcalcCorner(Corner *corner,
+			 const CornerSeq &dcalc_corners) const
+{
+  if (share_dcalc_) {
+    for (Corner *dcalc_corner : dcalc_corners) {
+      if (dcalcInputsEqual(dcalc_corner, corner))
+	return dcalc_corner;
+    }
+  }
+  return corner;
+}
+
+bool
+Corners::dcalcInputsEqual(Corner *corner1,
+			  Corner *corner2) const
+{
+  MinMaxIterator mm_iter;
+  while (mm_iter.hasNext()) {
+    MinMax *min_max = mm_iter.next();
+    LibertySeq *libs1 = corner1->libertyLibraries(min_max);
+    LibertySeq *libs2 = corner2->libertyLibraries(min_max);
+    if (*libs1 != *libs2)
+      return false;
+  }
+  return sdc_->netWireCapsEqual(corner1, corner2);
+}
+
 void
 Corners::makeDcalcAnalysisPts(Corner *corner)
 {
@@ -338,7 +443,8 @@ Corner::Corner(const char *name,
 	       int index) :
   name_(stringCopy(name)),
   index_(index),
-  path_analysis_pts_(MinMax::index_count)
+  path_analysis_pts_(MinMax::index_count),
+  dcalc_corner_(this)
 {
 }
 
@@ -54,9 +54,24 @@ public:
   void makeCorners(StringSet *corner_names);
   void analysisTypeChanged();
   void operatingConditionsChanged();
+  // Corners with the same liberty libraries and net wire caps
+  // (set_load -corner) share dcalc analysis points so their delays
+  // are only found once. Derates are applied by search for each
+  // path analysis point.
+  void dcalcInputsChanged();
+  // True if the corners sharing dcalc analysis points are out of date.
+  bool dcalcSharingChanged();
+  void updateDcalcSharing();
+  // Stop sharing dcalc analysis points so delays can be annotated
+  // for each corner. Return true if the analysis points need to be
+  // remade.
+  bool unshareDcalcAnalysisPts();
 
   void makeParasiticAnalysisPtsSingle();
   void makeParasiticAnalysisPtsMinMax();
+  // Make parasitic analysis points matching corners without deleting
+  // the parasitics so parasitics can be shared with other corners.
+  void copyParasiticAnalysisPts(Corners *corners);
   int parasiticAnalysisPtCount() const;
   ParasiticAnalysisPtSeq &parasiticAnalysisPts();
 
@@ -73,6 +88,10 @@ protected:
   void makeAnalysisPts();
   void updateCornerParasiticAnalysisPts();
   void makeDcalcAnalysisPts(Corner *corner);
+  Corner *findDcalcCorner(Corner *corner,
+			  const CornerSeq &dcalc_corners) const;
+  bool dcalcInputsEqual(Corner *corner1,
+			Corner *corner2) const;
   DcalcAnalysisPt *makeDcalcAnalysisPt(Corner *corner,
 				       const MinMax *min_max,
 				       const MinMax *check_clk_slew_min_max);
@@ -89,6 +108,8 @@ private:
   ParasiticAnalysisPtSeq parasitic_analysis_pts_;
   DcalcAnalysisPtSeq dcalc_analysis_pts_;
   PathAnalysisPtSeq path_analysis_pts_;
+  bool share_dcalc_;
+  bool dcalc_inputs_changed_;
 
   friend class CornerIterator;
   DISALLOW_COPY_AND_ASSIGN(Corners);
@@ -110,6 +131,8 @@ public:
 		  const MinMax *min_max);
   LibertySeq *libertyLibraries(const MinMax *min_max);
   int libertyIndex(const MinMax *min_max) const;
+  // Corner with the dcalc analysis points used by this corner.
+  Corner *dcalcCorner() const { return dcalc_corner_; }
 
 protected:
   void setParasiticAnalysisPtcount(int ap_count);
@@ -125,6 +148,7 @@ private:
   DcalcAnalysisPtSeq dcalc_analysis_pts_;
   PathAnalysisPtSeq path_analysis_pts_;
   LibertySeq liberty_[MinMax::index_count];
+  Corner *dcalc_corner_;
 
   friend class Corners;
   DISALLOW_COPY_AND_ASSIGN(Corner);
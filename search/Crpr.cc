@@ -17,6 +17,7 @@
 #include <cmath> // abs
 #include <stdio.h>
 #include "Machine.hh"
+#include "Mutex.hh"
 #include "Debug.hh"
 #include "Vector.hh"
 #include "Network.hh"
@@ -40,11 +41,73 @@ namespace sta {
 using std::min;
 using std::abs;
 
+CrprCacheKey::CrprCacheKey(VertexIndex src_vertex_index,
+			   TagIndex src_tag_index,
+			   VertexIndex tgt_vertex_index,
+			   TagIndex tgt_tag_index,
+			   bool same_pin) :
+  src_vertex_index_(src_vertex_index),
+  src_tag_index_(src_tag_index),
+  tgt_vertex_index_(tgt_vertex_index),
+  tgt_tag_index_(tgt_tag_index),
+  same_pin_(same_pin)
+{
+}
+
+bool
+CrprCacheKey::operator==(const CrprCacheKey &key) const
+{
+  return src_vertex_index_ == key.src_vertex_index_
+    && src_tag_index_ == key.src_tag_index_
+    && tgt_vertex_index_ == key.tgt_vertex_index_
+    && tgt_tag_index_ == key.tgt_tag_index_
+    && same_pin_ == key.same_pin_;
+}
+
+size_t
+CrprCacheKeyHash::operator()(const CrprCacheKey &key) const
+{
+  size_t hash = key.src_vertex_index_;
+  hash = hash * 31 + key.src_tag_index_;
+  hash = hash * 31 + key.tgt_vertex_index_;
+  hash = hash * 31 + key.tgt_tag_index_;
+  return hash * 2 + key.same_pin_;
+}
+
+CrprCacheValue::CrprCacheValue() :
+  crpr_(0.0),
+  crpr_pin_(nullptr),
+  generation_(0)
+{
+}
+
+CrprCacheValue::CrprCacheValue(Crpr crpr,
+			       Pin *crpr_pin,
+			       unsigned generation) :
+  crpr_(crpr),
+  crpr_pin_(crpr_pin),
+  generation_(generation)
+{
+}
+
+////////////////////////////////////////////////////////////////
+
+// Entries are not added past this size until the cache is cleared.
+static const size_t crpr_cache_size_max = 1 << 22;
+
 CheckCrpr::CheckCrpr(StaState *sta) :
-  StaState(sta)
+  StaState(sta),
+  generation_(0)
 {
 }
 
+void
+CheckCrpr::clearCache()
+{
+  cache_.clear();
+  generation_++;
+}
+
 PathVertex *
 CheckCrpr::clkPathPrev(const PathVertex *path,
 		       PathVertex &tmp)
@@ -62,7 +125,7 @@ CheckCrpr::clkPathPrev(Vertex *vertex,
 		       int arrival_index,
 		       PathVertex &tmp)
 {
-   PathVertexRep *prevs = vertex->prevPaths();
+  PathVertexRep *prevs = vertex->prevPaths();
   if (prevs) {
     PathVertexRep *prev = &prevs[arrival_index];
     if (prev->isNull())
@@ -73,6 +136,13 @@ CheckCrpr::clkPathPrev(Vertex *vertex,
       return &tmp;
     }
   }
+  else if (!search_->prevPathStorage()) {
+    // Find the prev path from the fanin arrivals.
+    Tag *tag = search_->tagGroup(vertex)->arrivalTag(arrival_index);
+    PathVertex path(vertex, tag, arrival_index);
+    path.prevPath(this, tmp);
+    return tmp.isNull() ? nullptr : &tmp;
+  }
   else
     internalError("missing prev paths");
 }
@@ -204,6 +274,10 @@ CheckCrpr::portClkPath(const ClockEdge *clk_edge,
   }
 }
 
+// Checks that share the same clock tree branches find the same common
+// point, so the common point crpr is cached by clock path pair.
+// Clock paths from different clock sources depend on the generated
+// clock source paths and are not cached.
 void
 CheckCrpr::findCrpr(const PathVertex *src_clk_path,
 		    const PathVertex *tgt_clk_path,
@@ -211,6 +285,45 @@ CheckCrpr::findCrpr(const PathVertex *src_clk_path,
 		    // Return values.
 		    Crpr &crpr,
 		    Pin *&crpr_pin)
+{
+  if (src_clk_path->clkInfo(this)->clkSrc()
+      == tgt_clk_path->clkInfo(this)->clkSrc()) {
+    CrprCacheKey key(src_clk_path->vertexIndex(this),
+		     src_clk_path->tagIndex(this),
+		     tgt_clk_path->vertexIndex(this),
+		     tgt_clk_path->tagIndex(this),
+		     same_pin);
+    // Read the generation before the clock paths so an entry found
+    // with arrivals that change during the search is stale.
+    unsigned generation = generation_;
+    {
+      UniqueLock lock(cache_.lock(key));
+      CrprCacheValue value;
+      bool exists;
+      cache_.findKey(key, value, exists);
+      if (exists && value.generation_ == generation) {
+	crpr = value.crpr_;
+	crpr_pin = value.crpr_pin_;
+	return;
+      }
+    }
+    findCrprUncached(src_clk_path, tgt_clk_path, same_pin, crpr, crpr_pin);
+    if (cache_.size() < crpr_cache_size_max) {
+      UniqueLock lock(cache_.lock(key));
+      cache_.insert(key, CrprCacheValue(crpr, crpr_pin, generation));
+    }
+  }
+  else
+    findCrprUncached(src_clk_path, tgt_clk_path, same_pin, crpr, crpr_pin);
+}
+
+void
+CheckCrpr::findCrprUncached(const PathVertex *src_clk_path,
+			    const PathVertex *tgt_clk_path,
+			    bool same_pin,
+			    // Return values.
+			    Crpr &crpr,
+			    Pin *&crpr_pin)
 {
   crpr = 0.0;
   crpr_pin = nullptr;
@@ -17,7 +17,10 @@
 #ifndef STA_CRPR_H
 #define STA_CRPR_H
 
+#include <atomic>
 #include "DisallowCopyAssign.hh"
+#include "StripedMap.hh"
+#include "GraphClass.hh"
 #include "SdcClass.hh"
 #include "SearchClass.hh"
 
@@ -25,11 +28,55 @@ namespace sta {
 
 class CrprPaths;
 
+// Source and target clock paths of a common point search.
+class CrprCacheKey
+{
+public:
+  CrprCacheKey(VertexIndex src_vertex_index,
+	       TagIndex src_tag_index,
+	       VertexIndex tgt_vertex_index,
+	       TagIndex tgt_tag_index,
+	       bool same_pin);
+  bool operator==(const CrprCacheKey &key) const;
+
+  VertexIndex src_vertex_index_;
+  TagIndex src_tag_index_;
+  VertexIndex tgt_vertex_index_;
+  TagIndex tgt_tag_index_;
+  bool same_pin_;
+};
+
+class CrprCacheKeyHash
+{
+public:
+  size_t operator()(const CrprCacheKey &key) const;
+};
+
+class CrprCacheValue
+{
+public:
+  CrprCacheValue();
+  CrprCacheValue(Crpr crpr,
+		 Pin *crpr_pin,
+		 unsigned generation);
+
+  Crpr crpr_;
+  Pin *crpr_pin_;
+  // Clock arrival generation the crpr was found with.
+  unsigned generation_;
+};
+
+typedef StripedMap<CrprCacheKey, CrprCacheValue, CrprCacheKeyHash> CrprCache;
+
 // Clock Reconvergence Pessimism Removal.
 class CheckCrpr : public StaState
 {
 public:
   explicit CheckCrpr(StaState *sta);
+  // Called by the search threads when the arrivals of a clock network
+  // vertex change, which makes the cached common points stale.
+  void clkArrivalsChanged() { generation_++; }
+  void clearCache();
 
   // Find the maximum possible crpr (clock min/max delta delay) for path.
   Arrival maxCrpr(ClkInfo *clk_info);
@@ -83,6 +130,12 @@ private:
 		// Return values.
 		Crpr &crpr,
 		Pin *&common_pin);
+  void findCrprUncached(const PathVertex *src_clk_path,
+			const PathVertex *tgt_clk_path,
+			bool same_pin,
+			// Return values.
+			Crpr &crpr,
+			Pin *&common_pin);
   void portClkPath(const ClockEdge *clk_edge,
 		   const Pin *clk_src_pin,
 		   const PathAnalysisPt *path_ap,
@@ -91,6 +144,10 @@ private:
   Crpr findCrpr1(const PathVertex *src_clk_path,
 		 const PathVertex *tgt_clk_path);
   float crprArrivalDiff(const PathVertex *path);
+
+  // Common point crpr of clock path pairs that share a clock source.
+  CrprCache cache_;
+  std::atomic<unsigned> generation_;
 };
 
 } // namespace
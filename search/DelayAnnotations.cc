@@ -0,0 +1,571 @@
+// OpenSTA, Static Timing Analyzer
+// Copyright (c) 2019, Parallax Software, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <algorithm>
+#include <string>
+#include <vector>
+#include "Machine.hh"
+#include "DisallowCopyAssign.hh"
+#include "Report.hh"
+#include "Error.hh"
+#include "MappedFile.hh"
+#include "ThreadPool.hh"
+#include "ThreadForEach.hh"
+#include "Transition.hh"
+#include "TimingRole.hh"
+#include "TimingArc.hh"
+#include "Network.hh"
+#include "Graph.hh"
+#include "Corner.hh"
+#include "Sta.hh"
+#include "DelayAnnotations.hh"
+
+namespace sta {
+
+using std::string;
+using std::vector;
+
+static const char delay_annotations_magic[] = "STADLYA1";
+
+// File layout:
+//  header
+//  names         char [names_size]      null terminated pin path names
+//  name offsets  uint64 [vertex_count]
+//  bidirect drvr uint8 [vertex_count]
+//  slews         float [vertex_count][tr][ap]
+//  edges         DelayAnnotationEdge [edge_count]
+//  delays        float [arc_count][ap]
+// Each section is padded to a multiple of 8 bytes so the sections of a
+// mapped file can be used in place.
+class DelayAnnotationHeader
+{
+public:
+  char magic_[8];
+  uint32_t ap_count_;
+  uint32_t vertex_count_;
+  uint32_t edge_count_;
+  uint32_t arc_count_;
+  uint64_t names_size_;
+};
+
+class DelayAnnotationEdge
+{
+public:
+  uint32_t from_;
+  uint32_t to_;
+  uint32_t role_;
+  // Index of the edge among the to vertex in edges from the same
+  // from vertex.
+  uint32_t ordinal_;
+  uint32_t arc_begin_;
+  uint32_t arc_count_;
+};
+
+static size_t
+sectionPadding(size_t size)
+{
+  return (8 - size % 8) % 8;
+}
+
+// Edges between the same from/to vertices are distinguished by their
+// order in the to vertex in edges. Vertices have few in edges, unlike
+// the out edges of high fanout drivers.
+static uint32_t
+edgeOrdinal(const Edge *edge,
+	    const Vertex *from,
+	    Vertex *to,
+	    const Graph *graph)
+{
+  uint32_t ordinal = 0;
+  VertexInEdgeIterator edge_iter(to, graph);
+  while (edge_iter.hasNext()) {
+    Edge *in_edge = edge_iter.next();
+    if (in_edge == edge)
+      break;
+    if (in_edge->from(graph) == from)
+      ordinal++;
+  }
+  return ordinal;
+}
+
+class DelayAnnotationsWriter : public StaState
+{
+public:
+  DelayAnnotationsWriter(const char *filename,
+			 StaState *sta);
+  ~DelayAnnotationsWriter();
+  void write();
+
+private:
+  DISALLOW_COPY_AND_ASSIGN(DelayAnnotationsWriter);
+  void findRows();
+  void writeNames();
+  void writeSlews();
+  void writeEdges();
+  void writeDelays();
+  void writeSection(const void *data,
+		    size_t size);
+
+  const char *filename_;
+  FILE *stream_;
+  DcalcAPIndex ap_count_;
+  VertexSeq vertices_;
+  // File index of each vertex by graph vertex index.
+  vector<uint32_t> vertex_rows_;
+  vector<Edge*> edges_;
+  vector<DelayAnnotationEdge> edge_rows_;
+  size_t arc_count_;
+};
+
+DelayAnnotationsWriter::DelayAnnotationsWriter(const char *filename,
+					       StaState *sta) :
+  StaState(sta),
+  filename_(filename),
+  stream_(nullptr),
+  ap_count_(sta->corners()->dcalcAnalysisPtCount()),
+  arc_count_(0)
+{
+}
+
+DelayAnnotationsWriter::~DelayAnnotationsWriter()
+{
+  if (stream_)
+    fclose(stream_);
+}
+
+void
+DelayAnnotationsWriter::write()
+{
+  findRows();
+  stream_ = fopen(filename_, "wb");
+  if (stream_ == nullptr)
+    throw FileNotWritable(filename_);
+  writeNames();
+  writeSlews();
+  writeEdges();
+  writeDelays();
+  if (fclose(stream_) != 0) {
+    stream_ = nullptr;
+    throw FileNotWritable(filename_);
+  }
+  stream_ = nullptr;
+}
+
+void
+DelayAnnotationsWriter::findRows()
+{
+  vertex_rows_.resize(graph_->vertexIndexBound());
+  VertexIterator vertex_iter(graph_);
+  while (vertex_iter.hasNext()) {
+    Vertex *vertex = vertex_iter.next();
+    vertex_rows_[graph_->index(vertex)] = vertices_.size();
+    vertices_.push_back(vertex);
+  }
+  for (Vertex *from : vertices_) {
+    uint32_t from_row = vertex_rows_[graph_->index(from)];
+    VertexOutEdgeIterator edge_iter(from, graph_);
+    while (edge_iter.hasNext()) {
+      Edge *edge = edge_iter.next();
+      Vertex *to = edge->to(graph_);
+      DelayAnnotationEdge row;
+      row.from_ = from_row;
+      row.to_ = vertex_rows_[graph_->index(to)];
+      row.role_ = edge->role()->index();
+      row.ordinal_ = edgeOrdinal(edge, from, to, graph_);
+      row.arc_begin_ = arc_count_;
+      row.arc_count_ = edge->timingArcSet()->arcCount();
+      arc_count_ += row.arc_count_;
+      edges_.push_back(edge);
+      edge_rows_.push_back(row);
+    }
+  }
+}
+
+// Path names are found in parallel chunks that are concatenated in order.
+void
+DelayAnnotationsWriter::writeNames()
+{
+  size_t vertex_count = vertices_.size();
+  size_t chunk_count = thread_pool_ ? thread_pool_->threadCount() * 4 : 1;
+  chunk_count = std::max(std::min(chunk_count, vertex_count), size_t(1));
+  size_t chunk_size = (vertex_count + chunk_count - 1) / chunk_count;
+  vector<string> chunk_names(chunk_count);
+  vector<uint64_t> name_offsets(vertex_count);
+  vector<uint8_t> bidirect_drvrs(vertex_count);
+  forEachChunk(chunk_count, thread_pool_,
+	       [&] (size_t begin, size_t end, int) {
+		 for (size_t chunk = begin; chunk < end; chunk++) {
+		   string &names = chunk_names[chunk];
+		   size_t vertex_end = std::min((chunk + 1) * chunk_size,
+						vertex_count);
+		   for (size_t i = chunk * chunk_size; i < vertex_end; i++) {
+		     Vertex *vertex = vertices_[i];
+		     name_offsets[i] = names.size();
+		     names += network_->pathName(vertex->pin());
+		     names += '\0';
+		     bidirect_drvrs[i] = vertex->isBidirectDriver();
+		   }
+		 }
+	       });
+  uint64_t names_size = 0;
+  for (size_t chunk = 0; chunk < chunk_count; chunk++) {
+    size_t vertex_end = std::min((chunk + 1) * chunk_size, vertex_count);
+    for (size_t i = chunk * chunk_size; i < vertex_end; i++)
+      name_offsets[i] += names_size;
+    names_size += chunk_names[chunk].size();
+  }
+
+  DelayAnnotationHeader header;
+  memset(&header, 0, sizeof(header));
+  memcpy(header.magic_, delay_annotations_magic, sizeof(header.magic_));
+  header.ap_count_ = ap_count_;
+  header.vertex_count_ = vertex_count;
+  header.edge_count_ = edge_rows_.size();
+  header.arc_count_ = arc_count_;
+  header.names_size_ = names_size;
+  writeSection(&header, sizeof(header));
+  for (string &names : chunk_names) {
+    if (fwrite(names.data(), 1, names.size(), stream_) != names.size())
+      throw FileNotWritable(filename_);
+  }
+  writeSection(nullptr, names_size);
+  writeSection(name_offsets.data(), vertex_count * sizeof(uint64_t));
+  writeSection(bidirect_drvrs.data(), vertex_count);
+}
+
+void
+DelayAnnotationsWriter::writeSlews()
+{
+  size_t value_count = ap_count_ * TransRiseFall::index_count;
+  vector<float> slews(vertices_.size() * value_count);
+  forEachChunk(vertices_.size(), thread_pool_,
+	       [&] (size_t begin, size_t end, int) {
+		 for (size_t i = begin; i < end; i++) {
+		   Vertex *vertex = vertices_[i];
+		   float *vertex_slews = &slews[i * value_count];
+		   TransRiseFallIterator tr_iter;
+		   while (tr_iter.hasNext()) {
+		     TransRiseFall *tr = tr_iter.next();
+		     for (DcalcAPIndex ap = 0; ap < ap_count_; ap++)
+		       *vertex_slews++ = delayAsFloat(graph_->slew(vertex, tr,
+								   ap));
+		   }
+		 }
+	       });
+  writeSection(slews.data(), slews.size() * sizeof(float));
+}
+
+void
+DelayAnnotationsWriter::writeEdges()
+{
+  writeSection(edge_rows_.data(),
+	       edge_rows_.size() * sizeof(DelayAnnotationEdge));
+}
+
+void
+DelayAnnotationsWriter::writeDelays()
+{
+  vector<float> delays(arc_count_ * ap_count_);
+  forEachChunk(edges_.size(), thread_pool_,
+	       [&] (size_t begin, size_t end, int) {
+		 for (size_t i = begin; i < end; i++) {
+		   Edge *edge = edges_[i];
+		   float *edge_delays = &delays[edge_rows_[i].arc_begin_
+						* ap_count_];
+		   for (TimingArc *arc : edge->timingArcSet()->arcs()) {
+		     for (DcalcAPIndex ap = 0; ap < ap_count_; ap++)
+		       *edge_delays++ = delayAsFloat(graph_->arcDelay(edge, arc,
+								      ap));
+		   }
+		 }
+	       });
+  writeSection(delays.data(), delays.size() * sizeof(float));
+}
+
+// Write data (if any) and pad the section to a multiple of 8 bytes.
+void
+DelayAnnotationsWriter::writeSection(const void *data,
+				     size_t size)
+{
+  static const char padding[8] = {0};
+  if ((data && fwrite(data, 1, size, stream_) != size)
+      || fwrite(padding, 1, sectionPadding(size), stream_)
+      != sectionPadding(size))
+    throw FileNotWritable(filename_);
+}
+
+////////////////////////////////////////////////////////////////
+
+class DelayAnnotationsReader : public StaState
+{
+public:
+  DelayAnnotationsReader(const char *filename,
+			 Sta *sta);
+  bool read();
+
+private:
+  DISALLOW_COPY_AND_ASSIGN(DelayAnnotationsReader);
+  template <class T>
+  const T *section(size_t count);
+  void findVertices(const char *names,
+		    const uint64_t *name_offsets,
+		    const uint8_t *bidirect_drvrs,
+		    size_t names_size);
+  Edge *findEdge(const DelayAnnotationEdge &row);
+  void annotateSlews(const float *slews);
+  void annotateDelays(const DelayAnnotationEdge *edge_rows,
+		      size_t edge_count,
+		      size_t arc_count,
+		      const float *delays);
+
+  const char *filename_;
+  Sta *sta_;
+  MappedFile file_;
+  size_t offset_;
+  DcalcAPIndex ap_count_;
+  vector<Vertex*> vertices_;
+};
+
+DelayAnnotationsReader::DelayAnnotationsReader(const char *filename,
+					       Sta *sta) :
+  StaState(sta),
+  filename_(filename),
+  sta_(sta),
+  file_(filename),
+  offset_(0),
+  ap_count_(sta->corners()->dcalcAnalysisPtCount())
+{
+}
+
+bool
+DelayAnnotationsReader::read()
+{
+  const DelayAnnotationHeader *header = section<DelayAnnotationHeader>(1);
+  if (header == nullptr
+      || memcmp(header->magic_, delay_annotations_magic,
+		sizeof(header->magic_)) != 0) {
+    report_->error("%s is not a delay annotation file.\n", filename_);
+    return false;
+  }
+  if (header->ap_count_ != static_cast<uint32_t>(ap_count_)) {
+    report_->error("%s analysis point count %u does not match %d.\n",
+		   filename_, header->ap_count_, ap_count_);
+    return false;
+  }
+  size_t vertex_count = header->vertex_count_;
+  size_t edge_count = header->edge_count_;
+  size_t value_count = ap_count_ * TransRiseFall::index_count;
+  const char *names = section<char>(header->names_size_);
+  const uint64_t *name_offsets = section<uint64_t>(vertex_count);
+  const uint8_t *bidirect_drvrs = section<uint8_t>(vertex_count);
+  const float *slews = section<float>(vertex_count * value_count);
+  const DelayAnnotationEdge *edge_rows =
+    section<DelayAnnotationEdge>(edge_count);
+  const float *delays = section<float>(header->arc_count_ * ap_count_);
+  if (names == nullptr
+      || name_offsets == nullptr
+      || bidirect_drvrs == nullptr
+      || slews == nullptr
+      || edge_rows == nullptr
+      || delays == nullptr) {
+    report_->error("%s is truncated.\n", filename_);
+    return false;
+  }
+  vertices_.resize(vertex_count, nullptr);
+  findVertices(names, name_offsets, bidirect_drvrs, header->names_size_);
+  annotateSlews(slews);
+  annotateDelays(edge_rows, edge_count, header->arc_count_, delays);
+  return true;
+}
+
+// Return count values at the read offset and advance past them and
+// the section padding. Return nullptr if the file is too short.
+template <class T>
+const T *
+DelayAnnotationsReader::section(size_t count)
+{
+  size_t size = count * sizeof(T);
+  size_t end = offset_ + size + sectionPadding(size);
+  if (end > file_.size())
+    return nullptr;
+  const T *values = reinterpret_cast<const T*>(file_.data() + offset_);
+  offset_ = end;
+  return values;
+}
+
+// Vertices are found by pin path name in parallel.
+void
+DelayAnnotationsReader::findVertices(const char *names,
+				     const uint64_t *name_offsets,
+				     const uint8_t *bidirect_drvrs,
+				     size_t names_size)
+{
+  // Names must be terminated inside the names section.
+  if (names_size == 0 || names[names_size - 1] != '\0')
+    return;
+  size_t vertex_count = vertices_.size();
+  forEachChunk(vertex_count, thread_pool_,
+	       [&] (size_t begin, size_t end, int) {
+		 for (size_t i = begin; i < end; i++) {
+		   Vertex *vertex = nullptr;
+		   uint64_t name_offset = name_offsets[i];
+		   if (name_offset < names_size) {
+		     Pin *pin = network_->findPin(&names[name_offset]);
+		     if (pin) {
+		       Vertex *bidirect_drvr_vertex;
+		       graph_->pinVertices(pin, vertex, bidirect_drvr_vertex);
+		       if (bidirect_drvrs[i])
+			 vertex = bidirect_drvr_vertex;
+		     }
+		   }
+		   vertices_[i] = vertex;
+		 }
+	       });
+  int missing_count = std::count(vertices_.begin(), vertices_.end(), nullptr);
+  if (missing_count > 0)
+    report_->warn("%s %d pins not found.\n", filename_, missing_count);
+}
+
+// The edge row's from/to vertices and role have to match, so edges
+// with a different library timing arc set are not annotated.
+Edge *
+DelayAnnotationsReader::findEdge(const DelayAnnotationEdge &row)
+{
+  if (row.from_ < vertices_.size()
+      && row.to_ < vertices_.size()) {
+    Vertex *from = vertices_[row.from_];
+    Vertex *to = vertices_[row.to_];
+    if (from && to) {
+      uint32_t ordinal = 0;
+      VertexInEdgeIterator edge_iter(to, graph_);
+      while (edge_iter.hasNext()) {
+	Edge *edge = edge_iter.next();
+	if (edge->from(graph_) == from) {
+	  if (ordinal == row.ordinal_) {
+	    if (static_cast<uint32_t>(edge->role()->index()) == row.role_
+		&& edge->timingArcSet()->arcCount() == row.arc_count_)
+	      return edge;
+	    else
+	      return nullptr;
+	  }
+	  ordinal++;
+	}
+      }
+    }
+  }
+  return nullptr;
+}
+
+void
+DelayAnnotationsReader::annotateSlews(const float *slews)
+{
+  size_t value_count = ap_count_ * TransRiseFall::index_count;
+  vector<VertexSlewValue> slew_values(vertices_.size() * value_count);
+  forEachChunk(vertices_.size(), thread_pool_,
+	       [&] (size_t begin, size_t end, int) {
+		 for (size_t i = begin; i < end; i++) {
+		   Vertex *vertex = vertices_[i];
+		   const float *vertex_slews = &slews[i * value_count];
+		   VertexSlewValue *values = &slew_values[i * value_count];
+		   TransRiseFallIterator tr_iter;
+		   while (tr_iter.hasNext()) {
+		     TransRiseFall *tr = tr_iter.next();
+		     for (DcalcAPIndex ap = 0; ap < ap_count_; ap++) {
+		       values->vertex_ = vertex;
+		       values->tr_ = tr;
+		       values->ap_index_ = ap;
+		       values->slew_ = *vertex_slews++;
+		       values++;
+		     }
+		   }
+		 }
+	       });
+  slew_values.erase(std::remove_if(slew_values.begin(), slew_values.end(),
+				   [] (const VertexSlewValue &value) {
+				     return value.vertex_ == nullptr;
+				   }),
+		    slew_values.end());
+  sta_->setAnnotatedSlews(slew_values.data(), slew_values.size());
+}
+
+// Edges are matched and their delays collected in parallel.
+void
+DelayAnnotationsReader::annotateDelays(const DelayAnnotationEdge *edge_rows,
+				       size_t edge_count,
+				       size_t arc_count,
+				       const float *delays)
+{
+  vector<ArcDelayValue> delay_values(arc_count * ap_count_);
+  vector<uint8_t> edge_missing(edge_count);
+  forEachChunk(edge_count, thread_pool_,
+	       [&] (size_t begin, size_t end, int) {
+		 for (size_t i = begin; i < end; i++) {
+		   const DelayAnnotationEdge &row = edge_rows[i];
+		   Edge *edge = nullptr;
+		   if (static_cast<size_t>(row.arc_begin_) + row.arc_count_
+		       <= arc_count)
+		     edge = findEdge(row);
+		   edge_missing[i] = (edge == nullptr);
+		   if (edge) {
+		     size_t value_index = row.arc_begin_ * ap_count_;
+		     const float *edge_delays = &delays[value_index];
+		     ArcDelayValue *values = &delay_values[value_index];
+		     for (TimingArc *arc : edge->timingArcSet()->arcs()) {
+		       for (DcalcAPIndex ap = 0; ap < ap_count_; ap++) {
+			 values->edge_ = edge;
+			 values->arc_ = arc;
+			 values->ap_index_ = ap;
+			 values->delay_ = *edge_delays++;
+			 values++;
+		       }
+		     }
+		   }
+		 }
+	       });
+  int missing_count = std::count(edge_missing.begin(), edge_missing.end(), 1);
+  if (missing_count > 0)
+    report_->warn("%s %d timing edges not found.\n", filename_,
+		  missing_count);
+  delay_values.erase(std::remove_if(delay_values.begin(), delay_values.end(),
+				    [] (const ArcDelayValue &value) {
+				      return value.edge_ == nullptr;
+				    }),
+		     delay_values.end());
+  sta_->setArcDelays(delay_values.data(), delay_values.size());
+}
+
+////////////////////////////////////////////////////////////////
+
+void
+writeDelayAnnotations(const char *filename,
+		      StaState *sta)
+{
+  DelayAnnotationsWriter writer(filename, sta);
+  writer.write();
+}
+
+bool
+readDelayAnnotations(const char *filename,
+		     Sta *sta)
+{
+  DelayAnnotationsReader reader(filename, sta);
+  return reader.read();
+}
+
+} // namespace
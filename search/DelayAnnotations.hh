@@ -0,0 +1,46 @@
+// OpenSTA, Static Timing Analyzer
+// Copyright (c) 2019, Parallax Software, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#ifndef STA_DELAY_ANNOTATIONS_H
+#define STA_DELAY_ANNOTATIONS_H
+
+namespace sta {
+
+class StaState;
+class Sta;
+
+// Delay annotation files are a binary alternative to writing and
+// reading sdf to hand the graph slews, arc delays and timing check
+// values of one session to another. Vertices are keyed by pin path name
+// and edges by their from/to vertices and timing role, so unlike timing
+// checkpoints they do not depend on the order the design was read in.
+// Values read are annotated so delay calculation does not replace them.
+// The file is written in native byte order and is not compressed so it
+// can be read in place.
+
+// Throws FileNotWritable.
+void
+writeDelayAnnotations(const char *filename,
+		      StaState *sta);
+
+// Throws FileNotReadable.
+// Return true if successful.
+bool
+readDelayAnnotations(const char *filename,
+		     Sta *sta);
+
+} // namespace
+#endif
@@ -15,6 +15,7 @@
 // along with this program.  If not, see <https://www.gnu.org/licenses/>.
 
 #include "Machine.hh"
+#include "ThreadForEach.hh"
 #include "DisallowCopyAssign.hh"
 #include "TimingRole.hh"
 #include "FuncExpr.hh"
@@ -77,6 +78,128 @@ FindRegClkPred::searchThru(Edge *edge)
     && SearchPred1::searchThru(edge);
 }
 
+// Depth first search from the clock vertices to find the register
+// clock pins in the clock network.
+class ClkNetworkRegClks
+{
+public:
+  ClkNetworkRegClks(Clock *clk,
+		 const StaState *sta);
+  void findPins(// Return value.
+		RegClkPinSenseSeq &pins);
+
+private:
+  DISALLOW_COPY_AND_ASSIGN(ClkNetworkRegClks);
+  void visitFanout(Vertex *from_vertex,
+		   TimingSense from_sense);
+
+  Clock *clk_;
+  FindRegClkPred clk_pred_;
+  VertexSet visited_vertices_;
+  RegClkPinSenseSeq *pins_;
+  const StaState *sta_;
+};
+
+ClkNetworkRegClks::ClkNetworkRegClks(Clock *clk,
+			       const StaState *sta) :
+  clk_(clk),
+  clk_pred_(clk, sta),
+  pins_(nullptr),
+  sta_(sta)
+{
+}
+
+void
+ClkNetworkRegClks::findPins(// Return value.
+			 RegClkPinSenseSeq &pins)
+{
+  pins_ = &pins;
+  Graph *graph = sta_->graph();
+  ClockVertexPinIterator pin_iter(clk_);
+  while (pin_iter.hasNext()) {
+    Pin *pin = pin_iter.next();
+    Vertex *vertex, *bidirect_drvr_vertex;
+    graph->pinVertices(pin, vertex, bidirect_drvr_vertex);
+    visitFanout(vertex, TimingSense::positive_unate);
+    // Clocks defined on bidirect pins blow it out both ends.
+    if (bidirect_drvr_vertex)
+      visitFanout(bidirect_drvr_vertex, TimingSense::positive_unate);
+  }
+}
+
+void
+ClkNetworkRegClks::visitFanout(Vertex *from_vertex,
+			    TimingSense from_sense)
+{
+  if (!visited_vertices_.hasKey(from_vertex)
+      && clk_pred_.searchFrom(from_vertex)) {
+    visited_vertices_.insert(from_vertex);
+    Graph *graph = sta_->graph();
+    VertexOutEdgeIterator edge_iter(from_vertex, graph);
+    while (edge_iter.hasNext()) {
+      Edge *edge = edge_iter.next();
+      Vertex *to_vertex = edge->to(graph);
+      TimingSense to_sense = pathSenseThru(from_sense, edge->sense());
+      if (to_vertex->isRegClk())
+	pins_->push_back(RegClkPinSense(to_vertex->pin(), to_sense));
+      // Even register clock pins can have combinational fanout arcs.
+      if (clk_pred_.searchThru(edge)
+          && clk_pred_.searchTo(to_vertex))
+	visitFanout(to_vertex, to_sense);
+    }
+  }
+}
+
+////////////////////////////////////////////////////////////////
+
+RegClkIndex::RegClkIndex() :
+  valid_(false)
+{
+}
+
+RegClkIndex::~RegClkIndex()
+{
+  clear();
+}
+
+void
+RegClkIndex::clear()
+{
+  clk_pins_.deleteContents();
+  clk_pins_.clear();
+}
+
+void
+RegClkIndex::ensure(const StaState *sta)
+{
+  if (!valid_) {
+    clear();
+    ClockSeq *clks = sta->sdc()->clocks();
+    std::vector<RegClkPinSenseSeq*> clk_pins(clks->size());
+    forEachChunk(clks->size(), sta->threadPool(),
+		 [&](size_t begin, size_t end, int) {
+		   for (size_t i = begin; i < end; i++) {
+		     Clock *clk = (*clks)[i];
+		     RegClkPinSenseSeq *pins = new RegClkPinSenseSeq;
+		     ClkNetworkRegClks find_pins(clk, sta);
+		     find_pins.findPins(*pins);
+		     clk_pins[i] = pins;
+		   }
+		 });
+    for (size_t i = 0; i < clks->size(); i++)
+      clk_pins_[(*clks)[i]] = clk_pins[i];
+    valid_ = true;
+  }
+}
+
+const RegClkPinSenseSeq *
+RegClkIndex::regClkPins(const Clock *clk) const
+{
+  return clk_pins_.findKey(clk);
+}
+
+////////////////////////////////////////////////////////////////
+
 // Helper for "all_registers".
 // Visit all register instances.
 class FindRegVisitor : public StaState
@@ -99,13 +222,6 @@ private:
   virtual void visitReg(Instance *inst) = 0;
   virtual void visitSequential(Instance *inst,
 			       Sequential *seq) = 0;
-  void visitFanoutRegs(Vertex *from_vertex,
-		       TimingSense from_sense,
-		       const TransRiseFallBoth *clk_tr,
-		       bool edge_triggered,
-		       bool latches,
-		       SearchPred &clk_pred,
-		       VertexSet &visited_vertices);
   void findSequential(const Pin *clk_pin,
 		      Instance *inst,
 		      LibertyCell *cell,
@@ -138,28 +254,18 @@ FindRegVisitor::visitRegs(ClockSet *clks,
 			  bool latches)
 {
   if (clks && !clks->empty()) {
-    // Use DFS search to find all registers downstream of the clocks.
+    // The registers downstream of each clock are found by a DFS
+    // search that is indexed by search.
+    RegClkIndex *reg_clk_index = search_->regClkIndex();
+    reg_clk_index->ensure(this);
     ClockSet::Iterator clk_iter(clks);
     while (clk_iter.hasNext()) {
       Clock *clk = clk_iter.next();
-      FindRegClkPred clk_pred(clk, this);
-      VertexSet visited_vertices;
-      ClockVertexPinIterator pin_iter(clk);
-      while (pin_iter.hasNext()) {
-	Pin *pin = pin_iter.next();
-	Vertex *vertex, *bidirect_drvr_vertex;
-	graph_->pinVertices(pin, vertex, bidirect_drvr_vertex);
-	visitFanoutRegs(vertex, TimingSense::positive_unate,
-			clk_tr, edge_triggered,
-			latches, clk_pred,
-			visited_vertices);
-	// Clocks defined on bidirect pins blow it out both ends.
-	if (bidirect_drvr_vertex)
-	  visitFanoutRegs(bidirect_drvr_vertex,
-			  TimingSense::positive_unate,
-			  clk_tr, edge_triggered,
-			  latches, clk_pred,
-			  visited_vertices);
+      const RegClkPinSenseSeq *pins = reg_clk_index->regClkPins(clk);
+      if (pins) {
+	for (auto &pin_sense : *pins)
+	  visitRegs(pin_sense.first, pin_sense.second,
+		    clk_tr, edge_triggered, latches);
       }
     }
   }
@@ -174,35 +280,6 @@ FindRegVisitor::visitRegs(ClockSet *clks,
   }
 }
 
-void
-FindRegVisitor::visitFanoutRegs(Vertex *from_vertex,
-				TimingSense from_sense,
-				const TransRiseFallBoth *clk_tr,
-				bool edge_triggered,
-				bool latches,
-				SearchPred &clk_pred,
-				VertexSet &visited_vertices)
-{
-  if (!visited_vertices.hasKey(from_vertex)
-      && clk_pred.searchFrom(from_vertex)) {
-    visited_vertices.insert(from_vertex);
-    VertexOutEdgeIterator edge_iter(from_vertex, graph_);
-    while (edge_iter.hasNext()) {
-      Edge *edge = edge_iter.next();
-      Vertex *to_vertex = edge->to(graph_);
-      const Pin *to_pin = to_vertex->pin();
-      TimingSense to_sense = pathSenseThru(from_sense, edge->sense());
-      if (to_vertex->isRegClk())
-	visitRegs(to_pin, to_sense, clk_tr, edge_triggered, latches);
-      // Even register clock pins can have combinational fanout arcs.
-      if (clk_pred.searchThru(edge)
-          && clk_pred.searchTo(to_vertex))
-	visitFanoutRegs(to_vertex, to_sense, clk_tr, edge_triggered, latches,
-			clk_pred, visited_vertices);
-    }
-  }
-}
-
 void
 FindRegVisitor::visitRegs(const Pin *clk_pin,
 			  TimingSense clk_sense,
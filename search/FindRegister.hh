@@ -17,13 +17,49 @@
 #ifndef STA_FIND_REGISTER_H
 #define STA_FIND_REGISTER_H
 
+#include <atomic>
+#include <utility>
+#include <vector>
+#include "DisallowCopyAssign.hh"
+#include "Map.hh"
 #include "StaState.hh"
 #include "LibertyClass.hh"
 #include "NetworkClass.hh"
 #include "SdcClass.hh"
+#include "TimingArc.hh"
 
 namespace sta {
 
+// Register clock pin and the path sense from the clock source to it.
+typedef std::pair<const Pin*, TimingSense> RegClkPinSense;
+typedef std::vector<RegClkPinSense> RegClkPinSenseSeq;
+typedef Map<const Clock*, RegClkPinSenseSeq*> RegClkPinSenseMap;
+
+// Register clock pins in the fanout of each clock, in the order the
+// clock network search finds them. The index is built for all clocks
+// in parallel by the first register query after it is invalidated and
+// answers all_registers -clock queries without searching the clock
+// network again. Search invalidates it with the arrivals.
+class RegClkIndex
+{
+public:
+  RegClkIndex();
+  ~RegClkIndex();
+  // Safe to call from delay calculation threads.
+  void invalid() { valid_ = false; }
+  // Build the index if it is invalid.
+  void ensure(const StaState *sta);
+  // Register clock pins of clk, or nullptr if clk is not indexed.
+  const RegClkPinSenseSeq *regClkPins(const Clock *clk) const;
+
+private:
+  DISALLOW_COPY_AND_ASSIGN(RegClkIndex);
+  void clear();
+
+  RegClkPinSenseMap clk_pins_;
+  std::atomic<bool> valid_;
+};
+
 InstanceSet *
 findRegInstances(ClockSet *clks, const TransRiseFallBoth *clk_tr,
 		 bool edge_triggered, bool latches, StaState *sta);
@@ -17,14 +17,15 @@
 #ifndef STA_GATED_CLK_H
 #define STA_GATED_CLK_H
 
+#include <vector>
 #include "SdcClass.hh"
 #include "GraphClass.hh"
 #include "SearchClass.hh"
 
 namespace sta {
 
-typedef Set<FuncExpr*> FuncExprSet;
-
+// Clock gating checks inferred from AND/OR type cell functions
+// (LibertyCell::clkGatingFuncs) on the clock network.
 class GatedClk : public StaState
 {
 public:
@@ -35,21 +36,15 @@ public:
 			bool &is_gated_clk_enable,
 			const Pin *&clk_pin,
 			LogicValue &logic_active_value) const;
+  // Find the gated clock enables in vertices in parallel.
+  void findEnables(const VertexSeq &vertices,
+		   // Return value.
+		   std::vector<char> &is_enables) const;
   void gatedClkEnables(Vertex *clk_vertex,
 		       // Return value.
 		       PinSet &enable_pins);
   TransRiseFall *gatedClkActiveTrans(LogicValue active_value,
 				     const MinMax *min_max) const;
-
-protected:
-  void isClkGatingFunc(FuncExpr *func,
-		       LibertyPort *enable_port,
-		       LibertyPort *clk_port,
-		       bool &is_clk_gate,
-		       LogicValue &logic_value) const;
-  void functionClkOperands(FuncExpr *root_expr,
-			   FuncExpr *curr_expr,
-			   FuncExprSet &funcs) const;
 };
 
 } // namespace
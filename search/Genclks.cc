@@ -15,6 +15,7 @@
 // along with this program.  If not, see <https://www.gnu.org/licenses/>.
 
 #include "Machine.hh"
+#include "ThreadForEach.hh"
 #include "Stats.hh"
 #include "Debug.hh"
 #include "Report.hh"
@@ -195,7 +196,7 @@ void
 Genclks::ensureInsertionDelays()
 {
   if (!found_insertion_delays_) {
-    Stats stats(debug_);
+    Stats stats(debug_, phase_stats_);
     debugPrint0(debug_, "genclk", 1, "find generated clk insertion delays\n");
 
     ClockSeq gclks;
@@ -212,11 +213,14 @@ Genclks::ensureInsertionDelays()
     // insertion delay, so sort the clocks by source pin level.
     sort(gclks, ClockPinMaxLevelLess(this));
 
-    ClockSeq::Iterator gclk_iter(gclks);
-    while (gclk_iter.hasNext()) {
-      Clock *gclk = gclk_iter.next();
+    Vector<VertexSet*> gclk_fanins;
+    findFanins(gclks, gclk_fanins);
+    // The source path searches share the vertex arrivals so they are
+    // run one clock at a time in level order.
+    for (size_t i = 0; i < gclks.size(); i++) {
+      Clock *gclk = gclks[i];
       if (gclk->masterClk()) {
-	findInsertionDelays(gclk);
+	findInsertionDelays(gclk, gclk_fanins[i]);
 	if (gclk->pllOut())
 	  findPllDelays(gclk);
 	recordSrcPaths(gclk);
@@ -450,29 +454,92 @@ GenClkFaninSrchPred::searchTo(const Vertex *)
   return true;
 }
 
+static void
+enqueueFaninVertices(Vertex *vertex,
+		     SearchPred *srch_pred,
+		     const Graph *graph,
+		     VertexSeq &queue)
+{
+  if (srch_pred->searchTo(vertex)) {
+    VertexInEdgeIterator edge_iter(vertex, graph);
+    while (edge_iter.hasNext()) {
+      Edge *edge = edge_iter.next();
+      Vertex *from_vertex = edge->from(graph);
+      if (srch_pred->searchFrom(from_vertex)
+	  && srch_pred->searchThru(edge))
+	queue.push_back(from_vertex);
+    }
+  }
+}
+
+// Find the fanins of the generated clocks in parallel. Generated clocks
+// defined on the same pins with the same combinational attribute have
+// the same fanin, so it is only searched for the first one.
+void
+Genclks::findFanins(ClockSeq &gclks,
+		    // Return value.
+		    Vector<VertexSet*> &gclk_fanins)
+{
+  size_t gclk_count = gclks.size();
+  gclk_fanins.resize(gclk_count);
+  std::vector<int> same_fanins(gclk_count, -1);
+  for (size_t i = 0; i < gclk_count; i++) {
+    Clock *gclk = gclks[i];
+    for (size_t j = 0; j < i; j++) {
+      Clock *gclk2 = gclks[j];
+      if (gclk2->masterClk()
+	  && gclk2->combinational() == gclk->combinational()
+	  && *gclk2->pins() == *gclk->pins()) {
+	same_fanins[i] = j;
+	break;
+      }
+    }
+  }
+  forEachChunk(gclk_count, thread_pool_,
+	       [&] (size_t begin, size_t end, int) {
+		 for (size_t i = begin; i < end; i++) {
+		   Clock *gclk = gclks[i];
+		   if (gclk->masterClk() && same_fanins[i] < 0) {
+		     VertexSet *fanins = new VertexSet;
+		     findFanin(gclk, fanins);
+		     gclk_fanins[i] = fanins;
+		   }
+		 }
+	       });
+  for (size_t i = 0; i < gclk_count; i++) {
+    int same_index = same_fanins[i];
+    if (gclks[i]->masterClk() && same_index >= 0)
+      gclk_fanins[i] = new VertexSet(*gclk_fanins[same_index]);
+  }
+}
+
+// Search backward from generated clock source pin to a clock pin.
+// The search does not use a BfsIterator so that the fanins of
+// several generated clocks can be found at the same time.
 void
 Genclks::findFanin(Clock *gclk,
 		   // Return value.
 		   VertexSet *fanins)
 {
-  // Search backward from generated clock source pin to a clock pin.
   GenClkFaninSrchPred srch_pred(gclk, this);
-  BfsBkwdIterator iter(BfsIndex::other, &srch_pred, this);
-  seedClkVertices(gclk, iter, fanins);
-  while (iter.hasNext()) {
-    Vertex *vertex = iter.next();
+  VertexSeq queue;
+  seedClkVertices(gclk, &srch_pred, queue, fanins);
+  while (!queue.empty()) {
+    Vertex *vertex = queue.back();
+    queue.pop_back();
     if (!fanins->hasKey(vertex)) {
       fanins->insert(vertex);
       debugPrint2(debug_, "genclk", 2, "gen clk %s fanin %s\n",
 		  gclk->name(), vertex->name(sdc_network_));
-      iter.enqueueAdjacentVertices(vertex);
+      enqueueFaninVertices(vertex, &srch_pred, graph_, queue);
     }
   }
 }
 
 void
 Genclks::seedClkVertices(Clock *clk,
-			 BfsBkwdIterator &iter,
+			 SearchPred *srch_pred,
+			 VertexSeq &queue,
 			 VertexSet *fanins)
 {
   ClockVertexPinIterator pin_iter(clk);
@@ -481,10 +548,10 @@ Genclks::seedClkVertices(Clock *clk,
     Vertex *vertex, *bidirect_drvr_vertex;
     graph_->pinVertices(pin, vertex, bidirect_drvr_vertex);
     fanins->insert(vertex);
-    iter.enqueueAdjacentVertices(vertex);
+    enqueueFaninVertices(vertex, srch_pred, graph_, queue);
     if (bidirect_drvr_vertex) {
       fanins->insert(bidirect_drvr_vertex);
-      iter.enqueueAdjacentVertices(bidirect_drvr_vertex);
+      enqueueFaninVertices(bidirect_drvr_vertex, srch_pred, graph_, queue);
     }
   }
 }
@@ -568,11 +635,12 @@ GenClkInsertionSearchPred::isNonGeneratedClkPin(const Pin *pin) const
 ////////////////////////////////////////////////////////////////
 
 void
-Genclks::findInsertionDelays(Clock *gclk)
+Genclks::findInsertionDelays(Clock *gclk,
+			     VertexSet *fanins)
 {
   debugPrint1(debug_, "genclk", 2, "find gen clk %s insertion\n",
 	      gclk->name());
-  GenclkInfo *genclk_info = makeGenclkInfo(gclk);
+  GenclkInfo *genclk_info = makeGenclkInfo(gclk, fanins);
   FilterPath *src_filter = genclk_info->srcFilter();
   GenClkInsertionSearchPred srch_pred(gclk, nullptr, genclk_info, this);
   BfsFwdIterator insert_iter(BfsIndex::other, &srch_pred, this);
@@ -586,12 +654,11 @@ Genclks::findInsertionDelays(Clock *gclk)
 }
 
 GenclkInfo *
-Genclks::makeGenclkInfo(Clock *gclk)
+Genclks::makeGenclkInfo(Clock *gclk,
+			VertexSet *fanins)
 {
   FilterPath *src_filter = makeSrcFilter(gclk);
   Level gclk_level = clkPinMaxLevel(gclk);
-  VertexSet *fanins = new VertexSet;
-  findFanin(gclk, fanins);
   GenclkInfo *genclk_info = new GenclkInfo(gclk, gclk_level, fanins,
 					    src_filter);
   genclk_info_map_.insert(gclk, genclk_info);
@@ -938,6 +1005,12 @@ Genclks::clearSrcPaths()
   genclk_src_paths_.clear();
 }
 
+int
+Genclks::srcPathCount() const
+{
+  return TransRiseFall::index_count * corners_->pathAnalysisPtCount();
+}
+
 int
 Genclks::srcPathIndex(const TransRiseFall *clk_tr,
 		      const PathAnalysisPt *path_ap) const
@@ -948,8 +1021,7 @@ Genclks::srcPathIndex(const TransRiseFall *clk_tr,
 void
 Genclks::recordSrcPaths(Clock *gclk)
 {
-  int path_count = TransRiseFall::index_count
-    * corners_->pathAnalysisPtCount();
+  int path_count = srcPathCount();
 
   bool divide_by_1 = gclk->isDivideByOneCombinational();
   bool invert = gclk->invert();
@@ -85,15 +85,24 @@ public:
   Level clkPinMaxLevel(Clock *clk) const;
   void copyGenClkSrcPaths(Vertex *vertex,
 			  TagGroupBldr *tag_bldr);
+  // Generated clock source paths for each clock and pin.  Each entry
+  // is an array of srcPathCount() paths.
+  GenclkSrcPathMap &srcPaths() { return genclk_src_paths_; }
+  int srcPathCount() const;
 
 private:
   void findInsertionDelays();
   GenclkInfo *genclkInfo(const Clock *gclk) const;
   void clearSrcPaths();
   void recordSrcPaths(Clock *gclk);
-  void findInsertionDelays(Clock *gclk);
+  void findInsertionDelays(Clock *gclk,
+			   VertexSet *fanins);
+  void findFanins(ClockSeq &gclks,
+		  // Return value.
+		  Vector<VertexSet*> &gclk_fanins);
   void seedClkVertices(Clock *clk,
-		       BfsBkwdIterator &iter,
+		       SearchPred *srch_pred,
+		       VertexSeq &queue,
 		       VertexSet *fanins);
   int srcPathIndex(const TransRiseFall *clk_tr,
 		   const PathAnalysisPt *path_ap) const;
@@ -125,7 +134,8 @@ private:
   void seedSrcPins(Clock *clk,
 		   BfsBkwdIterator &iter);
   void findInsertionDelay(Clock *gclk);
-  GenclkInfo *makeGenclkInfo(Clock *gclk);
+  GenclkInfo *makeGenclkInfo(Clock *gclk,
+			     VertexSet *fanins);
   FilterPath *srcFilter(Clock *gclk);
   void findFanin(Clock *gclk,
 		 // Return value.
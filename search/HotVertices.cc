@@ -0,0 +1,239 @@
+// OpenSTA, Static Timing Analyzer
+// Copyright (c) 2019, Parallax Software, Inc.
+// 
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+// 
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+// 
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#include <algorithm>
+#include <functional>
+#include "Machine.hh"
+#include "Report.hh"
+#include "Network.hh"
+#include "Graph.hh"
+#include "Corner.hh"
+#include "Parasitics.hh"
+#include "TagGroup.hh"
+#include "Search.hh"
+#include "StaState.hh"
+#include "HotVertices.hh"
+
+namespace sta {
+
+HotVertexWork::HotVertexWork()
+{
+}
+
+void
+HotVertexWork::visited(Vertex *vertex,
+		       double seconds)
+{
+  if (visits_.size() < HotVertices::keep_count) {
+    visits_.push_back(HotVertexVisit(seconds, vertex));
+    std::push_heap(visits_.begin(), visits_.end(),
+		   std::greater<HotVertexVisit>());
+  }
+  else if (seconds > visits_.front().first) {
+    std::pop_heap(visits_.begin(), visits_.end(),
+		  std::greater<HotVertexVisit>());
+    visits_.back() = HotVertexVisit(seconds, vertex);
+    std::push_heap(visits_.begin(), visits_.end(),
+		   std::greater<HotVertexVisit>());
+  }
+}
+
+void
+HotVertexWork::clear()
+{
+  visits_.clear();
+}
+
+HotVertex::HotVertex() :
+  visit_count_(0),
+  seconds_(0.0),
+  max_seconds_(0.0),
+  fanout_(0),
+  tag_count_(0),
+  parasitic_node_count_(0)
+{
+}
+
+////////////////////////////////////////////////////////////////
+
+static const char *hot_vertex_bfs_names[] = {
+  "delay calc", "arrival search", "required search", "search"
+};
+
+HotVertices::HotVertices() :
+  enabled_(false)
+{
+}
+
+void
+HotVertices::setEnabled(bool enabled)
+{
+  enabled_ = enabled;
+}
+
+void
+HotVertices::clear()
+{
+  for (auto &vertices : vertices_)
+    vertices.clear();
+}
+
+void
+HotVertices::record(BfsIndex bfs_index,
+		    HotVertexWorkSeq &work,
+		    const StaState *sta)
+{
+  Graph *graph = sta->graph();
+  const Search *search = sta->search();
+  HotVertexMap &vertices = vertices_[static_cast<int>(bfs_index)];
+  for (auto &thread_work : work) {
+    for (auto &visit : thread_work.visits_) {
+      double seconds = visit.first;
+      Vertex *vertex = visit.second;
+      HotVertex &hot = vertices[graph->index(vertex)];
+      if (hot.visit_count_ == 0) {
+	hot.name_ = vertex->name(sta->network());
+	hot.fanout_ = 0;
+	VertexOutEdgeIterator edge_iter(vertex, graph);
+	while (edge_iter.hasNext()) {
+	  edge_iter.next();
+	  hot.fanout_++;
+	}
+	hot.parasitic_node_count_ = parasiticNodeCount(vertex, sta);
+      }
+      hot.visit_count_++;
+      hot.seconds_ += seconds;
+      hot.max_seconds_ = std::max(hot.max_seconds_, seconds);
+      TagGroup *tag_group = search->tagGroup(vertex);
+      hot.tag_count_ = tag_group ? tag_group->arrivalCount() : 0;
+    }
+    thread_work.clear();
+  }
+  if (vertices.size() > keep_count * 4)
+    prune(vertices);
+}
+
+int
+HotVertices::parasiticNodeCount(const Vertex *vertex,
+				const StaState *sta) const
+{
+  int node_count = 0;
+  Parasitics *parasitics = sta->parasitics();
+  if (parasitics
+      && sta->network()->isDriver(vertex->pin())
+      && !sta->corners()->parasiticAnalysisPts().empty()) {
+    ParasiticAnalysisPt *ap = sta->corners()->parasiticAnalysisPts()[0];
+    Parasitic *parasitic = parasitics->findParasiticNetwork(vertex->pin(), ap);
+    if (parasitic) {
+      ParasiticNodeIterator *node_iter = parasitics->nodeIterator(parasitic);
+      while (node_iter->hasNext()) {
+	node_iter->next();
+	node_count++;
+      }
+      delete node_iter;
+    }
+  }
+  return node_count;
+}
+
+class HotVertexGreater
+{
+public:
+  bool operator()(const std::pair<VertexIndex, HotVertex> &hot1,
+		  const std::pair<VertexIndex, HotVertex> &hot2) const
+  {
+    return hot1.second.seconds_ > hot2.second.seconds_
+      || (hot1.second.seconds_ == hot2.second.seconds_
+	  && hot1.first < hot2.first);
+  }
+};
+
+static void
+sortHotVertices(const HotVertexMap &vertices,
+		size_t count,
+		std::vector<std::pair<VertexIndex, HotVertex>> &sorted)
+{
+  sorted.assign(vertices.begin(), vertices.end());
+  count = std::min(count, sorted.size());
+  std::partial_sort(sorted.begin(), sorted.begin() + count, sorted.end(),
+		    HotVertexGreater());
+  sorted.resize(count);
+}
+
+// Keep the keep_count vertices with the most time.
+void
+HotVertices::prune(HotVertexMap &vertices)
+{
+  std::vector<std::pair<VertexIndex, HotVertex>> sorted;
+  sortHotVertices(vertices, keep_count, sorted);
+  vertices.clear();
+  for (auto &index_hot : sorted)
+    vertices[index_hot.first] = index_hot.second;
+}
+
+////////////////////////////////////////////////////////////////
+
+void
+HotVertices::report(int count,
+		    const StaState *sta) const
+{
+  Report *report = sta->report();
+  bool reported = false;
+  for (int i = 0; i < static_cast<int>(BfsIndex::bits); i++) {
+    const HotVertexMap &vertices = vertices_[i];
+    if (!vertices.empty()) {
+      if (reported)
+	report->print("\n");
+      this->report(hot_vertex_bfs_names[i], vertices, count, sta);
+      reported = true;
+    }
+  }
+  if (!reported) {
+    if (enabled_)
+      report->print("No vertex visits recorded.\n");
+    else
+      report->print("Hot vertex profiling is disabled (set sta_hot_vertex_profile 1).\n");
+  }
+}
+
+void
+HotVertices::report(const char *name,
+		    const HotVertexMap &vertices,
+		    int count,
+		    const StaState *sta) const
+{
+  Report *report = sta->report();
+  std::vector<std::pair<VertexIndex, HotVertex>> sorted;
+  sortHotVertices(vertices, count, sorted);
+  report->print("Hot vertices: %s\n", name);
+  report->print("%-40s %7s %9s %9s %6s %5s %6s\n",
+		"Vertex", "Visits", "Time(ms)", "Max(us)", "Fanout", "Tags",
+		"Nodes");
+  report->print("-------------------------------------------------------------------------------------\n");
+  for (auto &index_hot : sorted) {
+    const HotVertex &hot = index_hot.second;
+    report->print("%-40s %7lu %9.3f %9.1f %6d %5d %6d\n",
+		  hot.name_.c_str(),
+		  static_cast<unsigned long>(hot.visit_count_),
+		  hot.seconds_ * 1e+3,
+		  hot.max_seconds_ * 1e+6,
+		  hot.fanout_,
+		  hot.tag_count_,
+		  hot.parasitic_node_count_);
+  }
+}
+
+} // namespace
@@ -0,0 +1,111 @@
+// OpenSTA, Static Timing Analyzer
+// Copyright (c) 2019, Parallax Software, Inc.
+// 
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+// 
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+// 
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#ifndef STA_HOT_VERTICES_H
+#define STA_HOT_VERTICES_H
+
+#include <stddef.h>  // size_t
+#include <string>
+#include <utility>
+#include <vector>
+#include "DisallowCopyAssign.hh"
+#include "UnorderedMap.hh"
+#include "GraphClass.hh"
+
+namespace sta {
+
+class StaState;
+
+typedef std::pair<double, Vertex*> HotVertexVisit;
+
+// The slowest vertex visits made by one thread during a BFS visit.
+// Each thread only writes its own entry.
+class HotVertexWork
+{
+public:
+  HotVertexWork();
+  void visited(Vertex *vertex,
+	       double seconds);
+  void clear();
+
+  // Min heap of the slowest visits.
+  std::vector<HotVertexVisit> visits_;
+  // Keep entries for different threads off the same cache line.
+  char pad_[40];
+};
+
+typedef std::vector<HotVertexWork> HotVertexWorkSeq;
+
+class HotVertex
+{
+public:
+  HotVertex();
+
+  // Vertex name when it was first recorded.
+  std::string name_;
+  size_t visit_count_;
+  double seconds_;
+  double max_seconds_;
+  int fanout_;
+  // Arrival count after the last recorded visit.
+  int tag_count_;
+  int parasitic_node_count_;
+};
+
+typedef UnorderedMap<VertexIndex, HotVertex> HotVertexMap;
+
+// Vertices that take the most time to visit in delay calculation and
+// arrival/required search, such as large fanout nets, multi-driver
+// buses and clock mesh pins. Recording is enabled with the TCL
+// variable sta_hot_vertex_profile and adds two clock reads per vertex.
+// Each BFS pass keeps the slowest visits of each thread so the time of
+// vertices that are never among the slowest of a pass is not counted.
+class HotVertices
+{
+public:
+  HotVertices();
+  bool enabled() const { return enabled_; }
+  void setEnabled(bool enabled);
+  void clear();
+  // Merge the slowest visits of a BFS pass.
+  void record(BfsIndex bfs_index,
+	      HotVertexWorkSeq &work,
+	      const StaState *sta);
+  // Report the count vertices with the most time for each BFS.
+  void report(int count,
+	      const StaState *sta) const;
+
+  // Visits kept per thread for each pass.
+  static const size_t keep_count = 1000;
+
+protected:
+  void prune(HotVertexMap &vertices);
+  void report(const char *name,
+	      const HotVertexMap &vertices,
+	      int count,
+	      const StaState *sta) const;
+  int parasiticNodeCount(const Vertex *vertex,
+			 const StaState *sta) const;
+
+  bool enabled_;
+  HotVertexMap vertices_[static_cast<int>(BfsIndex::bits)];
+
+private:
+  DISALLOW_COPY_AND_ASSIGN(HotVertices);
+};
+
+} // namespace
+#endif
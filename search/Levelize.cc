@@ -15,10 +15,13 @@
 // along with this program.  If not, see <https://www.gnu.org/licenses/>.
 
 #include <algorithm>
+#include <atomic>
+#include <vector>
 #include "Machine.hh"
 #include "Report.hh"
 #include "Debug.hh"
 #include "Stats.hh"
+#include "ThreadForEach.hh"
 #include "TimingRole.hh"
 #include "PortDirection.hh"
 #include "Network.hh"
@@ -30,6 +33,17 @@
 
 namespace sta {
 
+// Breadth first levelization waves smaller than this are expanded
+// without the thread pool.
+static const size_t levelize_parallel_min = 1024;
+// Incremental relevelization from more than this fraction of the
+// vertices levelizes the entire graph instead.
+static const size_t relevelize_full_divisor = 8;
+
+static void
+atomicMax(std::atomic<int> &value,
+	  int max_value);
+
 Levelize::Levelize(StaState *sta) :
   StaState(sta),
   search_pred_(new SearchPredNonLatch2(sta)),
@@ -71,6 +85,8 @@ Levelize::clear()
   relevelize_from_.clear();
   clearLoopEdges();
   deleteLoops();
+  if (observer_)
+    observer_->levelsInvalid();
 }
 
 void
@@ -106,18 +122,39 @@ Levelize::ensureLevelized()
   }
 }
 
-// Depth first search.
-// "Introduction to Algorithms", section 23.3 pg 478.
+// Acyclic graphs are levelized breadth first.  Loops in graphs with
+// cycles are broken one strongly connected component at a time and
+// the broken graph is levelized breadth first.  The depth first
+// search is the last resort for graphs that are still not levelized.
 void
 Levelize::levelize()
 {
-  Stats stats(debug_);
+  Stats stats(debug_, phase_stats_);
   debugPrint0(debug_, "levelize", 1, "levelize\n");
   max_level_ = 0;
   clearLoopEdges();
   deleteLoops();
   loops_ = new GraphLoopSeq;
   findRoots();
+  if (levelizeAcyclic()
+      || (breakLoops() && levelizeAcyclic()))
+    ensureLatchLevels();
+  else {
+    findRoots();
+    levelizeLoops();
+  }
+  levelized_ = true;
+  levels_valid_ = true;
+  stats.setVisitCount(graph_->vertexCount());
+  stats.report("Levelize");
+}
+
+// Depth first search.
+// "Introduction to Algorithms", section 23.3 pg 478.
+void
+Levelize::levelizeLoops()
+{
+  debugPrint0(debug_, "levelize", 1, "levelize loops\n");
   VertexSeq roots;
   // Sort the roots so that loop breaking is stable in regressions.
   // In situations where port directions are broken pins may
@@ -129,9 +166,393 @@ Levelize::levelize()
   ensureLatchLevels();
   // Find vertices in cycles that are were not accessible from roots.
   levelizeCycles();
-  levelized_ = true;
-  levels_valid_ = true;
-  stats.report("Levelize");
+}
+
+// Kahn's algorithm.
+// Each vertex level is the longest path from the roots, the same
+// levels the depth first search finds when there are no loops.
+// Vertices whose fanin levels are all known form a wave that is
+// expanded in parallel.  Returns false without changing any levels
+// when some vertices are in (or downstream of) loops or are not
+// reachable from the roots, because only the depth first search
+// breaks loops and picks roots for unreachable vertices.
+bool
+Levelize::levelizeAcyclic()
+{
+  VertexSeq vertices;
+  VertexIndex index_max = 0;
+  VertexIterator vertex_iter(graph_);
+  while (vertex_iter.hasNext()) {
+    Vertex *vertex = vertex_iter.next();
+    vertices.push_back(vertex);
+    index_max = max(index_max, graph_->index(vertex));
+  }
+  size_t vertex_count = vertices.size();
+  ThreadPool *pool = (vertex_count >= levelize_parallel_min)
+    ? thread_pool_
+    : nullptr;
+  int thread_count = pool ? pool->threadCount() : 1;
+  std::vector<VertexSeq> thread_fanouts(thread_count);
+  std::vector<VertexSeq> thread_frontiers(thread_count);
+  std::vector<EdgeSeq> thread_latch_edges(thread_count);
+
+  // Indexed by graph vertex index.
+  std::vector<std::atomic<int>> fanin_counts(index_max + 1);
+  std::vector<std::atomic<int>> levels(index_max + 1);
+  std::vector<std::atomic<bool>> reached(index_max + 1);
+  forEachChunk(vertex_count, pool,
+	       [&] (size_t begin, size_t end, int) {
+		 for (size_t i = begin; i < end; i++) {
+		   Vertex *vertex = vertices[i];
+		   VertexIndex index = graph_->index(vertex);
+		   fanin_counts[index].store(0, std::memory_order_relaxed);
+		   levels[index].store(0, std::memory_order_relaxed);
+		   reached[index].store(roots_.hasKey(vertex), std::memory_order_relaxed);
+		 }
+	       });
+  forEachChunk(vertex_count, pool,
+	       [&] (size_t begin, size_t end, int thread_index) {
+		 VertexSeq &fanouts = thread_fanouts[thread_index];
+		 for (size_t i = begin; i < end; i++) {
+		   fanouts.clear();
+		   findFanouts(vertices[i], fanouts, nullptr);
+		   for (Vertex *to_vertex : fanouts)
+		     fanin_counts[graph_->index(to_vertex)].fetch_add(1);
+		 }
+	       });
+
+  VertexSeq frontier;
+  for (Vertex *vertex : vertices) {
+    if (fanin_counts[graph_->index(vertex)].load(std::memory_order_relaxed) == 0)
+      frontier.push_back(vertex);
+  }
+  size_t visit_count = 0;
+  while (!frontier.empty()) {
+    size_t frontier_size = frontier.size();
+    visit_count += frontier_size;
+    forEachChunk(frontier_size,
+		 (frontier_size >= levelize_parallel_min) ? pool : nullptr,
+		 [&] (size_t begin, size_t end, int thread_index) {
+		   VertexSeq &fanouts = thread_fanouts[thread_index];
+		   VertexSeq &next_frontier = thread_frontiers[thread_index];
+		   EdgeSeq &latch_edges = thread_latch_edges[thread_index];
+		   for (size_t i = begin; i < end; i++) {
+		     Vertex *vertex = frontier[i];
+		     VertexIndex index = graph_->index(vertex);
+		     int to_level = levels[index].load(std::memory_order_relaxed)
+		       + level_space_;
+		     bool is_reached = reached[index].load(std::memory_order_relaxed);
+		     fanouts.clear();
+		     findFanouts(vertex, fanouts, &latch_edges);
+		     for (Vertex *to_vertex : fanouts) {
+		       VertexIndex to_index = graph_->index(to_vertex);
+		       atomicMax(levels[to_index], to_level);
+		       if (is_reached)
+			 reached[to_index].store(true, std::memory_order_relaxed);
+		       // The last fanin to finish schedules the vertex.
+		       if (fanin_counts[to_index].fetch_sub(1) == 1)
+			 next_frontier.push_back(to_vertex);
+		     }
+		   }
+		 });
+    frontier.clear();
+    for (VertexSeq &next_frontier : thread_frontiers) {
+      frontier.insert(frontier.end(), next_frontier.begin(), next_frontier.end());
+      next_frontier.clear();
+    }
+  }
+  if (visit_count < vertex_count) {
+    debugPrint1(debug_, "levelize", 1, "%zu vertices in loops\n",
+		vertex_count - visit_count);
+    return false;
+  }
+  for (Vertex *vertex : vertices) {
+    if (search_pred_->searchFrom(vertex)
+	&& !reached[graph_->index(vertex)].load(std::memory_order_relaxed))
+      return false;
+  }
+
+  for (Vertex *vertex : vertices) {
+    Level level = levels[graph_->index(vertex)].load(std::memory_order_relaxed);
+    setLevel(vertex, level);
+    vertex->setColor(LevelColor::black);
+    max_level_ = max(level, max_level_);
+  }
+  for (EdgeSeq &latch_edges : thread_latch_edges) {
+    for (Edge *edge : latch_edges)
+      latch_d_to_q_edges_.insert(edge);
+  }
+  return true;
+}
+
+static void
+atomicMax(std::atomic<int> &value,
+	  int max_value)
+{
+  int prev = value.load(std::memory_order_relaxed);
+  while (prev < max_value
+	 && !value.compare_exchange_weak(prev, max_value,
+					 std::memory_order_relaxed)) {
+  }
+}
+
+// Find the strongly connected components (Tarjan's algorithm) and
+// disable the back edges of a depth first search inside each one.
+// Components are searched in parallel; the loops are recorded in
+// component order so the disabled edges do not depend on the
+// thread count.  Returns true if any loops were broken.
+bool
+Levelize::breakLoops()
+{
+  VertexSeq vertices;
+  VertexIndex index_max = 0;
+  VertexIterator vertex_iter(graph_);
+  while (vertex_iter.hasNext()) {
+    Vertex *vertex = vertex_iter.next();
+    vertices.push_back(vertex);
+    index_max = max(index_max, graph_->index(vertex));
+  }
+  std::vector<VertexSeq> sccs;
+  std::vector<int> scc_ids(index_max + 1, -1);
+  findSccs(vertices, sccs, scc_ids);
+  size_t scc_count = sccs.size();
+  debugPrint1(debug_, "levelize", 1, "%zu loop components\n", scc_count);
+  if (scc_count == 0)
+    return false;
+
+  // Search from the vertices entered from outside the component
+  // first.  Sort here because vertex names are not thread safe.
+  for (size_t scc_id = 0; scc_id < scc_count; scc_id++) {
+    VertexSeq &scc = sccs[scc_id];
+    VertexSeq entries;
+    VertexSeq interior;
+    for (Vertex *vertex : scc) {
+      vertex->setColor(LevelColor::white);
+      if (isSccEntry(vertex, scc_ids))
+	entries.push_back(vertex);
+      else
+	interior.push_back(vertex);
+    }
+    sort(entries, VertexNameLess(network_));
+    sort(interior, VertexNameLess(network_));
+    scc = entries;
+    scc.insert(scc.end(), interior.begin(), interior.end());
+  }
+
+  std::vector<EdgeSeqSeq> scc_loops(scc_count);
+  forEachChunk(scc_count, thread_pool_,
+	       [&] (size_t begin, size_t end, int) {
+		 for (size_t scc_id = begin; scc_id < end; scc_id++) {
+		   for (Vertex *vertex : sccs[scc_id]) {
+		     if (vertex->color() == LevelColor::white) {
+		       EdgeSeq path;
+		       visitScc(vertex, scc_id, scc_ids, path,
+				scc_loops[scc_id]);
+		     }
+		   }
+		 }
+	       });
+
+  for (size_t scc_id = 0; scc_id < scc_count; scc_id++) {
+    for (EdgeSeq *loop_edges : scc_loops[scc_id]) {
+      Edge *closing_edge = loop_edges->back();
+      debugPrint3(debug_, "levelize", 2, "Loop edge %s -> %s (%s)\n",
+		  closing_edge->from(graph_)->name(sdc_network_),
+		  closing_edge->to(graph_)->name(sdc_network_),
+		  closing_edge->role()->asString());
+      recordLoop(loop_edges);
+      disabled_loop_edges_.insert(closing_edge);
+    }
+    // Vertices entered only by disabled loop edges are now roots.
+    for (Vertex *vertex : sccs[scc_id]) {
+      if (isRoot(vertex))
+	roots_.insert(vertex);
+    }
+  }
+  return true;
+}
+
+// Strongly connected components with more than one vertex or a
+// vertex that is its own fanout, in the order Tarjan's algorithm
+// completes them.  The recursion is unrolled with an explicit stack
+// because loops can be very deep.
+void
+Levelize::findSccs(VertexSeq &vertices,
+		   // Return values.
+		   std::vector<VertexSeq> &sccs,
+		   std::vector<int> &scc_ids)
+{
+  struct SccFrame
+  {
+    Vertex *vertex;
+    VertexSeq fanouts;
+    size_t next;
+  };
+  size_t index_count = scc_ids.size();
+  std::vector<int> dfs_indices(index_count, -1);
+  std::vector<int> low_links(index_count, 0);
+  std::vector<bool> on_stack(index_count, false);
+  std::vector<SccFrame> frames;
+  size_t frame_count = 0;
+  VertexSeq stack;
+  int dfs_index = 0;
+  for (Vertex *root : vertices) {
+    if (dfs_indices[graph_->index(root)] >= 0)
+      continue;
+    Vertex *vertex = root;
+    while (true) {
+      if (vertex) {
+	// Enter vertex.
+	VertexIndex index = graph_->index(vertex);
+	dfs_indices[index] = dfs_index;
+	low_links[index] = dfs_index;
+	dfs_index++;
+	stack.push_back(vertex);
+	on_stack[index] = true;
+	if (frame_count == frames.size())
+	  frames.push_back(SccFrame());
+	SccFrame &frame = frames[frame_count++];
+	frame.vertex = vertex;
+	frame.fanouts.clear();
+	frame.next = 0;
+	findFanouts(vertex, frame.fanouts, nullptr);
+	vertex = nullptr;
+      }
+      if (frame_count == 0)
+	break;
+      SccFrame &frame = frames[frame_count - 1];
+      VertexIndex index = graph_->index(frame.vertex);
+      if (frame.next < frame.fanouts.size()) {
+	Vertex *to_vertex = frame.fanouts[frame.next++];
+	VertexIndex to_index = graph_->index(to_vertex);
+	if (dfs_indices[to_index] < 0)
+	  vertex = to_vertex;
+	else if (on_stack[to_index])
+	  low_links[index] = std::min(low_links[index], dfs_indices[to_index]);
+      }
+      else {
+	// Leave vertex.
+	if (low_links[index] == dfs_indices[index]) {
+	  VertexSeq scc;
+	  Vertex *scc_vertex;
+	  do {
+	    scc_vertex = stack.back();
+	    stack.pop_back();
+	    on_stack[graph_->index(scc_vertex)] = false;
+	    scc.push_back(scc_vertex);
+	  } while (scc_vertex != frame.vertex);
+	  if (scc.size() > 1
+	      || std::find(frame.fanouts.begin(), frame.fanouts.end(),
+			   frame.vertex) != frame.fanouts.end()) {
+	    int scc_id = sccs.size();
+	    for (Vertex *scc_vertex : scc)
+	      scc_ids[graph_->index(scc_vertex)] = scc_id;
+	    sccs.push_back(scc);
+	  }
+	}
+	Vertex *from_vertex = frame.vertex;
+	frame_count--;
+	if (frame_count > 0) {
+	  VertexIndex parent_index = graph_->index(frames[frame_count-1].vertex);
+	  low_links[parent_index] = std::min(low_links[parent_index],
+					     low_links[graph_->index(from_vertex)]);
+	}
+      }
+    }
+  }
+}
+
+bool
+Levelize::isSccEntry(Vertex *vertex,
+		     std::vector<int> &scc_ids)
+{
+  int scc_id = scc_ids[graph_->index(vertex)];
+  VertexInEdgeIterator edge_iter(vertex, graph_);
+  while (edge_iter.hasNext()) {
+    Edge *edge = edge_iter.next();
+    Vertex *from_vertex = edge->from(graph_);
+    if (scc_ids[graph_->index(from_vertex)] != scc_id
+	&& search_pred_->searchFrom(from_vertex)
+	&& search_pred_->searchThru(edge))
+      return true;
+  }
+  return false;
+}
+
+// Depth first search restricted to one strongly connected component.
+// Back edges are disabled and their loops appended to loops.
+void
+Levelize::visitScc(Vertex *vertex,
+		   int scc_id,
+		   std::vector<int> &scc_ids,
+		   EdgeSeq &path,
+		   // Return value.
+		   EdgeSeqSeq &loops)
+{
+  vertex->setColor(LevelColor::gray);
+  if (search_pred_->searchFrom(vertex)) {
+    VertexOutEdgeIterator edge_iter(vertex, graph_);
+    while (edge_iter.hasNext()) {
+      Edge *edge = edge_iter.next();
+      Vertex *to_vertex = edge->to(graph_);
+      if (scc_ids[graph_->index(to_vertex)] == scc_id
+	  && search_pred_->searchThru(edge)
+	  && search_pred_->searchTo(to_vertex)) {
+	LevelColor to_color = to_vertex->color();
+	if (to_color == LevelColor::gray) {
+	  // Edges in one component are only visited by one thread.
+	  edge->setIsDisabledLoop(true);
+	  loops.push_back(loopEdges(path, edge));
+	}
+	else if (to_color == LevelColor::white) {
+	  path.push_back(edge);
+	  visitScc(to_vertex, scc_id, scc_ids, path, loops);
+	  path.pop_back();
+	}
+      }
+    }
+    Pin *from_pin = vertex->pin();
+    if (sdc_->bidirectDrvrSlewFromLoad(from_pin)
+	&& !vertex->isBidirectDriver()) {
+      Vertex *to_vertex = graph_->pinDrvrVertex(from_pin);
+      if (scc_ids[graph_->index(to_vertex)] == scc_id
+	  && search_pred_->searchTo(to_vertex)
+	  && to_vertex->color() == LevelColor::white)
+	visitScc(to_vertex, scc_id, scc_ids, path, loops);
+    }
+  }
+  vertex->setColor(LevelColor::black);
+}
+
+// Vertices visit() searches from vertex, with the latch D->Q edges
+// it records appended to latch_edges.
+void
+Levelize::findFanouts(Vertex *vertex,
+		      // Return values.
+		      VertexSeq &fanouts,
+		      EdgeSeq *latch_edges)
+{
+  if (search_pred_->searchFrom(vertex)) {
+    VertexOutEdgeIterator edge_iter(vertex, graph_);
+    while (edge_iter.hasNext()) {
+      Edge *edge = edge_iter.next();
+      Vertex *to_vertex = edge->to(graph_);
+      if (search_pred_->searchThru(edge)
+	  && search_pred_->searchTo(to_vertex))
+	fanouts.push_back(to_vertex);
+      if (latch_edges
+	  && edge->role() == TimingRole::latchDtoQ())
+	latch_edges->push_back(edge);
+    }
+    // Levelize bidirect driver as if it was a fanout of the bidirect load.
+    Pin *from_pin = vertex->pin();
+    if (sdc_->bidirectDrvrSlewFromLoad(from_pin)
+	&& !vertex->isBidirectDriver()) {
+      Vertex *to_vertex = graph_->pinDrvrVertex(from_pin);
+      if (search_pred_->searchTo(to_vertex))
+	fanouts.push_back(to_vertex);
+    }
+  }
 }
 
 void
@@ -256,24 +677,37 @@ Levelize::recordLoop(Edge *edge,
 	      edge->to(graph_)->name(sdc_network_),
 	      edge->role()->asString());
   // Do not record loops if they have been invalidated.
-  if (loops_) {
-    EdgeSeq *loop_edges = loopEdges(path, edge);
-    GraphLoop *loop = new GraphLoop(loop_edges);
-    loops_->push_back(loop);
-    if (sdc_->dynamicLoopBreaking())
-      sdc_->makeLoopExceptions(loop);
-  }
+  if (loops_)
+    recordLoop(loopEdges(path, edge));
   // Record disabled loop edges so they can be cleared without
   // traversing the entire graph to find them.
   disabled_loop_edges_.insert(edge);
   edge->setIsDisabledLoop(true);
 }
 
+void
+Levelize::recordLoop(EdgeSeq *loop_edges)
+{
+  debugPrint0(debug_, "loop", 2, "Loop\n");
+  EdgeSeq::Iterator edge_iter(loop_edges);
+  while (edge_iter.hasNext()) {
+    Edge *edge = edge_iter.next();
+    debugPrint2(debug_, "loop", 2, " %s -> %s\n",
+		edge->from(graph_)->name(sdc_network_),
+		edge->to(graph_)->name(sdc_network_));
+    loop_edges_.insert(edge);
+  }
+  GraphLoop *loop = new GraphLoop(loop_edges);
+  loops_->push_back(loop);
+  if (sdc_->dynamicLoopBreaking())
+    sdc_->makeLoopExceptions(loop);
+}
+
+// Loop closed by closing_edge, which is last.
 EdgeSeq *
 Levelize::loopEdges(EdgeSeq &path,
 		    Edge *closing_edge)
 {
-  debugPrint0(debug_, "loop", 2, "Loop\n");
   EdgeSeq *loop_edges = new EdgeSeq;
   // Skip the "head" of the path up to where closing_edge closes the loop.
   Pin *loop_pin = closing_edge->to(graph_)->pin();
@@ -284,19 +718,10 @@ Levelize::loopEdges(EdgeSeq &path,
     Pin *from_pin = edge->from(graph_)->pin();
     if (from_pin == loop_pin)
       copy = true;
-    if (copy) {
-      debugPrint2(debug_, "loop", 2, " %s -> %s\n",
-		  edge->from(graph_)->name(sdc_network_),
-		  edge->to(graph_)->name(sdc_network_));
+    if (copy)
       loop_edges->push_back(edge);
-      loop_edges_.insert(edge);
-    }
   }
-  debugPrint2(debug_, "loop", 2, " %s -> %s\n",
-	      closing_edge->from(graph_)->name(sdc_network_),
-	      closing_edge->to(graph_)->name(sdc_network_));
   loop_edges->push_back(closing_edge);
-  loop_edges_.insert(closing_edge);
   return loop_edges;
 }
 
@@ -410,6 +835,15 @@ Levelize::deleteEdgeBefore(Edge *edge)
 void
 Levelize::relevelize()
 {
+  // Searching the cones of a large fraction of the graph one at a
+  // time is slower than levelizing all of it.
+  if (relevelize_from_.size() > graph_->vertexCount() / relevelize_full_divisor) {
+    debugPrint1(debug_, "levelize", 1, "relevelize %zu vertices\n",
+		relevelize_from_.size());
+    clear();
+    levelize();
+    return;
+  }
   VertexSet::Iterator vertex_iter(relevelize_from_);
   while (vertex_iter.hasNext()) {
     Vertex *vertex = vertex_iter.next();
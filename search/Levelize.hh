@@ -17,6 +17,7 @@
 #ifndef STA_LEVELIZE_H
 #define STA_LEVELIZE_H
 
+#include <vector>
 #include "DisallowCopyAssign.hh"
 #include "StaState.hh"
 #include "NetworkClass.hh"
@@ -28,6 +29,8 @@ namespace sta {
 class SearchPred;
 class LevelizeObserver;
 
+typedef std::vector<EdgeSeq*> EdgeSeqSeq;
+
 class Levelize : public StaState
 {
 public:
@@ -59,6 +62,25 @@ public:
 
 protected:
   void levelize();
+  bool levelizeAcyclic();
+  void levelizeLoops();
+  bool breakLoops();
+  void findSccs(VertexSeq &vertices,
+		// Return values.
+		std::vector<VertexSeq> &sccs,
+		std::vector<int> &scc_ids);
+  bool isSccEntry(Vertex *vertex,
+		  std::vector<int> &scc_ids);
+  void visitScc(Vertex *vertex,
+		int scc_id,
+		std::vector<int> &scc_ids,
+		EdgeSeq &path,
+		// Return value.
+		EdgeSeqSeq &loops);
+  void findFanouts(Vertex *vertex,
+		   // Return values.
+		   VertexSeq &fanouts,
+		   EdgeSeq *latch_edges);
   void findRoots();
   void sortRoots(VertexSeq &roots);
   void levelizeFrom(VertexSeq &roots);
@@ -68,6 +90,7 @@ protected:
   void clearLoopEdges();
   void deleteLoops();
   void recordLoop(Edge *edge, EdgeSeq &path);
+  void recordLoop(EdgeSeq *loop_edges);
   EdgeSeq *loopEdges(EdgeSeq &path, Edge *closing_edge);
   void ensureLatchLevels();
   void setLevel(Vertex  *vertex,
@@ -116,6 +139,8 @@ public:
   LevelizeObserver() {}
   virtual ~LevelizeObserver() {}
   virtual void levelChangedBefore(Vertex *vertex) = 0;
+  // All of the levels are invalid.
+  virtual void levelsInvalid() = 0;
 
 private:
   DISALLOW_COPY_AND_ASSIGN(LevelizeObserver);
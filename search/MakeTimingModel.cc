@@ -0,0 +1,495 @@
+// OpenSTA, Static Timing Analyzer
+// Copyright (c) 2019, Parallax Software, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#include <stdio.h>
+#include "Machine.hh"
+#include "DisallowCopyAssign.hh"
+#include "Error.hh"
+#include "MinMax.hh"
+#include "Transition.hh"
+#include "TimingRole.hh"
+#include "TimingArc.hh"
+#include "PortDirection.hh"
+#include "Network.hh"
+#include "Graph.hh"
+#include "Sdc.hh"
+#include "Corner.hh"
+#include "DcalcAnalysisPt.hh"
+#include "GraphDelayCalc.hh"
+#include "SearchPred.hh"
+#include "StaState.hh"
+#include "MakeTimingModel.hh"
+
+namespace sta {
+
+// Min/max delays from one transition at a model input to the rise
+// and fall transitions at a vertex.
+class ModelDelays
+{
+public:
+  ModelDelays();
+  bool exists(const TransRiseFall *tr) const;
+  float delay(const TransRiseFall *tr,
+	      const MinMax *min_max) const;
+  void merge(const TransRiseFall *tr,
+	     const MinMax *min_max,
+	     float delay);
+
+private:
+  float delays_[TransRiseFall::index_count][MinMax::index_count];
+};
+
+typedef UnorderedMap<Vertex*, ModelDelays> ModelDelayMap;
+
+class ModelInput
+{
+public:
+  Pin *pin;
+  Vertex *vertex;
+  bool is_clk;
+  // Indexed by the transition at the input.
+  ModelDelayMap delays[TransRiseFall::index_count];
+};
+
+typedef Vector<ModelInput*> ModelInputSeq;
+
+class TimingModelWriter : public StaState
+{
+public:
+  TimingModelWriter(const char *cell_name,
+		    const char *filename,
+		    const Corner *corner,
+		    StaState *sta);
+  ~TimingModelWriter();
+  void write();
+
+private:
+  DISALLOW_COPY_AND_ASSIGN(TimingModelWriter);
+  void findInputs();
+  void findDelays(ModelInput *input,
+		  TransRiseFall *from_tr);
+  void writeInput(ModelInput *input);
+  void writeConstraints(ModelInput *input,
+			ModelInput *clk_input,
+			TransRiseFall *clk_tr);
+  void writeOutput(const Pin *pin);
+  void writeArc(ModelInput *input,
+		Vertex *vertex,
+		TransRiseFall *from_tr);
+  void writeTable(const char *table,
+		  float value);
+  const char *pinName(const Pin *pin);
+
+  const char *cell_name_;
+  const char *filename_;
+  const Corner *corner_;
+  FILE *stream_;
+  ModelInputSeq inputs_;
+};
+
+void
+writeTimingModel(const char *cell_name,
+		 const char *filename,
+		 const Corner *corner,
+		 StaState *sta)
+{
+  TimingModelWriter writer(cell_name, filename, corner, sta);
+  writer.write();
+}
+
+TimingModelWriter::TimingModelWriter(const char *cell_name,
+				     const char *filename,
+				     const Corner *corner,
+				     StaState *sta) :
+  StaState(sta),
+  cell_name_(cell_name),
+  filename_(filename),
+  corner_(corner),
+  stream_(nullptr)
+{
+}
+
+TimingModelWriter::~TimingModelWriter()
+{
+  if (stream_)
+    fclose(stream_);
+  inputs_.deleteContents();
+}
+
+void
+TimingModelWriter::write()
+{
+  stream_ = fopen(filename_, "w");
+  if (stream_ == nullptr)
+    throw FileNotWritable(filename_);
+  findInputs();
+  fprintf(stream_, "library (%s) {\n", cell_name_);
+  fprintf(stream_, "  delay_model : table_lookup;\n");
+  fprintf(stream_, "  time_unit : \"1ns\";\n");
+  fprintf(stream_, "  voltage_unit : \"1V\";\n");
+  fprintf(stream_, "  current_unit : \"1mA\";\n");
+  fprintf(stream_, "  capacitive_load_unit (1,pf);\n");
+  fprintf(stream_, "\n");
+  fprintf(stream_, "  cell (%s) {\n", cell_name_);
+  ModelInputSeq::Iterator input_iter(inputs_);
+  while (input_iter.hasNext())
+    writeInput(input_iter.next());
+  Instance *top_inst = network_->topInstance();
+  InstancePinIterator *pin_iter = network_->pinIterator(top_inst);
+  while (pin_iter->hasNext()) {
+    Pin *pin = pin_iter->next();
+    if (network_->direction(pin)->isAnyOutput())
+      writeOutput(pin);
+  }
+  delete pin_iter;
+  fprintf(stream_, "  }\n");
+  fprintf(stream_, "}\n");
+}
+
+void
+TimingModelWriter::findInputs()
+{
+  Instance *top_inst = network_->topInstance();
+  InstancePinIterator *pin_iter = network_->pinIterator(top_inst);
+  while (pin_iter->hasNext()) {
+    Pin *pin = pin_iter->next();
+    if (network_->direction(pin)->isAnyInput()) {
+      Vertex *vertex = graph_->pinDrvrVertex(pin);
+      if (vertex) {
+	ModelInput *input = new ModelInput;
+	input->pin = pin;
+	input->vertex = vertex;
+	input->is_clk = sdc_->isClock(pin);
+	TransRiseFallIterator tr_iter;
+	while (tr_iter.hasNext())
+	  findDelays(input, tr_iter.next());
+	inputs_.push_back(input);
+      }
+    }
+  }
+  delete pin_iter;
+}
+
+// Sum the arc delays through the fanout of the input in level order.
+// Register clock to output arcs are followed so clock inputs reach the
+// outputs they launch; timing checks end the search.
+void
+TimingModelWriter::findDelays(ModelInput *input,
+			      TransRiseFall *from_tr)
+{
+  ModelDelayMap &delays = input->delays[from_tr->index()];
+  SearchPred2 pred(this);
+  VertexSeq cone;
+  cone.push_back(input->vertex);
+  ModelDelays &from_delays = delays[input->vertex];
+  from_delays.merge(from_tr, MinMax::min(), 0.0);
+  from_delays.merge(from_tr, MinMax::max(), 0.0);
+  for (size_t i = 0; i < cone.size(); i++) {
+    Vertex *vertex = cone[i];
+    if (pred.searchFrom(vertex)) {
+      VertexOutEdgeIterator edge_iter(vertex, graph_);
+      while (edge_iter.hasNext()) {
+	Edge *edge = edge_iter.next();
+	Vertex *to_vertex = edge->to(graph_);
+	if (pred.searchThru(edge)
+	    && pred.searchTo(to_vertex)
+	    && !delays.hasKey(to_vertex)) {
+	  delays[to_vertex];
+	  cone.push_back(to_vertex);
+	}
+      }
+    }
+  }
+  sort(cone, [] (const Vertex *vertex1,
+		 const Vertex *vertex2) {
+	       return vertex1->level() < vertex2->level();
+	     });
+
+  VertexSeq::Iterator cone_iter(cone);
+  while (cone_iter.hasNext()) {
+    Vertex *vertex = cone_iter.next();
+    const ModelDelays &vertex_delays = delays[vertex];
+    VertexOutEdgeIterator edge_iter(vertex, graph_);
+    while (edge_iter.hasNext()) {
+      Edge *edge = edge_iter.next();
+      Vertex *to_vertex = edge->to(graph_);
+      auto to_iter = delays.find(to_vertex);
+      if (to_iter != delays.end()
+	  && pred.searchThru(edge)) {
+	ModelDelays &to_delays = to_iter->second;
+	TimingArcSetArcIterator arc_iter(edge->timingArcSet());
+	while (arc_iter.hasNext()) {
+	  TimingArc *arc = arc_iter.next();
+	  TransRiseFall *arc_from_tr = arc->fromTrans()->asRiseFall();
+	  TransRiseFall *arc_to_tr = arc->toTrans()->asRiseFall();
+	  if (arc_from_tr && arc_to_tr
+	      && vertex_delays.exists(arc_from_tr)) {
+	    MinMaxIterator mm_iter;
+	    while (mm_iter.hasNext()) {
+	      MinMax *min_max = mm_iter.next();
+	      const DcalcAnalysisPt *dcalc_ap =
+		corner_->findDcalcAnalysisPt(min_max);
+	      ArcDelay arc_delay = graph_->arcDelay(edge, arc,
+						    dcalc_ap->index());
+	      to_delays.merge(arc_to_tr, min_max,
+			      vertex_delays.delay(arc_from_tr, min_max)
+			      + delayAsFloat(arc_delay));
+	    }
+	  }
+	}
+      }
+    }
+  }
+}
+
+void
+TimingModelWriter::writeInput(ModelInput *input)
+{
+  const DcalcAnalysisPt *dcalc_ap =
+    corner_->findDcalcAnalysisPt(MinMax::max());
+  float cap = graph_delay_calc_->loadCap(input->pin, dcalc_ap);
+  fprintf(stream_, "    pin (%s) {\n", pinName(input->pin));
+  fprintf(stream_, "      direction : input;\n");
+  if (input->is_clk)
+    fprintf(stream_, "      clock : true;\n");
+  fprintf(stream_, "      capacitance : %.6f;\n", cap * 1e+12);
+  if (!input->is_clk) {
+    ModelInputSeq::Iterator clk_iter(inputs_);
+    while (clk_iter.hasNext()) {
+      ModelInput *clk_input = clk_iter.next();
+      if (clk_input->is_clk) {
+	TransRiseFallIterator clk_tr_iter;
+	while (clk_tr_iter.hasNext())
+	  writeConstraints(input, clk_input, clk_tr_iter.next());
+      }
+    }
+  }
+  fprintf(stream_, "    }\n");
+}
+
+// Setup and hold constraints of the input relative to one edge of a
+// clock input. Setup uses the latest data and earliest clock, hold the
+// earliest data and latest clock.
+void
+TimingModelWriter::writeConstraints(ModelInput *input,
+				    ModelInput *clk_input,
+				    TransRiseFall *clk_tr)
+{
+  const ModelDelayMap &clk_delays = clk_input->delays[clk_tr->index()];
+  const DcalcAnalysisPt *max_ap = corner_->findDcalcAnalysisPt(MinMax::max());
+  const DcalcAnalysisPt *min_ap = corner_->findDcalcAnalysisPt(MinMax::min());
+  ModelDelays setups, holds;
+  TransRiseFallIterator tr_iter;
+  while (tr_iter.hasNext()) {
+    TransRiseFall *tr = tr_iter.next();
+    for (auto &vertex_delays : input->delays[tr->index()]) {
+      Vertex *vertex = vertex_delays.first;
+      const ModelDelays &data_delays = vertex_delays.second;
+      VertexInEdgeIterator edge_iter(vertex, graph_);
+      while (edge_iter.hasNext()) {
+	Edge *edge = edge_iter.next();
+	const TimingRole *role = edge->role();
+	auto clk_iter = clk_delays.find(edge->from(graph_));
+	if ((role == TimingRole::setup()
+	     || role == TimingRole::hold())
+	    && clk_iter != clk_delays.end()) {
+	  const ModelDelays &latencies = clk_iter->second;
+	  TimingArcSetArcIterator arc_iter(edge->timingArcSet());
+	  while (arc_iter.hasNext()) {
+	    TimingArc *arc = arc_iter.next();
+	    TransRiseFall *ck_tr = arc->fromTrans()->asRiseFall();
+	    TransRiseFall *data_tr = arc->toTrans()->asRiseFall();
+	    if (ck_tr && data_tr
+		&& latencies.exists(ck_tr)
+		&& data_delays.exists(data_tr)) {
+	      if (role == TimingRole::setup()) {
+		float margin = delayAsFloat(graph_->arcDelay(edge, arc,
+							     max_ap->index()));
+		setups.merge(tr, MinMax::max(),
+			     data_delays.delay(data_tr, MinMax::max())
+			     + margin
+			     - latencies.delay(ck_tr, MinMax::min()));
+	      }
+	      else {
+		float margin = delayAsFloat(graph_->arcDelay(edge, arc,
+							     min_ap->index()));
+		holds.merge(tr, MinMax::max(),
+			    latencies.delay(ck_tr, MinMax::max())
+			    + margin
+			    - data_delays.delay(data_tr, MinMax::min()));
+	      }
+	    }
+	  }
+	}
+      }
+    }
+  }
+  const char *edge_name = (clk_tr == TransRiseFall::rise())
+    ? "rising" : "falling";
+  for (int check = 0; check < 2; check++) {
+    const ModelDelays &constraints = (check == 0) ? setups : holds;
+    if (constraints.exists(TransRiseFall::rise())
+	|| constraints.exists(TransRiseFall::fall())) {
+      fprintf(stream_, "      timing () {\n");
+      fprintf(stream_, "        related_pin : \"%s\";\n",
+	      pinName(clk_input->pin));
+      fprintf(stream_, "        timing_type : %s_%s;\n",
+	      (check == 0) ? "setup" : "hold", edge_name);
+      if (constraints.exists(TransRiseFall::rise()))
+	writeTable("rise_constraint",
+		   constraints.delay(TransRiseFall::rise(), MinMax::max()));
+      if (constraints.exists(TransRiseFall::fall()))
+	writeTable("fall_constraint",
+		   constraints.delay(TransRiseFall::fall(), MinMax::max()));
+      fprintf(stream_, "      }\n");
+    }
+  }
+}
+
+void
+TimingModelWriter::writeOutput(const Pin *pin)
+{
+  fprintf(stream_, "    pin (%s) {\n", pinName(pin));
+  fprintf(stream_, "      direction : output;\n");
+  Vertex *vertex = graph_->pinLoadVertex(pin);
+  if (vertex) {
+    ModelInputSeq::Iterator input_iter(inputs_);
+    while (input_iter.hasNext()) {
+      ModelInput *input = input_iter.next();
+      if (input->is_clk) {
+	TransRiseFallIterator clk_tr_iter;
+	while (clk_tr_iter.hasNext())
+	  writeArc(input, vertex, clk_tr_iter.next());
+      }
+      else
+	writeArc(input, vertex, nullptr);
+    }
+  }
+  fprintf(stream_, "    }\n");
+}
+
+// Clock inputs have edge arcs for from_tr. Other inputs have one
+// combinational arc (from_tr null) with the unateness of the paths.
+void
+TimingModelWriter::writeArc(ModelInput *input,
+			    Vertex *vertex,
+			    TransRiseFall *from_tr)
+{
+  ModelDelays delays;
+  bool positive = false;
+  bool negative = false;
+  TransRiseFallIterator tr_iter;
+  while (tr_iter.hasNext()) {
+    TransRiseFall *tr = tr_iter.next();
+    if (from_tr == nullptr || tr == from_tr) {
+      const ModelDelayMap &tr_delays = input->delays[tr->index()];
+      auto delay_iter = tr_delays.find(vertex);
+      if (delay_iter != tr_delays.end()) {
+	const ModelDelays &vertex_delays = delay_iter->second;
+	TransRiseFallIterator to_tr_iter;
+	while (to_tr_iter.hasNext()) {
+	  TransRiseFall *to_tr = to_tr_iter.next();
+	  if (vertex_delays.exists(to_tr)) {
+	    delays.merge(to_tr, MinMax::max(),
+			 vertex_delays.delay(to_tr, MinMax::max()));
+	    if (to_tr == tr)
+	      positive = true;
+	    else
+	      negative = true;
+	  }
+	}
+      }
+    }
+  }
+  if (positive || negative) {
+    fprintf(stream_, "      timing () {\n");
+    fprintf(stream_, "        related_pin : \"%s\";\n", pinName(input->pin));
+    if (from_tr)
+      fprintf(stream_, "        timing_type : %s;\n",
+	      (from_tr == TransRiseFall::rise())
+	      ? "rising_edge" : "falling_edge");
+    else
+      fprintf(stream_, "        timing_sense : %s;\n",
+	      (positive && negative) ? "non_unate"
+	      : (positive ? "positive_unate" : "negative_unate"));
+    const DcalcAnalysisPt *dcalc_ap =
+      corner_->findDcalcAnalysisPt(MinMax::max());
+    TransRiseFallIterator to_tr_iter;
+    while (to_tr_iter.hasNext()) {
+      TransRiseFall *to_tr = to_tr_iter.next();
+      if (delays.exists(to_tr)) {
+	bool rise = (to_tr == TransRiseFall::rise());
+	writeTable(rise ? "cell_rise" : "cell_fall",
+		   delays.delay(to_tr, MinMax::max()));
+	Slew slew = graph_->slew(vertex, to_tr, dcalc_ap->index());
+	writeTable(rise ? "rise_transition" : "fall_transition",
+		   delayAsFloat(slew));
+      }
+    }
+    fprintf(stream_, "      }\n");
+  }
+}
+
+void
+TimingModelWriter::writeTable(const char *table,
+			      float value)
+{
+  fprintf(stream_, "        %s (scalar) {\n", table);
+  fprintf(stream_, "          values (\"%.6f\");\n", value * 1e+9);
+  fprintf(stream_, "        }\n");
+}
+
+const char *
+TimingModelWriter::pinName(const Pin *pin)
+{
+  return network_->portName(pin);
+}
+
+////////////////////////////////////////////////////////////////
+
+ModelDelays::ModelDelays()
+{
+  for (int tr_index = 0; tr_index < TransRiseFall::index_count; tr_index++) {
+    delays_[tr_index][MinMax::minIndex()] = MinMax::min()->initValue();
+    delays_[tr_index][MinMax::maxIndex()] = MinMax::max()->initValue();
+  }
+}
+
+bool
+ModelDelays::exists(const TransRiseFall *tr) const
+{
+  return delays_[tr->index()][MinMax::maxIndex()]
+    != MinMax::max()->initValue();
+}
+
+float
+ModelDelays::delay(const TransRiseFall *tr,
+		   const MinMax *min_max) const
+{
+  return delays_[tr->index()][min_max->index()];
+}
+
+void
+ModelDelays::merge(const TransRiseFall *tr,
+		   const MinMax *min_max,
+		   float delay)
+{
+  float &value = delays_[tr->index()][min_max->index()];
+  if (min_max->compare(delay, value))
+    value = delay;
+}
+
+} // namespace
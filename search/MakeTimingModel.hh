@@ -0,0 +1,43 @@
+// OpenSTA, Static Timing Analyzer
+// Copyright (c) 2019, Parallax Software, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#ifndef STA_MAKE_TIMING_MODEL_H
+#define STA_MAKE_TIMING_MODEL_H
+
+namespace sta {
+
+class StaState;
+class Corner;
+
+// Extracted timing models replace a timed block with a liberty cell
+// that has only its interface timing. The delays through the block
+// are summed from the graph arc delays of the corner so the model
+// holds the delays for the block's current boundary slews and loads.
+//  input to output      combinational arcs
+//  clock to output      rising_edge/falling_edge arcs through registers
+//  input to register    setup_rising/hold_rising and the falling
+//                       equivalents relative to the clock port
+// Delays and constraints use scalar tables.
+
+// Throws FileNotWritable.
+void
+writeTimingModel(const char *cell_name,
+		 const char *filename,
+		 const Corner *corner,
+		 StaState *sta);
+
+} // namespace
+#endif
@@ -0,0 +1,289 @@
+// OpenSTA, Static Timing Analyzer
+// Copyright (c) 2019, Parallax Software, Inc.
+// 
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+// 
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+// 
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#include <string.h>  // memcpy
+#include <vector>
+#include "Machine.hh"
+#include "ThreadForEach.hh"
+#include "TimingRole.hh"
+#include "TimingArc.hh"
+#include "Liberty.hh"
+#include "Network.hh"
+#include "Sdc.hh"
+#include "Graph.hh"
+#include "DcalcAnalysisPt.hh"
+#include "ArcDelayCalc.hh"
+#include "GraphDelayCalc.hh"
+#include "PathAnalysisPt.hh"
+#include "PathRef.hh"
+#include "PathEnd.hh"
+#include "PathExpanded.hh"
+#include "Search.hh"
+#include "PathBasedTiming.hh"
+
+namespace sta {
+
+PbaDelayKey::PbaDelayKey(const Edge *edge,
+			 const TimingArc *arc,
+			 const Edge *wire_edge,
+			 DcalcAPIndex ap_index,
+			 float in_slew) :
+  edge_(edge),
+  arc_(arc),
+  wire_edge_(wire_edge),
+  ap_index_(ap_index),
+  in_slew_(in_slew)
+{
+}
+
+bool
+PbaDelayKey::operator==(const PbaDelayKey &key) const
+{
+  return edge_ == key.edge_
+    && arc_ == key.arc_
+    && wire_edge_ == key.wire_edge_
+    && ap_index_ == key.ap_index_
+    && in_slew_ == key.in_slew_;
+}
+
+size_t
+PbaDelayKeyHash::operator()(const PbaDelayKey &key) const
+{
+  uint32_t slew_bits;
+  memcpy(&slew_bits, &key.in_slew_, sizeof(slew_bits));
+  size_t hash = reinterpret_cast<uintptr_t>(key.edge_) >> 3;
+  hash = hash * 31 + (reinterpret_cast<uintptr_t>(key.arc_) >> 3);
+  hash = hash * 31 + (reinterpret_cast<uintptr_t>(key.wire_edge_) >> 3);
+  hash = hash * 31 + key.ap_index_;
+  return hash * 31 + slew_bits;
+}
+
+PbaDelay::PbaDelay() :
+  gate_delay_(delay_zero),
+  drvr_slew_(delay_zero),
+  wire_delay_(delay_zero),
+  load_slew_(delay_zero),
+  wire_valid_(false)
+{
+}
+
+////////////////////////////////////////////////////////////////
+
+PathBasedTiming::PathBasedTiming(const StaState *sta) :
+  StaState(sta),
+  delay_calc_count_(0),
+  cache_hit_count_(0)
+{
+}
+
+void
+PathBasedTiming::findSlacks(const PathEndSeq &path_ends,
+			    // Return value.
+			    SlackSeq &slacks)
+{
+  delay_calc_count_ = 0;
+  cache_hit_count_ = 0;
+  slacks.resize(path_ends.size());
+  // Arc delay calculators keep the state of the last gate delay for
+  // loadDelay, so each thread needs its own.
+  int thread_count = thread_pool_ ? thread_pool_->threadCount() : 1;
+  std::vector<ArcDelayCalc*> arc_delay_calcs;
+  for (int i = 0; i < thread_count; i++)
+    arc_delay_calcs.push_back(arc_delay_calc_->copy());
+  forEachChunk(path_ends.size(), thread_pool_,
+	       [&] (size_t begin, size_t end, int thread_index) {
+		 ArcDelayCalc *arc_delay_calc = arc_delay_calcs[thread_index];
+		 for (size_t i = begin; i < end; i++)
+		   slacks[i] = findSlack(path_ends[i], arc_delay_calc);
+	       });
+  for (auto arc_delay_calc : arc_delay_calcs)
+    delete arc_delay_calc;
+  // Parasitics and loads may change before the next call.
+  delay_cache_.clear();
+}
+
+Slack
+PathBasedTiming::findSlack(const PathEnd *path_end,
+			   ArcDelayCalc *arc_delay_calc)
+{
+  const Path *path = path_end->path();
+  Slack slack = path_end->slack(this);
+  if (path_end->isUnconstrained())
+    return slack;
+  Arrival arrival = findArrival(path, arc_delay_calc);
+  Arrival arrival_diff = arrival - path->arrival(this);
+  if (path_end->minMax(this) == MinMax::max())
+    return slack - arrival_diff;
+  else
+    return slack + arrival_diff;
+}
+
+// Data path arrival at the end of path with delays found from the
+// slews along the path.
+Arrival
+PathBasedTiming::findArrival(const Path *path,
+			     ArcDelayCalc *arc_delay_calc)
+{
+  PathExpanded expanded(path, this);
+  const PathAnalysisPt *path_ap = path->pathAnalysisPt(this);
+  const DcalcAnalysisPt *dcalc_ap = path_ap->dcalcAnalysisPt();
+  DcalcAPIndex ap_index = dcalc_ap->index();
+  size_t start_index = expanded.startIndex();
+  PathRef *start_path = expanded.path(start_index);
+  Arrival arrival = start_path->arrival(this);
+  Slew slew = start_path->slew(this);
+  // Wire delay to the next pin on the path found with the gate delay.
+  PbaDelay delay;
+  for (size_t i = start_index + 1; i < expanded.size(); i++) {
+    PathRef *to_path = expanded.path(i);
+    PathRef *from_path = expanded.path(i - 1);
+    TimingArc *arc = expanded.prevArc(i);
+    Edge *edge = to_path->prevEdge(arc, this);
+    ArcDelay arc_delay;
+    if (edge->role()->isWire()) {
+      if (delay.wire_valid_) {
+	arc_delay = delay.wire_delay_;
+	slew = delay.load_slew_;
+      }
+      else {
+	arc_delay = graph_->arcDelay(edge, arc, ap_index);
+	slew = to_path->slew(this);
+      }
+      delay.wire_valid_ = false;
+    }
+    else {
+      Edge *wire_edge = nullptr;
+      if (i + 1 < expanded.size()) {
+	PathRef *next_path = expanded.path(i + 1);
+	TimingArc *next_arc = expanded.prevArc(i + 1);
+	if (next_arc && next_arc->role()->isWire()) {
+	  wire_edge = next_path->prevEdge(next_arc, this);
+	  if (graph_->arcDelayAnnotated(wire_edge, next_arc, ap_index))
+	    wire_edge = nullptr;
+	}
+      }
+      if (gateDelay(edge, arc, slew, wire_edge, dcalc_ap,
+		    arc_delay_calc, delay)) {
+	arc_delay = delay.gate_delay_;
+	slew = delay.drvr_slew_;
+      }
+      else {
+	arc_delay = graph_->arcDelay(edge, arc, ap_index);
+	slew = to_path->slew(this);
+	delay.wire_valid_ = false;
+      }
+    }
+    Vertex *from_vertex = from_path->vertex(this);
+    float derate = search_->timingDerate(from_vertex, arc, edge, false,
+					 path_ap);
+    arrival += arc_delay * derate;
+  }
+  return arrival;
+}
+
+// Return false if the graph based delay should be used.
+bool
+PathBasedTiming::gateDelay(Edge *edge,
+			   TimingArc *arc,
+			   const Slew &in_slew,
+			   Edge *wire_edge,
+			   const DcalcAnalysisPt *dcalc_ap,
+			   ArcDelayCalc *arc_delay_calc,
+			   // Return value.
+			   PbaDelay &delay)
+{
+  DcalcAPIndex ap_index = dcalc_ap->index();
+  if (edge->role()->isTimingCheck()
+      || arc->fromTrans()->asRiseFall() == nullptr
+      || arc->toTrans()->asRiseFall() == nullptr
+      || graph_->arcDelayAnnotated(edge, arc, ap_index)
+      || network_->libertyCell(network_->instance(edge->to(graph_)->pin()))
+      == nullptr
+      || graph_delay_calc_->isMultiDrvr(edge->to(graph_)))
+    return false;
+  if (pocv_enabled_) {
+    findGateDelay(edge, arc, in_slew, wire_edge, dcalc_ap, arc_delay_calc,
+		  delay);
+    delay_calc_count_++;
+  }
+  else {
+    PbaDelayKey key(edge, arc, wire_edge, ap_index, delayAsFloat(in_slew));
+    bool exists;
+    {
+      std::lock_guard<std::mutex> lock(delay_cache_.lock(key));
+      delay_cache_.findKey(key, delay, exists);
+    }
+    if (exists)
+      cache_hit_count_++;
+    else {
+      findGateDelay(edge, arc, in_slew, wire_edge, dcalc_ap, arc_delay_calc,
+		    delay);
+      delay_calc_count_++;
+      std::lock_guard<std::mutex> lock(delay_cache_.lock(key));
+      delay_cache_.insert(key, delay);
+    }
+  }
+  return true;
+}
+
+void
+PathBasedTiming::findGateDelay(Edge *edge,
+			       TimingArc *arc,
+			       const Slew &in_slew,
+			       Edge *wire_edge,
+			       const DcalcAnalysisPt *dcalc_ap,
+			       ArcDelayCalc *arc_delay_calc,
+			       // Return value.
+			       PbaDelay &delay)
+{
+  const TransRiseFall *drvr_tr = arc->toTrans()->asRiseFall();
+  const Pin *drvr_pin = edge->to(graph_)->pin();
+  Instance *drvr_inst = network_->instance(drvr_pin);
+  const LibertyCell *drvr_cell = network_->libertyCell(drvr_inst);
+  const Pvt *pvt = sdc_->pvt(drvr_inst, dcalc_ap->constraintMinMax());
+  if (pvt == nullptr)
+    pvt = dcalc_ap->operatingConditions();
+  Parasitic *parasitic = arc_delay_calc->findParasitic(drvr_pin, drvr_tr,
+						       dcalc_ap);
+  float load_cap = graph_delay_calc_->loadCap(drvr_pin, parasitic, drvr_tr,
+					      dcalc_ap);
+  float related_out_cap = 0.0;
+  const LibertyPort *related_out_port = edge->timingArcSet()->relatedOut();
+  if (related_out_port) {
+    const Pin *related_out_pin = network_->findPin(drvr_inst,
+						   related_out_port);
+    if (related_out_pin) {
+      Parasitic *related_out_parasitic =
+	arc_delay_calc->findParasitic(related_out_pin, drvr_tr, dcalc_ap);
+      related_out_cap = graph_delay_calc_->loadCap(related_out_pin,
+						   related_out_parasitic,
+						   drvr_tr, dcalc_ap);
+    }
+  }
+  arc_delay_calc->gateDelay(drvr_cell, arc, in_slew, load_cap, parasitic,
+			    related_out_cap, pvt, dcalc_ap,
+			    delay.gate_delay_, delay.drvr_slew_);
+  if (wire_edge) {
+    arc_delay_calc->loadDelay(wire_edge->to(graph_)->pin(),
+			      delay.wire_delay_, delay.load_slew_);
+    delay.wire_valid_ = true;
+  }
+  else
+    delay.wire_valid_ = false;
+  arc_delay_calc->finishDrvrPin();
+}
+
+} // namespace
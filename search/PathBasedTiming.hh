@@ -0,0 +1,126 @@
+// OpenSTA, Static Timing Analyzer
+// Copyright (c) 2019, Parallax Software, Inc.
+// 
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+// 
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+// 
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#ifndef STA_PATH_BASED_TIMING_H
+#define STA_PATH_BASED_TIMING_H
+
+#include <stddef.h>  // size_t
+#include <atomic>
+#include "DisallowCopyAssign.hh"
+#include "StripedMap.hh"
+#include "GraphClass.hh"
+#include "Delay.hh"
+#include "SearchClass.hh"
+#include "StaState.hh"
+
+namespace sta {
+
+class ArcDelayCalc;
+class DcalcAnalysisPt;
+
+// Gate arc with the input slew and the wire from the driver on the path.
+class PbaDelayKey
+{
+public:
+  PbaDelayKey(const Edge *edge,
+	      const TimingArc *arc,
+	      const Edge *wire_edge,
+	      DcalcAPIndex ap_index,
+	      float in_slew);
+  bool operator==(const PbaDelayKey &key) const;
+
+  const Edge *edge_;
+  const TimingArc *arc_;
+  const Edge *wire_edge_;
+  DcalcAPIndex ap_index_;
+  float in_slew_;
+};
+
+class PbaDelayKeyHash
+{
+public:
+  size_t operator()(const PbaDelayKey &key) const;
+};
+
+class PbaDelay
+{
+public:
+  PbaDelay();
+
+  ArcDelay gate_delay_;
+  Slew drvr_slew_;
+  ArcDelay wire_delay_;
+  Slew load_slew_;
+  bool wire_valid_;
+};
+
+typedef StripedMap<PbaDelayKey, PbaDelay, PbaDelayKeyHash> PbaDelayCache;
+
+// Path based analysis (PBA).
+// Graph based analysis propagates the worst slew at each vertex, so
+// path delays use slews from other paths thru the same pins. Path
+// based analysis finds the gate and wire delays along the data path
+// of a path end again with the slews of the path itself.
+// Clock paths, timing check margins, annotated delays and multiple
+// driver nets keep the graph based values.
+// Path ends are retimed in parallel. Paths that share a gate arc with
+// the same input slew, such as the common prefix of paths from one
+// startpoint, share one delay calculation.
+class PathBasedTiming : public StaState
+{
+public:
+  explicit PathBasedTiming(const StaState *sta);
+  // Find the path based slack of each path end.
+  void findSlacks(const PathEndSeq &path_ends,
+		  // Return value.
+		  SlackSeq &slacks);
+  // Delay calculations and cache hits of the last findSlacks.
+  size_t delayCalcCount() const { return delay_calc_count_; }
+  size_t cacheHitCount() const { return cache_hit_count_; }
+
+protected:
+  Slack findSlack(const PathEnd *path_end,
+		  ArcDelayCalc *arc_delay_calc);
+  Arrival findArrival(const Path *path,
+		      ArcDelayCalc *arc_delay_calc);
+  bool gateDelay(Edge *edge,
+		 TimingArc *arc,
+		 const Slew &in_slew,
+		 Edge *wire_edge,
+		 const DcalcAnalysisPt *dcalc_ap,
+		 ArcDelayCalc *arc_delay_calc,
+		 // Return value.
+		 PbaDelay &delay);
+  void findGateDelay(Edge *edge,
+		     TimingArc *arc,
+		     const Slew &in_slew,
+		     Edge *wire_edge,
+		     const DcalcAnalysisPt *dcalc_ap,
+		     ArcDelayCalc *arc_delay_calc,
+		     // Return value.
+		     PbaDelay &delay);
+
+  // Shared by the threads retiming paths.
+  PbaDelayCache delay_cache_;
+  std::atomic<size_t> delay_calc_count_;
+  std::atomic<size_t> cache_hit_count_;
+
+private:
+  DISALLOW_COPY_AND_ASSIGN(PathBasedTiming);
+};
+
+} // namespace
+#endif
@@ -14,6 +14,7 @@
 // You should have received a copy of the GNU General Public License
 // along with this program.  If not, see <https://www.gnu.org/licenses/>.
 
+#include <limits>
 #include "Machine.hh"
 #include "DisallowCopyAssign.hh"
 #include "Debug.hh"
@@ -47,21 +48,27 @@ class Diversion
 {
 public:
   Diversion(PathEnd *path_end,
-	    Path *after_div);
+	    Path *after_div,
+	    int path_enumed_count);
   PathEnd *pathEnd() const { return path_end_; }
   Path *divPath() const { return after_div_; }
+  // Number of PathEnumed objects in the diverted path.
+  int pathEnumedCount() const { return path_enumed_count_; }
 
 private:
   DISALLOW_COPY_AND_ASSIGN(Diversion);
 
   PathEnd *path_end_;
   Path *after_div_;
+  int path_enumed_count_;
 };
 
 Diversion::Diversion(PathEnd *path_end,
-		     Path *after_div) :
+		     Path *after_div,
+		     int path_enumed_count) :
   path_end_(path_end),
-  after_div_(after_div)
+  after_div_(after_div),
+  path_enumed_count_(path_enumed_count)
 {
 }
 
@@ -99,6 +106,9 @@ deleteDiversionPathEnd(Diversion *div)
 
 ////////////////////////////////////////////////////////////////
 
+// PathEnumed objects in the diversion queue before it is pruned.
+static const int path_enumed_limit = 1 << 22;
+
 PathEnum::PathEnum(int group_count,
 		   int endpoint_count,
 		   bool unique_pins,
@@ -111,6 +121,14 @@ PathEnum::PathEnum(int group_count,
   unique_pins_(unique_pins),
   div_queue_(DiversionGreater(sta)),
   div_count_(0),
+  prune_count_(0),
+  report_count_(0),
+  path_enumed_count_(0),
+  path_enumed_count_max_(0),
+  div_queue_limit_(group_count < std::numeric_limits<int>::max() / 4
+		   ? group_count * 4
+		   : std::numeric_limits<int>::max()),
+  path_enumed_limit_(path_enumed_limit),
   inserts_pruned_(false),
   next_(nullptr)
 {
@@ -126,13 +144,19 @@ PathEnum::insert(PathEnd *path_end)
 	      cmp_slack_ ? "slack" : "delay",
 	      delayAsString(cmp_slack_ ? path_end->slack(this) :
 			    path_end->dataArrivalTime(this), this));
-  Diversion *div = new Diversion(path_end, path_end->path());
+  Diversion *div = new Diversion(path_end, path_end->path(), 0);
   div_queue_.push(div);
   div_count_++;
 }
 
 PathEnum::~PathEnum()
 {
+  debugPrint4(debug_, "path_enum", 1,
+	      "diversions %d pruned %d reported %d path_enumed max %d\n",
+	      div_count_,
+	      prune_count_,
+	      report_count_,
+	      path_enumed_count_max_);
   while (!div_queue_.empty()) {
     Diversion *div = div_queue_.top();
     deleteDiversionPathEnd(div);
@@ -172,6 +196,7 @@ PathEnum::findNext()
   while (!div_queue_.empty()) {
     Diversion *div = div_queue_.top();
     div_queue_.pop();
+    path_enumed_count_ -= div->pathEnumedCount();
     PathEnd *path_end = div->pathEnd();
     Vertex *vertex = path_end->vertex(this);
     if (debug_->check("path_enum", 2)) {
@@ -190,6 +215,7 @@ PathEnum::findNext()
       makeDiversions(path_end, div->divPath());
       // Caller owns the path end now, so don't delete it.
       next_ = path_end;
+      report_count_++;
       delete div;
       break;
     }
@@ -198,6 +224,7 @@ PathEnum::findNext()
       debugPrint1(debug_, "path_enum", 1, "endpoint_count reached for %s\n",
 		  vertex->name(sdc_network_));
       deleteDiversionPathEnd(div);
+      prune_count_++;
     }
   }
 }
@@ -256,7 +283,8 @@ private:
 			   TimingArc *div_arc,
 			   // Return values.
 			   PathEnd *&div_end,
-			   PathEnumed *&after_div_copy);
+			   PathEnumed *&after_div_copy,
+			   int &path_enumed_count);
   void reportDiversion(TimingArc *div_arc,
 		       Path *after_div);
 
@@ -345,12 +373,14 @@ PathEnumFaninVisitor::visitFromToPath(const Pin *,
     if (crpr_active_) {
       PathEnd *div_end;
       PathEnumed *after_div_copy;
+      int path_enumed_count;
       // Make the diverted path end to check slack with from_path crpr.
-      makeDivertedPathEnd(from_path, arc, div_end, after_div_copy);
+      makeDivertedPathEnd(from_path, arc, div_end, after_div_copy,
+			  path_enumed_count);
       // Only enumerate paths with greater slack.
       if (fuzzyGreaterEqual(div_end->slack(sta_), path_end_slack_)) {
 	reportDiversion(arc, from_path);
-	path_enum_->makeDiversion(div_end, after_div_copy);
+	path_enum_->makeDiversion(div_end, after_div_copy, path_enumed_count);
       }
       else
 	delete div_end;
@@ -359,9 +389,11 @@ PathEnumFaninVisitor::visitFromToPath(const Pin *,
     else if (fuzzyLessEqual(to_arrival, before_div_arrival_, min_max)) {
       PathEnd *div_end;
       PathEnumed *after_div_copy;
-      makeDivertedPathEnd(from_path, arc, div_end, after_div_copy);
+      int path_enumed_count;
+      makeDivertedPathEnd(from_path, arc, div_end, after_div_copy,
+			  path_enumed_count);
       reportDiversion(arc, from_path);
-      path_enum_->makeDiversion(div_end, after_div_copy);
+      path_enum_->makeDiversion(div_end, after_div_copy, path_enumed_count);
     }
   }
   return true;
@@ -372,11 +404,13 @@ PathEnumFaninVisitor::makeDivertedPathEnd(Path *after_div,
 					  TimingArc *div_arc,
 					  // Return values.
 					  PathEnd *&div_end,
-					  PathEnumed *&after_div_copy)
+					  PathEnumed *&after_div_copy,
+					  int &path_enumed_count)
 {
   PathEnumed *div_path;
   path_enum_->makeDivertedPath(path_end_->path(), &before_div_, after_div,
-			       div_arc, div_path, after_div_copy);
+			       div_arc, div_path, after_div_copy,
+			       path_enumed_count);
   div_end = path_end_->copy();
   div_end->setPath(div_path, sta_);
 }
@@ -419,15 +453,27 @@ PathEnumFaninVisitor::reportDiversion(TimingArc *div_arc,
 //      <--...--before_div<--...--path<---path_end
 void
 PathEnum::makeDiversion(PathEnd *div_end,
-			PathEnumed *after_div_copy)
+			PathEnumed *after_div_copy,
+			int path_enumed_count)
 {
-  Diversion *div = new Diversion(div_end, after_div_copy);
+  Diversion *div = new Diversion(div_end, after_div_copy, path_enumed_count);
   div_queue_.push(div);
   div_count_++;
-
-  if (static_cast<int>(div_queue_.size()) > group_count_ * 2)
-    // We have more potenial paths than we will need.
+  path_enumed_count_ += path_enumed_count;
+  if (path_enumed_count_ > path_enumed_count_max_)
+    path_enumed_count_max_ = path_enumed_count_;
+
+  // Diversions are normally pruned after all of the diversions for a
+  // path are made. Prune now if the queue or the paths it owns
+  // are over the hard limits.
+  if (static_cast<int>(div_queue_.size()) > div_queue_limit_
+      || path_enumed_count_ > path_enumed_limit_) {
     pruneDiversionQueue();
+    // The queue is never pruned below group_count diversions, so move
+    // the limit out of the way when they alone are over it.
+    if (path_enumed_count_ > path_enumed_limit_ / 2)
+      path_enumed_limit_ = path_enumed_count_ * 2;
+  }
 }
 
 void
@@ -448,8 +494,11 @@ PathEnum::pruneDiversionQueue()
       path_counts[vertex]++;
       end_count++;
     }
-    else
+    else {
+      path_enumed_count_ -= div->pathEnumedCount();
       deleteDiversionPathEnd(div);
+      prune_count_++;
+    }
     div_queue_.pop();
   }
 
@@ -516,6 +565,12 @@ PathEnum::makeDiversions(PathEnd *path_end,
 	   && prev_arc->role() != TimingRole::latchDtoQ()
 	   // Do not enumerate paths in the clk network.
 	   && !path.isClock(this));
+
+  // The diversions for the whole path are queued before pruning so
+  // the queue is pruned once per path instead of once per diversion.
+  if (static_cast<int>(div_queue_.size()) > group_count_ * 2)
+    // We have more potenial paths than we will need.
+    pruneDiversionQueue();
 }
 
 void
@@ -525,7 +580,8 @@ PathEnum::makeDivertedPath(Path *path,
 			   TimingArc *div_arc,
 			   // Returned values.
 			   PathEnumed *&div_path,
-			   PathEnumed *&after_div_copy)
+			   PathEnumed *&after_div_copy,
+			   int &path_enumed_count)
 {
   // Copy the diversion path.
   bool found_div = false;
@@ -572,6 +628,7 @@ PathEnum::makeDivertedPath(Path *path,
   }
   if (!found_div)
     internalError("diversion path not found");
+  path_enumed_count = copies.size();
 }
 
 void
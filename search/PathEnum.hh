@@ -69,14 +69,16 @@ private:
   void makeDiversions(PathEnd *path_end,
 		      Path *before);
   void makeDiversion(PathEnd *div_end,
-		     PathEnumed *after_div_copy);
+		     PathEnumed *after_div_copy,
+		     int path_enumed_count);
   void makeDivertedPath(Path *path,
 			Path *before_div,
 			Path *after_div,
 			TimingArc *div_arc,
 			// Returned values.
 			PathEnumed *&div_path,
-			PathEnumed *&after_div_copy);
+			PathEnumed *&after_div_copy,
+			int &path_enumed_count);
   void updatePathHeadDelays(PathEnumedSeq &path,
 			    Path *after_div);
   Arrival divSlack(Path *path,
@@ -94,7 +96,18 @@ private:
   int endpoint_count_;
   bool unique_pins_;
   DiversionQueue div_queue_;
+  // Diversions made.
   int div_count_;
+  // Diversions deleted without being reported.
+  int prune_count_;
+  // Paths returned by next.
+  int report_count_;
+  // PathEnumed objects owned by the diversions in the queue.
+  int path_enumed_count_;
+  int path_enumed_count_max_;
+  // Hard limits on the queue size and the PathEnumed objects it owns.
+  int div_queue_limit_;
+  int path_enumed_limit_;
   // Number of paths returned for each endpoint (limited to endpoint_count).
   VertexPathCountMap path_counts_;
   bool inserts_pruned_;
@@ -33,6 +33,7 @@
 #include "VisitPathEnds.hh"
 #include "PathEnum.hh"
 #include "ThreadForEach.hh"
+#include "VertexBitSet.hh"
 #include "PathGroup.hh"
 
 namespace sta {
@@ -82,6 +83,10 @@ PathGroup::PathGroup(const char *name,
   min_max_(min_max),
   compare_slack_(cmp_slack),
   threshold_(min_max->initValue()),
+  sorted_(false),
+  pruned_(false),
+  update_pruned_(false),
+  update_threshold_(threshold_),
   sta_(sta)
 {
 }
@@ -122,6 +127,27 @@ PathGroup::insert(PathEnd *path_end)
 {
   UniqueLock lock(lock_);
   path_ends_.push_back(path_end);
+  sorted_ = false;
+  if (group_count_ != group_count_max
+      && static_cast<int>(path_ends_.size()) > group_count_ * 2)
+    prune();
+}
+
+PathGroup *
+PathGroup::makeLocalGroup() const
+{
+  return new PathGroup(name_, group_count_, endpoint_count_, unique_pins_,
+		       slack_min_, slack_max_, compare_slack_, min_max_, sta_);
+}
+
+void
+PathGroup::mergeEnds(PathGroup *local_group)
+{
+  UniqueLock lock(lock_);
+  for (auto path_end : local_group->path_ends_)
+    path_ends_.push_back(path_end);
+  local_group->path_ends_.clear();
+  sorted_ = false;
   if (group_count_ != group_count_max
       && static_cast<int>(path_ends_.size()) > group_count_ * 2)
     prune();
@@ -146,6 +172,7 @@ PathGroup::prune()
       delete path_end;
   }
   path_ends_.resize(end_count);
+  pruned_ = true;
 
   // Set a threshold to the bottom of the sorted list that future
   // inserts need to beat.
@@ -179,7 +206,7 @@ PathGroup::ensureSortedMaxPaths()
 {
   if (static_cast<int>(path_ends_.size()) > group_count_)
     prune();
-  else
+  else if (!sorted_)
     sort();
 }
 
@@ -187,6 +214,7 @@ void
 PathGroup::sort()
 {
   sta::sort(path_ends_, PathEndLess(sta_));
+  sorted_ = true;
 }
 
 void
@@ -195,6 +223,45 @@ PathGroup::clear()
   UniqueLock lock(lock_);
   threshold_ = min_max_->initValue();
   path_ends_.clear();
+  sorted_ = false;
+  pruned_ = false;
+}
+
+void
+PathGroup::removeEnds(const VertexBitSet &vertices)
+{
+  update_pruned_ = pruned_;
+  update_threshold_ = threshold_;
+  const Graph *graph = sta_->graph();
+  size_t end_count = 0;
+  for (auto path_end : path_ends_) {
+    if (vertices.hasKey(path_end->vertex(sta_), graph))
+      delete path_end;
+    else
+      path_ends_[end_count++] = path_end;
+  }
+  path_ends_.resize(end_count);
+}
+
+bool
+PathGroup::updateComplete()
+{
+  ensureSortedMaxPaths();
+  if (!update_pruned_)
+    // No path ends were pruned so all of the savable ones are here.
+    return true;
+  else if (static_cast<int>(path_ends_.size()) < group_count_)
+    return false;
+  else {
+    // Pruned path ends were no better than the old threshold.
+    PathEnd *last_end = path_ends_.back();
+    if (compare_slack_)
+      return fuzzyLessEqual(delayAsFloat(last_end->slack(sta_)),
+			    update_threshold_);
+    else
+      return fuzzyGreaterEqual(delayAsFloat(last_end->dataArrivalTime(sta_)),
+			       update_threshold_, min_max_);
+  }
 }
 
 ////////////////////////////////////////////////////////////////
@@ -422,6 +489,44 @@ PathGroups::groupPathTo(const PathEnd *path_end) const
   return dynamic_cast<GroupPath*>(exception);
 }
 
+void
+PathGroups::groups(// Return value.
+		   Vector<PathGroup*> &groups) const
+{
+  MinMaxIterator mm_iter;
+  while (mm_iter.hasNext()) {
+    MinMax *min_max = mm_iter.next();
+    int mm_index = min_max->index();
+    PathGroupNamedMap::ConstIterator named_iter(named_map_[mm_index]);
+    while (named_iter.hasNext())
+      groups.push_back(named_iter.next());
+    PathGroupClkMap::ConstIterator clk_iter(clk_map_[mm_index]);
+    while (clk_iter.hasNext())
+      groups.push_back(clk_iter.next());
+    PathGroup *mm_groups[] = {path_delay_[mm_index],
+			      gated_clk_[mm_index],
+			      async_[mm_index],
+			      unconstrained_[mm_index]};
+    for (auto group : mm_groups) {
+      if (group)
+	groups.push_back(group);
+    }
+  }
+}
+
+// Sort the path ends of all of the groups in parallel.
+void
+PathGroups::sortGroupPathEnds()
+{
+  Vector<PathGroup*> groups;
+  this->groups(groups);
+  forEachChunk(groups.size(), thread_pool_,
+	       [&] (size_t begin, size_t end, int) {
+		 for (size_t i = begin; i < end; i++)
+		   groups[i]->ensureSortedMaxPaths();
+	       });
+}
+
 void
 PathGroups::pushGroupPathEnds(PathEndSeq *path_ends)
 {
@@ -499,11 +604,23 @@ PathGroups::makePathEnds(ExceptionTo *to,
 			 const MinMaxAll *min_max,
 			 bool sort_by_slack)
 {
-  Stats stats(this->debug());
+  Stats stats(this->debug(), this->phaseStats());
   makeGroupPathEnds(to, group_count_, endpoint_count_, unique_pins_,
 		    corner, min_max);
+  PathEndSeq *path_ends = groupPathEnds(unconstrained_paths, min_max,
+					sort_by_slack);
+  stats.setVisitCount(path_ends->size());
+  stats.report("Make path ends");
+  return path_ends;
+}
 
+PathEndSeq *
+PathGroups::groupPathEnds(bool unconstrained_paths,
+			  const MinMaxAll *min_max,
+			  bool sort_by_slack)
+{
   PathEndSeq *path_ends = new PathEndSeq;
+  sortGroupPathEnds();
   pushGroupPathEnds(path_ends);
   if (sort_by_slack) {
     sort(path_ends, PathEndLess(this));
@@ -515,20 +632,77 @@ PathGroups::makePathEnds(ExceptionTo *to,
       && path_ends->empty())
     // No constrained paths, so report unconstrained paths.
     pushUnconstrainedPathEnds(path_ends, min_max);
-
-  stats.report("Make path ends");
   return path_ends;
 }
 
 ////////////////////////////////////////////////////////////////
 
+typedef Map<PathGroup*, PathGroup*> PathGroupLocalMap;
+
+// Path end visitor used by one thread that saves path ends in local
+// copies of the path groups. The local groups are pruned as they fill
+// up and merged into the path groups after all of the endpoints have
+// been visited.
+class MakePathEnds : public PathEndVisitor
+{
+public:
+  explicit MakePathEnds(PathGroups *path_groups);
+  virtual ~MakePathEnds();
+  virtual MakePathEnds *copy() = 0;
+  void mergeLocalGroups();
+
+protected:
+  PathGroup *localGroup(PathGroup *group);
+
+  PathGroups *path_groups_;
+  // path group -> local group
+  PathGroupLocalMap local_groups_;
+
+private:
+  DISALLOW_COPY_AND_ASSIGN(MakePathEnds);
+};
+
+MakePathEnds::MakePathEnds(PathGroups *path_groups) :
+  path_groups_(path_groups)
+{
+}
+
+MakePathEnds::~MakePathEnds()
+{
+  local_groups_.deleteContents();
+}
+
+PathGroup *
+MakePathEnds::localGroup(PathGroup *group)
+{
+  PathGroup *local_group = local_groups_.findKey(group);
+  if (local_group == nullptr) {
+    local_group = group->makeLocalGroup();
+    local_groups_[group] = local_group;
+  }
+  return local_group;
+}
+
+void
+MakePathEnds::mergeLocalGroups()
+{
+  PathGroupLocalMap::Iterator group_iter(local_groups_);
+  while (group_iter.hasNext()) {
+    PathGroup *group, *local_group;
+    group_iter.next(group, local_group);
+    group->mergeEnds(local_group);
+  }
+}
+
+////////////////////////////////////////////////////////////////
+
 // Visit each path end for a vertex and add the worst one in each
 // path group to the group.
-class MakePathEnds1 : public PathEndVisitor
+class MakePathEnds1 : public MakePathEnds
 {
 public:
   explicit MakePathEnds1(PathGroups *path_groups);
-  virtual PathEndVisitor *copy();
+  virtual MakePathEnds *copy();
   virtual void visit(PathEnd *path_end);
   virtual void vertexEnd(Vertex *vertex);
 
@@ -537,18 +711,17 @@ private:
   void visitPathEnd(PathEnd *path_end,
 		    PathGroup *group);
 
-  PathGroups *path_groups_;
   PathGroupEndMap ends_;
   PathEndLess cmp_;
 };
 
 MakePathEnds1::MakePathEnds1(PathGroups *path_groups) :
-  path_groups_(path_groups),
+  MakePathEnds(path_groups),
   cmp_(path_groups){
 
 }
 
-PathEndVisitor *
+MakePathEnds *
 MakePathEnds1::copy()
 {
   return new MakePathEnds1(path_groups_);
@@ -566,7 +739,7 @@ void
 MakePathEnds1::visitPathEnd(PathEnd *path_end,
 			    PathGroup *group)
 {
-  if (group->savable(path_end)) {
+  if (localGroup(group)->savable(path_end)) {
     // Only keep the path end with the smallest slack/latest arrival.
     PathEnd *worst_end = ends_.findKey(group);
     if (worst_end) {
@@ -591,7 +764,7 @@ MakePathEnds1::vertexEnd(Vertex *)
     group_iter.next(group, end);
     // visitPathEnd already confirmed slack is savable.
     if (end) {
-      group->insert(end);
+      localGroup(group)->insert(end);
       // Clear ends_ for next vertex.
       ends_[group] = nullptr;
     }
@@ -603,13 +776,13 @@ MakePathEnds1::vertexEnd(Vertex *)
 // Visit each path end and add it to the corresponding path group.
 // After collecting the ends do parallel path enumeration to find the
 // path ends for the group.
-class MakePathEndsAll : public PathEndVisitor
+class MakePathEndsAll : public MakePathEnds
 {
 public:
   explicit MakePathEndsAll(int endpoint_count,
 			   PathGroups *path_groups);
   virtual ~MakePathEndsAll();
-  virtual PathEndVisitor *copy();
+  virtual MakePathEnds *copy();
   virtual void visit(PathEnd *path_end);
   virtual void vertexEnd(Vertex *vertex);
 
@@ -619,7 +792,6 @@ private:
 		    PathGroup *group);
 
   int endpoint_count_;
-  PathGroups *path_groups_;
   const StaState *sta_;
   PathGroupEndsMap ends_;
   PathEndSlackLess slack_cmp_;
@@ -628,8 +800,8 @@ private:
 
 MakePathEndsAll::MakePathEndsAll(int endpoint_count,
 				 PathGroups *path_groups) :
+  MakePathEnds(path_groups),
   endpoint_count_(endpoint_count),
-  path_groups_(path_groups),
   sta_(path_groups),
   slack_cmp_(path_groups),
   path_no_crpr_cmp_(path_groups)
@@ -637,7 +809,7 @@ MakePathEndsAll::MakePathEndsAll(int endpoint_count,
 }
 
 
-PathEndVisitor *
+MakePathEnds *
 MakePathEndsAll::copy()
 {
   return new MakePathEndsAll(endpoint_count_, path_groups_);
@@ -702,8 +874,9 @@ MakePathEndsAll::vertexEnd(Vertex *)
 		      path_end->path()->tag(sta_)->index());
 	  // Give the group a copy of the path end because
 	  // it may delete it during pruning.
-	  if (group->savable(path_end)) {
-	    group->insert(path_end->copy());
+	  PathGroup *local_group = localGroup(group);
+	  if (local_group->savable(path_end)) {
+	    local_group->insert(path_end->copy());
 	    unique_ends.insert(path_end);
 	    n++;
 	  }
@@ -728,6 +901,53 @@ MakePathEndsAll::vertexEnd(Vertex *)
 
 ////////////////////////////////////////////////////////////////
 
+// Only groups with one path end per endpoint are updated. The path
+// ends of the invalid vertices are replaced and the groups are
+// checked to see if an endpoint that was pruned could be one of the
+// group_count worst.
+PathEndSeq *
+PathGroups::updatePathEnds(const VertexSeq &invalids,
+			   const VertexBitSet &invalid_set,
+			   bool unconstrained_paths,
+			   const Corner *corner,
+			   const MinMaxAll *min_max,
+			   bool sort_by_slack)
+{
+  if (endpoint_count_ != 1)
+    return nullptr;
+  Stats stats(this->debug(), this->phaseStats());
+  Vector<PathGroup*> groups;
+  this->groups(groups);
+  for (auto group : groups)
+    group->removeEnds(invalid_set);
+
+  Search *search = this->search();
+  // Update the endpoints.
+  search->endpoints();
+  VertexSeq endpoints;
+  for (auto vertex : invalids) {
+    if (search->isEndpoint(vertex))
+      endpoints.push_back(vertex);
+  }
+  MakePathEnds1 make_path_ends(this);
+  makeGroupPathEnds(endpoints, corner, min_max, &make_path_ends);
+
+  for (auto group : groups) {
+    if (!group->updateComplete()) {
+      debugPrint1(debug_, "search", 1, "path group %s needs remake\n",
+		  group->name());
+      return nullptr;
+    }
+  }
+  PathEndSeq *path_ends = groupPathEnds(unconstrained_paths, min_max,
+					sort_by_slack);
+  stats.setVisitCount(endpoints.size());
+  stats.report("Update path ends");
+  return path_ends;
+}
+
+////////////////////////////////////////////////////////////////
+
 void
 PathGroups::makeGroupPathEnds(ExceptionTo *to,
 			      int group_count,
@@ -787,22 +1007,63 @@ PathGroups::enumPathEnds(PathGroup *group,
 			 bool unique_pins,
 			 bool cmp_slack)
 {
-  // Insert the worst max_path path ends in the group into a path
-  // enumerator.
-  PathEnum path_enum(group_count, endpoint_count, unique_pins, cmp_slack, this);
+  // Insert the worst max_path path ends in the group into path
+  // enumerators. Each endpoint belongs to one enumerator so the
+  // endpoint_count/unique_pins limits are applied by that enumerator.
+  int thread_count = thread_pool_ ? thread_pool_->threadCount() : 1;
+  if (thread_count < 1)
+    thread_count = 1;
+  Vector<PathEnum*> path_enums;
+  VertexPathCountMap vertex_enums;
   PathGroupIterator *end_iter = group->iterator();
   while (end_iter->hasNext()) {
     PathEnd *end = end_iter->next();
-    if (group->savable(end))
-      path_enum.insert(end);
+    if (group->savable(end)) {
+      Vertex *vertex = end->vertex(this);
+      int enum_index;
+      bool exists;
+      vertex_enums.findKey(vertex, enum_index, exists);
+      if (!exists) {
+	// Deal the endpoints out to the enumerators in slack order.
+	enum_index = vertex_enums.size() % thread_count;
+	vertex_enums[vertex] = enum_index;
+	if (enum_index == static_cast<int>(path_enums.size()))
+	  path_enums.push_back(new PathEnum(group_count, endpoint_count,
+					    unique_pins, cmp_slack, this));
+      }
+      path_enums[enum_index]->insert(end);
+    }
   }
   delete end_iter;
   group->clear();
 
   // Parallel path enumeratation to find the endpoint_count/max path ends.
-  for (int n = 0; path_enum.hasNext() && n < group_count; n++) {
-    PathEnd *end = path_enum.next();
-    group->insert(end);
+  Vector<PathEndSeq> enum_ends(path_enums.size());
+  forEachChunk(path_enums.size(), thread_pool_,
+	       [&] (size_t begin, size_t end, int) {
+		 for (size_t i = begin; i < end; i++) {
+		   PathEnum *path_enum = path_enums[i];
+		   PathEndSeq &ends = enum_ends[i];
+		   for (int n = 0; path_enum->hasNext() && n < group_count; n++)
+		     ends.push_back(path_enum->next());
+		 }
+	       });
+  path_enums.deleteContents();
+
+  // Merge the enumerated path ends by slack.
+  PathEndSeq ends;
+  for (auto &ends1 : enum_ends) {
+    for (auto end : ends1)
+      ends.push_back(end);
+  }
+  if (enum_ends.size() > 1)
+    sort(ends, PathEndLess(this));
+  for (size_t i = 0; i < ends.size(); i++) {
+    PathEnd *end = ends[i];
+    if (static_cast<int>(i) < group_count)
+      group->insert(end);
+    else
+      delete end;
   }
 }
 
@@ -810,16 +1071,16 @@ void
 PathGroups::makeGroupPathEnds(ExceptionTo *to,
 			      const Corner *corner,
 			      const MinMaxAll *min_max,
-			      PathEndVisitor *visitor)
+			      MakePathEnds *visitor)
 {
   Network *network = this->network();
   Graph *graph = this->graph();
   Search *search = this->search();
   if (exceptionToEmpty(to))
-    makeGroupPathEnds(search->endpoints(), corner, min_max, visitor);
+    makeGroupPathEnds(*search->endpoints(), corner, min_max, visitor);
   else {
     // Only visit -to filter pins.
-    VertexSet endpoints;
+    VertexSet endpoint_set;
     PinSet pins;
     to->allPins(network, &pins);
     PinSet::Iterator pin_iter(pins);
@@ -829,12 +1090,15 @@ PathGroups::makeGroupPathEnds(ExceptionTo *to,
       graph->pinVertices(pin, vertex, bidirect_drvr_vertex);
       if (vertex
 	  && search->isEndpoint(vertex))
-	endpoints.insert(vertex);
+	endpoint_set.insert(vertex);
       if (bidirect_drvr_vertex
 	  && search->isEndpoint(bidirect_drvr_vertex))
-	endpoints.insert(bidirect_drvr_vertex);
+	endpoint_set.insert(bidirect_drvr_vertex);
     }
-    makeGroupPathEnds(&endpoints, corner, min_max, visitor);
+    VertexSeq endpoints;
+    for (auto vertex : endpoint_set)
+      endpoints.push_back(vertex);
+    makeGroupPathEnds(endpoints, corner, min_max, visitor);
   }
 }
 
@@ -848,71 +1112,37 @@ exceptionToEmpty(ExceptionTo *to)
 
 ////////////////////////////////////////////////////////////////
 
-class MakeEndpointPathEnds : public VertexVisitor
-{
-public:
-  MakeEndpointPathEnds(PathEndVisitor *path_end_visitor,
-		       const Corner *corner,
-		       const MinMaxAll *min_max,
-		       const StaState *sta);
-  ~MakeEndpointPathEnds();
-  virtual VertexVisitor *copy();
-  virtual void visit(Vertex *vertex);
-
-private:
-  DISALLOW_COPY_AND_ASSIGN(MakeEndpointPathEnds);
-
-  VisitPathEnds *visit_path_ends_;
-  PathEndVisitor *path_end_visitor_;
-  const Corner *corner_;
-  const MinMaxAll *min_max_;
-  const StaState *sta_;
-};
-
-MakeEndpointPathEnds::MakeEndpointPathEnds(PathEndVisitor *path_end_visitor,
-					   const Corner *corner,
-					   const MinMaxAll *min_max,
-					   const StaState *sta) :
-  visit_path_ends_(new VisitPathEnds(sta)),
-  path_end_visitor_(path_end_visitor->copy()),
-  corner_(corner),
-  min_max_(min_max),
-  sta_(sta)
-{
-}
-
-MakeEndpointPathEnds::~MakeEndpointPathEnds()
-{
-  delete visit_path_ends_;
-  delete path_end_visitor_;
-}
-
-VertexVisitor *
-MakeEndpointPathEnds::copy()
-{
-  return new MakeEndpointPathEnds(path_end_visitor_, corner_, min_max_, sta_);
-}
-
-void
-MakeEndpointPathEnds::visit(Vertex *vertex)
-{
-  visit_path_ends_->visitPathEnds(vertex, corner_, min_max_, true,
-				  path_end_visitor_);
-}
-
-////////////////////////////////////////////////////////////////
-
 void
-PathGroups::makeGroupPathEnds(VertexSet *endpoints,
+PathGroups::makeGroupPathEnds(const VertexSeq &ends,
 			      const Corner *corner,
 			      const MinMaxAll *min_max,
-			      PathEndVisitor *visitor)
+			      MakePathEnds *visitor)
 {
-  VertexSet::Iterator end_iter(endpoints);
-  MakeEndpointPathEnds make_path_ends(visitor, corner, min_max, this);
-  forEach<VertexSet::Iterator,VertexVisitor,Vertex*>(&end_iter,
-						     &make_path_ends,
-						     thread_count_);
+  int thread_count = thread_pool_ ? thread_pool_->threadCount() : 1;
+  if (thread_count < 1)
+    thread_count = 1;
+  Vector<VisitPathEnds*> visit_path_ends(thread_count);
+  Vector<MakePathEnds*> visitors(thread_count);
+  for (int i = 0; i < thread_count; i++) {
+    visit_path_ends[i] = new VisitPathEnds(this);
+    visitors[i] = visitor->copy();
+  }
+  forEachChunk(ends.size(), thread_pool_,
+	       [&] (size_t begin, size_t end, int thread_index) {
+		 VisitPathEnds *thread_visit_path_ends =
+		   visit_path_ends[thread_index];
+		 MakePathEnds *thread_visitor = visitors[thread_index];
+		 for (size_t i = begin; i < end; i++)
+		   thread_visit_path_ends->visitPathEnds(ends[i], corner,
+							 min_max, true,
+							 thread_visitor);
+	       });
+  // Each thread pruned its own path ends so only the survivors are
+  // merged into the path groups.
+  for (auto thread_visitor : visitors)
+    thread_visitor->mergeLocalGroups();
+  visitors.deleteContents();
+  visit_path_ends.deleteContents();
 }
 
 } // namespace
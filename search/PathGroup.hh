@@ -27,6 +27,8 @@ namespace sta {
 
 class MinMax;
 class PathEndVisitor;
+class MakePathEnds;
+class VertexBitSet;
 
 typedef PathEndSeq::Iterator PathGroupIterator;
 typedef Map<const Clock*, PathGroup*> PathGroupClkMap;
@@ -56,6 +58,13 @@ public:
   const MinMax *minMax() const { return min_max_;}
   const PathEndSeq &pathEnds() const { return path_ends_; }
   void insert(PathEnd *path_end);
+  // Empty path group with the same limits for one thread to collect
+  // path ends in without contending for the group lock.
+  PathGroup *makeLocalGroup() const;
+  // Move the path ends of local_group into the group.
+  void mergeEnds(PathGroup *local_group);
+  // Prune to the group_count worst path ends and sort them.
+  void ensureSortedMaxPaths();
   // Push group_count into path_ends.
   void pushEnds(PathEndSeq *path_ends);
   // Predicates to determine if a PathEnd is worth saving.
@@ -64,6 +73,13 @@ public:
   PathGroupIterator *iterator();
   // This does NOT delete the path ends.
   void clear();
+  // Delete the path ends of vertices whose paths changed before
+  // visiting them again.
+  void removeEnds(const VertexBitSet &vertices);
+  // True if the group has its group_count worst path ends after the
+  // path ends removed by removeEnds were visited again. Endpoints
+  // pruned before the update may be worse than the new path ends.
+  bool updateComplete();
   static int group_count_max;
   
 protected:
@@ -76,7 +92,6 @@ protected:
 	    bool cmp_slack,
 	    const MinMax *min_max,
 	    const StaState *sta);
-  void ensureSortedMaxPaths();
   void prune();
   void sort();
 
@@ -90,6 +105,13 @@ protected:
   const MinMax *min_max_;
   bool compare_slack_;
   float threshold_;
+  // path_ends_ has not changed since it was sorted.
+  bool sorted_;
+  // Path ends worse than threshold_ were deleted.
+  bool pruned_;
+  // pruned_ and threshold_ before removeEnds.
+  bool update_pruned_;
+  float update_threshold_;
   std::mutex lock_;
   const StaState *sta_;
 
@@ -127,6 +149,15 @@ public:
 			   const MinMax *min_max) const;
   PathGroup *findPathGroup(const Clock *clock,
 			   const MinMax *min_max) const;
+  // Update the path ends after the paths of the invalid vertices
+  // changed instead of visiting all of the endpoints.
+  // Return nullptr if the path ends have to be made again.
+  PathEndSeq *updatePathEnds(const VertexSeq &invalids,
+			     const VertexBitSet &invalid_set,
+			     bool unconstrained_paths,
+			     const Corner *corner,
+			     const MinMaxAll *min_max,
+			     bool sort_by_slack);
   PathGroup *pathGroup(const PathEnd *path_end) const;
   static bool isGroupPathName(const char *group_name);
   static const char *asyncPathGroupName() { return async_group_name_; }
@@ -141,17 +172,23 @@ protected:
   void makeGroupPathEnds(ExceptionTo *to,
 			 const Corner *corner,
 			 const MinMaxAll *min_max,
-			 PathEndVisitor *visitor);
-  void makeGroupPathEnds(VertexSet *endpoints,
+			 MakePathEnds *visitor);
+  void makeGroupPathEnds(const VertexSeq &endpoints,
 			 const Corner *corner,
 			 const MinMaxAll *min_max,
-			 PathEndVisitor *visitor);
+			 MakePathEnds *visitor);
   void enumPathEnds(PathGroup *group,
 		    int group_count,
 		    int endpoint_count,
 		    bool unique_pins,
 		    bool cmp_slack);
 
+  PathEndSeq *groupPathEnds(bool unconstrained_paths,
+			    const MinMaxAll *min_max,
+			    bool sort_by_slack);
+  void groups(// Return value.
+	      Vector<PathGroup*> &groups) const;
+  void sortGroupPathEnds();
   void pushGroupPathEnds(PathEndSeq *path_ends);
   void pushUnconstrainedPathEnds(PathEndSeq *path_ends,
 				 const MinMaxAll *min_max);
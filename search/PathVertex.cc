@@ -18,6 +18,7 @@
 #include "Machine.hh"
 #include "DisallowCopyAssign.hh"
 #include "Fuzzy.hh"
+#include "TimingArc.hh"
 #include "Graph.hh"
 #include "ExceptionPath.hh"
 #include "Sdc.hh"
@@ -248,9 +249,12 @@ PathVertex::arrival(const StaState *) const
 
 void
 PathVertex::setArrival(Arrival arrival,
-		       const StaState *)
+		       const StaState *sta)
 {
   if (tag_) {
+    Search *search = sta->search();
+    if (search->arrivalJournalActive())
+      search->journalArrivals(vertex_);
     Arrival *arrivals = vertex_->arrivals();
     arrivals[arrival_index_] = arrival;
   }
@@ -274,16 +278,18 @@ void
 PathVertex::setRequired(const Required &required,
 			const StaState *sta)
 {
-  const Search *search = sta->search();
+  Search *search = sta->search();
+  if (search->arrivalJournalActive())
+    search->journalArrivals(vertex_);
   TagGroup *tag_group = search->tagGroup(vertex_);
   Arrival *arrivals = vertex_->arrivals();
   int arrival_count = tag_group->arrivalCount();
   if (!vertex_->hasRequireds()) {
-    Arrival *new_arrivals = new Arrival[arrival_count * 2];
+    Arrival *new_arrivals = sta->graph()->makeArrivals(arrival_count * 2);
     memcpy(new_arrivals, arrivals, arrival_count * sizeof(Arrival));
     vertex_->setArrivals(new_arrivals);
     vertex_->setHasRequireds(true);
-    delete [] arrivals;
+    sta->graph()->deleteArrivals(arrivals);
     arrivals = new_arrivals;
   }
   int req_index = arrival_index_ + arrival_count;
@@ -295,15 +301,17 @@ PathVertex::deleteRequireds(Vertex *vertex,
 			    const StaState *sta)
 {
   if (vertex->hasRequireds()) {
-    const Search *search = sta->search();
+    Search *search = sta->search();
+    if (search->arrivalJournalActive())
+      search->journalArrivals(vertex);
     TagGroup *tag_group = search->tagGroup(vertex);
     Arrival *arrivals = vertex->arrivals();
     int arrival_count = tag_group->arrivalCount();
-    Arrival *new_arrivals = new Arrival[arrival_count];
+    Arrival *new_arrivals = sta->graph()->makeArrivals(arrival_count);
     memcpy(new_arrivals, arrivals, arrival_count * sizeof(Arrival));
     vertex->setArrivals(new_arrivals);
     vertex->setHasRequireds(false);
-    delete [] arrivals;
+    sta->graph()->deleteArrivals(arrivals);
   }
 }
 
@@ -477,12 +485,64 @@ PrevPathVisitor::unfilteredTag(const Tag *tag) const
 
 ////////////////////////////////////////////////////////////////
 
+// Use the prev path recorded with the vertex arrivals when it includes
+// the prev arc instead of searching the fanin paths.
+static bool
+recordedPrevPath(const PathVertex *path,
+		 const StaState *sta,
+		 // Return values.
+		 PathVertex &prev_path,
+		 TimingArc *&prev_arc)
+{
+  Vertex *vertex = path->vertex(sta);
+  PathVertexRep *prev_paths = vertex->prevPaths();
+  int arrival_index;
+  bool arrival_exists;
+  path->arrivalIndex(arrival_index, arrival_exists);
+  if (prev_paths && arrival_exists) {
+    const PathVertexRep &prev = prev_paths[arrival_index];
+    if (!prev.isNull() && prev.hasPrevArc()) {
+      Graph *graph = sta->graph();
+      Vertex *prev_vertex = prev.vertex(sta);
+      Edge *prev_edge = nullptr;
+      VertexInEdgeIterator edge_iter(vertex, graph);
+      while (edge_iter.hasNext()) {
+	Edge *edge = edge_iter.next();
+	if (edge->from(graph) == prev_vertex) {
+	  // The arc index does not say which of parallel edges it is on.
+	  if (prev_edge)
+	    return false;
+	  prev_edge = edge;
+	}
+      }
+      if (prev_edge) {
+	TimingArcSet *arc_set = prev_edge->timingArcSet();
+	unsigned arc_index = prev.prevArcIndex();
+	TimingArc *arc = (arc_index < arc_set->arcCount())
+	  ? arc_set->findTimingArc(arc_index)
+	  : nullptr;
+	if (arc
+	    && arc->toTrans()->asRiseFall() == path->transition(sta)) {
+	  prev_path.init(prev, sta);
+	  if (!prev_path.isNull()) {
+	    prev_arc = arc;
+	    return true;
+	  }
+	}
+      }
+    }
+  }
+  return false;
+}
+
 void
 PathVertex::prevPath(const StaState *sta,
 		     // Return values.
 		     PathVertex &prev_path,
 		     TimingArc *&prev_arc) const
 {
+  if (recordedPrevPath(this, sta, prev_path, prev_arc))
+    return;
   PrevPred2 pred(sta);
   PrevPathVisitor visitor(this, &pred, sta);
   visitor.visitFaninPaths(vertex(sta));
@@ -495,6 +555,9 @@ PathVertex::prevPath(const StaState *sta,
 		     // Return values.
 		     PathVertex &prev_path) const
 {
+  TimingArc *prev_arc;
+  if (recordedPrevPath(this, sta, prev_path, prev_arc))
+    return;
   PrevPred2 pred(sta);
   PrevPathVisitor visitor(this, &pred, sta);
   visitor.visitFaninPaths(vertex(sta));
@@ -520,13 +583,12 @@ VertexPathIterator::VertexPathIterator(Vertex *vertex,
   vertex_(vertex),
   tr_(nullptr),
   path_ap_(nullptr),
-  min_max_(nullptr)
+  min_max_(nullptr),
+  tag_group_(search_->tagGroup(vertex)),
+  arrival_index_(0),
+  arrival_end_(tag_group_ ? tag_group_->arrivalCount() : 0)
 {
-  TagGroup *tag_group = search_->tagGroup(vertex);
-  if (tag_group) {
-    arrival_iter_.init(tag_group->arrivalMap());
-    findNext();
-  }
+  findNext();
 }
 
 // Iterate over vertex paths with the same transition and
@@ -539,13 +601,16 @@ VertexPathIterator::VertexPathIterator(Vertex *vertex,
   vertex_(vertex),
   tr_(tr),
   path_ap_(path_ap),
-  min_max_(nullptr)
-{
-  TagGroup *tag_group = search_->tagGroup(vertex);
-  if (tag_group) {
-    arrival_iter_.init(tag_group->arrivalMap());
-    findNext();
-  }
+  min_max_(nullptr),
+  tag_group_(search_->tagGroup(vertex)),
+  arrival_index_(0),
+  arrival_end_(0)
+{
+  // The arrivals for a path analysis point are contiguous.
+  if (tag_group_)
+    tag_group_->pathAPArrivalRange(path_ap->index(),
+				   arrival_index_, arrival_end_);
+  findNext();
 }
 
 VertexPathIterator::VertexPathIterator(Vertex *vertex,
@@ -556,13 +621,12 @@ VertexPathIterator::VertexPathIterator(Vertex *vertex,
   vertex_(vertex),
   tr_(tr),
   path_ap_(nullptr),
-  min_max_(min_max)
+  min_max_(min_max),
+  tag_group_(search_->tagGroup(vertex)),
+  arrival_index_(0),
+  arrival_end_(tag_group_ ? tag_group_->arrivalCount() : 0)
 {
-  TagGroup *tag_group = search_->tagGroup(vertex);
-  if (tag_group) {
-    arrival_iter_.init(tag_group->arrivalMap());
-    findNext();
-  }
+  findNext();
 }
 
 VertexPathIterator::~VertexPathIterator()
@@ -578,10 +642,9 @@ VertexPathIterator::hasNext()
 void
 VertexPathIterator::findNext()
 {
-  while (arrival_iter_.hasNext()) {
-    Tag *tag;
-    int arrival_index;
-    arrival_iter_.next(tag, arrival_index);
+  while (arrival_index_ < arrival_end_) {
+    int arrival_index = arrival_index_++;
+    Tag *tag = tag_group_->arrivalTag(arrival_index);
     if ((tr_ == nullptr
 	 || tag->trIndex() == tr_->index())
 	&& (path_ap_ == nullptr
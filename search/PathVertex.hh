@@ -138,7 +138,10 @@ private:
   const TransRiseFall *tr_;
   const PathAnalysisPt *path_ap_;
   const MinMax *min_max_;
-  ArrivalMap::Iterator arrival_iter_;
+  TagGroup *tag_group_;
+  // Remaining arrival indices [arrival_index_, arrival_end_).
+  int arrival_index_;
+  int arrival_end_;
   PathVertex path_;
   PathVertex next_;
 };
@@ -16,6 +16,7 @@
 
 #include "Machine.hh"
 #include "Graph.hh"
+#include "TimingArc.hh"
 #include "SearchClass.hh"
 #include "Tag.hh"
 #include "TagGroup.hh"
@@ -57,6 +58,7 @@ PathVertexRep::PathVertexRep(VertexIndex vertex_index,
 			     bool is_enum) :
   vertex_index_(vertex_index),
   tag_index_(tag_index),
+  prev_arc_index_(prev_arc_index_null),
   is_enum_(is_enum)
 {
 }
@@ -66,6 +68,7 @@ PathVertexRep::init()
 {
   vertex_index_ = 0;
   tag_index_ = tag_index_null;
+  prev_arc_index_ = prev_arc_index_null;
   is_enum_ = false;
 }
 
@@ -75,6 +78,7 @@ PathVertexRep::init(const PathVertexRep *path)
   if (path) {
     vertex_index_ = path->vertex_index_;
     tag_index_ = path->tag_index_;
+    prev_arc_index_ = path->prev_arc_index_;
     is_enum_ = false;
   }
   else
@@ -86,6 +90,7 @@ PathVertexRep::init(const PathVertexRep &path)
 {
   vertex_index_ = path.vertex_index_;
   tag_index_ = path.tag_index_;
+  prev_arc_index_ = path.prev_arc_index_;
   is_enum_ = false;
 }
 
@@ -98,6 +103,7 @@ PathVertexRep::init(const PathVertex *path,
   else {
     vertex_index_ = sta->graph()->index(path->vertex(sta));
     tag_index_ = path->tag(sta)->index();
+    prev_arc_index_ = prev_arc_index_null;
     is_enum_ = false;
   }
 }
@@ -111,10 +117,20 @@ PathVertexRep::init(const PathVertex &path,
   else {
     vertex_index_ = sta->graph()->index(path.vertex(sta));
     tag_index_ = path.tag(sta)->index();
+    prev_arc_index_ = prev_arc_index_null;
     is_enum_ = false;
   }
 }
 
+void
+PathVertexRep::setPrevArc(const TimingArc *prev_arc)
+{
+  if (prev_arc && prev_arc->index() < prev_arc_index_null)
+    prev_arc_index_ = prev_arc->index();
+  else
+    prev_arc_index_ = prev_arc_index_null;
+}
+
 Vertex *
 PathVertexRep::vertex(const StaState *sta) const
 {
@@ -21,10 +21,14 @@ namespace sta {
 
 class StaState;
 class PathVertex;
+class TimingArc;
 
 // Path representation that references a vertex arrival via a tag.
 // This does not implement the Path API which uses virtual functions
 // that would make it larger.
+// When used as a vertex prev path it can also record the index of the
+// arc from the prev path in the edge arc set, in bits left over from
+// the tag index.
 class PathVertexRep
 {
 public:
@@ -50,6 +54,11 @@ public:
   VertexIndex vertexIndex() const { return vertex_index_; }
   Tag *tag(const StaState *sta) const;
   TagIndex tagIndex() const { return tag_index_; }
+  void setTagIndex(TagIndex tag_index) { tag_index_ = tag_index; }
+  bool hasPrevArc() const { return prev_arc_index_ != prev_arc_index_null; }
+  unsigned prevArcIndex() const { return prev_arc_index_; }
+  // Arcs with indices that do not fit are not recorded.
+  void setPrevArc(const TimingArc *prev_arc);
   Arrival arrival(const StaState *sta) const;
   void prevPath(const StaState *sta,
 		// Return values.
@@ -66,8 +75,12 @@ public:
 		 const PathVertexRep &path2);
 
 protected:
+  static const int prev_arc_index_bits = 6;
+  static const unsigned prev_arc_index_null = (1 << prev_arc_index_bits) - 1;
+
   VertexIndex vertex_index_;
   unsigned int tag_index_:tag_index_bits;
+  unsigned int prev_arc_index_:prev_arc_index_bits;
   bool is_enum_:1;
 
 private:
@@ -15,7 +15,10 @@
 // along with this program.  If not, see <https://www.gnu.org/licenses/>.
 
 #include <algorithm> // max
+#include <string.h> // memcpy
 #include "Machine.hh"
+#include "Report.hh"
+#include "Error.hh"
 #include "Debug.hh"
 #include "EnumNameMap.hh"
 #include "Units.hh"
@@ -41,6 +44,8 @@
 #include "Sim.hh"
 #include "Search.hh"
 #include "Bfs.hh"
+#include "Mutex.hh"
+#include "ThreadForEach.hh"
 #include "Power.hh"
 
 // Related liberty not supported:
@@ -63,10 +68,48 @@ Power::Power(Sta *sta) :
   StaState(sta),
   global_activity_{0.0, 0.0, PwrActivityOrigin::unknown},
   input_activity_{0.1, 0.5, PwrActivityOrigin::input},
-  activities_valid_(false)
+  activities_valid_(false),
+  internal_power_cache_enabled_(false),
+  internal_power_cache_hits_(0),
+  internal_power_cache_misses_(0)
 {
 }
 
+void
+Power::setInternalPowerCache(bool enable)
+{
+  internal_power_cache_enabled_ = enable;
+  internal_power_cache_.clear();
+  internal_power_cache_hits_ = 0;
+  internal_power_cache_misses_ = 0;
+}
+
+void
+Power::internalPowerCacheStats(// Return values.
+			       size_t &hits,
+			       size_t &misses,
+			       size_t &entries) const
+{
+  hits = internal_power_cache_hits_;
+  misses = internal_power_cache_misses_;
+  entries = internal_power_cache_.size();
+}
+
+void
+Power::reportInternalPowerCache()
+{
+  size_t hits, misses, entries;
+  internalPowerCacheStats(hits, misses, entries);
+  size_t lookups = hits + misses;
+  report_->print("Internal power cache %s\n",
+		 internal_power_cache_enabled_ ? "enabled" : "disabled");
+  report_->print("Entries %zu\n", entries);
+  report_->print("Hits    %zu\n", hits);
+  report_->print("Misses  %zu\n", misses);
+  if (lookups > 0)
+    report_->print("Hit rate %.1f%%\n", hits * 100.0 / lookups);
+}
+
 void
 Power::setGlobalActivity(float activity,
 			 float duty)
@@ -142,25 +185,45 @@ Power::power(const Corner *corner,
   pad.clear();
 
   preamble();
+  internal_power_cache_.clear();
+  InstanceSeq insts;
   LeafInstanceIterator *inst_iter = network_->leafInstanceIterator();
   while (inst_iter->hasNext()) {
     Instance *inst = inst_iter->next();
-    LibertyCell *cell = network_->libertyCell(inst);
-    if (cell) {
-      PowerResult inst_power;
-      power(inst, corner, inst_power);
-      if (cell->isMacro())
-	macro.incr(inst_power);
-      else if (cell->isPad())
-	pad.incr(inst_power);
-      else if (cell->hasSequentials())
-	sequential.incr(inst_power);
-      else
-	combinational.incr(inst_power);
-      total.incr(inst_power);
-    }
+    if (network_->libertyCell(inst))
+      insts.push_back(inst);
   }
   delete inst_iter;
+
+  // Per-thread group totals are summed after the instances are visited.
+  int thread_count = thread_pool_ ? thread_pool_->threadCount() : 1;
+  std::vector<PowerGroupResults> thread_results(thread_count);
+  forEachChunk(insts.size(), thread_pool_,
+	       [&] (size_t begin, size_t end, int thread_index) {
+		 PowerGroupResults &results = thread_results[thread_index];
+		 for (size_t i = begin; i < end; i++) {
+		   Instance *inst = insts[i];
+		   LibertyCell *cell = network_->libertyCell(inst);
+		   PowerResult inst_power;
+		   power(inst, cell, corner, inst_power);
+		   if (cell->isMacro())
+		     results.macro.incr(inst_power);
+		   else if (cell->isPad())
+		     results.pad.incr(inst_power);
+		   else if (cell->hasSequentials())
+		     results.sequential.incr(inst_power);
+		   else
+		     results.combinational.incr(inst_power);
+		   results.total.incr(inst_power);
+		 }
+	       });
+  for (PowerGroupResults &results : thread_results) {
+    total.incr(results.total);
+    sequential.incr(results.sequential);
+    combinational.incr(results.combinational);
+    macro.incr(results.macro);
+    pad.incr(results.pad);
+  }
 }
 
 void
@@ -231,8 +294,15 @@ public:
   InstanceSet *stealVisitedRegs();
 
 private:
+  void insertVisitedReg(Instance *reg,
+			bool input_without_activity);
+
   InstanceSet *visited_regs_;
   bool found_reg_without_activity_;
+  std::mutex visited_regs_lock_;
+  // Copies made for parallel visits record registers in the
+  // visitor they were copied from.
+  PropActivityVisitor *owner_;
   Power *power_;
   BfsFwdIterator *bfs_;
 };
@@ -241,6 +311,8 @@ PropActivityVisitor::PropActivityVisitor(Power *power,
 					 BfsFwdIterator *bfs) :
   StaState(power),
   visited_regs_(nullptr),
+  found_reg_without_activity_(false),
+  owner_(this),
   power_(power),
   bfs_(bfs)
 {
@@ -254,7 +326,9 @@ PropActivityVisitor::~PropActivityVisitor()
 VertexVisitor *
 PropActivityVisitor::copy()
 {
-  return new PropActivityVisitor(power_, bfs_);
+  PropActivityVisitor *visitor = new PropActivityVisitor(power_, bfs_);
+  visitor->owner_ = owner_;
+  return visitor;
 }
 
 void
@@ -278,6 +352,18 @@ PropActivityVisitor::foundRegWithoutActivity() const
   return found_reg_without_activity_;
 }
 
+void
+PropActivityVisitor::insertVisitedReg(Instance *reg,
+				      bool input_without_activity)
+{
+  UniqueLock lock(visited_regs_lock_);
+  visited_regs_->insert(reg);
+  if (input_without_activity)
+    found_reg_without_activity_ = true;
+}
+
+// Activity map entries exist for all vertex pins while propagating,
+// so parallel visits only read and write existing entries.
 void
 PropActivityVisitor::visit(Vertex *vertex)
 {
@@ -292,13 +378,15 @@ PropActivityVisitor::visit(Vertex *vertex)
       if (edge->isWire()) {
 	Vertex *from_vertex = edge->from(graph_);
 	const Pin *from_pin = from_vertex->pin();
-	PwrActivity &from_activity = power_->pinActivity(from_pin);
-	PwrActivity to_activity(from_activity.activity(),
-				from_activity.duty(),
-				PwrActivityOrigin::propagated);
-	if (!power_->hasPinActivity(pin))
+	PwrActivity &from_activity = power_->propActivity(from_pin);
+	PwrActivity &to_activity = power_->propActivity(pin);
+	if (!to_activity.isSet())
 	  input_without_activity = true;
-	power_->setPinActivity(pin, to_activity);
+	// User (activity file) annotations are not overridden.
+	if (to_activity.origin() != PwrActivityOrigin::user)
+	  to_activity.set(from_activity.activity(),
+			  from_activity.duty(),
+			  PwrActivityOrigin::propagated);
       }
     }
     Instance *inst = network_->instance(pin);
@@ -306,17 +394,18 @@ PropActivityVisitor::visit(Vertex *vertex)
     if (cell && cell->hasSequentials()) {
       debugPrint1(debug_, "power_activity", 3, "pending reg %s\n",
 		  network_->pathName(inst));
-      visited_regs_->insert(inst);
-      found_reg_without_activity_ = input_without_activity;
+      owner_->insertVisitedReg(inst, input_without_activity);
     }
   }
   if (network_->isDriver(pin)) {
     LibertyPort *port = network_->libertyPort(pin);
-    if (port) {
+    PwrActivity &drvr_activity = power_->propActivity(pin);
+    if (port
+	&& drvr_activity.origin() != PwrActivityOrigin::user) {
       FuncExpr *func = port->function();
       Instance *inst = network_->instance(pin);
       PwrActivity activity = power_->evalActivity(func, inst);
-      power_->setPinActivity(pin, activity);
+      drvr_activity = activity;
       debugPrint3(debug_, "power_activity", 3, "set %s %.2e %.2f\n",
 		  vertex->name(network_),
 		  activity.activity(),
@@ -393,11 +482,14 @@ Power::ensureActivities()
     if (!activities_valid_) {
       ActivitySrchPred activity_srch_pred(this);
       BfsFwdIterator bfs(BfsIndex::other, &activity_srch_pred, this);
+      ensureActivityEntries();
       seedActivities(bfs);
       PropActivityVisitor visitor(this, &bfs);
       visitor.init();
-      bfs.visit(levelize_->maxLevel(), &visitor);
-      while (visitor.foundRegWithoutActivity()) {
+      bfs.visitParallel(levelize_->maxLevel(), &visitor);
+      int reg_pass_count = 0;
+      while (visitor.foundRegWithoutActivity()
+	     && reg_pass_count++ < reg_activity_pass_max_) {
 	InstanceSet *regs = visitor.stealVisitedRegs();
 	InstanceSet::Iterator reg_iter(regs);
 	while (reg_iter.hasNext()) {
@@ -407,13 +499,32 @@ Power::ensureActivities()
 	}
 	delete regs;
 	visitor.init();
-	bfs.visit(levelize_->maxLevel(), &visitor);
+	bfs.visitParallel(levelize_->maxLevel(), &visitor);
       }
       activities_valid_ = true;
     }
   }
 }
 
+void
+Power::ensureActivityEntries()
+{
+  VertexIterator vertex_iter(graph_);
+  while (vertex_iter.hasNext()) {
+    Vertex *vertex = vertex_iter.next();
+    activity_map_[vertex->pin()];
+  }
+}
+
+PwrActivity &
+Power::propActivity(const Pin *pin)
+{
+  auto activity_iter = activity_map_.find(pin);
+  if (activity_iter == activity_map_.end())
+    internalError("missing pin activity entry");
+  return activity_iter->second;
+}
+
 void
 Power::seedActivities(BfsFwdIterator &bfs)
 {
@@ -499,15 +610,22 @@ Power::power(const Instance *inst,
   while (pin_iter->hasNext()) {
     const Pin *to_pin = pin_iter->next();
     const LibertyPort *to_port = network_->libertyPort(to_pin);
-    float load_cap = to_port->direction()->isAnyOutput()
-      ? graph_delay_calc_->loadCap(to_pin, dcalc_ap)
-      : 0.0;
+    float load_cap = 0.0;
+    if (to_port->direction()->isAnyOutput()) {
+      // Finding the parasitic can reduce or estimate it.
+      std::lock_guard<std::mutex> lock(load_cap_lock_);
+      load_cap = graph_delay_calc_->loadCap(to_pin, dcalc_ap);
+    }
     PwrActivity activity = findClkedActivity(to_pin, inst_clk);
     if (to_port->direction()->isAnyOutput())
       findSwitchingPower(cell, to_port, activity, load_cap,
 			 dcalc_ap, result);
-    findInternalPower(to_pin, to_port, inst, cell, activity,
-		      load_cap, dcalc_ap, result);
+    if (internal_power_cache_enabled_)
+      cachedInternalPower(to_pin, to_port, inst, cell, activity,
+			  load_cap, dcalc_ap, result);
+    else
+      findInternalPower(to_pin, to_port, inst, cell, activity,
+			load_cap, dcalc_ap, result);
   }
   delete pin_iter;
   findLeakagePower(inst, cell, result);
@@ -620,6 +738,100 @@ Power::findInternalPower(const Pin *to_pin,
   result.setInternal(result.internal() + internal);
 }
 
+// Low mantissa bits ignored when matching cache key floats
+// (relative tolerance of about 1e-4).
+static const int internal_power_cache_quantize_bits = 10;
+
+static uint32_t
+internalPowerCacheQuantize(float value)
+{
+  uint32_t bits;
+  memcpy(&bits, &value, sizeof(bits));
+  return bits & ~((1u << internal_power_cache_quantize_bits) - 1);
+}
+
+// The key has every instance pin value findInternalPower reads:
+// activity, duty, clock and load vertex slews.
+void
+Power::cachedInternalPower(const Pin *to_pin,
+			   const LibertyPort *to_port,
+			   const Instance *inst,
+			   LibertyCell *cell,
+			   PwrActivity &to_activity,
+			   float load_cap,
+			   const DcalcAnalysisPt *dcalc_ap,
+			   // Return values.
+			   PowerResult &result)
+{
+  DcalcAPIndex ap_index = dcalc_ap->index();
+  InternalPowerCacheKey key;
+  key.to_port_ = to_port;
+  key.ap_index_ = ap_index;
+  key.values_.push_back(internalPowerCacheQuantize(load_cap));
+  key.values_.push_back(internalPowerCacheQuantize(to_activity.activity()));
+  InstancePinIterator *pin_iter = network_->pinIterator(inst);
+  while (pin_iter->hasNext()) {
+    const Pin *pin = pin_iter->next();
+    PwrActivity activity = findActivity(pin);
+    key.values_.push_back(internalPowerCacheQuantize(activity.activity()));
+    key.values_.push_back(internalPowerCacheQuantize(activity.duty()));
+    Vertex *vertex = graph_->pinLoadVertex(pin);
+    if (vertex) {
+      key.values_.push_back(search_->isClock(vertex));
+      TransRiseFallIterator tr_iter;
+      while (tr_iter.hasNext()) {
+	TransRiseFall *tr = tr_iter.next();
+	float slew = delayAsFloat(graph_->slew(vertex, tr, ap_index));
+	key.values_.push_back(internalPowerCacheQuantize(slew));
+      }
+    }
+  }
+  delete pin_iter;
+
+  float internal;
+  bool exists;
+  {
+    std::lock_guard<std::mutex> lock(internal_power_cache_.lock(key));
+    internal_power_cache_.findKey(key, internal, exists);
+  }
+  if (exists)
+    internal_power_cache_hits_++;
+  else {
+    PowerResult pin_result;
+    findInternalPower(to_pin, to_port, inst, cell, to_activity,
+		      load_cap, dcalc_ap, pin_result);
+    internal = pin_result.internal();
+    std::lock_guard<std::mutex> lock(internal_power_cache_.lock(key));
+    internal_power_cache_.insert(key, internal);
+    internal_power_cache_misses_++;
+  }
+  result.setInternal(result.internal() + internal);
+}
+
+InternalPowerCacheKey::InternalPowerCacheKey() :
+  to_port_(nullptr),
+  ap_index_(0)
+{
+}
+
+bool
+InternalPowerCacheKey::operator==(const InternalPowerCacheKey &key) const
+{
+  return to_port_ == key.to_port_
+    && ap_index_ == key.ap_index_
+    && values_ == key.values_;
+}
+
+size_t
+InternalPowerCacheKeyHash::operator()(const InternalPowerCacheKey &key) const
+{
+  size_t hash = reinterpret_cast<size_t>(key.to_port_);
+  hash = hash * 31 + key.ap_index_;
+  for (uint32_t value : key.values_)
+    hash = hash * 31 + value;
+  return hash;
+}
+
 ////////////////////////////////////////////////////////////////
 
 static bool
@@ -828,8 +1040,10 @@ Power::findActivity(const Pin *pin)
   else if (global_activity_.isSet())
     return global_activity_;
   else {
-    if (activity_map_.hasKey(pin)) {
-      PwrActivity &activity = activity_map_[pin];
+    // Use find instead of [] so parallel power lookups are read only.
+    auto activity_iter = activity_map_.find(pin);
+    if (activity_iter != activity_map_.end()) {
+      PwrActivity &activity = activity_iter->second;
       if (activity.origin() != PwrActivityOrigin::unknown)
 	return activity;
     }
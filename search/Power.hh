@@ -17,6 +17,10 @@
 #ifndef STA_POWER_H
 #define STA_POWER_H
 
+#include <atomic>
+#include <mutex>
+#include <vector>
+#include "StripedMap.hh"
 #include "Sta.hh"
 
 namespace sta {
@@ -28,6 +32,29 @@ class BfsFwdIterator;
 
 typedef UnorderedMap<const Pin*,PwrActivity> PwrActivityMap;
 
+// Inputs of the internal power of an instance pin. Instances of the
+// same cell with the same (quantized) slews, load and activities have
+// the same internal power.
+class InternalPowerCacheKey
+{
+public:
+  InternalPowerCacheKey();
+  bool operator==(const InternalPowerCacheKey &key) const;
+
+  const LibertyPort *to_port_;
+  DcalcAPIndex ap_index_;
+  std::vector<uint32_t> values_;
+};
+
+class InternalPowerCacheKeyHash
+{
+public:
+  size_t operator()(const InternalPowerCacheKey &key) const;
+};
+
+typedef StripedMap<InternalPowerCacheKey, float,
+		   InternalPowerCacheKeyHash> InternalPowerCache;
+
 enum class PwrActivityOrigin
 {
  global,
@@ -97,6 +124,17 @@ public:
 		      PwrActivityOrigin origin);
   // Activity is toggles per second.
   PwrActivity findClkedActivity(const Pin *pin);
+  // TCL variable sta_power_cache.
+  // Reuse the internal power of instance pins of the same cell with
+  // the same slews, load and activities.
+  bool internalPowerCache() const { return internal_power_cache_enabled_; }
+  void setInternalPowerCache(bool enable);
+  void internalPowerCacheStats(// Return values.
+			       size_t &hits,
+			       size_t &misses,
+			       size_t &entries) const;
+  // Report internal power cache hits and misses.
+  void reportInternalPowerCache();
 
 protected:
   void preamble();
@@ -116,6 +154,15 @@ protected:
 			 const DcalcAnalysisPt *dcalc_ap,
 			 // Return values.
 			 PowerResult &result);
+  void cachedInternalPower(const Pin *to_pin,
+			   const LibertyPort *to_port,
+			   const Instance *inst,
+			   LibertyCell *cell,
+			   PwrActivity &to_activity,
+			   float load_cap,
+			   const DcalcAnalysisPt *dcalc_ap,
+			   // Return values.
+			   PowerResult &result);
   void findLeakagePower(const Instance *inst,
 			LibertyCell *cell,
 			// Return values.
@@ -138,6 +185,10 @@ protected:
   float pgNameVoltage(LibertyCell *cell,
 		      const char *pg_port_name,
 		      const DcalcAnalysisPt *dcalc_ap);
+  // Make activity map entries for every vertex pin so propagation
+  // does not insert into the map from parallel visits.
+  void ensureActivityEntries();
+  PwrActivity &propActivity(const Pin *pin);
   void seedActivities(BfsFwdIterator &bfs);
   void seedRegOutputActivities(const Instance *reg,
 			       Sequential *seq,
@@ -158,6 +209,14 @@ private:
   PwrActivity input_activity_;
   PwrActivityMap activity_map_;
   bool activities_valid_;
+  std::mutex load_cap_lock_;
+  // Limit on passes that propagate activities across registers.
+  static const int reg_activity_pass_max_ = 100;
+  bool internal_power_cache_enabled_;
+  // Cleared by power(corner) so entries do not outlive liberty ports.
+  InternalPowerCache internal_power_cache_;
+  std::atomic<size_t> internal_power_cache_hits_;
+  std::atomic<size_t> internal_power_cache_misses_;
 
   friend class PropActivityVisitor;
 };
@@ -182,5 +241,15 @@ private:
   float leakage_;
 };
 
+// Power totals for each cell group.
+struct PowerGroupResults
+{
+  PowerResult total;
+  PowerResult sequential;
+  PowerResult combinational;
+  PowerResult macro;
+  PowerResult pad;
+};
+
 } // namespace
 #endif
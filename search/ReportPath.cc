@@ -14,10 +14,16 @@
 // You should have received a copy of the GNU General Public License
 // along with this program.  If not, see <https://www.gnu.org/licenses/>.
 
+#include <algorithm>
+#include <exception>
+#include <map>
+#include <vector>
 #include "Machine.hh"
 #include "Report.hh"
 #include "Error.hh"
 #include "StringUtil.hh"
+#include "ThreadPool.hh"
+#include "ThreadForEach.hh"
 #include "Units.hh"
 #include "Fuzzy.hh"
 #include "TimingRole.hh"
@@ -111,10 +117,22 @@ ReportField::setEnabled(bool enabled)
 
 const float ReportPath::field_blank_ = -1.0;
 
+// Names built by one thread while reporting path ends.
+class ReportNameCache
+{
+public:
+  UnorderedMap<const Pin*, string> pin_names_;
+  UnorderedMap<const Net*, string> net_names_;
+  // Pins and nets reported as ids for the name dictionary.
+  UnorderedMap<VertexIndex, const Pin*> pin_ids_;
+  UnorderedMap<VertexIndex, const Net*> net_ids_;
+};
+
 ReportPath::ReportPath(StaState *sta) :
   StaState(sta),
   format_(ReportPathFormat::full),
   no_split_(false),
+  name_ids_(false),
   start_end_pt_width_(80),
   plus_zero_(nullptr),
   minus_zero_(nullptr)
@@ -137,6 +155,7 @@ ReportPath::~ReportPath()
 
   stringDelete(plus_zero_);
   stringDelete(minus_zero_);
+  name_caches_.deleteContents();
 }
 
 void
@@ -245,6 +264,12 @@ ReportPath::setNoSplit(bool no_split)
   no_split_ = no_split;
 }
 
+void
+ReportPath::setNameIds(bool name_ids)
+{
+  name_ids_ = name_ids;
+}
+
 void
 ReportPath::setDigits(int digits)
 {
@@ -263,6 +288,13 @@ ReportPath::setDigits(int digits)
 void
 ReportPath::reportPathEndHeader()
 {
+  // Path ends are written in large blocks until the footer.
+  report_->bufferBegin();
+  if (name_caches_.empty()) {
+    int thread_count = thread_pool_ ? thread_pool_->threadCount() : 0;
+    for (int i = 0; i <= thread_count; i++)
+      name_caches_.push_back(new ReportNameCache);
+  }
   string header;
   switch (format_) {
   case ReportPathFormat::full:
@@ -279,6 +311,8 @@ ReportPath::reportPathEndHeader()
     reportSlackOnlyHeader(header);
     report_->print(header);
     break;
+  case ReportPathFormat::json:
+    break;
   default:
     internalError("unsupported path type");
     break;
@@ -300,10 +334,16 @@ ReportPath::reportPathEndFooter()
   case ReportPathFormat::slack_only:
     report_->print("\n");
     break;
+  case ReportPathFormat::json:
+    break;
   default:
     internalError("unsupported path type");
     break;
   }
+  reportNameDictionary();
+  name_caches_.deleteContents();
+  name_caches_.clear();
+  report_->bufferEnd();
 }
 
 void
@@ -316,6 +356,8 @@ void
 ReportPath::reportPathEnd(PathEnd *end,
 			  PathEnd *prev_end)
 {
+  // Names formatted for the path end are released after it is printed.
+  TmpStringScope tmp_scope;
   string result;
   switch (format_) {
   case ReportPathFormat::full:
@@ -343,6 +385,11 @@ ReportPath::reportPathEnd(PathEnd *end,
     reportSlackOnly(end, result);
     report_->print(result);
     break;
+  case ReportPathFormat::json:
+    json_buffer_.clear();
+    reportJson(end, json_buffer_);
+    report_->printString(json_buffer_.c_str(), json_buffer_.size());
+    break;
   default:
     internalError("unsupported path type");
     break;
@@ -353,18 +400,95 @@ void
 ReportPath::reportPathEnds(PathEndSeq *ends)
 {
   reportPathEndHeader();
-  PathEndSeq::Iterator end_iter(ends);
+  // Path ends are expanded and formatted in parallel a batch at a time
+  // and printed in order.
+  static const size_t batch_size = 4096;
+  size_t end_count = ends->size();
+  size_t result_count = std::min(end_count, batch_size);
+  std::vector<string> results(result_count);
+  std::vector<std::exception_ptr> exceptions(result_count);
+  // The arc delay calculators used by loadCap need separate state
+  // for each thread.
+  if (thread_pool_) {
+    for (int i = 0; i < thread_pool_->threadCount(); i++)
+      thread_arc_delay_calcs_.push_back(arc_delay_calc_
+					? arc_delay_calc_->copy()
+					: nullptr);
+  }
   PathEnd *prev_end = nullptr;
-  while (end_iter.hasNext()) {
-    PathEnd *end = end_iter.next();
-    reportEndpointHeader(end, prev_end);
-    string result;
-    end->reportFull(this, result);
-    report_->print(result);
-    report_->print("\n\n");
-    prev_end = end;
+  std::exception_ptr exception;
+  for (size_t batch_begin = 0;
+       batch_begin < end_count && exception == nullptr;
+       batch_begin += batch_size) {
+    size_t batch_end = std::min(batch_begin + batch_size, end_count);
+    forEachChunk(batch_end - batch_begin, thread_pool_,
+		 [&] (size_t begin, size_t end, int) {
+		   for (size_t i = begin; i < end; i++) {
+		     // Names formatted for the path end are released
+		     // after it is formatted.
+		     TmpStringScope tmp_scope;
+		     string &result = results[i];
+		     result.clear();
+		     try {
+		       reportPathEndsResult((*ends)[batch_begin + i], result);
+		     }
+		     catch (...) {
+		       exceptions[i] = std::current_exception();
+		     }
+		   }
+		 });
+    if (format_ == ReportPathFormat::json) {
+      // Print the batch in one block instead of one print per end.
+      json_buffer_.clear();
+      for (size_t i = 0; i < batch_end - batch_begin; i++) {
+	if (exceptions[i]) {
+	  exception = exceptions[i];
+	  break;
+	}
+	json_buffer_ += results[i];
+      }
+      if (!json_buffer_.empty())
+	report_->printString(json_buffer_.c_str(), json_buffer_.size());
+    }
+    else {
+      for (size_t i = 0; i < batch_end - batch_begin; i++) {
+	if (exceptions[i]) {
+	  exception = exceptions[i];
+	  break;
+	}
+	PathEnd *end = (*ends)[batch_begin + i];
+	reportEndpointHeader(end, prev_end);
+	report_->printString(results[i].c_str(), results[i].size());
+	prev_end = end;
+      }
+    }
   }
+  for (auto arc_delay_calc : thread_arc_delay_calcs_) {
+    if (arc_delay_calc) {
+      arc_delay_calc->finishDrvrPin();
+      delete arc_delay_calc;
+    }
+  }
+  thread_arc_delay_calcs_.clear();
+  // Do not hold on to a large buffer after the report.
+  string().swap(json_buffer_);
   reportPathEndFooter();
+  if (exception)
+    std::rethrow_exception(exception);
+}
+
+// Format one path end for reportPathEnds.
+// Called in parallel so the report must not be written.
+void
+ReportPath::reportPathEndsResult(PathEnd *end,
+				 string &result)
+{
+  if (format_ == ReportPathFormat::json)
+    reportJson(end, result);
+  else {
+    end->reportFull(this, result);
+    result += "\n\n";
+  }
 }
 
 void
@@ -1049,7 +1173,7 @@ ReportPath::pathStartpoint(PathEnd *end,
 {
   PathRef *start = expanded.startPath();
   Pin *pin = start->pin(graph_);
-  const char *pin_name = cmd_network_->pathName(pin);
+  const char *pin_name = pinName(pin);
   if (network_->isTopLevelPort(pin)) {
     PortDirection *dir = network_->direction(pin);
     return stdstrPrint("%s (%s)", pin_name, dir->name());
@@ -1065,7 +1189,7 @@ string
 ReportPath::pathEndpoint(PathEnd *end)
 {
   Pin *pin = end->vertex(this)->pin();
-  const char *pin_name = cmd_network_->pathName(pin);
+  const char *pin_name = pinName(pin);
   if (network_->isTopLevelPort(pin)) {
     PortDirection *dir = network_->direction(pin);
     return stdstrPrint("%s (%s)", pin_name, dir->name());
@@ -1105,6 +1229,101 @@ ReportPath::reportSlackOnly(PathEnd *end,
 
 ////////////////////////////////////////////////////////////////
 
+// Newline delimited JSON with times in user units.
+//  {"group":"clk","type":"check","min_max":"max","rise_fall":"rise",
+//   "corner":"default","startpoint":"r1/Q","endpoint":"r2/D",
+//   "arrival":1.2,"required":4.8,"slack":3.6,
+//   "path":[{"pin":"r1/Q","rise_fall":"rise","arrival":0.1},...]}
+// Unconstrained path ends report null required and slack.
+// Fields are appended directly to result so reports with many
+// path ends do not allocate strings for each field.
+void
+ReportPath::reportJson(PathEnd *end,
+		       string &result)
+{
+  PathExpanded expanded(end->path(), this);
+  result += '{';
+  jsonKey("group", result);
+  jsonString(search_->pathGroup(end)->name(), result);
+  result += ',';
+  jsonKey("type", result);
+  jsonString(end->typeName(), result);
+  result += ',';
+  jsonKey("min_max", result);
+  jsonString(end->minMax(this)->asString(), result);
+  result += ',';
+  jsonKey("rise_fall", result);
+  jsonString(end->transition(this)->name(), result);
+  result += ',';
+  jsonKey("corner", result);
+  jsonString(end->pathAnalysisPt(this)->corner()->name(), result);
+  result += ',';
+  jsonKey("startpoint", result);
+  jsonString(pinName(expanded.startPath()->pin(this)), result);
+  result += ',';
+  jsonKey("endpoint", result);
+  jsonString(pinName(end->vertex(this)->pin()), result);
+  result += ',';
+  jsonKey("arrival", result);
+  jsonTime(delayAsFloat(end->dataArrivalTime(this)), result);
+  result += ',';
+  jsonKey("required", result);
+  if (end->isUnconstrained())
+    result += "null";
+  else
+    jsonTime(delayAsFloat(end->requiredTime(this)), result);
+  result += ',';
+  jsonKey("slack", result);
+  if (end->isUnconstrained())
+    result += "null";
+  else
+    jsonTime(delayAsFloat(end->slack(this)), result);
+  result += ',';
+  jsonKey("path", result);
+  result += '[';
+  for (size_t i = expanded.startIndex(); i < expanded.size(); i++) {
+    PathRef *path = expanded.path(i);
+    if (i > expanded.startIndex())
+      result += ',';
+    result += '{';
+    jsonKey("pin", result);
+    jsonString(pinName(path->pin(this)), result);
+    result += ',';
+    jsonKey("rise_fall", result);
+    jsonString(path->transition(this)->name(), result);
+    result += ',';
+    jsonKey("arrival", result);
+    jsonTime(delayAsFloat(path->arrival(this)), result);
+    result += '}';
+  }
+  result += "]}\n";
+}
+
+void
+ReportPath::jsonKey(const char *key,
+		    string &result)
+{
+  result += '"';
+  result += key;
+  result += "\":";
+}
+
+void
+ReportPath::jsonTime(float value,
+		     string &result)
+{
+  char buffer[32];
+  float user_value = value / units_->timeUnit()->scale();
+  if (fuzzyInf(value))
+    result += (value < 0.0) ? "-1e30" : "1e30";
+  else {
+    int length = snprintf(buffer, sizeof(buffer), "%.*f", digits_, user_value);
+    result.append(buffer, length);
+  }
+}
+
+////////////////////////////////////////////////////////////////
+
 void
 ReportPath::reportMpwCheck(MinPulseWidthCheck *check,
 			   bool verbose)
@@ -2696,14 +2915,14 @@ ReportPath::reportPath5(const Path *path,
 		     incr, time, false, min_max, tr, line_case, result);
 	  string what2;
 	  if (network_->isTopLevelPort(pin)) {
-	    const char *pin_name = cmd_network_->pathName(pin);
+	    const char *pin_name = pinName(pin);
 	    what2 = stdstrPrint("%s (net)", pin_name);
 	  }
 	  else {
 	    Net *net = network_->net(pin);
 	    if (net) {
 	      Net *highest_net = network_->highestNetAbove(net);
-	      const char *net_name = cmd_network_->pathName(highest_net);
+	      const char *net_name = netName(highest_net, pin);
 	      what2 = stdstrPrint("%s (net)", net_name);
 	    }
 	    else
@@ -2740,7 +2959,7 @@ string
 ReportPath::descriptionField(Vertex *vertex)
 {
   Pin *pin = vertex->pin();
-  const char *pin_name = cmd_network_->pathName(pin);
+  const char *pin_name = pinName(pin);
   const char *name2;
   if (network_->isTopLevelPort(pin)) {
     PortDirection *dir = network_->direction(pin);
@@ -2763,6 +2982,96 @@ ReportPath::descriptionField(Vertex *vertex)
   return stdstrPrint("%s (%s)", pin_name, name2);
 }
 
+////////////////////////////////////////////////////////////////
+
+ReportNameCache *
+ReportPath::nameCache()
+{
+  // Index 0 is the main thread (not a pool worker).
+  size_t index = ThreadPool::threadIndex() + 1;
+  if (index < name_caches_.size())
+    return name_caches_[index];
+  else
+    return nullptr;
+}
+
+bool
+ReportPath::nameIds() const
+{
+  return name_ids_
+    && format_ != ReportPathFormat::json;
+}
+
+const char *
+ReportPath::pinName(const Pin *pin)
+{
+  ReportNameCache *cache = nameCache();
+  if (cache == nullptr)
+    return cmd_network_->pathName(pin);
+  auto name_iter = cache->pin_names_.find(pin);
+  if (name_iter != cache->pin_names_.end())
+    return name_iter->second.c_str();
+  string &name = cache->pin_names_[pin];
+  Vertex *vertex = nameIds() ? graph_->pinLoadVertex(pin) : nullptr;
+  if (vertex) {
+    VertexIndex index = graph_->index(vertex);
+    name = stdstrPrint("p%lu", static_cast<unsigned long>(index));
+    cache->pin_ids_[index] = pin;
+  }
+  else
+    name = cmd_network_->pathName(pin);
+  return name.c_str();
+}
+
+const char *
+ReportPath::netName(const Net *net,
+		    const Pin *drvr_pin)
+{
+  ReportNameCache *cache = nameCache();
+  if (cache == nullptr)
+    return cmd_network_->pathName(net);
+  auto name_iter = cache->net_names_.find(net);
+  if (name_iter != cache->net_names_.end())
+    return name_iter->second.c_str();
+  string &name = cache->net_names_[net];
+  Vertex *vertex = nameIds() ? graph_->pinDrvrVertex(drvr_pin) : nullptr;
+  if (vertex) {
+    VertexIndex index = graph_->index(vertex);
+    name = stdstrPrint("n%lu", static_cast<unsigned long>(index));
+    cache->net_ids_[index] = net;
+  }
+  else
+    name = cmd_network_->pathName(net);
+  return name.c_str();
+}
+
+// Names of the ids reported since the header, in id order.
+void
+ReportPath::reportNameDictionary()
+{
+  std::map<VertexIndex, const Pin*> pins;
+  std::map<VertexIndex, const Net*> nets;
+  for (auto cache : name_caches_) {
+    for (auto &index_pin : cache->pin_ids_)
+      pins[index_pin.first] = index_pin.second;
+    for (auto &index_net : cache->net_ids_)
+      nets[index_net.first] = index_net.second;
+  }
+  if (!pins.empty() || !nets.empty()) {
+    TmpStringScope tmp_scope;
+    report_->print("Names\n");
+    for (auto &index_pin : pins)
+      report_->print("p%lu %s\n",
+		     static_cast<unsigned long>(index_pin.first),
+		     cmd_network_->pathName(index_pin.second));
+    for (auto &index_net : nets)
+      report_->print("n%lu %s\n",
+		     static_cast<unsigned long>(index_net.first),
+		     cmd_network_->pathName(index_net.second));
+    report_->print("\n");
+  }
+}
+
 float
 ReportPath::drvrFanout(Vertex *drvr,
 		       const MinMax *min_max)
@@ -2867,9 +3176,15 @@ ReportPath::loadCap(Pin *drvr_pin,
 		    const TransRiseFall *tr,
 		    DcalcAnalysisPt *dcalc_ap)
 {
+  ArcDelayCalc *arc_delay_calc = arc_delay_calc_;
+  // reportPathEnds formats path ends in the thread pool workers.
+  int thread_index = ThreadPool::threadIndex();
+  if (thread_index >= 0
+      && static_cast<size_t>(thread_index) < thread_arc_delay_calcs_.size())
+    arc_delay_calc = thread_arc_delay_calcs_[thread_index];
   Parasitic *parasitic = nullptr;
-  if (arc_delay_calc_)
-    parasitic = arc_delay_calc_->findParasitic(drvr_pin, tr, dcalc_ap);
+  if (arc_delay_calc)
+    parasitic = arc_delay_calc->findParasitic(drvr_pin, tr, dcalc_ap);
   return graph_delay_calc_->loadCap(drvr_pin, parasitic, tr, dcalc_ap);
 }
 
@@ -26,9 +26,11 @@
 namespace sta {
 
 class Corner;
+class ArcDelayCalc;
 class DcalcAnalysisPt;
 class PathExpanded;
 class ReportField;
+class ReportNameCache;
 
 using std::string;
 
@@ -48,6 +50,10 @@ public:
   int digits() const { return digits_; }
   void setDigits(int digits);
   void setNoSplit(bool no_split);
+  // Report pin and net names in path lines as ids (p<vertex index>,
+  // n<driver vertex index>) with a dictionary of the names after the
+  // path ends instead of building the hierarchical names on every line.
+  void setNameIds(bool name_ids);
   ReportField *findField(const char *name);
 
   // Header above reportPathEnd results.
@@ -105,6 +111,10 @@ public:
   void reportSlackOnly(PathEnd *end,
 		       string &result);
 
+  // One JSON object per line for each path end.
+  void reportJson(PathEnd *end,
+		  string &result);
+
   void reportMpwCheck(MinPulseWidthCheck *check,
 		      bool verbose);
   void reportMpwChecks(MinPulseWidthCheckSeq *checks,
@@ -174,6 +184,8 @@ protected:
 			 bool enabled);
   void reportEndpointHeader(PathEnd *end,
 			    PathEnd *prev_end);
+  void reportPathEndsResult(PathEnd *end,
+			    string &result);
   void reportShort(const PathEndUnconstrained *end,
 		   PathExpanded &expanded,
 		   string &result);
@@ -456,6 +468,13 @@ protected:
 		      string &result);
   void reportEndOfLine(string &result);
   string descriptionField(Vertex *vertex);
+  // Pin and net names for path lines.
+  const char *pinName(const Pin *pin);
+  const char *netName(const Net *net,
+		      const Pin *drvr_pin);
+  ReportNameCache *nameCache();
+  bool nameIds() const;
+  void reportNameDictionary();
   bool reportClkPath() const;
   string clkName(const Clock *clk,
 		 bool inverted);;
@@ -505,6 +524,10 @@ protected:
 			     PathRef &ref_path);
   const char *asRisingFalling(const TransRiseFall *tr);
   const char *asRiseFall(const TransRiseFall *tr);;
+  void jsonKey(const char *key,
+	       string &result);
+  void jsonTime(float value,
+		string &result);
 
   // Path options.
   ReportPathFormat format_;
@@ -512,6 +535,7 @@ protected:
   bool report_input_pin_;
   bool report_net_;
   bool no_split_;
+  bool name_ids_;
   int digits_;
 
   int start_end_pt_width_;
@@ -527,6 +551,15 @@ protected:
 
   const char *plus_zero_;
   const char *minus_zero_;
+  // Reused by reportJson so long reports do not allocate per path end.
+  string json_buffer_;
+  // Arc delay calculator for each thread pool worker while
+  // reportPathEnds is formatting path ends.
+  Vector<ArcDelayCalc*> thread_arc_delay_calcs_;
+  // Names built from reportPathEndHeader to reportPathEndFooter
+  // so pins common to many paths are only named once.
+  // Indexed by thread pool worker index + 1.
+  Vector<ReportNameCache*> name_caches_;
 
   static const float field_blank_;
   static const float field_skip_;
@@ -0,0 +1,734 @@
+// OpenSTA, Static Timing Analyzer
+// Copyright (c) 2019, Parallax Software, Inc.
+// 
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+// 
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+// 
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#include <ctype.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <vector>
+#include "Machine.hh"
+#include "DisallowCopyAssign.hh"
+#include "StringUtil.hh"
+#include "MinMax.hh"
+#include "Transition.hh"
+#include "PortDirection.hh"
+#include "Units.hh"
+#include "Network.hh"
+#include "Clock.hh"
+#include "ExceptionPath.hh"
+#include "Sdc.hh"
+#include "Sta.hh"
+#include "SdcFastCmd.hh"
+
+namespace sta {
+
+using std::string;
+
+typedef std::vector<string> SdcNameSeq;
+
+enum class SdcObjectType { none, pins, ports, cells, nets, clocks };
+
+// Command word.  Object words hold the names of a [get_* names] command.
+class SdcWord
+{
+public:
+  SdcWord();
+
+  string text_;
+  SdcObjectType obj_type_;
+  SdcNameSeq names_;
+};
+
+typedef std::vector<SdcWord> SdcWordSeq;
+
+// Objects found for an object word.
+class SdcObjects
+{
+public:
+  PinSet pins_;
+  PortSeq ports_;
+  InstanceSet insts_;
+  NetSet nets_;
+  ClockSet clks_;
+};
+
+class SdcFastCmd : public StaState
+{
+public:
+  SdcFastCmd(const char *filename,
+	     int line,
+	     Sta *sta);
+  bool eval(const char *cmd);
+
+private:
+  DISALLOW_COPY_AND_ASSIGN(SdcFastCmd);
+  bool parseWords(const char *cmd);
+  bool parseObjectCmd(const string &cmd,
+		      SdcWord &word);
+  bool splitNames(const string &list,
+		  SdcNameSeq &names);
+  bool findObjects(const SdcWord &word,
+		   SdcObjects &objects);
+  bool isKey(size_t index) const;
+  bool parseFloat(const string &str,
+		  float &value) const;
+  bool parseInt(const string &str,
+		int &value) const;
+  Clock *findClock(const SdcWord &word);
+  bool evalPortDelay(bool input);
+  bool evalLoad();
+  bool evalException(const string &cmd_name);
+  void deleteExceptionPts(ExceptionFrom *from,
+			  ExceptionThruSeq *thrus,
+			  ExceptionTo *to);
+
+  const char *filename_;
+  int line_;
+  Sta *sta_;
+  SdcWordSeq words_;
+};
+
+bool
+evalSdcFastCmd(const char *cmd,
+	       const char *filename,
+	       int line,
+	       Sta *sta)
+{
+  if (!sta->network()->isLinked())
+    return false;
+  SdcFastCmd fast_cmd(filename, line, sta);
+  return fast_cmd.eval(cmd);
+}
+
+SdcWord::SdcWord() :
+  obj_type_(SdcObjectType::none)
+{
+}
+
+SdcFastCmd::SdcFastCmd(const char *filename,
+		       int line,
+		       Sta *sta) :
+  StaState(sta),
+  filename_(filename),
+  line_(line),
+  sta_(sta)
+{
+}
+
+bool
+SdcFastCmd::eval(const char *cmd)
+{
+  const char *s = cmd;
+  while (isspace(*s))
+    s++;
+  // Blank lines and comments.
+  if (*s == '\0')
+    return true;
+  if (*s == '#')
+    return false;
+  // Substitutions and quoting are left to Tcl.
+  if (strpbrk(s, "\\$;\"") != nullptr)
+    return false;
+  if (!parseWords(s) || words_.empty()
+      || words_[0].obj_type_ != SdcObjectType::none)
+    return false;
+  const string &cmd_name = words_[0].text_;
+  if (cmd_name == "set_input_delay")
+    return evalPortDelay(true);
+  else if (cmd_name == "set_output_delay")
+    return evalPortDelay(false);
+  else if (cmd_name == "set_load")
+    return evalLoad();
+  else if (cmd_name == "set_false_path"
+	   || cmd_name == "set_multicycle_path"
+	   || cmd_name == "set_max_delay"
+	   || cmd_name == "set_min_delay")
+    return evalException(cmd_name);
+  else
+    return false;
+}
+
+bool
+SdcFastCmd::parseWords(const char *cmd)
+{
+  const char *s = cmd;
+  bool at_newline = false;
+  while (true) {
+    while (*s == ' ' || *s == '\t' || *s == '\r' || *s == '\n') {
+      if (*s == '\n')
+	at_newline = true;
+      s++;
+    }
+    if (*s == '\0')
+      return true;
+    // More than one command.
+    if (at_newline)
+      return false;
+    SdcWord word;
+    if (*s == '{' || *s == '[') {
+      char open = *s;
+      char close = (open == '{') ? '}' : ']';
+      const char *begin = ++s;
+      int depth = 1;
+      while (*s) {
+	if (*s == open) {
+	  // Nested commands are left to Tcl.
+	  if (open == '[')
+	    return false;
+	  depth++;
+	}
+	else if (*s == close && --depth == 0)
+	  break;
+	s++;
+      }
+      if (*s == '\0')
+	return false;
+      string text(begin, s - begin);
+      s++;
+      if (*s != '\0' && !isspace(*s))
+	return false;
+      if (open == '[') {
+	if (!parseObjectCmd(text, word))
+	  return false;
+      }
+      else
+	word.text_ = text;
+    }
+    else {
+      const char *begin = s;
+      while (*s && !isspace(*s)) {
+	if (*s == '{' || *s == '}' || *s == '[' || *s == ']')
+	  return false;
+	s++;
+      }
+      word.text_.assign(begin, s - begin);
+    }
+    words_.push_back(word);
+  }
+}
+
+// [get_pins names] with no options.
+bool
+SdcFastCmd::parseObjectCmd(const string &cmd,
+			   SdcWord &word)
+{
+  size_t cmd_begin = cmd.find_first_not_of(" \t");
+  if (cmd_begin == string::npos)
+    return false;
+  size_t cmd_end = cmd.find_first_of(" \t", cmd_begin);
+  if (cmd_end == string::npos)
+    return false;
+  string obj_cmd = cmd.substr(cmd_begin, cmd_end - cmd_begin);
+  if (obj_cmd == "get_pins")
+    word.obj_type_ = SdcObjectType::pins;
+  else if (obj_cmd == "get_ports")
+    word.obj_type_ = SdcObjectType::ports;
+  else if (obj_cmd == "get_cells")
+    word.obj_type_ = SdcObjectType::cells;
+  else if (obj_cmd == "get_nets")
+    word.obj_type_ = SdcObjectType::nets;
+  else if (obj_cmd == "get_clocks")
+    word.obj_type_ = SdcObjectType::clocks;
+  else
+    return false;
+
+  size_t arg_begin = cmd.find_first_not_of(" \t", cmd_end);
+  if (arg_begin == string::npos)
+    return false;
+  string arg;
+  if (cmd[arg_begin] == '{') {
+    size_t arg_end = cmd.find('}', arg_begin);
+    if (arg_end == string::npos
+	|| cmd.find_first_not_of(" \t", arg_end + 1) != string::npos)
+      return false;
+    arg = cmd.substr(arg_begin + 1, arg_end - arg_begin - 1);
+  }
+  else {
+    size_t arg_end = cmd.find_first_of(" \t", arg_begin);
+    if (arg_end != string::npos
+	&& cmd.find_first_not_of(" \t", arg_end) != string::npos)
+      return false;
+    arg = cmd.substr(arg_begin, arg_end - arg_begin);
+    // Options such as -hierarchical or -of_objects.
+    if (arg[0] == '-')
+      return false;
+  }
+  return splitNames(arg, word.names_);
+}
+
+bool
+SdcFastCmd::splitNames(const string &list,
+		       SdcNameSeq &names)
+{
+  size_t begin = list.find_first_not_of(" \t\n");
+  while (begin != string::npos) {
+    size_t end = list.find_first_of(" \t\n", begin);
+    string name = list.substr(begin, end - begin);
+    // Wildcards and bus bits use Tcl pattern matching.
+    if (name.find_first_of("*?[]{}") != string::npos)
+      return false;
+    names.push_back(name);
+    begin = (end == string::npos)
+      ? string::npos
+      : list.find_first_not_of(" \t\n", end);
+  }
+  return !names.empty();
+}
+
+// Fail if any name is not found so Tcl reports it.
+bool
+SdcFastCmd::findObjects(const SdcWord &word,
+			SdcObjects &objects)
+{
+  Instance *top_inst = network_->topInstance();
+  for (const string &name : word.names_) {
+    const char *name1 = name.c_str();
+    switch (word.obj_type_) {
+    case SdcObjectType::pins: {
+      // Top level pins are matched by get_pins patterns differently.
+      if (name.find(cmd_network_->pathDivider()) == string::npos)
+	return false;
+      Pin *pin = cmd_network_->findPin(name1);
+      if (pin == nullptr)
+	return false;
+      objects.pins_.insert(pin);
+      break;
+    }
+    case SdcObjectType::ports: {
+      Port *port = cmd_network_->findPort(cmd_network_->cell(top_inst),
+					  name1);
+      if (port == nullptr)
+	return false;
+      Pin *pin = network_->findPin(top_inst, port);
+      if (pin == nullptr)
+	return false;
+      objects.ports_.push_back(port);
+      objects.pins_.insert(pin);
+      break;
+    }
+    case SdcObjectType::cells: {
+      Instance *inst = cmd_network_->findInstance(name1);
+      if (inst == nullptr)
+	return false;
+      objects.insts_.insert(inst);
+      break;
+    }
+    case SdcObjectType::nets: {
+      Net *net = cmd_network_->findNet(name1);
+      if (net == nullptr)
+	return false;
+      objects.nets_.insert(net);
+      break;
+    }
+    case SdcObjectType::clocks: {
+      Clock *clk = sdc_->findClock(name1);
+      if (clk == nullptr)
+	return false;
+      objects.clks_.insert(clk);
+      break;
+    }
+    case SdcObjectType::none:
+      return false;
+    }
+  }
+  return true;
+}
+
+bool
+SdcFastCmd::isKey(size_t index) const
+{
+  const SdcWord &word = words_[index];
+  if (word.obj_type_ == SdcObjectType::none
+      && word.text_.size() > 1
+      && word.text_[0] == '-') {
+    float value;
+    // Negative numbers are not keys.
+    return !parseFloat(word.text_, value);
+  }
+  return false;
+}
+
+bool
+SdcFastCmd::parseFloat(const string &str,
+		       float &value) const
+{
+  const char *s = str.c_str();
+  char *end;
+  value = strtof(s, &end);
+  return end != s && *end == '\0';
+}
+
+bool
+SdcFastCmd::parseInt(const string &str,
+		     int &value) const
+{
+  const char *s = str.c_str();
+  char *end;
+  value = strtol(s, &end, 10);
+  return end != s && *end == '\0';
+}
+
+// -clock clk_name or -clock [get_clocks clk_name].
+Clock *
+SdcFastCmd::findClock(const SdcWord &word)
+{
+  if (word.obj_type_ == SdcObjectType::none)
+    return sdc_->findClock(word.text_.c_str());
+  else if (word.obj_type_ == SdcObjectType::clocks
+	   && word.names_.size() == 1)
+    return sdc_->findClock(word.names_[0].c_str());
+  else
+    return nullptr;
+}
+
+////////////////////////////////////////////////////////////////
+
+bool
+SdcFastCmd::evalPortDelay(bool input)
+{
+  Clock *clk = nullptr;
+  bool rise = false, fall = false, min = false, max = false;
+  bool clk_fall = false, add = false;
+  bool source_latency_included = false, network_latency_included = false;
+  SdcWordSeq args;
+  for (size_t i = 1; i < words_.size(); i++) {
+    if (isKey(i)) {
+      const string &key = words_[i].text_;
+      if (key == "-clock") {
+	if (clk || ++i == words_.size())
+	  return false;
+	clk = findClock(words_[i]);
+	if (clk == nullptr)
+	  return false;
+      }
+      else if (key == "-rise")
+	rise = true;
+      else if (key == "-fall")
+	fall = true;
+      else if (key == "-min")
+	min = true;
+      else if (key == "-max")
+	max = true;
+      else if (key == "-clock_fall")
+	clk_fall = true;
+      else if (key == "-add_delay")
+	add = true;
+      else if (key == "-source_latency_included")
+	source_latency_included = true;
+      else if (key == "-network_latency_included")
+	network_latency_included = true;
+      else
+	// -reference_pin and errors.
+	return false;
+    }
+    else
+      args.push_back(words_[i]);
+  }
+  float delay;
+  SdcObjects objects;
+  if (args.size() != 2
+      || args[0].obj_type_ != SdcObjectType::none
+      || !parseFloat(args[0].text_, delay)
+      || !(args[1].obj_type_ == SdcObjectType::pins
+	   || args[1].obj_type_ == SdcObjectType::ports)
+      || !findObjects(args[1], objects)
+      // Both -min and -max is an error.
+      || (min && max))
+    return false;
+
+  // Pins that Tcl warns about.
+  for (Pin *pin : objects.pins_) {
+    if (network_->isTopLevelPort(pin)) {
+      PortDirection *dir = network_->direction(pin);
+      bool dir_ok = input
+	? (dir->isInput() || dir->isBidirect())
+	: (dir->isOutput() || dir->isTristate() || dir->isBidirect());
+      if (!dir_ok)
+	return false;
+    }
+    if (clk && clk->pins() && clk->pins()->hasKey(pin))
+      return false;
+  }
+
+  const TransRiseFallBoth *tr = TransRiseFallBoth::riseFall();
+  if (rise && !fall)
+    tr = TransRiseFallBoth::rise();
+  else if (fall && !rise)
+    tr = TransRiseFallBoth::fall();
+  const MinMaxAll *min_max = MinMaxAll::all();
+  if (min)
+    min_max = MinMaxAll::min();
+  else if (max)
+    min_max = MinMaxAll::max();
+  const TransRiseFall *clk_tr = clk_fall
+    ? TransRiseFall::fall()
+    : TransRiseFall::rise();
+  delay *= units_->timeUnit()->scale();
+  for (Pin *pin : objects.pins_) {
+    if (input)
+      sta_->setInputDelay(pin, tr, clk, clk_tr, nullptr,
+			  source_latency_included, network_latency_included,
+			  min_max, add, delay);
+    else
+      sta_->setOutputDelay(pin, tr, clk, clk_tr, nullptr,
+			   source_latency_included, network_latency_included,
+			   min_max, add, delay);
+  }
+  return true;
+}
+
+// set_load on ports.
+bool
+SdcFastCmd::evalLoad()
+{
+  bool rise = false, fall = false, min = false, max = false;
+  bool pin_load = false, wire_load = false, subtract_pin_load = false;
+  SdcWordSeq args;
+  for (size_t i = 1; i < words_.size(); i++) {
+    if (isKey(i)) {
+      const string &key = words_[i].text_;
+      if (key == "-rise")
+	rise = true;
+      else if (key == "-fall")
+	fall = true;
+      else if (key == "-min")
+	min = true;
+      else if (key == "-max")
+	max = true;
+      else if (key == "-pin_load")
+	pin_load = true;
+      else if (key == "-wire_load")
+	wire_load = true;
+      else if (key == "-subtract_pin_load")
+	subtract_pin_load = true;
+      else
+	// -corner and errors.
+	return false;
+    }
+    else
+      args.push_back(words_[i]);
+  }
+  float cap;
+  SdcObjects objects;
+  if (args.size() != 2
+      || args[0].obj_type_ != SdcObjectType::none
+      || !parseFloat(args[0].text_, cap)
+      || cap < 0.0
+      || args[1].obj_type_ != SdcObjectType::ports
+      || !findObjects(args[1], objects))
+    return false;
+
+  const TransRiseFallBoth *tr = TransRiseFallBoth::riseFall();
+  if (rise && !fall)
+    tr = TransRiseFallBoth::rise();
+  else if (fall && !rise)
+    tr = TransRiseFallBoth::fall();
+  const MinMaxAll *min_max = MinMaxAll::all();
+  if (min && !max)
+    min_max = MinMaxAll::min();
+  else if (max && !min)
+    min_max = MinMaxAll::max();
+  cap *= units_->capacitanceUnit()->scale();
+  for (Port *port : objects.ports_) {
+    // -pin_load is the default.
+    if (pin_load || !wire_load)
+      sta_->setPortExtPinCap(port, tr, min_max, cap);
+    else
+      sta_->setPortExtWireCap(port, subtract_pin_load, tr, min_max, cap);
+  }
+  return true;
+}
+
+// set_false_path, set_multicycle_path, set_max_delay, set_min_delay.
+bool
+SdcFastCmd::evalException(const string &cmd_name)
+{
+  bool is_false_path = (cmd_name == "set_false_path");
+  bool is_mcp = (cmd_name == "set_multicycle_path");
+  bool is_path_delay = !(is_false_path || is_mcp);
+  bool setup = false, hold = false, rise = false, fall = false;
+  bool start = false, end = false, ignore_clk_latency = false;
+  const SdcWord *from_word = nullptr;
+  const SdcWord *to_word = nullptr;
+  const TransRiseFallBoth *from_tr = TransRiseFallBoth::riseFall();
+  const TransRiseFallBoth *to_tr = TransRiseFallBoth::riseFall();
+  std::vector<const SdcWord*> thru_words;
+  std::vector<const TransRiseFallBoth*> thru_trs;
+  string comment;
+  SdcWordSeq args;
+  for (size_t i = 1; i < words_.size(); i++) {
+    if (isKey(i)) {
+      const string &key = words_[i].text_;
+      if (key == "-from" || key == "-rise_from" || key == "-fall_from") {
+	if (from_word || ++i == words_.size())
+	  return false;
+	from_word = &words_[i];
+	if (key == "-rise_from")
+	  from_tr = TransRiseFallBoth::rise();
+	else if (key == "-fall_from")
+	  from_tr = TransRiseFallBoth::fall();
+      }
+      else if (key == "-to" || key == "-rise_to" || key == "-fall_to") {
+	if (to_word || ++i == words_.size())
+	  return false;
+	to_word = &words_[i];
+	if (key == "-rise_to")
+	  to_tr = TransRiseFallBoth::rise();
+	else if (key == "-fall_to")
+	  to_tr = TransRiseFallBoth::fall();
+      }
+      else if (key == "-through" || key == "-rise_through"
+	       || key == "-fall_through") {
+	if (++i == words_.size())
+	  return false;
+	thru_words.push_back(&words_[i]);
+	if (key == "-rise_through")
+	  thru_trs.push_back(TransRiseFallBoth::rise());
+	else if (key == "-fall_through")
+	  thru_trs.push_back(TransRiseFallBoth::fall());
+	else
+	  thru_trs.push_back(TransRiseFallBoth::riseFall());
+      }
+      else if (key == "-comment") {
+	if (!comment.empty() || ++i == words_.size()
+	    || words_[i].obj_type_ != SdcObjectType::none)
+	  return false;
+	comment = words_[i].text_;
+      }
+      else if (key == "-rise")
+	rise = true;
+      else if (key == "-fall")
+	fall = true;
+      else if (key == "-setup" && !is_path_delay)
+	setup = true;
+      else if (key == "-hold" && !is_path_delay)
+	hold = true;
+      else if (key == "-start" && is_mcp)
+	start = true;
+      else if (key == "-end" && is_mcp)
+	end = true;
+      else if (key == "-ignore_clock_latency" && is_path_delay)
+	ignore_clk_latency = true;
+      else
+	// -reset_path and errors.
+	return false;
+    }
+    else
+      args.push_back(words_[i]);
+  }
+
+  int path_multiplier = 0;
+  float delay = 0.0;
+  if (is_false_path) {
+    if (!args.empty())
+      return false;
+  }
+  else if (args.size() != 1
+	   || args[0].obj_type_ != SdcObjectType::none
+	   || (is_mcp && !parseInt(args[0].text_, path_multiplier))
+	   || (is_path_delay && !parseFloat(args[0].text_, delay)))
+    return false;
+  if (!is_path_delay
+      && from_word == nullptr && thru_words.empty() && to_word == nullptr)
+    return false;
+  if (start && end)
+    return false;
+
+  // Find all of the objects before making anything.
+  SdcObjects from_objs, to_objs;
+  std::vector<SdcObjects> thru_objs(thru_words.size());
+  if (from_word
+      && (from_word->obj_type_ == SdcObjectType::nets
+	  || !findObjects(*from_word, from_objs)))
+    return false;
+  if (to_word
+      && (to_word->obj_type_ == SdcObjectType::nets
+	  || !findObjects(*to_word, to_objs)))
+    return false;
+  for (size_t i = 0; i < thru_words.size(); i++) {
+    const SdcWord *thru_word = thru_words[i];
+    if (thru_word->obj_type_ == SdcObjectType::clocks
+	|| !findObjects(*thru_word, thru_objs[i]))
+      return false;
+  }
+
+  ExceptionFrom *from = nullptr;
+  if (from_word)
+    from = sta_->makeExceptionFrom(new PinSet(from_objs.pins_),
+				   new ClockSet(from_objs.clks_),
+				   new InstanceSet(from_objs.insts_),
+				   from_tr);
+  ExceptionThruSeq *thrus = nullptr;
+  if (!thru_words.empty()) {
+    thrus = new ExceptionThruSeq;
+    for (size_t i = 0; i < thru_words.size(); i++) {
+      SdcObjects &objs = thru_objs[i];
+      thrus->push_back(sta_->makeExceptionThru(new PinSet(objs.pins_),
+					       new NetSet(objs.nets_),
+					       new InstanceSet(objs.insts_),
+					       thru_trs[i]));
+    }
+  }
+  TransRiseFallBoth *end_tr = TransRiseFallBoth::riseFall();
+  if (rise && !fall)
+    end_tr = TransRiseFallBoth::rise();
+  else if (fall && !rise)
+    end_tr = TransRiseFallBoth::fall();
+  ExceptionTo *to = nullptr;
+  if (to_word)
+    to = sta_->makeExceptionTo(new PinSet(to_objs.pins_),
+			       new ClockSet(to_objs.clks_),
+			       new InstanceSet(to_objs.insts_),
+			       to_tr, end_tr);
+  else if (end_tr != TransRiseFallBoth::riseFall())
+    // -rise/-fall without -to.
+    to = sta_->makeExceptionTo(new PinSet, new ClockSet, new InstanceSet,
+			       TransRiseFallBoth::riseFall(), end_tr);
+
+  const char *comment1 = comment.c_str();
+  if (is_path_delay) {
+    const MinMax *min_max = (cmd_name == "set_max_delay")
+      ? MinMax::max()
+      : MinMax::min();
+    sta_->makePathDelay(from, thrus, to, min_max, ignore_clk_latency,
+			delay * units_->timeUnit()->scale(), comment1);
+  }
+  else {
+    sta_->checkExceptionFromPins(from, filename_, line_);
+    sta_->checkExceptionToPins(to, filename_, line_);
+    const MinMaxAll *min_max = MinMaxAll::all();
+    bool use_end_clk = true;
+    if (setup && !hold)
+      min_max = MinMaxAll::max();
+    else if (hold && !setup) {
+      min_max = MinMaxAll::min();
+      use_end_clk = false;
+    }
+    if (is_false_path)
+      sta_->makeFalsePath(from, thrus, to, min_max, comment1);
+    else {
+      if (start)
+	use_end_clk = false;
+      else if (end)
+	use_end_clk = true;
+      sta_->makeMulticyclePath(from, thrus, to, min_max, use_end_clk,
+			       path_multiplier, comment1);
+    }
+  }
+  return true;
+}
+
+} // namespace
@@ -0,0 +1,40 @@
+// OpenSTA, Static Timing Analyzer
+// Copyright (c) 2019, Parallax Software, Inc.
+// 
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+// 
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+// 
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#ifndef STA_SDC_FAST_CMD_H
+#define STA_SDC_FAST_CMD_H
+
+namespace sta {
+
+class Sta;
+
+// Evaluate the SDC commands that dominate large constraint files
+//   set_false_path set_multicycle_path set_max_delay set_min_delay
+//   set_input_delay set_output_delay set_load
+// without going through the Tcl command procs.
+// Object arguments must be [get_pins|get_ports|get_cells|get_nets|get_clocks]
+// of plain names.  Commands that are not handled (variables, quotes,
+// nested commands, wildcards, unknown objects, options that are
+// not supported here) return false without side effects so the
+// caller can evaluate them with Tcl.
+bool
+evalSdcFastCmd(const char *cmd,
+	       const char *filename,
+	       int line,
+	       Sta *sta);
+
+} // namespace
+#endif
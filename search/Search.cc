@@ -16,6 +16,9 @@
 
 #include <algorithm>
 #include <cmath> // abs
+#include <set>
+#include <string>
+#include <vector>
 #include "Machine.hh"
 #include "DisallowCopyAssign.hh"
 #include "Mutex.hh"
@@ -24,6 +27,8 @@
 #include "Debug.hh"
 #include "Error.hh"
 #include "Stats.hh"
+#include "MemoryReport.hh"
+#include "UnorderedSet.hh"
 #include "Fuzzy.hh"
 #include "TimingRole.hh"
 #include "FuncExpr.hh"
@@ -58,6 +63,8 @@
 #include "PathAnalysisPt.hh"
 #include "VisitPathEnds.hh"
 #include "GatedClk.hh"
+#include "AocvDepths.hh"
+#include "FindRegister.hh"
 #include "WorstSlack.hh"
 #include "Latches.hh"
 #include "Crpr.hh"
@@ -66,6 +73,10 @@
 
 namespace sta {
 
+// Compact tags when this many tag groups have been made since the
+// last compaction and they are at least half as many as there were.
+static const TagGroupIndex tag_compact_group_min = 10000;
+
 using std::min;
 using std::max;
 using std::abs;
@@ -105,7 +116,8 @@ EvalPred::searchTo(const Vertex *to_vertex)
   const Pin *pin = to_vertex->pin();
   return SearchPred0::searchTo(to_vertex)
     && !(sdc->isVertexPinClock(pin)
-	 && !sdc->isPathDelayInternalEndpoint(pin));
+	 && !sdc->isPathDelayInternalEndpoint(pin))
+    && sta_->search()->inTimingScope(to_vertex);
 }
 
 ////////////////////////////////////////////////////////////////
@@ -219,7 +231,9 @@ ClkArrivalSearchPred::searchThru(Edge *edge)
 ////////////////////////////////////////////////////////////////
 
 Search::Search(StaState *sta) :
-  StaState(sta)
+  StaState(sta),
+  tags_(tag_index_max),
+  tag_groups_(tag_group_index_max)
 {
   init(sta);
 }
@@ -234,6 +248,7 @@ Search::init(StaState *sta)
   check_crpr_ = new CheckCrpr(sta);
   genclks_ = new Genclks(sta);
   arrival_visitor_ = new ArrivalVisitor(sta);
+  timing_scope_exists_ = false;
   clk_arrivals_valid_ = false;
   arrivals_exist_ = false;
   arrivals_at_endpoints_exist_ = false;
@@ -241,23 +256,25 @@ Search::init(StaState *sta)
   requireds_exist_ = false;
   requireds_seeded_ = false;
   tns_exists_ = false;
+  arrival_journal_active_ = false;
   worst_slacks_ = nullptr;
   arrival_iter_ = new BfsFwdIterator(BfsIndex::arrival, nullptr, sta);
   required_iter_ = new BfsBkwdIterator(BfsIndex::required, search_adj_, sta);
-  tag_capacity_ = 127;
-  tag_set_ = new TagHashSet(tag_capacity_, false);
-  clk_info_set_ = new ClkInfoSet(ClkInfoLess(sta));
+  tag_set_ = new TagHashSet;
+  clk_info_set_ = new ClkInfoSet;
   tag_next_ = 0;
-  tags_ = new Tag*[tag_capacity_];
-  tag_group_capacity_ = 127;
-  tag_groups_ = new TagGroup*[tag_group_capacity_];
   tag_group_next_ = 0;
-  tag_group_set_ = new TagGroupSet(tag_group_capacity_, false);
+  tag_group_compact_count_ = 0;
+  tag_group_set_ = new TagGroupSet;
+  incremental_tolerance_ = 0.0;
   visit_path_ends_ = new VisitPathEnds(this);
   gated_clk_ = new GatedClk(this);
+  aocv_depths_ = new AocvDepths(this);
+  reg_clk_index_ = new RegClkIndex;
   path_groups_ = nullptr;
+  path_ends_args_ = nullptr;
+  path_ends_valid_ = false;
   endpoints_ = nullptr;
-  invalid_endpoints_ = nullptr;
   filter_ = nullptr;
   filter_from_ = nullptr;
   filter_to_ = nullptr;
@@ -271,6 +288,10 @@ Search::initVars()
   unconstrained_paths_ = false;
   crpr_path_pruning_enabled_ = true;
   crpr_approx_missing_requireds_ = true;
+  clk_domain_partitions_ = false;
+  prev_path_storage_ = true;
+  statistical_max_ = false;
+  aocv_enabled_ = false;
 }
 
 Search::~Search()
@@ -279,8 +300,6 @@ Search::~Search()
   deleteTags();
   delete tag_set_;
   delete clk_info_set_;
-  delete [] tags_;
-  delete [] tag_groups_;
   delete tag_group_set_;
   delete search_adj_;
   delete eval_pred_;
@@ -288,9 +307,10 @@ Search::~Search()
   delete arrival_iter_;
   delete required_iter_;
   delete endpoints_;
-  delete invalid_endpoints_;
   delete visit_path_ends_;
   delete gated_clk_;
+  delete aocv_depths_;
+  delete reg_clk_index_;
   delete worst_slacks_;
   delete check_crpr_;
   delete genclks_;
@@ -308,6 +328,7 @@ Search::clear()
   arrivals_seeded_ = false;
   requireds_exist_ = false;
   requireds_seeded_ = false;
+  required_cone_vertices_.clear();
   tns_exists_ = false;
   clearWorstSlack();
   invalid_arrivals_.clear();
@@ -321,8 +342,11 @@ Search::clear()
   deleteTags();
   clearPendingLatchOutputs();
   deleteFilter();
+  clearTimingScope();
   genclks_->clear();
   found_downstream_clk_pins_ = false;
+  reg_clk_index_->invalid();
+  aocv_depths_->clear();
 }
 
 bool
@@ -349,17 +373,73 @@ Search::setCrprApproxMissingRequireds(bool enabled)
   crpr_approx_missing_requireds_ = enabled;
 }
 
+void
+Search::setClkDomainPartitions(bool partitions)
+{
+  clk_domain_partitions_ = partitions;
+}
+
+void
+Search::setPrevPathStorage(bool storage)
+{
+  if (storage != prev_path_storage_) {
+    prev_path_storage_ = storage;
+    // Existing prev paths are made or deleted by the next search.
+    arrivalsInvalid();
+  }
+}
+
+void
+Search::setStatisticalMax(bool statistical_max)
+{
+  if (statistical_max != statistical_max_) {
+    statistical_max_ = statistical_max;
+    arrivalsInvalid();
+  }
+}
+
+void
+Search::setAocvEnabled(bool enabled)
+{
+  if (enabled != aocv_enabled_) {
+    aocv_enabled_ = enabled;
+    if (!enabled)
+      aocv_depths_->clear();
+    arrivalsInvalid();
+  }
+}
+
+void
+Search::setIncrementalTolerance(float tol)
+{
+  incremental_tolerance_ = tol;
+}
+
+bool
+Search::exceedsIncrementalTolerance(const Arrival &time1,
+				    const Arrival &time2) const
+{
+  return !fuzzyEqual(time1, time2)
+    && (incremental_tolerance_ == 0.0
+	|| abs(delayAsFloat(time1) - delayAsFloat(time2))
+	> incremental_tolerance_);
+}
+
 void
 Search::deleteTags()
 {
   for (TagGroupIndex i = 0; i < tag_group_next_; i++) {
     TagGroup *group = tag_groups_[i];
     delete group;
+    tag_groups_.set(i, nullptr);
   }
   tag_group_next_ = 0;
   tag_group_set_->clear();
   tag_group_free_indices_.clear();
+  tag_group_compact_count_ = 0;
 
+  for (TagIndex i = 0; i < tag_next_; i++)
+    tags_.set(i, nullptr);
   tag_next_ = 0;
   tag_set_->deleteContentsClear();
   tag_free_indices_.clear();
@@ -393,6 +473,7 @@ Search::copyState(const StaState *sta)
   required_iter_->copyState(sta);
   visit_path_ends_->copyState(sta);
   gated_clk_->copyState(sta);
+  aocv_depths_->copyState(sta);
   check_crpr_->copyState(sta);
   genclks_->copyState(sta);
 }
@@ -403,6 +484,7 @@ void
 Search::deletePaths()
 {
   debugPrint0(debug_, "search", 1, "delete paths\n");
+  check_crpr_->clearCache();
   if (arrivals_exist_) {
     VertexIterator vertex_iter(graph_);
     while (vertex_iter.hasNext()) {
@@ -416,11 +498,18 @@ Search::deletePaths()
 void
 Search::deletePaths1(Vertex *vertex)
 {
-  Arrival *arrivals = vertex->arrivals();
-  delete [] arrivals;
+  if (arrival_journal_active_)
+    journalArrivals(vertex);
+  pathEndInvalid(vertex);
+  graph_->deleteArrivals(vertex->arrivals());
   vertex->setArrivals(nullptr);
   PathVertexRep *prev_paths = vertex->prevPaths();
-  delete [] prev_paths;
+  // Only clock network vertices have prev paths.
+  if (prev_paths) {
+    check_crpr_->clkArrivalsChanged();
+    pathEndsInvalid();
+  }
+  graph_->deletePrevPaths(prev_paths);
   vertex->setPrevPaths(nullptr);
   vertex->setTagGroupIndex(tag_group_index_max);
   vertex->setHasRequireds(false);
@@ -438,6 +527,140 @@ Search::deletePaths(Vertex *vertex)
 
 ////////////////////////////////////////////////////////////////
 
+class VertexPathsSave
+{
+public:
+  TagGroupIndex tag_group_index_;
+  Arrival *arrivals_;
+  PathVertexRep *prev_paths_;
+  bool has_requireds_;
+  bool crpr_path_pruning_disabled_;
+};
+
+void
+Search::beginArrivalJournal()
+{
+  endArrivalJournal();
+  arrival_journal_active_ = true;
+}
+
+void
+Search::journalArrivals(Vertex *vertex)
+{
+  UniqueLock lock(arrival_journal_lock_);
+  if (!arrival_journal_.hasKey(vertex)) {
+    VertexPathsSave *save = new VertexPathsSave;
+    save->tag_group_index_ = vertex->tagGroupIndex();
+    save->arrivals_ = nullptr;
+    save->prev_paths_ = nullptr;
+    save->has_requireds_ = vertex->hasRequireds();
+    save->crpr_path_pruning_disabled_ = vertex->crprPathPruningDisabled();
+    TagGroup *tag_group = tagGroup(vertex);
+    if (tag_group) {
+      int arrival_count = tag_group->arrivalCount();
+      Arrival *arrivals = vertex->arrivals();
+      if (arrivals) {
+	int count = save->has_requireds_ ? arrival_count * 2 : arrival_count;
+	save->arrivals_ = graph_->makeArrivals(count);
+	for (int i = 0; i < count; i++)
+	  save->arrivals_[i] = arrivals[i];
+      }
+      PathVertexRep *prev_paths = vertex->prevPaths();
+      if (prev_paths) {
+	save->prev_paths_ = graph_->makePrevPaths(arrival_count);
+	for (int i = 0; i < arrival_count; i++)
+	  save->prev_paths_[i] = prev_paths[i];
+      }
+    }
+    arrival_journal_[vertex] = save;
+  }
+}
+
+void
+Search::restoreArrivalJournal()
+{
+  bool prev_paths_changed = false;
+  for (auto vertex_save : arrival_journal_) {
+    Vertex *vertex = vertex_save.first;
+    VertexPathsSave *save = vertex_save.second;
+    if (vertex->prevPaths() || save->prev_paths_)
+      prev_paths_changed = true;
+    graph_->deleteArrivals(vertex->arrivals());
+    graph_->deletePrevPaths(vertex->prevPaths());
+    vertex->setArrivals(save->arrivals_);
+    vertex->setPrevPaths(save->prev_paths_);
+    vertex->setTagGroupIndex(save->tag_group_index_);
+    vertex->setHasRequireds(save->has_requireds_);
+    vertex->setCrprPathPruningDisabled(save->crpr_path_pruning_disabled_);
+    tnsInvalid(vertex);
+    delete save;
+  }
+  debugPrint1(debug_, "arrival_journal", 1, "restored %lu vertices\n",
+	      arrival_journal_.size());
+  arrival_journal_.clear();
+  arrival_journal_active_ = false;
+  if (prev_paths_changed)
+    check_crpr_->clkArrivalsChanged();
+  // Path ends reference the discarded paths.
+  deletePathGroups();
+}
+
+void
+Search::endArrivalJournal()
+{
+  for (auto vertex_save : arrival_journal_) {
+    VertexPathsSave *save = vertex_save.second;
+    graph_->deleteArrivals(save->arrivals_);
+    graph_->deletePrevPaths(save->prev_paths_);
+    delete save;
+  }
+  arrival_journal_.clear();
+  arrival_journal_active_ = false;
+}
+
+////////////////////////////////////////////////////////////////
+
+// findPathEnds arguments compared to reuse the last path ends.
+class PathEndsArgs
+{
+public:
+  PathEndsArgs(bool unconstrained,
+	       const Corner *corner,
+	       const MinMaxAll *min_max,
+	       int group_count,
+	       int endpoint_count,
+	       bool unique_pins,
+	       float slack_min,
+	       float slack_max,
+	       bool sort_by_slack,
+	       PathGroupNameSet *group_names,
+	       bool setup,
+	       bool hold,
+	       bool recovery,
+	       bool removal,
+	       bool clk_gating_setup,
+	       bool clk_gating_hold);
+  bool equal(const PathEndsArgs *args) const;
+
+private:
+  bool unconstrained_;
+  const Corner *corner_;
+  const MinMaxAll *min_max_;
+  int group_count_;
+  int endpoint_count_;
+  bool unique_pins_;
+  float slack_min_;
+  float slack_max_;
+  bool sort_by_slack_;
+  std::set<std::string> group_names_;
+  bool setup_;
+  bool hold_;
+  bool recovery_;
+  bool removal_;
+  bool clk_gating_setup_;
+  bool clk_gating_hold_;
+};
+
 // from/thrus/to are owned and deleted by Search.
 // Returned sequence is owned by the caller.
 // PathEnds are owned by Search PathGroups and deleted on next call.
@@ -463,6 +686,22 @@ Search::findPathEnds(ExceptionFrom *from,
 		     bool clk_gating_hold)
 {
   unconstrained_paths_ = unconstrained;
+  PathEndsArgs *args = nullptr;
+  if (from == nullptr && thrus == nullptr && to == nullptr) {
+    args = new PathEndsArgs(unconstrained, corner, min_max,
+			    group_count, endpoint_count, unique_pins,
+			    slack_min, slack_max, sort_by_slack, group_names,
+			    setup, hold, recovery, removal,
+			    clk_gating_setup, clk_gating_hold);
+    if (path_ends_args_
+	&& args->equal(path_ends_args_)) {
+      PathEndSeq *path_ends = updatePathEnds(corner, min_max, sort_by_slack);
+      if (path_ends) {
+	delete args;
+	return path_ends;
+      }
+    }
+  }
   // Delete results from last findPathEnds.
   // Filtered arrivals are deleted by Sta::searchPreamble.
   deletePathGroups();
@@ -495,9 +734,107 @@ Search::findPathEnds(ExceptionFrom *from,
 						     corner, min_max,
 						     sort_by_slack);
   sdc_->reportClkToClkMaxCycleWarnings();
+  if (args) {
+    path_ends_args_ = args;
+    path_ends_ = *path_ends;
+    path_ends_valid_ = true;
+  }
   return path_ends;
 }
 
+// Reuse the path groups from the last findPathEnds, replacing the
+// path ends of endpoints with paths that changed since then.
+PathEndSeq *
+Search::updatePathEnds(const Corner *corner,
+		       const MinMaxAll *min_max,
+		       bool sort_by_slack)
+{
+  if (path_ends_valid_) {
+    findAllArrivals();
+    // Clock arrival changes invalidate all of the path ends.
+    if (path_ends_valid_) {
+      if (path_end_invalids_.empty()) {
+	debugPrint0(debug_, "search", 1, "reuse path ends\n");
+	return new PathEndSeq(path_ends_);
+      }
+      VertexSeq invalids;
+      path_end_invalids_.vertices(graph_, invalids);
+      debugPrint1(debug_, "search", 1, "update path ends %zu invalid\n",
+		  invalids.size());
+      PathEndSeq *path_ends =
+	path_groups_->updatePathEnds(invalids, path_end_invalids_,
+				     unconstrained_paths_, corner, min_max,
+				     sort_by_slack);
+      if (path_ends) {
+	path_end_invalids_.clear();
+	path_ends_ = *path_ends;
+	sdc_->reportClkToClkMaxCycleWarnings();
+      }
+      return path_ends;
+    }
+  }
+  return nullptr;
+}
+
+PathEndsArgs::PathEndsArgs(bool unconstrained,
+			   const Corner *corner,
+			   const MinMaxAll *min_max,
+			   int group_count,
+			   int endpoint_count,
+			   bool unique_pins,
+			   float slack_min,
+			   float slack_max,
+			   bool sort_by_slack,
+			   PathGroupNameSet *group_names,
+			   bool setup,
+			   bool hold,
+			   bool recovery,
+			   bool removal,
+			   bool clk_gating_setup,
+			   bool clk_gating_hold) :
+  unconstrained_(unconstrained),
+  corner_(corner),
+  min_max_(min_max),
+  group_count_(group_count),
+  endpoint_count_(endpoint_count),
+  unique_pins_(unique_pins),
+  slack_min_(slack_min),
+  slack_max_(slack_max),
+  sort_by_slack_(sort_by_slack),
+  setup_(setup),
+  hold_(hold),
+  recovery_(recovery),
+  removal_(removal),
+  clk_gating_setup_(clk_gating_setup),
+  clk_gating_hold_(clk_gating_hold)
+{
+  if (group_names) {
+    for (const char *group_name : *group_names)
+      group_names_.insert(group_name);
+  }
+}
+
+bool
+PathEndsArgs::equal(const PathEndsArgs *args) const
+{
+  return unconstrained_ == args->unconstrained_
+    && corner_ == args->corner_
+    && min_max_ == args->min_max_
+    && group_count_ == args->group_count_
+    && endpoint_count_ == args->endpoint_count_
+    && unique_pins_ == args->unique_pins_
+    && slack_min_ == args->slack_min_
+    && slack_max_ == args->slack_max_
+    && sort_by_slack_ == args->sort_by_slack_
+    && setup_ == args->setup_
+    && hold_ == args->hold_
+    && recovery_ == args->recovery_
+    && removal_ == args->removal_
+    && clk_gating_setup_ == args->clk_gating_setup_
+    && clk_gating_hold_ == args->clk_gating_hold_
+    && group_names_ == args->group_names_;
+}
+
 // From/thrus/to are used to make a filter exception.  If the last
 // search used a filter arrival/required times were only found for a
 // subset of the paths.  Delete the paths that have a filter
@@ -540,7 +877,7 @@ Search::deleteFilterTagGroups()
     if (group
 	&& group->hasFilterTag()) {
       tag_group_set_->erase(group);
-      tag_groups_[group->index()] = nullptr;
+      tag_groups_.set(group->index(), nullptr);
       tag_group_free_indices_.push_back(i);
       delete group;
     }
@@ -554,7 +891,7 @@ Search::deleteFilterTags()
     Tag *tag = tags_[i];
     if (tag
 	&& tag->isFilter()) {
-      tags_[i] = nullptr;
+      tags_.set(i, nullptr);
       tag_set_->erase(tag);
       delete tag;
       tag_free_indices_.push_back(i);
@@ -575,6 +912,211 @@ Search::deleteFilterClkInfos()
   }
 }
 
+bool
+Search::requiredsValid() const
+{
+  return clk_arrivals_valid_
+    && arrivals_seeded_
+    && requireds_seeded_
+    && filter_ == nullptr
+    && invalid_arrivals_.empty()
+    && invalid_requireds_.empty()
+    && arrival_iter_->empty()
+    && required_iter_->empty()
+    && invalid_endpoints_.empty();
+}
+
+bool
+Search::tagCompactionDue() const
+{
+  // Journaled tag group indices must stay valid until restored.
+  if (arrival_journal_active_)
+    return false;
+  TagGroupIndex group_count = tag_group_set_->size();
+  TagGroupIndex new_count = group_count > tag_group_compact_count_
+    ? group_count - tag_group_compact_count_
+    : 0;
+  return new_count >= tag_compact_group_min
+    && new_count >= tag_group_compact_count_ / 2;
+}
+
+// Delete the tag groups that no vertex references, the tags that are
+// not in the remaining tag groups or referenced by paths, and the
+// clk infos that are not used by the remaining tags.  Renumber the
+// remaining tags and tag groups densely in their existing order so
+// that arrival maps and clk info sets sorted by index stay sorted.
+// Path ends reference tags, so the path groups are deleted.
+void
+Search::compactTags()
+{
+  Stats stats(debug_, phase_stats_);
+  deletePathGroups();
+  // The crpr cache is keyed by tag index, and tag indices are
+  // renumbered and reused below.
+  check_crpr_->clearCache();
+
+  std::vector<bool> group_used(tag_group_next_, false);
+  std::vector<bool> tag_used(tag_next_, false);
+  std::vector<TagIndex> tag_queue;
+  auto markTag = [&] (TagIndex tag_index) {
+    if (tag_index < tag_next_ && !tag_used[tag_index]) {
+      tag_used[tag_index] = true;
+      tag_queue.push_back(tag_index);
+    }
+  };
+  auto markPath = [&] (const PathVertexRep &path) {
+    if (!path.isNull())
+      markTag(path.tagIndex());
+  };
+
+  VertexIterator vertex_iter(graph_);
+  while (vertex_iter.hasNext()) {
+    Vertex *vertex = vertex_iter.next();
+    TagGroup *tag_group = tagGroup(vertex);
+    if (tag_group) {
+      group_used[tag_group->index()] = true;
+      PathVertexRep *prev_paths = vertex->prevPaths();
+      if (prev_paths) {
+	int arrival_count = tag_group->arrivalCount();
+	for (int i = 0; i < arrival_count; i++)
+	  markPath(prev_paths[i]);
+      }
+    }
+  }
+  for (TagGroupIndex i = 0; i < tag_group_next_; i++) {
+    TagGroup *tag_group = tag_groups_[i];
+    if (tag_group && group_used[i]) {
+      ArrivalMap::Iterator arrival_iter(tag_group->arrivalMap());
+      while (arrival_iter.hasNext()) {
+	Tag *tag;
+	int arrival_index;
+	arrival_iter.next(tag, arrival_index);
+	markTag(tag->index());
+      }
+    }
+  }
+  int src_path_count = genclks_->srcPathCount();
+  GenclkSrcPathMap::Iterator src_path_iter(genclks_->srcPaths());
+  while (src_path_iter.hasNext()) {
+    PathVertexRep *src_paths = src_path_iter.next();
+    for (int i = 0; i < src_path_count; i++)
+      markPath(src_paths[i]);
+  }
+  // Clk info crpr clock paths reference more tags.
+  UnorderedSet<ClkInfo*> clk_infos_used;
+  while (!tag_queue.empty()) {
+    Tag *tag = tags_[tag_queue.back()];
+    tag_queue.pop_back();
+    if (tag) {
+      ClkInfo *clk_info = tag->clkInfo();
+      if (!clk_infos_used.hasKey(clk_info)) {
+	clk_infos_used.insert(clk_info);
+	markPath(clk_info->crprClkPath());
+      }
+    }
+  }
+
+  // Delete and renumber tag groups.
+  std::vector<TagGroupIndex> group_map(tag_group_next_, tag_group_index_max);
+  TagGroupIndex group_next = 0;
+  for (TagGroupIndex i = 0; i < tag_group_next_; i++) {
+    TagGroup *tag_group = tag_groups_[i];
+    if (tag_group) {
+      if (group_used[i]) {
+	group_map[i] = group_next;
+	tag_group->setIndex(group_next);
+	tag_groups_.set(group_next, tag_group);
+	group_next++;
+      }
+      else {
+	tag_group_set_->erase(tag_group);
+	delete tag_group;
+      }
+    }
+  }
+  for (TagGroupIndex i = group_next; i < tag_group_next_; i++)
+    tag_groups_.set(i, nullptr);
+  TagGroupIndex group_delete_count = tag_group_next_ - group_next;
+  tag_group_next_ = group_next;
+  tag_group_free_indices_.clear();
+
+  // Delete and renumber tags.
+  std::vector<TagIndex> tag_map(tag_next_, tag_index_null);
+  TagIndex tag_next = 0;
+  for (TagIndex i = 0; i < tag_next_; i++) {
+    Tag *tag = tags_[i];
+    if (tag) {
+      if (tag_used[i]) {
+	tag_map[i] = tag_next;
+	tag->setIndex(tag_next);
+	tags_.set(tag_next, tag);
+	tag_next++;
+      }
+      else {
+	tag_set_->erase(tag);
+	delete tag;
+      }
+    }
+  }
+  for (TagIndex i = tag_next; i < tag_next_; i++)
+    tags_.set(i, nullptr);
+  TagIndex tag_delete_count = tag_next_ - tag_next;
+  tag_next_ = tag_next;
+  tag_free_indices_.clear();
+
+  size_t clk_info_delete_count = 0;
+  ClkInfoSet::Iterator clk_info_iter(clk_info_set_);
+  while (clk_info_iter.hasNext()) {
+    ClkInfo *clk_info = clk_info_iter.next();
+    if (!clk_infos_used.hasKey(clk_info)) {
+      clk_info_set_->erase(clk_info);
+      delete clk_info;
+      clk_info_delete_count++;
+    }
+  }
+
+  // Renumber the references.
+  auto remapPath = [&] (PathVertexRep &path) {
+    if (!path.isNull()
+	&& static_cast<size_t>(path.tagIndex()) < tag_map.size())
+      path.setTagIndex(tag_map[path.tagIndex()]);
+  };
+  VertexIterator vertex_iter2(graph_);
+  while (vertex_iter2.hasNext()) {
+    Vertex *vertex = vertex_iter2.next();
+    TagGroupIndex group_index = vertex->tagGroupIndex();
+    if (group_index != tag_group_index_max) {
+      TagGroupIndex new_index = group_map[group_index];
+      vertex->setTagGroupIndex(new_index);
+      PathVertexRep *prev_paths = vertex->prevPaths();
+      if (prev_paths) {
+	int arrival_count = tag_groups_[new_index]->arrivalCount();
+	for (int i = 0; i < arrival_count; i++)
+	  remapPath(prev_paths[i]);
+      }
+    }
+  }
+  ClkInfoSet::Iterator clk_info_iter2(clk_info_set_);
+  while (clk_info_iter2.hasNext()) {
+    ClkInfo *clk_info = clk_info_iter2.next();
+    remapPath(clk_info->crprClkPath());
+  }
+  GenclkSrcPathMap::Iterator src_path_iter2(genclks_->srcPaths());
+  while (src_path_iter2.hasNext()) {
+    PathVertexRep *src_paths = src_path_iter2.next();
+    for (int i = 0; i < src_path_count; i++)
+      remapPath(src_paths[i]);
+  }
+
+  tag_group_compact_count_ = tag_group_set_->size();
+  debugPrint3(debug_, "search", 1,
+	      "compact tags deleted %u tag groups %d tags %zu clk infos\n",
+	      group_delete_count,
+	      tag_delete_count,
+	      clk_info_delete_count);
+  stats.report("Compact tags");
+}
+
 void
 Search::findFilteredArrivals()
 {
@@ -585,13 +1127,18 @@ Search::findFilteredArrivals()
   // fanin startpoints to reach -thru/-to endpoints.
   arrival_visitor_->init(true);
   // Iterate until data arrivals at all latches stop changing.
-  for (int pass = 1; pass <= 2 || havePendingLatchOutputs() ; pass++) {
+  int pass = 1;
+  for (; pass <= 2 || havePendingLatchOutputs() ; pass++) {
+    debugPrint2(debug_, "search", 1, "find arrivals pass %d latches %lu\n",
+		pass,
+		pending_latch_outputs_.size());
     enqueuePendingLatchOutputs();
-    debugPrint1(debug_, "search", 1, "find arrivals pass %d\n", pass);
     int arrival_count = arrival_iter_->visitParallel(max_level,
 						     arrival_visitor_);
     debugPrint1(debug_, "search", 1, "found %d arrivals\n", arrival_count);
   }
+  debugPrint1(debug_, "latch", 1, "latch arrivals converged in %d passes\n",
+	      pass - 1);
   arrivals_exist_ = true;
 }
 
@@ -657,25 +1204,89 @@ Search::seedFilterStarts()
 void
 Search::deleteVertexBefore(Vertex *vertex)
 {
+  // Path ends may reference the vertex.
+  pathEndsInvalid();
+  reg_clk_index_->invalid();
   if (arrivals_exist_) {
     deletePaths(vertex);
     arrival_iter_->deleteVertexBefore(vertex);
-    invalid_arrivals_.erase(vertex);
+    invalid_arrivals_.erase(vertex, graph_);
   }
   if (requireds_exist_) {
     required_iter_->deleteVertexBefore(vertex);
-    invalid_requireds_.erase(vertex);
-    invalid_tns_.erase(vertex);
+    invalid_requireds_.erase(vertex, graph_);
+    invalid_tns_.erase(vertex, graph_);
+  }
+  requiredConesInvalid();
+  if (endpoints_
+      && endpointsHasKey(vertex))
+    eraseEndpoint(vertex);
+  invalid_endpoints_.erase(vertex, graph_);
+  aocv_depths_->deleteVertexBefore(vertex);
+  if (timing_scope_exists_) {
+    timing_scope_.erase(vertex, graph_);
+    timing_scope_ends_.erase(vertex, graph_);
   }
-  if (endpoints_)
-    endpoints_->erase(vertex);
-  if (invalid_endpoints_)
-    invalid_endpoints_->erase(vertex);
+}
+
+////////////////////////////////////////////////////////////////
+
+// The fanin cone includes the clock network of the registers in the
+// cone thru the check and clock to q edges.
+void
+Search::setTimingScope(const VertexSeq &ends)
+{
+  clearTimingScope();
+  VertexSeq queue;
+  for (Vertex *end : ends) {
+    timing_scope_ends_.insert(end, graph_);
+    if (timing_scope_.insert(end, graph_))
+      queue.push_back(end);
+  }
+  while (!queue.empty()) {
+    Vertex *to_vertex = queue.back();
+    queue.pop_back();
+    VertexInEdgeIterator edge_iter(to_vertex, graph_);
+    while (edge_iter.hasNext()) {
+      Edge *edge = edge_iter.next();
+      Vertex *from_vertex = edge->from(graph_);
+      if (timing_scope_.insert(from_vertex, graph_))
+	queue.push_back(from_vertex);
+    }
+  }
+  timing_scope_exists_ = true;
+  debugPrint2(debug_, "search", 1, "timing scope %lu ends %lu vertices\n",
+	      timing_scope_ends_.size(),
+	      timing_scope_.size());
+}
+
+void
+Search::clearTimingScope()
+{
+  timing_scope_exists_ = false;
+  timing_scope_.clear();
+  timing_scope_ends_.clear();
+}
+
+bool
+Search::inTimingScope(const Vertex *vertex) const
+{
+  return !timing_scope_exists_
+    || timing_scope_.hasKey(vertex, graph_);
+}
+
+bool
+Search::isTimingScopeEnd(const Vertex *vertex) const
+{
+  return !timing_scope_exists_
+    || timing_scope_ends_.hasKey(vertex, graph_);
 }
 
 void
 Search::arrivalsInvalid()
 {
+  pathEndsInvalid();
+  reg_clk_index_->invalid();
   if (arrivals_exist_) {
     debugPrint0(debug_, "search", 1, "arrivals invalid\n");
     // Delete paths to make sure no state is left over.
@@ -689,6 +1300,7 @@ Search::arrivalsInvalid()
     arrivals_seeded_ = false;
     requireds_exist_ = false;
     requireds_seeded_ = false;
+    required_cone_vertices_.clear();
     clk_arrivals_valid_ = false;
     arrival_iter_->clear();
     required_iter_->clear();
@@ -705,8 +1317,10 @@ void
 Search::requiredsInvalid()
 {
   debugPrint0(debug_, "search", 1, "requireds invalid\n");
+  pathEndsInvalid();
   requireds_exist_ = false;
   requireds_seeded_ = false;
+  required_cone_vertices_.clear();
   invalid_requireds_.clear();
   tns_exists_ = false;
   clearWorstSlack();
@@ -716,14 +1330,14 @@ Search::requiredsInvalid()
 void
 Search::arrivalInvalid(Vertex *vertex)
 {
+  reg_clk_index_->invalid();
+  aocv_depths_->faninInvalid(vertex);
   if (arrivals_exist_) {
     debugPrint1(debug_, "search", 2, "arrival invalid %s\n",
 		vertex->name(sdc_network_));
-    if (!arrival_iter_->inQueue(vertex)) {
-      // Lock for StaDelayCalcObserver called by delay calc threads.
-      UniqueLock lock(invalid_arrivals_lock_);
-      invalid_arrivals_.insert(vertex);
-    }
+    // StaDelayCalcObserver calls this from delay calc threads.
+    if (!arrival_iter_->inQueue(vertex))
+      invalid_arrivals_.insert(vertex, graph_);
     tnsInvalid(vertex);
   }
 }
@@ -738,6 +1352,8 @@ Search::arrivalInvalidDelete(Vertex *vertex)
 void
 Search::levelChangedBefore(Vertex *vertex)
 {
+  aocv_depths_->faninInvalid(vertex);
+  aocv_depths_->fanoutInvalid(vertex);
   if (arrivals_exist_) {
     arrival_iter_->remove(vertex);
     required_iter_->remove(vertex);
@@ -746,6 +1362,12 @@ Search::levelChangedBefore(Vertex *vertex)
   }
 }
 
+void
+Search::levelsInvalid()
+{
+  aocv_depths_->depthsInvalid();
+}
+
 void
 Search::arrivalInvalid(const Pin *pin)
 {
@@ -786,14 +1408,14 @@ Search::requiredInvalid(const Pin *pin)
 void
 Search::requiredInvalid(Vertex *vertex)
 {
+  pathEndInvalid(vertex);
+  aocv_depths_->fanoutInvalid(vertex);
   if (requireds_exist_) {
     debugPrint1(debug_, "search", 2, "required invalid %s\n",
 		vertex->name(sdc_network_));
-    if (!required_iter_->inQueue(vertex)) {
-      // Lock for StaDelayCalcObserver called by delay calc threads.
-      UniqueLock lock(invalid_arrivals_lock_);
-      invalid_requireds_.insert(vertex);
-    }
+    // StaDelayCalcObserver calls this from delay calc threads.
+    if (!required_iter_->inQueue(vertex))
+      invalid_requireds_.insert(vertex, graph_);
     tnsInvalid(vertex);
   }
 }
@@ -805,14 +1427,16 @@ Search::findClkArrivals()
 {
   if (!clk_arrivals_valid_) {
     genclks_->ensureInsertionDelays();
-    Stats stats(debug_);
+    Stats stats(debug_, phase_stats_);
     debugPrint0(debug_, "search", 1, "find clk arrivals\n");
     arrival_iter_->clear();
     seedClkVertexArrivals();
     ClkArrivalSearchPred search_clk(this);
     arrival_visitor_->init(false, &search_clk);
-    arrival_iter_->visitParallel(levelize_->maxLevel(), arrival_visitor_);
+    int arrival_count = arrival_iter_->visitParallel(levelize_->maxLevel(),
+						     arrival_visitor_);
     arrivals_exist_ = true;
+    stats.setVisitCount(arrival_count);
     stats.report("Find clk arrivals");
   }
   clk_arrivals_valid_ = true;
@@ -917,7 +1541,9 @@ Search::visitStartpoints(VertexVisitor *visitor)
 void
 Search::visitEndpoints(VertexVisitor *visitor)
 {
-  for (auto end : *endpoints()) {
+  // Copy the endpoints in case the visitor changes them.
+  VertexSeq ends(*endpoints());
+  for (auto end : ends) {
     Pin *pin = end->pin();
     // Filter register clock pins (fails on set_max_delay -from clk_src).
     if (!network_->isRegClkPin(pin)
@@ -939,11 +1565,22 @@ void
 Search::findAllArrivals(VertexVisitor *arrival_visitor)
 {
   // Iterate until data arrivals at all latches stop changing.
-  for (int pass = 1; pass == 1 || havePendingLatchOutputs(); pass++) {
+  int pass = 1;
+  for (; pass == 1 || havePendingLatchOutputs(); pass++) {
+    debugPrint2(debug_, "search", 1, "find arrivals pass %d latches %lu\n",
+		pass,
+		pending_latch_outputs_.size());
     enqueuePendingLatchOutputs();
-    debugPrint1(debug_, "search", 1, "find arrivals pass %d\n", pass);
+    if (pass == 1
+	&& clk_domain_partitions_
+	&& !arrivals_seeded_) {
+      findArrivals1();
+      findClkDomainArrivals(arrival_visitor);
+    }
     findArrivals(levelize_->maxLevel(), arrival_visitor);
   }
+  debugPrint1(debug_, "latch", 1, "latch arrivals converged in %d passes\n",
+	      pass - 1);
 }
 
 bool
@@ -961,7 +1598,9 @@ Search::clearPendingLatchOutputs()
 void
 Search::enqueuePendingLatchOutputs()
 {
-  for (auto latch_vertex : pending_latch_outputs_)
+  VertexSeq latch_vertices;
+  pending_latch_outputs_.vertices(graph_, latch_vertices);
+  for (auto latch_vertex : latch_vertices)
     arrival_iter_->enqueue(latch_vertex);
   clearPendingLatchOutputs();
 }
@@ -985,8 +1624,9 @@ Search::findArrivals(Level level,
 {
   debugPrint1(debug_, "search", 1, "find arrivals to level %d\n", level);
   findArrivals1();
-  Stats stats(debug_);
+  Stats stats(debug_, phase_stats_);
   int arrival_count = arrival_iter_->visitParallel(level, arrival_visitor);
+  stats.setVisitCount(arrival_count);
   stats.report("Find arrivals");
   if (arrival_iter_->empty()
       && invalid_arrivals_.empty()) {
@@ -1000,6 +1640,9 @@ Search::findArrivals(Level level,
 void
 Search::findArrivals1()
 {
+  graph_->ensureCsr();
+  if (aocv_enabled_ && sdc_->hasAocvDerates())
+    aocv_depths_->ensureDepths();
   if (!arrivals_seeded_) {
     genclks_->ensureInsertionDelays();
     arrival_iter_->clear();
@@ -1014,6 +1657,182 @@ Search::findArrivals1()
   seedInvalidArrivals();
 }
 
+// Clock domain labels used by findClkDomainArrivals.
+static const int clk_domain_none = 0;
+// In the fanout of more than one clock domain.
+static const int clk_domain_shared = 1;
+static const int clk_domain_unclked = 2;
+// The domain of clk is clk->index() + clk_domain_clk_begin.
+static const int clk_domain_clk_begin = 3;
+
+static int
+meetClkDomains(int domain1,
+	       int domain2)
+{
+  if (domain1 == clk_domain_none)
+    return domain2;
+  else if (domain2 == clk_domain_none
+	   || domain1 == domain2)
+    return domain1;
+  else
+    return clk_domain_shared;
+}
+
+static int
+tagGroupClkDomain(const TagGroup *tag_group)
+{
+  int domain = clk_domain_none;
+  for (int i = 0; i < tag_group->arrivalCount(); i++) {
+    const Clock *clk = tag_group->arrivalTag(i)->clock();
+    int tag_domain = clk
+      ? clk->index() + clk_domain_clk_begin
+      : clk_domain_unclked;
+    domain = meetClkDomains(domain, tag_domain);
+  }
+  return domain;
+}
+
+// Find the arrivals in the fanout of the seeded vertices that is only
+// in the fanout of one clock domain. Each domain is searched by one
+// thread in level order with no level barriers. The fanin of a vertex
+// in a domain partition is either seeded or in the same partition, so
+// the arrivals are the same as the level by level search.
+// Vertices in the fanout of more than one domain are left to the
+// arrival iterator.
+void
+Search::findClkDomainArrivals(VertexVisitor *arrival_visitor)
+{
+  if (thread_pool_ == nullptr || thread_pool_->threadCount() <= 1)
+    return;
+  Stats stats(debug_, phase_stats_);
+  VertexIndex index_max = 0;
+  VertexIterator vertex_iter(graph_);
+  while (vertex_iter.hasNext())
+    index_max = max(index_max, graph_->index(vertex_iter.next()));
+  std::vector<bool> in_cone(index_max + 1, false);
+  // Take the seeded fanout out of the arrival queue and find everything
+  // the search can reach from it.
+  VertexSeq queued;
+  while (arrival_iter_->hasNext()) {
+    Vertex *vertex = arrival_iter_->next();
+    in_cone[graph_->index(vertex)] = true;
+    queued.push_back(vertex);
+  }
+  VertexSeq cone = queued;
+  for (size_t i = 0; i < cone.size(); i++) {
+    Vertex *vertex = cone[i];
+    if (eval_pred_->searchFrom(vertex)) {
+      VertexOutEdgeIterator edge_iter(vertex, graph_);
+      while (edge_iter.hasNext()) {
+	Edge *edge = edge_iter.next();
+	Vertex *to_vertex = edge->to(graph_);
+	VertexIndex to_index = graph_->index(to_vertex);
+	if (!in_cone[to_index]
+	    && eval_pred_->searchThru(edge)
+	    && eval_pred_->searchTo(to_vertex)) {
+	  in_cone[to_index] = true;
+	  cone.push_back(to_vertex);
+	}
+      }
+    }
+  }
+  sort(cone, [] (const Vertex *vertex1,
+		 const Vertex *vertex2) {
+	       return vertex1->level() < vertex2->level();
+	     });
+
+  // Label the cone vertices with the domain of their fanin.
+  std::vector<int> domains(index_max + 1, clk_domain_none);
+  int clk_index_max = 0;
+  for (auto clk : sdc_->clks())
+    clk_index_max = max(clk_index_max, clk->index());
+  std::vector<VertexSeq> partitions(clk_index_max + clk_domain_clk_begin + 1);
+  for (auto vertex : cone) {
+    int domain = clk_domain_none;
+    VertexInEdgeIterator edge_iter(vertex, graph_);
+    while (edge_iter.hasNext()
+	   && domain != clk_domain_shared) {
+      Edge *edge = edge_iter.next();
+      Vertex *from_vertex = edge->from(graph_);
+      if (eval_pred_->searchFrom(from_vertex)
+	  && eval_pred_->searchThru(edge)) {
+	VertexIndex from_index = graph_->index(from_vertex);
+	if (in_cone[from_index]) {
+	  // Loop edges into the vertex are searched dynamically so the
+	  // vertex cannot be visited before them.
+	  if (from_vertex->level() < vertex->level())
+	    domain = meetClkDomains(domain, domains[from_index]);
+	  else
+	    domain = clk_domain_shared;
+	}
+	else {
+	  TagGroup *tag_group = tagGroup(from_vertex);
+	  if (tag_group)
+	    domain = meetClkDomains(domain, tagGroupClkDomain(tag_group));
+	}
+      }
+    }
+    // Paths that start at the vertex itself.
+    if (domain == clk_domain_none)
+      domain = clk_domain_unclked;
+    domains[graph_->index(vertex)] = domain;
+    if (domain != clk_domain_shared)
+      partitions[domain].push_back(vertex);
+  }
+
+  Vector<VertexSeq*> domain_partitions;
+  for (auto &partition : partitions) {
+    if (!partition.empty())
+      domain_partitions.push_back(&partition);
+  }
+  int visit_count = 0;
+  if (domain_partitions.size() > 1) {
+    // The partition vertices are visited in level order so they are
+    // marked in the queue to keep the search from enqueuing them.
+    for (auto partition : domain_partitions) {
+      for (auto vertex : *partition)
+	vertex->setBfsInQueue(BfsIndex::arrival, true);
+    }
+    for (auto vertex : queued) {
+      if (domains[graph_->index(vertex)] == clk_domain_shared)
+	arrival_iter_->enqueue(vertex);
+    }
+    // Biggest partitions first to balance the threads.
+    sort(domain_partitions, [] (const VertexSeq *partition1,
+				const VertexSeq *partition2) {
+			      return partition1->size() > partition2->size();
+			    });
+    int thread_count = thread_pool_->threadCount();
+    VertexVisitorSeq visitors(thread_count);
+    for (int i = 0; i < thread_count; i++)
+      visitors[i] = arrival_visitor->copy();
+    std::atomic<int> count(0);
+    forEachChunk(domain_partitions.size(), thread_pool_,
+		 [&] (size_t begin, size_t end, int thread_index) {
+		   VertexVisitor *thread_visitor = visitors[thread_index];
+		   for (size_t i = begin; i < end; i++) {
+		     VertexSeq *partition = domain_partitions[i];
+		     for (auto vertex : *partition) {
+		       vertex->setBfsInQueue(BfsIndex::arrival, false);
+		       thread_visitor->visit(vertex);
+		     }
+		     count += partition->size();
+		   }
+		 });
+    visitors.deleteContents();
+    visit_count = count;
+  }
+  else {
+    for (auto vertex : queued)
+      arrival_iter_->enqueue(vertex);
+  }
+  debugPrint2(debug_, "search", 1, "found %d arrivals in %zu clock domains\n",
+	      visit_count,
+	      domain_partitions.size());
+  stats.setVisitCount(visit_count);
+  stats.report("Find clock domain arrivals");
+}
+
 ////////////////////////////////////////////////////////////////
 
 ArrivalVisitor::ArrivalVisitor(const StaState *sta) :
@@ -1039,6 +1858,7 @@ ArrivalVisitor::init0()
   tag_bldr_ = new TagGroupBldr(true, sta_);
   tag_bldr_no_crpr_ = new TagGroupBldr(false, sta_);
   adj_pred_ = new SearchThru(tag_bldr_, sta_);
+  debug_search_ = sta_->debug()->handle("search");
 }
 
 void
@@ -1055,6 +1875,10 @@ ArrivalVisitor::init(bool always_to_endpoints,
   always_to_endpoints_ = always_to_endpoints;
   pred_ = pred;
   crpr_active_ = sta_->sdc()->crprActive();
+  Search *search = sta_->search();
+  statistical_max_ = search
+    && search->statisticalMax()
+    && sta_->pocvEnabled();
 }
 
 
@@ -1086,13 +1910,15 @@ ArrivalVisitor::visit(Vertex *vertex)
   const Graph *graph = sta_->graph();
   const Sdc *sdc = sta_->sdc();
   Search *search = sta_->search();
-  debugPrint1(debug, "search", 2, "find arrivals %s\n",
+  debugPrint1(debug, debug_search_, 2, "find arrivals %s\n",
 	      vertex->name(sdc_network));
   Pin *pin = vertex->pin();
+  bool is_clk_src = sdc->isVertexPinClock(pin);
+  bool is_internal_endpoint = sdc->isPathDelayInternalEndpoint(pin);
   // Don't clobber clock sources.
-  if (!sdc->isVertexPinClock(pin)
+  if (!is_clk_src
       // Unless it is an internal path delay endpoint.
-      || sdc->isPathDelayInternalEndpoint(pin)) {
+      || is_internal_endpoint) {
     tag_bldr_->init(vertex);
     has_fanin_one_ = graph->hasFaninOne(vertex);
     if (crpr_active_
@@ -1114,8 +1940,8 @@ ArrivalVisitor::visit(Vertex *vertex)
     if (sdc->isPathDelayInternalStartpoint(pin))
       // set_min/max_delay on internal pin.
       search->makeUnclkedPaths(vertex, true, tag_bldr_);
-    if (sdc->isPathDelayInternalEndpoint(pin)
-	&& sdc->isVertexPinClock(pin))
+    if (is_internal_endpoint
+	&& is_clk_src)
       // set_min/max_delay on internal pin also a clock src. Bizzaroland.
       // Re-seed the clock arrivals on top of the propagated paths.
       search->seedClkArrivals(pin, vertex, tag_bldr_);
@@ -1126,12 +1952,14 @@ ArrivalVisitor::visit(Vertex *vertex)
     // For example, "set_max_delay -to" from an unclocked source register.
     bool is_clk = tag_bldr_->hasClkTag();
     if (vertex->isRegClk() && !is_clk) {
-      debugPrint1(debug, "search", 2, "arrival seed unclked reg clk %s\n",
+      debugPrint1(debug, debug_search_, 2, "arrival seed unclked reg clk %s\n",
 		  network->pathName(pin));
       search->makeUnclkedPaths(vertex, true, tag_bldr_);
     }
 
-    bool arrivals_changed = search->arrivalsChanged(vertex, tag_bldr_);
+    bool arrivals_differ;
+    bool arrivals_changed = search->arrivalsChanged(vertex, tag_bldr_,
+						    arrivals_differ);
     // If vertex is a latch data input arrival that changed from the
     // previous eval pass enqueue the latch outputs to be re-evaled on the
     // next pass.
@@ -1144,15 +1972,17 @@ ArrivalVisitor::visit(Vertex *vertex)
 	 || always_to_endpoints_
 	 || arrivals_changed)
 	&& (network->isRegClkPin(pin)
-	    || !sdc->isPathDelayInternalEndpoint(pin)))
+	    || !is_internal_endpoint))
       search->arrivalIterator()->enqueueAdjacentVertices(vertex, adj_pred_);
-    if (arrivals_changed) {
-      debugPrint0(debug, "search", 4, "arrival changed\n");
+    if (arrivals_differ) {
+      debugPrint0(debug, debug_search_, 4, "arrival changed\n");
       // Only update arrivals when delays change by more than
       // fuzzyEqual can distinguish.
       search->setVertexArrivals(vertex, tag_bldr_);
       search->tnsInvalid(vertex);
-      constrainedRequiredsInvalid(vertex, is_clk);
+      // Changes within the incremental tolerance are not propagated.
+      if (arrivals_changed)
+	constrainedRequiredsInvalid(vertex, is_clk);
     }
     enqueueRefPinInputDelays(pin);
   }
@@ -1202,13 +2032,17 @@ ArrivalVisitor::constrainedRequiredsInvalid(Vertex *vertex,
 
 bool
 Search::arrivalsChanged(Vertex *vertex,
-			TagGroupBldr *tag_bldr)
+			TagGroupBldr *tag_bldr,
+			// Return value.
+			bool &arrivals_differ)
 {
+  arrivals_differ = true;
   Arrival *arrivals1 = vertex->arrivals();
   if (arrivals1) {
     TagGroup *tag_group = tagGroup(vertex);
     if (tag_group->arrivalMap()->size() != tag_bldr->arrivalMap()->size())
       return true;
+    bool differ = false;
     ArrivalMap::Iterator arrival_iter1(tag_group->arrivalMap());
     while (arrival_iter1.hasNext()) {
       Tag *tag1;
@@ -1219,9 +2053,12 @@ Search::arrivalsChanged(Vertex *vertex,
       bool arrival_exists2;
       tag_bldr->tagArrival(tag1, arrival2, arrival_exists2);
       if (!arrival_exists2
-	  || !fuzzyEqual(arrival1, arrival2))
+	  || exceedsIncrementalTolerance(arrival1, arrival2))
 	return true;
+      if (!fuzzyEqual(arrival1, arrival2))
+	differ = true;
     }
+    arrivals_differ = differ;
     return false;
   }
   else
@@ -1235,7 +2072,7 @@ ArrivalVisitor::visitFromToPath(const Pin *,
 				Tag *from_tag,
 				PathVertex *from_path,
 				Edge *,
-				TimingArc *,
+				TimingArc *arc,
 				ArcDelay arc_delay,
 				Vertex *,
 				const TransRiseFall *to_tr,
@@ -1246,15 +2083,15 @@ ArrivalVisitor::visitFromToPath(const Pin *,
 {
   const Debug *debug = sta_->debug();
   const Network *sdc_network = sta_->sdcNetwork();
-  debugPrint1(debug, "search", 3, " %s\n",
+  debugPrint1(debug, debug_search_, 3, " %s\n",
 	      from_vertex->name(sdc_network));
-  debugPrint3(debug, "search", 3, "  %s -> %s %s\n",
+  debugPrint3(debug, debug_search_, 3, "  %s -> %s %s\n",
 	      from_tr->asString(),
 	      to_tr->asString(),
 	      min_max->asString());
-  debugPrint1(debug, "search", 3, "  from tag: %s\n",
+  debugPrint1(debug, debug_search_, 3, "  from tag: %s\n",
 	      from_tag->asString(sta_));
-  debugPrint1(debug, "search", 3, "  to tag  : %s\n",
+  debugPrint1(debug, debug_search_, 3, "  to tag  : %s\n",
 	      to_tag->asString(sta_));
   ClkInfo *to_clk_info = to_tag->clkInfo();
   bool to_is_clk = to_tag->isClock();
@@ -1262,19 +2099,33 @@ ArrivalVisitor::visitFromToPath(const Pin *,
   int arrival_index;
   Tag *tag_match;
   tag_bldr_->tagMatchArrival(to_tag, tag_match, arrival, arrival_index);
-  if (tag_match == nullptr
-      || fuzzyGreater(to_arrival, arrival, min_max)) {
-    debugPrint5(debug, "search", 3, "   %s + %s = %s %s %s\n",
+  if (statistical_max_
+      && tag_match
+      && !to_is_clk
+      && !fuzzyGreater(to_arrival, arrival, min_max)) {
+    // The existing path stays the prev path of the merged arrival.
+    Arrival merged = delayStatisticalMax(arrival, to_arrival, min_max);
+    tag_bldr_->replaceArrival(arrival_index, merged);
+  }
+  else if (tag_match == nullptr
+	   || fuzzyGreater(to_arrival, arrival, min_max)) {
+    debugPrint5(debug, debug_search_, 3, "   %s + %s = %s %s %s\n",
 		delayAsString(from_path->arrival(sta_), sta_),
 		delayAsString(arc_delay, sta_),
 		delayAsString(to_arrival, sta_),
 		min_max == MinMax::max() ? ">" : "<",
 		tag_match ? delayAsString(arrival, sta_) : "MIA");
     PathVertexRep prev_path;
-    if (to_tag->isClock() || to_tag->isGenClkSrcPath())
+    if ((to_tag->isClock() || to_tag->isGenClkSrcPath())
+	&& sta_->search()->prevPathStorage()) {
       prev_path.init(from_path, sta_);
+      prev_path.setPrevArc(arc);
+    }
+    Arrival merged = (statistical_max_ && tag_match && !to_is_clk)
+      ? delayStatisticalMax(to_arrival, arrival, min_max)
+      : to_arrival;
     tag_bldr_->setMatchArrival(to_tag, tag_match,
-			       to_arrival, arrival_index,
+			       merged, arrival_index,
 			       &prev_path);
     if (crpr_active_
 	&& !has_fanin_one_
@@ -1319,14 +2170,14 @@ ArrivalVisitor::pruneCrprArrivals()
 	Arrival max_arrival_max_crpr = (min_max == MinMax::max())
 	  ? max_arrival - max_crpr
 	  : max_arrival + max_crpr;
-	debugPrint4(debug, "search", 4, "  cmp %s %s - %s = %s\n",
+	debugPrint4(debug, debug_search_, 4, "  cmp %s %s - %s = %s\n",
 		    tag->asString(sta_),
 		    delayAsString(max_arrival, sta_),
 		    delayAsString(max_crpr, sta_),
 		    delayAsString(max_arrival_max_crpr, sta_));
 	Arrival arrival = tag_bldr_->arrival(arrival_index);
 	if (fuzzyGreater(max_arrival_max_crpr, arrival, min_max)) {
-	  debugPrint1(debug, "search", 3, "  pruned %s\n",
+	  debugPrint1(debug, debug_search_, 3, "  pruned %s\n",
 		      tag->asString(sta_));
 	  tag_bldr_->deleteArrival(tag);
 	}
@@ -1372,16 +2223,28 @@ ArrivalVisitor::seedInputDelayArrival(const Pin *pin,
 						     search->searchAdj());
 }
 
+// A latch output at a higher level than the data input is visited
+// later in the same pass, so it is enqueued now. Only latch outputs
+// that close a loop back to a lower level wait for another pass.
 void
 Search::enqueueLatchDataOutputs(Vertex *vertex)
 {
   VertexOutEdgeIterator out_edge_iter(vertex, graph_);
   while (out_edge_iter.hasNext()) {
     Edge *out_edge = out_edge_iter.next();
-    if (latches_->isLatchDtoQ(out_edge)) {
-      Vertex *out_vertex = out_edge->to(graph_);
-      UniqueLock lock(pending_latch_outputs_lock_);
-      pending_latch_outputs_.insert(out_vertex);
+    Vertex *out_vertex = out_edge->to(graph_);
+    if (latches_->isLatchDtoQ(out_edge)
+	&& inTimingScope(out_vertex)) {
+      if (out_vertex->level() > vertex->level()) {
+	debugPrint1(debug_, "latch", 2, "enqueue latch output %s\n",
+		    out_vertex->name(sdc_network_));
+	arrival_iter_->enqueue(out_vertex);
+      }
+      else {
+	debugPrint1(debug_, "latch", 2, "pending latch output %s\n",
+		    out_vertex->name(sdc_network_));
+	pending_latch_outputs_.insert(out_vertex, graph_);
+      }
     }
   }
 }
@@ -1394,8 +2257,10 @@ Search::seedArrivals()
   findRootVertices(vertices);
   findInputDrvrVertices(vertices);
 
-  for (auto vertex : vertices)
-    seedArrival(vertex);
+  for (auto vertex : vertices) {
+    if (inTimingScope(vertex))
+      seedArrival(vertex);
+  }
 }
 
 void
@@ -1417,8 +2282,12 @@ Search::findClockVertices(VertexSet &vertices)
 void
 Search::seedInvalidArrivals()
 {
-  for (auto vertex : invalid_arrivals_)
-    seedArrival(vertex);
+  VertexSeq vertices;
+  invalid_arrivals_.vertices(graph_, vertices);
+  for (auto vertex : vertices) {
+    if (inTimingScope(vertex))
+      seedArrival(vertex);
+  }
   invalid_arrivals_.clear();
 }
 
@@ -2576,6 +3445,8 @@ Search::mutateTag(Tag *from_tag,
   ExceptionStateSet *new_states = nullptr;
   ExceptionStateSet *from_states = from_tag->states();
   if (from_states) {
+    // Most pins are not on any -thru so no state can advance at them.
+    bool thru_pin = sdc_->isExceptionThruPin(to_pin);
     // Check for state changes in from_tag (but postpone copying state set).
     bool state_change = false;
     for (auto state : *from_states) {
@@ -2586,7 +3457,8 @@ Search::mutateTag(Tag *from_tag,
 	// Don't propagate a completed false path -thru unless it is a
 	// clock (which ignores exceptions).
 	return nullptr;
-      if (state->matchesNextThru(from_pin,to_pin,to_tr,min_max,network_)) {
+      if (thru_pin
+	  && state->matchesNextThru(from_pin,to_pin,to_tr,min_max,network_)) {
 	// Found a -thru that we've been waiting for.
 	if (state->nextState()->isComplete()
 	    && exception->isLoop())
@@ -2620,7 +3492,8 @@ Search::mutateTag(Tag *from_tag,
 	  return nullptr;
 	}
 	// One edge may traverse multiple hierarchical thru pins.
-	while (state->matchesNextThru(from_pin,to_pin,to_tr,min_max,network_))
+	while (thru_pin
+	       && state->matchesNextThru(from_pin,to_pin,to_tr,min_max,network_))
 	  // Found a -thru that we've been waiting for.
 	  state = state->nextState();
 
@@ -2667,43 +3540,38 @@ Search::findTagGroup(TagGroupBldr *tag_bldr)
   TagGroup probe(tag_bldr);
   TagGroup *tag_group = tag_group_set_->findKey(&probe);
   if (tag_group == nullptr) {
-    // Recheck with lock.
-    UniqueLock lock(tag_group_lock_);
+    // Recheck with the lock for the probe's shard of the set.
+    UniqueLock lock(tag_group_set_->lock(&probe));
     tag_group = tag_group_set_->findKey(&probe);
     if (tag_group == nullptr) {
-      TagGroupIndex tag_group_index;
-      if (tag_group_free_indices_.empty())
-	tag_group_index = tag_group_next_++;
-      else {
-	tag_group_index = tag_group_free_indices_.back();
-	tag_group_free_indices_.pop_back();
-      }
+      TagGroupIndex tag_group_index = makeTagGroupIndex();
       tag_group = tag_bldr->makeTagGroup(tag_group_index, this);
-      tag_groups_[tag_group_index] = tag_group;
+      // Make sure the tag group can be indexed in tag_groups_ before
+      // it is visible to other threads via tag_group_set_.
+      tag_groups_.set(tag_group_index, tag_group);
       tag_group_set_->insert(tag_group);
-      // If tag_groups_ needs to grow make the new array and copy the
-      // contents into it before updating tags_groups_ so that other threads
-      // can use Search::tagGroup(TagGroupIndex) without returning gubbish.
-      // std::vector doesn't seem to follow this protocol so multi-thread
-      // search fails occasionally if a vector is used for tag_groups_.
-      if (tag_group_next_ == tag_group_capacity_) {
-	TagGroupIndex new_capacity = nextMersenne(tag_group_capacity_);
-	TagGroup **new_tag_groups = new TagGroup*[new_capacity];
-	memcpy(new_tag_groups, tag_groups_,
-	       tag_group_capacity_ * sizeof(TagGroup*));
-	TagGroup **old_tag_groups = tag_groups_;
-	tag_groups_ = new_tag_groups;
-	tag_group_capacity_ = new_capacity;
-	delete [] old_tag_groups;
-	tag_group_set_->resize(new_capacity);
-      }
-      if (tag_group_next_ > tag_group_index_max)
-	internalError("max tag group index exceeded");
     }
   }
   return tag_group;
 }
 
+TagGroupIndex
+Search::makeTagGroupIndex()
+{
+  UniqueLock lock(tag_group_lock_);
+  TagGroupIndex tag_group_index;
+  if (tag_group_free_indices_.empty()) {
+    tag_group_index = tag_group_next_++;
+    if (tag_group_next_ > tag_group_index_max)
+      internalError("max tag group index exceeded");
+  }
+  else {
+    tag_group_index = tag_group_free_indices_.back();
+    tag_group_free_indices_.pop_back();
+  }
+  return tag_group_index;
+}
+
 void
 Search::setVertexArrivals(Vertex *vertex,
 			  TagGroupBldr *tag_bldr)
@@ -2711,9 +3579,19 @@ Search::setVertexArrivals(Vertex *vertex,
   if (tag_bldr->empty())
     deletePaths(vertex);
   else {
+    if (arrival_journal_active_)
+      journalArrivals(vertex);
+    pathEndInvalid(vertex);
     TagGroup *prev_tag_group = tagGroup(vertex);
     Arrival *prev_arrivals = vertex->arrivals();
     PathVertexRep *prev_paths = vertex->prevPaths();
+    if (prev_paths
+	|| tag_bldr->hasClkTag()
+	|| tag_bldr->hasGenClkSrcTag()) {
+      check_crpr_->clkArrivalsChanged();
+      // Path ends reference clock paths.
+      pathEndsInvalid();
+    }
 
     TagGroup *tag_group = findTagGroup(tag_bldr);
     int arrival_count = tag_group->arrivalCount();
@@ -2724,13 +3602,14 @@ Search::setVertexArrivals(Vertex *vertex,
 	&& (!has_requireds
 	    // Requireds can only be reused if the tag group is unchanged.
 	    || tag_group == prev_tag_group)) {
-      if  (tag_bldr->hasClkTag() || tag_bldr->hasGenClkSrcTag()) {
+      if  (prev_path_storage_
+	   && (tag_bldr->hasClkTag() || tag_bldr->hasGenClkSrcTag())) {
 	if (prev_paths == nullptr)
-	  prev_paths = new PathVertexRep[arrival_count];
+	  prev_paths = graph_->makePrevPaths(arrival_count);
       }
       else {
 	// Prev paths not required, delete stale ones.
-	delete [] prev_paths;
+	graph_->deletePrevPaths(prev_paths);
 	prev_paths = nullptr;
 	vertex->setPrevPaths(nullptr);
       }
@@ -2738,13 +3617,15 @@ Search::setVertexArrivals(Vertex *vertex,
       vertex->setTagGroupIndex(tag_group->index());
     }
     else {
-      delete [] prev_arrivals;
-      delete [] prev_paths;
-
-      Arrival *arrivals = new Arrival[arrival_count];
-      prev_paths = nullptr;
-      if  (tag_bldr->hasClkTag() || tag_bldr->hasGenClkSrcTag())
-	prev_paths = new PathVertexRep[arrival_count];
+      // Reuse the slab slots when the size class is unchanged.
+      Arrival *arrivals = graph_->resizeArrivals(prev_arrivals, arrival_count);
+      if  (prev_path_storage_
+	   && (tag_bldr->hasClkTag() || tag_bldr->hasGenClkSrcTag()))
+	prev_paths = graph_->resizePrevPaths(prev_paths, arrival_count);
+      else {
+	graph_->deletePrevPaths(prev_paths);
+	prev_paths = nullptr;
+      }
       tag_bldr->copyArrivals(tag_group, arrivals, prev_paths);
 
       vertex->setTagGroupIndex(tag_group->index());
@@ -2828,23 +3709,36 @@ Search::reportTagGroups() const
   for (TagGroupIndex i = 0; i < tag_group_next_; i++) {
     TagGroup *tag_group = tag_groups_[i];
     if (tag_group) {
-      report_->print("Group %4u hash = %4u (%4u)\n",
+      report_->print("Group %4u hash = %4u\n",
 		     i,
-		     tag_group->hash(),
-		     tag_group->hash() % tag_group_set_->capacity());
+		     tag_group->hash());
       tag_group->reportArrivalMap(this);
     }
   }
-  Hash long_hash = tag_group_set_->longestBucketHash();
-  report_->print("Longest hash bucket length %lu hash=%lu\n",
-		 tag_group_set_->bucketLength(long_hash),
-		 long_hash);
+  report_->print("Longest hash probe length %d\n",
+		 tag_group_set_->longestProbeLength());
 }
 
 void
 Search::reportArrivalCountHistogram() const
 {
-  Vector<int> vertex_counts(10);
+  Vector<int> vertex_counts;
+  arrivalCountHistogram(vertex_counts);
+  for (int arrival_count = 0;
+       arrival_count < static_cast<int>(vertex_counts.size());
+       arrival_count++) {
+    int vertex_count = vertex_counts[arrival_count];
+    if (vertex_count > 0)
+      report_->print("%6d %6d\n", arrival_count, vertex_count);
+  }
+}
+
+void
+Search::arrivalCountHistogram(// Return value.
+			      Vector<int> &vertex_counts) const
+{
+  vertex_counts.clear();
+  vertex_counts.resize(10);
   VertexIterator vertex_iter(graph_);
   while (vertex_iter.hasNext()) {
     Vertex *vertex = vertex_iter.next();
@@ -2856,14 +3750,205 @@ Search::reportArrivalCountHistogram() const
       vertex_counts[arrival_count]++;
     }
   }
+}
 
-  for (int arrival_count = 0;
-       arrival_count < static_cast<int>(vertex_counts.size());
-       arrival_count++) {
-    int vertex_count = vertex_counts[arrival_count];
-    if (vertex_count > 0)
-      report_->print("%6d %6d\n", arrival_count, vertex_count);
+// Reasons an arrival tag is distinct from the first tag with the same
+// transition and path analysis point at a vertex, in the order they
+// are checked.
+enum class TagGrowthFactor {
+  clk_edge,
+  clk,
+  crpr_clk_pin,
+  clk_info,
+  input_delay,
+  segment_start,
+  exception_state,
+  count
+};
+
+static const int tag_growth_factor_count =
+  static_cast<int>(TagGrowthFactor::count);
+
+static const char *tag_growth_factor_names[tag_growth_factor_count] = {
+  "clk_edge", "clk", "crpr_pin", "clk_info", "in_delay", "segment", "except"
+};
+
+static TagGrowthFactor
+tagGrowthFactor(const Tag *tag,
+		const Tag *base_tag,
+		const StaState *sta)
+{
+  ClkInfo *clk_info = tag->clkInfo();
+  ClkInfo *base_clk_info = base_tag->clkInfo();
+  if (tag->clkEdge() != base_tag->clkEdge())
+    return TagGrowthFactor::clk_edge;
+  else if (tag->isClock() != base_tag->isClock())
+    return TagGrowthFactor::clk;
+  else if (clk_info->crprClkPin(sta) != base_clk_info->crprClkPin(sta))
+    return TagGrowthFactor::crpr_clk_pin;
+  else if (clk_info != base_clk_info)
+    return TagGrowthFactor::clk_info;
+  else if (tag->inputDelay() != base_tag->inputDelay())
+    return TagGrowthFactor::input_delay;
+  else if (tag->isSegmentStart() != base_tag->isSegmentStart())
+    return TagGrowthFactor::segment_start;
+  else
+    return TagGrowthFactor::exception_state;
+}
+
+class TagGrowth
+{
+public:
+  Vertex *vertex_;
+  VertexIndex vertex_index_;
+  int tag_count_;
+  int fanin_tag_count_;
+  int factor_counts_[tag_growth_factor_count];
+};
+
+class TagGrowthGreater
+{
+public:
+  bool operator()(const TagGrowth &growth1,
+		  const TagGrowth &growth2) const
+  {
+    int diff1 = growth1.tag_count_ - growth1.fanin_tag_count_;
+    int diff2 = growth2.tag_count_ - growth2.fanin_tag_count_;
+    return diff1 > diff2
+      || (diff1 == diff2
+	  && growth1.vertex_index_ < growth2.vertex_index_);
   }
+};
+
+// Vertices whose arrival count grows the most over the largest fanin
+// arrival count are the roots of tag explosions. Each tag beyond the
+// first for a transition/path analysis point is attributed to the
+// first factor that differs from that tag.
+void
+Search::reportTagGrowth(int max_count) const
+{
+  int ap_tr_count = corners_->pathAnalysisPtCount()
+    * TransRiseFall::index_count;
+  std::vector<TagGrowth> growths;
+  int total_counts[tag_growth_factor_count] = {0};
+  std::vector<Tag*> base_tags(ap_tr_count);
+  VertexIterator vertex_iter(graph_);
+  while (vertex_iter.hasNext()) {
+    Vertex *vertex = vertex_iter.next();
+    TagGroup *tag_group = tagGroup(vertex);
+    if (tag_group) {
+      TagGrowth growth;
+      growth.vertex_ = vertex;
+      growth.vertex_index_ = graph_->index(vertex);
+      growth.tag_count_ = tag_group->arrivalCount();
+      growth.fanin_tag_count_ = 0;
+      VertexInEdgeIterator edge_iter(vertex, graph_);
+      while (edge_iter.hasNext()) {
+	Edge *edge = edge_iter.next();
+	if (!edge->role()->isTimingCheck()) {
+	  TagGroup *from_tag_group = tagGroup(edge->from(graph_));
+	  if (from_tag_group)
+	    growth.fanin_tag_count_ = std::max(growth.fanin_tag_count_,
+					       from_tag_group->arrivalCount());
+	}
+      }
+      std::fill(growth.factor_counts_,
+		growth.factor_counts_ + tag_growth_factor_count, 0);
+      std::fill(base_tags.begin(), base_tags.end(), nullptr);
+      for (int i = 0; i < growth.tag_count_; i++) {
+	Tag *tag = tag_group->arrivalTag(i);
+	int ap_tr = tag->pathAPIndex() * TransRiseFall::index_count
+	  + tag->trIndex();
+	Tag *base_tag = base_tags[ap_tr];
+	if (base_tag) {
+	  int factor = static_cast<int>(tagGrowthFactor(tag, base_tag, this));
+	  growth.factor_counts_[factor]++;
+	  total_counts[factor]++;
+	}
+	else
+	  base_tags[ap_tr] = tag;
+      }
+      if (growth.tag_count_ > growth.fanin_tag_count_)
+	growths.push_back(growth);
+    }
+  }
+  sort(growths.begin(), growths.end(), TagGrowthGreater());
+
+  report_->print("%-40s %5s %5s %6s", "Vertex", "Tags", "Fanin", "Growth");
+  for (int i = 0; i < tag_growth_factor_count; i++)
+    report_->print(" %8s", tag_growth_factor_names[i]);
+  report_->print("\n");
+  int count = 0;
+  for (auto &growth : growths) {
+    if (count++ == max_count)
+      break;
+    report_->print("%-40s %5d %5d %6d",
+		   growth.vertex_->name(sdc_network_),
+		   growth.tag_count_,
+		   growth.fanin_tag_count_,
+		   growth.tag_count_ - growth.fanin_tag_count_);
+    for (int i = 0; i < tag_growth_factor_count; i++)
+      report_->print(" %8d", growth.factor_counts_[i]);
+    report_->print("\n");
+  }
+  report_->print("%-40s %5zu %5s %6s", "Total tags", tag_set_->size(), "", "");
+  for (int i = 0; i < tag_growth_factor_count; i++)
+    report_->print(" %8d", total_counts[i]);
+  report_->print("\n");
+}
+
+void
+Search::reportMemory(MemoryReport &memory) const
+{
+  size_t tag_count = tag_set_->size();
+  memory.reportUsage("Search", "tags", tag_count,
+		     tag_count * sizeof(Tag)
+		     + tag_set_->capacity() * (sizeof(Tag*) + 1)
+		     + tags_.capacity() * sizeof(Tag*));
+  size_t tag_group_count = 0;
+  size_t tag_group_bytes = tag_groups_.capacity() * sizeof(TagGroup*)
+    + tag_group_set_->capacity() * (sizeof(TagGroup*) + 1);
+  for (TagGroupIndex i = 0; i < tag_group_next_; i++) {
+    TagGroup *tag_group = tag_groups_[i];
+    if (tag_group) {
+      size_t arrival_count = tag_group->arrivalCount();
+      tag_group_count++;
+      tag_group_bytes += sizeof(TagGroup)
+	+ sizeof(ArrivalMap)
+	+ arrival_count * (sizeof(Tag*) + sizeof(int)
+			   + MemoryReport::hash_node_bytes
+			   + sizeof(Tag*));
+    }
+  }
+  memory.reportUsage("Search", "tag groups", tag_group_count,
+		     tag_group_bytes);
+  size_t clk_info_count = clk_info_set_->size();
+  memory.reportUsage("Search", "clk infos", clk_info_count,
+		     clk_info_count * sizeof(ClkInfo)
+		     + clk_info_set_->capacity() * (sizeof(ClkInfo*) + 1));
+  size_t arrival_count = 0;
+  size_t required_count = 0;
+  size_t prev_path_count = 0;
+  VertexIterator vertex_iter(graph_);
+  while (vertex_iter.hasNext()) {
+    Vertex *vertex = vertex_iter.next();
+    TagGroup *tag_group = tagGroup(vertex);
+    if (tag_group && vertex->arrivals()) {
+      int count = tag_group->arrivalCount();
+      arrival_count += count;
+      if (vertex->hasRequireds())
+	required_count += count;
+      if (vertex->prevPaths())
+	prev_path_count += count;
+    }
+  }
+  memory.reportUsage("Search", "arrivals", arrival_count,
+		     arrival_count * sizeof(Arrival));
+  memory.reportUsage("Search", "requireds", required_count,
+		     required_count * sizeof(Required));
+  memory.reportUsage("Search", "prev paths", prev_path_count,
+		     prev_path_count * sizeof(PathVertexRep));
+  memory.reportSubsystemTotal("Search");
 }
 
 ////////////////////////////////////////////////////////////////
@@ -2895,44 +3980,21 @@ Search::findTag(const TransRiseFall *tr,
 	    is_segment_start, states, false, this);
   Tag *tag = tag_set_->findKey(&probe);
   if (tag == nullptr) {
-    // Recheck with lock.
-    UniqueLock lock(tag_lock_);
+    // Recheck with the lock for the probe's shard of the set.
+    UniqueLock lock(tag_set_->lock(&probe));
     tag = tag_set_->findKey(&probe);
     if (tag == nullptr) {
       ExceptionStateSet *new_states = !own_states && states
 	? new ExceptionStateSet(*states) : states;
-      TagIndex tag_index;
-      if (tag_free_indices_.empty())
-	tag_index = tag_next_++;
-      else {
-	tag_index = tag_free_indices_.back();
-	tag_free_indices_.pop_back();
-      }
+      TagIndex tag_index = makeTagIndex();
       tag = new Tag(tag_index, tr->index(), path_ap->index(),
 		    clk_info, is_clk, input_delay, is_segment_start,
 		    new_states, true, this);
       own_states = false;
       // Make sure tag can be indexed in tags_ before it is visible to
       // other threads via tag_set_.
-      tags_[tag_index] = tag;
+      tags_.set(tag_index, tag);
       tag_set_->insert(tag);
-      // If tags_ needs to grow make the new array and copy the
-      // contents into it before updating tags_ so that other threads
-      // can use Search::tag(TagIndex) without returning gubbish.
-      // std::vector doesn't seem to follow this protocol so multi-thread
-      // search fails occasionally if a vector is used for tags_.
-      if (tag_next_ == tag_capacity_) {
-	TagIndex new_capacity = nextMersenne(tag_capacity_);
-	Tag **new_tags = new Tag*[new_capacity];
-	memcpy(new_tags, tags_, tag_capacity_ * sizeof(Tag*));
-	Tag **old_tags = tags_;
-	tags_ = new_tags;
-	delete [] old_tags;
-	tag_capacity_ = new_capacity;
-	tag_set_->resize(new_capacity);
-      }
-      if (tag_next_ > tag_index_max)
-	internalError("max tag index exceeded");
     }
   }
   if (own_states)
@@ -2940,6 +4002,23 @@ Search::findTag(const TransRiseFall *tr,
   return tag;
 }
 
+TagIndex
+Search::makeTagIndex()
+{
+  UniqueLock lock(tag_lock_);
+  TagIndex tag_index;
+  if (tag_free_indices_.empty()) {
+    tag_index = tag_next_++;
+    if (tag_next_ > tag_index_max)
+      internalError("max tag index exceeded");
+  }
+  else {
+    tag_index = tag_free_indices_.back();
+    tag_free_indices_.pop_back();
+  }
+  return tag_index;
+}
+
 void
 Search::reportTags() const
 {
@@ -2948,13 +4027,11 @@ Search::reportTags() const
     if (tag)
       report_->print("Tag %4u %4u %s\n",
 		     tag->index(),
-		     tag->hash() % tag_set_->capacity(),
+		     tag->hash(),
 		     tag->asString(false, this)) ;
   }
-  Hash long_hash = tag_set_->longestBucketHash();
-  printf("Longest hash bucket length %d hash=%u\n",
-	 tag_set_->bucketLength(long_hash),
-	 long_hash);
+  report_->print("Longest hash probe length %d\n",
+		 tag_set_->longestProbeLength());
 }
 
 void
@@ -2962,8 +4039,9 @@ Search::reportClkInfos() const
 {
   Vector<ClkInfo*> clk_infos;
   // set -> vector for sorting.
-  for (auto clk_info : *clk_info_set_)
-    clk_infos.push_back(clk_info);
+  ClkInfoSet::Iterator clk_info_iter(clk_info_set_);
+  while (clk_info_iter.hasNext())
+    clk_infos.push_back(clk_info_iter.next());
   sort(clk_infos, ClkInfoLess(this));
   for (auto clk_info : clk_infos)
     report_->print("ClkInfo %s\n",
@@ -2989,14 +4067,18 @@ Search::findClkInfo(ClockEdge *clk_edge,
   ClkInfo probe(clk_edge, clk_src, is_propagated, gen_clk_src, gen_clk_src_path,
 		pulse_clk_sense, insertion, latency, uncertainties,
 		path_ap->index(), crpr_clk_path_rep, this);
-  UniqueLock lock(clk_info_lock_);
   ClkInfo *clk_info = clk_info_set_->findKey(&probe);
   if (clk_info == nullptr) {
-    clk_info = new ClkInfo(clk_edge, clk_src,
-			   is_propagated, gen_clk_src, gen_clk_src_path,
-			   pulse_clk_sense, insertion, latency, uncertainties,
-			   path_ap->index(), crpr_clk_path_rep, this);
-    clk_info_set_->insert(clk_info);
+    // Recheck with the lock for the probe's shard of the set.
+    UniqueLock lock(clk_info_set_->lock(&probe));
+    clk_info = clk_info_set_->findKey(&probe);
+    if (clk_info == nullptr) {
+      clk_info = new ClkInfo(clk_edge, clk_src,
+			     is_propagated, gen_clk_src, gen_clk_src_path,
+			     pulse_clk_sense, insertion, latency, uncertainties,
+			     path_ap->index(), crpr_clk_path_rep, this);
+      clk_info_set_->insert(clk_info);
+    }
   }
   return clk_info;
 }
@@ -3059,8 +4141,18 @@ Search::timingDerate(Vertex *from_vertex,
        derate_type = TimingDerateType::cell_delay;
        tr = arc->fromTrans()->asRiseFall();
     }
-    return sdc_->timingDerateInstance(pin, derate_type, derate_clk_data, tr,
-				      path_ap->pathMinMax());
+    const EarlyLate *early_late = path_ap->pathMinMax();
+    float derate = sdc_->timingDerateInstance(pin, derate_type,
+					      derate_clk_data, tr, early_late);
+    if (derate_type == TimingDerateType::cell_delay
+	&& aocv_enabled_
+	&& sdc_->hasAocvDerates()) {
+      const Instance *inst = network_->instance(pin);
+      const LibertyCell *cell = network_->libertyCell(inst);
+      derate *= sdc_->aocvDerate(cell, derate_clk_data, tr, early_late,
+				 aocv_depths_->cellDepth(edge));
+    }
+    return derate;
   }
 }
 
@@ -3122,71 +4214,200 @@ Search::findRequireds()
 void
 Search::findRequireds(Level level)
 {
-  Stats stats(debug_);
+  Stats stats(debug_, phase_stats_);
   debugPrint1(debug_, "search", 1, "find requireds to level %d\n", level);
   RequiredVisitor req_visitor(this);
+  graph_->ensureCsr();
   if (!requireds_seeded_)
     seedRequireds();
   seedInvalidRequireds();
   int required_count = required_iter_->visitParallel(level, &req_visitor);
   requireds_exist_ = true;
   debugPrint1(debug_, "search", 1, "found %d requireds\n", required_count);
+  stats.setVisitCount(required_count);
   stats.report("Find requireds");
 }
 
+void
+Search::findRequireds(Vertex *vertex)
+{
+  if (requireds_seeded_)
+    findRequireds(vertex->level());
+  else {
+    Stats stats(debug_, phase_stats_);
+    debugPrint1(debug_, "search", 1, "find cone requireds %s\n",
+		vertex->name(sdc_network_));
+    RequiredVisitor req_visitor(this);
+    graph_->ensureCsr();
+    seedConeRequireds(vertex);
+    seedInvalidRequireds();
+    int required_count = required_iter_->visitParallel(vertex->level(),
+						       &req_visitor);
+    requireds_exist_ = true;
+    debugPrint1(debug_, "search", 1, "found %d requireds\n", required_count);
+    stats.setVisitCount(required_count);
+    stats.report("Find cone requireds");
+  }
+}
+
 void
 Search::seedRequireds()
 {
   ensureDownstreamClkPins();
-  for (auto vertex : *endpoints())
-    seedRequired(vertex);
+  VertexSeq ends;
+  for (Vertex *end : *endpoints()) {
+    if (isTimingScopeEnd(end))
+      ends.push_back(end);
+  }
+  seedRequireds(ends);
   requireds_seeded_ = true;
   requireds_exist_ = true;
+  required_cone_vertices_.clear();
 }
 
-VertexSet *
+// Seed the endpoints in the fanout cone of vertex. The required time
+// of a vertex only depends on the endpoints in its fanout cone, so
+// vertices that have already had their cone seeded are not searched
+// again until the cones are invalidated.
+void
+Search::seedConeRequireds(Vertex *vertex)
+{
+  ensureDownstreamClkPins();
+  // Make sure the endpoints are up to date.
+  endpoints();
+  VertexSeq ends;
+  VertexSeq queue;
+  if (!required_cone_vertices_.hasKey(vertex)) {
+    required_cone_vertices_.insert(vertex);
+    queue.push_back(vertex);
+  }
+  while (!queue.empty()) {
+    Vertex *from_vertex = queue.back();
+    queue.pop_back();
+    if (endpointsHasKey(from_vertex)
+	&& isTimingScopeEnd(from_vertex))
+      ends.push_back(from_vertex);
+    if (search_adj_->searchFrom(from_vertex)) {
+      VertexOutEdgeIterator edge_iter(from_vertex, graph_);
+      while (edge_iter.hasNext()) {
+	Edge *edge = edge_iter.next();
+	Vertex *to_vertex = edge->to(graph_);
+	// Required times do not propagate back thru latch D->Q edges.
+	if (edge->role() != TimingRole::latchDtoQ()
+	    && search_adj_->searchThru(edge)
+	    && search_adj_->searchTo(to_vertex)
+	    && !required_cone_vertices_.hasKey(to_vertex)) {
+	  required_cone_vertices_.insert(to_vertex);
+	  queue.push_back(to_vertex);
+	}
+      }
+    }
+  }
+  seedRequireds(ends);
+  debugPrint1(debug_, "search", 2, "seeded %lu cone endpoints\n",
+	      ends.size());
+}
+
+void
+Search::requiredConesInvalid()
+{
+  required_cone_vertices_.clear();
+}
+
+VertexSeq *
 Search::endpoints()
 {
   if (endpoints_ == nullptr) {
-    endpoints_ = new VertexSet;
-    invalid_endpoints_ = new VertexSet;
+    endpoints_ = new VertexSeq;
+    endpoint_positions_.assign(graph_->vertexIndexBound(), 0);
+    invalid_endpoints_.clear();
+    VertexSeq vertices;
     VertexIterator vertex_iter(graph_);
-    while (vertex_iter.hasNext()) {
-      Vertex *vertex = vertex_iter.next();
-      if (isEndpoint(vertex)) {
+    while (vertex_iter.hasNext())
+      vertices.push_back(vertex_iter.next());
+    // Mark the gated clock enables in parallel.
+    std::vector<char> is_gated_clk_enables;
+    bool gated_clk_checks = sdc_->gatedClkChecksEnabled();
+    if (gated_clk_checks)
+      gated_clk_->findEnables(vertices, is_gated_clk_enables);
+    for (size_t i = 0; i < vertices.size(); i++) {
+      Vertex *vertex = vertices[i];
+      bool is_gated_clk_enable = gated_clk_checks && is_gated_clk_enables[i];
+      vertex->setIsGatedClkEnable(is_gated_clk_enable);
+      if (isEndpoint(vertex, search_adj_, is_gated_clk_enable)) {
 	debugPrint1(debug_, "endpoint", 2, "insert %s\n",
 		    vertex->name(sdc_network_));
-	endpoints_->insert(vertex);
+	insertEndpoint(vertex);
       }
     }
   }
-  if (invalid_endpoints_) {
-    for (auto vertex : *invalid_endpoints_) {
-      if (isEndpoint(vertex)) {
-	debugPrint1(debug_, "endpoint", 2, "insert %s\n",
-		    vertex->name(sdc_network_));
-	endpoints_->insert(vertex);
+  if (!invalid_endpoints_.empty()) {
+    VertexSeq vertices;
+    invalid_endpoints_.vertices(graph_, vertices);
+    for (auto vertex : vertices) {
+      bool is_gated_clk_enable = sdc_->gatedClkChecksEnabled()
+	&& gated_clk_->isGatedClkEnable(vertex);
+      vertex->setIsGatedClkEnable(is_gated_clk_enable);
+      if (isEndpoint(vertex, search_adj_, is_gated_clk_enable)) {
+	if (!endpointsHasKey(vertex)) {
+	  debugPrint1(debug_, "endpoint", 2, "insert %s\n",
+		      vertex->name(sdc_network_));
+	  insertEndpoint(vertex);
+	}
       }
-      else {
-	if (debug_->check("endpoint", 2)
-	    && endpoints_->hasKey(vertex))
-	  debug_->print("endpoint: remove %s\n", vertex->name(sdc_network_));
-	endpoints_->erase(vertex);
+      else if (endpointsHasKey(vertex)) {
+	debugPrint1(debug_, "endpoint", 2, "remove %s\n",
+		    vertex->name(sdc_network_));
+	eraseEndpoint(vertex);
       }
     }
-    invalid_endpoints_->clear();
+    invalid_endpoints_.clear();
   }
   return endpoints_;
 }
 
+bool
+Search::endpointsHasKey(Vertex *vertex) const
+{
+  VertexIndex index = graph_->index(vertex);
+  return index < endpoint_positions_.size()
+    && endpoint_positions_[index] != 0;
+}
+
+void
+Search::insertEndpoint(Vertex *vertex)
+{
+  VertexIndex index = graph_->index(vertex);
+  if (index >= endpoint_positions_.size())
+    endpoint_positions_.resize(graph_->vertexIndexBound(), 0);
+  endpoints_->push_back(vertex);
+  endpoint_positions_[index] = endpoints_->size();
+}
+
+// Move the last endpoint into the hole left by vertex.
+void
+Search::eraseEndpoint(Vertex *vertex)
+{
+  VertexIndex index = graph_->index(vertex);
+  VertexIndex position = endpoint_positions_[index] - 1;
+  Vertex *last = endpoints_->back();
+  (*endpoints_)[position] = last;
+  endpoint_positions_[graph_->index(last)] = position + 1;
+  endpoints_->pop_back();
+  endpoint_positions_[index] = 0;
+}
+
 void
 Search::endpointInvalid(Vertex *vertex)
 {
-  if (invalid_endpoints_) {
+  // Endpoint and fanout edge changes change the fanout cones.
+  requiredConesInvalid();
+  if (endpoints_) {
     debugPrint1(debug_, "endpoint", 2, "invalid %s\n",
 		vertex->name(sdc_network_));
-    invalid_endpoints_->insert(vertex);
+    invalid_endpoints_.insert(vertex, graph_);
   }
+  pathEndInvalid(vertex);
 }
 
 bool
@@ -3198,13 +4419,22 @@ Search::isEndpoint(Vertex *vertex) const
 bool
 Search::isEndpoint(Vertex *vertex,
 		   SearchPred *pred) const
+{
+  return isEndpoint(vertex, pred,
+		    sdc_->gatedClkChecksEnabled()
+		    && gated_clk_->isGatedClkEnable(vertex));
+}
+
+bool
+Search::isEndpoint(Vertex *vertex,
+		   SearchPred *pred,
+		   bool is_gated_clk_enable) const
 {
   Pin *pin = vertex->pin();
   return hasFanin(vertex, pred, graph_)
     && ((vertex->hasChecks()
 	 && hasEnabledChecks(vertex))
-	|| (sdc_->gatedClkChecksEnabled()
-	    && gated_clk_->isGatedClkEnable(vertex))
+	|| is_gated_clk_enable
 	|| vertex->isConstrained()
 	|| sdc_->isPathDelayInternalEndpoint(pin)
 	|| !hasFanout(vertex, pred, graph_)
@@ -3228,17 +4458,22 @@ Search::hasEnabledChecks(Vertex *vertex) const
 void
 Search::endpointsInvalid()
 {
+  requiredConesInvalid();
   delete endpoints_;
-  delete invalid_endpoints_;
   endpoints_ = nullptr;
-  invalid_endpoints_ = nullptr;
+  endpoint_positions_.clear();
+  invalid_endpoints_.clear();
 }
 
 void
 Search::seedInvalidRequireds()
 {
-  for (auto vertex : invalid_requireds_)
-    required_iter_->enqueue(vertex);
+  VertexSeq vertices;
+  invalid_requireds_.vertices(graph_, vertices);
+  for (auto vertex : vertices) {
+    if (inTimingScope(vertex))
+      required_iter_->enqueue(vertex);
+  }
   invalid_requireds_.clear();
 }
 
@@ -3328,6 +4563,44 @@ Search::seedRequiredEnqueueFanin(Vertex *vertex)
   required_iter_->enqueueAdjacentVertices(vertex);
 }
 
+// Seed the endpoint required times in parallel. The path end required
+// times are where crpr is applied, so the backward search from the
+// seeds only subtracts arc delays. Fanin is enqueued after the seeds
+// are saved because enqueueing marks the fanin vertices, which may be
+// endpoints being seeded by another thread.
+void
+Search::seedRequireds(const VertexSeq &ends)
+{
+  int thread_count = thread_pool_ ? thread_pool_->threadCount() : 1;
+  if (thread_count < 1)
+    thread_count = 1;
+  Vector<VisitPathEnds*> visit_path_ends(thread_count);
+  for (int i = 0; i < thread_count; i++)
+    visit_path_ends[i] = new VisitPathEnds(this);
+  std::vector<char> requireds_changed(ends.size());
+  forEachChunk(ends.size(), thread_pool_,
+	       [&] (size_t begin, size_t end, int thread_index) {
+		 VisitPathEnds *visit_ends = visit_path_ends[thread_index];
+		 RequiredCmp required_cmp;
+		 FindEndRequiredVisitor seeder(&required_cmp, this);
+		 for (size_t i = begin; i < end; i++) {
+		   Vertex *vertex = ends[i];
+		   debugPrint1(debug_, "search", 2, "required seed %s\n",
+			       vertex->name(sdc_network_));
+		   required_cmp.requiredsInit(vertex, this);
+		   visit_ends->visitPathEnds(vertex, &seeder);
+		   requireds_changed[i] = required_cmp.requiredsSave(vertex,
+								     this);
+		 }
+	       });
+  visit_path_ends.deleteContents();
+  // Enqueue fanin vertices for back-propagating required times.
+  for (size_t i = 0; i < ends.size(); i++) {
+    if (requireds_changed[i])
+      required_iter_->enqueueAdjacentVertices(ends[i]);
+  }
+}
+
 ////////////////////////////////////////////////////////////////
 
 RequiredCmp::RequiredCmp() :
@@ -3381,6 +4654,7 @@ RequiredCmp::requiredsSave(Vertex *vertex,
     if (!prev_reqs)
       requireds_changed = true;
     Debug *debug = sta->debug();
+    const Search *search = sta->search();
     VertexPathIterator path_iter(vertex, sta);
     while (path_iter.hasNext()) {
       PathVertex *path = path_iter.next();
@@ -3395,7 +4669,9 @@ RequiredCmp::requiredsSave(Vertex *vertex,
 		      delayAsString(prev_req, sta),
 		      delayAsString(req, sta));
 	  path->setRequired(req, sta);
-	  requireds_changed = true;
+	  // Changes within the incremental tolerance are not propagated.
+	  if (search->exceedsIncrementalTolerance(prev_req, req))
+	    requireds_changed = true;
 	}
       }
       else {
@@ -3547,31 +4823,67 @@ RequiredVisitor::visitFromToPath(const Pin *,
 
 ////////////////////////////////////////////////////////////////
 
+// Mark the vertices upstream of register clock pins.
+class DownstreamClkPinVisitor : public VertexVisitor
+{
+public:
+  explicit DownstreamClkPinVisitor(BfsBkwdIterator *iter);
+  virtual VertexVisitor *copy();
+  virtual void visit(Vertex *vertex);
+
+private:
+  DISALLOW_COPY_AND_ASSIGN(DownstreamClkPinVisitor);
+
+  BfsBkwdIterator *iter_;
+};
+
+DownstreamClkPinVisitor::DownstreamClkPinVisitor(BfsBkwdIterator *iter) :
+  VertexVisitor(),
+  iter_(iter)
+{
+}
+
+VertexVisitor *
+DownstreamClkPinVisitor::copy()
+{
+  return new DownstreamClkPinVisitor(iter_);
+}
+
+void
+DownstreamClkPinVisitor::visit(Vertex *vertex)
+{
+  vertex->setHasDownstreamClkPin(true);
+  iter_->enqueueAdjacentVertices(vertex);
+}
+
 void
 Search::ensureDownstreamClkPins()
 {
   if (!found_downstream_clk_pins_) {
+    Stats stats(debug_, phase_stats_);
     // Use backward BFS from register clk pins to mark upsteam pins
-    // as having downstream clk pins.
+    // as having downstream clk pins. Each level of the clock network
+    // is marked in parallel.
     ClkTreeSearchPred pred(this);
     BfsBkwdIterator iter(BfsIndex::other, &pred, this);
     for (auto vertex : *graph_->regClkVertices())
       iter.enqueue(vertex);
 
     // Enqueue PLL feedback pins.
-    VertexIterator vertex_iter(graph_);
-    while (vertex_iter.hasNext()) {
-      Vertex *vertex = vertex_iter.next();
-      Pin *pin = vertex->pin();
-      const LibertyPort *port = network_->libertyPort(pin);
-      if (port && port->isPllFeedbackPin())
-	iter.enqueue(vertex);
-    }
-    while (iter.hasNext()) {
-      Vertex *vertex = iter.next();
-      vertex->setHasDownstreamClkPin(true);
-      iter.enqueueAdjacentVertices(vertex);
+    if (LibertyLibrary::foundPllFeedbackPins()) {
+      VertexIterator vertex_iter(graph_);
+      while (vertex_iter.hasNext()) {
+	Vertex *vertex = vertex_iter.next();
+	Pin *pin = vertex->pin();
+	const LibertyPort *port = network_->libertyPort(pin);
+	if (port && port->isPllFeedbackPin())
+	  iter.enqueue(vertex);
+      }
     }
+    DownstreamClkPinVisitor visitor(&iter);
+    int visit_count = iter.visitParallel(0, &visitor);
+    stats.setVisitCount(visit_count);
+    stats.report("Find downstream clk pins");
   }
   found_downstream_clk_pins_ = true;
 }
@@ -3721,30 +5033,41 @@ Search::tnsInvalid(Vertex *vertex)
       && isEndpoint(vertex)) {
     debugPrint1(debug_, "tns", 2, "tns invalid %s\n",
 		vertex->name(sdc_network_));
-    UniqueLock lock(tns_lock_);
-    invalid_tns_.insert(vertex);
+    invalid_tns_.insert(vertex, graph_);
   }
 }
 
+// Only the endpoints with slacks that changed since the last query
+// are visited, so the update is proportional to the size of the edit.
 void
 Search::updateInvalidTns()
 {
   PathAPIndex path_ap_count = corners_->pathAnalysisPtCount();
-  for (auto vertex : invalid_tns_) {
+  VertexSeq vertices;
+  invalid_tns_.vertices(graph_, vertices);
+  VertexSeq ends;
+  for (auto vertex : vertices) {
     // Network edits can change endpointedness since tnsInvalid was called.
     if (isEndpoint(vertex)) {
       debugPrint1(debug_, "tns", 2, "update tns %s\n",
 		  vertex->name(sdc_network_));
-      SlackSeq slacks(path_ap_count);
-      wnsSlacks(vertex, slacks);
-
-      if (tns_exists_)
-	updateTns(vertex, slacks);
-      if (worst_slacks_)
-	worst_slacks_->updateWorstSlacks(vertex, slacks);
+      ends.push_back(vertex);
     }
   }
   invalid_tns_.clear();
+
+  SlackSeq slacks;
+  wnsSlacks(ends, slacks);
+  if (tns_exists_)
+    updateTns(ends, slacks, true);
+  if (worst_slacks_) {
+    SlackSeq vertex_slacks(path_ap_count);
+    for (size_t i = 0; i < ends.size(); i++) {
+      for (PathAPIndex j = 0; j < path_ap_count; j++)
+	vertex_slacks[j] = slacks[i * path_ap_count + j];
+      worst_slacks_->updateWorstSlacks(ends[i], vertex_slacks);
+    }
+  }
 }
 
 void
@@ -3755,25 +5078,36 @@ Search::findTotalNegativeSlacks()
     tns_[i] = 0.0;
     tns_slacks_[i].clear();
   }
-  for (auto vertex : *endpoints()) {
-    // No locking required.
-    SlackSeq slacks(path_ap_count);
-    wnsSlacks(vertex, slacks);
-    for (PathAPIndex i = 0; i < path_ap_count; i++)
-      tnsIncr(vertex, slacks[i], i);
-  }
+  const VertexSeq &ends = *endpoints();
+  SlackSeq slacks;
+  wnsSlacks(ends, slacks);
+  updateTns(ends, slacks, false);
   tns_exists_ = true;
 }
 
+// Each analysis point has its own tns sum and slack map, so the
+// analysis points are updated in parallel. The endpoints are summed
+// in the same order as a serial update so the result does not depend
+// on the thread count.
 void
-Search::updateTns(Vertex *vertex,
-		  SlackSeq &slacks)
+Search::updateTns(const VertexSeq &ends,
+		  const SlackSeq &slacks,
+		  bool decr)
 {
   PathAPIndex path_ap_count = corners_->pathAnalysisPtCount();
-  for (PathAPIndex i = 0; i < path_ap_count; i++) {
-    tnsDecr(vertex, i);
-    tnsIncr(vertex, slacks[i], i);
-  }
+  forEachChunk(path_ap_count, thread_pool_,
+	       [&] (size_t begin, size_t end, int) {
+		 for (size_t j = begin; j < end; j++) {
+		   PathAPIndex path_ap_index = j;
+		   for (size_t i = 0; i < ends.size(); i++) {
+		     Vertex *vertex = ends[i];
+		     if (decr)
+		       tnsDecr(vertex, path_ap_index);
+		     tnsIncr(vertex, slacks[i * path_ap_count + j],
+			     path_ap_index);
+		   }
+		 }
+	       });
 }
 
 void
@@ -3810,11 +5144,13 @@ Search::tnsDecr(Vertex *vertex,
 }
 
 // Notify tns before updating/deleting slack (arrival/required).
+// Called by the search threads.
 void
 Search::tnsNotifyBefore(Vertex *vertex)
 {
   if (tns_exists_
       && isEndpoint(vertex)) {
+    UniqueLock lock(tns_lock_);
     int ap_count = corners_->pathAnalysisPtCount();
     for (int i = 0; i < ap_count; i++) {
       tnsDecr(vertex, i);
@@ -3861,10 +5197,13 @@ Search::wnsTnsPreamble()
   findAllArrivals();
   // Required times are only needed at endpoints.
   if (requireds_seeded_) {
-    for (Vertex *vertex : invalid_requireds_) {
+    VertexSeq vertices;
+    invalid_requireds_.vertices(graph_, vertices);
+    for (Vertex *vertex : vertices) {
       debugPrint1(debug_, "search", 2, "tns update required %s\n",
 		  vertex->name(sdc_network_));
-      if (isEndpoint(vertex)) {
+      if (isEndpoint(vertex)
+	  && isTimingScopeEnd(vertex)) {
 	seedRequired(vertex);
 	// If the endpoint has fanout it's required time
 	// depends on downstream checks, so enqueue it to
@@ -3947,14 +5286,41 @@ Search::wnsSlacks(Vertex *vertex,
     visit_path_ends_->visitPathEnds(vertex, &end_visitor);
   }
   else {
-    VertexPathIterator path_iter(vertex, this);
-    while (path_iter.hasNext()) {
-      Path *path = path_iter.next();
-      PathAPIndex path_ap_index = path->pathAnalysisPtIndex(this);
-      const Slack path_slack = path->slack(this);
-      if (!path->tag(this)->isFilter()
-	  && fuzzyLess(path_slack, slacks[path_ap_index]))
-	slacks[path_ap_index] = path_slack;
+    TagGroup *tag_group = tagGroup(vertex);
+    if (tag_group && vertex->hasRequireds()) {
+      // Stream the arrival and required blocks of each path analysis
+      // point instead of looking up the path for each tag.
+      const Arrival *arrivals = vertex->arrivals();
+      const Required *requireds = arrivals + tag_group->arrivalCount();
+      for (PathAPIndex i = 0; i < path_ap_count; i++) {
+	int begin, end;
+	tag_group->pathAPArrivalRange(i, begin, end);
+	if (begin < end) {
+	  bool is_max = corners_->findPathAnalysisPt(i)->pathMinMax()
+	    == MinMax::max();
+	  Slack &slack = slacks[i];
+	  for (int j = begin; j < end; j++) {
+	    if (!tag_group->arrivalTag(j)->isFilter()) {
+	      const Slack path_slack = is_max
+		? requireds[j] - arrivals[j]
+		: arrivals[j] - requireds[j];
+	      if (fuzzyLess(path_slack, slack))
+		slack = path_slack;
+	    }
+	  }
+	}
+      }
+    }
+    else {
+      VertexPathIterator path_iter(vertex, this);
+      while (path_iter.hasNext()) {
+	Path *path = path_iter.next();
+	PathAPIndex path_ap_index = path->pathAnalysisPtIndex(this);
+	const Slack path_slack = path->slack(this);
+	if (!path->tag(this)->isFilter()
+	    && fuzzyLess(path_slack, slacks[path_ap_index]))
+	  slacks[path_ap_index] = path_slack;
+      }
     }
   }
 }
@@ -3969,6 +5335,24 @@ Search::wnsSlack(Vertex *vertex,
   return slacks[path_ap_index];
 }
 
+void
+Search::wnsSlacks(const VertexSeq &vertices,
+		  // Return value.
+		  SlackSeq &slacks)
+{
+  PathAPIndex path_ap_count = corners_->pathAnalysisPtCount();
+  slacks.resize(vertices.size() * path_ap_count);
+  forEachChunk(vertices.size(), thread_pool_,
+	       [&] (size_t begin, size_t end, int) {
+		 SlackSeq vertex_slacks(path_ap_count);
+		 for (size_t i = begin; i < end; i++) {
+		   wnsSlacks(vertices[i], vertex_slacks);
+		   for (PathAPIndex j = 0; j < path_ap_count; j++)
+		     slacks[i * path_ap_count + j] = vertex_slacks[j];
+		 }
+	       });
+}
+
 ////////////////////////////////////////////////////////////////
 
 PathGroups *
@@ -4000,6 +5384,26 @@ Search::deletePathGroups()
 {
   delete path_groups_;
   path_groups_ = nullptr;
+  delete path_ends_args_;
+  path_ends_args_ = nullptr;
+  path_ends_.clear();
+  path_ends_valid_ = false;
+  path_end_invalids_.clear();
+}
+
+// Called from delay calc threads, so only write the flag if it is set.
+void
+Search::pathEndsInvalid()
+{
+  if (path_ends_valid_.load(std::memory_order_relaxed))
+    path_ends_valid_.store(false, std::memory_order_relaxed);
+}
+
+void
+Search::pathEndInvalid(Vertex *vertex)
+{
+  if (path_ends_valid_.load(std::memory_order_relaxed))
+    path_end_invalids_.insert(vertex, graph_);
 }
 
 PathGroup *
@@ -18,13 +18,18 @@
 #define STA_SEARCH_H
 
 #include <mutex>
+#include <atomic>
 #include "MinMax.hh"
+#include "Debug.hh"
 #include "StaState.hh"
-#include "HashSet.hh"
+#include "ConcurrentHashSet.hh"
+#include "SegmentedArray.hh"
+#include "UnorderedMap.hh"
 #include "Transition.hh"
 #include "LibertyClass.hh"
 #include "NetworkClass.hh"
 #include "GraphClass.hh"
+#include "VertexBitSet.hh"
 #include "Delay.hh"
 #include "SdcClass.hh"
 #include "SearchClass.hh"
@@ -37,27 +42,31 @@ class BfsFwdIterator;
 class BfsBkwdIterator;
 class SearchPred;
 class SearchThru;
-class ClkInfoLess;
 class PathEndVisitor;
 class ArrivalVisitor;
 class RequiredVisitor;
 class ClkPathIterator;
+class VertexPathsSave;
 class EvalPred;
 class TagGroup;
 class TagGroupBldr;
 class PathGroups;
+class PathEndsArgs;
 class WorstSlacks;
 class DcalcAnalysisPt;
 class VisitPathEnds;
 class GatedClk;
+class AocvDepths;
+class RegClkIndex;
 class CheckCrpr;
 class Genclks;
 class Corner;
+class MemoryReport;
 
-typedef Set<ClkInfo*, ClkInfoLess> ClkInfoSet;
-typedef HashSet<Tag*, TagHash, TagEqual> TagHashSet;
-typedef HashSet<TagGroup*, TagGroupHash, TagGroupEqual> TagGroupSet;
-typedef Map<Vertex*, Slack> VertexSlackMap;
+typedef ConcurrentHashSet<ClkInfo*, ClkInfoHash, ClkInfoEqual> ClkInfoSet;
+typedef ConcurrentHashSet<Tag*, TagHash, TagEqual> TagHashSet;
+typedef ConcurrentHashSet<TagGroup*, TagGroupHash, TagGroupEqual> TagGroupSet;
+typedef UnorderedMap<Vertex*, Slack> VertexSlackMap;
 typedef Vector<VertexSlackMap> VertexSlackMapSeq;
 typedef Vector<WorstSlacks> WorstSlacksSeq;
 
@@ -78,6 +87,44 @@ public:
   // disables additional search to returns approximate required times.
   bool crprApproxMissingRequireds() const;
   void setCrprApproxMissingRequireds(bool enabled);
+  // Change in arrival or required time (seconds) that causes fanout
+  // (fanin) arrivals (requireds) to be recomputed during incremental
+  // search.  Smaller changes are saved but not propagated.
+  // Defaults to 0.0 for maximum accuracy and slowest incremental speed.
+  float incrementalTolerance() const { return incremental_tolerance_; }
+  void setIncrementalTolerance(float tol);
+  // True if arrival/required time1 and time2 differ by more than the
+  // incremental tolerance.
+  bool exceedsIncrementalTolerance(const Arrival &time1,
+				   const Arrival &time2) const;
+  // When enabled the first arrival search visits the fanout of each
+  // clock domain that does not mix with other domains on its own thread
+  // before searching the shared fanout.
+  bool clkDomainPartitions() const { return clk_domain_partitions_; }
+  void setClkDomainPartitions(bool partitions);
+  // When disabled clock path arrivals do not keep prev paths and
+  // clock path prevs are found from the fanin arrivals when needed.
+  bool prevPathStorage() const { return prev_path_storage_; }
+  void setPrevPathStorage(bool storage);
+  // With pocv enabled, merge data arrivals of the same tag with a
+  // statistical max (Clark) instead of keeping the worst mean.
+  bool statisticalMax() const { return statistical_max_; }
+  void setStatisticalMax(bool statistical_max);
+  // Scale cell delays by the advanced on-chip variation derates
+  // (Sdc::setAocvDerate) at the logic depth of each cell.
+  bool aocvEnabled() const { return aocv_enabled_; }
+  void setAocvEnabled(bool enabled);
+  // Restrict delay calculation, arrival and required search to the
+  // fanin cone of ends. Required times are only seeded at ends.
+  // Vertices made after the scope is set are outside of it.
+  void setTimingScope(const VertexSeq &ends);
+  void clearTimingScope();
+  bool hasTimingScope() const { return timing_scope_exists_; }
+  // True if there is no timing scope or vertex is in its fanin cone.
+  bool inTimingScope(const Vertex *vertex) const;
+  // True if there is no timing scope or vertex is one of its ends.
+  bool isTimingScopeEnd(const Vertex *vertex) const;
+  size_t timingScopeVertexCount() const { return timing_scope_.size(); }
 
   bool unconstrainedPaths() const { return unconstrained_paths_; }
   // from/thrus/to are owned and deleted by Search.
@@ -127,7 +174,14 @@ public:
   void findRequireds();
   // Find required times down thru level.
   void findRequireds(Level level);
+  // Find required times down thru vertex level seeding only the
+  // endpoints in the fanout cone of vertex.
+  void findRequireds(Vertex *vertex);
   bool requiredsSeeded() const { return requireds_seeded_; }
+  // Arrivals and requireds are found for every vertex and none are
+  // invalid, so vertex queries do not update them.
+  bool requiredsValid() const;
+  bool arrivalsExist() const { return arrivals_exist_; }
   bool requiredsExist() const { return requireds_exist_; }
   // The sum of all negative endpoints slacks.
   // Incrementally updated.
@@ -157,6 +211,11 @@ public:
 
   PathGroup *pathGroup(const PathEnd *path_end) const;
   void deletePathGroups();
+  // Arrivals or requireds changed so the last path ends are stale.
+  void pathEndsInvalid();
+  // The paths or requireds of vertex changed so its path ends in the
+  // last path groups are stale.
+  void pathEndInvalid(Vertex *vertex);
   virtual ExceptionPath *exceptionTo(ExceptionPathType type,
 				     const Path *path,
 				     const Pin *pin,
@@ -171,7 +230,9 @@ public:
 
   // Endpoints are discovered during arrival search, so are only
   // defined after findArrivals.
-  VertexSet *endpoints();
+  // The endpoints are kept in a dense array that is updated
+  // incrementally as vertices become or stop being endpoints.
+  VertexSeq *endpoints();
   void endpointsInvalid();
 
   // Clock tree vertices between the clock source pin and register clk pins.
@@ -208,8 +269,34 @@ public:
   Tag *tag(TagIndex index) const;
   TagIndex tagCount() const;
   TagGroupIndex tagGroupCount() const;
+  // Delete unreferenced tags, tag groups and clk infos and renumber
+  // the rest.  Deletes path groups.
+  void compactTags();
+  // Enough tag groups have been made since the last compaction to
+  // compact them again.
+  bool tagCompactionDue() const;
+  // The arrival journal saves the arrivals, requireds and prev paths
+  // of each vertex before they are changed so they can be restored
+  // to the values from before the journal began.
+  // Tags are not compacted while the journal is active.
+  void beginArrivalJournal();
+  // Restore the saved vertex paths and end the journal.
+  void restoreArrivalJournal();
+  // Keep the current vertex paths and end the journal.
+  void endArrivalJournal();
+  bool arrivalJournalActive() const { return arrival_journal_active_; }
+  // Save the vertex paths if they have not been saved since the
+  // journal began.
+  void journalArrivals(Vertex *vertex);
   void reportTagGroups() const;
   void reportArrivalCountHistogram() const;
+  // Number of vertices indexed by the vertex arrival count.
+  void arrivalCountHistogram(// Return value.
+			     Vector<int> &vertex_counts) const;
+  // Report the max_count vertices with the largest arrival count growth
+  // over their fanin and what distinguishes the extra tags.
+  void reportTagGrowth(int max_count) const;
+  void reportMemory(MemoryReport &memory) const;
   virtual int clkInfoCount() const;
   virtual bool isEndpoint(Vertex *vertex) const;
   virtual bool isEndpoint(Vertex *vertex,
@@ -257,8 +344,12 @@ public:
   void setVertexArrivals(Vertex *vertex,
 			 TagGroupBldr *group_bldr);
   void tnsInvalid(Vertex *vertex);
+  // Return true if the arrivals changed by more than the incremental
+  // tolerance.  arrivals_differ is true for any change.
   bool arrivalsChanged(Vertex *vertex,
-		       TagGroupBldr *tag_bldr);
+		       TagGroupBldr *tag_bldr,
+		       // Return value.
+		       bool &arrivals_differ);
   BfsFwdIterator *arrivalIterator() const { return arrival_iter_; }
   BfsBkwdIterator *requiredIterator() const { return required_iter_; }
   bool arrivalsAtEndpointsExist()const{return arrivals_at_endpoints_exist_;}
@@ -324,13 +415,26 @@ public:
 			Edge *edge,
 			bool is_clk,
 			const PathAnalysisPt *path_ap);
+  // Derate factor applied by deratedDelay.
+  virtual float timingDerate(Vertex *from_vertex,
+			     TimingArc *arc,
+			     Edge *edge,
+			     bool is_clk,
+			     const PathAnalysisPt *path_ap);
 
   TagGroup *tagGroup(const Vertex *vertex) const;
   TagGroup *tagGroup(TagGroupIndex index) const;
   void reportArrivals(Vertex *vertex) const;
   Slack wnsSlack(Vertex *vertex,
 		 PathAPIndex path_ap_index);
+  // Endpoint slacks of vertices for every path analysis point found
+  // in parallel.
+  // slacks[i * path_ap_count + path_ap_index] is the slack of vertices[i].
+  void wnsSlacks(const VertexSeq &vertices,
+		 // Return value.
+		 SlackSeq &slacks);
   void levelChangedBefore(Vertex *vertex);
+  void levelsInvalid();
   void seedInputArrival(const Pin *pin,
  			Vertex *vertex,
  			TagGroupBldr *tag_bldr);
@@ -345,6 +449,8 @@ public:
   CheckCrpr *checkCrpr() { return check_crpr_; }
   VisitPathEnds *visitPathEnds() { return visit_path_ends_; }
   GatedClk *gatedClk() { return gated_clk_; }
+  AocvDepths *aocvDepths() { return aocv_depths_; }
+  RegClkIndex *regClkIndex() { return reg_clk_index_; }
   Genclks *genclks() { return genclks_; }
 
 protected:
@@ -467,23 +573,33 @@ protected:
 			     const ClockEdge *clk_edge,
 			     const MinMax *min_max) const;
   void seedRequireds();
+  bool endpointsHasKey(Vertex *vertex) const;
+  void insertEndpoint(Vertex *vertex);
+  void eraseEndpoint(Vertex *vertex);
+  void seedConeRequireds(Vertex *vertex);
+  void seedRequireds(const VertexSeq &ends);
   void seedInvalidRequireds();
+  void requiredConesInvalid();
   bool havePendingLatchOutputs();
   void clearPendingLatchOutputs();
   void enqueuePendingLatchOutputs();
   void findFilteredArrivals();
+  PathEndSeq *updatePathEnds(const Corner *corner,
+			     const MinMaxAll *min_max,
+			     bool sort_by_slack);
   void findArrivals1();
+  void findClkDomainArrivals(VertexVisitor *arrival_visitor);
   void seedFilterStarts();
   bool hasEnabledChecks(Vertex *vertex) const;
-  virtual float timingDerate(Vertex *from_vertex,
-			     TimingArc *arc,
-			     Edge *edge,
-			     bool is_clk,
-			     const PathAnalysisPt *path_ap);
+  bool isEndpoint(Vertex *vertex,
+		  SearchPred *pred,
+		  bool is_gated_clk_enable) const;
   void deletePaths();
   void deletePaths(Vertex *vertex);
   void deletePaths1(Vertex *vertex);
   TagGroup *findTagGroup(TagGroupBldr *group_bldr);
+  TagIndex makeTagIndex();
+  TagGroupIndex makeTagGroupIndex();
   void deleteFilterTags();
   void deleteFilterTagGroups();
   void deleteFilterClkInfos();
@@ -500,8 +616,9 @@ protected:
   void deleteWorstSlacks();
   void updateWorstSlacks(Vertex *vertex,
 			 Slack slacks);
-  void updateTns(Vertex *vertex,
-		 SlackSeq &slacks);
+  void updateTns(const VertexSeq &ends,
+		 const SlackSeq &slacks,
+		 bool decr);
   void tnsIncr(Vertex *vertex,
 	       Slack slack,
 	       PathAPIndex path_ap_index);
@@ -532,6 +649,11 @@ protected:
   bool unconstrained_paths_;
   bool crpr_path_pruning_enabled_;
   bool crpr_approx_missing_requireds_;
+  bool clk_domain_partitions_;
+  bool prev_path_storage_;
+  bool statistical_max_;
+  bool aocv_enabled_;
+  float incremental_tolerance_;
   // Search predicates.
   SearchPred *search_adj_;
   SearchPred *search_clk_;
@@ -549,48 +671,58 @@ protected:
   bool requireds_exist_;
   // Requireds have been seeded by searching arrivals to all endpoints.
   bool requireds_seeded_;
+  // Vertices with fanout cone endpoints seeded by findRequireds(vertex)
+  // when requireds are not seeded at all endpoints.
+  VertexSet required_cone_vertices_;
   // Vertices with invalid arrival times to update and search from.
-  VertexSet invalid_arrivals_;
-  std::mutex invalid_arrivals_lock_;
+  VertexBitSet invalid_arrivals_;
   BfsFwdIterator *arrival_iter_;
   // Vertices with invalid required times to update and search from.
-  VertexSet invalid_requireds_;
+  VertexBitSet invalid_requireds_;
   BfsBkwdIterator *required_iter_;
   bool tns_exists_;
   // Endpoint vertices with slacks that have changed since tns was found.
-  VertexSet invalid_tns_;
+  VertexBitSet invalid_tns_;
   // Indexed by path_ap->index().
   SlackSeq tns_;
   // Indexed by path_ap->index().
   VertexSlackMapSeq tns_slacks_;
   std::mutex tns_lock_;
+  bool arrival_journal_active_;
+  UnorderedMap<Vertex*, VertexPathsSave*> arrival_journal_;
+  std::mutex arrival_journal_lock_;
   // Indexed by path_ap->index().
   WorstSlacks *worst_slacks_;
   // Use pointer to clk_info set so Tag.hh does not need to be included.
   ClkInfoSet *clk_info_set_;
-  std::mutex clk_info_lock_;
   // Use pointer to tag set so Tag.hh does not need to be included.
+  // Lookups are lock free; inserts lock one shard of the set.
   TagHashSet *tag_set_;
   // Entries in tags_ may be missing where previous filter tags were deleted.
-  TagIndex tag_capacity_;
-  Tag **tags_;
+  SegmentedArray<Tag> tags_;
   TagIndex tag_next_;
   // Holes in tags_ left by deleting filter tags.
   std::vector<TagIndex> tag_free_indices_;
+  // Protects tag_next_ and tag_free_indices_.
   std::mutex tag_lock_;
   TagGroupSet *tag_group_set_;
-  TagGroup **tag_groups_;
+  SegmentedArray<TagGroup> tag_groups_;
   TagGroupIndex tag_group_next_;
   // Holes in tag_groups_ left by deleting filter tag groups.
   std::vector<TagIndex> tag_group_free_indices_;
-  // Capacity of tag_groups_.
-  TagGroupIndex tag_group_capacity_;
+  // Protects tag_group_next_ and tag_group_free_indices_.
   std::mutex tag_group_lock_;
+  // Tag group count after the last compaction.
+  TagGroupIndex tag_group_compact_count_;
   // Latches data outputs to queue on the next search pass.
-  VertexSet pending_latch_outputs_;
-  std::mutex pending_latch_outputs_lock_;
-  VertexSet *endpoints_;
-  VertexSet *invalid_endpoints_;
+  VertexBitSet pending_latch_outputs_;
+  // Endpoint vertices, or null if they have not been found.
+  VertexSeq *endpoints_;
+  // Position + 1 of vertices in endpoints_ indexed by VertexIndex,
+  // or 0 if the vertex is not an endpoint.
+  std::vector<VertexIndex> endpoint_positions_;
+  // Vertices to check for endpoint changes when endpoints_ exists.
+  VertexBitSet invalid_endpoints_;
   // Filter exception to tag arrivals for
   // report_timing -from pin|inst -through.
   // -to is always nullptr.
@@ -600,8 +732,23 @@ protected:
   ExceptionTo *filter_to_;
   bool found_downstream_clk_pins_;
   PathGroups *path_groups_;
+  // The path groups made by the last findPathEnds and its arguments
+  // are updated by the next call with the same arguments. The path
+  // ends of path_end_invalids_ are found again unless all arrivals
+  // or requireds or clock arrivals were invalidated.
+  PathEndsArgs *path_ends_args_;
+  PathEndSeq path_ends_;
+  // Cleared by delay calc and search threads (pathEndsInvalid).
+  std::atomic<bool> path_ends_valid_;
+  VertexBitSet path_end_invalids_;
   VisitPathEnds *visit_path_ends_;
   GatedClk *gated_clk_;
+  AocvDepths *aocv_depths_;
+  bool timing_scope_exists_;
+  // Fanin cone of the timing scope ends.
+  VertexBitSet timing_scope_;
+  VertexBitSet timing_scope_ends_;
+  RegClkIndex *reg_clk_index_;
   CheckCrpr *check_crpr_;
   Genclks *genclks_;
 };
@@ -733,6 +880,8 @@ protected:
   SearchPred *adj_pred_;
   bool crpr_active_;
   bool has_fanin_one_;
+  bool statistical_max_;
+  DebugHandle debug_search_;
 };
 
 class RequiredCmp
@@ -119,6 +119,27 @@ SearchPredNonLatch2::searchThru(Edge *edge)
 
 ////////////////////////////////////////////////////////////////
 
+SearchPredScope2::SearchPredScope2(const StaState *sta) :
+  SearchPredNonLatch2(sta)
+{
+}
+
+bool
+SearchPredScope2::searchFrom(const Vertex *from_vertex)
+{
+  return SearchPredNonLatch2::searchFrom(from_vertex)
+    && sta_->search()->inTimingScope(from_vertex);
+}
+
+bool
+SearchPredScope2::searchTo(const Vertex *to_vertex)
+{
+  return SearchPredNonLatch2::searchTo(to_vertex)
+    && sta_->search()->inTimingScope(to_vertex);
+}
+
+////////////////////////////////////////////////////////////////
+
 SearchPredNonReg2::SearchPredNonReg2(const StaState *sta) :
   SearchPred2(sta)
 {
@@ -33,6 +33,7 @@ namespace sta {
 //    ClkTreeSearchPred (only wire or combinational)
 //    SearchPred2 (unless timing check)
 //     SearchPredNonLatch2 (unless latch D->Q)
+//      SearchPredScope2 (outside search timing scope)
 //     SearchPredNonReg2 (unless reg CLK->Q, latch D->Q)
 
 // Virtual base class for search predicates.
@@ -119,6 +120,20 @@ private:
   DISALLOW_COPY_AND_ASSIGN(SearchPredNonLatch2);
 };
 
+// SearchPredNonLatch2 unless
+//  from/to vertex outside of the search timing scope
+//  (Search::setTimingScope).
+class SearchPredScope2 : public SearchPredNonLatch2
+{
+public:
+  explicit SearchPredScope2(const StaState *sta);
+  virtual bool searchFrom(const Vertex *from_vertex);
+  virtual bool searchTo(const Vertex *to_vertex);
+
+private:
+  DISALLOW_COPY_AND_ASSIGN(SearchPredScope2);
+};
+
 // SearchPred2 unless
 //  register/latch CLK->Q edges.
 class SearchPredNonReg2 : public SearchPred2
@@ -21,6 +21,7 @@
 #include "Debug.hh"
 #include "Report.hh"
 #include "Stats.hh"
+#include "ThreadForEach.hh"
 #include "PortDirection.hh"
 #include "FuncExpr.hh"
 #include "TimingRole.hh"
@@ -29,6 +30,7 @@
 #include "Network.hh"
 #include "Sdc.hh"
 #include "Graph.hh"
+#include "SimModes.hh"
 #include "Sim.hh"
 
 #if CUDD
@@ -324,6 +326,9 @@ Sim::Sim(StaState *sta) :
   observer_(nullptr),
   valid_(false),
   incremental_(false),
+  parallel_propagation_(false),
+  parallel_modes_(nullptr),
+  case_modes_(nullptr),
   const_func_pins_valid_(false)
 {
 }
@@ -331,6 +336,8 @@ Sim::Sim(StaState *sta) :
 Sim::~Sim()
 {
   delete observer_;
+  delete parallel_modes_;
+  delete case_modes_;
 }
 
 TimingSense
@@ -515,6 +522,24 @@ Sim::evalExpr(const FuncExpr *expr,
 
 #endif // CUDD
 
+LogicValue
+Sim::evalFunc(const FuncExpr *expr,
+	      const FuncTruthTable *table,
+	      const Instance *inst) const
+{
+  if (table) {
+    LogicValue input_values[FuncTruthTable::max_inputs];
+    for (int i = 0; i < table->inputCount(); i++) {
+      Pin *pin = network_->findPin(inst, table->input(i));
+      // Internal ports don't have instance pins.
+      input_values[i] = pin ? logicValue(pin) : LogicValue::unknown;
+    }
+    return table->eval(input_values);
+  }
+  else
+    return evalExpr(expr, inst);
+}
+
 void
 Sim::clear()
 {
@@ -527,6 +552,28 @@ Sim::clear()
   invalid_insts_.clear();
   invalid_drvr_pins_.clear();
   invalid_load_pins_.clear();
+  invalid_constraint_pins_.clear();
+  if (parallel_modes_)
+    parallel_modes_->netlistChanged();
+  if (case_modes_)
+    case_modes_->clear();
+}
+
+void
+Sim::setParallelPropagation(bool enable)
+{
+  parallel_propagation_ = enable;
+  constantsInvalid();
+}
+
+SimModes *
+Sim::caseModes()
+{
+  if (case_modes_ == nullptr)
+    case_modes_ = new SimModes(this);
+  else
+    case_modes_->copyState(this);
+  return case_modes_;
 }
 
 void
@@ -540,17 +587,22 @@ void
 Sim::ensureConstantsPropagated()
 {
   if (!valid_) {
-    Stats stats(debug_);
+    Stats stats(debug_, phase_stats_);
     ensureConstantFuncPins();
     instances_to_annotate_.clear();
     if (incremental_) {
+      seedInvalidConstraintPins();
       seedInvalidConstants();
       propagateToInvalidLoads();
       propagateFromInvalidDrvrsToLoads();
     }
     else {
+      invalid_constraint_pins_.clear();
       clearSimValues();
-      seedConstants();
+      if (parallel_propagation_ && thread_count_ > 1)
+	propagateConstantsParallel();
+      else
+	seedConstants();
     }
     invalid_insts_.clear();
     propagateConstants();
@@ -572,6 +624,104 @@ Sim::seedInvalidConstants()
   }
 }
 
+// Propagate the constants in the fanout of pins with constraint
+// values that changed again.
+void
+Sim::seedInvalidConstraintPins()
+{
+  if (!invalid_constraint_pins_.empty()) {
+    // Clear the fanout of all of the pins before seeding any of them
+    // so the seeds are not cleared by another pin in their fanin.
+    PinSeq seed_pins;
+    PinSet cleared;
+    PinSet::Iterator pin_iter(invalid_constraint_pins_);
+    while (pin_iter.hasNext()) {
+      Pin *pin = pin_iter.next();
+      PinSeq leaf_pins;
+      constraintLeafPins(pin, leaf_pins);
+      for (auto leaf_pin : leaf_pins) {
+	clearConstantFanout(leaf_pin, cleared);
+	seed_pins.push_back(leaf_pin);
+      }
+    }
+    invalid_constraint_pins_.clear();
+
+    for (auto pin : seed_pins) {
+      LogicValue value;
+      bool exists;
+      constraintValue(pin, value, exists);
+      if (!exists && network_->isLoad(pin))
+	// Value from the driver.
+	invalid_load_pins_.insert(pin);
+    }
+    // Constraints inside the cleared fanout also need to be restored.
+    PinSet::Iterator cleared_iter(cleared);
+    while (cleared_iter.hasNext()) {
+      Pin *pin = cleared_iter.next();
+      LogicValue value;
+      bool exists;
+      constraintValue(pin, value, exists);
+      if (exists)
+	setPinValue(pin, value, true);
+    }
+  }
+}
+
+// Clear the propagated values in the fanout of pin that depend on
+// the value of pin.  The instances of the cleared pins are
+// evaluated again to find the values that do not depend on it.
+void
+Sim::clearConstantFanout(Pin *pin,
+			 // Return value.
+			 PinSet &cleared)
+{
+  PinSeq pins;
+  pins.push_back(pin);
+  while (!pins.empty()) {
+    Pin *pin1 = pins.back();
+    pins.pop_back();
+    if (!cleared.hasKey(pin1)) {
+      cleared.insert(pin1);
+      bool has_value = logicValue(pin1) != LogicValue::unknown;
+      debugPrint1(debug_, "sim", 3, "clear %s\n",
+		  network_->pathName(pin1));
+      Vertex *vertex, *bidirect_drvr_vertex;
+      graph_->pinVertices(pin1, vertex, bidirect_drvr_vertex);
+      if (vertex)
+	setSimValue(vertex, LogicValue::unknown);
+      if (bidirect_drvr_vertex)
+	setSimValue(bidirect_drvr_vertex, LogicValue::unknown);
+      Instance *inst = network_->instance(pin1);
+      invalid_insts_.insert(inst);
+      instances_to_annotate_.insert(inst);
+      if (has_value) {
+	if (network_->direction(pin1)->isAnyInput()) {
+	  InstancePinIterator *out_iter = network_->pinIterator(inst);
+	  while (out_iter->hasNext()) {
+	    Pin *out_pin = out_iter->next();
+	    if (network_->direction(out_pin)->isAnyOutput()
+		&& !const_func_pins_.hasKey(out_pin)
+		&& logicValue(out_pin) != LogicValue::unknown)
+	      pins.push_back(out_pin);
+	  }
+	  delete out_iter;
+	}
+	if (network_->isDriver(pin1)) {
+	  PinConnectedPinIterator *load_iter =
+	    network_->connectedPinIterator(pin1);
+	  while (load_iter->hasNext()) {
+	    Pin *load_pin = load_iter->next();
+	    if (load_pin != pin1
+		&& network_->isLoad(load_pin))
+	      pins.push_back(load_pin);
+	  }
+	  delete load_iter;
+	}
+      }
+    }
+  }
+}
+
 void
 Sim::propagateToInvalidLoads()
 {
@@ -624,6 +774,55 @@ Sim::constantsInvalid()
 {
   valid_ = false;
   incremental_ = false;
+  if (case_modes_)
+    case_modes_->valuesInvalid();
+}
+
+void
+Sim::caseAnalysisInvalid()
+{
+  valid_ = false;
+  incremental_ = false;
+}
+
+bool
+Sim::caseAnalysisChanged(Pin *pin)
+{
+  valid_ = false;
+  if (incremental_) {
+    invalid_constraint_pins_.insert(pin);
+    return true;
+  }
+  else
+    return false;
+}
+
+bool
+Sim::logicValueChanged(Pin *pin)
+{
+  // The case modes share the logic values.
+  if (case_modes_)
+    case_modes_->valuesInvalid();
+  return caseAnalysisChanged(pin);
+}
+
+bool
+Sim::setCaseMode(int mode)
+{
+  if (valid_) {
+    Stats stats(debug_, phase_stats_);
+    SimModes *modes = caseModes();
+    modes->ensurePropagated();
+    instances_to_annotate_.clear();
+    setModeValues(modes, mode);
+    annotateGraphEdges();
+    stats.report("Switch case mode");
+    return true;
+  }
+  else {
+    incremental_ = false;
+    return false;
+  }
 }
 
 void
@@ -665,6 +864,7 @@ Sim::deleteInstanceBefore(Instance *inst)
 {
   instances_with_const_pins_.erase(inst);
   invalid_insts_.erase(inst);
+  modesNetlistChanged();
 }
 
 void
@@ -672,6 +872,7 @@ Sim::makePinAfter(Pin *pin)
 {
   // Incrementally update const_func_pins_.
   recordConstPinFunc(pin);
+  modesNetlistChanged();
 }
 
 void
@@ -681,7 +882,11 @@ Sim::deletePinBefore(Pin *pin)
   const_func_pins_.erase(pin);
   invalid_load_pins_.erase(pin);
   invalid_drvr_pins_.erase(pin);
+  invalid_constraint_pins_.erase(pin);
   invalid_insts_.insert(network_->instance(pin));
+  if (case_modes_)
+    case_modes_->deletePinBefore(pin);
+  modesNetlistChanged();
 }
 
 void
@@ -689,6 +894,7 @@ Sim::connectPinAfter(Pin *pin)
 {
   // Incrementally update const_func_pins_.
   recordConstPinFunc(pin);
+  modesNetlistChanged();
   if (incremental_) {
     if (network_->isLoad(pin))
       invalid_load_pins_.insert(pin);
@@ -704,6 +910,7 @@ Sim::disconnectPinBefore(Pin *pin)
   if (incremental_
       && network_->isLoad(pin))
     removePropagatedValue(pin);
+  modesNetlistChanged();
 }
 
 void
@@ -718,6 +925,16 @@ Sim::pinSetFuncAfter(Pin *pin)
   // Incrementally update const_func_pins_.
   const_func_pins_.erase(pin);
   recordConstPinFunc(pin);
+  modesNetlistChanged();
+}
+
+void
+Sim::modesNetlistChanged()
+{
+  if (parallel_modes_)
+    parallel_modes_->netlistChanged();
+  if (case_modes_)
+    case_modes_->netlistChanged();
 }
 
 void
@@ -743,6 +960,59 @@ Sim::propagateConstants()
   }
 }
 
+// Propagate the constants for the current constraints with SimModes
+// and copy them to the graph vertices.
+void
+Sim::propagateConstantsParallel()
+{
+  if (parallel_modes_ == nullptr) {
+    parallel_modes_ = new SimModes(this);
+    parallel_modes_->addMode(nullptr);
+  }
+  else {
+    parallel_modes_->copyState(this);
+    parallel_modes_->valuesInvalid();
+  }
+  parallel_modes_->ensurePropagated();
+  setModeValues(parallel_modes_, 0);
+}
+
+// Copy the propagated values of mode to the graph vertices that
+// have different values.
+void
+Sim::setModeValues(SimModes *modes,
+		   int mode)
+{
+  size_t vertex_count = modes->vertexCount();
+  for (size_t i = 0; i < vertex_count; i++) {
+    Vertex *vertex = modes->vertex(i);
+    const Pin *pin = vertex->pin();
+    LogicValue propagated_value;
+    if (modes->constraintConflict(i, mode, propagated_value)) {
+      LogicValue constraint_value;
+      bool exists;
+      sdc_->caseLogicValue(pin, constraint_value, exists);
+      if (!exists)
+	sdc_->logicValue(pin, constraint_value, exists);
+      report_->warn("propagated logic value %c differs from constraint value of %c on pin %s.\n",
+		    logicValueString(propagated_value),
+		    logicValueString(constraint_value),
+		    sdc_network_->pathName(pin));
+    }
+    LogicValue value = modes->logicValue(i, mode);
+    if (value != vertex->simValue()) {
+      setSimValue(vertex, value);
+      Instance *inst = network_->instance(pin);
+      if (logicValueZeroOne(value))
+	instances_with_const_pins_.insert(inst);
+      instances_to_annotate_.insert(inst);
+    }
+  }
+  // Constraint values that are not zero/one (rise/fall).
+  setConstraintConstPins(sdc_->logicValues(), false);
+  setConstraintConstPins(sdc_->caseLogicValues(), false);
+}
+
 void
 Sim::setConstraintConstPins(LogicValueMap *value_map,
 			    bool propagate)
@@ -755,23 +1025,46 @@ Sim::setConstraintConstPins(LogicValueMap *value_map,
     debugPrint2(debug_, "sim", 2, "case pin %s = %c\n",
 		network_->pathName(pin),
 		logicValueString(value));
-    if (network_->isHierarchical(pin)) {
-      // Set the logic value on pins inside the instance of a hierarchical pin.
-      bool pin_is_output = network_->direction(pin)->isAnyOutput();
-      PinConnectedPinIterator *pin_iter=network_->connectedPinIterator(pin);
-      while (pin_iter->hasNext()) {
-	Pin *pin1 = pin_iter->next();
-	if (network_->isLeaf(pin1)
-	    && network_->direction(pin1)->isAnyInput()
-	    && ((pin_is_output && !network_->isInside(pin1, pin))
-		|| (!pin_is_output && network_->isInside(pin1, pin))))
-	  setPinValue(pin1, value, propagate);
-      }
-      delete pin_iter;
+    PinSeq leaf_pins;
+    constraintLeafPins(pin, leaf_pins);
+    for (auto leaf_pin : leaf_pins)
+      setPinValue(leaf_pin, value, propagate);
+  }
+}
+
+// Pins that get the logic value of a constraint on pin.
+void
+Sim::constraintLeafPins(const Pin *pin,
+			// Return value.
+			PinSeq &leaf_pins) const
+{
+  if (network_->isHierarchical(pin)) {
+    // Set the logic value on pins inside the instance of a hierarchical pin.
+    bool pin_is_output = network_->direction(pin)->isAnyOutput();
+    PinConnectedPinIterator *pin_iter=network_->connectedPinIterator(pin);
+    while (pin_iter->hasNext()) {
+      Pin *pin1 = pin_iter->next();
+      if (network_->isLeaf(pin1)
+	  && network_->direction(pin1)->isAnyInput()
+	  && ((pin_is_output && !network_->isInside(pin1, pin))
+	      || (!pin_is_output && network_->isInside(pin1, pin))))
+	leaf_pins.push_back(pin1);
     }
-    else
-      setPinValue(pin, value, propagate);
+    delete pin_iter;
   }
+  else
+    leaf_pins.push_back(const_cast<Pin*>(pin));
+}
+
+void
+Sim::constraintValue(const Pin *pin,
+		     // Return values.
+		     LogicValue &value,
+		     bool &exists) const
+{
+  sdc_->caseLogicValue(pin, value, exists);
+  if (!exists)
+    sdc_->logicValue(pin, value, exists);
 }
 
 // Propagate constants from outputs with constant functions
@@ -906,10 +1199,11 @@ Sim::evalInstance(const Instance *inst)
       if (port) {
 	FuncExpr *expr = port->function();
 	if (expr) {
-	  LogicValue value = evalExpr(expr, inst);
+	  LogicValue value = evalFunc(expr, port->functionTruthTable(), inst);
 	  FuncExpr *tri_en_expr = port->tristateEnable();
 	  if (tri_en_expr == nullptr
-	      || evalExpr(tri_en_expr, inst) == LogicValue::one) {
+	      || evalFunc(tri_en_expr, port->tristateEnableTruthTable(),
+			  inst) == LogicValue::one) {
 	    debugPrint3(debug_, "sim", 2, " %s %s = %c\n",
 			port->name(),
 			expr->asString(),
@@ -959,20 +1253,20 @@ Sim::functionSense(const Instance *inst,
 		// Tristate is disabled.
 		return TimingSense::none;
 	      else
-		return functionSense(func, from_pin, inst);
+		return portFunctionSense(to_port, from_pin, inst);
 	    }
 	  }
 	  else {
 	    // Missing tristate enable function.
 	    if (func->hasPort(from_port))
 	      // from_pin is an input to the to_pin function.
-	      return functionSense(func, from_pin, inst);
+	      return portFunctionSense(to_port, from_pin, inst);
 	  }
 	}
 	else {
 	  if (func->hasPort(from_port))
 	    // from_pin is an input to the to_pin function.
-	    return functionSense(func, from_pin, inst);
+	    return portFunctionSense(to_port, from_pin, inst);
 	}
       }
     }
@@ -980,6 +1274,32 @@ Sim::functionSense(const Instance *inst,
   }
 }
 
+// Timing sense of the to_port function with its truth table if it
+// has one.
+TimingSense
+Sim::portFunctionSense(const LibertyPort *to_port,
+		       const Pin *from_pin,
+		       const Instance *inst)
+{
+  const FuncTruthTable *table = to_port->functionTruthTable();
+  if (table) {
+    LibertyPort *from_port = network_->libertyPort(from_pin);
+    LogicValue input_values[FuncTruthTable::max_inputs];
+    int from_index = -1;
+    for (int i = 0; i < table->inputCount(); i++) {
+      LibertyPort *input = table->input(i);
+      if (input == from_port)
+	from_index = i;
+      Pin *pin = network_->findPin(inst, input);
+      // Internal ports don't have instance pins.
+      input_values[i] = pin ? logicValue(pin) : LogicValue::unknown;
+    }
+    if (from_index >= 0)
+      return table->sense(from_index, input_values);
+  }
+  return functionSense(to_port->function(), from_pin, inst);
+}
+
 LogicValue
 Sim::logicValue(const Pin *pin) const
 {
@@ -1053,19 +1373,42 @@ Sim::clearInstSimValues(const Instance *inst)
 }
 
 // Annotate graph edges disabled by constant values.
+// The edge annotations of the instances are found on multiple threads.
+// The edges are updated and the observer is notified on this one.
 void
 Sim::annotateGraphEdges()
 {
+  ConstInstanceSeq insts;
   InstanceSet::Iterator inst_iter(instances_to_annotate_);
-  while (inst_iter.hasNext()) {
-    const Instance *inst = inst_iter.next();
-    annotateVertexEdges(inst, true);
-  }
+  while (inst_iter.hasNext())
+    insts.push_back(inst_iter.next());
+  int thread_count = thread_pool_ ? thread_pool_->threadCount() : 1;
+  std::vector<EdgeAnnotationSeq> annotations(thread_count);
+  forEachChunk(insts.size(), thread_pool_,
+	       [&] (size_t begin, size_t end, int thread_index) {
+		 for (size_t i = begin; i < end; i++)
+		   findEdgeAnnotations(insts[i], true,
+				       annotations[thread_index]);
+	       });
+  for (auto &thread_annotations : annotations)
+    setEdgeAnnotations(thread_annotations);
 }
 
 void
 Sim::annotateVertexEdges(const Instance *inst,
 			 bool annotate)
+{
+  EdgeAnnotationSeq annotations;
+  findEdgeAnnotations(inst, annotate, annotations);
+  setEdgeAnnotations(annotations);
+}
+
+// Find the edges of inst with annotations that change.
+void
+Sim::findEdgeAnnotations(const Instance *inst,
+			 bool annotate,
+			 // Return value.
+			 EdgeAnnotationSeq &annotations)
 {
   debugPrint2(debug_, "sim", 4, "annotate %s %s\n",
 	      network_->pathName(inst),
@@ -1076,20 +1419,22 @@ Sim::annotateVertexEdges(const Instance *inst,
     Vertex *vertex, *bidirect_drvr_vertex;
     graph_->pinVertices(pin, vertex, bidirect_drvr_vertex);
     if (vertex)
-      annotateVertexEdges(inst, pin, vertex, annotate);
+      findEdgeAnnotations(inst, pin, vertex, annotate, annotations);
     if (bidirect_drvr_vertex)
-      annotateVertexEdges(inst, pin, bidirect_drvr_vertex, annotate);
+      findEdgeAnnotations(inst, pin, bidirect_drvr_vertex, annotate,
+			  annotations);
   }
   delete pin_iter;
 }
 
 void
-Sim::annotateVertexEdges(const Instance *inst,
+Sim::findEdgeAnnotations(const Instance *inst,
 			 const Pin *pin,
 			 Vertex *vertex,
-			 bool annotate)
+			 bool annotate,
+			 // Return value.
+			 EdgeAnnotationSeq &annotations)
 {
-  bool fanin_disables_changed = false;
   VertexInEdgeIterator edge_iter(vertex, graph_);
   while (edge_iter.hasNext()) {
     Edge *edge = edge_iter.next();
@@ -1115,23 +1460,30 @@ Sim::annotateVertexEdges(const Instance *inst,
 	    || isTestDisabled(inst, from_pin, pin,
 			      network_, sim_);
       }
-      bool disables_changed = false;
-      if (sense != edge->simTimingSense()) {
-	edge->setSimTimingSense(sense);
-	disables_changed = true;
-	fanin_disables_changed = true;
-      }
-      if (is_disabled_cond != edge->isDisabledCond()) {
-	edge->setIsDisabledCond(is_disabled_cond);
-	disables_changed = true;
-	fanin_disables_changed = true;
-      }
-      if (observer_ && disables_changed)
-	observer_->fanoutEdgesChangeAfter(from_vertex);
+      if (sense != edge->simTimingSense()
+	  || is_disabled_cond != edge->isDisabledCond())
+	annotations.push_back(EdgeAnnotation(edge, sense, is_disabled_cond));
+    }
+  }
+}
+
+// Annotations for the in edges of a vertex are adjacent.
+void
+Sim::setEdgeAnnotations(const EdgeAnnotationSeq &annotations)
+{
+  Vertex *prev_vertex = nullptr;
+  for (const EdgeAnnotation &annotation : annotations) {
+    Edge *edge = annotation.edge();
+    edge->setSimTimingSense(annotation.sense());
+    edge->setIsDisabledCond(annotation.isDisabledCond());
+    if (observer_) {
+      Vertex *to_vertex = edge->to(graph_);
+      observer_->fanoutEdgesChangeAfter(edge->from(graph_));
+      if (to_vertex != prev_vertex)
+	observer_->faninEdgesChangeAfter(to_vertex);
+      prev_vertex = to_vertex;
     }
   }
-  if (observer_ && fanin_disables_changed)
-    observer_->faninEdgesChangeAfter(vertex);
 }
 
 bool
@@ -18,12 +18,14 @@
 #define STA_SIM_H
 
 #include <queue>
+#include <vector>
 #include <mutex>
 #include "StaConfig.hh"  // CUDD
 #include "DisallowCopyAssign.hh"
 #include "Map.hh"
 #include "StaState.hh"
 #include "NetworkClass.hh"
+#include "LibertyClass.hh"
 #include "GraphClass.hh"
 #include "SdcClass.hh"
 
@@ -33,11 +35,35 @@ struct DdManager;
 namespace sta {
 
 class SimObserver;
+class SimModes;
 
 typedef Map<const Pin*, LogicValue> PinValueMap;
 typedef std::queue<const Instance*> EvalQueue;
 typedef Map<const char*, DdNode*, CharPtrLess> BddSymbolTable;
 
+// Timing sense and cond disable of an edge from constant values.
+class EdgeAnnotation
+{
+public:
+  EdgeAnnotation(Edge *edge,
+		 TimingSense sense,
+		 bool is_disabled_cond) :
+    edge_(edge),
+    sense_(sense),
+    is_disabled_cond_(is_disabled_cond)
+  {}
+  Edge *edge() const { return edge_; }
+  TimingSense sense() const { return sense_; }
+  bool isDisabledCond() const { return is_disabled_cond_; }
+
+private:
+  Edge *edge_;
+  TimingSense sense_;
+  bool is_disabled_cond_;
+};
+
+typedef std::vector<EdgeAnnotation> EdgeAnnotationSeq;
+
 // Propagate constants from constraints and netlist tie high/low
 // connections thru gates.
 class Sim : public StaState
@@ -49,9 +75,40 @@ public:
   // Set the observer for simulation value changes.
   void setObserver(SimObserver *observer);
   void ensureConstantsPropagated();
+  bool constantsValid() const { return valid_; }
   void constantsInvalid();
+  // set_case_analysis values changed.  The case modes have their own
+  // copies of the case values so they are still valid.
+  void caseAnalysisInvalid();
+  // The set_case_analysis value of pin changed.  Only the constants
+  // in the fanout of the pin are propagated again and the observer is
+  // notified of the vertices and edges that change.  Returns false
+  // when there are no current values to update so the constants are
+  // propagated again.
+  bool caseAnalysisChanged(Pin *pin);
+  // The set_logic_zero/one/dc value of pin changed (see
+  // caseAnalysisChanged).
+  bool logicValueChanged(Pin *pin);
+  // Update the constants for the set_case_analysis values of case
+  // mode from the values caseModes() propagated for all of the modes.
+  // Only the vertices with values that differ from the current mode
+  // and the edges of their instances change, and the observer is
+  // notified of each change.  The sdc set_case_analysis values must
+  // already be those of the mode.  Returns false when there are no
+  // current values to update so the constants are propagated again.
+  bool setCaseMode(int mode);
+  // Propagate constants level by level on multiple threads
+  // instead of pin by pin when the constants are not incremental.
+  bool parallelPropagation() const { return parallel_propagation_; }
+  void setParallelPropagation(bool enable);
+  // set_case_analysis scenarios propagated together.
+  SimModes *caseModes();
   LogicValue evalExpr(const FuncExpr *expr,
 		      const Instance *inst) const;
+  // Evaluate expr with its truth table if it has one.
+  LogicValue evalFunc(const FuncExpr *expr,
+		      const FuncTruthTable *table,
+		      const Instance *inst) const;
   LogicValue logicValue(const Pin *pin) const;
   bool logicZeroOne(const Pin *pin) const;
   // Timing sense for the function between from_pin and to_pin
@@ -73,7 +130,21 @@ protected:
   void recordConstPinFunc(Pin *pin);
   virtual void seedConstants();
   void seedInvalidConstants();
+  void seedInvalidConstraintPins();
+  void clearConstantFanout(Pin *pin,
+			   // Return value.
+			   PinSet &cleared);
+  void constraintLeafPins(const Pin *pin,
+			  // Return value.
+			  PinSeq &leaf_pins) const;
+  void constraintValue(const Pin *pin,
+		       // Return values.
+		       LogicValue &value,
+		       bool &exists) const;
   void propagateConstants();
+  void propagateConstantsParallel();
+  void setModeValues(SimModes *modes,
+		     int mode);
   void setConstraintConstPins(LogicValueMap *pin_value_map,
 			      bool propagate);
   void setConstFuncPins(bool propagate);
@@ -86,6 +157,9 @@ protected:
   TimingSense functionSense(const FuncExpr *expr,
 			    const Pin *input_pin,
 			    const Instance *inst);
+  TimingSense portFunctionSense(const LibertyPort *to_port,
+				const Pin *from_pin,
+				const Instance *inst);
   void functionSense(const FuncExpr *expr,
 		     const Pin *input_pin,
 		     const Instance *inst,
@@ -96,11 +170,18 @@ protected:
   virtual void clearInstSimValues(const Instance *inst);
   void annotateGraphEdges();
   void annotateVertexEdges(const Instance *inst,
+			   bool annotate);
+  void findEdgeAnnotations(const Instance *inst,
+			   bool annotate,
+			   // Return value.
+			   EdgeAnnotationSeq &annotations);
+  void findEdgeAnnotations(const Instance *inst,
 			   const Pin *pin,
 			   Vertex *vertex,
-			   bool annotate);
-  void annotateVertexEdges(const Instance *inst,
-			   bool annotate);
+			   bool annotate,
+			   // Return value.
+			   EdgeAnnotationSeq &annotations);
+  void setEdgeAnnotations(const EdgeAnnotationSeq &annotations);
   void removePropagatedValue(const Pin *pin);
   void propagateFromInvalidDrvrsToLoads();
   void propagateToInvalidLoads();
@@ -108,10 +189,16 @@ protected:
 			   Pin *load_pin);
   void setSimValue(Vertex *vertex,
 		   LogicValue value);
+  void modesNetlistChanged();
 
   SimObserver *observer_;
   bool valid_;
   bool incremental_;
+  bool parallel_propagation_;
+  // Mode for the current set_case_analysis values used by
+  // parallel propagation.
+  SimModes *parallel_modes_;
+  SimModes *case_modes_;
   // Cache of pins that have constant functions (tie high and tie low
   // cell instances).
   PinSet const_func_pins_;
@@ -122,6 +209,8 @@ protected:
   PinSet invalid_drvr_pins_;
   // Load pins that waiting for the driver constant to propagate.
   PinSet invalid_load_pins_;
+  // Pins with set_case_analysis or set_logic values that changed.
+  PinSet invalid_constraint_pins_;
   EvalQueue eval_queue_;
   // Instances with constant pin values for annotateVertexEdges.
   InstanceSet instances_with_const_pins_;
@@ -0,0 +1,718 @@
+// OpenSTA, Static Timing Analyzer
+// Copyright (c) 2019, Parallax Software, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#include "Machine.hh"
+#include "Report.hh"
+#include "Debug.hh"
+#include "Stats.hh"
+#include "ThreadForEach.hh"
+#include "PortDirection.hh"
+#include "FuncExpr.hh"
+#include "Liberty.hh"
+#include "Network.hh"
+#include "Sdc.hh"
+#include "Graph.hh"
+#include "SimModes.hh"
+
+namespace sta {
+
+// Levels smaller than this are evaluated by the calling thread.
+static const size_t sim_modes_parallel_level_min = 256;
+
+SimModeConstraint::SimModeConstraint() :
+  constrained_(0),
+  constraint_one_(0),
+  constraint_zero_(0),
+  seed_one_(0),
+  seed_zero_(0),
+  conflict_one_(0),
+  conflict_zero_(0)
+{
+}
+
+SimModes::SimModes(StaState *sta) :
+  StaState(sta),
+  levels_valid_(false),
+  values_valid_(false),
+  loops_begin_(0)
+{
+}
+
+SimModes::~SimModes()
+{
+  modes_.deleteContentsClear();
+}
+
+void
+SimModes::clear()
+{
+  clearModes();
+  netlistChanged();
+}
+
+void
+SimModes::netlistChanged()
+{
+  levels_valid_ = false;
+  values_valid_ = false;
+  nodes_.clear();
+  vertex_nodes_.clear();
+  inputs_.clear();
+  input_ports_.clear();
+  level_order_.clear();
+  level_begins_.clear();
+  ones_.clear();
+  zeros_.clear();
+  node_constraints_.clear();
+  constraints_.clear();
+}
+
+void
+SimModes::valuesInvalid()
+{
+  values_valid_ = false;
+}
+
+int
+SimModes::addMode(const LogicValueMap *case_values)
+{
+  if (modes_.size() == max_modes)
+    report_->error("maximum of %d case analysis modes exceeded.\n",
+		   max_modes);
+  modes_.push_back(case_values ? new LogicValueMap(*case_values) : nullptr);
+  values_valid_ = false;
+  return modes_.size() - 1;
+}
+
+void
+SimModes::clearModes()
+{
+  modes_.deleteContentsClear();
+  values_valid_ = false;
+}
+
+void
+SimModes::deletePinBefore(const Pin *pin)
+{
+  for (LogicValueMap *case_values : modes_) {
+    if (case_values)
+      case_values->erase(pin);
+  }
+  values_valid_ = false;
+}
+
+SimModeBits
+SimModes::allModes() const
+{
+  size_t mode_count = modes_.size();
+  return (mode_count == max_modes)
+    ? ~SimModeBits(0)
+    : (SimModeBits(1) << mode_count) - 1;
+}
+
+////////////////////////////////////////////////////////////////
+
+void
+SimModes::ensureLevelized()
+{
+  if (!levels_valid_) {
+    Stats stats(debug_, phase_stats_);
+    makeNodes();
+    levelize();
+    levels_valid_ = true;
+    stats.report("Levelize modes");
+  }
+}
+
+void
+SimModes::makeNodes()
+{
+  netlistChanged();
+  VertexIterator vertex_iter(graph_);
+  while (vertex_iter.hasNext()) {
+    Vertex *vertex = vertex_iter.next();
+    vertex_nodes_[vertex] = nodes_.size();
+    SimModeNode node;
+    node.vertex_ = vertex;
+    nodes_.push_back(node);
+  }
+  for (SimModeNode &node : nodes_)
+    makeNode(node.vertex_, node);
+}
+
+void
+SimModes::makeNode(Vertex *vertex,
+		   SimModeNode &node)
+{
+  node.type_ = SimModeNodeType::source;
+  node.input_begin_ = inputs_.size();
+  node.input_count_ = 0;
+  node.tri_enable_input_count_ = 0;
+  node.func_ = nullptr;
+  node.func_table_ = nullptr;
+  node.tri_enable_ = nullptr;
+  node.tri_enable_table_ = nullptr;
+
+  // Loads take the value of the net drivers.
+  VertexInEdgeIterator edge_iter(vertex, graph_);
+  while (edge_iter.hasNext()) {
+    Edge *edge = edge_iter.next();
+    if (edge->isWire()) {
+      Vertex *drvr_vertex = edge->from(graph_);
+      inputs_.push_back(vertex_nodes_[drvr_vertex]);
+      input_ports_.push_back(nullptr);
+      node.input_count_++;
+    }
+  }
+  if (node.input_count_ > 0)
+    node.type_ = SimModeNodeType::load;
+  else {
+    const Pin *pin = vertex->pin();
+    PortDirection *dir = network_->direction(pin);
+    if (network_->isLeaf(pin)
+	&& (vertex->isBidirectDriver()
+	    || (dir->isAnyOutput() && !dir->isBidirect()))) {
+      LibertyPort *port = network_->libertyPort(pin);
+      if (port && port->function()) {
+	const Instance *inst = network_->instance(pin);
+	node.type_ = SimModeNodeType::func;
+	node.func_ = port->function();
+	node.func_table_ = port->functionTruthTable();
+	node.input_count_ = makeFuncInputs(inst, node.func_, node.func_table_);
+	node.tri_enable_ = port->tristateEnable();
+	if (node.tri_enable_) {
+	  node.tri_enable_table_ = port->tristateEnableTruthTable();
+	  node.tri_enable_input_count_ = makeFuncInputs(inst, node.tri_enable_,
+							node.tri_enable_table_);
+	}
+      }
+    }
+  }
+}
+
+// The inputs of a truth table are in table input order.
+unsigned
+SimModes::makeFuncInputs(const Instance *inst,
+			 FuncExpr *expr,
+			 const FuncTruthTable *table)
+{
+  unsigned input_count = 0;
+  if (table) {
+    for (int i = 0; i < table->inputCount(); i++) {
+      LibertyPort *port = table->input(i);
+      inputs_.push_back(inputNode(inst, port));
+      input_ports_.push_back(port);
+      input_count++;
+    }
+  }
+  else {
+    FuncExprPortIterator port_iter(expr);
+    while (port_iter.hasNext()) {
+      LibertyPort *port = port_iter.next();
+      inputs_.push_back(inputNode(inst, port));
+      input_ports_.push_back(port);
+      input_count++;
+    }
+  }
+  return input_count;
+}
+
+int
+SimModes::inputNode(const Instance *inst,
+		    LibertyPort *port) const
+{
+  Pin *pin = network_->findPin(inst, port);
+  // Internal ports don't have instance pins.
+  if (pin) {
+    Vertex *vertex = graph_->pinLoadVertex(pin);
+    if (vertex) {
+      auto node_iter = vertex_nodes_.find(vertex);
+      if (node_iter != vertex_nodes_.end())
+	return node_iter->second;
+    }
+  }
+  return -1;
+}
+
+// Levelize the nodes by their inputs rather than the timing arcs so
+// that every node follows the nodes it is evaluated from.
+// Levelize (graph levels) cannot be used because it depends on the
+// constants already being propagated.
+void
+SimModes::levelize()
+{
+  size_t node_count = nodes_.size();
+  Vector<unsigned> fanin_count(node_count, 0);
+  Vector<size_t> fanout_begins(node_count + 1, 0);
+  for (size_t i = 0; i < node_count; i++) {
+    const SimModeNode &node = nodes_[i];
+    size_t input_end = node.input_begin_ + node.input_count_
+      + node.tri_enable_input_count_;
+    for (size_t k = node.input_begin_; k < input_end; k++) {
+      int input = inputs_[k];
+      if (input >= 0) {
+	fanin_count[i]++;
+	fanout_begins[input + 1]++;
+      }
+    }
+  }
+  for (size_t i = 0; i < node_count; i++)
+    fanout_begins[i + 1] += fanout_begins[i];
+  Vector<size_t> fanouts(fanout_begins[node_count]);
+  Vector<size_t> fanout_ends(fanout_begins);
+  for (size_t i = 0; i < node_count; i++) {
+    const SimModeNode &node = nodes_[i];
+    size_t input_end = node.input_begin_ + node.input_count_
+      + node.tri_enable_input_count_;
+    for (size_t k = node.input_begin_; k < input_end; k++) {
+      int input = inputs_[k];
+      if (input >= 0)
+	fanouts[fanout_ends[input]++] = i;
+    }
+  }
+
+  level_order_.reserve(node_count);
+  for (size_t i = 0; i < node_count; i++) {
+    if (fanin_count[i] == 0)
+      level_order_.push_back(i);
+  }
+  size_t level_begin = 0;
+  while (level_begin < level_order_.size()) {
+    size_t level_end = level_order_.size();
+    level_begins_.push_back(level_begin);
+    for (size_t k = level_begin; k < level_end; k++) {
+      size_t index = level_order_[k];
+      for (size_t f = fanout_begins[index]; f < fanout_begins[index + 1]; f++) {
+	size_t fanout = fanouts[f];
+	if (--fanin_count[fanout] == 0)
+	  level_order_.push_back(fanout);
+      }
+    }
+    level_begin = level_end;
+  }
+  loops_begin_ = level_order_.size();
+  level_begins_.push_back(loops_begin_);
+  for (size_t i = 0; i < node_count; i++) {
+    if (fanin_count[i] > 0)
+      level_order_.push_back(i);
+  }
+  debugPrint3(debug_, "sim_modes", 1, "%zu nodes %zu levels %zu in loops\n",
+	      node_count,
+	      level_begins_.size() - 1,
+	      node_count - loops_begin_);
+}
+
+////////////////////////////////////////////////////////////////
+
+void
+SimModes::ensurePropagated()
+{
+  if (!values_valid_) {
+    ensureLevelized();
+    propagate();
+    values_valid_ = true;
+  }
+}
+
+void
+SimModes::propagate()
+{
+  Stats stats(debug_, phase_stats_);
+  size_t node_count = nodes_.size();
+  ones_.assign(node_count, 0);
+  zeros_.assign(node_count, 0);
+  node_constraints_.assign(node_count, -1);
+  constraints_.clear();
+
+  SimModeBits all_modes = allModes();
+  seedNetworkConstants(all_modes);
+  // set_logic_zero/one/dc values apply to all modes.
+  setConstraints(sdc_->logicValues(), all_modes);
+  // Case analysis values override logic values.
+  for (size_t mode = 0; mode < modes_.size(); mode++) {
+    LogicValueMap *case_values = modes_[mode];
+    setConstraints(case_values ? case_values : sdc_->caseLogicValues(),
+		   SimModeBits(1) << mode);
+  }
+
+  for (size_t level = 0; level + 1 < level_begins_.size(); level++) {
+    size_t begin = level_begins_[level];
+    size_t count = level_begins_[level + 1] - begin;
+    auto eval_nodes = [&] (size_t chunk_begin,
+			   size_t chunk_end,
+			   int) {
+      for (size_t k = chunk_begin; k < chunk_end; k++)
+	evalNode(level_order_[begin + k]);
+    };
+    if (count < sim_modes_parallel_level_min)
+      eval_nodes(0, count, 0);
+    else
+      forEachChunk(count, thread_pool_, eval_nodes);
+  }
+  evalLoops();
+  stats.report("Propagate modes");
+}
+
+// Loop nodes start unknown and only become constant, so they settle.
+void
+SimModes::evalLoops()
+{
+  bool changed = true;
+  while (changed) {
+    changed = false;
+    for (size_t k = loops_begin_; k < level_order_.size(); k++)
+      changed |= evalNode(level_order_[k]);
+  }
+}
+
+void
+SimModes::seedNetworkConstants(SimModeBits modes)
+{
+  ConstantPinIterator *const_iter = network_->constantPinIterator();
+  while (const_iter->hasNext()) {
+    LogicValue value;
+    Pin *pin;
+    const_iter->next(pin, value);
+    Vertex *vertex, *bidirect_drvr_vertex;
+    graph_->pinVertices(pin, vertex, bidirect_drvr_vertex);
+    Vertex *vertices[2] = {vertex, bidirect_drvr_vertex};
+    for (Vertex *vertex1 : vertices) {
+      if (vertex1) {
+	auto node_iter = vertex_nodes_.find(vertex1);
+	if (node_iter != vertex_nodes_.end()) {
+	  SimModeConstraint &constraint = ensureConstraint(node_iter->second);
+	  if (value == LogicValue::one)
+	    constraint.seed_one_ |= modes;
+	  else if (value == LogicValue::zero)
+	    constraint.seed_zero_ |= modes;
+	}
+      }
+    }
+  }
+  delete const_iter;
+}
+
+void
+SimModes::setConstraints(const LogicValueMap *value_map,
+			 SimModeBits modes)
+{
+  LogicValueMap::ConstIterator value_iter(value_map);
+  while (value_iter.hasNext()) {
+    LogicValue value;
+    const Pin *pin;
+    value_iter.next(pin, value);
+    if (network_->isHierarchical(pin)) {
+      // Set the logic value on pins inside the instance of a hierarchical pin.
+      bool pin_is_output = network_->direction(pin)->isAnyOutput();
+      PinConnectedPinIterator *pin_iter=network_->connectedPinIterator(pin);
+      while (pin_iter->hasNext()) {
+	Pin *pin1 = pin_iter->next();
+	if (network_->isLeaf(pin1)
+	    && network_->direction(pin1)->isAnyInput()
+	    && ((pin_is_output && !network_->isInside(pin1, pin))
+		|| (!pin_is_output && network_->isInside(pin1, pin))))
+	  setPinConstraint(pin1, value, modes);
+      }
+      delete pin_iter;
+    }
+    else
+      setPinConstraint(pin, value, modes);
+  }
+}
+
+void
+SimModes::setPinConstraint(const Pin *pin,
+			   LogicValue value,
+			   SimModeBits modes)
+{
+  Vertex *vertex, *bidirect_drvr_vertex;
+  graph_->pinVertices(pin, vertex, bidirect_drvr_vertex);
+  Vertex *vertices[2] = {vertex, bidirect_drvr_vertex};
+  for (Vertex *vertex1 : vertices) {
+    if (vertex1) {
+      auto node_iter = vertex_nodes_.find(vertex1);
+      if (node_iter != vertex_nodes_.end()) {
+	SimModeConstraint &constraint = ensureConstraint(node_iter->second);
+	constraint.constrained_ |= modes;
+	constraint.constraint_one_ &= ~modes;
+	constraint.constraint_zero_ &= ~modes;
+	if (value == LogicValue::one)
+	  constraint.constraint_one_ |= modes;
+	else if (value == LogicValue::zero)
+	  constraint.constraint_zero_ |= modes;
+      }
+    }
+  }
+}
+
+SimModeConstraint &
+SimModes::ensureConstraint(size_t index)
+{
+  int constraint_index = node_constraints_[index];
+  if (constraint_index < 0) {
+    constraint_index = constraints_.size();
+    constraints_.push_back(SimModeConstraint());
+    node_constraints_[index] = constraint_index;
+  }
+  return constraints_[constraint_index];
+}
+
+const SimModeConstraint *
+SimModes::constraint(size_t index) const
+{
+  int constraint_index = node_constraints_[index];
+  if (constraint_index >= 0)
+    return &constraints_[constraint_index];
+  else
+    return nullptr;
+}
+
+// Inputs are evaluated before the node, so each node is written by
+// exactly one thread and only reads values from lower levels.
+// Returns true if the value changed.
+bool
+SimModes::evalNode(size_t index)
+{
+  const SimModeNode &node = nodes_[index];
+  SimModeBits one = 0;
+  SimModeBits zero = 0;
+  switch (node.type_) {
+  case SimModeNodeType::source:
+    break;
+  case SimModeNodeType::load: {
+    // Drivers with unknown values (disabled tristates) do not
+    // contribute.  Drivers with opposite values make the load unknown.
+    SimModeBits any_one = 0;
+    SimModeBits any_zero = 0;
+    size_t input_end = node.input_begin_ + node.input_count_;
+    for (size_t k = node.input_begin_; k < input_end; k++) {
+      SimModeBits drvr_one, drvr_zero;
+      inputValue(inputs_[k], drvr_one, drvr_zero);
+      any_one |= drvr_one;
+      any_zero |= drvr_zero;
+    }
+    one = any_one & ~any_zero;
+    zero = any_zero & ~any_one;
+    break;
+  }
+  case SimModeNodeType::func: {
+    size_t func_end = node.input_begin_ + node.input_count_;
+    evalFunc(node.input_begin_, func_end, node.func_, node.func_table_,
+	     one, zero);
+    if (node.tri_enable_) {
+      SimModeBits enable_one, enable_zero;
+      evalFunc(func_end, func_end + node.tri_enable_input_count_,
+	       node.tri_enable_, node.tri_enable_table_,
+	       enable_one, enable_zero);
+      // Outputs are only driven when the tristate is enabled.
+      one &= enable_one;
+      zero &= enable_one;
+    }
+    break;
+  }
+  }
+
+  int constraint_index = node_constraints_[index];
+  if (constraint_index >= 0) {
+    SimModeConstraint &constraint = constraints_[constraint_index];
+    SimModeBits seeded = constraint.seed_one_ | constraint.seed_zero_;
+    one = (one & ~seeded) | constraint.seed_one_;
+    zero = (zero & ~seeded) | constraint.seed_zero_;
+    SimModeBits constrained = constraint.constrained_;
+    constraint.conflict_one_ = constrained & one & ~constraint.constraint_one_;
+    constraint.conflict_zero_ = constrained & zero & ~constraint.constraint_zero_;
+    one = (one & ~constrained) | constraint.constraint_one_;
+    zero = (zero & ~constrained) | constraint.constraint_zero_;
+  }
+  bool changed = (one != ones_[index] || zero != zeros_[index]);
+  ones_[index] = one;
+  zeros_[index] = zero;
+  return changed;
+}
+
+void
+SimModes::evalFunc(size_t input_begin,
+		   size_t input_end,
+		   const FuncExpr *expr,
+		   const FuncTruthTable *table,
+		   // Return values.
+		   SimModeBits &one,
+		   SimModeBits &zero) const
+{
+  if (table) {
+    int input_count = table->inputCount();
+    SimModeBits input_ones[FuncTruthTable::max_inputs];
+    SimModeBits input_zeros[FuncTruthTable::max_inputs];
+    for (int i = 0; i < input_count; i++)
+      inputValue(inputs_[input_begin + i], input_ones[i], input_zeros[i]);
+    // A mode is one (zero) if the function is one (zero) for every
+    // minterm that is consistent with its constant inputs.
+    SimModeBits any_one = 0;
+    SimModeBits any_zero = 0;
+    unsigned minterm_count = 1U << input_count;
+    for (unsigned minterm = 0; minterm < minterm_count; minterm++) {
+      SimModeBits consistent = ~SimModeBits(0);
+      for (int i = 0; i < input_count; i++)
+	consistent &= ((minterm >> i) & 1) ? ~input_zeros[i] : ~input_ones[i];
+      if (table->value(minterm))
+	any_one |= consistent;
+      else
+	any_zero |= consistent;
+    }
+    one = any_one & ~any_zero;
+    zero = any_zero & ~any_one;
+  }
+  else
+    evalExpr(input_begin, input_end, expr, one, zero);
+}
+
+void
+SimModes::evalExpr(size_t input_begin,
+		   size_t input_end,
+		   const FuncExpr *expr,
+		   // Return values.
+		   SimModeBits &one,
+		   SimModeBits &zero) const
+{
+  SimModeBits one1, zero1, one2, zero2;
+  switch (expr->op()) {
+  case FuncExpr::op_port: {
+    one = 0;
+    zero = 0;
+    LibertyPort *port = expr->port();
+    for (size_t k = input_begin; k < input_end; k++) {
+      if (input_ports_[k] == port) {
+	inputValue(inputs_[k], one, zero);
+	break;
+      }
+    }
+    break;
+  }
+  case FuncExpr::op_not:
+    evalExpr(input_begin, input_end, expr->left(), one1, zero1);
+    one = zero1;
+    zero = one1;
+    break;
+  case FuncExpr::op_or:
+    evalExpr(input_begin, input_end, expr->left(), one1, zero1);
+    evalExpr(input_begin, input_end, expr->right(), one2, zero2);
+    one = one1 | one2;
+    zero = zero1 & zero2;
+    break;
+  case FuncExpr::op_and:
+    evalExpr(input_begin, input_end, expr->left(), one1, zero1);
+    evalExpr(input_begin, input_end, expr->right(), one2, zero2);
+    one = one1 & one2;
+    zero = zero1 | zero2;
+    break;
+  case FuncExpr::op_xor:
+    evalExpr(input_begin, input_end, expr->left(), one1, zero1);
+    evalExpr(input_begin, input_end, expr->right(), one2, zero2);
+    one = (one1 & zero2) | (zero1 & one2);
+    zero = (one1 & one2) | (zero1 & zero2);
+    break;
+  case FuncExpr::op_one:
+    one = ~SimModeBits(0);
+    zero = 0;
+    break;
+  case FuncExpr::op_zero:
+    one = 0;
+    zero = ~SimModeBits(0);
+    break;
+  }
+}
+
+void
+SimModes::inputValue(int input,
+		     // Return values.
+		     SimModeBits &one,
+		     SimModeBits &zero) const
+{
+  if (input >= 0) {
+    one = ones_[input];
+    zero = zeros_[input];
+  }
+  else {
+    one = 0;
+    zero = 0;
+  }
+}
+
+////////////////////////////////////////////////////////////////
+
+Vertex *
+SimModes::vertex(size_t index) const
+{
+  return nodes_[index].vertex_;
+}
+
+LogicValue
+SimModes::logicValue(size_t index,
+		     int mode) const
+{
+  SimModeBits mode_bit = SimModeBits(1) << mode;
+  if (ones_[index] & mode_bit)
+    return LogicValue::one;
+  else if (zeros_[index] & mode_bit)
+    return LogicValue::zero;
+  else
+    return LogicValue::unknown;
+}
+
+bool
+SimModes::constraintConflict(size_t index,
+			     int mode,
+			     // Return value.
+			     LogicValue &propagated_value) const
+{
+  const SimModeConstraint *constraint = this->constraint(index);
+  if (constraint) {
+    SimModeBits mode_bit = SimModeBits(1) << mode;
+    if (constraint->conflict_one_ & mode_bit) {
+      propagated_value = LogicValue::one;
+      return true;
+    }
+    else if (constraint->conflict_zero_ & mode_bit) {
+      propagated_value = LogicValue::zero;
+      return true;
+    }
+  }
+  return false;
+}
+
+LogicValue
+SimModes::logicValue(const Pin *pin,
+		     int mode)
+{
+  ensurePropagated();
+  Vertex *vertex = graph_->pinLoadVertex(pin);
+  if (vertex) {
+    auto node_iter = vertex_nodes_.find(vertex);
+    if (node_iter != vertex_nodes_.end())
+      return logicValue(node_iter->second, mode);
+  }
+  else if (network_->isHierarchical(pin)) {
+    PinSet *drvrs = network_->drivers(pin);
+    if (drvrs) {
+      PinSet::Iterator drvr_iter(drvrs);
+      if (drvr_iter.hasNext())
+	return logicValue(drvr_iter.next(), mode);
+    }
+  }
+  return LogicValue::unknown;
+}
+
+} // namespace
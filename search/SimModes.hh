@@ -0,0 +1,189 @@
+// OpenSTA, Static Timing Analyzer
+// Copyright (c) 2019, Parallax Software, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#ifndef STA_SIM_MODES_H
+#define STA_SIM_MODES_H
+
+#include "DisallowCopyAssign.hh"
+#include "Vector.hh"
+#include "UnorderedMap.hh"
+#include "StaState.hh"
+#include "LibertyClass.hh"
+#include "NetworkClass.hh"
+#include "GraphClass.hh"
+#include "SdcClass.hh"
+
+namespace sta {
+
+// One bit per mode.
+typedef unsigned long long SimModeBits;
+
+enum class SimModeNodeType { source, load, func };
+
+// Graph vertex and the nodes that determine its value.
+class SimModeNode
+{
+public:
+  Vertex *vertex_;
+  SimModeNodeType type_;
+  // Loads: driver nodes.
+  // Functions: function inputs followed by tristate enable inputs.
+  size_t input_begin_;
+  unsigned input_count_;
+  unsigned tri_enable_input_count_;
+  FuncExpr *func_;
+  const FuncTruthTable *func_table_;
+  FuncExpr *tri_enable_;
+  const FuncTruthTable *tri_enable_table_;
+};
+
+// Constraint and netlist constant values on a node.
+class SimModeConstraint
+{
+public:
+  SimModeConstraint();
+
+  // Modes with a constraint and its zero/one value.
+  // Constrained modes that are neither one nor zero are unknown.
+  SimModeBits constrained_;
+  SimModeBits constraint_one_;
+  SimModeBits constraint_zero_;
+  // Netlist tie high/low values.
+  SimModeBits seed_one_;
+  SimModeBits seed_zero_;
+  // Propagated values in modes where they differ from the constraint.
+  SimModeBits conflict_one_;
+  SimModeBits conflict_zero_;
+};
+
+typedef Vector<SimModeNode> SimModeNodeSeq;
+typedef Vector<SimModeConstraint> SimModeConstraintSeq;
+typedef Vector<SimModeBits> SimModeBitsSeq;
+typedef Vector<LogicValueMap*> LogicValueMapSeq;
+
+// Propagate constants for up to max_modes set_case_analysis scenarios
+// (modes) at once.  Each mode is one bit lane of the per vertex
+// one/zero bit masks.  The graph is levelized by the logic functions
+// once, and then each level is evaluated in parallel for all modes.
+// set_logic_zero/one/dc values and netlist tie high/low connections
+// apply to every mode.
+class SimModes : public StaState
+{
+public:
+  static const int max_modes = sizeof(SimModeBits) * 8;
+
+  explicit SimModes(StaState *sta);
+  virtual ~SimModes();
+  // Delete the modes and the levelized graph.
+  void clear();
+  // The netlist or graph changed, so the graph has to be levelized again.
+  void netlistChanged();
+  // Constraints or netlist constants changed.
+  void valuesInvalid();
+  // Add a mode with a copy of case_values.
+  // With null case_values the mode uses the sdc set_case_analysis
+  // values at the time of propagation.
+  // Returns the mode index.
+  int addMode(const LogicValueMap *case_values);
+  int modeCount() const { return modes_.size(); }
+  // set_case_analysis values of mode.
+  const LogicValueMap *caseValues(int mode) const { return modes_[mode]; }
+  void clearModes();
+  void deletePinBefore(const Pin *pin);
+  void ensurePropagated();
+  LogicValue logicValue(const Pin *pin,
+			int mode);
+
+  // Results by vertex index for ensurePropagated() callers.
+  size_t vertexCount() const { return nodes_.size(); }
+  Vertex *vertex(size_t index) const;
+  LogicValue logicValue(size_t index,
+			int mode) const;
+  // Propagated value that differs from the constraint value in mode.
+  bool constraintConflict(size_t index,
+			  int mode,
+			  // Return value.
+			  LogicValue &propagated_value) const;
+
+protected:
+  void ensureLevelized();
+  void makeNodes();
+  void makeNode(Vertex *vertex,
+		SimModeNode &node);
+  unsigned makeFuncInputs(const Instance *inst,
+			  FuncExpr *expr,
+			  const FuncTruthTable *table);
+  int inputNode(const Instance *inst,
+		LibertyPort *port) const;
+  void levelize();
+  void propagate();
+  void setConstraints(const LogicValueMap *value_map,
+		      SimModeBits modes);
+  void setPinConstraint(const Pin *pin,
+			LogicValue value,
+			SimModeBits modes);
+  void seedNetworkConstants(SimModeBits modes);
+  SimModeBits allModes() const;
+  SimModeConstraint &ensureConstraint(size_t index);
+  void evalLoops();
+  bool evalNode(size_t index);
+  void evalFunc(size_t input_begin,
+		size_t input_end,
+		const FuncExpr *expr,
+		const FuncTruthTable *table,
+		// Return values.
+		SimModeBits &one,
+		SimModeBits &zero) const;
+  void evalExpr(size_t input_begin,
+		size_t input_end,
+		const FuncExpr *expr,
+		// Return values.
+		SimModeBits &one,
+		SimModeBits &zero) const;
+  void inputValue(int input,
+		  // Return values.
+		  SimModeBits &one,
+		  SimModeBits &zero) const;
+  const SimModeConstraint *constraint(size_t index) const;
+
+  LogicValueMapSeq modes_;
+  bool levels_valid_;
+  bool values_valid_;
+  SimModeNodeSeq nodes_;
+  UnorderedMap<const Vertex*, size_t> vertex_nodes_;
+  // Node indices of function inputs and load drivers.
+  // -1 for function inputs without a pin.
+  Vector<int> inputs_;
+  // Function port of each input, null for load drivers.
+  Vector<LibertyPort*> input_ports_;
+  // Node indices in level order.
+  Vector<size_t> level_order_;
+  // Level i is level_order_[level_begins_[i], level_begins_[i+1]).
+  Vector<size_t> level_begins_;
+  // Nodes in combinational loops follow the levels in level_order_.
+  size_t loops_begin_;
+  SimModeBitsSeq ones_;
+  SimModeBitsSeq zeros_;
+  // Index into constraints_ by node, -1 for unconstrained nodes.
+  Vector<int> node_constraints_;
+  SimModeConstraintSeq constraints_;
+
+private:
+  DISALLOW_COPY_AND_ASSIGN(SimModes);
+};
+
+} // namespace
+#endif
@@ -14,26 +14,37 @@
 // You should have received a copy of the GNU General Public License
 // along with this program.  If not, see <https://www.gnu.org/licenses/>.
 
+#include <algorithm>
 #include <limits>
+#include <exception>
+#include <vector>
+#include <thread>
 #include "Machine.hh"
 #include "DisallowCopyAssign.hh"
 #include "ReportTcl.hh"
 #include "Debug.hh"
 #include "Stats.hh"
+#include "MemoryReport.hh"
+#include "StringIntern.hh"
+#include "ThreadPool.hh"
+#include "ThreadForEach.hh"
 #include "Units.hh"
 #include "Fuzzy.hh"
 #include "PortDirection.hh"
 #include "TimingRole.hh"
 #include "TimingArc.hh"
+#include "TableModel.hh"
 #include "FuncExpr.hh"
 #include "EquivCells.hh"
 #include "Liberty.hh"
 #include "LibertyReader.hh"
+#include "LibertyCache.hh"
 #include "Network.hh"
 #include "MakeConcreteNetwork.hh"
 #include "VerilogReader.hh"
 #include "SdcNetwork.hh"
 #include "Graph.hh"
+#include "VertexVisitedBits.hh"
 #include "GraphCmp.hh"
 #include "Levelize.hh"
 #include "Sdc.hh"
@@ -41,11 +52,15 @@
 #include "ExceptionPath.hh"
 #include "MakeConcreteParasitics.hh"
 #include "Parasitics.hh"
+#include "ParasiticsDb.hh"
+#include "PlacementParasitics.hh"
+#include "NetworkDb.hh"
 #include "DelayCalc.hh"
 #include "ArcDelayCalc.hh"
 #include "GraphDelayCalc1.hh"
 #include "DcalcAnalysisPt.hh"
 #include "Sim.hh"
+#include "SimModes.hh"
 #include "ClkInfo.hh"
 #include "Tag.hh"
 #include "TagGroup.hh"
@@ -68,14 +83,30 @@
 #include "SdfWriter.hh"
 #include "Genclks.hh"
 #include "Power.hh"
+#include "ActivityReader.hh"
+#include "TimingCheckpoint.hh"
+#include "DelayAnnotations.hh"
+#include "TimingColumns.hh"
+#include "BoundaryTiming.hh"
+#include "MakeTimingModel.hh"
+#include "ThreadProfile.hh"
+#include "HotVertices.hh"
+#include "PathBasedTiming.hh"
+#include "StaMode.hh"
 #include "Sta.hh"
 
 namespace sta {
 
 using std::min;
+using std::max;
+using std::string;
 
 static const ClockEdge *clk_edge_wildcard = reinterpret_cast<ClockEdge*>(1);
 
+// Bulk delay/slew updates touching more than 1/bulk_invalid_ratio of
+// the vertices invalidate all arrivals.
+static const VertexIndex bulk_invalid_ratio = 4;
+
 static bool
 libertyPortCapsEqual(LibertyPort *port1,
 		     LibertyPort *port2);
@@ -200,6 +231,7 @@ class StaLevelizeObserver : public LevelizeObserver
 public:
   StaLevelizeObserver(Search *search);
   virtual void levelChangedBefore(Vertex *vertex);
+  virtual void levelsInvalid();
 
 private:
   DISALLOW_COPY_AND_ASSIGN(StaLevelizeObserver);
@@ -218,6 +250,49 @@ StaLevelizeObserver::levelChangedBefore(Vertex *vertex)
   search_->levelChangedBefore(vertex);
 }
 
+void
+StaLevelizeObserver::levelsInvalid()
+{
+  search_->levelsInvalid();
+}
+
+////////////////////////////////////////////////////////////////
+
+// Collect the messages from a liberty reader thread so they can be
+// reported in file order when the threads are done.
+class LibertyReadReport : public Report
+{
+public:
+  LibertyReadReport();
+
+protected:
+  virtual size_t printConsole(const char *buffer, size_t length);
+  virtual size_t printErrorConsole(const char *buffer, size_t length);
+
+private:
+  DISALLOW_COPY_AND_ASSIGN(LibertyReadReport);
+};
+
+LibertyReadReport::LibertyReadReport() :
+  Report()
+{
+  redirectStringBegin();
+}
+
+size_t
+LibertyReadReport::printConsole(const char *,
+				size_t length)
+{
+  return length;
+}
+
+size_t
+LibertyReadReport::printErrorConsole(const char *,
+				     size_t length)
+{
+  return length;
+}
+
 ////////////////////////////////////////////////////////////////
 
 void
@@ -243,6 +318,10 @@ deleteAllMemory()
 {
   Sta *sta = Sta::sta();
   if (sta) {
+    // Modes are deleted by their parent.
+    StaMode *mode = dynamic_cast<StaMode*>(sta);
+    if (mode)
+      sta = mode->parent();
     delete sta;
     Sta::setSta(nullptr);
   }
@@ -275,8 +354,11 @@ Sta::Sta() :
   clk_skews_(nullptr),
   report_path_(nullptr),
   power_(nullptr),
+  placement_parasitics_(nullptr),
   link_make_black_boxes_(true),
-  update_genclks_(false)
+  update_genclks_(false),
+  quantized_slews_(false),
+  eco_depth_(0)
 {
 }
 
@@ -285,6 +367,9 @@ Sta::makeComponents()
 {
   makeReport();
   makeDebug();
+  makePhaseStats();
+  makeThreadProfile();
+  makeHotVertices();
   makeUnits();
   makeNetwork();
   makeSdc();
@@ -303,7 +388,7 @@ Sta::makeComponents()
 
   makeObservers();
   // This must follow updateComponentsState.
-  corners_->makeParasiticAnalysisPtsSingle();
+  makeParasiticAnalysisPts();
   setThreadCount(defaultThreadCount());
 }
 
@@ -315,6 +400,12 @@ Sta::makeObservers()
   levelize_->setObserver(new StaLevelizeObserver(search_));
 }
 
+void
+Sta::makeParasiticAnalysisPts()
+{
+  corners_->makeParasiticAnalysisPtsSingle();
+}
+
 int
 Sta::defaultThreadCount() const
 {
@@ -325,15 +416,114 @@ void
 Sta::setThreadCount(int thread_count)
 {
   thread_count_ = thread_count;
+  if (thread_count > 1) {
+    if (thread_pool_)
+      thread_pool_->setThreadCount(thread_count);
+    else
+      thread_pool_ = new ThreadPool(thread_count);
+  }
+  else {
+    delete thread_pool_;
+    thread_pool_ = nullptr;
+  }
+  updateComponentsState();
+}
+
+void
+Sta::setDataflowScheduling(bool enable)
+{
+  dataflow_scheduling_ = enable;
   updateComponentsState();
 }
 
+bool
+Sta::parallelConstantPropagation() const
+{
+  return sim_->parallelPropagation();
+}
+
+void
+Sta::setParallelConstantPropagation(bool enable)
+{
+  sim_->setParallelPropagation(enable);
+}
+
+bool
+Sta::clkDomainPartitions() const
+{
+  return search_->clkDomainPartitions();
+}
+
+void
+Sta::setClkDomainPartitions(bool partitions)
+{
+  search_->setClkDomainPartitions(partitions);
+}
+
+bool
+Sta::prevPathStorage() const
+{
+  return search_->prevPathStorage();
+}
+
+void
+Sta::setPrevPathStorage(bool storage)
+{
+  search_->setPrevPathStorage(storage);
+}
+
+bool
+Sta::pocvStatisticalMax() const
+{
+  return search_->statisticalMax();
+}
+
+void
+Sta::setPocvStatisticalMax(bool statistical_max)
+{
+  search_->setStatisticalMax(statistical_max);
+}
+
+bool
+Sta::aocvEnabled() const
+{
+  return search_->aocvEnabled();
+}
+
+void
+Sta::setAocvEnabled(bool enabled)
+{
+  search_->setAocvEnabled(enabled);
+}
+
+bool
+Sta::quantizedSlews() const
+{
+  return quantized_slews_;
+}
+
+void
+Sta::setQuantizedSlews(bool quantized)
+{
+  quantized_slews_ = quantized;
+  if (graph_)
+    graph_->setQuantizedSlews(quantized);
+}
+
 void
 Sta::updateComponentsState()
 {
   // These components do not use StaState:
   //  units_
   network_->copyState(this);
+  parasitics_->copyState(this);
+  updateModeComponentsState();
+}
+
+// Components that are not shared with modes (see StaMode).
+void
+Sta::updateModeComponentsState()
+{
   cmd_network_->copyState(this);
   sdc_network_->copyState(this);
   if (graph_)
@@ -341,7 +531,6 @@ Sta::updateComponentsState()
   sdc_->copyState(this);
   corners_->copyState(this);
   levelize_->copyState(this);
-  parasitics_->copyState(this);
   if (arc_delay_calc_)
     arc_delay_calc_->copyState(this);
   sim_->copyState(this);
@@ -353,6 +542,8 @@ Sta::updateComponentsState()
     check_timing_->copyState(this);
   if (power_)
     power_->copyState(this);
+  if (placement_parasitics_)
+    placement_parasitics_->copyState(this);
 }
 
 void
@@ -367,6 +558,24 @@ Sta::makeDebug()
   debug_ = new Debug(report_);
 }
 
+void
+Sta::makePhaseStats()
+{
+  phase_stats_ = new PhaseStats;
+}
+
+void
+Sta::makeThreadProfile()
+{
+  thread_profile_ = new ThreadProfile;
+}
+
+void
+Sta::makeHotVertices()
+{
+  hot_vertices_ = new HotVertices;
+}
+
 void
 Sta::makeUnits()
 {
@@ -492,6 +701,7 @@ Sta::sta()
 Sta::~Sta()
 {
   // Delete "top down" to minimize chance of referencing deleted memory.
+  deleteModes();
   delete check_slew_limits_;
   delete check_min_pulse_widths_;
   delete check_min_periods_;
@@ -514,14 +724,21 @@ Sta::~Sta()
   delete sdc_network_;
   delete network_;
   delete debug_;
+  delete phase_stats_;
+  delete thread_profile_;
+  delete hot_vertices_;
   delete units_;
+  delete thread_pool_;
   delete report_;
   delete power_;
+  delete placement_parasitics_;
 }
 
 void
 Sta::clear()
 {
+  // Mode graphs reference the network.
+  deleteModes();
   // Constraints reference search filter, so clear search first.
   search_->clear();
   sdc_->clear();
@@ -529,12 +746,15 @@ Sta::clear()
   levelize_->clear();
   if (parasitics_)
     parasitics_->clear();
+  if (placement_parasitics_)
+    placement_parasitics_->clear();
   graph_delay_calc_->clear();
   sim_->clear();
   if (check_min_pulse_widths_)
     check_min_pulse_widths_->clear();
   if (check_min_periods_)
     check_min_periods_->clear();
+  clearEcoInvalids();
   delete graph_;
   graph_ = nullptr;
   current_instance_ = nullptr;
@@ -597,22 +817,143 @@ LibertyLibrary *
 Sta::readLiberty(const char *filename,
 		 Corner *corner,
 		 const MinMaxAll *min_max,
-		 bool infer_latches)
+		 bool infer_latches,
+		 const StringSet *skip_groups)
 {
-  Stats stats(debug_);
+  Stats stats(debug_, phase_stats_);
   LibertyLibrary *library = readLibertyFile(filename, corner, min_max,
-					    infer_latches,
+					    infer_latches, skip_groups,
 					    report_, debug_, network_);
-  if (library
-      // The default library is the first library read.
-      // This corresponds to a link_path of '*'.
-      && network_->defaultLibertyLibrary() == nullptr) {
+  if (library)
+    readLibertyDefault(library);
+  stats.report("Read liberty");
+  return library;
+}
+
+LibertyLibrary *
+Sta::readLibertyCache(const char *cache_filename,
+		      Corner *corner,
+		      const MinMaxAll *min_max,
+		      bool infer_latches,
+		      bool lazy)
+{
+  Stats stats(debug_, phase_stats_);
+  LibertyLibrary *library = lazy
+    ? sta::readLibertyCacheLazy(cache_filename, infer_latches,
+				report_, debug_, network_)
+    : sta::readLibertyCache(cache_filename, infer_latches,
+			    report_, debug_, network_);
+  if (library) {
+    readLibertyAfter(library, corner, min_max);
+    readLibertyDefault(library);
+  }
+  stats.report("Read liberty cache");
+  return library;
+}
+
+bool
+Sta::readLibertyFiles(StringSeq *filenames,
+		      Corner *corner,
+		      const MinMaxAll *min_max,
+		      bool infer_latches,
+		      const StringSet *skip_groups)
+{
+  Stats stats(debug_, phase_stats_);
+  size_t file_count = filenames->size();
+  std::vector<LibertyLibrary*> libraries(file_count, nullptr);
+  std::vector<std::exception_ptr> exceptions(file_count);
+  Vector<LibertyReadReport*> reports;
+  for (size_t i = 0; i < file_count; i++)
+    reports.push_back(new LibertyReadReport);
+  // The libraries are built concurrently but not added to the network
+  // until all of the threads are done.
+  forEachChunk(file_count, thread_pool_,
+	       [&] (size_t begin, size_t end, int) {
+		 for (size_t i = begin; i < end; i++) {
+		   try {
+		     libraries[i] = readLibertyDetached((*filenames)[i],
+							infer_latches,
+							skip_groups,
+							reports[i],
+							debug_, network_);
+		   }
+		   catch (...) {
+		     exceptions[i] = std::current_exception();
+		   }
+		 }
+	       });
+  stats.setVisitCount(file_count);
+
+  // Register the libraries in filename order so the link library
+  // order and default library are the same as reading them one by one.
+  bool success = true;
+  std::exception_ptr exception;
+  for (size_t i = 0; i < file_count; i++) {
+    const char *messages = reports[i]->redirectStringEnd();
+    if (messages[0] != '\0')
+      report_->printError(messages, strlen(messages));
+    LibertyLibrary *library = libraries[i];
+    if (exception == nullptr)
+      exception = exceptions[i];
+    if (exception)
+      // Libraries after a file that failed are discarded.
+      delete library;
+    else if (library) {
+      for (size_t j = 0; j < i; j++) {
+	LibertyLibrary *prev_library = libraries[j];
+	if (prev_library && stringEq(prev_library->name(), library->name())) {
+	  report_->warn("%s library %s already exists.\n",
+			(*filenames)[i], library->name());
+	  break;
+	}
+      }
+      network_->addLibertyLibrary(library);
+      readLibertyAfter(library, corner, min_max);
+      readLibertyDefault(library);
+    }
+    else
+      success = false;
+  }
+  reports.deleteContents();
+  stats.report("Read liberty files");
+  if (exception)
+    std::rethrow_exception(exception);
+  return success;
+}
+
+void
+Sta::writeLibertyCache(const char *filename,
+		       const char *cache_filename)
+{
+  sta::writeLibertyCache(filename, cache_filename, report_);
+}
+
+bool
+Sta::readLibertyTableValues(const char *filename)
+{
+  bool valid = readSharedTableValues(filename);
+  if (!valid)
+    report_->error("%s is not a liberty table values file for this version.\n",
+		   filename);
+  return valid;
+}
+
+void
+Sta::writeLibertyTableValues(const char *filename)
+{
+  writeSharedTableValues(filename);
+}
+
+void
+Sta::readLibertyDefault(LibertyLibrary *library)
+{
+  // The default library is the first library read.
+  // This corresponds to a link_path of '*'.
+  if (network_->defaultLibertyLibrary() == nullptr) {
     network_->setDefaultLibertyLibrary(library);
     // Set units from default (first) library.
     units_->copy(library->units());
   }
-  stats.report("Read liberty");
-  return library;
 }
 
 LibertyLibrary *
@@ -620,34 +961,44 @@ Sta::readLibertyFile(const char *filename,
 		     Corner *corner,
 		     const MinMaxAll *min_max,
 		     bool infer_latches,
+		     const StringSet *skip_groups,
 		     Report *report,
 		     Debug *debug,
 		     Network *network)
 {
   LibertyLibrary *liberty = sta::readLibertyFile(filename, infer_latches,
+						 skip_groups,
 						 report, debug, network);
-  if (liberty) {
-    // Don't map liberty cells if they are redefined by reading another
-    // library with the same cell names.
-    if (min_max == MinMaxAll::all()) {
-      readLibertyAfter(liberty, corner, MinMax::min());
-      readLibertyAfter(liberty, corner, MinMax::max());
-    }
-    else
-      readLibertyAfter(liberty, corner, min_max->asMinMax());
-    network_->readLibertyAfter(liberty);
-  }
+  if (liberty)
+    readLibertyAfter(liberty, corner, min_max);
   return liberty;
 }
 
+void
+Sta::readLibertyAfter(LibertyLibrary *liberty,
+		      Corner *corner,
+		      const MinMaxAll *min_max)
+{
+  // Don't map liberty cells if they are redefined by reading another
+  // library with the same cell names.
+  if (min_max == MinMaxAll::all()) {
+    readLibertyAfter(liberty, corner, MinMax::min());
+    readLibertyAfter(liberty, corner, MinMax::max());
+  }
+  else
+    readLibertyAfter(liberty, corner, min_max->asMinMax());
+  network_->readLibertyAfter(liberty);
+}
+
 LibertyLibrary *
 Sta::readLibertyFile(const char *filename,
 		     bool infer_latches,
+		     const StringSet *skip_groups,
 		     Report *report,
 		     Debug *debug,
 		     Network *network)
 {
-  return sta::readLibertyFile(filename, infer_latches,
+  return sta::readLibertyFile(filename, infer_latches, skip_groups,
 			      report, debug, network);
 }
 
@@ -657,6 +1008,7 @@ Sta::readLibertyAfter(LibertyLibrary *liberty,
 		      const MinMax *min_max)
 {
   corner->addLiberty(liberty, min_max);
+  corners_->dcalcInputsChanged();
   LibertyLibrary::makeCornerMap(liberty, corner->libertyIndex(min_max),
 				network_, report_);
 }
@@ -668,7 +1020,7 @@ Sta::setMinLibrary(const char *min_filename,
   LibertyLibrary *max_lib = network_->findLibertyFilename(max_filename);
   if (max_lib) {
     LibertyLibrary *min_lib = readLibertyFile(min_filename, cmd_corner_,
-					      MinMaxAll::min(), false,
+					      MinMaxAll::min(), false, nullptr,
 					      report_, debug_, network_);
     return min_lib != nullptr;
   }
@@ -689,7 +1041,7 @@ bool
 Sta::linkDesign(const char *top_cell_name)
 {
   clear();
-  Stats stats(debug_);
+  Stats stats(debug_, phase_stats_);
   bool status = network_->linkNetwork(top_cell_name,
 				      link_make_black_boxes_,
 				      report_);
@@ -697,6 +1049,27 @@ Sta::linkDesign(const char *top_cell_name)
   return status;
 }
 
+void
+Sta::writeNetworkDb(const char *filename)
+{
+  sta::writeNetworkDb(filename, network_);
+}
+
+bool
+Sta::readNetworkDb(const char *filename)
+{
+  readNetlistBefore();
+  NetworkReader *network_reader = networkReader();
+  if (network_reader) {
+    Stats stats(debug_, phase_stats_);
+    bool success = sta::readNetworkDb(filename, network_reader);
+    stats.report("Read network db");
+    return success;
+  }
+  else
+    return false;
+}
+
 bool
 Sta::linkMakeBlackBoxes() const
 {
@@ -734,6 +1107,31 @@ Sta::setAnalysisType(AnalysisType analysis_type)
   }
 }
 
+void
+Sta::updateDcalcAnalysisPts()
+{
+  if (corners_->dcalcSharingChanged())
+    dcalcAnalysisPtsChanged();
+}
+
+void
+Sta::unshareDcalcAnalysisPts()
+{
+  if (corners_->unshareDcalcAnalysisPts())
+    dcalcAnalysisPtsChanged();
+}
+
+void
+Sta::dcalcAnalysisPtsChanged()
+{
+  graph_delay_calc_->delaysInvalid();
+  search_->arrivalsInvalid();
+  search_->deletePathGroups();
+  corners_->updateDcalcSharing();
+  if (graph_)
+    graph_->setDelayCount(corners_->dcalcAnalysisPtCount());
+}
+
 OperatingConditions *
 Sta::operatingConditions(const MinMax *min_max) const
 {
@@ -840,6 +1238,39 @@ Sta::unsetTimingDerate()
   search_->arrivalsInvalid();
 }
 
+void
+Sta::setAocvDerate(PathClkOrData clk_data,
+		   const TransRiseFallBoth *tr,
+		   const EarlyLate *early_late,
+		   const FloatSeq *depths,
+		   const FloatSeq *derates)
+{
+  sdc_->setAocvDerate(clk_data, tr, early_late, depths, derates);
+  if (search_->aocvEnabled())
+    search_->arrivalsInvalid();
+}
+
+void
+Sta::setAocvDerate(const LibertyCell *cell,
+		   PathClkOrData clk_data,
+		   const TransRiseFallBoth *tr,
+		   const EarlyLate *early_late,
+		   const FloatSeq *depths,
+		   const FloatSeq *derates)
+{
+  sdc_->setAocvDerate(cell, clk_data, tr, early_late, depths, derates);
+  if (search_->aocvEnabled())
+    search_->arrivalsInvalid();
+}
+
+void
+Sta::unsetAocvDerates()
+{
+  sdc_->unsetAocvDerates();
+  if (search_->aocvEnabled())
+    search_->arrivalsInvalid();
+}
+
 void
 Sta::setInputSlew(Port *port,
 		  const TransRiseFallBoth *tr,
@@ -1768,17 +2199,21 @@ Sta::setLogicValue(Pin *pin,
 		   LogicValue value)
 {
   sdc_->setLogicValue(pin, value);
-  // Levelization respects constant disabled edges.
-  levelize_->invalid();
-  sim_->constantsInvalid();
-  // Constants disable edges which isolate downstream vertices of the
-  // graph from the delay calculator's BFS search.  This means that
-  // simply invaldating the delays downstream from the constant pin
-  // fails.  This could be more incremental if the graph delay
-  // calculator searched thru disabled edges but ignored their
-  // results.
-  graph_delay_calc_->delaysInvalid();
-  search_->arrivalsInvalid();
+  // The sim observer invalidates the levels, delays and arrivals
+  // of the vertices and edges that change when only the fanout of
+  // the pin is propagated again.
+  if (!sim_->logicValueChanged(pin)) {
+    // Levelization respects constant disabled edges.
+    levelize_->invalid();
+    // Constants disable edges which isolate downstream vertices of the
+    // graph from the delay calculator's BFS search.  This means that
+    // simply invaldating the delays downstream from the constant pin
+    // fails.  This could be more incremental if the graph delay
+    // calculator searched thru disabled edges but ignored their
+    // results.
+    graph_delay_calc_->delaysInvalid();
+    search_->arrivalsInvalid();
+  }
 }
 
 void
@@ -1786,32 +2221,71 @@ Sta::setCaseAnalysis(Pin *pin,
 		     LogicValue value)
 {
   sdc_->setCaseAnalysis(pin, value);
-  // Levelization respects constant disabled edges.
-  levelize_->invalid();
-  sim_->constantsInvalid();
-  // Constants disable edges which isolate downstream vertices of the
-  // graph from the delay calculator's BFS search.  This means that
-  // simply invaldating the delays downstream from the constant pin
-  // fails.  This could be handled incrementally by invalidating delays
-  // on the output of gates one level downstream.
-  graph_delay_calc_->delaysInvalid();
-  search_->arrivalsInvalid();
+  caseAnalysisChanged(pin);
 }
 
 void
 Sta::removeCaseAnalysis(Pin *pin)
 {
   sdc_->removeCaseAnalysis(pin);
-  // Levelization respects constant disabled edges.
-  levelize_->invalid();
-  sim_->constantsInvalid();
-  // Constants disable edges which isolate downstream vertices of the
-  // graph from the delay calculator's BFS search.  This means that
-  // simply invaldating the delays downstream from the constant pin
-  // fails.  This could be handled incrementally by invalidating delays
-  // on the output of gates one level downstream.
-  graph_delay_calc_->delaysInvalid();
-  search_->arrivalsInvalid();
+  caseAnalysisChanged(pin);
+}
+
+void
+Sta::caseAnalysisChanged(Pin *pin)
+{
+  // The sim observer invalidates the levels, delays and arrivals
+  // of the vertices and edges that change when only the fanout of
+  // the pin is propagated again.
+  if (!sim_->caseAnalysisChanged(pin)) {
+    // Levelization respects constant disabled edges.
+    levelize_->invalid();
+    // Constants disable edges which isolate downstream vertices of the
+    // graph from the delay calculator's BFS search.  This means that
+    // simply invaldating the delays downstream from the constant pin
+    // fails.  This could be handled incrementally by invalidating delays
+    // on the output of gates one level downstream.
+    graph_delay_calc_->delaysInvalid();
+    search_->arrivalsInvalid();
+  }
+}
+
+int
+Sta::addCaseAnalysisMode()
+{
+  return sim_->caseModes()->addMode(sdc_->caseLogicValues());
+}
+
+int
+Sta::caseAnalysisModeCount()
+{
+  return sim_->caseModes()->modeCount();
+}
+
+void
+Sta::clearCaseAnalysisModes()
+{
+  sim_->caseModes()->clearModes();
+}
+
+void
+Sta::setCaseAnalysisMode(int mode)
+{
+  ensureGraph();
+  sdc_->setCaseAnalysis(sim_->caseModes()->caseValues(mode));
+  if (!sim_->setCaseMode(mode)) {
+    levelize_->invalid();
+    graph_delay_calc_->delaysInvalid();
+    search_->arrivalsInvalid();
+  }
+}
+
+LogicValue
+Sta::caseAnalysisModeValue(const Pin *pin,
+			   int mode)
+{
+  ensureGraph();
+  return sim_->caseModes()->logicValue(pin, mode);
 }
 
 void
@@ -1880,8 +2354,10 @@ Sta::makeFalsePath(ExceptionFrom *from,
 		   const MinMaxAll *min_max,
 		   const char *comment)
 {
+  PinSet pins;
+  bool incremental = exceptionInvalidPins(from, thrus, to, pins);
   sdc_->makeFalsePath(from, thrus, to, min_max, comment);
-  search_->arrivalsInvalid();
+  exceptionInvalid(incremental, pins);
 }
 
 void
@@ -1893,15 +2369,129 @@ Sta::makeMulticyclePath(ExceptionFrom *from,
 			int path_multiplier,
 			const char *comment)
 {
+  PinSet pins;
+  bool incremental = exceptionInvalidPins(from, thrus, to, pins);
   sdc_->makeMulticyclePath(from, thrus, to, min_max,
 			   use_end_clk, path_multiplier,
 			   comment);
-  search_->arrivalsInvalid();
+  exceptionInvalid(incremental, pins);
 }
 
-void
-Sta::makePathDelay(ExceptionFrom *from,
-		   ExceptionThruSeq *thrus,
+// Find the pins where tags change when an exception is added.
+// The exception points are found before the exception is added
+// because the exception may be merged away and deleted.
+// Return false if the exception can change tags everywhere
+// (clock or hierarchical pin exception points).
+bool
+Sta::exceptionInvalidPins(ExceptionFrom *from,
+			  ExceptionThruSeq *thrus,
+			  ExceptionTo *to,
+			  // Return value.
+			  PinSet &pins) const
+{
+  if (!search_->arrivalsExist())
+    return false;
+  if (from && !exceptionPtInvalidPins(from, pins))
+    return false;
+  if (thrus) {
+    for (ExceptionThru *thru : *thrus) {
+      if (!exceptionPtInvalidPins(thru, pins))
+	return false;
+    }
+  }
+  return to == nullptr
+    || exceptionPtInvalidPins(to, pins);
+}
+
+bool
+Sta::exceptionPtInvalidPins(ExceptionPt *pt,
+			    // Return value.
+			    PinSet &pins) const
+{
+  ClockSet *clks = pt->clks();
+  if (clks && !clks->empty())
+    return false;
+  PinSet *pt_pins = pt->pins();
+  if (pt_pins) {
+    PinSet::Iterator pin_iter(pt_pins);
+    while (pin_iter.hasNext()) {
+      Pin *pin = pin_iter.next();
+      if (network_->isHierarchical(pin))
+	return false;
+      pins.insert(pin);
+    }
+  }
+  InstanceSet *insts = pt->instances();
+  if (insts) {
+    InstanceSet::Iterator inst_iter(insts);
+    while (inst_iter.hasNext()) {
+      Instance *inst = inst_iter.next();
+      if (network_->isHierarchical(inst))
+	return false;
+      InstancePinIterator *pin_iter = network_->pinIterator(inst);
+      while (pin_iter->hasNext())
+	pins.insert(pin_iter->next());
+      delete pin_iter;
+    }
+  }
+  NetSet *nets = pt->nets();
+  if (nets) {
+    NetSet::Iterator net_iter(nets);
+    while (net_iter.hasNext()) {
+      Net *net = net_iter.next();
+      NetConnectedPinIterator *pin_iter = network_->connectedPinIterator(net);
+      while (pin_iter->hasNext()) {
+	Pin *pin = pin_iter->next();
+	if (network_->isLeaf(pin))
+	  pins.insert(pin);
+      }
+      delete pin_iter;
+    }
+  }
+  return true;
+}
+
+// Arrivals are searched again from the exception pins and their
+// fanout, which picks up the new exception states and propagates the
+// changed tags forward.  The fanout is needed because -from states
+// start on the edges out of the pin (reg clk->q for example).
+// Requireds follow the changed arrivals.
+// Tags hash the exceptions they reference, so if adding the
+// exception deleted or merged into an exception that was already
+// searched the tags have to be rebuilt from scratch.
+void
+Sta::exceptionInvalid(bool incremental,
+		      PinSet &pins)
+{
+  if (incremental && !sdc_->searchedExceptionsChanged()) {
+    PinSet::Iterator pin_iter(pins);
+    while (pin_iter.hasNext()) {
+      Pin *pin = pin_iter.next();
+      Vertex *vertex, *bidirect_drvr_vertex;
+      graph_->pinVertices(pin, vertex, bidirect_drvr_vertex);
+      Vertex *vertices[2] = {vertex, bidirect_drvr_vertex};
+      for (Vertex *vertex1 : vertices) {
+	if (vertex1) {
+	  search_->arrivalInvalid(vertex1);
+	  search_->requiredInvalid(vertex1);
+	  VertexOutEdgeIterator edge_iter(vertex1, graph_);
+	  while (edge_iter.hasNext()) {
+	    Edge *edge = edge_iter.next();
+	    search_->arrivalInvalid(edge->to(graph_));
+	  }
+	}
+      }
+    }
+  }
+  else {
+    search_->arrivalsInvalid();
+    sdc_->clearSearchedExceptionsChanged();
+  }
+}
+
+void
+Sta::makePathDelay(ExceptionFrom *from,
+		   ExceptionThruSeq *thrus,
 		   ExceptionTo *to,
 		   const MinMax *min_max,
 		   bool ignore_clk_latency,
@@ -2077,11 +2667,12 @@ Sta::constraintsChanged()
 void
 Sta::writeSdc(const char *filename,
 	      bool compatible,
+	      bool gzip,
 	      bool no_timestamp,
 	      int digits)
 {
   sta::writeSdc(network_->topInstance(), filename, "write_sdc",
-		compatible, no_timestamp, digits, sdc_);
+		compatible, gzip, no_timestamp, digits, sdc_);
 }
 
 ////////////////////////////////////////////////////////////////
@@ -2093,7 +2684,8 @@ Sta::checkTiming(bool no_input_delay,
 		 bool reg_no_clks,
 		 bool unconstrained_endpoints,
 		 bool loops,
-		 bool generated_clks)
+		 bool generated_clks,
+		 bool verbose)
 {
   searchPreamble();
   if (unconstrained_endpoints)
@@ -2106,7 +2698,7 @@ Sta::checkTiming(bool no_input_delay,
   return check_timing_->check(no_input_delay, no_output_delay,
 			      reg_multiple_clks, reg_no_clks,
 			      unconstrained_endpoints,
-			      loops, generated_clks);
+			      loops, generated_clks, verbose);
 }
 
 bool
@@ -2157,6 +2749,8 @@ Sta::setPocvEnabled(bool enabled)
   }
   pocv_enabled_ = enabled;
   updateComponentsState();
+  if (graph_)
+    graph_->updateDelayStorage();
 }
 
 void
@@ -2436,7 +3030,14 @@ Sta::searchPreamble()
   findDelays();
   updateGeneratedClks();
   sdc_->searchPreamble();
+  if (sdc_->searchedExceptionsChanged()) {
+    // Deferred exception merges changed exceptions referenced by tags.
+    search_->arrivalsInvalid();
+    sdc_->clearSearchedExceptionsChanged();
+  }
   search_->deleteFilteredArrivals();
+  if (search_->tagCompactionDue())
+    compactTags();
 }
 
 void
@@ -2479,6 +3080,12 @@ Sta::setReportPathNoSplit(bool no_split)
   report_path_->setNoSplit(no_split);
 }
 
+void
+Sta::setReportPathNameIds(bool name_ids)
+{
+  report_path_->setNameIds(name_ids);
+}
+
 void
 Sta::reportPathEnds(PathEndSeq *ends)
 {
@@ -2519,10 +3126,135 @@ Sta::reportPath(Path *path)
 void
 Sta::updateTiming(bool full)
 {
+  Stats stats(debug_, phase_stats_);
   searchPreamble();
   if (full)
     search_->arrivalsInvalid();
   search_->findAllArrivals();
+  stats.report("Update timing");
+}
+
+StaMode *
+Sta::makeMode(const char *name)
+{
+  StaMode *mode = new StaMode(name, this);
+  modes_.push_back(mode);
+  return mode;
+}
+
+StaMode *
+Sta::findMode(const char *name) const
+{
+  for (StaMode *mode : modes_) {
+    if (stringEq(mode->name(), name))
+      return mode;
+  }
+  return nullptr;
+}
+
+void
+Sta::deleteModes()
+{
+  modes_.deleteContentsClear();
+}
+
+void
+Sta::updateModeTiming(bool full,
+		      bool requireds)
+{
+  Stats stats(debug_, phase_stats_);
+  int thread_count = thread_count_;
+  int mode_thread_count = max(thread_count
+			      / static_cast<int>(modes_.size() + 1), 1);
+  // Thread counts and graphs are updated before any timing thread
+  // starts because they update the state of shared components.
+  setThreadCount(mode_thread_count);
+  ensureGraph();
+  for (StaMode *mode : modes_) {
+    mode->setThreadCount(mode_thread_count);
+    mode->ensureGraph();
+    if (full)
+      mode->graphDelayCalc()->delaysInvalid();
+    mode->debug()->copyLevels(debug_);
+    // Mode output is printed by this thread after the join.
+    mode->modeReport()->collectBegin();
+  }
+  auto update_timing = [=] (Sta *sta) {
+    sta->updateTiming(full);
+    if (requireds)
+      sta->findRequireds();
+  };
+  std::vector<std::thread> threads;
+  for (StaMode *mode : modes_)
+    threads.push_back(std::thread(update_timing, mode));
+  update_timing(this);
+  for (std::thread &thread : threads)
+    thread.join();
+  for (StaMode *mode : modes_)
+    mode->modeReport()->collectEnd();
+  setThreadCount(thread_count);
+  stats.report("Update mode timing");
+}
+
+void
+Sta::setTimingScope(PinSet *pins,
+		    InstanceSet *insts)
+{
+  ensureLevelized();
+  VertexSeq ends;
+  if (pins) {
+    for (const Pin *pin : *pins) {
+      Vertex *vertex = graph_->pinLoadVertex(pin);
+      if (vertex)
+	ends.push_back(vertex);
+    }
+  }
+  if (insts) {
+    for (Vertex *end : *search_->endpoints()) {
+      const Instance *end_inst = network_->instance(end->pin());
+      for (const Instance *inst : *insts) {
+	if (network_->isInside(end_inst, inst)) {
+	  ends.push_back(end);
+	  break;
+	}
+      }
+    }
+  }
+  search_->setTimingScope(ends);
+  // Delays and arrivals outside of the previous scope are stale.
+  graph_delay_calc_->delaysInvalid();
+  search_->arrivalsInvalid();
+}
+
+void
+Sta::unsetTimingScope()
+{
+  if (search_->hasTimingScope()) {
+    search_->clearTimingScope();
+    graph_delay_calc_->delaysInvalid();
+    search_->arrivalsInvalid();
+  }
+}
+
+bool
+Sta::hasTimingScope() const
+{
+  return search_->hasTimingScope();
+}
+
+bool
+Sta::timingUpToDate()
+{
+  return graph_
+    && !inEco()
+    && !update_genclks_
+    && sim_->constantsValid()
+    && levelize_->levelized()
+    && graph_delay_calc_->delaysValid()
+    && !sdc_->searchPreambleDue()
+    && !sdc_->searchedExceptionsChanged()
+    && !search_->tagCompactionDue()
+    && search_->requiredsValid();
 }
 
 void
@@ -2537,6 +3269,42 @@ Sta::reportClkSkew(ClockSet *clks,
   clk_skews_->reportClkSkew(clks, corner, setup_hold, digits);
 }
 
+void
+Sta::pathBasedSlacks(const PathEndSeq &path_ends,
+		     // Return value.
+		     SlackSeq &slacks)
+{
+  PathBasedTiming pba(this);
+  pba.findSlacks(path_ends, slacks);
+}
+
+void
+Sta::reportPathBasedSlacks(const PathEndSeq &path_ends,
+			   int digits)
+{
+  PathBasedTiming pba(this);
+  SlackSeq slacks;
+  pba.findSlacks(path_ends, slacks);
+  report_->print("%-40s %10s %10s\n", "Endpoint", "GBA Slack", "PBA Slack");
+  report_->print("-------------------------------------------------------------\n");
+  for (size_t i = 0; i < path_ends.size(); i++) {
+    PathEnd *path_end = path_ends[i];
+    string name = sdc_network_->pathName(path_end->path()->pin(this));
+    name += " (";
+    name += path_end->transition(this)->asString();
+    name += ")";
+    string gba_slack = delayAsString(path_end->slack(this), this, digits);
+    string pba_slack = delayAsString(slacks[i], this, digits);
+    report_->print("%-40s %10s %10s\n",
+		   name.c_str(),
+		   gba_slack.c_str(),
+		   pba_slack.c_str());
+  }
+  report_->print("\nGate delays %zu found %zu reused\n",
+		 pba.delayCalcCount(),
+		 pba.cacheHitCount());
+}
+
 ////////////////////////////////////////////////////////////////
 
 void
@@ -2721,8 +3489,10 @@ Sta::vertexArrival(Vertex *vertex,
 		   const ClockEdge *clk_edge,
 		   const PathAnalysisPt *path_ap)
 {
-  searchPreamble();
-  search_->findArrivals(vertex->level());
+  if (!timingUpToDate()) {
+    searchPreamble();
+    search_->findArrivals(vertex->level());
+  }
   const MinMax *min_max = path_ap->pathMinMax();
   Arrival arrival = min_max->initValue();
   VertexPathIterator path_iter(vertex, tr, path_ap, this);
@@ -2799,11 +3569,319 @@ Sta::pinSlack(const Pin *pin,
   return slack;
 }
 
+void
+Sta::pinSlacks(const PinSeq *pins,
+	       const MinMax *min_max,
+	       // Return value.
+	       float *slacks)
+{
+  ensureGraph();
+  findRequireds();
+  bool resurrect_pruned = sdc_->crprEnabled()
+    && search_->crprPathPruningEnabled()
+    && !search_->crprApproxMissingRequireds();
+  size_t pin_count = pins->size();
+  std::vector<char> pruned(pin_count, 0);
+  forEachChunk(pin_count, thread_pool_,
+	       [&] (size_t begin, size_t end, int) {
+		 for (size_t i = begin; i < end; i++) {
+		   Vertex *vertex, *bidirect_drvr_vertex;
+		   graph_->pinVertices((*pins)[i], vertex, bidirect_drvr_vertex);
+		   Slack slack = MinMax::min()->initValue();
+		   if (vertex) {
+		     slack = vertexSlack1(vertex, min_max);
+		     if (resurrect_pruned
+			 && !search_->isClock(vertex)
+			 && vertex->requiredsPruned())
+		       pruned[i] = 1;
+		   }
+		   if (bidirect_drvr_vertex) {
+		     slack = min(slack, vertexSlack1(bidirect_drvr_vertex,
+						     min_max));
+		     if (resurrect_pruned
+			 && !search_->isClock(bidirect_drvr_vertex)
+			 && bidirect_drvr_vertex->requiredsPruned())
+		       pruned[i] = 1;
+		   }
+		   slacks[i] = delayAsFloat(slack);
+		 }
+	       });
+  // Pruned requireds are found again one pin at a time because
+  // that searches the fanout.
+  for (size_t i = 0; i < pin_count; i++) {
+    if (pruned[i])
+      slacks[i] = delayAsFloat(pinSlack((*pins)[i], min_max));
+  }
+}
+
+void
+Sta::pinArrivals(const PinSeq *pins,
+		 const MinMax *min_max,
+		 // Return value.
+		 float *arrivals)
+{
+  ensureGraph();
+  searchPreamble();
+  search_->findAllArrivals();
+  forEachChunk(pins->size(), thread_pool_,
+	       [&] (size_t begin, size_t end, int) {
+		 for (size_t i = begin; i < end; i++) {
+		   Vertex *vertex, *bidirect_drvr_vertex;
+		   graph_->pinVertices((*pins)[i], vertex, bidirect_drvr_vertex);
+		   Arrival arrival = min_max->initValue();
+		   if (vertex)
+		     arrival = vertexArrival1(vertex, min_max);
+		   if (bidirect_drvr_vertex) {
+		     Arrival arrival1 = vertexArrival1(bidirect_drvr_vertex,
+						       min_max);
+		     if (fuzzyGreater(arrival1, arrival, min_max))
+		       arrival = arrival1;
+		   }
+		   arrivals[i] = delayAsFloat(arrival);
+		 }
+	       });
+}
+
+void
+Sta::pinSlews(const PinSeq *pins,
+	      const MinMax *min_max,
+	      // Return value.
+	      float *slews)
+{
+  ensureGraph();
+  findDelays();
+  forEachChunk(pins->size(), thread_pool_,
+	       [&] (size_t begin, size_t end, int) {
+		 for (size_t i = begin; i < end; i++) {
+		   Vertex *vertex, *bidirect_drvr_vertex;
+		   graph_->pinVertices((*pins)[i], vertex, bidirect_drvr_vertex);
+		   Slew slew = min_max->initValue();
+		   if (vertex)
+		     slew = vertexSlew1(vertex, min_max);
+		   if (bidirect_drvr_vertex) {
+		     Slew slew1 = vertexSlew1(bidirect_drvr_vertex, min_max);
+		     if (fuzzyGreater(slew1, slew, min_max))
+		       slew = slew1;
+		   }
+		   slews[i] = delayAsFloat(slew);
+		 }
+	       });
+}
+
+// Arrivals must be up to date.
+Arrival
+Sta::vertexArrival1(Vertex *vertex,
+		    const MinMax *min_max)
+{
+  Arrival arrival = min_max->initValue();
+  VertexPathIterator path_iter(vertex, this);
+  while (path_iter.hasNext()) {
+    Path *path = path_iter.next();
+    if (path->minMax(this) == min_max
+	&& !path->clkInfo(search_)->isGenClkSrcPath()) {
+      const Arrival &path_arrival = path->arrival(this);
+      if (fuzzyGreater(path_arrival, arrival, min_max))
+	arrival = path_arrival;
+    }
+  }
+  return arrival;
+}
+
+// Delays must be up to date.
+Slew
+Sta::vertexSlew1(Vertex *vertex,
+		 const MinMax *min_max)
+{
+  Slew mm_slew = min_max->initValue();
+  DcalcAnalysisPtIterator dcalc_ap_iter(this);
+  while (dcalc_ap_iter.hasNext()) {
+    DcalcAnalysisPt *dcalc_ap = dcalc_ap_iter.next();
+    TransRiseFallIterator tr_iter;
+    while (tr_iter.hasNext()) {
+      TransRiseFall *tr = tr_iter.next();
+      Slew slew = graph_->slew(vertex, tr, dcalc_ap->index());
+      if (fuzzyGreater(slew, mm_slew, min_max))
+	mm_slew = slew;
+    }
+  }
+  return mm_slew;
+}
+
+void
+Sta::reportPinSlacks(const MinMax *min_max,
+		     int digits)
+{
+  PinSeq pins;
+  Instance *top_inst = network_->topInstance();
+  InstancePinIterator *port_iter = network_->pinIterator(top_inst);
+  while (port_iter->hasNext())
+    pins.push_back(port_iter->next());
+  delete port_iter;
+  LeafInstanceIterator *leaf_iter = network_->leafInstanceIterator();
+  while (leaf_iter->hasNext()) {
+    Instance *inst = leaf_iter->next();
+    InstancePinIterator *pin_iter = network_->pinIterator(inst);
+    while (pin_iter->hasNext())
+      pins.push_back(pin_iter->next());
+    delete pin_iter;
+  }
+  delete leaf_iter;
+
+  std::vector<float> slacks(pins.size());
+  pinSlacks(&pins, min_max, slacks.data());
+
+  float time_scale = units_->timeUnit()->scale();
+  string line;
+  report_->bufferBegin();
+  for (size_t i = 0; i < pins.size(); i++) {
+    float slack = slacks[i];
+    line = sdc_network_->pathName(pins[i]);
+    if (fuzzyInf(slack))
+      line += " INF\n";
+    else {
+      char buffer[32];
+      snprintf(buffer, sizeof(buffer), " %.*f\n", digits, slack / time_scale);
+      line += buffer;
+    }
+    report_->print(line);
+  }
+  report_->bufferEnd();
+}
+
+void
+Sta::endpointSlacks(const MinMax *min_max,
+		    // Return values.
+		    VertexSeq &ends,
+		    SlackSeq &slacks)
+{
+  ensureGraph();
+  findRequireds();
+  const VertexSeq &all_ends = *search_->endpoints();
+  SlackSeq ap_slacks;
+  search_->wnsSlacks(all_ends, ap_slacks);
+  PathAPIndex path_ap_count = corners_->pathAnalysisPtCount();
+  ends.clear();
+  slacks.clear();
+  for (size_t i = 0; i < all_ends.size(); i++) {
+    Slack slack = MinMax::min()->initValue();
+    for (PathAPIndex j = 0; j < path_ap_count; j++) {
+      if (corners_->findPathAnalysisPt(j)->pathMinMax() == min_max) {
+	Slack ap_slack = ap_slacks[i * path_ap_count + j];
+	if (ap_slack < slack)
+	  slack = ap_slack;
+      }
+    }
+    // Skip unconstrained endpoints.
+    if (!fuzzyInf(delayAsFloat(slack))) {
+      ends.push_back(all_ends[i]);
+      slacks.push_back(slack);
+    }
+  }
+}
+
+void
+Sta::reportSlackHistogram(const MinMax *min_max,
+			  int bin_count,
+			  int digits)
+{
+  VertexSeq ends;
+  SlackSeq slacks;
+  endpointSlacks(min_max, ends, slacks);
+  if (slacks.empty()) {
+    report_->print("No constrained endpoints.\n");
+    return;
+  }
+  float slack_min = INF;
+  float slack_max = -INF;
+  for (auto slack : slacks) {
+    float slack1 = delayAsFloat(slack);
+    slack_min = min(slack_min, slack1);
+    slack_max = max(slack_max, slack1);
+  }
+  float bin_width = (slack_max - slack_min) / bin_count;
+  std::vector<int> bins(bin_count, 0);
+  for (auto slack : slacks) {
+    int bin = (bin_width > 0.0)
+      ? static_cast<int>((delayAsFloat(slack) - slack_min) / bin_width)
+      : 0;
+    // slack_max lands on the upper edge of the last bin.
+    if (bin >= bin_count)
+      bin = bin_count - 1;
+    bins[bin]++;
+  }
+  const Unit *time_unit = units_->timeUnit();
+  float time_scale = time_unit->scale();
+  report_->print("Endpoint %s slack histogram (%s)\n",
+		 min_max->asString(),
+		 time_unit->suffix());
+  for (int i = 0; i < bin_count; i++) {
+    float from = slack_min + i * bin_width;
+    float to = (i == bin_count - 1) ? slack_max : from + bin_width;
+    report_->print("%12.*f %12.*f %8d\n",
+		   digits, from / time_scale,
+		   digits, to / time_scale,
+		   bins[i]);
+  }
+}
+
+void
+Sta::reportEndpointSummary(const MinMax *min_max,
+			   int top_n,
+			   int digits)
+{
+  VertexSeq ends;
+  SlackSeq slacks;
+  endpointSlacks(min_max, ends, slacks);
+  int violation_count = 0;
+  float wns = 0.0;
+  float tns = 0.0;
+  for (auto slack : slacks) {
+    float slack1 = delayAsFloat(slack);
+    if (slack1 < 0.0) {
+      violation_count++;
+      tns += slack1;
+      wns = min(wns, slack1);
+    }
+  }
+  const Unit *time_unit = units_->timeUnit();
+  float time_scale = time_unit->scale();
+  report_->print("Endpoints  %zu\n", slacks.size());
+  report_->print("Violations %d\n", violation_count);
+  report_->print("wns %.*f\n", digits, wns / time_scale);
+  report_->print("tns %.*f\n", digits, tns / time_scale);
+
+  size_t report_count = min(static_cast<size_t>(top_n), slacks.size());
+  if (report_count > 0) {
+    std::vector<size_t> order(slacks.size());
+    for (size_t i = 0; i < order.size(); i++)
+      order[i] = i;
+    std::partial_sort(order.begin(), order.begin() + report_count, order.end(),
+		      [&] (size_t i1, size_t i2) {
+			return delayAsFloat(slacks[i1]) < delayAsFloat(slacks[i2]);
+		      });
+    report_->print("\n");
+    for (size_t i = 0; i < report_count; i++) {
+      size_t index = order[i];
+      report_->print("%12.*f %s\n",
+		     digits, delayAsFloat(slacks[index]) / time_scale,
+		     ends[index]->name(sdc_network_));
+    }
+  }
+}
+
 Slack
 Sta::vertexSlack(Vertex *vertex,
 		 const MinMax *min_max)
 {
   findRequired(vertex);
+  return vertexSlack1(vertex, min_max);
+}
+
+// Requireds must be up to date.
+Slack
+Sta::vertexSlack1(Vertex *vertex,
+		  const MinMax *min_max)
+{
   MinMax *min = MinMax::min();
   Slack slack = min->initValue();
   VertexPathIterator path_iter(vertex, this);
@@ -2877,9 +3955,11 @@ Sta::vertexSlack1(Vertex *vertex,
 void
 Sta::findRequired(Vertex *vertex)
 {
-  searchPreamble();
-  search_->findAllArrivals();
-  search_->findRequireds(vertex->level());
+  if (!timingUpToDate()) {
+    searchPreamble();
+    search_->findAllArrivals();
+    search_->findRequireds(vertex);
+  }
   if (sdc_->crprEnabled()
       && search_->crprPathPruningEnabled()
       && !search_->crprApproxMissingRequireds()
@@ -2897,7 +3977,7 @@ Sta::findRequired(Vertex *vertex)
 		fanout);
     // Find fanout arrivals and requireds with pruning disabled.
     search_->findArrivals();
-    search_->findRequireds(vertex->level());
+    search_->findRequireds(vertex);
   }
 }
 
@@ -3006,6 +4086,8 @@ Sta::findDelays(Level level)
 void
 Sta::delayCalcPreamble()
 {
+  if (inEco())
+    applyEcoInvalids();
   ensureLevelized();
 }
 
@@ -3015,6 +4097,51 @@ Sta::setIncrementalDelayTolerance(float tol)
   graph_delay_calc_->setIncrementalDelayTolerance(tol);
 }
 
+void
+Sta::setIncrementalArrivalTolerance(float tol)
+{
+  search_->setIncrementalTolerance(tol);
+}
+
+bool
+Sta::gateDelayCache() const
+{
+  return graph_delay_calc_->gateDelayCache();
+}
+
+void
+Sta::setGateDelayCache(bool enable)
+{
+  graph_delay_calc_->setGateDelayCache(enable);
+}
+
+bool
+Sta::dcalcLevelBatch() const
+{
+  return graph_delay_calc_->levelBatch();
+}
+
+void
+Sta::setDcalcLevelBatch(bool enable)
+{
+  graph_delay_calc_->setLevelBatch(enable);
+}
+
+void
+Sta::reportGateDelayCache()
+{
+  size_t hits, misses, entries;
+  graph_delay_calc_->gateDelayCacheStats(hits, misses, entries);
+  size_t lookups = hits + misses;
+  report_->print("Gate delay cache %s\n",
+		 graph_delay_calc_->gateDelayCache() ? "enabled" : "disabled");
+  report_->print("Entries %zu\n", entries);
+  report_->print("Hits    %zu\n", hits);
+  report_->print("Misses  %zu\n", misses);
+  if (lookups > 0)
+    report_->print("Hit rate %.1f%%\n", hits * 100.0 / lookups);
+}
+
 ArcDelay
 Sta::arcDelay(Edge *edge,
 	      TimingArc *arc,
@@ -3077,6 +4204,7 @@ Sta::vertexSlew(Vertex *vertex,
 Graph *
 Sta::ensureGraph()
 {
+  updateDcalcAnalysisPts();
   if (graph_ == nullptr && network_) {
     makeGraph();
     // Update pointers to graph.
@@ -3090,6 +4218,7 @@ void
 Sta::makeGraph()
 {
   graph_ = new Graph(this, 2, true, corners_->dcalcAnalysisPtCount());
+  graph_->setQuantizedSlews(quantized_slews_);
   graph_->makeGraph();
 }
 
@@ -3209,6 +4338,128 @@ Sta::clkInfoCount() const
   return search_->clkInfoCount();
 }
 
+void
+Sta::compactTags()
+{
+  // Journaled arrivals refer to tag group indices that must stay
+  // valid until the journal is restored.
+  if (search_->arrivalJournalActive()) {
+    report_->warn("tags are not compacted while arrivals are journaled.\n");
+    return;
+  }
+  // Check results hold paths.
+  if (check_min_pulse_widths_)
+    check_min_pulse_widths_->clear();
+  if (check_min_periods_)
+    check_min_periods_->clear();
+  if (check_max_skews_)
+    check_max_skews_->clear();
+  if (graph_)
+    search_->compactTags();
+}
+
+void
+Sta::reportMemory(bool json)
+{
+  MemoryReport memory(report_, json);
+  network_->reportMemory(memory);
+  LibertyLibraryIterator *lib_iter = network_->libertyLibraryIterator();
+  while (lib_iter->hasNext()) {
+    LibertyLibrary *lib = lib_iter->next();
+    lib->reportMemory(memory);
+  }
+  delete lib_iter;
+  size_t float_count, mapped_float_count;
+  size_t float_seq_count = internedFloatsCount(float_count,
+					       mapped_float_count);
+  // Mapped shared table values are not private memory.
+  memory.reportUsage("Liberty", "table values", float_seq_count,
+		     float_seq_count * (sizeof(TableValues) + sizeof(FloatSeq)
+					+ MemoryReport::hash_node_bytes)
+		     + float_count * sizeof(float));
+  memory.reportSubsystemTotal("Liberty");
+  // Cell, port, instance and net names shared by Network and Liberty.
+  size_t string_bytes;
+  size_t string_count = internedStringCount(string_bytes);
+  memory.reportUsage("Strings", "interned names", string_count, string_bytes);
+  memory.reportSubsystemTotal("Strings");
+  if (graph_) {
+    graph_->reportMemory(memory);
+    search_->reportMemory(memory);
+  }
+  parasitics_->reportMemory(memory);
+  memory.reportTotal();
+}
+
+void
+Sta::reportPhaseStats(bool json)
+{
+  if (json)
+    phase_stats_->reportJson(report_);
+  else
+    phase_stats_->report(report_);
+}
+
+void
+Sta::clearPhaseStats()
+{
+  phase_stats_->clear();
+}
+
+bool
+Sta::threadProfileEnabled() const
+{
+  return thread_profile_->enabled();
+}
+
+void
+Sta::setThreadProfileEnabled(bool enabled)
+{
+  thread_profile_->setEnabled(enabled);
+}
+
+void
+Sta::reportThreadProfile(int max_levels)
+{
+  thread_profile_->report(max_levels, this);
+}
+
+void
+Sta::reportThreadProfileJson()
+{
+  thread_profile_->reportJson(report_);
+}
+
+void
+Sta::clearThreadProfile()
+{
+  thread_profile_->clear();
+}
+
+bool
+Sta::hotVertexProfileEnabled() const
+{
+  return hot_vertices_->enabled();
+}
+
+void
+Sta::setHotVertexProfileEnabled(bool enabled)
+{
+  hot_vertices_->setEnabled(enabled);
+}
+
+void
+Sta::reportHotVertices(int count)
+{
+  hot_vertices_->report(count, this);
+}
+
+void
+Sta::clearHotVertices()
+{
+  hot_vertices_->clear();
+}
+
 void
 Sta::setArcDelay(Edge *edge,
 		 TimingArc *arc,
@@ -3216,6 +4467,7 @@ Sta::setArcDelay(Edge *edge,
 		 const MinMaxAll *min_max,
 		 ArcDelay delay)
 {
+  unshareDcalcAnalysisPts();
   MinMaxIterator mm_iter(min_max);
   while (mm_iter.hasNext()) {
     MinMax *mm = mm_iter.next();
@@ -3240,6 +4492,7 @@ Sta::setAnnotatedSlew(Vertex *vertex,
 		      const TransRiseFallBoth *tr,
 		      float slew)
 {
+  unshareDcalcAnalysisPts();
   MinMaxIterator mm_iter(min_max);
   while (mm_iter.hasNext()) {
     MinMax *mm = mm_iter.next();
@@ -3256,6 +4509,79 @@ Sta::setAnnotatedSlew(Vertex *vertex,
   graph_delay_calc_->delayInvalid(vertex);
 }
 
+void
+Sta::setArcDelays(const ArcDelayValue *delays,
+		  size_t count)
+{
+  forEachChunk(count, thread_pool_,
+	       [&] (size_t begin, size_t end, int) {
+		 for (size_t i = begin; i < end; i++) {
+		   const ArcDelayValue &delay = delays[i];
+		   graph_->setArcDelay(delay.edge_, delay.arc_, delay.ap_index_,
+				       delay.delay_);
+		 }
+	       });
+  // The annotation bits are packed so they are set by one thread.
+  for (size_t i = 0; i < count; i++) {
+    const ArcDelayValue &delay = delays[i];
+    // Don't let delay calculation clobber the value.
+    graph_->setArcDelayAnnotated(delay.edge_, delay.arc_, delay.ap_index_,
+				 true);
+  }
+  // Invalidating every arrival is cheaper than tracking most of the
+  // graph incrementally.
+  if (count > graph_->vertexCount() / bulk_invalid_ratio)
+    search_->arrivalsInvalid();
+  else {
+    VertexSet arrival_invalids;
+    VertexSet required_invalids;
+    for (size_t i = 0; i < count; i++) {
+      Edge *edge = delays[i].edge_;
+      if (edge->role()->isTimingCheck())
+	required_invalids.insert(edge->to(graph_));
+      else {
+	arrival_invalids.insert(edge->to(graph_));
+	required_invalids.insert(edge->from(graph_));
+      }
+    }
+    for (auto vertex : arrival_invalids)
+      search_->arrivalInvalid(vertex);
+    for (auto vertex : required_invalids)
+      search_->requiredInvalid(vertex);
+  }
+}
+
+void
+Sta::setAnnotatedSlews(const VertexSlewValue *slews,
+		       size_t count)
+{
+  forEachChunk(count, thread_pool_,
+	       [&] (size_t begin, size_t end, int) {
+		 for (size_t i = begin; i < end; i++) {
+		   const VertexSlewValue &slew = slews[i];
+		   graph_->setSlew(slew.vertex_, slew.tr_, slew.ap_index_,
+				   slew.slew_);
+		 }
+	       });
+  // Annotation bits for different transitions share a vertex word.
+  for (size_t i = 0; i < count; i++) {
+    const VertexSlewValue &slew = slews[i];
+    // Don't let delay calculation clobber the value.
+    slew.vertex_->setSlewAnnotated(true, slew.tr_, slew.ap_index_);
+  }
+  if (count > graph_->vertexCount() / bulk_invalid_ratio) {
+    graph_delay_calc_->delaysInvalid();
+    search_->arrivalsInvalid();
+  }
+  else {
+    VertexSet invalids;
+    for (size_t i = 0; i < count; i++)
+      invalids.insert(slews[i].vertex_);
+    for (auto vertex : invalids)
+      graph_delay_calc_->delayInvalid(vertex);
+  }
+}
+
 void
 Sta::writeSdf(const char *filename,
 	      Corner *corner,
@@ -3270,6 +4596,76 @@ Sta::writeSdf(const char *filename,
 		no_version, this);
 }
 
+void
+Sta::writeTimingCheckpoint(const char *filename)
+{
+  findDelays();
+  sta::writeTimingCheckpoint(filename, this);
+}
+
+bool
+Sta::readTimingCheckpoint(const char *filename)
+{
+  ensureLevelized();
+  if (sta::readTimingCheckpoint(filename, this)) {
+    graph_delay_calc_->delaysRestored();
+    search_->arrivalsInvalid();
+    return true;
+  }
+  else {
+    // Discard any partially restored delays.
+    graph_delay_calc_->delaysInvalid();
+    search_->arrivalsInvalid();
+    return false;
+  }
+}
+
+void
+Sta::writeDelayAnnotations(const char *filename)
+{
+  unshareDcalcAnalysisPts();
+  findDelays();
+  sta::writeDelayAnnotations(filename, this);
+}
+
+bool
+Sta::readDelayAnnotations(const char *filename)
+{
+  ensureGraph();
+  unshareDcalcAnalysisPts();
+  return sta::readDelayAnnotations(filename, this);
+}
+
+void
+Sta::writeTimingColumns(const char *dirname)
+{
+  findRequireds();
+  sta::writeTimingColumns(dirname, this);
+}
+
+void
+Sta::writeBoundaryTiming(Instance *inst,
+			 const char *filename)
+{
+  updateTiming(false);
+  sta::writeBoundaryTiming(inst, filename, this);
+}
+
+bool
+Sta::readBoundaryTiming(const char *filename)
+{
+  return sta::readBoundaryTiming(filename, this);
+}
+
+void
+Sta::writeTimingModel(const char *cell_name,
+		      const char *filename,
+		      const Corner *corner)
+{
+  findDelays();
+  sta::writeTimingModel(cell_name, filename, corner, this);
+}
+
 void
 Sta::removeDelaySlewAnnotations()
 {
@@ -3398,6 +4794,7 @@ Sta::setNetWireCap(Net *net,
     MinMax *mm = mm_iter.next();
     sdc_->setNetWireCap(net, subtract_pin_cap, corner, mm, cap);
   }
+  corners_->dcalcInputsChanged();
   delaysInvalidFromFanin(net);
 }
 
@@ -3479,13 +4876,15 @@ Sta::readSpef(const char *filename,
 	      Instance *instance,
 	      const MinMaxAll *min_max,
 	      bool increment,
+	      bool incremental,
 	      bool pin_cap_included,
 	      bool keep_coupling_caps,
 	      float coupling_cap_factor,
 	      ReduceParasiticsTo reduce_to,
 	      bool delete_after_reduce,
 	      bool save,
-	      bool quiet)
+	      bool quiet,
+	      bool lazy)
 {
   Corner *corner = cmd_corner_;
   const MinMax *cnst_min_max;
@@ -3502,12 +4901,44 @@ Sta::readSpef(const char *filename,
   }
   const OperatingConditions *op_cond =
     sdc_->operatingConditions(cnst_min_max);
+  NetSet updated_nets;
   bool success = readSpefFile(filename, instance, ap, increment,
 			      pin_cap_included,
 			      keep_coupling_caps, coupling_cap_factor,
 			      reduce_to, delete_after_reduce,
 			      op_cond, corner, cnst_min_max, save, quiet,
-			      report_, network_, parasitics_);
+			      lazy, incremental ? &updated_nets : nullptr,
+			      report_, network_, parasitics_, thread_pool_);
+  // Remember where the deleted networks came from in case a command
+  // like write_path_spice needs them later.
+  if (success
+      && delete_after_reduce
+      && reduce_to != ReduceParasiticsTo::none)
+    ap->addDiscardedSpefFile(filename, instance, pin_cap_included,
+			     keep_coupling_caps);
+  if (incremental && graph_) {
+    NetSet::Iterator net_iter(updated_nets);
+    while (net_iter.hasNext())
+      delaysInvalidFromFanin(net_iter.next());
+  }
+  else {
+    graph_delay_calc_->delaysInvalid();
+    search_->arrivalsInvalid();
+  }
+  return success;
+}
+
+void
+Sta::writeParasiticsDb(const char *filename,
+		       bool networks)
+{
+  sta::writeParasiticsDb(filename, networks, this);
+}
+
+bool
+Sta::readParasiticsDb(const char *filename)
+{
+  bool success = sta::readParasiticsDb(filename, this);
   graph_delay_calc_->delaysInvalid();
   search_->arrivalsInvalid();
   return success;
@@ -3534,21 +4965,59 @@ Sta::findPiElmore(Pin *drvr_pin,
 }
 
 void
-Sta::makePiElmore(Pin *drvr_pin,
-		  const TransRiseFall *tr,
-		  const MinMaxAll *min_max,
-		  float c2,
-		  float rpi,
-		  float c1)
+Sta::makePiElmore(Pin *drvr_pin,
+		  const TransRiseFall *tr,
+		  const MinMaxAll *min_max,
+		  float c2,
+		  float rpi,
+		  float c1)
+{
+  Corner *corner = cmd_corner_;
+  MinMaxIterator mm_iter(min_max);
+  while (mm_iter.hasNext()) {
+    MinMax *mm = mm_iter.next();
+    ParasiticAnalysisPt *ap = corner->findParasiticAnalysisPt(mm);
+    parasitics_->makePiElmore(drvr_pin, tr, ap, c2, rpi, c1);
+  }
+  delaysInvalidFrom(drvr_pin);
+}
+
+void
+Sta::setPlacementWireRC(float res_per_length,
+			float cap_per_length)
+{
+  makePlacementParasitics();
+  placement_parasitics_->setWireRC(res_per_length, cap_per_length);
+}
+
+void
+Sta::setPinLocations(const Pin * const *pins,
+		     const double *xs,
+		     const double *ys,
+		     size_t count)
+{
+  makePlacementParasitics();
+  placement_parasitics_->setPinLocations(pins, xs, ys, count);
+}
+
+void
+Sta::makePlacementParasitics()
+{
+  if (placement_parasitics_ == nullptr)
+    placement_parasitics_ = new PlacementParasitics(this);
+}
+
+void
+Sta::estimatePlacementParasitics()
 {
-  Corner *corner = cmd_corner_;
-  MinMaxIterator mm_iter(min_max);
-  while (mm_iter.hasNext()) {
-    MinMax *mm = mm_iter.next();
-    ParasiticAnalysisPt *ap = corner->findParasiticAnalysisPt(mm);
-    parasitics_->makePiElmore(drvr_pin, tr, ap, c2, rpi, c1);
+  if (placement_parasitics_) {
+    Stats stats(debug_, phase_stats_);
+    PinSeq drvrs;
+    placement_parasitics_->estimate(drvrs);
+    for (auto drvr : drvrs)
+      delaysInvalidFrom(drvr);
+    stats.report("Estimate placement parasitics");
   }
-  delaysInvalidFrom(drvr_pin);
 }
 
 void
@@ -3627,6 +5096,19 @@ Sta::deleteInstance(Instance *inst)
   network->deleteInstance(inst);
 }
 
+void
+Sta::findEquivCells()
+{
+  Stats stats(debug_, phase_stats_);
+  LibertyLibraryIterator *lib_iter = network_->libertyLibraryIterator();
+  while (lib_iter->hasNext()) {
+    LibertyLibrary *lib = lib_iter->next();
+    lib->findEquivCells(thread_pool_);
+  }
+  delete lib_iter;
+  stats.report("Find equiv cells");
+}
+
 void
 Sta::replaceCell(Instance *inst,
 		 LibertyCell *to_cell)
@@ -3645,6 +5127,94 @@ Sta::replaceCell(Instance *inst,
   }
 }
 
+Slack
+Sta::whatIfReplaceCell(Instance *inst,
+		       LibertyCell *to_cell,
+		       const MinMax *min_max)
+{
+  LibertyCellSeq cells;
+  cells.push_back(to_cell);
+  SlackSeq wns_deltas, tns_deltas, inst_slack_deltas;
+  whatIfReplaceCells(inst, &cells, min_max,
+		     wns_deltas, tns_deltas, inst_slack_deltas);
+  return wns_deltas[0];
+}
+
+// Timing changes from each edit are journaled and discarded after the
+// slacks are found, so the committed delays and arrivals are not
+// recomputed when the edit is undone.
+// Candidates are evaluated one at a time; each incremental update
+// runs on the thread pool. Evaluating candidates concurrently would
+// need a private copy of more than the graph and search state: the
+// reduced parasitics are cached in the shared parasitics by driver
+// pin, the edit changes the shared network instance cell, and the
+// constraints (Sdc) belong to the Sta.
+void
+Sta::whatIfReplaceCells(Instance *inst,
+			LibertyCellSeq *cells,
+			const MinMax *min_max,
+			// Return values.
+			SlackSeq &wns_deltas,
+			SlackSeq &tns_deltas,
+			SlackSeq &inst_slack_deltas)
+{
+  NetworkEdit *network = networkCmdEdit();
+  LibertyCell *from_cell = network->libertyCell(inst);
+  Slack wns, tns, inst_slack;
+  whatIfSlacks(inst, min_max, wns, tns, inst_slack);
+  for (auto to_cell : *cells) {
+    // Cells that are not equivalent are not evaluated.
+    Slack wns_delta = INF;
+    Slack tns_delta = INF;
+    Slack inst_slack_delta = INF;
+    if (equivCells(from_cell, to_cell)) {
+      graph_->beginDelayJournal();
+      search_->beginArrivalJournal();
+      replaceEquivCellBefore(inst, to_cell);
+      network->replaceCell(inst, to_cell);
+      replaceEquivCellAfter(inst);
+      Slack what_if_wns, what_if_tns, what_if_inst_slack;
+      whatIfSlacks(inst, min_max, what_if_wns, what_if_tns, what_if_inst_slack);
+      wns_delta = delayAsFloat(what_if_wns) - delayAsFloat(wns);
+      tns_delta = delayAsFloat(what_if_tns) - delayAsFloat(tns);
+      inst_slack_delta = 0.0;
+      // Unconstrained instance pins have infinite slack.
+      if (!fuzzyInf(inst_slack) && !fuzzyInf(what_if_inst_slack))
+	inst_slack_delta = delayAsFloat(what_if_inst_slack)
+	  - delayAsFloat(inst_slack);
+
+      network->replaceCell(inst, from_cell);
+      replaceEquivCellArcSets(inst, from_cell);
+      replaceEquivCellAfter(inst);
+      graph_->restoreDelayJournal();
+      search_->restoreArrivalJournal();
+    }
+    wns_deltas.push_back(wns_delta);
+    tns_deltas.push_back(tns_delta);
+    inst_slack_deltas.push_back(inst_slack_delta);
+  }
+}
+
+void
+Sta::whatIfSlacks(Instance *inst,
+		  const MinMax *min_max,
+		  // Return values.
+		  Slack &wns,
+		  Slack &tns,
+		  Slack &inst_slack)
+{
+  Vertex *worst_vertex;
+  worstSlack(min_max, wns, worst_vertex);
+  tns = totalNegativeSlack(min_max);
+  inst_slack = MinMax::min()->initValue();
+  InstancePinIterator *pin_iter = network_->pinIterator(inst);
+  while (pin_iter->hasNext()) {
+    Pin *pin = pin_iter->next();
+    inst_slack = min(inst_slack, pinSlack(pin, min_max));
+  }
+  delete pin_iter;
+}
+
 Net *
 Sta::makeNet(const char *name,
 	     Instance *parent)
@@ -3702,6 +5272,7 @@ Sta::insertBuffer(const char *buffer_name,
   LibertyPort *buffer_in_port = findCellPort(buffer_cell, PortDirection::input());
   LibertyPort *buffer_out_port = findCellPort(buffer_cell, PortDirection::output());
   if (buffer_in_port && buffer_out_port) {
+    beginEco();
     Instance *buffer = makeInstance(buffer_name, buffer_cell, parent);
     connectPin(buffer, buffer_in_port, net);
 
@@ -3716,6 +5287,108 @@ Sta::insertBuffer(const char *buffer_name,
       disconnectPin(load_pin);
       connectPin(load_inst, load_port, buffer_out_net);
     }
+    commitEco();
+  }
+}
+
+////////////////////////////////////////////////////////////////
+
+void
+Sta::beginEco()
+{
+  eco_depth_++;
+}
+
+void
+Sta::commitEco()
+{
+  if (eco_depth_ > 0) {
+    eco_depth_--;
+    if (eco_depth_ == 0)
+      applyEcoInvalids();
+  }
+}
+
+void
+Sta::applyEcoInvalids()
+{
+  debugPrint5(debug_, "eco", 1,
+	      "eco pins %zu delays %zu arrivals %zu requireds %zu endpoints %zu\n",
+	      eco_connected_pins_.size(),
+	      eco_delays_invalid_.size(),
+	      eco_arrivals_invalid_.size(),
+	      eco_requireds_invalid_.size(),
+	      eco_endpoints_invalid_.size());
+  for (Pin *pin : eco_connected_pins_) {
+    // The pin may have been disconnected by a later edit.
+    if (network_->net(pin))
+      sdc_->connectPinAfter(pin);
+  }
+  for (Vertex *vertex : eco_delays_invalid_)
+    graph_delay_calc_->delayInvalid(vertex);
+  for (Vertex *vertex : eco_arrivals_invalid_)
+    search_->arrivalInvalid(vertex);
+  for (Vertex *vertex : eco_requireds_invalid_)
+    search_->requiredInvalid(vertex);
+  for (Vertex *vertex : eco_endpoints_invalid_)
+    search_->endpointInvalid(vertex);
+  clearEcoInvalids();
+}
+
+void
+Sta::clearEcoInvalids()
+{
+  eco_connected_pins_.clear();
+  eco_delays_invalid_.clear();
+  eco_arrivals_invalid_.clear();
+  eco_requireds_invalid_.clear();
+  eco_endpoints_invalid_.clear();
+}
+
+void
+Sta::ecoDelayInvalid(Vertex *vertex)
+{
+  if (inEco())
+    eco_delays_invalid_.insert(vertex);
+  else
+    graph_delay_calc_->delayInvalid(vertex);
+}
+
+void
+Sta::ecoArrivalInvalid(Vertex *vertex)
+{
+  if (inEco())
+    eco_arrivals_invalid_.insert(vertex);
+  else
+    search_->arrivalInvalid(vertex);
+}
+
+void
+Sta::ecoRequiredInvalid(Vertex *vertex)
+{
+  if (inEco())
+    eco_requireds_invalid_.insert(vertex);
+  else
+    search_->requiredInvalid(vertex);
+}
+
+void
+Sta::ecoEndpointInvalid(Vertex *vertex)
+{
+  if (inEco())
+    eco_endpoints_invalid_.insert(vertex);
+  else
+    search_->endpointInvalid(vertex);
+}
+
+void
+Sta::ecoDeleteVertexBefore(Vertex *vertex)
+{
+  if (inEco()) {
+    eco_delays_invalid_.erase(vertex);
+    eco_arrivals_invalid_.erase(vertex);
+    eco_requireds_invalid_.erase(vertex);
+    eco_endpoints_invalid_.erase(vertex);
   }
 }
 
@@ -3785,31 +5458,45 @@ Sta::replaceEquivCellBefore(Instance *inst,
       if (port->direction()->isAnyInput()) {
 	Vertex *vertex = graph_->pinLoadVertex(pin);
 	replaceCellPinInvalidate(port, vertex, to_cell);
-
-	// Replace the timing arc sets in the graph edges.
-	VertexOutEdgeIterator edge_iter(vertex, graph_);
-	while (edge_iter.hasNext()) {
-	  Edge *edge = edge_iter.next();
-	  Vertex *to_vertex = edge->to(graph_);
-	  if (network_->instance(to_vertex->pin()) == inst) {
-	    TimingArcSet *from_set = edge->timingArcSet();
-	    // Find corresponding timing arc set.
-	    TimingArcSet *to_set = to_cell->findTimingArcSet(from_set);
-	    if (to_set)
-	      edge->setTimingArcSet(to_set);
-	    else
-	      internalError("corresponding timing arc set not found in equiv cells");
-	  }
-	}
       }
       else {
 	// Force delay calculation on output pins.
 	Vertex *vertex = graph_->pinDrvrVertex(pin);
-	graph_delay_calc_->delayInvalid(vertex);
+	ecoDelayInvalid(vertex);
       }
     }
     delete pin_iter;
+    replaceEquivCellArcSets(inst, to_cell);
+  }
+}
+
+// Replace the timing arc sets in the graph edges.
+void
+Sta::replaceEquivCellArcSets(Instance *inst,
+			     LibertyCell *to_cell)
+{
+  InstancePinIterator *pin_iter = network_->pinIterator(inst);
+  while (pin_iter->hasNext()) {
+    Pin *pin = pin_iter->next();
+    if (network_->direction(pin)->isAnyInput()) {
+      Vertex *vertex = graph_->pinLoadVertex(pin);
+      VertexOutEdgeIterator edge_iter(vertex, graph_);
+      while (edge_iter.hasNext()) {
+	Edge *edge = edge_iter.next();
+	Vertex *to_vertex = edge->to(graph_);
+	if (network_->instance(to_vertex->pin()) == inst) {
+	  TimingArcSet *from_set = edge->timingArcSet();
+	  // Find corresponding timing arc set.
+	  TimingArcSet *to_set = to_cell->findTimingArcSet(from_set);
+	  if (to_set)
+	    edge->setTimingArcSet(to_set);
+	  else
+	    internalError("corresponding timing arc set not found in equiv cells");
+	}
+      }
+    }
   }
+  delete pin_iter;
 }
 
 void
@@ -3898,6 +5585,7 @@ Sta::replaceCellBefore(Instance *inst,
 void
 Sta::replaceCellAfter(Instance *inst)
 {
+  sdc_->timingDerateCellChanged(inst);
   if (graph_) {
     graph_->makeInstanceEdges(inst);
     InstancePinIterator *pin_iter = network_->pinIterator(inst);
@@ -3914,6 +5602,8 @@ Sta::replaceCellAfter(Instance *inst)
 void
 Sta::connectPinAfter(Pin *pin)
 {
+  if (placement_parasitics_)
+    placement_parasitics_->netChanged(pin);
   if (graph_) {
     if (network_->isHierarchical(pin)) {
       graph_->makeWireEdgesThruPin(pin);
@@ -3926,17 +5616,17 @@ Sta::connectPinAfter(Pin *pin)
     }
     else {
       Vertex *vertex, *bidir_drvr_vertex;
-      if (network_->vertexIndex(pin) == 0) {
+      if (graph_->pinVertexIndex(pin) == 0) {
 	graph_->makePinVertices(pin, vertex, bidir_drvr_vertex);
 	graph_->makePinInstanceEdges(pin);
       }
       else
 	graph_->pinVertices(pin, vertex, bidir_drvr_vertex);
-      search_->arrivalInvalid(vertex);
-      search_->requiredInvalid(vertex);
+      ecoArrivalInvalid(vertex);
+      ecoRequiredInvalid(vertex);
       if (bidir_drvr_vertex) {
-	search_->arrivalInvalid(bidir_drvr_vertex);
-	search_->requiredInvalid(bidir_drvr_vertex);
+	ecoArrivalInvalid(bidir_drvr_vertex);
+	ecoRequiredInvalid(bidir_drvr_vertex);
       }
 
       // Make interconnect edges from/to pin.
@@ -3952,7 +5642,10 @@ Sta::connectPinAfter(Pin *pin)
       }
     }
   }
-  sdc_->connectPinAfter(pin);
+  if (inEco())
+    eco_connected_pins_.insert(pin);
+  else
+    sdc_->connectPinAfter(pin);
   sim_->connectPinAfter(pin);
 }
 
@@ -3964,14 +5657,14 @@ Sta::connectDrvrPinAfter(Vertex *vertex)
   while (edge_iter.hasNext()) {
     Edge *edge = edge_iter.next();
     Vertex *to_vertex = edge->to(graph_);
-    search_->arrivalInvalid(to_vertex);
-    search_->endpointInvalid(to_vertex);
+    ecoArrivalInvalid(to_vertex);
+    ecoEndpointInvalid(to_vertex);
     sdc_->clkHpinDisablesChanged(to_vertex->pin());
   }
   sdc_->clkHpinDisablesChanged(vertex->pin());
-  graph_delay_calc_->delayInvalid(vertex);
-  search_->requiredInvalid(vertex);
-  search_->endpointInvalid(vertex);
+  ecoDelayInvalid(vertex);
+  ecoRequiredInvalid(vertex);
+  ecoEndpointInvalid(vertex);
   levelize_->invalidFrom(vertex);
 }
 
@@ -3983,21 +5676,23 @@ Sta::connectLoadPinAfter(Vertex *vertex)
   while (edge_iter.hasNext()) {
     Edge *edge = edge_iter.next();
     Vertex *from_vertex = edge->from(graph_);
-    graph_delay_calc_->delayInvalid(from_vertex);
-    search_->requiredInvalid(from_vertex);
+    ecoDelayInvalid(from_vertex);
+    ecoRequiredInvalid(from_vertex);
     sdc_->clkHpinDisablesChanged(from_vertex->pin());
   }
   sdc_->clkHpinDisablesChanged(vertex->pin());
-  graph_delay_calc_->delayInvalid(vertex);
+  ecoDelayInvalid(vertex);
   levelize_->invalidFrom(vertex);
-  search_->arrivalInvalid(vertex);
-  search_->endpointInvalid(vertex);
+  ecoArrivalInvalid(vertex);
+  ecoEndpointInvalid(vertex);
 }
 
 void
 Sta::disconnectPinBefore(Pin *pin)
 {
   parasitics_->disconnectPinBefore(pin);
+  if (placement_parasitics_)
+    placement_parasitics_->netChanged(pin);
   sdc_->disconnectPinBefore(pin);
   sim_->disconnectPinBefore(pin);
   if (graph_) {
@@ -4042,9 +5737,9 @@ Sta::deleteEdge(Edge *edge)
 {
   Vertex *from = edge->from(graph_);
   Vertex *to = edge->to(graph_);
-  search_->arrivalInvalid(to);
-  search_->requiredInvalid(from);
-  graph_delay_calc_->delayInvalid(to);
+  ecoArrivalInvalid(to);
+  ecoRequiredInvalid(from);
+  ecoDelayInvalid(to);
   levelize_->relevelizeFrom(to);
   levelize_->deleteEdgeBefore(edge);
   sdc_->clkHpinDisablesChanged(edge->from(graph_)->pin());
@@ -4089,6 +5784,14 @@ Sta::deleteInstanceBefore(Instance *inst)
       deleteInstanceBefore(child);
     }
     delete child_iter;
+    if (inEco()) {
+      InstancePinIterator *pin_iter = network_->pinIterator(inst);
+      while (pin_iter->hasNext()) {
+	Pin *pin = pin_iter->next();
+	eco_connected_pins_.erase(pin);
+      }
+      delete pin_iter;
+    }
   }
 }
 
@@ -4107,6 +5810,9 @@ Sta::deleteLeafInstanceBefore(Instance *inst)
 void
 Sta::deletePinBefore(Pin *pin)
 {
+  eco_connected_pins_.erase(pin);
+  if (placement_parasitics_)
+    placement_parasitics_->deletePinBefore(pin);
   if (graph_) {
     if (network_->isLoad(pin)) {
       Vertex *vertex = graph_->pinLoadVertex(pin);
@@ -4114,6 +5820,7 @@ Sta::deletePinBefore(Pin *pin)
       levelize_->deleteVertexBefore(vertex);
       graph_delay_calc_->deleteVertexBefore(vertex);
       search_->deleteVertexBefore(vertex);
+      ecoDeleteVertexBefore(vertex);
 
       VertexInEdgeIterator in_edge_iter(vertex, graph_);
       while (in_edge_iter.hasNext()) {
@@ -4121,7 +5828,7 @@ Sta::deletePinBefore(Pin *pin)
 	if (edge->role()->isWire()) {
 	  Vertex *from = edge->from(graph_);
 	  // Only notify from vertex (to vertex will be deleted).
-	  search_->requiredInvalid(from);
+	  ecoRequiredInvalid(from);
 	}
 	levelize_->deleteEdgeBefore(edge);
       }
@@ -4133,6 +5840,7 @@ Sta::deletePinBefore(Pin *pin)
       levelize_->deleteVertexBefore(vertex);
       graph_delay_calc_->deleteVertexBefore(vertex);
       search_->deleteVertexBefore(vertex);
+      ecoDeleteVertexBefore(vertex);
 
       VertexOutEdgeIterator edge_iter(vertex, graph_);
       while (edge_iter.hasNext()) {
@@ -4142,7 +5850,7 @@ Sta::deletePinBefore(Pin *pin)
 	  Vertex *to = edge->to(graph_);
 	  // to->prev_paths point to vertex, so delete them.
 	  search_->arrivalInvalidDelete(to);
-	  graph_delay_calc_->delayInvalid(to);
+	  ecoDelayInvalid(to);
 	  levelize_->relevelizeFrom(to);
 	}
 	levelize_->deleteEdgeBefore(edge);
@@ -4155,6 +5863,7 @@ Sta::deletePinBefore(Pin *pin)
       levelize_->deleteVertexBefore(vertex);
       graph_delay_calc_->deleteVertexBefore(vertex);
       search_->deleteVertexBefore(vertex);
+      ecoDeleteVertexBefore(vertex);
       graph_->deleteVertex(vertex);
     }
   }
@@ -4199,9 +5908,9 @@ Sta::delaysInvalidFrom(Pin *pin)
 void
 Sta::delaysInvalidFrom(Vertex *vertex)
 {
-  search_->arrivalInvalid(vertex);
-  search_->requiredInvalid(vertex);
-  graph_delay_calc_->delayInvalid(vertex);
+  ecoArrivalInvalid(vertex);
+  ecoRequiredInvalid(vertex);
+  ecoDelayInvalid(vertex);
 }
 
 void
@@ -4259,7 +5968,7 @@ Sta::delaysInvalidFromFanin(Vertex *vertex)
     Edge *edge = edge_iter.next();
     Vertex *from_vertex = edge->from(graph_);
     delaysInvalidFrom(from_vertex);
-    search_->requiredInvalid(from_vertex);
+    ecoRequiredInvalid(from_vertex);
   }
 }
 
@@ -4455,11 +6164,51 @@ Sta::findFaninPins(PinSeq *to,
 		   int pin_levels,
 		   bool thru_disabled,
 		   bool thru_constants)
+{
+  PinSeq *fanin_seq = findFaninPinSeq(to, flat, startpoints_only,
+				      inst_levels, pin_levels,
+				      thru_disabled, thru_constants);
+  PinSet *fanin = new PinSet;
+  for (auto pin : *fanin_seq)
+    fanin->insert(pin);
+  delete fanin_seq;
+  return fanin;
+}
+
+PinSeq *
+Sta::findFaninPinSeq(PinSeq *to,
+		     bool flat,
+		     bool startpoints_only,
+		     int inst_levels,
+		     int pin_levels,
+		     bool thru_disabled,
+		     bool thru_constants)
 {
   ensureGraph();
   ensureLevelized();
-  PinSet *fanin = new PinSet;
+  PinSeq *fanin = new PinSeq;
   FaninSrchPred pred(thru_disabled, thru_constants, this);
+  VertexSeq seeds;
+  faninSeeds(to, seeds);
+  if (inst_levels <= 0 && pin_levels <= 0)
+    findConePins(seeds, true, flat, startpoints_only, pred, *fanin);
+  else {
+    PinSet fanin_set;
+    for (auto vertex : seeds)
+      findFaninPins(vertex, flat, startpoints_only,
+		    inst_levels, pin_levels, &fanin_set, pred);
+    PinSet::Iterator pin_iter(fanin_set);
+    while (pin_iter.hasNext())
+      fanin->push_back(pin_iter.next());
+  }
+  return fanin;
+}
+
+void
+Sta::faninSeeds(PinSeq *to,
+		// Return value.
+		VertexSeq &seeds)
+{
   PinSeq::Iterator to_iter(to);
   while (to_iter.hasNext()) {
     Pin *pin = to_iter.next();
@@ -4467,17 +6216,15 @@ Sta::findFaninPins(PinSeq *to,
       EdgesThruHierPinIterator edge_iter(pin, network_, graph_);
       while (edge_iter.hasNext()) {
 	Edge *edge = edge_iter.next();
-	findFaninPins(edge->from(graph_), flat, startpoints_only,
-		      inst_levels, pin_levels, fanin, pred);
+	seeds.push_back(edge->from(graph_));
       }
     }
     else {
       Vertex *vertex = graph_->pinLoadVertex(pin);
-      findFaninPins(vertex, flat, startpoints_only,
-		    inst_levels, pin_levels, fanin, pred);
+      if (vertex)
+	seeds.push_back(vertex);
     }
   }
-  return fanin;
 }
 
 void
@@ -4565,11 +6312,51 @@ Sta::findFanoutPins(PinSeq *from,
 		    int pin_levels,
 		    bool thru_disabled,
 		    bool thru_constants)
+{
+  PinSeq *fanout_seq = findFanoutPinSeq(from, flat, endpoints_only,
+					inst_levels, pin_levels,
+					thru_disabled, thru_constants);
+  PinSet *fanout = new PinSet;
+  for (auto pin : *fanout_seq)
+    fanout->insert(pin);
+  delete fanout_seq;
+  return fanout;
+}
+
+PinSeq *
+Sta::findFanoutPinSeq(PinSeq *from,
+		      bool flat,
+		      bool endpoints_only,
+		      int inst_levels,
+		      int pin_levels,
+		      bool thru_disabled,
+		      bool thru_constants)
 {
   ensureGraph();
   ensureLevelized();
-  PinSet *fanout = new PinSet;
+  PinSeq *fanout = new PinSeq;
   FanInOutSrchPred pred(thru_disabled, thru_constants, this);
+  VertexSeq seeds;
+  fanoutSeeds(from, seeds);
+  if (inst_levels <= 0 && pin_levels <= 0)
+    findConePins(seeds, false, flat, endpoints_only, pred, *fanout);
+  else {
+    PinSet fanout_set;
+    for (auto vertex : seeds)
+      findFanoutPins(vertex, flat, endpoints_only,
+		     inst_levels, pin_levels, &fanout_set, pred);
+    PinSet::Iterator pin_iter(fanout_set);
+    while (pin_iter.hasNext())
+      fanout->push_back(pin_iter.next());
+  }
+  return fanout;
+}
+
+void
+Sta::fanoutSeeds(PinSeq *from,
+		 // Return value.
+		 VertexSeq &seeds)
+{
   PinSeq::Iterator from_iter(from);
   while (from_iter.hasNext()) {
     Pin *pin = from_iter.next();
@@ -4577,17 +6364,15 @@ Sta::findFanoutPins(PinSeq *from,
       EdgesThruHierPinIterator edge_iter(pin, network_, graph_);
       while (edge_iter.hasNext()) {
 	Edge *edge = edge_iter.next();
-	findFanoutPins(edge->to(graph_), flat, endpoints_only,
-		       inst_levels, pin_levels, fanout, pred);
+	seeds.push_back(edge->to(graph_));
       }
     }
     else {
       Vertex *vertex = graph_->pinDrvrVertex(pin);
-      findFanoutPins(vertex, flat, endpoints_only,
-		     inst_levels, pin_levels, fanout, pred);
+      if (vertex)
+	seeds.push_back(vertex);
     }
   }
-  return fanout;
 }
 
 void
@@ -4651,6 +6436,125 @@ Sta::findFanoutPins(Vertex *from,
   }
 }
 
+class VertexIndexLess
+{
+public:
+  explicit VertexIndexLess(const Graph *graph) :
+    graph_(graph)
+  {
+  }
+  bool operator()(const Vertex *vertex1,
+		  const Vertex *vertex2) const
+  {
+    return graph_->index(vertex1) < graph_->index(vertex2);
+  }
+
+private:
+  const Graph *graph_;
+};
+
+// Breadth first search of the fanin or fanout cone of seeds without
+// level limits. Each level of the search is expanded in parallel.
+// The cone is the same as the depth first search of each seed
+// because the search stops depend only on the vertex and edge.
+void
+Sta::findConePins(VertexSeq &seeds,
+		  bool fanin,
+		  bool flat,
+		  bool ends_only,
+		  SearchPred &pred,
+		  // Return value.
+		  PinSeq &pins)
+{
+  VertexVisitedBits visited(graph_->vertexIndexBound());
+  VertexSeq cone;
+  VertexSeq frontier;
+  for (auto vertex : seeds) {
+    if (visited.visit(graph_->index(vertex)))
+      frontier.push_back(vertex);
+  }
+  int thread_count = thread_pool_ ? thread_pool_->threadCount() : 1;
+  std::vector<VertexSeq> nexts(std::max(thread_count, 1));
+  while (!frontier.empty()) {
+    forEachChunk(frontier.size(), thread_pool_,
+		 [&] (size_t begin, size_t end, int thread_index) {
+		   for (size_t i = begin; i < end; i++)
+		     findConeNext(frontier[i], fanin, flat, pred, visited,
+				  nexts[thread_index]);
+		 });
+    cone.insert(cone.end(), frontier.begin(), frontier.end());
+    frontier.clear();
+    for (auto &next : nexts) {
+      frontier.insert(frontier.end(), next.begin(), next.end());
+      next.clear();
+    }
+  }
+
+  sort(cone, VertexIndexLess(graph_));
+  std::vector<char> keep(cone.size(), 1);
+  if (ends_only) {
+    forEachChunk(cone.size(), thread_pool_,
+		 [&] (size_t begin, size_t end, int) {
+		   for (size_t i = begin; i < end; i++) {
+		     Vertex *vertex = cone[i];
+		     if (fanin)
+		       keep[i] = network_->isRegClkPin(vertex->pin())
+			 || !hasFanin(vertex, &pred, graph_);
+		     else
+		       keep[i] = search_->isEndpoint(vertex, &pred);
+		   }
+		 });
+  }
+  for (size_t i = 0; i < cone.size(); i++) {
+    if (keep[i])
+      pins.push_back(cone[i]->pin());
+  }
+}
+
+// Append the unvisited fanin (fanout) vertices of vertex to next.
+void
+Sta::findConeNext(Vertex *vertex,
+		  bool fanin,
+		  bool flat,
+		  SearchPred &pred,
+		  VertexVisitedBits &visited,
+		  // Return value.
+		  VertexSeq &next)
+{
+  if (fanin) {
+    if (!network_->isRegClkPin(vertex->pin())
+	&& pred.searchTo(vertex)) {
+      VertexInEdgeIterator edge_iter(vertex, graph_);
+      while (edge_iter.hasNext()) {
+	Edge *edge = edge_iter.next();
+	Vertex *from_vertex = edge->from(graph_);
+	if (pred.searchThru(edge)
+	    && (flat
+		|| !crossesHierarchy(edge))
+	    && pred.searchFrom(from_vertex)
+	    && visited.visit(graph_->index(from_vertex)))
+	  next.push_back(from_vertex);
+      }
+    }
+  }
+  else {
+    if (!search_->isEndpoint(vertex, &pred)
+	&& pred.searchFrom(vertex)) {
+      VertexOutEdgeIterator edge_iter(vertex, graph_);
+      while (edge_iter.hasNext()) {
+	Edge *edge = edge_iter.next();
+	Vertex *to_vertex = edge->to(graph_);
+	if (pred.searchThru(edge)
+	    && (flat
+		|| !crossesHierarchy(edge))
+	    && pred.searchTo(to_vertex)
+	    && visited.visit(graph_->index(to_vertex)))
+	  next.push_back(to_vertex);
+      }
+    }
+  }
+}
+
 InstanceSet *
 Sta::findFanoutInstances(PinSeq *from,
 			 bool flat,
@@ -4665,6 +6569,119 @@ Sta::findFanoutInstances(PinSeq *from,
   return pinInstances(pins, network_);
 }
 
+int
+Sta::reduceToInterfaceLogic()
+{
+  ensureGraph();
+  ensureLevelized();
+  // Constants and disabled timing can change after the reduction so
+  // search thru them.
+  FanInOutSrchPred fanout_pred(true, true, this);
+  FaninSrchPred fanin_pred(true, true, this);
+  PinSet interface_pins;
+  Instance *top_inst = network_->topInstance();
+  InstancePinIterator *port_iter = network_->pinIterator(top_inst);
+  while (port_iter->hasNext()) {
+    Pin *pin = port_iter->next();
+    PortDirection *dir = network_->direction(pin);
+    // Clock fanout stops at the register clock pins so clock ports
+    // would keep every register; the clock trees are found below.
+    if (dir->isAnyInput() && !sdc_->isClock(pin)) {
+      Vertex *vertex = graph_->pinDrvrVertex(pin);
+      if (vertex)
+	findFanoutPins(vertex, true, false, 0, 0, &interface_pins,
+		       fanout_pred);
+    }
+    if (dir->isAnyOutput()) {
+      Vertex *vertex = graph_->pinLoadVertex(pin);
+      if (vertex)
+	findFaninPins(vertex, true, false, 0, 0, &interface_pins,
+		      fanin_pred);
+    }
+  }
+  delete port_iter;
+
+  InstanceSet interface_insts;
+  PinSet::Iterator pin_iter(interface_pins);
+  while (pin_iter.hasNext()) {
+    Pin *pin = pin_iter.next();
+    if (!network_->isTopLevelPort(pin))
+      interface_insts.insert(network_->instance(pin));
+  }
+  findInterfaceClkTrees(interface_insts, fanin_pred);
+
+  // Keep the loads of the interface instance outputs.
+  InstanceSet keep_insts = interface_insts;
+  InstanceSet::Iterator inst_iter(interface_insts);
+  while (inst_iter.hasNext()) {
+    Instance *inst = inst_iter.next();
+    InstancePinIterator *inst_pin_iter = network_->pinIterator(inst);
+    while (inst_pin_iter->hasNext()) {
+      Pin *pin = inst_pin_iter->next();
+      Vertex *vertex = graph_->pinDrvrVertex(pin);
+      if (vertex && network_->isDriver(pin)) {
+	VertexOutEdgeIterator edge_iter(vertex, graph_);
+	while (edge_iter.hasNext()) {
+	  Edge *edge = edge_iter.next();
+	  if (edge->isWire()) {
+	    Pin *load_pin = edge->to(graph_)->pin();
+	    if (!network_->isTopLevelPort(load_pin))
+	      keep_insts.insert(network_->instance(load_pin));
+	  }
+	}
+      }
+    }
+    delete inst_pin_iter;
+  }
+
+  InstanceSeq delete_insts;
+  LeafInstanceIterator *leaf_iter = network_->leafInstanceIterator();
+  while (leaf_iter->hasNext()) {
+    Instance *inst = leaf_iter->next();
+    if (!keep_insts.hasKey(inst))
+      delete_insts.push_back(inst);
+  }
+  delete leaf_iter;
+  InstanceSeq::Iterator delete_iter(delete_insts);
+  while (delete_iter.hasNext())
+    deleteInstance(delete_iter.next());
+  return delete_insts.size();
+}
+
+// Add the fanin of the register clock pins of interface_insts.
+void
+Sta::findInterfaceClkTrees(InstanceSet &interface_insts,
+			   SearchPred &pred)
+{
+  PinSet clk_tree_pins;
+  InstanceSet::Iterator inst_iter(interface_insts);
+  while (inst_iter.hasNext()) {
+    Instance *inst = inst_iter.next();
+    InstancePinIterator *pin_iter = network_->pinIterator(inst);
+    while (pin_iter->hasNext()) {
+      Pin *pin = pin_iter->next();
+      Vertex *vertex = graph_->pinLoadVertex(pin);
+      // The fanin search does not leave register clock pins so
+      // start from their drivers.
+      if (vertex && network_->isRegClkPin(pin)) {
+	VertexInEdgeIterator edge_iter(vertex, graph_);
+	while (edge_iter.hasNext()) {
+	  Edge *edge = edge_iter.next();
+	  findFaninPins(edge->from(graph_), true, false, 0, 0,
+			&clk_tree_pins, pred);
+	}
+      }
+    }
+    delete pin_iter;
+  }
+  PinSet::Iterator pin_iter(clk_tree_pins);
+  while (pin_iter.hasNext()) {
+    Pin *pin = pin_iter.next();
+    if (!network_->isTopLevelPort(pin))
+      interface_insts.insert(network_->instance(pin));
+  }
+}
+
 static InstanceSet *
 pinInstances(PinSet *pins,
 	     const Network *network)
@@ -4793,10 +6810,12 @@ Sta::pinMinSlewLimitSlack(const Corner *corner,
 
 PinSeq *
 Sta::pinSlewLimitViolations(const Corner *corner,
-			    const MinMax *min_max)
+			    const MinMax *min_max,
+			    size_t max_count)
 {
   checkSlewLimitPreamble();
-  return check_slew_limits_->pinSlewLimitViolations(corner, min_max);
+  return check_slew_limits_->pinSlewLimitViolations(corner, min_max,
+						    max_count);
 }
 
 void
@@ -4877,10 +6896,11 @@ Sta::minPulseWidthChecks(const Corner *corner)
 }
 
 MinPulseWidthCheckSeq &
-Sta::minPulseWidthViolations(const Corner *corner)
+Sta::minPulseWidthViolations(const Corner *corner,
+			     size_t max_count)
 {
   minPulseWidthPreamble();
-  return check_min_pulse_widths_->violations(corner);
+  return check_min_pulse_widths_->violations(corner, max_count);
 }
 
 MinPulseWidthCheck *
@@ -4907,10 +6927,10 @@ Sta::reportMpwCheck(MinPulseWidthCheck *check,
 ////////////////////////////////////////////////////////////////
 
 MinPeriodCheckSeq &
-Sta::minPeriodViolations()
+Sta::minPeriodViolations(size_t max_count)
 {
   minPeriodPreamble();
-  return check_min_periods_->violations();
+  return check_min_periods_->violations(max_count);
 }
 
 MinPeriodCheck *
@@ -4946,10 +6966,10 @@ Sta::reportCheck(MinPeriodCheck *check,
 ////////////////////////////////////////////////////////////////
 
 MaxSkewCheckSeq &
-Sta::maxSkewViolations()
+Sta::maxSkewViolations(size_t max_count)
 {
   maxSkewPreamble();
-  return check_max_skews_->violations();
+  return check_max_skews_->violations(max_count);
 }
 
 MaxSkewCheck *
@@ -5014,4 +7034,18 @@ Sta::power(const Instance *inst,
   power_->power(inst, corner, result);
 }
 
+bool
+Sta::readVcdActivities(const char *filename,
+		       const char *scope)
+{
+  return sta::readVcdActivities(filename, scope, power_);
+}
+
+bool
+Sta::readSaifActivities(const char *filename,
+			const char *scope)
+{
+  return sta::readSaifActivities(filename, scope, power_);
+}
+
 } // namespace
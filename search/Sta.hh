@@ -57,9 +57,33 @@ class ClkSkews;
 class ReportField;
 class Power;
 class PowerResult;
+class PlacementParasitics;
+class VertexVisitedBits;
 class ClockIterator;
+class StaMode;
 
 typedef InstanceSeq::Iterator SlowDrvrIterator;
+typedef Vector<StaMode*> StaModeSeq;
+
+// Arc delay for Sta::setArcDelays.
+class ArcDelayValue
+{
+public:
+  Edge *edge_;
+  TimingArc *arc_;
+  DcalcAPIndex ap_index_;
+  ArcDelay delay_;
+};
+
+// Vertex slew for Sta::setAnnotatedSlews.
+class VertexSlewValue
+{
+public:
+  Vertex *vertex_;
+  const TransRiseFall *tr_;
+  DcalcAPIndex ap_index_;
+  Slew slew_;
+};
 typedef Vector<const char*> CheckError;
 typedef Vector<CheckError*> CheckErrorSeq;
 
@@ -102,11 +126,73 @@ public:
   // Default number of threads to use.
   virtual int defaultThreadCount() const;
   void setThreadCount(int thread_count);
+  // TCL variable sta_dataflow_scheduling.
+  // Visit vertices in parallel delay calculation and arrival search as
+  // soon as their fanin is done instead of level by level.
+  void setDataflowScheduling(bool enable);
+  // TCL variable sta_parallel_constant_propagation.
+  // Propagate constants level by level on multiple threads.
+  bool parallelConstantPropagation() const;
+  void setParallelConstantPropagation(bool enable);
+  // TCL variable sta_clk_domain_partitions.
+  // Search the fanout of each clock domain that does not mix with other
+  // domains on its own thread.
+  bool clkDomainPartitions() const;
+  void setClkDomainPartitions(bool partitions);
+  // TCL variable sta_prev_path_storage.
+  // Keep clock path prevs with the arrivals (default) or find them from
+  // the fanin arrivals when they are needed to save memory.
+  bool prevPathStorage() const;
+  void setPrevPathStorage(bool storage);
+  // TCL variable sta_pocv_statistical_max.
+  // Merge pocv data arrivals with Clark's statistical max.
+  bool pocvStatisticalMax() const;
+  void setPocvStatisticalMax(bool statistical_max);
+  // TCL variable sta_aocv_enabled.
+  // Scale cell delays by the AOCV derates at the cell logic depth.
+  bool aocvEnabled() const;
+  void setAocvEnabled(bool enabled);
+  // TCL variable sta_quantized_slews.
+  // Store slews in 16 bits to save memory.
+  bool quantizedSlews() const;
+  void setQuantizedSlews(bool quantized);
 
+  // Groups with a type in skip_groups are not read (nullptr reads
+  // all groups; see makeLibertySkipGroups).
   virtual LibertyLibrary *readLiberty(const char *filename,
 				      Corner *corner,
 				      const MinMaxAll *min_max,
-				      bool infer_latches);
+				      bool infer_latches,
+				      const StringSet *skip_groups);
+  // Read a library from a cache written by writeLibertyCache.
+  // With lazy the cells are not made until they are referenced
+  // by name (linking, get_lib_cells).
+  LibertyLibrary *readLibertyCache(const char *cache_filename,
+				   Corner *corner,
+				   const MinMaxAll *min_max,
+				   bool infer_latches,
+				   bool lazy);
+  // Read liberty files and/or liberty caches in parallel with the
+  // thread pool. Each file is parsed or read by its own thread.
+  // The libraries are added to the network and corner in filename order.
+  // Return true if all of the libraries were read.
+  bool readLibertyFiles(StringSeq *filenames,
+			Corner *corner,
+			const MinMaxAll *min_max,
+			bool infer_latches,
+			const StringSet *skip_groups);
+  // Parse liberty filename and save it in a binary cache that
+  // readLibertyCache reads without parsing.
+  void writeLibertyCache(const char *filename,
+			 const char *cache_filename);
+  // Map a shared table values file written by writeLibertyTableValues.
+  // Libraries read after this reference the table values in the file
+  // instead of private copies, so processes mapping the same file
+  // share the pages.
+  bool readLibertyTableValues(const char *filename);
+  // Write the table values of the libraries that have been read to a
+  // shared table values file.
+  void writeLibertyTableValues(const char *filename);
   bool setMinLibrary(const char *min_filename,
 		     const char *max_filename);
   // Network readers call this to notify the Sta to delete any previously
@@ -114,6 +200,12 @@ public:
   void readNetlistBefore();
   // Return true if successful.
   bool linkDesign(const char *top_cell_name);
+  // Save the linked network in a binary database that readNetworkDb
+  // loads without reading and linking verilog.
+  void writeNetworkDb(const char *filename);
+  // Liberty libraries used by the network must be read first.
+  // Return true if successful.
+  bool readNetworkDb(const char *filename);
   bool linkMakeBlackBoxes() const;
   void setLinkMakeBlackBoxes(bool make);
 
@@ -147,6 +239,20 @@ public:
 		       const EarlyLate *early_late,
 		       float derate);
   void unsetTimingDerate();
+  // Advanced on-chip variation cell delay derates by logic depth.
+  // depths must be increasing. The derates are used with AOCV enabled.
+  void setAocvDerate(PathClkOrData clk_data,
+		     const TransRiseFallBoth *tr,
+		     const EarlyLate *early_late,
+		     const FloatSeq *depths,
+		     const FloatSeq *derates);
+  void setAocvDerate(const LibertyCell *cell,
+		     PathClkOrData clk_data,
+		     const TransRiseFallBoth *tr,
+		     const EarlyLate *early_late,
+		     const FloatSeq *depths,
+		     const FloatSeq *derates);
+  void unsetAocvDerates();
   void setInputSlew(Port *port,
 		    const TransRiseFallBoth *tr,
 		    const MinMaxAll *min_max,
@@ -468,6 +574,19 @@ public:
   void setCaseAnalysis(Pin *pin,
 		       LogicValue value);
   void removeCaseAnalysis(Pin *pin);
+  // Save the current set_case_analysis values as a mode for
+  // caseAnalysisModeValue.  Returns the mode index.
+  int addCaseAnalysisMode();
+  int caseAnalysisModeCount();
+  void clearCaseAnalysisModes();
+  // Switch the set_case_analysis values to those of mode.
+  // The constants for the mode are taken from the case modes, so
+  // only the delays and arrivals around the constants that change
+  // are invalidated.
+  void setCaseAnalysisMode(int mode);
+  // Constants for all modes are propagated together.
+  LogicValue caseAnalysisModeValue(const Pin *pin,
+				   int mode);
   void setInputDelay(Pin *pin,
 		     const TransRiseFallBoth *tr,
 		     Clock *clk,
@@ -605,6 +724,25 @@ public:
 		      int pin_levels,
 		      bool thru_disabled,
 		      bool thru_constants);
+  // findFaninPins/findFanoutPins with the pins in vertex index order.
+  // Cones without level limits are searched one level at a time
+  // in parallel.
+  PinSeq *
+  findFaninPinSeq(PinSeq *to,
+		  bool flat,
+		  bool startpoints_only,
+		  int inst_levels,
+		  int pin_levels,
+		  bool thru_disabled,
+		  bool thru_constants);
+  PinSeq *
+  findFanoutPinSeq(PinSeq *from,
+		   bool flat,
+		   bool endpoints_only,
+		   int inst_levels,
+		   int pin_levels,
+		   bool thru_disabled,
+		   bool thru_constants);
 
   // The set of clocks that reach pin.
   void clocks(const Pin *pin,
@@ -615,10 +753,12 @@ public:
   // corner=nullptr checks all corners.
   Pin *pinMinSlewLimitSlack(const Corner *corner,
 			    const MinMax *min_max);
-  // Return all pins with min/max slew violations.
+  // Return pins with min/max slew violations sorted by slack.
   // corner=nullptr checks all corners.
+  // max_count=0 returns all violators.
   PinSeq *pinSlewLimitViolations(const Corner *corner,
-				 const MinMax *min_max);
+				 const MinMax *min_max,
+				 size_t max_count);
   void reportSlewLimitShortHeader();
   void reportSlewLimitShort(Pin *pin,
 			    const Corner *corner,
@@ -640,7 +780,9 @@ public:
   MinPulseWidthCheck *minPulseWidthSlack(const Corner *corner);
   // All violating min pulse width checks.
   // corner=nullptr checks all corners.
-  MinPulseWidthCheckSeq &minPulseWidthViolations(const Corner *corner);
+  // max_count > 0 returns the max_count checks with the least slack.
+  MinPulseWidthCheckSeq &minPulseWidthViolations(const Corner *corner,
+						 size_t max_count);
   // Min pulse width checks for pins.
   // corner=nullptr checks all corners.
   MinPulseWidthCheckSeq &minPulseWidthChecks(PinSeq *pins,
@@ -656,7 +798,8 @@ public:
   // Min period check with the least slack.
   MinPeriodCheck *minPeriodSlack();
   // All violating min period checks.
-  MinPeriodCheckSeq &minPeriodViolations();
+  // max_count > 0 returns the max_count checks with the least slack.
+  MinPeriodCheckSeq &minPeriodViolations(size_t max_count);
   void reportChecks(MinPeriodCheckSeq *checks,
 		    bool verbose);
   void reportCheck(MinPeriodCheck *check,
@@ -664,8 +807,9 @@ public:
 
   // Max skew check with the least slack.
   MaxSkewCheck *maxSkewSlack();
-  // All violating min period checks.
-  MaxSkewCheckSeq &maxSkewViolations();
+  // All violating max skew checks.
+  // max_count > 0 returns the max_count checks with the least slack.
+  MaxSkewCheckSeq &maxSkewViolations(size_t max_count);
   void reportChecks(MaxSkewCheckSeq *checks,
 		    bool verbose);
   void reportCheck(MaxSkewCheck *check,
@@ -712,6 +856,18 @@ public:
 			const MinMaxAll *min_max,
 			const TransRiseFallBoth *tr,
 			float slew);
+  // Set the delays of count timing arcs, for delay calculators outside
+  // of the STA. The values are written in parallel and annotated so
+  // delay calculation does not clobber them. Arrivals and requireds are
+  // invalidated once for all of the arcs.
+  // An (edge, arc, ap_index) should only appear once.
+  void setArcDelays(const ArcDelayValue *delays,
+		    size_t count);
+  // Set the annotated slews of count vertices with one delay
+  // calculation invalidation.
+  // A (vertex, tr, ap_index) should only appear once.
+  void setAnnotatedSlews(const VertexSlewValue *slews,
+			 size_t count);
   void writeSdf(const char *filename,
 		Corner *corner,
 		char sdf_divider,
@@ -719,6 +875,41 @@ public:
 		bool gzip,
 		bool no_timestamp,
 		bool no_version);
+  // Save the delay calculation results to filename.
+  // Throws FileNotWritable.
+  void writeTimingCheckpoint(const char *filename);
+  // Restore delay calculation results saved by writeTimingCheckpoint
+  // in a session with the same design, parasitics and constraints.
+  // Throws FileNotReadable.
+  // Return true if the checkpoint was restored.
+  bool readTimingCheckpoint(const char *filename);
+  // Write graph slews, arc delays and timing check values keyed by pin
+  // names (see DelayAnnotations.hh).
+  // Throws FileNotWritable.
+  void writeDelayAnnotations(const char *filename);
+  // Annotate the slews and delays written by writeDelayAnnotations so
+  // delay calculation does not recalculate them.
+  // Throws FileNotReadable.
+  bool readDelayAnnotations(const char *filename);
+  // Write vertex, edge and arc slews, delays and slacks as columnar
+  // binary tables in directory dirname (see TimingColumns.hh).
+  // Throws FileNotWritable.
+  void writeTimingColumns(const char *dirname);
+  // Write the boundary arrivals, slews and requireds of a hierarchical
+  // instance for timing it in a separate session.
+  // Throws FileNotWritable.
+  void writeBoundaryTiming(Instance *inst,
+			   const char *filename);
+  // Apply boundary timing written by writeBoundaryTiming to the
+  // top level ports.
+  // Throws FileNotReadable.
+  bool readBoundaryTiming(const char *filename);
+  // Write a liberty library with a cell named cell_name that models
+  // the interface timing of the design at corner.
+  // Throws FileNotWritable.
+  void writeTimingModel(const char *cell_name,
+			const char *filename,
+			const Corner *corner);
   // Remove all delay and slew annotations.
   void removeDelaySlewAnnotations();
   // TCL variable sta_crpr_enabled.
@@ -782,11 +973,14 @@ public:
 				     bool reg_no_clks,
 				     bool unconstrained_endpoints,
 				     bool loops,
-				     bool generated_clks);
+				     bool generated_clks,
+				     // Only count the errors when false.
+				     bool verbose);
   // Path from/thrus/to filter.
   // from/thrus/to are owned and deleted by Search.
   // Returned sequence is owned by the caller.
-  // PathEnds are owned by Search PathGroups and deleted on next call.
+  // PathEnds are owned by Search PathGroups and deleted on next call,
+  // so only one thread may call findPathEnds at a time.
   virtual PathEndSeq *findPathEnds(ExceptionFrom *from,
 				   ExceptionThruSeq *thrus,
 				   ExceptionTo *to,
@@ -869,11 +1063,20 @@ public:
   ReportField *findReportPathField(const char *name);
   void setReportPathDigits(int digits);
   void setReportPathNoSplit(bool no_split);
+  void setReportPathNameIds(bool name_ids);
   // Report clk skews for clks.
   void reportClkSkew(ClockSet *clks,
 		     const Corner *corner,
 		     const SetupHold *setup_hold,
 		     int digits);
+  // Path based analysis (PBA) slacks of path ends found with the
+  // slews along each path instead of the worst slews at each pin.
+  void pathBasedSlacks(const PathEndSeq &path_ends,
+		       // Return value.
+		       SlackSeq &slacks);
+  // Report the graph and path based slacks of path ends.
+  void reportPathBasedSlacks(const PathEndSeq &path_ends,
+			     int digits);
   // Header above reportPathEnd results.
   void reportPathEndHeader();
   // Footer below reportPathEnd results.
@@ -892,7 +1095,34 @@ public:
   // loops until the arrivals converge.
   // If full=false update arrivals incrementally.
   // If full=true update all arrivals from scratch.
+  // Required times are found lazily by queries (see findRequireds).
   void updateTiming(bool full);
+  // Constraint modes share the network, liberty libraries and
+  // parasitics of this sta with their own constraints and timing
+  // (see StaMode). Make modes after the design is linked; linking
+  // again deletes the modes.
+  StaMode *makeMode(const char *name);
+  StaMode *findMode(const char *name) const;
+  const StaModeSeq &modes() const { return modes_; }
+  void deleteModes();
+  // Update timing for this sta and its modes concurrently.
+  // The threads are divided among the modes.
+  // If full=true also find all mode delays from scratch, which is
+  // required after parasitics or netlist changes.
+  // If requireds=true also find all required times (see findRequireds).
+  void updateModeTiming(bool full,
+			bool requireds);
+  // No delays, arrivals or requireds are pending update.
+  bool timingUpToDate();
+  // Restrict updateTiming to the fanin cone of the endpoint pins and
+  // the endpoints inside the instances. Delays, arrivals and requireds
+  // outside of the cone are not found and only the scope endpoints
+  // have required times. Endpoints made after the scope is set are not
+  // in the scope.
+  void setTimingScope(PinSet *pins,
+		      InstanceSet *insts);
+  void unsetTimingScope();
+  bool hasTimingScope() const;
   // Invalidate all arrival and required times.
   void arrivalsInvalid();
   void setPathMinMax(const MinMaxAll *min_max) __attribute__ ((deprecated));
@@ -903,6 +1133,11 @@ public:
   // Return value is owned by the caller.
   PinSet *findGroupPathPins(const char *group_path_name);
   // Find all required times after updateTiming().
+  // Until the next edit, vertex arrival, required and slack queries
+  // do not update timing and are safe to call from multiple threads.
+  // Path end queries and path reports are not: findPathEnds keeps its
+  // results in the Search PathGroups and ReportPath formats into
+  // shared buffers, so call them from one thread.
   void findRequireds();
   string *reportDelayCalc(Edge *edge,
 			  TimingArc *arc,
@@ -911,6 +1146,7 @@ public:
 			  int digits);
   void writeSdc(const char *filename,
 		bool native,
+		bool gzip,
 		bool no_timestamp,
 		int digits);
 
@@ -984,6 +1220,40 @@ public:
 		 const MinMax *min_max);
   Slack pinSlack(const Pin *pin,
 		 const MinMax *min_max);
+  // Bulk versions of pinSlack/pinArrival/vertexSlew for many pins
+  // found in parallel.  The results array must hold pins->size() values.
+  void pinSlacks(const PinSeq *pins,
+		 const MinMax *min_max,
+		 // Return value.
+		 float *slacks);
+  // Data arrivals (generated clock source paths are skipped).
+  void pinArrivals(const PinSeq *pins,
+		   const MinMax *min_max,
+		   // Return value.
+		   float *arrivals);
+  // Slew across all corners and transitions.
+  void pinSlews(const PinSeq *pins,
+		const MinMax *min_max,
+		// Return value.
+		float *slews);
+  // Report "pin slack" lines for every leaf instance pin and top
+  // level port.
+  void reportPinSlacks(const MinMax *min_max,
+		       int digits);
+  // Worst slack of every constrained endpoint found in parallel from
+  // the vertex arrivals/requireds without making path ends.
+  void endpointSlacks(const MinMax *min_max,
+		      // Return values.
+		      VertexSeq &ends,
+		      SlackSeq &slacks);
+  // Endpoint slack distribution in bin_count equal width bins.
+  void reportSlackHistogram(const MinMax *min_max,
+			    int bin_count,
+			    int digits);
+  // Endpoint count, violations, wns, tns and the top_n worst endpoints.
+  void reportEndpointSummary(const MinMax *min_max,
+			     int top_n,
+			     int digits);
   Slack vertexSlack(Vertex *vertex,
 		    const MinMax *min_max);
   Slack vertexSlack(Vertex *vertex,
@@ -1026,9 +1296,35 @@ public:
   TagIndex tagCount() const;
   TagGroupIndex tagGroupCount() const;
   int clkInfoCount() const;
+  // Delete tags, tag groups and clk infos that are no longer used by
+  // arrivals and renumber the rest.  Deletes path ends and check
+  // results that reference them.  Done automatically before
+  // searches after many new tag groups have been made.
+  void compactTags();
   int arrivalCount() const;
   int vertexArrivalCount(Vertex  *vertex) const;
   Vertex *maxArrivalCountVertex() const;
+  // Report estimated memory usage by subsystem as text or json.
+  void reportMemory(bool json = false);
+  // Report the run time of update timing phases as text or json.
+  void reportPhaseStats(bool json);
+  void clearPhaseStats();
+  // TCL variable sta_thread_profile.
+  // Record per thread busy time and level barrier waits of parallel
+  // delay calculation and arrival/required search.
+  bool threadProfileEnabled() const;
+  void setThreadProfileEnabled(bool enabled);
+  // Report the thread profile with the max_levels slowest levels.
+  void reportThreadProfile(int max_levels);
+  void reportThreadProfileJson();
+  void clearThreadProfile();
+  // TCL variable sta_hot_vertex_profile.
+  // Record the vertices that take the most time to visit in delay
+  // calculation and arrival/required search.
+  bool hotVertexProfileEnabled() const;
+  void setHotVertexProfileEnabled(bool enabled);
+  void reportHotVertices(int count);
+  void clearHotVertices();
 
   LogicValue simLogicValue(const Pin *pin);
   // Iterator for instances sorted by max driver pin slew.
@@ -1042,18 +1338,31 @@ public:
   // The parasitic memory footprint is much smaller if parasitic
   // networks (dspf) are reduced and deleted after reading each net
   // with reduce_to and delete_after_reduce.
+  // With incremental the file only has the nets changed by an eco.
+  // Their parasitics are replaced and only their delays invalidated.
+  // With lazy the parasitics of each net are read when they are
+  // first used.
   // Return true if successful.
   bool readSpef(const char *filename,
 		Instance *instance,
 		const MinMaxAll *min_max,
 		bool increment,
+		bool incremental,
 		bool pin_cap_included,
 		bool keep_coupling_caps,
 		float coupling_cap_factor,
 		ReduceParasiticsTo reduce_to,
 		bool delete_after_reduce,
 		bool save,
-		bool quiet);
+		bool quiet,
+		bool lazy);
+  // Save the parasitics of every parasitic analysis point in a binary
+  // database that readParasiticsDb loads without reading spef.
+  // Parasitic networks are included if networks is true.
+  void writeParasiticsDb(const char *filename,
+			 bool networks);
+  // Return true if successful.
+  bool readParasiticsDb(const char *filename);
   // Parasitics.
   void findPiElmore(Pin *drvr_pin,
 		    const TransRiseFall *tr,
@@ -1079,6 +1388,18 @@ public:
 		 const TransRiseFall *tr,
 		 const MinMaxAll *min_max,
 		 float elmore);
+  // Placement based parasitic estimation.
+  // Wire resistance and capacitance per unit length (meters).
+  void setPlacementWireRC(float res_per_length,
+			  float cap_per_length);
+  // Pin locations (meters) from placement.
+  void setPinLocations(const Pin * const *pins,
+		       const double *xs,
+		       const double *ys,
+		       size_t count);
+  // Estimate the parasitics of nets with pins that moved since the
+  // last estimate and invalidate their delays.
+  void estimatePlacementParasitics();
 
   // TCL network edit function support.
   virtual Instance *makeInstance(const char *name,
@@ -1088,6 +1409,32 @@ public:
   // replace_cell
   virtual void replaceCell(Instance *inst,
 			   LibertyCell *to_cell);
+  // Find the equivalent cells of every liberty library in parallel.
+  void findEquivCells();
+  // Worst slack change from replacing the cell of inst with an
+  // equivalent cell. The network and timing are left unchanged.
+  // Returns INF if to_cell is not equivalent.
+  Slack whatIfReplaceCell(Instance *inst,
+			  LibertyCell *to_cell,
+			  const MinMax *min_max);
+  // Worst slack, total negative slack and instance pin slack changes
+  // from replacing the cell of inst with each cell in cells.
+  // The deltas of cells that are not equivalent are INF so they
+  // cannot be mistaken for an edit that does not change timing.
+  void whatIfReplaceCells(Instance *inst,
+			  LibertyCellSeq *cells,
+			  const MinMax *min_max,
+			  // Return values.
+			  SlackSeq &wns_deltas,
+			  SlackSeq &tns_deltas,
+			  SlackSeq &inst_slack_deltas);
+  // Reduce the design to its interface logic model by deleting the
+  // instances that are not in the fanout of the inputs to the first
+  // registers, the fanin of the outputs from the last registers or
+  // the clock trees of those registers. Loads on the interface nets
+  // are kept so the interface delays do not change.
+  // Returns the number of instances deleted.
+  int reduceToInterfaceLogic();
   virtual Net *makeNet(const char *name,
 		       Instance *parent);
   virtual void deleteNet(Net *net);
@@ -1110,6 +1457,14 @@ public:
 		    Net *net,
 		    PinSeq *load_pins,
 		    const char *buffer_out_net_name);
+  // Network edits between beginEco and commitEco are applied to the
+  // network and graph immediately but the delay, arrival, required
+  // and endpoint invalidations are collected in sets and applied once
+  // by commitEco. Timing queries during an eco apply the collected
+  // invalidations first. beginEco/commitEco pairs can be nested.
+  void beginEco();
+  void commitEco();
+  bool inEco() const { return eco_depth_ > 0; }
 
   // Network edit before/after methods.
   void makeInstanceAfter(Instance *inst);
@@ -1120,6 +1475,14 @@ public:
   virtual void replaceEquivCellBefore(Instance *inst,
 				      LibertyCell *to_cell);
   virtual void replaceEquivCellAfter(Instance *inst);
+  void replaceEquivCellArcSets(Instance *inst,
+			       LibertyCell *to_cell);
+  void whatIfSlacks(Instance *inst,
+		    const MinMax *min_max,
+		    // Return values.
+		    Slack &wns,
+		    Slack &tns,
+		    Slack &inst_slack);
   // Replace the instance cell with to_cell.
   // equivCellPorts(from_cell, to_cell) must be true.
   virtual void replaceCellBefore(Instance *inst,
@@ -1137,6 +1500,13 @@ public:
   Tcl_Interp *tclInterp();
   // Ensure that the timing graph has been built.
   Graph *ensureGraph();
+  // Remake the dcalc analysis points shared by corners with the same
+  // liberty libraries and net wire caps if the corner inputs changed.
+  void updateDcalcAnalysisPts();
+  // Give each corner its own dcalc analysis points before annotating
+  // delays for a corner. Existing delays are discarded if the
+  // corners were sharing analysis points.
+  void unshareDcalcAnalysisPts();
   Corner *cmdCorner() const;
   void setCmdCorner(Corner *corner);
   Corner *findCorner(const char *corner_name);
@@ -1152,6 +1522,22 @@ public:
   // delays to be recomputed during incremental delay calculation.
   // Defaults to 0.0 for maximum accuracy and slowest incremental speed.
   void setIncrementalDelayTolerance(float tol);
+  // Change in arrival or required time (seconds) that causes fanout
+  // arrivals or fanin requireds to be recomputed during incremental
+  // search.  Defaults to 0.0.
+  void setIncrementalArrivalTolerance(float tol);
+  // TCL variable sta_gate_delay_cache.
+  // Reuse gate and load delays of driver timing arcs whose input slew,
+  // load and parasitic have not changed since the last calculation.
+  bool gateDelayCache() const;
+  void setGateDelayCache(bool enable);
+  // Report gate delay cache hits and misses.
+  void reportGateDelayCache();
+  // TCL variable sta_dcalc_level_batch.
+  // Find the gate delays of all of the drivers in a level in batches
+  // before annotating them.
+  bool dcalcLevelBatch() const;
+  void setDcalcLevelBatch(bool enable);
   // Make graph and find delays.
   void searchPreamble();
 
@@ -1189,6 +1575,13 @@ public:
 	     const Corner *corner,
 	     // Return values.
 	     PowerResult &result);
+  // Annotate pin activities from a VCD or SAIF switching activity file.
+  // scope is the path of the design top in the file.
+  // Return true if successful.
+  bool readVcdActivities(const char *filename,
+			 const char *scope);
+  bool readSaifActivities(const char *filename,
+			  const char *scope);
 
 protected:
   // Default constructors that are called by makeComponents in the Sta
@@ -1196,6 +1589,9 @@ protected:
   // specialize the sta components.
   virtual void makeReport();
   virtual void makeDebug();
+  virtual void makePhaseStats();
+  virtual void makeThreadProfile();
+  virtual void makeHotVertices();
   virtual void makeUnits();
   virtual void makeNetwork();
   virtual void makeCmdNetwork();
@@ -1217,26 +1613,42 @@ protected:
   virtual void makeReportPath();
   virtual void makePower();
   virtual void makeObservers();
+  virtual void makeParasiticAnalysisPts();
+  void updateModeComponentsState();
   NetworkEdit *networkCmdEdit();
 
   LibertyLibrary *readLibertyFile(const char *filename,
 				  Corner *corner,
 				  const MinMaxAll *min_max,
 				  bool infer_latches,
+				  const StringSet *skip_groups,
 				  Report *report,
 				  Debug *debug,
 				  Network *network);
   // Allow external Liberty reader to parse forms not used by Sta.
   virtual LibertyLibrary *readLibertyFile(const char *filename,
 					  bool infer_latches,
+					  const StringSet *skip_groups,
 					  Report *report,
 					  Debug *debug,
 					  Network *network);
   void ensureLevelized();
   void ensureClkArrivals();
   void delayCalcPreamble();
+  void dcalcAnalysisPtsChanged();
   void delaysInvalidFrom(Port *port);
   void delaysInvalidFromFanin(Port *port);
+  bool exceptionInvalidPins(ExceptionFrom *from,
+			    ExceptionThruSeq *thrus,
+			    ExceptionTo *to,
+			    // Return value.
+			    PinSet &pins) const;
+  bool exceptionPtInvalidPins(ExceptionPt *pt,
+			      // Return value.
+			      PinSet &pins) const;
+  void exceptionInvalid(bool incremental,
+			PinSet &pins);
+  void caseAnalysisChanged(Pin *pin);
   void deleteEdge(Edge *edge);
   void netParasiticCaps(Net *net,
 			const TransRiseFall *tr,
@@ -1247,6 +1659,12 @@ protected:
   void exprConstantPins(FuncExpr *expr,
 			Instance *inst,
 			PinSet *pins);
+  Arrival vertexArrival1(Vertex *vertex,
+			 const MinMax *min_max);
+  Slew vertexSlew1(Vertex *vertex,
+		   const MinMax *min_max);
+  Slack vertexSlack1(Vertex *vertex,
+		     const MinMax *min_max);
   Slack vertexSlack1(Vertex *vertex,
 		     const TransRiseFall *tr,
 		     const ClockEdge *clk_edge,
@@ -1294,17 +1712,51 @@ protected:
 		      SearchPred *pred,
 		      int inst_level,
 		      int pin_level);
+  void faninSeeds(PinSeq *to,
+		  // Return value.
+		  VertexSeq &seeds);
+  void fanoutSeeds(PinSeq *from,
+		   // Return value.
+		   VertexSeq &seeds);
+  void findConePins(VertexSeq &seeds,
+		    bool fanin,
+		    bool flat,
+		    bool ends_only,
+		    SearchPred &pred,
+		    // Return value.
+		    PinSeq &pins);
+  void findConeNext(Vertex *vertex,
+		    bool fanin,
+		    bool flat,
+		    SearchPred &pred,
+		    VertexVisitedBits &visited,
+		    // Return value.
+		    VertexSeq &next);
+  void findInterfaceClkTrees(InstanceSet &interface_insts,
+			     SearchPred &pred);
   void findRegisterPreamble();
   bool crossesHierarchy(Edge *edge) const;
   void deleteLeafInstanceBefore(Instance *inst);
+  void readLibertyAfter(LibertyLibrary *liberty,
+			Corner *corner,
+			const MinMaxAll *min_max);
+  void readLibertyDefault(LibertyLibrary *library);
   void readLibertyAfter(LibertyLibrary *liberty,
 			Corner *corner,
 			const MinMax *min_max);
   void powerPreamble();
+  void makePlacementParasitics();
   void disableFanoutCrprPruning(Vertex *vertex,
 			      int &fanou);
   LibertyPort *findCellPort(LibertyCell *cell,
 			    PortDirection *dir);
+  void ecoDelayInvalid(Vertex *vertex);
+  void ecoArrivalInvalid(Vertex *vertex);
+  void ecoRequiredInvalid(Vertex *vertex);
+  void ecoEndpointInvalid(Vertex *vertex);
+  void ecoDeleteVertexBefore(Vertex *vertex);
+  void applyEcoInvalids();
+  void clearEcoInvalids();
 
   CmdNamespace cmd_namespace_;
   Instance *current_instance_;
@@ -1317,9 +1769,19 @@ protected:
   ClkSkews *clk_skews_;
   ReportPath *report_path_;
   Power *power_;
+  PlacementParasitics *placement_parasitics_;
+  StaModeSeq modes_;
   Tcl_Interp *tcl_interp_;
   bool link_make_black_boxes_;
   bool update_genclks_;
+  bool quantized_slews_;
+  int eco_depth_;
+  VertexSet eco_delays_invalid_;
+  VertexSet eco_arrivals_invalid_;
+  VertexSet eco_requireds_invalid_;
+  VertexSet eco_endpoints_invalid_;
+  // Pins with sdc connectPinAfter pending.
+  PinSet eco_connected_pins_;
 
   // Singleton sta used by tcl command interpreter.
   static Sta *sta_;
@@ -0,0 +1,183 @@
+// OpenSTA, Static Timing Analyzer
+// Copyright (c) 2019, Parallax Software, Inc.
+// 
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+// 
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+// 
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#include "Machine.hh"
+#include "Report.hh"
+#include "Debug.hh"
+#include "Network.hh"
+#include "Parasitics.hh"
+#include "Graph.hh"
+#include "MinMax.hh"
+#include "Corner.hh"
+#include "StaMode.hh"
+
+namespace sta {
+
+StaMode::StaMode(const char *name,
+		 Sta *parent) :
+  Sta(),
+  name_(name),
+  parent_(parent),
+  mode_report_(nullptr)
+{
+  makeComponents();
+  setTclInterp(parent->tclInterp());
+  debug_->copyLevels(parent->debug());
+}
+
+// The shared components are deleted by the parent.
+StaMode::~StaMode()
+{
+  units_ = nullptr;
+  network_ = nullptr;
+  parasitics_ = nullptr;
+}
+
+// The shared network and parasitics keep the parent state.
+void
+StaMode::updateComponentsState()
+{
+  updateModeComponentsState();
+}
+
+void
+StaMode::makeReport()
+{
+  mode_report_ = new ModeReport(parent_->report());
+  report_ = mode_report_;
+}
+
+void
+StaMode::makeUnits()
+{
+  units_ = parent_->units();
+}
+
+void
+StaMode::makeNetwork()
+{
+  network_ = parent_->network();
+}
+
+void
+StaMode::makeParasitics()
+{
+  parasitics_ = parent_->parasitics();
+}
+
+void
+StaMode::makeGraph()
+{
+  graph_ = new Graph(this, 2, true, corners_->dcalcAnalysisPtCount());
+  graph_->setPrivatePinVertexIndices(true);
+  graph_->setQuantizedSlews(quantizedSlews());
+  graph_->makeGraph();
+}
+
+// Corners with the parent corner names and liberty libraries so the
+// corner liberty indices and parasitic analysis points match.
+void
+StaMode::makeCorners()
+{
+  corners_ = new Corners(this);
+  Corners *parent_corners = parent_->corners();
+  StringSet corner_names;
+  for (int i = 0; i < parent_corners->count(); i++)
+    corner_names.insert(parent_corners->findCorner(i)->name());
+  Sta::makeCorners(&corner_names);
+  for (int i = 0; i < parent_corners->count(); i++) {
+    Corner *parent_corner = parent_corners->findCorner(i);
+    Corner *corner = corners_->findCorner(parent_corner->name());
+    MinMaxIterator mm_iter;
+    while (mm_iter.hasNext()) {
+      MinMax *min_max = mm_iter.next();
+      for (LibertyLibrary *lib : *parent_corner->libertyLibraries(min_max))
+	corner->addLiberty(lib, min_max);
+    }
+  }
+}
+
+// Share the parent parasitics instead of deleting them.
+void
+StaMode::makeParasiticAnalysisPts()
+{
+  corners_->copyParasiticAnalysisPts(parent_->corners());
+}
+
+////////////////////////////////////////////////////////////////
+
+ModeReport::ModeReport(Report *parent) :
+  Report(),
+  parent_(parent),
+  collect_(false)
+{
+}
+
+void
+ModeReport::collectBegin()
+{
+  collect_ = true;
+}
+
+void
+ModeReport::collectEnd()
+{
+  collect_ = false;
+  for (auto &error_output : collected_) {
+    const std::string &output = error_output.second;
+    if (error_output.first)
+      parent_->printError(output.c_str(), output.size());
+    else
+      parent_->printString(output.c_str(), output.size());
+  }
+  collected_.clear();
+}
+
+size_t
+ModeReport::printConsole(const char *buffer,
+			 size_t length)
+{
+  if (collect_) {
+    collect(false, buffer, length);
+    return length;
+  }
+  else
+    return parent_->printString(buffer, length);
+}
+
+size_t
+ModeReport::printErrorConsole(const char *buffer,
+			      size_t length)
+{
+  if (collect_) {
+    collect(true, buffer, length);
+    return length;
+  }
+  else
+    return parent_->printError(buffer, length);
+}
+
+void
+ModeReport::collect(bool error,
+		    const char *buffer,
+		    size_t length)
+{
+  if (collected_.empty() || collected_.back().first != error)
+    collected_.push_back(std::make_pair(error, std::string()));
+  collected_.back().second.append(buffer, length);
+}
+
+} // namespace
@@ -0,0 +1,102 @@
+// OpenSTA, Static Timing Analyzer
+// Copyright (c) 2019, Parallax Software, Inc.
+// 
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+// 
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+// 
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#ifndef STA_STA_MODE_H
+#define STA_STA_MODE_H
+
+#include <string>
+#include <utility>
+#include <vector>
+#include "Report.hh"
+#include "Sta.hh"
+
+namespace sta {
+
+// Mode output goes to the parent report. While the mode is timed on
+// its own thread (Sta::updateModeTiming) the output is collected
+// instead and printed to the parent report by the parent thread after
+// the mode threads are done, so output from concurrent modes does not
+// interleave and only the parent thread writes to Tcl channels.
+class ModeReport : public Report
+{
+public:
+  explicit ModeReport(Report *parent);
+  void collectBegin();
+  // Print the collected output to the parent report.
+  void collectEnd();
+
+protected:
+  virtual size_t printConsole(const char *buffer,
+			      size_t length);
+  virtual size_t printErrorConsole(const char *buffer,
+				   size_t length);
+  void collect(bool error,
+	       const char *buffer,
+	       size_t length);
+
+private:
+  DISALLOW_COPY_AND_ASSIGN(ModeReport);
+
+  Report *parent_;
+  bool collect_;
+  // Collected output in order; first is true for errors.
+  std::vector<std::pair<bool, std::string>> collected_;
+};
+
+// A constraint mode that shares the network, liberty libraries and
+// parasitics of a parent Sta. Each mode has its own constraints (Sdc),
+// constants (Sim), graph, delays and search state, so the modes can be
+// timed concurrently (Sta::updateModeTiming).
+// The netlist, libraries and parasitics are read with the parent and
+// the mode corners and parasitic analysis points are copied from the
+// parent when the mode is made. Netlist edits are not seen by the mode
+// graphs.
+// The shared components keep the parent state (StaState) and the mode
+// graph keeps its own pin vertex indices so the mode never writes to
+// the shared components.
+// Each mode has its own report (see ModeReport) and debug. The debug
+// levels are copied from the parent when the mode is made and when
+// mode timing is updated.
+class StaMode : public Sta
+{
+public:
+  StaMode(const char *name,
+	  Sta *parent);
+  virtual ~StaMode();
+  virtual void updateComponentsState();
+  const char *name() const { return name_.c_str(); }
+  Sta *parent() const { return parent_; }
+  ModeReport *modeReport() const { return mode_report_; }
+
+protected:
+  virtual void makeReport();
+  virtual void makeUnits();
+  virtual void makeNetwork();
+  virtual void makeParasitics();
+  virtual void makeGraph();
+  virtual void makeCorners();
+  virtual void makeParasiticAnalysisPts();
+
+  std::string name_;
+  Sta *parent_;
+  ModeReport *mode_report_;
+
+private:
+  DISALLOW_COPY_AND_ASSIGN(StaMode);
+};
+
+} // namespace
+#endif
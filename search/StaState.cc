@@ -37,6 +37,11 @@ StaState::StaState() :
   search_(nullptr),
   latches_(nullptr),
   thread_count_(1),
+  thread_pool_(nullptr),
+  dataflow_scheduling_(false),
+  phase_stats_(nullptr),
+  thread_profile_(nullptr),
+  hot_vertices_(nullptr),
   pocv_enabled_(false),
   sigma_factor_(1.0)
 {
@@ -60,6 +65,11 @@ StaState::StaState(const StaState *sta) :
   search_(sta->search_),
   latches_(sta->latches_),
   thread_count_(sta->thread_count_),
+  thread_pool_(sta->thread_pool_),
+  dataflow_scheduling_(sta->dataflow_scheduling_),
+  phase_stats_(sta->phase_stats_),
+  thread_profile_(sta->thread_profile_),
+  hot_vertices_(sta->hot_vertices_),
   pocv_enabled_(sta->pocv_enabled_),
   sigma_factor_(sta->sigma_factor_)
 {
@@ -85,6 +95,11 @@ StaState::copyState(const StaState *sta)
   search_ = sta->search_;
   latches_ = sta->latches_;
   thread_count_ = sta->thread_count_;
+  thread_pool_ = sta->thread_pool_;
+  dataflow_scheduling_ = sta->dataflow_scheduling_;
+  phase_stats_ = sta->phase_stats_;
+  thread_profile_ = sta->thread_profile_;
+  hot_vertices_ = sta->hot_vertices_;
   pocv_enabled_ = sta->pocv_enabled_;
   sigma_factor_ = sta->sigma_factor_;
 }
@@ -37,6 +37,10 @@ class Parasitics;
 class ArcDelayCalc;
 class GraphDelayCalc;
 class Latches;
+class ThreadPool;
+class PhaseStats;
+class ThreadProfile;
+class HotVertices;
 
 // Most STA components use functionality in other components.
 // This class simplifies the process of copying pointers to the
@@ -90,6 +94,15 @@ public:
   Latches *latches() { return latches_; }
   Latches *latches() const { return latches_; }
   unsigned threadCount() const { return thread_count_; }
+  // Worker threads shared by parallel components (null if single threaded).
+  ThreadPool *threadPool() const { return thread_pool_; }
+  bool dataflowScheduling() const { return dataflow_scheduling_; }
+  // Per phase run time statistics.
+  PhaseStats *phaseStats() const { return phase_stats_; }
+  // Parallel visit thread utilization.
+  ThreadProfile *threadProfile() const { return thread_profile_; }
+  // Slowest vertices to visit in delay calculation and search.
+  HotVertices *hotVertices() const { return hot_vertices_; }
   bool pocvEnabled() const { return pocv_enabled_; }
   float sigmaFactor() const { return sigma_factor_; }
 
@@ -112,6 +125,11 @@ protected:
   Search *search_;
   Latches *latches_;
   int thread_count_;
+  ThreadPool *thread_pool_;
+  bool dataflow_scheduling_;
+  PhaseStats *phase_stats_;
+  ThreadProfile *thread_profile_;
+  HotVertices *hot_vertices_;
   bool pocv_enabled_;
   float sigma_factor_;
 
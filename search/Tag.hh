@@ -70,6 +70,8 @@ public:
   PathAnalysisPt *pathAnalysisPt(const StaState *sta) const;
   PathAPIndex pathAPIndex() const { return path_ap_index_; }
   TagIndex index() const { return index_; }
+  // Only Search::compactTags renumbers tags.
+  void setIndex(TagIndex index) { index_ = index; }
   ExceptionStateSet *states() const { return states_; }
   void setStates(ExceptionStateSet *states);
   bool isGenClkSrcPath() const;
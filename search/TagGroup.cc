@@ -43,6 +43,46 @@ TagGroup::TagGroup(TagGroupIndex index,
   has_loop_tag_(has_loop_tag),
   own_arrival_map_(true)
 {
+  makeArrivalTags();
+}
+
+void
+TagGroup::makeArrivalTags()
+{
+  int arrival_count = arrival_map_->size();
+  arrival_tags_.resize(arrival_count);
+  PathAPIndex path_ap_max = -1;
+  ArrivalMap::Iterator arrival_iter(arrival_map_);
+  while (arrival_iter.hasNext()) {
+    Tag *tag;
+    int arrival_index;
+    arrival_iter.next(tag, arrival_index);
+    arrival_tags_[arrival_index] = tag;
+    path_ap_max = max(path_ap_max, tag->pathAPIndex());
+  }
+  path_ap_begin_.resize(path_ap_max + 2);
+  PathAPIndex path_ap_index = 0;
+  for (int i = 0; i < arrival_count; i++) {
+    PathAPIndex tag_ap_index = arrival_tags_[i]->pathAPIndex();
+    while (path_ap_index <= tag_ap_index)
+      path_ap_begin_[path_ap_index++] = i;
+  }
+  while (path_ap_index <= path_ap_max + 1)
+    path_ap_begin_[path_ap_index++] = arrival_count;
+}
+
+void
+TagGroup::pathAPArrivalRange(PathAPIndex path_ap_index,
+			     // Return values.
+			     int &begin,
+			     int &end) const
+{
+  if (path_ap_index + 1 < static_cast<PathAPIndex>(path_ap_begin_.size())) {
+    begin = path_ap_begin_[path_ap_index];
+    end = path_ap_begin_[path_ap_index + 1];
+  }
+  else
+    begin = end = 0;
 }
 
 TagGroup::TagGroup(TagGroupBldr *tag_bldr) :
@@ -229,6 +269,13 @@ TagGroupBldr::arrival(int arrival_index) const
   return arrivals_[arrival_index];
 }
 
+void
+TagGroupBldr::replaceArrival(int arrival_index,
+			     const Arrival &arrival)
+{
+  arrivals_[arrival_index] = arrival;
+}
+
 void
 TagGroupBldr::setArrival(Tag *tag,
 			 const Arrival &arrival,
@@ -296,21 +343,37 @@ TagGroupBldr::makeTagGroup(TagGroupIndex index,
 
 }
 
+static bool
+tagPathAPLess(const Tag *tag1,
+	      const Tag *tag2)
+{
+  PathAPIndex path_ap_index1 = tag1->pathAPIndex();
+  PathAPIndex path_ap_index2 = tag2->pathAPIndex();
+  return path_ap_index1 < path_ap_index2
+    || (path_ap_index1 == path_ap_index2
+	&& tag1->index() < tag2->index());
+}
+
 ArrivalMap *
 TagGroupBldr::makeArrivalMap(const StaState *sta)
 {
   ArrivalMap *arrival_map = new ArrivalMap(arrival_map_.size(),
 					   TagMatchHash(true, sta),
 					   TagMatchEqual(true, sta));
-  int arrival_index = 0;
+  // Sort the tags so the arrivals for each path analysis point
+  // are contiguous.
+  TagSeq tags;
   ArrivalMap::Iterator arrival_iter(arrival_map_);
   while (arrival_iter.hasNext()) {
     Tag *tag;
     int arrival_index1;
     arrival_iter.next(tag, arrival_index1);
-    arrival_map->insert(tag, arrival_index);
-    arrival_index++;
+    tags.push_back(tag);
   }
+  sort(tags, tagPathAPLess);
+  int arrival_index = 0;
+  for (auto tag : tags)
+    arrival_map->insert(tag, arrival_index++);
   return arrival_map;
 }
 
@@ -47,6 +47,8 @@ public:
   TagGroup(TagGroupBldr *tag_bldr);
   ~TagGroup();
   TagGroupIndex index() const { return index_; }
+  // Only Search::compactTags renumbers tag groups.
+  void setIndex(TagGroupIndex index) { index_ = index; }
   Hash hash() const { return hash_; }
   void report(const StaState *sta) const;
   void reportArrivalMap(const StaState *sta) const;
@@ -65,12 +67,26 @@ public:
   int requiredIndex(int arrival_index) const;
   ArrivalMap *arrivalMap() const { return arrival_map_; }
   bool hasTag(Tag *tag) const;
+  // Arrival indices are ordered by path analysis point so the arrivals
+  // (and requireds) of a path analysis point are contiguous in the
+  // vertex arrival array.
+  Tag *arrivalTag(int arrival_index) const { return arrival_tags_[arrival_index]; }
+  // Arrival indices [begin, end) for path_ap_index.
+  void pathAPArrivalRange(PathAPIndex path_ap_index,
+			  // Return values.
+			  int &begin,
+			  int &end) const;
 
 protected:
   Hash arrivalMapHash(ArrivalMap *arrival_map);
+  void makeArrivalTags();
 
   // tag -> arrival index
   ArrivalMap *arrival_map_;
+  // arrival index -> tag
+  TagSeq arrival_tags_;
+  // Arrival index of the first tag of each path analysis point.
+  Vector<int> path_ap_begin_;
   Hash hash_;
   unsigned int index_:tag_group_index_bits;
   unsigned int has_clk_tag_:1;
@@ -128,6 +144,9 @@ public:
 		       Arrival &arrival,
 		       int &arrival_index) const;
   Arrival arrival(int arrival_index) const;
+  // Change an existing arrival without changing its prev path.
+  void replaceArrival(int arrival_index,
+		      const Arrival &arrival);
   void setArrival(Tag *tag,
 		  const Arrival &arrival,
 		  PathVertexRep *prev_path);
@@ -0,0 +1,323 @@
+// OpenSTA, Static Timing Analyzer
+// Copyright (c) 2019, Parallax Software, Inc.
+// 
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+// 
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+// 
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#include <algorithm>
+#include "Machine.hh"
+#include "Report.hh"
+#include "Network.hh"
+#include "Graph.hh"
+#include "StaState.hh"
+#include "ThreadProfile.hh"
+
+namespace sta {
+
+ThreadLevelWork::ThreadLevelWork()
+{
+  clear();
+}
+
+void
+ThreadLevelWork::clear()
+{
+  busy_ = 0.0;
+  vertex_count_ = 0;
+  slowest_vertex_ = nullptr;
+  slowest_time_ = 0.0;
+}
+
+void
+ThreadLevelWork::visited(Vertex *vertex,
+			 double seconds)
+{
+  busy_ += seconds;
+  vertex_count_++;
+  if (seconds > slowest_time_) {
+    slowest_vertex_ = vertex;
+    slowest_time_ = seconds;
+  }
+}
+
+LevelProfile::LevelProfile() :
+  visit_count_(0),
+  vertex_count_(0),
+  wall_(0.0),
+  thread_wall_(0.0),
+  busy_(0.0),
+  busy_max_(0.0),
+  slowest_time_(0.0)
+{
+}
+
+BfsProfile::BfsProfile() :
+  level_visit_count_(0),
+  vertex_count_(0),
+  wall_(0.0),
+  busy_(0.0),
+  barrier_wait_(0.0),
+  dataflow_count_(0),
+  dataflow_wall_(0.0),
+  dataflow_busy_(0.0)
+{
+}
+
+////////////////////////////////////////////////////////////////
+
+static const char *bfs_profile_names[] = {
+  "delay calc", "arrival search", "required search", "search"
+};
+
+ThreadProfile::ThreadProfile() :
+  enabled_(false)
+{
+}
+
+void
+ThreadProfile::setEnabled(bool enabled)
+{
+  enabled_ = enabled;
+}
+
+void
+ThreadProfile::clear()
+{
+  for (auto &profile : profiles_)
+    profile = BfsProfile();
+}
+
+void
+ThreadProfile::recordThreads(BfsProfile &profile,
+			     const ThreadLevelWorkSeq &work)
+{
+  size_t thread_count = work.size();
+  if (profile.thread_busy_.size() < thread_count) {
+    profile.thread_busy_.resize(thread_count, 0.0);
+    profile.thread_vertex_counts_.resize(thread_count, 0);
+  }
+  for (size_t i = 0; i < thread_count; i++) {
+    profile.thread_busy_[i] += work[i].busy_;
+    profile.thread_vertex_counts_[i] += work[i].vertex_count_;
+  }
+}
+
+void
+ThreadProfile::levelVisited(BfsIndex bfs_index,
+			    Level level,
+			    double wall,
+			    const ThreadLevelWorkSeq &work,
+			    const Network *network)
+{
+  BfsProfile &profile = profiles_[static_cast<int>(bfs_index)];
+  recordThreads(profile, work);
+  double busy = 0.0;
+  double busy_max = 0.0;
+  size_t vertex_count = 0;
+  const ThreadLevelWork *slowest = nullptr;
+  for (auto &thread_work : work) {
+    busy += thread_work.busy_;
+    busy_max = std::max(busy_max, thread_work.busy_);
+    vertex_count += thread_work.vertex_count_;
+    if (thread_work.slowest_vertex_
+	&& (slowest == nullptr
+	    || thread_work.slowest_time_ > slowest->slowest_time_))
+      slowest = &thread_work;
+  }
+  double thread_wall = wall * work.size();
+  profile.level_visit_count_++;
+  profile.vertex_count_ += vertex_count;
+  profile.wall_ += wall;
+  profile.busy_ += busy;
+  profile.barrier_wait_ += std::max(thread_wall - busy, 0.0);
+
+  if (profile.levels_.size() <= static_cast<size_t>(level))
+    profile.levels_.resize(level + 1);
+  LevelProfile &level_profile = profile.levels_[level];
+  level_profile.visit_count_++;
+  level_profile.vertex_count_ += vertex_count;
+  level_profile.wall_ += wall;
+  level_profile.thread_wall_ += thread_wall;
+  level_profile.busy_ += busy;
+  level_profile.busy_max_ += busy_max;
+  if (slowest && slowest->slowest_time_ > level_profile.slowest_time_) {
+    level_profile.slowest_vertex_ = slowest->slowest_vertex_->name(network);
+    level_profile.slowest_time_ = slowest->slowest_time_;
+  }
+}
+
+void
+ThreadProfile::dataflowVisited(BfsIndex bfs_index,
+			       double wall,
+			       const ThreadLevelWorkSeq &work)
+{
+  BfsProfile &profile = profiles_[static_cast<int>(bfs_index)];
+  recordThreads(profile, work);
+  profile.dataflow_count_++;
+  profile.dataflow_wall_ += wall;
+  for (auto &thread_work : work) {
+    profile.dataflow_busy_ += thread_work.busy_;
+    profile.vertex_count_ += thread_work.vertex_count_;
+  }
+}
+
+////////////////////////////////////////////////////////////////
+
+void
+ThreadProfile::report(int max_levels,
+		      const StaState *sta) const
+{
+  Report *report = sta->report();
+  bool reported = false;
+  for (int i = 0; i < static_cast<int>(BfsIndex::bits); i++) {
+    const BfsProfile &profile = profiles_[i];
+    if (profile.level_visit_count_ > 0 || profile.dataflow_count_ > 0) {
+      if (reported)
+	report->print("\n");
+      this->report(bfs_profile_names[i], profile, max_levels, sta);
+      reported = true;
+    }
+  }
+  if (!reported) {
+    if (enabled_)
+      report->print("No parallel visits recorded.\n");
+    else
+      report->print("Thread profiling is disabled (set sta_thread_profile 1).\n");
+  }
+}
+
+void
+ThreadProfile::reportJson(Report *report) const
+{
+  report->print("{\"enabled\": %s, \"bfs\": [", enabled_ ? "true" : "false");
+  bool first = true;
+  for (int i = 0; i < static_cast<int>(BfsIndex::bits); i++) {
+    const BfsProfile &profile = profiles_[i];
+    if (profile.level_visit_count_ > 0 || profile.dataflow_count_ > 0) {
+      double thread_wall = profile.busy_ + profile.barrier_wait_;
+      report->print("%s\n  {\"name\": \"%s\", \"level_visits\": %lu, \"vertices\": %lu, \"wall\": %.6f, \"busy\": %.6f, \"barrier_wait\": %.6f, \"utilization\": %.4f,",
+		    first ? "" : ",",
+		    bfs_profile_names[i],
+		    static_cast<unsigned long>(profile.level_visit_count_),
+		    static_cast<unsigned long>(profile.vertex_count_),
+		    profile.wall_,
+		    profile.busy_,
+		    profile.barrier_wait_,
+		    (thread_wall > 0.0) ? profile.busy_ / thread_wall : 0.0);
+      report->print("\n   \"dataflow_visits\": %lu, \"dataflow_wall\": %.6f, \"dataflow_busy\": %.6f,",
+		    static_cast<unsigned long>(profile.dataflow_count_),
+		    profile.dataflow_wall_,
+		    profile.dataflow_busy_);
+      report->print("\n   \"thread_busy\": [");
+      for (size_t j = 0; j < profile.thread_busy_.size(); j++)
+	report->print("%s%.6f", j > 0 ? ", " : "", profile.thread_busy_[j]);
+      report->print("],\n   \"thread_vertices\": [");
+      for (size_t j = 0; j < profile.thread_vertex_counts_.size(); j++)
+	report->print("%s%lu", j > 0 ? ", " : "",
+		      static_cast<unsigned long>(profile.thread_vertex_counts_[j]));
+      report->print("]}");
+      first = false;
+    }
+  }
+  report->print("\n]}\n");
+}
+
+class LevelWallGreater
+{
+public:
+  explicit LevelWallGreater(const std::vector<LevelProfile> &levels) :
+    levels_(levels)
+  {
+  }
+  bool operator()(Level level1,
+		  Level level2) const
+  {
+    double wall1 = levels_[level1].wall_;
+    double wall2 = levels_[level2].wall_;
+    return wall1 > wall2
+      || (wall1 == wall2 && level1 < level2);
+  }
+
+private:
+  const std::vector<LevelProfile> &levels_;
+};
+
+void
+ThreadProfile::report(const char *name,
+		      const BfsProfile &profile,
+		      int max_levels,
+		      const StaState *sta) const
+{
+  Report *report = sta->report();
+  double thread_wall = profile.busy_ + profile.barrier_wait_;
+  report->print("Thread profile: %s\n", name);
+  report->print("Level visits %lu vertices %lu wall %.3fs\n",
+		static_cast<unsigned long>(profile.level_visit_count_),
+		static_cast<unsigned long>(profile.vertex_count_),
+		profile.wall_);
+  report->print("Busy %.3fs barrier wait %.3fs utilization %.1f%%\n",
+		profile.busy_,
+		profile.barrier_wait_,
+		(thread_wall > 0.0) ? profile.busy_ / thread_wall * 100.0 : 0.0);
+  if (profile.dataflow_count_ > 0)
+    report->print("Dataflow visits %lu wall %.3fs busy %.3fs\n",
+		  static_cast<unsigned long>(profile.dataflow_count_),
+		  profile.dataflow_wall_,
+		  profile.dataflow_busy_);
+
+  report->print("\nThread  Busy(s)   Vertices\n");
+  report->print("---------------------------\n");
+  for (size_t i = 0; i < profile.thread_busy_.size(); i++)
+    report->print("%6lu %8.3f %10lu\n",
+		  static_cast<unsigned long>(i),
+		  profile.thread_busy_[i],
+		  static_cast<unsigned long>(profile.thread_vertex_counts_[i]));
+
+  // Levels with the most wall time.
+  std::vector<Level> levels;
+  for (size_t level = 0; level < profile.levels_.size(); level++) {
+    if (profile.levels_[level].visit_count_ > 0)
+      levels.push_back(level);
+  }
+  if (!levels.empty()) {
+    size_t level_count = std::min(levels.size(),
+				  static_cast<size_t>(max_levels));
+    std::partial_sort(levels.begin(), levels.begin() + level_count,
+		      levels.end(), LevelWallGreater(profile.levels_));
+    levels.resize(level_count);
+
+    // Imbalance is the busiest thread time over the mean thread time.
+    report->print("\nLevel  Visits   Vertices  Wall(ms)  Util Imbalance Slowest(us) Slowest vertex\n");
+    report->print("-------------------------------------------------------------------------------\n");
+    for (auto level : levels) {
+      const LevelProfile &level_profile = profile.levels_[level];
+      double threads = (level_profile.wall_ > 0.0)
+	? level_profile.thread_wall_ / level_profile.wall_
+	: 1.0;
+      double busy_mean = level_profile.busy_ / threads;
+      report->print("%5d %7lu %10lu %9.3f %4.0f%% %9.2f %11.1f %s\n",
+		    level,
+		    static_cast<unsigned long>(level_profile.visit_count_),
+		    static_cast<unsigned long>(level_profile.vertex_count_),
+		    level_profile.wall_ * 1e+3,
+		    (level_profile.thread_wall_ > 0.0)
+		    ? level_profile.busy_ / level_profile.thread_wall_ * 100.0
+		    : 0.0,
+		    (busy_mean > 0.0) ? level_profile.busy_max_ / busy_mean : 0.0,
+		    level_profile.slowest_time_ * 1e+6,
+		    level_profile.slowest_vertex_.c_str());
+    }
+  }
+}
+
+} // namespace
@@ -0,0 +1,137 @@
+// OpenSTA, Static Timing Analyzer
+// Copyright (c) 2019, Parallax Software, Inc.
+// 
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+// 
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+// 
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#ifndef STA_THREAD_PROFILE_H
+#define STA_THREAD_PROFILE_H
+
+#include <stddef.h>  // size_t
+#include <string>
+#include <vector>
+#include "DisallowCopyAssign.hh"
+#include "GraphClass.hh"
+
+namespace sta {
+
+class StaState;
+class Network;
+class Report;
+
+// Work done by one thread on one level (or dataflow visit).
+// Each thread only writes its own entry.
+class ThreadLevelWork
+{
+public:
+  ThreadLevelWork();
+  void clear();
+  void visited(Vertex *vertex,
+	       double seconds);
+
+  double busy_;
+  size_t vertex_count_;
+  Vertex *slowest_vertex_;
+  double slowest_time_;
+  // Keep entries for different threads off the same cache line.
+  char pad_[32];
+};
+
+typedef std::vector<ThreadLevelWork> ThreadLevelWorkSeq;
+
+// Accumulated profile of the parallel visits of one BFS (delay calc,
+// arrival search, ...) at one level.
+class LevelProfile
+{
+public:
+  LevelProfile();
+
+  size_t visit_count_;
+  size_t vertex_count_;
+  double wall_;
+  // Sum over visits of wall time * thread count.
+  double thread_wall_;
+  // Sum of busy time of all threads.
+  double busy_;
+  // Sum over visits of the busiest thread's time.
+  double busy_max_;
+  std::string slowest_vertex_;
+  double slowest_time_;
+};
+
+class BfsProfile
+{
+public:
+  BfsProfile();
+
+  size_t level_visit_count_;
+  size_t vertex_count_;
+  double wall_;
+  // Busy time of all threads visiting levels.
+  double busy_;
+  // Indexed by thread.
+  std::vector<double> thread_busy_;
+  std::vector<size_t> thread_vertex_counts_;
+  // Thread time waiting at level barriers (thread count * wall - busy).
+  double barrier_wait_;
+  size_t dataflow_count_;
+  double dataflow_wall_;
+  double dataflow_busy_;
+  // Indexed by level.
+  std::vector<LevelProfile> levels_;
+};
+
+// Per thread utilization and load imbalance of the level synchronous
+// (and dataflow) parallel visits used by delay calculation and
+// arrival/required search. Recording is enabled with the TCL variable
+// sta_thread_profile and adds two clock reads per visited vertex.
+class ThreadProfile
+{
+public:
+  ThreadProfile();
+  bool enabled() const { return enabled_; }
+  void setEnabled(bool enabled);
+  void clear();
+  // Record one parallel visit of the vertices at level.
+  void levelVisited(BfsIndex bfs_index,
+		    Level level,
+		    double wall,
+		    const ThreadLevelWorkSeq &work,
+		    const Network *network);
+  void dataflowVisited(BfsIndex bfs_index,
+		       double wall,
+		       const ThreadLevelWorkSeq &work);
+  // Report totals for each BFS and the max_levels levels with
+  // the most wall time.
+  void report(int max_levels,
+	      const StaState *sta) const;
+  // Report the totals and thread busy times of each BFS as json.
+  void reportJson(Report *report) const;
+
+protected:
+  void recordThreads(BfsProfile &profile,
+		     const ThreadLevelWorkSeq &work);
+  void report(const char *name,
+	      const BfsProfile &profile,
+	      int max_levels,
+	      const StaState *sta) const;
+
+  bool enabled_;
+  BfsProfile profiles_[static_cast<int>(BfsIndex::bits)];
+
+private:
+  DISALLOW_COPY_AND_ASSIGN(ThreadProfile);
+};
+
+} // namespace
+#endif
@@ -0,0 +1,295 @@
+// OpenSTA, Static Timing Analyzer
+// Copyright (c) 2019, Parallax Software, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#include <stdint.h>
+#include <string.h>
+#include <vector>
+#include "Machine.hh"
+#include "DisallowCopyAssign.hh"
+#include "Zlib.hh"
+#include "Report.hh"
+#include "Error.hh"
+#include "Debug.hh"
+#include "Transition.hh"
+#include "TimingArc.hh"
+#include "Graph.hh"
+#include "Corner.hh"
+#include "StaState.hh"
+#include "TimingCheckpoint.hh"
+
+namespace sta {
+
+static const char checkpoint_magic[] = "STATCKP1";
+static const size_t checkpoint_magic_length = sizeof(checkpoint_magic) - 1;
+
+// Per vertex record:
+//  vertex index
+//  slews [tr][ap]
+//  out edge count
+//  per out edge: edge index, to vertex index, arc count, delays [arc][ap]
+class TimingCheckpoint : public StaState
+{
+public:
+  TimingCheckpoint(const char *filename,
+		   StaState *sta);
+  ~TimingCheckpoint();
+  void write();
+  bool read();
+
+private:
+  DISALLOW_COPY_AND_ASSIGN(TimingCheckpoint);
+  void writeUint(uint32_t value);
+  void writeFloat(float value);
+  void flush();
+  bool readUint(uint32_t &value);
+  bool readFloat(float &value);
+  bool readVertex(Vertex *vertex);
+  bool readEdge(Edge *edge);
+  bool mismatch(const char *what);
+
+  const char *filename_;
+  gzFile stream_;
+  DcalcAPIndex ap_count_;
+  std::vector<char> buffer_;
+};
+
+TimingCheckpoint::TimingCheckpoint(const char *filename,
+				   StaState *sta) :
+  StaState(sta),
+  filename_(filename),
+  stream_(Z_NULL),
+  ap_count_(sta->corners()->dcalcAnalysisPtCount())
+{
+}
+
+TimingCheckpoint::~TimingCheckpoint()
+{
+  if (stream_ != Z_NULL)
+    gzclose(stream_);
+}
+
+void
+TimingCheckpoint::write()
+{
+  stream_ = gzopen(filename_, "wb");
+  if (stream_ == Z_NULL)
+    throw FileNotWritable(filename_);
+  buffer_.insert(buffer_.end(), checkpoint_magic,
+		 checkpoint_magic + checkpoint_magic_length);
+  writeUint(ap_count_);
+  writeUint(graph_->vertexCount());
+  writeUint(graph_->edgeCount());
+  VertexIterator vertex_iter(graph_);
+  while (vertex_iter.hasNext()) {
+    Vertex *vertex = vertex_iter.next();
+    writeUint(graph_->index(vertex));
+    TransRiseFallIterator tr_iter;
+    while (tr_iter.hasNext()) {
+      TransRiseFall *tr = tr_iter.next();
+      for (DcalcAPIndex ap_index = 0; ap_index < ap_count_; ap_index++)
+	writeFloat(delayAsFloat(graph_->slew(vertex, tr, ap_index)));
+    }
+    uint32_t edge_count = 0;
+    VertexOutEdgeIterator count_iter(vertex, graph_);
+    while (count_iter.hasNext()) {
+      count_iter.next();
+      edge_count++;
+    }
+    writeUint(edge_count);
+    VertexOutEdgeIterator edge_iter(vertex, graph_);
+    while (edge_iter.hasNext()) {
+      Edge *edge = edge_iter.next();
+      TimingArcSet *arc_set = edge->timingArcSet();
+      writeUint(graph_->index(edge));
+      writeUint(graph_->index(edge->to(graph_)));
+      writeUint(arc_set->arcCount());
+      TimingArcSetArcIterator arc_iter(arc_set);
+      while (arc_iter.hasNext()) {
+	TimingArc *arc = arc_iter.next();
+	for (DcalcAPIndex ap_index = 0; ap_index < ap_count_; ap_index++)
+	  writeFloat(delayAsFloat(graph_->arcDelay(edge, arc, ap_index)));
+      }
+    }
+    if (buffer_.size() >= (1 << 16))
+      flush();
+  }
+  flush();
+}
+
+void
+TimingCheckpoint::writeUint(uint32_t value)
+{
+  const char *bytes = reinterpret_cast<const char*>(&value);
+  buffer_.insert(buffer_.end(), bytes, bytes + sizeof(value));
+}
+
+void
+TimingCheckpoint::writeFloat(float value)
+{
+  const char *bytes = reinterpret_cast<const char*>(&value);
+  buffer_.insert(buffer_.end(), bytes, bytes + sizeof(value));
+}
+
+void
+TimingCheckpoint::flush()
+{
+  if (!buffer_.empty()) {
+    if (gzwrite(stream_, &buffer_[0], buffer_.size())
+	!= static_cast<int>(buffer_.size()))
+      throw FileNotWritable(filename_);
+    buffer_.clear();
+  }
+}
+
+////////////////////////////////////////////////////////////////
+
+// The graph is traversed in the same order it was written so each
+// record is checked against the vertex or edge it is restored to.
+bool
+TimingCheckpoint::read()
+{
+  stream_ = gzopen(filename_, "rb");
+  if (stream_ == Z_NULL)
+    throw FileNotReadable(filename_);
+  char magic[checkpoint_magic_length];
+  if (gzread(stream_, magic, checkpoint_magic_length)
+      != static_cast<int>(checkpoint_magic_length)
+      || memcmp(magic, checkpoint_magic, checkpoint_magic_length) != 0) {
+    report_->error("%s is not a timing checkpoint.\n", filename_);
+    return false;
+  }
+  uint32_t ap_count, vertex_count, edge_count;
+  if (!readUint(ap_count)
+      || !readUint(vertex_count)
+      || !readUint(edge_count))
+    return mismatch("header");
+  if (ap_count != static_cast<uint32_t>(ap_count_))
+    return mismatch("analysis point count");
+  if (vertex_count != graph_->vertexCount())
+    return mismatch("vertex count");
+  if (edge_count != graph_->edgeCount())
+    return mismatch("edge count");
+  int vertex_restore_count = 0;
+  VertexIterator vertex_iter(graph_);
+  while (vertex_iter.hasNext()) {
+    Vertex *vertex = vertex_iter.next();
+    if (!readVertex(vertex))
+      return false;
+    vertex_restore_count++;
+  }
+  debugPrint2(debug_, "checkpoint", 1, "restored %d vertices from %s\n",
+	      vertex_restore_count, filename_);
+  return true;
+}
+
+bool
+TimingCheckpoint::readVertex(Vertex *vertex)
+{
+  uint32_t vertex_index;
+  if (!readUint(vertex_index)
+      || vertex_index != graph_->index(vertex))
+    return mismatch("vertex");
+  TransRiseFallIterator tr_iter;
+  while (tr_iter.hasNext()) {
+    TransRiseFall *tr = tr_iter.next();
+    for (DcalcAPIndex ap_index = 0; ap_index < ap_count_; ap_index++) {
+      float slew;
+      if (!readFloat(slew))
+	return mismatch("slew");
+      graph_->setSlew(vertex, tr, ap_index, slew);
+    }
+  }
+  uint32_t edge_count;
+  if (!readUint(edge_count))
+    return mismatch("edge count");
+  uint32_t edge_restore_count = 0;
+  VertexOutEdgeIterator edge_iter(vertex, graph_);
+  while (edge_iter.hasNext()) {
+    Edge *edge = edge_iter.next();
+    if (edge_restore_count == edge_count
+	|| !readEdge(edge))
+      return mismatch("edge");
+    edge_restore_count++;
+  }
+  if (edge_restore_count != edge_count)
+    return mismatch("edge");
+  return true;
+}
+
+bool
+TimingCheckpoint::readEdge(Edge *edge)
+{
+  TimingArcSet *arc_set = edge->timingArcSet();
+  uint32_t edge_index, to_index, arc_count;
+  if (!readUint(edge_index)
+      || !readUint(to_index)
+      || !readUint(arc_count)
+      || edge_index != graph_->index(edge)
+      || to_index != graph_->index(edge->to(graph_))
+      || arc_count != arc_set->arcCount())
+    return false;
+  TimingArcSetArcIterator arc_iter(arc_set);
+  while (arc_iter.hasNext()) {
+    TimingArc *arc = arc_iter.next();
+    for (DcalcAPIndex ap_index = 0; ap_index < ap_count_; ap_index++) {
+      float delay;
+      if (!readFloat(delay))
+	return false;
+      graph_->setArcDelay(edge, arc, ap_index, delay);
+    }
+  }
+  return true;
+}
+
+bool
+TimingCheckpoint::readUint(uint32_t &value)
+{
+  return gzread(stream_, &value, sizeof(value)) == sizeof(value);
+}
+
+bool
+TimingCheckpoint::readFloat(float &value)
+{
+  return gzread(stream_, &value, sizeof(value)) == sizeof(value);
+}
+
+bool
+TimingCheckpoint::mismatch(const char *what)
+{
+  report_->error("timing checkpoint %s %s does not match the design.\n",
+		 filename_, what);
+  return false;
+}
+
+////////////////////////////////////////////////////////////////
+
+void
+writeTimingCheckpoint(const char *filename,
+		      StaState *sta)
+{
+  TimingCheckpoint checkpoint(filename, sta);
+  checkpoint.write();
+}
+
+bool
+readTimingCheckpoint(const char *filename,
+		     StaState *sta)
+{
+  TimingCheckpoint checkpoint(filename, sta);
+  return checkpoint.read();
+}
+
+} // namespace
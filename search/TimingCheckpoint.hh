@@ -0,0 +1,43 @@
+// OpenSTA, Static Timing Analyzer
+// Copyright (c) 2019, Parallax Software, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#ifndef STA_TIMING_CHECKPOINT_H
+#define STA_TIMING_CHECKPOINT_H
+
+namespace sta {
+
+class StaState;
+
+// Timing checkpoints save the graph slews and arc delays found by
+// delay calculation so a later session with the same network,
+// libraries, parasitics and constraints can restore them instead of
+// recalculating them. Vertices and edges are matched by graph index,
+// which is repeatable when the inputs are read in the same order.
+// The file is gzipped.
+
+// Throws FileNotWritable.
+void
+writeTimingCheckpoint(const char *filename,
+		      StaState *sta);
+
+// Throws FileNotReadable.
+// Return true if the checkpoint matches the graph and was restored.
+bool
+readTimingCheckpoint(const char *filename,
+		     StaState *sta);
+
+} // namespace
+#endif
@@ -0,0 +1,381 @@
+// OpenSTA, Static Timing Analyzer
+// Copyright (c) 2019, Parallax Software, Inc.
+// 
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+// 
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+// 
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#include <stdint.h>
+#include <stdio.h>
+#include <limits>
+#include <string>
+#include <vector>
+#include "Machine.hh"
+#include "DisallowCopyAssign.hh"
+#include "Error.hh"
+#include "ThreadForEach.hh"
+#include "Transition.hh"
+#include "TimingRole.hh"
+#include "TimingArc.hh"
+#include "PortDirection.hh"
+#include "Network.hh"
+#include "Graph.hh"
+#include "DcalcAnalysisPt.hh"
+#include "Corner.hh"
+#include "PathAnalysisPt.hh"
+#include "PathVertex.hh"
+#include "StaState.hh"
+#include "TimingColumns.hh"
+
+namespace sta {
+
+using std::string;
+using std::vector;
+
+// Transition column value for transitions that are not rise or fall.
+static const uint8_t timing_columns_no_rf = 255;
+
+class TimingColumns : public StaState
+{
+public:
+  TimingColumns(const char *dirname,
+		StaState *sta);
+  void write();
+
+private:
+  DISALLOW_COPY_AND_ASSIGN(TimingColumns);
+  void findRows();
+  void writeVertices();
+  void writeEdges();
+  void writeArcs();
+  void writeNames();
+  void writeManifest();
+  void beginTable(const char *table,
+		  size_t row_count);
+  void endTable();
+  template <class T>
+  void writeColumn(const string &column,
+		   const char *type,
+		   const vector<T> &values);
+  FILE *open(const string &filename);
+  string apName(const Corner *corner,
+		const MinMax *min_max) const;
+
+  const char *dirname_;
+  VertexSeq vertices_;
+  vector<Edge*> edges_;
+  // Index of the first arc row of each edge row (edge count + 1).
+  vector<uint32_t> arc_begin_;
+  // Role names indexed by TimingRole::index.
+  vector<string> roles_;
+  const char *table_;
+  size_t row_count_;
+  // Json for the columns of the current table and the finished tables.
+  string columns_json_;
+  string tables_json_;
+};
+
+void
+writeTimingColumns(const char *dirname,
+		   StaState *sta)
+{
+  TimingColumns columns(dirname, sta);
+  columns.write();
+}
+
+TimingColumns::TimingColumns(const char *dirname,
+			     StaState *sta) :
+  StaState(sta),
+  dirname_(dirname),
+  table_(nullptr),
+  row_count_(0)
+{
+}
+
+void
+TimingColumns::write()
+{
+  findRows();
+  writeVertices();
+  writeEdges();
+  writeArcs();
+  writeNames();
+  writeManifest();
+}
+
+// Vertex, edge and arc rows are found serially so the columns can be
+// filled in parallel.
+void
+TimingColumns::findRows()
+{
+  VertexIterator vertex_iter(graph_);
+  while (vertex_iter.hasNext()) {
+    Vertex *vertex = vertex_iter.next();
+    vertices_.push_back(vertex);
+    VertexOutEdgeIterator edge_iter(vertex, graph_);
+    while (edge_iter.hasNext()) {
+      Edge *edge = edge_iter.next();
+      edges_.push_back(edge);
+      const TimingRole *role = edge->role();
+      size_t role_index = role->index();
+      if (roles_.size() <= role_index)
+	roles_.resize(role_index + 1);
+      roles_[role_index] = role->asString();
+    }
+  }
+  arc_begin_.resize(edges_.size() + 1);
+  arc_begin_[0] = 0;
+  for (size_t i = 0; i < edges_.size(); i++)
+    arc_begin_[i + 1] = arc_begin_[i] + edges_[i]->timingArcSet()->arcCount();
+}
+
+void
+TimingColumns::writeVertices()
+{
+  size_t vertex_count = vertices_.size();
+  beginTable("vertices", vertex_count);
+  vector<uint32_t> indices(vertex_count);
+  vector<int32_t> levels(vertex_count);
+  vector<uint8_t> drivers(vertex_count);
+  forEachChunk(vertex_count, thread_pool_,
+	       [&] (size_t begin, size_t end, int) {
+		 for (size_t i = begin; i < end; i++) {
+		   Vertex *vertex = vertices_[i];
+		   const Pin *pin = vertex->pin();
+		   indices[i] = graph_->index(vertex);
+		   levels[i] = vertex->level();
+		   drivers[i] = network_->isDriver(pin)
+		     && (!network_->direction(pin)->isBidirect()
+			 || vertex->isBidirectDriver());
+		 }
+	       });
+  writeColumn("index", "uint32", indices);
+  writeColumn("level", "int32", levels);
+  writeColumn("driver", "uint8", drivers);
+  indices.clear();
+  levels.clear();
+  drivers.clear();
+
+  vector<float> slews(vertex_count);
+  for (auto dcalc_ap : corners_->dcalcAnalysisPts()) {
+    DcalcAPIndex ap_index = dcalc_ap->index();
+    TransRiseFallIterator tr_iter;
+    while (tr_iter.hasNext()) {
+      TransRiseFall *tr = tr_iter.next();
+      forEachChunk(vertex_count, thread_pool_,
+		   [&] (size_t begin, size_t end, int) {
+		     for (size_t i = begin; i < end; i++)
+		       slews[i] = delayAsFloat(graph_->slew(vertices_[i], tr,
+							    ap_index));
+		   });
+      string column = "slew_" + apName(dcalc_ap->corner(),
+				       dcalc_ap->slewMinMax())
+	+ "_" + tr->name();
+      writeColumn(column, "float32", slews);
+    }
+  }
+  slews.clear();
+
+  // Slack columns indexed by path analysis point.
+  // Vertices with no paths for an analysis point have NaN slack.
+  PathAPIndex path_ap_count = corners_->pathAnalysisPtCount();
+  vector<vector<float>> slacks(path_ap_count);
+  for (auto &ap_slacks : slacks)
+    ap_slacks.resize(vertex_count, std::numeric_limits<float>::quiet_NaN());
+  forEachChunk(vertex_count, thread_pool_,
+	       [&] (size_t begin, size_t end, int) {
+		 for (size_t i = begin; i < end; i++) {
+		   VertexPathIterator path_iter(vertices_[i], this);
+		   while (path_iter.hasNext()) {
+		     PathVertex *path = path_iter.next();
+		     float slack = delayAsFloat(path->slack(this));
+		     float &ap_slack = slacks[path->pathAnalysisPtIndex(this)][i];
+		     // NaN compares false.
+		     if (!(slack >= ap_slack))
+		       ap_slack = slack;
+		   }
+		 }
+	       });
+  for (auto path_ap : corners_->pathAnalysisPts()) {
+    string column = "slack_" + apName(path_ap->corner(),
+				      path_ap->pathMinMax());
+    writeColumn(column, "float32", slacks[path_ap->index()]);
+  }
+  endTable();
+}
+
+void
+TimingColumns::writeEdges()
+{
+  size_t edge_count = edges_.size();
+  beginTable("edges", edge_count);
+  vector<uint32_t> indices(edge_count);
+  vector<uint32_t> froms(edge_count);
+  vector<uint32_t> tos(edge_count);
+  vector<uint8_t> roles(edge_count);
+  forEachChunk(edge_count, thread_pool_,
+	       [&] (size_t begin, size_t end, int) {
+		 for (size_t i = begin; i < end; i++) {
+		   Edge *edge = edges_[i];
+		   indices[i] = graph_->index(edge);
+		   froms[i] = graph_->index(edge->from(graph_));
+		   tos[i] = graph_->index(edge->to(graph_));
+		   roles[i] = edge->role()->index();
+		 }
+	       });
+  writeColumn("index", "uint32", indices);
+  writeColumn("from", "uint32", froms);
+  writeColumn("to", "uint32", tos);
+  writeColumn("role", "uint8", roles);
+  endTable();
+}
+
+void
+TimingColumns::writeArcs()
+{
+  size_t edge_count = edges_.size();
+  size_t arc_count = arc_begin_[edge_count];
+  beginTable("arcs", arc_count);
+  vector<uint32_t> arc_edges(arc_count);
+  vector<uint8_t> from_rfs(arc_count);
+  vector<uint8_t> to_rfs(arc_count);
+  forEachChunk(edge_count, thread_pool_,
+	       [&] (size_t begin, size_t end, int) {
+		 for (size_t i = begin; i < end; i++) {
+		   size_t arc_row = arc_begin_[i];
+		   TimingArcSetArcIterator arc_iter(edges_[i]->timingArcSet());
+		   while (arc_iter.hasNext()) {
+		     TimingArc *arc = arc_iter.next();
+		     const TransRiseFall *from_rf = arc->fromTrans()->asRiseFall();
+		     const TransRiseFall *to_rf = arc->toTrans()->asRiseFall();
+		     arc_edges[arc_row] = i;
+		     from_rfs[arc_row] = from_rf
+		       ? from_rf->index()
+		       : timing_columns_no_rf;
+		     to_rfs[arc_row] = to_rf ? to_rf->index() : timing_columns_no_rf;
+		     arc_row++;
+		   }
+		 }
+	       });
+  writeColumn("edge", "uint32", arc_edges);
+  writeColumn("from_rf", "uint8", from_rfs);
+  writeColumn("to_rf", "uint8", to_rfs);
+  arc_edges.clear();
+  from_rfs.clear();
+  to_rfs.clear();
+
+  vector<float> delays(arc_count);
+  for (auto dcalc_ap : corners_->dcalcAnalysisPts()) {
+    DcalcAPIndex ap_index = dcalc_ap->index();
+    forEachChunk(edge_count, thread_pool_,
+		 [&] (size_t begin, size_t end, int) {
+		   for (size_t i = begin; i < end; i++) {
+		     Edge *edge = edges_[i];
+		     size_t arc_row = arc_begin_[i];
+		     TimingArcSetArcIterator arc_iter(edge->timingArcSet());
+		     while (arc_iter.hasNext()) {
+		       TimingArc *arc = arc_iter.next();
+		       delays[arc_row++] =
+			 delayAsFloat(graph_->arcDelay(edge, arc, ap_index));
+		     }
+		   }
+		 });
+    string column = "delay_" + apName(dcalc_ap->corner(),
+				      dcalc_ap->delayMinMax());
+    writeColumn(column, "float32", delays);
+  }
+  endTable();
+}
+
+void
+TimingColumns::writeNames()
+{
+  FILE *stream = open("vertices.names.txt");
+  for (auto vertex : vertices_)
+    fprintf(stream, "%s\n", vertex->name(network_));
+  if (fclose(stream) != 0)
+    throw FileNotWritable(dirname_);
+}
+
+void
+TimingColumns::writeManifest()
+{
+  FILE *stream = open("columns.json");
+  fprintf(stream, "{\"byte_order\": \"little\",\n");
+  fprintf(stream, " \"tables\": [%s\n ],\n", tables_json_.c_str());
+  fprintf(stream, " \"rf\": [\"rise\", \"fall\"],\n");
+  fprintf(stream, " \"roles\": [");
+  for (size_t i = 0; i < roles_.size(); i++)
+    fprintf(stream, "%s\"%s\"", (i > 0) ? ", " : "", roles_[i].c_str());
+  fprintf(stream, "]}\n");
+  if (fclose(stream) != 0)
+    throw FileNotWritable(dirname_);
+}
+
+void
+TimingColumns::beginTable(const char *table,
+			  size_t row_count)
+{
+  table_ = table;
+  row_count_ = row_count;
+  columns_json_.clear();
+}
+
+void
+TimingColumns::endTable()
+{
+  if (!tables_json_.empty())
+    tables_json_ += ",";
+  tables_json_ += "\n  {\"name\": \"";
+  tables_json_ += table_;
+  tables_json_ += "\", \"rows\": " + std::to_string(row_count_);
+  tables_json_ += ", \"columns\": [" + columns_json_ + "\n   ]}";
+}
+
+template <class T>
+void
+TimingColumns::writeColumn(const string &column,
+			   const char *type,
+			   const vector<T> &values)
+{
+  string filename = string(table_) + "." + column + ".bin";
+  FILE *stream = open(filename);
+  size_t write_count = values.empty()
+    ? 0
+    : fwrite(&values[0], sizeof(T), values.size(), stream);
+  if (fclose(stream) != 0 || write_count != values.size())
+    throw FileNotWritable(dirname_);
+  if (!columns_json_.empty())
+    columns_json_ += ",";
+  columns_json_ += "\n    {\"name\": \"" + column
+    + "\", \"type\": \"" + type
+    + "\", \"file\": \"" + filename + "\"}";
+}
+
+FILE *
+TimingColumns::open(const string &filename)
+{
+  string path = string(dirname_) + "/" + filename;
+  FILE *stream = fopen(path.c_str(), "wb");
+  if (stream == nullptr)
+    throw FileNotWritable(dirname_);
+  return stream;
+}
+
+string
+TimingColumns::apName(const Corner *corner,
+		      const MinMax *min_max) const
+{
+  return string(corner->name()) + "_" + min_max->asString();
+}
+
+} // namespace
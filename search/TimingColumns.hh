@@ -0,0 +1,42 @@
+// OpenSTA, Static Timing Analyzer
+// Copyright (c) 2019, Parallax Software, Inc.
+// 
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+// 
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+// 
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#ifndef STA_TIMING_COLUMNS_H
+#define STA_TIMING_COLUMNS_H
+
+namespace sta {
+
+class StaState;
+
+// Write the graph and timing results to dirname as columnar tables
+// for analysis outside of the STA.
+//  vertices: index level driver slew_<ap>_<rf> slack_<path_ap>
+//  edges:    index from to role
+//  arcs:     edge from_rf to_rf delay_<ap>
+// Each column is a file of little endian values with no header
+// (<table>.<column>.bin) so it can be memory mapped (numpy.memmap).
+// columns.json describes the tables, column types and row counts and
+// the role names indexed by the edges role column. vertices.names.txt
+// has the pin name of each vertex row.
+// Columns are filled in parallel.
+// Requireds must be up to date.
+// Throws FileNotWritable.
+void
+writeTimingColumns(const char *dirname,
+		   StaState *sta);
+
+} // namespace
+#endif
@@ -32,6 +32,18 @@ public:
   virtual VertexVisitor *copy() = 0;
   virtual void visit(Vertex *vertex) = 0;
   void operator()(Vertex *vertex) { visit(vertex); }
+  // Vertices other than the edge fanin that must be visited before
+  // vertex when vertices are not visited in level order
+  // (dataflow scheduling).  The dependencies must not form a cycle.
+  virtual void dataflowPreds(Vertex *,
+			     // Return value.
+			     VertexSeq &) {}
+  // Called with the queued vertices of a level before BfsIterator
+  // visits them in level order. Removed vertices are null.
+  virtual void levelBegin(const VertexSeq &) {}
+  // True if visiting vertex is much more work than the other vertices
+  // in its level. Parallel level visits start heavy vertices first.
+  virtual bool heavy(Vertex *) { return false; }
 
 private:
   DISALLOW_COPY_AND_ASSIGN(VertexVisitor);
@@ -14,6 +14,7 @@
 // You should have received a copy of the GNU General Public License
 // along with this program.  If not, see <https://www.gnu.org/licenses/>.
 
+#include <vector>
 #include "Machine.hh"
 #include "Debug.hh"
 #include "Graph.hh"
@@ -27,15 +28,28 @@
 
 namespace sta {
 
-typedef Set<PathVertex*, PathLess> PathVertexSet;
-typedef Map<Vertex*, PathVertexSet*> VertexPathSetMap;
+// Path group matches of each vertex's arrivals indexed by VertexIndex.
+// Each vertex has a bitmap indexed by arrival index of the paths that
+// are in the path group's fanin. A vertex with an empty bitmap does not
+// match. The backward search only writes the entry of the vertex
+// being visited and reads the entries of its fanout, which are on
+// higher levels that have already been visited, so the search can
+// visit each level in parallel.
+class PathGroupMatches
+{
+public:
+  explicit PathGroupMatches(const Graph *graph);
+  bool matches(Vertex *vertex) const;
+  bool matches(VertexIndex vertex_index) const;
+  bool matches(const PathVertex *path,
+	       const StaState *sta) const;
+  void insert(Vertex *vertex,
+	      int arrival_index);
 
-static void
-vertexPathSetMapInsertPath(VertexPathSetMap *matching_path_map,
-			   Vertex *vertex,
-			   Tag *tag,
-			   int arrival_index,
-			   const StaState *sta);
+private:
+  const Graph *graph_;
+  std::vector<std::vector<bool>> arrivals_;
+};
 
 // Visit each path end for a vertex and add the worst one in each
 // path group to the group.
@@ -43,8 +57,7 @@ class VisitPathGroupEnds : public PathEndVisitor
 {
 public:
   explicit VisitPathGroupEnds(PathGroup *path_group,
-			      VertexVisitor *vertex_visitor,
-			      VertexPathSetMap *matching_path_map,
+			      PathGroupMatches *matches,
 			      BfsBkwdIterator *bkwd_iter,
 			      StaState *sta);
   virtual PathEndVisitor *copy();
@@ -56,9 +69,8 @@ private:
   DISALLOW_COPY_AND_ASSIGN(VisitPathGroupEnds);
 
   PathGroup *path_group_;
-  VertexVisitor *vertex_visitor_;
   BfsBkwdIterator *bkwd_iter_;
-  VertexPathSetMap *matching_path_map_;
+  PathGroupMatches *matches_;
   bool vertex_matches_;
   StaState *sta_;
 };
@@ -66,9 +78,8 @@ private:
 class PathGroupPathVisitor : public PathVisitor
 {
 public:
-  PathGroupPathVisitor(VertexVisitor *visitor,
-		       BfsBkwdIterator *bkwd_iter,
-		       VertexPathSetMap *matching_path_map,
+  PathGroupPathVisitor(BfsBkwdIterator *bkwd_iter,
+		       PathGroupMatches *matches,
 		       const StaState *sta);
   virtual ~PathGroupPathVisitor();
   virtual VertexVisitor *copy();
@@ -91,13 +102,11 @@ protected:
 			       const MinMax *min_max,
 			       const PathAnalysisPt *path_ap);
   void fromMatches(Vertex *from_vertex,
-		   Tag *from_tag,
 		   int from_arrival_index);
 
 private:
-  VertexVisitor *visitor_;
   BfsBkwdIterator *bkwd_iter_;
-  VertexPathSetMap *matching_path_map_;
+  PathGroupMatches *matches_;
   bool vertex_matches_;
 };
 
@@ -111,50 +120,83 @@ visitPathGroupVertices(PathGroup *path_group,
 		       StaState *sta)
 {
   Search *search = sta->search();
-  VertexPathSetMap matching_path_map;
+  Graph *graph = sta->graph();
+  PathGroupMatches matches(graph);
   // Do not visit clock network.
   SearchPredNonReg2 srch_non_reg(sta);
   BfsBkwdIterator bkwd_iter(BfsIndex::other, &srch_non_reg, sta);
   // Visit the path ends and filter by path_group to seed the backward search.
-  VisitPathGroupEnds end_visitor(path_group, visitor, &matching_path_map,
-				 &bkwd_iter, sta);
+  VisitPathGroupEnds end_visitor(path_group, &matches, &bkwd_iter, sta);
   VisitPathEnds visit_path_ends(sta);
-  VertexSet::Iterator end_iter(search->endpoints());
-  while (end_iter.hasNext()) {
-    Vertex *vertex = end_iter.next();
+  for (Vertex *vertex : *search->endpoints())
     visit_path_ends.visitPathEnds(vertex, &end_visitor);
-  }
 
   // Search backward from the path ends thru vertices that have arrival tags
   // that match path_group end paths.
-  PathGroupPathVisitor path_visitor(visitor, &bkwd_iter, &matching_path_map,
-				    sta);
-  bkwd_iter.visit(0, &path_visitor);
-
-  // Cleanup.
-  VertexPathSetMap::Iterator matching_iter(matching_path_map);
-  while (matching_iter.hasNext()) {
-    PathVertexSet *paths = matching_iter.next();
-    PathVertexSet::Iterator path_iter(paths);
-    while (path_iter.hasNext()) {
-      PathVertex *path = path_iter.next();
-      delete path;
-    }
-    delete paths;
+  PathGroupPathVisitor path_visitor(&bkwd_iter, &matches, sta);
+  bkwd_iter.visitParallel(0, &path_visitor);
+
+  // Visitors are not thread safe so the matching vertices are visited
+  // after the search.
+  VertexIndex index_bound = graph->vertexIndexBound();
+  for (VertexIndex index = 1; index < index_bound; index++) {
+    if (matches.matches(index))
+      visitor->visit(graph->vertex(index));
   }
 }
 
 ////////////////////////////////////////////////////////////////
 
+PathGroupMatches::PathGroupMatches(const Graph *graph) :
+  graph_(graph),
+  arrivals_(graph->vertexIndexBound())
+{
+}
+
+bool
+PathGroupMatches::matches(Vertex *vertex) const
+{
+  return matches(graph_->index(vertex));
+}
+
+bool
+PathGroupMatches::matches(VertexIndex vertex_index) const
+{
+  return !arrivals_[vertex_index].empty();
+}
+
+bool
+PathGroupMatches::matches(const PathVertex *path,
+			  const StaState *sta) const
+{
+  const std::vector<bool> &arrivals = arrivals_[path->vertexIndex(sta)];
+  int arrival_index;
+  bool arrival_exists;
+  path->arrivalIndex(arrival_index, arrival_exists);
+  return arrival_exists
+    && static_cast<size_t>(arrival_index) < arrivals.size()
+    && arrivals[arrival_index];
+}
+
+void
+PathGroupMatches::insert(Vertex *vertex,
+			 int arrival_index)
+{
+  std::vector<bool> &arrivals = arrivals_[graph_->index(vertex)];
+  if (static_cast<size_t>(arrival_index) >= arrivals.size())
+    arrivals.resize(arrival_index + 1, false);
+  arrivals[arrival_index] = true;
+}
+
+////////////////////////////////////////////////////////////////
+
 VisitPathGroupEnds::VisitPathGroupEnds(PathGroup *path_group,
-				       VertexVisitor *vertex_visitor,
-				       VertexPathSetMap *matching_path_map,
+				       PathGroupMatches *matches,
 				       BfsBkwdIterator *bkwd_iter,
 				       StaState *sta) :
   path_group_(path_group),
-  vertex_visitor_(vertex_visitor),
   bkwd_iter_(bkwd_iter),
-  matching_path_map_(matching_path_map),
+  matches_(matches),
   sta_(sta)
 {
 }
@@ -162,8 +204,7 @@ VisitPathGroupEnds::VisitPathGroupEnds(PathGroup *path_group,
 PathEndVisitor *
 VisitPathGroupEnds::copy()
 {
-  return new VisitPathGroupEnds(path_group_, vertex_visitor_,
-				matching_path_map_, bkwd_iter_, sta_);
+  return new VisitPathGroupEnds(path_group_, matches_, bkwd_iter_, sta_);
 }
 
 void
@@ -183,49 +224,27 @@ VisitPathGroupEnds::visit(PathEnd *path_end)
     int arrival_index;
     bool arrival_exists;
     path.arrivalIndex(arrival_index, arrival_exists);
-    vertexPathSetMapInsertPath(matching_path_map_, vertex, path.tag(sta_),
-			       arrival_index, sta_);
+    matches_->insert(vertex, arrival_index);
     vertex_matches_ = true;
   }
 }
 
-static void
-vertexPathSetMapInsertPath(VertexPathSetMap *matching_path_map,
-			   Vertex *vertex,
-			   Tag *tag,
-			   int arrival_index,
-			   const StaState *sta)
-{
-  PathVertexSet *matching_paths = matching_path_map->findKey(vertex);
-  if (matching_paths == nullptr) {
-    PathLess path_less(sta);
-    matching_paths = new PathVertexSet(path_less);
-    (*matching_path_map)[vertex] = matching_paths;
-  }
-  PathVertex *vpath = new PathVertex(vertex, tag, arrival_index);
-  matching_paths->insert(vpath);
-}
-
 void
 VisitPathGroupEnds::vertexEnd(Vertex *vertex)
 {
-  if (vertex_matches_) {
-    vertex_visitor_->visit(vertex);
+  if (vertex_matches_)
     // Seed backward bfs fanin search.
     bkwd_iter_->enqueueAdjacentVertices(vertex);
-  }
 }
 
 ////////////////////////////////////////////////////////////////
 
-PathGroupPathVisitor::PathGroupPathVisitor(VertexVisitor *visitor,
-					   BfsBkwdIterator *bkwd_iter,
-					   VertexPathSetMap *matching_path_map,
+PathGroupPathVisitor::PathGroupPathVisitor(BfsBkwdIterator *bkwd_iter,
+					   PathGroupMatches *matches,
 					   const StaState *sta) :
   PathVisitor(sta),
-  visitor_(visitor),
   bkwd_iter_(bkwd_iter),
-  matching_path_map_(matching_path_map)
+  matches_(matches)
 {
 }
 
@@ -236,8 +255,7 @@ PathGroupPathVisitor::~PathGroupPathVisitor()
 VertexVisitor *
 PathGroupPathVisitor::copy()
 {
-  return new PathGroupPathVisitor(visitor_, bkwd_iter_, matching_path_map_,
-				  sta_);
+  return new PathGroupPathVisitor(bkwd_iter_, matches_, sta_);
 }
 
 void
@@ -249,7 +267,6 @@ PathGroupPathVisitor::visit(Vertex *vertex)
     const Debug *debug = sta_->debug();
     debugPrint1(debug, "visit_path_group", 1, "visit %s\n",
 		vertex->name(sta_->network()));
-    visitor_->visit(vertex);
     bkwd_iter_->enqueueAdjacentVertices(vertex);
   }
 }
@@ -270,21 +287,20 @@ PathGroupPathVisitor::visitFromToPath(const Pin *,
 				      const MinMax *,
 				      const PathAnalysisPt *path_ap)
 {
-  PathVertexSet *matching_paths = matching_path_map_->findKey(to_vertex);
-  if (matching_paths) {
+  if (matches_->matches(to_vertex)) {
     int arrival_index;
     bool arrival_exists;
     from_path->arrivalIndex(arrival_index, arrival_exists);
     PathVertex to_path(to_vertex, to_tag, sta_);
     if (!to_path.isNull()) {
-      if (matching_paths->hasKey(&to_path)) {
+      if (matches_->matches(&to_path, sta_)) {
 	const Debug *debug = sta_->debug();
 	debugPrint4(debug, "visit_path_group", 2, "match %s %s -> %s %s\n",
 		    from_vertex->name(sta_->network()),
 		    from_tag->asString(sta_),
 		    to_vertex->name(sta_->network()),
 		    to_tag->asString(sta_));
-	fromMatches(from_vertex, from_tag, arrival_index);
+	fromMatches(from_vertex, arrival_index);
       }
     }
     else {
@@ -292,7 +308,7 @@ PathGroupPathVisitor::visitFromToPath(const Pin *,
       while (to_iter.hasNext()) {
 	PathVertex *to_path = to_iter.next();
 	if (tagMatchNoCrpr(to_path->tag(sta_), to_tag)
-	    && matching_paths->hasKey(to_path)) {
+	    && matches_->matches(to_path, sta_)) {
 	  const Debug *debug = sta_->debug();
 	  debugPrint4(debug, "visit_path_group", 2, 
 		      "match crpr %s %s -> %s %s\n",
@@ -300,7 +316,7 @@ PathGroupPathVisitor::visitFromToPath(const Pin *,
 		      from_tag->asString(sta_),
 		      to_vertex->name(sta_->network()),
 		      to_tag->asString(sta_));
-	  fromMatches(from_vertex, from_tag, arrival_index);
+	  fromMatches(from_vertex, arrival_index);
 	}
       }
     }
@@ -310,12 +326,10 @@ PathGroupPathVisitor::visitFromToPath(const Pin *,
 
 void
 PathGroupPathVisitor::fromMatches(Vertex *from_vertex,
-				  Tag *from_tag,
 				  int from_arrival_index)
 {
   vertex_matches_ = true;
-  vertexPathSetMapInsertPath(matching_path_map_, from_vertex,
-			     from_tag, from_arrival_index, sta_);
+  matches_->insert(from_vertex, from_arrival_index);
 }
 
 } // namespace
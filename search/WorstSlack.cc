@@ -14,8 +14,11 @@
 // You should have received a copy of the GNU General Public License
 // along with this program.  If not, see <https://www.gnu.org/licenses/>.
 
+#include <algorithm>
+#include <vector>
 #include "Machine.hh"
 #include "Mutex.hh"
+#include "ThreadForEach.hh"
 #include "Debug.hh"
 #include "Report.hh"
 #include "Graph.hh"
@@ -42,6 +45,7 @@ WorstSlacks::worstSlack(const MinMax *min_max,
 {
   worst_slack = MinMax::min()->initValue();
   worst_vertex = nullptr;
+  initQueues(min_max);
   CornerIterator corner_iter(sta_);
   while (corner_iter.hasNext()) {
     Corner *corner = corner_iter.next();
@@ -69,6 +73,34 @@ WorstSlacks::worstSlack(const Corner *corner,
 					  worst_slack, worst_vertex);
 }
 
+void
+WorstSlacks::initQueues(const MinMax *min_max)
+{
+  std::vector<PathAPIndex> path_ap_indices;
+  CornerIterator corner_iter(sta_);
+  while (corner_iter.hasNext()) {
+    Corner *corner = corner_iter.next();
+    PathAPIndex path_ap_index = corner->findPathAnalysisPt(min_max)->index();
+    if (worst_slacks_[path_ap_index].initQueueNeeded())
+      path_ap_indices.push_back(path_ap_index);
+  }
+  // A single queue is initialized by findWorstSlack.
+  if (path_ap_indices.size() > 1) {
+    Search *search = sta_->search();
+    const VertexSeq &ends = *search->endpoints();
+    SlackSeq end_slacks;
+    search->wnsSlacks(ends, end_slacks);
+    forEachChunk(path_ap_indices.size(), sta_->threadPool(),
+		 [&] (size_t begin, size_t end, int) {
+		   for (size_t i = begin; i < end; i++) {
+		     PathAPIndex path_ap_index = path_ap_indices[i];
+		     worst_slacks_[path_ap_index].initQueue(path_ap_index, ends,
+							     end_slacks, sta_);
+		   }
+		 });
+  }
+}
+
 void
 WorstSlacks::updateWorstSlacks(Vertex *vertex,
 			       SlackSeq &slacks)
@@ -95,6 +127,9 @@ WorstSlack::WorstSlack() :
   worst_vertex_(nullptr),
   worst_slack_(slack_init_),
   slack_threshold_(slack_init_),
+  buckets_(bucket_count_),
+  bucket_min_(0.0),
+  bucket_width_(0.0),
   min_queue_size_(10),
   max_queue_size_(20)
 {
@@ -105,6 +140,9 @@ WorstSlack::WorstSlack(const WorstSlack &) :
   worst_vertex_(nullptr),
   worst_slack_(slack_init_),
   slack_threshold_(slack_init_),
+  buckets_(bucket_count_),
+  bucket_min_(0.0),
+  bucket_width_(0.0),
   min_queue_size_(10),
   max_queue_size_(20)
 {
@@ -118,7 +156,7 @@ WorstSlack::deleteVertexBefore(Vertex *vertex)
     worst_vertex_ = nullptr;
     worst_slack_ = slack_init_;
   }
-  queue_.erase(vertex);
+  queueErase(vertex);
 }
 
 void
@@ -145,94 +183,103 @@ WorstSlack::findWorstSlack(PathAPIndex path_ap_index,
   }
 }
 
+bool
+WorstSlack::initQueueNeeded() const
+{
+  return worst_vertex_ == nullptr
+    && queue_.empty();
+}
+
 void
 WorstSlack::initQueue(PathAPIndex path_ap_index,
 		      const StaState *sta)
 {
   Search *search = sta->search();
+  const VertexSeq &ends = *search->endpoints();
+  SlackSeq end_slacks;
+  search->wnsSlacks(ends, end_slacks);
+  initQueue(path_ap_index, ends, end_slacks, sta);
+}
+
+void
+WorstSlack::initQueue(PathAPIndex path_ap_index,
+		      const VertexSeq &ends,
+		      const SlackSeq &end_slacks,
+		      const StaState *sta)
+{
   const Debug *debug = sta->debug();
   debugPrint0(debug, "wns", 3, "init queue\n");
 
-  queue_.clear();
+  queueClear();
   worst_vertex_ = nullptr;
   worst_slack_ = slack_init_;
   slack_threshold_ = slack_init_;
-  VertexSet::Iterator end_iter(search->endpoints());
-  while (end_iter.hasNext()) {
-    Vertex *vertex = end_iter.next();
-    Slack slack = search->wnsSlack(vertex, path_ap_index);
+  PathAPIndex path_ap_count = sta->corners()->pathAnalysisPtCount();
+  typedef std::pair<Slack, Vertex*> SlackVertex;
+  std::vector<SlackVertex> slack_vertices;
+  for (size_t i = 0; i < ends.size(); i++) {
+    Slack slack = end_slacks[i * path_ap_count + path_ap_index];
     if (!fuzzyEqual(slack, slack_init_)) {
+      Vertex *vertex = ends[i];
       if (fuzzyLess(slack, worst_slack_))
 	setWorstSlack(vertex, slack, sta);
-      if (fuzzyLessEqual(slack, slack_threshold_))
-	queue_.insert(vertex);
-      int queue_size = queue_.size();
-      if (queue_size >= max_queue_size_)
-	sortQueue(path_ap_index, sta);
+      slack_vertices.push_back(SlackVertex(slack, vertex));
     }
   }
-  debugPrint1(debug, "wns", 3, "threshold %s\n",
-	      delayAsString(slack_threshold_, sta));
-//  checkQueue();
-}
-
-void
-WorstSlack::sortQueue(PathAPIndex path_ap_index,
-		      const StaState *sta)
-{
-  Search *search = sta->search();
-  const Debug *debug = sta->debug();
-  debugPrint0(debug, "wns", 3, "sort queue\n");
-
-  VertexSeq vertices;
-  vertices.reserve(queue_.size());
-  VertexSet::Iterator queue_iter(queue_);
-  while (queue_iter.hasNext()) {
-    Vertex *vertex = queue_iter.next();
-    vertices.push_back(vertex);
+  int vertex_count = slack_vertices.size();
+  if (vertex_count >= max_queue_size_) {
+    // Keep the min_queue_size_ worst slacks. Only the threshold slack
+    // is needed so the slacks are partitioned rather than sorted.
+    int threshold_index = min(min_queue_size_, vertex_count - 1);
+    std::nth_element(slack_vertices.begin(),
+		     slack_vertices.begin() + threshold_index,
+		     slack_vertices.end(),
+		     [] (const SlackVertex &slack_vertex1,
+			 const SlackVertex &slack_vertex2) {
+		       return fuzzyLess(slack_vertex1.first,
+					slack_vertex2.first);
+		     });
+    slack_threshold_ = slack_vertices[threshold_index].first;
   }
-  WnsSlackLess slack_less(path_ap_index, sta);
-  sort(vertices, slack_less);
-
-  int vertex_count = vertices.size();
-  int threshold_index = min(min_queue_size_, vertex_count - 1);
-  Vertex *threshold_vertex = vertices[threshold_index];
-  slack_threshold_ = search->wnsSlack(threshold_vertex, path_ap_index);
+  if (worst_vertex_) {
+    bucket_min_ = delayAsFloat(worst_slack_);
+    if (vertex_count >= max_queue_size_)
+      bucket_width_ = (delayAsFloat(slack_threshold_) - bucket_min_)
+	/ bucket_count_;
+    else
+      bucket_width_ = 0.0;
+  }
+  for (auto &slack_vertex : slack_vertices) {
+    if (vertex_count < max_queue_size_
+	|| fuzzyLessEqual(slack_vertex.first, slack_threshold_))
+      queueInsert(slack_vertex.second, slack_vertex.first);
+  }
+  if (vertex_count >= max_queue_size_)
+    max_queue_size_ = queue_.size() * 2;
   debugPrint1(debug, "wns", 3, "threshold %s\n",
 	      delayAsString(slack_threshold_, sta));
-
-  // Reinsert vertices with slack < threshold.
-  queue_.clear();
-  VertexSeq::Iterator queue_iter2(vertices);
-  while (queue_iter2.hasNext()) {
-    Vertex *vertex = queue_iter2.next();
-    Slack slack = search->wnsSlack(vertex, path_ap_index);
-    if (fuzzyGreater(slack, slack_threshold_))
-      break;
-    queue_.insert(vertex);
-  }
-  max_queue_size_ = queue_.size() * 2;
-  Vertex *worst_slack_vertex = vertices[0];
-  Slack worst_slack_slack = search->wnsSlack(worst_slack_vertex, path_ap_index);
-  setWorstSlack(worst_slack_vertex, worst_slack_slack, sta);
+//  checkQueue();
 }
 
 void
-WorstSlack::findWorstInQueue(PathAPIndex path_ap_index,
+WorstSlack::findWorstInQueue(PathAPIndex,
 			     const StaState *sta)
 {
-  Search *search = sta->search();
   const Debug *debug = sta->debug();
   debugPrint0(debug, "wns", 3, "find worst in queue\n");
 
   worst_vertex_ = nullptr;
   worst_slack_ = slack_init_;
-  VertexSet::Iterator queue_iter(queue_);
-  while (queue_iter.hasNext()) {
-    Vertex *vertex = queue_iter.next();
-    Slack slack = search->wnsSlack(vertex, path_ap_index);
-    if (slack < worst_slack_)
-      setWorstSlack(vertex, slack, sta);
+  // The worst slack is in the first non-empty bucket.
+  for (auto &bucket : buckets_) {
+    if (!bucket.empty()) {
+      for (auto &vertex_slack : bucket) {
+	Slack slack = vertex_slack.second;
+	if (slack < worst_slack_)
+	  setWorstSlack(vertex_slack.first, slack, sta);
+      }
+      break;
+    }
   }
 }
 
@@ -245,9 +292,7 @@ WorstSlack::checkQueue(PathAPIndex path_ap_index,
   const Network *network = sta->network();
 
   VertexSeq ends;
-  VertexSet::Iterator end_iter(search->endpoints());
-  while (end_iter.hasNext()) {
-    Vertex *end = end_iter.next();
+  for (Vertex *end : *search->endpoints()) {
     if (fuzzyLessEqual(search->wnsSlack(end, path_ap_index),
 			    slack_threshold_))
       ends.push_back(end);
@@ -269,9 +314,11 @@ WorstSlack::checkQueue(PathAPIndex path_ap_index,
 		    delayAsString(slack_threshold_, sta));
   }
 
-  VertexSet::Iterator queue_iter(queue_);
+  WorstSlackBucketIndexMap::Iterator queue_iter(queue_);
   while (queue_iter.hasNext()) {
-    Vertex *end = queue_iter.next();
+    Vertex *end;
+    int bucket_index;
+    queue_iter.next(end, bucket_index);
     if (!end_set.hasKey(end))
       report->print("WorstSlack queue extra %s %s > %s\n",
 		    end->name(network),
@@ -305,13 +352,13 @@ WorstSlack::updateWorstSlack(Vertex *vertex,
     debugPrint2(debug, "wns", 3, "insert %s %s\n",
 		vertex->name(network),
 		delayAsString(slack, sta));
-    queue_.insert(vertex);
+    queueInsert(vertex, slack);
   }
   else {
     debugPrint2(debug, "wns", 3, "delete %s %s\n",
 		vertex->name(network),
 		delayAsString(slack, sta));
-    queue_.erase(vertex);
+    queueErase(vertex);
   }
   //  checkQueue();
 }
@@ -328,6 +375,52 @@ WorstSlack::setWorstSlack(Vertex *vertex,
   worst_slack_ = slack;
 }
 
+void
+WorstSlack::queueClear()
+{
+  for (auto &bucket : buckets_)
+    bucket.clear();
+  queue_.clear();
+}
+
+void
+WorstSlack::queueInsert(Vertex *vertex,
+			Slack slack)
+{
+  queueErase(vertex);
+  int bucket_index = bucketIndex(slack);
+  buckets_[bucket_index][vertex] = slack;
+  queue_[vertex] = bucket_index;
+}
+
+void
+WorstSlack::queueErase(Vertex *vertex)
+{
+  int bucket_index;
+  bool exists;
+  queue_.findKey(vertex, bucket_index, exists);
+  if (exists) {
+    buckets_[bucket_index].erase(vertex);
+    queue_.erase(vertex);
+  }
+}
+
+int
+WorstSlack::bucketIndex(Slack slack) const
+{
+  if (bucket_width_ > 0.0) {
+    float bucket = (delayAsFloat(slack) - bucket_min_) / bucket_width_;
+    if (bucket <= 0.0)
+      return 0;
+    else if (bucket >= bucket_count_)
+      return bucket_count_ - 1;
+    else
+      return static_cast<int>(bucket);
+  }
+  else
+    return 0;
+}
+
 ////////////////////////////////////////////////////////////////
 
 WnsSlackLess::WnsSlackLess(PathAPIndex path_ap_index,
@@ -22,6 +22,7 @@ namespace sta {
 #include <mutex>
 #include "MinMax.hh"
 #include "Vector.hh"
+#include "UnorderedMap.hh"
 #include "GraphClass.hh"
 #include "SearchClass.hh"
 
@@ -30,6 +31,11 @@ class WorstSlack;
 class WnsSlackLess;
 
 typedef Vector<WorstSlack> WorstSlackSeq;
+// Queue vertex -> slack.
+typedef UnorderedMap<Vertex*, Slack> WorstSlackBucket;
+typedef Vector<WorstSlackBucket> WorstSlackBucketSeq;
+// Queue vertex -> bucket index.
+typedef UnorderedMap<Vertex*, int> WorstSlackBucketIndexMap;
 
 class WorstSlacks
 {
@@ -49,6 +55,10 @@ public:
   void worstSlackNotifyBefore(Vertex *vertex);
 
 protected:
+  // Initialize the queues of the path analysis points of min_max for
+  // all corners from one parallel pass over the endpoints.
+  void initQueues(const MinMax *min_max);
+
   WorstSlackSeq worst_slacks_;
   const StaState *sta_;
 };
@@ -81,6 +91,13 @@ public:
 			PathAPIndex path_ap_index,
 			const StaState *sta);
   void deleteVertexBefore(Vertex *vertex);
+  bool initQueueNeeded() const;
+  // Initialize the queue from the endpoint slacks found by
+  // Search::wnsSlacks.
+  void initQueue(PathAPIndex path_ap_index,
+		 const VertexSeq &ends,
+		 const SlackSeq &end_slacks,
+		 const StaState *sta);
 
 protected:
   void findWorstSlack(PathAPIndex path_ap_index,
@@ -92,10 +109,13 @@ protected:
   void setWorstSlack(Vertex *vertex,
 		     Slack slack,
 		     const StaState *sta);
-  void sortQueue(PathAPIndex path_ap_index,
-		 const StaState *sta);
   void checkQueue(PathAPIndex path_ap_index,
 		  const StaState *sta);
+  void queueClear();
+  void queueInsert(Vertex *vertex,
+		   Slack slack);
+  void queueErase(Vertex *vertex);
+  int bucketIndex(Slack slack) const;
 
   Slack slack_init_;
   // Vertex with the worst slack.
@@ -103,13 +123,20 @@ protected:
   Vertex *worst_vertex_;
   Slack worst_slack_;
   Slack slack_threshold_;
-  // Vertices with slack < threshold_
-  VertexSet queue_;
-  // Queue is sorted and pruned to min_queue_size_ vertices when it
-  // reaches max_queue_size_.
+  // Vertices with slack < threshold_ and their slacks in a histogram
+  // of bucket_count_ buckets between bucket_min_ and the threshold.
+  // Slacks worse than bucket_min_ are in the first bucket.
+  WorstSlackBucketSeq buckets_;
+  WorstSlackBucketIndexMap queue_;
+  float bucket_min_;
+  float bucket_width_;
+  // Queue is pruned to min_queue_size_ vertices when it is
+  // initialized with more than max_queue_size_ vertices.
   int min_queue_size_;
   int max_queue_size_;
   std::mutex lock_;
+
+  static const int bucket_count_ = 32;
 };
 
 } // namespace
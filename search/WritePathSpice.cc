@@ -14,6 +14,12 @@
 // You should have received a copy of the GNU General Public License
 // along with this program.  If not, see <https://www.gnu.org/licenses/>.
 
+#include <sys/stat.h>
+#include <string.h>
+#include <algorithm>
+#include <exception>
+#include <memory>
+#include <mutex>
 #include <string>
 #include <iostream>
 #include <fstream>
@@ -22,6 +28,7 @@
 #include "Error.hh"
 #include "Report.hh"
 #include "StringUtil.hh"
+#include "ThreadForEach.hh"
 #include "FuncExpr.hh"
 #include "Units.hh"
 #include "Sequential.hh"
@@ -34,10 +41,13 @@
 #include "Sdc.hh"
 #include "DcalcAnalysisPt.hh"
 #include "Parasitics.hh"
+#include "Corner.hh"
+#include "SpefReader.hh"
 #include "PathAnalysisPt.hh"
 #include "Path.hh"
 #include "PathRef.hh"
 #include "PathExpanded.hh"
+#include "PathEnd.hh"
 #include "StaState.hh"
 #include "Sim.hh"
 #include "WritePathSpice.hh"
@@ -67,6 +77,52 @@ streamPrint(ofstream &stream,
 
 ////////////////////////////////////////////////////////////////
 
+// Location of a subckt definition in a spice library file.
+class SubcktLocation
+{
+public:
+  // Offset of the .subckt line.
+  std::streamoff begin_;
+  // Length through the end of the .ends line.
+  size_t length_;
+  bool ends_found_;
+  // .subckt <cell_name> [args..]
+  StringVector tokens_;
+};
+
+// Index of the subckt definitions in a spice library file so the
+// subckts used by a path can be copied without parsing the library.
+class SpiceSubcktIndex
+{
+public:
+  explicit SpiceSubcktIndex(const char *filename);
+  // Return false if the file is not readable.
+  bool read();
+  // True if the file has not changed since it was read.
+  bool isCurrent() const;
+  const SubcktLocation *find(const char *cell_name) const;
+  const string &filename() const { return filename_; }
+
+private:
+  DISALLOW_COPY_AND_ASSIGN(SpiceSubcktIndex);
+  static bool fileStat(const char *filename,
+		       // Return values.
+		       off_t &size,
+		       time_t &mtime);
+
+  string filename_;
+  off_t size_;
+  time_t mtime_;
+  Map<string, SubcktLocation> subckts_;
+};
+
+typedef std::shared_ptr<const SpiceSubcktIndex> SpiceSubcktIndexPtr;
+
+static SpiceSubcktIndexPtr
+spiceSubcktIndex(const char *filename);
+
+////////////////////////////////////////////////////////////////
+
 class WritePathSpice : public StaState
 {
 public:
@@ -80,6 +136,8 @@ public:
 		 const StaState *sta);
   ~WritePathSpice();
   void writeSpice();;
+  // Messages are printed to report instead of the sta report.
+  void setReport(Report *report) { report_ = report; }
 
 private:
   void writeHeader();
@@ -103,11 +161,13 @@ private:
 			       const Clock *clk,
 			       DcalcAPIndex dcalc_ap_index);
   void writeStageParasitics(Stage stage);
+  void readDiscardedNetworks();
+  void deleteRereadNetworks();
   void writeSubckts();
   void findPathCellnames(// Return values.
 			 StringSet &path_cell_names);
   void recordSpicePortNames(const char *cell_name,
-			    StringVector &tokens);
+			    const StringVector &tokens);
   float maxTime();
   const char *nodeName(ParasiticNode *node);
   void initNodeMap(const char *net_name);
@@ -218,6 +278,9 @@ private:
   PathExpanded path_expanded_;
   CellSpicePortNames cell_spice_port_names_;
   ParasiticNodeMap node_map_;
+  // Nets with parasitic networks read again from discarded spef files.
+  NetSet reread_nets_;
+  ParasiticAnalysisPt *reread_ap_;
   int next_node_index_;
   const char *net_name_;
   float power_voltage_;
@@ -259,6 +322,246 @@ SubcktEndsMissing::what() const throw()
 
 ////////////////////////////////////////////////////////////////
 
+SpiceSubcktIndex::SpiceSubcktIndex(const char *filename) :
+  filename_(filename),
+  size_(0),
+  mtime_(0)
+{
+}
+
+bool
+SpiceSubcktIndex::fileStat(const char *filename,
+			   // Return values.
+			   off_t &size,
+			   time_t &mtime)
+{
+  struct stat file_stat;
+  if (stat(filename, &file_stat) == 0) {
+    size = file_stat.st_size;
+    mtime = file_stat.st_mtime;
+    return true;
+  }
+  else
+    return false;
+}
+
+bool
+SpiceSubcktIndex::read()
+{
+  const char *filename = filename_.c_str();
+  if (!fileStat(filename, size_, mtime_))
+    return false;
+  ifstream stream(filename, std::ios::binary);
+  if (!stream.is_open())
+    return false;
+  std::streamoff offset = 0;
+  SubcktLocation *subckt = nullptr;
+  string line;
+  while (getline(stream, line)) {
+    std::streamoff line_begin = offset;
+    // getline drops the newline.
+    offset += line.size() + 1;
+    if (subckt) {
+      if (stringBeginEqual(line.c_str(), ".ends")) {
+	subckt->length_ = std::min(offset, static_cast<std::streamoff>(size_))
+	  - subckt->begin_;
+	subckt->ends_found_ = true;
+	subckt = nullptr;
+      }
+    }
+    else {
+      // .subckt <cell_name> [args..]
+      StringVector tokens;
+      split(line, " \t", tokens);
+      if (tokens.size() >= 2
+	  && stringEqual(tokens[0].c_str(), ".subckt")
+	  // The first definition of a cell is used.
+	  && !subckts_.hasKey(tokens[1])) {
+	subckt = &subckts_[tokens[1]];
+	subckt->begin_ = line_begin;
+	subckt->length_ = 0;
+	subckt->ends_found_ = false;
+	subckt->tokens_ = tokens;
+      }
+    }
+  }
+  return true;
+}
+
+bool
+SpiceSubcktIndex::isCurrent() const
+{
+  off_t size;
+  time_t mtime;
+  return fileStat(filename_.c_str(), size, mtime)
+    && size == size_
+    && mtime == mtime_;
+}
+
+const SubcktLocation *
+SpiceSubcktIndex::find(const char *cell_name) const
+{
+  auto subckt_iter = subckts_.find(cell_name);
+  if (subckt_iter == subckts_.end())
+    return nullptr;
+  else
+    return &subckt_iter->second;
+}
+
+static std::mutex spice_subckt_index_lock;
+static SpiceSubcktIndexPtr spice_subckt_index;
+
+// The index of the last library file is kept so writing many paths
+// reads the library once.
+// Throws FileNotReadable.
+static SpiceSubcktIndexPtr
+spiceSubcktIndex(const char *filename)
+{
+  std::lock_guard<std::mutex> lock(spice_subckt_index_lock);
+  if (spice_subckt_index == nullptr
+      || spice_subckt_index->filename() != filename
+      || !spice_subckt_index->isCurrent()) {
+    SpiceSubcktIndex *index = new SpiceSubcktIndex(filename);
+    // Paths still writing with the previous index keep it alive.
+    SpiceSubcktIndexPtr index_ptr(index);
+    if (!index->read())
+      throw FileNotReadable(filename);
+    spice_subckt_index = index_ptr;
+  }
+  return spice_subckt_index;
+}
+
+////////////////////////////////////////////////////////////////
+
+// Messages for one path of a parallel write are saved until all of
+// the paths are done so they are not interleaved.
+class WritePathSpiceReport : public Report
+{
+public:
+  WritePathSpiceReport();
+
+protected:
+  virtual size_t printConsole(const char *buffer, size_t length);
+  virtual size_t printErrorConsole(const char *buffer, size_t length);
+
+private:
+  DISALLOW_COPY_AND_ASSIGN(WritePathSpiceReport);
+};
+
+WritePathSpiceReport::WritePathSpiceReport() :
+  Report()
+{
+  redirectStringBegin();
+}
+
+size_t
+WritePathSpiceReport::printConsole(const char *,
+				   size_t length)
+{
+  return length;
+}
+
+size_t
+WritePathSpiceReport::printErrorConsole(const char *,
+					size_t length)
+{
+  return length;
+}
+
+// Exception messages that refer to the path file names are copied
+// because the names do not outlive the write.
+class WritePathSpiceError : public StaException
+{
+public:
+  explicit WritePathSpiceError(const char *what);
+  const char *what() const throw();
+
+protected:
+  string what_;
+};
+
+WritePathSpiceError::WritePathSpiceError(const char *what) :
+  what_(what)
+{
+}
+
+const char *
+WritePathSpiceError::what() const throw()
+{
+  return what_.c_str();
+}
+
+// Rereading discarded spef networks changes the parasitics so those
+// paths are written one at a time.
+static bool
+hasDiscardedSpef(const StaState *sta)
+{
+  for (auto parasitic_ap : sta->corners()->parasiticAnalysisPts()) {
+    if (!parasitic_ap->discardedSpefFiles().empty())
+      return true;
+  }
+  return false;
+}
+
+void
+writePathSpice(PathEndSeq *path_ends,
+	       const char *spice_dir,
+	       const char *lib_subckt_filename,
+	       const char *model_filename,
+	       const char *power_name,
+	       const char *gnd_name,
+	       StaState *sta)
+{
+  size_t path_count = path_ends->size();
+  std::vector<string> spice_filenames(path_count);
+  std::vector<string> subckt_filenames(path_count);
+  for (size_t i = 0; i < path_count; i++) {
+    string path_name = string(spice_dir) + "/path_" + std::to_string(i + 1);
+    spice_filenames[i] = path_name + ".sp";
+    subckt_filenames[i] = path_name + ".subckt";
+  }
+  std::vector<std::exception_ptr> exceptions(path_count);
+  Vector<WritePathSpiceReport*> reports;
+  for (size_t i = 0; i < path_count; i++)
+    reports.push_back(new WritePathSpiceReport);
+  auto write_paths = [&] (size_t begin, size_t end, int) {
+    for (size_t i = begin; i < end; i++) {
+      try {
+	WritePathSpice writer((*path_ends)[i]->path(),
+			      spice_filenames[i].c_str(),
+			      subckt_filenames[i].c_str(),
+			      lib_subckt_filename, model_filename,
+			      power_name, gnd_name, sta);
+	writer.setReport(reports[i]);
+	writer.writeSpice();
+      }
+      catch (StaException &error) {
+	exceptions[i] = std::make_exception_ptr(WritePathSpiceError(error.what()));
+      }
+      catch (...) {
+	exceptions[i] = std::current_exception();
+      }
+    }
+  };
+  if (hasDiscardedSpef(sta))
+    write_paths(0, path_count, 0);
+  else
+    forEachChunk(path_count, sta->threadPool(), write_paths);
+
+  Report *report = sta->report();
+  std::exception_ptr exception;
+  for (size_t i = 0; i < path_count; i++) {
+    const char *messages = reports[i]->redirectStringEnd();
+    if (messages[0] != '\0')
+      report->printError(messages, strlen(messages));
+    if (exception == nullptr)
+      exception = exceptions[i];
+  }
+  reports.deleteContents();
+  if (exception)
+    std::rethrow_exception(exception);
+}
+
 void
 writePathSpice(Path *path,
 	       const char *spice_filename,
@@ -292,6 +595,7 @@ WritePathSpice::WritePathSpice(Path *path,
   power_name_(power_name),
   gnd_name_(gnd_name),
   path_expanded_(sta),
+  reread_ap_(nullptr),
   net_name_(nullptr),
   default_library_(network_->defaultLibertyLibrary()),
   short_ckt_resistance_(.0001),
@@ -313,6 +617,7 @@ WritePathSpice::WritePathSpice(Path *path,
 
 WritePathSpice::~WritePathSpice()
 {
+  deleteRereadNetworks();
   stringDelete(net_name_);
   cell_spice_port_names_.deleteContents();
 }
@@ -323,6 +628,7 @@ WritePathSpice::writeSpice()
   spice_stream_.open(spice_filename_);
   if (spice_stream_.is_open()) {
     path_expanded_.expand(path_, true);
+    readDiscardedNetworks();
     // Find subckt port names as a side-effect of writeSubckts.
     writeSubckts();
     writeHeader();
@@ -1310,6 +1616,41 @@ WritePathSpice::writeStageParasitics(Stage stage)
   }
 }
 
+// Read the parasitic networks of the path stages back from spef files
+// that were read with -delete_after_reduce.
+void
+WritePathSpice::readDiscardedNetworks()
+{
+  auto dcalc_ap = path_->dcalcAnalysisPt(this);
+  auto parasitic_ap = dcalc_ap->parasiticAnalysisPt();
+  auto &spef_files = parasitic_ap->discardedSpefFiles();
+  if (!spef_files.empty()) {
+    for (auto stage = stageFirst(); stage <= stageLast(); stage++) {
+      auto drvr_pin = stageDrvrPin(stage);
+      if (parasitics_->findParasiticNetwork(drvr_pin, parasitic_ap) == nullptr) {
+	auto net = parasitics_->findParasiticNet(drvr_pin);
+	if (net)
+	  reread_nets_.insert(net);
+      }
+    }
+    if (!reread_nets_.empty()) {
+      reread_ap_ = parasitic_ap;
+      for (auto spef_file : spef_files)
+	readSpefNets(spef_file, &reread_nets_, parasitic_ap,
+		     report_, network_, parasitics_);
+    }
+  }
+}
+
+// Discard the networks again so they do not change the timing.
+void
+WritePathSpice::deleteRereadNetworks()
+{
+  for (auto net : reread_nets_)
+    parasitics_->deleteParasiticNetwork(net, reread_ap_);
+  reread_nets_.clear();
+}
+
 void
 WritePathSpice::initNodeMap(const char *net_name)
 {
@@ -1347,35 +1688,37 @@ WritePathSpice::writeSubckts()
   StringSet path_cell_names;
   findPathCellnames(path_cell_names);
 
-  ifstream lib_subckts_stream(lib_subckt_filename_);
+  SpiceSubcktIndexPtr subckt_index = spiceSubcktIndex(lib_subckt_filename_);
+  Vector<const SubcktLocation*> subckts;
+  for (auto cell_name : path_cell_names) {
+    const SubcktLocation *subckt = subckt_index->find(cell_name);
+    if (subckt) {
+      if (!subckt->ends_found_)
+	throw SubcktEndsMissing(cell_name, lib_subckt_filename_);
+      subckts.push_back(subckt);
+    }
+  }
+  // Copy the subckts in library file order.
+  sort(subckts, [] (const SubcktLocation *subckt1,
+		    const SubcktLocation *subckt2) {
+	 return subckt1->begin_ < subckt2->begin_;
+       });
+
+  ifstream lib_subckts_stream(lib_subckt_filename_, std::ios::binary);
   if (lib_subckts_stream.is_open()) {
     ofstream subckts_stream(subckt_filename_);
     if (subckts_stream.is_open()) {
-      string line;
-      while (getline(lib_subckts_stream, line)) {
-	// .subckt <cell_name> [args..]
-	StringVector tokens;
-	split(line, " \t", tokens);
-	if (tokens.size() >= 2
-	    && stringEqual(tokens[0].c_str(), ".subckt")) {
-	  auto cell_name = tokens[1].c_str();
-	  if (path_cell_names.hasKey(cell_name)) {
-	    subckts_stream << line << "\n";
-	    bool found_ends = false;
-	    while (getline(lib_subckts_stream, line)) {
-	      subckts_stream << line << "\n";
-	      if (stringBeginEqual(line.c_str(), ".ends")) {
-		subckts_stream << "\n";
-		found_ends = true;
-		break;
-	      }
-	    }
-	    if (!found_ends)
-	      throw SubcktEndsMissing(cell_name, lib_subckt_filename_);
-	    path_cell_names.erase(cell_name);
-	  }
-	  recordSpicePortNames(cell_name, tokens);
-	}
+      string text;
+      for (auto subckt : subckts) {
+	text.resize(subckt->length_);
+	lib_subckts_stream.seekg(subckt->begin_);
+	lib_subckts_stream.read(&text[0], subckt->length_);
+	if (text.empty() || text.back() != '\n')
+	  text += '\n';
+	subckts_stream << text << "\n";
+	auto cell_name = subckt->tokens_[1].c_str();
+	recordSpicePortNames(cell_name, subckt->tokens_);
+	path_cell_names.erase(cell_name);
       }
       subckts_stream.close();
       lib_subckts_stream.close();
@@ -1426,7 +1769,7 @@ WritePathSpice::findPathCellnames(// Return values.
 
 void
 WritePathSpice::recordSpicePortNames(const char *cell_name,
-				     StringVector &tokens)
+				     const StringVector &tokens)
 {
   auto cell = network_->findLibertyCell(cell_name);
   if (cell) {
@@ -17,6 +17,8 @@
 #ifndef STA_WRITE_PATH_SPICE_H
 #define STA_WRITE_PATH_SPICE_H
 
+#include "SearchClass.hh"
+
 namespace sta {
 
 // Write a spice deck for path.
@@ -35,5 +37,19 @@ writePathSpice(Path *path,
 	       const char *gnd_name,
 	       StaState *sta);
 
+// Write spice decks for the paths of path_ends to
+// spice_dir/path_<n>.sp and spice_dir/path_<n>.subckt with n from 1.
+// Paths are written in parallel unless parasitic networks have to be
+// read again from spef files read with -delete_after_reduce.
+// Throws FileNotReadable, FileNotWritable, SubcktEndsMissing
+void
+writePathSpice(PathEndSeq *path_ends,
+	       const char *spice_dir,
+	       const char *lib_subckt_filename,
+	       const char *model_filename,
+	       const char *power_name,
+	       const char *gnd_name,
+	       StaState *sta);
+
 } // namespace
 #endif
@@ -81,7 +81,7 @@ proc check_setup_cmd { cmd cmd_args } {
   set errors [check_timing_cmd $no_input_delay $no_output_delay \
 		$multiple_clock $no_clock \
 		$unconstrained_endpoints $loops \
-		$generated_clocks]
+		$generated_clocks $verbose]
   foreach error $errors {
     # First line is the error msg.
     puts [lindex $error 0]
@@ -954,6 +954,28 @@ proc get_object_args { objects clks_var libcells_var libports_var \
     upvar 1 $timing_arc_sets_var timing_arc_sets
   }
 
+  # Lists returned by get_* commands have one object type so they are
+  # appended without checking each object.
+  if { [llength $objects] > 1 } {
+    set obj [lindex $objects 0]
+    if { [is_object $obj] } {
+      set object_type [object_type $obj]
+      set type_vars {Pin pins Instance insts Net nets Port ports \
+		       Edge edges Clock clks LibertyCell libcells \
+		       LibertyPort libports Cell cells \
+		       TimingArcSet timing_arc_sets}
+      set type_index [lsearch -exact $type_vars $object_type]
+      if { $type_index >= 0 } {
+	set var [lindex $type_vars [expr $type_index + 1]]
+	if { [set ${var}_var] != {} \
+	       && [is_object_list $objects $object_type] } {
+	  set $var [concat [set $var] $objects]
+	  return
+	}
+      }
+    }
+  }
+
   # Copy backslashes that will be removed by foreach.
   set objects [string map {\\ \\\\} $objects]
   foreach obj $objects {
@@ -1991,16 +2013,9 @@ proc write_path_spice { args } {
   if { $path_ends == {} } {
     sta_error "No paths found for -path_args $path_args.\n"
   } else {
-    set path_index 1
-    foreach path_end $path_ends {
-      set path [$path_end path]
-      set path_name "path_$path_index"
-      set spice_file [file join $spice_dir "$path_name.sp"]
-      set subckt_file [file join $spice_dir "$path_name.subckt"]
-      write_path_spice_cmd $path $spice_file $subckt_file \
-	$lib_subckt_file $model_file $power $ground
-      incr path_index
-    }
+    # Writes spice_dir/path_<n>.sp and path_<n>.subckt for each path.
+    write_path_spices_cmd $path_ends $spice_dir $lib_subckt_file \
+      $model_file $power $ground
   }
 }
 
@@ -231,6 +231,23 @@ proc report_pin_constant { pin } {
 
 ################################################################
 
+define_cmd_args "report_case_analysis_modes" {pins}
+
+# Report the propagated value of each pin in each mode saved by
+# add_case_analysis_mode, one character per mode.
+proc report_case_analysis_modes { pins } {
+  set mode_count [case_analysis_mode_count]
+  foreach pin [get_port_pins_error "pins" $pins] {
+    set values ""
+    for {set mode 0} {$mode < $mode_count} {incr mode} {
+      append values [pin_case_analysis_mode_value $pin $mode]
+    }
+    puts "[get_full_name $pin] $values"
+  }
+}
+
+################################################################
+
 proc report_disabled_edges {} {
   foreach edge [disabled_edges_sorted] {
     if { [$edge role] == "wire" } {
@@ -19,18 +19,73 @@
 namespace eval sta {
 
 define_cmd_args "read_liberty" \
-  {[-corner corner_name] [-min] [-max] [-no_latch_infer] filename}
+  {[-corner corner_name] [-min] [-max] [-no_latch_infer]\
+     [-no_power] [-no_ccs] filename|-files filenames}
 
 proc_redirect read_liberty {
-  parse_key_args "read_liberty" args keys {-corner} \
-    flags {-min -max -no_latch_infer}
-  check_argc_eq1 "read_liberty" $args
+  parse_key_args "read_liberty" args keys {-corner -files} \
+    flags {-min -max -no_latch_infer -no_power -no_ccs}
+
+  set corner [parse_corner keys]
+  set min_max [parse_min_max_all_flags flags]
+  set infer_latches [expr ![info exists flags(-no_latch_infer)]]
+  # Power and CCS groups are skipped by the parser without reading them.
+  set skip_power [info exists flags(-no_power)]
+  set skip_ccs [info exists flags(-no_ccs)]
+  if [info exists keys(-files)] {
+    check_argc_eq0 "read_liberty" $args
+    # Liberty files and liberty caches are read in parallel.
+    set filenames {}
+    foreach filename $keys(-files) {
+      lappend filenames [file nativename $filename]
+    }
+    read_liberty_files_cmd $filenames $corner $min_max $infer_latches \
+      $skip_power $skip_ccs
+  } else {
+    check_argc_eq1 "read_liberty" $args
+    set filename [file nativename $args]
+    read_liberty_cmd $filename $corner $min_max $infer_latches \
+      $skip_power $skip_ccs
+  }
+}
+
+define_cmd_args "read_liberty_cache" \
+  {[-corner corner_name] [-min] [-max] [-no_latch_infer] [-lazy] filename}
+
+proc_redirect read_liberty_cache {
+  parse_key_args "read_liberty_cache" args keys {-corner} \
+    flags {-min -max -no_latch_infer -lazy}
+  check_argc_eq1 "read_liberty_cache" $args
 
   set filename [file nativename $args]
   set corner [parse_corner keys]
   set min_max [parse_min_max_all_flags flags]
   set infer_latches [expr ![info exists flags(-no_latch_infer)]]
-  read_liberty_cmd $filename $corner $min_max $infer_latches
+  set lazy [info exists flags(-lazy)]
+  read_liberty_cache_cmd $filename $corner $min_max $infer_latches $lazy
+}
+
+define_cmd_args "write_liberty_cache" {liberty_filename cache_filename}
+
+proc write_liberty_cache { args } {
+  check_argc_eq2 "write_liberty_cache" $args
+  set filename [file nativename [lindex $args 0]]
+  set cache_filename [file nativename [lindex $args 1]]
+  write_liberty_cache_cmd $filename $cache_filename
+}
+
+define_cmd_args "read_liberty_table_values" {filename}
+
+proc read_liberty_table_values { args } {
+  check_argc_eq1 "read_liberty_table_values" $args
+  read_liberty_table_values_cmd [file nativename $args]
+}
+
+define_cmd_args "write_liberty_table_values" {filename}
+
+proc write_liberty_table_values { args } {
+  check_argc_eq1 "write_liberty_table_values" $args
+  write_liberty_table_values_cmd [file nativename $args]
 }
 
 # sta namespace end
@@ -34,5 +34,19 @@ proc link_design { {top_cell_name ""} } {
   link_design_cmd $top_cell_name
 }
 
+define_cmd_args "write_network_db" {filename}
+
+proc write_network_db { args } {
+  check_argc_eq1 "write_network_db" $args
+  write_network_db_cmd [file nativename $args]
+}
+
+define_cmd_args "read_network_db" {filename}
+
+proc read_network_db { args } {
+  check_argc_eq1 "read_network_db" $args
+  return [read_network_db_cmd [file nativename $args]]
+}
+
 # sta namespace end
 }
@@ -105,4 +105,56 @@ insert_buffer_cmd(const char *buffer_name,
   delete load_pins;
 } 
 
+void
+begin_eco_cmd()
+{
+  Sta::sta()->beginEco();
+}
+
+void
+commit_eco_cmd()
+{
+  Sta::sta()->commitEco();
+}
+
+bool
+in_eco()
+{
+  return Sta::sta()->inEco();
+}
+
+float
+what_if_replace_cell_cmd(Instance *inst,
+			 LibertyCell *to_cell,
+			 const MinMax *min_max)
+{
+  return delayAsFloat(Sta::sta()->whatIfReplaceCell(inst, to_cell, min_max));
+}
+
+// Deltas for each cell are returned as wns_delta tns_delta inst_slack_delta.
+TmpFloatSeq *
+what_if_replace_cells_cmd(Instance *inst,
+			  LibertyCellSeq *cells,
+			  const MinMax *min_max)
+{
+  SlackSeq wns_deltas, tns_deltas, inst_slack_deltas;
+  Sta::sta()->whatIfReplaceCells(inst, cells, min_max, wns_deltas,
+				 tns_deltas, inst_slack_deltas);
+  FloatSeq *deltas = new FloatSeq;
+  for (size_t i = 0; i < cells->size(); i++) {
+    deltas->push_back(delayAsFloat(wns_deltas[i]));
+    deltas->push_back(delayAsFloat(tns_deltas[i]));
+    deltas->push_back(delayAsFloat(inst_slack_deltas[i]));
+  }
+  delete cells;
+  return deltas;
+}
+
+int
+reduce_to_interface_logic_cmd()
+{
+  cmdLinkedNetwork();
+  return Sta::sta()->reduceToInterfaceLogic();
+}
+
 %} // inline
@@ -236,6 +236,63 @@ proc replace_cell { instance lib_cell } {
   }
 }
 
+# Return the worst slack change from replacing the instance cell
+# without changing the network or committed timing.
+proc what_if_replace_cell { instance lib_cell min_max } {
+  set cell [get_lib_cell_warn "lib_cell" $lib_cell]
+  if { $cell == "NULL" } {
+    return 0.0
+  }
+  set inst [get_instance_error "instance" $instance]
+  set inst_cell [$inst liberty_cell]
+  if { $inst_cell == "NULL" \
+	 || ![equiv_cell_ports $inst_cell $cell] } {
+    sta_error "$lib_cell is not equivalent to the instance cell."
+  }
+  if { $min_max != "min" && $min_max != "max" } {
+    sta_error "min_max must be min or max."
+  }
+  return [time_sta_ui [what_if_replace_cell_cmd $inst $cell $min_max]]
+}
+
+# Return a list of {wns_delta tns_delta inst_slack_delta} for replacing
+# the instance cell with each lib cell, in lib_cells order.
+# Every lib cell must exist and be equivalent to the instance cell.
+proc what_if_replace_cells { instance lib_cells min_max } {
+  set inst [get_instance_error "instance" $instance]
+  set inst_cell [$inst liberty_cell]
+  set cells {}
+  foreach lib_cell $lib_cells {
+    set cell [get_lib_cell_warn "lib_cell" $lib_cell]
+    if { $cell == "NULL" } {
+      sta_error "lib cell $lib_cell not found."
+    }
+    if { $inst_cell == "NULL" \
+	   || ![equiv_cell_ports $inst_cell $cell] } {
+      sta_error "$lib_cell is not equivalent to the instance cell."
+    }
+    lappend cells $cell
+  }
+  if { $min_max != "min" && $min_max != "max" } {
+    sta_error "min_max must be min or max."
+  }
+  set result {}
+  foreach {wns tns slack} [what_if_replace_cells_cmd $inst $cells $min_max] {
+    lappend result [list [time_sta_ui $wns] [time_sta_ui $tns] \
+		      [time_sta_ui $slack]]
+  }
+  return $result
+}
+
+################################################################
+
+# Delete the register to register logic of the design, keeping the
+# input and output interface logic and its clock trees.
+# Returns the number of instances deleted.
+proc reduce_to_interface_logic {} {
+  return [reduce_to_interface_logic_cmd]
+}
+
 ################################################################
 
 proc insert_buffer { buffer_name buffer_cell net load_pins buffer_out_net_name } {
@@ -263,5 +320,20 @@ proc insert_buffer { buffer_name buffer_cell net load_pins buffer_out_net_name }
   }
 }
 
+################################################################
+
+# Edits between begin_eco and commit_eco invalidate timing once
+# when the eco is committed.
+proc begin_eco {} {
+  begin_eco_cmd
+}
+
+proc commit_eco {} {
+  if { ![in_eco] } {
+    sta_error "commit_eco without begin_eco."
+  }
+  commit_eco_cmd
+}
+
 # sta namespace end.
 }
@@ -244,5 +244,42 @@ proc set_power_activity { args } {
   }
 }
 
+################################################################
+
+define_cmd_args "read_vcd" {[-scope scope] filename}
+
+proc read_vcd { args } {
+  parse_key_args "read_vcd" args keys {-scope} flags {}
+  check_argc_eq1 "read_vcd" $args
+  set scope ""
+  if { [info exists keys(-scope)] } {
+    set scope $keys(-scope)
+  }
+  return [read_vcd_activities [file nativename [lindex $args 0]] $scope]
+}
+
+define_cmd_args "read_saif" {[-scope scope] filename}
+
+proc read_saif { args } {
+  parse_key_args "read_saif" args keys {-scope} flags {}
+  check_argc_eq1 "read_saif" $args
+  set scope ""
+  if { [info exists keys(-scope)] } {
+    set scope $keys(-scope)
+  }
+  return [read_saif_activities [file nativename [lindex $args 0]] $scope]
+}
+
+################################################################
+
+define_cmd_args "report_power_cache" {}
+
+# Report hits and misses of the internal power cache enabled by
+# the sta_power_cache variable.
+proc report_power_cache { args } {
+  check_argc_eq0 "report_power_cache" $args
+  report_power_cache_cmd
+}
+
 # sta namespace end.
 }
@@ -34,12 +34,19 @@ proc_redirect read_sdc {
   check_argc_eq1 "read_sdc" $args
   set echo [info exists flags(-echo)]
   set filename [lindex $args 0]
-  source_ $filename $echo 0
+  set merge_deferred [exception_merge_deferred]
+  set_exception_merge_deferred $::sta_read_sdc_defer_merge
+  source_ $filename $echo 0 $::sta_read_sdc_fast
+  set_exception_merge_deferred $merge_deferred
 }
 
 ################################################################
 
 set ::sta_continue_on_error 1
+# read_sdc evaluates common constraint commands without the Tcl procs.
+set ::sta_read_sdc_fast 1
+# read_sdc merges timing exceptions in one pass before the next search.
+set ::sta_read_sdc_defer_merge 1
 
 define_cmd_args "source" \
   {[-echo] [-verbose] filename [> filename] [>> filename]}
@@ -56,7 +63,7 @@ proc_redirect source {
   source_ $filename $echo $verbose
 }
 
-proc source_ { filename echo verbose } {
+proc source_ { filename echo verbose {sdc_fast 0} } {
   global sta_continue_on_error
   variable sdc_file
   variable sdc_line
@@ -82,6 +89,11 @@ proc source_ { filename echo verbose } {
       append cmd $line "\n"
       if { [string index $line end] != "\\" \
 	     && [info complete $cmd] } {
+	if { $sdc_fast && [sdc_fast_cmd $cmd $sdc_file $sdc_line] } {
+	  set cmd ""
+	  incr sdc_line
+	  continue
+	}
 	set error {}
 	switch [catch {uplevel \#0 $cmd} result] {
 	  0 { if { $verbose && $result != "" } { puts $result } }
@@ -123,11 +135,11 @@ proc source_ { filename echo verbose } {
 ################################################################
 
 define_cmd_args "write_sdc" \
-  {[-no_timestamp] [-digits digits] filename}
+  {[-gzip] [-no_timestamp] [-digits digits] filename}
 
 proc write_sdc { args } {
   parse_key_args "write_sdc" args keys {-digits -significant_digits} \
-    flags {-compatible -no_timestamp}
+    flags {-compatible -gzip -no_timestamp}
   check_argc_eq1 "write_sdc" $args
 
   set digits 4
@@ -142,7 +154,8 @@ proc write_sdc { args } {
   set filename [file nativename [lindex $args 0]]
   set no_timestamp [info exists flags(-no_timestamp)]
   set compatible [info exists flags(-native)]
-  write_sdc_cmd $filename $compatible $no_timestamp $digits
+  set gzip [info exists flags(-gzip)]
+  write_sdc_cmd $filename $compatible $gzip $no_timestamp $digits
 }
 
 ################################################################
@@ -435,17 +448,7 @@ proc get_cells { args } {
       sta_warn "patterns argument not supported with -of_objects."
     }
     parse_pin_net_args $keys(-of_objects) pins nets
-    foreach pin $pins {
-      lappend insts [$pin instance]
-    }
-    foreach net $nets {
-      set pin_iter [$net pin_iterator]
-      while { [$pin_iter has_next] } {
-	set pin [$pin_iter next]
-	lappend insts [$pin instance]
-      }
-      $pin_iter finish
-    }
+    set insts [pin_net_instances $pins $nets]
   } else {
     if { $args == {} } {
       set insts [network_leaf_instances]
@@ -752,17 +755,7 @@ proc get_nets { args } {
       sta_warn "patterns argument not supported with -of_objects."
     }
     parse_inst_pin_arg $keys(-of_objects) insts pins
-    foreach inst $insts {
-      set pin_iter [$inst pin_iterator]
-      while { [$pin_iter has_next] } {
-	set pin [$pin_iter next]
-	lappend nets [$pin net]
-      }
-      $pin_iter finish
-    }
-    foreach pin $pins {
-      lappend nets [$pin net]
-    }
+    set nets [instance_pin_nets $insts $pins]
   } else {
     check_argc_eq1 "get_nets" $args
     foreach pattern $patterns {
@@ -805,22 +798,7 @@ proc get_pins { args } {
       sta_warn "patterns argument not supported with -of_objects."
     }
     parse_inst_net_arg $keys(-of_objects) insts nets
-    foreach inst $insts {
-      set pin_iter [$inst pin_iterator]
-      while { [$pin_iter has_next] } {
-	set pin [$pin_iter next]
-	lappend pins $pin
-      }
-      $pin_iter finish
-    }
-    foreach net $nets {
-      set pin_iter [$net pin_iterator]
-      while { [$pin_iter has_next] } {
-	set pin [$pin_iter next]
-	lappend pins $pin
-      }
-      $pin_iter finish
-    }
+    set pins [instance_net_pins $insts $nets]
   } else {
     check_argc_eq1 "get_pins" $args
     set patterns [lindex $args 0]
@@ -2188,6 +2166,39 @@ proc set_case_analysis { value pins } {
 
 ################################################################
 
+define_cmd_args "add_case_analysis_mode" {}
+
+# Save the current set_case_analysis values as a mode for
+# report_case_analysis_modes.  Returns the mode index.
+proc add_case_analysis_mode { args } {
+  check_argc_eq0 "add_case_analysis_mode" $args
+  return [add_case_analysis_mode_cmd]
+}
+
+define_cmd_args "clear_case_analysis_modes" {}
+
+proc clear_case_analysis_modes { args } {
+  check_argc_eq0 "clear_case_analysis_modes" $args
+  clear_case_analysis_modes_cmd
+}
+
+define_cmd_args "set_case_analysis_mode" {mode}
+
+# Replace the set_case_analysis values with those saved by
+# add_case_analysis_mode.  Only the timing around the constants that
+# differ between the modes is updated.
+proc set_case_analysis_mode { args } {
+  check_argc_eq1 "set_case_analysis_mode" $args
+  set mode [lindex $args 0]
+  check_integer "mode" $mode
+  if { $mode < 0 || $mode >= [case_analysis_mode_count] } {
+    sta_error "case analysis mode $mode not found."
+  }
+  set_case_analysis_mode_cmd $mode
+}
+
+################################################################
+
 define_cmd_args "set_drive" {[-rise] [-fall] [-min] [-max] \
 			       resistance ports}
 
@@ -221,13 +221,13 @@ proc parse_report_path_options { cmd args_var default_format
     unset path_options
   }
   parse_key_args $cmd args path_options {-format -digits -fields} \
-    path_options {-no_line_splits} $unknown_key_is_error
+    path_options {-no_line_splits -name_ids} $unknown_key_is_error
 
   set format $default_format
   if [info exists path_options(-format)] {
     set format $path_options(-format)
     set formats {full full_clock full_clock_expanded short \
-		   end slack_only summary}
+		   end slack_only summary json}
     if { [lsearch $formats $format] == -1 } {
       sta_error "-format $format not recognized."
     }
@@ -265,6 +265,7 @@ proc parse_report_path_options { cmd args_var default_format
     $report_cap $report_slew
 
   set_report_path_no_split [info exists path_options(-no_line_splits)]
+  set_report_path_name_ids [info exists path_options(-name_ids)]
 }
 
 ################################################################
@@ -295,6 +296,23 @@ proc report_tag_arrivals { pin } {
 
 ################################################################
 
+define_hidden_cmd_args "report_tag_growth" {[-max_vertices count]}
+
+# Vertices where the arrival tag count grows the most over their fanin
+# with the factors that make the extra tags distinct.
+proc_redirect report_tag_growth {
+  parse_key_args "report_tag_growth" args keys {-max_vertices} flags {}
+  check_argc_eq0 "report_tag_growth" $args
+  set max_vertices 20
+  if { [info exists keys(-max_vertices)] } {
+    set max_vertices $keys(-max_vertices)
+    check_positive_integer "-max_vertices" $max_vertices
+  }
+  report_tag_growth_cmd $max_vertices
+}
+
+################################################################
+
 define_hidden_cmd_args "total_negative_slack" \
   {[-corner corner] [-min]|[-max]}
 
@@ -353,9 +371,10 @@ proc parse_path_group_arg { group_names } {
   return $names
 }
 
-proc report_slew_limits { corner min_max all_violators verbose nosplit } {
+proc report_slew_limits { corner min_max all_violators max_count \
+			   verbose nosplit } {
   if { $all_violators } {
-    set violators [pin_slew_limit_violations $corner $min_max]
+    set violators [pin_slew_limit_violations $corner $min_max $max_count]
     if { $violators != {} } {
       puts "${min_max}_transition"
       puts ""
@@ -95,11 +95,76 @@ proc delete_generated_clock { args } {
 
 ################################################################
 
-define_sta_cmd_args "find_timing" {[-full_update]}
+define_sta_cmd_args "find_timing" {[-full_update] [-requireds]}
 
+# -requireds also finds all required times so later arrival, required
+# and slack queries do not update timing.
 proc find_timing { args } {
-  parse_key_args "find_timing" args keys {} flags {-full_update}
-  find_timing_cmd [info exists flags(-full_update)]
+  parse_key_args "find_timing" args keys {} flags {-full_update -requireds}
+  find_timing_cmd [info exists flags(-full_update)] \
+    [info exists flags(-requireds)]
+}
+
+################################################################
+
+define_sta_cmd_args "set_timing_scope" {[-pins pins] [-instances insts]}
+
+proc set_timing_scope { args } {
+  parse_key_args "set_timing_scope" args keys {-pins -instances} flags {}
+  check_argc_eq0 "set_timing_scope" $args
+
+  set pins {}
+  if [info exists keys(-pins)] {
+    set pins [get_port_pins_error "pins" $keys(-pins)]
+  }
+  set insts {}
+  if [info exists keys(-instances)] {
+    set insts [get_instances_error "-instances" $keys(-instances)]
+  }
+  if { $pins == {} && $insts == {} } {
+    sta_error "set_timing_scope requires -pins or -instances."
+  }
+  set_timing_scope_cmd $pins $insts
+}
+
+define_sta_cmd_args "unset_timing_scope" {}
+
+proc unset_timing_scope { args } {
+  check_argc_eq0 "unset_timing_scope" $args
+  unset_timing_scope_cmd
+}
+
+################################################################
+
+define_sta_cmd_args "create_mode" {mode_name}
+
+proc create_mode { args } {
+  check_argc_eq1 "create_mode" $args
+  set name [lindex $args 0]
+  if { $name == "default" || [mode_exists $name] } {
+    sta_error "mode $name already exists."
+  }
+  create_mode_cmd $name
+}
+
+define_sta_cmd_args "set_mode" {mode_name}
+
+proc set_mode { args } {
+  check_argc_eq1 "set_mode" $args
+  set name [lindex $args 0]
+  if { $name != "default" && ![mode_exists $name] } {
+    sta_error "mode $name not found."
+  }
+  set_mode_cmd $name
+}
+
+define_sta_cmd_args "update_mode_timing" {[-full_update] [-requireds]}
+
+proc update_mode_timing { args } {
+  parse_key_args "update_mode_timing" args keys {} \
+    flags {-full_update -requireds}
+  update_mode_timing_cmd [info exists flags(-full_update)] \
+    [info exists flags(-requireds)]
 }
 
 ################################################################
@@ -291,10 +356,11 @@ define_sta_cmd_args "report_checks" \
      [-slack_min slack_min]\
      [-sort_by_slack]\
      [-path_group group_name]\
-     [-format full|full_clock|full_clock_expanded|short|end|summary]\
+     [-format full|full_clock|full_clock_expanded|short|end|summary|json]\
      [-fields [capacitance|transition_time|input_pin|net]]\
      [-digits digits]\
      [-no_line_splits]\
+     [-name_ids]\
      [> filename] [>> filename]}
 
 proc_redirect report_checks {
@@ -311,8 +377,45 @@ proc_redirect report_checks {
 
 ################################################################
 
+define_sta_cmd_args "report_path_based_slacks" \
+  {[-from from_list|-rise_from from_list|-fall_from from_list]\
+     [-through through_list|-rise_through through_list|-fall_through through_list]\
+     [-to to_list|-rise_to to_list|-fall_to to_list]\
+     [-unconstrained]\
+     [-path_delay min|min_rise|min_fall|max|max_rise|max_fall|min_max]\
+     [-corner corner_name]\
+     [-group_count path_count] \
+     [-endpoint_count path_count]\
+     [-unique_paths_to_endpoint]\
+     [-slack_max slack_max]\
+     [-slack_min slack_min]\
+     [-sort_by_slack]\
+     [-path_group group_name]\
+     [-digits digits]\
+     [> filename] [>> filename]}
+
+proc_redirect report_path_based_slacks {
+  global sta_report_default_digits
+
+  parse_key_args "report_path_based_slacks" args keys {-digits} flags {} 0
+  if [info exists keys(-digits)] {
+    set digits $keys(-digits)
+    check_positive_integer "-digits" $digits
+  } else {
+    set digits $sta_report_default_digits
+  }
+  set path_ends [find_timing_paths_cmd "report_path_based_slacks" args]
+  if { $path_ends == {} } {
+    puts "No paths found."
+  } else {
+    report_path_based_slacks_cmd $path_ends $digits
+  }
+}
+
+################################################################
+
 define_sta_cmd_args "report_check_types" \
-  {[-all_violators] [-verbose]\
+  {[-all_violators] [-max_count count] [-verbose]\
      [-corner corner_name]\
      [-format slack_only|end]\
      [-max_delay] [-min_delay]\
@@ -326,10 +429,16 @@ define_sta_cmd_args "report_check_types" \
 proc_redirect report_check_types {
   variable path_options
 
-  parse_key_args "report_check_types" args keys {-corner}\
+  parse_key_args "report_check_types" args keys {-corner -max_count}\
     flags {-all_violators -verbose -no_line_splits} 0
 
   set all_violators [info exists flags(-all_violators)]
+  # Limit on transition violators reported (0 for all).
+  set max_count 0
+  if { [info exists keys(-max_count)] } {
+    set max_count $keys(-max_count)
+    check_positive_integer "-max_count" $max_count
+  }
   set verbose [info exists flags(-verbose)]
   set nosplit [info exists flags(-no_line_splits)]
 
@@ -437,14 +546,16 @@ proc_redirect report_check_types {
   }
 
   if { $max_transition } {
-    report_slew_limits $corner "max" $all_violators $verbose $nosplit
+    report_slew_limits $corner "max" $all_violators $max_count \
+      $verbose $nosplit
   }
   if { $min_transition } {
-    report_slew_limits $corner "min" $all_violators $verbose $nosplit
+    report_slew_limits $corner "min" $all_violators $max_count \
+      $verbose $nosplit
   }
   if { $min_pulse_width } {
     if { $all_violators } {
-      set checks [min_pulse_width_violations $corner]
+      set checks [min_pulse_width_violations $corner $max_count]
       report_mpw_checks $checks $verbose
     } else {
       set check [min_pulse_width_check_slack $corner]
@@ -455,7 +566,7 @@ proc_redirect report_check_types {
   }
   if { $min_period } {
     if { $all_violators } {
-      set checks [min_period_violations]
+      set checks [min_period_violations $max_count]
       report_min_period_checks $checks $verbose
     } else {
       set check [min_period_check_slack]
@@ -466,7 +577,7 @@ proc_redirect report_check_types {
   }
   if { $max_skew } {
     if { $all_violators } {
-      set checks [max_skew_violations]
+      set checks [max_skew_violations $max_count]
       report_max_skew_checks $checks $verbose
     } else {
       set check [max_skew_check_slack]
@@ -515,6 +626,74 @@ proc_redirect report_wns {
 
 ################################################################
 
+define_sta_cmd_args "report_pin_slacks" {[-min] [-max] [-digits digits]}
+
+proc_redirect report_pin_slacks {
+  global sta_report_default_digits
+
+  parse_key_args "report_pin_slacks" args keys {-digits} flags {-min -max}
+  if [info exists keys(-digits)] {
+    set digits $keys(-digits)
+    check_positive_integer "-digits" $digits
+  } else {
+    set digits $sta_report_default_digits
+  }
+  set min_max [parse_min_max_flags flags]
+  report_pin_slacks_cmd $min_max $digits
+}
+
+################################################################
+
+define_sta_cmd_args "report_slack_histogram" \
+  {[-min] [-max] [-bins bin_count] [-digits digits]}
+
+proc_redirect report_slack_histogram {
+  global sta_report_default_digits
+
+  parse_key_args "report_slack_histogram" args keys {-bins -digits} \
+    flags {-min -max}
+  set bin_count 10
+  if [info exists keys(-bins)] {
+    set bin_count $keys(-bins)
+    check_positive_integer "-bins" $bin_count
+  }
+  if [info exists keys(-digits)] {
+    set digits $keys(-digits)
+    check_positive_integer "-digits" $digits
+  } else {
+    set digits $sta_report_default_digits
+  }
+  set min_max [parse_min_max_flags flags]
+  report_slack_histogram_cmd $min_max $bin_count $digits
+}
+
+################################################################
+
+define_sta_cmd_args "report_endpoint_summary" \
+  {[-min] [-max] [-top count] [-digits digits]}
+
+proc_redirect report_endpoint_summary {
+  global sta_report_default_digits
+
+  parse_key_args "report_endpoint_summary" args keys {-top -digits} \
+    flags {-min -max}
+  set top_n 10
+  if [info exists keys(-top)] {
+    set top_n $keys(-top)
+    check_cardinal "-top" $top_n
+  }
+  if [info exists keys(-digits)] {
+    set digits $keys(-digits)
+    check_positive_integer "-digits" $digits
+  } else {
+    set digits $sta_report_default_digits
+  }
+  set min_max [parse_min_max_flags flags]
+  report_endpoint_summary_cmd $min_max $top_n $digits
+}
+
+################################################################
+
 define_sta_cmd_args "report_dcalc" \
   {[-from from_pin] [-to to_pin] [-corner corner_name] [-min] [-max] [-digits digits]}
 
@@ -528,6 +707,174 @@ define_sta_cmd_args "report_disabled_edges" {}
 
 ################################################################
 
+define_sta_cmd_args "write_timing_checkpoint" {filename}
+
+proc write_timing_checkpoint { args } {
+  check_argc_eq1 "write_timing_checkpoint" $args
+  write_timing_checkpoint_cmd [file nativename [lindex $args 0]]
+}
+
+################################################################
+
+define_sta_cmd_args "read_timing_checkpoint" {filename}
+
+# Read the design, libraries, parasitics and constraints in the same
+# order as the session that wrote the checkpoint before reading it.
+proc read_timing_checkpoint { args } {
+  check_argc_eq1 "read_timing_checkpoint" $args
+  return [read_timing_checkpoint_cmd [file nativename [lindex $args 0]]]
+}
+
+################################################################
+
+define_sta_cmd_args "write_delay_annotations" {filename}
+
+proc write_delay_annotations { args } {
+  check_argc_eq1 "write_delay_annotations" $args
+  write_delay_annotations_cmd [file nativename [lindex $args 0]]
+}
+
+################################################################
+
+define_sta_cmd_args "read_delay_annotations" {filename}
+
+# Annotate slews, arc delays and timing check values written by
+# write_delay_annotations so delay calculation is skipped for them.
+proc read_delay_annotations { args } {
+  check_argc_eq1 "read_delay_annotations" $args
+  return [read_delay_annotations_cmd [file nativename [lindex $args 0]]]
+}
+
+################################################################
+
+define_sta_cmd_args "write_timing_columns" {dirname}
+
+# Write graph slews, arc delays and slacks as binary column files
+# described by dirname/columns.json for loading with numpy.memmap.
+proc write_timing_columns { args } {
+  check_argc_eq1 "write_timing_columns" $args
+  set dirname [file nativename [lindex $args 0]]
+  file mkdir $dirname
+  write_timing_columns_cmd $dirname
+}
+
+################################################################
+
+define_sta_cmd_args "write_boundary_timing" {instance filename}
+
+# Write the boundary timing of a hierarchical instance to time it
+# in a separate session with read_boundary_timing.
+proc write_boundary_timing { args } {
+  check_argc_eq2 "write_boundary_timing" $args
+  set inst [get_instance_error "instance" [lindex $args 0]]
+  write_boundary_timing_cmd $inst [file nativename [lindex $args 1]]
+}
+
+################################################################
+
+define_sta_cmd_args "read_boundary_timing" {filename}
+
+proc read_boundary_timing { args } {
+  check_argc_eq1 "read_boundary_timing" $args
+  return [read_boundary_timing_cmd [file nativename [lindex $args 0]]]
+}
+
+################################################################
+
+define_sta_cmd_args "write_timing_model" {[-corner corner_name]\
+					    cell_name filename}
+
+# Write a liberty cell with the interface timing of the design to
+# use in place of the block in hierarchical runs.
+proc write_timing_model { args } {
+  parse_key_args "write_timing_model" args keys {-corner} flags {}
+  check_argc_eq2 "write_timing_model" $args
+  set corner [parse_corner keys]
+  set cell_name [lindex $args 0]
+  write_timing_model_cmd $cell_name [file nativename [lindex $args 1]] $corner
+}
+
+################################################################
+
+define_sta_cmd_args "report_memory" {[-json] [> filename] [>> filename]}
+
+proc_redirect report_memory {
+  parse_key_args "report_memory" args keys {} flags {-json}
+  check_argc_eq0 "report_memory" $args
+  report_memory_cmd [info exists flags(-json)]
+}
+
+################################################################
+
+define_sta_cmd_args "compact_tags" {}
+
+proc compact_tags { args } {
+  parse_key_args "compact_tags" args keys {} flags {}
+  check_argc_eq0 "compact_tags" $args
+  compact_tags_cmd
+}
+
+################################################################
+
+define_sta_cmd_args "report_phase_stats" {[-json] [-clear]\
+					     [> filename] [>> filename]}
+
+proc_redirect report_phase_stats {
+  parse_key_args "report_phase_stats" args keys {} flags {-json -clear}
+  check_argc_eq0 "report_phase_stats" $args
+  report_phase_stats_cmd [info exists flags(-json)]
+  if [info exists flags(-clear)] {
+    clear_phase_stats
+  }
+}
+
+################################################################
+
+define_sta_cmd_args "report_thread_profile" {[-max_levels count] [-json]\
+						[-clear]\
+						[> filename] [>> filename]}
+
+# Thread utilization, barrier waits and the slowest levels of parallel
+# delay calculation and search recorded while sta_thread_profile is 1.
+proc_redirect report_thread_profile {
+  parse_key_args "report_thread_profile" args keys {-max_levels} \
+    flags {-json -clear}
+  check_argc_eq0 "report_thread_profile" $args
+  set max_levels 10
+  if { [info exists keys(-max_levels)] } {
+    set max_levels $keys(-max_levels)
+    check_positive_integer "-max_levels" $max_levels
+  }
+  report_thread_profile_cmd $max_levels [info exists flags(-json)]
+  if [info exists flags(-clear)] {
+    clear_thread_profile
+  }
+}
+
+################################################################
+
+define_sta_cmd_args "report_hot_vertices" {[-count count] [-clear]\
+					      [> filename] [>> filename]}
+
+# Vertices with the most delay calculation and search time recorded
+# while sta_hot_vertex_profile is 1, with their fanout, arrival count
+# and parasitic network node count.
+proc_redirect report_hot_vertices {
+  parse_key_args "report_hot_vertices" args keys {-count} flags {-clear}
+  check_argc_eq0 "report_hot_vertices" $args
+  set count 20
+  if { [info exists keys(-count)] } {
+    set count $keys(-count)
+    check_positive_integer "-count" $count
+  }
+  report_hot_vertices_cmd $count
+  if [info exists flags(-clear)] {
+    clear_hot_vertices
+  }
+}
+
+################################################################
+
 define_sta_cmd_args "report_pulse_width_checks" \
   {[-verbose] [-corner corner_name] [-digits digits] [-no_line_splits] [pins]\
      [> filename] [>> filename]}
@@ -707,6 +1054,78 @@ proc unset_timing_derate { args } {
   reset_timing_derate_cmd
 }
 
+define_sta_cmd_args "set_aocv_derate" \
+  {-early|-late [-rise] [-fall] [-clock] [-data] -depths depths \
+     -derates derates [lib_cells]}
+
+proc set_aocv_derate { args } {
+  parse_key_args "set_aocv_derate" args keys {-depths -derates} \
+    flags {-rise -fall -early -late -clock -data}
+  check_argc_eq0or1 "set_aocv_derate" $args
+
+  if { ![info exists keys(-depths)] || ![info exists keys(-derates)] } {
+    sta_error "-depths and -derates are required."
+  }
+  set depths $keys(-depths)
+  set derates $keys(-derates)
+  if { [llength $depths] == 0 \
+	 || [llength $depths] != [llength $derates] } {
+    sta_error "-depths and -derates must be the same length."
+  }
+  set prev_depth {}
+  foreach depth $depths {
+    check_positive_float "-depths" $depth
+    if { $prev_depth != {} && $depth <= $prev_depth } {
+      sta_error "-depths must be increasing."
+    }
+    set prev_depth $depth
+  }
+  foreach derate $derates {
+    check_positive_float "-derates" $derate
+  }
+
+  set tr [parse_rise_fall_flags flags]
+  set early_late [parse_early_late_flags flags]
+
+  set path_types {}
+  if { ![info exists flags(-clock)] \
+	 && ![info exists flags(-data)] } {
+    # Derate clk and data if neither -clock or -data.
+    lappend path_types "clk"
+    lappend path_types "data"
+  }
+  if { [info exists flags(-clock)] } {
+    lappend path_types "clk"
+  }
+  if { [info exists flags(-data)] } {
+    lappend path_types "data"
+  }
+
+  if { [llength $args] == 1 } {
+    set libcells {}
+    get_object_args [lindex $args 0] {} libcells {} {} {} {} {} {} {} {}
+    foreach libcell $libcells {
+      foreach path_type $path_types {
+	set_aocv_derate_cell_cmd $libcell $path_type $tr $early_late \
+	  $depths $derates
+      }
+    }
+  } else {
+    foreach path_type $path_types {
+      set_aocv_derate_cmd $path_type $tr $early_late $depths $derates
+    }
+  }
+}
+
+################################################################
+
+define_sta_cmd_args "unset_aocv_derate" {}
+
+proc unset_aocv_derate { args } {
+  check_argc_eq0 "unset_aocv_derate" $args
+  unset_aocv_derate_cmd
+}
+
 ################################################################
 #
 # Network editing commands
@@ -731,6 +1150,10 @@ define_sta_cmd_args "make_net" {}
 
 define_sta_cmd_args "replace_cell" {instance lib_cell}
 
+define_sta_cmd_args "what_if_replace_cell" {instance lib_cell min|max}
+
+define_sta_cmd_args "what_if_replace_cells" {instance lib_cells min|max}
+
 define_sta_cmd_args "insert_buffer" {buffer_name buffer_cell net load_pins\
 				       buffer_out_net_name}
 
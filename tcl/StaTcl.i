@@ -41,6 +41,8 @@
 #include "Error.hh"
 #include "StringUtil.hh"
 #include "PatternMatch.hh"
+#include "MemoryPolicy.hh"
+#include "Progress.hh"
 #include "MinMax.hh"
 #include "Fuzzy.hh"
 #include "PortDirection.hh"
@@ -52,7 +54,9 @@
 #include "TimingArc.hh"
 #include "EquivCells.hh"
 #include "Liberty.hh"
+#include "LibertyReader.hh"
 #include "Network.hh"
+#include "NetworkCmp.hh"
 #include "Clock.hh"
 #include "PortDelay.hh"
 #include "ExceptionPath.hh"
@@ -80,6 +84,8 @@
 #include "Power.hh"
 #include "Property.hh"
 #include "WritePathSpice.hh"
+#include "SdcFastCmd.hh"
+#include "StaMode.hh"
 #include "Sta.hh"
 
 namespace sta {
@@ -166,6 +172,18 @@ cmdGraph()
   return Sta::sta()->ensureGraph();
 }
 
+// The sta that owns the modes.
+Sta *
+cmdParentSta()
+{
+  Sta *sta = Sta::sta();
+  StaMode *mode = dynamic_cast<StaMode*>(sta);
+  if (mode)
+    return mode->parent();
+  else
+    return sta;
+}
+
 // These should be templated, but Sun's compiler can't deal with
 // an explicit template instantiation (ie, the arglist is the same
 // for all these functions).  Adding a dummy argument of the return
@@ -214,6 +232,48 @@ TclListSeqPin(Tcl_Obj * const source,
     return nullptr;
 }
 
+PathEndSeq *
+TclListSeqPathEnd(Tcl_Obj * const source,
+		  Tcl_Interp *interp)
+{
+  int argc;
+  Tcl_Obj **argv;
+
+  if (Tcl_ListObjGetElements(interp, source, &argc, &argv) == TCL_OK) {
+    PathEndSeq *seq = new PathEndSeq;
+    for (int i = 0; i < argc; i++) {
+      void *obj;
+      // Ignore returned TCL_ERROR because can't get swig_type_info.
+      SWIG_ConvertPtr(argv[i], &obj, SWIGTYPE_p_PathEnd, false);
+      seq->push_back(reinterpret_cast<PathEnd*>(obj));
+    }
+    return seq;
+  }
+  else
+    return nullptr;
+}
+
+LibertyCellSeq *
+TclListSeqLibertyCell(Tcl_Obj * const source,
+		      Tcl_Interp *interp)
+{
+  int argc;
+  Tcl_Obj **argv;
+
+  if (Tcl_ListObjGetElements(interp, source, &argc, &argv) == TCL_OK) {
+    LibertyCellSeq *seq = new LibertyCellSeq;
+    for (int i = 0; i < argc; i++) {
+      void *obj;
+      // Ignore returned TCL_ERROR because can't get swig_type_info.
+      SWIG_ConvertPtr(argv[i], &obj, SWIGTYPE_p_LibertyCell, false);
+      seq->push_back(reinterpret_cast<LibertyCell*>(obj));
+    }
+    return seq;
+  }
+  else
+    return nullptr;
+}
+
 InstanceSeq *
 TclListSeqInstance(Tcl_Obj * const source,
 		   Tcl_Interp *interp)
@@ -235,6 +295,27 @@ TclListSeqInstance(Tcl_Obj * const source,
     return nullptr;
 }
 
+NetSeq *
+TclListSeqNet(Tcl_Obj * const source,
+	      Tcl_Interp *interp)
+{
+  int argc;
+  Tcl_Obj **argv;
+
+  if (Tcl_ListObjGetElements(interp, source, &argc, &argv) == TCL_OK) {
+    NetSeq *seq = new NetSeq;
+    for (int i = 0; i < argc; i++) {
+      void *obj;
+      // Ignore returned TCL_ERROR because can't get swig_type_info.
+      SWIG_ConvertPtr(argv[i], &obj, SWIGTYPE_p_Net, false);
+      seq->push_back(reinterpret_cast<Net*>(obj));
+    }
+    return seq;
+  }
+  else
+    return nullptr;
+}
+
 ExceptionThruSeq *
 TclListSeqExceptionThru(Tcl_Obj *const source,
 			Tcl_Interp *interp)
@@ -611,6 +692,10 @@ using namespace sta;
   Tcl_SetObjResult(interp, list);
 }
 
+%typemap(in) LibertyCellSeq* {
+  $1 = TclListSeqLibertyCell($input, interp);
+}
+
 %typemap(out) TmpLibertyCellSeq* {
   Tcl_Obj *list = Tcl_NewListObj(0, nullptr);
   LibertyCellSeq *cells = $1;
@@ -918,6 +1003,10 @@ using namespace sta;
   Tcl_SetObjResult(interp, obj);
 }
 
+%typemap(in) NetSeq* {
+  $1 = TclListSeqNet($input, interp);
+}
+
 %typemap(out) NetSeq* {
   Tcl_Obj *list = Tcl_NewListObj(0, nullptr);
   NetSeq *nets = $1;
@@ -1220,6 +1309,8 @@ using namespace sta;
     $1 = ReportPathFormat::summary;
   else if (stringEq(arg, "slack_only"))
     $1 = ReportPathFormat::slack_only;
+  else if (stringEq(arg, "json"))
+    $1 = ReportPathFormat::json;
   else {
     tclError(interp, "Error: unknown path type %s.", arg);
     return TCL_ERROR;
@@ -1395,6 +1486,10 @@ using namespace sta;
   Tcl_SetObjResult(interp, obj);
 }
 
+%typemap(in) PathEndSeq* {
+  $1 = TclListSeqPathEnd($input, interp);
+}
+
 %typemap(out) PathEndSeq* {
   Tcl_Obj *list = Tcl_NewListObj(0, nullptr);
   const PathEndSeq *path_ends = $1;
@@ -2212,13 +2307,65 @@ bool
 read_liberty_cmd(char *filename,
 		 Corner *corner,
 		 const MinMaxAll *min_max,
-		 bool infer_latches)
+		 bool infer_latches,
+		 bool skip_power,
+		 bool skip_ccs)
 {
+  StringSet *skip_groups = makeLibertySkipGroups(skip_power, skip_ccs);
   LibertyLibrary *lib = Sta::sta()->readLiberty(filename, corner, min_max,
-						infer_latches);
+						infer_latches, skip_groups);
+  delete skip_groups;
+  return (lib != nullptr);
+}
+
+bool
+read_liberty_cache_cmd(char *cache_filename,
+		       Corner *corner,
+		       const MinMaxAll *min_max,
+		       bool infer_latches,
+		       bool lazy)
+{
+  LibertyLibrary *lib = Sta::sta()->readLibertyCache(cache_filename, corner,
+						     min_max, infer_latches,
+						     lazy);
   return (lib != nullptr);
 }
 
+bool
+read_liberty_files_cmd(StringSeq *filenames,
+		       Corner *corner,
+		       const MinMaxAll *min_max,
+		       bool infer_latches,
+		       bool skip_power,
+		       bool skip_ccs)
+{
+  StringSet *skip_groups = makeLibertySkipGroups(skip_power, skip_ccs);
+  bool success = Sta::sta()->readLibertyFiles(filenames, corner, min_max,
+					      infer_latches, skip_groups);
+  delete skip_groups;
+  delete filenames;
+  return success;
+}
+
+void
+write_liberty_cache_cmd(const char *filename,
+			const char *cache_filename)
+{
+  Sta::sta()->writeLibertyCache(filename, cache_filename);
+}
+
+bool
+read_liberty_table_values_cmd(const char *filename)
+{
+  return Sta::sta()->readLibertyTableValues(filename);
+}
+
+void
+write_liberty_table_values_cmd(const char *filename)
+{
+  Sta::sta()->writeLibertyTableValues(filename);
+}
+
 bool
 set_min_library_cmd(char *min_filename,
 		    char *max_filename)
@@ -2282,6 +2429,7 @@ find_library_buffers(LibertyLibrary *library)
 LibertyCellSeq *
 equiv_cells(LibertyCell *cell)
 {
+  Sta::sta()->findEquivCells();
   return cell->equivCells();
 }
 
@@ -2309,6 +2457,19 @@ link_design_cmd(const char *top_cell_name)
   return Sta::sta()->linkDesign(top_cell_name);
 }
 
+void
+write_network_db_cmd(const char *filename)
+{
+  cmdLinkedNetwork();
+  Sta::sta()->writeNetworkDb(filename);
+}
+
+bool
+read_network_db_cmd(const char *filename)
+{
+  return Sta::sta()->readNetworkDb(filename);
+}
+
 bool
 link_make_black_boxes()
 {
@@ -2427,6 +2588,8 @@ find_pins_matching(const char *pattern,
   Instance *current_instance = sta->currentInstance();
   TmpPinSeq *pins = new TmpPinSeq;
   network->findPinsMatching(current_instance, &matcher, pins);
+  // Instance children are hashed so sort the matches.
+  sort(pins, PinPathNameLess(network));
   return pins;
 }
 
@@ -2441,6 +2604,7 @@ find_pins_hier_matching(const char *pattern,
   PatternMatch matcher(pattern, regexp, nocase, Sta::sta()->tclInterp());
   TmpPinSeq *pins = new TmpPinSeq;
   network->findPinsHierMatching(current_instance, &matcher, pins);
+  sort(pins, PinPathNameLess(network));
   return pins;
 }
 
@@ -2453,13 +2617,15 @@ find_instance(char *path_name)
 TmpInstanceSeq *
 network_leaf_instances()
 {
+  Network *network = cmdLinkedNetwork();
   InstanceSeq *insts = new InstanceSeq;
-  LeafInstanceIterator *iter = cmdLinkedNetwork()->leafInstanceIterator();
+  LeafInstanceIterator *iter = network->leafInstanceIterator();
   while (iter->hasNext()) {
     Instance *inst = iter->next();
     insts->push_back(inst);
   }
   delete iter;
+  sort(insts, InstancePathNameLess(network));
   return insts;
 }
 
@@ -2471,8 +2637,10 @@ find_instances_matching(const char *pattern,
   Sta *sta = Sta::sta();
   Instance *current_instance = sta->currentInstance();
   PatternMatch matcher(pattern, regexp, nocase, sta->tclInterp());
+  Network *network = cmdLinkedNetwork();
   TmpInstanceSeq *insts = new InstanceSeq;
-  cmdLinkedNetwork()->findInstancesMatching(current_instance, &matcher, insts);
+  network->findInstancesMatching(current_instance, &matcher, insts);
+  sort(insts, InstancePathNameLess(network));
   return insts;
 }
 
@@ -2487,6 +2655,7 @@ find_instances_hier_matching(const char *pattern,
   PatternMatch matcher(pattern, regexp, nocase, sta->tclInterp());
   TmpInstanceSeq *insts = new InstanceSeq;
   network->findInstancesHierMatching(current_instance, &matcher, insts);
+  sort(insts, InstancePathNameLess(network));
   return insts;
 }
 
@@ -2572,6 +2741,7 @@ find_nets_matching(const char *pattern,
   PatternMatch matcher(pattern, regexp, nocase, Sta::sta()->tclInterp());
   NetSeq *nets = new NetSeq;
   network->findNetsMatching(current_instance, &matcher, nets);
+  sort(nets, NetPathNameLess(network));
   return nets;
 }
 
@@ -2585,6 +2755,88 @@ find_nets_hier_matching(const char *pattern,
   PatternMatch matcher(pattern, regexp, nocase, Sta::sta()->tclInterp());
   NetSeq *nets = new NetSeq;
   network->findNetsHierMatching(current_instance, &matcher, nets);
+  sort(nets, NetPathNameLess(network));
+  return nets;
+}
+
+// -of_objects for get_pins, get_cells and get_nets.
+// Collecting the objects here avoids a Tcl iterator loop per object.
+TmpPinSeq *
+instance_net_pins(InstanceSeq *insts,
+		  NetSeq *nets)
+{
+  Network *network = cmdLinkedNetwork();
+  TmpPinSeq *pins = new TmpPinSeq;
+  InstanceSeq::Iterator inst_iter(insts);
+  while (inst_iter.hasNext()) {
+    Instance *inst = inst_iter.next();
+    InstancePinIterator *pin_iter = network->pinIterator(inst);
+    while (pin_iter->hasNext())
+      pins->push_back(pin_iter->next());
+    delete pin_iter;
+  }
+  NetSeq::Iterator net_iter(nets);
+  while (net_iter.hasNext()) {
+    Net *net = net_iter.next();
+    NetPinIterator *pin_iter = network->pinIterator(net);
+    while (pin_iter->hasNext())
+      pins->push_back(pin_iter->next());
+    delete pin_iter;
+  }
+  delete insts;
+  delete nets;
+  return pins;
+}
+
+TmpInstanceSeq *
+pin_net_instances(PinSeq *pins,
+		  NetSeq *nets)
+{
+  Network *network = cmdLinkedNetwork();
+  TmpInstanceSeq *insts = new TmpInstanceSeq;
+  PinSeq::Iterator pin_iter(pins);
+  while (pin_iter.hasNext()) {
+    Pin *pin = pin_iter.next();
+    insts->push_back(network->instance(pin));
+  }
+  NetSeq::Iterator net_iter(nets);
+  while (net_iter.hasNext()) {
+    Net *net = net_iter.next();
+    NetPinIterator *net_pin_iter = network->pinIterator(net);
+    while (net_pin_iter->hasNext()) {
+      Pin *pin = net_pin_iter->next();
+      insts->push_back(network->instance(pin));
+    }
+    delete net_pin_iter;
+  }
+  delete pins;
+  delete nets;
+  return insts;
+}
+
+NetSeq *
+instance_pin_nets(InstanceSeq *insts,
+		  PinSeq *pins)
+{
+  Network *network = cmdLinkedNetwork();
+  NetSeq *nets = new NetSeq;
+  InstanceSeq::Iterator inst_iter(insts);
+  while (inst_iter.hasNext()) {
+    Instance *inst = inst_iter.next();
+    InstancePinIterator *pin_iter = network->pinIterator(inst);
+    while (pin_iter->hasNext()) {
+      Pin *pin = pin_iter->next();
+      nets->push_back(network->net(pin));
+    }
+    delete pin_iter;
+  }
+  PinSeq::Iterator pin_iter(pins);
+  while (pin_iter.hasNext()) {
+    Pin *pin = pin_iter.next();
+    nets->push_back(network->net(pin));
+  }
+  delete insts;
+  delete pins;
   return nets;
 }
 
@@ -3752,6 +4004,37 @@ unset_case_analysis_cmd(Pin *pin)
   Sta::sta()->removeCaseAnalysis(pin);
 }
 
+int
+add_case_analysis_mode_cmd()
+{
+  return Sta::sta()->addCaseAnalysisMode();
+}
+
+int
+case_analysis_mode_count()
+{
+  return Sta::sta()->caseAnalysisModeCount();
+}
+
+void
+clear_case_analysis_modes_cmd()
+{
+  Sta::sta()->clearCaseAnalysisModes();
+}
+
+void
+set_case_analysis_mode_cmd(int mode)
+{
+  Sta::sta()->setCaseAnalysisMode(mode);
+}
+
+char
+pin_case_analysis_mode_value(const Pin *pin,
+			     int mode)
+{
+  return logicValueString(Sta::sta()->caseAnalysisModeValue(pin, mode));
+}
+
 void
 set_timing_derate_cmd(TimingDerateType type,
 		      PathClkOrData clk_data,
@@ -3800,6 +4083,37 @@ unset_timing_derate_cmd()
   Sta::sta()->unsetTimingDerate();
 }
 
+void
+set_aocv_derate_cmd(PathClkOrData clk_data,
+		    const TransRiseFallBoth *tr,
+		    const EarlyLate *early_late,
+		    FloatSeq *depths,
+		    FloatSeq *derates)
+{
+  Sta::sta()->setAocvDerate(clk_data, tr, early_late, depths, derates);
+  delete depths;
+  delete derates;
+}
+
+void
+set_aocv_derate_cell_cmd(const LibertyCell *cell,
+			 PathClkOrData clk_data,
+			 const TransRiseFallBoth *tr,
+			 const EarlyLate *early_late,
+			 FloatSeq *depths,
+			 FloatSeq *derates)
+{
+  Sta::sta()->setAocvDerate(cell, clk_data, tr, early_late, depths, derates);
+  delete depths;
+  delete derates;
+}
+
+void
+unset_aocv_derate_cmd()
+{
+  Sta::sta()->unsetAocvDerates();
+}
+
 ClockIterator *
 clock_iterator()
 {
@@ -4026,13 +4340,14 @@ check_timing_cmd(bool no_input_delay,
 		 bool reg_no_clks,
 		 bool unconstrained_endpoints,
 		 bool loops,
-		 bool generated_clks)
+		 bool generated_clks,
+		 bool verbose)
 {
   cmdLinkedNetwork();
   return Sta::sta()->checkTiming(no_input_delay, no_output_delay,
 				 reg_multiple_clks, reg_no_clks,
 				 unconstrained_endpoints,
-				 loops, generated_clks);
+				 loops, generated_clks, verbose);
 }
 
 bool
@@ -4041,6 +4356,12 @@ crpr_enabled()
   return Sta::sta()->crprEnabled();
 }
 
+void
+set_search_incremental_tolerance(float tol)
+{
+  Sta::sta()->setIncrementalArrivalTolerance(tol);
+}
+
 void
 set_crpr_enabled(bool enabled)
 {
@@ -4345,6 +4666,12 @@ set_report_path_no_split(bool no_split)
   Sta::sta()->setReportPathNoSplit(no_split);
 }
 
+void
+set_report_path_name_ids(bool name_ids)
+{
+  Sta::sta()->setReportPathNameIds(name_ids);
+}
+
 void
 delete_path_ref(PathRef *path)
 {
@@ -4374,6 +4701,15 @@ report_clk_skew(ClockSet *clks,
   delete clks;
 }
 
+void
+report_path_based_slacks_cmd(PathEndSeq *path_ends,
+			     int digits)
+{
+  cmdLinkedNetwork();
+  Sta::sta()->reportPathBasedSlacks(*path_ends, digits);
+  delete path_ends;
+}
+
 TmpPinSet *
 startpoints()
 {
@@ -4400,10 +4736,11 @@ group_path_pins(const char *group_path_name)
 ////////////////////////////////////////////////////////////////
 
 MinPulseWidthCheckSeq &
-min_pulse_width_violations(const Corner *corner)
+min_pulse_width_violations(const Corner *corner,
+			   int max_count)
 {
   cmdLinkedNetwork();
-  return Sta::sta()->minPulseWidthViolations(corner);
+  return Sta::sta()->minPulseWidthViolations(corner, max_count);
 }
 
 MinPulseWidthCheckSeq &
@@ -4448,10 +4785,10 @@ report_mpw_check(MinPulseWidthCheck *check,
 ////////////////////////////////////////////////////////////////
 
 MinPeriodCheckSeq &
-min_period_violations()
+min_period_violations(int max_count)
 {
   cmdLinkedNetwork();
-  return Sta::sta()->minPeriodViolations();
+  return Sta::sta()->minPeriodViolations(max_count);
 }
 
 MinPeriodCheck *
@@ -4478,10 +4815,10 @@ report_min_period_check(MinPeriodCheck *check,
 ////////////////////////////////////////////////////////////////
 
 MaxSkewCheckSeq &
-max_skew_violations()
+max_skew_violations(int max_count)
 {
   cmdLinkedNetwork();
-  return Sta::sta()->maxSkewViolations();
+  return Sta::sta()->maxSkewViolations(max_count);
 }
 
 MaxSkewCheck *
@@ -4508,10 +4845,72 @@ report_max_skew_check(MaxSkewCheck *check,
 ////////////////////////////////////////////////////////////////
 
 void
-find_timing_cmd(bool full)
+find_timing_cmd(bool full,
+		bool requireds)
+{
+  cmdLinkedNetwork();
+  Sta *sta = Sta::sta();
+  sta->updateTiming(full);
+  if (requireds)
+    sta->findRequireds();
+}
+
+void
+create_mode_cmd(const char *name)
+{
+  cmdLinkedNetwork();
+  cmdParentSta()->makeMode(name);
+}
+
+bool
+mode_exists(const char *name)
+{
+  return cmdParentSta()->findMode(name) != nullptr;
+}
+
+void
+set_mode_cmd(const char *name)
+{
+  Sta *parent = cmdParentSta();
+  if (stringEq(name, "default"))
+    Sta::setSta(parent);
+  else
+    Sta::setSta(parent->findMode(name));
+}
+
+const char *
+current_mode()
+{
+  StaMode *mode = dynamic_cast<StaMode*>(Sta::sta());
+  if (mode)
+    return mode->name();
+  else
+    return "default";
+}
+
+void
+update_mode_timing_cmd(bool full,
+		       bool requireds)
 {
   cmdLinkedNetwork();
-  Sta::sta()->updateTiming(full);
+  cmdParentSta()->updateModeTiming(full, requireds);
+}
+
+void
+set_timing_scope_cmd(PinSet *pins,
+		     InstanceSet *insts)
+{
+  cmdLinkedNetwork();
+  Sta::sta()->setTimingScope(pins, insts);
+  delete pins;
+  delete insts;
+}
+
+void
+unset_timing_scope_cmd()
+{
+  cmdLinkedNetwork();
+  Sta::sta()->unsetTimingScope();
 }
 
 void
@@ -4528,6 +4927,112 @@ find_delays()
   Sta::sta()->findDelays();
 }
 
+void
+write_timing_checkpoint_cmd(const char *filename)
+{
+  cmdLinkedNetwork();
+  Sta::sta()->writeTimingCheckpoint(filename);
+}
+
+bool
+read_timing_checkpoint_cmd(const char *filename)
+{
+  cmdLinkedNetwork();
+  return Sta::sta()->readTimingCheckpoint(filename);
+}
+
+void
+write_delay_annotations_cmd(const char *filename)
+{
+  cmdLinkedNetwork();
+  Sta::sta()->writeDelayAnnotations(filename);
+}
+
+bool
+read_delay_annotations_cmd(const char *filename)
+{
+  cmdLinkedNetwork();
+  return Sta::sta()->readDelayAnnotations(filename);
+}
+
+void
+write_timing_columns_cmd(const char *dirname)
+{
+  cmdLinkedNetwork();
+  Sta::sta()->writeTimingColumns(dirname);
+}
+
+void
+write_boundary_timing_cmd(Instance *inst,
+			  const char *filename)
+{
+  cmdLinkedNetwork();
+  Sta::sta()->writeBoundaryTiming(inst, filename);
+}
+
+bool
+read_boundary_timing_cmd(const char *filename)
+{
+  cmdLinkedNetwork();
+  return Sta::sta()->readBoundaryTiming(filename);
+}
+
+void
+write_timing_model_cmd(const char *cell_name,
+		       const char *filename,
+		       const Corner *corner)
+{
+  cmdLinkedNetwork();
+  Sta::sta()->writeTimingModel(cell_name, filename, corner);
+}
+
+void
+report_pin_slacks_cmd(const MinMax *min_max,
+		      int digits)
+{
+  cmdLinkedNetwork();
+  Sta::sta()->reportPinSlacks(min_max, digits);
+}
+
+// Returns false if cmd has to be evaluated by Tcl.
+bool
+sdc_fast_cmd(const char *cmd,
+	     const char *filename,
+	     int line)
+{
+  return evalSdcFastCmd(cmd, filename, line, Sta::sta());
+}
+
+bool
+exception_merge_deferred()
+{
+  return Sta::sta()->sdc()->exceptionMergeDeferred();
+}
+
+void
+set_exception_merge_deferred(bool deferred)
+{
+  Sta::sta()->sdc()->setExceptionMergeDeferred(deferred);
+}
+
+void
+report_slack_histogram_cmd(const MinMax *min_max,
+			   int bin_count,
+			   int digits)
+{
+  cmdLinkedNetwork();
+  Sta::sta()->reportSlackHistogram(min_max, bin_count, digits);
+}
+
+void
+report_endpoint_summary_cmd(const MinMax *min_max,
+			    int top_n,
+			    int digits)
+{
+  cmdLinkedNetwork();
+  Sta::sta()->reportEndpointSummary(min_max, top_n, digits);
+}
+
 Slack
 total_negative_slack_cmd(const MinMax *min_max)
 {
@@ -4640,10 +5145,11 @@ pin_min_slew_limit_slack(const Corner *corner,
 
 PinSeq *
 pin_slew_limit_violations(const Corner *corner,
-			  const MinMax *min_max)
+			  const MinMax *min_max,
+			  int max_count)
 {
   cmdLinkedNetwork();
-  return Sta::sta()->pinSlewLimitViolations(corner, min_max);
+  return Sta::sta()->pinSlewLimitViolations(corner, min_max, max_count);
 }
 
 void
@@ -4731,6 +5237,44 @@ set_power_pin_activity(const Pin *pin,
 					     PwrActivityOrigin::user);
 }
 
+bool
+power_cache()
+{
+  return Sta::sta()->power()->internalPowerCache();
+}
+
+void
+set_power_cache(bool enable)
+{
+  Sta::sta()->power()->setInternalPowerCache(enable);
+}
+
+void
+report_power_cache_cmd()
+{
+  Sta::sta()->power()->reportInternalPowerCache();
+}
+
+bool
+read_vcd_activities(const char *filename,
+		    const char *scope)
+{
+  cmdLinkedNetwork();
+  if (stringEq(scope, ""))
+    scope = NULL;
+  return Sta::sta()->readVcdActivities(filename, scope);
+}
+
+bool
+read_saif_activities(const char *filename,
+		     const char *scope)
+{
+  cmdLinkedNetwork();
+  if (stringEq(scope, ""))
+    scope = NULL;
+  return Sta::sta()->readSaifActivities(filename, scope);
+}
+
 ////////////////////////////////////////////////////////////////
 
 EdgeSeq *
@@ -4743,11 +5287,12 @@ disabled_edges_sorted()
 void
 write_sdc_cmd(const char *filename,
 	      bool compatible,
+	      bool gzip,
 	      bool no_timestamp,
 	      int digits)
 {
   cmdLinkedNetwork();
-  Sta::sta()->writeSdc(filename, compatible, no_timestamp, digits);
+  Sta::sta()->writeSdc(filename, compatible, gzip, no_timestamp, digits);
 }
 
 void
@@ -4765,6 +5310,20 @@ write_path_spice_cmd(PathRef *path,
 		 power_name, gnd_name, sta);
 }
 
+void
+write_path_spices_cmd(PathEndSeq *path_ends,
+		      const char *spice_dir,
+		      const char *lib_subckt_filename,
+		      const char *model_filename,
+		      const char *power_name,
+		      const char *gnd_name)
+{
+  Sta *sta = Sta::sta();
+  writePathSpice(path_ends, spice_dir, lib_subckt_filename, model_filename,
+		 power_name, gnd_name, sta);
+  delete path_ends;
+}
+
 bool
 liberty_supply_exists(const char *supply_name)
 {
@@ -4907,7 +5466,7 @@ timing_role_is_check(TimingRole *role)
 
 ////////////////////////////////////////////////////////////////
 
-TmpPinSet *
+TmpPinSeq *
 find_fanin_pins(PinSeq *to,
 		bool flat,
 		bool startpoints_only,
@@ -4918,9 +5477,9 @@ find_fanin_pins(PinSeq *to,
 {
   cmdLinkedNetwork();
   Sta *sta = Sta::sta();
-  PinSet *fanin = sta->findFaninPins(to, flat, startpoints_only,
-				     inst_levels, pin_levels,
-				     thru_disabled, thru_constants);
+  PinSeq *fanin = sta->findFaninPinSeq(to, flat, startpoints_only,
+				       inst_levels, pin_levels,
+				       thru_disabled, thru_constants);
   delete to;
   return fanin;
 }
@@ -4943,7 +5502,7 @@ find_fanin_insts(PinSeq *to,
   return fanin;
 }
 
-TmpPinSet *
+TmpPinSeq *
 find_fanout_pins(PinSeq *from,
 		 bool flat,
 		 bool endpoints_only,
@@ -4954,9 +5513,9 @@ find_fanout_pins(PinSeq *from,
 {
   cmdLinkedNetwork();
   Sta *sta = Sta::sta();
-  PinSet *fanout = sta->findFanoutPins(from, flat, endpoints_only,
-				       inst_levels, pin_levels,
-				       thru_disabled, thru_constants);
+  PinSeq *fanout = sta->findFanoutPinSeq(from, flat, endpoints_only,
+					 inst_levels, pin_levels,
+					 thru_disabled, thru_constants);
   delete from;
   return fanout;
 }
@@ -5105,6 +5664,13 @@ report_arrival_count_histogram()
   Sta::sta()->search()->reportArrivalCountHistogram();
 }
 
+void
+report_tag_growth_cmd(int max_count)
+{
+  cmdLinkedNetwork();
+  Sta::sta()->search()->reportTagGrowth(max_count);
+}
+
 int
 tag_count()
 {
@@ -5117,12 +5683,65 @@ report_tags()
   Sta::sta()->search()->reportTags();
 }
 
+void
+compact_tags_cmd()
+{
+  cmdLinkedNetwork();
+  Sta::sta()->compactTags();
+}
+
 void
 report_clk_infos()
 {
   Sta::sta()->search()->reportClkInfos();
 }
 
+void
+report_memory_cmd(bool json)
+{
+  Sta::sta()->reportMemory(json);
+}
+
+void
+report_phase_stats_cmd(bool json)
+{
+  Sta::sta()->reportPhaseStats(json);
+}
+
+void
+clear_phase_stats()
+{
+  Sta::sta()->clearPhaseStats();
+}
+
+void
+report_thread_profile_cmd(int max_levels,
+			  bool json)
+{
+  if (json)
+    Sta::sta()->reportThreadProfileJson();
+  else
+    Sta::sta()->reportThreadProfile(max_levels);
+}
+
+void
+clear_thread_profile()
+{
+  Sta::sta()->clearThreadProfile();
+}
+
+void
+report_hot_vertices_cmd(int count)
+{
+  Sta::sta()->reportHotVertices(count);
+}
+
+void
+clear_hot_vertices()
+{
+  Sta::sta()->clearHotVertices();
+}
+
 int
 clk_info_count()
 {
@@ -5222,6 +5841,154 @@ set_thread_count(int count)
   Sta::sta()->setThreadCount(count);
 }
 
+const char *
+memory_policy()
+{
+  switch (memoryPolicy()) {
+  case MemoryPolicy::standard:
+    return "standard";
+  case MemoryPolicy::huge_pages:
+    return "huge_pages";
+  case MemoryPolicy::interleave:
+    return "interleave";
+  default:
+    return "";
+  }
+}
+
+void
+set_memory_policy(const char *policy)
+{
+  if (stringEq(policy, "standard"))
+    setMemoryPolicy(MemoryPolicy::standard);
+  else if (stringEq(policy, "huge_pages"))
+    setMemoryPolicy(MemoryPolicy::huge_pages);
+  else if (stringEq(policy, "interleave"))
+    setMemoryPolicy(MemoryPolicy::interleave);
+  else
+    internalError("unknown memory policy.");
+}
+
+double
+progress_interval()
+{
+  return progressInterval();
+}
+
+void
+set_progress_interval(double seconds)
+{
+  setProgressInterval(seconds);
+}
+
+bool
+dataflow_scheduling()
+{
+  return Sta::sta()->dataflowScheduling();
+}
+
+void
+set_dataflow_scheduling(bool enable)
+{
+  Sta::sta()->setDataflowScheduling(enable);
+}
+
+bool
+thread_profile()
+{
+  return Sta::sta()->threadProfileEnabled();
+}
+
+void
+set_thread_profile(bool enable)
+{
+  Sta::sta()->setThreadProfileEnabled(enable);
+}
+
+bool
+hot_vertex_profile()
+{
+  return Sta::sta()->hotVertexProfileEnabled();
+}
+
+void
+set_hot_vertex_profile(bool enable)
+{
+  Sta::sta()->setHotVertexProfileEnabled(enable);
+}
+
+bool
+parallel_constant_propagation()
+{
+  return Sta::sta()->parallelConstantPropagation();
+}
+
+void
+set_parallel_constant_propagation(bool enable)
+{
+  Sta::sta()->setParallelConstantPropagation(enable);
+}
+
+bool
+clk_domain_partitions()
+{
+  return Sta::sta()->clkDomainPartitions();
+}
+
+void
+set_clk_domain_partitions(bool partitions)
+{
+  Sta::sta()->setClkDomainPartitions(partitions);
+}
+
+bool
+prev_path_storage()
+{
+  return Sta::sta()->prevPathStorage();
+}
+
+void
+set_prev_path_storage(bool storage)
+{
+  Sta::sta()->setPrevPathStorage(storage);
+}
+
+bool
+pocv_statistical_max()
+{
+  return Sta::sta()->pocvStatisticalMax();
+}
+
+void
+set_pocv_statistical_max(bool statistical_max)
+{
+  Sta::sta()->setPocvStatisticalMax(statistical_max);
+}
+
+bool
+aocv_enabled()
+{
+  return Sta::sta()->aocvEnabled();
+}
+
+void
+set_aocv_enabled(bool enabled)
+{
+  Sta::sta()->setAocvEnabled(enabled);
+}
+
+bool
+quantized_slews()
+{
+  return Sta::sta()->quantizedSlews();
+}
+
+void
+set_quantized_slews(bool quantized)
+{
+  Sta::sta()->setQuantizedSlews(quantized);
+}
+
 void
 arrivals_invalid()
 {
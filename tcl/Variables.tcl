@@ -168,6 +168,144 @@ proc trace_pocv_enabled { name1 name2 op } {
     pocv_enabled set_pocv_enabled
 }
 
+trace variable ::sta_pocv_statistical_max "rw" \
+  sta::trace_pocv_statistical_max
+
+proc trace_pocv_statistical_max { name1 name2 op } {
+  trace_boolean_var $op ::sta_pocv_statistical_max \
+    pocv_statistical_max set_pocv_statistical_max
+}
+
+trace variable ::sta_aocv_enabled "rw" \
+  sta::trace_aocv_enabled
+
+proc trace_aocv_enabled { name1 name2 op } {
+  trace_boolean_var $op ::sta_aocv_enabled \
+    aocv_enabled set_aocv_enabled
+}
+
+# Store slews in 16 bits to save memory.
+trace variable ::sta_quantized_slews "rw" \
+  sta::trace_quantized_slews
+
+proc trace_quantized_slews { name1 name2 op } {
+  trace_boolean_var $op ::sta_quantized_slews \
+    quantized_slews set_quantized_slews
+}
+
+trace variable ::sta_dataflow_scheduling "rw" \
+  sta::trace_dataflow_scheduling
+
+proc trace_dataflow_scheduling { name1 name2 op } {
+  trace_boolean_var $op ::sta_dataflow_scheduling \
+    dataflow_scheduling set_dataflow_scheduling
+}
+
+# Record thread utilization of parallel visits for report_thread_profile.
+trace variable ::sta_thread_profile "rw" \
+  sta::trace_thread_profile
+
+proc trace_thread_profile { name1 name2 op } {
+  trace_boolean_var $op ::sta_thread_profile \
+    thread_profile set_thread_profile
+}
+
+# Record the slowest vertices to visit for report_hot_vertices.
+trace variable ::sta_hot_vertex_profile "rw" \
+  sta::trace_hot_vertex_profile
+
+proc trace_hot_vertex_profile { name1 name2 op } {
+  trace_boolean_var $op ::sta_hot_vertex_profile \
+    hot_vertex_profile set_hot_vertex_profile
+}
+
+trace variable ::sta_parallel_constant_propagation "rw" \
+  sta::trace_parallel_constant_propagation
+
+proc trace_parallel_constant_propagation { name1 name2 op } {
+  trace_boolean_var $op ::sta_parallel_constant_propagation \
+    parallel_constant_propagation set_parallel_constant_propagation
+}
+
+trace variable ::sta_clk_domain_partitions "rw" \
+  sta::trace_clk_domain_partitions
+
+proc trace_clk_domain_partitions { name1 name2 op } {
+  trace_boolean_var $op ::sta_clk_domain_partitions \
+    clk_domain_partitions set_clk_domain_partitions
+}
+
+trace variable ::sta_prev_path_storage "rw" \
+  sta::trace_prev_path_storage
+
+proc trace_prev_path_storage { name1 name2 op } {
+  trace_boolean_var $op ::sta_prev_path_storage \
+    prev_path_storage set_prev_path_storage
+}
+
+trace variable ::sta_gate_delay_cache "rw" \
+  sta::trace_gate_delay_cache
+
+proc trace_gate_delay_cache { name1 name2 op } {
+  trace_boolean_var $op ::sta_gate_delay_cache \
+    gate_delay_cache set_gate_delay_cache
+}
+
+trace variable ::sta_dcalc_level_batch "rw" \
+  sta::trace_dcalc_level_batch
+
+proc trace_dcalc_level_batch { name1 name2 op } {
+  trace_boolean_var $op ::sta_dcalc_level_batch \
+    dcalc_level_batch set_dcalc_level_batch
+}
+
+trace variable ::sta_power_cache "rw" \
+  sta::trace_power_cache
+
+proc trace_power_cache { name1 name2 op } {
+  trace_boolean_var $op ::sta_power_cache \
+    power_cache set_power_cache
+}
+
+# Placement of graph pool blocks made after it is set.
+trace variable ::sta_memory_policy "rw" \
+  sta::trace_memory_policy
+
+proc trace_memory_policy { name1 name2 op } {
+  global sta_memory_policy
+
+  if { $op == "r" } {
+    set sta_memory_policy [memory_policy]
+  } elseif { $op == "w" } {
+    if { $sta_memory_policy == "standard" \
+	   || $sta_memory_policy == "huge_pages" \
+	   || $sta_memory_policy == "interleave" } {
+      set_memory_policy $sta_memory_policy
+    } else {
+      sta_error "sta_memory_policy must be standard, huge_pages or interleave."
+    }
+  }
+}
+
+# Seconds between progress messages during reads and timing updates.
+trace variable ::sta_progress_interval "rw" \
+  sta::trace_progress_interval
+
+proc trace_progress_interval { name1 name2 op } {
+  global sta_progress_interval
+
+  if { $op == "r" } {
+    set sta_progress_interval [progress_interval]
+  } elseif { $op == "w" } {
+    if { [string is double $sta_progress_interval] \
+	   && $sta_progress_interval >= 0 } {
+      set_progress_interval $sta_progress_interval
+    } else {
+      sta_error "sta_progress_interval must be a positive number of seconds."
+    }
+  }
+}
+
 # Report path numeric field width is digits + extra.
 set report_path_field_width_extra 5
 
@@ -0,0 +1,560 @@
+// OpenSTA, Static Timing Analyzer
+// Copyright (c) 2019, Parallax Software, Inc.
+// 
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+// 
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+// 
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#ifndef STA_CONCURRENT_ARRAY_POOL_H
+#define STA_CONCURRENT_ARRAY_POOL_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <atomic>
+#include <mutex>
+#include <new>
+#include <vector>
+#include "DisallowCopyAssign.hh"
+
+namespace sta {
+
+// Slot index of a thread for per thread caches.
+// A thread takes a free slot the first time it asks for one and
+// returns it when the thread exits, so slot indices stay below the
+// peak number of live threads and a new thread takes over the caches
+// (and the deleted arrays on them) of an exited thread.
+class PoolThreadSlot
+{
+public:
+  PoolThreadSlot();
+  ~PoolThreadSlot();
+  size_t index() const { return index_; }
+
+private:
+  DISALLOW_COPY_AND_ASSIGN(PoolThreadSlot);
+
+  struct FreeSlots
+  {
+    FreeSlots() : next_index(0) {}
+    std::mutex lock;
+    // Slots returned by exited threads.
+    std::vector<size_t> free;
+    size_t next_index;
+  };
+  static FreeSlots &freeSlots();
+
+  size_t index_;
+};
+
+inline PoolThreadSlot::FreeSlots &
+PoolThreadSlot::freeSlots()
+{
+  static FreeSlots free_slots;
+  return free_slots;
+}
+
+inline
+PoolThreadSlot::PoolThreadSlot()
+{
+  FreeSlots &slots = freeSlots();
+  std::lock_guard<std::mutex> lock(slots.lock);
+  if (slots.free.empty())
+    index_ = slots.next_index++;
+  else {
+    index_ = slots.free.back();
+    slots.free.pop_back();
+  }
+}
+
+// The slot lock orders the exited thread's cache updates before
+// those of the next thread to take the slot.
+inline
+PoolThreadSlot::~PoolThreadSlot()
+{
+  FreeSlots &slots = freeSlots();
+  std::lock_guard<std::mutex> lock(slots.lock);
+  slots.free.push_back(index_);
+}
+
+inline size_t
+poolThreadIndex()
+{
+  static thread_local PoolThreadSlot slot;
+  return slot.index();
+}
+
+// Pool of object arrays that threads make and delete without locks.
+// Array lengths are rounded up to size classes; each thread carves
+// arrays from its own slab blocks and keeps the arrays it deletes on
+// free lists by size class, so the common case touches no shared
+// state. The caches belong to thread slots (see PoolThreadSlot), so
+// they are reused by later threads instead of being stranded when
+// a thread exits. Threads past max_thread_count_ live threads share
+// a locked cache. New blocks are pushed on a lock free list that is only
+// walked to free them when the pool is deleted.
+// Arrays longer than max_cached_count_ use the heap.
+// An array may be deleted by a different thread than the one that
+// made it.
+template <class OBJ>
+class ConcurrentArrayPool
+{
+public:
+  ConcurrentArrayPool();
+  ~ConcurrentArrayPool();
+  // Array of count value initialized objects.
+  OBJ *makeObjects(size_t count);
+  // Reinitialize objects as an array of count objects in place when
+  // count is in the same size class, otherwise delete it and make a
+  // new array. objects may be null.
+  OBJ *resizeObjects(OBJ *objects,
+		     size_t count);
+  void deleteObjects(OBJ *objects);
+
+  // Statistics. Only meaningful when no thread is making or deleting
+  // arrays.
+  size_t arrayCount() const;
+  // Bytes of the objects in live arrays.
+  size_t usedBytes() const;
+  // Bytes of the size class slots of live arrays including headers.
+  size_t slotBytes() const;
+  // Bytes of the slots on free lists.
+  size_t freeBytes() const;
+  // Bytes allocated for blocks and heap arrays.
+  size_t reservedBytes() const;
+  // Arrays that resizeObjects reused in place.
+  size_t reuseCount() const;
+
+private:
+  DISALLOW_COPY_AND_ASSIGN(ConcurrentArrayPool);
+
+  struct ArrayInfo
+  {
+    uint32_t count;
+    uint32_t size_class;
+  };
+
+  // Arrays are preceded by a header with the object count and size
+  // class. The header also keeps the objects aligned.
+  union Header
+  {
+    ArrayInfo info;
+    Header *next_free;
+    double align;
+  };
+  static_assert(alignof(OBJ) <= alignof(Header),
+		"pool objects need more alignment than the array header");
+
+  struct Block
+  {
+    Block *next;
+    char *memory;
+  };
+
+  struct Stats
+  {
+    Stats() :
+      array_count(0),
+      used_bytes(0),
+      slot_bytes(0),
+      free_bytes(0),
+      reuse_count(0)
+    {}
+    // Arrays deleted by another thread wrap these around, but the
+    // sums over all threads are correct.
+    size_t array_count;
+    size_t used_bytes;
+    size_t slot_bytes;
+    size_t free_bytes;
+    size_t reuse_count;
+  };
+
+  struct ThreadCache
+  {
+    ThreadCache() :
+      next_free(nullptr),
+      end(nullptr),
+      free_lists(size_class_count_, nullptr)
+    {}
+    char *next_free;
+    char *end;
+    // Deleted arrays indexed by size class.
+    std::vector<Header*> free_lists;
+    Stats stats;
+  };
+
+  static size_t sizeClass(size_t count);
+  static size_t sizeClassCount(size_t size_class);
+  static size_t arrayBytes(size_t count);
+  static void constructObjects(OBJ *objects,
+			       size_t count);
+  static void destroyObjects(OBJ *objects,
+			     size_t count);
+  static Header *header(OBJ *objects);
+  ThreadCache *threadCache();
+  OBJ *makeObjects(ThreadCache *cache,
+		   size_t count);
+  void deleteObjects(ThreadCache *cache,
+		     Header *header);
+  char *makeBlock(ThreadCache *cache,
+		  size_t bytes);
+  void sumStats(Stats &stats) const;
+
+  static const size_t max_cached_count_ = 1024;
+  // Counts up to exact_count_ are their own size class. Above that
+  // there are four size classes per power of two.
+  static const size_t exact_count_ = 16;
+  static const size_t size_class_count_ = exact_count_ + 6 * 4 + 1;
+  static const uint32_t heap_size_class_ = size_class_count_;
+  static const size_t block_bytes_ = 1 << 16;
+  static const size_t max_thread_count_ = 256;
+  std::atomic<Block*> blocks_;
+  std::atomic<size_t> block_bytes_total_;
+  std::atomic<ThreadCache*> caches_[max_thread_count_];
+  // Shared cache for threads past max_thread_count_ live threads.
+  ThreadCache overflow_cache_;
+  std::mutex overflow_lock_;
+  // Heap array statistics.
+  std::atomic<size_t> heap_count_;
+  std::atomic<size_t> heap_bytes_;
+  std::atomic<size_t> heap_used_bytes_;
+};
+
+template <class OBJ>
+ConcurrentArrayPool<OBJ>::ConcurrentArrayPool() :
+  blocks_(nullptr),
+  block_bytes_total_(0),
+  heap_count_(0),
+  heap_bytes_(0),
+  heap_used_bytes_(0)
+{
+  for (size_t i = 0; i < max_thread_count_; i++)
+    caches_[i].store(nullptr, std::memory_order_relaxed);
+}
+
+template <class OBJ>
+ConcurrentArrayPool<OBJ>::~ConcurrentArrayPool()
+{
+  Block *next;
+  for (Block *block = blocks_.load(std::memory_order_acquire);
+       block;
+       block = next) {
+    next = block->next;
+    delete [] block->memory;
+    delete block;
+  }
+  for (size_t i = 0; i < max_thread_count_; i++)
+    delete caches_[i].load(std::memory_order_acquire);
+}
+
+// 1..16 exact, then 20, 24, 28, 32, 40, 48, 56, 64, ... 1024.
+template <class OBJ>
+size_t
+ConcurrentArrayPool<OBJ>::sizeClass(size_t count)
+{
+  if (count <= exact_count_)
+    return count;
+  else {
+    size_t size_class = exact_count_;
+    size_t pow2 = exact_count_;
+    while (pow2 * 2 < count) {
+      pow2 *= 2;
+      size_class += 4;
+    }
+    size_t step = pow2 / 4;
+    return size_class + (count - pow2 + step - 1) / step;
+  }
+}
+
+template <class OBJ>
+size_t
+ConcurrentArrayPool<OBJ>::sizeClassCount(size_t size_class)
+{
+  if (size_class <= exact_count_)
+    return size_class;
+  else {
+    size_t pow2 = exact_count_ << ((size_class - exact_count_ - 1) / 4);
+    return pow2 + ((size_class - exact_count_ - 1) % 4 + 1) * (pow2 / 4);
+  }
+}
+
+template <class OBJ>
+size_t
+ConcurrentArrayPool<OBJ>::arrayBytes(size_t count)
+{
+  size_t bytes = sizeof(Header) + count * sizeof(OBJ);
+  // Round up so the next array header is aligned.
+  return (bytes + sizeof(Header) - 1) / sizeof(Header) * sizeof(Header);
+}
+
+template <class OBJ>
+void
+ConcurrentArrayPool<OBJ>::constructObjects(OBJ *objects,
+					   size_t count)
+{
+  for (size_t i = 0; i < count; i++)
+    new (objects + i) OBJ();
+}
+
+template <class OBJ>
+void
+ConcurrentArrayPool<OBJ>::destroyObjects(OBJ *objects,
+					 size_t count)
+{
+  for (size_t i = 0; i < count; i++)
+    objects[i].~OBJ();
+}
+
+template <class OBJ>
+typename ConcurrentArrayPool<OBJ>::Header *
+ConcurrentArrayPool<OBJ>::header(OBJ *objects)
+{
+  return reinterpret_cast<Header*>(objects) - 1;
+}
+
+template <class OBJ>
+typename ConcurrentArrayPool<OBJ>::ThreadCache *
+ConcurrentArrayPool<OBJ>::threadCache()
+{
+  size_t thread_index = poolThreadIndex();
+  if (thread_index < max_thread_count_) {
+    std::atomic<ThreadCache*> &cache_ref = caches_[thread_index];
+    // Only the thread owning the slot stores its cache.
+    ThreadCache *cache = cache_ref.load(std::memory_order_relaxed);
+    if (cache == nullptr) {
+      cache = new ThreadCache;
+      cache_ref.store(cache, std::memory_order_release);
+    }
+    return cache;
+  }
+  else
+    return nullptr;
+}
+
+template <class OBJ>
+OBJ *
+ConcurrentArrayPool<OBJ>::makeObjects(size_t count)
+{
+  if (count > max_cached_count_) {
+    size_t bytes = arrayBytes(count);
+    Header *header = reinterpret_cast<Header*>(new char[bytes]);
+    header->info.count = count;
+    header->info.size_class = heap_size_class_;
+    heap_count_ += 1;
+    heap_bytes_ += bytes;
+    heap_used_bytes_ += count * sizeof(OBJ);
+    OBJ *objects = reinterpret_cast<OBJ*>(header + 1);
+    constructObjects(objects, count);
+    return objects;
+  }
+  ThreadCache *cache = threadCache();
+  if (cache)
+    return makeObjects(cache, count);
+  else {
+    std::lock_guard<std::mutex> lock(overflow_lock_);
+    return makeObjects(&overflow_cache_, count);
+  }
+}
+
+template <class OBJ>
+OBJ *
+ConcurrentArrayPool<OBJ>::makeObjects(ThreadCache *cache,
+				      size_t count)
+{
+  size_t size_class = sizeClass(count);
+  size_t bytes = arrayBytes(sizeClassCount(size_class));
+  Header *header = cache->free_lists[size_class];
+  if (header) {
+    cache->free_lists[size_class] = header->next_free;
+    cache->stats.free_bytes -= bytes;
+  }
+  else {
+    if (cache->next_free == nullptr
+	|| cache->next_free + bytes > cache->end)
+      cache->next_free = makeBlock(cache, bytes);
+    header = reinterpret_cast<Header*>(cache->next_free);
+    cache->next_free += bytes;
+  }
+  header->info.count = count;
+  header->info.size_class = size_class;
+  cache->stats.array_count++;
+  cache->stats.used_bytes += count * sizeof(OBJ);
+  cache->stats.slot_bytes += bytes;
+  OBJ *objects = reinterpret_cast<OBJ*>(header + 1);
+  constructObjects(objects, count);
+  return objects;
+}
+
+// The rest of the thread's previous block is abandoned.
+template <class OBJ>
+char *
+ConcurrentArrayPool<OBJ>::makeBlock(ThreadCache *cache,
+				    size_t bytes)
+{
+  size_t block_bytes = (bytes > block_bytes_) ? bytes : block_bytes_;
+  Block *block = new Block;
+  block->memory = new char[block_bytes];
+  block->next = blocks_.load(std::memory_order_relaxed);
+  while (!blocks_.compare_exchange_weak(block->next, block,
+					std::memory_order_release,
+					std::memory_order_relaxed)) {}
+  block_bytes_total_ += block_bytes;
+  cache->end = block->memory + block_bytes;
+  return block->memory;
+}
+
+template <class OBJ>
+OBJ *
+ConcurrentArrayPool<OBJ>::resizeObjects(OBJ *objects,
+					size_t count)
+{
+  if (objects) {
+    Header *header = this->header(objects);
+    size_t prev_count = header->info.count;
+    size_t size_class = header->info.size_class;
+    if (size_class != heap_size_class_
+	&& count <= max_cached_count_
+	&& sizeClass(count) == size_class) {
+      destroyObjects(objects, prev_count);
+      constructObjects(objects, count);
+      header->info.count = count;
+      ThreadCache *cache = threadCache();
+      std::unique_lock<std::mutex> lock(overflow_lock_, std::defer_lock);
+      if (cache == nullptr) {
+	lock.lock();
+	cache = &overflow_cache_;
+      }
+      cache->stats.used_bytes += (count - prev_count) * sizeof(OBJ);
+      cache->stats.reuse_count++;
+      return objects;
+    }
+    deleteObjects(objects);
+  }
+  return makeObjects(count);
+}
+
+template <class OBJ>
+void
+ConcurrentArrayPool<OBJ>::deleteObjects(OBJ *objects)
+{
+  if (objects) {
+    Header *header = this->header(objects);
+    size_t count = header->info.count;
+    destroyObjects(objects, count);
+    if (header->info.size_class == heap_size_class_) {
+      heap_count_ -= 1;
+      heap_bytes_ -= arrayBytes(count);
+      heap_used_bytes_ -= count * sizeof(OBJ);
+      delete [] reinterpret_cast<char*>(header);
+    }
+    else {
+      ThreadCache *cache = threadCache();
+      if (cache)
+	deleteObjects(cache, header);
+      else {
+	std::lock_guard<std::mutex> lock(overflow_lock_);
+	deleteObjects(&overflow_cache_, header);
+      }
+    }
+  }
+}
+
+template <class OBJ>
+void
+ConcurrentArrayPool<OBJ>::deleteObjects(ThreadCache *cache,
+					Header *header)
+{
+  size_t count = header->info.count;
+  size_t size_class = header->info.size_class;
+  size_t bytes = arrayBytes(sizeClassCount(size_class));
+  cache->stats.array_count--;
+  cache->stats.used_bytes -= count * sizeof(OBJ);
+  cache->stats.slot_bytes -= bytes;
+  cache->stats.free_bytes += bytes;
+  header->next_free = cache->free_lists[size_class];
+  cache->free_lists[size_class] = header;
+}
+
+template <class OBJ>
+void
+ConcurrentArrayPool<OBJ>::sumStats(Stats &stats) const
+{
+  for (size_t i = 0; i < max_thread_count_; i++) {
+    const ThreadCache *cache = caches_[i].load(std::memory_order_acquire);
+    if (cache) {
+      stats.array_count += cache->stats.array_count;
+      stats.used_bytes += cache->stats.used_bytes;
+      stats.slot_bytes += cache->stats.slot_bytes;
+      stats.free_bytes += cache->stats.free_bytes;
+      stats.reuse_count += cache->stats.reuse_count;
+    }
+  }
+  stats.array_count += overflow_cache_.stats.array_count;
+  stats.used_bytes += overflow_cache_.stats.used_bytes;
+  stats.slot_bytes += overflow_cache_.stats.slot_bytes;
+  stats.free_bytes += overflow_cache_.stats.free_bytes;
+  stats.reuse_count += overflow_cache_.stats.reuse_count;
+}
+
+template <class OBJ>
+size_t
+ConcurrentArrayPool<OBJ>::arrayCount() const
+{
+  Stats stats;
+  sumStats(stats);
+  return stats.array_count + heap_count_;
+}
+
+template <class OBJ>
+size_t
+ConcurrentArrayPool<OBJ>::usedBytes() const
+{
+  Stats stats;
+  sumStats(stats);
+  return stats.used_bytes + heap_used_bytes_;
+}
+
+template <class OBJ>
+size_t
+ConcurrentArrayPool<OBJ>::slotBytes() const
+{
+  Stats stats;
+  sumStats(stats);
+  return stats.slot_bytes + heap_bytes_;
+}
+
+template <class OBJ>
+size_t
+ConcurrentArrayPool<OBJ>::freeBytes() const
+{
+  Stats stats;
+  sumStats(stats);
+  return stats.free_bytes;
+}
+
+template <class OBJ>
+size_t
+ConcurrentArrayPool<OBJ>::reservedBytes() const
+{
+  return block_bytes_total_ + heap_bytes_;
+}
+
+template <class OBJ>
+size_t
+ConcurrentArrayPool<OBJ>::reuseCount() const
+{
+  Stats stats;
+  sumStats(stats);
+  return stats.reuse_count;
+}
+
+} // namespace
+#endif
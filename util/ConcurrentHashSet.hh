@@ -0,0 +1,446 @@
+// OpenSTA, Static Timing Analyzer
+// Copyright (c) 2019, Parallax Software, Inc.
+// 
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+// 
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+// 
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#ifndef STA_CONCURRENT_HASH_SET_H
+#define STA_CONCURRENT_HASH_SET_H
+
+#include <stddef.h>  // size_t
+#include <stdint.h>
+#include <atomic>
+#include <mutex>
+#include <vector>
+#include "DisallowCopyAssign.hh"
+#include "Hash.hh"
+
+namespace sta {
+
+// Open addressing hash set of object pointers with lock free findKey.
+// The set is split into shards that each have their own lock.
+// Hold lock(key) around insert(key) and the findKey that checks
+// key is missing so threads inserting keys in different shards do
+// not serialize.
+//
+// Keys are stored in flat slot arrays probed a group of 8 slots at a
+// time. Each slot has a control byte that is empty, deleted or the
+// low 7 bits of the key hash. The control bytes of a group share one
+// word so a probe compares all 8 of them with a few integer
+// operations and only compares keys whose hash bits match.
+//
+// A shard grows by building a new table.  The tables it replaces are
+// kept until erase/clear so readers that are still using them see a
+// consistent (if stale) set; a reader that misses rechecks with the
+// lock.
+// erase, clear, deleteContentsClear and the iterator are not thread
+// safe.
+template <class KEY, class HASH, class EQUAL>
+class ConcurrentHashSet
+{
+  struct Table;
+
+public:
+  ConcurrentHashSet();
+  ~ConcurrentHashSet();
+  // size and empty do not need a lock.
+  size_t size() const { return size_; }
+  bool empty() const { return size_ == 0; }
+  // Number of slots in all shards.
+  size_t capacity() const;
+  std::mutex &lock(KEY key) const { return shards_[shardIndex(key)].lock; }
+  // Lock free.
+  KEY findKey(KEY key) const;
+  // Caller holds lock(key).
+  void insert(KEY key);
+  void erase(KEY key);
+  void clear();
+  void deleteContentsClear();
+  // Most slot groups probed to find a key.
+  int longestProbeLength() const;
+
+  class Iterator
+  {
+  public:
+    explicit Iterator(const ConcurrentHashSet *set) :
+      set_(set),
+      shard_(0),
+      slot_(0),
+      key_(nullptr)
+    {
+      findNext();
+    }
+    bool hasNext() { return key_ != nullptr; }
+    KEY next()
+    {
+      KEY key = key_;
+      slot_++;
+      findNext();
+      return key;
+    }
+
+  private:
+    void findNext();
+
+    const ConcurrentHashSet *set_;
+    size_t shard_;
+    size_t slot_;
+    KEY key_;
+  };
+
+private:
+  DISALLOW_COPY_AND_ASSIGN(ConcurrentHashSet);
+
+  struct Table
+  {
+    explicit Table(size_t group_count);
+    ~Table();
+    size_t slotCount() const { return group_count * group_width_; }
+    size_t group_count;
+    // Control bytes, one word per group.
+    std::atomic<uint64_t> *ctrls;
+    std::atomic<KEY> *keys;
+    // Full and deleted slots.
+    size_t used;
+  };
+
+  struct Shard
+  {
+    Shard() :
+      table(new Table(initial_group_count_)),
+      size(0)
+    {}
+    std::atomic<Table*> table;
+    size_t size;
+    // Tables replaced by resize that readers may still be using.
+    std::vector<Table*> retired;
+    std::mutex lock;
+  };
+
+  // Fibonacci hashing spreads the key hash over all of the bits.
+  // The high bits pick the shard and the bits below them the control
+  // byte so they are independent of the group index.
+  static uint64_t mixHash(KEY key)
+  {
+    return static_cast<uint64_t>(HASH()(key)) * 0x9e3779b97f4a7c15ULL;
+  }
+  static size_t shardIndex(KEY key)
+  {
+    return mixHash(key) >> (64 - shard_bits_);
+  }
+  static uint8_t ctrlHash(uint64_t hash)
+  {
+    return ctrl_full_ | ((hash >> (64 - shard_bits_ - 7)) & 0x7f);
+  }
+  static size_t homeGroup(uint64_t hash,
+			  const Table *table)
+  {
+    return (hash ^ (hash >> 32)) & (table->group_count - 1);
+  }
+  // Bytes of ctrl_word equal to ctrl have their high bit set in the
+  // result. Bytes above a match may also be set; the keys are compared
+  // anyway.
+  static uint64_t matchCtrl(uint64_t ctrl_word,
+			    uint8_t ctrl)
+  {
+    uint64_t x = ctrl_word ^ (ctrl * lsb_bytes_);
+    return (x - lsb_bytes_) & ~x & msb_bytes_;
+  }
+  static int matchSlot(uint64_t match)
+  {
+    return __builtin_ctzll(match) / 8;
+  }
+  static uint8_t slotCtrl(uint64_t ctrl_word,
+			  int slot)
+  {
+    return (ctrl_word >> (slot * 8)) & 0xff;
+  }
+  // Insert into a table with room for key. Caller holds the lock.
+  static void insertSlot(Table *table,
+			 KEY key,
+			 uint64_t hash);
+  void resize(Shard &shard);
+  void deleteRetired(Shard &shard);
+
+  static const size_t shard_bits_ = 6;
+  static const size_t shard_count_ = 1 << shard_bits_;
+  static const size_t group_width_ = 8;
+  static const size_t initial_group_count_ = 4;
+  static const uint8_t ctrl_empty_ = 0x00;
+  static const uint8_t ctrl_deleted_ = 0x01;
+  static const uint8_t ctrl_full_ = 0x80;
+  static const uint64_t lsb_bytes_ = 0x0101010101010101ULL;
+  static const uint64_t msb_bytes_ = 0x8080808080808080ULL;
+  mutable Shard shards_[shard_count_];
+  std::atomic<size_t> size_;
+};
+
+template <class KEY, class HASH, class EQUAL>
+ConcurrentHashSet<KEY, HASH, EQUAL>::Table::Table(size_t group_count) :
+  group_count(group_count),
+  ctrls(new std::atomic<uint64_t>[group_count]),
+  keys(new std::atomic<KEY>[group_count * group_width_]),
+  used(0)
+{
+  for (size_t i = 0; i < group_count; i++)
+    ctrls[i].store(0, std::memory_order_relaxed);
+  for (size_t i = 0; i < group_count * group_width_; i++)
+    keys[i].store(nullptr, std::memory_order_relaxed);
+}
+
+template <class KEY, class HASH, class EQUAL>
+ConcurrentHashSet<KEY, HASH, EQUAL>::Table::~Table()
+{
+  delete [] ctrls;
+  delete [] keys;
+}
+
+template <class KEY, class HASH, class EQUAL>
+ConcurrentHashSet<KEY, HASH, EQUAL>::ConcurrentHashSet() :
+  size_(0)
+{
+}
+
+template <class KEY, class HASH, class EQUAL>
+ConcurrentHashSet<KEY, HASH, EQUAL>::~ConcurrentHashSet()
+{
+  for (size_t i = 0; i < shard_count_; i++) {
+    Shard &shard = shards_[i];
+    deleteRetired(shard);
+    delete shard.table.load(std::memory_order_relaxed);
+  }
+}
+
+template <class KEY, class HASH, class EQUAL>
+size_t
+ConcurrentHashSet<KEY, HASH, EQUAL>::capacity() const
+{
+  size_t capacity = 0;
+  for (size_t i = 0; i < shard_count_; i++)
+    capacity += shards_[i].table.load(std::memory_order_acquire)->slotCount();
+  return capacity;
+}
+
+template <class KEY, class HASH, class EQUAL>
+KEY
+ConcurrentHashSet<KEY, HASH, EQUAL>::findKey(KEY key) const
+{
+  uint64_t hash = mixHash(key);
+  const Shard &shard = shards_[hash >> (64 - shard_bits_)];
+  const Table *table = shard.table.load(std::memory_order_acquire);
+  uint8_t ctrl = ctrlHash(hash);
+  size_t group_mask = table->group_count - 1;
+  for (size_t group = homeGroup(hash, table), probe = 0;
+       probe < table->group_count;
+       group = (group + 1) & group_mask, probe++) {
+    // The acquire pairs with the release in insertSlot so the keys of
+    // the full slots seen here are visible.
+    uint64_t ctrl_word = table->ctrls[group].load(std::memory_order_acquire);
+    for (uint64_t match = matchCtrl(ctrl_word, ctrl);
+	 match;
+	 match &= match - 1) {
+      int slot = matchSlot(match);
+      KEY slot_key = table->keys[group * group_width_ + slot]
+	.load(std::memory_order_relaxed);
+      if (slot_key && EQUAL()(slot_key, key))
+	return slot_key;
+    }
+    if (matchCtrl(ctrl_word, ctrl_empty_))
+      break;
+  }
+  return nullptr;
+}
+
+template <class KEY, class HASH, class EQUAL>
+void
+ConcurrentHashSet<KEY, HASH, EQUAL>::insert(KEY key)
+{
+  uint64_t hash = mixHash(key);
+  Shard &shard = shards_[hash >> (64 - shard_bits_)];
+  Table *table = shard.table.load(std::memory_order_relaxed);
+  // Keep the table at most 7/8 used so probes find an empty slot.
+  if ((table->used + 1) * 8 > table->slotCount() * 7) {
+    resize(shard);
+    table = shard.table.load(std::memory_order_relaxed);
+  }
+  insertSlot(table, key, hash);
+  shard.size++;
+  size_++;
+}
+
+template <class KEY, class HASH, class EQUAL>
+void
+ConcurrentHashSet<KEY, HASH, EQUAL>::insertSlot(Table *table,
+						KEY key,
+						uint64_t hash)
+{
+  size_t group_mask = table->group_count - 1;
+  for (size_t group = homeGroup(hash, table); ;
+       group = (group + 1) & group_mask) {
+    uint64_t ctrl_word = table->ctrls[group].load(std::memory_order_relaxed);
+    uint64_t empty = matchCtrl(ctrl_word, ctrl_empty_);
+    if (empty) {
+      int slot = matchSlot(empty);
+      table->keys[group * group_width_ + slot].store(key,
+						     std::memory_order_relaxed);
+      // Publish the control byte after the key.
+      uint64_t slot_ctrl = static_cast<uint64_t>(ctrlHash(hash)) << (slot * 8);
+      table->ctrls[group].store(ctrl_word | slot_ctrl,
+				std::memory_order_release);
+      table->used++;
+      return;
+    }
+  }
+}
+
+// Rebuild the shard table without deleted slots, doubling it if it is
+// more than half full.
+template <class KEY, class HASH, class EQUAL>
+void
+ConcurrentHashSet<KEY, HASH, EQUAL>::resize(Shard &shard)
+{
+  Table *table = shard.table.load(std::memory_order_relaxed);
+  size_t group_count = table->group_count;
+  if ((shard.size + 1) * 2 > table->slotCount())
+    group_count *= 2;
+  Table *new_table = new Table(group_count);
+  for (size_t group = 0; group < table->group_count; group++) {
+    uint64_t ctrl_word = table->ctrls[group].load(std::memory_order_relaxed);
+    for (size_t slot = 0; slot < group_width_; slot++) {
+      if (slotCtrl(ctrl_word, slot) & ctrl_full_) {
+	KEY key = table->keys[group * group_width_ + slot]
+	  .load(std::memory_order_relaxed);
+	insertSlot(new_table, key, mixHash(key));
+      }
+    }
+  }
+  shard.table.store(new_table, std::memory_order_release);
+  shard.retired.push_back(table);
+}
+
+template <class KEY, class HASH, class EQUAL>
+void
+ConcurrentHashSet<KEY, HASH, EQUAL>::deleteRetired(Shard &shard)
+{
+  for (Table *table : shard.retired)
+    delete table;
+  shard.retired.clear();
+}
+
+template <class KEY, class HASH, class EQUAL>
+void
+ConcurrentHashSet<KEY, HASH, EQUAL>::erase(KEY key)
+{
+  uint64_t hash = mixHash(key);
+  Shard &shard = shards_[hash >> (64 - shard_bits_)];
+  deleteRetired(shard);
+  Table *table = shard.table.load(std::memory_order_relaxed);
+  uint8_t ctrl = ctrlHash(hash);
+  size_t group_mask = table->group_count - 1;
+  for (size_t group = homeGroup(hash, table), probe = 0;
+       probe < table->group_count;
+       group = (group + 1) & group_mask, probe++) {
+    uint64_t ctrl_word = table->ctrls[group].load(std::memory_order_relaxed);
+    for (uint64_t match = matchCtrl(ctrl_word, ctrl);
+	 match;
+	 match &= match - 1) {
+      int slot = matchSlot(match);
+      std::atomic<KEY> &slot_key = table->keys[group * group_width_ + slot];
+      KEY key1 = slot_key.load(std::memory_order_relaxed);
+      if (key1 && EQUAL()(key1, key)) {
+	// Deleted slots keep probes for other keys going.
+	slot_key.store(nullptr, std::memory_order_relaxed);
+	uint64_t slot_mask = static_cast<uint64_t>(0xff) << (slot * 8);
+	uint64_t deleted = static_cast<uint64_t>(ctrl_deleted_) << (slot * 8);
+	table->ctrls[group].store((ctrl_word & ~slot_mask) | deleted,
+				  std::memory_order_relaxed);
+	shard.size--;
+	size_--;
+	return;
+      }
+    }
+    if (matchCtrl(ctrl_word, ctrl_empty_))
+      return;
+  }
+}
+
+template <class KEY, class HASH, class EQUAL>
+void
+ConcurrentHashSet<KEY, HASH, EQUAL>::clear()
+{
+  for (size_t i = 0; i < shard_count_; i++) {
+    Shard &shard = shards_[i];
+    deleteRetired(shard);
+    delete shard.table.load(std::memory_order_relaxed);
+    shard.table.store(new Table(initial_group_count_),
+		      std::memory_order_relaxed);
+    shard.size = 0;
+  }
+  size_ = 0;
+}
+
+template <class KEY, class HASH, class EQUAL>
+void
+ConcurrentHashSet<KEY, HASH, EQUAL>::deleteContentsClear()
+{
+  Iterator iter(this);
+  while (iter.hasNext())
+    delete iter.next();
+  clear();
+}
+
+template <class KEY, class HASH, class EQUAL>
+int
+ConcurrentHashSet<KEY, HASH, EQUAL>::longestProbeLength() const
+{
+  size_t longest = 0;
+  for (size_t i = 0; i < shard_count_; i++) {
+    const Table *table = shards_[i].table.load(std::memory_order_acquire);
+    size_t group_mask = table->group_count - 1;
+    for (size_t group = 0; group < table->group_count; group++) {
+      for (size_t slot = 0; slot < group_width_; slot++) {
+	KEY key = table->keys[group * group_width_ + slot]
+	  .load(std::memory_order_relaxed);
+	if (key) {
+	  size_t home = homeGroup(mixHash(key), table);
+	  size_t length = ((group - home) & group_mask) + 1;
+	  if (length > longest)
+	    longest = length;
+	}
+      }
+    }
+  }
+  return longest;
+}
+
+template <class KEY, class HASH, class EQUAL>
+void
+ConcurrentHashSet<KEY, HASH, EQUAL>::Iterator::findNext()
+{
+  while (shard_ < shard_count_) {
+    const Table *table =
+      set_->shards_[shard_].table.load(std::memory_order_relaxed);
+    while (slot_ < table->slotCount()) {
+      key_ = table->keys[slot_].load(std::memory_order_relaxed);
+      if (key_)
+	return;
+      slot_++;
+    }
+    shard_++;
+    slot_ = 0;
+  }
+  key_ = nullptr;
+}
+
+} // namespace
+#endif
@@ -22,6 +22,21 @@ namespace sta {
 
 bool debug_on = false;
 
+static const int debug_handle_level_zero = 0;
+
+DebugHandle::DebugHandle() :
+  name_(""),
+  level_(&debug_handle_level_zero)
+{
+}
+
+DebugHandle::DebugHandle(const char *name,
+			 const int *level) :
+  name_(name),
+  level_(level)
+{
+}
+
 Debug::Debug(Report *&report) :
   report_(report),
   debug_map_(nullptr),
@@ -42,6 +57,14 @@ Debug::~Debug()
     }
     delete debug_map_;
   }
+  DebugLevelMap::Iterator handle_iter(handle_levels_);
+  while (handle_iter.hasNext()) {
+    const char *what;
+    int *level;
+    handle_iter.next(what, level);
+    delete [] what;
+    delete level;
+  }
 }
 
 bool
@@ -72,10 +95,67 @@ Debug::level(const char *what)
   return 0;
 }
 
+DebugHandle
+Debug::handle(const char *what)
+{
+  const char *key;
+  int *handle_level;
+  bool exists;
+  handle_levels_.findKey(what, key, handle_level, exists);
+  if (!exists) {
+    char *what_cpy = new char[strlen(what) + 1];
+    strcpy(what_cpy, what);
+    key = what_cpy;
+    handle_level = new int(level(what));
+    handle_levels_[key] = handle_level;
+  }
+  return DebugHandle(key, handle_level);
+}
+
+void
+Debug::copyLevels(const Debug *debug)
+{
+  if (debug_map_) {
+    DebugMap::Iterator debug_iter(debug_map_);
+    // Delete the debug map keys.
+    while (debug_iter.hasNext()) {
+      const char *what;
+      int level;
+      debug_iter.next(what, level);
+      delete [] what;
+    }
+    debug_map_->clear();
+  }
+  if (debug->debug_map_) {
+    if (debug_map_ == nullptr)
+      debug_map_ = new DebugMap;
+    DebugMap::Iterator debug_iter(debug->debug_map_);
+    while (debug_iter.hasNext()) {
+      const char *what;
+      int level;
+      debug_iter.next(what, level);
+      char *what_cpy = new char[strlen(what) + 1];
+      strcpy(what_cpy, what);
+      (*debug_map_)[what_cpy] = level;
+    }
+  }
+  DebugLevelMap::Iterator handle_iter(handle_levels_);
+  while (handle_iter.hasNext()) {
+    const char *what;
+    int *level;
+    handle_iter.next(what, level);
+    *level = this->level(what);
+  }
+  stats_level_ = debug->stats_level_;
+}
+
 void
 Debug::setLevel(const char *what,
 		int level)
 {
+  int *handle_level = handle_levels_.findKey(what);
+  if (handle_level)
+    *handle_level = level;
   if (stringEq(what, "stats"))
     stats_level_ = level;
   else if (level == 0) {
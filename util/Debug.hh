@@ -18,6 +18,7 @@
 #define STA_DEBUG_H
 
 #include <stdarg.h>
+#include "StaConfig.hh"  // STA_DEBUG
 #include "DisallowCopyAssign.hh"
 #include "Map.hh"
 #include "StringUtil.hh"
@@ -32,7 +33,34 @@ class Pin;
 // is enabled.
 extern bool debug_on;
 
+// Builds configured with STA_DEBUG=0 compile the debug prints out.
+#if defined(STA_DEBUG) && STA_DEBUG == 0
+static constexpr bool debug_compiled = false;
+#else
+static constexpr bool debug_compiled = true;
+#endif
+
 typedef Map<const char *, int, CharPtrLess> DebugMap;
+typedef Map<const char *, int*, CharPtrLess> DebugLevelMap;
+
+// Level of one debug subsystem found once so checks in hot loops do
+// not look up the subsystem name. The level follows Debug::setLevel.
+class DebugHandle
+{
+public:
+  DebugHandle();
+  const char *name() const { return name_; }
+  bool check(int level) const { return *level_ >= level; }
+
+private:
+  DebugHandle(const char *name,
+	      const int *level);
+
+  const char *name_;
+  const int *level_;
+
+  friend class Debug;
+};
 
 class Debug
 {
@@ -41,9 +69,15 @@ public:
   ~Debug();
   bool check(const char *what,
 	     int level) const;
+  bool check(const DebugHandle &what,
+	     int level) const { return what.check(level); }
   int level(const char *what);
   void setLevel(const char *what,
 		int level);
+  // Set all of the levels to those of debug.
+  void copyLevels(const Debug *debug);
+  // Not thread safe; find handles before starting threads.
+  DebugHandle handle(const char *what);
   int statsLevel() const { return stats_level_; }
   void print(const char *fmt,
 	     ...) const
@@ -52,6 +86,8 @@ public:
 protected:
   Report *&report_;
   DebugMap *debug_map_;
+  // Levels referenced by handles.
+  DebugLevelMap handle_levels_;
   int stats_level_;
 
 private:
@@ -64,62 +100,83 @@ debugCheck(const Debug *debug,
 	   const char *what,
 	   int level)
 {
-  return debug_on && debug->check(what, level);
+  return debug_compiled && debug_on && debug->check(what, level);
+}
+
+inline bool
+debugCheck(const Debug *,
+	   const DebugHandle &what,
+	   int level)
+{
+  return debug_compiled && debug_on && what.check(level);
+}
+
+inline const char *
+debugName(const char *what)
+{
+  return what;
+}
+
+inline const char *
+debugName(const DebugHandle &what)
+{
+  return what.name();
 }
 
 // Inlining a varargs function would eval the args, which can
 // be expensive, so use macros.
+// what is a subsystem name or a DebugHandle.
 
 #define debugPrint0(debug, what, level, msg)				    \
-  if (sta::debug_on && debug->check(what, level)) { \
-    debug->print("%s: %s", what, msg); \
+  if (sta::debugCheck(debug, what, level)) { \
+    debug->print("%s: %s", sta::debugName(what), msg); \
   }
 
 #define debugPrint1(debug, what, level, fmt, arg1) \
-  if (sta::debug_on && debug->check(what, level)) { \
-    debug->print("%s: ", what); \
+  if (sta::debugCheck(debug, what, level)) { \
+    debug->print("%s: ", sta::debugName(what)); \
     debug->print(fmt, arg1); \
   }
 
 #define debugPrint2(debug, what, level, fmt, arg1, arg2) \
-  if (sta::debug_on && debug->check(what, level)) { \
-    debug->print("%s: ", what); \
+  if (sta::debugCheck(debug, what, level)) { \
+    debug->print("%s: ", sta::debugName(what)); \
     debug->print(fmt, arg1, arg2); \
   }
 
 #define debugPrint3(debug, what, level, fmt, arg1, arg2, arg3) \
-  if (sta::debug_on && debug->check(what, level)) { \
-    debug->print("%s: ", what); \
+  if (sta::debugCheck(debug, what, level)) { \
+    debug->print("%s: ", sta::debugName(what)); \
     debug->print(fmt, arg1, arg2, arg3); \
   }
 
 #define debugPrint4(debug, what, level, fmt, arg1, arg2, arg3, arg4) \
-  if (sta::debug_on && debug->check(what, level)) { \
-    debug->print("%s: ", what); \
+  if (sta::debugCheck(debug, what, level)) { \
+    debug->print("%s: ", sta::debugName(what)); \
     debug->print(fmt, arg1, arg2, arg3, arg4); \
   }
 
 #define debugPrint5(debug, what, level, fmt, arg1, arg2, arg3, arg4, arg5) \
-  if (sta::debug_on && debug->check(what, level)) { \
-    debug->print("%s: ", what); \
+  if (sta::debugCheck(debug, what, level)) { \
+    debug->print("%s: ", sta::debugName(what)); \
     debug->print(fmt, arg1, arg2, arg3, arg4, arg5); \
   }
 
 #define debugPrint6(debug,what,level,fmt,arg1,arg2,arg3,arg4,arg5,arg6) \
-  if (sta::debug_on && debug->check(what, level)) { \
-    debug->print("%s: ", what); \
+  if (sta::debugCheck(debug, what, level)) { \
+    debug->print("%s: ", sta::debugName(what)); \
     debug->print(fmt, arg1, arg2, arg3, arg4, arg5, arg6); \
   }
 
 #define debugPrint7(debug,what,level,fmt,arg1,arg2,arg3,arg4,arg5,arg6,arg7) \
-  if (sta::debug_on && debug->check(what, level)) { \
-    debug->print("%s: ", what); \
+  if (sta::debugCheck(debug, what, level)) { \
+    debug->print("%s: ", sta::debugName(what)); \
     debug->print(fmt, arg1, arg2, arg3, arg4, arg5, arg6, arg7);	\
   }
 
 #define debugPrint8(debug,what,level,fmt,arg1,arg2,arg3,arg4,arg5,arg6,arg7,arg8) \
-  if (sta::debug_on && debug->check(what, level)) { \
-    debug->print("%s: ", what); \
+  if (sta::debugCheck(debug, what, level)) { \
+    debug->print("%s: ", sta::debugName(what)); \
     debug->print(fmt, arg1, arg2, arg3, arg4, arg5, arg6, arg7, arg8);	\
   }
 
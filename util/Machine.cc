@@ -85,6 +85,12 @@ memoryUsage()
   return 0;
 }
 
+size_t
+peakMemoryUsage()
+{
+  return 0;
+}
+
 }
 
 #else // _WINDOWS
@@ -146,8 +152,8 @@ systemRunTime()
 }
 
 // rusage->ru_maxrss is not set in linux so read it from /proc.
-size_t
-memoryUsage()
+static size_t
+procStatusMemory(const char *field_name)
 {
   string proc_filename;
   stringPrint(proc_filename, "/proc/%d/status", getpid());
@@ -158,11 +164,11 @@ memoryUsage()
     char line[line_length];
     while (fgets(line, line_length, status) != nullptr) {
       char *field = strtok(line, " \t");
-      if (stringEq(field, "VmRSS:")) {
+      if (stringEq(field, field_name)) {
 	char *size = strtok(nullptr, " \t");
 	if (size) {
 	  char *ignore;
-	  // VmRSS is in kilobytes.
+	  // Sizes are in kilobytes.
 	  memory = strtol(size, &ignore, 10) * 1000;
 	  break;
 	}
@@ -173,6 +179,18 @@ memoryUsage()
   return memory;
 }
 
+size_t
+memoryUsage()
+{
+  return procStatusMemory("VmRSS:");
+}
+
+size_t
+peakMemoryUsage()
+{
+  return procStatusMemory("VmHWM:");
+}
+
 }
 
 #endif // !_WINDOWS
@@ -118,6 +118,10 @@ systemRunTime();
 size_t
 memoryUsage();
 
+// Peak memory usage (high water mark) in bytes.
+size_t
+peakMemoryUsage();
+
 #if __WORDSIZE == 64
   #define hashPtr(ptr) (reinterpret_cast<intptr_t>(ptr) >> 3)
 #else
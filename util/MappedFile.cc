@@ -0,0 +1,78 @@
+// OpenSTA, Static Timing Analyzer
+// Copyright (c) 2019, Parallax Software, Inc.
+// 
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+// 
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+// 
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+
+#include <stdio.h>
+#include "Machine.hh"
+#if !(defined(_WINDOWS) || defined(_WIN32))
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+#include "Error.hh"
+#include "MappedFile.hh"
+
+namespace sta {
+
+MappedFile::MappedFile(const char *filename) :
+  data_(nullptr),
+  size_(0),
+  mapped_(false)
+{
+#if defined(_WINDOWS) || defined(_WIN32)
+  FILE *stream = fopen(filename, "rb");
+  if (stream == nullptr)
+    throw FileNotReadable(filename);
+  fseek(stream, 0, SEEK_END);
+  size_ = ftell(stream);
+  fseek(stream, 0, SEEK_SET);
+  data_ = new char[size_];
+  size_ = fread(data_, 1, size_, stream);
+  fclose(stream);
+#else
+  int fd = open(filename, O_RDONLY);
+  if (fd < 0)
+    throw FileNotReadable(filename);
+  struct stat file_stat;
+  if (fstat(fd, &file_stat) == 0 && file_stat.st_size > 0) {
+    size_ = file_stat.st_size;
+    void *data = mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (data != MAP_FAILED) {
+      data_ = static_cast<char*>(data);
+      mapped_ = true;
+      // Readers go through the file front to back.
+      madvise(data, size_, MADV_SEQUENTIAL);
+    }
+    else
+      size_ = 0;
+  }
+  close(fd);
+#endif
+}
+
+MappedFile::~MappedFile()
+{
+#if !(defined(_WINDOWS) || defined(_WIN32))
+  if (mapped_) {
+    munmap(data_, size_);
+    return;
+  }
+#endif
+  delete [] data_;
+}
+
+} // namespace
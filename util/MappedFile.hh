@@ -0,0 +1,46 @@
+// OpenSTA, Static Timing Analyzer
+// Copyright (c) 2019, Parallax Software, Inc.
+// 
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+// 
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+// 
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+
+#ifndef STA_MAPPED_FILE_H
+#define STA_MAPPED_FILE_H
+
+#include <stddef.h>  // size_t
+#include "DisallowCopyAssign.hh"
+
+namespace sta {
+
+// Read only contents of a file that is memory mapped where mmap is
+// available and read into memory otherwise.
+class MappedFile
+{
+public:
+  // Throws FileNotReadable if filename cannot be read.
+  explicit MappedFile(const char *filename);
+  ~MappedFile();
+  const char *data() const { return data_; }
+  size_t size() const { return size_; }
+
+private:
+  DISALLOW_COPY_AND_ASSIGN(MappedFile);
+
+  char *data_;
+  size_t size_;
+  bool mapped_;
+};
+
+} // namespace
+#endif
@@ -0,0 +1,110 @@
+// OpenSTA, Static Timing Analyzer
+// Copyright (c) 2019, Parallax Software, Inc.
+// 
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+// 
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+// 
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#include "Machine.hh"
+#if defined(__linux__)
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#endif
+#include "MemoryPolicy.hh"
+
+namespace sta {
+
+static MemoryPolicy memory_policy = MemoryPolicy::standard;
+
+static const size_t huge_page_bytes = 2 * 1024 * 1024;
+
+void
+setMemoryPolicy(MemoryPolicy policy)
+{
+  memory_policy = policy;
+}
+
+MemoryPolicy
+memoryPolicy()
+{
+  return memory_policy;
+}
+
+#if defined(__linux__)
+
+static size_t
+policyPagesBytes(size_t bytes)
+{
+  return (bytes + huge_page_bytes - 1) / huge_page_bytes * huge_page_bytes;
+}
+
+// From linux/mempolicy.h, which libc does not wrap.
+static const int mpol_interleave = 3;
+
+void *
+allocatePolicyPages(size_t bytes)
+{
+  if (memory_policy == MemoryPolicy::standard
+      || bytes < huge_page_bytes)
+    return nullptr;
+  size_t pages_bytes = policyPagesBytes(bytes);
+  // Map an extra huge page so the pages can be aligned to it.
+  size_t map_bytes = pages_bytes + huge_page_bytes;
+  void *map = mmap(nullptr, map_bytes, PROT_READ | PROT_WRITE,
+		   MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  if (map == MAP_FAILED)
+    return nullptr;
+  char *map_begin = static_cast<char*>(map);
+  char *pages = reinterpret_cast<char*>
+    ((reinterpret_cast<size_t>(map_begin) + huge_page_bytes - 1)
+     / huge_page_bytes * huge_page_bytes);
+  char *map_end = map_begin + map_bytes;
+  if (pages > map_begin)
+    munmap(map_begin, pages - map_begin);
+  if (map_end > pages + pages_bytes)
+    munmap(pages + pages_bytes, map_end - (pages + pages_bytes));
+  // Placement is advisory, so failures leave the pages as mapped.
+  madvise(pages, pages_bytes, MADV_HUGEPAGE);
+  if (memory_policy == MemoryPolicy::interleave) {
+    // All nodes; the kernel limits them to the nodes with memory.
+    unsigned long node_mask = ~0UL;
+    syscall(SYS_mbind, pages, pages_bytes, mpol_interleave,
+	    &node_mask, sizeof(node_mask) * 8 + 1, 0);
+  }
+  return pages;
+}
+
+void
+freePolicyPages(void *pages,
+		size_t bytes)
+{
+  munmap(pages, policyPagesBytes(bytes));
+}
+
+#else
+
+void *
+allocatePolicyPages(size_t)
+{
+  return nullptr;
+}
+
+void
+freePolicyPages(void *,
+		size_t)
+{
+}
+
+#endif
+
+} // namespace
@@ -0,0 +1,48 @@
+// OpenSTA, Static Timing Analyzer
+// Copyright (c) 2019, Parallax Software, Inc.
+// 
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+// 
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+// 
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#ifndef STA_MEMORY_POLICY_H
+#define STA_MEMORY_POLICY_H
+
+#include <stddef.h>  // size_t
+
+namespace sta {
+
+// Placement of large pool blocks (graph vertices, edges, slews and
+// arc delays).
+//  standard    heap, pages first touched by the thread that builds
+//              the pool
+//  huge_pages  transparent huge pages
+//  interleave  huge pages interleaved across the NUMA nodes
+enum class MemoryPolicy { standard, huge_pages, interleave };
+
+// Blocks already allocated keep their placement.
+void
+setMemoryPolicy(MemoryPolicy policy);
+MemoryPolicy
+memoryPolicy();
+
+// Map bytes following the memory policy.
+// Returns nullptr for the standard policy, blocks smaller than a huge
+// page or when the pages cannot be mapped, and the caller uses the heap.
+void *
+allocatePolicyPages(size_t bytes);
+void
+freePolicyPages(void *pages,
+		size_t bytes);
+
+} // namespace
+#endif
@@ -0,0 +1,126 @@
+// OpenSTA, Static Timing Analyzer
+// Copyright (c) 2019, Parallax Software, Inc.
+// 
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+// 
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+// 
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+
+#include "Machine.hh"
+#include "Report.hh"
+#include "MemoryReport.hh"
+
+namespace sta {
+
+MemoryReport::MemoryReport(Report *report,
+			   bool json) :
+  report_(report),
+  json_(json),
+  first_subsystem_(true),
+  subsystem_open_(false),
+  subsystem_total_(0),
+  total_(0)
+{
+  if (json_)
+    report_->print("{\"subsystems\": [");
+  else {
+    report_->print("Subsystem    Object                    Count         MB\n");
+    report_->print("-------------------------------------------------------\n");
+  }
+}
+
+void
+MemoryReport::reportUsage(const char *subsystem,
+			  const char *what,
+			  size_t count,
+			  size_t bytes)
+{
+  if (json_) {
+    if (subsystem_open_)
+      report_->print(",");
+    else
+      beginJsonSubsystem(subsystem);
+    report_->print("\n    {\"name\": \"%s\", \"count\": %lu, \"bytes\": %lu}",
+		   what,
+		   static_cast<unsigned long>(count),
+		   static_cast<unsigned long>(bytes));
+  }
+  else
+    report_->print("%-12s %-20s %10lu %10.2f\n",
+		   subsystem,
+		   what,
+		   static_cast<unsigned long>(count),
+		   bytes * 1e-6);
+  subsystem_total_ += bytes;
+  total_ += bytes;
+}
+
+void
+MemoryReport::beginJsonSubsystem(const char *subsystem)
+{
+  report_->print("%s\n  {\"name\": \"%s\", \"objects\": [",
+		 first_subsystem_ ? "" : ",",
+		 subsystem);
+  first_subsystem_ = false;
+  subsystem_open_ = true;
+}
+
+void
+MemoryReport::reportSubsystemTotal(const char *subsystem)
+{
+  if (json_) {
+    if (subsystem_open_)
+      report_->print("\n  ]");
+    else {
+      // Subsystem without objects.
+      beginJsonSubsystem(subsystem);
+      report_->print("]");
+    }
+    report_->print(", \"bytes\": %lu}",
+		   static_cast<unsigned long>(subsystem_total_));
+    subsystem_open_ = false;
+  }
+  else {
+    report_->print("%-12s %-20s %10s %10.2f\n",
+		   subsystem,
+		   "total",
+		   "",
+		   subsystem_total_ * 1e-6);
+    report_->print("\n");
+  }
+  subsystem_total_ = 0;
+}
+
+void
+MemoryReport::reportTotal()
+{
+  if (json_)
+    report_->print("\n],\n\"bytes\": %lu, \"process_bytes\": %lu, \"peak_process_bytes\": %lu}\n",
+		   static_cast<unsigned long>(total_),
+		   static_cast<unsigned long>(memoryUsage()),
+		   static_cast<unsigned long>(peakMemoryUsage()));
+  else {
+    report_->print("-------------------------------------------------------\n");
+    report_->print("%-12s %-20s %10s %10.2f\n",
+		   "Total",
+		   "",
+		   "",
+		   total_ * 1e-6);
+    report_->print("%-12s %-20s %10s %10.2f\n",
+		   "Process",
+		   "",
+		   "",
+		   memoryUsage() * 1e-6);
+  }
+}
+
+} // namespace
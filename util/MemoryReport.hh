@@ -0,0 +1,67 @@
+// OpenSTA, Static Timing Analyzer
+// Copyright (c) 2019, Parallax Software, Inc.
+// 
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+// 
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+// 
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+
+#ifndef STA_MEMORY_REPORT_H
+#define STA_MEMORY_REPORT_H
+
+#include <stddef.h>  // size_t
+#include "DisallowCopyAssign.hh"
+
+namespace sta {
+
+class Report;
+
+// Accumulate and report estimated memory usage by subsystem.
+// The estimates count the objects allocated by each subsystem
+// using sizeof and approximate container overhead.
+// With json=true the report is a json object with the objects and
+// total bytes of each subsystem.
+class MemoryReport
+{
+public:
+  explicit MemoryReport(Report *report,
+			bool json = false);
+  // Report count objects of type what using bytes of memory.
+  void reportUsage(const char *subsystem,
+		   const char *what,
+		   size_t count,
+		   size_t bytes);
+  // Report the subsystem total and start a new subsystem.
+  void reportSubsystemTotal(const char *subsystem);
+  void reportTotal();
+  size_t total() const { return total_; }
+
+  // Approximate overhead of a node based (std::map/std::set) container entry.
+  static constexpr size_t map_node_bytes = 4 * sizeof(void*);
+  // Approximate overhead of a hashed container entry.
+  static constexpr size_t hash_node_bytes = 2 * sizeof(void*);
+
+private:
+  DISALLOW_COPY_AND_ASSIGN(MemoryReport);
+  void beginJsonSubsystem(const char *subsystem);
+
+  Report *report_;
+  bool json_;
+  bool first_subsystem_;
+  // True after the first object of a json subsystem is reported.
+  bool subsystem_open_;
+  size_t subsystem_total_;
+  size_t total_;
+};
+
+} // namespace
+#endif
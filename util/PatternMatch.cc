@@ -93,6 +93,15 @@ PatternMatch::hasWildcards() const
     return patternWildcards(pattern_);
 }
 
+size_t
+PatternMatch::literalPrefixLength() const
+{
+  if (is_regexp_ || nocase_)
+    return 0;
+  else
+    return strcspn(pattern_, "*?");
+}
+
 bool
 PatternMatch::match(const char *str) const
 {
@@ -17,6 +17,7 @@
 #ifndef STA_PATTERN_MATCH_H
 #define STA_PATTERN_MATCH_H
 
+#include <stddef.h>  // size_t
 #include "DisallowCopyAssign.hh"
 #include "Error.hh"
 
@@ -52,6 +53,9 @@ public:
   bool nocase() const { return nocase_; }
   Tcl_Interp *tclInterp() const { return interp_; }
   bool hasWildcards() const;
+  // Length of the literal prefix before the first wildcard that every
+  // match starts with.  Zero for regular expressions and nocase patterns.
+  size_t literalPrefixLength() const;
 
 private:
   DISALLOW_COPY_AND_ASSIGN(PatternMatch);
@@ -19,8 +19,10 @@
 
 #include <stddef.h>
 #include <algorithm> // max
+#include <new>
 #include "DisallowCopyAssign.hh"
 #include "Error.hh"
+#include "MemoryPolicy.hh"
 #include "Vector.hh"
 #include "ObjectIndex.hh"
 
@@ -30,24 +32,28 @@ using std::max;
 
 typedef Vector<ObjectIndex> DeletedListHeads;
 
+// Blocks big enough for huge pages are placed by the memory policy.
 template <class OBJ>
 class PoolBlock
 {
 public:
   explicit PoolBlock(ObjectIndex size,
 		     ObjectIndex begin_index);
+  ~PoolBlock();
   OBJ *makeObject();
   OBJ *makeObjects(ObjectIndex count);
   ObjectIndex index(const OBJ *object);
   OBJ *find(ObjectIndex index);
   PoolBlock *nextBlock() const { return next_block_; }
   void setNextBlock(PoolBlock *next);
-  ObjectIndex size() const { return objects_.size(); }
+  ObjectIndex size() const { return size_; }
 
 private:
   DISALLOW_COPY_AND_ASSIGN(PoolBlock);
 
-  std::vector<OBJ> objects_;
+  OBJ *objects_;
+  ObjectIndex size_;
+  bool policy_pages_;
   ObjectIndex begin_index_;
   ObjectIndex next_free_;
   PoolBlock *next_block_;
@@ -57,18 +63,37 @@ private:
 template <class OBJ>
 PoolBlock<OBJ>::PoolBlock(ObjectIndex size,
 			  ObjectIndex begin_index) :
-  objects_(size),
+  size_(size),
   begin_index_(begin_index),
   next_free_(0),
   next_block_(nullptr)
 {
+  size_t bytes = size * sizeof(OBJ);
+  void *memory = allocatePolicyPages(bytes);
+  policy_pages_ = (memory != nullptr);
+  if (memory == nullptr)
+    memory = ::operator new(bytes);
+  objects_ = static_cast<OBJ*>(memory);
+  for (ObjectIndex i = 0; i < size; i++)
+    new (objects_ + i) OBJ();
+}
+
+template <class OBJ>
+PoolBlock<OBJ>::~PoolBlock()
+{
+  for (ObjectIndex i = 0; i < size_; i++)
+    objects_[i].~OBJ();
+  if (policy_pages_)
+    freePolicyPages(objects_, size_ * sizeof(OBJ));
+  else
+    ::operator delete(objects_);
 }
 
 template <class OBJ>
 OBJ *
 PoolBlock<OBJ>::makeObject()
 {
-  if (next_free_ < objects_.size())
+  if (next_free_ < size_)
     return &objects_[next_free_++];
   else
     return nullptr;
@@ -78,7 +103,7 @@ template <class OBJ>
 OBJ *
 PoolBlock<OBJ>::makeObjects(ObjectIndex count)
 {
-  if ((next_free_ + count - 1) < objects_.size()) {
+  if ((next_free_ + count - 1) < size_) {
     OBJ *object = &objects_[next_free_];
     next_free_ += count;
     return object;
@@ -91,9 +116,9 @@ template <class OBJ>
 ObjectIndex
 PoolBlock<OBJ>::index(const OBJ *object)
 {
-  if (object >= &objects_[0] && object < &objects_[objects_.size()])
+  if (object >= objects_ && object < objects_ + size_)
     // Index==0 is reserved.
-    return begin_index_ + object - &objects_[0] + 1;
+    return begin_index_ + object - objects_ + 1;
   else
     return 0;
 }
@@ -105,7 +130,7 @@ PoolBlock<OBJ>::find(ObjectIndex index)
   // Index==0 is reserved.
   ObjectIndex index1 = index - 1;
   if (index1 >= begin_index_
-      && index1 < begin_index_ + objects_.size())
+      && index1 < begin_index_ + size_)
     return &objects_[index1 - begin_index_];
   else
     return nullptr;
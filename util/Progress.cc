@@ -0,0 +1,120 @@
+// OpenSTA, Static Timing Analyzer
+// Copyright (c) 2019, Parallax Software, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#include <limits>
+#include "Machine.hh"
+#include "Report.hh"
+#include "Progress.hh"
+
+namespace sta {
+
+static double progress_interval = 0.0;
+
+// Objects counted between clock checks.
+static const size_t progress_check_stride = 256;
+static const size_t progress_check_stride_max = 1 << 20;
+
+void
+setProgressInterval(double seconds)
+{
+  progress_interval = seconds;
+}
+
+double
+progressInterval()
+{
+  return progress_interval;
+}
+
+Progress::Progress(const char *step,
+		   const char *units,
+		   Report *report) :
+  step_(step),
+  units_(units),
+  report_(report),
+  interval_(report ? progress_interval : 0.0),
+  begin_time_(0.0),
+  next_report_time_(0.0),
+  last_check_time_(0.0),
+  count_(0),
+  next_check_(std::numeric_limits<size_t>::max()),
+  check_stride_(progress_check_stride),
+  level_(0),
+  level_count_(0),
+  reported_(false)
+{
+  if (interval_ > 0.0) {
+    begin_time_ = elapsedRunTime();
+    next_report_time_ = begin_time_ + interval_;
+    last_check_time_ = begin_time_;
+    next_check_ = check_stride_;
+  }
+}
+
+Progress::~Progress()
+{
+  if (reported_)
+    report(elapsedRunTime());
+}
+
+void
+Progress::setLevel(size_t level,
+		   size_t level_count)
+{
+  level_ = level;
+  level_count_ = level_count;
+  if (interval_ > 0.0)
+    check();
+}
+
+// Adapt the stride so the clock is read a few times per interval
+// whatever rate objects are counted at.
+void
+Progress::check()
+{
+  double now = elapsedRunTime();
+  if (now >= next_report_time_) {
+    report(now);
+    next_report_time_ = now + interval_;
+    reported_ = true;
+  }
+  double check_delta = now - last_check_time_;
+  if (check_delta < interval_ * 0.05
+      && check_stride_ < progress_check_stride_max)
+    check_stride_ *= 2;
+  else if (check_delta > interval_ * 0.25
+	   && check_stride_ > 1)
+    check_stride_ /= 2;
+  last_check_time_ = now;
+  next_check_ = count_ + check_stride_;
+}
+
+void
+Progress::report(double now)
+{
+  double elapsed = now - begin_time_;
+  double rate = (elapsed > 0.0) ? count_ / elapsed : 0.0;
+  double rss = memoryUsage() * 1e-6;
+  if (level_count_ > 0)
+    report_->print("Progress %s: level %zu/%zu %zu %s %.0f/s rss %.0fMB %.1fs\n",
+		   step_, level_, level_count_, count_, units_, rate, rss,
+		   elapsed);
+  else
+    report_->print("Progress %s: %zu %s %.0f/s rss %.0fMB %.1fs\n",
+		   step_, count_, units_, rate, rss, elapsed);
+}
+
+} // namespace
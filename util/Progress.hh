@@ -0,0 +1,80 @@
+// OpenSTA, Static Timing Analyzer
+// Copyright (c) 2019, Parallax Software, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#ifndef STA_PROGRESS_H
+#define STA_PROGRESS_H
+
+#include <stddef.h>  // size_t
+#include "DisallowCopyAssign.hh"
+
+namespace sta {
+
+class Report;
+
+// Seconds between progress messages for long running steps.
+// Zero (the default) disables progress messages.
+void
+setProgressInterval(double seconds);
+double
+progressInterval();
+
+// Periodic progress messages for a step such as reading a netlist or
+// a timing update pass.
+//  Progress read_spef: 1200000 nets 410000/s rss 5120MB 3.1s
+//  Progress arrival search: level 120/400 8000000 vertices 2100000/s rss 9800MB 7.0s
+// incr is an add and compare between checks of the clock so it can be
+// called for every object. Progress is not thread safe; call it from
+// the thread that runs the step. Progress without a report is disabled.
+class Progress
+{
+public:
+  Progress(const char *step,
+	   const char *units,
+	   Report *report);
+  // Reports the final count if any progress was reported.
+  ~Progress();
+  void incr(size_t count = 1)
+  {
+    count_ += count;
+    if (count_ >= next_check_)
+      check();
+  }
+  // Levels finished by a levelized pass.
+  void setLevel(size_t level,
+		size_t level_count);
+
+private:
+  DISALLOW_COPY_AND_ASSIGN(Progress);
+  void check();
+  void report(double now);
+
+  const char *step_;
+  const char *units_;
+  Report *report_;
+  double interval_;
+  double begin_time_;
+  double next_report_time_;
+  double last_check_time_;
+  size_t count_;
+  size_t next_check_;
+  size_t check_stride_;
+  size_t level_;
+  size_t level_count_;
+  bool reported_;
+};
+
+} // namespace
+#endif
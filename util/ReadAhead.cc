@@ -0,0 +1,109 @@
+// OpenSTA, Static Timing Analyzer
+// Copyright (c) 2019, Parallax Software, Inc.
+// 
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+// 
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+// 
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#include <algorithm>
+#include <string.h>
+#include "Machine.hh"
+#include "ReadAhead.hh"
+
+namespace sta {
+
+ReadAhead::ReadAhead(gzFile stream) :
+  stream_(stream),
+  full_count_(0),
+  read_block_(0),
+  read_offset_(0),
+  write_block_(0),
+  eof_(false),
+  stop_(false)
+{
+  for (int i = 0; i < block_count; i++) {
+    blocks_[i] = new char[block_size];
+    block_lengths_[i] = 0;
+  }
+  thread_ = std::thread(&ReadAhead::fill, this);
+}
+
+ReadAhead::~ReadAhead()
+{
+  {
+    std::unique_lock<std::mutex> lock(lock_);
+    stop_ = true;
+  }
+  empty_cond_.notify_one();
+  thread_.join();
+  for (int i = 0; i < block_count; i++)
+    delete [] blocks_[i];
+}
+
+void
+ReadAhead::fill()
+{
+  while (true) {
+    {
+      std::unique_lock<std::mutex> lock(lock_);
+      while (full_count_ == block_count && !stop_)
+	empty_cond_.wait(lock);
+      if (stop_)
+	break;
+    }
+    // The reader does not touch write_block_ until it is full.
+    char *block = blocks_[write_block_];
+    int length = gzread(stream_, block, block_size);
+    {
+      std::unique_lock<std::mutex> lock(lock_);
+      if (length <= 0)
+	eof_ = true;
+      else {
+	block_lengths_[write_block_] = length;
+	write_block_ = (write_block_ + 1) % block_count;
+	full_count_++;
+      }
+    }
+    full_cond_.notify_one();
+    if (length <= 0)
+      break;
+  }
+}
+
+size_t
+ReadAhead::read(char *buf,
+		size_t max_size)
+{
+  {
+    std::unique_lock<std::mutex> lock(lock_);
+    while (full_count_ == 0 && !eof_)
+      full_cond_.wait(lock);
+    if (full_count_ == 0)
+      return 0;
+  }
+  size_t length = block_lengths_[read_block_];
+  size_t count = std::min(max_size, length - read_offset_);
+  memcpy(buf, blocks_[read_block_] + read_offset_, count);
+  read_offset_ += count;
+  if (read_offset_ == length) {
+    {
+      std::unique_lock<std::mutex> lock(lock_);
+      read_block_ = (read_block_ + 1) % block_count;
+      read_offset_ = 0;
+      full_count_--;
+    }
+    empty_cond_.notify_one();
+  }
+  return count;
+}
+
+} // namespace
@@ -0,0 +1,68 @@
+// OpenSTA, Static Timing Analyzer
+// Copyright (c) 2019, Parallax Software, Inc.
+// 
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+// 
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+// 
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#ifndef STA_READ_AHEAD_H
+#define STA_READ_AHEAD_H
+
+#include <stddef.h>  // size_t
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include "DisallowCopyAssign.hh"
+#include "Zlib.hh"
+
+namespace sta {
+
+// Read (and uncompress) a stream in a separate thread ahead of a
+// parser so that reading the file overlaps with scanning it.
+// Used by ScanInput for compressed files.
+// The stream must stay open until the ReadAhead is deleted.
+class ReadAhead
+{
+public:
+  explicit ReadAhead(gzFile stream);
+  ~ReadAhead();
+  // Copy up to max_size chars into buf.
+  // Returns the number of chars copied, 0 at the end of the stream.
+  size_t read(char *buf,
+	      size_t max_size);
+
+private:
+  DISALLOW_COPY_AND_ASSIGN(ReadAhead);
+  void fill();
+
+  static const int block_count = 4;
+  static const size_t block_size = 1 << 20;
+
+  gzFile stream_;
+  char *blocks_[block_count];
+  size_t block_lengths_[block_count];
+  // Blocks [read_block_, read_block_ + full_count_) are filled
+  // and owned by the reader.  The rest are owned by fill().
+  int full_count_;
+  int read_block_;
+  size_t read_offset_;
+  int write_block_;
+  bool eof_;
+  bool stop_;
+  std::mutex lock_;
+  std::condition_variable full_cond_;
+  std::condition_variable empty_cond_;
+  std::thread thread_;
+};
+
+} // namespace
+#endif
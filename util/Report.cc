@@ -23,19 +23,28 @@ namespace sta {
 
 using std::min;
 
+const size_t Report::console_buffer_size_ = 1 << 16;
+const size_t Report::redirect_buffer_size_ = 1 << 20;
+
 Report::Report() :
   log_stream_(nullptr),
   redirect_stream_(nullptr),
   redirect_to_string_(false),
   buffer_size_(1000),
   buffer_(new char[buffer_size_]),
-  buffer_length_(0)
+  buffer_length_(0),
+  buffer_console_(false),
+  redirect_buffer_(nullptr)
 {
 }
 
 Report::~Report()
 {
+  // Derived classes flush because printConsole is gone by now.
+  if (redirect_stream_)
+    fclose(redirect_stream_);
   delete [] buffer_;
+  delete [] redirect_buffer_;
 }
 
 void
@@ -63,6 +72,11 @@ Report::printString(const char *buffer, size_t length)
   else {
     if (redirect_stream_)
       ret = min(ret, fwrite(buffer, sizeof(char), length, redirect_stream_));
+    else if (buffer_console_) {
+      console_buffer_.append(buffer, length);
+      if (console_buffer_.size() >= console_buffer_size_)
+	flush();
+    }
     else
       ret = min(ret, printConsole(buffer, length));
     if (log_stream_)
@@ -71,6 +85,30 @@ Report::printString(const char *buffer, size_t length)
   return ret;
 }
 
+void
+Report::bufferBegin()
+{
+  if (console_buffer_.capacity() < console_buffer_size_)
+    console_buffer_.reserve(console_buffer_size_ * 2);
+  buffer_console_ = true;
+}
+
+void
+Report::bufferEnd()
+{
+  flush();
+  buffer_console_ = false;
+}
+
+void
+Report::flush()
+{
+  if (!console_buffer_.empty()) {
+    printConsole(console_buffer_.c_str(), console_buffer_.size());
+    console_buffer_.clear();
+  }
+}
+
 void
 Report::print(const string *str)
 {
@@ -108,8 +146,11 @@ Report::printError(const char *buffer, size_t length)
   else {
     if (redirect_stream_)
       ret = min(ret, fwrite(buffer, sizeof(char), length, redirect_stream_));
-    else
+    else {
+      // Keep errors after the output that preceded them.
+      flush();
       ret = min(ret, printErrorConsole(buffer, length));
+    }
     if (log_stream_)
       ret = min(ret, fwrite(buffer, sizeof(char), length, log_stream_));
   }
@@ -251,17 +292,32 @@ Report::logEnd()
 void
 Report::redirectFileBegin(const char *filename)
 {
+  flush();
   redirect_stream_ = fopen(filename, "w");
   if (redirect_stream_ == nullptr)
     throw FileNotWritable(filename);
+  redirectStreamBuffer();
 }
 
 void
 Report::redirectFileAppendBegin(const char *filename)
 {
+  flush();
   redirect_stream_ = fopen(filename, "a");
   if (redirect_stream_ == nullptr)
     throw FileNotWritable(filename);
+  redirectStreamBuffer();
+}
+
+// Redirected output is written straight to the file rather than
+// through Tcl, so give it a buffer big enough that large reports
+// turn into large writes.
+void
+Report::redirectStreamBuffer()
+{
+  if (redirect_buffer_ == nullptr)
+    redirect_buffer_ = new char[redirect_buffer_size_];
+  setvbuf(redirect_stream_, redirect_buffer_, _IOFBF, redirect_buffer_size_);
 }
 
 void
@@ -275,6 +331,7 @@ Report::redirectFileEnd()
 void
 Report::redirectStringBegin()
 {
+  flush();
   redirect_to_string_ = true;
   redirect_string_.clear();
 }
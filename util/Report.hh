@@ -94,6 +94,15 @@ public:
   virtual const char *redirectStringEnd();
   virtual void setTclInterp(Tcl_Interp *) {}
 
+  // Collect console output in a large buffer until bufferEnd so
+  // long reports are written in a few large blocks.
+  // Errors, warnings and redirection changes flush the buffer first
+  // so output stays in order.
+  void bufferBegin();
+  void bufferEnd();
+  // Write buffered console output.
+  void flush();
+
 protected:
   // Primitive to print output on the console.
   // Return the number of characters written.
@@ -103,6 +112,7 @@ protected:
   virtual size_t printErrorConsole(const char *buffer, size_t length) = 0;
   void printToBuffer(const char *fmt, va_list args);
   void redirectStringPrint(const char *buffer, size_t length);
+  void redirectStreamBuffer();
 
   FILE *log_stream_;
   FILE *redirect_stream_;
@@ -113,6 +123,12 @@ protected:
   char *buffer_;
   // Length of string in buffer.
   size_t buffer_length_;
+  bool buffer_console_;
+  string console_buffer_;
+  // Large stdio buffer for redirect_stream_.
+  char *redirect_buffer_;
+  static const size_t console_buffer_size_;
+  static const size_t redirect_buffer_size_;
 
 private:
   DISALLOW_COPY_AND_ASSIGN(Report);
@@ -28,6 +28,7 @@ class ReportStd : public Report
 {
 public:
   ReportStd();
+  virtual ~ReportStd();
 
 protected:
   virtual size_t printConsole(const char *buffer, size_t length);
@@ -48,6 +49,11 @@ ReportStd::ReportStd() :
 {
 }
 
+ReportStd::~ReportStd()
+{
+  flush();
+}
+
 size_t
 ReportStd::printConsole(const char *buffer, size_t length)
 {
@@ -275,6 +275,7 @@ ReportTcl::ReportTcl() :
 
 ReportTcl::~ReportTcl()
 {
+  flush();
   tcl_encap_stdout_ = nullptr;
   tcl_encap_stderr_ = nullptr;
   Tcl_UnstackChannel(interp_, tcl_stdout_);
@@ -401,6 +402,8 @@ encapErrorOutputProc(ClientData instanceData, CONST84 char *buf, int toWrite,
 		     int *)
 {
   ReportTcl *report = reinterpret_cast<ReportTcl*>(instanceData);
+  // Tcl errors can abort a buffered report before bufferEnd.
+  report->bufferEnd();
   return static_cast<int>(report->printString(buf, toWrite));
 }
 
@@ -0,0 +1,94 @@
+// OpenSTA, Static Timing Analyzer
+// Copyright (c) 2019, Parallax Software, Inc.
+// 
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+// 
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+// 
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#include <algorithm>
+#include <string.h>
+#include "Machine.hh"
+#include "Error.hh"
+#include "MappedFile.hh"
+#include "ReadAhead.hh"
+#include "ScanInput.hh"
+
+namespace sta {
+
+ScanInput::ScanInput(const char *filename,
+		     bool read_ahead) :
+  stream_(nullptr),
+  read_ahead_(nullptr),
+  mapped_(nullptr),
+  data_(nullptr),
+  size_(0),
+  offset_(0)
+{
+  // Use zlib to uncompress gzip'd files automagically.
+  stream_ = gzopen(filename, "rb");
+  if (stream_ == nullptr)
+    throw FileNotReadable(filename);
+  if (gzdirect(stream_)) {
+    // Not compressed.
+    gzclose(stream_);
+    stream_ = nullptr;
+    mapped_ = new MappedFile(filename);
+    data_ = mapped_->data();
+    size_ = mapped_->size();
+  }
+  else if (read_ahead)
+    read_ahead_ = new ReadAhead(stream_);
+}
+
+ScanInput::ScanInput(const char *data,
+		     size_t size) :
+  stream_(nullptr),
+  read_ahead_(nullptr),
+  mapped_(nullptr),
+  data_(data),
+  size_(size),
+  offset_(0)
+{
+}
+
+ScanInput::~ScanInput()
+{
+  // Stop the read ahead thread before the stream is closed.
+  delete read_ahead_;
+  delete mapped_;
+  if (stream_)
+    gzclose(stream_);
+}
+
+size_t
+ScanInput::read(char *buf,
+		size_t max_size)
+{
+  if (stream_ == nullptr) {
+    size_t count = std::min(max_size, size_ - offset_);
+    if (count > 0)
+      memcpy(buf, data_ + offset_, count);
+    offset_ += count;
+    return count;
+  }
+  else if (read_ahead_)
+    return read_ahead_->read(buf, max_size);
+  else {
+    char *status = gzgets(stream_, buf, max_size);
+    if (status == Z_NULL)
+      return 0;  // YY_nullptr
+    else
+      return strlen(buf);
+  }
+}
+
+} // namespace
@@ -0,0 +1,62 @@
+// OpenSTA, Static Timing Analyzer
+// Copyright (c) 2019, Parallax Software, Inc.
+// 
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+// 
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+// 
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#ifndef STA_SCAN_INPUT_H
+#define STA_SCAN_INPUT_H
+
+#include <stddef.h>  // size_t
+#include "DisallowCopyAssign.hh"
+#include "Zlib.hh"
+
+namespace sta {
+
+class MappedFile;
+class ReadAhead;
+
+// Characters for a flex scanner (YY_INPUT) from a file that may be
+// gzip'd. Uncompressed files are memory mapped and copied to the
+// scanner buffer in blocks without going through zlib.
+// Compressed files are uncompressed by a ReadAhead thread when
+// read_ahead is true and a line at a time with gzgets otherwise.
+class ScanInput
+{
+public:
+  // Throws FileNotReadable if filename cannot be read.
+  ScanInput(const char *filename,
+	    bool read_ahead);
+  // Characters in memory owned by the caller.
+  ScanInput(const char *data,
+	    size_t size);
+  ~ScanInput();
+  // Copy up to max_size chars into buf.
+  // Returns the number of chars copied, 0 at the end of the file.
+  size_t read(char *buf,
+	      size_t max_size);
+
+private:
+  DISALLOW_COPY_AND_ASSIGN(ScanInput);
+
+  gzFile stream_;
+  ReadAhead *read_ahead_;
+  MappedFile *mapped_;
+  // Mapped file or caller characters.
+  const char *data_;
+  size_t size_;
+  size_t offset_;
+};
+
+} // namespace
+#endif
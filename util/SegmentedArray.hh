@@ -0,0 +1,106 @@
+// OpenSTA, Static Timing Analyzer
+// Copyright (c) 2019, Parallax Software, Inc.
+// 
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+// 
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+// 
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#ifndef STA_SEGMENTED_ARRAY_H
+#define STA_SEGMENTED_ARRAY_H
+
+#include <stddef.h>  // size_t
+#include <atomic>
+#include "DisallowCopyAssign.hh"
+
+namespace sta {
+
+// Table of object pointers indexed by 0...index_max that grows one
+// fixed size segment at a time.  Segments never move, so finding an
+// index that has been set is safe while other threads set other
+// indices and grow the table.  Unset indices are nullptr.
+template <class OBJ>
+class SegmentedArray
+{
+public:
+  explicit SegmentedArray(size_t index_max);
+  ~SegmentedArray();
+  OBJ *operator[](size_t index) const
+  {
+    OBJ **segment = segments_[index >> segment_bits_].load(std::memory_order_acquire);
+    return segment ? segment[index & segment_mask_] : nullptr;
+  }
+  // Thread safe for different indices.
+  void set(size_t index,
+	   OBJ *obj);
+  // Number of allocated entries.
+  size_t capacity() const;
+
+private:
+  DISALLOW_COPY_AND_ASSIGN(SegmentedArray);
+
+  static const size_t segment_bits_ = 12;
+  static const size_t segment_size_ = 1 << segment_bits_;
+  static const size_t segment_mask_ = segment_size_ - 1;
+  size_t segment_count_;
+  std::atomic<OBJ**> *segments_;
+};
+
+template <class OBJ>
+SegmentedArray<OBJ>::SegmentedArray(size_t index_max) :
+  segment_count_((index_max >> segment_bits_) + 1),
+  segments_(new std::atomic<OBJ**>[segment_count_])
+{
+  for (size_t i = 0; i < segment_count_; i++)
+    segments_[i].store(nullptr, std::memory_order_relaxed);
+}
+
+template <class OBJ>
+SegmentedArray<OBJ>::~SegmentedArray()
+{
+  for (size_t i = 0; i < segment_count_; i++)
+    delete [] segments_[i].load(std::memory_order_relaxed);
+  delete [] segments_;
+}
+
+template <class OBJ>
+void
+SegmentedArray<OBJ>::set(size_t index,
+			 OBJ *obj)
+{
+  std::atomic<OBJ**> &segment_ref = segments_[index >> segment_bits_];
+  OBJ **segment = segment_ref.load(std::memory_order_acquire);
+  if (segment == nullptr) {
+    OBJ **new_segment = new OBJ*[segment_size_]();
+    if (segment_ref.compare_exchange_strong(segment, new_segment,
+					    std::memory_order_acq_rel))
+      segment = new_segment;
+    else
+      // Another thread made the segment first.
+      delete [] new_segment;
+  }
+  segment[index & segment_mask_] = obj;
+}
+
+template <class OBJ>
+size_t
+SegmentedArray<OBJ>::capacity() const
+{
+  size_t capacity = 0;
+  for (size_t i = 0; i < segment_count_; i++) {
+    if (segments_[i].load(std::memory_order_relaxed))
+      capacity += segment_size_;
+  }
+  return capacity;
+}
+
+} // namespace
+#endif
@@ -0,0 +1,9 @@
+#define STA_VERSION "2.0.15"
+
+#define ZLIB 1
+
+#define CUDD 0
+
+#define SSTA 0
+
+#define STA_DEBUG 1
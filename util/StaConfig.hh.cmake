@@ -5,3 +5,5 @@
 #define CUDD ${CUDD}
 
 #define SSTA ${SSTA}
+
+#define STA_DEBUG ${STA_DEBUG}
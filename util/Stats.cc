@@ -17,36 +17,235 @@
 #include "Machine.hh"
 #include "StringUtil.hh"
 #include "Debug.hh"
+#include "Report.hh"
 #include "Stats.hh"
 
 namespace sta {
 
-Stats::Stats(Debug *debug) :
-  debug_(debug)
+Stats::Stats(Debug *debug,
+	     PhaseStats *phase_stats) :
+  visit_count_(0),
+  debug_(debug),
+  phase_stats_(phase_stats),
+  phase_open_(false)
 {
-  if (debug->statsLevel() > 0) {
+  if (debug->statsLevel() > 0 || phase_stats_) {
     elapsed_begin_ = elapsedRunTime();
     user_begin_ = userRunTime();
     system_begin_ = systemRunTime();
+  }
+  if (debug->statsLevel() > 0)
     memory_begin_ = memoryUsage();
+  if (phase_stats_) {
+    phase_stats_->begin();
+    phase_open_ = true;
   }
 }
 
+Stats::~Stats()
+{
+  // Keep sub-phases of a phase that was not reported.
+  if (phase_open_)
+    phase_stats_->abandon();
+}
+
+void
+Stats::setVisitCount(size_t count)
+{
+  visit_count_ = count;
+}
+
 void
 Stats::report(const char *step)
 {
-  if (debug_->statsLevel() > 0) {
+  if (debug_->statsLevel() > 0 || phase_open_) {
     double elapsed_end = elapsedRunTime();
     double user_end = userRunTime();
-    double memory_begin = static_cast<double>(memory_begin_);
-    double memory_end = static_cast<double>(memoryUsage());
-    double memory_delta = memory_end - memory_begin;
-    debug_->print("stats: %5.1f/%5.1fe %5.1f/%5.1fu %5.1f/%5.1fMB %s\n",
-		  elapsed_end - elapsed_begin_, elapsed_end,
-		  user_end - user_begin_, user_end,
-		  memory_delta * 1e-6, memory_end * 1e-6,
-		  step);
+    double system_end = systemRunTime();
+    if (phase_open_) {
+      phase_stats_->end(step,
+			elapsed_end - elapsed_begin_,
+			user_end - user_begin_ + system_end - system_begin_,
+			visit_count_);
+      phase_open_ = false;
+    }
+    if (debug_->statsLevel() > 0) {
+      double memory_begin = static_cast<double>(memory_begin_);
+      double memory_end = static_cast<double>(memoryUsage());
+      double memory_delta = memory_end - memory_begin;
+      debug_->print("stats: %5.1f/%5.1fe %5.1f/%5.1fu %5.1f/%5.1fMB %s\n",
+		    elapsed_end - elapsed_begin_, elapsed_end,
+		    user_end - user_begin_, user_end,
+		    memory_delta * 1e-6, memory_end * 1e-6,
+		    step);
+    }
+  }
+}
+
+////////////////////////////////////////////////////////////////
+
+PhaseStat::PhaseStat(const char *name) :
+  name_(name),
+  call_count_(0),
+  elapsed_(0.0),
+  cpu_(0.0),
+  visit_count_(0)
+{
+}
+
+PhaseStat::~PhaseStat()
+{
+  children_.deleteContents();
+}
+
+PhaseStat *
+PhaseStat::findChild(const char *name)
+{
+  for (auto child : children_) {
+    if (child->name_ == name)
+      return child;
+  }
+  PhaseStat *child = new PhaseStat(name);
+  children_.push_back(child);
+  return child;
+}
+
+void
+PhaseStat::merge(const PhaseStat *stat)
+{
+  call_count_ += stat->call_count_;
+  elapsed_ += stat->elapsed_;
+  cpu_ += stat->cpu_;
+  visit_count_ += stat->visit_count_;
+  for (auto stat_child : stat->children_)
+    findChild(stat_child->name_.c_str())->merge(stat_child);
+}
+
+////////////////////////////////////////////////////////////////
+
+PhaseStats::PhaseStats() :
+  root_(new PhaseStat(""))
+{
+  stack_.push_back(root_);
+}
+
+PhaseStats::~PhaseStats()
+{
+  // Phases in progress are owned by the stack.
+  for (size_t i = 1; i < stack_.size(); i++)
+    delete stack_[i];
+  delete root_;
+}
+
+void
+PhaseStats::clear()
+{
+  // Phases in progress are kept so their Stats can finish.
+  root_->children_.deleteContents();
+  root_->children_.clear();
+  for (size_t i = 1; i < stack_.size(); i++) {
+    PhaseStat *stat = stack_[i];
+    stat->children_.deleteContents();
+    stat->children_.clear();
+  }
+}
+
+void
+PhaseStats::begin()
+{
+  // Sub-phases are collected in an unnamed stat until the phase ends.
+  stack_.push_back(new PhaseStat(""));
+}
+
+void
+PhaseStats::end(const char *name,
+		double elapsed,
+		double cpu,
+		size_t visit_count)
+{
+  PhaseStat *stat = stack_.back();
+  stack_.pop_back();
+  stat->call_count_ = 1;
+  stat->elapsed_ = elapsed;
+  stat->cpu_ = cpu;
+  stat->visit_count_ = visit_count;
+  stack_.back()->findChild(name)->merge(stat);
+  delete stat;
+}
+
+void
+PhaseStats::abandon()
+{
+  PhaseStat *stat = stack_.back();
+  stack_.pop_back();
+  PhaseStat *parent = stack_.back();
+  for (auto child : stat->children_)
+    parent->findChild(child->name_.c_str())->merge(child);
+  delete stat;
+}
+
+void
+PhaseStats::report(Report *report) const
+{
+  report->print("Phase                                 Calls    Wall(s)     CPU(s) CPU/Wall     Visits\n");
+  report->print("-------------------------------------------------------------------------------------\n");
+  for (auto child : root_->children_)
+    this->report(child, 0, report);
+}
+
+void
+PhaseStats::report(const PhaseStat *stat,
+		   int depth,
+		   Report *report) const
+{
+  string name(depth * 2, ' ');
+  name += stat->name_;
+  report->print("%-36s %6lu %10.2f %10.2f %8.2f %10lu\n",
+		name.c_str(),
+		static_cast<unsigned long>(stat->call_count_),
+		stat->elapsed_,
+		stat->cpu_,
+		(stat->elapsed_ > 0.0) ? stat->cpu_ / stat->elapsed_ : 0.0,
+		static_cast<unsigned long>(stat->visit_count_));
+  for (auto child : stat->children_)
+    this->report(child, depth + 1, report);
+}
+
+void
+PhaseStats::reportJson(Report *report) const
+{
+  report->print("{\"phases\": [");
+  bool first = true;
+  for (auto child : root_->children_) {
+    report->print(first ? "\n" : ",\n");
+    reportJson(child, 1, report);
+    first = false;
+  }
+  report->print("\n]}\n");
+}
+
+void
+PhaseStats::reportJson(const PhaseStat *stat,
+		       int depth,
+		       Report *report) const
+{
+  string indent(depth * 2, ' ');
+  report->print("%s{\"name\": \"%s\", \"calls\": %lu, \"wall\": %.3f, \"cpu\": %.3f, \"visits\": %lu, \"children\": [",
+		indent.c_str(),
+		stat->name_.c_str(),
+		static_cast<unsigned long>(stat->call_count_),
+		stat->elapsed_,
+		stat->cpu_,
+		static_cast<unsigned long>(stat->visit_count_));
+  bool first = true;
+  for (auto child : stat->children_) {
+    report->print(first ? "\n" : ",\n");
+    reportJson(child, depth + 1, report);
+    first = false;
   }
+  if (!first)
+    report->print("\n%s", indent.c_str());
+  report->print("]}");
 }
 
 } // namespace
@@ -18,17 +18,28 @@
 #define STA_STATS_H
 
 #include <stddef.h>  // size_t
+#include <string>
 #include "DisallowCopyAssign.hh"
+#include "Vector.hh"
 
 namespace sta {
 
 class Debug;
+class Report;
+class PhaseStats;
 
 // Show run time and memory statistics if the "stats" debug flag is on.
+// When phase_stats is non-null the run time is also recorded in the
+// phase tree under the step name. Stats nested in the lifetime of
+// another Stats are recorded as sub-phases.
 class Stats
 {
 public:
-  explicit Stats(Debug *debug);
+  explicit Stats(Debug *debug,
+		 PhaseStats *phase_stats = nullptr);
+  ~Stats();
+  // Number of vertices (or other objects) visited by the phase.
+  void setVisitCount(size_t count);
   void report(const char *step);
 
 private:
@@ -38,7 +49,71 @@ private:
   double user_begin_;
   double system_begin_;
   size_t memory_begin_;
+  size_t visit_count_;
   Debug *debug_;
+  PhaseStats *phase_stats_;
+  bool phase_open_;
+};
+
+class PhaseStat;
+typedef Vector<PhaseStat*> PhaseStatSeq;
+
+class PhaseStat
+{
+public:
+  explicit PhaseStat(const char *name);
+  ~PhaseStat();
+  PhaseStat *findChild(const char *name);
+  // Add stat and its children to this.
+  void merge(const PhaseStat *stat);
+
+  std::string name_;
+  size_t call_count_;
+  double elapsed_;
+  // User + system cpu time of all threads.
+  double cpu_;
+  size_t visit_count_;
+  // Children in first call order.
+  PhaseStatSeq children_;
+
+private:
+  DISALLOW_COPY_AND_ASSIGN(PhaseStat);
+};
+
+// Hierarchical wall/cpu time and visit counts of named phases
+// (levelize, delay calc, arrival search, ...) accumulated across calls.
+// Phases are recorded by Stats objects in the main thread.
+class PhaseStats
+{
+public:
+  PhaseStats();
+  ~PhaseStats();
+  void clear();
+  void report(Report *report) const;
+  void reportJson(Report *report) const;
+
+protected:
+  void begin();
+  void end(const char *name,
+	   double elapsed,
+	   double cpu,
+	   size_t visit_count);
+  void abandon();
+  void report(const PhaseStat *stat,
+	      int depth,
+	      Report *report) const;
+  void reportJson(const PhaseStat *stat,
+		  int depth,
+		  Report *report) const;
+
+  PhaseStat *root_;
+  // Phases in progress; the root is the bottom of the stack.
+  PhaseStatSeq stack_;
+
+private:
+  DISALLOW_COPY_AND_ASSIGN(PhaseStats);
+
+  friend class Stats;
 };
 
 } // namespace
@@ -0,0 +1,144 @@
+// OpenSTA, Static Timing Analyzer
+// Copyright (c) 2019, Parallax Software, Inc.
+// 
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+// 
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+// 
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#include <string.h>
+#include <mutex>
+#include "Machine.hh"
+#include "DisallowCopyAssign.hh"
+#include "Mutex.hh"
+#include "MemoryReport.hh"
+#include "Vector.hh"
+#include "UnorderedSet.hh"
+#include "StringUtil.hh"
+#include "StringIntern.hh"
+
+namespace sta {
+
+typedef UnorderedSet<const char*, CharPtrHash, CharPtrEqual> InternStringSet;
+
+// Strings are copied into large blocks to avoid the per string
+// allocation overhead.
+class StringInternTable
+{
+public:
+  StringInternTable();
+  ~StringInternTable();
+  const char *intern(const char *str);
+  void usage(// Return values.
+	     size_t &count,
+	     size_t &bytes);
+
+private:
+  DISALLOW_COPY_AND_ASSIGN(StringInternTable);
+  char *alloc(size_t length);
+
+  InternStringSet strings_;
+  Vector<char*> blocks_;
+  char *block_next_;
+  size_t block_free_;
+  size_t bytes_;
+  std::mutex lock_;
+
+  static const size_t block_size_ = 64 * 1024;
+};
+
+StringInternTable::StringInternTable() :
+  block_next_(nullptr),
+  block_free_(0),
+  bytes_(0)
+{
+}
+
+StringInternTable::~StringInternTable()
+{
+  for (char *block : blocks_)
+    delete [] block;
+}
+
+const char *
+StringInternTable::intern(const char *str)
+{
+  UniqueLock lock(lock_);
+  auto itr = strings_.find(str);
+  if (itr == strings_.end()) {
+    size_t length = strlen(str) + 1;
+    char *copy = alloc(length);
+    memcpy(copy, str, length);
+    strings_.insert(copy);
+    return copy;
+  }
+  else
+    return *itr;
+}
+
+void
+StringInternTable::usage(size_t &count,
+			 size_t &bytes)
+{
+  UniqueLock lock(lock_);
+  count = strings_.size();
+  bytes = bytes_ + count * (sizeof(char*) + MemoryReport::hash_node_bytes);
+}
+
+char *
+StringInternTable::alloc(size_t length)
+{
+  bytes_ += length;
+  // Long strings get their own block so the current block is not
+  // abandoned.
+  if (length > block_size_ / 16) {
+    char *block = new char[length];
+    blocks_.push_back(block);
+    return block;
+  }
+  if (length > block_free_) {
+    block_next_ = new char[block_size_];
+    blocks_.push_back(block_next_);
+    block_free_ = block_size_;
+  }
+  char *str = block_next_;
+  block_next_ += length;
+  block_free_ -= length;
+  return str;
+}
+
+// Function scope so the table is made before it is used by static
+// initializers in other files.
+static StringInternTable &
+stringInternTable()
+{
+  static StringInternTable table;
+  return table;
+}
+
+const char *
+internString(const char *str)
+{
+  if (str)
+    return stringInternTable().intern(str);
+  else
+    return nullptr;
+}
+
+size_t
+internedStringCount(size_t &bytes)
+{
+  size_t count;
+  stringInternTable().usage(count, bytes);
+  return count;
+}
+
+} // namespace
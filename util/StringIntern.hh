@@ -0,0 +1,37 @@
+// OpenSTA, Static Timing Analyzer
+// Copyright (c) 2019, Parallax Software, Inc.
+// 
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+// 
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+// 
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#ifndef STA_STRING_INTERN_H
+#define STA_STRING_INTERN_H
+
+#include <stddef.h>  // size_t
+
+namespace sta {
+
+// Return the shared copy of str in the string intern table.
+// Identical strings return the same pointer so they can be compared
+// with ==. Interned strings are allocated in blocks and are never
+// deleted, so they must not be passed to stringDelete.
+// Returns nullptr if str is nullptr. Thread safe.
+const char *
+internString(const char *str);
+// Return the number of interned strings and the bytes used by them.
+size_t
+internedStringCount(// Return value.
+		    size_t &bytes);
+
+} // namespace
+#endif
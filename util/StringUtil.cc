@@ -15,11 +15,11 @@
 // along with this program.  If not, see <https://www.gnu.org/licenses/>.
 
 #include <limits>
+#include <vector>
+#include <algorithm>
 #include <ctype.h>
 #include <stdio.h>
-#include <mutex>
 #include "Machine.hh"
-#include "Mutex.hh"
 #include "StringUtil.hh"
 
 namespace sta {
@@ -34,6 +34,8 @@ static void
 getTmpString(// Return values.
 	     char *&str,
 	     size_t &length);
+static void
+commitTmpString(size_t length);
 
 char *
 stringCopy(const char *str)
@@ -57,6 +59,28 @@ isDigits(const char *str)
   return true;
 }
 
+void
+jsonString(const char *str,
+	   string &result)
+{
+  result += '"';
+  for (const char *s = str; *s; s++) {
+    char ch = *s;
+    if (ch == '"' || ch == '\\') {
+      result += '\\';
+      result += ch;
+    }
+    else if (static_cast<unsigned char>(ch) < 0x20) {
+      char escape[8];
+      snprintf(escape, sizeof(escape), "\\u%04x", ch);
+      result += escape;
+    }
+    else
+      result += ch;
+  }
+  result += '"';
+}
+
 ////////////////////////////////////////////////////////////////
 
 char *
@@ -146,7 +170,9 @@ stringPrintTmp(const char *fmt,
   tmp_length = vsnprint(tmp, tmp_length1, fmt, args_copy);
   va_end(args_copy);
 
-  if (tmp_length >= tmp_length1) {
+  if (tmp_length < tmp_length1)
+    commitTmpString(tmp_length + 1);
+  else {
     tmp_length1 = tmp_length + 1;
     tmp = makeTmpString(tmp_length1);
     va_copy(args_copy, args);
@@ -157,38 +183,171 @@ stringPrintTmp(const char *fmt,
 
 ////////////////////////////////////////////////////////////////
 
-static int tmp_string_count_ = 100;
-static char **tmp_strings_ = nullptr;
-static size_t *tmp_string_lengths_ = nullptr;
-static int tmp_string_next_;
-static std::mutex string_lock_;
+// Each thread has its own ring of temporary strings so threads
+// formatting names at the same time do not reuse each other's strings.
+// Inside a TmpStringScope strings are bump allocated from the thread's
+// arena blocks instead and released together when the scope ends.
+class TmpStrings
+{
+public:
+  TmpStrings();
+  ~TmpStrings();
+  // The string may be longer than the caller needs; commitString
+  // claims the part that is used.
+  void getString(// Return values.
+		 char *&str,
+		 size_t &length);
+  void commitString(size_t length);
+  char *makeString(size_t length);
+  void beginScope(// Return values.
+		  size_t &block,
+		  size_t &offset);
+  void endScope(size_t block,
+		size_t offset);
 
-void
-initTmpStrings()
+private:
+  void ensureArena(size_t length);
+
+  static const int count_ = 100;
+  char *strings_[count_];
+  size_t lengths_[count_];
+  int next_;
+
+  static const size_t arena_block_length_ = 1 << 16;
+  std::vector<char*> blocks_;
+  std::vector<size_t> block_lengths_;
+  size_t block_;
+  size_t offset_;
+  int scope_depth_;
+};
+
+const size_t TmpStrings::arena_block_length_;
+
+TmpStrings::TmpStrings() :
+  next_(0),
+  block_(0),
+  offset_(0),
+  scope_depth_(0)
 {
   size_t initial_length = 100;
+  for (int i = 0; i < count_; i++) {
+    strings_[i] = new char[initial_length];
+    lengths_[i] = initial_length;
+  }
+}
 
-  tmp_strings_ = new char*[tmp_string_count_];
-  tmp_string_lengths_ = new size_t[tmp_string_count_];
-  for (int i = 0; i < tmp_string_count_; i++) {
-    tmp_strings_[i] = new char[initial_length];
-    tmp_string_lengths_[i] = initial_length;
+TmpStrings::~TmpStrings()
+{
+  for (int i = 0; i < count_; i++)
+    delete [] strings_[i];
+  for (char *block : blocks_)
+    delete [] block;
+}
+
+void
+TmpStrings::getString(// Return values.
+		      char *&str,
+		      size_t &length)
+{
+  if (scope_depth_ > 0) {
+    ensureArena(100);
+    str = blocks_[block_] + offset_;
+    length = block_lengths_[block_] - offset_;
+    return;
   }
-  tmp_string_next_ = 0;
+  if (next_ == count_)
+    next_ = 0;
+  str = strings_[next_];
+  length = lengths_[next_];
+  next_++;
 }
 
 void
-deleteTmpStrings()
+TmpStrings::commitString(size_t length)
 {
-  if (tmp_strings_) {
-    for (int i = 0; i < tmp_string_count_; i++)
-      delete [] tmp_strings_[i];
-    delete [] tmp_strings_;
-    tmp_strings_ = nullptr;
+  if (scope_depth_ > 0)
+    offset_ += length;
+}
 
-    delete [] tmp_string_lengths_;
-    tmp_string_lengths_ = nullptr;
+char *
+TmpStrings::makeString(size_t length)
+{
+  if (scope_depth_ > 0) {
+    ensureArena(length);
+    char *str = blocks_[block_] + offset_;
+    offset_ += length;
+    return str;
+  }
+  if (next_ == count_)
+    next_ = 0;
+  char *tmp_str = strings_[next_];
+  if (lengths_[next_] < length) {
+    // String isn't long enough.  Make a new one.
+    stringDelete(tmp_str);
+    tmp_str = new char[length];
+    strings_[next_] = tmp_str;
+    lengths_[next_] = length;
+  }
+  next_++;
+  return tmp_str;
+}
+
+// Make room for length bytes at offset_ in block_.
+void
+TmpStrings::ensureArena(size_t length)
+{
+  if (blocks_.empty()) {
+    size_t block_length = std::max(arena_block_length_, length);
+    blocks_.push_back(new char[block_length]);
+    block_lengths_.push_back(block_length);
   }
+  else if (offset_ + length > block_lengths_[block_]) {
+    block_++;
+    offset_ = 0;
+    if (block_ == blocks_.size()) {
+      size_t block_length = std::max(arena_block_length_, length);
+      blocks_.push_back(new char[block_length]);
+      block_lengths_.push_back(block_length);
+    }
+    else if (block_lengths_[block_] < length) {
+      // Blocks after block_ are not in use.
+      delete [] blocks_[block_];
+      blocks_[block_] = new char[length];
+      block_lengths_[block_] = length;
+    }
+  }
+}
+
+void
+TmpStrings::beginScope(// Return values.
+		       size_t &block,
+		       size_t &offset)
+{
+  block = block_;
+  offset = offset_;
+  scope_depth_++;
+}
+
+void
+TmpStrings::endScope(size_t block,
+		     size_t offset)
+{
+  block_ = block;
+  offset_ = offset;
+  scope_depth_--;
+}
+
+static thread_local TmpStrings tmp_strings_;
+
+// The strings are made on first use by each thread.
+void
+initTmpStrings()
+{
+}
+
+void
+deleteTmpStrings()
+{
 }
 
 static void
@@ -196,31 +355,29 @@ getTmpString(// Return values.
 	     char *&str,
 	     size_t &length)
 {
-  UniqueLock lock(string_lock_);
-  if (tmp_string_next_ == tmp_string_count_)
-    tmp_string_next_ = 0;
-  str = tmp_strings_[tmp_string_next_];
-  length = tmp_string_lengths_[tmp_string_next_];
-  tmp_string_next_++;
+  tmp_strings_.getString(str, length);
+}
+
+static void
+commitTmpString(size_t length)
+{
+  tmp_strings_.commitString(length);
 }
 
 char *
 makeTmpString(size_t length)
 {
-  UniqueLock lock(string_lock_);
-  if (tmp_string_next_ == tmp_string_count_)
-    tmp_string_next_ = 0;
-  char *tmp_str = tmp_strings_[tmp_string_next_];
-  size_t tmp_length = tmp_string_lengths_[tmp_string_next_];
-  if (tmp_length < length) {
-    // String isn't long enough.  Make a new one.
-    stringDelete(tmp_str);
-    tmp_str = new char[length];
-    tmp_strings_[tmp_string_next_] = tmp_str;
-    tmp_string_lengths_[tmp_string_next_] = length;
-  }
-  tmp_string_next_++;
-  return tmp_str;
+  return tmp_strings_.makeString(length);
+}
+
+TmpStringScope::TmpStringScope()
+{
+  tmp_strings_.beginScope(block_, offset_);
+}
+
+TmpStringScope::~TmpStringScope()
+{
+  tmp_strings_.endScope(block_, offset_);
 }
 
 ////////////////////////////////////////////////////////////////
@@ -20,6 +20,8 @@
 #include <stdarg.h>
 #include <string.h>
 #include <string>
+#include "DisallowCopyAssign.hh"
+#include "Hash.hh"
 
 namespace sta {
 
@@ -29,7 +31,8 @@ inline bool
 stringEq(const char *str1,
 	 const char *str2)
 {
-  return strcmp(str1, str2) == 0;
+  // Interned strings (see StringIntern.hh) compare by pointer.
+  return str1 == str2 || strcmp(str1, str2) == 0;
 }
 
 // Compare the first length characters.
@@ -77,7 +80,7 @@ inline bool
 stringLess(const char *str1,
 	   const char *str2)
 {
-  return strcmp(str1, str2) < 0;
+  return str1 != str2 && strcmp(str1, str2) < 0;
 }
 
 inline bool
@@ -98,6 +101,29 @@ public:
   }
 };
 
+// Hash and equality for const char* keyed hashed containers.
+class CharPtrHash
+{
+public:
+  size_t operator()(const char *str) const
+  {
+    Hash hash = hash_init_value;
+    for (const char *s = str; *s; s++)
+      hashIncr(hash, *s);
+    return hash;
+  }
+};
+
+class CharPtrEqual
+{
+public:
+  bool operator()(const char *str1,
+		  const char *str2) const
+  {
+    return strcmp(str1, str2) == 0;
+  }
+};
+
 // Case insensitive comparision.
 class CharPtrCaseLess
 {
@@ -130,6 +156,10 @@ stringDelete(const char *str)
 
 bool
 isDigits(const char *str);
+// Append str to result as a quoted json string.
+void
+jsonString(const char *str,
+	   string &result);
 
 // Print to a new string.
 // Caller owns returned string.
@@ -162,6 +192,26 @@ initTmpStrings();
 void
 deleteTmpStrings();
 
+// Temporary strings made on a thread while a TmpStringScope is active
+// stay valid until the scope ends instead of being reused after 100
+// more temporary strings are made. Scopes nest.
+//   {
+//     TmpStringScope tmp_scope;
+//     ... network_->pathName(pin) ...
+//   }
+class TmpStringScope
+{
+public:
+  TmpStringScope();
+  ~TmpStringScope();
+
+private:
+  DISALLOW_COPY_AND_ASSIGN(TmpStringScope);
+
+  size_t block_;
+  size_t offset_;
+};
+
 ////////////////////////////////////////////////////////////////
 
 // Trim right spaces.
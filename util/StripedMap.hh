@@ -0,0 +1,149 @@
+// OpenSTA, Static Timing Analyzer
+// Copyright (c) 2019, Parallax Software, Inc.
+// 
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+// 
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+// 
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#ifndef STA_STRIPED_MAP_H
+#define STA_STRIPED_MAP_H
+
+#include <stddef.h>  // size_t
+#include <atomic>
+#include <mutex>
+#include "DisallowCopyAssign.hh"
+#include "UnorderedMap.hh"
+
+namespace sta {
+
+// Hash map split into stripes that each have their own lock so
+// threads working on keys in different stripes do not serialize.
+// Hold lock(key) around findKey/insert/erase of key and any use of
+// the value found that races with other threads.
+// clear and the iterator are not thread safe.
+template <class KEY, class VALUE, class HASH = std::hash<KEY> >
+class StripedMap
+{
+public:
+  typedef UnorderedMap<KEY, VALUE, HASH> StripeMap;
+
+  StripedMap() :
+    size_(0)
+  {
+  }
+
+  // size and empty do not need a lock.
+  size_t size() const { return size_; }
+  bool empty() const { return size_ == 0; }
+
+  std::mutex &lock(const KEY key) const
+  {
+    return locks_[stripeIndex(key)];
+  }
+
+  // Caller holds lock(key).
+  VALUE findKey(const KEY key) const
+  {
+    return maps_[stripeIndex(key)].findKey(key);
+  }
+
+  // Caller holds lock(key).
+  void findKey(const KEY key,
+	       // Return Values.
+	       VALUE &value,
+	       bool &exists) const
+  {
+    maps_[stripeIndex(key)].findKey(key, value, exists);
+  }
+
+  // Caller holds lock(key).
+  void insert(const KEY key,
+	      VALUE value)
+  {
+    StripeMap &map = maps_[stripeIndex(key)];
+    auto insert_iter = map.emplace(key, value);
+    if (insert_iter.second)
+      size_++;
+    else
+      insert_iter.first->second = value;
+  }
+
+  // Caller holds lock(key).
+  void erase(const KEY key)
+  {
+    if (maps_[stripeIndex(key)].erase(key))
+      size_--;
+  }
+
+  void clear()
+  {
+    for (size_t i = 0; i < stripe_count_; i++)
+      maps_[i].clear();
+    size_ = 0;
+  }
+
+  class Iterator
+  {
+  public:
+    explicit Iterator(const StripedMap *map) :
+      map_(map),
+      stripe_(0),
+      iter_(map->maps_[0].begin())
+    {
+      findNext();
+    }
+    bool hasNext() { return stripe_ < stripe_count_; }
+    void next(// Return values.
+	      KEY &key,
+	      VALUE &value)
+    {
+      key = iter_->first;
+      value = iter_->second;
+      iter_++;
+      findNext();
+    }
+
+  private:
+    void findNext()
+    {
+      while (stripe_ < stripe_count_
+	     && iter_ == map_->maps_[stripe_].end()) {
+	stripe_++;
+	if (stripe_ < stripe_count_)
+	  iter_ = map_->maps_[stripe_].begin();
+      }
+    }
+
+    const StripedMap *map_;
+    size_t stripe_;
+    typename StripeMap::const_iterator iter_;
+  };
+
+private:
+  DISALLOW_COPY_AND_ASSIGN(StripedMap);
+
+  size_t stripeIndex(const KEY key) const
+  {
+    // Fibonacci hashing spreads the aligned low bits of pointer keys.
+    size_t hash = HASH()(key) * static_cast<size_t>(0x9e3779b97f4a7c15ULL);
+    return hash >> (sizeof(size_t) * 8 - stripe_bits_);
+  }
+
+  static const size_t stripe_bits_ = 6;
+  static const size_t stripe_count_ = 1 << stripe_bits_;
+  StripeMap maps_[stripe_count_];
+  mutable std::mutex locks_[stripe_count_];
+  std::atomic<size_t> size_;
+};
+
+} // namespace
+#endif
@@ -17,10 +17,12 @@
 #ifndef STA_THREAD_FOR_EACH_H
 #define STA_THREAD_FOR_EACH_H
 
+#include <atomic>
 #include <mutex>
 #include <thread>
 #include <vector>
 #include "Iterator.hh"
+#include "ThreadPool.hh"
 
 namespace sta {
 
@@ -61,13 +63,14 @@ public:
   Func *func_;
 };
 
+// Apply func to iter objects until iter is exhausted.
+// lock serializes access to iter between threads.
 template<class Iterator, class Func, class FuncArg>
 void
-forEachBegin(ForEachArg<Iterator, Func> arg1)
+forEachBegin(Iterator *iter,
+	     std::mutex &lock,
+	     Func *func)
 {
-  Iterator *iter = arg1.iter_;
-  std::mutex &lock = arg1.lock_;
-  Func *func = arg1.func_;
   while (true) {
     lock.lock();
     if (iter->hasNext()) {
@@ -82,6 +85,13 @@ forEachBegin(ForEachArg<Iterator, Func> arg1)
   }
 }
 
+template<class Iterator, class Func, class FuncArg>
+void
+forEachBegin(ForEachArg<Iterator, Func> arg1)
+{
+  forEachBegin<Iterator, Func, FuncArg>(arg1.iter_, arg1.lock_, arg1.func_);
+}
+
 // Parallel version of STL for_each.
 // Each thread has its own functor.
 // Func::copy() must be defined.
@@ -108,5 +118,71 @@ forEach(Iterator *iter,
   }
 }
 
+// Parallel version of STL for_each using the worker threads in pool.
+// Each thread has its own functor.
+// Func::copy() must be defined.
+template<class Iterator, class Func, class FuncArg>
+void
+forEach(Iterator *iter,
+	Func *func,
+	ThreadPool *pool)
+{
+  if (pool == nullptr || pool->threadCount() <= 1) {
+    while (iter->hasNext())
+      (*func)(iter->next());
+  }
+  else {
+    int thread_count = pool->threadCount();
+    std::vector<Func*> funcs(thread_count);
+    for (int i = 0; i < thread_count; i++)
+      funcs[i] = func->copy();
+    std::mutex lock;
+    pool->run([&] (int thread_index) {
+	forEachBegin<Iterator,Func,FuncArg>(iter, lock, funcs[thread_index]);
+      });
+    for (auto thread_func : funcs)
+      delete thread_func;
+  }
+}
+
+// Largest block of indices handed to a thread at once.
+const size_t for_each_chunk_max = 256;
+
+// Parallel loop over the index range [0, count) that hands out blocks
+// of indices with an atomic compare/exchange instead of a lock.
+// The block size shrinks as the range is consumed (guided schedule) so
+// threads claim big blocks while there is plenty of work and small ones
+// near the end to balance the load.
+// func(begin, end, thread_index) is called for each block.
+template<class Func>
+void
+forEachChunk(size_t count,
+	     ThreadPool *pool,
+	     Func func)
+{
+  if (pool == nullptr || pool->threadCount() <= 1)
+    func(0, count, 0);
+  else {
+    size_t divisor = pool->threadCount() * 4;
+    std::atomic<size_t> next(0);
+    pool->run([&] (int thread_index) {
+	size_t begin = next.load(std::memory_order_relaxed);
+	while (begin < count) {
+	  size_t chunk = (count - begin) / divisor;
+	  if (chunk < 1)
+	    chunk = 1;
+	  else if (chunk > for_each_chunk_max)
+	    chunk = for_each_chunk_max;
+	  if (next.compare_exchange_weak(begin, begin + chunk,
+					 std::memory_order_relaxed)) {
+	    func(begin, begin + chunk, thread_index);
+	    begin = next.load(std::memory_order_relaxed);
+	  }
+	  // else compare_exchange_weak reloaded begin.
+	}
+      });
+  }
+}
+
 } // namespace
 #endif
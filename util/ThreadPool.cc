@@ -15,37 +15,97 @@
 // along with this program.  If not, see <https://www.gnu.org/licenses/>.
 
 #include "Machine.hh"
-#include "ThreadWorker.hh"
 #include "ThreadPool.hh"
 
 namespace sta {
 
+thread_local int ThreadPool::thread_index_ = -1;
+
+ThreadPool::ThreadPool(int thread_count) :
+  func_(nullptr),
+  task_id_(0),
+  running_count_(0),
+  stop_(false)
+{
+  start(thread_count);
+}
+
 ThreadPool::~ThreadPool()
 {
-  threads_.deleteContentsClear();
+  stop();
+}
+
+void
+ThreadPool::setThreadCount(int thread_count)
+{
+  if (thread_count != threadCount()) {
+    stop();
+    start(thread_count);
+  }
+}
+
+void
+ThreadPool::start(int thread_count)
+{
+  stop_ = false;
+  for (int i = 0; i < thread_count; i++)
+    threads_.push_back(std::thread(&ThreadPool::worker, this, i, task_id_));
+}
+
+void
+ThreadPool::stop()
+{
+  {
+    std::unique_lock<std::mutex> lock(lock_);
+    stop_ = true;
+  }
+  task_cond_.notify_all();
+  for (auto &thread : threads_)
+    thread.join();
+  threads_.clear();
 }
 
-ThreadWorker *
-ThreadPool::pop()
+void
+ThreadPool::run(const ThreadPoolFunc &func)
 {
-  lock_.lock();
-  if (!threads_.empty()) {
-    ThreadWorker *thread = threads_.back();
-    threads_.pop_back();
-    lock_.unlock();
-    return thread;
+  if (threads_.empty())
+    func(0);
+  else {
+    std::unique_lock<std::mutex> lock(lock_);
+    func_ = &func;
+    running_count_ = threadCount();
+    task_id_++;
+    task_cond_.notify_all();
+    done_cond_.wait(lock, [this] () { return running_count_ == 0; });
+    func_ = nullptr;
   }
-  lock_.unlock();
-  // No threads in the pool, get a new one.
-  return new ThreadWorker;
 }
 
 void
-ThreadPool::push(ThreadWorker *thread)
+ThreadPool::worker(int thread_index,
+		   unsigned long task_id)
 {
-  lock_.lock();
-  threads_.push_back(thread);
-  lock_.unlock();
+  thread_index_ = thread_index;
+  while (true) {
+    const ThreadPoolFunc *func;
+    {
+      std::unique_lock<std::mutex> lock(lock_);
+      task_cond_.wait(lock, [this, task_id] () {
+	  return stop_ || task_id_ != task_id;
+	});
+      if (stop_)
+	break;
+      task_id = task_id_;
+      func = func_;
+    }
+    (*func)(thread_index);
+    {
+      std::unique_lock<std::mutex> lock(lock_);
+      running_count_--;
+      if (running_count_ == 0)
+	done_cond_.notify_one();
+    }
+  }
 }
 
 } // namespace
@@ -17,28 +17,56 @@
 #ifndef STA_THREAD_POOL_H
 #define STA_THREAD_POOL_H
 
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <functional>
+#include <vector>
 #include "DisallowCopyAssign.hh"
-#include "Vector.hh"
-#include "Mutex.hh"
 
 namespace sta {
 
-class ThreadWorker;
+typedef std::function<void (int thread_index)> ThreadPoolFunc;
 
+// Pool of long lived worker threads.
+// The threads sleep between tasks so the cost of creating and joining
+// threads is only paid when the thread count changes instead of
+// once per parallel region.
 class ThreadPool
 {
 public:
-  ThreadPool() {}
+  explicit ThreadPool(int thread_count);
   ~ThreadPool();
-  // Create a new working thread if the pool is empty.
-  ThreadWorker *pop();
-  void push(ThreadWorker *thread);
+  int threadCount() const { return static_cast<int>(threads_.size()); }
+  void setThreadCount(int thread_count);
+  // Call func(thread_index) once in each worker thread and wait for
+  // all of the workers to return.  thread_index is [0, threadCount()).
+  // Not reentrant; func must not call run().
+  void run(const ThreadPoolFunc &func);
+  // Index of the calling worker thread, or -1 if the caller is
+  // not a pool thread.
+  static int threadIndex() { return thread_index_; }
 
 private:
   DISALLOW_COPY_AND_ASSIGN(ThreadPool);
+  void start(int thread_count);
+  void stop();
+  void worker(int thread_index,
+	      unsigned long task_id);
 
-  Vector<ThreadWorker*> threads_;
-  Mutex lock_;
+  std::vector<std::thread> threads_;
+  std::mutex lock_;
+  // Signals the workers that a task (or stop) is pending.
+  std::condition_variable task_cond_;
+  // Signals run() that the workers are done.
+  std::condition_variable done_cond_;
+  const ThreadPoolFunc *func_;
+  // Incremented for each task so sleeping workers can tell a new task
+  // from a spurious wakeup.
+  unsigned long task_id_;
+  int running_count_;
+  bool stop_;
+  static thread_local int thread_index_;
 };
 
 } // namespace
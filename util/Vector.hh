@@ -136,5 +136,23 @@ sort(Vector<OBJ> *seq, SortCmp cmp)
   std::stable_sort(seq->begin(), seq->end(), cmp);
 }
 
+// Sort the first count objects of seq and delete the rest.
+// count=0 sorts all of the objects.
+template <class OBJ, class SortCmp>
+void
+sortDeleteTail(Vector<OBJ*> &seq,
+	       size_t count,
+	       SortCmp cmp)
+{
+  if (count > 0 && count < seq.size()) {
+    std::partial_sort(seq.begin(), seq.begin() + count, seq.end(), cmp);
+    for (auto iter = seq.begin() + count; iter != seq.end(); iter++)
+      delete *iter;
+    seq.resize(count);
+  }
+  else
+    sort(seq, cmp);
+}
+
 } // namespace
 #endif
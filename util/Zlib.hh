@@ -32,8 +32,13 @@
 
 #define gzFile FILE*
 #define gzopen fopen
+#define gzdopen fdopen
 #define gzclose fclose
 #define gzgets(stream,s,size) fgets(s,size,stream)
+// Files are never compressed.
+#define gzdirect(stream) 1
+#define gzread(stream,buf,len) fread(buf,1,len,stream)
+#define gzwrite(stream,buf,len) fwrite(buf,1,len,stream)
 #define gzprintf fprintf
 #define Z_NULL nullptr
 
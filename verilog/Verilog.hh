@@ -17,8 +17,8 @@
 #ifndef STA_VERILOG_H
 #define STA_VERILOG_H
 
+#include <mutex>
 #include "DisallowCopyAssign.hh"
-#include "Zlib.hh"
 #include "Vector.hh"
 #include "Map.hh"
 #include "StringSeq.hh"
@@ -36,6 +36,7 @@ namespace sta {
 
 class Debug;
 class Report;
+class Progress;
 class VerilogReader;
 class VerilogStmt;
 class VerilogNet;
@@ -54,6 +55,9 @@ class VerilogNetBitSelect;
 class VerilogNetPartSelect;
 class StringRegistry;
 class VerilogBindingTbl;
+class VerilogLinkBody;
+class ScanInput;
+class ThreadPool;
 class VerilogNetNameIterator;
 class VerilogNetPortRef;
 class VerilogError;
@@ -65,6 +69,7 @@ typedef Map<const char*, VerilogDcl*, CharPtrLess> VerilogDclMap;
 typedef Vector<VerilogDclArg*> VerilogDclArgSeq;
 typedef Map<Cell*, VerilogModule*> VerilogModuleMap;
 typedef Vector<VerilogError*> VerilogErrorSeq;
+typedef Vector<VerilogLinkBody*> VerilogLinkBodySeq;
 typedef Vector<bool> VerilogConstantValue;
 // Max base 10 constant net value (for strtoll).
 typedef unsigned long long VerilogConstant10;
@@ -78,7 +83,10 @@ public:
 			 Debug *debug,
 			 NetworkReader *network);
   ~VerilogReader();
-  bool read(const char *filename);
+  // With flat the leaf liberty cell instances are made in the network
+  // as they are read instead of when the network is linked.
+  bool read(const char *filename,
+	    bool flat);
   // flex YY_INPUT yy_n_chars arg changed definition from int to size_t,
   // so provide both forms.
   void getChars(char *buf,
@@ -87,6 +95,7 @@ public:
   void getChars(char *buf,
 		int &result,
 		size_t max_size);
+  void beginModule(const char *module_name);
   void makeModule(const char *module_name,
 		  VerilogNetSeq *ports,
 		  VerilogStmtSeq *stmts,
@@ -178,6 +187,11 @@ private:
 				 StringSet &port_names);
   void checkModuleDcls(VerilogModule *module,
 		       StringSet &port_names);
+  void linkBodiesParallel(VerilogModule *top_module,
+			  Instance *top_instance,
+			  VerilogBindingTbl *top_bindings,
+			  bool make_black_boxes,
+			  ThreadPool *thread_pool);
   void makeModuleInstBody(VerilogModule *module,
 			  Instance *inst,
 			  VerilogBindingTbl *bindings,
@@ -191,6 +205,18 @@ private:
 		       Instance *parent,
 		       VerilogModule *parent_module,
 		       VerilogBindingTbl *parent_bindings);
+  void makeLibertyInst(LibertyCell *lib_cell,
+		       const char *inst_name,
+		       const char **net_names,
+		       Instance *parent,
+		       VerilogDclMap *parent_dcls,
+		       VerilogBindingTbl *parent_bindings);
+  void makeFlatLibertyInst(LibertyCell *lib_cell,
+			   const char *inst_name,
+			   const char **net_names,
+			   int line);
+  Cell *makeModuleCell(const char *module_name);
+  void deleteModule(VerilogModule *module);
   void bindGlobalNets(VerilogBindingTbl *bindings);
   void makeNamedInstPins1(Cell *cell,
 			  Instance *inst,
@@ -259,18 +285,32 @@ private:
 
   const char *filename_;
   int line_;
-  gzFile stream_;
+  ScanInput *input_;
 
   Library *library_;
+  bool flat_;
+  // Cell, instance and net bindings of the module being read with flat_.
+  Cell *flat_cell_;
+  Instance *flat_instance_;
+  VerilogBindingTbl *flat_bindings_;
+  // Bus declarations seen so far in the module being read with flat_.
+  VerilogDclMap flat_bus_dcls_;
   int black_box_index_;
   VerilogModuleMap module_map_;
   VerilogErrorSeq link_errors_;
+  std::mutex link_errors_lock_;
+  std::mutex link_cell_lock_;
+  // Non-null while hierarchical instance bodies are being deferred
+  // for the parallel link.
+  VerilogLinkBodySeq *link_bodies_;
   const char *zero_net_name_;
   const char *one_net_name_;
   const char *constant10_max_;
   size_t constant10_max_length_;
   ViewType *view_type_;
   bool report_stmt_stats_;
+  // Instance statement progress while a file is read.
+  Progress *progress_;
   int module_count_;
   int inst_mod_count_;
   int inst_lib_count_;
@@ -331,6 +371,11 @@ public:
   VerilogDclMap *declarationMap() { return &dcl_map_; }
   void parseDcl(VerilogDcl *dcl,
 		VerilogReader *reader);
+  // Instance holding the liberty cell instances made by a flat read.
+  Instance *flatInstance() const { return flat_instance_; }
+  VerilogBindingTbl *flatBindings() const { return flat_bindings_; }
+  void setFlatNetwork(Instance *inst,
+		      VerilogBindingTbl *bindings);
 
 private:
   DISALLOW_COPY_AND_ASSIGN(VerilogModule);
@@ -344,6 +389,8 @@ private:
   VerilogNetSeq *ports_;
   VerilogStmtSeq *stmts_;
   VerilogDclMap dcl_map_;
+  Instance *flat_instance_;
+  VerilogBindingTbl *flat_bindings_;
 };
 
 class VerilogDcl : public VerilogStmt
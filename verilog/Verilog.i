@@ -19,29 +19,42 @@
 // along with this program.  If not, see <https://www.gnu.org/licenses/>.
 
 #include "VerilogReader.hh"
+#include "VerilogWriter.hh"
 #include "Sta.hh"
 
 using sta::Sta;
 using sta::NetworkReader;
 using sta::readVerilogFile;
+using sta::cmdLinkedNetwork;
 
 %}
 
 %inline %{
 
 bool
-read_verilog(const char *filename)
+read_verilog_cmd(const char *filename,
+		 bool flat)
 {
   Sta *sta = Sta::sta();
   NetworkReader *network = sta->networkReader();
   if (network) {
     sta->readNetlistBefore();
-    return readVerilogFile(filename, sta->report(), sta->debug(), network);
+    return readVerilogFile(filename, flat, sta->report(), sta->debug(),
+			   network);
   }
   else
     return false;
 }
 
+void
+write_verilog_cmd(const char *filename,
+		  bool gzip)
+{
+  cmdLinkedNetwork();
+  Sta *sta = Sta::sta();
+  sta::writeVerilog(filename, gzip, sta);
+}
+
 void
 delete_verilog_reader()
 {
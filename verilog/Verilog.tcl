@@ -16,8 +16,23 @@
 
 namespace eval sta {
 
-# Defined by SWIG interface Verilog.i.
-define_cmd_args "read_verilog" {filename}
+define_cmd_args "read_verilog" {[-flat] filename}
+
+proc read_verilog { args } {
+  parse_key_args "read_verilog" args keys {} flags {-flat}
+  check_argc_eq1 "read_verilog" $args
+  set flat [info exists flags(-flat)]
+  return [read_verilog_cmd [file nativename $args] $flat]
+}
+
+define_cmd_args "write_verilog" {[-gzip] filename}
+
+proc write_verilog { args } {
+  parse_key_args "write_verilog" args keys {} flags {-gzip}
+  check_argc_eq1 "write_verilog" $args
+  set gzip [info exists flags(-gzip)]
+  write_verilog_cmd [file nativename $args] $gzip
+}
 
 # sta namespace end
 }
@@ -53,7 +53,7 @@ int VerilogLex_lex();
 %left '*' '/'
 %left NEG     /* negation--unary minus */
 
-%type <string> ID STRING
+%type <string> ID STRING module_name
 %type <ival> WIRE WAND WOR TRI INPUT OUTPUT INOUT SUPPLY1 SUPPLY0
 %type <ival> INT parameter_exprs parameter_expr module_begin
 %type <constant> CONSTANT
@@ -91,14 +91,19 @@ module_begin:
 	{ $$ = $<ival>2; }
 	;
 
+module_name:
+	ID
+	{ sta::verilog_reader->beginModule($1); $$ = $1; }
+	;
+
 module:
-	module_begin ID ';' stmts ENDMODULE
+	module_begin module_name ';' stmts ENDMODULE
 	{ sta::verilog_reader->makeModule($2, new sta::VerilogNetSeq,$4,$1);}
-|	module_begin ID '(' ')' ';' stmts ENDMODULE
+|	module_begin module_name '(' ')' ';' stmts ENDMODULE
 	{ sta::verilog_reader->makeModule($2, new sta::VerilogNetSeq,$6,$1);}
-|	module_begin ID '(' port_list ')' ';' stmts ENDMODULE
+|	module_begin module_name '(' port_list ')' ';' stmts ENDMODULE
 	{ sta::verilog_reader->makeModule($2, $4, $7, $1); }
-|	module_begin ID '(' port_dcls ')' ';' stmts ENDMODULE
+|	module_begin module_name '(' port_dcls ')' ';' stmts ENDMODULE
 	{ sta::verilog_reader->makeModule($2, $4, $7, $1); }
 	;
 
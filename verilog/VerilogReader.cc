@@ -15,15 +15,21 @@
 // along with this program.  If not, see <https://www.gnu.org/licenses/>.
 
 #include <stdlib.h>
+#include <mutex>
 #include "Machine.hh"
 #include "DisallowCopyAssign.hh"
+#include "Mutex.hh"
 #include "Debug.hh"
 #include "Report.hh"
 #include "Error.hh"
 #include "Stats.hh"
+#include "Progress.hh"
+#include "StringIntern.hh"
 #include "PortDirection.hh"
 #include "Liberty.hh"
 #include "Network.hh"
+#include "ThreadForEach.hh"
+#include "ScanInput.hh"
 #include "VerilogNamespace.hh"
 #include "Verilog.hh"
 #include "VerilogReader.hh"
@@ -54,13 +60,14 @@ linkVerilogNetwork(Cell *top_cell,
 
 bool
 readVerilogFile(const char *filename,
+		bool flat,
 		Report *report,
 		Debug *debug,
 		NetworkReader *network)
 {
   if (verilog_reader == nullptr)
     verilog_reader = new VerilogReader(report, debug, network);
-  return verilog_reader->read(filename);
+  return verilog_reader->read(filename, flat);
 }
 
 void
@@ -94,6 +101,34 @@ private:
   friend class VerilogErrorCmp;
 };
 
+////////////////////////////////////////////////////////////////
+
+// Verilog net name to network net map.
+typedef Map<const char*, Net*, CharPtrLess> BindingMap;
+
+class VerilogBindingTbl
+{
+public:
+  VerilogBindingTbl(const char *zero_net_name_,
+		    const char *one_net_name_);
+  Net *ensureNetBinding(const char *net_name,
+			Instance *inst,
+			NetworkReader *network);
+  Net *find(const char *name,
+	    NetworkReader *network);
+  void bind(const char *name,
+	    Net *net);
+
+private:
+  DISALLOW_COPY_AND_ASSIGN(VerilogBindingTbl);
+
+  const char *zero_net_name_;
+  const char *one_net_name_;
+  BindingMap map_;
+};
+
+////////////////////////////////////////////////////////////////
+
 VerilogError::VerilogError(const char *filename,
 			   int line,
 			   const char *msg,
@@ -146,10 +181,17 @@ VerilogReader::VerilogReader(Report *report,
   report_(report),
   debug_(debug),
   network_(network),
+  input_(nullptr),
   library_(nullptr),
+  flat_(false),
+  flat_cell_(nullptr),
+  flat_instance_(nullptr),
+  flat_bindings_(nullptr),
   black_box_index_(0),
+  link_bodies_(nullptr),
   zero_net_name_("zero_"),
-  one_net_name_("one_")
+  one_net_name_("one_"),
+  progress_(nullptr)
 {
   network->setLinkFunc(linkVerilogNetwork);
   VerilogConstant10 constant10_max = 0;
@@ -159,6 +201,14 @@ VerilogReader::VerilogReader(Report *report,
 
 VerilogReader::~VerilogReader()
 {
+  // The network is deleted before the reader, so flat read instances
+  // that were never linked cannot be deleted.
+  VerilogModuleMap::Iterator module_iter(module_map_);
+  while (module_iter.hasNext()) {
+    VerilogModule *module = module_iter.next();
+    delete module->flatBindings();
+    module->setFlatNetwork(nullptr, nullptr);
+  }
   deleteModules();
   stringDelete(constant10_max_);
 }
@@ -171,28 +221,42 @@ VerilogReader::deleteModules()
   while (module_iter.hasNext()) {
     VerilogModule *module = module_iter.next();
     filenames.insert(module->filename());
-    delete module;
+    deleteModule(module);
   }
   deleteContents(&filenames);
   module_map_.clear();
 }
 
+void
+VerilogReader::deleteModule(VerilogModule *module)
+{
+  Instance *flat_inst = module->flatInstance();
+  if (flat_inst)
+    network_->deleteInstance(flat_inst);
+  delete module->flatBindings();
+  delete module;
+}
+
 bool
-VerilogReader::read(const char *filename)
-{
-  // Use zlib to uncompress gzip'd files automagically.
-  stream_ = gzopen(filename, "rb");
-  if (stream_) {
-    Stats stats(debug_);
-    init(filename);
-    bool success = (::VerilogParse_parse() == 0);
-    gzclose(stream_);
-    reportStmtCounts();
-    stats.report("Read verilog");
-    return success;
-  }
-  else
-    throw FileNotReadable(filename);
+VerilogReader::read(const char *filename,
+		    bool flat)
+{
+  // Only read ahead when there is a spare thread to parse while the
+  // file is uncompressed.
+  ThreadPool *thread_pool = network_->threadPool();
+  ScanInput input(filename, thread_pool && thread_pool->threadCount() > 1);
+  Stats stats(debug_);
+  Progress progress("read_verilog", "instances", report_);
+  init(filename);
+  flat_ = flat;
+  progress_ = &progress;
+  input_ = &input;
+  bool success = (::VerilogParse_parse() == 0);
+  input_ = nullptr;
+  progress_ = nullptr;
+  reportStmtCounts();
+  stats.report("Read verilog");
+  return success;
 }
 
 void
@@ -236,11 +300,7 @@ VerilogReader::getChars(char *buf,
 			size_t &result,
 			size_t max_size)
 {
-  char *status = gzgets(stream_, buf, max_size);
-  if (status == Z_NULL)
-    result = 0;  // YY_nullptr
-  else
-    result = strlen(buf);
+  result = input_->read(buf, max_size);
 }
 
 void
@@ -248,11 +308,7 @@ VerilogReader::getChars(char *buf,
 			int &result,
 			size_t max_size)
 {
-  char *status = gzgets(stream_, buf, max_size);
-  if (status == Z_NULL)
-    result = 0;  // YY_nullptr
-  else
-    result = strlen(buf);
+  result = static_cast<int>(input_->read(buf, max_size));
 }
 
 VerilogModule *
@@ -261,25 +317,56 @@ VerilogReader::module(Cell *cell)
   return module_map_.findKey(cell);
 }
 
+void
+VerilogReader::beginModule(const char *name)
+{
+  if (flat_) {
+    // Make the module cell and an instance of it to hold the leaf
+    // instances as they are read. The ports are made at the end
+    // of the module.
+    flat_cell_ = makeModuleCell(name);
+    flat_instance_ = network_->makeInstance(flat_cell_, "", nullptr);
+    flat_bindings_ = new VerilogBindingTbl(zero_net_name_, one_net_name_);
+  }
+}
+
 void
 VerilogReader::makeModule(const char *name,
 			  VerilogNetSeq *ports,
 			  VerilogStmtSeq *stmts,
 			  int line)
+{
+  Cell *cell = flat_cell_;
+  if (cell == nullptr)
+    cell = makeModuleCell(name);
+  VerilogModule *module = new VerilogModule(name, ports, stmts,
+					    filename_, line, this);
+  module_map_[cell] = module;
+  makeCellPorts(cell, module, ports);
+  if (flat_cell_) {
+    network_->initPins(flat_instance_);
+    module->setFlatNetwork(flat_instance_, flat_bindings_);
+    flat_cell_ = nullptr;
+    flat_instance_ = nullptr;
+    flat_bindings_ = nullptr;
+    flat_bus_dcls_.clear();
+  }
+  module_count_++;
+}
+
+// Delete any previous definition of the module.
+Cell *
+VerilogReader::makeModuleCell(const char *name)
 {
   Cell *cell = network_->findCell(library_, name);
   if (cell) {
     VerilogModule *module = module_map_[cell];
-    delete module;
+    if (module)
+      deleteModule(module);
     module_map_.erase(cell);
     network_->deleteCell(cell);
   }
-  VerilogModule *module = new VerilogModule(name, ports, stmts,
-					    filename_, line, this);
-  cell = network_->makeCell(library_, name, false, filename_);
-  module_map_[cell] = module;
-  makeCellPorts(cell, module, ports);
-  module_count_++;
+  return network_->makeCell(library_, name, false, filename_);
 }
 
 void
@@ -458,7 +545,10 @@ VerilogReader::makeDclBus(PortDirection *dir,
 			  int line)
 {
   dcl_bus_count_++;
-  return new VerilogDclBus(dir, from_index, to_index, arg, line);
+  VerilogDclBus *dcl = new VerilogDclBus(dir, from_index, to_index, arg, line);
+  if (flat_instance_)
+    flat_bus_dcls_[arg->netName()] = dcl;
+  return dcl;
 }
 
 VerilogDclBus *
@@ -469,7 +559,16 @@ VerilogReader::makeDclBus(PortDirection *dir,
 			  int line)
 {
   dcl_bus_count_++;
-  return new VerilogDclBus(dir, from_index, to_index, args, line);
+  VerilogDclBus *dcl = new VerilogDclBus(dir, from_index, to_index, args,
+					 line);
+  if (flat_instance_) {
+    VerilogDclArgSeq::Iterator arg_iter(args);
+    while (arg_iter.hasNext()) {
+      VerilogDclArg *arg = arg_iter.next();
+      flat_bus_dcls_[arg->netName()] = dcl;
+    }
+  }
+  return dcl;
 }
 
 VerilogDclArg *
@@ -538,6 +637,8 @@ VerilogReader::makeModuleInst(const char *module_name,
 			      VerilogNetSeq *pins,
 			      const int line)
 {
+  if (progress_)
+    progress_->incr();
   Cell *cell = network_->findAnyCell(module_name);
   LibertyCell *liberty_cell = network_->libertyCell(cell);
   VerilogInst *inst;
@@ -564,23 +665,31 @@ VerilogReader::makeModuleInst(const char *module_name,
 	lport = member_iter.next();
       }
       int pin_index = lport->pinIndex();
-      const char *prev_net_name = net_names[pin_index];
-      if (prev_net_name
-	  && prev_net_name !=unconnected_net_name)
-	// Repeated port reference.
-	stringDelete(prev_net_name);
-      net_names[pin_index]=(net_name == nullptr) ? unconnected_net_name : net_name;
+      // Net names are interned because most nets connect to
+      // several instances.
+      net_names[pin_index] = (net_name == nullptr)
+	? unconnected_net_name
+	: internString(net_name);
+      stringDelete(net_name);
       delete vpin;
       net_port_ref_scalar_net_count_--;
     }
-    inst = new VerilogLibertyInst(liberty_cell, inst_name, net_names, line);
-    stringDelete(module_name);
-    delete pins;
     if (report_stmt_stats_) {
       inst_names_ += strlen(inst_name) + 1;
       inst_lib_count_++;
       inst_lib_net_arrays_ += port_count;
     }
+    if (flat_instance_) {
+      // Make the instance now rather than keeping a statement for it.
+      makeFlatLibertyInst(liberty_cell, inst_name, net_names, line);
+      stringDelete(inst_name);
+      delete [] net_names;
+      inst = nullptr;
+    }
+    else
+      inst = new VerilogLibertyInst(liberty_cell, inst_name, net_names, line);
+    stringDelete(module_name);
+    delete pins;
   }
   else {
     inst = new VerilogModuleInst(module_name, inst_name, pins, line);
@@ -768,7 +877,9 @@ VerilogModule::VerilogModule(const char *name,
   name_(name),
   filename_(filename),
   ports_(ports),
-  stmts_(stmts)
+  stmts_(stmts),
+  flat_instance_(nullptr),
+  flat_bindings_(nullptr)
 {
   parseStmts(reader);
 }
@@ -863,6 +974,14 @@ VerilogModule::checkInstanceName(VerilogInst *inst,
   inst_names.insert(inst_name);
 }
 
+void
+VerilogModule::setFlatNetwork(Instance *inst,
+			      VerilogBindingTbl *bindings)
+{
+  flat_instance_ = inst;
+  flat_bindings_ = bindings;
+}
+
 VerilogDcl *
 VerilogModule::declaration(const char *net_name)
 {
@@ -942,13 +1061,7 @@ VerilogLibertyInst::VerilogLibertyInst(LibertyCell *cell,
 
 VerilogLibertyInst::~VerilogLibertyInst()
 {
-  int port_count = cell_->portBitCount();
-  for (int i = 0; i < port_count; i++) {
-    const char *net_name = net_names_[i];
-    if (net_name
-	&& net_name != unconnected_net_name)
-      stringDelete(net_name);
-  }
+  // The net names are interned.
   delete [] net_names_;
 }
 
@@ -1672,30 +1785,26 @@ linkVerilogNetwork(Cell *top_cell, bool make_black_boxes,
   return verilog_reader->linkNetwork(top_cell, make_black_boxes, report);
 }
 
-// Verilog net name to network net map.
-typedef Map<const char*, Net*, CharPtrLess> BindingMap;
-
-class VerilogBindingTbl
+// Hierarchical instance whose body is linked after its parent.
+class VerilogLinkBody
 {
 public:
-  VerilogBindingTbl(const char *zero_net_name_,
-		    const char *one_net_name_);
-  Net *ensureNetBinding(const char *net_name,
-			Instance *inst,
-			NetworkReader *network);
-  Net *find(const char *name,
-	    NetworkReader *network);
-  void bind(const char *name,
-	    Net *net);
+  VerilogLinkBody(VerilogModule *module,
+		  Instance *inst,
+		  VerilogBindingTbl *bindings);
+  ~VerilogLinkBody();
 
-private:
-  DISALLOW_COPY_AND_ASSIGN(VerilogBindingTbl);
+  VerilogModule *module_;
+  Instance *inst_;
+  VerilogBindingTbl *bindings_;
 
-  const char *zero_net_name_;
-  const char *one_net_name_;
-  BindingMap map_;
+private:
+  DISALLOW_COPY_AND_ASSIGN(VerilogLinkBody);
 };
 
+// Serializes updates to the network constant net sets.
+static std::mutex constant_nets_lock;
+
 Instance *
 VerilogReader::linkNetwork(Cell *top_cell,
 			   bool make_black_boxes,
@@ -1704,8 +1813,23 @@ VerilogReader::linkNetwork(Cell *top_cell,
   VerilogModule *module = verilog_reader->module(top_cell);
   if (module) {
     // Seed the recursion for expansion with the top level instance.
-    Instance *top_instance = network_->makeInstance(top_cell, "", nullptr);
-    VerilogBindingTbl bindings(zero_net_name_, one_net_name_);
+    Instance *top_instance = module->flatInstance();
+    VerilogBindingTbl *bindings = module->flatBindings();
+    if (top_instance) {
+      // The leaf instances were made by a flat read.
+      module->setFlatNetwork(nullptr, nullptr);
+      // Constant nets found while reading were cleared before linking.
+      Net *zero_net = bindings->find(zero_net_name_, network_);
+      if (zero_net)
+	network_->addConstantNet(zero_net, LogicValue::zero);
+      Net *one_net = bindings->find(one_net_name_, network_);
+      if (one_net)
+	network_->addConstantNet(one_net, LogicValue::one);
+    }
+    else {
+      top_instance = network_->makeInstance(top_cell, "", nullptr);
+      bindings = new VerilogBindingTbl(zero_net_name_, one_net_name_);
+    }
     VerilogNetSeq::Iterator port_iter(module->ports());
     while (port_iter.hasNext()) {
       VerilogNet *mod_port = port_iter.next();
@@ -1714,7 +1838,7 @@ VerilogReader::linkNetwork(Cell *top_cell,
       while (net_name_iter->hasNext()) {
 	const char *net_name = net_name_iter->next();
 	Port *port = network_->findPort(top_cell, net_name);
-	Net *net = bindings.ensureNetBinding(net_name, top_instance, network_);
+	Net *net = bindings->ensureNetBinding(net_name, top_instance, network_);
 	// Guard against repeated port name.
 	if (network_->findPin(top_instance, port) == nullptr) {
 	  Pin *pin = network_->makePin(top_instance, port, nullptr);
@@ -1723,7 +1847,13 @@ VerilogReader::linkNetwork(Cell *top_cell,
       }
       delete net_name_iter;
     }
-    makeModuleInstBody(module, top_instance, &bindings, make_black_boxes);
+    ThreadPool *thread_pool = network_->threadPool();
+    if (thread_pool && thread_pool->threadCount() > 1)
+      linkBodiesParallel(module, top_instance, bindings, make_black_boxes,
+			 thread_pool);
+    else
+      makeModuleInstBody(module, top_instance, bindings, make_black_boxes);
+    delete bindings;
     bool errors = reportLinkErrors(report);
     deleteModules();
     if (errors) {
@@ -1739,6 +1869,59 @@ VerilogReader::linkNetwork(Cell *top_cell,
   }
 }
 
+// Link the top levels of the hierarchy breadth first, deferring the
+// bodies of hierarchical instances, until there are enough sub-trees
+// to keep the threads busy. The sub-trees share no nets or instances
+// below their ports, so each one is linked by a single thread directly
+// into the network.
+void
+VerilogReader::linkBodiesParallel(VerilogModule *top_module,
+				  Instance *top_instance,
+				  VerilogBindingTbl *top_bindings,
+				  bool make_black_boxes,
+				  ThreadPool *thread_pool)
+{
+  size_t body_min = thread_pool->threadCount() * 4;
+  VerilogLinkBodySeq bodies;
+  link_bodies_ = &bodies;
+  makeModuleInstBody(top_module, top_instance, top_bindings,
+		     make_black_boxes);
+  while (!bodies.empty() && bodies.size() < body_min) {
+    VerilogLinkBodySeq level;
+    level.swap(bodies);
+    for (VerilogLinkBody *body : level) {
+      makeModuleInstBody(body->module_, body->inst_, body->bindings_,
+			 make_black_boxes);
+      delete body;
+    }
+  }
+  // Bodies below the deferred instances are linked without deferral.
+  link_bodies_ = nullptr;
+  forEachChunk(bodies.size(), thread_pool,
+	       [&] (size_t begin, size_t end, int) {
+		 for (size_t i = begin; i < end; i++) {
+		   VerilogLinkBody *body = bodies[i];
+		   makeModuleInstBody(body->module_, body->inst_,
+				      body->bindings_, make_black_boxes);
+		   delete body;
+		 }
+	       });
+}
+
+VerilogLinkBody::VerilogLinkBody(VerilogModule *module,
+				 Instance *inst,
+				 VerilogBindingTbl *bindings) :
+  module_(module),
+  inst_(inst),
+  bindings_(bindings)
+{
+}
+
+VerilogLinkBody::~VerilogLinkBody()
+{
+  delete bindings_;
+}
+
 void
 VerilogReader::makeModuleInstBody(VerilogModule *module,
 				  Instance *inst,
@@ -1765,10 +1948,12 @@ VerilogReader::makeModuleInstBody(VerilogModule *module,
 	  mergeAssignNet(assign, module, inst, bindings);
 	if (dir->isGround()) {
 	  Net *net = bindings->ensureNetBinding(arg->netName(),inst,network_);
+	  UniqueLock lock(constant_nets_lock);
 	  network_->addConstantNet(net, LogicValue::zero);
 	}
 	if (dir->isPower()) {
 	  Net *net = bindings->ensureNetBinding(arg->netName(),inst,network_);
+	  UniqueLock lock(constant_nets_lock);
 	  network_->addConstantNet(net, LogicValue::one);
 	}
       }
@@ -1787,6 +1972,9 @@ VerilogReader::makeModuleInstNetwork(VerilogModuleInst *mod_inst,
 				     bool make_black_boxes)
 {
   const char *module_name = mod_inst->moduleName();
+  // Black boxes are added to the library while other threads look
+  // up cells.
+  UniqueLock cell_lock(link_cell_lock_);
   Cell *cell = network_->findAnyCell(module_name);
   if (cell == nullptr) {
     if (make_black_boxes) {
@@ -1802,6 +1990,7 @@ VerilogReader::makeModuleInstNetwork(VerilogModuleInst *mod_inst,
 		mod_inst->moduleName(),
 		mod_inst->instanceName());
   }
+  cell_lock.unlock();
   if (cell) {
     Instance *inst = network_->makeInstance(cell, mod_inst->instanceName(),
 					    parent);
@@ -1817,19 +2006,35 @@ VerilogReader::makeModuleInstNetwork(VerilogModuleInst *mod_inst,
 	}
       }
     }
-    VerilogBindingTbl bindings(zero_net_name_, one_net_name_);
+    VerilogBindingTbl *bindings = new VerilogBindingTbl(zero_net_name_,
+							one_net_name_);
     if (mod_inst->hasPins()) {
       if (mod_inst->namedPins())
-	makeNamedInstPins(cell, inst, mod_inst, &bindings, parent,
+	makeNamedInstPins(cell, inst, mod_inst, bindings, parent,
 			  parent_module, parent_bindings, is_leaf);
       else
-	makeOrderedInstPins(cell, inst, mod_inst, &bindings, parent,
+	makeOrderedInstPins(cell, inst, mod_inst, bindings, parent,
 			    parent_module, parent_bindings, is_leaf);
     }
     if (!is_leaf) {
       VerilogModule *module = verilog_reader->module(cell);
-      makeModuleInstBody(module, inst, &bindings, make_black_boxes);
+      if (module->flatInstance()) {
+	linkError(filename_, mod_inst->line(),
+		  "module %s read with -flat cannot be instantiated by %s.\n",
+		  mod_inst->moduleName(),
+		  mod_inst->instanceName());
+	delete bindings;
+      }
+      else if (link_bodies_)
+	// The body owns the bindings.
+	link_bodies_->push_back(new VerilogLinkBody(module, inst, bindings));
+      else {
+	makeModuleInstBody(module, inst, bindings, make_black_boxes);
+	delete bindings;
+      }
     }
+    else
+      delete bindings;
   }
 }
 
@@ -1976,11 +2181,21 @@ VerilogReader::makeLibertyInst(VerilogLibertyInst *lib_inst,
 			       VerilogModule *parent_module,
 			       VerilogBindingTbl *parent_bindings)
 {
-  LibertyCell *lib_cell = lib_inst->cell();
+  makeLibertyInst(lib_inst->cell(), lib_inst->instanceName(),
+		  lib_inst->netNames(), parent,
+		  parent_module->declarationMap(), parent_bindings);
+}
+
+void
+VerilogReader::makeLibertyInst(LibertyCell *lib_cell,
+			       const char *inst_name,
+			       const char **net_names,
+			       Instance *parent,
+			       VerilogDclMap *parent_dcls,
+			       VerilogBindingTbl *parent_bindings)
+{
   Cell *cell = reinterpret_cast<Cell*>(lib_cell);
-  Instance *inst = network_->makeInstance(cell, lib_inst->instanceName(),
-					  parent);
-  const char **net_names = lib_inst->netNames();
+  Instance *inst = network_->makeInstance(cell, inst_name, parent);
   LibertyCellPortBitIterator port_iter(lib_cell);
   while (port_iter.hasNext()) {
     LibertyPort *port = port_iter.next();
@@ -1990,7 +2205,7 @@ VerilogReader::makeLibertyInst(VerilogLibertyInst *lib_inst,
       Net *net = nullptr;
       // If the pin is unconnected (ie, .A()) make the pin but not the net.
       if (net_name != unconnected_net_name) {
-	VerilogDcl *dcl = parent_module->declaration(net_name);
+	VerilogDcl *dcl = parent_dcls->findKey(net_name);
 	// Check for single bit bus reference .A(BUS) -> .A(BUS[LSB]).
 	if (dcl && dcl->isBus()) {
 	  VerilogDclBus *dcl_bus = dynamic_cast<VerilogDclBus *>(dcl);
@@ -2010,6 +2225,32 @@ VerilogReader::makeLibertyInst(VerilogLibertyInst *lib_inst,
   }
 }
 
+// Flat netlists declare buses before they are referenced, so only
+// the declarations read so far are needed to find single bit buses.
+void
+VerilogReader::makeFlatLibertyInst(LibertyCell *lib_cell,
+				   const char *inst_name,
+				   const char **net_names,
+				   int line)
+{
+  const char *inst_name1 = inst_name;
+  const char *replacement_name = nullptr;
+  if (network_->findChild(flat_instance_, inst_name)) {
+    int i = 1;
+    do {
+      stringDelete(replacement_name);
+      replacement_name = stringPrint("%s_%d", inst_name, i++);
+    } while (network_->findChild(flat_instance_, replacement_name));
+    warn(filename_, line, "instance name %s duplicated - renamed to %s.\n",
+	 inst_name,
+	 replacement_name);
+    inst_name1 = replacement_name;
+  }
+  makeLibertyInst(lib_cell, inst_name1, net_names, flat_instance_,
+		  &flat_bus_dcls_, flat_bindings_);
+  stringDelete(replacement_name);
+}
+
 ////////////////////////////////////////////////////////////////
 
 Cell *
@@ -2157,10 +2398,14 @@ VerilogBindingTbl::ensureNetBinding(const char *net_name,
   if (net == nullptr) {
     net = network->makeNet(net_name, inst);
     map_[network->name(net)] = net;
-    if (stringEq(net_name, zero_net_name_))
+    if (stringEq(net_name, zero_net_name_)) {
+      UniqueLock lock(constant_nets_lock);
       network->addConstantNet(net, LogicValue::zero);
-    if (stringEq(net_name, one_net_name_))
+    }
+    if (stringEq(net_name, one_net_name_)) {
+      UniqueLock lock(constant_nets_lock);
       network->addConstantNet(net, LogicValue::one);
+    }
   }
   return net;
 }
@@ -2176,6 +2421,7 @@ VerilogReader::linkWarn(const char *filename,
   va_start(args, msg);
   char *msg_str = stringPrintArgs(msg, args);
   VerilogError *error = new VerilogError(filename, line, msg_str, true);
+  UniqueLock lock(link_errors_lock_);
   link_errors_.push_back(error);
   va_end(args);
 }
@@ -2189,6 +2435,7 @@ VerilogReader::linkError(const char *filename,
   va_start(args, msg);
   char *msg_str = stringPrintArgs(msg, args);
   VerilogError *error = new VerilogError(filename, line, msg_str, false);
+  UniqueLock lock(link_errors_lock_);
   link_errors_.push_back(error);
   va_end(args);
 }
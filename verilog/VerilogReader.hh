@@ -26,9 +26,13 @@ class NetworkEdit;
 class Instance;
 
 // Return true if successful.
+// With flat the liberty cell instances are made while reading
+// instead of saving the verilog statements for them until the
+// network is linked. Modules read with flat cannot be instantiated
+// by other modules.
 bool
-readVerilogFile(const char *filename, Report *report, Debug *debug,
-		NetworkReader *network);
+readVerilogFile(const char *filename, bool flat, Report *report,
+		Debug *debug, NetworkReader *network);
 
 void
 deleteVerilogReader();
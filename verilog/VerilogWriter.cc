@@ -0,0 +1,449 @@
+// OpenSTA, Static Timing Analyzer
+// Copyright (c) 2019, Parallax Software, Inc.
+// 
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+// 
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+// 
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#include <stdio.h>
+#include <string.h>
+#include <algorithm>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+#include "Machine.hh"
+#include "Zlib.hh"
+#include "Error.hh"
+#include "StringUtil.hh"
+#include "ThreadPool.hh"
+#include "ThreadForEach.hh"
+#include "PortDirection.hh"
+#include "ParseBus.hh"
+#include "VerilogNamespace.hh"
+#include "Network.hh"
+#include "StaState.hh"
+#include "VerilogWriter.hh"
+
+namespace sta {
+
+// Instance statements formatted in memory before they are written.
+static const size_t write_batch_inst_count = 1 << 16;
+
+typedef std::map<std::string, std::pair<int, int> > VerilogBusRangeMap;
+
+class VerilogWriter : public StaState
+{
+public:
+  VerilogWriter(StaState *sta);
+  void write(const char *filename,
+	     bool gzip);
+
+protected:
+  void findModules(const Instance *inst,
+		   CellSet &visited,
+		   ConstInstanceSeq &modules);
+  void writeModule(const Instance *inst);
+  void writePorts(const Cell *cell);
+  void writePortDcls(const Cell *cell);
+  const char *verilogPortDir(const PortDirection *dir);
+  void writeWireDcls(const Instance *inst);
+  void writeChildren(const Instance *inst);
+  void writeChild(const Instance *child,
+		  std::string &text);
+  void writeChildBus(const Instance *child,
+		     const Port *port,
+		     std::string &text);
+  void writeAssigns(const Instance *inst);
+  const char *netName(const Pin *pin);
+  void flush();
+  void compress(const std::string &text,
+		// Return value.
+		std::string &chunk);
+
+private:
+  DISALLOW_COPY_AND_ASSIGN(VerilogWriter);
+
+  FILE *stream_;
+  bool gzip_;
+  char escape_;
+  // Module statements that are not instances.
+  std::string text_;
+};
+
+void
+writeVerilog(const char *filename,
+	     bool gzip,
+	     StaState *sta)
+{
+  VerilogWriter writer(sta);
+  writer.write(filename, gzip);
+}
+
+VerilogWriter::VerilogWriter(StaState *sta) :
+  StaState(sta),
+  stream_(nullptr),
+  gzip_(false),
+  escape_(network_->pathEscape())
+{
+}
+
+void
+VerilogWriter::write(const char *filename,
+		     bool gzip)
+{
+  stream_ = fopen(filename, "wb");
+  if (stream_ == nullptr)
+    throw FileNotWritable(filename);
+  gzip_ = gzip;
+  CellSet visited;
+  ConstInstanceSeq modules;
+  Instance *top_inst = network_->topInstance();
+  findModules(top_inst, visited, modules);
+  modules.push_back(top_inst);
+  for (const Instance *inst : modules)
+    writeModule(inst);
+  flush();
+  fclose(stream_);
+  stream_ = nullptr;
+}
+
+// One instance of each hierarchical cell below inst, with the modules
+// it instantiates before it.
+void
+VerilogWriter::findModules(const Instance *inst,
+			   CellSet &visited,
+			   ConstInstanceSeq &modules)
+{
+  InstanceChildIterator *child_iter = network_->childIterator(inst);
+  while (child_iter->hasNext()) {
+    Instance *child = child_iter->next();
+    Cell *cell = network_->cell(child);
+    if (network_->isHierarchical(child)
+	&& !visited.hasKey(cell)) {
+      visited.insert(cell);
+      findModules(child, visited, modules);
+      modules.push_back(child);
+    }
+  }
+  delete child_iter;
+}
+
+void
+VerilogWriter::writeModule(const Instance *inst)
+{
+  Cell *cell = network_->cell(inst);
+  text_ += "module ";
+  text_ += network_->name(cell);
+  text_ += " (";
+  writePorts(cell);
+  text_ += ");\n";
+  writePortDcls(cell);
+  writeWireDcls(inst);
+  text_ += "\n";
+  writeChildren(inst);
+  writeAssigns(inst);
+  text_ += "endmodule\n";
+}
+
+void
+VerilogWriter::writePorts(const Cell *cell)
+{
+  bool first = true;
+  CellPortIterator *port_iter = network_->portIterator(cell);
+  while (port_iter->hasNext()) {
+    Port *port = port_iter->next();
+    if (!first)
+      text_ += ",\n    ";
+    text_ += netVerilogName(network_->name(port), escape_);
+    first = false;
+  }
+  delete port_iter;
+}
+
+void
+VerilogWriter::writePortDcls(const Cell *cell)
+{
+  CellPortIterator *port_iter = network_->portIterator(cell);
+  while (port_iter->hasNext()) {
+    Port *port = port_iter->next();
+    const char *dir = verilogPortDir(network_->direction(port));
+    if (dir) {
+      text_ += " ";
+      text_ += dir;
+      if (network_->isBus(port)) {
+	text_ += stringPrintTmp(" [%d:%d]",
+				network_->fromIndex(port),
+				network_->toIndex(port));
+      }
+      text_ += " ";
+      text_ += netVerilogName(network_->name(port), escape_);
+      text_ += ";\n";
+    }
+  }
+  delete port_iter;
+}
+
+const char *
+VerilogWriter::verilogPortDir(const PortDirection *dir)
+{
+  if (dir->isInput())
+    return "input";
+  else if (dir->isOutput()
+	   || dir->isTristate())
+    return "output";
+  else if (dir->isBidirect())
+    return "inout";
+  else
+    // Power, ground and internal ports are not written.
+    return nullptr;
+}
+
+// Nets that are not ports. Nets named as bus bits are declared as
+// buses that span the bits that are used.
+void
+VerilogWriter::writeWireDcls(const Instance *inst)
+{
+  Cell *cell = network_->cell(inst);
+  VerilogBusRangeMap bus_ranges;
+  InstanceNetIterator *net_iter = network_->netIterator(inst);
+  while (net_iter->hasNext()) {
+    Net *net = net_iter->next();
+    const char *net_name = network_->name(net);
+    char *bus_name;
+    int index;
+    parseBusName(net_name, '[', ']', bus_name, index);
+    if (bus_name) {
+      if (network_->findPort(cell, bus_name) == nullptr) {
+	auto range_iter = bus_ranges.find(bus_name);
+	if (range_iter == bus_ranges.end())
+	  bus_ranges[bus_name] = std::make_pair(index, index);
+	else {
+	  std::pair<int, int> &range = range_iter->second;
+	  range.first = std::max(range.first, index);
+	  range.second = std::min(range.second, index);
+	}
+      }
+      stringDelete(bus_name);
+    }
+    else if (network_->findPort(cell, net_name) == nullptr) {
+      text_ += " wire ";
+      text_ += netVerilogName(net_name, escape_);
+      text_ += ";\n";
+    }
+  }
+  delete net_iter;
+
+  for (auto &name_range : bus_ranges) {
+    const std::pair<int, int> &range = name_range.second;
+    text_ += stringPrintTmp(" wire [%d:%d] ", range.first, range.second);
+    text_ += netVerilogName(name_range.first.c_str(), escape_);
+    text_ += ";\n";
+  }
+}
+
+// Instance statements are formatted (and compressed) in parallel in
+// batches and written in order.
+void
+VerilogWriter::writeChildren(const Instance *inst)
+{
+  ConstInstanceSeq children;
+  InstanceChildIterator *child_iter = network_->childIterator(inst);
+  while (child_iter->hasNext())
+    children.push_back(child_iter->next());
+  delete child_iter;
+
+  flush();
+  for (size_t batch_begin = 0;
+       batch_begin < children.size();
+       batch_begin += write_batch_inst_count) {
+    size_t batch_end = std::min(batch_begin + write_batch_inst_count,
+				children.size());
+    size_t batch_size = batch_end - batch_begin;
+    size_t chunk_count = thread_pool_ ? thread_pool_->threadCount() * 4 : 1;
+    chunk_count = std::max(std::min(chunk_count, batch_size), size_t(1));
+    size_t chunk_size = (batch_size + chunk_count - 1) / chunk_count;
+    std::vector<std::string> chunks(chunk_count);
+    forEachChunk(chunk_count, thread_pool_,
+		 [&] (size_t begin, size_t end, int) {
+		   for (size_t i = begin; i < end; i++) {
+		     size_t inst_begin = batch_begin + i * chunk_size;
+		     size_t inst_end = std::min(inst_begin + chunk_size,
+						batch_end);
+		     std::string text;
+		     for (size_t j = inst_begin; j < inst_end; j++)
+		       writeChild(children[j], text);
+		     compress(text, chunks[i]);
+		   }
+		 });
+    for (std::string &chunk : chunks)
+      fwrite(chunk.data(), 1, chunk.size(), stream_);
+  }
+}
+
+void
+VerilogWriter::writeChild(const Instance *child,
+			  std::string &text)
+{
+  TmpStringScope tmp_scope;
+  Cell *child_cell = network_->cell(child);
+  text += " ";
+  text += network_->name(child_cell);
+  text += " ";
+  text += instanceVerilogName(network_->name(child), escape_);
+  text += " (";
+  bool first = true;
+  CellPortIterator *port_iter = network_->portIterator(child_cell);
+  while (port_iter->hasNext()) {
+    Port *port = port_iter->next();
+    if (network_->isBus(port)) {
+      if (!first)
+	text += ",\n    ";
+      writeChildBus(child, port, text);
+      first = false;
+    }
+    else {
+      Pin *pin = network_->findPin(child, port);
+      const char *net_name = pin ? netName(pin) : nullptr;
+      if (net_name) {
+	if (!first)
+	  text += ",\n    ";
+	text += ".";
+	text += netVerilogName(network_->name(port), escape_);
+	text += "(";
+	text += net_name;
+	text += ")";
+	first = false;
+      }
+    }
+  }
+  delete port_iter;
+  text += ");\n";
+}
+
+void
+VerilogWriter::writeChildBus(const Instance *child,
+			     const Port *port,
+			     std::string &text)
+{
+  text += ".";
+  text += netVerilogName(network_->name(port), escape_);
+  text += "({";
+  bool first = true;
+  PortMemberIterator *member_iter = network_->memberIterator(port);
+  while (member_iter->hasNext()) {
+    Port *member = member_iter->next();
+    Pin *pin = network_->findPin(child, member);
+    const char *net_name = pin ? netName(pin) : nullptr;
+    if (!first)
+      text += ", ";
+    // Unconnected bits are left floating.
+    text += net_name ? net_name : "1'bz";
+    first = false;
+  }
+  delete member_iter;
+  text += "})";
+}
+
+// Connect ports to internal nets with different names.
+void
+VerilogWriter::writeAssigns(const Instance *inst)
+{
+  if (!network_->isTopInstance(inst)) {
+    InstancePinIterator *pin_iter = network_->pinIterator(inst);
+    while (pin_iter->hasNext()) {
+      Pin *pin = pin_iter->next();
+      Term *term = network_->term(pin);
+      Net *net = term ? network_->net(term) : nullptr;
+      Port *port = network_->port(pin);
+      if (net
+	  && !stringEq(network_->name(net), network_->name(port))) {
+	text_ += " assign ";
+	text_ += netVerilogName(network_->name(port), escape_);
+	text_ += " = ";
+	text_ += netVerilogName(network_->name(net), escape_);
+	text_ += ";\n";
+      }
+    }
+    delete pin_iter;
+  }
+  else {
+    // Top level ports are terminals of the top instance pins.
+    Cell *cell = network_->cell(inst);
+    CellPortBitIterator *port_iter = network_->portBitIterator(cell);
+    while (port_iter->hasNext()) {
+      Port *port = port_iter->next();
+      Pin *pin = network_->findPin(inst, port);
+      Net *net = pin ? network_->net(pin) : nullptr;
+      if (net
+	  && !stringEq(network_->name(net), network_->name(port))) {
+	text_ += " assign ";
+	text_ += netVerilogName(network_->name(port), escape_);
+	text_ += " = ";
+	text_ += netVerilogName(network_->name(net), escape_);
+	text_ += ";\n";
+      }
+    }
+    delete port_iter;
+  }
+}
+
+// Name of the net connected to an instance pin in the parent module.
+const char *
+VerilogWriter::netName(const Pin *pin)
+{
+  Net *net = network_->net(pin);
+  if (net)
+    return netVerilogName(network_->name(net), escape_);
+  else
+    return nullptr;
+}
+
+void
+VerilogWriter::flush()
+{
+  if (!text_.empty()) {
+    std::string chunk;
+    compress(text_, chunk);
+    fwrite(chunk.data(), 1, chunk.size(), stream_);
+    text_.clear();
+  }
+}
+
+// A gzip file can be a sequence of compressed members, so each chunk
+// is compressed into a member of its own.
+void
+VerilogWriter::compress(const std::string &text,
+			std::string &chunk)
+{
+#if ZLIB
+  if (gzip_) {
+    z_stream zstream;
+    memset(&zstream, 0, sizeof(zstream));
+    // windowBits + 16 writes a gzip header and trailer.
+    deflateInit2(&zstream, Z_DEFAULT_COMPRESSION, Z_DEFLATED, 15 + 16, 8,
+		 Z_DEFAULT_STRATEGY);
+    chunk.resize(deflateBound(&zstream, text.size()));
+    zstream.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(text.data()));
+    zstream.avail_in = text.size();
+    zstream.next_out = reinterpret_cast<Bytef*>(&chunk[0]);
+    zstream.avail_out = chunk.size();
+    deflate(&zstream, Z_FINISH);
+    chunk.resize(zstream.total_out);
+    deflateEnd(&zstream);
+  }
+  else
+#endif
+    chunk = text;
+}
+
+} // namespace